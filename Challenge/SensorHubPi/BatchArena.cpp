@@ -0,0 +1,54 @@
+#include "BatchArena.h"
+#include <new>
+
+BatchArena::BatchArena(size_t blockBytes)
+    : _blockBytes(blockBytes != 0 ? blockBytes : 4096), _current(0), _offset(0), _used(0), _highWater(0),
+      _capacity(0), _heapCalls(0) {
+    _blocks.reserve(16);
+    grow(_blockBytes);  // On the constructing thread: the first touch places it
+}
+
+BatchArena::~BatchArena() {
+    for (Block& block : _blocks) ::operator delete(block.data, std::align_val_t(BlockAlignment));
+}
+
+void BatchArena::reset() {
+    if (_used > _highWater) _highWater = _used;
+    _current = 0;
+    _offset = 0;
+    _used = 0;
+}
+
+void* BatchArena::do_allocate(size_t bytes, size_t alignment) {
+    if (bytes == 0) bytes = 1;
+    for (;;) {
+        if (_current < _blocks.size()) {
+            Block& block = _blocks[_current];
+            const uintptr_t base = reinterpret_cast<uintptr_t>(block.data);
+            const uintptr_t aligned = (base + _offset + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+            const size_t end = static_cast<size_t>(aligned - base) + bytes;
+            if (end <= block.size) {
+                _used += end - _offset;
+                _offset = end;
+                return reinterpret_cast<void*>(aligned);
+            }
+            // The rest of this block is left for the next batch: try the next one
+            _used += block.size - _offset;
+            _current++;
+            _offset = 0;
+            continue;
+        }
+        if (!grow(bytes + alignment)) throw std::bad_alloc();
+    }
+}
+
+// A new block at the end, at least one default block in size
+bool BatchArena::grow(size_t bytes) {
+    const size_t size = bytes > _blockBytes ? bytes : _blockBytes;
+    void* data = ::operator new(size, std::align_val_t(BlockAlignment), std::nothrow);
+    if (data == nullptr) return false;
+    _blocks.push_back(Block{static_cast<unsigned char*>(data), size});
+    _capacity += size;
+    _heapCalls++;
+    return true;
+}
@@ -0,0 +1,65 @@
+#ifndef BATCH_ARENA_H
+#define BATCH_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+// Bump allocator for the temporary buffers of one batch.
+//
+// An allocation is a pointer increment in the current block;
+// deallocate() does nothing. reset() at the end of the batch frees
+// everything at once and keeps the blocks, so once the arena has grown
+// to the largest batch, allocating costs no heap call and no lock. Only
+// a batch that needs more than all blocks together allocates another
+// block, which is then kept as well.
+//
+// It is a std::pmr::memory_resource, so the standard containers use it
+// directly:
+//
+//     std::pmr::vector<float> column(count, &arena);
+//
+// One thread only: every pipeline stage has its own (Pipeline::batchResource()).
+class BatchArena : public std::pmr::memory_resource {
+public:
+    // Allocates the first block of blockBytes
+    explicit BatchArena(size_t blockBytes = 256 * 1024);
+    ~BatchArena() override;
+
+    BatchArena(const BatchArena&) = delete;
+    BatchArena& operator=(const BatchArena&) = delete;
+
+    // Frees every allocation since the previous reset(); the blocks stay
+    void reset();
+
+    size_t getUsed() const { return _used; }                // Bytes since reset(), padding included
+    size_t getHighWater() const { return _highWater; }      // Most used by one batch
+    size_t getCapacity() const { return _capacity; }        // All blocks
+    uint64_t getHeapCalls() const { return _heapCalls; }    // Blocks allocated, in total
+
+private:
+    struct Block {
+        unsigned char* data;
+        size_t size;
+    };
+
+    static const size_t BlockAlignment = 64;    // Cache line: no false sharing with other threads' blocks
+
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void*, size_t, size_t) override {}
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    bool grow(size_t bytes);
+
+    const size_t _blockBytes;
+    std::vector<Block> _blocks;
+    size_t _current;            // Block being filled
+    size_t _offset;             // In that block
+    size_t _used;
+    size_t _highWater;
+    size_t _capacity;
+    uint64_t _heapCalls;
+};
+
+#endif // BATCH_ARENA_H
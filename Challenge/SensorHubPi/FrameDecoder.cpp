@@ -0,0 +1,126 @@
+#include "FrameDecoder.h"
+
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#define FRAME_DECODER_SSE 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define FRAME_DECODER_NEON 1
+#endif
+
+// Shuffle index that yields a zero byte (SSSE3: bit 7; NEON: out of the table)
+static const uint8_t Zero = 0x80;
+
+FrameDecoder::FrameDecoder(size_t frameBytes, const std::vector<FrameField>& fields)
+    : _frameBytes(frameBytes), _fields(fields), _chunks(0) {
+    if (_frameBytes == 0 || _frameBytes > MaxFrameBytes) return;
+    _chunks = (Lanes * _frameBytes + 15) / 16;
+    _masks.assign(_fields.size() * _chunks * 16, Zero);
+
+    // Lane j of field f: little-endian 16 bits, low byte from offset + 1 of frame j
+    for (size_t f = 0; f < _fields.size(); f++) {
+        for (size_t lane = 0; lane < Lanes; lane++) {
+            const size_t high = lane * _frameBytes + _fields[f].byteOffset;
+            const size_t sources[2] = {high + 1, high};
+            for (size_t half = 0; half < 2; half++) {
+                const size_t chunk = sources[half] / 16;
+                _masks[(f * _chunks + chunk) * 16 + 2 * lane + half] = static_cast<uint8_t>(sources[half] % 16);
+            }
+        }
+    }
+}
+
+FrameDecoder FrameDecoder::ecg(float scale, float offset) {
+    return FrameDecoder(6, {{0, false, scale, offset}, {2, false, scale, offset}, {4, false, scale, offset}});
+}
+
+FrameDecoder FrameDecoder::spo2Raw(float scale, float offset) {
+    return FrameDecoder(4, {{1, false, scale, offset}});
+}
+
+FrameDecoder FrameDecoder::mcp3426(float scale, float offset) {
+    return FrameDecoder(3, {{0, true, scale, offset}});
+}
+
+bool FrameDecoder::hasSimd() {
+#if defined(FRAME_DECODER_SSE) || defined(FRAME_DECODER_NEON)
+    return true;
+#else
+    return false;
+#endif
+}
+
+void FrameDecoder::decodeScalar(const uint8_t* frames, size_t from, size_t count, float* const* columns) const {
+    for (size_t f = 0; f < _fields.size(); f++) {
+        const FrameField& field = _fields[f];
+        const uint8_t* in = frames + from * _frameBytes + field.byteOffset;
+        float* out = columns[f];
+        for (size_t i = from; i < count; i++, in += _frameBytes) {
+            const uint16_t raw = static_cast<uint16_t>(in[0] << 8 | in[1]);
+            const float value = field.isSigned ? static_cast<float>(static_cast<int16_t>(raw)) : static_cast<float>(raw);
+            out[i] = field.offset + field.scale * value;
+        }
+    }
+}
+
+void FrameDecoder::decode(const uint8_t* frames, size_t count, float* const* columns) const {
+    size_t i = 0;
+#if defined(FRAME_DECODER_SSE) || defined(FRAME_DECODER_NEON)
+    // A step loads _chunks whole vectors: stop while they still lie inside the array
+    const size_t loadBytes = _chunks * 16;
+    for (; _chunks > 0 && i + Lanes <= count && (count - i) * _frameBytes >= loadBytes; i += Lanes) {
+        const uint8_t* block = frames + i * _frameBytes;
+        for (size_t f = 0; f < _fields.size(); f++) {
+            const FrameField& field = _fields[f];
+            const uint8_t* masks = &_masks[f * _chunks * 16];
+#if defined(FRAME_DECODER_SSE)
+            __m128i raw = _mm_setzero_si128();
+            for (size_t c = 0; c < _chunks; c++) {
+                const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 16 * c));
+                const __m128i mask = _mm_loadu_si128(reinterpret_cast<const __m128i*>(masks + 16 * c));
+                raw = _mm_or_si128(raw, _mm_shuffle_epi8(bytes, mask));
+            }
+            __m128i low, high;
+            if (field.isSigned) {
+                low = _mm_srai_epi32(_mm_unpacklo_epi16(raw, raw), 16);
+                high = _mm_srai_epi32(_mm_unpackhi_epi16(raw, raw), 16);
+            } else {
+                low = _mm_unpacklo_epi16(raw, _mm_setzero_si128());
+                high = _mm_unpackhi_epi16(raw, _mm_setzero_si128());
+            }
+            const __m128 scale = _mm_set1_ps(field.scale);
+            const __m128 offset = _mm_set1_ps(field.offset);
+            _mm_storeu_ps(columns[f] + i, _mm_add_ps(offset, _mm_mul_ps(scale, _mm_cvtepi32_ps(low))));
+            _mm_storeu_ps(columns[f] + i + 4, _mm_add_ps(offset, _mm_mul_ps(scale, _mm_cvtepi32_ps(high))));
+#else
+            uint8x16_t gathered = vdupq_n_u8(0);
+            for (size_t c = 0; c < _chunks; c++) {
+                const uint8x16_t bytes = vld1q_u8(block + 16 * c);
+                const uint8x16_t mask = vld1q_u8(masks + 16 * c);
+#if defined(__aarch64__)
+                gathered = vorrq_u8(gathered, vqtbl1q_u8(bytes, mask));
+#else
+                const uint8x8x2_t table = {{vget_low_u8(bytes), vget_high_u8(bytes)}};
+                gathered = vorrq_u8(gathered, vcombine_u8(vtbl2_u8(table, vget_low_u8(mask)),
+                                                          vtbl2_u8(table, vget_high_u8(mask))));
+#endif
+            }
+            const uint16x8_t raw = vreinterpretq_u16_u8(gathered);
+            float32x4_t low, high;
+            if (field.isSigned) {
+                const int16x8_t value = vreinterpretq_s16_u16(raw);
+                low = vcvtq_f32_s32(vmovl_s16(vget_low_s16(value)));
+                high = vcvtq_f32_s32(vmovl_s16(vget_high_s16(value)));
+            } else {
+                low = vcvtq_f32_u32(vmovl_u16(vget_low_u16(raw)));
+                high = vcvtq_f32_u32(vmovl_u16(vget_high_u16(raw)));
+            }
+            const float32x4_t offset = vdupq_n_f32(field.offset);
+            vst1q_f32(columns[f] + i, vaddq_f32(offset, vmulq_n_f32(low, field.scale)));
+            vst1q_f32(columns[f] + i + 4, vaddq_f32(offset, vmulq_n_f32(high, field.scale)));
+#endif
+        }
+    }
+#endif
+    decodeScalar(frames, i, count, columns);
+}
@@ -0,0 +1,61 @@
+#ifndef FRAME_DECODER_H
+#define FRAME_DECODER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// One big-endian 16-bit field of a module frame and its calibration:
+// value = offset + scale * raw
+struct FrameField {
+    uint8_t byteOffset;         // In the frame
+    bool isSigned;              // Two's complement (MCP3426) or unsigned (ADC counts)
+    float scale;
+    float offset;
+};
+
+// Turns arrays of raw module frames, as they come off the hub (HubLink
+// records, ECG bursts), into one float column per field.
+//
+// Eight frames are decoded per step with SSSE3 (x86) or NEON (Pi): the
+// frames are loaded as 16-byte vectors, one table shuffle per vector
+// gathers and byte-swaps a field of all eight, then they are widened,
+// converted and scaled in float lanes. The shuffle masks follow from the
+// layout and are built once by the constructor. Frames longer than
+// MaxFrameBytes, the tail of an array and targets without SIMD take the
+// scalar path, with the same results up to float rounding.
+class FrameDecoder {
+public:
+    static const size_t MaxFrameBytes = 16;     // For the SIMD path
+    static const size_t Lanes = 8;              // Frames per step
+
+    FrameDecoder(size_t frameBytes, const std::vector<FrameField>& fields);
+
+    // ECG frame (NUM_SENSOR_BYTES = 6): LL, LA, RA, unsigned
+    static FrameDecoder ecg(float scale = 1.0f, float offset = 0.0f);
+    // SpO2 registers from 0x00 (4 bytes): status, raw ADC value, LED
+    static FrameDecoder spo2Raw(float scale = 1.0f, float offset = 0.0f);
+    // MCP3426 conversion (3 bytes): signed result, configuration
+    static FrameDecoder mcp3426(float scale = 1.0f, float offset = 0.0f);
+
+    // count frames of getFrameBytes() each, back to back; columns[f] gets
+    // count values of field f
+    void decode(const uint8_t* frames, size_t count, float* const* columns) const;
+
+    size_t getFrameBytes() const { return _frameBytes; }
+    size_t getFields() const { return _fields.size(); }
+    const FrameField& getField(size_t field) const { return _fields[field]; }
+
+    // SIMD path compiled in (SSSE3 or NEON)
+    static bool hasSimd();
+
+private:
+    void decodeScalar(const uint8_t* frames, size_t from, size_t count, float* const* columns) const;
+
+    size_t _frameBytes;
+    std::vector<FrameField> _fields;
+    size_t _chunks;                 // 16-byte vectors per Lanes frames
+    std::vector<uint8_t> _masks;    // Per field and chunk, 16 shuffle indices
+};
+
+#endif // FRAME_DECODER_H
@@ -0,0 +1,167 @@
+#include "MqttTransport.h"
+#include <cstring>
+#include <ctime>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+static const uint8_t CONNECT = 0x10;
+static const uint8_t CONNACK = 0x20;
+static const uint8_t PUBLISH_QOS1 = 0x32;
+static const uint8_t PUBACK = 0x40;
+static const uint8_t PINGREQ = 0xC0;
+static const uint8_t PINGRESP = 0xD0;
+static const uint8_t DISCONNECT = 0xE0;
+static const int TIMEOUT_S = 5;
+
+static uint64_t monotonicNs() {
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<uint64_t>(now.tv_sec) * 1000000000ull + static_cast<uint64_t>(now.tv_nsec);
+}
+
+MqttTransport::MqttTransport(const std::string& host, uint16_t port, const std::string& clientId, uint16_t keepAliveS)
+    : _host(host), _port(port), _clientId(clientId), _keepAliveS(keepAliveS), _socket(-1), _packetId(0),
+      _lastSendNs(0) {}
+
+MqttTransport::~MqttTransport() {
+    disconnect();
+}
+
+void MqttTransport::appendLength(std::string& packet, size_t length) {
+    do {
+        uint8_t digit = static_cast<uint8_t>(length & 0x7F);
+        length >>= 7;
+        if (length != 0) digit |= 0x80;
+        packet.push_back(static_cast<char>(digit));
+    } while (length != 0);
+}
+
+void MqttTransport::appendString(std::string& packet, const std::string& value) {
+    packet.push_back(static_cast<char>(value.size() >> 8));
+    packet.push_back(static_cast<char>(value.size() & 0xFF));
+    packet += value;
+}
+
+bool MqttTransport::sendAll(const void* data, size_t size) {
+    const char* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        const ssize_t sent = send(_socket, bytes, size, MSG_NOSIGNAL);
+        if (sent <= 0) return false;
+        bytes += sent;
+        size -= static_cast<size_t>(sent);
+    }
+    _lastSendNs = monotonicNs();
+    return true;
+}
+
+bool MqttTransport::receiveAll(void* data, size_t size) {
+    char* bytes = static_cast<char*>(data);
+    while (size > 0) {
+        const ssize_t received = recv(_socket, bytes, size, 0);
+        if (received <= 0) return false;  // Closed, or nothing within TIMEOUT_S
+        bytes += received;
+        size -= static_cast<size_t>(received);
+    }
+    return true;
+}
+
+bool MqttTransport::receivePacket(uint8_t& type, std::string& body) {
+    if (!receiveAll(&type, 1)) return false;
+    size_t length = 0;
+    for (int shift = 0;; shift += 7) {
+        uint8_t digit;
+        if (shift > 21 || !receiveAll(&digit, 1)) return false;
+        length |= static_cast<size_t>(digit & 0x7F) << shift;
+        if ((digit & 0x80) == 0) break;
+    }
+    body.resize(length);
+    return length == 0 || receiveAll(&body[0], length);
+}
+
+bool MqttTransport::connect() {
+    disconnect();
+
+    addrinfo hints;
+    std::memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* addresses = nullptr;
+    if (getaddrinfo(_host.c_str(), std::to_string(_port).c_str(), &hints, &addresses) != 0) return false;
+    for (const addrinfo* address = addresses; address != nullptr && _socket == -1; address = address->ai_next) {
+        _socket = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+        if (_socket == -1) continue;
+        timeval timeout = {TIMEOUT_S, 0};
+        setsockopt(_socket, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        setsockopt(_socket, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));  // Also bounds connect()
+        const int one = 1;
+        setsockopt(_socket, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        if (::connect(_socket, address->ai_addr, address->ai_addrlen) != 0) {
+            close(_socket);
+            _socket = -1;
+        }
+    }
+    freeaddrinfo(addresses);
+    if (_socket == -1) return false;
+
+    // Protocol "MQTT" level 4, clean session, keep-alive, client id
+    std::string variable;
+    appendString(variable, "MQTT");
+    variable.push_back(4);
+    variable.push_back(0x02);
+    variable.push_back(static_cast<char>(_keepAliveS >> 8));
+    variable.push_back(static_cast<char>(_keepAliveS & 0xFF));
+    appendString(variable, _clientId);
+    std::string packet(1, static_cast<char>(CONNECT));
+    appendLength(packet, variable.size());
+    packet += variable;
+
+    uint8_t type = 0;
+    std::string body;
+    const bool ok = sendAll(packet.data(), packet.size()) && receivePacket(type, body) && type == CONNACK &&
+                    body.size() == 2 && body[1] == 0;
+    if (!ok) disconnect();
+    return ok;
+}
+
+void MqttTransport::disconnect() {
+    if (_socket == -1) return;
+    const uint8_t packet[2] = {DISCONNECT, 0};
+    send(_socket, packet, sizeof(packet), MSG_NOSIGNAL);
+    close(_socket);
+    _socket = -1;
+}
+
+bool MqttTransport::publish(const std::string& topic, const uint8_t* data, size_t size) {
+    if (_socket == -1) return false;
+    if (++_packetId == 0) _packetId = 1;  // 0 is not a valid packet identifier
+
+    std::string head(1, static_cast<char>(PUBLISH_QOS1));
+    appendLength(head, 2 + topic.size() + 2 + size);
+    appendString(head, topic);
+    head.push_back(static_cast<char>(_packetId >> 8));
+    head.push_back(static_cast<char>(_packetId & 0xFF));
+    if (!sendAll(head.data(), head.size()) || !sendAll(data, size)) return false;
+
+    for (;;) {
+        uint8_t type = 0;
+        std::string body;
+        if (!receivePacket(type, body)) return false;
+        if ((type & 0xF0) != PUBACK || body.size() < 2) continue;  // E.g. a late PINGRESP
+        const uint16_t id = static_cast<uint16_t>(static_cast<uint8_t>(body[0]) << 8 | static_cast<uint8_t>(body[1]));
+        if (id == _packetId) return true;
+    }
+}
+
+bool MqttTransport::idle() {
+    if (_socket == -1) return false;
+    if (monotonicNs() - _lastSendNs < static_cast<uint64_t>(_keepAliveS) * 500000000ull) return true;
+
+    const uint8_t packet[2] = {PINGREQ, 0};
+    uint8_t type = 0;
+    std::string body;
+    return sendAll(packet, sizeof(packet)) && receivePacket(type, body) && (type & 0xF0) == PINGRESP;
+}
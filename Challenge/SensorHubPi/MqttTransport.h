@@ -0,0 +1,40 @@
+#ifndef MQTT_TRANSPORT_H
+#define MQTT_TRANSPORT_H
+
+#include "SampleExporter.h"
+#include <cstdint>
+#include <string>
+
+// Just enough MQTT 3.1.1 for the exporter: CONNECT, PUBLISH at QoS 1 and
+// PINGREQ over plain TCP, nothing subscribed. publish() waits for the
+// PUBACK, so a frame only counts as sent once the broker has it; frames
+// are large enough that one in flight keeps up with the sensors.
+class MqttTransport : public ExportTransport {
+public:
+    MqttTransport(const std::string& host, uint16_t port, const std::string& clientId, uint16_t keepAliveS = 30);
+    ~MqttTransport();
+
+    bool connect() override;
+    void disconnect() override;
+    bool publish(const std::string& topic, const uint8_t* data, size_t size) override;
+    bool idle() override;
+
+private:
+    static void appendLength(std::string& packet, size_t length);
+    static void appendString(std::string& packet, const std::string& value);
+
+    bool sendAll(const void* data, size_t size);
+    bool receiveAll(void* data, size_t size);
+    // Next packet from the broker: its first byte and body
+    bool receivePacket(uint8_t& type, std::string& body);
+
+    std::string _host;
+    uint16_t _port;
+    std::string _clientId;
+    uint16_t _keepAliveS;
+    int _socket;
+    uint16_t _packetId;
+    uint64_t _lastSendNs;
+};
+
+#endif // MQTT_TRANSPORT_H
@@ -0,0 +1,188 @@
+#include "Pipeline.h"
+#include <chrono>
+#include <pthread.h>
+#include <sched.h>
+
+static uint64_t monotonicNs() {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+}
+
+// Bucket b holds latencies below 2^b ns
+static uint32_t bucketOf(uint64_t ns, uint32_t buckets) {
+    uint32_t bucket = 0;
+    while (bucket + 1 < buckets && (1ull << bucket) <= ns) bucket++;
+    return bucket;
+}
+
+// Arena of the stage running on this thread
+static thread_local BatchArena* threadArena = nullptr;
+
+Pipeline::Pipeline() : _stopping(false), _arenaBytes(256 * 1024) {}
+
+Pipeline::~Pipeline() {
+    stop();
+}
+
+int Pipeline::addSource(const std::string& name, int core, std::function<uint32_t()> produce) {
+    const int index = add(name, core, std::move(produce), nullptr, 0, nullptr);
+    _stages[index]->isSource = true;
+    return index;
+}
+
+int Pipeline::add(const std::string& name, int core, std::function<uint32_t()> step, std::function<uint32_t()> depth,
+                  uint32_t capacity, std::function<uint64_t()> fullWaits) {
+    if (isRunning()) return -1;
+    std::unique_ptr<Stage> stage(new Stage);
+    stage->name = name;
+    stage->core = core;
+    stage->isSource = false;
+    stage->step = std::move(step);
+    stage->depth = std::move(depth);
+    stage->capacity = capacity;
+    stage->fullWaits = std::move(fullWaits);
+    stage->reportedFullWaits = 0;
+    stage->pinned = false;
+    stage->finished = false;
+    stage->queueMax = 0;
+    stage->items = 0;
+    stage->batches = 0;
+    stage->busyNs = 0;
+    stage->latencyMaxNs = 0;
+    for (std::atomic<uint64_t>& bucket : stage->latency) bucket = 0;
+    stage->arenaHighWater = 0;
+    stage->arenaCapacity = 0;
+    stage->arenaHeapCalls = 0;
+    stage->reportedHeapCalls = 0;
+    _stages.push_back(std::move(stage));
+    return static_cast<int>(_stages.size() - 1);
+}
+
+bool Pipeline::start() {
+    if (isRunning() || _stages.empty()) return false;
+    _stopping = false;
+    for (std::unique_ptr<Stage>& stage : _stages) stage->finished = false;
+    for (size_t i = 0; i < _stages.size(); i++) _threads.emplace_back(&Pipeline::run, this, i);
+    return true;
+}
+
+void Pipeline::stop() {
+    if (!isRunning()) return;
+    _stopping = true;
+    for (std::thread& thread : _threads) thread.join();
+    _threads.clear();
+}
+
+std::pmr::memory_resource* Pipeline::batchResource() {
+    if (threadArena != nullptr) return threadArena;
+    return std::pmr::get_default_resource();
+}
+
+bool Pipeline::upstreamFinished(size_t index) const {
+    for (size_t i = 0; i < index; i++) {
+        if (!_stages[i]->finished.load(std::memory_order_acquire)) return false;
+    }
+    return true;
+}
+
+void Pipeline::run(size_t index) {
+    Stage& stage = *_stages[index];
+    if (stage.core >= 0 && stage.core < CPU_SETSIZE) {
+        cpu_set_t cores;
+        CPU_ZERO(&cores);
+        CPU_SET(stage.core, &cores);
+        stage.pinned = pthread_setaffinity_np(pthread_self(), sizeof(cores), &cores) == 0;
+    }
+    pthread_setname_np(pthread_self(), stage.name.substr(0, 15).c_str());
+
+    // Allocated here, after pinning: the first touch puts it near the core
+    BatchArena arena(_arenaBytes);
+    threadArena = &arena;
+
+    for (uint32_t idle = 0;;) {
+        if (stage.isSource && _stopping.load(std::memory_order_acquire)) break;
+        if (stage.depth) {
+            const uint32_t depth = stage.depth();
+            if (depth > stage.queueMax.load(std::memory_order_relaxed)) stage.queueMax.store(depth, std::memory_order_relaxed);
+        }
+
+        const uint64_t startNs = monotonicNs();
+        const uint32_t count = stage.step();
+        if (arena.getUsed() != 0) {
+            arena.reset();
+            if (arena.getHighWater() > stage.arenaHighWater.load(std::memory_order_relaxed)) {
+                stage.arenaHighWater.store(arena.getHighWater(), std::memory_order_relaxed);
+            }
+            stage.arenaCapacity.store(arena.getCapacity(), std::memory_order_relaxed);
+            stage.arenaHeapCalls.store(arena.getHeapCalls(), std::memory_order_relaxed);
+        }
+        if (count != 0) {
+            const uint64_t ns = monotonicNs() - startNs;
+            stage.items.fetch_add(count, std::memory_order_relaxed);
+            stage.batches.fetch_add(1, std::memory_order_relaxed);
+            stage.busyNs.fetch_add(ns, std::memory_order_relaxed);
+            stage.latency[bucketOf(ns, LatencyBuckets)].fetch_add(1, std::memory_order_relaxed);
+            if (ns > stage.latencyMaxNs.load(std::memory_order_relaxed)) stage.latencyMaxNs.store(ns, std::memory_order_relaxed);
+            idle = 0;
+            continue;
+        }
+
+        // Done once everything before it is done and nothing is left to read
+        if (!stage.isSource && _stopping.load(std::memory_order_acquire) && upstreamFinished(index) &&
+            stage.depth() == 0) {
+            break;
+        }
+        if (++idle < 64) continue;
+        if (idle < 128) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+    threadArena = nullptr;
+    stage.finished.store(true, std::memory_order_release);
+}
+
+std::vector<StageMetrics> Pipeline::metrics() {
+    std::vector<StageMetrics> result;
+    for (std::unique_ptr<Stage>& stage : _stages) {
+        StageMetrics m;
+        m.name = stage->name;
+        m.core = stage->core;
+        m.pinned = stage->pinned.load();
+        m.items = stage->items.exchange(0);
+        m.batches = stage->batches.exchange(0);
+        m.busyNs = stage->busyNs.exchange(0);
+        m.latencyMaxNs = stage->latencyMaxNs.exchange(0);
+
+        uint64_t counts[LatencyBuckets];
+        uint64_t total = 0;
+        for (uint32_t b = 0; b < LatencyBuckets; b++) total += counts[b] = stage->latency[b].exchange(0);
+        m.latencyP50Ns = 0;
+        m.latencyP99Ns = 0;
+        uint64_t seen = 0;
+        for (uint32_t b = 0; b < LatencyBuckets && total != 0; b++) {
+            seen += counts[b];
+            if (m.latencyP50Ns == 0 && seen * 2 >= total) m.latencyP50Ns = 1ull << b;
+            if (seen * 100 >= total * 99) {
+                m.latencyP99Ns = 1ull << b;
+                break;
+            }
+        }
+
+        m.queueDepth = stage->depth ? stage->depth() : 0;
+        m.queueMax = stage->queueMax.exchange(0);
+        m.queueCapacity = stage->capacity;
+        const uint64_t fullWaits = stage->fullWaits ? stage->fullWaits() : 0;
+        m.fullWaits = fullWaits - stage->reportedFullWaits;
+        stage->reportedFullWaits = fullWaits;
+        m.arenaHighWater = stage->arenaHighWater.load();
+        m.arenaCapacity = stage->arenaCapacity.load();
+        const uint64_t heapCalls = stage->arenaHeapCalls.load();
+        m.arenaHeapCalls = heapCalls - stage->reportedHeapCalls;
+        stage->reportedHeapCalls = heapCalls;
+        result.push_back(m);
+    }
+    return result;
+}
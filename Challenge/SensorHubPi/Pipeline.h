@@ -0,0 +1,214 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include "BatchArena.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Bounded ring between two pipeline stages: one producer thread, one
+// consumer thread, no locks. Both sides keep a cached copy of the other's
+// index and only reload it when the ring looks full or empty, so in steady
+// state neither touches the other's cache line. The consumer reads
+// batches in place (peek/release).
+template <typename T>
+class SpscRing {
+    static_assert(std::is_trivially_copyable<T>::value, "Ring items are copied as raw memory");
+
+public:
+    // capacity is rounded up to a power of two
+    explicit SpscRing(uint32_t capacity)
+        : _mask(roundUp(capacity) - 1), _slots(new T[_mask + 1]), _head(0), _tail(0), _fullWaits(0), _cachedTail(0),
+          _cachedHead(0) {}
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    // --- Producer ---
+
+    bool tryPush(const T& item) {
+        const uint64_t head = _head.load(std::memory_order_relaxed);
+        if (head - _cachedTail > _mask) {
+            _cachedTail = _tail.load(std::memory_order_acquire);
+            if (head - _cachedTail > _mask) return false;
+        }
+        _slots[head & _mask] = item;
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Waits while the ring is full: the consumer sets the pace
+    void push(const T& item) {
+        if (tryPush(item)) return;
+        _fullWaits.fetch_add(1, std::memory_order_relaxed);
+        for (uint32_t spin = 0; !tryPush(item); spin++) {
+            if (spin >= 64) std::this_thread::yield();
+        }
+    }
+
+    // --- Consumer ---
+
+    // Up to maxItems readable items in one run (shorter at the end of the ring)
+    uint32_t peek(const T*& items, uint32_t maxItems) {
+        const uint64_t tail = _tail.load(std::memory_order_relaxed);
+        if (_cachedHead == tail) {
+            _cachedHead = _head.load(std::memory_order_acquire);
+            if (_cachedHead == tail) return 0;
+        }
+        const uint64_t start = tail & _mask;
+        uint64_t count = _cachedHead - tail;
+        if (count > _mask + 1 - start) count = _mask + 1 - start;
+        if (count > maxItems) count = maxItems;
+        items = &_slots[start];
+        return static_cast<uint32_t>(count);
+    }
+
+    // Hand count peeked items back to the producer
+    void release(uint32_t count) { _tail.store(_tail.load(std::memory_order_relaxed) + count, std::memory_order_release); }
+
+    // --- Either side ---
+
+    uint32_t getDepth() const {
+        return static_cast<uint32_t>(_head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire));
+    }
+    uint32_t getCapacity() const { return _mask + 1; }
+    uint64_t getFullWaits() const { return _fullWaits.load(std::memory_order_relaxed); }
+
+private:
+    static uint32_t roundUp(uint32_t capacity) {
+        uint32_t size = 2;
+        while (size < capacity) size <<= 1;
+        return size;
+    }
+
+    const uint32_t _mask;
+    std::unique_ptr<T[]> _slots;
+    alignas(64) std::atomic<uint64_t> _head;        // Next slot the producer writes
+    alignas(64) std::atomic<uint64_t> _tail;        // Next slot the consumer reads
+    alignas(64) std::atomic<uint64_t> _fullWaits;   // Pushes that found the ring full
+    uint64_t _cachedTail;                           // Producer's copy
+    alignas(64) uint64_t _cachedHead;               // Consumer's copy
+};
+
+// Counters of one stage since the previous Pipeline::metrics() call
+struct StageMetrics {
+    std::string name;
+    int core;                   // -1: not pinned
+    bool pinned;                // The affinity was applied
+    uint64_t items;
+    uint64_t batches;
+    uint64_t busyNs;            // Time spent in the stage's own work
+    uint64_t latencyP50Ns;      // Per batch, from a log2 histogram (upper bounds)
+    uint64_t latencyP99Ns;
+    uint64_t latencyMaxNs;
+    uint32_t queueDepth;        // Input ring, now and the highest seen
+    uint32_t queueMax;
+    uint32_t queueCapacity;     // 0 for a source
+    uint64_t fullWaits;         // Upstream pushes that found the input ring full
+    size_t arenaHighWater;      // Most arena bytes one batch used
+    size_t arenaCapacity;
+    uint64_t arenaHeapCalls;    // Arena blocks allocated: 0 in steady state
+};
+
+// Staged processing on the gateway: acquisition, decode, QRS detection,
+// alarms, compression, export, each on its own thread, optionally pinned
+// to a core, with an SpscRing between consecutive stages.
+//
+// A source produces items (returns how many, 0 when there was nothing).
+// A stage takes batches of up to batchSize items from its input ring, in
+// place, and pushes its results into the ring of the next stage, which
+// waits while that ring is full. An idle thread spins briefly, then yields,
+// then sleeps in 50 us steps.
+//
+// Stages are added in order from the sources downstream. stop() ends the
+// sources; every other stage finishes once the stages before it are done
+// and its input is empty, so nothing in flight is lost.
+//
+// Every thread has its own BatchArena for the temporary buffers of a
+// batch, reset after each step: batchResource() inside a source or stage.
+// Once the arenas have grown to the largest batch, the stages make no
+// heap calls and never contend on the allocator.
+class Pipeline {
+public:
+    Pipeline();
+    ~Pipeline();
+
+    Pipeline(const Pipeline&) = delete;
+    Pipeline& operator=(const Pipeline&) = delete;
+
+    // core: CPU to pin the thread to, -1 to leave it to the scheduler
+    int addSource(const std::string& name, int core, std::function<uint32_t()> produce);
+
+    template <typename In>
+    int addStage(const std::string& name, int core, SpscRing<In>& input, uint32_t batchSize,
+                 std::function<void(const In* items, uint32_t count)> process) {
+        SpscRing<In>* ring = &input;
+        const uint32_t batch = batchSize != 0 ? batchSize : 1;
+        return add(name, core,
+                   [ring, batch, process]() {
+                       const In* items = nullptr;
+                       const uint32_t count = ring->peek(items, batch);
+                       if (count == 0) return 0u;
+                       process(items, count);
+                       ring->release(count);
+                       return count;
+                   },
+                   [ring]() { return ring->getDepth(); }, ring->getCapacity(), [ring]() { return ring->getFullWaits(); });
+    }
+
+    // Initial arena block of every thread (default 256 KiB); call before start()
+    void setArenaBytes(size_t bytes) { _arenaBytes = bytes; }
+
+    // The arena of the calling source or stage, freed when its step
+    // returns; the default resource on any other thread
+    static std::pmr::memory_resource* batchResource();
+
+    bool start();
+    void stop();        // Drains the stages, then joins the threads
+    bool isRunning() const { return !_threads.empty(); }
+
+    std::vector<StageMetrics> metrics();
+
+private:
+    static const uint32_t LatencyBuckets = 40;   // 2^39 ns: 9 minutes
+
+    struct Stage {
+        std::string name;
+        int core;
+        bool isSource;
+        std::function<uint32_t()> step;
+        std::function<uint32_t()> depth;
+        uint32_t capacity;
+        std::function<uint64_t()> fullWaits;
+        uint64_t reportedFullWaits;
+        std::atomic<bool> pinned;
+        std::atomic<bool> finished;
+        std::atomic<uint32_t> queueMax;
+        std::atomic<uint64_t> items;
+        std::atomic<uint64_t> batches;
+        std::atomic<uint64_t> busyNs;
+        std::atomic<uint64_t> latencyMaxNs;
+        std::atomic<uint64_t> latency[LatencyBuckets];
+        std::atomic<size_t> arenaHighWater;
+        std::atomic<size_t> arenaCapacity;
+        std::atomic<uint64_t> arenaHeapCalls;
+        uint64_t reportedHeapCalls;
+    };
+
+    int add(const std::string& name, int core, std::function<uint32_t()> step, std::function<uint32_t()> depth,
+            uint32_t capacity, std::function<uint64_t()> fullWaits);
+    void run(size_t index);
+    bool upstreamFinished(size_t index) const;
+
+    std::vector<std::unique_ptr<Stage>> _stages;
+    std::vector<std::thread> _threads;
+    std::atomic<bool> _stopping;
+    size_t _arenaBytes;
+};
+
+#endif // PIPELINE_H
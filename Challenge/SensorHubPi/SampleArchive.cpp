@@ -0,0 +1,507 @@
+#include "SampleArchive.h"
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const uint32_t BLOCK_MAGIC = 0x56534142;  // "VSAB"
+static const uint32_t NO_BLOCK = 0xFFFFFFFF;
+static const uint8_t NO_WINDOW = 0xFF;
+static const uint32_t MAX_SAMPLE_BITS = 4 + 32 + 2 + 5 + 5 + 32;  // Largest timestamp plus largest value code
+static const size_t PAGE = 4096;
+
+static_assert(SampleArchive::BlockSize <= PAGE && PAGE % SampleArchive::BlockSize == 0,
+              "A block is synced as part of one page");
+
+// MSB first into a zeroed payload
+static void putBits(uint8_t* payload, uint32_t& bit, uint32_t value, uint8_t n) {
+    while (n > 0) {
+        const uint8_t free = 8 - (bit & 7);
+        const uint8_t take = n < free ? n : free;
+        const uint32_t chunk = (value >> (n - take)) & ((1u << take) - 1);
+        payload[bit >> 3] |= static_cast<uint8_t>(chunk << (free - take));
+        bit += take;
+        n -= take;
+    }
+}
+
+static uint32_t getBits(const uint8_t* payload, uint32_t& bit, uint8_t n) {
+    uint32_t value = 0;
+    while (n > 0) {
+        const uint8_t left = 8 - (bit & 7);
+        const uint8_t take = n < left ? n : left;
+        const uint32_t chunk = (payload[bit >> 3] >> (left - take)) & ((1u << take) - 1);
+        value = (value << take) | chunk;
+        bit += take;
+        n -= take;
+    }
+    return value;
+}
+
+static int32_t signExtend(uint32_t value, uint8_t bits) {
+    const uint32_t sign = 1u << (bits - 1);
+    return static_cast<int32_t>((value ^ sign) - sign);
+}
+
+static uint32_t floatBits(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static float bitsFloat(uint32_t bits) {
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Delta-of-delta codes: prefix, field bits (Gorilla, section 4.1.1)
+struct TimeCode {
+    uint32_t prefix;
+    uint8_t prefixBits;
+    uint8_t bits;
+};
+
+static const TimeCode TIME_CODES[] = { {0x2, 2, 7}, {0x6, 3, 9}, {0xE, 4, 12}, {0xF, 4, 32} };
+
+SampleArchive::Cursor::Cursor(const SampleArchive* archive, std::vector<uint32_t> blocks, uint64_t fromNs,
+                              uint64_t toNs)
+    : _archive(archive), _blocks(std::move(blocks)), _next(0), _active(false), _block(0), _sequence(0), _state(),
+      _fromNs(fromNs), _toNs(toNs) {}
+
+bool SampleArchive::Cursor::next(SampleRecord& sample) {
+    for (;;) {
+        if (!_active) {
+            if (_next >= _blocks.size()) return false;
+            _block = _blocks[_next++];
+            const BlockHeader& header = _archive->header(_block);
+            _sequence = header.sequence;
+            if (header.state.load(std::memory_order_acquire) == Sealed &&
+                header.check != checksum(_archive->payload(_block), header.bits.load(std::memory_order_relaxed))) {
+                continue;  // Damaged on disk
+            }
+            _state = State();
+            _active = true;
+        }
+
+        const BlockHeader& header = _archive->header(_block);
+        if (!decodeNext(header, _archive->payload(_block), _state) || header.sequence != _sequence) {
+            _active = false;  // End of the block, or the writer reused it meanwhile
+            continue;
+        }
+
+        const uint64_t timestampNs = _state.time * header.resolutionNs;
+        if (timestampNs > _toNs) {
+            _next = _blocks.size();  // Later blocks of the channel are later still
+            _active = false;
+            return false;
+        }
+        if (timestampNs < _fromNs) continue;
+
+        sample.timestampNs = timestampNs;
+        sample.channel = header.channel;
+        sample.flags = header.flags;
+        sample.value = bitsFloat(_state.value);
+        sample.sequence = 0;
+        sample.check = 0;
+        return true;
+    }
+}
+
+SampleArchive::SampleArchive()
+    : _memory(nullptr), _fileSize(0), _blockCount(0), _resolutionNs(DefaultResolutionNs), _writable(false),
+      _nextBlock(0), _nextSequence(1), _syncIntervalNs(DefaultSyncIntervalNs), _lastSyncNs(0), _syncs(0) {}
+
+SampleArchive::~SampleArchive() {
+    close();
+}
+
+// FNV-1a over the written payload bytes
+uint32_t SampleArchive::checksum(const uint8_t* payload, uint32_t bits) {
+    uint32_t hash = 2166136261u;
+    for (uint32_t i = 0; i < (bits + 7) / 8; i++) {
+        hash = (hash ^ payload[i]) * 16777619u;
+    }
+    return hash;
+}
+
+SampleArchive::BlockHeader& SampleArchive::header(uint32_t block) const {
+    return *reinterpret_cast<BlockHeader*>(_memory + static_cast<size_t>(block) * BlockSize);
+}
+
+uint8_t* SampleArchive::payload(uint32_t block) const {
+    return _memory + static_cast<size_t>(block) * BlockSize + sizeof(BlockHeader);
+}
+
+// The sample after state; the first one comes from the header
+bool SampleArchive::decodeNext(const BlockHeader& header, const uint8_t* payload, Cursor::State& state) {
+    const uint32_t count = header.count.load(std::memory_order_acquire);
+    if (state.index >= count) return false;
+    if (state.index == 0) {
+        state.time = header.firstTime;
+        state.delta = 0;
+        state.value = header.firstValue;
+        state.leading = NO_WINDOW;
+        state.trailing = 0;
+        state.bit = 0;
+        state.index = 1;
+        return true;
+    }
+    if (state.bit + MAX_SAMPLE_BITS > PayloadBits) return false;  // encode() keeps this much room
+
+    // Timestamp: '0' = same delta, else the first code with a zero prefix bit
+    int64_t dod = 0;
+    if (getBits(payload, state.bit, 1) != 0) {
+        uint8_t code = 0;
+        while (code < 3 && getBits(payload, state.bit, 1) != 0) code++;
+        dod = signExtend(getBits(payload, state.bit, TIME_CODES[code].bits), TIME_CODES[code].bits);
+    }
+    state.delta += dod;
+    state.time += static_cast<uint64_t>(state.delta);
+
+    // Value: '0' = unchanged, '10' = inside the previous window, '11' = new window
+    if (getBits(payload, state.bit, 1) != 0) {
+        if (getBits(payload, state.bit, 1) != 0) {
+            state.leading = static_cast<uint8_t>(getBits(payload, state.bit, 5));
+            const uint8_t length = static_cast<uint8_t>(getBits(payload, state.bit, 5) + 1);
+            state.trailing = static_cast<uint8_t>(32 - state.leading - length);
+        } else if (state.leading == NO_WINDOW) {
+            return false;  // Damaged: no window to reuse yet
+        }
+        const uint8_t length = static_cast<uint8_t>(32 - state.leading - state.trailing);
+        state.value ^= getBits(payload, state.bit, length) << state.trailing;
+    }
+    state.index++;
+    return true;
+}
+
+bool SampleArchive::open(const std::string& directory, uint32_t blocks, uint32_t resolutionNs) {
+    close();
+    if (blocks < 2 || resolutionNs == 0) return false;
+
+    mkdir(directory.c_str(), 0755);
+    _path = directory + "/archive.dat";
+    const int fd = ::open(_path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd == -1) return false;
+
+    _fileSize = static_cast<size_t>(blocks) * BlockSize;
+    struct stat info;
+    bool ok = fstat(fd, &info) == 0;
+    // Reserve the blocks now: a full disk fails here, not as SIGBUS in append()
+    if (ok && static_cast<size_t>(info.st_size) != _fileSize) {
+        ok = ftruncate(fd, 0) == 0 && posix_fallocate(fd, 0, static_cast<off_t>(_fileSize)) == 0;
+    }
+    void* memory = ok ? mmap(nullptr, _fileSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+    ::close(fd);
+    if (memory == MAP_FAILED) return false;
+
+    _memory = static_cast<uint8_t*>(memory);
+    _blockCount = blocks;
+    _resolutionNs = resolutionNs;
+    _writable = true;
+
+    // Continue after the newest block; every channel resumes its newest open
+    // block at the last synced sample
+    uint64_t newest = 0;
+    for (uint32_t b = 0; b < blocks; b++) {
+        const BlockHeader& block = header(b);
+        if (block.magic != BLOCK_MAGIC || block.state.load(std::memory_order_relaxed) == Empty) continue;
+        if (block.sequence > newest) {
+            newest = block.sequence;
+            _nextBlock = (b + 1) % blocks;
+        }
+        if (block.state.load(std::memory_order_relaxed) != Open) continue;
+
+        Writer& writer = *writerFor(block.channel);
+        uint32_t older = b;
+        if (writer.block == NO_BLOCK || header(writer.block).sequence < block.sequence) std::swap(writer.block, older);
+        if (older != NO_BLOCK) {
+            Writer stale{block.channel, older, Cursor::State()};
+            seal(stale);  // Power lost between claiming a block and sealing the one before
+        }
+    }
+    _nextSequence = newest + 1;
+
+    for (Writer& writer : _writers) {
+        BlockHeader& block = header(writer.block);
+        block.count.store(block.syncedCount, std::memory_order_relaxed);
+        block.bits.store(block.syncedBits, std::memory_order_relaxed);
+        uint8_t* bytes = payload(writer.block);
+        const uint32_t whole = block.syncedBits / 8;
+        const uint32_t partial = block.syncedBits % 8;
+        if (partial != 0) bytes[whole] &= static_cast<uint8_t>(0xFF00 >> partial);
+        const uint32_t kept = whole + (partial != 0 ? 1 : 0);
+        memset(bytes + kept, 0, PayloadBits / 8 - kept);  // Unsynced bits would corrupt the next codes
+
+        while (decodeNext(block, bytes, writer.state)) {}
+        block.lastTime.store(writer.state.time, std::memory_order_relaxed);
+        if (block.resolutionNs != _resolutionNs) seal(writer);
+    }
+    return true;
+}
+
+bool SampleArchive::openReadOnly(const std::string& directory) {
+    close();
+    _path = directory + "/archive.dat";
+    const int fd = ::open(_path.c_str(), O_RDONLY);
+    if (fd == -1) return false;
+
+    struct stat info;
+    bool ok = fstat(fd, &info) == 0 && info.st_size > 0 && info.st_size % BlockSize == 0;
+    void* memory = MAP_FAILED;
+    if (ok) {
+        _fileSize = static_cast<size_t>(info.st_size);
+        memory = mmap(nullptr, _fileSize, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+    if (memory == MAP_FAILED) return false;
+
+    _memory = static_cast<uint8_t*>(memory);
+    _blockCount = static_cast<uint32_t>(_fileSize / BlockSize);
+    _writable = false;
+    return true;
+}
+
+void SampleArchive::close() {
+    if (_memory != nullptr) {
+        if (_writable) flush();
+        munmap(_memory, _fileSize);
+    }
+    _memory = nullptr;
+    _blockCount = 0;
+    _writers.clear();
+    _nextBlock = 0;
+    _nextSequence = 1;
+    _lastSyncNs = 0;
+}
+
+bool SampleArchive::syncBlock(uint32_t block) {
+    const size_t page = (static_cast<size_t>(block) * BlockSize) & ~(PAGE - 1);
+    _syncs++;
+    return msync(_memory + page, std::min(PAGE, _fileSize - page), MS_SYNC) == 0;
+}
+
+SampleArchive::Writer* SampleArchive::writerFor(uint16_t channel) {
+    for (Writer& writer : _writers) {
+        if (writer.channel == channel) return &writer;
+    }
+    _writers.push_back(Writer{channel, NO_BLOCK, Cursor::State()});
+    return &_writers.back();
+}
+
+bool SampleArchive::seal(Writer& writer) {
+    BlockHeader& block = header(writer.block);
+    const uint32_t bits = block.bits.load(std::memory_order_relaxed);
+    block.check = checksum(payload(writer.block), bits);
+    block.syncedCount = block.count.load(std::memory_order_relaxed);
+    block.syncedBits = bits;
+    block.state.store(Sealed, std::memory_order_release);
+    const bool ok = syncBlock(writer.block);
+    writer.block = NO_BLOCK;
+    return ok;
+}
+
+// Claim the oldest slot for the channel, with its first sample in the header
+bool SampleArchive::startBlock(Writer& writer, uint64_t time, float value, uint16_t flags) {
+    const uint32_t b = _nextBlock;
+    for (Writer& other : _writers) {
+        if (other.block == b) seal(other);  // Idle for a whole ring: its block is the oldest
+    }
+
+    BlockHeader& block = header(b);
+    block.state.store(Empty, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    memset(payload(b), 0, PayloadBits / 8);
+    block.magic = BLOCK_MAGIC;
+    block.sequence = _nextSequence++;
+    block.channel = writer.channel;
+    block.flags = flags;
+    block.resolutionNs = _resolutionNs;
+    block.firstTime = time;
+    block.firstValue = floatBits(value);
+    block.bits.store(0, std::memory_order_relaxed);
+    block.syncedCount = 1;
+    block.syncedBits = 0;
+    block.check = 0;
+    block.lastTime.store(time, std::memory_order_relaxed);
+    block.count.store(1, std::memory_order_relaxed);
+    block.state.store(Open, std::memory_order_release);
+
+    writer.block = b;
+    writer.state = Cursor::State();
+    decodeNext(block, payload(b), writer.state);  // State after the first sample
+    _nextBlock = (b + 1) % _blockCount;
+    return syncBlock(b);  // Once per block: a stale block can never pass as new
+}
+
+// Code one more sample into the open block; false if it does not fit
+bool SampleArchive::encode(Writer& writer, uint64_t time, float value) {
+    Cursor::State& state = writer.state;
+    if (state.bit + MAX_SAMPLE_BITS > PayloadBits) return false;
+    const int64_t delta = static_cast<int64_t>(time - state.time);
+    const int64_t dod = delta - state.delta;
+    if (dod < INT32_MIN || dod > INT32_MAX) return false;  // A gap of more than 2^31 units
+
+    uint8_t* bytes = payload(writer.block);
+    if (dod == 0) {
+        putBits(bytes, state.bit, 0, 1);
+    } else {
+        uint8_t code = 0;
+        while (code < 3 && (dod < -(1ll << (TIME_CODES[code].bits - 1)) || dod >= (1ll << (TIME_CODES[code].bits - 1)))) {
+            code++;
+        }
+        putBits(bytes, state.bit, TIME_CODES[code].prefix, TIME_CODES[code].prefixBits);
+        putBits(bytes, state.bit, static_cast<uint32_t>(dod), TIME_CODES[code].bits);
+    }
+
+    const uint32_t bits = floatBits(value);
+    const uint32_t xored = bits ^ state.value;
+    if (xored == 0) {
+        putBits(bytes, state.bit, 0, 1);
+    } else {
+        const uint8_t leading = static_cast<uint8_t>(__builtin_clz(xored));
+        const uint8_t trailing = static_cast<uint8_t>(__builtin_ctz(xored));
+        if (state.leading != NO_WINDOW && leading >= state.leading && trailing >= state.trailing) {
+            putBits(bytes, state.bit, 0x2, 2);
+        } else {
+            putBits(bytes, state.bit, 0x3, 2);
+            putBits(bytes, state.bit, leading, 5);
+            putBits(bytes, state.bit, 31u - leading - trailing, 5);  // Length - 1
+            state.leading = leading;
+            state.trailing = trailing;
+        }
+        putBits(bytes, state.bit, xored >> state.trailing, static_cast<uint8_t>(32 - state.leading - state.trailing));
+    }
+
+    state.time = time;
+    state.delta = delta;
+    state.value = bits;
+    state.index++;
+
+    BlockHeader& block = header(writer.block);
+    block.bits.store(state.bit, std::memory_order_relaxed);
+    block.lastTime.store(time, std::memory_order_relaxed);
+    block.count.store(state.index, std::memory_order_release);  // Readers see the sample complete
+    return true;
+}
+
+bool SampleArchive::append(uint16_t channel, float value, uint16_t flags) {
+    timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    return append(static_cast<uint64_t>(now.tv_sec) * 1000000000ull + static_cast<uint64_t>(now.tv_nsec), channel,
+                  value, flags);
+}
+
+bool SampleArchive::append(uint64_t timestampNs, uint16_t channel, float value, uint16_t flags) {
+    if (_memory == nullptr || !_writable) return false;
+
+    Writer& writer = *writerFor(channel);
+    uint64_t time = timestampNs / _resolutionNs;
+    bool ok = true;
+    bool stored = false;
+    if (writer.block != NO_BLOCK) {
+        if (time < writer.state.time) time = writer.state.time;  // Clock stepped back
+        stored = header(writer.block).flags == flags && encode(writer, time, value);
+        if (!stored) ok = seal(writer);  // Full, new flags or a long gap
+    }
+    if (!stored) ok = startBlock(writer, time, value, flags) && ok;
+
+    if (_syncIntervalNs != 0 && timestampNs - _lastSyncNs >= _syncIntervalNs) {
+        _lastSyncNs = timestampNs;
+        ok = flush() && ok;
+    }
+    return ok;
+}
+
+bool SampleArchive::flush() {
+    if (_memory == nullptr || !_writable) return false;
+    bool ok = true;
+    for (const Writer& writer : _writers) {
+        if (writer.block == NO_BLOCK) continue;
+        BlockHeader& block = header(writer.block);
+        block.syncedCount = block.count.load(std::memory_order_relaxed);
+        block.syncedBits = block.bits.load(std::memory_order_relaxed);
+        ok = syncBlock(writer.block) && ok;
+    }
+    return ok;
+}
+
+// Slots of the channel (-1 = all) that overlap the range, in recording order
+std::vector<uint32_t> SampleArchive::blocksInOrder(int channel, uint64_t fromNs, uint64_t toNs) const {
+    std::vector<std::pair<uint64_t, uint32_t>> found;
+    for (uint32_t b = 0; b < _blockCount; b++) {
+        const BlockHeader& block = header(b);
+        if (block.magic != BLOCK_MAGIC || block.state.load(std::memory_order_acquire) == Empty) continue;
+        if (channel >= 0 && block.channel != channel) continue;
+        if (block.count.load(std::memory_order_relaxed) == 0 || block.firstTime * block.resolutionNs > toNs ||
+            block.lastTime.load(std::memory_order_relaxed) * block.resolutionNs < fromNs) {
+            continue;
+        }
+        found.emplace_back(block.sequence, b);
+    }
+    std::sort(found.begin(), found.end());
+
+    std::vector<uint32_t> blocks;
+    blocks.reserve(found.size());
+    for (const auto& entry : found) blocks.push_back(entry.second);
+    return blocks;
+}
+
+SampleArchive::Cursor SampleArchive::scan(uint16_t channel, uint64_t fromNs, uint64_t toNs) const {
+    if (_memory == nullptr) return Cursor(this, std::vector<uint32_t>(), fromNs, toNs);
+    return Cursor(this, blocksInOrder(channel, fromNs, toNs), fromNs, toNs);
+}
+
+uint64_t SampleArchive::query(uint64_t fromNs, uint64_t toNs, const SampleRecorder::Visitor& visit,
+                              int channel) const {
+    if (_memory == nullptr) return 0;
+
+    // One cursor per channel, merged on the timestamp
+    std::vector<uint16_t> channels;
+    for (uint32_t b : blocksInOrder(channel, fromNs, toNs)) {
+        const uint16_t c = header(b).channel;
+        if (std::find(channels.begin(), channels.end(), c) == channels.end()) channels.push_back(c);
+    }
+    std::vector<Cursor> cursors;
+    std::vector<SampleRecord> heads(channels.size());
+    std::vector<bool> valid(channels.size());
+    for (size_t i = 0; i < channels.size(); i++) {
+        cursors.push_back(scan(channels[i], fromNs, toNs));
+        valid[i] = cursors[i].next(heads[i]);
+    }
+
+    uint64_t visited = 0;
+    for (;;) {
+        size_t oldest = channels.size();
+        for (size_t i = 0; i < channels.size(); i++) {
+            if (valid[i] && (oldest == channels.size() || heads[i].timestampNs < heads[oldest].timestampNs)) oldest = i;
+        }
+        if (oldest == channels.size()) return visited;
+        visit(heads[oldest]);
+        visited++;
+        valid[oldest] = cursors[oldest].next(heads[oldest]);
+    }
+}
+
+uint64_t SampleArchive::getSamples() const {
+    uint64_t samples = 0;
+    for (uint32_t b = 0; b < _blockCount; b++) {
+        const BlockHeader& block = header(b);
+        if (block.magic == BLOCK_MAGIC && block.state.load(std::memory_order_acquire) != Empty) {
+            samples += block.count.load(std::memory_order_relaxed);
+        }
+    }
+    return samples;
+}
+
+uint32_t SampleArchive::getBlocksUsed() const {
+    uint32_t used = 0;
+    for (uint32_t b = 0; b < _blockCount; b++) {
+        const BlockHeader& block = header(b);
+        if (block.magic == BLOCK_MAGIC && block.state.load(std::memory_order_acquire) != Empty) used++;
+    }
+    return used;
+}
@@ -0,0 +1,161 @@
+#ifndef SAMPLE_ARCHIVE_H
+#define SAMPLE_ARCHIVE_H
+
+#include "SampleRecorder.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Compressed archive for the slow channels (SpO2, pulse rate, temperature).
+//
+// Every channel appends to its own open block; blocks are fixed-size slots
+// in one preallocated, memory-mapped ring file (archive.dat). Samples are
+// coded as in Gorilla (Pelkonen et al., VLDB 2015):
+//   - timestamps, in resolution units, as delta-of-delta: 1 bit while the
+//     period is steady, 9 to 36 bits for jitter and gaps
+//   - values as the XOR with the previous float: 1 bit when unchanged,
+//     otherwise only the meaningful bits, often inside the previous window
+// A steady 1 Hz temperature takes 2 bits per sample instead of the 24 bytes
+// of a SampleRecord. Timestamps are truncated to the resolution (1 us by
+// default); values and flags are kept exactly (a change of flags starts a
+// new block).
+//
+// A block is written in place in the mapping. It is synced when it is
+// sealed (full, new flags, or a gap the timestamp code cannot hold), and
+// the open blocks every syncInterval; after a power loss a channel resumes
+// at its last synced sample. The oldest block is claimed as the next one.
+//
+// Block headers hold channel, time range and count, so query() and Cursor
+// skip the blocks outside a range without decoding them, and decode the
+// others sample by sample up to the end of the range.
+class SampleArchive {
+public:
+    static const uint32_t BlockSize = 512;
+    static const uint32_t DefaultBlocks = 4096;  // 2 MiB
+    static const uint32_t DefaultResolutionNs = 1000;
+    static const uint64_t DefaultSyncIntervalNs = 10000000000ull;
+
+    // One channel, oldest first, decoded while iterating. Stays valid while
+    // the archive is open; a block reused by the writer ends the scan early.
+    class Cursor {
+    public:
+        // Next sample in the range (sequence and check are 0: not archived)
+        bool next(SampleRecord& sample);
+
+    private:
+        friend class SampleArchive;
+        struct State {
+            uint64_t time;       // Resolution units
+            int64_t delta;
+            uint32_t value;      // Float bits
+            uint8_t leading;     // XOR window of the last coded value
+            uint8_t trailing;
+            uint32_t index;      // Samples decoded
+            uint32_t bit;        // Read position in the payload
+        };
+
+        Cursor(const SampleArchive* archive, std::vector<uint32_t> blocks, uint64_t fromNs, uint64_t toNs);
+
+        const SampleArchive* _archive;
+        std::vector<uint32_t> _blocks;  // Slots in recording order
+        size_t _next;
+        bool _active;
+        uint32_t _block;
+        uint64_t _sequence;             // Of the block being decoded
+        State _state;
+        uint64_t _fromNs;
+        uint64_t _toNs;
+    };
+
+    SampleArchive();
+    ~SampleArchive();
+
+    // Writer: create archive.dat in directory, or continue the archive there
+    bool open(const std::string& directory, uint32_t blocks = DefaultBlocks,
+              uint32_t resolutionNs = DefaultResolutionNs);
+
+    // Reader (another process, or after the fact): map the archive read-only
+    bool openReadOnly(const std::string& directory);
+
+    void close();
+
+    // Stamped with CLOCK_REALTIME
+    bool append(uint16_t channel, float value, uint16_t flags = 0);
+    // A timestamp before the channel's previous one is raised to it
+    bool append(uint64_t timestampNs, uint16_t channel, float value, uint16_t flags = 0);
+
+    // Sync the open blocks now (e.g. before a planned shutdown); append() does
+    // this every interval (0 = only when a block is sealed)
+    bool flush();
+    void setSyncInterval(uint64_t intervalNs) { _syncIntervalNs = intervalNs; }
+
+    // Samples of one channel with fromNs <= timestampNs <= toNs
+    Cursor scan(uint16_t channel, uint64_t fromNs, uint64_t toNs) const;
+
+    // Calls visit for every sample in the range, oldest first, optionally only
+    // for one channel (-1 = all, merged in time order). Returns the count.
+    uint64_t query(uint64_t fromNs, uint64_t toNs, const SampleRecorder::Visitor& visit, int channel = -1) const;
+
+    uint64_t getSamples() const;       // Still in the ring
+    uint32_t getBlocksUsed() const;
+    uint64_t getSyncs() const { return _syncs; }
+
+private:
+    enum State : uint32_t { Empty = 0, Open = 1, Sealed = 2 };
+
+    struct BlockHeader {
+        uint32_t magic;
+        std::atomic<uint32_t> state;
+        uint64_t sequence;              // 1, 2, ... in claim order
+        uint16_t channel;
+        uint16_t flags;
+        uint32_t resolutionNs;
+        uint64_t firstTime;             // Resolution units
+        uint32_t firstValue;            // Float bits
+        std::atomic<uint32_t> count;
+        std::atomic<uint32_t> bits;     // Payload bits written
+        uint32_t syncedCount;           // count and bits at the last sync
+        uint32_t syncedBits;
+        uint32_t check;                 // Over the payload, when sealed
+        std::atomic<uint64_t> lastTime;
+    };
+
+    static const uint32_t PayloadBits = (BlockSize - sizeof(BlockHeader)) * 8;
+
+    // A channel's open block and the coder state after its last sample
+    struct Writer {
+        uint16_t channel;
+        uint32_t block;
+        Cursor::State state;
+    };
+
+    static uint32_t checksum(const uint8_t* payload, uint32_t bits);
+    static bool decodeNext(const BlockHeader& header, const uint8_t* payload, Cursor::State& state);
+
+    BlockHeader& header(uint32_t block) const;
+    uint8_t* payload(uint32_t block) const;
+    std::vector<uint32_t> blocksInOrder(int channel, uint64_t fromNs, uint64_t toNs) const;
+    Writer* writerFor(uint16_t channel);
+    bool startBlock(Writer& writer, uint64_t time, float value, uint16_t flags);
+    bool seal(Writer& writer);
+    bool syncBlock(uint32_t block);
+    bool encode(Writer& writer, uint64_t time, float value);
+
+    std::string _path;
+    uint8_t* _memory;
+    size_t _fileSize;
+    uint32_t _blockCount;
+    uint32_t _resolutionNs;
+    bool _writable;
+
+    std::vector<Writer> _writers;
+    uint32_t _nextBlock;      // Slot to claim next
+    uint64_t _nextSequence;
+    uint64_t _syncIntervalNs;
+    uint64_t _lastSyncNs;
+    uint64_t _syncs;
+};
+
+#endif // SAMPLE_ARCHIVE_H
@@ -0,0 +1,304 @@
+#ifndef SAMPLE_BUS_H
+#define SAMPLE_BUS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <thread>
+#include <type_traits>
+#include <unistd.h>
+
+// One producer, many consumers, Disruptor style.
+//
+// The producer writes items straight into the ring slots and publishes a
+// whole batch with one store. Every consumer has its own cursor. It reads
+// the published slots in place, through a pointer to the ring, as one or
+// two runs per poll(). Nothing is copied per subscriber and nothing is
+// locked. The producer never overwrites a slot that an active consumer
+// has not passed yet; a slow consumer holds the producer back.
+//
+// Optionally (stallNs) a consumer that blocks the producer longer than
+// that is evicted, so a hung process cannot stop the recording; its next
+// poll() reports this.
+//
+// SampleBus keeps the ring in the process. ShmSampleBus puts the same
+// layout in POSIX shared memory for consumers in other processes. T must
+// be trivially copyable.
+template <typename T, uint32_t Capacity, uint32_t MaxConsumers = 8>
+struct SampleBusLayout {
+    static_assert(Capacity != 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+    static_assert(std::is_trivially_copyable<T>::value, "Bus items are shared as raw memory");
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "Cursors are shared between processes");
+
+    enum State : uint32_t { Free = 0, Active = 1, Evicted = 2 };
+
+    struct alignas(64) Cursor {
+        std::atomic<uint64_t> position;  // Next sequence this consumer reads
+        std::atomic<uint32_t> state;
+    };
+
+    uint32_t magic;
+    uint32_t capacity;
+    uint32_t maxConsumers;
+    uint32_t itemSize;
+    alignas(64) std::atomic<uint64_t> published;  // Sequences below this are readable
+    Cursor cursors[MaxConsumers];
+    alignas(64) T slots[Capacity];
+
+    static const uint32_t Magic = 0x56534231;  // "VSB1"
+
+    void init() {
+        magic = 0;
+        capacity = Capacity;
+        maxConsumers = MaxConsumers;
+        itemSize = sizeof(T);
+        published.store(0, std::memory_order_relaxed);
+        for (uint32_t i = 0; i < MaxConsumers; i++) {
+            cursors[i].position.store(0, std::memory_order_relaxed);
+            cursors[i].state.store(Free, std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+        magic = Magic;
+    }
+
+    bool matches() const {
+        return magic == Magic && capacity == Capacity && maxConsumers == MaxConsumers && itemSize == sizeof(T);
+    }
+};
+
+template <typename T, uint32_t Capacity, uint32_t MaxConsumers = 8>
+class SampleBus {
+public:
+    typedef SampleBusLayout<T, Capacity, MaxConsumers> Layout;
+
+    // stallNs: evict a consumer that blocks the producer this long (0 = never)
+    explicit SampleBus(uint64_t stallNs = 0)
+        : _layout(new Layout), _owned(true), _stallNs(stallNs), _claimed(0), _gate(0), _evictions(0) {
+        _layout->init();
+    }
+
+    virtual ~SampleBus() {
+        if (_owned) delete _layout;
+    }
+
+    SampleBus(const SampleBus&) = delete;
+    SampleBus& operator=(const SampleBus&) = delete;
+
+    // --- Producer (one thread) ---
+
+    // Slot for the next item; it becomes visible at the next publish().
+    // Waits while the slowest consumer is a whole ring behind.
+    T& next() {
+        const uint64_t published = _layout->published.load(std::memory_order_relaxed);
+        if (_claimed - published == Capacity) publish();  // A batch can be at most the ring
+        if (_claimed - _gate >= Capacity) waitForConsumers();
+        return _layout->slots[_claimed++ & (Capacity - 1)];
+    }
+
+    // Make everything since the last publish() readable
+    void publish() { _layout->published.store(_claimed, std::memory_order_release); }
+
+    void publish(const T& item) {
+        next() = item;
+        publish();
+    }
+
+    uint64_t getPublished() const { return _layout->published.load(std::memory_order_acquire); }
+    uint32_t getEvictions() const { return _evictions; }
+
+    // --- Consumers ---
+
+    // Reads from the moment of subscribing; unsubscribes when destroyed
+    class Subscriber {
+    public:
+        explicit Subscriber(SampleBus& bus) : _layout(bus._layout), _index(-1) {
+            for (uint32_t i = 0; i < MaxConsumers; i++) {
+                typename Layout::Cursor& cursor = _layout->cursors[i];
+                uint32_t expected = Layout::Free;
+                // Claim the cursor (Evicted: not gated on yet), then set the
+                // position: once Active is seen, the producer gates on it
+                if (cursor.state.compare_exchange_strong(expected, Layout::Evicted, std::memory_order_acq_rel)) {
+                    cursor.position.store(_layout->published.load(std::memory_order_acquire), std::memory_order_relaxed);
+                    cursor.state.store(Layout::Active, std::memory_order_release);
+                    _index = static_cast<int>(i);
+                    break;
+                }
+            }
+        }
+
+        ~Subscriber() {
+            if (_index >= 0) _layout->cursors[_index].state.store(Layout::Free, std::memory_order_release);
+        }
+
+        Subscriber(const Subscriber&) = delete;
+        Subscriber& operator=(const Subscriber&) = delete;
+
+        bool isSubscribed() const { return _index >= 0; }
+
+        // The producer evicted this consumer for stalling it
+        bool isEvicted() const {
+            return _index >= 0 && _layout->cursors[_index].state.load(std::memory_order_acquire) == Layout::Evicted;
+        }
+
+        // Hand what is published to handler(const T* items, uint32_t count,
+        // uint64_t firstSequence), in place, at most maxItems. Returns the count.
+        template <typename Handler>
+        uint32_t poll(Handler&& handler, uint32_t maxItems = Capacity) {
+            if (_index < 0 || isEvicted()) return 0;
+
+            typename Layout::Cursor& cursor = _layout->cursors[_index];
+            const uint64_t position = cursor.position.load(std::memory_order_relaxed);
+            const uint64_t available = _layout->published.load(std::memory_order_acquire) - position;
+            const uint32_t count = static_cast<uint32_t>(available < maxItems ? available : maxItems);
+            if (count == 0) return 0;
+
+            // At most two runs: up to the end of the ring and from its start
+            const uint32_t start = static_cast<uint32_t>(position & (Capacity - 1));
+            const uint32_t first = count < Capacity - start ? count : Capacity - start;
+            handler(&_layout->slots[start], first, position);
+            if (first < count) handler(&_layout->slots[0], count - first, position + first);
+
+            // Releases the slots to the producer
+            cursor.position.store(position + count, std::memory_order_release);
+            return count;
+        }
+
+        // Wait until something is published: spin briefly, then sleep in short steps
+        bool wait(uint32_t timeoutUs) const {
+            if (_index < 0) return false;
+            const typename Layout::Cursor& cursor = _layout->cursors[_index];
+            const auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(timeoutUs);
+            for (uint32_t spin = 0;; spin++) {
+                if (_layout->published.load(std::memory_order_acquire) != cursor.position.load(std::memory_order_relaxed)) {
+                    return true;
+                }
+                if (spin < 64) continue;
+                if (std::chrono::steady_clock::now() >= deadline) return false;
+                std::this_thread::sleep_for(std::chrono::microseconds(20));
+            }
+        }
+
+        uint64_t getPosition() const {
+            return _index >= 0 ? _layout->cursors[_index].position.load(std::memory_order_relaxed) : 0;
+        }
+
+    private:
+        Layout* _layout;
+        int _index;
+    };
+
+protected:
+    // For ShmSampleBus: the layout lives in a mapping owned by the derived class
+    SampleBus(Layout* layout, uint64_t stallNs)
+        : _layout(layout), _owned(false), _stallNs(stallNs), _claimed(0), _gate(0), _evictions(0) {}
+
+    void adopt(Layout* layout) {
+        _layout = layout;
+        _claimed = layout != nullptr ? layout->published.load(std::memory_order_relaxed) : 0;
+        _gate = _claimed;
+    }
+
+    Layout* _layout;
+
+private:
+    // Lowest cursor of the active consumers, or all published when there are none
+    uint64_t slowestConsumer(int& slowest) const {
+        uint64_t gate = _layout->published.load(std::memory_order_relaxed);
+        slowest = -1;
+        for (uint32_t i = 0; i < MaxConsumers; i++) {
+            const typename Layout::Cursor& cursor = _layout->cursors[i];
+            if (cursor.state.load(std::memory_order_acquire) != Layout::Active) continue;
+            const uint64_t position = cursor.position.load(std::memory_order_acquire);
+            if (position < gate) {
+                gate = position;
+                slowest = static_cast<int>(i);
+            }
+        }
+        return gate;
+    }
+
+    void waitForConsumers() {
+        int slowest;
+        _gate = slowestConsumer(slowest);
+        if (_claimed - _gate < Capacity) return;
+
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32_t spin = 0; _claimed - _gate >= Capacity; spin++) {
+            if (spin < 64) {
+                // Usually a consumer is just finishing a batch
+            } else if (_stallNs != 0 && std::chrono::steady_clock::now() - start >= std::chrono::nanoseconds(_stallNs)) {
+                uint32_t expected = Layout::Active;
+                if (_layout->cursors[slowest].state.compare_exchange_strong(expected, Layout::Evicted,
+                                                                            std::memory_order_acq_rel)) {
+                    _evictions++;
+                }
+            } else {
+                std::this_thread::yield();
+            }
+            _gate = slowestConsumer(slowest);
+        }
+    }
+
+    bool _owned;
+    uint64_t _stallNs;
+    uint64_t _claimed;  // Producer: next sequence to hand out
+    uint64_t _gate;     // Producer: cached slowest consumer position
+    uint32_t _evictions;
+};
+
+// The same bus in POSIX shared memory (/dev/shm/<name>). The producer
+// create()s it, consumers in other processes attach() and then use
+// Subscriber as usual. Consumers map it writable: their cursor is in it.
+template <typename T, uint32_t Capacity, uint32_t MaxConsumers = 8>
+class ShmSampleBus : public SampleBus<T, Capacity, MaxConsumers> {
+public:
+    typedef SampleBusLayout<T, Capacity, MaxConsumers> Layout;
+
+    // A crashed consumer process would stall the producer: evict it after stallNs
+    explicit ShmSampleBus(uint64_t stallNs = 1000000000ull)
+        : SampleBus<T, Capacity, MaxConsumers>(nullptr, stallNs), _fd(-1), _owner(false), _name{0} {}
+
+    ~ShmSampleBus() override {
+        if (this->_layout != nullptr) munmap(this->_layout, sizeof(Layout));
+        if (_fd != -1) close(_fd);
+        if (_owner) shm_unlink(_name);
+    }
+
+    // Producer: create (or reset) the segment
+    bool create(const char* name) {
+        if (!map(name, true)) return false;
+        _owner = true;
+        this->_layout->init();
+        this->adopt(this->_layout);
+        return true;
+    }
+
+    // Consumer
+    bool attach(const char* name) {
+        if (!map(name, false)) return false;
+        return this->_layout->matches();
+    }
+
+private:
+    bool map(const char* name, bool create) {
+        strncpy(_name, name, sizeof(_name) - 1);
+
+        _fd = shm_open(name, create ? (O_RDWR | O_CREAT) : O_RDWR, 0644);
+        if (_fd == -1) return false;
+        if (create && ftruncate(_fd, sizeof(Layout)) != 0) return false;
+
+        void* memory = mmap(nullptr, sizeof(Layout), PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+        if (memory == MAP_FAILED) return false;
+        this->adopt(static_cast<Layout*>(memory));
+        return true;
+    }
+
+    int _fd;
+    bool _owner;
+    char _name[64];
+};
+
+#endif // SAMPLE_BUS_H
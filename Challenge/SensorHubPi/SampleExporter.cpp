@@ -0,0 +1,454 @@
+#include "SampleExporter.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const uint32_t SPOOL_FILE_BYTES = 1u << 20;  // A spool file is closed at this size
+static const size_t MAX_GAPS = 1024;
+
+static uint64_t nowNs() {
+    timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    return static_cast<uint64_t>(now.tv_sec) * 1000000000ull + static_cast<uint64_t>(now.tv_nsec);
+}
+
+// FNV-1a, as for the recorder's records
+static uint32_t checksum(const uint8_t* data, size_t size) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; i++) hash = (hash ^ data[i]) * 16777619u;
+    return hash;
+}
+
+void CborWriter::head(uint8_t major, uint64_t value) {
+    const uint8_t type = static_cast<uint8_t>(major << 5);
+    if (value < 24) {
+        _out.push_back(static_cast<uint8_t>(type | value));
+        return;
+    }
+    int bytes = 8;
+    uint8_t info = 27;
+    if (value <= 0xFF) {
+        bytes = 1;
+        info = 24;
+    } else if (value <= 0xFFFF) {
+        bytes = 2;
+        info = 25;
+    } else if (value <= 0xFFFFFFFFull) {
+        bytes = 4;
+        info = 26;
+    }
+    _out.push_back(static_cast<uint8_t>(type | info));
+    for (int i = bytes - 1; i >= 0; i--) _out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+}
+
+void CborWriter::text(const char* value) {
+    const size_t length = std::strlen(value);
+    head(3, length);
+    _out.insert(_out.end(), value, value + length);
+}
+
+void CborWriter::float32(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    _out.push_back(0xFA);
+    for (int i = 3; i >= 0; i--) _out.push_back(static_cast<uint8_t>(bits >> (8 * i)));
+}
+
+SampleExporter::SampleExporter(ExportTransport& transport, const Config& config)
+    : _transport(transport), _config(config), _queueBytes(0), _running(false), _spoolWrite(0), _spoolWriteBytes(0),
+      _spoolReadOffset(0), _spoolPending(false), _lastAttemptNs(0), _connected(false), _framesSent(0),
+      _samplesSent(0), _refused(0), _backfilled(0), _spooled(0), _spoolFilesDropped(0) {
+    if (_config.maxSamples == 0) _config.maxSamples = 1;
+}
+
+SampleExporter::~SampleExporter() {
+    stop();
+}
+
+bool SampleExporter::start() {
+    if (_thread.joinable()) return false;
+    if (!_config.spoolDirectory.empty()) {
+        mkdir(_config.spoolDirectory.c_str(), 0755);
+        const std::vector<uint32_t> files = spoolFiles();
+        _spoolPending = !files.empty();  // Left by an earlier run: sent before anything new
+        _spoolWrite = files.empty() ? 0 : files.back() + 1;
+        _spoolWriteBytes = 0;
+        _spoolReadOffset = 0;
+    }
+    _running = true;
+    _thread = std::thread(&SampleExporter::run, this);
+    return true;
+}
+
+void SampleExporter::stop() {
+    if (!_thread.joinable()) return;
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        for (Batch& batch : _batches) close(batch);
+        _running = false;
+    }
+    _wake.notify_one();
+    _thread.join();
+}
+
+size_t SampleExporter::getQueueBytes() const {
+    std::lock_guard<std::mutex> guard(_lock);
+    return _queueBytes;
+}
+
+std::string SampleExporter::topicFor(uint16_t channel) const {
+    return _config.topicPrefix + "/" + std::to_string(channel);
+}
+
+void SampleExporter::encode(const Batch& batch, std::vector<uint8_t>& out) {
+    const size_t count = batch.timestamps.size();
+    out.clear();
+    out.reserve(32 + count * 10);
+    CborWriter cbor(out);
+    cbor.map(5);
+    cbor.text("ch");
+    cbor.uint(batch.channel);
+    cbor.text("fl");
+    cbor.uint(batch.flags);
+    cbor.text("t0");
+    cbor.uint(batch.timestamps[0]);
+    cbor.text("dt");
+    cbor.array(count);
+    for (size_t i = 0; i < count; i++) cbor.uint(i == 0 ? 0 : batch.timestamps[i] - batch.timestamps[i - 1]);
+    cbor.text("v");
+    cbor.array(count);
+    for (size_t i = 0; i < count; i++) cbor.float32(batch.values[i]);
+}
+
+SampleExporter::Batch& SampleExporter::batchFor(uint16_t channel) {
+    for (Batch& batch : _batches) {
+        if (batch.channel == channel) return batch;
+    }
+    _batches.push_back(Batch{channel, 0, false, std::vector<uint64_t>(), std::vector<float>()});
+    _batches.back().timestamps.reserve(_config.maxSamples);
+    _batches.back().values.reserve(_config.maxSamples);
+    return _batches.back();
+}
+
+// The queue may go over its bound by the open batches: they are already in memory
+void SampleExporter::close(Batch& batch) {
+    if (batch.timestamps.empty()) return;
+    Frame frame{batch.channel, static_cast<uint32_t>(batch.timestamps.size()), std::vector<uint8_t>()};
+    encode(batch, frame.data);
+    _queueBytes += frame.data.size();
+    _queue.push_back(std::move(frame));
+    batch.timestamps.clear();
+    batch.values.clear();
+}
+
+void SampleExporter::closeExpired(uint64_t now) {
+    for (Batch& batch : _batches) {
+        if (!batch.timestamps.empty() && now > batch.timestamps[0] && now - batch.timestamps[0] >= _config.maxAgeNs) {
+            close(batch);
+        }
+    }
+}
+
+void SampleExporter::refuse(Batch& batch, uint64_t timestampNs) {
+    _refused.fetch_add(1, std::memory_order_relaxed);
+    if (batch.refusing) {
+        for (size_t i = _gaps.size(); i-- > 0;) {
+            if (_gaps[i].channel == batch.channel) {
+                _gaps[i].toNs = timestampNs;
+                return;
+            }
+        }
+    }
+    batch.refusing = true;
+    if (_gaps.size() < MAX_GAPS) {
+        _gaps.push_back(Gap{batch.channel, timestampNs, timestampNs});
+        return;
+    }
+    // Too many gaps: widen the channel's last one (resends what lies between)
+    for (size_t i = _gaps.size(); i-- > 0;) {
+        if (_gaps[i].channel == batch.channel) {
+            _gaps[i].toNs = timestampNs;
+            return;
+        }
+    }
+}
+
+bool SampleExporter::add(uint64_t timestampNs, uint16_t channel, float value, uint16_t flags) {
+    bool wake = false;
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        if (!_running) return false;
+        Batch& batch = batchFor(channel);
+        if (_queueBytes >= _config.maxQueueBytes) {
+            refuse(batch, timestampNs);
+            return false;
+        }
+        batch.refusing = false;
+        if (!batch.timestamps.empty() && batch.flags != flags) {
+            close(batch);
+            wake = true;
+        }
+        if (batch.timestamps.empty()) batch.flags = flags;
+        batch.timestamps.push_back(timestampNs);
+        batch.values.push_back(value);
+        if (batch.timestamps.size() >= _config.maxSamples) {
+            close(batch);
+            wake = true;
+        }
+    }
+    if (wake) _wake.notify_one();
+    return true;
+}
+
+bool SampleExporter::send(const Frame& frame) {
+    if (!_transport.publish(topicFor(frame.channel), frame.data.data(), frame.data.size())) return false;
+    _framesSent.fetch_add(1, std::memory_order_relaxed);
+    _samplesSent.fetch_add(frame.samples, std::memory_order_relaxed);
+    return true;
+}
+
+void SampleExporter::run() {
+    for (;;) {
+        Frame frame;
+        bool haveFrame = false;
+        bool stopping = false;
+        std::vector<Gap> gaps;
+        {
+            std::unique_lock<std::mutex> lock(_lock);
+            const bool connected = _connected.load(std::memory_order_relaxed);
+            const bool work = connected && (!_queue.empty() || _spoolPending || !_gaps.empty());
+            if (_running && !work) _wake.wait_for(lock, std::chrono::milliseconds(100));
+            closeExpired(nowNs());
+            stopping = !_running;
+            if (connected && !_spoolPending) {
+                if (!_queue.empty()) {
+                    frame = std::move(_queue.front());
+                    _queue.pop_front();
+                    _queueBytes -= frame.data.size();
+                    haveFrame = true;
+                } else if (!_gaps.empty() && !stopping) {
+                    gaps.swap(_gaps);  // Taken: samples refused from now on start new gaps
+                    for (Batch& batch : _batches) batch.refusing = false;
+                }
+            }
+        }
+
+        if (!_connected.load(std::memory_order_relaxed)) {
+            const uint64_t now = nowNs();
+            if (now - _lastAttemptNs >= _config.retryNs || stopping) {
+                _lastAttemptNs = now;
+                _connected.store(_transport.connect(), std::memory_order_relaxed);
+            }
+            if (!_connected.load(std::memory_order_relaxed)) {
+                spoolQueue();
+                if (stopping) break;
+                continue;
+            }
+        }
+
+        if (stopping && (_spoolPending || !haveFrame)) {
+            spoolQueue();  // What the broker did not get yet is sent by the next run
+            break;
+        }
+
+        bool ok = true;
+        if (_spoolPending) {
+            ok = sendSpool();
+        } else if (haveFrame) {
+            ok = send(frame);
+            if (!ok && !spoolFrame(frame)) {
+                // No spool: back to the front of the queue, sent after reconnecting
+                std::lock_guard<std::mutex> guard(_lock);
+                _queueBytes += frame.data.size();
+                _queue.push_front(std::move(frame));
+            }
+        } else if (!gaps.empty()) {
+            size_t done = 0;
+            while (done < gaps.size() && (ok = backfill(gaps[done]))) done++;
+            if (done < gaps.size()) {
+                std::lock_guard<std::mutex> guard(_lock);
+                _gaps.insert(_gaps.begin(), gaps.begin() + static_cast<std::ptrdiff_t>(done), gaps.end());
+            }
+        } else {
+            ok = _transport.idle();
+        }
+
+        if (!ok) {
+            _transport.disconnect();
+            _connected.store(false, std::memory_order_relaxed);
+            _lastAttemptNs = nowNs();
+        }
+    }
+
+    if (_connected.load(std::memory_order_relaxed)) _transport.disconnect();
+    _connected.store(false, std::memory_order_relaxed);
+}
+
+// Re-read a refused range from the recording. On a lost connection the gap
+// keeps what is not sent yet.
+bool SampleExporter::backfill(Gap& gap) {
+    if (!_backfill) return true;  // Nothing to read back from: the samples stay refused
+
+    Batch batch{gap.channel, 0, false, std::vector<uint64_t>(), std::vector<float>()};
+    bool ok = true;
+    uint64_t sentTo = 0;
+    bool sentAny = false;
+    const auto flush = [&]() {
+        if (!ok || batch.timestamps.empty()) return;
+        Frame frame{batch.channel, static_cast<uint32_t>(batch.timestamps.size()), std::vector<uint8_t>()};
+        encode(batch, frame.data);
+        ok = send(frame);
+        if (ok) {
+            _backfilled.fetch_add(frame.samples, std::memory_order_relaxed);
+            sentTo = batch.timestamps.back();
+            sentAny = true;
+        }
+        batch.timestamps.clear();
+        batch.values.clear();
+    };
+    _backfill(gap.fromNs, gap.toNs, gap.channel, [&](const SampleRecord& record) {
+        if (!ok) return;
+        if (!batch.timestamps.empty() && batch.flags != record.flags) flush();
+        if (batch.timestamps.empty()) batch.flags = record.flags;
+        batch.timestamps.push_back(record.timestampNs);
+        batch.values.push_back(record.value);
+        if (batch.timestamps.size() >= _config.maxSamples) flush();
+    });
+    flush();
+    if (!ok && sentAny) gap.fromNs = sentTo + 1;
+    return ok;
+}
+
+std::string SampleExporter::spoolPath(uint32_t number) const {
+    char name[32];
+    snprintf(name, sizeof(name), "/spool_%06u.dat", number);
+    return _config.spoolDirectory + name;
+}
+
+std::vector<uint32_t> SampleExporter::spoolFiles() const {
+    std::vector<uint32_t> files;
+    DIR* directory = opendir(_config.spoolDirectory.c_str());
+    if (directory == nullptr) return files;
+    while (const dirent* entry = readdir(directory)) {
+        unsigned number;
+        char tail;
+        if (sscanf(entry->d_name, "spool_%6u.da%c", &number, &tail) == 2 && tail == 't') files.push_back(number);
+    }
+    closedir(directory);
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+// Spool record: channel (16), samples (32), size (32), the frame, FNV-1a of the frame
+bool SampleExporter::spoolFrame(const Frame& frame) {
+    if (_config.spoolDirectory.empty()) return false;
+    if (_spoolWriteBytes >= SPOOL_FILE_BYTES) {
+        _spoolWrite++;
+        _spoolWriteBytes = 0;
+    }
+
+    FILE* file = fopen(spoolPath(_spoolWrite).c_str(), "ab");
+    if (file == nullptr) return false;
+    const uint32_t size = static_cast<uint32_t>(frame.data.size());
+    const uint32_t check = checksum(frame.data.data(), frame.data.size());
+    bool ok = fwrite(&frame.channel, sizeof(frame.channel), 1, file) == 1 &&
+              fwrite(&frame.samples, sizeof(frame.samples), 1, file) == 1 && fwrite(&size, sizeof(size), 1, file) == 1 &&
+              fwrite(frame.data.data(), 1, size, file) == size && fwrite(&check, sizeof(check), 1, file) == 1;
+    ok = fclose(file) == 0 && ok;
+    if (!ok) return false;
+
+    _spoolWriteBytes += sizeof(frame.channel) + sizeof(frame.samples) + sizeof(size) + size + sizeof(check);
+    _spoolPending = true;
+    _spooled.fetch_add(1, std::memory_order_relaxed);
+    trimSpool();
+    return true;
+}
+
+// Oldest files go first when the spool is over its bound
+void SampleExporter::trimSpool() {
+    std::vector<uint32_t> files = spoolFiles();
+    uint64_t total = 0;
+    std::vector<uint64_t> sizes;
+    for (uint32_t number : files) {
+        struct stat info;
+        sizes.push_back(stat(spoolPath(number).c_str(), &info) == 0 ? static_cast<uint64_t>(info.st_size) : 0);
+        total += sizes.back();
+    }
+    for (size_t i = 0; i + 1 < files.size() && total > _config.maxSpoolBytes; i++) {
+        unlink(spoolPath(files[i]).c_str());
+        total -= sizes[i];
+        if (i == 0) _spoolReadOffset = 0;
+        _spoolFilesDropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void SampleExporter::spoolQueue() {
+    if (_config.spoolDirectory.empty()) return;
+    for (;;) {
+        Frame frame;
+        {
+            std::lock_guard<std::mutex> guard(_lock);
+            if (_queue.empty()) return;
+            frame = std::move(_queue.front());
+            _queue.pop_front();
+            _queueBytes -= frame.data.size();
+        }
+        if (!spoolFrame(frame)) {
+            std::lock_guard<std::mutex> guard(_lock);  // Disk full: keep it in memory
+            _queueBytes += frame.data.size();
+            _queue.push_front(std::move(frame));
+            return;
+        }
+    }
+}
+
+// Send the next spooled frame, oldest file first; a file is removed once sent
+bool SampleExporter::sendSpool() {
+    const std::vector<uint32_t> files = spoolFiles();
+    if (files.empty()) {
+        _spoolPending = false;
+        return true;
+    }
+
+    const uint32_t number = files.front();
+    FILE* file = fopen(spoolPath(number).c_str(), "rb");
+    bool done = file == nullptr;
+    if (file != nullptr) {
+        Frame frame;
+        uint32_t size = 0;
+        uint32_t check = 0;
+        bool valid = fseek(file, static_cast<long>(_spoolReadOffset), SEEK_SET) == 0 &&
+                     fread(&frame.channel, sizeof(frame.channel), 1, file) == 1 &&
+                     fread(&frame.samples, sizeof(frame.samples), 1, file) == 1 &&
+                     fread(&size, sizeof(size), 1, file) == 1 && size <= SPOOL_FILE_BYTES;
+        if (valid) {
+            frame.data.resize(size);
+            valid = fread(frame.data.data(), 1, size, file) == size && fread(&check, sizeof(check), 1, file) == 1 &&
+                    check == checksum(frame.data.data(), size);
+        }
+        fclose(file);
+
+        if (valid) {
+            if (!send(frame)) return false;
+            _spoolReadOffset += sizeof(frame.channel) + sizeof(frame.samples) + sizeof(size) + size + sizeof(check);
+            return true;
+        }
+        done = true;  // End of the file, or a record torn by a power loss
+    }
+
+    if (done) {
+        unlink(spoolPath(number).c_str());
+        _spoolReadOffset = 0;
+        if (number == _spoolWrite) {
+            _spoolWrite++;
+            _spoolWriteBytes = 0;
+        }
+        if (files.size() == 1) _spoolPending = false;
+    }
+    return true;
+}
@@ -0,0 +1,172 @@
+#ifndef SAMPLE_EXPORTER_H
+#define SAMPLE_EXPORTER_H
+
+#include "SampleRecorder.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Where the exporter delivers its frames, e.g. MqttTransport. Called from
+// the export thread only; publish() returns once the frame is accepted
+// (for MQTT: acknowledged), false if the connection is lost.
+class ExportTransport {
+public:
+    virtual ~ExportTransport() {}
+    virtual bool connect() = 0;
+    virtual void disconnect() = 0;
+    virtual bool publish(const std::string& topic, const uint8_t* data, size_t size) = 0;
+    // Called when there is nothing to send (keep-alive)
+    virtual bool idle() { return true; }
+};
+
+// Minimal CBOR (RFC 8949) writer for the export frames
+class CborWriter {
+public:
+    explicit CborWriter(std::vector<uint8_t>& out) : _out(out) {}
+
+    void map(uint64_t pairs) { head(5, pairs); }
+    void array(uint64_t items) { head(4, items); }
+    void text(const char* value);
+    void uint(uint64_t value) { head(0, value); }
+    void float32(float value);
+
+private:
+    void head(uint8_t major, uint64_t value);
+
+    std::vector<uint8_t>& _out;
+};
+
+// Upstream export: batches samples per channel into CBOR frames and hands
+// them to a transport from its own thread.
+//
+// A frame is one map: {"ch": channel, "fl": flags, "t0": first timestamp
+// (ns), "dt": [ns since the previous sample, ...], "v": [float32, ...]},
+// published on "<prefix>/<channel>". A batch is closed at maxSamples, at a
+// change of flags, or when its first sample is maxAgeNs old.
+//
+// add() never blocks on the network: closed frames wait in a queue bounded
+// by maxQueueBytes. While the transport is down the export thread moves the
+// queue to a spool of files in the spool directory (bounded by
+// maxSpoolBytes, oldest dropped first) and sends it first after reconnecting;
+// a spool left by an earlier run is sent too.
+//
+// When the queue is full add() refuses the sample instead of holding up
+// acquisition, and returns false as backpressure. The exporter remembers
+// the refused time range per channel; once the queue has drained, it
+// re-reads that range from the recording through the backfill source (see
+// setBackfill) and exports it, so nothing the recorder kept is lost.
+class SampleExporter {
+public:
+    struct Config {
+        std::string topicPrefix = "sensorhub";
+        uint32_t maxSamples = 250;                 // Per frame
+        uint64_t maxAgeNs = 1000000000ull;         // Oldest sample in an open batch
+        size_t maxQueueBytes = 4u << 20;
+        std::string spoolDirectory;                // Empty: no spool, frames wait in the queue
+        uint64_t maxSpoolBytes = 256ull << 20;
+        uint64_t retryNs = 2000000000ull;          // Between reconnects
+    };
+
+    // Reads [fromNs, toNs] of one channel from the recording, oldest first
+    typedef std::function<uint64_t(uint64_t fromNs, uint64_t toNs, int channel, const SampleRecorder::Visitor& visit)>
+        Backfill;
+
+    SampleExporter(ExportTransport& transport, const Config& config);
+    ~SampleExporter();
+
+    bool start();
+    // Closes the open batches, sends (or spools) what is queued and stops the thread
+    void stop();
+
+    void setBackfill(const Backfill& backfill) { _backfill = backfill; }
+
+    // From the acquisition thread; false when the sample was refused (backpressure)
+    bool add(uint64_t timestampNs, uint16_t channel, float value, uint16_t flags = 0);
+    bool add(const SampleRecord& record) { return add(record.timestampNs, record.channel, record.value, record.flags); }
+
+    bool isConnected() const { return _connected.load(std::memory_order_relaxed); }
+    uint64_t getFramesSent() const { return _framesSent.load(std::memory_order_relaxed); }
+    uint64_t getSamplesSent() const { return _samplesSent.load(std::memory_order_relaxed); }
+    uint64_t getRefused() const { return _refused.load(std::memory_order_relaxed); }
+    uint64_t getBackfilled() const { return _backfilled.load(std::memory_order_relaxed); }
+    uint64_t getSpooled() const { return _spooled.load(std::memory_order_relaxed); }
+    uint64_t getSpoolFilesDropped() const { return _spoolFilesDropped.load(std::memory_order_relaxed); }
+    size_t getQueueBytes() const;
+
+private:
+    struct Batch {
+        uint16_t channel;
+        uint16_t flags;
+        bool refusing;            // The last sample was refused: extend its gap
+        std::vector<uint64_t> timestamps;
+        std::vector<float> values;
+    };
+
+    struct Frame {
+        uint16_t channel;
+        uint32_t samples;
+        std::vector<uint8_t> data;
+    };
+
+    // Refused samples of a channel, to be read back from the recording
+    struct Gap {
+        uint16_t channel;
+        uint64_t fromNs;
+        uint64_t toNs;
+    };
+
+    static void encode(const Batch& batch, std::vector<uint8_t>& out);
+
+    Batch& batchFor(uint16_t channel);
+    void close(Batch& batch);                  // With _lock held
+    void closeExpired(uint64_t nowNs);         // With _lock held
+    void refuse(Batch& batch, uint64_t timestampNs);  // With _lock held
+    std::string topicFor(uint16_t channel) const;
+
+    void run();
+    bool send(const Frame& frame);
+    bool sendSpool();
+    bool backfill(Gap& gap);
+    void spoolQueue();
+    bool spoolFrame(const Frame& frame);
+    void trimSpool();
+    std::vector<uint32_t> spoolFiles() const;
+    std::string spoolPath(uint32_t number) const;
+
+    ExportTransport& _transport;
+    Config _config;
+    Backfill _backfill;
+
+    mutable std::mutex _lock;
+    std::condition_variable _wake;
+    std::vector<Batch> _batches;
+    std::deque<Frame> _queue;
+    size_t _queueBytes;
+    std::vector<Gap> _gaps;
+    bool _running;
+    std::thread _thread;
+
+    // Export thread only
+    uint32_t _spoolWrite;       // File being appended to
+    uint64_t _spoolWriteBytes;
+    uint64_t _spoolReadOffset;  // Sent from the oldest spool file
+    bool _spoolPending;
+    uint64_t _lastAttemptNs;
+
+    std::atomic<bool> _connected;
+    std::atomic<uint64_t> _framesSent;
+    std::atomic<uint64_t> _samplesSent;
+    std::atomic<uint64_t> _refused;
+    std::atomic<uint64_t> _backfilled;
+    std::atomic<uint64_t> _spooled;
+    std::atomic<uint64_t> _spoolFilesDropped;
+};
+
+#endif // SAMPLE_EXPORTER_H
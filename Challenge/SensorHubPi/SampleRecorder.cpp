@@ -0,0 +1,488 @@
+#include "SampleRecorder.h"
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const uint32_t SEGMENT_MAGIC = 0x56535247;  // "VSRG"
+static const uint32_t SEGMENT_VERSION = 1;
+
+static_assert(sizeof(std::atomic<uint64_t>) == sizeof(uint64_t) && std::atomic<uint64_t>::is_always_lock_free,
+              "Header atomics are shared through the file mapping");
+
+SampleRecorder::SampleRecorder()
+    : _segments(nullptr), _segmentCount(0), _segmentRecords(0), _stride(1), _fileSize(0), _writable(false),
+      _current(0), _nextSequence(0), _lastNs(0), _syncs(0), _recovered(0) {}
+
+SampleRecorder::~SampleRecorder() {
+    close();
+}
+
+// FNV-1a over the record without its check field: a few cycles per sample
+uint32_t SampleRecorder::checksum(const SampleRecord& record) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&record);
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < offsetof(SampleRecord, check); i++) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+size_t SampleRecorder::fileSize(uint32_t segmentRecords) {
+    return HeaderSize + static_cast<size_t>(segmentRecords) * sizeof(SampleRecord);
+}
+
+bool SampleRecorder::mapSegment(uint32_t number, bool writable, uint32_t segmentRecords) {
+    char name[32];
+    snprintf(name, sizeof(name), "/seg_%03u.dat", number);
+    const std::string path = _directory + name;
+
+    const int fd = ::open(path.c_str(), writable ? (O_RDWR | O_CREAT) : O_RDONLY, 0644);
+    if (fd == -1) return false;
+
+    struct stat info;
+    bool ok = fstat(fd, &info) == 0;
+    if (ok && writable) {
+        _fileSize = fileSize(segmentRecords);
+        // Reserve the blocks now: a full disk fails here, not as SIGBUS in append()
+        if (static_cast<size_t>(info.st_size) != _fileSize) {
+            ok = ftruncate(fd, 0) == 0 && posix_fallocate(fd, 0, static_cast<off_t>(_fileSize)) == 0;
+        }
+    } else if (ok) {
+        _fileSize = static_cast<size_t>(info.st_size);
+        ok = _fileSize > HeaderSize && (_fileSize - HeaderSize) % sizeof(SampleRecord) == 0;
+    }
+
+    void* memory = MAP_FAILED;
+    if (ok) {
+        memory = mmap(nullptr, _fileSize, writable ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);  // The mapping keeps the file
+    if (memory == MAP_FAILED) return false;
+
+    Segment& segment = _segments[number];
+    segment.memory = static_cast<uint8_t*>(memory);
+    segment.header = reinterpret_cast<SegmentHeader*>(segment.memory);
+    segment.records = reinterpret_cast<SampleRecord*>(segment.memory + HeaderSize);
+    madvise(segment.memory, _fileSize, writable ? MADV_SEQUENTIAL : MADV_RANDOM);
+    return true;
+}
+
+void SampleRecorder::resetSegment(Segment& segment, uint64_t generation, uint64_t firstSequence) {
+    SegmentHeader& header = *segment.header;
+    header.state.store(Empty, std::memory_order_relaxed);
+    header.magic = SEGMENT_MAGIC;
+    header.version = SEGMENT_VERSION;
+    header.recordSize = sizeof(SampleRecord);
+    header.capacity = _segmentRecords;
+    header.generation = generation;
+    header.firstSequence = firstSequence;
+    header.count.store(0, std::memory_order_relaxed);
+    header.firstNs.store(0, std::memory_order_relaxed);
+    header.lastNs.store(0, std::memory_order_relaxed);
+    header.indexStride = _stride;
+    header.reserved = 0;
+    std::atomic_thread_fence(std::memory_order_release);
+    if (generation != 0) header.state.store(Active, std::memory_order_release);
+
+    // Once per segment: afterwards no stale record in it can pass as new
+    msync(segment.memory, HeaderSize, MS_SYNC);
+    _syncs++;
+}
+
+// Records of the open segment that made it to disk: stop at the first one
+// that was not (completely) written. Rebuilds count, index and lastNs.
+uint32_t SampleRecorder::scanSegment(Segment& segment) {
+    SegmentHeader& header = *segment.header;
+    uint32_t count = 0;
+    uint64_t lastNs = 0;
+    while (count < header.capacity) {
+        const SampleRecord& record = segment.records[count];
+        if (record.sequence != static_cast<uint32_t>(header.firstSequence + count) || record.check != checksum(record) ||
+            record.timestampNs < lastNs) {
+            break;
+        }
+        if (count % header.indexStride == 0) header.index[count / header.indexStride] = record.timestampNs;
+        if (count == 0) header.firstNs.store(record.timestampNs, std::memory_order_relaxed);
+        lastNs = record.timestampNs;
+        count++;
+    }
+    header.lastNs.store(lastNs, std::memory_order_relaxed);
+    header.count.store(count, std::memory_order_release);
+    return count;
+}
+
+bool SampleRecorder::open(const std::string& directory, uint32_t segments, uint32_t segmentRecords) {
+    close();
+    if (segments < 2 || segmentRecords == 0) return false;
+
+    mkdir(directory.c_str(), 0755);
+    _directory = directory;
+    _writable = true;
+    _segmentCount = segments;
+    _segmentRecords = segmentRecords;
+    _stride = (segmentRecords + IndexEntries - 1) / IndexEntries;
+    _segments = new Segment[segments]();
+
+    // Find the newest segment of an earlier recording with the same geometry
+    bool found = false;
+    for (uint32_t i = 0; i < segments; i++) {
+        if (!mapSegment(i, true, segmentRecords)) {
+            close();
+            return false;
+        }
+        SegmentHeader& header = *_segments[i].header;
+        const bool valid = header.magic == SEGMENT_MAGIC && header.version == SEGMENT_VERSION &&
+                           header.recordSize == sizeof(SampleRecord) && header.capacity == segmentRecords &&
+                           header.indexStride == _stride;
+        if (!valid) {
+            resetSegment(_segments[i], 0, 0);
+        } else if (header.state.load(std::memory_order_relaxed) != Empty &&
+                   (!found || header.generation > _segments[_current].header->generation)) {
+            _current = i;
+            found = true;
+        }
+    }
+
+    if (!found) {
+        _current = 0;
+        resetSegment(_segments[0], 1, 0);
+        return true;
+    }
+
+    Segment& segment = _segments[_current];
+    SegmentHeader& header = *segment.header;
+    if (header.state.load(std::memory_order_relaxed) == Active) {
+        _recovered = scanSegment(segment);
+    }
+    const uint32_t count = header.count.load(std::memory_order_relaxed);
+    _nextSequence = header.firstSequence + count;
+    _lastNs = header.lastNs.load(std::memory_order_relaxed);
+    // Sealed but the next segment was never claimed: power lost during rotate()
+    if (count == _segmentRecords || header.state.load(std::memory_order_relaxed) == Sealed) return rotate();
+    return true;
+}
+
+bool SampleRecorder::openReadOnly(const std::string& directory) {
+    close();
+    _directory = directory;
+    _writable = false;
+
+    uint32_t segments = 0;
+    for (;; segments++) {
+        char name[32];
+        snprintf(name, sizeof(name), "/seg_%03u.dat", segments);
+        if (access((directory + name).c_str(), R_OK) != 0) break;
+    }
+    if (segments == 0) return false;
+
+    _segmentCount = segments;
+    _segments = new Segment[segments]();
+    for (uint32_t i = 0; i < segments; i++) {
+        if (!mapSegment(i, false, 0)) {
+            close();
+            return false;
+        }
+    }
+    return true;
+}
+
+void SampleRecorder::close() {
+    if (_segments != nullptr) {
+        if (_writable) flush();
+        for (uint32_t i = 0; i < _segmentCount; i++) {
+            if (_segments[i].memory != nullptr) munmap(_segments[i].memory, _fileSize);
+        }
+        delete[] _segments;
+    }
+    _segments = nullptr;
+    _segmentCount = 0;
+    _current = 0;
+    _nextSequence = 0;
+    _lastNs = 0;
+}
+
+// Seal the full segment and claim the oldest one
+bool SampleRecorder::rotate() {
+    Segment& full = _segments[_current];
+    full.header->state.store(Sealed, std::memory_order_release);
+    if (msync(full.memory, _fileSize, MS_SYNC) != 0) return false;
+    _syncs++;
+
+    const uint64_t generation = full.header->generation + 1;
+    _current = (_current + 1) % _segmentCount;
+    resetSegment(_segments[_current], generation, _nextSequence);
+    return true;
+}
+
+bool SampleRecorder::append(uint16_t channel, float value, uint16_t flags) {
+    timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    return append(static_cast<uint64_t>(now.tv_sec) * 1000000000ull + static_cast<uint64_t>(now.tv_nsec), channel,
+                  value, flags);
+}
+
+bool SampleRecorder::append(uint64_t timestampNs, uint16_t channel, float value, uint16_t flags) {
+    if (_segments == nullptr || !_writable) return false;
+
+    Segment* segment = &_segments[_current];
+    uint32_t count = segment->header->count.load(std::memory_order_relaxed);
+    if (count == _segmentRecords) {
+        if (!rotate()) return false;
+        segment = &_segments[_current];
+        count = 0;
+    }
+
+    if (timestampNs < _lastNs) timestampNs = _lastNs;  // Clock stepped back
+
+    SampleRecord& record = segment->records[count];
+    record.timestampNs = timestampNs;
+    record.channel = channel;
+    record.flags = flags;
+    record.value = value;
+    record.sequence = static_cast<uint32_t>(_nextSequence);
+    record.check = checksum(record);
+
+    SegmentHeader& header = *segment->header;
+    if (count % _stride == 0) header.index[count / _stride] = timestampNs;
+    if (count == 0) header.firstNs.store(timestampNs, std::memory_order_relaxed);
+    header.lastNs.store(timestampNs, std::memory_order_relaxed);
+    header.count.store(count + 1, std::memory_order_release);  // Readers see the record complete
+
+    _lastNs = timestampNs;
+    _nextSequence++;
+    return true;
+}
+
+bool SampleRecorder::flush() {
+    if (_segments == nullptr || !_writable) return false;
+    _syncs++;
+    return msync(_segments[_current].memory, _fileSize, MS_SYNC) == 0;
+}
+
+uint64_t SampleRecorder::querySegment(const Segment& segment, uint64_t fromNs, uint64_t toNs, const Visitor& visit,
+                                      int channel) const {
+    const SegmentHeader& header = *segment.header;
+    const uint32_t count = header.count.load(std::memory_order_acquire);
+    if (count == 0 || header.lastNs.load(std::memory_order_relaxed) < fromNs ||
+        header.firstNs.load(std::memory_order_relaxed) > toNs) {
+        return 0;
+    }
+
+    // Last index entry at or before fromNs: the range starts in that stride
+    const uint32_t stride = header.indexStride;
+    uint32_t low = 0;
+    uint32_t high = (count - 1) / stride;
+    while (low < high) {
+        const uint32_t middle = (low + high + 1) / 2;
+        if (header.index[middle] <= fromNs) {
+            low = middle;
+        } else {
+            high = middle - 1;
+        }
+    }
+
+    uint64_t visited = 0;
+    for (uint32_t i = low * stride; i < count; i++) {
+        const SampleRecord& record = segment.records[i];
+        if (record.timestampNs > toNs) break;
+        // A reader can be overtaken by the writer reusing this segment
+        if (record.sequence != static_cast<uint32_t>(header.firstSequence + i)) break;
+        if (record.timestampNs < fromNs) continue;
+        if (channel >= 0 && record.channel != channel) continue;
+        visit(record);
+        visited++;
+    }
+    return visited;
+}
+
+uint64_t SampleRecorder::query(uint64_t fromNs, uint64_t toNs, const Visitor& visit, int channel) const {
+    if (_segments == nullptr) return 0;
+
+    // Segments in recording order: oldest generation first
+    uint64_t visited = 0;
+    uint64_t generation = 0;
+    for (;;) {
+        int next = -1;
+        for (uint32_t i = 0; i < _segmentCount; i++) {
+            const SegmentHeader& header = *_segments[i].header;
+            if (header.magic != SEGMENT_MAGIC || header.state.load(std::memory_order_acquire) == Empty) continue;
+            if (header.generation > generation && (next < 0 || header.generation < _segments[next].header->generation)) {
+                next = static_cast<int>(i);
+            }
+        }
+        if (next < 0) return visited;
+        generation = _segments[next].header->generation;
+        visited += querySegment(_segments[next], fromNs, toNs, visit, channel);
+    }
+}
+
+uint64_t SampleRecorder::getRecords() const {
+    uint64_t records = 0;
+    for (uint32_t i = 0; i < _segmentCount; i++) {
+        const SegmentHeader& header = *_segments[i].header;
+        if (header.magic == SEGMENT_MAGIC && header.state.load(std::memory_order_acquire) != Empty) {
+            records += header.count.load(std::memory_order_relaxed);
+        }
+    }
+    return records;
+}
+
+uint64_t SampleRecorder::getOldestNs() const {
+    uint64_t oldest = 0;
+    uint64_t generation = 0;
+    for (uint32_t i = 0; i < _segmentCount; i++) {
+        const SegmentHeader& header = *_segments[i].header;
+        if (header.magic != SEGMENT_MAGIC || header.state.load(std::memory_order_acquire) == Empty ||
+            header.count.load(std::memory_order_relaxed) == 0) {
+            continue;
+        }
+        if (generation == 0 || header.generation < generation) {
+            generation = header.generation;
+            oldest = header.firstNs.load(std::memory_order_relaxed);
+        }
+    }
+    return oldest;
+}
+
+uint64_t SampleRecorder::getNewestNs() const {
+    uint64_t newest = 0;
+    for (uint32_t i = 0; i < _segmentCount; i++) {
+        const SegmentHeader& header = *_segments[i].header;
+        if (header.magic == SEGMENT_MAGIC && header.state.load(std::memory_order_acquire) != Empty) {
+            const uint64_t last = header.lastNs.load(std::memory_order_relaxed);
+            if (last > newest) newest = last;
+        }
+    }
+    return newest;
+}
+
+std::vector<SampleRecorder::SegmentView> SampleRecorder::segments() const {
+    std::vector<SegmentView> views;
+    if (_segments == nullptr) return views;
+
+    uint64_t generation = 0;
+    for (;;) {
+        int next = -1;
+        for (uint32_t i = 0; i < _segmentCount; i++) {
+            const SegmentHeader& header = *_segments[i].header;
+            if (header.magic != SEGMENT_MAGIC || header.state.load(std::memory_order_acquire) == Empty) continue;
+            if (header.generation > generation && (next < 0 || header.generation < _segments[next].header->generation)) {
+                next = static_cast<int>(i);
+            }
+        }
+        if (next < 0) return views;
+
+        const Segment& segment = _segments[next];
+        const SegmentHeader& header = *segment.header;
+        generation = header.generation;
+        SegmentView view;
+        view.records = segment.records;
+        view.count = header.count.load(std::memory_order_acquire);
+        view.generation = header.generation;
+        view.firstSequence = header.firstSequence;
+        view.firstNs = header.firstNs.load(std::memory_order_relaxed);
+        view.lastNs = header.lastNs.load(std::memory_order_relaxed);
+        if (view.count > 0) views.push_back(view);
+    }
+}
+
+static void appendJsonText(std::string& out, const std::string& text) {
+    out += '"';
+    for (const char c : text) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char escaped[8];
+            snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(c));
+            out += escaped;
+        } else {
+            out += c;
+        }
+    }
+    out += '"';
+}
+
+// Offsets come from the structs, so the description cannot drift from the
+// files. dtypes are numpy's: "<u8" is a little endian uint64.
+bool SampleRecorder::writeLayout(const std::vector<ChannelLayout>& channels) const {
+    if (_segments == nullptr || !_writable) return false;
+
+    struct Field {
+        const char* name;
+        size_t offset;
+        const char* dtype;
+    };
+    static const Field headerFields[] = {
+        {"magic", offsetof(SegmentHeader, magic), "<u4"},
+        {"version", offsetof(SegmentHeader, version), "<u4"},
+        {"recordSize", offsetof(SegmentHeader, recordSize), "<u4"},
+        {"capacity", offsetof(SegmentHeader, capacity), "<u4"},
+        {"generation", offsetof(SegmentHeader, generation), "<u8"},
+        {"firstSequence", offsetof(SegmentHeader, firstSequence), "<u8"},
+        {"state", offsetof(SegmentHeader, state), "<u4"},
+        {"count", offsetof(SegmentHeader, count), "<u4"},
+        {"firstNs", offsetof(SegmentHeader, firstNs), "<u8"},
+        {"lastNs", offsetof(SegmentHeader, lastNs), "<u8"},
+        {"indexStride", offsetof(SegmentHeader, indexStride), "<u4"},
+        {"index", offsetof(SegmentHeader, index), "<u8"},
+    };
+    static const Field recordFields[] = {
+        {"timestampNs", offsetof(SampleRecord, timestampNs), "<u8"},
+        {"channel", offsetof(SampleRecord, channel), "<u2"},
+        {"flags", offsetof(SampleRecord, flags), "<u2"},
+        {"value", offsetof(SampleRecord, value), "<f4"},
+        {"sequence", offsetof(SampleRecord, sequence), "<u4"},
+        {"check", offsetof(SampleRecord, check), "<u4"},
+    };
+
+    char line[256];
+    std::string json = "{\n";
+    snprintf(line, sizeof(line),
+             "  \"magic\": %u,\n  \"version\": %u,\n  \"segmentFiles\": \"seg_%%03u.dat\",\n  \"segments\": %u,\n"
+             "  \"headerBytes\": %u,\n  \"capacity\": %u,\n  \"indexStride\": %u,\n",
+             SEGMENT_MAGIC, SEGMENT_VERSION, _segmentCount, HeaderSize, _segmentRecords, _stride);
+    json += line;
+    json += "  \"states\": {\"empty\": 0, \"active\": 1, \"sealed\": 2},\n  \"header\": [\n";
+    for (size_t i = 0; i < sizeof(headerFields) / sizeof(headerFields[0]); i++) {
+        snprintf(line, sizeof(line), "    {\"name\": \"%s\", \"offset\": %zu, \"dtype\": \"%s\"}%s\n", headerFields[i].name,
+                 headerFields[i].offset, headerFields[i].dtype,
+                 i + 1 < sizeof(headerFields) / sizeof(headerFields[0]) ? "," : "");
+        json += line;
+    }
+    snprintf(line, sizeof(line), "  ],\n  \"record\": {\"stride\": %zu, \"fields\": [\n", sizeof(SampleRecord));
+    json += line;
+    for (size_t i = 0; i < sizeof(recordFields) / sizeof(recordFields[0]); i++) {
+        snprintf(line, sizeof(line), "    {\"name\": \"%s\", \"offset\": %zu, \"dtype\": \"%s\"}%s\n", recordFields[i].name,
+                 recordFields[i].offset, recordFields[i].dtype,
+                 i + 1 < sizeof(recordFields) / sizeof(recordFields[0]) ? "," : "");
+        json += line;
+    }
+    json += "  ]},\n  \"timestamps\": \"ns since the Unix epoch (CLOCK_REALTIME), non-decreasing\",\n  \"channels\": [\n";
+    for (size_t i = 0; i < channels.size(); i++) {
+        snprintf(line, sizeof(line), "    {\"channel\": %u, \"name\": ", static_cast<unsigned>(channels[i].channel));
+        json += line;
+        appendJsonText(json, channels[i].name);
+        json += ", \"unit\": ";
+        appendJsonText(json, channels[i].unit);
+        snprintf(line, sizeof(line), ", \"rateHz\": %g}%s\n", channels[i].rateHz, i + 1 < channels.size() ? "," : "");
+        json += line;
+    }
+    json += "  ]\n}\n";
+
+    // Readers never see half a file
+    const std::string path = _directory + "/layout.json";
+    const std::string temporary = path + ".tmp";
+    FILE* file = fopen(temporary.c_str(), "w");
+    if (file == nullptr) return false;
+    const bool written = fwrite(json.data(), 1, json.size(), file) == json.size();
+    if (fclose(file) != 0 || !written) {
+        unlink(temporary.c_str());
+        return false;
+    }
+    return rename(temporary.c_str(), path.c_str()) == 0;
+}
@@ -0,0 +1,161 @@
+#ifndef SAMPLE_RECORDER_H
+#define SAMPLE_RECORDER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// One vital-sign sample as stored on disk (24 bytes, little endian)
+struct SampleRecord {
+    uint64_t timestampNs;  // CLOCK_REALTIME, non-decreasing within a recording
+    uint16_t channel;      // See Channel, or any application number
+    uint16_t flags;
+    float value;
+    uint32_t sequence;     // Low 32 bits of the record number since the recording began
+    uint32_t check;        // Over the fields above; finds torn records after power loss
+};
+
+static_assert(sizeof(SampleRecord) == 24, "SampleRecord is a file format");
+
+// Channels of the SensorHub vital-sign modules
+enum class Channel : uint16_t { Ecg = 0, SpO2 = 1, PulseRate = 2, Temperature = 3 };
+
+// Persistent recorder: fixed-size records appended to a ring of
+// preallocated, memory-mapped segment files (seg_000.dat, ...).
+//
+// append() is a store into the mapping, no system call. Segments are
+// only synced when they are full: the full segment is flushed and sealed,
+// then the oldest segment is claimed as the next one (its header is
+// synced first, so it can never be mistaken for old data). After a power
+// loss the last segment is scanned up to the first record whose sequence
+// or check does not match; everything in sealed segments is intact.
+//
+// Every segment header holds the first/last timestamp and a timestamp for
+// every IndexStride-th record, so query() only touches the segments and
+// the part of a segment that overlap the requested range.
+//
+// The segments are also the export to analysis processes: they map the
+// same files read-only (MAP_SHARED, so the page cache is shared with the
+// writer) and read the records in place. writeLayout() describes the
+// files in layout.json for readers that are not C++: head fields, record
+// dtype with offsets and stride, and the channels recorded.
+class SampleRecorder {
+public:
+    static const uint32_t DefaultSegments = 64;
+    static const uint32_t DefaultSegmentRecords = 65536;  // 1.5 MiB per segment
+
+    SampleRecorder();
+    ~SampleRecorder();
+
+    // Writer: create the segments in directory, or continue a recording there
+    bool open(const std::string& directory, uint32_t segments = DefaultSegments,
+              uint32_t segmentRecords = DefaultSegmentRecords);
+
+    // Reader (another process, or after the fact): map the segments read-only
+    bool openReadOnly(const std::string& directory);
+
+    void close();
+
+    // Stamped with CLOCK_REALTIME
+    bool append(uint16_t channel, float value, uint16_t flags = 0);
+    // A timestamp before the previous one is raised to it, queries rely on the order
+    bool append(uint64_t timestampNs, uint16_t channel, float value, uint16_t flags = 0);
+
+    // Sync the current segment now (e.g. before a planned shutdown)
+    bool flush();
+
+    // Calls visit for every record with fromNs <= timestampNs <= toNs, oldest
+    // first, optionally only for one channel (-1 = all). Returns the count.
+    typedef std::function<void(const SampleRecord&)> Visitor;
+    uint64_t query(uint64_t fromNs, uint64_t toNs, const Visitor& visit, int channel = -1) const;
+
+    // One segment in the mapping, no copy. Records [0, count) were complete
+    // when the view was taken. In a live recording the writer reuses the
+    // oldest segment: a record that is not isCurrent() has been overwritten.
+    struct SegmentView {
+        const SampleRecord* records;
+        uint32_t count;
+        uint64_t generation;
+        uint64_t firstSequence;   // Record number of records[0]
+        uint64_t firstNs;
+        uint64_t lastNs;
+
+        bool isCurrent(uint32_t i) const { return records[i].sequence == static_cast<uint32_t>(firstSequence + i); }
+    };
+
+    // Segments with records, oldest first
+    std::vector<SegmentView> segments() const;
+
+    struct ChannelLayout {
+        uint16_t channel;
+        std::string name;
+        std::string unit;
+        double rateHz;            // Nominal, 0 = irregular
+    };
+
+    // Writer: layout.json next to the segments, replaced atomically
+    bool writeLayout(const std::vector<ChannelLayout>& channels) const;
+
+    uint64_t getRecords() const;        // Still in the ring
+    uint64_t getOldestNs() const;
+    uint64_t getNewestNs() const;
+    uint64_t getSyncs() const { return _syncs; }
+    uint64_t getRecovered() const { return _recovered; }  // Records found in the open segment by open()
+
+private:
+    static const uint32_t HeaderSize = 4096;
+    static const uint32_t IndexEntries = (HeaderSize - 64) / sizeof(uint64_t);
+
+    enum State : uint32_t { Empty = 0, Active = 1, Sealed = 2 };
+
+    struct SegmentHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t recordSize;
+        uint32_t capacity;
+        uint64_t generation;      // 1, 2, ... in recording order
+        uint64_t firstSequence;   // Record number of record 0
+        std::atomic<uint32_t> state;
+        std::atomic<uint32_t> count;
+        std::atomic<uint64_t> firstNs;
+        std::atomic<uint64_t> lastNs;
+        uint32_t indexStride;
+        uint32_t reserved;
+        uint64_t index[IndexEntries];  // Timestamp of record k * indexStride
+    };
+
+    struct Segment {
+        uint8_t* memory;
+        SegmentHeader* header;
+        SampleRecord* records;
+    };
+
+    static uint32_t checksum(const SampleRecord& record);
+    static size_t fileSize(uint32_t segmentRecords);
+
+    bool mapSegment(uint32_t number, bool writable, uint32_t segmentRecords);
+    void resetSegment(Segment& segment, uint64_t generation, uint64_t firstSequence);
+    uint32_t scanSegment(Segment& segment);
+    bool rotate();
+    uint64_t querySegment(const Segment& segment, uint64_t fromNs, uint64_t toNs, const Visitor& visit,
+                          int channel) const;
+
+    std::string _directory;
+    Segment* _segments;
+    uint32_t _segmentCount;
+    uint32_t _segmentRecords;
+    uint32_t _stride;
+    size_t _fileSize;
+    bool _writable;
+
+    uint32_t _current;       // Segment being appended to
+    uint64_t _nextSequence;
+    uint64_t _lastNs;
+    uint64_t _syncs;
+    uint64_t _recovered;
+};
+
+#endif // SAMPLE_RECORDER_H
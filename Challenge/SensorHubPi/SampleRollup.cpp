@@ -0,0 +1,231 @@
+#include "SampleRollup.h"
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const uint32_t ROLLUP_MAGIC = 0x56535255;  // "VSRU"
+static const uint32_t ROLLUP_VERSION = 1;
+
+static const char* const LEVEL_NAMES[SampleRollup::LevelCount] = {"1s", "10s", "1m", "10m"};
+static const uint64_t LEVEL_WIDTHS_NS[SampleRollup::LevelCount] = {
+    1000000000ull, 10000000000ull, 60000000000ull, 600000000000ull};
+static const uint32_t LEVEL_SLOTS[SampleRollup::LevelCount] = {86400, 60480, 43200, 52560};
+
+SampleRollup::SampleRollup() : _levels(), _fileSizes(), _channels(0), _writable(false) {}
+
+SampleRollup::~SampleRollup() {
+    close();
+}
+
+uint64_t SampleRollup::getWidthNs(uint32_t level) {
+    return LEVEL_WIDTHS_NS[level < LevelCount ? level : LevelCount - 1];
+}
+
+size_t SampleRollup::fileSize(uint32_t slots, uint16_t channels) {
+    return HeaderSize + static_cast<size_t>(slots) * channels * sizeof(Bucket);
+}
+
+bool SampleRollup::mapLevel(uint32_t number, bool writable) {
+    const std::string path = _directory + "/rollup_" + LEVEL_NAMES[number] + ".dat";
+    const int fd = ::open(path.c_str(), writable ? (O_RDWR | O_CREAT) : O_RDONLY, 0644);
+    if (fd == -1) return false;
+
+    struct stat info;
+    bool ok = fstat(fd, &info) == 0;
+    size_t size = 0;
+    if (ok && writable) {
+        size = fileSize(LEVEL_SLOTS[number], _channels);
+        // Reserve the blocks now: a full disk fails here, not as SIGBUS in add()
+        if (static_cast<size_t>(info.st_size) != size) {
+            ok = ftruncate(fd, 0) == 0 && posix_fallocate(fd, 0, static_cast<off_t>(size)) == 0;
+        }
+    } else if (ok) {
+        size = static_cast<size_t>(info.st_size);
+        ok = size > HeaderSize;
+    }
+
+    void* memory = MAP_FAILED;
+    if (ok) memory = mmap(nullptr, size, writable ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);  // The mapping keeps the file
+    if (memory == MAP_FAILED) return false;
+
+    Level& level = _levels[number];
+    level.memory = static_cast<uint8_t*>(memory);
+    level.header = reinterpret_cast<LevelHeader*>(level.memory);
+    level.buckets = reinterpret_cast<Bucket*>(level.memory + HeaderSize);
+    _fileSizes[number] = size;
+
+    LevelHeader& header = *level.header;
+    if (writable) {
+        const bool valid = header.magic == ROLLUP_MAGIC && header.version == ROLLUP_VERSION &&
+                           header.widthNs == LEVEL_WIDTHS_NS[number] && header.slots == LEVEL_SLOTS[number] &&
+                           header.channels == _channels;
+        if (!valid) {
+            // New, or another geometry: the buckets are meaningless, start empty
+            memset(level.memory, 0, size);
+            header.magic = ROLLUP_MAGIC;
+            header.version = ROLLUP_VERSION;
+            header.widthNs = LEVEL_WIDTHS_NS[number];
+            header.slots = LEVEL_SLOTS[number];
+            header.channels = _channels;
+            header.newest.store(0, std::memory_order_relaxed);
+            msync(level.memory, size, MS_SYNC);
+        }
+    } else {
+        const bool valid = header.magic == ROLLUP_MAGIC && header.version == ROLLUP_VERSION && header.slots != 0 &&
+                           size == fileSize(header.slots, static_cast<uint16_t>(header.channels));
+        if (!valid) return false;
+        if (number == 0) _channels = static_cast<uint16_t>(header.channels);
+        if (header.channels != _channels) return false;
+    }
+    level.widthNs = header.widthNs;
+    level.slots = header.slots;
+    return true;
+}
+
+bool SampleRollup::open(const std::string& directory, uint16_t channels) {
+    close();
+    if (channels == 0) return false;
+
+    mkdir(directory.c_str(), 0755);
+    _directory = directory;
+    _writable = true;
+    _channels = channels;
+    for (uint32_t i = 0; i < LevelCount; i++) {
+        if (!mapLevel(i, true)) {
+            close();
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SampleRollup::openReadOnly(const std::string& directory) {
+    close();
+    _directory = directory;
+    _writable = false;
+    for (uint32_t i = 0; i < LevelCount; i++) {
+        if (!mapLevel(i, false)) {
+            close();
+            return false;
+        }
+    }
+    return true;
+}
+
+void SampleRollup::close() {
+    if (_writable) flush();
+    for (uint32_t i = 0; i < LevelCount; i++) {
+        if (_levels[i].memory != nullptr) munmap(_levels[i].memory, _fileSizes[i]);
+        _levels[i] = Level();
+        _fileSizes[i] = 0;
+    }
+    _channels = 0;
+    _writable = false;
+}
+
+bool SampleRollup::add(uint64_t timestampNs, uint16_t channel, float value) {
+    if (!_writable || channel >= _channels) return false;
+
+    for (uint32_t i = 0; i < LevelCount; i++) {
+        Level& level = _levels[i];
+        const uint64_t number = timestampNs / level.widthNs + 1;
+        const uint64_t newest = level.header->newest.load(std::memory_order_relaxed);
+        if (newest >= level.slots && number <= newest - level.slots) continue;  // Out of retention
+        if (number > newest) level.header->newest.store(number, std::memory_order_relaxed);
+
+        Bucket& bucket = level.buckets[static_cast<size_t>(channel) * level.slots + number % level.slots];
+        const uint64_t held = bucket.number.load(std::memory_order_relaxed);
+        if (held > number) continue;  // Its slot has moved on to a newer bucket
+
+        const uint32_t sequence = bucket.sequence.load(std::memory_order_relaxed);
+        bucket.sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        if (held != number) {
+            bucket.number.store(number, std::memory_order_relaxed);
+            bucket.count = 0;
+            bucket.min = value;
+            bucket.max = value;
+            bucket.sum = 0.0;
+        }
+        bucket.count++;
+        if (value < bucket.min) bucket.min = value;
+        if (value > bucket.max) bucket.max = value;
+        bucket.sum += value;
+        bucket.sequence.store(sequence + 2, std::memory_order_release);
+    }
+    return true;
+}
+
+bool SampleRollup::flush() {
+    if (!_writable) return false;
+    bool ok = true;
+    for (uint32_t i = 0; i < LevelCount; i++) {
+        if (_levels[i].memory != nullptr) ok = msync(_levels[i].memory, _fileSizes[i], MS_SYNC) == 0 && ok;
+    }
+    return ok;
+}
+
+// Consistent copy of bucket 'number', false if its slot holds no such bucket
+bool SampleRollup::readBucket(const Level& level, uint16_t channel, uint64_t number, RollupBucket& out) const {
+    const Bucket& bucket = level.buckets[static_cast<size_t>(channel) * level.slots + number % level.slots];
+    for (;;) {
+        const uint32_t before = bucket.sequence.load(std::memory_order_acquire);
+        if ((before & 1) != 0) continue;  // The writer is in the middle of an update
+        const uint64_t held = bucket.number.load(std::memory_order_relaxed);
+        const uint32_t count = bucket.count;
+        const float min = bucket.min;
+        const float max = bucket.max;
+        const double sum = bucket.sum;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (bucket.sequence.load(std::memory_order_relaxed) != before) continue;
+
+        if (held != number || count == 0) return false;
+        out.startNs = (number - 1) * level.widthNs;
+        out.widthNs = level.widthNs;
+        out.channel = channel;
+        out.count = count;
+        out.min = min;
+        out.max = max;
+        out.mean = static_cast<float>(sum / count);
+        return true;
+    }
+}
+
+uint32_t SampleRollup::levelFor(uint64_t fromNs, uint64_t resolutionNs) const {
+    uint32_t level = 0;
+    while (level + 1 < LevelCount && getWidthNs(level + 1) <= resolutionNs) level++;
+    for (; level + 1 < LevelCount; level++) {
+        const Level& candidate = _levels[level];
+        if (candidate.header == nullptr) break;
+        const uint64_t newest = candidate.header->newest.load(std::memory_order_relaxed);
+        if (newest < candidate.slots || fromNs / candidate.widthNs + 1 > newest - candidate.slots) break;
+    }
+    return level;
+}
+
+uint64_t SampleRollup::query(uint16_t channel, uint64_t fromNs, uint64_t toNs, uint64_t resolutionNs,
+                             const Visitor& visit) const {
+    if (channel >= _channels || fromNs > toNs) return 0;
+    const Level& level = _levels[levelFor(fromNs, resolutionNs)];
+    if (level.header == nullptr) return 0;
+
+    // Only the buffered part of the range: never more than one lap of the ring
+    const uint64_t newest = level.header->newest.load(std::memory_order_acquire);
+    uint64_t first = fromNs / level.widthNs + 1;
+    uint64_t last = toNs / level.widthNs + 1;
+    if (last > newest) last = newest;
+    if (newest >= level.slots && first <= newest - level.slots) first = newest - level.slots + 1;
+
+    uint64_t found = 0;
+    RollupBucket bucket;
+    for (uint64_t number = first; number <= last; number++) {
+        if (!readBucket(level, channel, number, bucket)) continue;
+        visit(bucket);
+        found++;
+    }
+    return found;
+}
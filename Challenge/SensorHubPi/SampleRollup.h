@@ -0,0 +1,114 @@
+#ifndef SAMPLE_ROLLUP_H
+#define SAMPLE_ROLLUP_H
+
+#include "SampleRecorder.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+// Summary of one channel over [startNs, startNs + widthNs)
+struct RollupBucket {
+    uint64_t startNs;
+    uint64_t widthNs;
+    uint16_t channel;
+    uint32_t count;
+    float min;
+    float max;
+    float mean;
+};
+
+// Min/max/mean/count of every channel at 1 s, 10 s, 1 min and 10 min,
+// updated by add() as the samples arrive, so a dashboard can draw a day
+// from 1440 one-minute buckets instead of 43 million ECG samples.
+//
+// Each level is a preallocated, memory-mapped file next to the segments
+// (rollup_1s.dat, ...) holding a ring of buckets per channel. A bucket's
+// slot follows from its start time, so add() and query() address buckets
+// directly, without an index. Default retention: 1 day of 1 s buckets,
+// 1 week of 10 s, 30 days of 1 min and a year of 10 min (31 MiB for four
+// channels).
+//
+// Buckets are written under a per-bucket sequence count, so a reader in
+// another process never sees a half-updated bucket. The files are only
+// synced by flush() and close(): after a power loss the buckets of the last
+// minutes may miss samples that the recorder still has.
+class SampleRollup {
+public:
+    static const uint32_t LevelCount = 4;
+    static const uint16_t DefaultChannels = 4;
+
+    SampleRollup();
+    ~SampleRollup();
+
+    // Writer: create the level files in directory, or continue the rollups there
+    bool open(const std::string& directory, uint16_t channels = DefaultChannels);
+
+    // Reader (another process, or after the fact): map the level files read-only
+    bool openReadOnly(const std::string& directory);
+
+    void close();
+
+    // Channels at or above getChannels() are not rolled up (returns false).
+    // A sample older than a level's retention is left out of that level.
+    bool add(uint64_t timestampNs, uint16_t channel, float value);
+    bool add(const SampleRecord& record) { return add(record.timestampNs, record.channel, record.value); }
+
+    bool flush();
+
+    // Coarsest level whose buckets are at most resolutionNs wide (the 1 s
+    // level for anything finer), then coarser while the level no longer holds
+    // fromNs. Calls visit for every non-empty bucket that overlaps
+    // [fromNs, toNs], oldest first. Returns the count.
+    typedef std::function<void(const RollupBucket&)> Visitor;
+    uint64_t query(uint16_t channel, uint64_t fromNs, uint64_t toNs, uint64_t resolutionNs, const Visitor& visit) const;
+
+    // The level query() would use
+    uint32_t levelFor(uint64_t fromNs, uint64_t resolutionNs) const;
+    static uint64_t getWidthNs(uint32_t level);
+    uint16_t getChannels() const { return _channels; }
+
+private:
+    static const uint32_t HeaderSize = 4096;
+
+    struct LevelHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t widthNs;
+        uint32_t slots;                 // Buckets per channel
+        uint32_t channels;
+        std::atomic<uint64_t> newest;   // Highest bucket number added, + 1 (0 = none)
+    };
+
+    struct Bucket {
+        std::atomic<uint64_t> number;   // startNs / widthNs + 1 (0 = empty)
+        std::atomic<uint32_t> sequence; // Odd while the writer updates the bucket
+        uint32_t count;
+        float min;
+        float max;
+        uint32_t reserved;
+        double sum;
+    };
+
+    struct Level {
+        uint8_t* memory;
+        LevelHeader* header;
+        Bucket* buckets;
+        uint64_t widthNs;
+        uint32_t slots;
+    };
+
+    static size_t fileSize(uint32_t slots, uint16_t channels);
+
+    bool mapLevel(uint32_t level, bool writable);
+    bool readBucket(const Level& level, uint16_t channel, uint64_t number, RollupBucket& bucket) const;
+
+    std::string _directory;
+    Level _levels[LevelCount];
+    size_t _fileSizes[LevelCount];
+    uint16_t _channels;
+    bool _writable;
+};
+
+#endif // SAMPLE_ROLLUP_H
@@ -0,0 +1,21 @@
+#ifndef VITAL_BUS_H
+#define VITAL_BUS_H
+
+#include "SampleBus.h"
+#include <cstdint>
+
+// The gateway's sample bus: what the SensorHub reader publishes and the
+// recorder, displays and exporters consume
+struct VitalSample {
+    uint64_t timestampNs;
+    uint16_t channel;  // Channel
+    uint16_t flags;
+    float value;
+};
+
+typedef SampleBus<VitalSample, 4096> VitalBus;
+typedef ShmSampleBus<VitalSample, 4096> SharedVitalBus;
+
+static const char* const BUS_NAME = "/vitals_bus";
+
+#endif // VITAL_BUS_H
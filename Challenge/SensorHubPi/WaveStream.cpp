@@ -0,0 +1,499 @@
+#include "WaveStream.h"
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+static const size_t MAX_REQUEST = 8192;
+static const uint16_t DEFAULT_RATE_HZ = 500;
+
+static const char PAGE[] =
+    "<!DOCTYPE html><html><head><meta name=viewport content='width=device-width'><title>SensorHub</title></head>"
+    "<body style='margin:0;background:#000'><canvas id=c></canvas><script>\n"
+    "const c=document.getElementById('c'),g=c.getContext('2d'),q=new URLSearchParams(location.search);\n"
+    "c.width=innerWidth;c.height=innerHeight;const ch=q.get('channel')||0,s=q.get('seconds')||5;\n"
+    "let lo=new Float32Array(c.width),hi=new Float32Array(c.width),x=0;\n"
+    "const ws=new WebSocket(`ws://${location.host}/stream?channel=${ch}&width=${c.width}&seconds=${s}`);\n"
+    "ws.binaryType='arraybuffer';ws.onmessage=e=>{const d=new DataView(e.data),o=d.getFloat32(16,true),\n"
+    "k=d.getFloat32(20,true),n=d.getUint16(24,true);for(let i=0;i<n;i++){lo[x]=o+k*d.getInt16(26+4*i,true);\n"
+    "hi[x]=o+k*d.getInt16(28+4*i,true);x=(x+1)%c.width;}let a=Math.min(...lo),b=Math.max(...hi);if(b<=a)b=a+1;\n"
+    "g.fillStyle='#000';g.fillRect(0,0,c.width,c.height);g.fillStyle='#0f0';const y=v=>c.height*(b-v)/(b-a);\n"
+    "for(let i=0;i<c.width;i++)g.fillRect(i,y(hi[i]),1,Math.max(1,y(lo[i])-y(hi[i])));};\n"
+    "</script></body></html>";
+
+static uint64_t monotonicMs() {
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<uint64_t>(now.tv_sec) * 1000u + static_cast<uint64_t>(now.tv_nsec) / 1000000u;
+}
+
+static void put16(std::string& out, uint16_t value) {
+    out.push_back(static_cast<char>(value & 0xFF));
+    out.push_back(static_cast<char>(value >> 8));
+}
+
+static void put32(std::string& out, uint32_t value) {
+    for (int i = 0; i < 4; i++) out.push_back(static_cast<char>(value >> (8 * i)));
+}
+
+static void putFloat(std::string& out, float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    put32(out, bits);
+}
+
+// SHA-1 (FIPS 180-4), only for the WebSocket handshake
+static void sha1(const std::string& message, uint8_t digest[20]) {
+    uint32_t h[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+    std::string data = message;
+    const uint64_t bits = static_cast<uint64_t>(message.size()) * 8;
+    data.push_back(static_cast<char>(0x80));
+    while (data.size() % 64 != 56) data.push_back(0);
+    for (int i = 7; i >= 0; i--) data.push_back(static_cast<char>(bits >> (8 * i)));
+
+    for (size_t block = 0; block < data.size(); block += 64) {
+        uint32_t w[80];
+        for (int i = 0; i < 16; i++) {
+            const uint8_t* p = reinterpret_cast<const uint8_t*>(data.data() + block + 4 * i);
+            w[i] = static_cast<uint32_t>(p[0]) << 24 | static_cast<uint32_t>(p[1]) << 16 |
+                   static_cast<uint32_t>(p[2]) << 8 | p[3];
+        }
+        for (int i = 16; i < 80; i++) {
+            const uint32_t x = w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16];
+            w[i] = x << 1 | x >> 31;
+        }
+        uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+        for (int i = 0; i < 80; i++) {
+            uint32_t f, k;
+            if (i < 20) {
+                f = (b & c) | (~b & d);
+                k = 0x5A827999;
+            } else if (i < 40) {
+                f = b ^ c ^ d;
+                k = 0x6ED9EBA1;
+            } else if (i < 60) {
+                f = (b & c) | (b & d) | (c & d);
+                k = 0x8F1BBCDC;
+            } else {
+                f = b ^ c ^ d;
+                k = 0xCA62C1D6;
+            }
+            const uint32_t t = (a << 5 | a >> 27) + f + e + k + w[i];
+            e = d;
+            d = c;
+            c = b << 30 | b >> 2;
+            b = a;
+            a = t;
+        }
+        h[0] += a;
+        h[1] += b;
+        h[2] += c;
+        h[3] += d;
+        h[4] += e;
+    }
+    for (int i = 0; i < 20; i++) digest[i] = static_cast<uint8_t>(h[i / 4] >> (24 - 8 * (i % 4)));
+}
+
+static std::string base64(const uint8_t* data, size_t size) {
+    static const char digits[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string out;
+    for (size_t i = 0; i < size; i += 3) {
+        const uint32_t n = static_cast<uint32_t>(data[i]) << 16 | (i + 1 < size ? data[i + 1] << 8 : 0) |
+                           (i + 2 < size ? data[i + 2] : 0);
+        out.push_back(digits[n >> 18 & 63]);
+        out.push_back(digits[n >> 12 & 63]);
+        out.push_back(i + 1 < size ? digits[n >> 6 & 63] : '=');
+        out.push_back(i + 2 < size ? digits[n & 63] : '=');
+    }
+    return out;
+}
+
+// Value of name=... in the query string of path, or fallback
+static long queryValue(const std::string& path, const char* name, long fallback) {
+    const size_t query = path.find('?');
+    if (query == std::string::npos) return fallback;
+    const std::string key = std::string(name) + "=";
+    for (size_t at = query + 1; at < path.size();) {
+        const size_t end = std::min(path.find('&', at), path.size());
+        if (path.compare(at, key.size(), key) == 0) return std::strtol(path.c_str() + at + key.size(), nullptr, 10);
+        at = end + 1;
+    }
+    return fallback;
+}
+
+EnvelopeDecimator::EnvelopeDecimator(uint16_t channel, uint32_t samplesPerPoint)
+    : _channel(channel), _samplesPerPoint(samplesPerPoint == 0 ? 1 : samplesPerPoint), _inPoint(0), _pointMin(0),
+      _pointMax(0), _pointNs(0), _firstNs(0) {
+    _min.reserve(MaxPoints);
+    _max.reserve(MaxPoints);
+}
+
+void EnvelopeDecimator::add(uint64_t timestampNs, float value) {
+    if (_inPoint == 0) {
+        _pointMin = value;
+        _pointMax = value;
+        _pointNs = timestampNs;
+    } else if (value < _pointMin) {
+        _pointMin = value;
+    } else if (value > _pointMax) {
+        _pointMax = value;
+    }
+    if (++_inPoint < _samplesPerPoint) return;
+
+    if (_min.empty()) _firstNs = _pointNs;
+    _min.push_back(_pointMin);
+    _max.push_back(_pointMax);
+    _inPoint = 0;
+}
+
+void EnvelopeDecimator::takeFrame(std::string& frame) {
+    const uint16_t points = static_cast<uint16_t>(std::min<size_t>(_min.size(), MaxPoints));
+    float low = points > 0 ? _min[0] : 0.0f;
+    float high = low;
+    for (uint16_t i = 0; i < points; i++) {
+        low = std::min(low, _min[i]);
+        high = std::max(high, _max[i]);
+    }
+    // 16 bits over the range of this frame
+    const float offset = (low + high) / 2;
+    const float scale = high > low ? (high - low) / 65534.0f : 1.0f;
+
+    frame.clear();
+    frame.reserve(HeaderBytes + 4u * points);
+    frame.push_back(static_cast<char>(Version));
+    frame.push_back(0);
+    put16(frame, _channel);
+    put32(frame, _samplesPerPoint);
+    put32(frame, static_cast<uint32_t>(_firstNs));
+    put32(frame, static_cast<uint32_t>(_firstNs >> 32));
+    putFloat(frame, offset);
+    putFloat(frame, scale);
+    put16(frame, points);
+    for (uint16_t i = 0; i < points; i++) {
+        const long min = std::lround((_min[i] - offset) / scale);
+        const long max = std::lround((_max[i] - offset) / scale);
+        put16(frame, static_cast<uint16_t>(static_cast<int16_t>(std::max(-32767L, std::min(32767L, min)))));
+        put16(frame, static_cast<uint16_t>(static_cast<int16_t>(std::max(-32767L, std::min(32767L, max)))));
+    }
+    _min.erase(_min.begin(), _min.begin() + points);
+    _max.erase(_max.begin(), _max.begin() + points);
+}
+
+WaveStreamServer::WaveStreamServer() : _listen(-1), _lastFrameMs(0), _framesSent(0), _framesDropped(0) {}
+
+WaveStreamServer::~WaveStreamServer() {
+    close();
+}
+
+bool WaveStreamServer::listen(uint16_t port) {
+    close();
+    _listen = socket(AF_INET6, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    if (_listen == -1) return false;
+    const int off = 0;
+    const int on = 1;
+    setsockopt(_listen, IPPROTO_IPV6, IPV6_V6ONLY, &off, sizeof(off));  // IPv4 clients too
+    setsockopt(_listen, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+
+    sockaddr_in6 address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin6_family = AF_INET6;
+    address.sin6_addr = in6addr_any;
+    address.sin6_port = htons(port);
+    if (bind(_listen, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || ::listen(_listen, 16) != 0) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void WaveStreamServer::close() {
+    for (Client& client : _clients) ::close(client.socket);
+    _clients.clear();
+    _decimators.clear();
+    if (_listen != -1) ::close(_listen);
+    _listen = -1;
+}
+
+void WaveStreamServer::setChannelRate(uint16_t channel, uint32_t hz) {
+    for (auto& rate : _rates) {
+        if (rate.first == channel) {
+            rate.second = hz;
+            return;
+        }
+    }
+    _rates.emplace_back(channel, hz);
+}
+
+uint32_t WaveStreamServer::rateOf(uint16_t channel) const {
+    for (const auto& rate : _rates) {
+        if (rate.first == channel) return rate.second;
+    }
+    return DEFAULT_RATE_HZ;
+}
+
+size_t WaveStreamServer::getClients() const {
+    size_t count = 0;
+    for (const Client& client : _clients) {
+        if (client.upgraded) count++;
+    }
+    return count;
+}
+
+// An envelope nobody watches any more is reused for the next request
+int WaveStreamServer::decimatorFor(uint16_t channel, uint32_t samplesPerPoint) {
+    int unused = -1;
+    for (size_t i = 0; i < _decimators.size(); i++) {
+        Decimator& decimator = _decimators[i];
+        if (decimator.clients == 0) {
+            unused = static_cast<int>(i);
+        } else if (decimator.envelope.getChannel() == channel &&
+                   decimator.envelope.getSamplesPerPoint() == samplesPerPoint) {
+            decimator.clients++;
+            return static_cast<int>(i);
+        }
+    }
+    const Decimator fresh{EnvelopeDecimator(channel, samplesPerPoint), 1};
+    if (unused >= 0) {
+        _decimators[unused] = fresh;
+        return unused;
+    }
+    _decimators.push_back(fresh);
+    return static_cast<int>(_decimators.size() - 1);
+}
+
+void WaveStreamServer::release(Client& client) {
+    if (client.decimator >= 0) _decimators[client.decimator].clients--;
+    client.decimator = -1;
+}
+
+void WaveStreamServer::feed(uint16_t channel, uint64_t timestampNs, float value) {
+    for (Decimator& decimator : _decimators) {
+        if (decimator.clients == 0 || decimator.envelope.getChannel() != channel) continue;
+        decimator.envelope.add(timestampNs, value);
+        if (decimator.envelope.getPending() < EnvelopeDecimator::MaxPoints) continue;
+
+        // Full before its interval (very fine decimation): send right away
+        std::string payload;
+        decimator.envelope.takeFrame(payload);
+        const int index = static_cast<int>(&decimator - &_decimators[0]);
+        for (Client& client : _clients) {
+            if (client.decimator == index) queue(client, payload);
+        }
+    }
+}
+
+void WaveStreamServer::appendFrameHeader(std::string& out, uint8_t opcode, size_t length) {
+    out.push_back(static_cast<char>(0x80 | opcode));  // FIN, not masked (server to client)
+    if (length < 126) {
+        out.push_back(static_cast<char>(length));
+    } else if (length <= 0xFFFF) {
+        out.push_back(126);
+        out.push_back(static_cast<char>(length >> 8));
+        out.push_back(static_cast<char>(length & 0xFF));
+    } else {
+        out.push_back(127);
+        for (int i = 7; i >= 0; i--) out.push_back(static_cast<char>(static_cast<uint64_t>(length) >> (8 * i)));
+    }
+}
+
+// Whole frames only: a frame that does not fit the backlog is dropped
+void WaveStreamServer::queue(Client& client, const std::string& payload) {
+    if (client.closing) return;
+    if (client.out.size() - client.sent + payload.size() + 10 > MaxBacklog) {
+        client.dropped++;
+        _framesDropped++;
+        return;
+    }
+    if (client.sent > 0 && client.sent == client.out.size()) {
+        client.out.clear();
+        client.sent = 0;
+    }
+    appendFrameHeader(client.out, 0x2, payload.size());
+    client.out += payload;
+    _framesSent++;
+}
+
+void WaveStreamServer::sendDue() {
+    const uint64_t now = monotonicMs();
+    if (now - _lastFrameMs < FrameIntervalMs) return;
+    _lastFrameMs = now;
+
+    std::string payload;
+    for (size_t i = 0; i < _decimators.size(); i++) {
+        EnvelopeDecimator& envelope = _decimators[i].envelope;
+        if (_decimators[i].clients == 0 || envelope.getPending() == 0) continue;
+        envelope.takeFrame(payload);  // Encoded once for all its clients
+        for (Client& client : _clients) {
+            if (client.decimator == static_cast<int>(i)) queue(client, payload);
+        }
+    }
+}
+
+void WaveStreamServer::accept() {
+    for (;;) {
+        const int socket = accept4(_listen, nullptr, nullptr, SOCK_NONBLOCK);
+        if (socket == -1) return;
+        const int on = 1;
+        setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+        _clients.push_back(Client{socket, false, false, std::string(), std::string(), 0, -1, 0});
+    }
+}
+
+std::string WaveStreamServer::acceptKey(const std::string& key) {
+    uint8_t digest[20];
+    sha1(key + "258EAFA5-E914-47DA-95CA-C5AB0DC85B11", digest);
+    return base64(digest, sizeof(digest));
+}
+
+// The HTTP request: the page, or the upgrade to a stream
+bool WaveStreamServer::handshake(Client& client) {
+    const size_t end = client.in.find("\r\n\r\n");
+    if (end == std::string::npos) return client.in.size() < MAX_REQUEST;
+    const std::string request = client.in.substr(0, end + 2);
+    client.in.erase(0, end + 4);
+
+    const size_t pathEnd = request.find(' ', 4);
+    if (request.compare(0, 4, "GET ") != 0 || pathEnd == std::string::npos) return false;
+    const std::string path = request.substr(4, pathEnd - 4);
+
+    std::string key;
+    std::string lower(request);
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return std::tolower(c); });
+    const size_t header = lower.find("\r\nsec-websocket-key:");
+    if (header != std::string::npos) {
+        size_t at = header + 20;
+        while (at < request.size() && request[at] == ' ') at++;
+        key = request.substr(at, request.find("\r\n", at) - at);
+    }
+
+    if (key.empty()) {
+        if (path != "/" && path.compare(0, 2, "/?") != 0) {
+            client.out = "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+        } else {
+            client.out = "HTTP/1.1 200 OK\r\nContent-Type: text/html\r\nConnection: close\r\nContent-Length: " +
+                         std::to_string(sizeof(PAGE) - 1) + "\r\n\r\n" + PAGE;
+        }
+        client.closing = true;
+        return true;
+    }
+
+    // Samples per point for width pixels over seconds, rounded to a power of two
+    const uint16_t channel = static_cast<uint16_t>(queryValue(path, "channel", 0));
+    const long width = std::max(16L, queryValue(path, "width", 1024));
+    const long seconds = std::max(1L, queryValue(path, "seconds", 5));
+    const double ideal = static_cast<double>(rateOf(channel)) * seconds / width;
+    uint32_t samplesPerPoint = 1;
+    while (samplesPerPoint < (1u << 20) && samplesPerPoint * 1.5 < ideal) samplesPerPoint <<= 1;
+
+    client.out = "HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+                 "Sec-WebSocket-Accept: " + acceptKey(key) + "\r\n\r\n";
+    client.upgraded = true;
+    client.decimator = decimatorFor(channel, samplesPerPoint);
+    return true;
+}
+
+// Frames from the browser: answer ping and close, ignore the rest
+bool WaveStreamServer::handleFrames(Client& client) {
+    for (;;) {
+        const std::string& in = client.in;
+        if (in.size() < 2) return true;
+        const uint8_t opcode = static_cast<uint8_t>(in[0]) & 0x0F;
+        const bool masked = (static_cast<uint8_t>(in[1]) & 0x80) != 0;
+        uint64_t length = static_cast<uint8_t>(in[1]) & 0x7F;
+        size_t at = 2;
+        if (length >= 126) {
+            const size_t bytes = length == 126 ? 2 : 8;
+            if (in.size() < at + bytes) return true;
+            length = 0;
+            for (size_t i = 0; i < bytes; i++) length = length << 8 | static_cast<uint8_t>(in[at + i]);
+            at += bytes;
+        }
+        if (!masked || length > MAX_REQUEST) return false;  // Clients must mask; no large messages expected
+        if (in.size() < at + 4 + length) return true;
+
+        std::string payload = in.substr(at + 4, static_cast<size_t>(length));
+        for (size_t i = 0; i < payload.size(); i++) payload[i] ^= in[at + i % 4];
+        client.in.erase(0, at + 4 + static_cast<size_t>(length));
+
+        if (opcode == 0x8) {
+            std::string reply;
+            appendFrameHeader(reply, 0x8, 0);
+            client.out += reply;
+            client.closing = true;
+            return true;
+        }
+        if (opcode == 0x9) {
+            std::string pong;
+            appendFrameHeader(pong, 0xA, payload.size());
+            client.out += pong + payload;
+        }
+    }
+}
+
+bool WaveStreamServer::readFrom(Client& client) {
+    char buffer[4096];
+    for (;;) {
+        const ssize_t received = recv(client.socket, buffer, sizeof(buffer), 0);
+        if (received == 0) return false;
+        if (received < 0) break;
+        client.in.append(buffer, static_cast<size_t>(received));
+        if (client.in.size() > 2 * MAX_REQUEST) return false;
+    }
+    if (errno != EAGAIN && errno != EWOULDBLOCK) return false;
+    if (client.closing) return true;
+    if (!client.upgraded) return handshake(client) && (!client.upgraded || handleFrames(client));
+    return handleFrames(client);
+}
+
+bool WaveStreamServer::writeTo(Client& client) {
+    while (client.sent < client.out.size()) {
+        const ssize_t sent = send(client.socket, client.out.data() + client.sent, client.out.size() - client.sent,
+                                  MSG_NOSIGNAL);
+        if (sent < 0) return errno == EAGAIN || errno == EWOULDBLOCK;
+        client.sent += static_cast<size_t>(sent);
+    }
+    client.out.clear();
+    client.sent = 0;
+    return !client.closing;
+}
+
+void WaveStreamServer::poll(int timeoutMs) {
+    if (_listen == -1) return;
+
+    std::vector<pollfd> fds;
+    fds.reserve(_clients.size() + 1);
+    fds.push_back(pollfd{_listen, POLLIN, 0});
+    for (const Client& client : _clients) {
+        const short events = static_cast<short>(POLLIN | (client.sent < client.out.size() ? POLLOUT : 0));
+        fds.push_back(pollfd{client.socket, events, 0});
+    }
+    ::poll(fds.data(), fds.size(), timeoutMs);
+
+    sendDue();
+    for (size_t i = 0; i < _clients.size(); i++) {
+        Client& client = _clients[i];
+        const short events = fds[i + 1].revents;
+        bool keep = (events & (POLLERR | POLLNVAL)) == 0;
+        if (keep && (events & (POLLIN | POLLHUP)) != 0) keep = readFrom(client);
+        if (keep && client.sent < client.out.size()) keep = writeTo(client);  // Also frames queued just now
+        if (keep && client.closing && client.out.empty()) keep = false;
+        if (!keep) {
+            ::close(client.socket);
+            client.socket = -1;  // Removed below
+        }
+    }
+    for (size_t i = _clients.size(); i-- > 0;) {
+        if (_clients[i].socket != -1) continue;
+        release(_clients[i]);
+        _clients.erase(_clients.begin() + static_cast<std::ptrdiff_t>(i));
+    }
+    if (fds[0].revents & POLLIN) accept();
+}
@@ -0,0 +1,127 @@
+#ifndef WAVE_STREAM_H
+#define WAVE_STREAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Min/max envelope of one channel at a fixed number of samples per point:
+// what a trace of a given width in pixels needs, whatever the sample rate.
+// Shared by every client that asks for the same channel and decimation.
+class EnvelopeDecimator {
+public:
+    static const uint16_t MaxPoints = 512;  // Per frame
+
+    // Frame payload (little endian):
+    //   u8 version (1), u8 reserved, u16 channel, u32 samples per point,
+    //   u64 timestamp of the first sample (ns), f32 offset, f32 scale, u16 points,
+    //   then points x (i16 min, i16 max); value = offset + scale * q
+    static const uint8_t Version = 1;
+    static const size_t HeaderBytes = 26;
+
+    EnvelopeDecimator(uint16_t channel, uint32_t samplesPerPoint);
+
+    void add(uint64_t timestampNs, float value);
+
+    // Complete points waiting for the next frame
+    uint16_t getPending() const { return static_cast<uint16_t>(_min.size()); }
+    // Encode the pending points as one frame and start the next
+    void takeFrame(std::string& frame);
+
+    uint16_t getChannel() const { return _channel; }
+    uint32_t getSamplesPerPoint() const { return _samplesPerPoint; }
+
+private:
+    uint16_t _channel;
+    uint32_t _samplesPerPoint;
+    uint32_t _inPoint;          // Samples in the point being built
+    float _pointMin;
+    float _pointMax;
+    uint64_t _pointNs;
+    uint64_t _firstNs;          // Of the first pending point
+    std::vector<float> _min;
+    std::vector<float> _max;
+};
+
+// Live waveforms for browsers and tablets over WebSocket.
+//
+// A client opens ws://gateway:port/stream?channel=0&width=1024&seconds=5
+// and receives binary frames of min/max points (see EnvelopeDecimator),
+// about as many per window as it has pixels across. Decimations are rounded
+// to a power of two and shared: the server builds each (channel,
+// decimation) envelope once however many clients watch it, and encodes
+// each frame once for all of them. A point costs two compares per sample.
+//
+// Sockets are non-blocking. Each client has a bounded send backlog; a frame
+// that does not fit is dropped for that client only, so a slow tablet sees
+// a gap instead of the server buffering without limit or holding up the
+// others. GET / serves a small page that draws the trace.
+//
+// Single-threaded: feed() the samples and call poll() from the same loop.
+class WaveStreamServer {
+public:
+    static const size_t MaxBacklog = 256 * 1024;   // Bytes queued per client
+    static const uint32_t FrameIntervalMs = 40;    // 25 frames per second
+
+    WaveStreamServer();
+    ~WaveStreamServer();
+
+    bool listen(uint16_t port);
+    void close();
+
+    // Nominal sample rate of a channel, for the decimation (default 500 Hz)
+    void setChannelRate(uint16_t channel, uint32_t hz);
+
+    void feed(uint16_t channel, uint64_t timestampNs, float value);
+
+    // Accept, read and write what is ready, waiting at most timeoutMs, and
+    // send frames that are due
+    void poll(int timeoutMs);
+
+    size_t getClients() const;
+    size_t getDecimators() const { return _decimators.size(); }
+    uint64_t getFramesSent() const { return _framesSent; }
+    uint64_t getFramesDropped() const { return _framesDropped; }
+
+private:
+    struct Client {
+        int socket;
+        bool upgraded;              // WebSocket handshake done
+        bool closing;               // Close once the backlog is sent
+        std::string in;
+        std::string out;
+        size_t sent;                // Of out
+        int decimator;              // Index in _decimators, -1 = none
+        uint64_t dropped;
+    };
+
+    struct Decimator {
+        EnvelopeDecimator envelope;
+        uint32_t clients;
+    };
+
+    static std::string acceptKey(const std::string& key);
+    static void appendFrameHeader(std::string& out, uint8_t opcode, size_t length);
+
+    uint32_t rateOf(uint16_t channel) const;
+    int decimatorFor(uint16_t channel, uint32_t samplesPerPoint);
+    void release(Client& client);
+    void accept();
+    bool readFrom(Client& client);
+    bool handshake(Client& client);
+    bool handleFrames(Client& client);
+    bool writeTo(Client& client);
+    void queue(Client& client, const std::string& frame);
+    void sendDue();
+
+    int _listen;
+    std::vector<Client> _clients;
+    std::vector<Decimator> _decimators;
+    std::vector<std::pair<uint16_t, uint32_t>> _rates;
+    uint64_t _lastFrameMs;
+    uint64_t _framesSent;
+    uint64_t _framesDropped;
+};
+
+#endif // WAVE_STREAM_H
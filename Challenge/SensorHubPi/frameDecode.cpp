@@ -0,0 +1,82 @@
+#include "FrameDecoder.h"
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Usage:
+//   frameDecode [modules] [seconds]
+//
+// Decodes simulated ECG (500 frames/s), SpO2 and MCP3426 frames of the
+// given number of modules (default 16) for the given time (default 60 s)
+// as fast as it can, checks the result against a plain loop and prints
+// the throughput and how much faster than real time that is.
+
+struct Stream {
+    const char* name;
+    FrameDecoder decoder;
+    uint32_t rate;              // Frames per second per module
+    std::vector<uint8_t> frames;
+    std::vector<std::vector<float>> columns;
+};
+
+// Reference: the field by field formula, in double
+static size_t mismatches(const Stream& stream, size_t count) {
+    const FrameDecoder& decoder = stream.decoder;
+    size_t wrong = 0;
+    for (size_t f = 0; f < decoder.getFields(); f++) {
+        const FrameField& field = decoder.getField(f);
+        for (size_t i = 0; i < count; i++) {
+            const uint8_t* in = &stream.frames[i * decoder.getFrameBytes() + field.byteOffset];
+            const uint16_t raw = static_cast<uint16_t>(in[0] << 8 | in[1]);
+            const double value = field.isSigned ? static_cast<int16_t>(raw) : raw;
+            const double expected = field.offset + static_cast<double>(field.scale) * value;
+            if (std::fabs(stream.columns[f][i] - expected) > 1e-5 * (1.0 + std::fabs(expected))) wrong++;
+        }
+    }
+    return wrong;
+}
+
+int main(int argc, char* argv[]) {
+    const uint32_t modules = argc > 1 ? static_cast<uint32_t>(std::atoi(argv[1])) : 16;
+    const uint32_t seconds = argc > 2 ? static_cast<uint32_t>(std::atoi(argv[2])) : 60;
+
+    // ECG in mV around mid-scale of the 12-bit ADC, MCP3426 in mV (62.5 uV per LSB)
+    std::vector<Stream> streams;
+    streams.push_back({"ECG", FrameDecoder::ecg(3300.0f / 4096.0f, -1650.0f), 500, {}, {}});
+    streams.push_back({"SpO2", FrameDecoder::spo2Raw(), 100, {}, {}});
+    streams.push_back({"MCP3426", FrameDecoder::mcp3426(0.0625f), 10, {}, {}});
+
+    std::mt19937 random(1);
+    uint64_t totalFrames = 0;
+    for (Stream& stream : streams) {
+        const size_t count = static_cast<size_t>(stream.rate) * modules * seconds;
+        stream.frames.resize(count * stream.decoder.getFrameBytes());
+        for (uint8_t& byte : stream.frames) byte = static_cast<uint8_t>(random());
+        stream.columns.assign(stream.decoder.getFields(), std::vector<float>(count));
+        totalFrames += count;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    for (Stream& stream : streams) {
+        std::vector<float*> columns;
+        for (std::vector<float>& column : stream.columns) columns.push_back(column.data());
+        stream.decoder.decode(stream.frames.data(), stream.columns[0].size(), columns.data());
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    size_t wrong = 0;
+    for (const Stream& stream : streams) wrong += mismatches(stream, stream.columns[0].size());
+
+    std::cout << totalFrames << " frames of " << modules << " modules (" << seconds << " s) in "
+              << elapsed.count() * 1000 << " ms, " << totalFrames / elapsed.count() / 1e6 << " M frames/s, "
+              << seconds / elapsed.count() << "x real time (" << (FrameDecoder::hasSimd() ? "SIMD" : "scalar")
+              << ")" << std::endl;
+    if (wrong != 0) {
+        std::cerr << wrong << " values differ from the reference" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,194 @@
+#include "FrameDecoder.h"
+#include "Pipeline.h"
+#include "SampleRecorder.h"
+#include "VitalBus.h"
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory_resource>
+#include <thread>
+#include <unistd.h>
+
+// Usage:
+//   pipeline [boxes] [seconds] [batch] [fast] [directory]
+//
+// Simulated ECG modules of the given number of boxes (default 8) through
+// acquire -> decode -> analyse -> record, one thread per stage pinned to
+// cores 0..3, for the given time (default 10 s, 0 = until Ctrl-C). batch is
+// the batch size of every stage (default 64). "fast" produces bursts as
+// fast as the pipeline takes them instead of at 500 frames/s per box: the
+// number of boxes one gateway keeps up with. With a directory the record
+// stage writes to a SampleRecorder there, channel 4 * box.
+//
+// Once a second it prints per stage: items/s, busy %, batch latency p50 /
+// p99 / max, input queue depth / highest / capacity, how often the stage
+// before it found the queue full, and the batch arena: most bytes used by
+// one batch and heap calls (0 once it has grown).
+
+static const uint32_t FramesPerBurst = 8;
+static const uint32_t SampleRate = 500;
+
+// One ECG burst as it comes off the hub: frames of NUM_SENSOR_BYTES
+struct EcgBurst {
+    uint64_t timestampNs;       // First frame
+    uint16_t box;
+    uint8_t frames[FramesPerBurst * 6];
+};
+
+static volatile sig_atomic_t stopRequested = 0;
+
+static void onSignal(int) {
+    stopRequested = 1;
+}
+
+// ADC counts of LL, LA and RA at sample n: a beat every 0.8 s on a baseline
+static void simulate(uint8_t* frame, uint64_t n, uint16_t box) {
+    const double t = static_cast<double>(n % (SampleRate * 4 / 5)) / SampleRate;
+    const double r = 700.0 * std::exp(-std::pow((t - 0.2) / 0.012, 2));
+    const uint16_t leads[3] = {static_cast<uint16_t>(2048 + r), static_cast<uint16_t>(2048 + r / 2),
+                               static_cast<uint16_t>(2048 - r / 4 + box % 7)};
+    for (int i = 0; i < 3; i++) {
+        frame[2 * i] = static_cast<uint8_t>(leads[i] >> 8);
+        frame[2 * i + 1] = static_cast<uint8_t>(leads[i] & 0xFF);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    const uint32_t boxes = argc > 1 ? static_cast<uint32_t>(std::atoi(argv[1])) : 8;
+    const uint32_t seconds = argc > 2 ? static_cast<uint32_t>(std::atoi(argv[2])) : 10;
+    const uint32_t batch = argc > 3 ? static_cast<uint32_t>(std::atoi(argv[3])) : 64;
+    const bool fast = argc > 4 && std::strcmp(argv[4], "fast") == 0;
+    const char* directory = argc > 5 ? argv[5] : nullptr;
+    if (boxes == 0) return 1;
+
+    SampleRecorder recorder;
+    if (directory != nullptr && !recorder.open(directory)) {
+        std::cerr << "Cannot open " << directory << std::endl;
+        return 1;
+    }
+
+    SpscRing<EcgBurst> raw(1024);
+    SpscRing<VitalSample> decoded(16384);
+    SpscRing<VitalSample> analysed(16384);
+    const unsigned cores = std::thread::hardware_concurrency();
+    auto core = [cores](int stage) { return cores > 1 ? static_cast<int>(stage % cores) : -1; };
+
+    Pipeline pipeline;
+
+    // Acquire: the bursts of every box, due every 16 ms (or at once when fast)
+    const auto start = std::chrono::steady_clock::now();
+    uint64_t next = 0;  // Frame number of the next burst of every box
+    pipeline.addSource("acquire", core(0), [&]() {
+        const uint64_t elapsedNs = static_cast<uint64_t>((std::chrono::steady_clock::now() - start).count());
+        if (!fast && next * 1000000000ull / SampleRate > elapsedNs) return 0u;
+        for (uint16_t box = 0; box < boxes; box++) {
+            EcgBurst burst;
+            burst.timestampNs = next * 1000000000ull / SampleRate;
+            burst.box = box;
+            for (uint32_t i = 0; i < FramesPerBurst; i++) simulate(burst.frames + 6 * i, next + i, box);
+            raw.push(burst);
+        }
+        next += FramesPerBurst;
+        return boxes;
+    });
+
+    // Decode: raw frames to mV, lead II = LL - RA. The frames of the whole
+    // batch are decoded in one call, in buffers from the batch arena.
+    const FrameDecoder decoder = FrameDecoder::ecg(3300.0f / 4096.0f, 0.0f);
+    pipeline.addStage<EcgBurst>("decode", core(1), raw, batch, [&](const EcgBurst* bursts, uint32_t count) {
+        std::pmr::memory_resource* memory = Pipeline::batchResource();
+        const size_t frames = static_cast<size_t>(count) * FramesPerBurst;
+        std::pmr::vector<uint8_t> bytes(frames * sizeof(bursts[0].frames) / FramesPerBurst, memory);
+        std::pmr::vector<float> ll(frames, memory), la(frames, memory), ra(frames, memory);
+        for (uint32_t b = 0; b < count; b++) {
+            std::memcpy(bytes.data() + b * sizeof(bursts[0].frames), bursts[b].frames, sizeof(bursts[0].frames));
+        }
+        float* columns[3] = {ll.data(), la.data(), ra.data()};
+        decoder.decode(bytes.data(), frames, columns);
+
+        for (uint32_t b = 0; b < count; b++) {
+            for (uint32_t i = 0; i < FramesPerBurst; i++) {
+                const size_t frame = static_cast<size_t>(b) * FramesPerBurst + i;
+                VitalSample sample;
+                sample.timestampNs = bursts[b].timestampNs + i * 1000000000ull / SampleRate;
+                sample.channel = static_cast<uint16_t>(4 * bursts[b].box + static_cast<uint16_t>(Channel::Ecg));
+                sample.flags = 0;
+                sample.value = ll[frame] - ra[frame];
+                decoded.push(sample);
+            }
+        }
+    });
+
+    // Analyse: R peaks by threshold on the slope, a rate alarm per box
+    struct Beat {
+        float previous;
+        uint64_t lastPeakNs;
+        uint32_t beats;
+        uint32_t alarms;
+    };
+    std::vector<Beat> beats(boxes, Beat{0, 0, 0, 0});
+    pipeline.addStage<VitalSample>("analyse", core(2), decoded, batch, [&](const VitalSample* samples, uint32_t count) {
+        for (uint32_t i = 0; i < count; i++) {
+            VitalSample sample = samples[i];
+            Beat& beat = beats[sample.channel / 4];
+            if (sample.value - beat.previous > 40.0f && sample.timestampNs - beat.lastPeakNs > 250000000ull) {
+                const uint64_t rrNs = sample.timestampNs - beat.lastPeakNs;
+                if (beat.beats > 0 && (rrNs > 1500000000ull || rrNs < 333000000ull)) {
+                    beat.alarms++;  // Below 40 or above 180 bpm
+                    sample.flags = 1;
+                }
+                beat.lastPeakNs = sample.timestampNs;
+                beat.beats++;
+            }
+            beat.previous = sample.value;
+            analysed.push(sample);
+        }
+    });
+
+    // Record
+    uint64_t recorded = 0;
+    pipeline.addStage<VitalSample>("record", core(3), analysed, batch, [&](const VitalSample* samples, uint32_t count) {
+        if (directory != nullptr) {
+            for (uint32_t i = 0; i < count; i++) {
+                recorder.append(samples[i].timestampNs, samples[i].channel, samples[i].value, samples[i].flags);
+            }
+        }
+        recorded += count;
+    });
+
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+    pipeline.start();
+    for (uint32_t second = 0; !stopRequested && (seconds == 0 || second < seconds); second++) {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        std::printf("%u s\n", second + 1);
+        for (const StageMetrics& m : pipeline.metrics()) {
+            std::printf("  %-8s core %2d%s %9llu items/s %5.1f %% busy  batch %6llu / %7llu / %8llu ns",
+                        m.name.c_str(), m.core, m.pinned ? " " : "*", static_cast<unsigned long long>(m.items),
+                        m.busyNs / 1e7, static_cast<unsigned long long>(m.latencyP50Ns),
+                        static_cast<unsigned long long>(m.latencyP99Ns), static_cast<unsigned long long>(m.latencyMaxNs));
+            if (m.queueCapacity != 0) {
+                std::printf("  queue %5u / %5u / %5u  full %llu", m.queueDepth, m.queueMax, m.queueCapacity,
+                            static_cast<unsigned long long>(m.fullWaits));
+            }
+            if (m.arenaHighWater != 0) {
+                std::printf("  arena %zu B, heap %llu", m.arenaHighWater, static_cast<unsigned long long>(m.arenaHeapCalls));
+            }
+            std::printf("\n");
+        }
+    }
+    pipeline.stop();
+
+    uint32_t totalBeats = 0, totalAlarms = 0;
+    for (const Beat& beat : beats) {
+        totalBeats += beat.beats;
+        totalAlarms += beat.alarms;
+    }
+    std::cout << recorded << " samples of " << boxes << " boxes recorded (" << next * boxes << " produced), "
+              << totalBeats << " beats, " << totalAlarms << " rate alarms" << std::endl;
+    return 0;
+}
@@ -0,0 +1,264 @@
+#include "MqttTransport.h"
+#include "SampleArchive.h"
+#include "SampleExporter.h"
+#include "SampleRecorder.h"
+#include "SampleRollup.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Usage:
+//   recorder record <dir> [seconds] [broker[:port]]  simulated ECG 500 Hz, SpO2 100 Hz, pulse and temperature 1 Hz
+//   recorder query <dir> <from_s> <to_s> [channel]   seconds back from now, as CSV
+//   recorder rollup <dir> <from_s> <to_s> <channel> [points]   min/max/mean, about points rows
+//   recorder segments <dir> [channel]                 the ring read in place, per segment
+//
+// The SensorHub I2C reader calls SampleRecorder::append() the same way as
+// the simulation below does. ECG goes to the record ring; the slow channels
+// go to the compressed SampleArchive in the same directory. Every sample
+// also updates the SampleRollup levels that dashboards read and, with a
+// broker, goes upstream through the SampleExporter.
+
+static volatile sig_atomic_t stopRequested = 0;
+
+static void onSignal(int) {
+    stopRequested = 1;
+}
+
+static uint64_t nowNs() {
+    timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    return static_cast<uint64_t>(now.tv_sec) * 1000000000ull + static_cast<uint64_t>(now.tv_nsec);
+}
+
+static bool isArchived(int channel) {
+    return channel == static_cast<int>(Channel::SpO2) || channel == static_cast<int>(Channel::PulseRate) ||
+           channel == static_cast<int>(Channel::Temperature);
+}
+
+// Samples of [fromNs, toNs] from whichever store holds the channel
+static uint64_t readBack(const std::string& directory, uint64_t fromNs, uint64_t toNs, int channel,
+                         const SampleRecorder::Visitor& visit) {
+    if (isArchived(channel)) {
+        SampleArchive archive;
+        return archive.openReadOnly(directory) ? archive.query(fromNs, toNs, visit, channel) : 0;
+    }
+    SampleRecorder recorder;
+    return recorder.openReadOnly(directory) ? recorder.query(fromNs, toNs, visit, channel) : 0;
+}
+
+static int record(const char* directory, double seconds, const char* broker) {
+    SampleRecorder recorder;
+    if (!recorder.open(directory)) {
+        std::cerr << "Cannot open recording in " << directory << std::endl;
+        return 1;
+    }
+    if (recorder.getRecovered() > 0) {
+        std::cout << "Continuing, recovered " << recorder.getRecovered() << " records of the open segment" << std::endl;
+    }
+    // Only ECG goes to the ring; the slow channels are in the archive
+    if (!recorder.writeLayout({{static_cast<uint16_t>(Channel::Ecg), "ecg", "mV", 500.0}})) {
+        std::cerr << "Cannot write layout.json in " << directory << std::endl;
+    }
+    SampleArchive archive;
+    if (!archive.open(directory)) {
+        std::cerr << "Cannot open archive in " << directory << std::endl;
+        return 1;
+    }
+    SampleRollup rollup;
+    if (!rollup.open(directory)) {
+        std::cerr << "Cannot open rollups in " << directory << std::endl;
+        return 1;
+    }
+
+    // Upstream export: spooled next to the recording, refused samples read back from it
+    std::unique_ptr<MqttTransport> transport;
+    std::unique_ptr<SampleExporter> exporter;
+    if (broker != nullptr) {
+        std::string host = broker;
+        uint16_t port = 1883;
+        const size_t colon = host.rfind(':');
+        if (colon != std::string::npos) {
+            port = static_cast<uint16_t>(std::atoi(host.c_str() + colon + 1));
+            host.resize(colon);
+        }
+        transport.reset(new MqttTransport(host, port, "sensorhub-recorder"));
+        SampleExporter::Config config;
+        config.spoolDirectory = std::string(directory) + "/spool";
+        exporter.reset(new SampleExporter(*transport, config));
+        const std::string source = directory;
+        exporter->setBackfill([source](uint64_t fromNs, uint64_t toNs, int channel, const SampleRecorder::Visitor& visit) {
+            return readBack(source, fromNs, toNs, channel, visit);
+        });
+        exporter->start();
+    }
+
+    const auto store = [&](uint64_t t, Channel channel, float value) {
+        const uint16_t number = static_cast<uint16_t>(channel);
+        if (isArchived(number)) {
+            archive.append(t, number, value);
+        } else {
+            recorder.append(t, number, value);
+        }
+        rollup.add(t, number, value);
+        if (exporter) exporter->add(t, number, value);
+    };
+
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    // 2 ms tick: ECG every tick, SpO2 every 5th, pulse and temperature every 500th
+    const auto tick = std::chrono::milliseconds(2);
+    const clock_t cpuStart = clock();
+    auto next = std::chrono::steady_clock::now();
+    uint64_t ticks = 0;
+    uint64_t samples = 0;
+    while (!stopRequested && (seconds <= 0 || ticks * 0.002 < seconds)) {
+        const uint64_t t = nowNs();
+        const double phase = std::fmod(ticks * 0.002, 0.8) / 0.8;  // 75 bpm
+        const float ecg = static_cast<float>(std::exp(-std::pow((phase - 0.3) * 40.0, 2.0)) + 0.05 * std::sin(ticks * 0.01));
+        store(t, Channel::Ecg, ecg);
+        samples++;
+        if (ticks % 5 == 0) {
+            store(t, Channel::SpO2, 97.0f + 0.5f * static_cast<float>(std::sin(ticks * 1e-4)));
+            samples++;
+        }
+        if (ticks % 500 == 0) {
+            store(t, Channel::PulseRate, 75.0f);
+            store(t, Channel::Temperature, 36.8f);
+            samples += 2;
+        }
+        ticks++;
+        next += tick;
+        std::this_thread::sleep_until(next);
+    }
+
+    archive.flush();
+    rollup.flush();
+    if (exporter) {
+        exporter->stop();
+        std::cout << "Exported " << exporter->getSamplesSent() << " samples in " << exporter->getFramesSent()
+                  << " frames (" << exporter->getBackfilled() << " read back after backpressure), "
+                  << exporter->getSpooled() << " frames spooled" << std::endl;
+    }
+    const double cpu = static_cast<double>(clock() - cpuStart) / CLOCKS_PER_SEC;
+    std::cout << "Recorded " << samples << " samples, " << recorder.getRecords() << " in the ring, "
+              << archive.getSamples() << " in the archive (" << archive.getBlocksUsed() * SampleArchive::BlockSize
+              << " bytes), " << recorder.getSyncs() + archive.getSyncs() << " syncs, " << cpu << " s CPU" << std::endl;
+    return 0;
+}
+
+static int query(const char* directory, double fromS, double toS, int channel) {
+    SampleRecorder recorder;
+    SampleArchive archive;
+    const bool haveRecording = recorder.openReadOnly(directory);
+    const bool haveArchive = archive.openReadOnly(directory);
+    if (!haveRecording && !haveArchive) {
+        std::cerr << "No recording in " << directory << std::endl;
+        return 1;
+    }
+
+    const uint64_t now = nowNs();
+    const uint64_t from = now - static_cast<uint64_t>(fromS * 1e9);
+    const uint64_t to = now - static_cast<uint64_t>(toS * 1e9);
+    std::vector<SampleRecord> records;
+    const auto collect = [&records](const SampleRecord& r) { records.push_back(r); };
+    if (haveRecording && (channel < 0 || !isArchived(channel))) recorder.query(from, to, collect, channel);
+    if (haveArchive && (channel < 0 || isArchived(channel))) archive.query(from, to, collect, channel);
+    std::stable_sort(records.begin(), records.end(), [](const SampleRecord& a, const SampleRecord& b) {
+        return a.timestampNs < b.timestampNs;
+    });
+
+    std::cout << "timestamp_ns,channel,value" << std::endl;
+    for (const SampleRecord& r : records) {
+        std::cout << r.timestampNs << ',' << r.channel << ',' << r.value << '\n';
+    }
+    std::cerr << records.size() << " records" << std::endl;
+    return 0;
+}
+
+static int rollupQuery(const char* directory, double fromS, double toS, int channel, int points) {
+    SampleRollup rollup;
+    if (!rollup.openReadOnly(directory)) {
+        std::cerr << "No rollups in " << directory << std::endl;
+        return 1;
+    }
+
+    const uint64_t now = nowNs();
+    const uint64_t from = now - static_cast<uint64_t>(fromS * 1e9);
+    const uint64_t to = now - static_cast<uint64_t>(toS * 1e9);
+    const uint64_t resolution = (to - from) / static_cast<uint64_t>(points > 0 ? points : 1);
+    const auto start = std::chrono::steady_clock::now();
+    std::cout << "start_ns,channel,count,min,max,mean" << std::endl;
+    const uint64_t found = rollup.query(static_cast<uint16_t>(channel), from, to, resolution, [](const RollupBucket& b) {
+        std::cout << b.startNs << ',' << b.channel << ',' << b.count << ',' << b.min << ',' << b.max << ',' << b.mean
+                  << '\n';
+    });
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cerr << found << " buckets of " << SampleRollup::getWidthNs(rollup.levelFor(from, resolution)) / 1000000000ull
+              << " s, " << ms << " ms" << std::endl;
+    return 0;
+}
+
+// What an analysis process does: map the ring and read the records where
+// they are, without copying or parsing them
+static int segments(const char* directory, int channel) {
+    SampleRecorder recorder;
+    if (!recorder.openReadOnly(directory)) {
+        std::cerr << "No recording in " << directory << std::endl;
+        return 1;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    uint64_t total = 0;
+    uint64_t overwritten = 0;
+    std::cout << "generation,records,first_ns,last_ns,mean" << std::endl;
+    for (const SampleRecorder::SegmentView& view : recorder.segments()) {
+        double sum = 0.0;
+        uint32_t used = 0;
+        for (uint32_t i = 0; i < view.count; i++) {
+            if (!view.isCurrent(i)) {
+                overwritten += view.count - i;
+                break;
+            }
+            if (channel >= 0 && view.records[i].channel != channel) continue;
+            sum += view.records[i].value;
+            used++;
+        }
+        std::cout << view.generation << ',' << used << ',' << view.firstNs << ',' << view.lastNs << ','
+                  << (used > 0 ? sum / used : 0.0) << '\n';
+        total += used;
+    }
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cerr << total << " records in place, " << overwritten << " overwritten while reading, " << ms << " ms"
+              << std::endl;
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc >= 3 && std::strcmp(argv[1], "record") == 0) {
+        return record(argv[2], argc > 3 ? std::atof(argv[3]) : 0.0, argc > 4 ? argv[4] : nullptr);
+    }
+    if (argc >= 5 && std::strcmp(argv[1], "query") == 0) {
+        return query(argv[2], std::atof(argv[3]), std::atof(argv[4]), argc > 5 ? std::atoi(argv[5]) : -1);
+    }
+    if (argc >= 6 && std::strcmp(argv[1], "rollup") == 0) {
+        return rollupQuery(argv[2], std::atof(argv[3]), std::atof(argv[4]), std::atoi(argv[5]),
+                           argc > 6 ? std::atoi(argv[6]) : 500);
+    }
+    if (argc >= 3 && std::strcmp(argv[1], "segments") == 0) {
+        return segments(argv[2], argc > 3 ? std::atoi(argv[3]) : -1);
+    }
+    std::cerr << "Usage: recorder record <dir> [seconds] [broker[:port]] | query <dir> <from_s_ago> <to_s_ago> [channel]"
+              << " | rollup <dir> <from_s_ago> <to_s_ago> <channel> [points] | segments <dir> [channel]" << std::endl;
+    return 1;
+}
@@ -0,0 +1,159 @@
+#include "SampleRecorder.h"
+#include "VitalBus.h"
+#include <atomic>
+#include <csignal>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+// Usage:
+//   vitalsBus                    in-process: one producer, four consumers, throughput
+//   vitalsBus publish            producer on the shared memory bus "/vitals_bus"
+//   vitalsBus subscribe          consumer in another process
+
+static volatile sig_atomic_t stopRequested = 0;
+
+static void onSignal(int) {
+    stopRequested = 1;
+}
+
+// Every consumer checks that it sees all samples, in order
+struct SequenceCheck {
+    uint64_t expected = 0;
+    uint64_t errors = 0;
+    uint64_t seen = 0;
+
+    void operator()(const VitalSample* items, uint32_t count, uint64_t) {
+        for (uint32_t i = 0; i < count; i++) {
+            if (items[i].timestampNs != expected) errors++;
+            expected = items[i].timestampNs + 1;
+        }
+        seen += count;
+    }
+};
+
+static int inProcess() {
+    const uint64_t total = 20000000;
+    VitalBus bus;
+    std::atomic<bool> done(false);
+    std::atomic<int> ready(0);
+
+    SampleRecorder recorder;
+    const bool recording = recorder.open("/tmp/vitalsBus", 4, 1 << 20);
+
+    std::vector<std::thread> consumers;
+    std::vector<SequenceCheck> checks(4);
+    for (int c = 0; c < 4; c++) {
+        consumers.emplace_back([&, c]() {
+            VitalBus::Subscriber subscriber(bus);
+            ready++;
+            float alarmLevel = 0;
+            for (;;) {
+                const uint32_t n = subscriber.poll([&](const VitalSample* items, uint32_t count, uint64_t first) {
+                    checks[c](items, count, first);
+                    if (c == 0 && recording) {
+                        // Recorder: persists every sample
+                        for (uint32_t i = 0; i < count; i++) {
+                            recorder.append(items[i].timestampNs, items[i].channel, items[i].value, items[i].flags);
+                        }
+                    } else if (c == 1) {
+                        // Alarm logic: looks at every value
+                        for (uint32_t i = 0; i < count; i++) {
+                            if (items[i].value > alarmLevel) alarmLevel = items[i].value;
+                        }
+                    }
+                });
+                if (n == 0) {
+                    if (done.load() && subscriber.getPosition() == bus.getPublished()) break;
+                    subscriber.wait(1000);
+                }
+            }
+        });
+    }
+    while (ready.load() < 4) std::this_thread::yield();
+
+    const auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < total; i++) {
+        VitalSample& sample = bus.next();
+        sample.timestampNs = i;
+        sample.channel = static_cast<uint16_t>(i % 4);
+        sample.flags = 0;
+        sample.value = static_cast<float>(i % 1000);
+        if ((i & 31) == 31) bus.publish();  // Batches of 32
+    }
+    bus.publish();
+    done = true;
+    for (std::thread& t : consumers) t.join();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::cout << total << " samples to 4 consumers in " << elapsed.count() << " s ("
+              << total / elapsed.count() / 1e6 << " M/s)" << std::endl;
+    for (int c = 0; c < 4; c++) {
+        std::cout << "  consumer " << c << ": " << checks[c].seen << " samples, " << checks[c].errors
+                  << " out of order" << std::endl;
+    }
+    return 0;
+}
+
+static int publish() {
+    SharedVitalBus bus;
+    if (!bus.create(BUS_NAME)) {
+        std::cerr << "Failed to create shared memory bus." << std::endl;
+        return 1;
+    }
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    // ECG at 500 Hz, published per 10 ms
+    uint64_t sequence = 0;
+    auto next = std::chrono::steady_clock::now();
+    while (!stopRequested) {
+        for (int i = 0; i < 5; i++) {
+            VitalSample& sample = bus.next();
+            sample.timestampNs = sequence++;
+            sample.channel = static_cast<uint16_t>(Channel::Ecg);
+            sample.flags = 0;
+            sample.value = static_cast<float>(sequence % 400) / 400.0f;
+        }
+        bus.publish();
+        next += std::chrono::milliseconds(10);
+        std::this_thread::sleep_until(next);
+    }
+    std::cout << "Published " << bus.getPublished() << ", evicted " << bus.getEvictions() << " consumers" << std::endl;
+    return 0;
+}
+
+static int subscribe() {
+    SharedVitalBus bus;
+    if (!bus.attach(BUS_NAME)) {
+        std::cerr << "Shared memory bus not found." << std::endl;
+        return 1;
+    }
+    SharedVitalBus::Subscriber subscriber(bus);
+    if (!subscriber.isSubscribed()) {
+        std::cerr << "No free consumer cursor." << std::endl;
+        return 1;
+    }
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    SequenceCheck check;
+    check.expected = subscriber.getPosition();
+    auto report = std::chrono::steady_clock::now();
+    while (!stopRequested && !subscriber.isEvicted()) {
+        if (subscriber.wait(100000)) subscriber.poll(check);
+        if (std::chrono::steady_clock::now() - report >= std::chrono::seconds(1)) {
+            std::cout << check.seen << " samples, " << check.errors << " out of order" << std::endl;
+            report = std::chrono::steady_clock::now();
+        }
+    }
+    if (subscriber.isEvicted()) std::cerr << "Evicted by the producer." << std::endl;
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::strcmp(argv[1], "publish") == 0) return publish();
+    if (argc > 1 && std::strcmp(argv[1], "subscribe") == 0) return subscribe();
+    return inProcess();
+}
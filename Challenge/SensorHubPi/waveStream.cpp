@@ -0,0 +1,61 @@
+#include "SampleRecorder.h"
+#include "VitalBus.h"
+#include "WaveStream.h"
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+
+// Usage:
+//   waveStream [port]       live traces of the shared memory bus "/vitals_bus"
+//
+// Open http://gateway:8080/?channel=0&seconds=5 on a tablet, or stream
+// ws://gateway:8080/stream?channel=0&width=1024&seconds=5 into an own viewer.
+// One bus consumer serves every client.
+
+static volatile sig_atomic_t stopRequested = 0;
+
+static void onSignal(int) {
+    stopRequested = 1;
+}
+
+int main(int argc, char* argv[]) {
+    const uint16_t port = static_cast<uint16_t>(argc > 1 ? std::atoi(argv[1]) : 8080);
+    SharedVitalBus bus;
+    if (!bus.attach(BUS_NAME)) {
+        std::cerr << "Shared memory bus not found." << std::endl;
+        return 1;
+    }
+    WaveStreamServer server;
+    if (!server.listen(port)) {
+        std::cerr << "Cannot listen on port " << port << std::endl;
+        return 1;
+    }
+    server.setChannelRate(static_cast<uint16_t>(Channel::Ecg), 500);
+    server.setChannelRate(static_cast<uint16_t>(Channel::SpO2), 100);
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    std::unique_ptr<SharedVitalBus::Subscriber> subscriber(new SharedVitalBus::Subscriber(bus));
+    auto report = std::chrono::steady_clock::now();
+    while (!stopRequested) {
+        if (!subscriber->isSubscribed() || subscriber->isEvicted()) {
+            // Evicted for stalling the producer: continue from what is published now
+            subscriber.reset();
+            subscriber.reset(new SharedVitalBus::Subscriber(bus));
+        }
+        subscriber->poll([&server](const VitalSample* items, uint32_t count, uint64_t) {
+            for (uint32_t i = 0; i < count; i++) server.feed(items[i].channel, items[i].timestampNs, items[i].value);
+        });
+        server.poll(5);
+
+        if (std::chrono::steady_clock::now() - report >= std::chrono::seconds(10)) {
+            std::cout << server.getClients() << " clients, " << server.getDecimators() << " envelopes, "
+                      << server.getFramesSent() << " frames sent, " << server.getFramesDropped() << " dropped"
+                      << std::endl;
+            report = std::chrono::steady_clock::now();
+        }
+    }
+    return 0;
+}
@@ -4,12 +4,16 @@
  * Compatible with 8-bit 16MHz Arduino boards
  * 
  * v1.1 - Added proper deceleration for direction changes
+ * v1.2 - Ramps planned by MotionPlanner (SimpleStepper library): the
+ *        deceleration ends exactly at the target
  * Aug 2025
  * Embedded Programming (Prog 5/6)
  * johan.korten@han.nl
  * MIC2 Style
  */
 
+#include <MotionPlanner.h>
+
 // --- Pin definitions ---
 const uint8_t STEP_PIN = 7;  // TB6600 PUL
 const uint8_t DIR_PIN = 6;   // TB6600 DIR  
@@ -23,21 +27,19 @@ const long STEPS_PER_REV = (long)FULL_STEPS_PER_REV * MICROSTEPS;  // Now 1600 s
 // --- Speed control ---
 const float TARGET_RPM = 300.0;  // Increased from 120 to 300 RPM
 const float ACCEL_RPM_S = 600.0;  // Increased acceleration
+const float ACCEL_SPS2 = (ACCEL_RPM_S / 60.0f) * (float)STEPS_PER_REV;  // steps/s^2
 
 // Timing calculations
 const float TARGET_SPS = (TARGET_RPM / 60.0f) * (float)STEPS_PER_REV;
 const unsigned long TARGET_STEP_INTERVAL = 1000000UL / (unsigned long)TARGET_SPS; // microseconds
-const unsigned long ACCEL_STEP_SIZE = 25; // Reduced from 50 - smoother acceleration at higher speeds
-const uint8_t DECEL_MULTIPLIER = 5;
 
-// --- NEW: Deceleration parameters ---
-const long DECEL_DISTANCE = 400;  // Increased from 200 - need more distance at higher speeds
-const unsigned long MIN_STEP_INTERVAL = TARGET_STEP_INTERVAL * 15; // Reduced multiplier for faster direction changes
+// --- Motion planner: precomputed ramps, cheap per step ---
+MotionPlanner planner;
 
 // --- Motion state variables ---
 volatile long currentPosition = 0;
 volatile long targetPosition = STEPS_PER_REV;
-volatile unsigned long currentStepInterval = TARGET_STEP_INTERVAL * 10; // start slow
+volatile unsigned long currentStepInterval = TARGET_STEP_INTERVAL * 10; // set by the planner
 
 // --- NEW: Motion state tracking ---
 typedef enum {
@@ -86,11 +88,9 @@ void setDirectionReverse(void);
 void waitForDirectionSetup(void);
 
 // Speed/acceleration control
+void initializePlanner(void);
+void planMoveToTarget(void);
 void handleAcceleration(void);
-void accelerateMotor(void);
-boolean canAccelerate(void);
-void resetSpeedForDirectionChange(void);
-void decelerateMotor(void); // NEW
 
 // Timing utilities
 unsigned long getCurrentTime(void);
@@ -138,9 +138,10 @@ void enableDriverOutput(void) {
 void initializeMotionParameters(void) {
   currentPosition = 0;
   targetPosition = STEPS_PER_REV;
-  currentStepInterval = TARGET_STEP_INTERVAL * 10;
   motionState = ACCELERATING;
   updateDirection();
+  initializePlanner();
+  planMoveToTarget();
 }
 
 // === MAIN MOTION CONTROL ===
@@ -173,47 +174,45 @@ void executeStepSequence(unsigned long currentTime, unsigned long *lastStepTime)
 void handleTargetReached(void) {
   debugPosition();
   
-  // Only change direction if we're moving slowly enough
-  if (currentStepInterval >= MIN_STEP_INTERVAL) {
-    reverseDirection();
-    motionState = DIRECTION_CHANGE;
-    updateDirection();
-    
-    // Add a small pause to ensure complete stop
-    delay(5); // Reduced from 10ms
-    
-    // Reset to acceleration phase for new direction
-    motionState = ACCELERATING;
-    currentStepInterval = MIN_STEP_INTERVAL; // Start from slow speed
-    Serial.println("Direction changed - starting acceleration");
-  }
+  // The planned ramp ends at standstill on the target
+  reverseDirection();
+  motionState = DIRECTION_CHANGE;
+  updateDirection();
+  
+  // Add a small pause to ensure complete stop
+  delay(5); // Reduced from 10ms
+  
+  // Reset to acceleration phase for new direction
+  motionState = ACCELERATING;
+  planMoveToTarget();
+  Serial.println("Direction changed - starting acceleration");
 }
 
 // === NEW: MOTION STATE MANAGEMENT ===
 
 void updateMotionState(void) {
-  long stepsToTarget = abs(targetPosition - currentPosition);
+  MotionPhase phase = planner.getPhase();
   
   switch(motionState) {
     case ACCELERATING:
-      if (currentStepInterval <= TARGET_STEP_INTERVAL) {
+      if (phase == MotionPhase::CRUISING) {
         motionState = CONSTANT_SPEED;
         Serial.println("Entering constant speed");
-      } else if (stepsToTarget <= DECEL_DISTANCE) {
+      } else if (phase == MotionPhase::DECELERATING) {
         motionState = DECELERATING;
         Serial.println("Starting deceleration");
       }
       break;
       
     case CONSTANT_SPEED:
-      if (stepsToTarget <= DECEL_DISTANCE) {
+      if (phase == MotionPhase::DECELERATING) {
         motionState = DECELERATING;
         Serial.println("Starting deceleration");
       }
       break;
       
     case DECELERATING:
-      // Continue decelerating until very slow
+      // Continue decelerating until the target
       break;
       
     case DIRECTION_CHANGE:
@@ -294,53 +293,26 @@ void waitForDirectionSetup(void) {
 
 // === SPEED/ACCELERATION CONTROL ===
 
-void handleAcceleration(void) {
-  switch(motionState) {
-    case ACCELERATING:
-      if (canAccelerate()) {
-        accelerateMotor();
-      }
-      break;
-      
-    case CONSTANT_SPEED:
-      // Maintain current speed
-      break;
-      
-    case DECELERATING:
-      decelerateMotor();
-      break;
-      
-    case DIRECTION_CHANGE:
-      // Very slow speed for direction change
-      currentStepInterval = MIN_STEP_INTERVAL;
-      break;
-  }
-}
-
-boolean canAccelerate(void) {
-  return (currentStepInterval > TARGET_STEP_INTERVAL);
+void initializePlanner(void) {
+  MotionLimits limits;
+  limits.maxSpeed = (uint32_t)TARGET_SPS;
+  limits.acceleration = (uint32_t)ACCEL_SPS2;
+  planner.setLimits(limits);
 }
 
-void accelerateMotor(void) {
-  currentStepInterval -= ACCEL_STEP_SIZE;
-  if (currentStepInterval < TARGET_STEP_INTERVAL) {
-    currentStepInterval = TARGET_STEP_INTERVAL;
-  }
+void planMoveToTarget(void) {
+  planner.plan(abs(targetPosition - currentPosition));
+  currentStepInterval = planner.nextInterval();  // Interval before the first step
 }
 
-// NEW: Deceleration function
-void decelerateMotor(void) {
-  currentStepInterval += ACCEL_STEP_SIZE;  // Increase interval = slower speed
-  if (currentStepInterval > MIN_STEP_INTERVAL) {
-    currentStepInterval = MIN_STEP_INTERVAL;
+// Accelerating, cruising and decelerating all follow the plan
+void handleAcceleration(void) {
+  unsigned long next = planner.nextInterval();
+  if (next > 0) {
+    currentStepInterval = next;
   }
 }
 
-void resetSpeedForDirectionChange(void) {
-  currentStepInterval = MIN_STEP_INTERVAL;  // Start very slow
-  motionState = ACCELERATING;
-}
-
 // === TIMING UTILITIES ===
 
 unsigned long getCurrentTime(void) {
@@ -0,0 +1,55 @@
+/*
+  AsyncMotion.ino
+  
+  Non-blocking example for SimpleStepper library v2.1
+  Two motors turn at the same time from the Timer1 interrupt while
+  loop() stays free for other work (here: a heartbeat LED).
+  
+  Circuit (Active-Low Configuration, two TB6600 drivers):
+  - Motor A: Step D7, Direction D6, Enable D5
+  - Motor B: Step D4, Direction D3, Enable D2
+  
+  Note: Timer1 is used for stepping (no Servo library, no PWM on D9/D10)
+  
+  Created for Embedded Programming Course
+  HAN University, Aug 2025
+*/
+
+#include <SimpleStepper.h>
+
+SimpleStepper motorA(7, 6, 5);
+SimpleStepper motorB(4, 3, 2);
+
+constexpr uint16_t HEARTBEAT_MS = 250;
+unsigned long lastBlink = 0;
+
+void setup() {
+  Serial.begin(9600);
+  Serial.println(F("SimpleStepper v2.1 - Async Motion Example"));
+  pinMode(LED_BUILTIN, OUTPUT);
+  
+  MotorConfig config;
+  config.rpm = 90;
+  motorA.begin(config);
+  
+  config.rpm = 45;
+  motorB.begin(config);
+}
+
+void loop() {
+  // Start a new move as soon as a motor is done (both turn concurrently)
+  if (!motorA.isRunning()) {
+    motorA.setDirection(motorA.getDirection() == Direction::CLOCKWISE ?
+                        Direction::COUNTER_CLOCKWISE : Direction::CLOCKWISE);
+    motorA.rotateAsync(2.0);
+  }
+  if (!motorB.isRunning()) {
+    motorB.rotateAsync(0.5);
+  }
+  
+  // loop() is free: nothing above blocks
+  if (millis() - lastBlink >= HEARTBEAT_MS) {
+    lastBlink = millis();
+    digitalWrite(LED_BUILTIN, !digitalRead(LED_BUILTIN));
+  }
+}
@@ -0,0 +1,79 @@
+/*
+  ClosedLoopMotion.ino
+  
+  Closed-loop example for SimpleStepper library v2.1
+  The motor follows a trapezoidal reference while its encoder is read
+  back every millisecond; slipped steps are made again. Hold the shaft
+  during a move: the error grows, then the motor catches up. Hold it
+  hard enough and the axis faults instead of losing its position.
+  
+  Circuit (Active-Low Configuration, TB6600 driver, 1/16 microstepping):
+  - Step D7, Direction D6, Enable D5
+  - Encoder A D2, B D3 (400 lines, 1600 counts/rev)
+  
+  Note: Timer1 is used for stepping (no Servo library, no PWM on D9/D10)
+  
+  Created for Embedded Programming Course
+  HAN University, Aug 2025
+*/
+
+#include <SimpleStepper.h>
+#include <ClosedLoopStepper.h>
+
+constexpr uint16_t STEPS_PER_REV = 3200;    // 200 full steps x 16
+constexpr uint16_t COUNTS_PER_REV = 1600;
+
+SimpleStepper motor(7, 6, 5);
+QuadratureEncoder encoder;
+ClosedLoopStepper axis(motor, encoder);
+
+const int32_t TARGETS[] = { 16000, 0, 8000, -8000, 0 };
+constexpr uint8_t TARGET_COUNT = sizeof(TARGETS) / sizeof(TARGETS[0]);
+uint8_t nextTarget = 0;
+unsigned long lastReport = 0;
+
+void setup() {
+  Serial.begin(9600);
+  Serial.println(F("SimpleStepper v2.1 - Closed-Loop Motion Example"));
+  
+  MotorConfig config;
+  motor.begin(config);
+  
+  if (!encoder.begin(2, 3) || !axis.begin(STEPS_PER_REV, COUNTS_PER_REV)) {
+    Serial.println(F("Encoder or step timer not available"));
+  }
+  
+  // Higher than open loop would risk: a slip is corrected, not lost
+  MotionLimits limits;
+  limits.maxSpeed = 8000;        // steps/s
+  limits.acceleration = 40000;   // steps/s^2
+  axis.setLimits(limits);
+  axis.setGains(100.0f, 20.0f, 0.0f);
+  axis.setErrorLimit(STEPS_PER_REV / 4);   // Quarter turn behind: fault
+}
+
+void loop() {
+  axis.update();
+  
+  if (axis.isFaulted()) {
+    Serial.println(F("Following error too large - axis stopped"));
+    delay(2000);
+    axis.setPosition(axis.getPosition());  // Take the encoder position, carry on
+    return;
+  }
+  
+  if (!axis.isRunning()) {
+    Serial.print(F("Target "));
+    Serial.println(TARGETS[nextTarget]);
+    axis.moveTo(TARGETS[nextTarget]);
+    nextTarget = (nextTarget + 1) % TARGET_COUNT;
+  }
+  
+  if (millis() - lastReport >= 200) {
+    lastReport = millis();
+    Serial.print(F("pos "));
+    Serial.print(axis.getPosition());
+    Serial.print(F(" error "));
+    Serial.println(axis.getFollowingError());
+  }
+}
@@ -0,0 +1,67 @@
+/*
+  MultiAxisMotion.ino
+  
+  Coordinated motion example for SimpleStepper library v2.1
+  Three axes move to a list of points; on every move all axes start and
+  arrive together, sharing one acceleration ramp.
+  
+  Circuit (Active-Low Configuration, three TB6600 drivers):
+  - STEP pins on one port (PORTD): X D2, Y D3, Z D4
+  - Direction: X D5, Y D6, Z D7
+  - Enable (shared): D8
+  
+  Note: Timer1 is used for stepping (no Servo library, no PWM on D9/D10)
+  
+  Created for Embedded Programming Course
+  HAN University, Aug 2025
+*/
+
+#include <SimpleStepper.h>
+#include <MultiAxisMotion.h>
+
+SimpleStepper axisX(2, 5, 8);
+SimpleStepper axisY(3, 6, 8);
+SimpleStepper axisZ(4, 7, 8);
+MultiAxisMotion motion;
+
+// Points in steps (X, Y, Z)
+const int32_t POINTS[][MULTIAXIS_MAX_AXES] = {
+  { 3200,     0,    0 },
+  { 3200,  1600,  400 },
+  {    0,  1600,  400 },
+  {    0,     0,    0 }
+};
+constexpr uint8_t POINT_COUNT = sizeof(POINTS) / sizeof(POINTS[0]);
+uint8_t nextPoint = 0;
+
+void setup() {
+  Serial.begin(9600);
+  Serial.println(F("SimpleStepper v2.1 - Multi-Axis Motion Example"));
+  
+  MotorConfig config;
+  axisX.begin(config);
+  axisY.begin(config);
+  axisZ.begin(config);
+  
+  // All STEP pins must share a port for the single port write
+  if (!motion.addAxis(axisX) || !motion.addAxis(axisY) || !motion.addAxis(axisZ)) {
+    Serial.println(F("STEP pins are not on one port"));
+  }
+  
+  MotionLimits limits;
+  limits.maxSpeed = 6400;        // Dominant axis, steps/s
+  limits.acceleration = 12800;   // steps/s^2
+  limits.profile = ProfileType::S_CURVE;
+  motion.setLimits(limits);
+}
+
+void loop() {
+  if (!motion.isRunning()) {
+    Serial.print(F("Point "));
+    Serial.println(nextPoint);
+    motion.moveTo(POINTS[nextPoint]);
+    nextPoint = (nextPoint + 1) % POINT_COUNT;
+  }
+  
+  // loop() stays free while the axes move
+}
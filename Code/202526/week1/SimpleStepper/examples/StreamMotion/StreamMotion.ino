@@ -0,0 +1,69 @@
+/*
+  StreamMotion.ino
+  
+  High step rate example for SimpleStepper library v2.1 (experimental)
+  The STEP pulses come out of USART1 in Master SPI mode as a bitstream,
+  so the motor runs at up to 250 kHz step rate without a step
+  interrupt. Moves back and forth and reports the result of every move.
+  
+  Circuit (Arduino Mega, Active-Low Configuration, A4988 / DRV8825 class
+  driver that takes 2 us pulses):
+  - Step D18 (TXD1, fixed), Direction D6, Enable D5
+  
+  Note: USART1 is used for stepping (no Serial1). On an Uno the stream
+  uses USART0: STEP on D1 and no Serial.
+  
+  Created for Embedded Programming Course
+  HAN University, Aug 2025
+*/
+
+#include <SimpleStepper.h>
+#include <StepStream.h>
+
+SimpleStepper motor(STEP_STREAM_STEP_PIN, 6, 5);
+StepStream stream;
+
+ISR(STEP_STREAM_UDRE_vect) { StepStream::onDataEmpty(); }
+
+constexpr uint16_t SLOT_NANOS = 2000;   // One bit of the pattern
+constexpr uint8_t PULSE_SLOTS = 1;      // 2 us STEP pulses
+constexpr int32_t MOVE_STEPS = 160000;  // 10 revolutions at 1/16 steps
+
+int32_t direction = 1;
+
+void setup() {
+  Serial.begin(115200);
+  Serial.println(F("SimpleStepper v2.1 - Stream Motion Example"));
+  
+  MotorConfig config;
+  config.microsteps = 16;
+  motor.begin(config);
+  
+  if (!stream.begin(motor, SLOT_NANOS, PULSE_SLOTS)) {
+    Serial.println(F("ERROR: StepStream not available on this pin or board"));
+    while (true) {}
+  }
+  
+  MotionLimits limits;
+  limits.maxSpeed = 160000;       // steps/s: 50 rev/s at 1/16
+  limits.acceleration = 400000;   // steps/s^2
+  stream.setLimits(limits);
+  Serial.print(F("Fastest step rate: "));
+  Serial.println(stream.getMaxSpeed());
+}
+
+void loop() {
+  // Renders the next half of the pattern (must come within 2 ms)
+  stream.update();
+  
+  if (!stream.isRunning()) {
+    Serial.print(F("Position "));
+    Serial.print(motor.getPosition());
+    Serial.print(F(", underruns "));
+    Serial.println(stream.getUnderruns());
+    
+    delay(500);
+    stream.move(direction * MOVE_STEPS);
+    direction = -direction;
+  }
+}
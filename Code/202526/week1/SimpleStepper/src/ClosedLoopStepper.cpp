@@ -0,0 +1,280 @@
+/*
+  ClosedLoopStepper.cpp - Encoder position control for one SimpleStepper axis
+  Created for Embedded Programming Course, HAN University
+  Version 2.1.0
+  Aug 2025
+*/
+
+#include "ClosedLoopStepper.h"
+
+namespace {
+  ClosedLoopStepper* activeAxis = nullptr;  // One closed-loop axis per tick
+
+  // steps/s -> steps per tick in Q16; the pulse lasts one tick and needs a
+  // low phase, so at most one step every two ticks
+  constexpr float RATE_SCALE = STEP_TIMER_TICK_MICROS * 65536.0f / 1000000.0f;
+  constexpr uint16_t MAX_RATE = 0x8000;
+  constexpr float MAX_DT = 0.01f;  // A late loop() must not make the reference jump
+}
+
+// Interrupt-safe access to state shared with the step ISR
+#if defined(__AVR__)
+#define CLOSED_LOOP_LOCK() uint8_t closedLoopSreg = SREG; cli()
+#define CLOSED_LOOP_UNLOCK() SREG = closedLoopSreg
+#else
+#define CLOSED_LOOP_LOCK() noInterrupts()
+#define CLOSED_LOOP_UNLOCK() interrupts()
+#endif
+
+ClosedLoopStepper::ClosedLoopStepper(SimpleStepper& motor, const QuadratureEncoder& encoder)
+  : _motor(motor),
+    _encoder(encoder),
+    _stepPort(nullptr),
+    _stepMask(0),
+    _activeLow(true),
+    _stepsPerCount(1.0f),
+    _maxSpeed(3200.0f),
+    _acceleration(6400.0f),
+    _kp(100.0f),
+    _ki(20.0f),
+    _kd(0.0f),
+    _errorLimit(800),
+    _tolerance(1),
+    _countOffset(0),
+    _positionOffset(0),
+    _target(0),
+    _reference(0.0f),
+    _referenceSpeed(0.0f),
+    _integral(0.0f),
+    _lastError(0.0f),
+    _error(0.0f),
+    _lastUpdate(0),
+    _stopping(false),
+    _faulted(false),
+    _rate(0),
+    _direction(1),
+    _phase(0),
+    _pulseActive(false) {
+}
+
+bool ClosedLoopStepper::begin(uint16_t stepsPerRev, uint16_t countsPerRev) {
+  if (!StepTimer::isAvailable() || countsPerRev == 0) return false;
+
+#if STEP_TIMER_AVAILABLE
+  _stepPort = portOutputRegister(digitalPinToPort(_motor.getStepPin()));
+  _stepMask = digitalPinToBitMask(_motor.getStepPin());
+#endif
+  _activeLow = (_motor.getSignalLogic() == SignalLogic::ACTIVE_LOW);
+  _stepsPerCount = (float)stepsPerRev / countsPerRev;
+
+  // SimpleStepper: CLOCKWISE counts up, the encoder must agree
+  _direction = 1;
+  _motor.setDirection(Direction::CLOCKWISE);
+  setPosition(0);
+  _lastUpdate = micros();
+
+  activeAxis = this;
+  return StepTimer::attach(serviceAll);
+}
+
+void ClosedLoopStepper::setLimits(const MotionLimits& limits) {
+  _maxSpeed = limits.maxSpeed;
+  _acceleration = limits.acceleration > 0 ? limits.acceleration : 1;
+}
+
+void ClosedLoopStepper::setGains(float kp, float ki, float kd) {
+  _kp = kp;
+  _ki = ki;
+  _kd = kd;
+  _integral = 0.0f;
+}
+
+void ClosedLoopStepper::setErrorLimit(uint16_t steps) {
+  _errorLimit = steps;
+}
+
+void ClosedLoopStepper::setTolerance(uint16_t steps) {
+  _tolerance = steps;
+}
+
+bool ClosedLoopStepper::moveTo(int32_t target) {
+  if (_faulted) return false;
+  // The reference carries on from where it is: a new target while
+  // moving blends into the running move
+  _target = target;
+  _stopping = false;
+  return true;
+}
+
+bool ClosedLoopStepper::move(int32_t steps) {
+  return moveTo(_target + steps);
+}
+
+void ClosedLoopStepper::stop() {
+  _stopping = true;
+}
+
+void ClosedLoopStepper::update() {
+  const unsigned long now = micros();
+  const unsigned long elapsed = now - _lastUpdate;
+  if (elapsed < CLOSED_LOOP_PERIOD_MICROS) return;
+  _lastUpdate = now;
+  if (_faulted) return;
+
+  float dt = elapsed * 1e-6f;
+  if (dt > MAX_DT) dt = MAX_DT;
+  updateReference(dt);
+
+  const float error = _reference - measure();
+  _error = error;
+  if (fabs(error) > _errorLimit) {
+    setRate(0.0f);
+    _faulted = true;
+    return;
+  }
+
+  // At rest within tolerance: hold still instead of hunting the last count
+  if (_referenceSpeed == 0.0f && fabs(error) <= _tolerance) {
+    _lastError = error;
+    setRate(0.0f);
+    return;
+  }
+
+  _integral += error * dt;
+  if (_ki > 0.0f) {
+    const float limit = _maxSpeed / _ki;  // Anti-windup: at most maxSpeed
+    if (_integral > limit) _integral = limit;
+    if (_integral < -limit) _integral = -limit;
+  }
+  const float derivative = (error - _lastError) / dt;
+  _lastError = error;
+
+  setRate(_referenceSpeed + _kp * error + _ki * _integral + _kd * derivative);
+}
+
+bool ClosedLoopStepper::isRunning() const {
+  if (_faulted) return false;
+  return _referenceSpeed != 0.0f || _reference != (float)_target || fabs(_error) > _tolerance;
+}
+
+bool ClosedLoopStepper::isFaulted() const {
+  return _faulted;
+}
+
+int32_t ClosedLoopStepper::getPosition() const {
+  return (int32_t)lroundf(measure());
+}
+
+int32_t ClosedLoopStepper::getFollowingError() const {
+  return (int32_t)lroundf(_error);
+}
+
+int32_t ClosedLoopStepper::getTarget() const {
+  return _target;
+}
+
+void ClosedLoopStepper::setPosition(int32_t position) {
+  setRate(0.0f);
+  _countOffset = _encoder.getCount();
+  _positionOffset = position;
+  _target = position;
+  _reference = position;
+  _referenceSpeed = 0.0f;
+  _integral = 0.0f;
+  _lastError = 0.0f;
+  _error = 0.0f;
+  _stopping = false;
+  _faulted = false;
+}
+
+// PRIVATE METHODS
+
+float ClosedLoopStepper::measure() const {
+  return _positionOffset + (_encoder.getCount() - _countOffset) * _stepsPerCount;
+}
+
+// Trapezoid in the time domain: brake when the stopping distance reaches
+// what is left, otherwise accelerate toward maxSpeed
+void ClosedLoopStepper::updateReference(float dt) {
+  float speed = _referenceSpeed;
+  const float dv = _acceleration * dt;
+
+  if (_stopping) {
+    if (fabs(speed) <= dv) {
+      _referenceSpeed = 0.0f;
+      _target = (int32_t)lroundf(_reference);
+      _reference = _target;
+      _stopping = false;
+      return;
+    }
+    speed -= speed > 0.0f ? dv : -dv;
+    _reference += speed * dt;
+    _referenceSpeed = speed;
+    return;
+  }
+
+  const float remaining = _target - _reference;
+  if (remaining == 0.0f && speed == 0.0f) return;
+
+  const float toward = remaining >= 0.0f ? 1.0f : -1.0f;
+  const float braking = speed * speed / (2.0f * _acceleration);
+  if (speed * toward < 0.0f) {
+    speed += toward * dv;                  // Moving away: turn around
+  } else if (fabs(remaining) - fabs(speed) * dt <= braking) {
+    speed -= toward * dv;                  // Brake
+    if (speed * toward < 0.0f) speed = 0.0f;
+  } else {
+    speed += toward * dv;
+  }
+  if (speed > _maxSpeed) speed = _maxSpeed;
+  if (speed < -_maxSpeed) speed = -_maxSpeed;
+
+  const float next = _reference + speed * dt;
+  if ((_target - next) * toward <= 0.0f || (fabs(remaining) < 0.5f && fabs(speed) <= dv)) {
+    _reference = _target;  // Arrived (or would pass the target this period)
+    _referenceSpeed = 0.0f;
+    return;
+  }
+  _reference = next;
+  _referenceSpeed = speed;
+}
+
+// Signed steps/s to the tick; DIR is changed while no step can start
+void ClosedLoopStepper::setRate(float rate) {
+  const int8_t direction = rate < 0.0f ? -1 : 1;
+  const float scaled = fabs(rate) * RATE_SCALE;
+  const uint16_t q = scaled >= MAX_RATE ? MAX_RATE : (uint16_t)scaled;
+
+  if (q > 0 && direction != _direction) {
+    CLOSED_LOOP_LOCK();
+    _rate = 0;
+    CLOSED_LOOP_UNLOCK();
+    _motor.setDirection(direction > 0 ? Direction::CLOCKWISE : Direction::COUNTER_CLOCKWISE);
+    _direction = direction;
+  }
+
+  CLOSED_LOOP_LOCK();
+  _rate = q;  // 16 bits: not a single store on AVR
+  CLOSED_LOOP_UNLOCK();
+}
+
+void ClosedLoopStepper::serviceAll() {
+  if (activeAxis) activeAxis->serviceTick();
+}
+
+// Timer tick (runs in the ISR): end the pulse of the last tick, then step
+// when the phase accumulator overflows. The rate is at most half a step
+// per tick, so a step never follows the previous one on the next tick.
+void ClosedLoopStepper::serviceTick() {
+  if (_pulseActive) {
+    if (_activeLow) *_stepPort |= _stepMask; else *_stepPort &= ~_stepMask;
+    _pulseActive = false;
+  }
+
+  _phase += _rate;
+  if (_phase < 0x10000UL) return;
+  _phase -= 0x10000UL;
+
+  if (_activeLow) *_stepPort &= ~_stepMask; else *_stepPort |= _stepMask;
+  _pulseActive = true;
+}
@@ -0,0 +1,125 @@
+/*
+  ClosedLoopStepper.h - Encoder position control for one SimpleStepper axis
+  Created for Embedded Programming Course, HAN University
+  Version 2.1.0
+  Aug 2025
+
+  move() trusts that every pulse lands. ClosedLoopStepper measures
+  instead: update() runs a control loop every CLOSED_LOOP_PERIOD_MICROS
+  from loop():
+
+  - a trapezoidal reference (position and speed) runs toward the target
+    within the MotionLimits;
+  - the following error is the reference minus the encoder position;
+  - the step rate is the reference speed (feed-forward) plus a PID on
+    the error, so slipped steps are made again instead of lost.
+
+  The rate goes to the StepTimer tick, which steps from a phase
+  accumulator: no division or float in the ISR. Because lost steps are
+  recovered, speed and acceleration can run closer to what the motor can
+  do than open loop allows. An error above the error limit means the
+  motor cannot follow at all (jammed, far too fast): the axis stops and
+  isFaulted() stays set until setPosition().
+
+  One closed-loop axis per program; it can share the tick with moveAsync().
+*/
+
+#ifndef ClosedLoopStepper_h
+#define ClosedLoopStepper_h
+
+#include "Arduino.h"
+#include "SimpleStepper.h"
+#include "MotionPlanner.h"
+#include "QuadratureEncoder.h"
+
+#ifndef CLOSED_LOOP_PERIOD_MICROS
+#define CLOSED_LOOP_PERIOD_MICROS 1000  // 1 kHz control loop
+#endif
+
+class ClosedLoopStepper {
+  public:
+    ClosedLoopStepper(SimpleStepper& motor, const QuadratureEncoder& encoder);
+
+    // stepsPerRev: commanded (micro)steps per revolution; countsPerRev:
+    // encoder counts per revolution (x4). false when no timer is available.
+    bool begin(uint16_t stepsPerRev, uint16_t countsPerRev);
+
+    // Reference trajectory (trapezoidal; the profile type is not used)
+    void setLimits(const MotionLimits& limits);
+
+    // rate (steps/s) = kp * error + ki * integral + kd * d(error)/dt,
+    // error in steps; the integral term is limited to maxSpeed
+    void setGains(float kp, float ki, float kd);
+
+    // Following error (steps) that faults the axis
+    void setErrorLimit(uint16_t steps);
+
+    // Error (steps) at which a finished move counts as arrived
+    void setTolerance(uint16_t steps);
+
+    // Absolute / relative move; false while faulted
+    bool moveTo(int32_t target);
+    bool move(int32_t steps);
+
+    // Bring the reference to standstill along the deceleration ramp
+    void stop();
+
+    // Control loop; call as often as possible from loop()
+    void update();
+
+    // True until the reference has arrived and the error is in tolerance
+    bool isRunning() const;
+    bool isFaulted() const;
+
+    // Encoder position in steps, and the error to the reference
+    int32_t getPosition() const;
+    int32_t getFollowingError() const;
+    int32_t getTarget() const;
+
+    // The axis is at position: clears a fault, holds there
+    void setPosition(int32_t position);
+
+  private:
+    float measure() const;
+    void updateReference(float dt);
+    void setRate(float rate);
+    void serviceTick();
+    static void serviceAll();
+
+    SimpleStepper& _motor;
+    const QuadratureEncoder& _encoder;
+    volatile uint8_t* _stepPort;
+    uint8_t _stepMask;
+    bool _activeLow;
+
+    // Configuration
+    float _stepsPerCount;
+    float _maxSpeed;
+    float _acceleration;
+    float _kp;
+    float _ki;
+    float _kd;
+    uint16_t _errorLimit;
+    uint16_t _tolerance;
+
+    // Control loop (loop() only)
+    int32_t _countOffset;     // Encoder count at setPosition()
+    int32_t _positionOffset;
+    int32_t _target;
+    float _reference;         // Reference position, steps
+    float _referenceSpeed;    // steps/s, signed
+    float _integral;
+    float _lastError;
+    float _error;
+    unsigned long _lastUpdate;
+    bool _stopping;
+    bool _faulted;
+
+    // Step engine (the rate is written by loop(), the rest is the ISR's)
+    volatile uint16_t _rate;  // Steps per tick, Q16 (at most 0.5)
+    int8_t _direction;        // Direction the DIR pin is set for
+    uint32_t _phase;
+    bool _pulseActive;
+};
+
+#endif
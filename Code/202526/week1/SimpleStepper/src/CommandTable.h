@@ -0,0 +1,163 @@
+/*
+  CommandTable.h - Text command dispatch through a compile-time perfect hash
+  Created for Embedded Programming Course, HAN University
+  Version 2.1.0
+  Aug 2025
+
+  The command set is a constexpr array of {name, handler}. At compile
+  time a seed is searched for which the FNV-1a hash of every name lands
+  in its own slot of a power-of-two table (static_assert if there is
+  none, e.g. for a duplicate name), and the slot table is placed in
+  flash. Dispatch hashes the first word of the line once and makes one
+  lookup, whatever the number of commands. The rest of the line is
+  passed to the handler in place.
+
+  Usage:
+    constexpr CommandDef<Machine> COMMANDS[] = {
+      {"HOME", &onHome},
+      {"GOTO", &onGoto},
+    };
+    typedef CommandTable<Machine, COMMANDS, 2> Commands;
+    Commands::dispatch(machine, line);  // false: unknown command
+*/
+
+#ifndef CommandTable_h
+#define CommandTable_h
+
+#include "Arduino.h"
+
+template <typename Context>
+struct CommandDef {
+  const char* name;
+  void (*handler)(Context& context, const char* args);
+};
+
+namespace command_table {
+  static constexpr uint32_t FNV_BASIS = 2166136261UL;
+  static constexpr uint32_t FNV_PRIME = 16777619UL;
+  static constexpr uint32_t NO_SEED = 0xFFFFFFFFUL;
+  static constexpr uint32_t MAX_SEED = 255;
+
+  // Command names end at the end of the string or at the first space
+  constexpr bool isEnd(char c) {
+    return c == '\0' || c == ' ';
+  }
+
+  constexpr uint32_t hash(const char* s, uint32_t h) {
+    return isEnd(*s) ? h : hash(s + 1, (h ^ (uint8_t)*s) * FNV_PRIME);
+  }
+
+  constexpr uint8_t length(const char* s) {
+    return isEnd(*s) ? 0 : 1 + length(s + 1);
+  }
+
+  constexpr uint8_t slotOf(uint32_t h, uint8_t mask) {
+    return (uint8_t)((h ^ (h >> 16)) & mask);
+  }
+
+  // Smallest power of two with at least twice as many slots as commands
+  constexpr uint8_t tableSize(uint8_t count, uint8_t size = 1) {
+    return size >= 2 * count ? size : tableSize(count, size * 2);
+  }
+
+  template <typename Context>
+  constexpr uint8_t slotOfCommand(const CommandDef<Context>* defs, uint8_t i, uint32_t seed, uint8_t mask) {
+    return slotOf(hash(defs[i].name, FNV_BASIS ^ seed), mask);
+  }
+
+  template <typename Context>
+  constexpr bool collides(const CommandDef<Context>* defs, uint8_t i, uint8_t j, uint8_t count, uint32_t seed, uint8_t mask) {
+    return j < count && (slotOfCommand(defs, i, seed, mask) == slotOfCommand(defs, j, seed, mask) ||
+                         collides(defs, i, j + 1, count, seed, mask));
+  }
+
+  template <typename Context>
+  constexpr bool isPerfect(const CommandDef<Context>* defs, uint8_t i, uint8_t count, uint32_t seed, uint8_t mask) {
+    return i >= count || (!collides(defs, i, i + 1, count, seed, mask) &&
+                          isPerfect(defs, i + 1, count, seed, mask));
+  }
+
+  template <typename Context>
+  constexpr uint32_t findSeed(const CommandDef<Context>* defs, uint8_t count, uint8_t mask, uint32_t seed = 0) {
+    return seed > MAX_SEED ? NO_SEED :
+           isPerfect(defs, 0, count, seed, mask) ? seed : findSeed(defs, count, mask, seed + 1);
+  }
+
+  // Index of the command in slot, or count when the slot is free
+  template <typename Context>
+  constexpr uint8_t commandInSlot(const CommandDef<Context>* defs, uint8_t slot, uint8_t count, uint32_t seed, uint8_t mask, uint8_t i = 0) {
+    return i >= count || slotOfCommand(defs, i, seed, mask) == slot ? i :
+           commandInSlot(defs, slot, count, seed, mask, i + 1);
+  }
+
+  // C++11 has no std::index_sequence
+  template <uint8_t... I> struct Indices {};
+  template <uint8_t N, uint8_t... I> struct MakeIndices : MakeIndices<N - 1, N - 1, I...> {};
+  template <uint8_t... I> struct MakeIndices<0, I...> { typedef Indices<I...> type; };
+}
+
+template <typename Context, const CommandDef<Context>* DEFS, uint8_t COUNT>
+class CommandTable {
+  public:
+    typedef void (*Handler)(Context& context, const char* args);
+
+    static constexpr uint8_t SIZE = command_table::tableSize(COUNT);
+    static constexpr uint8_t MASK = SIZE - 1;
+    static constexpr uint32_t SEED = command_table::findSeed(DEFS, COUNT, MASK);
+    static_assert(SEED != command_table::NO_SEED, "CommandTable: duplicate command name or no perfect seed");
+
+    // Run the command named by the first word of line; false when unknown.
+    // The full 32-bit hash and the length must match, so names are not
+    // stored and not compared.
+    static bool dispatch(Context& context, const char* line) {
+      uint32_t h = command_table::FNV_BASIS ^ SEED;
+      uint8_t length = 0;
+      const char* p = line;
+      while (!command_table::isEnd(*p)) {
+        h = (h ^ (uint8_t)*p++) * command_table::FNV_PRIME;
+        length++;
+      }
+      while (*p == ' ') p++;  // Arguments, in place
+
+      Slot slot;
+      memcpy_P(&slot, &Slots<typename command_table::MakeIndices<SIZE>::type>::table[command_table::slotOf(h, MASK)], sizeof(slot));
+      if (slot.handler == nullptr || slot.hash != h || slot.length != length) {
+        return false;
+      }
+      slot.handler(context, p);
+      return true;
+    }
+
+  private:
+    struct Slot {
+      uint32_t hash;
+      uint8_t length;
+      Handler handler;
+    };
+
+    static constexpr Slot makeSlot(uint8_t index) {
+      return makeSlotFor(command_table::commandInSlot(DEFS, index, COUNT, SEED, MASK));
+    }
+
+    static constexpr Slot makeSlotFor(uint8_t command) {
+      return command >= COUNT ? Slot{0, 0, nullptr} :
+             Slot{command_table::hash(DEFS[command].name, command_table::FNV_BASIS ^ SEED),
+                  command_table::length(DEFS[command].name),
+                  DEFS[command].handler};
+    }
+
+    template <typename Sequence> struct Slots;
+    template <uint8_t... I>
+    struct Slots<command_table::Indices<I...> > {
+      static const Slot table[sizeof...(I)];
+    };
+};
+
+template <typename Context, const CommandDef<Context>* DEFS, uint8_t COUNT>
+template <uint8_t... I>
+const typename CommandTable<Context, DEFS, COUNT>::Slot
+CommandTable<Context, DEFS, COUNT>::Slots<command_table::Indices<I...> >::table[sizeof...(I)] PROGMEM = {
+  CommandTable<Context, DEFS, COUNT>::makeSlot(I)...
+};
+
+#endif
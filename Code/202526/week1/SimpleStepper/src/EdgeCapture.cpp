@@ -0,0 +1,110 @@
+/*
+  EdgeCapture.cpp - Latch the axis position at a sensor edge
+  Created for Embedded Programming Course, HAN University
+  Version 2.1.0
+  Aug 2025
+*/
+
+#include "EdgeCapture.h"
+
+static EdgeCapture* activeCapture = nullptr;
+
+EdgeCapture::EdgeCapture()
+  : _input(nullptr),
+    _mask(0),
+    _activeHigh(true),
+    _usesInterrupt(false),
+    _armed(false),
+    _captured(false),
+    _position(0),
+    _capturedPosition(0) {
+}
+
+bool EdgeCapture::begin(uint8_t pin, bool activeHigh) {
+  pinMode(pin, INPUT);
+  _input = portInputRegister(digitalPinToPort(pin));
+  _mask = digitalPinToBitMask(pin);
+  _activeHigh = activeHigh;
+  _armed = false;
+  _captured = false;
+  activeCapture = this;
+
+  _usesInterrupt = false;
+#if defined(__AVR__) && defined(digitalPinToPCICR)
+  volatile uint8_t* pcicr = digitalPinToPCICR(pin);
+  if (pcicr) {
+    *digitalPinToPCMSK(pin) |= _BV(digitalPinToPCMSKbit(pin));
+    *pcicr |= _BV(digitalPinToPCICRbit(pin));
+    _usesInterrupt = true;
+  }
+#endif
+  return _usesInterrupt;
+}
+
+void EdgeCapture::arm() {
+#if defined(__AVR__)
+  uint8_t sreg = SREG;
+  cli();
+  _captured = false;
+  _armed = true;
+  SREG = sreg;
+#else
+  _captured = false;
+  _armed = true;
+#endif
+}
+
+void EdgeCapture::disarm() {
+  _armed = false;
+}
+
+void EdgeCapture::setPosition(int32_t position) {
+  if (!_armed) return;
+  if (!_usesInterrupt) {
+    _position = position;
+    onEdge();  // Polled: the edge fell somewhere in the last step
+    return;
+  }
+#if defined(__AVR__)
+  uint8_t sreg = SREG;  // Four stores: the ISR must not see half of them
+  cli();
+  _position = position;
+  SREG = sreg;
+#else
+  _position = position;
+#endif
+}
+
+bool EdgeCapture::isCaptured() const {
+  return _captured;
+}
+
+int32_t EdgeCapture::getCapturedPosition() const {
+#if defined(__AVR__)
+  uint8_t sreg = SREG;
+  cli();
+  int32_t position = _capturedPosition;
+  SREG = sreg;
+  return position;
+#else
+  return _capturedPosition;
+#endif
+}
+
+bool EdgeCapture::isActive() const {
+  bool high = (*_input & _mask) != 0;
+  return high == _activeHigh;
+}
+
+void EdgeCapture::onPinChange() {
+  if (activeCapture) activeCapture->onEdge();
+}
+
+// Any change on the port lands here: only the first one to the active
+// level counts, later bounces find the capture disarmed
+void EdgeCapture::onEdge() {
+  if (!_armed || !isActive()) return;
+  _capturedPosition = _position;
+  _captured = true;
+  _armed = false;
+}
@@ -0,0 +1,67 @@
+/*
+  EdgeCapture.h - Latch the axis position at a sensor edge
+  Created for Embedded Programming Course, HAN University
+  Version 2.1.0
+  Aug 2025
+
+  Polling a home sensor once per step finds the edge one step late at
+  best, and at speed the sensor may be read after several steps. With
+  EdgeCapture the sensor's pin-change interrupt copies the position at
+  the moment the sensor becomes active, however fast the axis runs. The
+  axis can then approach at full speed, decelerate past the edge and
+  still know exactly where it was.
+
+  The step code reports every new position with setPosition(); the
+  sketch's ISR(PCINTn_vect) calls EdgeCapture::onPinChange(), so the
+  capture can share that interrupt with other pin-change users. Without
+  a pin-change interrupt (not AVR, or a pin without one) setPosition()
+  reads the pin itself: the capture is then exact to one step.
+
+  One capture per program: onPinChange() is static.
+*/
+
+#ifndef EdgeCapture_h
+#define EdgeCapture_h
+
+#include "Arduino.h"
+
+class EdgeCapture {
+  public:
+    EdgeCapture();
+
+    // Enable the pin-change interrupt of pin; false when it has none and
+    // the edge is looked for in setPosition() instead
+    bool begin(uint8_t pin, bool activeHigh);
+
+    // Latch the position at the next change to the active level. If the
+    // sensor is already active there is no edge: check isActive() first.
+    void arm();
+    void disarm();
+
+    // Position after every step (while armed); copied atomically
+    void setPosition(int32_t position);
+
+    bool isCaptured() const;
+    int32_t getCapturedPosition() const;
+
+    // Sensor level now
+    bool isActive() const;
+
+    // Interrupt service; called from the sketch's pin-change handlers
+    static void onPinChange();
+
+  private:
+    void onEdge();
+
+    volatile uint8_t* _input;
+    uint8_t _mask;
+    bool _activeHigh;
+    bool _usesInterrupt;
+
+    volatile bool _armed;
+    volatile bool _captured;
+    volatile int32_t _position;
+    volatile int32_t _capturedPosition;
+};
+
+#endif
@@ -0,0 +1,65 @@
+/*
+  MessageTable.h - Status messages in flash, addressed by a compile-time ID
+  Created for Embedded Programming Course, HAN University
+  Version 2.1.0
+  Aug 2025
+
+  The texts are PROGMEM strings and the table of pointers to them is in
+  flash too; the ID is the index in that table, normally an enum. Text
+  output streams straight from flash, without the RAM copy of
+  strcpy_P(). A binary protocol sends only the ID. The host can translate
+  it with its own copy of the table. dictionaryHash() tells the host
+  whether that copy still matches the firmware.
+
+  Usage:
+    const char TEXT_READY[] PROGMEM = "STATUS:READY";
+    const char TEXT_HOMED[] PROGMEM = "STATUS:HOMED:0";
+    enum Message : uint8_t { MSG_READY, MSG_HOMED, MSG_COUNT };
+    const char* const TEXTS[MSG_COUNT] PROGMEM = {TEXT_READY, TEXT_HOMED};
+    typedef MessageTable<TEXTS, MSG_COUNT> Messages;
+    Messages::println(Serial, MSG_READY);
+*/
+
+#ifndef MessageTable_h
+#define MessageTable_h
+
+#include "Arduino.h"
+
+template <const char* const* TEXTS, uint8_t COUNT>
+class MessageTable {
+  public:
+    static const uint8_t SIZE = COUNT;
+    static_assert(COUNT > 0, "MessageTable: no messages");
+
+    // Text of a message in flash, nullptr for an unknown ID
+    static const __FlashStringHelper* text(uint8_t id) {
+      if (id >= COUNT) return nullptr;
+      return reinterpret_cast<const __FlashStringHelper*>(pgm_read_ptr(&TEXTS[id]));
+    }
+
+    static size_t print(Print& out, uint8_t id) {
+      const __FlashStringHelper* message = text(id);
+      return message == nullptr ? 0 : out.print(message);
+    }
+
+    static size_t println(Print& out, uint8_t id) {
+      return print(out, id) + out.println();
+    }
+
+    // FNV-1a over all texts in ID order, terminators included, so a
+    // reordered or edited table gives another hash
+    static uint32_t dictionaryHash() {
+      uint32_t h = 2166136261UL;
+      for (uint8_t id = 0; id < COUNT; id++) {
+        const char* p = reinterpret_cast<const char*>(pgm_read_ptr(&TEXTS[id]));
+        char c;
+        do {
+          c = (char)pgm_read_byte(p++);
+          h = (h ^ (uint8_t)c) * 16777619UL;
+        } while (c != '\0');
+      }
+      return h;
+    }
+};
+
+#endif
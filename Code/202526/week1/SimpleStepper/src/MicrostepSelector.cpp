@@ -0,0 +1,73 @@
+/*
+  MicrostepSelector.cpp - Microstep resolution through the driver's MS pins
+  Created for Embedded Programming Course, HAN University
+  Version 2.1.0
+  Aug 2025
+*/
+
+#include "MicrostepSelector.h"
+
+namespace {
+  // [log2(microsteps)] -> MS3 MS2 MS1 levels as bits 2..0, -1: no such mode
+  const int8_t A4988_CODES[] = { 0b000, 0b001, 0b010, 0b011, 0b111, -1 };
+  const int8_t DRV8825_CODES[] = { 0b000, 0b001, 0b010, 0b011, 0b100, 0b101 };
+  constexpr uint8_t CODE_COUNT = sizeof(A4988_CODES) / sizeof(A4988_CODES[0]);
+}
+
+MicrostepSelector::MicrostepSelector(uint8_t ms1, uint8_t ms2, uint8_t ms3, MicrostepDriver driver)
+  : _pins{ms1, ms2, ms3},
+    _driver(driver),
+    _microsteps(0) {
+}
+
+bool MicrostepSelector::begin(uint8_t microsteps) {
+  for (uint8_t i = 0; i < 3; i++) {
+    if (_pins[i] == MICROSTEP_PIN_NONE) continue;
+    pinMode(_pins[i], OUTPUT);
+#if defined(__AVR__)
+    _ports[i] = portOutputRegister(digitalPinToPort(_pins[i]));
+    _masks[i] = digitalPinToBitMask(_pins[i]);
+#endif
+  }
+  return select(microsteps);
+}
+
+bool MicrostepSelector::select(uint8_t microsteps) {
+  const int8_t code = codeFor(microsteps);
+  if (code < 0) return false;
+  for (uint8_t i = 0; i < 3; i++) {
+    writePin(i, code & (1 << i));
+  }
+  _microsteps = microsteps;
+  return true;
+}
+
+bool MicrostepSelector::supports(uint8_t microsteps) const {
+  return codeFor(microsteps) >= 0;
+}
+
+uint8_t MicrostepSelector::getMicrosteps() const {
+  return _microsteps;
+}
+
+// PRIVATE METHODS
+
+int8_t MicrostepSelector::codeFor(uint8_t microsteps) const {
+  if (microsteps == 0 || (microsteps & (microsteps - 1)) != 0) return -1;
+  uint8_t index = 0;
+  while ((1 << index) < microsteps) index++;
+  if (index >= CODE_COUNT) return -1;
+  return _driver == MicrostepDriver::DRV8825 ? DRV8825_CODES[index] : A4988_CODES[index];
+}
+
+void MicrostepSelector::writePin(uint8_t index, bool high) {
+  if (_pins[index] == MICROSTEP_PIN_NONE) return;
+#if defined(__AVR__)
+  uint8_t sreg = SREG;  // Read-modify-write of a port the ISR may also write
+  cli();
+  if (high) *_ports[index] |= _masks[index]; else *_ports[index] &= ~_masks[index];
+  SREG = sreg;
+#else
+  digitalWrite(_pins[index], high ? HIGH : LOW);
+#endif
+}
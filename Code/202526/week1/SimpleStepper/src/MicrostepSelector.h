@@ -0,0 +1,56 @@
+/*
+  MicrostepSelector.h - Microstep resolution through the driver's MS pins
+  Created for Embedded Programming Course, HAN University
+  Version 2.1.0
+  Aug 2025
+
+  The TB6600 sets its microstepping with DIP switches; drivers such as
+  the A4988 and DRV8825 have MS1..MS3 (MODE0..MODE2) inputs instead, so
+  the resolution can be changed while running. SimpleStepper uses this
+  to switch to coarse steps at high speed (setMicrostepSwitching()).
+
+  select() writes the pins straight to their output registers, so it is
+  short enough for the step ISR. A pin that is wired to a fixed level
+  can be given as MICROSTEP_PIN_NONE.
+*/
+
+#ifndef MicrostepSelector_h
+#define MicrostepSelector_h
+
+#include "Arduino.h"
+
+#define MICROSTEP_PIN_NONE 0xFF
+
+// MS pin coding differs per driver
+enum class MicrostepDriver : uint8_t {
+  A4988 = 0,     // Full to 1/16
+  DRV8825 = 1    // Full to 1/32
+};
+
+class MicrostepSelector {
+  public:
+    MicrostepSelector(uint8_t ms1, uint8_t ms2, uint8_t ms3,
+                      MicrostepDriver driver = MicrostepDriver::A4988);
+
+    // Pins as outputs, start at microsteps; false if not supported
+    bool begin(uint8_t microsteps);
+
+    // 1, 2, 4, ... microsteps per full step; false if not supported
+    bool select(uint8_t microsteps);
+    bool supports(uint8_t microsteps) const;
+    uint8_t getMicrosteps() const;
+
+  private:
+    int8_t codeFor(uint8_t microsteps) const;
+    void writePin(uint8_t index, bool high);
+
+    uint8_t _pins[3];
+#if defined(__AVR__)
+    volatile uint8_t* _ports[3];
+    uint8_t _masks[3];
+#endif
+    MicrostepDriver _driver;
+    volatile uint8_t _microsteps;
+};
+
+#endif
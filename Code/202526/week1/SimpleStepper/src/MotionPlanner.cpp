@@ -0,0 +1,250 @@
+/*
+  MotionPlanner.cpp - Step interval planner for accelerated stepper moves
+  Created for Embedded Programming Course, HAN University
+  Version 2.1.0
+  Aug 2025
+*/
+
+#include "MotionPlanner.h"
+#include <math.h>
+
+namespace {
+  constexpr float TIMER_HZ = 1000000.0f;          // Intervals in microseconds
+  constexpr float RATE_SCALE = 70.368744f;        // 2^46 / TIMER_HZ^2
+  constexpr uint32_t MAX_PERIOD = 0xFFFF0000UL;   // 65535 us, Q16.16
+  constexpr float MIN_SPEED = 15.26f;             // steps/s at MAX_PERIOD
+  
+  uint32_t periodFor(float speed) {
+    if (speed < MIN_SPEED) return MAX_PERIOD;
+    return static_cast<uint32_t>(TIMER_HZ / speed * 65536.0f);
+  }
+}
+
+MotionPlanner::MotionPlanner()
+  : _limits(),
+    _segmentCount(0),
+    _segment(0),
+    _stepsRemaining(0),
+    _period(MAX_PERIOD),
+    _cruisePeriod(MAX_PERIOD),
+    _endPeriod(MAX_PERIOD) {
+}
+
+MotionPlanner::MotionPlanner(const MotionLimits& limits) : MotionPlanner() {
+  setLimits(limits);
+}
+
+void MotionPlanner::setLimits(const MotionLimits& limits) {
+  _limits = limits;
+  if (_limits.acceleration == 0) _limits.acceleration = 1;
+  if (_limits.maxSpeed == 0) _limits.maxSpeed = 1;
+  if (_limits.jerk == 0) _limits.jerk = 4UL * _limits.acceleration;
+}
+
+const MotionLimits& MotionPlanner::getLimits() const {
+  return _limits;
+}
+
+// Constant-acceleration segments from one speed to another (plan time only).
+// Returns the number of segments; steps receives their total.
+uint8_t MotionPlanner::buildRamp(float fromSpeed, float toSpeed, Segment* out, uint32_t& steps) const {
+  steps = 0;
+  const float dv = fabsf(toSpeed - fromSpeed);
+  if (dv < 1.0f) return 0;
+  
+  const float sign = (toSpeed > fromSpeed) ? -1.0f : 1.0f;  // Accelerating shortens the interval
+  float accel[MAX_RAMP_SEGMENTS];
+  float deltaV[MAX_RAMP_SEGMENTS];
+  uint8_t count = 0;
+  
+  if (_limits.profile == ProfileType::S_CURVE) {
+    // Peak acceleration is reached only if the speed change allows it
+    const float jerk = (float)_limits.jerk;
+    const float aPeak = fminf((float)_limits.acceleration, sqrtf(jerk * dv));
+    const float rampTime = aPeak / jerk;
+    const float levelTime = rampTime / S_CURVE_LEVELS;
+    
+    for (uint8_t i = 0; i < S_CURVE_LEVELS; i++) {
+      accel[count] = aPeak * (i + 0.5f) / S_CURVE_LEVELS;
+      deltaV[count] = accel[count] * levelTime;
+      count++;
+    }
+    const float holdV = dv - aPeak * rampTime;  // Both ramps together gain aPeak * rampTime
+    if (holdV > 0.5f) {
+      accel[count] = aPeak;
+      deltaV[count++] = holdV;
+    }
+    for (uint8_t i = S_CURVE_LEVELS; i > 0; i--) {
+      accel[count] = aPeak * (i - 0.5f) / S_CURVE_LEVELS;
+      deltaV[count] = accel[count] * levelTime;
+      count++;
+    }
+  } else {
+    accel[0] = (float)_limits.acceleration;
+    deltaV[0] = dv;
+    count = 1;
+  }
+  
+  // Distance of each segment: (v1^2 - v0^2) / 2a
+  uint8_t used = 0;
+  float v = fromSpeed;
+  const float direction = (toSpeed > fromSpeed) ? 1.0f : -1.0f;
+  for (uint8_t i = 0; i < count; i++) {
+    float next = v + direction * deltaV[i];
+    if (direction > 0 ? next > toSpeed : next < toSpeed) next = toSpeed;
+    const float distance = fabsf(next * next - v * v) / (2.0f * accel[i]);
+    const uint32_t n = static_cast<uint32_t>(distance + 0.5f);
+    v = next;
+    if (n == 0) continue;
+    
+    out[used].steps = n;
+    out[used].rate = static_cast<int32_t>(sign * accel[i] * RATE_SCALE);
+    steps += n;
+    used++;
+  }
+  return used;
+}
+
+void MotionPlanner::plan(uint32_t steps, uint32_t startSpeed, uint32_t endSpeed) {
+  _segmentCount = 0;
+  _segment = 0;
+  _stepsRemaining = steps;
+  if (steps == 0) return;
+  
+  const float vMax = (float)_limits.maxSpeed;
+  const float v0 = fminf((float)startSpeed, vMax);
+  const float v1 = fminf((float)endSpeed, vMax);
+  
+  Segment up[MAX_RAMP_SEGMENTS];
+  Segment down[MAX_RAMP_SEGMENTS];
+  uint32_t upSteps = 0;
+  uint32_t downSteps = 0;
+  uint8_t upCount = buildRamp(v0, vMax, up, upSteps);
+  uint8_t downCount = buildRamp(vMax, v1, down, downSteps);
+  float vPeak = vMax;
+  
+  if (steps != CONTINUOUS && (uint64_t)upSteps + downSteps > steps) {
+    // Too short to reach full speed: highest peak whose ramps still fit
+    float low = fmaxf(v0, v1);
+    float high = vMax;
+    for (uint8_t i = 0; i < 20; i++) {
+      vPeak = 0.5f * (low + high);
+      upCount = buildRamp(v0, vPeak, up, upSteps);
+      downCount = buildRamp(vPeak, v1, down, downSteps);
+      if (upSteps + downSteps > steps) high = vPeak; else low = vPeak;
+    }
+    vPeak = low;
+    upCount = buildRamp(v0, vPeak, up, upSteps);
+    downCount = buildRamp(vPeak, v1, down, downSteps);
+    
+    // Rounding can still leave the ramps a few steps too long
+    while (upSteps + downSteps > steps && downCount > 0) {
+      Segment& last = down[downCount - 1];
+      last.steps--;
+      downSteps--;
+      if (last.steps == 0) downCount--;
+    }
+    while (upSteps + downSteps > steps && upCount > 0) {
+      Segment& last = up[upCount - 1];
+      last.steps--;
+      upSteps--;
+      if (last.steps == 0) upCount--;
+    }
+  }
+  
+  for (uint8_t i = 0; i < upCount; i++) _segments[_segmentCount++] = up[i];
+  const uint32_t cruiseSteps = (steps == CONTINUOUS) ? CONTINUOUS : steps - upSteps - downSteps;
+  if (cruiseSteps > 0) _segments[_segmentCount++] = {cruiseSteps, 0};
+  for (uint8_t i = 0; i < downCount; i++) _segments[_segmentCount++] = down[i];
+  
+  _cruisePeriod = periodFor(vPeak);
+  _endPeriod = periodFor(fmaxf(v1, MIN_SPEED));
+  
+  // First interval: speed after one step from v0 (Eiderman: F / sqrt(v0^2 + 2a))
+  if (upCount > 0) {
+    const float a = -up[0].rate / RATE_SCALE;
+    _period = periodFor(sqrtf(v0 * v0 + 2.0f * a));
+  } else {
+    _period = _cruisePeriod;
+  }
+  startSegment();
+}
+
+void MotionPlanner::requestStop() {
+  if (isDone()) return;
+  
+  const float speed = (float)getCurrentSpeed();
+  Segment down[MAX_RAMP_SEGMENTS];
+  uint32_t downSteps = 0;
+  const uint8_t downCount = buildRamp(speed, 0.0f, down, downSteps);
+  
+  // Slow enough already: this step is the last one
+  _segmentCount = 0;
+  _segment = 0;
+  if (downCount == 0) {
+    _segments[_segmentCount++] = {1, 0};
+    _stepsRemaining = 1;
+  } else {
+    for (uint8_t i = 0; i < downCount; i++) _segments[_segmentCount++] = down[i];
+    _stepsRemaining = downSteps;
+  }
+  _cruisePeriod = _period;
+  _endPeriod = MAX_PERIOD;
+}
+
+// Entering a cruise segment: snap to the exact planned speed
+void MotionPlanner::startSegment() {
+  if (_segment < _segmentCount && _segments[_segment].rate == 0) {
+    _period = _cruisePeriod;
+  }
+}
+
+uint32_t MotionPlanner::nextInterval() {
+  if (_stepsRemaining == 0 || _segment >= _segmentCount) return 0;
+  
+  const uint32_t interval = (_period + 0x8000UL) >> 16;
+  Segment& segment = _segments[_segment];
+  
+  if (segment.rate != 0) {
+    // q = m * p^2 in Q2.30, then p += p * (q + q^2)
+    const uint32_t p = (_period + 0x8000UL) >> 16;
+    const int32_t q = static_cast<int32_t>(((int64_t)segment.rate * (int64_t)(p * p)) >> 16);
+    const int32_t q2 = static_cast<int32_t>(((int64_t)q * q) >> 30);
+    int64_t period = (int64_t)_period + (((int64_t)_period * (q + q2)) >> 30);
+    
+    if (segment.rate < 0) {
+      if (period < (int64_t)_cruisePeriod) period = _cruisePeriod;  // Never faster than planned
+    } else if (period > (int64_t)_endPeriod) {
+      period = _endPeriod;
+    }
+    if (period > (int64_t)MAX_PERIOD) period = MAX_PERIOD;
+    _period = static_cast<uint32_t>(period);
+  }
+  
+  if (segment.steps != CONTINUOUS && --segment.steps == 0) {
+    _segment++;
+    startSegment();
+  }
+  if (_stepsRemaining != CONTINUOUS) _stepsRemaining--;
+  return interval > 0 ? interval : 1;
+}
+
+bool MotionPlanner::isDone() const {
+  return _stepsRemaining == 0 || _segment >= _segmentCount;
+}
+
+MotionPhase MotionPlanner::getPhase() const {
+  if (isDone()) return MotionPhase::IDLE;
+  const int32_t rate = _segments[_segment].rate;
+  if (rate < 0) return MotionPhase::ACCELERATING;
+  return rate == 0 ? MotionPhase::CRUISING : MotionPhase::DECELERATING;
+}
+
+uint32_t MotionPlanner::getStepsRemaining() const {
+  return _stepsRemaining;
+}
+
+uint32_t MotionPlanner::getCurrentSpeed() const {
+  const uint32_t p = _period >> 16;
+  return p > 0 ? 1000000UL / p : 1000000UL;
+}
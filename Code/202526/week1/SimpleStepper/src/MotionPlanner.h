@@ -0,0 +1,92 @@
+/*
+  MotionPlanner.h - Step interval planner for accelerated stepper moves
+  Created for Embedded Programming Course, HAN University
+  Version 2.1.0
+  Aug 2025
+  
+  plan() does the floating point work once per move and splits it into a
+  few constant-acceleration segments. nextInterval() then only needs the
+  Eiderman recurrence  p' = p * (1 + q + q^2),  q = m * p^2  in fixed point:
+  multiplies and shifts, no division or sqrt per step, so it is cheap
+  enough for a step ISR.
+  
+  TRAPEZOIDAL: accelerate, cruise, decelerate to the end speed.
+  S_CURVE:     jerk limited; the acceleration is ramped up and down in
+               S_CURVE_LEVELS steps per ramp, so the motor is never hit
+               with the full acceleration at once.
+*/
+
+#ifndef MotionPlanner_h
+#define MotionPlanner_h
+
+#include "Arduino.h"
+
+enum class ProfileType : uint8_t {
+  TRAPEZOIDAL = 0,
+  S_CURVE = 1
+};
+
+enum class MotionPhase : uint8_t {
+  IDLE = 0,
+  ACCELERATING = 1,
+  CRUISING = 2,
+  DECELERATING = 3
+};
+
+// Limits of the motion (SRP: configuration separate from planning)
+struct MotionLimits {
+  uint32_t maxSpeed = 3200;       // steps/s
+  uint32_t acceleration = 6400;   // steps/s^2
+  uint32_t jerk = 0;              // steps/s^3, S_CURVE only (0 = 4 x acceleration)
+  ProfileType profile = ProfileType::TRAPEZOIDAL;
+};
+
+class MotionPlanner {
+  public:
+    static constexpr uint8_t S_CURVE_LEVELS = 3;
+    // Per ramp: levels up, hold, levels down (S_CURVE) or a single segment
+    static constexpr uint8_t MAX_RAMP_SEGMENTS = 2 * S_CURVE_LEVELS + 1;
+    static constexpr uint8_t MAX_SEGMENTS = 2 * MAX_RAMP_SEGMENTS + 1;
+    static constexpr uint32_t CONTINUOUS = 0xFFFFFFFFUL;  // plan() until requestStop()
+    
+    MotionPlanner();
+    explicit MotionPlanner(const MotionLimits& limits);
+    
+    void setLimits(const MotionLimits& limits);
+    const MotionLimits& getLimits() const;
+    
+    // Plan a move of steps (speeds in steps/s, 0 = standstill).
+    // Uses float math: call from loop(), not from the ISR.
+    void plan(uint32_t steps, uint32_t startSpeed = 0, uint32_t endSpeed = 0);
+    
+    // Replace the rest of the move by the shortest ramp to standstill
+    void requestStop();
+    
+    // Microseconds until the next step, 0 when the move is complete
+    uint32_t nextInterval();
+    
+    bool isDone() const;
+    MotionPhase getPhase() const;
+    uint32_t getStepsRemaining() const;
+    uint32_t getCurrentSpeed() const;  // steps/s (divides: for status output)
+    
+  private:
+    struct Segment {
+      uint32_t steps;
+      int32_t rate;       // m = -+a/F^2 scaled by 2^46; < 0 accelerates, 0 cruises
+    };
+    
+    uint8_t buildRamp(float fromSpeed, float toSpeed, Segment* out, uint32_t& steps) const;
+    void startSegment();
+    
+    MotionLimits _limits;
+    Segment _segments[MAX_SEGMENTS];
+    uint8_t _segmentCount;
+    uint8_t _segment;
+    uint32_t _stepsRemaining;
+    uint32_t _period;        // Current interval, microseconds Q16.16
+    uint32_t _cruisePeriod;  // Interval at the planned peak speed, Q16.16
+    uint32_t _endPeriod;     // Longest interval at the end of a ramp, Q16.16
+};
+
+#endif
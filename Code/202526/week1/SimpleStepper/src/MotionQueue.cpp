@@ -0,0 +1,118 @@
+/*
+  MotionQueue.cpp - Look-ahead queue of motion segments for one axis
+  Created for Embedded Programming Course, HAN University
+  Version 2.1.0
+  Aug 2025
+*/
+
+#include "MotionQueue.h"
+#include <math.h>
+
+MotionQueue::MotionQueue()
+  : _limits(),
+    _segments(),
+    _head(0),
+    _count(0),
+    _endPosition(0),
+    _hasActive(false),
+    _activeDirection(1),
+    _activeExitSpeed(0) {
+}
+
+void MotionQueue::setLimits(const MotionLimits& limits) {
+  _limits = limits;
+  planJunctions();
+}
+
+void MotionQueue::reset(int32_t position) {
+  _head = 0;
+  _count = 0;
+  _endPosition = position;
+  _hasActive = false;
+  _activeExitSpeed = 0;
+}
+
+bool MotionQueue::push(int32_t target) {
+  if (target == _endPosition) return true;
+  if (isFull()) return false;
+  
+  MotionSegment& segment = _segments[(_head + _count) % CAPACITY];
+  segment.target = target;
+  segment.direction = target > _endPosition ? 1 : -1;
+  segment.steps = target > _endPosition ? (uint32_t)(target - _endPosition) : (uint32_t)(_endPosition - target);
+  segment.exitSpeed = 0;
+  _count++;
+  _endPosition = target;
+  
+  planJunctions();
+  return true;
+}
+
+bool MotionQueue::pop(MotionSegment& segment) {
+  if (_count == 0) {
+    _hasActive = false;
+    _activeExitSpeed = 0;
+    return false;
+  }
+  segment = _segments[_head];
+  _head = (_head + 1) % CAPACITY;
+  _count--;
+  
+  _hasActive = true;
+  _activeDirection = segment.direction;
+  _activeExitSpeed = segment.exitSpeed;
+  return true;
+}
+
+uint32_t MotionQueue::getActiveExitSpeed() const {
+  return _activeExitSpeed;
+}
+
+uint8_t MotionQueue::getCount() const {
+  return _count;
+}
+
+bool MotionQueue::isEmpty() const {
+  return _count == 0;
+}
+
+bool MotionQueue::isFull() const {
+  return _count >= CAPACITY;
+}
+
+// PRIVATE METHODS
+
+// Backward pass: the last segment ends at standstill; each exit speed is
+// the lower of the junction limit and the speed from which the next
+// segment can still brake to its own exit speed: v^2 = v_next^2 + 2 a L
+void MotionQueue::planJunctions() {
+  const float accel2 = 2.0f * (float)_limits.acceleration;
+  uint32_t nextExit = 0;
+  
+  for (uint8_t i = _count; i > 0; i--) {
+    MotionSegment& segment = _segments[(_head + i - 1) % CAPACITY];
+    segment.exitSpeed = nextExit;
+    if (i == 1) break;
+    
+    const MotionSegment& previous = _segments[(_head + i - 2) % CAPACITY];
+    const float reachable = sqrtf((float)nextExit * nextExit + accel2 * segment.steps);
+    const uint32_t limit = junctionSpeed(previous.direction, segment);
+    nextExit = reachable < limit ? (uint32_t)reachable : limit;
+  }
+  
+  if (_hasActive) {
+    if (_count == 0) {
+      _activeExitSpeed = 0;
+    } else {
+      const MotionSegment& first = _segments[_head];
+      const float reachable = sqrtf((float)first.exitSpeed * first.exitSpeed + accel2 * first.steps);
+      const uint32_t limit = junctionSpeed(_activeDirection, first);
+      _activeExitSpeed = reachable < limit ? (uint32_t)reachable : limit;
+    }
+  }
+}
+
+// A reversal needs a full stop; in the same direction the speed carries on
+uint32_t MotionQueue::junctionSpeed(int8_t fromDirection, const MotionSegment& next) const {
+  return fromDirection == next.direction ? _limits.maxSpeed : 0;
+}
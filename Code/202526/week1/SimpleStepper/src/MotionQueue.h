@@ -0,0 +1,67 @@
+/*
+  MotionQueue.h - Look-ahead queue of motion segments for one axis
+  Created for Embedded Programming Course, HAN University
+  Version 2.1.0
+  Aug 2025
+  
+  Targets are queued ahead of execution. On every push the junction
+  speeds are replanned backwards from a stop after the last segment:
+  the exit speed of a segment is the largest speed from which all
+  following segments can still be completed, limited to 0 where the
+  direction reverses. Consecutive moves in the same direction therefore
+  run through without stopping.
+*/
+
+#ifndef MotionQueue_h
+#define MotionQueue_h
+
+#include "Arduino.h"
+#include "MotionPlanner.h"
+
+struct MotionSegment {
+  int32_t target;      // Absolute end position
+  uint32_t steps;
+  int8_t direction;    // +1 / -1
+  uint32_t exitSpeed;  // steps/s at the end of the segment (look-ahead)
+};
+
+class MotionQueue {
+  public:
+    static constexpr uint8_t CAPACITY = 8;
+    
+    MotionQueue();
+    
+    void setLimits(const MotionLimits& limits);
+    
+    // Empty the queue; the next segment starts at position
+    void reset(int32_t position);
+    
+    // Queue a move to target. Zero-length moves are dropped (true);
+    // false when the queue is full.
+    bool push(int32_t target);
+    
+    // Take the next segment; it becomes the active one (false: none left)
+    bool pop(MotionSegment& segment);
+    
+    // Exit speed of the active segment; rises when a push lets it run on
+    uint32_t getActiveExitSpeed() const;
+    
+    uint8_t getCount() const;
+    bool isEmpty() const;
+    bool isFull() const;
+    
+  private:
+    void planJunctions();
+    uint32_t junctionSpeed(int8_t fromDirection, const MotionSegment& next) const;
+    
+    MotionLimits _limits;
+    MotionSegment _segments[CAPACITY];
+    uint8_t _head;
+    uint8_t _count;
+    int32_t _endPosition;   // End of the last queued segment
+    bool _hasActive;
+    int8_t _activeDirection;
+    uint32_t _activeExitSpeed;
+};
+
+#endif
@@ -0,0 +1,86 @@
+/*
+  MotionState.h - Packed axis state shared by the step ISR and loop()
+  Created for Embedded Programming Course, HAN University
+  Version 2.1.0
+  Aug 2025
+
+  Everything the step code and the application both need of one axis in
+  12 bytes: position, signed velocity in fixed point, step interval and
+  the axis flags in one byte. The fields sit together, so the ISR reaches
+  all of them from one pointer (a single Y/Z displacement on AVR).
+
+  Sharing is a seqlock: the writer bumps the sequence before and after
+  an update, and read() copies the whole state without disabling
+  interrupts, retrying when a write came in between (odd or changed
+  sequence). The writer is the step ISR; when loop() writes (a new move,
+  setting the position) it does so with interrupts off, so the ISR never
+  sees a half-written state. Single byte fields (flags) can be read
+  directly.
+*/
+
+#ifndef MotionState_h
+#define MotionState_h
+
+#include "Arduino.h"
+
+// Flag bits; MOTION_USER_* are free for the owner of the state
+#define MOTION_ENABLED 0x01   // Driver enabled
+#define MOTION_REVERSE 0x02   // Counting down (COUNTER_CLOCKWISE / BACKWARD)
+#define MOTION_RUNNING 0x04   // A move is being stepped
+#define MOTION_PULSE   0x08   // STEP is active, ends on the next tick
+#define MOTION_COARSE  0x10   // Driver at coarse microsteps (SimpleStepper)
+#define MOTION_USER_0  0x20
+#define MOTION_USER_1  0x40
+#define MOTION_USER_2  0x80
+
+// Velocity: signed steps per millisecond in Q8.8 (1/256 step/ms, up to
+// 127 steps/ms); computed from the interval, so no float in the ISR
+#define MOTION_VELOCITY_SHIFT 8
+
+struct MotionState {
+  int32_t position;    // Steps, up when MOTION_REVERSE is clear
+  uint32_t interval;   // Microseconds between steps
+  int16_t velocity;    // Q8.8 steps/ms, 0 when standing still
+  uint8_t flags;       // MOTION_* bits
+  uint8_t sequence;    // Odd while a write is in progress
+
+  // Writer side: ISR, or loop() with interrupts off
+  void beginWrite() volatile { sequence = sequence + 1; }
+  void endWrite() volatile { sequence = sequence + 1; }
+
+  bool has(uint8_t flag) const volatile { return (flags & flag) != 0; }
+  void set(uint8_t flag, bool on) volatile { flags = on ? (flags | flag) : (flags & ~flag); }
+
+  // Consistent copy from loop(); must not be used in an ISR (a write it
+  // interrupted would never finish)
+  MotionState read() const volatile {
+    MotionState copy;
+    uint8_t before;
+    do {
+      before = sequence;
+      copy.position = position;
+      copy.interval = interval;
+      copy.velocity = velocity;
+      copy.flags = flags;
+    } while ((before & 1) || before != sequence);
+    copy.sequence = before;
+    return copy;
+  }
+
+  // Q8.8 steps/ms of a step interval, saturated
+  static int16_t velocityFor(uint32_t intervalMicros, bool reverse) {
+    if (intervalMicros == 0) return 0;
+    const uint32_t scaled = ((1000UL << MOTION_VELOCITY_SHIFT) + intervalMicros / 2) / intervalMicros;
+    const int16_t speed = scaled > 0x7FFF ? 0x7FFF : (int16_t)scaled;
+    return reverse ? -speed : speed;
+  }
+
+  // Back to steps/s, for reports
+  static int32_t stepsPerSecond(int16_t velocity) {
+    return ((int32_t)velocity * 1000L) >> MOTION_VELOCITY_SHIFT;
+  }
+};
+
+static_assert(sizeof(MotionState) == 12, "MotionState must stay packed");
+
+#endif
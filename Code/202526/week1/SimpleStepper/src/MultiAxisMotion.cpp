@@ -0,0 +1,193 @@
+/*
+  MultiAxisMotion.cpp - Coordinated moves for several SimpleStepper axes
+  Created for Embedded Programming Course, HAN University
+  Version 2.1.0
+  Aug 2025
+*/
+
+#include "MultiAxisMotion.h"
+
+namespace {
+  MultiAxisMotion* activeMotion = nullptr;  // One coordinator owns the tick
+}
+
+// Interrupt-safe access to state shared with the step ISR
+#if defined(__AVR__)
+#define MULTIAXIS_LOCK() uint8_t multiAxisSreg = SREG; cli()
+#define MULTIAXIS_UNLOCK() SREG = multiAxisSreg
+#else
+#define MULTIAXIS_LOCK() noInterrupts()
+#define MULTIAXIS_UNLOCK() interrupts()
+#endif
+
+MultiAxisMotion::MultiAxisMotion()
+  : _axes(),
+    _axisCount(0),
+    _stepPort(nullptr),
+    _allMask(0),
+    _activeLow(true),
+    _planner(),
+    _majorSteps(0),
+    _majorRemaining(0),
+    _intervalMicros(0),
+    _elapsedMicros(0),
+    _pulseActive(false),
+    _stopRequested(false) {
+}
+
+bool MultiAxisMotion::addAxis(SimpleStepper& motor) {
+  if (_axisCount >= MULTIAXIS_MAX_AXES || isRunning()) return false;
+  
+#if STEP_TIMER_AVAILABLE
+  // Single port write per tick: every STEP pin must be on the same port
+  volatile uint8_t* port = portOutputRegister(digitalPinToPort(motor.getStepPin()));
+  if (_axisCount > 0 && port != _stepPort) return false;
+  _stepPort = port;
+  const uint8_t mask = digitalPinToBitMask(motor.getStepPin());
+#else
+  const uint8_t mask = 0;
+#endif
+  
+  Axis& axis = _axes[_axisCount++];
+  axis.motor = &motor;
+  axis.mask = mask;
+  axis.delta = 0;
+  axis.error = 0;
+  axis.direction = 1;
+  axis.position = 0;
+  _allMask |= mask;
+  _activeLow = (motor.getSignalLogic() == SignalLogic::ACTIVE_LOW);
+  return true;
+}
+
+uint8_t MultiAxisMotion::getAxisCount() const {
+  return _axisCount;
+}
+
+void MultiAxisMotion::setLimits(const MotionLimits& limits) {
+  _planner.setLimits(limits);
+}
+
+bool MultiAxisMotion::move(const int32_t* steps) {
+  if (_axisCount == 0 || isRunning() || !StepTimer::isAvailable()) return false;
+  
+  // Dominant axis sets the pace
+  uint32_t major = 0;
+  for (uint8_t i = 0; i < _axisCount; i++) {
+    Axis& axis = _axes[i];
+    axis.direction = steps[i] < 0 ? -1 : 1;
+    axis.delta = steps[i] < 0 ? (uint32_t)(-steps[i]) : (uint32_t)steps[i];
+    if (axis.delta > major) major = axis.delta;
+  }
+  if (major == 0) return true;
+  
+  for (uint8_t i = 0; i < _axisCount; i++) {
+    Axis& axis = _axes[i];
+    axis.error = (int32_t)(major / 2);
+    // SimpleStepper: CLOCKWISE counts up
+    axis.motor->setDirection(axis.direction > 0 ? Direction::CLOCKWISE : Direction::COUNTER_CLOCKWISE);
+  }
+  
+  // Float math of the ramp happens here, not in the ISR
+  _planner.plan(major);
+  _majorSteps = major;
+  _stopRequested = false;
+  _pulseActive = false;
+  _intervalMicros = _planner.nextInterval();
+  _elapsedMicros = _intervalMicros;  // First step on the next tick
+  
+  activeMotion = this;
+  MULTIAXIS_LOCK();
+  _majorRemaining = major;
+  MULTIAXIS_UNLOCK();
+  return StepTimer::attach(serviceAll);
+}
+
+bool MultiAxisMotion::moveTo(const int32_t* positions) {
+  int32_t steps[MULTIAXIS_MAX_AXES];
+  for (uint8_t i = 0; i < _axisCount; i++) {
+    steps[i] = positions[i] - getPosition(i);
+  }
+  return move(steps);
+}
+
+bool MultiAxisMotion::isRunning() const {
+  MULTIAXIS_LOCK();
+  const bool running = _majorRemaining != 0;
+  MULTIAXIS_UNLOCK();
+  return running;
+}
+
+// The ISR replans the ramp on its next step (requestStop() is cheap
+// compared to plan(), but must not race with nextInterval())
+void MultiAxisMotion::stop() {
+  MULTIAXIS_LOCK();
+  _stopRequested = true;
+  MULTIAXIS_UNLOCK();
+}
+
+int32_t MultiAxisMotion::getPosition(uint8_t axis) const {
+  if (axis >= _axisCount) return 0;
+  MULTIAXIS_LOCK();
+  const int32_t position = _axes[axis].position;
+  MULTIAXIS_UNLOCK();
+  return position;
+}
+
+void MultiAxisMotion::setPosition(uint8_t axis, int32_t position) {
+  if (axis >= _axisCount) return;
+  MULTIAXIS_LOCK();
+  _axes[axis].position = position;
+  MULTIAXIS_UNLOCK();
+}
+
+// PRIVATE METHODS
+
+void MultiAxisMotion::serviceAll() {
+  if (activeMotion) activeMotion->serviceTick();
+}
+
+// Timer tick (runs in the ISR): end the pulses of the last tick, then one
+// major step when its interval has elapsed, with a DDA step on every axis
+// whose error term overflows
+void MultiAxisMotion::serviceTick() {
+  if (_pulseActive) {
+    if (_activeLow) *_stepPort |= _allMask; else *_stepPort &= ~_allMask;
+    _pulseActive = false;
+  }
+  if (_majorRemaining == 0) return;
+  
+  _elapsedMicros += STEP_TIMER_TICK_MICROS;
+  if (_elapsedMicros < _intervalMicros) return;
+  _elapsedMicros -= _intervalMicros;
+  
+  if (_stopRequested) {
+    _stopRequested = false;
+    _planner.requestStop();
+    // Ramp length is in major steps; the minor axes scale along
+    const uint32_t left = _planner.getStepsRemaining();
+    if (left < _majorRemaining) _majorRemaining = left;
+  }
+  
+  uint8_t mask = 0;
+  for (uint8_t i = 0; i < _axisCount; i++) {
+    Axis& axis = _axes[i];
+    axis.error -= (int32_t)axis.delta;
+    if (axis.error < 0) {
+      axis.error += (int32_t)_majorSteps;
+      axis.position = axis.position + axis.direction;
+      mask |= axis.mask;
+    }
+  }
+  
+  // All axes in one write
+  if (_activeLow) *_stepPort &= ~mask; else *_stepPort |= mask;
+  _pulseActive = true;
+  
+  _majorRemaining = _majorRemaining - 1;
+  const uint32_t next = _planner.nextInterval();
+  if (next > 0) {
+    // The pulse lasts one tick and needs a low phase
+    _intervalMicros = next < 2UL * STEP_TIMER_TICK_MICROS ? 2UL * STEP_TIMER_TICK_MICROS : next;
+  }
+}
@@ -0,0 +1,76 @@
+/*
+  MultiAxisMotion.h - Coordinated moves for several SimpleStepper axes
+  Created for Embedded Programming Course, HAN University
+  Version 2.1.0
+  Aug 2025
+  
+  All axes start and arrive together. One MotionPlanner ramp drives the
+  axis with the most steps; the others follow by Bresenham (DDA)
+  interpolation on the same StepTimer tick. The STEP pins of all axes are
+  set with one write to their shared port, so the pulses of one tick are
+  simultaneous: put every STEP pin on the same port (D0-D7 = PORTD on
+  an Uno).
+*/
+
+#ifndef MultiAxisMotion_h
+#define MultiAxisMotion_h
+
+#include "Arduino.h"
+#include "SimpleStepper.h"
+#include "MotionPlanner.h"
+
+#define MULTIAXIS_MAX_AXES 3
+
+class MultiAxisMotion {
+  public:
+    MultiAxisMotion();
+    
+    // Axes keep their pins, logic level and enable state; index = order added.
+    // false when full or when the STEP pin is not on the port of axis 0.
+    bool addAxis(SimpleStepper& motor);
+    uint8_t getAxisCount() const;
+    
+    // Speed and acceleration of the dominant axis (steps/s)
+    void setLimits(const MotionLimits& limits);
+    
+    // Relative move, one signed step count per axis; returns false when
+    // busy or no timer is available. moveTo() uses the tracked positions.
+    bool move(const int32_t* steps);
+    bool moveTo(const int32_t* positions);
+    
+    bool isRunning() const;
+    void stop();  // Decelerate along the planned ramp, still coordinated
+    
+    int32_t getPosition(uint8_t axis) const;
+    void setPosition(uint8_t axis, int32_t position);
+    
+  private:
+    struct Axis {
+      SimpleStepper* motor;
+      uint8_t mask;
+      uint32_t delta;      // |steps| of this move
+      int32_t error;       // Bresenham error term
+      int8_t direction;    // +1 / -1
+      volatile int32_t position;
+    };
+    
+    void serviceTick();
+    static void serviceAll();
+    
+    Axis _axes[MULTIAXIS_MAX_AXES];
+    uint8_t _axisCount;
+    volatile uint8_t* _stepPort;
+    uint8_t _allMask;
+    bool _activeLow;
+    
+    // Written by loop() before a move, then owned by the ISR
+    MotionPlanner _planner;
+    uint32_t _majorSteps;
+    volatile uint32_t _majorRemaining;
+    uint32_t _intervalMicros;
+    uint32_t _elapsedMicros;
+    bool _pulseActive;
+    bool _stopRequested;
+};
+
+#endif
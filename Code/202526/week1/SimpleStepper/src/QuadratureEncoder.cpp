@@ -0,0 +1,118 @@
+/*
+  QuadratureEncoder.cpp - Interrupt-driven quadrature encoder counter
+  Created for Embedded Programming Course, HAN University
+  Version 2.1.0
+  Aug 2025
+*/
+
+#include "QuadratureEncoder.h"
+
+// [previous state << 2 | new state] -> count change; INVALID: both
+// channels changed, so the direction is unknown
+static const int8_t INVALID = 2;
+static const int8_t TRANSITIONS[16] = {
+   0, +1, -1, INVALID,
+  -1,  0, INVALID, +1,
+  +1, INVALID,  0, -1,
+  INVALID, -1, +1,  0
+};
+
+static QuadratureEncoder* activeEncoder = nullptr;
+
+static void encoderEdge() {
+  if (activeEncoder) activeEncoder->onEdge();
+}
+
+QuadratureEncoder::QuadratureEncoder()
+  : _inputA(nullptr),
+    _inputB(nullptr),
+    _maskA(0),
+    _maskB(0),
+    _pinA(0),
+    _pinB(0),
+    _state(0),
+    _count(0),
+    _errors(0) {
+}
+
+bool QuadratureEncoder::begin(uint8_t pinA, uint8_t pinB) {
+  if (activeEncoder != nullptr && activeEncoder != this) return false;
+  if (digitalPinToInterrupt(pinA) == NOT_AN_INTERRUPT ||
+      digitalPinToInterrupt(pinB) == NOT_AN_INTERRUPT) {
+    return false;
+  }
+
+  _pinA = pinA;
+  _pinB = pinB;
+  pinMode(pinA, INPUT_PULLUP);  // Open-collector encoders need a pull-up
+  pinMode(pinB, INPUT_PULLUP);
+  _inputA = portInputRegister(digitalPinToPort(pinA));
+  _inputB = portInputRegister(digitalPinToPort(pinB));
+  _maskA = digitalPinToBitMask(pinA);
+  _maskB = digitalPinToBitMask(pinB);
+
+  _state = readState();
+  _count = 0;
+  _errors = 0;
+  activeEncoder = this;
+  attachInterrupt(digitalPinToInterrupt(pinA), encoderEdge, CHANGE);
+  attachInterrupt(digitalPinToInterrupt(pinB), encoderEdge, CHANGE);
+  return true;
+}
+
+void QuadratureEncoder::end() {
+  if (activeEncoder != this) return;
+  detachInterrupt(digitalPinToInterrupt(_pinA));
+  detachInterrupt(digitalPinToInterrupt(_pinB));
+  activeEncoder = nullptr;
+}
+
+int32_t QuadratureEncoder::getCount() const {
+#if defined(__AVR__)
+  uint8_t sreg = SREG;  // 32 bits take four loads: keep the ISR out
+  cli();
+  int32_t count = _count;
+  SREG = sreg;
+  return count;
+#else
+  return _count;
+#endif
+}
+
+void QuadratureEncoder::setCount(int32_t count) {
+#if defined(__AVR__)
+  uint8_t sreg = SREG;
+  cli();
+  _count = count;
+  SREG = sreg;
+#else
+  _count = count;
+#endif
+}
+
+uint32_t QuadratureEncoder::getErrors() const {
+#if defined(__AVR__)
+  uint8_t sreg = SREG;
+  cli();
+  uint32_t errors = _errors;
+  SREG = sreg;
+  return errors;
+#else
+  return _errors;
+#endif
+}
+
+uint8_t QuadratureEncoder::readState() const {
+  return ((*_inputA & _maskA) ? 2 : 0) | ((*_inputB & _maskB) ? 1 : 0);
+}
+
+void QuadratureEncoder::onEdge() {
+  uint8_t state = readState();
+  int8_t change = TRANSITIONS[(_state << 2) | state];
+  _state = state;
+  if (change == INVALID) {
+    _errors++;
+  } else {
+    _count += change;
+  }
+}
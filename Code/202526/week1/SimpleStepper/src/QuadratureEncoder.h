@@ -0,0 +1,55 @@
+/*
+  QuadratureEncoder.h - Interrupt-driven quadrature encoder counter
+  Created for Embedded Programming Course, HAN University
+  Version 2.1.0
+  Aug 2025
+
+  Both channels interrupt on every edge (x4 decoding). The ISR reads the
+  two pins straight from their input registers and looks the transition
+  up in a 16-entry table: +1, -1, or 0 for no change. An impossible
+  transition (both channels changed, an edge was missed) is counted in
+  getErrors() instead of guessed.
+
+  Use pins with an external interrupt (D2 and D3 on an Uno). One
+  encoder per program: the interrupt handlers are shared.
+*/
+
+#ifndef QuadratureEncoder_h
+#define QuadratureEncoder_h
+
+#include "Arduino.h"
+
+class QuadratureEncoder {
+  public:
+    QuadratureEncoder();
+
+    // Attach the interrupts and start counting from 0; false if a pin
+    // has no external interrupt or another encoder is active
+    bool begin(uint8_t pinA, uint8_t pinB);
+    void end();
+
+    // Counts since begin() (4 per encoder line); safe in loop()
+    int32_t getCount() const;
+    void setCount(int32_t count);
+
+    // Transitions where both channels changed at once
+    uint32_t getErrors() const;
+
+    // Interrupt service; called from the pin change handlers
+    void onEdge();
+
+  private:
+    uint8_t readState() const;
+
+    volatile uint8_t* _inputA;
+    volatile uint8_t* _inputB;
+    uint8_t _maskA;
+    uint8_t _maskB;
+    uint8_t _pinA;
+    uint8_t _pinB;
+    volatile uint8_t _state;    // Last A/B levels: A << 1 | B
+    volatile int32_t _count;
+    volatile uint32_t _errors;
+};
+
+#endif
@@ -1,7 +1,7 @@
 /*
   SimpleStepper.cpp - Clean library for controlling stepper motors with TB6600 drivers
   Created for Embedded Programming Course, HAN University
-  Version 2.0.0
+  Version 2.1.0
   Aug 2025
   
   Note: Configured for active-low control (PUL-, DIR-, ENA-)
@@ -18,17 +18,43 @@ namespace {
   constexpr uint32_t MICROS_PER_MINUTE = 60000000UL;
   constexpr uint16_t MAX_DELAY_MICROS = 16383;
   constexpr uint16_t MILLIS_PER_SECOND = 1000;
+
+  SimpleStepper* asyncMotors[SIMPLESTEPPER_MAX_ASYNC] = {nullptr};
+  uint8_t asyncCount = 0;
 }
 
+// Interrupt-safe access to state shared with the step ISR
+#if defined(__AVR__)
+#define STEPPER_LOCK() uint8_t stepperSreg = SREG; cli()
+#define STEPPER_UNLOCK() SREG = stepperSreg
+#else
+#define STEPPER_LOCK() noInterrupts()
+#define STEPPER_UNLOCK() interrupts()
+#endif
+
+constexpr uint32_t SimpleStepper::MIN_ASYNC_INTERVAL_MICROS;
+
 // Constructor - initialization list (RAII principle)
 SimpleStepper::SimpleStepper(uint8_t stepPin, uint8_t dirPin, uint8_t enablePin)
   : _stepPin(stepPin),
     _dirPin(dirPin),
     _enablePin(enablePin),
-    _direction(Direction::CLOCKWISE),
-    _state(MotorState::DISABLED),
+    _motion{0, 1000, 0, 0, 0},
     _config(),
-    _stepDelayMicros(1000) {
+    _stepDelayMicros(1000),
+    _speed(MotionState::velocityFor(1000, false)),
+    _stepPort(nullptr),
+    _stepMask(0),
+    _dirPort(nullptr),
+    _dirMask(0),
+    _stepsRemaining(0),
+    _elapsedMicros(0),
+    _selector(nullptr),
+    _coarseMicrosteps(0),
+    _coarseRatio(1),
+    _switchRPM(0),
+    _coarseLeft(0),
+    _coarseIntervalMicros(1000) {
 }
 
 // Initialize motor with configuration (SRP: only initialization)
@@ -50,7 +76,9 @@ void SimpleStepper::begin(const MotorConfig& config) {
 
 // Set motor state (SRP: only state management)
 void SimpleStepper::setState(MotorState state) {
-  _state = state;
+  STEPPER_LOCK();  // The ISR also writes the flags
+  _motion.set(MOTION_ENABLED, state == MotorState::ENABLED);
+  STEPPER_UNLOCK();
   // Use configured logic level (active-low or active-high)
   digitalWrite(_enablePin, state == MotorState::ENABLED ? activeLevel() : inactiveLevel());
   delayMicroseconds(SETUP_TIME_MICROS);
@@ -58,32 +86,51 @@ void SimpleStepper::setState(MotorState state) {
 
 // Get current motor state
 MotorState SimpleStepper::getState() const {
-  return _state;
+  return _motion.has(MOTION_ENABLED) ? MotorState::ENABLED : MotorState::DISABLED;
 }
 
 // Set direction (SRP: only direction management)
 void SimpleStepper::setDirection(Direction dir) {
-  _direction = dir;
-  digitalWrite(_dirPin, static_cast<uint8_t>(dir));
+  const bool reverse = (dir == Direction::COUNTER_CLOCKWISE);
+  STEPPER_LOCK();
+  _motion.set(MOTION_REVERSE, reverse);
+  const int16_t velocity = _motion.velocity;
+  if ((velocity < 0) != reverse) _motion.velocity = -velocity;  // Sign follows DIR
+  STEPPER_UNLOCK();
+  writeDirPin(dir);
   delayMicroseconds(SETUP_TIME_MICROS);
 }
 
 // Get current direction
 Direction SimpleStepper::getDirection() const {
-  return _direction;
+  return _motion.has(MOTION_REVERSE) ? Direction::COUNTER_CLOCKWISE : Direction::CLOCKWISE;
 }
 
 // Generate single step (SRP: only step generation)
 void SimpleStepper::step() {
+  preparePulse();
   pulseStep();
   delayMicros(_stepDelayMicros);
 }
 
 // Move specified number of steps (uses DRY - calls step())
 void SimpleStepper::move(uint32_t steps) {
-  for (uint32_t i = 0; i < steps; i++) {
-    step();
+  _coarseLeft = planCoarse(steps);
+  if (_coarseLeft == 0) {
+    for (uint32_t i = 0; i < steps; i++) {
+      step();
+    }
+    return;
+  }
+  
+  // Fine steps up to the coarse grid, coarse pulses, fine steps to the end
+  while (steps > 0) {
+    const uint8_t size = preparePulse();
+    pulseStep();
+    steps -= size;
+    delayMicros(size == 1 ? _stepDelayMicros : _coarseIntervalMicros);
   }
+  endCoarse();
 }
 
 // Rotate specified revolutions (SRP: only rotation logic)
@@ -92,6 +139,52 @@ void SimpleStepper::rotate(float revolutions) {
   move(totalSteps);
 }
 
+// Start moving in the background (SRP: only hands the steps to the ISR)
+bool SimpleStepper::moveAsync(uint32_t steps) {
+  if (!StepTimer::isAvailable()) {
+    move(steps);  // No timer on this target: blocking fallback
+    return true;
+  }
+  if (!registerAsync()) return false;
+
+  STEPPER_LOCK();
+  _elapsedMicros = _motion.interval;  // First step on the next tick
+  _coarseLeft = planCoarse(steps);
+  _stepsRemaining = steps;
+  _motion.set(MOTION_RUNNING, steps > 0);
+  _motion.velocity = steps > 0 ? (_motion.has(MOTION_REVERSE) ? -_speed : _speed) : 0;
+  STEPPER_UNLOCK();
+  return true;
+}
+
+// Rotate in the background (same conversion as rotate())
+bool SimpleStepper::rotateAsync(float revolutions) {
+  return moveAsync(calculateTotalSteps(revolutions));
+}
+
+// True while moveAsync() steps are left (one byte: no lock needed)
+bool SimpleStepper::isRunning() const {
+  return _motion.has(MOTION_RUNNING);
+}
+
+// Steps still to go (32-bit read is not atomic on AVR)
+uint32_t SimpleStepper::getStepsRemaining() const {
+  STEPPER_LOCK();
+  uint32_t remaining = _stepsRemaining;
+  STEPPER_UNLOCK();
+  return remaining;
+}
+
+// Stop a background move after the current pulse
+void SimpleStepper::stop() {
+  STEPPER_LOCK();
+  _stepsRemaining = 0;
+  endCoarse();  // On the coarse grid, so fine steps line up again
+  _motion.set(MOTION_RUNNING, false);
+  _motion.velocity = 0;
+  STEPPER_UNLOCK();
+}
+
 // Set speed in RPM (SRP: only speed management)
 void SimpleStepper::setRPM(uint16_t rpm) {
   _config.rpm = rpm;
@@ -103,6 +196,62 @@ uint16_t SimpleStepper::getRPM() const {
   return _config.rpm;
 }
 
+// Enable or (selector nullptr) disable microstep switching
+bool SimpleStepper::setMicrostepSwitching(MicrostepSelector* selector, uint8_t coarseMicrosteps, uint16_t switchRPM) {
+  if (isRunning()) return false;
+  if (selector == nullptr) {
+    _coarseRatio = 1;
+    return true;
+  }
+  
+  const uint8_t fine = _config.microsteps;
+  if (coarseMicrosteps == 0 || coarseMicrosteps >= fine || fine % coarseMicrosteps != 0 ||
+      !selector->supports(coarseMicrosteps) || !selector->supports(fine)) {
+    return false;
+  }
+  
+  _selector = selector;
+  _coarseMicrosteps = coarseMicrosteps;
+  _coarseRatio = fine / coarseMicrosteps;  // Both powers of two
+  _switchRPM = switchRPM;
+  STEPPER_LOCK();
+  _motion.set(MOTION_COARSE, false);
+  STEPPER_UNLOCK();
+  _selector->select(fine);
+  updateStepDelay();
+  return true;
+}
+
+// Resolution the driver is set to now
+uint8_t SimpleStepper::getActiveMicrosteps() const {
+  return _motion.has(MOTION_COARSE) ? _coarseMicrosteps : _config.microsteps;
+}
+
+// Position in fine steps (seqlock read, the step ISR is not held off)
+int32_t SimpleStepper::getPosition() const {
+  return _motion.read().position;
+}
+
+void SimpleStepper::setPosition(int32_t position) {
+  STEPPER_LOCK();
+  _motion.position = position;
+  STEPPER_UNLOCK();
+}
+
+MotionState SimpleStepper::getMotionState() const {
+  return _motion.read();
+}
+
+// Get STEP pin
+uint8_t SimpleStepper::getStepPin() const {
+  return _stepPin;
+}
+
+// Get configured signal logic
+SignalLogic SimpleStepper::getSignalLogic() const {
+  return _config.signalLogic;
+}
+
 // PRIVATE METHODS
 
 // Initialize pin states (SRP: only pin initialization)
@@ -113,8 +262,17 @@ void SimpleStepper::setPinStates() {
   
   // Set initial states based on configured logic
   digitalWrite(_stepPin, inactiveLevel());  // Step inactive
-  digitalWrite(_dirPin, static_cast<uint8_t>(_direction));
+  digitalWrite(_dirPin, static_cast<uint8_t>(getDirection()));
   digitalWrite(_enablePin, inactiveLevel());  // Start disabled
+  
+#if defined(__AVR__)
+  // Direct port access for pulseStep(), setDirection() and the step ISR:
+  // digitalWrite() looks up the pin tables on every call
+  _stepPort = portOutputRegister(digitalPinToPort(_stepPin));
+  _stepMask = digitalPinToBitMask(_stepPin);
+  _dirPort = portOutputRegister(digitalPinToPort(_dirPin));
+  _dirMask = digitalPinToBitMask(_dirPin);
+#endif
 }
 
 // Update step delay based on configuration (SRP: only delay calculation)
@@ -126,14 +284,66 @@ void SimpleStepper::updateStepDelay() {
   if (stepsPerMinute > 0) {
     _stepDelayMicros = MICROS_PER_MINUTE / stepsPerMinute;
   }
+  
+  // One coarse pulse covers _coarseRatio fine steps (divided once, no
+  // rounding error multiplied up)
+  uint32_t coarseDelay = _stepDelayMicros * _coarseRatio;
+  if (stepsPerMinute > 0) {
+    coarseDelay = MICROS_PER_MINUTE * _coarseRatio / stepsPerMinute;
+  }
+  
+  uint32_t interval = _stepDelayMicros < MIN_ASYNC_INTERVAL_MICROS ? MIN_ASYNC_INTERVAL_MICROS : _stepDelayMicros;
+  setIntervals(interval, coarseDelay, MotionState::velocityFor(interval, false));
+}
+
+// Precomputed timing (SRP: only applies it)
+void SimpleStepper::applyStepTiming(uint16_t rpm, uint32_t stepDelayQ8, int16_t speed) {
+  _config.rpm = rpm;
+  _stepDelayMicros = stepDelayQ8 >> 8;
+  uint32_t interval = _stepDelayMicros < MIN_ASYNC_INTERVAL_MICROS ? MIN_ASYNC_INTERVAL_MICROS : _stepDelayMicros;
+  setIntervals(interval, (stepDelayQ8 * _coarseRatio) >> 8, speed);
+}
+
+// Also applies to a running background move
+void SimpleStepper::setIntervals(uint32_t interval, uint32_t coarseDelay, int16_t speed) {
+  uint32_t coarseInterval = coarseDelay < MIN_ASYNC_INTERVAL_MICROS ? MIN_ASYNC_INTERVAL_MICROS : coarseDelay;
+  STEPPER_LOCK();
+  _speed = speed;
+  _motion.interval = interval;
+  _coarseIntervalMicros = coarseInterval;
+  if (_motion.has(MOTION_RUNNING)) {
+    _motion.velocity = _motion.has(MOTION_REVERSE) ? -speed : speed;
+  }
+  STEPPER_UNLOCK();
 }
 
 // Generate step pulse (SRP: only pulse generation)
 void SimpleStepper::pulseStep() {
   // Generate pulse based on configured logic
-  digitalWrite(_stepPin, activeLevel());   // Active
+  writeStepPin(true);   // Active
   delayMicroseconds(PULSE_WIDTH_MICROS);
-  digitalWrite(_stepPin, inactiveLevel());  // Inactive
+  writeStepPin(false);  // Inactive
+}
+
+void SimpleStepper::writeStepPin(bool active) {
+  if (_stepPort == nullptr) {
+    digitalWrite(_stepPin, active ? activeLevel() : inactiveLevel());
+    return;
+  }
+  STEPPER_LOCK();  // Read-modify-write of a port the ISR may also write
+  writeStepPort(active);
+  STEPPER_UNLOCK();
+}
+
+// DIR level is the Direction value, whatever the signal logic
+void SimpleStepper::writeDirPin(Direction dir) {
+  if (_dirPort == nullptr) {
+    digitalWrite(_dirPin, static_cast<uint8_t>(dir));
+    return;
+  }
+  STEPPER_LOCK();  // Read-modify-write of a port the ISR may also write
+  if (static_cast<uint8_t>(dir) == LOW) *_dirPort &= ~_dirMask; else *_dirPort |= _dirMask;
+  STEPPER_UNLOCK();
 }
 
 // Handle delays > 16383 microseconds (SRP: only delay handling)
@@ -151,4 +361,94 @@ uint32_t SimpleStepper::calculateTotalSteps(float revolutions) const {
   return static_cast<uint32_t>(revolutions * 
                                 _config.stepsPerRevolution * 
                                 _config.microsteps);
-}
\ No newline at end of file
+}
+
+// Coarse pulses that fit in a move of steps, after the fine steps that
+// bring the position onto the coarse grid; 0 below the switch speed
+uint32_t SimpleStepper::planCoarse(uint32_t steps) const {
+  if (_coarseRatio <= 1 || _config.rpm < _switchRPM) return 0;
+  
+  const uint32_t offset = static_cast<uint32_t>(_motion.position) & (_coarseRatio - 1);
+  uint32_t head = 0;
+  if (offset != 0) {
+    head = _motion.has(MOTION_REVERSE) ? offset : _coarseRatio - offset;
+  }
+  return steps > head ? (steps - head) / _coarseRatio : 0;
+}
+
+// Select the resolution of the coming pulse and count it; returns its
+// size in fine steps. Coarse only on the coarse grid, so the driver's
+// microstep table and the position stay in step.
+uint8_t SimpleStepper::preparePulse() {
+  const bool coarse = _coarseLeft > 0 &&
+                      (static_cast<uint32_t>(_motion.position) & (_coarseRatio - 1)) == 0;
+  if (coarse != _motion.has(MOTION_COARSE)) {
+    _selector->select(coarse ? _coarseMicrosteps : _config.microsteps);
+    _motion.set(MOTION_COARSE, coarse);
+  }
+  
+  const uint8_t size = coarse ? _coarseRatio : 1;
+  if (coarse) _coarseLeft = _coarseLeft - 1;
+  _motion.position = _motion.position + (_motion.has(MOTION_REVERSE) ? -size : size);
+  return size;
+}
+
+// Back to fine microstepping for positioning and holding
+void SimpleStepper::endCoarse() {
+  _coarseLeft = 0;
+  if (_motion.has(MOTION_COARSE)) {
+    _selector->select(_config.microsteps);
+    _motion.set(MOTION_COARSE, false);
+  }
+}
+
+// Add this motor to the ISR list once (SRP: only registration)
+bool SimpleStepper::registerAsync() {
+  for (uint8_t i = 0; i < asyncCount; i++) {
+    if (asyncMotors[i] == this) return true;
+  }
+  if (asyncCount >= SIMPLESTEPPER_MAX_ASYNC || _stepPort == nullptr) return false;
+
+  STEPPER_LOCK();
+  asyncMotors[asyncCount++] = this;
+  STEPPER_UNLOCK();
+  return StepTimer::attach(serviceAll);
+}
+
+// Timer tick for all async motors (runs in the ISR)
+void SimpleStepper::serviceAll() {
+  for (uint8_t i = 0; i < asyncCount; i++) {
+    asyncMotors[i]->serviceTick();
+  }
+}
+
+// Timer tick for one motor (runs in the ISR): end the pulse of the last
+// tick, then step when the interval has elapsed
+void SimpleStepper::serviceTick() {
+  if (_motion.has(MOTION_PULSE)) {
+    writeStepPort(false);
+    _motion.set(MOTION_PULSE, false);
+  }
+  if (_stepsRemaining == 0) return;
+  
+  // Accumulate time, so the average rate is exact even when the interval
+  // is not a multiple of the tick
+  const bool coarse = _coarseLeft > 0 &&
+                      (static_cast<uint32_t>(_motion.position) & (_coarseRatio - 1)) == 0;
+  const uint32_t interval = coarse ? _coarseIntervalMicros : _motion.interval;
+  _elapsedMicros += STEP_TIMER_TICK_MICROS;
+  if (_elapsedMicros < interval) return;
+  _elapsedMicros -= interval;
+  
+  _motion.beginWrite();
+  const uint8_t size = preparePulse();  // MS pins before the STEP edge
+  writeStepPort(true);
+  _motion.set(MOTION_PULSE, true);
+  _stepsRemaining = _stepsRemaining - size;
+  if (_stepsRemaining == 0) {
+    endCoarse();
+    _motion.set(MOTION_RUNNING, false);
+    _motion.velocity = 0;
+  }
+  _motion.endWrite();
+}
@@ -1,16 +1,24 @@
 /*
   SimpleStepper.h - Clean library for controlling stepper motors with TB6600 drivers
   Created for Embedded Programming Course, HAN University
-  Version 2.0.0
+  Version 2.1.0
   Aug 2025
   
   Note: Configured for active-low control (PUL-, DIR-, ENA-)
+  moveAsync() steps from the shared Timer1 interrupt (see StepTimer.h)
+  setMicrostepSwitching() runs fast moves at coarse microsteps on drivers
+  with MS pins (see MicrostepSelector.h)
 */
 
 #ifndef SimpleStepper_h
 #define SimpleStepper_h
 
 #include "Arduino.h"
+#include "StepTimer.h"
+#include "MicrostepSelector.h"
+#include "MotionState.h"
+
+#define SIMPLESTEPPER_MAX_ASYNC 4   // Motors that can run with moveAsync()
 
 // Proper enum for direction (type safety)
 enum class Direction : uint8_t {
@@ -40,6 +48,9 @@ struct MotorConfig {
 
 class SimpleStepper {
   public:
+    // The pulse lasts one tick and needs a low phase: at least two ticks per step
+    static constexpr uint32_t MIN_ASYNC_INTERVAL_MICROS = 2UL * STEP_TIMER_TICK_MICROS;
+    
     // Constructor
     SimpleStepper(uint8_t stepPin, uint8_t dirPin, uint8_t enablePin);
     
@@ -59,30 +70,93 @@ class SimpleStepper {
     void move(uint32_t steps);
     void rotate(float revolutions);
     
+    // Non-blocking movement (SRP: the timer interrupt generates the steps)
+    bool moveAsync(uint32_t steps);   // false if no async slot is free
+    bool rotateAsync(float revolutions);
+    bool isRunning() const;
+    uint32_t getStepsRemaining() const;
+    void stop();
+    
     // Speed configuration
     void setRPM(uint16_t rpm);
     uint16_t getRPM() const;
     
+    // Microstep switching (driver MS pins): at or above switchRPM a move
+    // runs in coarseMicrosteps pulses between fine steps that align it to
+    // the coarse grid and finish it at config.microsteps. Step counts and
+    // the position stay in config.microsteps. false if the selector does
+    // not support both or coarse does not divide config.microsteps.
+    bool setMicrostepSwitching(MicrostepSelector* selector, uint8_t coarseMicrosteps, uint16_t switchRPM);
+    uint8_t getActiveMicrosteps() const;
+    
+    // Position in config.microsteps steps; CLOCKWISE counts up
+    int32_t getPosition() const;
+    void setPosition(int32_t position);
+    
+    // Position, velocity, interval and flags as one consistent snapshot,
+    // read without blocking the step interrupt (see MotionState.h)
+    MotionState getMotionState() const;
+    
+    // Pin and logic level, for coordinators such as MultiAxisMotion
+    uint8_t getStepPin() const;
+    SignalLogic getSignalLogic() const;
+    
+  protected:
+    // Speed with the timing worked out by the caller (SimpleStepperT: at
+    // compile time): the fine step delay in 1/256 us, so the coarse delay
+    // is a multiplication, and the speed at the fine interval for
+    // MotionState::velocity. No division.
+    void applyStepTiming(uint16_t rpm, uint32_t stepDelayQ8, int16_t speed);
+    
   private:
     // Pin assignments (const after initialization)
     const uint8_t _stepPin;
     const uint8_t _dirPin;
     const uint8_t _enablePin;
     
-    // Current state
-    Direction _direction;
-    MotorState _state;
+    // Position, interval, velocity, direction, enable and pulse state
+    // (written by the timer interrupt inside its seqlock)
+    volatile MotionState _motion;
     
     // Configuration
     MotorConfig _config;
     uint32_t _stepDelayMicros;
+    int16_t _speed;                  // MotionState::velocity at _motion.interval, forward
+    
+    // STEP and DIR as port and bit mask, resolved in begin() (AVR only,
+    // nullptr elsewhere: digitalWrite())
+    volatile uint8_t* _stepPort;
+    uint8_t _stepMask;
+    volatile uint8_t* _dirPort;
+    uint8_t _dirMask;
+    
+    // Async stepping (written by loop(), consumed by the timer interrupt)
+    volatile uint32_t _stepsRemaining;
+    uint32_t _elapsedMicros;
+    
+    // Microstep switching (_coarseRatio 1: off)
+    MicrostepSelector* _selector;
+    uint8_t _coarseMicrosteps;
+    uint8_t _coarseRatio;            // config.microsteps / coarse, power of two
+    uint16_t _switchRPM;
+    volatile uint32_t _coarseLeft;   // Coarse pulses still planned for this move
+    volatile uint32_t _coarseIntervalMicros;
     
     // Private methods (SRP: each method has one job)
     void updateStepDelay();
+    void setIntervals(uint32_t interval, uint32_t coarseDelay, int16_t speed);
     void pulseStep();
+    void writeStepPin(bool active);
+    void writeDirPin(Direction dir);
     void delayMicros(uint32_t micros);
     void setPinStates();
     uint32_t calculateTotalSteps(float revolutions) const;
+    uint32_t planCoarse(uint32_t steps) const;
+    uint8_t preparePulse();
+    void endCoarse();
+    bool registerAsync();
+    void serviceTick();
+    static void serviceAll();
     
     // Logic level helpers (DRY: centralize logic inversion)
     inline uint8_t activeLevel() const { 
@@ -91,6 +165,13 @@ class SimpleStepper {
     inline uint8_t inactiveLevel() const { 
       return (_config.signalLogic == SignalLogic::ACTIVE_LOW) ? HIGH : LOW; 
     }
+    
+    // STEP pin through the cached port; interrupts must be off, as the
+    // ISR writes the same port for the other motors
+    inline void writeStepPort(bool active) {
+      if (active == (_config.signalLogic == SignalLogic::ACTIVE_LOW)) *_stepPort &= ~_stepMask;
+      else *_stepPort |= _stepMask;
+    }
 };
 
 // Convenience aliases for backward compatibility
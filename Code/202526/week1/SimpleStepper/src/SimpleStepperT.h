@@ -0,0 +1,121 @@
+/*
+  SimpleStepperT.h - SimpleStepper with the motor configuration fixed at compile time
+  Created for Embedded Programming Course, HAN University
+  Version 2.1.0
+  Aug 2025
+
+  SimpleStepper works out its step delay from MotorConfig at run time: 32-bit
+  divisions in setRPM() and a float product in rotate(). When the motor and
+  its speeds are known when the sketch is written, SimpleStepperT<Config>
+  does that arithmetic in the compiler:
+
+    typedef StaticMotorConfig<200, 16, 60> PumpMotor;   // Steps/rev, microsteps, rpm
+    SimpleStepperT<PumpMotor> pump(7, 6, 5);
+
+    pump.begin();
+    pump.setPresetRPM<120>();       // Delays are constants, no division
+    pump.moveRevolutions(3);        // One integer multiplication
+
+  Every speed, the default and each setPresetRPM<>(), is checked with
+  static_assert: it must fit the step timer (two ticks per step at
+  least) and its delays must fit 32 bits. Everything else is the
+  ordinary SimpleStepper, the run time setRPM() included.
+
+  C++11 (the Arduino AVR core) has no class type template parameters,
+  so the configuration is a type with constexpr members rather than a
+  MotorConfig value.
+*/
+
+#ifndef SimpleStepperT_h
+#define SimpleStepperT_h
+
+#include "SimpleStepper.h"
+
+template <uint16_t StepsPerRevolution, uint8_t Microsteps, uint16_t Rpm,
+          SignalLogic Logic = SignalLogic::ACTIVE_LOW>
+struct StaticMotorConfig {
+  static constexpr uint16_t STEPS_PER_REVOLUTION = StepsPerRevolution;
+  static constexpr uint8_t MICROSTEPS = Microsteps;
+  static constexpr uint16_t RPM = Rpm;
+  static constexpr SignalLogic SIGNAL_LOGIC = Logic;
+};
+
+namespace stepper_timing {
+  static constexpr uint64_t MICROS_PER_MINUTE_Q8 = 60000000ULL << 8;
+
+  constexpr uint32_t clampInterval(uint32_t micros) {
+    return micros < SimpleStepper::MIN_ASYNC_INTERVAL_MICROS ? SimpleStepper::MIN_ASYNC_INTERVAL_MICROS : micros;
+  }
+
+  // MotionState::velocityFor() of a forward move
+  constexpr int16_t speedFor(uint32_t intervalMicros) {
+    return ((1000ULL << MOTION_VELOCITY_SHIFT) + intervalMicros / 2) / intervalMicros > 0x7FFF ? 0x7FFF :
+           (int16_t)(((1000ULL << MOTION_VELOCITY_SHIFT) + intervalMicros / 2) / intervalMicros);
+  }
+}
+
+template <typename Config>
+class SimpleStepperT : public SimpleStepper {
+  public:
+    static constexpr uint32_t STEPS_PER_REVOLUTION =
+      (uint32_t)Config::STEPS_PER_REVOLUTION * Config::MICROSTEPS;
+
+    static_assert(STEPS_PER_REVOLUTION > 0, "SimpleStepperT: no steps per revolution");
+
+    // Timing of one speed, all constants
+    template <uint16_t Rpm>
+    struct Preset {
+      static constexpr uint32_t STEPS_PER_MINUTE = (uint32_t)Rpm * STEPS_PER_REVOLUTION;
+      static_assert(Rpm > 0 && STEPS_PER_MINUTE / Rpm == STEPS_PER_REVOLUTION,
+                    "SimpleStepperT: speed is 0 or overflows steps per minute");
+
+      static constexpr uint32_t DELAY_Q8 = (uint32_t)(stepper_timing::MICROS_PER_MINUTE_Q8 / STEPS_PER_MINUTE);
+      static_assert(stepper_timing::MICROS_PER_MINUTE_Q8 / STEPS_PER_MINUTE * Config::MICROSTEPS <= 0xFFFFFFFFULL,
+                    "SimpleStepperT: speed too low, the coarse step delay overflows");
+
+      static constexpr uint32_t STEP_DELAY_MICROS = DELAY_Q8 >> 8;
+      static_assert(STEP_DELAY_MICROS >= SimpleStepper::MIN_ASYNC_INTERVAL_MICROS,
+                    "SimpleStepperT: speed too high for the step timer (two ticks per step)");
+
+      // Timer ticks per step; the ISR keeps the remainder, so the average is exact
+      static constexpr uint32_t TICKS_PER_STEP = STEP_DELAY_MICROS / STEP_TIMER_TICK_MICROS;
+
+      static constexpr int16_t SPEED = stepper_timing::speedFor(stepper_timing::clampInterval(STEP_DELAY_MICROS));
+    };
+
+    typedef Preset<Config::RPM> Default;
+    static constexpr uint32_t STEP_DELAY_MICROS = Default::STEP_DELAY_MICROS;
+
+    SimpleStepperT(uint8_t stepPin, uint8_t dirPin, uint8_t enablePin)
+      : SimpleStepper(stepPin, dirPin, enablePin) {
+    }
+
+    void begin() {
+      MotorConfig config;
+      config.stepsPerRevolution = Config::STEPS_PER_REVOLUTION;
+      config.microsteps = Config::MICROSTEPS;
+      config.rpm = Config::RPM;
+      config.signalLogic = Config::SIGNAL_LOGIC;
+      SimpleStepper::begin(config);
+    }
+
+    // One of the speeds checked at compile time; also for a running move
+    template <uint16_t Rpm>
+    void setPresetRPM() {
+      applyStepTiming(Rpm, Preset<Rpm>::DELAY_Q8, Preset<Rpm>::SPEED);
+    }
+
+    static constexpr uint32_t stepsFor(uint32_t revolutions) {
+      return revolutions * STEPS_PER_REVOLUTION;
+    }
+
+    void moveRevolutions(uint32_t revolutions) {
+      move(stepsFor(revolutions));
+    }
+
+    bool moveRevolutionsAsync(uint32_t revolutions) {
+      return moveAsync(stepsFor(revolutions));
+    }
+};
+
+#endif
@@ -0,0 +1,121 @@
+/*
+  StallDetector.cpp - Commanded versus measured position for one axis
+  Created for Embedded Programming Course, HAN University
+  Version 2.1.0
+  Aug 2025
+*/
+
+#include "StallDetector.h"
+
+StallDetector::StallDetector()
+  : _encoder(nullptr),
+    _stepsPerRev(1),
+    _countsPerRev(1),
+    _tolerance(0),
+    _countOffset(0),
+    _positionOffset(0),
+    _commanded(0),
+    _expected(0),
+    _fraction(0),
+    _maxError(0),
+    _faultInput(nullptr),
+    _faultMask(0),
+    _faultActiveHigh(true),
+    _reason(StallReason::NONE) {
+}
+
+void StallDetector::attachEncoder(const QuadratureEncoder* encoder, uint16_t stepsPerRev,
+                                  uint16_t countsPerRev, uint16_t toleranceCounts) {
+  _encoder = encoder;
+  _stepsPerRev = stepsPerRev > 0 ? stepsPerRev : 1;
+  _countsPerRev = countsPerRev > 0 ? countsPerRev : 1;
+  _tolerance = toleranceCounts;
+  reset(_commanded);
+}
+
+void StallDetector::attachFaultPin(uint8_t pin, uint8_t activeLevel) {
+  pinMode(pin, INPUT_PULLUP);  // Fault outputs are usually open collector
+  _faultInput = portInputRegister(digitalPinToPort(pin));
+  _faultMask = digitalPinToBitMask(pin);
+  _faultActiveHigh = (activeLevel == HIGH);
+}
+
+void StallDetector::reset(int32_t position) {
+  _commanded = position;
+  _positionOffset = position;
+  _countOffset = _encoder ? _encoder->getCount() : 0;
+  _expected = 0;
+  _fraction = 0;
+  _maxError = 0;
+  _reason = StallReason::NONE;
+}
+
+bool StallDetector::onStep(int8_t direction) {
+  _commanded += direction;
+  if (_reason != StallReason::NONE) return true;
+
+  if (checkFault()) {
+    _reason = StallReason::DRIVER_FAULT;
+    return true;
+  }
+
+  if (_encoder == nullptr) return false;
+
+  // Expected counts follow the steps by countsPerRev / stepsPerRev,
+  // Bresenham style: one add and a compare per step, no division
+  if (direction > 0) {
+    _fraction += _countsPerRev;
+    while (_fraction >= _stepsPerRev) {
+      _fraction -= _stepsPerRev;
+      _expected++;
+    }
+  } else {
+    while (_fraction < _countsPerRev) {
+      _fraction += _stepsPerRev;
+      _expected--;
+    }
+    _fraction -= _countsPerRev;
+  }
+
+  int32_t error = getFollowingError();
+  uint32_t magnitude = error < 0 ? -error : error;
+  if (magnitude > _maxError) _maxError = magnitude > 0xFFFF ? 0xFFFF : (uint16_t)magnitude;
+  if (magnitude > _tolerance) {
+    _reason = StallReason::FOLLOWING_ERROR;
+    return true;
+  }
+  return false;
+}
+
+bool StallDetector::checkFault() const {
+  if (_faultInput == nullptr) return false;
+  bool high = (*_faultInput & _faultMask) != 0;
+  return high == _faultActiveHigh;
+}
+
+bool StallDetector::isStalled() const {
+  return _reason != StallReason::NONE;
+}
+
+StallReason StallDetector::getReason() const {
+  return _reason;
+}
+
+int32_t StallDetector::getFollowingError() const {
+  if (_encoder == nullptr) return 0;
+  return (_encoder->getCount() - _countOffset) - _expected;
+}
+
+uint16_t StallDetector::getMaxFollowingError() const {
+  return _maxError;
+}
+
+int32_t StallDetector::getCommandedPosition() const {
+  return _commanded;
+}
+
+int32_t StallDetector::getMeasuredPosition() const {
+  if (_encoder == nullptr) return _commanded;
+  int64_t counts = _encoder->getCount() - _countOffset;
+  return _positionOffset + (int32_t)(counts * _stepsPerRev / _countsPerRev);
+}
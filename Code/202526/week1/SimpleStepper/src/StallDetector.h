@@ -0,0 +1,92 @@
+/*
+  StallDetector.h - Commanded versus measured position for one axis
+  Created for Embedded Programming Course, HAN University
+  Version 2.1.0
+  Aug 2025
+
+  An open-loop stepper counts the steps it sends, not the steps the
+  motor makes. When it stalls, the count runs on. StallDetector is told
+  about every commanded step (onStep()) and compares it in real time
+  with one or both of:
+
+  - a QuadratureEncoder: the expected encoder count follows the
+    commanded steps (integer ratio, no division per step); a following
+    error above the tolerance is a stall. A stalled stepper slips a
+    whole electrical cycle (4 full steps) at a time, so a tolerance of
+    1-2 full steps catches the first slip within a few steps.
+  - a driver fault output (ALM / DIAG / stallGuard pin): read on every
+    step, stall when it shows the active level.
+
+  After a stall onStep() keeps returning true until reset(), normally
+  when the axis is homed again.
+*/
+
+#ifndef StallDetector_h
+#define StallDetector_h
+
+#include "Arduino.h"
+#include "QuadratureEncoder.h"
+
+enum class StallReason : uint8_t {
+  NONE = 0,
+  FOLLOWING_ERROR = 1,   // Encoder disagrees with the commanded position
+  DRIVER_FAULT = 2       // Driver fault input active
+};
+
+class StallDetector {
+  public:
+    StallDetector();
+
+    // Compare against an encoder. stepsPerRev: commanded (micro)steps per
+    // motor revolution; countsPerRev: encoder counts per revolution (x4);
+    // toleranceCounts: largest following error that is not a stall.
+    void attachEncoder(const QuadratureEncoder* encoder, uint16_t stepsPerRev,
+                       uint16_t countsPerRev, uint16_t toleranceCounts);
+
+    // Watch a driver fault output; activeLevel is HIGH or LOW
+    void attachFaultPin(uint8_t pin, uint8_t activeLevel);
+
+    // Commanded position is now position and the encoder agrees with it;
+    // clears a stall and the error statistics
+    void reset(int32_t position);
+
+    // After every commanded step (+1 / -1); true when stalled
+    bool onStep(int8_t direction);
+
+    bool isStalled() const;
+    StallReason getReason() const;
+
+    // Measured minus expected encoder counts, and its largest magnitude
+    // since reset(); 0 without an encoder
+    int32_t getFollowingError() const;
+    uint16_t getMaxFollowingError() const;
+
+    // Commanded position in steps
+    int32_t getCommandedPosition() const;
+
+    // Encoder position converted to steps (divides: for status output)
+    int32_t getMeasuredPosition() const;
+
+  private:
+    bool checkFault() const;
+
+    const QuadratureEncoder* _encoder;
+    uint16_t _stepsPerRev;
+    uint16_t _countsPerRev;
+    uint16_t _tolerance;
+    int32_t _countOffset;     // Encoder count at reset()
+    int32_t _positionOffset;  // Commanded position at reset()
+
+    int32_t _commanded;       // Steps
+    int32_t _expected;        // Encoder counts relative to _countOffset
+    uint16_t _fraction;       // Remainder of the step -> count ratio
+    uint16_t _maxError;
+
+    volatile uint8_t* _faultInput;
+    uint8_t _faultMask;
+    bool _faultActiveHigh;
+
+    StallReason _reason;
+};
+
+#endif
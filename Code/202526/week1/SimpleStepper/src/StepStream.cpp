@@ -0,0 +1,287 @@
+/*
+  StepStream.cpp - STEP pulses as a bitstream from a USART in SPI mode
+  Created for Embedded Programming Course, HAN University
+  Version 2.1.0
+  Aug 2025
+*/
+
+#include "StepStream.h"
+#include <math.h>
+
+#if STEP_STREAM_AVAILABLE
+#include <avr/interrupt.h>
+
+#if defined(UDR1)
+#define STREAM_UDR   UDR1
+#define STREAM_UCSRB UCSR1B
+#define STREAM_UCSRC UCSR1C
+#define STREAM_UBRR  UBRR1
+#define STREAM_XCK_BIT 5              // XCK1 is PD5
+#else
+#define STREAM_UDR   UDR0
+#define STREAM_UCSRB UCSR0B
+#define STREAM_UCSRC UCSR0C
+#define STREAM_UBRR  UBRR0
+#define STREAM_XCK_BIT 4              // XCK0 is PD4 (D4 on an Uno)
+#endif
+
+// Bit positions are the same on every USART
+#define STREAM_TXEN  _BV(3)
+#define STREAM_UDRIE _BV(5)
+#define STREAM_MSPIM (_BV(7) | _BV(6))  // UMSELn1:0 = Master SPI, mode 0
+#define STREAM_LSB_FIRST _BV(2)         // UDORDn: slot 0 is bit 0
+
+#define STREAM_LOCK() uint8_t streamSreg = SREG; cli()
+#define STREAM_UNLOCK() SREG = streamSreg
+#else
+#define STREAM_LOCK() ((void)0)
+#define STREAM_UNLOCK() ((void)0)
+#endif
+
+namespace {
+  StepStream* activeStream = nullptr;
+
+  constexpr float Q32 = 4294967296.0f;         // Increments are steps per slot * 2^32
+  constexpr uint32_t MAX_FAST_INCREMENT = 0x1FFFFFFFUL;  // 8 slots added at once cannot wrap twice
+}
+
+StepStream::StepStream()
+  : _motor(nullptr),
+    _slotNanos(2000),
+    _pulseSlots(2),
+    _idle(0),
+    _baud(0),
+    _phase(0),
+    _increment(0),
+    _minIncrement(1),
+    _maxIncrement(1),
+    _acceleration(1),
+    _stepsLeft(0),
+    _rampSteps(0),
+    _pulseLeft(0),
+    _reverse(false),
+    _steps{0, 0},
+    _ready{false, false},
+    _half(0),
+    _index(0),
+    _rendered(false),
+    _running(false),
+    _position(0),
+    _underruns(0),
+    _finished(true) {
+}
+
+bool StepStream::begin(SimpleStepper& motor, uint16_t slotNanos, uint8_t pulseSlots) {
+#if STEP_STREAM_AVAILABLE
+  if (motor.getStepPin() != STEP_STREAM_STEP_PIN || motor.isRunning() || isRunning()) return false;
+  if (slotNanos < MIN_SLOT_NANOS || pulseSlots == 0) return false;
+
+  // One slot is 2 * (UBRR + 1) CPU clocks
+  const uint32_t clocks = (F_CPU / 1000000UL) * slotNanos / 1000UL;
+  if (clocks / 2 > 4096) return false;
+  _baud = (uint16_t)(clocks / 2 - 1);
+  _slotNanos = (uint16_t)(2000UL * (_baud + 1) / (F_CPU / 1000000UL));
+
+  _motor = &motor;
+  _pulseSlots = pulseSlots;
+  _idle = (motor.getSignalLogic() == SignalLogic::ACTIVE_LOW) ? 0xFF : 0x00;
+  activeStream = this;
+  setLimits(MotionLimits());
+  return true;
+#else
+  (void)motor;
+  (void)slotNanos;
+  (void)pulseSlots;
+  return false;
+#endif
+}
+
+// Float work once per change of limits, as MotionPlanner::plan()
+void StepStream::setLimits(const MotionLimits& limits) {
+  const float slot = _slotNanos * 1e-9f;
+  const float maxSpeed = fminf(limits.maxSpeed == 0 ? 1.0f : (float)limits.maxSpeed, (float)getMaxSpeed());
+  const float acceleration = limits.acceleration == 0 ? 1.0f : (float)limits.acceleration;
+
+  _maxIncrement = (uint32_t)(maxSpeed * slot * Q32);
+  _minIncrement = (uint32_t)(fminf(sqrtf(2.0f * acceleration), maxSpeed) * slot * Q32);
+  if (_minIncrement == 0) _minIncrement = 1;
+  if (_maxIncrement < _minIncrement) _maxIncrement = _minIncrement;
+
+  const float perByte = acceleration * 8.0f * slot * slot * Q32;
+  _acceleration = perByte < 1.0f ? 1 : (uint32_t)fminf(perByte, (float)_maxIncrement);
+}
+
+bool StepStream::move(int32_t steps) {
+  if (_motor == nullptr || isRunning()) return false;
+  update();  // End position of the previous move to the motor
+  if (steps == 0) return true;
+
+  _reverse = steps < 0;
+  _motor->setDirection(_reverse ? Direction::COUNTER_CLOCKWISE : Direction::CLOCKWISE);
+  _stepsLeft = _reverse ? (uint32_t)(-(int64_t)steps) : (uint32_t)steps;
+  _rampSteps = 0;
+  _pulseLeft = 0;
+  _phase = 0;
+  _increment = _minIncrement;
+
+  _position = _motor->getPosition();
+  _underruns = 0;
+  _ready[0] = false;
+  _ready[1] = false;
+  _half = 0;
+  _index = 0;
+  _rendered = false;
+  _finished = false;
+  render(0);
+  if (!_rendered) render(1);
+
+  _running = true;
+  startTransmitter();
+  return true;
+}
+
+void StepStream::update() {
+  if (_motor == nullptr || _finished) return;
+  if (!_running) {
+    _motor->setPosition(getPosition());
+    _finished = true;
+    return;
+  }
+
+  // The half the interrupt waits for first, if it is already waiting
+  for (uint8_t i = 0; i < 2 && !_rendered; i++) {
+    const uint8_t half = _half ^ i;
+    if (!_ready[half]) render(half);
+  }
+}
+
+void StepStream::requestStop() {
+  if (_stepsLeft > _rampSteps) _stepsLeft = _rampSteps;
+}
+
+bool StepStream::isRunning() const {
+  return _running;
+}
+
+int32_t StepStream::getPosition() const {
+  STREAM_LOCK();
+  const int32_t position = _position;
+  STREAM_UNLOCK();
+  return position;
+}
+
+uint32_t StepStream::getMaxSpeed() const {
+  return 1000000000UL / (2UL * _pulseSlots * _slotNanos);
+}
+
+uint16_t StepStream::getUnderruns() const {
+  STREAM_LOCK();
+  const uint16_t underruns = _underruns;
+  STREAM_UNLOCK();
+  return underruns;
+}
+
+// One half of the pattern. The rate changes once per byte: up by
+// _acceleration until _maxIncrement, down again once the steps left fit
+// in the distance the ramp up took.
+void StepStream::render(uint8_t half) {
+  uint8_t* out = _buffer[half];
+  uint16_t steps = 0;
+
+  for (uint16_t i = 0; i < STEP_STREAM_BUFFER_BYTES; i++) {
+    if (_stepsLeft == 0 && _pulseLeft == 0) {
+      out[i] = _idle;
+      continue;
+    }
+
+    bool accelerating = false;
+    if (_stepsLeft <= _rampSteps) {
+      _increment = _increment > _minIncrement + _acceleration ? _increment - _acceleration : _minIncrement;
+    } else if (_increment < _maxIncrement) {
+      _increment = _maxIncrement - _increment > _acceleration ? _increment + _acceleration : _maxIncrement;
+      accelerating = true;
+    }
+
+    // No step starts and no pulse continues in this byte: one add
+    if (_pulseLeft == 0 && _increment <= MAX_FAST_INCREMENT) {
+      const uint32_t phase = _phase + (_increment << 3);
+      if (phase >= _phase) {
+        _phase = phase;
+        out[i] = _idle;
+        continue;
+      }
+    }
+
+    uint8_t active = 0;
+    const uint16_t before = steps;
+    for (uint8_t bit = 1; bit != 0; bit <<= 1) {
+      const uint32_t phase = _phase + _increment;
+      if (phase < _phase && _stepsLeft != 0) {
+        _stepsLeft--;
+        steps++;
+        _pulseLeft = _pulseSlots;
+      }
+      _phase = phase;
+      if (_pulseLeft != 0) {
+        active |= bit;
+        _pulseLeft--;
+      }
+    }
+    if (accelerating) _rampSteps += steps - before;
+    out[i] = _idle ^ active;
+  }
+
+  _steps[half] = steps;
+  const bool last = (_stepsLeft == 0 && _pulseLeft == 0);
+  asm volatile("" ::: "memory");  // Pattern written before the interrupt may send it
+  _ready[half] = true;
+  if (last) _rendered = true;
+}
+
+void StepStream::onDataEmpty() {
+  if (activeStream) activeStream->sendNext();
+}
+
+#if STEP_STREAM_AVAILABLE
+
+void StepStream::startTransmitter() {
+  // Master SPI init order: UBRR 0 while the transmitter is enabled, then the rate
+  STREAM_UBRR = 0;
+  DDRD |= _BV(STREAM_XCK_BIT);   // XCK output selects master mode
+  STREAM_UCSRC = STREAM_MSPIM | STREAM_LSB_FIRST;
+  STREAM_UCSRB = STREAM_TXEN;
+  STREAM_UBRR = _baud;
+  STREAM_UCSRB = STREAM_TXEN | STREAM_UDRIE;  // The empty data register asks for the first byte
+}
+
+// Interrupt: the next byte, or idle while update() is late. After the
+// last half the transmitter is switched off once the shift register is
+// empty, and STEP falls back to its port bit (inactive, SimpleStepper).
+void StepStream::sendNext() {
+  const uint8_t half = _half;
+  if (_index == 0 && !_ready[half]) {
+    if (_rendered) {
+      STREAM_UCSRB = 0;
+      _running = false;
+      return;
+    }
+    STREAM_UDR = _idle;
+    _underruns++;
+    return;
+  }
+
+  STREAM_UDR = _buffer[half][_index];
+  if (++_index == STEP_STREAM_BUFFER_BYTES) {
+    _index = 0;
+    _position += _reverse ? -(int32_t)_steps[half] : (int32_t)_steps[half];
+    _ready[half] = false;
+    _half = half ^ 1;
+  }
+}
+
+#else
+
+void StepStream::startTransmitter() {}
+void StepStream::sendNext() {}
+
+#endif
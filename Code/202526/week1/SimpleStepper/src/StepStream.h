@@ -0,0 +1,142 @@
+/*
+  StepStream.h - STEP pulses as a bitstream from a USART in SPI mode
+  Created for Embedded Programming Course, HAN University
+  Version 2.1.0
+  Aug 2025
+
+  Experimental. Above a few tens of kHz a step interrupt per pulse eats
+  the CPU. StepStream instead writes the STEP waveform as bits, one bit
+  per time slot (2 us by default), and lets a USART in Master SPI mode
+  shift them out of its TXD pin. The USART's data register is double
+  buffered, so the stream has no gaps; it raises an interrupt per byte
+  of 8 slots, however many steps the byte holds. AVRs have no DMA: the
+  interrupt copies the next byte from a buffer, nothing else.
+
+  update() (from loop()) renders one half of a double buffer while the
+  interrupt sends the other. The pattern comes from a phase accumulator:
+  every slot adds the rate, every overflow starts a pulse of pulseSlots.
+  The rate follows a trapezoidal ramp of MotionLimits, changed once per
+  byte (MotionPlanner's per-step recurrence would cost more than the
+  step itself here). Bytes without a step edge are one add. Timing is
+  exact to one slot, without interrupt jitter; the fastest step rate is
+  one pulse per 2 * pulseSlots slots: 125 kHz at the defaults,
+  250 kHz with 1-slot pulses (A4988, DRV8825; the TB6600 needs the
+  2 slots of 2 us).
+
+  The STEP pin is the TXD pin of the USART (STEP_STREAM_STEP_PIN):
+  USART1 where there is one (D18 on a Mega, D1 on a Leonardo), else
+  USART0 (D1 on an Uno, which then has no Serial). The library defines
+  no ISR, so it cannot clash with HardwareSerial; the sketch adds
+    ISR(STEP_STREAM_UDRE_vect) { StepStream::onDataEmpty(); }
+  One stream per program: onDataEmpty() is static.
+*/
+
+#ifndef StepStream_h
+#define StepStream_h
+
+#include "Arduino.h"
+#include "SimpleStepper.h"
+#include "MotionPlanner.h"
+
+#if defined(__AVR__) && defined(UDR1)
+#define STEP_STREAM_AVAILABLE 1
+#define STEP_STREAM_UDRE_vect USART1_UDRE_vect
+#if defined(__AVR_ATmega32U4__)
+#define STEP_STREAM_STEP_PIN 1      // TXD1 (PD3)
+#else
+#define STEP_STREAM_STEP_PIN 18     // TXD1 (PD3) on a Mega
+#endif
+#elif defined(__AVR__) && defined(UDR0)
+#define STEP_STREAM_AVAILABLE 1
+#if defined(USART_UDRE_vect)
+#define STEP_STREAM_UDRE_vect USART_UDRE_vect
+#else
+#define STEP_STREAM_UDRE_vect USART0_UDRE_vect
+#endif
+#define STEP_STREAM_STEP_PIN 1      // TXD0 (PD1) on an Uno
+#else
+#define STEP_STREAM_AVAILABLE 0
+#define STEP_STREAM_STEP_PIN 0xFF
+#endif
+
+#ifndef STEP_STREAM_BUFFER_BYTES
+#define STEP_STREAM_BUFFER_BYTES 128   // Per half: 2 ms at 2 us slots
+#endif
+
+class StepStream {
+  public:
+    static constexpr uint16_t MIN_SLOT_NANOS = 1000;  // The ISR must keep up with a byte per 8 slots
+
+    StepStream();
+
+    // Take over the USART for motor, whose STEP pin must be
+    // STEP_STREAM_STEP_PIN. false on another pin, a slot shorter than
+    // MIN_SLOT_NANOS or one the USART clock cannot make.
+    bool begin(SimpleStepper& motor, uint16_t slotNanos = 2000, uint8_t pulseSlots = 2);
+
+    // maxSpeed is capped at getMaxSpeed(); profile and jerk are ignored
+    // (always trapezoidal)
+    void setLimits(const MotionLimits& limits);
+
+    // Relative move, positive CLOCKWISE; renders the first two halves
+    // and starts the stream. false while running.
+    bool move(int32_t steps);
+
+    // Call often from loop(): renders a half that was sent, within
+    // STEP_STREAM_BUFFER_BYTES * 8 slots, and hands the end position to
+    // the motor when the move is done
+    void update();
+
+    // Decelerate to standstill from the speed reached
+    void requestStop();
+
+    bool isRunning() const;
+
+    // Steps of the halves sent so far: exact once the move is done
+    int32_t getPosition() const;
+
+    uint32_t getMaxSpeed() const;  // Steps/s at one pulse per 2 * pulseSlots slots
+
+    // Idle bytes of the last move sent because update() had not rendered
+    // the next half in time; each one stretched the move by 8 slots
+    uint16_t getUnderruns() const;
+
+    // Interrupt service; called from the sketch's ISR(STEP_STREAM_UDRE_vect)
+    static void onDataEmpty();
+
+  private:
+    void render(uint8_t half);
+    void startTransmitter();
+    void sendNext();
+
+    SimpleStepper* _motor;
+    uint16_t _slotNanos;
+    uint8_t _pulseSlots;
+    uint8_t _idle;               // Byte with STEP inactive in every slot
+    uint16_t _baud;              // UBRR of the slot
+
+    // Pattern state (loop() only)
+    uint32_t _phase;             // Fraction of a step, overflows at a step
+    uint32_t _increment;         // Steps per slot, Q0.32
+    uint32_t _minIncrement;      // Speed after the first step: start and end of a move
+    uint32_t _maxIncrement;
+    uint32_t _acceleration;      // Increment change per byte
+    uint32_t _stepsLeft;         // Still to render
+    uint32_t _rampSteps;         // Rendered while accelerating: the braking distance
+    uint8_t _pulseLeft;          // Active slots still to render
+    bool _reverse;
+
+    // Shared with the interrupt
+    uint8_t _buffer[2][STEP_STREAM_BUFFER_BYTES];
+    volatile uint16_t _steps[2]; // Steps in each half
+    volatile bool _ready[2];     // Rendered, not yet sent
+    volatile uint8_t _half;      // Half being sent
+    volatile uint16_t _index;    // Next byte in it
+    volatile bool _rendered;     // Last step rendered: stop at the next empty half
+    volatile bool _running;
+    volatile int32_t _position;
+    volatile uint16_t _underruns;
+    bool _finished;              // Position handed to the motor
+};
+
+#endif
@@ -0,0 +1,97 @@
+/*
+  StepTimer.cpp - Shared step tick for SimpleStepper
+  Created for Embedded Programming Course, HAN University
+  Version 2.1.0
+  Aug 2025
+*/
+
+#include "StepTimer.h"
+
+#if STEP_TIMER_AVAILABLE
+#include <avr/interrupt.h>
+#endif
+
+#if defined(TRACE_RECORDER_ENABLED)
+#include <TraceRecorder.h>
+#else
+#define TRACE_BEGIN(event, arg) ((void)0)
+#define TRACE_END(event, arg) ((void)0)
+#endif
+
+StepTimer::Handler StepTimer::_handlers[STEP_TIMER_MAX_HANDLERS] = {nullptr};
+uint8_t StepTimer::_count = 0;
+
+bool StepTimer::attach(Handler handler) {
+#if STEP_TIMER_AVAILABLE
+  for (uint8_t i = 0; i < _count; i++) {
+    if (_handlers[i] == handler) return true;
+  }
+  if (_count >= STEP_TIMER_MAX_HANDLERS) return false;
+
+  uint8_t sreg = SREG;
+  cli();
+  _handlers[_count++] = handler;
+  SREG = sreg;
+
+  if (_count == 1) start();
+  return true;
+#else
+  (void)handler;
+  return false;
+#endif
+}
+
+void StepTimer::detach(Handler handler) {
+#if STEP_TIMER_AVAILABLE
+  uint8_t sreg = SREG;
+  cli();
+  for (uint8_t i = 0; i < _count; i++) {
+    if (_handlers[i] == handler) {
+      _handlers[i] = _handlers[--_count];  // Order does not matter
+      break;
+    }
+  }
+  SREG = sreg;
+
+  if (_count == 0) stop();
+#else
+  (void)handler;
+#endif
+}
+
+void StepTimer::tick() {
+  for (uint8_t i = 0; i < _count; i++) {
+    _handlers[i]();
+  }
+}
+
+#if STEP_TIMER_AVAILABLE
+
+void StepTimer::start() {
+  uint8_t sreg = SREG;
+  cli();
+  TCCR1A = 0;
+  TCCR1B = _BV(WGM12) | _BV(CS11);  // CTC, prescaler 8
+  TCNT1 = 0;
+  OCR1A = (F_CPU / 8 / 1000000UL) * STEP_TIMER_TICK_MICROS - 1;
+  TIMSK1 |= _BV(OCIE1A);
+  SREG = sreg;
+}
+
+void StepTimer::stop() {
+  TIMSK1 &= ~_BV(OCIE1A);
+  TCCR1B = 0;
+}
+
+ISR(TIMER1_COMPA_vect) {
+  TRACE_BEGIN(TraceRecorder::EV_STEP_TICK, 0);
+  StepTimer::tick();
+  TRACE_END(TraceRecorder::EV_STEP_TICK, 0);
+}
+
+#else
+
+void StepTimer::start() {}
+void StepTimer::stop() {}
+
+#endif
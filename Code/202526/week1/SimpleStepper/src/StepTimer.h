@@ -0,0 +1,50 @@
+/*
+  StepTimer.h - Shared step tick for SimpleStepper
+  Created for Embedded Programming Course, HAN University
+  Version 2.1.0
+  Aug 2025
+
+  Timer1 in CTC mode interrupts every STEP_TIMER_TICK_MICROS and calls
+  every attached handler, so several motors share one interrupt.
+  Note: takes over Timer1 (Servo library, PWM on D9/D10 on an Uno).
+*/
+
+#ifndef StepTimer_h
+#define StepTimer_h
+
+#include "Arduino.h"
+
+#if defined(__AVR__)
+#define STEP_TIMER_AVAILABLE 1
+#else
+#define STEP_TIMER_AVAILABLE 0
+#endif
+
+#ifndef STEP_TIMER_TICK_MICROS
+#define STEP_TIMER_TICK_MICROS 50   // 20 kHz tick, max 10 kHz step rate
+#endif
+#define STEP_TIMER_MAX_HANDLERS 4
+
+class StepTimer {
+  public:
+    using Handler = void (*)();
+
+    // Register a tick handler (runs in the ISR); starts the timer.
+    // Attaching the same handler twice is a no-op.
+    static bool attach(Handler handler);
+    static void detach(Handler handler);
+
+    static bool isAvailable() { return STEP_TIMER_AVAILABLE; }
+
+    // Called by the Timer1 compare interrupt
+    static void tick();
+
+  private:
+    static void start();
+    static void stop();
+
+    static Handler _handlers[STEP_TIMER_MAX_HANDLERS];
+    static uint8_t _count;
+};
+
+#endif
@@ -0,0 +1,190 @@
+/*
+ * Step Pulse Benchmark - probe for the stepper variants
+ * Runs on a SECOND Arduino Uno/Nano, wired to the STEP output of the
+ * board under test (DUT), so the DUT keeps all its timers.
+ *
+ * - Timer1 input capture (ICP1 = D8) timestamps every rising STEP edge
+ *   at 62.5 ns (prescaler 1); overflows extend the stamps to 32 bits
+ * - INT0 (D2) counts edges of an optional DUT heartbeat pin: a pin the
+ *   DUT toggles once per main loop pass shows how much CPU is left
+ * - Every window (WINDOW_MS) one CSV line with step count, interval
+ *   min/max/mean and jitter; step_bench.py turns them into a report
+ *
+ * Wiring: DUT STEP -> D8, DUT heartbeat (optional) -> D2, GND -> GND.
+ * The TB6600 may stay connected: D8 is a high-impedance input.
+ * The statistics cost the probe about 30 us per step, so it follows up
+ * to roughly 30 kHz; above that the overruns column counts lost edges.
+ *
+ * v1.0 - Sep 2025
+ * Embedded Programming (Prog 5/6)
+ */
+
+// === CONFIGURATION ===
+#define WINDOW_MS 100         // Report period
+#define CAPTURE_BUFFER 128    // Intervals waiting for loop(), power of two
+
+// Line format, printed once after reset
+const char CSV_HEADER[] PROGMEM =
+  "WIN,ms,steps,min_ticks,max_ticks,mean_ticks,jitter_rms_ticks,jitter_max_ticks,heartbeats,overruns";
+
+// === CAPTURE (ISR side) ===
+volatile uint16_t overflowCount = 0;   // Upper 16 bits of the time stamps
+volatile uint32_t lastEdge = 0;
+volatile bool haveEdge = false;
+
+volatile uint32_t intervals[CAPTURE_BUFFER];
+volatile uint8_t captureHead = 0;      // Written by the ISR
+volatile uint8_t captureTail = 0;      // Written by loop()
+volatile uint16_t overruns = 0;        // Intervals lost: loop() fell behind
+
+volatile uint16_t heartbeats = 0;
+
+ISR(TIMER1_OVF_vect) {
+  overflowCount++;
+}
+
+// Rising STEP edge: ICR1 holds the timer value of the edge itself, so
+// ISR latency does not show up in the measurement
+ISR(TIMER1_CAPT_vect) {
+  uint16_t captured = ICR1;
+  uint16_t high = overflowCount;
+  // Overflow pending that happened before the edge: count it here
+  if ((TIFR1 & _BV(TOV1)) && captured < 0x8000) {
+    high++;
+  }
+  uint32_t stamp = ((uint32_t)high << 16) | captured;
+
+  if (haveEdge) {
+    uint8_t next = (captureHead + 1) & (CAPTURE_BUFFER - 1);
+    if (next != captureTail) {
+      intervals[captureHead] = stamp - lastEdge;
+      captureHead = next;
+    } else {
+      overruns++;
+    }
+  }
+  lastEdge = stamp;
+  haveEdge = true;
+}
+
+ISR(INT0_vect) {
+  heartbeats++;
+}
+
+// === STATISTICS (loop side) ===
+struct WindowStats {
+  uint32_t steps;
+  uint32_t minTicks;
+  uint32_t maxTicks;
+  uint64_t sumTicks;
+  float sumJitterSquared;   // Successive interval differences
+  uint32_t maxJitter;
+  uint32_t previous;        // Last interval, 0 = none yet
+};
+
+WindowStats stats;
+unsigned long windowStart = 0;
+
+void resetStats() {
+  uint32_t previous = stats.previous;  // Jitter runs on across windows
+  memset(&stats, 0, sizeof(stats));
+  stats.minTicks = 0xFFFFFFFFUL;
+  stats.previous = previous;
+}
+
+void addInterval(uint32_t ticks) {
+  stats.steps++;
+  if (ticks < stats.minTicks) stats.minTicks = ticks;
+  if (ticks > stats.maxTicks) stats.maxTicks = ticks;
+  stats.sumTicks += ticks;
+
+  if (stats.previous != 0) {
+    uint32_t jitter = ticks > stats.previous ? ticks - stats.previous : stats.previous - ticks;
+    if (jitter > stats.maxJitter) stats.maxJitter = jitter;
+    stats.sumJitterSquared += (float)jitter * jitter;
+  }
+  stats.previous = ticks;
+}
+
+void drainCaptures() {
+  while (captureTail != captureHead) {
+    uint8_t tail = captureTail;
+    uint32_t ticks = intervals[tail];  // The ISR does not write this slot until the tail moves
+    captureTail = (tail + 1) & (CAPTURE_BUFFER - 1);
+    addInterval(ticks);
+  }
+}
+
+void reportWindow(unsigned long now) {
+  noInterrupts();
+  uint16_t beats = heartbeats;
+  heartbeats = 0;
+  uint16_t lost = overruns;
+  overruns = 0;
+  interrupts();
+
+  // A pause longer than the window breaks the jitter chain
+  if (stats.steps == 0) stats.previous = 0;
+
+  uint32_t jitterSamples = stats.steps > 1 ? stats.steps - 1 : 0;
+  Serial.print(F("WIN,"));
+  Serial.print(now);
+  Serial.print(',');
+  Serial.print(stats.steps);
+  Serial.print(',');
+  Serial.print(stats.steps ? stats.minTicks : 0);
+  Serial.print(',');
+  Serial.print(stats.maxTicks);
+  Serial.print(',');
+  Serial.print(stats.steps ? (uint32_t)(stats.sumTicks / stats.steps) : 0);
+  Serial.print(',');
+  Serial.print(jitterSamples ? sqrt(stats.sumJitterSquared / jitterSamples) : 0.0f, 1);
+  Serial.print(',');
+  Serial.print(stats.maxJitter);
+  Serial.print(',');
+  Serial.print(beats);
+  Serial.print(',');
+  Serial.println(lost);
+}
+
+// === SETUP ===
+void initCapture() {
+  pinMode(8, INPUT);             // ICP1
+  TCCR1A = 0;                    // Normal mode, free running
+  TCCR1B = _BV(ICNC1) | _BV(ICES1) | _BV(CS10);  // Noise canceler, rising edge, prescaler 1
+  TCNT1 = 0;
+  TIFR1 = _BV(ICF1) | _BV(TOV1);
+  TIMSK1 = _BV(ICIE1) | _BV(TOIE1);
+}
+
+void initHeartbeat() {
+  pinMode(2, INPUT_PULLUP);      // INT0; the pull-up keeps it quiet when nothing is wired
+  EICRA = _BV(ISC00);            // Any change
+  EIFR = _BV(INTF0);
+  EIMSK = _BV(INT0);
+}
+
+void setup() {
+  Serial.begin(115200);
+  char header[sizeof(CSV_HEADER)];
+  strcpy_P(header, CSV_HEADER);
+  Serial.println(header);
+
+  // Timer0 stays on for millis(); its ISR only delays the capture ISR,
+  // the captured time stamps are exact
+  initCapture();
+  initHeartbeat();
+  resetStats();
+  windowStart = millis();
+}
+
+void loop() {
+  drainCaptures();
+
+  unsigned long now = millis();
+  if (now - windowStart >= WINDOW_MS) {
+    windowStart += WINDOW_MS;
+    reportWindow(now);
+    resetStats();
+  }
+}
@@ -0,0 +1,176 @@
+#!/usr/bin/env python3
+"""
+Benchmarks the stepper variants from the STEP edges captured by the
+StepBenchmark probe sketch.
+
+For every variant: flash it on the board under test (by hand, or with
+--upload through arduino-cli), let it run, and read the probe's window
+lines. The report gives per variant:
+
+  peak rate       highest step rate of one window (steps/s)
+  sustained rate  highest rate held within 2 % for --hold seconds
+  jitter          RMS and worst change between successive intervals
+                  at the sustained rate (microseconds)
+  headroom        heartbeat rate while stepping / heartbeat rate at
+                  rest, when the variant toggles a heartbeat pin
+
+Embedded Programming (Prog 5/6)
+v1.0
+Sep 2025
+
+Usage: python3 step_bench.py --probe /dev/ttyUSB1 [--upload /dev/ttyACM0] [variant ...]
+"""
+
+import argparse
+import os
+import statistics
+import subprocess
+import sys
+import time
+
+TICKS_PER_US = 16          # Probe Timer1 at 16 MHz, prescaler 1
+WINDOW_S = 0.1             # WINDOW_MS of the probe
+STABLE = 0.02              # Sustained: every window within 2 % of the first
+
+WEEK1 = os.path.normpath(os.path.join(os.path.dirname(os.path.abspath(__file__)), ".."))
+
+# name -> sketch directory relative to week1 (None: build by hand)
+VARIANTS = {
+    "1a": "stepper_code_example_1a",
+    "1b": "stepper_code_example_1b",
+    "1c": "stepper_code_example_1c",
+    "1d": "stepper_code_example_1d",
+    "1e": "stepper_code_example_1e",
+    "1f": "stepper_code_example_1f",
+    "1g": "stepper_code_example_1g",
+    "SimpleStepper": "SimpleStepper/examples/AsyncMotion",
+    "stepper_library": None,   # avr-gcc, see stepper_library/README.md
+    "demo_version_v1": "Functional/demo_version_v1",
+}
+
+
+def flash(name, port, fqbn):
+    sketch = VARIANTS[name]
+    if port is None or sketch is None:
+        input("Flash %s on the board under test, start it, then press Enter " % name)
+        return
+    path = os.path.join(WEEK1, sketch)
+    cmd = ["arduino-cli", "compile", "--upload", "-p", port, "--fqbn", fqbn,
+           "--library", os.path.join(WEEK1, "SimpleStepper"), path]
+    print("Uploading %s ..." % name)
+    if subprocess.call(cmd) != 0:
+        raise SystemExit("upload of %s failed" % name)
+
+
+def read_windows(probe, seconds):
+    """Window lines of the probe for seconds, as dicts"""
+    probe.reset_input_buffer()
+    header = None
+    windows = []
+    end = time.time() + seconds
+    while time.time() < end:
+        line = probe.readline().decode("ascii", "replace").strip()
+        if line.startswith("WIN,ms"):
+            header = line.split(",")
+            continue
+        if not line.startswith("WIN,"):
+            continue
+        fields = line.split(",")
+        if header is None:
+            header = ["WIN", "ms", "steps", "min_ticks", "max_ticks", "mean_ticks",
+                      "jitter_rms_ticks", "jitter_max_ticks", "heartbeats", "overruns"]
+        try:
+            windows.append({k: float(v) for k, v in zip(header[1:], fields[1:])})
+        except ValueError:
+            pass   # Line cut by the start of the read
+    return windows
+
+
+def sustained(windows, hold):
+    """Highest rate that stays within STABLE for hold seconds, and its windows"""
+    need = max(1, int(round(hold / WINDOW_S)))
+    best, best_run = 0.0, []
+    for i in range(len(windows) - need + 1):
+        run = windows[i:i + need]
+        base = run[0]["steps"]
+        if base == 0 or any(w["overruns"] for w in run):
+            continue
+        if all(abs(w["steps"] - base) <= STABLE * base for w in run):
+            rate = sum(w["steps"] for w in run) / (need * WINDOW_S)
+            if rate > best:
+                best, best_run = rate, run
+    return best, best_run
+
+
+def analyse(windows, hold):
+    moving = [w for w in windows if w["steps"] > 0]
+    if not moving:
+        return None
+    result = {
+        "peak": max(w["steps"] for w in moving if not w["overruns"]) / WINDOW_S
+        if any(not w["overruns"] for w in moving) else 0.0,
+        "overruns": sum(w["overruns"] for w in windows),
+    }
+    rate, run = sustained(windows, hold)
+    result["sustained"] = rate
+    cruise = run or moving
+    result["jitter_rms"] = statistics.median(w["jitter_rms_ticks"] for w in cruise) / TICKS_PER_US
+    result["jitter_max"] = max(w["jitter_max_ticks"] for w in cruise) / TICKS_PER_US
+
+    idle = [w["heartbeats"] for w in windows if w["steps"] == 0]
+    busy = [w["heartbeats"] for w in cruise]
+    if idle and statistics.mean(idle) > 0:
+        result["headroom"] = 100.0 * statistics.mean(busy) / statistics.mean(idle)
+    else:
+        result["headroom"] = None
+    return result
+
+
+def print_report(results):
+    print()
+    print("| Variant | Peak (steps/s) | Sustained (steps/s) | Jitter RMS (us) | Jitter max (us) | Headroom |")
+    print("|---|---:|---:|---:|---:|---:|")
+    for name, r in results:
+        if r is None:
+            print("| %s | no steps | | | | |" % name)
+            continue
+        headroom = "n/a" if r["headroom"] is None else "%.0f %%" % r["headroom"]
+        note = " (probe overruns: %d)" % r["overruns"] if r["overruns"] else ""
+        print("| %s%s | %.0f | %.0f | %.2f | %.2f | %s |"
+              % (name, note, r["peak"], r["sustained"], r["jitter_rms"], r["jitter_max"], headroom))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("variants", nargs="*", default=list(VARIANTS),
+                        help="variants to run (default: all)")
+    parser.add_argument("--probe", required=True, help="serial port of the probe board")
+    parser.add_argument("--upload", metavar="PORT", help="flash the variants with arduino-cli")
+    parser.add_argument("--fqbn", default="arduino:avr:uno")
+    parser.add_argument("--seconds", type=float, default=10.0, help="capture time per variant")
+    parser.add_argument("--hold", type=float, default=0.5, help="seconds a sustained rate must hold")
+    parser.add_argument("--settle", type=float, default=1.0, help="seconds skipped after flashing")
+    args = parser.parse_args()
+
+    unknown = [v for v in args.variants if v not in VARIANTS]
+    if unknown:
+        parser.error("unknown variant(s): %s (known: %s)" % (", ".join(unknown), ", ".join(VARIANTS)))
+
+    try:
+        import serial
+    except ImportError:
+        raise SystemExit("pyserial is needed: pip install pyserial")
+    probe = serial.Serial(args.probe, 115200, timeout=0.5)
+    results = []
+    for name in args.variants:
+        flash(name, args.upload, args.fqbn)
+        time.sleep(args.settle)
+        windows = read_windows(probe, args.seconds)
+        if not windows:
+            print("No data from the probe on %s" % args.probe, file=sys.stderr)
+        results.append((name, analyse(windows, args.hold)))
+    print_report(results)
+
+
+if __name__ == "__main__":
+    main()
@@ -6,6 +6,10 @@
  * Low level embedded code - structured C
  * v1.0
  * Aug 2025
+ * v1.1 - Step pulses from Timer1 output compare (OC1A toggle):
+ *   edges and pulse width come from hardware, the compare ISR only
+ *   loads the next interval planned by the main loop
+ *   (STEP moves from D7 to D9 / PB1, the OC1A pin)
  * Embedded Programming (Prog 5/6)
  * johan.korten@han.nl
  * MIC2 Style
@@ -13,12 +17,12 @@
 
 #include <avr/io.h>
 #include <avr/interrupt.h>
-#include <util/delay.h>
 
 // --- Pin definitions (ATmega328P) ---
-// Arduino Pin 7 = PD7, Arduino Pin 6 = PD6, Arduino Pin 5 = PD5
-#define STEP_PIN    7  // PD7 - TB6600 PUL
-#define DIR_PIN     6  // PD6 - TB6600 DIR  
+// STEP must be on OC1A: Timer1 drives that pin directly
+// Arduino Pin 9 = PB1, Arduino Pin 6 = PD6, Arduino Pin 5 = PD5
+#define STEP_PIN    1  // PB1 / OC1A - TB6600 PUL (was D7 with software pulses)
+#define DIR_PIN     6  // PD6 - TB6600 DIR
 #define EN_PIN      5  // PD5 - TB6600 ENA
 
 #define STEP_MASK   (1 << STEP_PIN)
@@ -47,10 +51,40 @@
 #define ACCEL_STEP_SIZE     100
 #define DECEL_MULTIPLIER    5
 
+// --- Hardware step engine ---
+// Every compare match toggles OC1A: one match raises STEP, the next one
+// lowers it again, so the pulse width is exact whatever the main loop does.
+// Timer1 runs free (normal mode): each new compare value is the previous
+// one plus an interval, so ISR latency does not shift the edges.
+#define PULSE_TICKS         US_TO_TICKS(5)   // STEP high time (TB6600 needs >= 2.2µs)
+#define MIN_STEP_TICKS      US_TO_TICKS(20)  // 50 kHz: both ISRs fit with room to spare
+#define START_LEAD_TICKS    US_TO_TICKS(20)  // First edge this long after starting
+
+// Planned steps waiting for the ISR (power of two)
+#define STEP_QUEUE_SIZE     16
+#define STEP_QUEUE_MASK     (STEP_QUEUE_SIZE - 1)
+
+typedef struct {
+    uint16_t ticks;     // From the previous step's rising edge to this one
+    uint8_t reverse;    // DIR level for this step
+} PlannedStep;
+
 // --- Motion state variables ---
-volatile long currentPosition = 0;
-volatile long targetPosition = STEPS_PER_REV;
-volatile uint16_t currentStepInterval = TARGET_STEP_TICKS * 10; // start slow
+// Planner (main loop): where the motor will be once the queue has run
+long plannedPosition = 0;
+long targetPosition = STEPS_PER_REV;
+uint16_t currentStepInterval = TARGET_STEP_TICKS * 10; // start slow
+
+// Step engine (ISR)
+volatile long currentPosition = 0;  // Steps actually made
+volatile uint8_t engineRunning = 0;
+volatile uint8_t stepHigh = 0;      // OC1A level after the last toggle
+volatile uint8_t stepReverse = 0;   // Direction of the step being made
+volatile uint16_t lastRisingEdge;   // Timer1 time of the last STEP rise
+
+PlannedStep stepQueue[STEP_QUEUE_SIZE];
+volatile uint8_t queueHead = 0;  // Written by the planner
+volatile uint8_t queueTail = 0;  // Written by the ISR
 
 // --- Function prototypes ---
 // Hardware initialization
@@ -59,27 +93,29 @@ void initPorts(void);
 void initTimer1(void);
 void enableInterrupts(void);
 
-// Motion control
+// Motion control (planner)
 void executeMotionControl(void);
-uint8_t isTimeForNextStep(uint16_t currentTime, uint16_t *lastStepTime);
-void executeStepSequence(uint16_t currentTime, uint16_t *lastStepTime);
+void planNextStep(void);
+void queueStep(void);
 void handleTargetReached(void);
 
-// Position management  
-void updatePosition(void);
+// Position management
 uint8_t hasReachedTarget(void);
 void reverseDirection(void);
 long calculateNewTarget(void);
+uint8_t isMovingForward(void);
 
-// Step generation
-void makeStep(void);
-void generateStepPulse(void);
+// Step queue
+uint8_t isQueueFull(void);
+
+// Step engine (Timer1 / OC1A)
+uint8_t loadNextStep(uint16_t edgeTime);
+void startStepEngine(void);
+void stopStepEngine(void);
 
 // Direction control
-void updateDirection(void);
 void setDirectionForward(void);
 void setDirectionReverse(void);
-uint8_t isMovingForward(void);
 
 // Speed/acceleration control
 void handleAcceleration(void);
@@ -88,9 +124,7 @@ uint8_t canAccelerate(void);
 void resetSpeedForDirectionChange(void);
 
 // Timing utilities
-void delayMicroseconds(uint16_t us);
 uint16_t getTimer1(void);
-uint16_t getTimeDifference(uint16_t current, uint16_t previous);
 
 // System utilities
 void initializeMotionParameters(void);
@@ -99,12 +133,14 @@ void performSystemSetup(void);
 int main(void) {
     // Initialize all systems
     performSystemSetup();
-    
+
     // Main control loop
     while(1) {
         executeMotionControl();
+        // Anything else can run here: it only has to come back before
+        // the queued steps (16 x the step interval) have run out
     }
-    
+
     return 0;
 }
 
@@ -123,10 +159,11 @@ void initializeHardware(void) {
 
 void initPorts(void) {
     // Set pins as outputs (Data Direction Register)
-    DDRD |= (STEP_MASK | DIR_MASK | EN_MASK);
-    
+    DDRB |= STEP_MASK;
+    DDRD |= (DIR_MASK | EN_MASK);
+
     // Initialize pin states
-    PORTD &= ~STEP_MASK;  // STEP low
+    PORTB &= ~STEP_MASK;  // STEP low while Timer1 is not driving it
     PORTD &= ~DIR_MASK;   // DIR low (forward)
     PORTD |= EN_MASK;     // EN high (enable driver)
 }
@@ -134,7 +171,7 @@ void initPorts(void) {
 void initTimer1(void) {
     // Timer1: 16-bit timer, prescaler = 8, normal mode
     // This gives us 0.5µs resolution at 16MHz
-    TCCR1A = 0x00;  // Normal mode
+    TCCR1A = 0x00;  // Normal mode, OC1A disconnected until the first step
     TCCR1B = 0x02;  // Prescaler = 8 (CS11 = 1)
     TCNT1 = 0;      // Reset counter
 }
@@ -144,56 +181,55 @@ void enableInterrupts(void) {
 }
 
 void initializeMotionParameters(void) {
+    plannedPosition = 0;
     currentPosition = 0;
     targetPosition = STEPS_PER_REV;
     currentStepInterval = TARGET_STEP_TICKS * 10;
-    updateDirection();
 }
 
 // === MAIN MOTION CONTROL ===
 
+// Keep the queue filled; the step engine takes the steps from there
 void executeMotionControl(void) {
-    static uint16_t lastStepTime = 0;
-    uint16_t currentTime = getTimer1();
-    
-    if (isTimeForNextStep(currentTime, &lastStepTime)) {
-        if (hasReachedTarget()) {
-            handleTargetReached();
-        } else {
-            executeStepSequence(currentTime, &lastStepTime);
-        }
+    while (!isQueueFull()) {
+        planNextStep();
     }
-}
 
-uint8_t isTimeForNextStep(uint16_t currentTime, uint16_t *lastStepTime) {
-    return (getTimeDifference(currentTime, *lastStepTime) >= currentStepInterval);
+    if (!engineRunning) {
+        startStepEngine();
+    }
 }
 
-void executeStepSequence(uint16_t currentTime, uint16_t *lastStepTime) {
-    makeStep();
-    *lastStepTime = currentTime;
-    updatePosition();
+void planNextStep(void) {
+    if (hasReachedTarget()) {
+        handleTargetReached();
+    }
+    queueStep();
     handleAcceleration();
 }
 
+void queueStep(void) {
+    PlannedStep *step = &stepQueue[queueHead];
+    step->ticks = currentStepInterval;
+    step->reverse = !isMovingForward();
+
+    if (isMovingForward()) {
+        plannedPosition++;
+    } else {
+        plannedPosition--;
+    }
+    queueHead = (queueHead + 1) & STEP_QUEUE_MASK;  // Publish after filling in
+}
+
 void handleTargetReached(void) {
     reverseDirection();
     resetSpeedForDirectionChange();
-    updateDirection();
 }
 
 // === POSITION MANAGEMENT ===
 
-void updatePosition(void) {
-    if (isMovingForward()) {
-        currentPosition++;
-    } else {
-        currentPosition--;
-    }
-}
-
 uint8_t hasReachedTarget(void) {
-    return (currentPosition == targetPosition);
+    return (plannedPosition == targetPosition);
 }
 
 void reverseDirection(void) {
@@ -201,38 +237,95 @@ void reverseDirection(void) {
 }
 
 long calculateNewTarget(void) {
-    return -currentPosition; // ping-pong motion
+    return -plannedPosition; // ping-pong motion
 }
 
 uint8_t isMovingForward(void) {
-    return (targetPosition > currentPosition);
+    return (targetPosition > plannedPosition);
 }
 
-// === STEP GENERATION ===
+// === STEP QUEUE ===
 
-void makeStep(void) {
-    generateStepPulse();
+// One slot stays free to tell full from empty
+uint8_t isQueueFull(void) {
+    return ((queueHead + 1) & STEP_QUEUE_MASK) == queueTail;
 }
 
-void generateStepPulse(void) {
-    // Generate step pulse - TB6600 steps on rising edge
-    PORTD |= STEP_MASK;   // STEP high
-    delayMicroseconds(5); // Minimum pulse width for TB6600
-    PORTD &= ~STEP_MASK;  // STEP low
-    delayMicroseconds(5); // Minimum low time
-}
+// === STEP ENGINE ===
 
-// === DIRECTION CONTROL ===
+// Take the next planned step: DIR now, rising edge at edgeTime
+// Returns 0 when the planner has nothing queued
+uint8_t loadNextStep(uint16_t edgeTime) {
+    uint8_t tail = queueTail;
+    if (tail == queueHead) {
+        return 0;
+    }
 
-void updateDirection(void) {
-    if (isMovingForward()) {
+    PlannedStep *step = &stepQueue[tail];
+    stepReverse = step->reverse;
+    if (stepReverse) {
+        setDirectionReverse();   // At least 15µs before the rising edge,
+    } else {                     // TB6600 DIR setup time is 5µs
         setDirectionForward();
+    }
+    OCR1A = edgeTime;
+    queueTail = (tail + 1) & STEP_QUEUE_MASK;
+    return 1;
+}
+
+void startStepEngine(void) {
+    cli();
+    // OC1A is low (reset state, or stopped after a falling edge),
+    // so the first match raises STEP
+    if (loadNextStep(getTimer1() + START_LEAD_TICKS)) {
+        lastRisingEdge = OCR1A;
+        stepHigh = 0;
+        TIFR1 = (1 << OCF1A);       // Clear a stale match
+        TCCR1A = (1 << COM1A0);     // Toggle OC1A on compare match
+        TIMSK1 |= (1 << OCIE1A);
+        engineRunning = 1;
+    }
+    sei();
+}
+
+// Called from the ISR after a falling edge: STEP is low
+void stopStepEngine(void) {
+    TIMSK1 &= ~(1 << OCIE1A);
+    TCCR1A = 0x00;              // PORTB (low) drives the pin again
+    engineRunning = 0;
+}
+
+// Every OC1A toggle: schedule the other edge. No planning here, only a
+// queue read, so the ISR is short and the edges stay on the timer grid
+// (each compare value is computed from the previous one, not from now).
+ISR(TIMER1_COMPA_vect) {
+    stepHigh = !stepHigh;
+
+    if (stepHigh) {
+        // Rising edge: the step is made, end the pulse
+        if (stepReverse) {
+            currentPosition--;
+        } else {
+            currentPosition++;
+        }
+        OCR1A = lastRisingEdge + PULSE_TICKS;
+        return;
+    }
+
+    // Falling edge: the next rising edge one interval after the last one
+    uint16_t ticks = stepQueue[queueTail].ticks;
+    if (ticks < MIN_STEP_TICKS) {
+        ticks = MIN_STEP_TICKS;
+    }
+    if (loadNextStep(lastRisingEdge + ticks)) {
+        lastRisingEdge = OCR1A;
     } else {
-        setDirectionReverse();
+        stopStepEngine();       // Planner fell behind: stop, STEP low
     }
-    delayMicroseconds(20);   // Direction setup time for TB6600
 }
 
+// === DIRECTION CONTROL ===
+
 void setDirectionForward(void) {
     PORTD &= ~DIR_MASK;  // DIR low = forward
 }
@@ -266,28 +359,12 @@ void resetSpeedForDirectionChange(void) {
 
 // === TIMING UTILITIES ===
 
-void delayMicroseconds(uint16_t us) {
-    // For small delays, use cycle counting
-    // At 16MHz: 16 cycles = 1µs
-    if (us == 0) return;
-    
-    // This is approximate - for exact timing, use timer-based delays
-    while (us--) {
-        _delay_us(1);
-    }
-}
-
 uint16_t getTimer1(void) {
     // Return current Timer1 value (16-bit)
     // Each tick = 0.5µs at 16MHz with prescaler 8
     return TCNT1;
 }
 
-uint16_t getTimeDifference(uint16_t current, uint16_t previous) {
-    // Handle 16-bit timer overflow correctly
-    return (uint16_t)(current - previous);
-}
-
 /*
  * Compilation command:
  * avr-gcc -mmcu=atmega328p -DF_CPU=16000000UL -Os -o stepper.elf stepper.c
@@ -8,6 +8,16 @@
  * - Target position for syringe compression
  * - Return to origin for syringe release
  * - Complete cycle automation
+ * v6.1 - Acceleration planned by MotionPlanner (SimpleStepper library):
+ *   trapezoidal ramps that end exactly at the target
+ * v6.2 - QUEUE n: targets queued ahead (MotionQueue look-ahead), moves
+ *   in the same direction run through without stopping
+ * v6.3 - LimitManager composed at compile time (no virtual call per step);
+ *   steps to the nearest software limit are precomputed and the sensor is
+ *   only read after a pin-change interrupt
+ * v6.4 - Two-phase homing: fast approach while the pin-change interrupt
+ *   latches the position at the sensor edge (EdgeCapture), decelerate,
+ *   back off, slow second approach for the zero point
  * 
  * Sep 2025
  * Embedded Programming (Prog 5/6)
@@ -15,12 +25,16 @@
  * SOLID Principles Applied with State Pattern
  */
 
+#include <MotionPlanner.h>
+#include <MotionQueue.h>
+#include <EdgeCapture.h>
+
 // Forward declarations
 class ILimit;
 class ILimitResponse;
 class StepperMotor;
 class MotionProfile;
-class MotionController;
+template <typename Limits> class MotionController;
 
 // === LIMIT RESPONSE INTERFACE ===
 // Defines what action to take when a limit is reached
@@ -60,6 +74,11 @@ public:
 
 // === LIMIT INTERFACE ===
 // Open/Closed Principle: Open for extension, closed for modification
+// The virtual part is only used once a limit is reached (name, response).
+// The per-step part is non-virtual: LimitManager knows the concrete types
+// and calls these directly, a limit only hides the ones it needs.
+const long LIMIT_NONE = 0x7FFFFFFFL;  // No software limit ahead
+
 class ILimit {
 public:
   virtual ~ILimit() {}
@@ -67,11 +86,18 @@ public:
   virtual ILimitResponse* getResponse() const = 0;
   virtual const char* getName() const = 0;
   virtual void reset() {}  // Optional reset for stateful limits
+  
+  // Per-step helpers (non-virtual, hidden by concrete limits)
+  void begin() {}
+  // Steps that can be taken before isReached() turns true; 0 = check every step
+  long stepsUntil(long position, int direction) const { return 0; }
+  // Sensor limits: true when the input may have changed since the last call
+  boolean consumeChange() { return false; }
 };
 
 // === POSITION LIMIT ===
 // Software limit based on absolute position
-class PositionLimit : public ILimit {
+class PositionLimit final : public ILimit {
 private:
   long limitPosition_;
   int triggerDirection_;  // 1 for forward, -1 for reverse, 0 for both
@@ -97,6 +123,14 @@ public:
     }
   }
   
+  long stepsUntil(long position, int direction) const {
+    if (triggerDirection_ != 0 && triggerDirection_ != direction) {
+      return LIMIT_NONE;
+    }
+    long steps = direction > 0 ? limitPosition_ - position : position - limitPosition_;
+    return steps > 0 ? steps : 0;
+  }
+  
   ILimitResponse* getResponse() const override {
     return response_;
   }
@@ -108,27 +142,62 @@ public:
 
 // === SENSOR LIMIT ===
 // Hardware limit using physical sensor
-class SensorLimit : public ILimit {
+class SensorLimit final : public ILimit {
 private:
   uint8_t pin_;
   boolean activeHigh_;
   ILimitResponse* response_;
   const char* name_;
+  boolean usesInterrupt_;
+  
+  static volatile boolean changed_;  // Set by the pin-change interrupt
   
 public:
   SensorLimit(uint8_t pin, boolean activeHigh, ILimitResponse* response, const char* name)
     : pin_(pin), 
       activeHigh_(activeHigh),
       response_(response),
-      name_(name) {
+      name_(name),
+      usesInterrupt_(false) {
     pinMode(pin_, INPUT);
   }
   
+  // Enable the pin-change interrupt of the pin (AVR); elsewhere the
+  // sensor is read every step
+  void begin() {
+#if defined(__AVR__) && defined(digitalPinToPCICR)
+    volatile uint8_t* pcicr = digitalPinToPCICR(pin_);
+    if (pcicr) {
+      *digitalPinToPCMSK(pin_) |= _BV(digitalPinToPCMSKbit(pin_));
+      *pcicr |= _BV(digitalPinToPCICRbit(pin_));
+      usesInterrupt_ = true;
+    }
+#endif
+  }
+  
   boolean isReached(long position, int direction) const override {
     boolean sensorState = digitalRead(pin_);
     return activeHigh_ ? sensorState : !sensorState;
   }
   
+  // Unknown in advance: the sensor is handled by consumeChange()
+  long stepsUntil(long position, int direction) const {
+    return LIMIT_NONE;
+  }
+  
+  boolean consumeChange() {
+    if (!usesInterrupt_) return true;
+    noInterrupts();
+    boolean changed = changed_;
+    changed_ = false;
+    interrupts();
+    return changed;
+  }
+  
+  static void onPinChange() {
+    changed_ = true;
+  }
+  
   ILimitResponse* getResponse() const override {
     return response_;
   }
@@ -140,7 +209,7 @@ public:
 
 // === DISTANCE LIMIT ===
 // Limit based on distance traveled from a reference point
-class DistanceLimit : public ILimit {
+class DistanceLimit final : public ILimit {
 private:
   long maxDistance_;
   long referencePosition_;
@@ -162,6 +231,13 @@ public:
     return distance >= maxDistance_;
   }
   
+  // |position + direction * k - reference| >= maxDistance
+  long stepsUntil(long position, int direction) const {
+    if (!active_) return LIMIT_NONE;
+    long steps = maxDistance_ - direction * (position - referencePosition_);
+    return steps > 0 ? steps : 0;
+  }
+  
   ILimitResponse* getResponse() const override {
     return response_;
   }
@@ -184,46 +260,76 @@ public:
   }
 };
 
+volatile boolean SensorLimit::changed_ = true;  // First check reads the pin
+
+// One interrupt per port; any change makes the controller read its sensors
+// and lets the homing capture latch the position at the sensor edge
+#if defined(__AVR__) && defined(PCINT0_vect)
+ISR(PCINT0_vect) { SensorLimit::onPinChange(); EdgeCapture::onPinChange(); }
+#endif
+#if defined(__AVR__) && defined(PCINT1_vect)
+ISR(PCINT1_vect) { SensorLimit::onPinChange(); EdgeCapture::onPinChange(); }
+#endif
+#if defined(__AVR__) && defined(PCINT2_vect)
+ISR(PCINT2_vect) { SensorLimit::onPinChange(); EdgeCapture::onPinChange(); }
+#endif
+
 // === LIMIT MANAGER ===
-// Manages multiple limits and determines appropriate response
-class LimitManager {
+// Manages multiple limits and determines appropriate response.
+// Composed at compile time: LimitManager<SensorLimit, DistanceLimit> holds a
+// reference per limit and unrolls every check, so the compiler sees the
+// concrete (final) types and inlines the calls - no virtual call per step.
+template <typename... Limits>
+class LimitManager;
+
+template <>
+class LimitManager<> {
+public:
+  void begin() {}
+  ILimit* checkLimits(long position, int direction) { return nullptr; }
+  long stepsUntilLimit(long position, int direction) const { return LIMIT_NONE; }
+  boolean consumeSensorChanges() { return false; }
+  void resetAll() {}
+};
+
+template <typename First, typename... Rest>
+class LimitManager<First, Rest...> {
 private:
-  static const int MAX_LIMITS = 10;
-  ILimit* limits_[MAX_LIMITS];
-  int limitCount_;
+  First& first_;
+  LimitManager<Rest...> rest_;
   
 public:
-  LimitManager() : limitCount_(0) {
-    for (int i = 0; i < MAX_LIMITS; i++) {
-      limits_[i] = nullptr;
-    }
+  LimitManager(First& first, Rest&... rest) : first_(first), rest_(rest...) {}
+  
+  void begin() {
+    first_.begin();
+    rest_.begin();
   }
   
-  void addLimit(ILimit* limit) {
-    if (limitCount_ < MAX_LIMITS && limit != nullptr) {
-      limits_[limitCount_++] = limit;
+  // First limit reached, in declaration order
+  ILimit* checkLimits(long position, int direction) {
+    if (first_.isReached(position, direction)) {
+      return &first_;
     }
+    return rest_.checkLimits(position, direction);
   }
   
-  void removeAllLimits() {
-    limitCount_ = 0;
+  // Steps until the nearest limit could be reached
+  long stepsUntilLimit(long position, int direction) const {
+    long steps = first_.stepsUntil(position, direction);
+    long others = rest_.stepsUntilLimit(position, direction);
+    return steps < others ? steps : others;
   }
   
-  ILimit* checkLimits(long position, int direction) {
-    for (int i = 0; i < limitCount_; i++) {
-      if (limits_[i] && limits_[i]->isReached(position, direction)) {
-        return limits_[i];
-      }
-    }
-    return nullptr;
+  // True when any sensor may have changed (clears every flag)
+  boolean consumeSensorChanges() {
+    boolean changed = first_.consumeChange();
+    return rest_.consumeSensorChanges() || changed;
   }
   
   void resetAll() {
-    for (int i = 0; i < limitCount_; i++) {
-      if (limits_[i]) {
-        limits_[i]->reset();
-      }
-    }
+    first_.reset();
+    rest_.resetAll();
   }
 };
 
@@ -329,37 +435,84 @@ private:
 
 // === MOTION PROFILE CLASS ===
 // Single Responsibility: Manage acceleration and speed profiles
+// The ramps come from MotionPlanner; this class only tracks the interval
+// until the next step.
 class MotionProfile {
 private:
-  const unsigned long targetInterval_;
-  const unsigned long accelStepSize_;
-  const uint8_t decelMultiplier_;
+  MotionPlanner planner_;
   unsigned long currentInterval_;
+  uint32_t maxSpeed_;
 
 public:
   MotionProfile(unsigned long targetInterval,
-                unsigned long accelStepSize = 50,
-                uint8_t decelMultiplier = 5)
-    : targetInterval_(targetInterval),
-      accelStepSize_(accelStepSize),
-      decelMultiplier_(decelMultiplier),
-      currentInterval_(targetInterval * 10) {}
+                unsigned long acceleration = 12800,
+                ProfileType type = ProfileType::TRAPEZOIDAL)
+    : planner_(),
+      currentInterval_(0),
+      maxSpeed_(1000000UL / targetInterval) {
+    MotionLimits limits;
+    limits.maxSpeed = maxSpeed_;
+    limits.acceleration = acceleration;
+    limits.profile = type;
+    planner_.setLimits(limits);
+  }
 
+  // Known distance: accelerate, cruise and end at exitSpeed (steps/s)
+  void startMove(unsigned long steps, uint32_t entrySpeed = 0, uint32_t exitSpeed = 0) {
+    planner_.plan(steps, entrySpeed, exitSpeed);
+    currentInterval_ = planner_.nextInterval();
+  }
+  
+  // New exit speed for a running move; the next interval is already set
+  void replan(unsigned long remainingSteps, uint32_t exitSpeed) {
+    if (remainingSteps > 1) {
+      planner_.plan(remainingSteps - 1, planner_.getCurrentSpeed(), exitSpeed);
+    }
+  }
+  
+  uint32_t getCurrentSpeed() const {
+    return planner_.getCurrentSpeed();
+  }
+  
+  const MotionLimits& getLimits() const {
+    return planner_.getLimits();
+  }
+
+  // Shortest ramp to standstill from the current speed
+  void requestStop() {
+    planner_.requestStop();
+  }
+  
+  boolean isDone() const {
+    return planner_.isDone();
+  }
+  
+  // Top speed for the following moves: full speed / divisor
+  void setSpeedDivisor(uint8_t divisor) {
+    MotionLimits limits = planner_.getLimits();
+    limits.maxSpeed = maxSpeed_ / divisor;
+    planner_.setLimits(limits);
+  }
+
+  // Unknown distance (homing, limits): accelerate and keep running
+  void startContinuous() {
+    startMove(MotionPlanner::CONTINUOUS);
+  }
+
+  // Call after every step
   void accelerate() {
-    if (currentInterval_ > targetInterval_) {
-      currentInterval_ -= accelStepSize_;
-      if (currentInterval_ < targetInterval_) {
-        currentInterval_ = targetInterval_;
-      }
+    unsigned long next = planner_.nextInterval();
+    if (next > 0) {
+      currentInterval_ = next;  // Keep the last interval once the plan is done
     }
   }
 
   void resetForDirectionChange() {
-    currentInterval_ = targetInterval_ * decelMultiplier_;
+    startContinuous();
   }
   
   void resetSlow() {
-    currentInterval_ = targetInterval_ * 10;
+    startContinuous();
   }
 
   unsigned long getCurrentInterval() const {
@@ -368,7 +521,8 @@ public:
 };
 
 // === MOTION CONTROLLER CLASS ===
-// Uses Dependency Injection for limits
+// Uses Dependency Injection for limits (any LimitManager<...>)
+template <typename Limits>
 class MotionController {
 public:
   enum SystemState {
@@ -385,9 +539,11 @@ public:
 private:
   StepperMotor& motor_;
   MotionProfile profile_;
-  LimitManager& limitManager_;
+  MotionQueue queue_;
+  Limits& limitManager_;
   
   unsigned long lastStepTime_;
+  long limitBudget_;   // Steps before the limits must be checked again
   long backoffTarget_;
   long backoffStart_;
   
@@ -397,32 +553,51 @@ private:
     STOPPED
   };
   
+  // Homing: fast to the sensor, stop, back off, slowly onto the edge again
+  enum HomingPhase {
+    HOME_FAST,       // Full speed toward the sensor, edge latched by interrupt
+    HOME_STOPPING,   // Decelerating past the edge
+    HOME_CLEARING,   // Started on the sensor: slowly off it first
+    HOME_BACKOFF,    // To HOME_BACKOFF_STEPS before the latched edge
+    HOME_SLOW        // Slow approach; its edge is the zero point
+  };
+  
+  static const long HOME_BACKOFF_STEPS = 200;
+  static const uint8_t HOMING_SLOW_DIVISOR = 16;
+  
+  EdgeCapture& homeSensor_;
+  HomingPhase homingPhase_;
+  long homingTarget_;   // End of the backoff
+  
   MotionState motionState_;
   SystemState systemState_;
   
   long homePosition_;
   long targetPosition_;
   long currentTargetPosition_;
-  boolean homingComplete_;
-  boolean sensorFoundDuringHoming_;
 
 public:
-  MotionController(StepperMotor& motor, LimitManager& limitManager)
+  MotionController(StepperMotor& motor, Limits& limitManager, EdgeCapture& homeSensor)
     : motor_(motor),
       profile_(motor.getMinStepInterval()),
       limitManager_(limitManager),
       lastStepTime_(0),
+      limitBudget_(0),
       backoffTarget_(0),
       backoffStart_(0),
+      homeSensor_(homeSensor),
+      homingPhase_(HOME_FAST),
+      homingTarget_(0),
       motionState_(STOPPED),
       systemState_(IDLE),
       homePosition_(0),
       targetPosition_(3200),
-      currentTargetPosition_(0),
-      homingComplete_(false),
-      sensorFoundDuringHoming_(false) {}
+      currentTargetPosition_(0) {
+    queue_.setLimits(profile_.getLimits());
+  }
 
   void begin() {
+    limitManager_.begin();
     motor_.disable();
     motionState_ = STOPPED;
     systemState_ = IDLE;
@@ -452,6 +627,8 @@ public:
   void stop() {
     motor_.disable();
     motionState_ = STOPPED;
+    endHoming();
+    queue_.reset(motor_.getPosition());
     if (systemState_ != IDLE && systemState_ != HOMED && systemState_ != AT_TARGET && systemState_ != AT_ORIGIN) {
       systemState_ = IDLE;
     }
@@ -462,12 +639,10 @@ public:
     if (systemState_ == IDLE || systemState_ == ERROR) {
       Serial.println("Starting homing sequence...");
       systemState_ = HOMING;
-      homingComplete_ = false;
-      sensorFoundDuringHoming_ = false;
       motor_.enable();
-      motor_.setDirection(StepperMotor::REVERSE);
       motionState_ = RUNNING;
-      profile_.resetSlow();
+      // Already on the sensor: move off it, the fast approach is not needed
+      startHomingPhase(homeSensor_.isActive() ? HOME_CLEARING : HOME_FAST);
     } else {
       Serial.println("Cannot home - system not in IDLE state");
     }
@@ -479,10 +654,11 @@ public:
       Serial.println(targetPosition_);
       systemState_ = MOVING_TO_TARGET;
       currentTargetPosition_ = targetPosition_;
+      queue_.reset(currentTargetPosition_);  // QUEUE n continues from the target
       motor_.enable();
-      motor_.setDirection(StepperMotor::FORWARD);
+      setDirection(StepperMotor::FORWARD);
       motionState_ = RUNNING;
-      profile_.resetForDirectionChange();
+      profile_.startMove(abs(currentTargetPosition_ - motor_.getPosition()));
     } else {
       Serial.println("Cannot move to target - not in HOMED or AT_ORIGIN state");
     }
@@ -494,9 +670,9 @@ public:
       systemState_ = RETURNING_TO_ORIGIN;
       currentTargetPosition_ = homePosition_;
       motor_.enable();
-      motor_.setDirection(StepperMotor::REVERSE);
+      setDirection(StepperMotor::REVERSE);
       motionState_ = RUNNING;
-      profile_.resetForDirectionChange();
+      profile_.startMove(abs(currentTargetPosition_ - motor_.getPosition()));
     } else {
       Serial.println("Cannot return to origin - not at target position");
     }
@@ -514,6 +690,39 @@ public:
     }
   }
   
+  // Queue a move; starts at once when homed or at rest, otherwise it runs
+  // after the moves already queued
+  void queuePosition(long position) {
+    if (systemState_ == MOVING_TO_TARGET) {
+      const uint32_t exitBefore = queue_.getActiveExitSpeed();
+      if (!queue_.push(position)) {
+        Serial.println("Queue full");
+        return;
+      }
+      if (queue_.getActiveExitSpeed() != exitBefore) {
+        profile_.replan(abs(currentTargetPosition_ - motor_.getPosition()), queue_.getActiveExitSpeed());
+      }
+    } else if (systemState_ == HOMED || systemState_ == AT_TARGET || systemState_ == AT_ORIGIN) {
+      queue_.reset(motor_.getPosition());
+      queue_.push(position);
+      if (!startNextSegment(0)) {
+        Serial.println("Already at position");
+        return;
+      }
+      systemState_ = MOVING_TO_TARGET;
+      motor_.enable();
+      motionState_ = RUNNING;
+    } else {
+      Serial.println("Cannot queue - system not homed");
+      return;
+    }
+    Serial.print("Queued: ");
+    Serial.print(position);
+    Serial.print(" (");
+    Serial.print(queue_.getCount());
+    Serial.println(" waiting)");
+  }
+  
   void setTargetPosition(long position) {
     targetPosition_ = position;
     Serial.print("Target position set to: ");
@@ -540,18 +749,16 @@ private:
   void updateStateMachine() {
     switch(systemState_) {
       case HOMING:
-        if (homingComplete_) {
-          motor_.resetPosition();
-          homePosition_ = 0;
-          systemState_ = HOMED;
-          motionState_ = STOPPED;
-          motor_.disable();
-          Serial.println("Homing complete! Position reset to 0.");
-        }
+        updateHoming();
         break;
         
       case MOVING_TO_TARGET:
         if (abs(motor_.getPosition() - currentTargetPosition_) <= 1) {
+          // Queued segment: carry on at the planned junction speed
+          const uint32_t junction = queue_.getActiveExitSpeed();
+          const uint32_t speed = profile_.getCurrentSpeed();
+          if (startNextSegment(junction < speed ? junction : speed)) break;
+          
           systemState_ = AT_TARGET;
           motionState_ = STOPPED;
           motor_.disable();
@@ -575,25 +782,139 @@ private:
     }
   }
   
+  void startHomingPhase(HomingPhase phase) {
+    homingPhase_ = phase;
+    
+    switch (phase) {
+      case HOME_FAST:
+      case HOME_SLOW:
+        // Distance to the sensor unknown: run until the edge is latched
+        profile_.setSpeedDivisor(phase == HOME_FAST ? 1 : HOMING_SLOW_DIVISOR);
+        setDirection(StepperMotor::REVERSE);
+        homeSensor_.arm();
+        homeSensor_.setPosition(motor_.getPosition());
+        profile_.startContinuous();
+        break;
+        
+      case HOME_STOPPING:
+        Serial.print("Sensor edge at ");
+        Serial.print(homeSensor_.getCapturedPosition());
+        Serial.println(", decelerating");
+        profile_.requestStop();
+        break;
+        
+      case HOME_CLEARING:
+        profile_.setSpeedDivisor(HOMING_SLOW_DIVISOR);
+        setDirection(StepperMotor::FORWARD);
+        profile_.startContinuous();
+        break;
+        
+      case HOME_BACKOFF:
+        profile_.setSpeedDivisor(1);
+        setDirection(StepperMotor::FORWARD);
+        profile_.startMove(homingTarget_ > motor_.getPosition() ? homingTarget_ - motor_.getPosition() : 0);
+        break;
+    }
+  }
+  
+  void updateHoming() {
+    switch (homingPhase_) {
+      case HOME_FAST:
+        if (homeSensor_.isCaptured()) startHomingPhase(HOME_STOPPING);
+        break;
+        
+      case HOME_STOPPING:
+        if (profile_.isDone()) {
+          homingTarget_ = homeSensor_.getCapturedPosition() + HOME_BACKOFF_STEPS;
+          startHomingPhase(HOME_BACKOFF);
+        }
+        break;
+        
+      case HOME_CLEARING:
+        if (!homeSensor_.isActive()) {
+          homingTarget_ = motor_.getPosition() + HOME_BACKOFF_STEPS;
+          startHomingPhase(HOME_BACKOFF);
+        }
+        break;
+        
+      case HOME_BACKOFF:
+        if (motor_.getPosition() >= homingTarget_) {
+          // Sensor wider than the backoff: off it first, or there is no edge
+          startHomingPhase(homeSensor_.isActive() ? HOME_CLEARING : HOME_SLOW);
+        }
+        break;
+        
+      case HOME_SLOW:
+        if (homeSensor_.isCaptured()) {
+          // Zero is the edge itself, not where the motor came to rest
+          motor_.setPosition(motor_.getPosition() - homeSensor_.getCapturedPosition());
+          endHoming();
+          limitBudget_ = 0;
+          homePosition_ = 0;
+          systemState_ = HOMED;
+          motionState_ = STOPPED;
+          motor_.disable();
+          Serial.println("Homing complete! Position reset to 0.");
+        }
+        break;
+    }
+  }
+  
+  // Homing finished or interrupted: normal speed, capture off
+  void endHoming() {
+    homeSensor_.disarm();
+    profile_.setSpeedDivisor(1);
+  }
+  
+  // Start the next queued segment; false when the queue is empty
+  boolean startNextSegment(uint32_t entrySpeed) {
+    MotionSegment segment;
+    if (!queue_.pop(segment)) return false;
+    
+    const StepperMotor::Direction dir = segment.direction > 0 ? StepperMotor::FORWARD : StepperMotor::REVERSE;
+    if (dir != motor_.getDirection()) entrySpeed = 0;  // Reversal: junction speed is 0 anyway
+    setDirection(dir);
+    currentTargetPosition_ = segment.target;
+    profile_.startMove(segment.steps, entrySpeed, segment.exitSpeed);
+    return true;
+  }
+  
+  // Direction changes move every software limit: check on the next step
+  void setDirection(StepperMotor::Direction dir) {
+    motor_.setDirection(dir);
+    limitBudget_ = 0;
+  }
+  
+  // Checks the limits only when a software limit can be near or a sensor
+  // input has changed; otherwise counts down the precomputed budget
+  ILimit* pollLimits() {
+    const boolean sensorChanged = limitManager_.consumeSensorChanges();
+    if (limitBudget_ > 0 && !sensorChanged) {
+      limitBudget_--;
+      return nullptr;
+    }
+    
+    const long position = motor_.getPosition();
+    const int direction = motor_.getDirection();
+    ILimit* limit = limitManager_.checkLimits(position, direction);
+    if (!limit) {
+      // This step is taken now, the budget covers the ones after it
+      const long steps = limitManager_.stepsUntilLimit(position, direction);
+      limitBudget_ = steps > 0 ? steps - 1 : 0;
+    }
+    return limit;
+  }
+  
   boolean shouldStep(unsigned long currentTime) const {
     return (currentTime - lastStepTime_) >= profile_.getCurrentInterval();
   }
   
   void handleNormalMovement() {
     if (systemState_ == HOMING) {
-      ILimit* triggeredLimit = limitManager_.checkLimits(
-        motor_.getPosition(), 
-        motor_.getDirection()
-      );
-      
-      if (triggeredLimit && strcmp(triggeredLimit->getName(), "Sensor") == 0) {
-        Serial.println("Sensor detected during homing");
-        homingComplete_ = true;
-        sensorFoundDuringHoming_ = true;
-      } else {
-        motor_.step();
-        profile_.accelerate();
-      }
+      // The sensor is watched by its interrupt; updateHoming() ends each phase
+      motor_.step();
+      homeSensor_.setPosition(motor_.getPosition());
+      profile_.accelerate();
     } else if (systemState_ == MOVING_TO_TARGET || systemState_ == RETURNING_TO_ORIGIN) {
       long distanceToTarget = abs(motor_.getPosition() - currentTargetPosition_);
       if (distanceToTarget > 1) {
@@ -601,10 +922,7 @@ private:
         profile_.accelerate();
       }
     } else {
-      ILimit* triggeredLimit = limitManager_.checkLimits(
-        motor_.getPosition(), 
-        motor_.getDirection()
-      );
+      ILimit* triggeredLimit = pollLimits();
       
       if (triggeredLimit) {
         handleLimitReached(triggeredLimit);
@@ -617,6 +935,7 @@ private:
   
   void handleBackoff() {
     motor_.step();
+    profile_.accelerate();
     
     long distanceBacked = abs(motor_.getPosition() - backoffStart_);
     if (distanceBacked >= backoffTarget_) {
@@ -624,6 +943,7 @@ private:
       Serial.println("Backoff complete, resuming normal operation");
       profile_.resetForDirectionChange();
       limitManager_.resetAll();
+      limitBudget_ = 0;
     }
   }
   
@@ -643,6 +963,7 @@ private:
       case ILimitResponse::REVERSE:
         reverseDirection();
         limitManager_.resetAll();
+        limitBudget_ = 0;
         break;
         
       case ILimitResponse::BACK_OFF:
@@ -660,7 +981,7 @@ private:
       ? StepperMotor::REVERSE 
       : StepperMotor::FORWARD;
     
-    motor_.setDirection(newDir);
+    setDirection(newDir);
     profile_.resetForDirectionChange();
     
     Serial.print("Direction reversed to ");
@@ -672,6 +993,7 @@ private:
     backoffStart_ = motor_.getPosition();
     backoffTarget_ = distance;
     reverseDirection();
+    profile_.startMove(distance);
     
     Serial.print("Starting backoff for ");
     Serial.print(distance);
@@ -692,10 +1014,11 @@ private:
   static const int FULL_STEPS_PER_REV = 200;
   static const int MICROSTEPS = 16;
   
-  // Components
+  // Limit set, checked in this order
+  typedef LimitManager<SensorLimit, DistanceLimit> Limits;
+  
+  // Components (the limits are constructed before the manager that refers to them)
   StepperMotor motor_;
-  LimitManager limitManager_;
-  MotionController controller_;
   
   // Limit responses (owned by application)
   BackOffResponse sensorBackoff_;
@@ -704,26 +1027,27 @@ private:
   // Limits (owned by application)
   SensorLimit sensorLimit_;
   DistanceLimit travelLimit_;
+  
+  Limits limitManager_;
+  EdgeCapture homeSensor_;
+  MotionController<Limits> controller_;
 
 public:
   StepperApplication()
     : motor_(STEP_PIN, DIR_PIN, ENABLE_PIN, FULL_STEPS_PER_REV, MICROSTEPS),
-      limitManager_(),
-      controller_(motor_, limitManager_),
       sensorBackoff_(200),  // 200 steps backoff
       travelReverse_(),
       sensorLimit_(SENSOR_PIN, true, &sensorBackoff_, "Sensor"),
-      travelLimit_(3200, &travelReverse_, "Travel") {
-    
-    // Configure limits
-    limitManager_.addLimit(&sensorLimit_);
-    limitManager_.addLimit(&travelLimit_);
+      travelLimit_(3200, &travelReverse_, "Travel"),
+      limitManager_(sensorLimit_, travelLimit_),
+      homeSensor_(),
+      controller_(motor_, limitManager_, homeSensor_) {
   }
 
   void begin() {
     Serial.begin(115200);
     Serial.println("=====================================");
-    Serial.println("SOLID Architecture Stepper Control v6.0");
+    Serial.println("SOLID Architecture Stepper Control v6.4");
     Serial.println("=====================================");
     Serial.println("Syringe Control with State Machine");
     Serial.println("- Homing to sensor zero point");
@@ -731,6 +1055,7 @@ public:
     Serial.println();
     
     motor_.begin();
+    homeSensor_.begin(SENSOR_PIN, true);
     controller_.begin();
     
     Serial.println();
@@ -767,6 +1092,13 @@ private:
         } else {
           Serial.println("Invalid target position (must be 1-9999)");
         }
+      } else if (cmd.startsWith("QUEUE ")) {
+        long position = cmd.substring(6).toInt();
+        if (position >= 0 && position < 10000) {
+          controller_.queuePosition(position);
+        } else {
+          Serial.println("Invalid position (must be 0-9999)");
+        }
       } else if (cmd == "POS") {
         Serial.print("Position: ");
         Serial.println(motor_.getPosition());
@@ -800,6 +1132,7 @@ private:
     Serial.println("RETURN       - Return to origin (release syringe)");
     Serial.println("CYCLE        - Run complete cycle (home->target->origin)");
     Serial.println("SETTARGET n  - Set target position (e.g., SETTARGET 3200)");
+    Serial.println("QUEUE n      - Queue a move to n (blends with queued moves)");
     Serial.println("STOP         - Emergency stop");
     Serial.println("POS          - Show current position");
     Serial.println("STATUS       - Show system status");
@@ -8,6 +8,23 @@
  * - PROGMEM for string constants
  * - Simplified class hierarchy
  * - Maintains core functionality
+ * - Trapezoidal acceleration from MotionPlanner (SimpleStepper library)
+ * - GOTO while moving queues the target (MotionQueue look-ahead):
+ *   moves in the same direction blend without stopping
+ * - Binary protocol next to the text commands: COBS frames with CRC-16,
+ *   fixed opcode table, non-blocking TX ring (see README)
+ * - Text commands dispatched through a compile-time perfect hash
+ *   (CommandTable): one lookup per line, handlers in flash
+ * - OP_MEMORY: stack high-water mark and ring/queue peaks (MemoryMonitor)
+ * - Optional stall detection (StallDetector): quadrature encoder and/or
+ *   driver fault input checked on every step, ERROR:STALL within a few steps
+ * - Two-phase homing: fast approach with the sensor edge latched by its
+ *   pin-change interrupt (EdgeCapture), decelerate, back off, then a slow
+ *   second approach that sets the zero point
+ * - Position, step interval and flags in one packed MotionState
+ *   (12 bytes), the layout SimpleStepper shares with its step ISR
+ * - Status messages by ID from a flash table (MessageTable): printed
+ *   straight from flash, binary mode sends only the ID (OP_MESSAGE)
  * 
  * Sep 2025
  * Embedded Programming (Prog 5/6)
@@ -15,6 +32,14 @@
  */
 
 #include <avr/pgmspace.h>
+#include <MotionPlanner.h>
+#include <MotionQueue.h>
+#include <CommandTable.h>
+#include <MemoryMonitor.h>
+#include <StallDetector.h>
+#include <EdgeCapture.h>
+#include <MotionState.h>
+#include <MessageTable.h>
 
 // === PIN CONFIGURATION ===
 #define STEP_PIN 7
@@ -28,9 +53,8 @@
 #define TARGET_RPM 180.0f  // Moderate speed increase
 
 // === MOTION PARAMETERS ===
-#define HOMING_SPEED_DIVISOR 2  // Slower but not too slow for homing
-#define ACCEL_SPEED_DIVISOR 5
-#define ACCEL_STEP_SIZE 50
+#define HOMING_SLOW_DIVISOR 16  // Second homing approach: 1/16 of full speed
+#define ACCELERATION 8000UL  // steps/s^2, full speed after ~0.3 s
 #define SENSOR_BACKOFF_STEPS 200
 #define DEFAULT_TARGET_POSITION 3200
 
@@ -41,17 +65,56 @@
 #define MAX_POSITION 22000
 #define MIN_POSITION 0
 
+// === STALL DETECTION (optional) ===
+// Encoder on the motor shaft (A/B on the D2/D3 interrupts) and/or the
+// fault output of a driver that has one; neither fitted: no checks
+#define STALL_ENCODER 0                // 1: encoder fitted
+#define ENCODER_A_PIN 2
+#define ENCODER_B_PIN 3
+#define ENCODER_COUNTS_PER_REV 1600    // 400-line encoder, x4 decoding
+#define STALL_TOLERANCE_COUNTS 16      // 2 full steps: a stall slips 4 at once
+#define DRIVER_FAULT_PIN 0xFF          // ALM / DIAG output, 0xFF: not connected
+#define DRIVER_FAULT_LEVEL LOW
+
+#define STALL_DETECTION (STALL_ENCODER || DRIVER_FAULT_PIN != 0xFF)
+
 // M2M communication messages - structured format
-const char MSG_INIT[] PROGMEM = "STATUS:INIT:v1.0f";
-const char MSG_READY[] PROGMEM = "STATUS:READY";
-const char MSG_HOMING[] PROGMEM = "STATUS:HOMING";
-const char MSG_HOMED[] PROGMEM = "STATUS:HOMED:0";
-const char MSG_TARGET[] PROGMEM = "STATUS:MOVING";
-const char MSG_AT_TARGET[] PROGMEM = "STATUS:TARGET_REACHED";
-const char MSG_RETURNING[] PROGMEM = "STATUS:RETURNING";
-const char MSG_AT_ORIGIN[] PROGMEM = "STATUS:ORIGIN_REACHED";
-const char MSG_STOPPED[] PROGMEM = "STATUS:STOPPED";
-const char MSG_ERROR[] PROGMEM = "ERROR:INVALID_STATE";
+// Texts and the table in flash; the ID is what binary mode sends, so
+// only append new messages (the host keeps a copy, see OP_DICTIONARY)
+const char TEXT_INIT[] PROGMEM = "STATUS:INIT:v1.0f";
+const char TEXT_READY[] PROGMEM = "STATUS:READY";
+const char TEXT_HOMING[] PROGMEM = "STATUS:HOMING";
+const char TEXT_HOMED[] PROGMEM = "STATUS:HOMED:0";
+const char TEXT_TARGET[] PROGMEM = "STATUS:MOVING";
+const char TEXT_AT_TARGET[] PROGMEM = "STATUS:TARGET_REACHED";
+const char TEXT_RETURNING[] PROGMEM = "STATUS:RETURNING";
+const char TEXT_AT_ORIGIN[] PROGMEM = "STATUS:ORIGIN_REACHED";
+const char TEXT_STOPPED[] PROGMEM = "STATUS:STOPPED";
+const char TEXT_ERROR[] PROGMEM = "ERROR:INVALID_STATE";
+const char TEXT_STALL[] PROGMEM = "ERROR:STALL";
+
+enum Message : uint8_t {
+  MSG_INIT,
+  MSG_READY,
+  MSG_HOMING,
+  MSG_HOMED,
+  MSG_TARGET,
+  MSG_AT_TARGET,
+  MSG_RETURNING,
+  MSG_AT_ORIGIN,
+  MSG_STOPPED,
+  MSG_ERROR,
+  MSG_STALL,
+  MSG_COUNT
+};
+
+const char* const MESSAGE_TEXTS[MSG_COUNT] PROGMEM = {
+  TEXT_INIT, TEXT_READY, TEXT_HOMING, TEXT_HOMED, TEXT_TARGET, TEXT_AT_TARGET,
+  TEXT_RETURNING, TEXT_AT_ORIGIN, TEXT_STOPPED, TEXT_ERROR, TEXT_STALL
+};
+typedef MessageTable<MESSAGE_TEXTS, MSG_COUNT> Messages;
+
+#define MESSAGE_QUEUE_SIZE 4  // Power of two; IDs waiting for an OP_MESSAGE frame
 
 // === ENUMS ===
 enum SystemState : uint8_t {
@@ -65,50 +128,97 @@ enum SystemState : uint8_t {
   STATE_ERROR
 };
 
+// Commands whose acceptance depends on the system state
+enum Command : uint8_t {
+  CMD_HOME,
+  CMD_TARGET,
+  CMD_RETURN,
+  CMD_MOVE
+};
+
+#define CMD_BIT(cmd) (1 << (cmd))
+
+// [state] -> accepted command mask, one byte per state in flash.
+// Replaces the chained state comparisons with a single table lookup.
+const uint8_t STATE_ACCEPTS[] PROGMEM = {
+  /* STATE_IDLE             */ CMD_BIT(CMD_HOME) | CMD_BIT(CMD_MOVE),
+  /* STATE_HOMING           */ 0,
+  /* STATE_HOMED            */ CMD_BIT(CMD_HOME) | CMD_BIT(CMD_TARGET) | CMD_BIT(CMD_MOVE),
+  /* STATE_MOVING_TO_TARGET */ 0,
+  /* STATE_AT_TARGET        */ CMD_BIT(CMD_RETURN) | CMD_BIT(CMD_MOVE),
+  /* STATE_RETURNING        */ 0,
+  /* STATE_AT_ORIGIN        */ CMD_BIT(CMD_TARGET) | CMD_BIT(CMD_MOVE),
+  /* STATE_ERROR            */ CMD_BIT(CMD_HOME)
+};
+
 enum Direction : uint8_t {
   FORWARD = 0,
   BACKWARD = 1
 };
 
+// Homing: fast to the sensor, stop, back off, slowly onto the edge again
+enum HomingPhase : uint8_t {
+  HOME_FAST,       // Full speed toward the sensor, edge latched by interrupt
+  HOME_STOPPING,   // Decelerating past the edge
+  HOME_CLEARING,   // Started on the sensor: slowly off it first
+  HOME_BACKOFF,    // To SENSOR_BACKOFF_STEPS before the latched edge
+  HOME_SLOW        // Slow approach; its edge is the zero point
+};
+
 // === COMPACT STEPPER CONTROLLER ===
 class StepperController {
 private:
+  // Position, current interval and flags (enable, direction, homing)
+  // packed together; steps come from loop(), so plain reads are safe
+  MotionState motion_;
+  
   // State variables
   SystemState systemState_;
-  long currentPosition_;
   long targetPosition_;
   long homePosition_;
   
   // Motion control
   unsigned long lastStepTime_;
-  unsigned long currentInterval_;
   unsigned long targetInterval_;
+  uint32_t maxSpeed_;
+  MotionPlanner planner_;
+  MotionQueue queue_;
+  
+  // Homing
+  EdgeCapture homeSensor_;
+  HomingPhase homingPhase_;
+  long homingTarget_;       // End of the backoff
+  
+#if STALL_DETECTION
+  StallDetector stall_;
+#endif
+#if STALL_ENCODER
+  QuadratureEncoder encoder_;
+#endif
+  
+  // Status messages as IDs in binary mode
+  uint8_t messages_[MESSAGE_QUEUE_SIZE];
+  uint8_t messageHead_;
+  uint8_t messageTail_;
+  bool binaryMessages_;
   
-  // Flags packed into single byte
-  struct {
-    uint8_t motorEnabled : 1;
-    uint8_t direction : 1;  // 0=FORWARD, 1=BACKWARD
-    uint8_t homingComplete : 1;
-    uint8_t sensorTriggered : 1;
-    uint8_t movingAwayFromSensor : 1;
-    uint8_t reserved : 3;
-  } flags_;
+  // Homing flag in the owner bits of motion_.flags
+  static const uint8_t FLAG_AWAY_FROM_SENSOR = MOTION_USER_0;
   
 public:
   StepperController() :
+    motion_(),
     systemState_(STATE_IDLE),
-    currentPosition_(0),
     targetPosition_(DEFAULT_TARGET_POSITION),
     homePosition_(0),
     lastStepTime_(micros()),
-    currentInterval_(0),
-    targetInterval_(0) {
-    
-    flags_.motorEnabled = 0;
-    flags_.direction = 0;
-    flags_.homingComplete = 0;
-    flags_.sensorTriggered = 0;
-    flags_.movingAwayFromSensor = 0;
+    targetInterval_(0),
+    maxSpeed_(0),
+    homingPhase_(HOME_FAST),
+    homingTarget_(0),
+    messageHead_(0),
+    messageTail_(0),
+    binaryMessages_(false) {
   }
   
   void begin() {
@@ -116,7 +226,7 @@ public:
     pinMode(STEP_PIN, OUTPUT);
     pinMode(DIR_PIN, OUTPUT);
     pinMode(ENABLE_PIN, OUTPUT);
-    pinMode(SENSOR_PIN, INPUT);
+    homeSensor_.begin(SENSOR_PIN, true);  // Pin-change interrupt, see ISR(PCINTn_vect)
     
     digitalWrite(STEP_PIN, LOW);
     digitalWrite(DIR_PIN, LOW);
@@ -125,7 +235,24 @@ public:
     // Calculate target interval for desired RPM
     float stepsPerSecond = (TARGET_RPM / 60.0f) * (FULL_STEPS_PER_REV * MICROSTEPS);
     targetInterval_ = 1000000UL / (unsigned long)stepsPerSecond;
-    currentInterval_ = targetInterval_ * HOMING_SPEED_DIVISOR;
+    motion_.interval = targetInterval_ * HOMING_SLOW_DIVISOR;
+    maxSpeed_ = (uint32_t)stepsPerSecond;
+    
+    MotionLimits limits;
+    limits.maxSpeed = maxSpeed_;
+    limits.acceleration = ACCELERATION;
+    planner_.setLimits(limits);
+    queue_.setLimits(limits);
+    
+#if STALL_ENCODER
+    if (encoder_.begin(ENCODER_A_PIN, ENCODER_B_PIN)) {
+      stall_.attachEncoder(&encoder_, FULL_STEPS_PER_REV * MICROSTEPS,
+                           ENCODER_COUNTS_PER_REV, STALL_TOLERANCE_COUNTS);
+    }
+#endif
+#if DRIVER_FAULT_PIN != 0xFF
+    stall_.attachFaultPin(DRIVER_FAULT_PIN, DRIVER_FAULT_LEVEL);
+#endif
     
     // Clean startup - wait for serial to stabilize
     delay(100);
@@ -140,10 +267,8 @@ public:
     Serial.print(F(":"));
     Serial.println(targetInterval_);
     
-    printProgmem(MSG_INIT);
-    Serial.println();
-    printProgmem(MSG_READY);
-    Serial.println();
+    report(MSG_INIT);
+    report(MSG_READY);
   }
   
   void update() {
@@ -151,9 +276,9 @@ public:
     updateStateMachine();
     
     // Motion update
-    if (flags_.motorEnabled) {
+    if (motion_.has(MOTION_ENABLED)) {
       unsigned long currentTime = micros();
-      if ((currentTime - lastStepTime_) >= currentInterval_) {
+      if ((currentTime - lastStepTime_) >= motion_.interval) {
         performStep();
         lastStepTime_ = currentTime;
       }
@@ -163,95 +288,80 @@ public:
   
   void startHoming() {
     // Always reset position before homing to allow backward movement
-    currentPosition_ = 1000;  // Set to positive value so we can move backward
+    motion_.position = 1000;  // Set to positive value so we can move backward
+    resyncStallDetection();
     
-    if (systemState_ == STATE_IDLE || systemState_ == STATE_ERROR || systemState_ == STATE_HOMED) {
+    if (accepts(CMD_HOME)) {
       systemState_ = STATE_HOMING;
-      flags_.homingComplete = 0;
-      flags_.sensorTriggered = 0;
-      flags_.movingAwayFromSensor = 0;
       enableMotor(true);
       
-      // Check if sensor is already triggered
-      if (digitalRead(SENSOR_PIN)) {
-        // Move away from sensor first (FORWARD = higher positions)
-        setDirection(FORWARD);
-        flags_.movingAwayFromSensor = 1;
-        // Sensor active - moving away first (no serial output)
-      } else {
-        // Move toward sensor (BACKWARD = toward position 0)
-        setDirection(BACKWARD);
-        flags_.movingAwayFromSensor = 0;
-        // Moving toward sensor (no serial output)
-      }
-      
-      currentInterval_ = targetInterval_;  // Use normal speed for homing
-      printProgmem(MSG_HOMING);
-      Serial.println();
+      // Already on the sensor: move off it, the fast approach is not needed
+      startHomingPhase(homeSensor_.isActive() ? HOME_CLEARING : HOME_FAST);
+      report(MSG_HOMING);
     }
   }
   
   void moveToTarget() {
-    if (systemState_ == STATE_HOMED || systemState_ == STATE_AT_ORIGIN) {
+    if (accepts(CMD_TARGET)) {
       systemState_ = STATE_MOVING_TO_TARGET;
       enableMotor(true);
-      setDirection(FORWARD); // Forward - away from home to compress syringe
-      currentInterval_ = targetInterval_;  // Use normal speed
-      printProgmem(MSG_TARGET);
-      Serial.println();
+      // Forward - away from home to compress syringe
+      queue_.reset(motion_.position);
+      queue_.push(targetPosition_);
+      if (!startNextSegment(0)) setDirection(FORWARD);  // Already there: state machine finishes
+      report(MSG_TARGET);
     }
   }
   
   void returnToOrigin() {
-    if (systemState_ == STATE_AT_TARGET) {
+    if (accepts(CMD_RETURN)) {
       systemState_ = STATE_RETURNING;
       enableMotor(true);
       setDirection(BACKWARD); // Backward - back to origin/home
-      currentInterval_ = targetInterval_;  // Use normal speed
-      printProgmem(MSG_RETURNING);
-      Serial.println();
+      startRamp(motion_.position > homePosition_ ? motion_.position - homePosition_ : 0);
+      report(MSG_RETURNING);
     }
   }
   
   void moveToPosition(long position) {
-    if (systemState_ == STATE_HOMED || systemState_ == STATE_AT_TARGET || 
-        systemState_ == STATE_AT_ORIGIN || systemState_ == STATE_IDLE) {
-      if (position < MIN_POSITION || position > MAX_POSITION) {
-        Serial.print(F("Invalid position ("));
-        Serial.print(MIN_POSITION);
-        Serial.print(F("-"));
-        Serial.print(MAX_POSITION);
-        Serial.println(F(")"));
-        return;
-      }
-      
-      // Determine direction based on current position
-      if (position > currentPosition_) {
-        setDirection(FORWARD); // Move forward to higher position
-        targetPosition_ = position;
-      } else if (position < currentPosition_) {
-        setDirection(BACKWARD); // Move backward to lower position
-        targetPosition_ = position;
-      } else {
+    if (position < MIN_POSITION || position > MAX_POSITION) {
+      Serial.print(F("Invalid position ("));
+      Serial.print(MIN_POSITION);
+      Serial.print(F("-"));
+      Serial.print(MAX_POSITION);
+      Serial.println(F(")"));
+      return;
+    }
+    
+    // Busy with a move: queue it behind the current one
+    if (systemState_ == STATE_MOVING_TO_TARGET) {
+      queueMove(position);
+      return;
+    }
+    
+    if (accepts(CMD_MOVE)) {
+      if (position == motion_.position) {
         Serial.println(F("Already at position"));
         return;
       }
       
+      queue_.reset(motion_.position);
+      queue_.push(position);
       systemState_ = STATE_MOVING_TO_TARGET;
       enableMotor(true);
-      currentInterval_ = targetInterval_;  // Use normal speed
+      startNextSegment(0);
       lastStepTime_ = micros();  // Reset timer for proper stepping
       
       Serial.print(F("Moving to: "));
       Serial.print(position);
       Serial.print(F(" from: "));
-      Serial.print(currentPosition_);
+      Serial.print(motion_.position);
       Serial.print(F(" dir: "));
-      Serial.print(flags_.direction == FORWARD ? F("FWD") : F("BWD"));
+      Serial.print(direction() == FORWARD ? F("FWD") : F("BWD"));
       Serial.print(F(" Target Int: "));
       Serial.print(targetInterval_);
       Serial.print(F(" Current Int: "));
-      Serial.println(currentInterval_);
+      Serial.println(motion_.interval);
     } else {
       Serial.print(F("Cannot move - busy, state: "));
       printStateName();
@@ -275,14 +385,15 @@ public:
   
   void stop() {
     enableMotor(false);
+    endHoming();
+    queue_.reset(motion_.position);
     // Go to IDLE from any state when manually stopped
     if (systemState_ != STATE_HOMED && systemState_ != STATE_AT_TARGET && 
         systemState_ != STATE_AT_ORIGIN) {
       systemState_ = STATE_IDLE;
       Serial.println(F("Stopped - returning to IDLE"));
     }
-    printProgmem(MSG_STOPPED);
-    Serial.println();
+    report(MSG_STOPPED);
   }
   
   void setTargetPosition(long position) {
@@ -293,72 +404,84 @@ public:
     }
   }
   
-  long getPosition() const { return currentPosition_; }
+  long getPosition() const { return motion_.position; }
+  
+  // Snapshot with the velocity filled in: a division per call, not per step
+  MotionState getMotionState() const {
+    MotionState state = motion_;
+    state.velocity = motion_.has(MOTION_ENABLED)
+      ? MotionState::velocityFor(motion_.interval, direction() == BACKWARD) : 0;
+    return state;
+  }
+  SystemState getState() const { return systemState_; }
+  bool isMotorEnabled() const { return motion_.has(MOTION_ENABLED); }
+  uint8_t getQueueCount() const { return queue_.getCount(); }
   
   void resetSystem() {
     enableMotor(false);
     systemState_ = STATE_IDLE;
-    currentPosition_ = 0;
-    currentInterval_ = targetInterval_;  // Reset speed to prevent noise
+    motion_.position = 0;
+    endHoming();
+    queue_.reset(0);
+    resyncStallDetection();
+    motion_.interval = targetInterval_;  // Reset speed to prevent noise
     Serial.println(F("STATUS:RESET:0"));
   }
   
+  void printStallStatus() const {
+#if STALL_DETECTION
+    Serial.print(F("STALL:"));  // STALL:error:max error (encoder counts):stalled
+    Serial.print(stall_.getFollowingError());
+    Serial.print(F(":"));
+    Serial.print(stall_.getMaxFollowingError());
+    Serial.print(F(":"));
+    Serial.println(stall_.isStalled() ? 1 : 0);
+#else
+    Serial.println(F("STALL:OFF"));
+#endif
+  }
+  
   void printStatus() const {
     Serial.print(F("STATUS:"));
     printStateName();
     Serial.print(F(":"));
-    Serial.print(currentPosition_);
+    Serial.print(motion_.position);
     Serial.print(F(":"));
-    Serial.println(flags_.motorEnabled ? F("ON") : F("OFF"));
+    Serial.println(motion_.has(MOTION_ENABLED) ? F("ON") : F("OFF"));
   }
   
 private:
+  bool accepts(Command cmd) const {
+    return pgm_read_byte(&STATE_ACCEPTS[systemState_]) & CMD_BIT(cmd);
+  }
+
   void updateStateMachine() {
     switch(systemState_) {
       case STATE_HOMING:
-        if (flags_.movingAwayFromSensor) {
-          // Moving away from sensor - wait until sensor is clear
-          if (!digitalRead(SENSOR_PIN)) {
-            // Sensor cleared - now move back toward it
-            setDirection(BACKWARD);
-            flags_.movingAwayFromSensor = 0;
-            // Sensor cleared - moving toward home (no serial output)
-          }
-        } else {
-          // Moving toward sensor - wait for trigger
-          boolean sensorActive = digitalRead(SENSOR_PIN);
-          
-          // NO SERIAL OUTPUT DURING HOMING MOVEMENT
-          
-          if (sensorActive) {
-            // Sensor triggered - home found
-            currentPosition_ = 0;
-            homePosition_ = 0;
-            systemState_ = STATE_HOMED;
-            enableMotor(false);
-            printProgmem(MSG_HOMED);
-            Serial.println();
-          }
-        }
+        // NO SERIAL OUTPUT DURING HOMING MOVEMENT
+        updateHoming();
         break;
         
       case STATE_MOVING_TO_TARGET:
         // Check if reached target in either direction  
-        if ((flags_.direction == FORWARD && currentPosition_ >= targetPosition_) ||  // Moving forward (increasing)
-            (flags_.direction == BACKWARD && currentPosition_ <= targetPosition_)) {  // Moving backward (decreasing)
+        if ((direction() == FORWARD && motion_.position >= targetPosition_) ||  // Moving forward (increasing)
+            (direction() == BACKWARD && motion_.position <= targetPosition_)) {  // Moving backward (decreasing)
+          // Queued segment: carry on at the planned junction speed
+          uint32_t junction = queue_.getActiveExitSpeed();
+          uint32_t speed = planner_.getCurrentSpeed();
+          if (startNextSegment(junction < speed ? junction : speed)) break;
+          
           systemState_ = STATE_AT_TARGET;
           enableMotor(false);
-          printProgmem(MSG_AT_TARGET);
-          Serial.println();
+          report(MSG_AT_TARGET);
         }
         break;
         
       case STATE_RETURNING:
-        if (currentPosition_ <= homePosition_) {
+        if (motion_.position <= homePosition_) {
           systemState_ = STATE_AT_ORIGIN;
           enableMotor(false);
-          printProgmem(MSG_AT_ORIGIN);
-          Serial.println();
+          report(MSG_AT_ORIGIN);
         }
         break;
         
@@ -371,15 +494,14 @@ private:
     // SENSOR CHECK TEMPORARILY DISABLED - Sensor is damaged
     // Uncomment this block when sensor is replaced:
     /*
-    if (flags_.direction == BACKWARD && digitalRead(SENSOR_PIN)) {
-      if (systemState_ == STATE_HOMING && !flags_.movingAwayFromSensor) {
+    if (direction() == BACKWARD && digitalRead(SENSOR_PIN)) {
+      if (systemState_ == STATE_HOMING && !motion_.has(FLAG_AWAY_FROM_SENSOR)) {
         // Homing: sensor found
-        currentPosition_ = 0;
+        motion_.position = 0;
         homePosition_ = 0;
         systemState_ = STATE_HOMED;
         enableMotor(false);
-        printProgmem(MSG_HOMED);
-        Serial.println();
+        report(MSG_HOMED);
         return;
       } else {
         // Any other backward movement: emergency stop at sensor
@@ -392,7 +514,7 @@ private:
     */
     
     // Check position limits (but not during homing)
-    if (flags_.direction == BACKWARD && currentPosition_ <= 0 && systemState_ != STATE_HOMING) {
+    if (direction() == BACKWARD && motion_.position <= 0 && systemState_ != STATE_HOMING) {
       enableMotor(false);
       Serial.println(F("Position limit: Cannot go below 0"));
       return;
@@ -411,28 +533,201 @@ private:
     // debugStepCount++;
     
     // Update position
-    currentPosition_ += flags_.direction ? -1 : 1;
+    motion_.position += direction() ? -1 : 1;
+    homeSensor_.setPosition(motion_.position);  // No-op unless homing
+    
+#if STALL_DETECTION
+    // Commanded against measured, every step: a stall stops the motor
+    // before the count runs away from the real position
+    if (stall_.onStep(direction() ? -1 : 1)) {
+      handleStall();
+      return;
+    }
+#endif
     
     // NO SERIAL OUTPUT DURING STEPPING
     
-    // No acceleration - just use target speed
-    currentInterval_ = targetInterval_;
+    // Next interval from the ramp; hold the last one when the plan is done
+    unsigned long next = planner_.nextInterval();
+    if (next > 0) motion_.interval = next;
+  }
+  
+  // Plan a ramp over steps; the first interval applies to the first step
+  void startRamp(unsigned long steps, uint32_t entrySpeed = 0, uint32_t exitSpeed = 0) {
+    planner_.plan(steps, entrySpeed, exitSpeed);
+    unsigned long first = planner_.nextInterval();
+    motion_.interval = first > 0 ? first : targetInterval_;
+  }
+  
+  // Start the next queued segment at entrySpeed; false when the queue is empty
+  bool startNextSegment(uint32_t entrySpeed) {
+    MotionSegment segment;
+    if (!queue_.pop(segment)) return false;
+    
+    Direction dir = segment.direction > 0 ? FORWARD : BACKWARD;
+    if (dir != direction()) entrySpeed = 0;  // Reversal: junction speed is 0 anyway
+    setDirection(dir);
+    targetPosition_ = segment.target;
+    startRamp(segment.steps, entrySpeed, segment.exitSpeed);
+    return true;
+  }
+  
+  // Append to the running move; replan it when the look-ahead lets it run on
+  void queueMove(long position) {
+    uint32_t exitBefore = queue_.getActiveExitSpeed();
+    if (!queue_.push(position)) {
+      Serial.println(F("ERROR:QUEUE_FULL"));
+      return;
+    }
+    
+    if (queue_.getActiveExitSpeed() != exitBefore) {
+      // The next step already has its interval: plan the ones after it
+      unsigned long remaining = labs(targetPosition_ - motion_.position);
+      if (remaining > 1) {
+        planner_.plan(remaining - 1, planner_.getCurrentSpeed(), queue_.getActiveExitSpeed());
+      }
+    }
+    Serial.print(F("QUEUED:"));
+    Serial.println(queue_.getCount());
+  }
+  
+  void startHomingPhase(HomingPhase phase) {
+    homingPhase_ = phase;
+    motion_.set(FLAG_AWAY_FROM_SENSOR, phase == HOME_CLEARING || phase == HOME_BACKOFF);
+    
+    switch (phase) {
+      case HOME_FAST:
+      case HOME_SLOW:
+        // Toward the sensor (BACKWARD = toward position 0); distance unknown
+        setSpeedDivisor(phase == HOME_FAST ? 1 : HOMING_SLOW_DIVISOR);
+        setDirection(BACKWARD);
+        homeSensor_.arm();
+        homeSensor_.setPosition(motion_.position);
+        startRamp(MotionPlanner::CONTINUOUS);
+        break;
+        
+      case HOME_STOPPING:
+        planner_.requestStop();  // Shortest ramp; the edge is already latched
+        break;
+        
+      case HOME_CLEARING:
+        setSpeedDivisor(HOMING_SLOW_DIVISOR);
+        setDirection(FORWARD);
+        startRamp(MotionPlanner::CONTINUOUS);
+        break;
+        
+      case HOME_BACKOFF:
+        setSpeedDivisor(1);
+        setDirection(FORWARD);
+        startRamp(homingTarget_ > motion_.position ? homingTarget_ - motion_.position : 0);
+        break;
+    }
+  }
+  
+  void updateHoming() {
+    switch (homingPhase_) {
+      case HOME_FAST:
+        if (homeSensor_.isCaptured()) startHomingPhase(HOME_STOPPING);
+        break;
+        
+      case HOME_STOPPING:
+        if (planner_.isDone()) {
+          homingTarget_ = homeSensor_.getCapturedPosition() + SENSOR_BACKOFF_STEPS;
+          startHomingPhase(HOME_BACKOFF);
+        }
+        break;
+        
+      case HOME_CLEARING:
+        if (!homeSensor_.isActive()) {
+          homingTarget_ = motion_.position + SENSOR_BACKOFF_STEPS;
+          startHomingPhase(HOME_BACKOFF);
+        }
+        break;
+        
+      case HOME_BACKOFF:
+        if (motion_.position >= homingTarget_) {
+          // Sensor wider than the backoff: off it first, or there is no edge
+          startHomingPhase(homeSensor_.isActive() ? HOME_CLEARING : HOME_SLOW);
+        }
+        break;
+        
+      case HOME_SLOW:
+        if (homeSensor_.isCaptured()) {
+          // Zero is the edge itself, not where the motor came to rest
+          motion_.position -= homeSensor_.getCapturedPosition();
+          homePosition_ = 0;
+          endHoming();
+          resyncStallDetection();
+          systemState_ = STATE_HOMED;
+          enableMotor(false);
+          report(MSG_HOMED);
+        }
+        break;
+    }
+  }
+  
+  // Homing finished or interrupted: normal speed, capture off
+  void endHoming() {
+    homeSensor_.disarm();
+    motion_.set(FLAG_AWAY_FROM_SENSOR, false);
+    setSpeedDivisor(1);
+  }
+  
+  void setSpeedDivisor(uint8_t divisor) {
+    MotionLimits limits = planner_.getLimits();
+    limits.maxSpeed = maxSpeed_ / divisor;
+    planner_.setLimits(limits);
+  }
+  
+  // The position is known again (homed / reset): measure from here
+  void resyncStallDetection() {
+#if STALL_DETECTION
+    stall_.reset(motion_.position);
+#endif
+  }
+  
+#if STALL_DETECTION
+  // Stop, take the measured position and require a new HOME
+  void handleStall() {
+    enableMotor(false);
+    endHoming();
+    long commanded = motion_.position;
+    if (stall_.getReason() == StallReason::FOLLOWING_ERROR) {
+      motion_.position = stall_.getMeasuredPosition();
+    }
+    queue_.reset(motion_.position);
+    systemState_ = STATE_ERROR;
+    
+    if (binaryMessages_) {
+      report(MSG_STALL);  // Reason and positions: STALL or the status block
+      return;
+    }
+    Messages::print(Serial, MSG_STALL);  // ERROR:STALL:reason:commanded:measured
+    Serial.print(stall_.getReason() == StallReason::DRIVER_FAULT ? F(":FAULT:") : F(":FOLLOWING:"));
+    Serial.print(commanded);
+    Serial.print(F(":"));
+    Serial.println(motion_.position);
   }
+#endif
   
   void enableMotor(bool enable) {
-    flags_.motorEnabled = enable;
+    motion_.set(MOTION_ENABLED, enable);
     // YOUR TB6600 uses HIGH to enable, LOW to disable (same as version 1b)
     digitalWrite(ENABLE_PIN, enable ? HIGH : LOW);
   }
   
+  Direction direction() const {
+    return motion_.has(MOTION_REVERSE) ? BACKWARD : FORWARD;
+  }
+  
   void setDirection(Direction dir) {
-    if (flags_.direction != dir) {
-      flags_.direction = dir;
+    if (direction() != dir) {
+      motion_.set(MOTION_REVERSE, dir == BACKWARD);
       delayMicroseconds(DIRECTION_SETUP_TIME_US);
     }
     // Always set the pin based on current direction
     // Hardware: HIGH moves away from sensor, LOW moves toward sensor
-    digitalWrite(DIR_PIN, flags_.direction == FORWARD ? HIGH : LOW);
+    digitalWrite(DIR_PIN, direction() == FORWARD ? HIGH : LOW);
   }
   
   void printStateName() const {
@@ -448,30 +743,277 @@ private:
     }
   }
   
-  void printProgmem(const char* msg) const {
-    char buffer[30];
-    strcpy_P(buffer, msg);
-    Serial.print(buffer);
+public:
+  // Binary mode: status messages are queued for OP_MESSAGE frames instead
+  // of printed; the queue is emptied when the mode changes
+  void setBinaryMessages(bool binary) {
+    binaryMessages_ = binary;
+    messageTail_ = messageHead_;
+  }
+  
+  bool peekMessage(uint8_t& id) const {
+    if (messageTail_ == messageHead_) return false;
+    id = messages_[messageTail_];
+    return true;
+  }
+  
+  void popMessage() {
+    if (messageTail_ != messageHead_) messageTail_ = (messageTail_ + 1) & (MESSAGE_QUEUE_SIZE - 1);
+  }
+  
+private:
+  void report(Message id) {
+    if (!binaryMessages_) {
+      Messages::println(Serial, id);  // Straight from flash
+      return;
+    }
+    uint8_t next = (messageHead_ + 1) & (MESSAGE_QUEUE_SIZE - 1);
+    if (next == messageTail_) return;  // Host not reading: drop the newest
+    messages_[messageHead_] = id;
+    messageHead_ = next;
   }
 };
 
 // === COMMAND PROCESSOR ===
+// === TEXT COMMANDS ===
+// Arguments arrive in place: the rest of the line after the command word
+void cmdHome(StepperController& c, const char*) { c.startHoming(); }
+void cmdTarget(StepperController& c, const char*) { c.moveToTarget(); }
+void cmdReturn(StepperController& c, const char*) { c.returnToOrigin(); }
+void cmdCycle(StepperController& c, const char*) { c.runCycle(); }
+void cmdStop(StepperController& c, const char*) { c.stop(); }
+void cmdStatus(StepperController& c, const char*) { c.printStatus(); }
+void cmdSet(StepperController& c, const char* args) { c.setTargetPosition(atol(args)); }
+void cmdGoto(StepperController& c, const char* args) { c.moveToPosition(atol(args)); }
+void cmdReset(StepperController& c, const char*) { c.resetSystem(); }
+void cmdStall(StepperController& c, const char*) { c.printStallStatus(); }
+
+void cmdPos(StepperController& c, const char*) {
+  Serial.print(F("Position: "));
+  Serial.println(c.getPosition());
+}
+
+void cmdHelp(StepperController&, const char*) {
+  Serial.println(F("COMMANDS:HOME,TARGET,RETURN,CYCLE,GOTO,SET,STOP,RESET,STATUS,POS,STALL,HELP"));
+}
+
+// Names are only used at compile time to build the hash table
+constexpr CommandDef<StepperController> TEXT_COMMANDS[] = {
+  {"HOME", &cmdHome},
+  {"TARGET", &cmdTarget},
+  {"RETURN", &cmdReturn},
+  {"CYCLE", &cmdCycle},
+  {"STOP", &cmdStop},
+  {"STATUS", &cmdStatus},
+  {"POS", &cmdPos},
+  {"SET", &cmdSet},
+  {"GOTO", &cmdGoto},
+  {"RESET", &cmdReset},
+  {"STALL", &cmdStall},
+  {"HELP", &cmdHelp},
+};
+typedef CommandTable<StepperController, TEXT_COMMANDS,
+                     sizeof(TEXT_COMMANDS) / sizeof(TEXT_COMMANDS[0])> TextCommands;
+
+// === BINARY PROTOCOL ===
+// Frame: 0x00, COBS([opcode][seq][payload][crc16 hi][crc16 lo]), 0x00
+// CRC-16/CCITT-FALSE over opcode..payload; integers big endian.
+// A 0x00 byte switches the processor to binary mode, OP_TEXT_MODE back.
+#define FRAME_MAX_RAW 16                          // opcode + seq + payload + crc
+#define FRAME_MAX_ENCODED (FRAME_MAX_RAW + 2)     // COBS overhead for short frames
+#define TX_RING_SIZE 64                           // Power of two
+
+enum Opcode : uint8_t {
+  OP_HOME = 0x01,
+  OP_TARGET = 0x02,
+  OP_RETURN = 0x03,
+  OP_CYCLE = 0x04,
+  OP_STOP = 0x05,
+  OP_RESET = 0x06,
+  OP_GOTO = 0x07,         // int32 position
+  OP_SET = 0x08,          // int32 target for OP_TARGET
+  OP_STATUS = 0x09,
+  OP_TELEMETRY = 0x0A,    // uint16 period in ms, 0 = off
+  OP_TEXT_MODE = 0x0B,
+  OP_MEMORY = 0x0C,       // Reply carries the memory block instead of the status
+  OP_DICTIONARY = 0x0D,   // Reply carries the message count and dictionary hash
+  OP_NAK = 0x7F,          // uint8 error
+  OP_REPLY = 0x80,        // OR-ed with the request opcode, payload = status
+  OP_TELEMETRY_DATA = 0xC0,
+  OP_MESSAGE = 0xC1       // uint8 message ID, instead of the status text
+};
+
+enum FrameError : uint8_t {
+  FRAME_ERR_CRC = 1,
+  FRAME_ERR_OPCODE = 2,
+  FRAME_ERR_LENGTH = 3,
+  FRAME_ERR_FULL = 4
+};
+
+// [opcode - 1] -> payload length, so every frame is checked before dispatch
+const uint8_t OPCODE_PAYLOAD[] PROGMEM = {
+  /* OP_HOME      */ 0,
+  /* OP_TARGET    */ 0,
+  /* OP_RETURN    */ 0,
+  /* OP_CYCLE     */ 0,
+  /* OP_STOP      */ 0,
+  /* OP_RESET     */ 0,
+  /* OP_GOTO      */ 4,
+  /* OP_SET       */ 4,
+  /* OP_STATUS    */ 0,
+  /* OP_TELEMETRY */ 2,
+  /* OP_TEXT_MODE */ 0,
+  /* OP_MEMORY    */ 0,
+  /* OP_DICTIONARY */ 0
+};
+
+// CRC-16/CCITT-FALSE, nibble table: 32 bytes of flash instead of 512
+const uint16_t CRC16_NIBBLE[16] PROGMEM = {
+  0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+  0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+};
+
+uint16_t crc16(const uint8_t* data, uint8_t length) {
+  uint16_t crc = 0xFFFF;
+  for (uint8_t i = 0; i < length; i++) {
+    crc = (crc << 4) ^ pgm_read_word(&CRC16_NIBBLE[(crc >> 12) ^ (data[i] >> 4)]);
+    crc = (crc << 4) ^ pgm_read_word(&CRC16_NIBBLE[(crc >> 12) ^ (data[i] & 0x0F)]);
+  }
+  return crc;
+}
+
+// COBS: replaces every 0x00 so the delimiter is unique. Returns encoded length.
+uint8_t cobsEncode(const uint8_t* in, uint8_t length, uint8_t* out) {
+  uint8_t codeIndex = 0;
+  uint8_t code = 1;
+  uint8_t o = 1;
+  for (uint8_t i = 0; i < length; i++) {
+    if (in[i] == 0) {
+      out[codeIndex] = code;
+      codeIndex = o++;
+      code = 1;
+    } else {
+      out[o++] = in[i];
+      if (++code == 0xFF) {
+        out[codeIndex] = code;
+        codeIndex = o++;
+        code = 1;
+      }
+    }
+  }
+  out[codeIndex] = code;
+  return o;
+}
+
+// Returns decoded length, 0 on a malformed frame
+uint8_t cobsDecode(const uint8_t* in, uint8_t length, uint8_t* out) {
+  uint8_t o = 0;
+  uint8_t i = 0;
+  while (i < length) {
+    uint8_t code = in[i++];
+    if (code == 0 || i + code - 1 > length) return 0;
+    for (uint8_t k = 1; k < code; k++) out[o++] = in[i++];
+    if (code != 0xFF && i < length) out[o++] = 0;
+  }
+  return o;
+}
+
+// Whole frames in a ring, sent only when the UART buffer takes the frame
+// in one go, so loop() never blocks and text output cannot split a frame
+class FrameTx {
+private:
+  uint8_t ring_[TX_RING_SIZE];
+  uint8_t head_;
+  uint8_t tail_;
+  
+public:
+  FrameTx() : head_(0), tail_(0) {}
+  
+  uint8_t used() const { return (uint8_t)(head_ - tail_) & (TX_RING_SIZE - 1); }
+  
+  bool send(uint8_t opcode, uint8_t seq, const uint8_t* payload, uint8_t length) {
+    uint8_t raw[FRAME_MAX_RAW];
+    uint8_t encoded[FRAME_MAX_ENCODED];
+    if (length > FRAME_MAX_RAW - 4) return false;
+    
+    raw[0] = opcode;
+    raw[1] = seq;
+    memcpy(raw + 2, payload, length);
+    uint16_t crc = crc16(raw, length + 2);
+    raw[length + 2] = crc >> 8;
+    raw[length + 3] = crc & 0xFF;
+    
+    uint8_t n = cobsEncode(raw, length + 4, encoded);
+    if (used() + n + 3 > TX_RING_SIZE - 1) return false;  // Length byte + 2 delimiters
+    
+    put(n + 2);
+    put(0);
+    for (uint8_t i = 0; i < n; i++) put(encoded[i]);
+    put(0);
+    return true;
+  }
+  
+  void drain() {
+    while (head_ != tail_) {
+      uint8_t length = ring_[tail_];
+      if (Serial.availableForWrite() < length) return;
+      tail_ = (tail_ + 1) & (TX_RING_SIZE - 1);
+      for (uint8_t i = 0; i < length; i++) {
+        Serial.write(ring_[tail_]);
+        tail_ = (tail_ + 1) & (TX_RING_SIZE - 1);
+      }
+    }
+  }
+  
+private:
+  void put(uint8_t b) {
+    ring_[head_] = b;
+    head_ = (head_ + 1) & (TX_RING_SIZE - 1);
+  }
+};
+
+// Stack high-water mark and buffer peaks, read with OP_MEMORY
+MemoryMonitor memory;
+uint8_t memoryTx;
+uint8_t memoryQueue;
+
 class CommandProcessor {
 private:
   StepperController& controller_;
   char commandBuffer_[20];
   uint8_t bufferIndex_;
   
+  // Binary mode
+  FrameTx tx_;
+  uint8_t frame_[FRAME_MAX_ENCODED];
+  uint8_t frameIndex_;
+  bool binaryMode_;
+  bool frameOverflow_;
+  uint8_t telemetrySeq_;
+  uint8_t messageSeq_;
+  uint16_t telemetryPeriod_;
+  unsigned long lastTelemetry_;
+  
 public:
   CommandProcessor(StepperController& controller) : 
     controller_(controller),
-    bufferIndex_(0) {}
+    bufferIndex_(0),
+    tx_(),
+    frameIndex_(0),
+    binaryMode_(false),
+    frameOverflow_(false),
+    telemetrySeq_(0),
+    messageSeq_(0),
+    telemetryPeriod_(0),
+    lastTelemetry_(0) {}
   
   void processSerial() {
     while (Serial.available()) {
       char c = Serial.read();
       
-      if (c == '\n' || c == '\r') {
+      if (binaryMode_ || c == 0) {
+        receiveFrameByte((uint8_t)c);
+      } else if (c == '\n' || c == '\r') {
         if (bufferIndex_ > 0) {
           commandBuffer_[bufferIndex_] = '\0';
           executeCommand();
@@ -481,42 +1023,163 @@ public:
         commandBuffer_[bufferIndex_++] = toupper(c);
       }
     }
+    
+    sendTelemetry();
+    sendMessages();
+    memory.setLevel(memoryTx, tx_.used());
+    tx_.drain();
   }
   
 private:
-  void executeCommand() {
-    if (strcmp(commandBuffer_, "HOME") == 0) {
-      controller_.startHoming();
-    } else if (strcmp(commandBuffer_, "TARGET") == 0) {
-      controller_.moveToTarget();
-    } else if (strcmp(commandBuffer_, "RETURN") == 0) {
-      controller_.returnToOrigin();
-    } else if (strcmp(commandBuffer_, "CYCLE") == 0) {
-      controller_.runCycle();
-    } else if (strcmp(commandBuffer_, "STOP") == 0) {
-      controller_.stop();
-    } else if (strcmp(commandBuffer_, "STATUS") == 0) {
-      controller_.printStatus();
-    } else if (strcmp(commandBuffer_, "POS") == 0) {
-      Serial.print(F("Position: "));
-      Serial.println(controller_.getPosition());
-    } else if (strncmp(commandBuffer_, "SET ", 4) == 0) {
-      long value = atol(commandBuffer_ + 4);
-      controller_.setTargetPosition(value);
-    } else if (strncmp(commandBuffer_, "GOTO ", 5) == 0) {
-      long position = atol(commandBuffer_ + 5);
-      controller_.moveToPosition(position);
-    } else if (strcmp(commandBuffer_, "RESET") == 0) {
-      controller_.resetSystem();
-    } else if (strcmp(commandBuffer_, "HELP") == 0) {
-      printHelp();
-    } else {
-      Serial.println(F("ERROR:UNKNOWN_COMMAND"));
+  // === Binary mode ===
+  void receiveFrameByte(uint8_t b) {
+    if (!binaryMode_) controller_.setBinaryMessages(true);
+    binaryMode_ = true;
+    if (b != 0) {
+      if (frameIndex_ < sizeof(frame_)) frame_[frameIndex_++] = b;
+      else frameOverflow_ = true;
+      return;
+    }
+    
+    // Delimiter: a frame is complete (empty ones are just sync)
+    if (frameIndex_ > 0) {
+      if (frameOverflow_) sendNak(0, FRAME_ERR_LENGTH);
+      else handleFrame();
     }
+    frameIndex_ = 0;
+    frameOverflow_ = false;
   }
   
-  void printHelp() {
-    Serial.println(F("COMMANDS:HOME,TARGET,RETURN,CYCLE,GOTO,SET,STOP,RESET,STATUS,POS,HELP"));
+  void handleFrame() {
+    uint8_t raw[FRAME_MAX_ENCODED];
+    uint8_t length = cobsDecode(frame_, frameIndex_, raw);
+    if (length < 4) {
+      sendNak(0, FRAME_ERR_LENGTH);
+      return;
+    }
+    
+    uint16_t crc = ((uint16_t)raw[length - 2] << 8) | raw[length - 1];
+    if (crc16(raw, length - 2) != crc) {
+      sendNak(0, FRAME_ERR_CRC);
+      return;
+    }
+    
+    uint8_t opcode = raw[0];
+    uint8_t seq = raw[1];
+    uint8_t payloadLength = length - 4;
+    if (opcode < OP_HOME || opcode > OP_DICTIONARY) {
+      sendNak(seq, FRAME_ERR_OPCODE);
+      return;
+    }
+    if (pgm_read_byte(&OPCODE_PAYLOAD[opcode - 1]) != payloadLength) {
+      sendNak(seq, FRAME_ERR_LENGTH);
+      return;
+    }
+    executeOpcode(opcode, raw + 2);
+    if (opcode == OP_MEMORY) sendMemory(OP_REPLY | opcode, seq);
+    else if (opcode == OP_DICTIONARY) sendDictionary(OP_REPLY | opcode, seq);
+    else sendStatus(OP_REPLY | opcode, seq);
+  }
+  
+  void executeOpcode(uint8_t opcode, const uint8_t* payload) {
+    switch (opcode) {
+      case OP_HOME: controller_.startHoming(); break;
+      case OP_TARGET: controller_.moveToTarget(); break;
+      case OP_RETURN: controller_.returnToOrigin(); break;
+      case OP_CYCLE: controller_.runCycle(); break;
+      case OP_STOP: controller_.stop(); break;
+      case OP_RESET: controller_.resetSystem(); break;
+      case OP_GOTO: controller_.moveToPosition(readInt32(payload)); break;
+      case OP_SET: controller_.setTargetPosition(readInt32(payload)); break;
+      case OP_STATUS: break;  // The reply carries the status
+      case OP_TELEMETRY:
+        telemetryPeriod_ = ((uint16_t)payload[0] << 8) | payload[1];
+        lastTelemetry_ = millis();
+        break;
+      case OP_TEXT_MODE:
+        binaryMode_ = false;
+        controller_.setBinaryMessages(false);
+        break;
+      default:
+        break;
+    }
+  }
+  
+  // Status block: state, flags (bit 0 = motor on), position, queue count
+  void sendStatus(uint8_t opcode, uint8_t seq) {
+    uint8_t payload[7];
+    long position = controller_.getPosition();
+    payload[0] = controller_.getState();
+    payload[1] = controller_.isMotorEnabled() ? 1 : 0;
+    payload[2] = (uint8_t)(position >> 24);
+    payload[3] = (uint8_t)(position >> 16);
+    payload[4] = (uint8_t)(position >> 8);
+    payload[5] = (uint8_t)position;
+    payload[6] = controller_.getQueueCount();
+    tx_.send(opcode, seq, payload, sizeof(payload));
+  }
+  
+  // Memory block: static RAM, stack peak, min headroom, free RAM (bytes),
+  // TX ring peak and size (bytes), queue peak and size (moves)
+  void sendMemory(uint8_t opcode, uint8_t seq) {
+    uint8_t payload[12];
+    put16(payload, memory.getStaticRam());
+    put16(payload + 2, memory.getStackPeak());
+    put16(payload + 4, memory.getMinHeadroom());
+    put16(payload + 6, memory.getFreeRam());
+    payload[8] = (uint8_t)memory.getBufferPeak(memoryTx);
+    payload[9] = (uint8_t)memory.getBufferCapacity(memoryTx);
+    payload[10] = (uint8_t)memory.getBufferPeak(memoryQueue);
+    payload[11] = (uint8_t)memory.getBufferCapacity(memoryQueue);
+    tx_.send(opcode, seq, payload, sizeof(payload));
+  }
+  
+  // Dictionary: message count, FNV-1a hash of the message table. A host
+  // with a copy of MESSAGE_TEXTS checks that it matches this firmware
+  void sendDictionary(uint8_t opcode, uint8_t seq) {
+    uint8_t payload[5];
+    uint32_t hash = Messages::dictionaryHash();
+    payload[0] = Messages::SIZE;
+    put16(payload + 1, (uint16_t)(hash >> 16));
+    put16(payload + 3, (uint16_t)hash);
+    tx_.send(opcode, seq, payload, sizeof(payload));
+  }
+  
+  // Status messages as one ID byte; kept queued while the ring is full
+  void sendMessages() {
+    uint8_t id;
+    while (controller_.peekMessage(id) && tx_.send(OP_MESSAGE, messageSeq_, &id, 1)) {
+      controller_.popMessage();
+      messageSeq_++;
+    }
+  }
+  
+  static void put16(uint8_t* p, uint16_t value) {
+    p[0] = value >> 8;
+    p[1] = value & 0xFF;
+  }
+  
+  void sendNak(uint8_t seq, uint8_t error) {
+    tx_.send(OP_NAK, seq, &error, 1);
+  }
+  
+  void sendTelemetry() {
+    if (telemetryPeriod_ == 0) return;
+    unsigned long now = millis();
+    if (now - lastTelemetry_ < telemetryPeriod_) return;
+    lastTelemetry_ = now;
+    sendStatus(OP_TELEMETRY_DATA, telemetrySeq_++);  // Dropped if the ring is full
+  }
+  
+  static long readInt32(const uint8_t* p) {
+    return ((long)p[0] << 24) | ((long)p[1] << 16) | ((long)p[2] << 8) | p[3];
+  }
+  
+  // === Text mode ===
+  void executeCommand() {
+    if (!TextCommands::dispatch(controller_, commandBuffer_)) {
+      Serial.println(F("ERROR:UNKNOWN_COMMAND"));
+    }
   }
 };
 
@@ -524,7 +1187,22 @@ private:
 StepperController stepper;
 CommandProcessor commands(stepper);
 
+// Home sensor edge: the pin-change interrupt of whichever port SENSOR_PIN is on
+#if defined(__AVR__) && defined(PCINT0_vect)
+ISR(PCINT0_vect) { EdgeCapture::onPinChange(); }
+#endif
+#if defined(__AVR__) && defined(PCINT1_vect)
+ISR(PCINT1_vect) { EdgeCapture::onPinChange(); }
+#endif
+#if defined(__AVR__) && defined(PCINT2_vect)
+ISR(PCINT2_vect) { EdgeCapture::onPinChange(); }
+#endif
+
 void setup() {
+  memory.begin();  // First, so the painted area covers everything below
+  memoryTx = memory.addBuffer(TX_RING_SIZE - 1);
+  memoryQueue = memory.addBuffer(MotionQueue::CAPACITY);
+  
   Serial.begin(115200);
   while (!Serial) { ; }
   
@@ -535,4 +1213,6 @@ void setup() {
 void loop() {
   stepper.update();
   commands.processSerial();
+  memory.setLevel(memoryQueue, stepper.getQueueCount());
+  memory.update();
 }
\ No newline at end of file
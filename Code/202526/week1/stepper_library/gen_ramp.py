@@ -0,0 +1,79 @@
+#!/usr/bin/env python3
+"""
+Generates stepper_ramp.h: the acceleration ramp for stepper.c as Timer1
+compare values in PROGMEM.
+
+Entry n is the time between step n+1 and step n+2 when starting from
+standstill with constant acceleration: t(n) = sqrt(2n / a), so the ramp
+is exact and the ISR does no math at all. The table ends at the first
+interval at or below the maximum step rate.
+
+Low level embedded code
+v1.1
+Aug 2025
+Embedded Programming (Prog 5/6)
+
+Usage: python3 gen_ramp.py [--accel 128000] [--max-rate 16000] > stepper_ramp.h
+"""
+
+import argparse
+import math
+
+F_CPU = 16000000
+PRESCALER = 8
+
+
+def ramp_ticks(accel, max_rate):
+    tick_hz = F_CPU / PRESCALER
+    min_ticks = math.ceil(tick_hz / max_rate)
+    ticks = []
+    n = 0
+    while True:
+        t0 = math.sqrt(2.0 * n / accel)
+        t1 = math.sqrt(2.0 * (n + 1) / accel)
+        value = round((t1 - t0) * tick_hz)
+        if value > 0xFFFF:
+            raise SystemExit("acceleration too low: first interval exceeds 16 bits")
+        if value <= min_ticks:
+            break
+        ticks.append(value)
+        n += 1
+    return ticks, min_ticks
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("--accel", type=int, default=128000, help="steps/s^2")
+    parser.add_argument("--max-rate", type=int, default=16000, help="steps/s")
+    args = parser.parse_args()
+
+    ticks, min_ticks = ramp_ticks(args.accel, args.max_rate)
+
+    print("/*")
+    print(" * Stepper Motor Library for ATmega328P")
+    print(" * Acceleration ramp, generated by gen_ramp.py - do not edit")
+    print(" *")
+    print(" * python3 gen_ramp.py --accel %d --max-rate %d" % (args.accel, args.max_rate))
+    print(" */")
+    print()
+    print("#ifndef STEPPER_RAMP_H")
+    print("#define STEPPER_RAMP_H")
+    print()
+    print("#include <avr/pgmspace.h>")
+    print()
+    print("#define STEPPER_RAMP_ACCEL      %dUL  // steps/s^2" % args.accel)
+    print("#define STEPPER_RAMP_MAX_RATE   %dUL  // steps/s" % args.max_rate)
+    print("#define STEPPER_RAMP_MIN_TICKS  %d    // Timer1 ticks (%d MHz / %d)"
+          % (min_ticks, F_CPU // 1000000, PRESCALER))
+    print("#define STEPPER_RAMP_LENGTH     %d" % len(ticks))
+    print()
+    print("static const uint16_t stepper_ramp[STEPPER_RAMP_LENGTH] PROGMEM = {")
+    for i in range(0, len(ticks), 10):
+        print("    " + ", ".join("%5d" % t for t in ticks[i:i + 10]) + ",")
+    print("};")
+    print()
+    print("#endif // STEPPER_RAMP_H")
+
+
+if __name__ == "__main__":
+    main()
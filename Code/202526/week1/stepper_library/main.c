@@ -3,7 +3,7 @@
  * ATmega328P
  * 
  * Low level embedded code
- * v1.0
+ * v1.1
  * Aug 2025
  * Embedded Programming (Prog 5/6)
  */
@@ -17,7 +17,7 @@ int main(void) {
     
     // Main loop
     while(1) {
-        // Example 1: Move 1 revolution clockwise at 60 RPM
+        // Example 1: Move 1 revolution clockwise at 60 RPM (ramps up and down)
         stepper_set_direction(STEPPER_DIR_CW);
         stepper_move_revolutions(1, 60);
         _delay_ms(500);
@@ -39,7 +39,15 @@ int main(void) {
         }
         _delay_ms(1000);
         
-        // Example 5: Disable motor for 2 seconds (saves power)
+        // Example 5: 5 revolutions at 300 RPM in the background
+        stepper_set_direction(STEPPER_DIR_CCW);
+        stepper_start_move(5UL * STEPS_PER_REV, 300);
+        while (stepper_is_busy()) {
+            // Free for other work: Timer1 generates every step
+        }
+        _delay_ms(500);
+        
+        // Example 6: Disable motor for 2 seconds (saves power)
         stepper_enable(false);
         _delay_ms(2000);
         stepper_enable(true);
@@ -3,14 +3,26 @@
  * Implementation file
  * 
  * Low level embedded code
- * v1.0
+ * v1.1 - Timer1 driven moves with a precomputed acceleration ramp
  * Aug 2025
  * Embedded Programming (Prog 5/6)
  */
 
 #include "stepper.h"
+#include "stepper_ramp.h"
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+#include <util/atomic.h>
 #include <util/delay.h>
 
+#define TIMER_TICKS_PER_MINUTE  (60UL * (F_CPU / STEPPER_TIMER_PRESCALER))
+
+// Move state, shared with the Timer1 ISRs
+static volatile uint32_t steps_left;      // Steps still to be issued
+static volatile uint16_t ramp_index;      // Ramp entries used = steps needed to stop
+static volatile uint16_t cruise_ticks;    // Interval at the requested speed
+static volatile bool busy;
+
 // Initialize stepper motor pins and settings
 void stepper_init(void) {
     // Set pins as outputs
@@ -77,34 +89,99 @@ void stepper_move_steps(uint16_t steps, uint16_t delay_us) {
     }
 }
 
-// Move a specific number of revolutions at given RPM
+// Move a specific number of revolutions at given RPM (accelerated, exact timing)
 void stepper_move_revolutions(uint8_t revolutions, uint16_t rpm) {
-    // Calculate delay between steps for desired RPM
-    // delay_us = (60 * 1000000) / (rpm * steps_per_rev)
-    uint32_t delay_us = 60000000UL / ((uint32_t)rpm * STEPS_PER_REV);
+    stepper_start_move((uint32_t)revolutions * STEPS_PER_REV, rpm);
+    stepper_wait();
+}
+
+// Start a move in the background; the first step follows right away
+void stepper_start_move(uint32_t steps, uint16_t rpm) {
+    if (steps == 0 || rpm == 0) {
+        return;
+    }
+    stepper_wait();  // One move at a time
     
-    // Total steps for requested revolutions
-    uint32_t total_steps = (uint32_t)revolutions * STEPS_PER_REV;
+    // The only division: once per move, not per step
+    uint32_t ticks = TIMER_TICKS_PER_MINUTE / ((uint32_t)rpm * STEPS_PER_REV);
+    if (ticks < STEPPER_RAMP_MIN_TICKS) {
+        ticks = STEPPER_RAMP_MIN_TICKS;
+    } else if (ticks > 0xFFFF) {
+        ticks = 0xFFFF;
+    }
     
-    // Move the motor
-    for (uint32_t i = 0; i < total_steps; i++) {
-        stepper_step();
-        
-        // Handle delays (same as in stepper_move_steps)
-        if (delay_us > 255) {
-            uint16_t ms = delay_us / 1000;
-            uint16_t us = delay_us % 1000;
-            for (uint16_t j = 0; j < ms; j++) {
-                _delay_ms(1);
-            }
-            if (us > 255) {
-                _delay_us(255);
-                _delay_us(us - 255);
-            } else if (us > 0) {
-                _delay_us(us);
-            }
-        } else {
-            _delay_us(delay_us);
+    cruise_ticks = (uint16_t)ticks;
+    ramp_index = 0;
+    steps_left = steps;
+    busy = true;
+    
+    // CTC on OCR1A: COMPA raises STEP, COMPB lowers it after the pulse width
+    TCCR1A = 0;
+    TCCR1B = (1 << WGM12);
+    TCNT1 = 0;
+    OCR1A = STEPPER_PULSE_TICKS * 2;  // First step almost immediately
+    OCR1B = STEPPER_PULSE_TICKS;
+    TIFR1 = (1 << OCF1A) | (1 << OCF1B);
+    TIMSK1 = (1 << OCIE1A) | (1 << OCIE1B);
+    TCCR1B |= (1 << CS11);  // Start, prescaler 8
+    sei();
+}
+
+bool stepper_is_busy(void) {
+    return busy;
+}
+
+void stepper_stop(void) {
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        // Stopping within the steps spent accelerating retraces the ramp
+        if (busy && steps_left > ramp_index) {
+            steps_left = ramp_index;
         }
     }
+}
+
+void stepper_wait(void) {
+    set_sleep_mode(SLEEP_MODE_IDLE);  // Timer1 keeps running, CPU sleeps
+    while (busy) {
+        sleep_mode();
+    }
+}
+
+// Step edge, then the interval until the next step (no math, table lookup)
+ISR(TIMER1_COMPA_vect) {
+    if (steps_left == 0) {
+        return;  // Last pulse still ending, COMPB stops the timer
+    }
+    PORTD |= STEP_MASK;
+    
+    uint32_t left = steps_left - 1;
+    steps_left = left;
+    if (left == 0) {
+        return;
+    }
+    
+    uint16_t index = ramp_index;
+    uint16_t next;
+    if (left <= index) {
+        // Decelerate: walk back down the ramp, the last interval is entry 0
+        index = (uint16_t)left - 1;
+        next = pgm_read_word(&stepper_ramp[index]);
+    } else if (index < STEPPER_RAMP_LENGTH && pgm_read_word(&stepper_ramp[index]) > cruise_ticks) {
+        next = pgm_read_word(&stepper_ramp[index]);
+        index++;
+    } else {
+        next = cruise_ticks;
+    }
+    ramp_index = index;
+    OCR1A = next - 1;  // CTC period is OCR1A + 1 ticks
+}
+
+// End of the step pulse; stops the timer after the last step
+ISR(TIMER1_COMPB_vect) {
+    PORTD &= ~STEP_MASK;
+    if (steps_left == 0) {
+        TCCR1B = 0;
+        TIMSK1 &= ~((1 << OCIE1A) | (1 << OCIE1B));
+        busy = false;
+    }
 }
\ No newline at end of file
@@ -3,7 +3,7 @@
  * Header file
  * 
  * Low level embedded code
- * v1.0
+ * v1.1 - Timer1 driven moves with a precomputed acceleration ramp
  * Aug 2025
  * Embedded Programming (Prog 5/6)
  */
@@ -13,6 +13,7 @@
 
 #include <avr/io.h>
 #include <stdbool.h>
+#include <stdint.h>
 
 // Pin definitions (ATmega328P)
 #define STEP_PIN    7  // PD7 - TB6600 PUL
@@ -28,6 +29,10 @@
 #define MICROSTEPS          16
 #define STEPS_PER_REV       (FULL_STEPS_PER_REV * MICROSTEPS)
 
+// Timer1 step generation (prescaler 8: 0.5 us per tick at 16 MHz)
+#define STEPPER_TIMER_PRESCALER  8
+#define STEPPER_PULSE_TICKS      10  // 5 us STEP high (TB6600 needs >= 2.2 us)
+
 // Direction enum
 typedef enum {
     STEPPER_DIR_CW = 0,   // Clockwise
@@ -42,4 +47,12 @@ void stepper_step(void);
 void stepper_move_steps(uint16_t steps, uint16_t delay_us);
 void stepper_move_revolutions(uint8_t revolutions, uint16_t rpm);
 
+// Non-blocking moves: Timer1 CTC interrupts generate the steps, ramping up
+// and down along the table in stepper_ramp.h (uses Timer1, so no PWM on
+// D9/D10). Speeds above the ramp's maximum rate are clamped.
+void stepper_start_move(uint32_t steps, uint16_t rpm);
+bool stepper_is_busy(void);
+void stepper_stop(void);      // Decelerate along the ramp, then stop
+void stepper_wait(void);      // Sleep (idle mode) until the move is done
+
 #endif // STEPPER_H
\ No newline at end of file
@@ -0,0 +1,121 @@
+/*
+ * Stepper Motor Library for ATmega328P
+ * Acceleration ramp, generated by gen_ramp.py - do not edit
+ *
+ * python3 gen_ramp.py --accel 128000 --max-rate 16000
+ */
+
+#ifndef STEPPER_RAMP_H
+#define STEPPER_RAMP_H
+
+#include <avr/pgmspace.h>
+
+#define STEPPER_RAMP_ACCEL      128000UL  // steps/s^2
+#define STEPPER_RAMP_MAX_RATE   16000UL  // steps/s
+#define STEPPER_RAMP_MIN_TICKS  125    // Timer1 ticks (16 MHz / 8)
+#define STEPPER_RAMP_LENGTH     992
+
+static const uint16_t stepper_ramp[STEPPER_RAMP_LENGTH] PROGMEM = {
+     7906,  3275,  2513,  2118,  1866,  1687,  1552,  1444,  1356,  1283,
+     1220,  1166,  1118,  1076,  1038,  1004,   973,   945,   919,   895,
+      873,   853,   833,   815,   799,   783,   768,   754,   740,   728,
+      716,   704,   693,   683,   673,   663,   654,   646,   637,   629,
+      621,   614,   606,   599,   593,   586,   580,   574,   568,   562,
+      556,   551,   546,   540,   535,   531,   526,   521,   517,   512,
+      508,   504,   500,   496,   492,   488,   485,   481,   478,   474,
+      471,   467,   464,   461,   458,   455,   452,   449,   446,   443,
+      441,   438,   435,   433,   430,   427,   425,   423,   420,   418,
+      416,   413,   411,   409,   407,   404,   402,   400,   398,   396,
+      394,   392,   390,   389,   387,   385,   383,   381,   379,   378,
+      376,   374,   373,   371,   369,   368,   366,   365,   363,   362,
+      360,   359,   357,   356,   354,   353,   351,   350,   349,   347,
+      346,   345,   343,   342,   341,   340,   338,   337,   336,   335,
+      333,   332,   331,   330,   329,   328,   327,   325,   324,   323,
+      322,   321,   320,   319,   318,   317,   316,   315,   314,   313,
+      312,   311,   310,   309,   308,   307,   306,   305,   305,   304,
+      303,   302,   301,   300,   299,   298,   298,   297,   296,   295,
+      294,   293,   293,   292,   291,   290,   289,   289,   288,   287,
+      286,   286,   285,   284,   283,   283,   282,   281,   281,   280,
+      279,   278,   278,   277,   276,   276,   275,   274,   274,   273,
+      272,   272,   271,   271,   270,   269,   269,   268,   267,   267,
+      266,   266,   265,   264,   264,   263,   263,   262,   261,   261,
+      260,   260,   259,   259,   258,   258,   257,   256,   256,   255,
+      255,   254,   254,   253,   253,   252,   252,   251,   251,   250,
+      250,   249,   249,   248,   248,   247,   247,   246,   246,   245,
+      245,   244,   244,   244,   243,   243,   242,   242,   241,   241,
+      240,   240,   239,   239,   239,   238,   238,   237,   237,   236,
+      236,   236,   235,   235,   234,   234,   234,   233,   233,   232,
+      232,   232,   231,   231,   230,   230,   230,   229,   229,   228,
+      228,   228,   227,   227,   227,   226,   226,   225,   225,   225,
+      224,   224,   224,   223,   223,   223,   222,   222,   221,   221,
+      221,   220,   220,   220,   219,   219,   219,   218,   218,   218,
+      217,   217,   217,   216,   216,   216,   215,   215,   215,   215,
+      214,   214,   214,   213,   213,   213,   212,   212,   212,   211,
+      211,   211,   211,   210,   210,   210,   209,   209,   209,   208,
+      208,   208,   208,   207,   207,   207,   206,   206,   206,   206,
+      205,   205,   205,   205,   204,   204,   204,   203,   203,   203,
+      203,   202,   202,   202,   202,   201,   201,   201,   201,   200,
+      200,   200,   200,   199,   199,   199,   199,   198,   198,   198,
+      198,   197,   197,   197,   197,   196,   196,   196,   196,   195,
+      195,   195,   195,   194,   194,   194,   194,   193,   193,   193,
+      193,   193,   192,   192,   192,   192,   191,   191,   191,   191,
+      191,   190,   190,   190,   190,   189,   189,   189,   189,   189,
+      188,   188,   188,   188,   187,   187,   187,   187,   187,   186,
+      186,   186,   186,   186,   185,   185,   185,   185,   185,   184,
+      184,   184,   184,   184,   183,   183,   183,   183,   183,   182,
+      182,   182,   182,   182,   181,   181,   181,   181,   181,   181,
+      180,   180,   180,   180,   180,   179,   179,   179,   179,   179,
+      178,   178,   178,   178,   178,   178,   177,   177,   177,   177,
+      177,   177,   176,   176,   176,   176,   176,   175,   175,   175,
+      175,   175,   175,   174,   174,   174,   174,   174,   174,   173,
+      173,   173,   173,   173,   173,   172,   172,   172,   172,   172,
+      172,   171,   171,   171,   171,   171,   171,   170,   170,   170,
+      170,   170,   170,   170,   169,   169,   169,   169,   169,   169,
+      168,   168,   168,   168,   168,   168,   168,   167,   167,   167,
+      167,   167,   167,   167,   166,   166,   166,   166,   166,   166,
+      165,   165,   165,   165,   165,   165,   165,   164,   164,   164,
+      164,   164,   164,   164,   164,   163,   163,   163,   163,   163,
+      163,   163,   162,   162,   162,   162,   162,   162,   162,   161,
+      161,   161,   161,   161,   161,   161,   161,   160,   160,   160,
+      160,   160,   160,   160,   159,   159,   159,   159,   159,   159,
+      159,   159,   158,   158,   158,   158,   158,   158,   158,   158,
+      157,   157,   157,   157,   157,   157,   157,   157,   156,   156,
+      156,   156,   156,   156,   156,   156,   155,   155,   155,   155,
+      155,   155,   155,   155,   155,   154,   154,   154,   154,   154,
+      154,   154,   154,   153,   153,   153,   153,   153,   153,   153,
+      153,   153,   152,   152,   152,   152,   152,   152,   152,   152,
+      152,   151,   151,   151,   151,   151,   151,   151,   151,   151,
+      150,   150,   150,   150,   150,   150,   150,   150,   150,   149,
+      149,   149,   149,   149,   149,   149,   149,   149,   149,   148,
+      148,   148,   148,   148,   148,   148,   148,   148,   147,   147,
+      147,   147,   147,   147,   147,   147,   147,   147,   146,   146,
+      146,   146,   146,   146,   146,   146,   146,   146,   145,   145,
+      145,   145,   145,   145,   145,   145,   145,   145,   144,   144,
+      144,   144,   144,   144,   144,   144,   144,   144,   144,   143,
+      143,   143,   143,   143,   143,   143,   143,   143,   143,   142,
+      142,   142,   142,   142,   142,   142,   142,   142,   142,   142,
+      141,   141,   141,   141,   141,   141,   141,   141,   141,   141,
+      141,   141,   140,   140,   140,   140,   140,   140,   140,   140,
+      140,   140,   140,   139,   139,   139,   139,   139,   139,   139,
+      139,   139,   139,   139,   139,   138,   138,   138,   138,   138,
+      138,   138,   138,   138,   138,   138,   137,   137,   137,   137,
+      137,   137,   137,   137,   137,   137,   137,   137,   137,   136,
+      136,   136,   136,   136,   136,   136,   136,   136,   136,   136,
+      136,   135,   135,   135,   135,   135,   135,   135,   135,   135,
+      135,   135,   135,   135,   134,   134,   134,   134,   134,   134,
+      134,   134,   134,   134,   134,   134,   134,   133,   133,   133,
+      133,   133,   133,   133,   133,   133,   133,   133,   133,   133,
+      132,   132,   132,   132,   132,   132,   132,   132,   132,   132,
+      132,   132,   132,   132,   131,   131,   131,   131,   131,   131,
+      131,   131,   131,   131,   131,   131,   131,   130,   130,   130,
+      130,   130,   130,   130,   130,   130,   130,   130,   130,   130,
+      130,   130,   129,   129,   129,   129,   129,   129,   129,   129,
+      129,   129,   129,   129,   129,   129,   128,   128,   128,   128,
+      128,   128,   128,   128,   128,   128,   128,   128,   128,   128,
+      128,   127,   127,   127,   127,   127,   127,   127,   127,   127,
+      127,   127,   127,   127,   127,   127,   126,   126,   126,   126,
+      126,   126,   126,   126,   126,   126,   126,   126,   126,   126,
+      126,   126,
+};
+
+#endif // STEPPER_RAMP_H
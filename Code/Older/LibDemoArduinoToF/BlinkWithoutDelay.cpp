@@ -4,7 +4,8 @@ BlinkWithoutDelay::BlinkWithoutDelay(int pin, unsigned long interval) :
   _pin(pin),
   _interval(interval),
   _previousMillis(0),
-  _ledState(LOW)
+  _ledState(LOW),
+  _timer(onTimer, this)
 {
   pinMode(_pin, OUTPUT);
 }
@@ -24,9 +25,19 @@ void BlinkWithoutDelay::update() {
 
   if (currentMillis - _previousMillis >= _interval) {
     _previousMillis = currentMillis;
-
-    // Toggle the LED state
-    _ledState = !_ledState;
-    digitalWrite(_pin, _ledState);
+    toggle();
   }
+}
+
+void BlinkWithoutDelay::start(SoftTimerService &timers) {
+  timers.startPeriodic(_timer, _interval);
+}
+
+void BlinkWithoutDelay::onTimer(void *context) {
+  static_cast<BlinkWithoutDelay *>(context)->toggle();
+}
+
+void BlinkWithoutDelay::toggle() {
+  _ledState = !_ledState;
+  digitalWrite(_pin, _ledState);
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 #define BlinkWithoutDelay_h
 
 #include "Arduino.h"
+#include "SoftTimer.h"
 
 class BlinkWithoutDelay {
 public:
@@ -9,13 +10,22 @@ public:
 
     void on();
     void off();
+
+    // Polling: call every loop()
     void update();
 
+    // Or let a periodic soft timer toggle the LED; update() is then not needed
+    void start(SoftTimerService &timers);
+
 private:
+    static void onTimer(void *context);
+    void toggle();
+
     int _pin;
     unsigned long _interval;
     unsigned long _previousMillis;
     bool _ledState;
+    SoftTimer _timer;
 };
 
 #endif
\ No newline at end of file
@@ -8,40 +8,211 @@
 
 #include "I2CHelper.h"
 
+I2CRegisterShadow::I2CRegisterShadow() : _count(0), _next(0) {}
+
+int8_t I2CRegisterShadow::find(uint16_t reg) const {
+    for (uint8_t i = 0; i < _count; ++i) {
+        if (_reg[i] == reg) return i;
+    }
+    return -1;
+}
+
+bool I2CRegisterShadow::lookup(uint16_t reg, uint8_t &value) const {
+    const int8_t i = find(reg);
+    if (i < 0) return false;
+    value = _value[i];
+    return true;
+}
+
+void I2CRegisterShadow::store(uint16_t reg, uint8_t value) {
+    int8_t i = find(reg);
+    if (i < 0) {
+        if (_count < I2C_HELPER_SHADOW_SIZE) {
+            i = _count++;
+        } else {
+            i = _next;  // Oldest entry
+            _next = (_next + 1) % I2C_HELPER_SHADOW_SIZE;
+        }
+        _reg[i] = reg;
+    }
+    _value[i] = value;
+}
+
+void I2CRegisterShadow::refresh(uint16_t reg, uint8_t value) {
+    const int8_t i = find(reg);
+    if (i >= 0) _value[i] = value;
+}
+
+void I2CRegisterShadow::clear() {
+    _count = 0;
+    _next = 0;
+}
+
 // Constructor
-I2CHelper::I2CHelper(TwoWire *wire) : _wire(wire) {}
+I2CHelper::I2CHelper(TwoWire *wire)
+    : _wire(wire), _volatileRegs(nullptr), _volatileCount(0), _shadowEnabled(false), _skipped(0) {}
 
 
 // Templated register access functions implementation
 template <typename T>
 T I2CHelper::readRegister(uint8_t address, uint16_t reg) {
-    _wire->beginTransmission(address);
-    _wire->write(reg >> 8); // MSB
-    _wire->write(reg & 0xFF); // LSB
-    _wire->endTransmission();
+    uint8_t bytes[sizeof(T)];
+    bool cached = true;
+    for (size_t i = 0; i < sizeof(T) && cached; ++i) {
+        cached = isCacheable(reg + i) && _shadow.lookup(reg + i, bytes[i]);
+    }
+
+    if (!cached) {
+        _wire->beginTransmission(address);
+        _wire->write(reg >> 8); // MSB
+        _wire->write(reg & 0xFF); // LSB
+        _wire->endTransmission();
+
+        const bool complete = _wire->requestFrom(address, sizeof(T)) == sizeof(T);
+        for (size_t i = 0; i < sizeof(T); ++i) {
+            bytes[i] = _wire->read();
+        }
+        if (complete) shadowStore(reg, bytes, sizeof(T));
+    } else {
+        _skipped += 2;  // Index write and read
+    }
 
-    _wire->requestFrom(address, sizeof(T));
     T value = 0;
     for (size_t i = 0; i < sizeof(T); ++i) {
         value <<= 8;
-        value |= _wire->read();
+        value |= bytes[i];
     }
     return value;
 }
 
 template <typename T>
 void I2CHelper::writeRegister(uint8_t address, uint16_t reg, T value) {
+    uint8_t bytes[sizeof(T)];
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        bytes[i] = (value >> (8 * (sizeof(T) - 1 - i))) & 0xFF;
+    }
+    if (shadowHolds(reg, bytes, sizeof(T))) {
+        _skipped++;
+        return;
+    }
+
     _wire->beginTransmission(address);
     _wire->write(reg >> 8); // MSB
     _wire->write(reg & 0xFF); // LSB
-    for (size_t i = 0; i < sizeof(T); ++i) {
-        _wire->write((value >> (8 * (sizeof(T) - 1 - i))) & 0xFF);
+    _wire->write(bytes, sizeof(T));
+    if (_wire->endTransmission() == 0) shadowStore(reg, bytes, sizeof(T));
+}
+
+// Start a write transaction with the 16-bit register index
+void I2CHelper::beginRegister(uint8_t address, uint16_t reg) {
+    _wire->beginTransmission(address);
+    _wire->write(reg >> 8); // MSB
+    _wire->write(reg & 0xFF); // LSB
+}
+
+bool I2CHelper::readBlock(uint8_t address, uint16_t reg, uint8_t *data, size_t length) {
+    size_t done = 0;
+    while (done < length) {
+        const size_t chunk = min(length - done, (size_t)I2C_HELPER_MAX_TRANSFER);
+
+        beginRegister(address, reg + done);
+        if (_wire->endTransmission(false) != 0) return false;  // Repeated start
+
+        if (_wire->requestFrom(address, (uint8_t)chunk) != chunk) return false;
+        for (size_t i = 0; i < chunk; ++i) {
+            data[done + i] = _wire->read();
+            if (_shadowEnabled) _shadow.refresh(reg + done + i, data[done + i]);
+        }
+        done += chunk;
+    }
+    return true;
+}
+
+bool I2CHelper::writeBlock(uint8_t address, uint16_t reg, const uint8_t *data, size_t length) {
+    size_t done = 0;
+    while (done < length) {
+        const size_t chunk = min(length - done, (size_t)I2C_HELPER_MAX_TRANSFER);
+
+        if (shadowHolds(reg + done, data + done, chunk)) {
+            _skipped++;  // Device already holds these values
+        } else {
+            beginRegister(address, reg + done);
+            _wire->write(data + done, chunk);
+            if (_wire->endTransmission() != 0) return false;
+            shadowStore(reg + done, data + done, chunk);
+        }
+        done += chunk;
+    }
+    return true;
+}
+
+size_t I2CHelper::writeSequence(uint8_t address, const I2CRegisterWrite *table, size_t count,
+                                bool autoIncrement) {
+    uint8_t run[I2C_HELPER_MAX_TRANSFER];
+    size_t transactions = 0;
+    size_t i = 0;
+
+    while (i < count) {
+        // Collect entries that continue at the next register address
+        const uint16_t start = table[i].reg;
+        size_t length = 0;
+        do {
+            run[length++] = table[i++].value;
+        } while (autoIncrement && i < count && length < sizeof(run) &&
+                 table[i].reg == start + length);
+
+        if (!writeBlock(address, start, run, length)) return 0;
+        transactions++;
+    }
+    return transactions;
+}
+
+void I2CHelper::enableShadow(const I2CRegisterRange *volatileRegs, size_t count) {
+    _volatileRegs = volatileRegs;
+    _volatileCount = count;
+    _shadow.clear();
+    _shadowEnabled = true;
+}
+
+void I2CHelper::disableShadow() {
+    _shadowEnabled = false;
+    _shadow.clear();
+}
+
+void I2CHelper::invalidateShadow() {
+    _shadow.clear();
+}
+
+uint32_t I2CHelper::getSkippedTransactions() const {
+    return _skipped;
+}
+
+bool I2CHelper::isCacheable(uint16_t reg) const {
+    if (!_shadowEnabled) return false;
+    for (size_t i = 0; i < _volatileCount; ++i) {
+        if (reg >= _volatileRegs[i].first && reg <= _volatileRegs[i].last) return false;
+    }
+    return true;
+}
+
+// True when every byte is cacheable and the shadow holds the same value
+bool I2CHelper::shadowHolds(uint16_t reg, const uint8_t *data, size_t length) const {
+    for (size_t i = 0; i < length; ++i) {
+        uint8_t value;
+        if (!isCacheable(reg + i) || !_shadow.lookup(reg + i, value) || value != data[i]) return false;
+    }
+    return true;
+}
+
+void I2CHelper::shadowStore(uint16_t reg, const uint8_t *data, size_t length) {
+    for (size_t i = 0; i < length; ++i) {
+        if (isCacheable(reg + i)) _shadow.store(reg + i, data[i]);
     }
-    _wire->endTransmission();
 }
 
 // Explicit instantiations for uint8_t and uint16_t
 template uint8_t I2CHelper::readRegister<uint8_t>(uint8_t, uint16_t); 
+template uint16_t I2CHelper::readRegister<uint16_t>(uint8_t, uint16_t);
 template void I2CHelper::writeRegister<uint8_t>(uint8_t, uint16_t, uint8_t);
 template void I2CHelper::writeRegister<uint16_t>(uint8_t, uint16_t, uint16_t);
 
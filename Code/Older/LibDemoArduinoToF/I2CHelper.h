@@ -11,6 +11,60 @@
 
 #include <Wire.h>
 
+// Largest payload per transaction; fits the smallest Wire buffer (AVR: 32 bytes)
+#define I2C_HELPER_MAX_TRANSFER 30
+
+// Registers remembered per device by the shadow cache
+#ifndef I2C_HELPER_SHADOW_SIZE
+#define I2C_HELPER_SHADOW_SIZE 16
+#endif
+
+/**
+ * @brief One entry of a register initialisation table.
+ *
+ * Tables are plain const arrays, so they end up in flash:
+ *   static const I2CRegisterWrite SETTINGS[] = { {0x0207, 0x01}, {0x0208, 0x01} };
+ */
+struct I2CRegisterWrite {
+    uint16_t reg;
+    uint8_t value;
+};
+
+/**
+ * @brief Inclusive register range, used to mark volatile registers.
+ *
+ * Volatile registers change without a write from us (status, results,
+ * self-clearing start/clear bits), so the shadow cache never serves or
+ * skips them:
+ *   static const I2CRegisterRange VOLATILE[] = { {0x004D, 0x0083}, {0x0015, 0x0015} };
+ */
+struct I2CRegisterRange {
+    uint16_t first;
+    uint16_t last;
+};
+
+/**
+ * @brief Last known values of a few byte registers of one device.
+ * When full, the oldest entry is replaced.
+ */
+class I2CRegisterShadow {
+public:
+    I2CRegisterShadow();
+
+    bool lookup(uint16_t reg, uint8_t &value) const;
+    void store(uint16_t reg, uint8_t value);
+    void refresh(uint16_t reg, uint8_t value);  // Only if the register is held
+    void clear();
+
+private:
+    int8_t find(uint16_t reg) const;
+
+    uint16_t _reg[I2C_HELPER_SHADOW_SIZE];
+    uint8_t _value[I2C_HELPER_SHADOW_SIZE];
+    uint8_t _count;
+    uint8_t _next;  // Entry replaced next when full
+};
+
 class I2CHelper {
 public:
     // Constructor taking the TwoWire instance
@@ -23,8 +77,80 @@ public:
     template <typename T>
     void writeRegister(uint8_t address, uint16_t reg, T value);
 
+    /**
+     * @brief Read consecutive registers, relying on the device's index auto-increment.
+     * Split into transactions of at most I2C_HELPER_MAX_TRANSFER bytes.
+     * @return false if the device did not acknowledge or returned too few bytes
+     */
+    bool readBlock(uint8_t address, uint16_t reg, uint8_t *data, size_t length);
+
+    template <size_t N>
+    bool readBlock(uint8_t address, uint16_t reg, uint8_t (&data)[N]) {
+        return readBlock(address, reg, data, N);
+    }
+
+    /**
+     * @brief Write consecutive registers in one transaction per chunk (auto-increment).
+     * @return false if the device did not acknowledge
+     */
+    bool writeBlock(uint8_t address, uint16_t reg, const uint8_t *data, size_t length);
+
+    template <size_t N>
+    bool writeBlock(uint8_t address, uint16_t reg, const uint8_t (&data)[N]) {
+        return writeBlock(address, reg, data, N);
+    }
+
+    /**
+     * @brief Stream a register table in order.
+     * Runs of entries with consecutive register addresses are merged into
+     * one auto-increment write, so a table costs one transaction per run
+     * instead of one per register.
+     * @param autoIncrement false for devices without index auto-increment
+     * @return Number of runs (including runs the shadow cache skipped), or 0 if one was not acknowledged
+     */
+    size_t writeSequence(uint8_t address, const I2CRegisterWrite *table, size_t count,
+                         bool autoIncrement = true);
+
+    template <size_t N>
+    size_t writeSequence(uint8_t address, const I2CRegisterWrite (&table)[N], bool autoIncrement = true) {
+        return writeSequence(address, table, N, autoIncrement);
+    }
+
+    /**
+     * @brief Turn on the shadow cache (off by default).
+     * Writes go through to the device, but are skipped when every byte
+     * already holds the value; reads of a register held in the cache cost
+     * no transaction. Registers in volatileRegs are never cached.
+     * One I2CHelper per device while the cache is on.
+     */
+    void enableShadow(const I2CRegisterRange *volatileRegs, size_t count);
+
+    template <size_t N>
+    void enableShadow(const I2CRegisterRange (&volatileRegs)[N]) {
+        enableShadow(volatileRegs, N);
+    }
+
+    void disableShadow();
+
+    /** @brief Forget all cached values, e.g. after the device was reset. */
+    void invalidateShadow();
+
+    /** @brief Transactions the shadow cache saved so far. */
+    uint32_t getSkippedTransactions() const;
+
 private:
     TwoWire *_wire;
+
+    I2CRegisterShadow _shadow;
+    const I2CRegisterRange *_volatileRegs;
+    size_t _volatileCount;
+    bool _shadowEnabled;
+    uint32_t _skipped;
+
+    void beginRegister(uint8_t address, uint16_t reg);
+    bool isCacheable(uint16_t reg) const;
+    bool shadowHolds(uint16_t reg, const uint8_t *data, size_t length) const;
+    void shadowStore(uint16_t reg, const uint8_t *data, size_t length);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,140 @@
+/**
+ * @file I2CQueue.cpp
+ * @brief Implementation of the I2CQueue class.
+ */
+
+#include "I2CQueue.h"
+
+// Critical section that is also safe inside an ISR (restores the old state)
+#if defined(__arm__)
+#define QUEUE_LOCK() uint32_t queuePrimask = __get_PRIMASK(); __disable_irq()
+#define QUEUE_UNLOCK() __set_PRIMASK(queuePrimask)
+#else
+#define QUEUE_LOCK() uint8_t queueSreg = SREG; noInterrupts()
+#define QUEUE_UNLOCK() SREG = queueSreg
+#endif
+
+static inline uint8_t nextSlot(uint8_t index) {
+    return (index + 1) % I2C_QUEUE_POOL_SIZE;
+}
+
+I2CQueue::I2CQueue(I2CAsyncBus &bus)
+    : _bus(bus), _head(0), _active(0), _tail(0), _running(false), _startUs(0),
+      _timeoutUs(I2C_QUEUE_TIMEOUT_US), _errors(0) {}
+
+bool I2CQueue::enqueueRead(uint8_t address, uint16_t reg, uint8_t length,
+                           I2CCallback callback, void *context) {
+    if (reserve(address, reg, length, true, callback, context) == nullptr) return false;
+    commit();
+    return true;
+}
+
+bool I2CQueue::enqueueWrite(uint8_t address, uint16_t reg, const uint8_t *data, uint8_t length,
+                            I2CCallback callback, void *context) {
+    I2CTransaction *t = reserve(address, reg, length, false, callback, context);
+    if (t == nullptr) return false;
+    if (length > 0) memcpy(t->buffer + 2, data, length);
+    commit();
+    return true;
+}
+
+// Fill the descriptor at _tail; it becomes visible to the ISR in commit()
+I2CTransaction *I2CQueue::reserve(uint8_t address, uint16_t reg, uint8_t length, bool read,
+                                  I2CCallback callback, void *context) {
+    if (length > I2C_QUEUE_MAX_DATA) return nullptr;
+    if (nextSlot(_tail) == _head) return nullptr;  // One slot kept free to tell full from empty
+
+    I2CTransaction &t = _pool[_tail];
+    t.address = address;
+    t.reg = reg;
+    t.length = length;
+    t.read = read;
+    t.result = I2CAsyncBus::IDLE;
+    t.callback = callback;
+    t.context = context;
+    t.buffer[0] = reg >> 8;   // MSB
+    t.buffer[1] = reg & 0xFF; // LSB
+    return &t;
+}
+
+void I2CQueue::commit() {
+    QUEUE_LOCK();
+    _tail = nextSlot(_tail);
+    QUEUE_UNLOCK();
+    pump();  // Bus idle: start right away
+}
+
+// Record the result of the active descriptor once the bus is done with it.
+// Runs in the ISR, or from loop() with interrupts disabled.
+void I2CQueue::finishActive() {
+    if (!_running || _bus.isBusy()) return;
+
+    I2CTransaction &done = _pool[_active];
+    done.result = _bus.getResult();
+    if (done.read && done.result == I2CAsyncBus::DONE && _bus.getReceived() != done.length) {
+        done.result = I2CAsyncBus::NACK;
+    }
+    if (done.result != I2CAsyncBus::DONE) _errors++;
+    _active = nextSlot(_active);
+    _running = false;
+}
+
+// Claim the next queued descriptor; false if none or the bus is in use
+bool I2CQueue::claimNext() {
+    if (_running || _active == _tail) return false;
+    _running = true;
+    _startUs = micros();
+    return true;
+}
+
+void I2CQueue::startActive() {
+    I2CTransaction &next = _pool[_active];
+    if (next.read) {
+        _bus.start(next.address, next.buffer, 2, next.buffer + 2, next.length);
+    } else {
+        _bus.start(next.address, next.buffer, 2 + next.length, nullptr, 0);
+    }
+}
+
+// loop() side: the bus is started outside the lock, so the blocking
+// fallback runs with interrupts enabled
+void I2CQueue::pump() {
+    for (;;) {
+        QUEUE_LOCK();
+        finishActive();
+        const bool start = claimNext();
+        QUEUE_UNLOCK();
+        if (!start) return;
+        startActive();  // The fallback finishes here, the next pass records it
+    }
+}
+
+void I2CQueue::onService() {
+    if (!_running) return;
+    _bus.onService();
+    finishActive();
+    if (claimNext()) startActive();  // Back to back, no loop() latency
+}
+
+void I2CQueue::poll() {
+    QUEUE_LOCK();
+    if (_running && _bus.isBusy() && (uint32_t)(micros() - _startUs) > _timeoutUs) {
+        _bus.abort();  // Stuck slave: give the bus back, result ABORTED
+    }
+    QUEUE_UNLOCK();
+    pump();
+
+    // Callbacks run in loop() context and may enqueue follow-up transactions
+    while (_head != _active) {
+        const I2CTransaction &t = _pool[_head];
+        if (t.callback) t.callback(t, t.context);
+        _head = nextSlot(_head);
+    }
+}
+
+uint8_t I2CQueue::getPending() const {
+    QUEUE_LOCK();
+    const uint8_t pending = (_tail + I2C_QUEUE_POOL_SIZE - _head) % I2C_QUEUE_POOL_SIZE;
+    QUEUE_UNLOCK();
+    return pending;
+}
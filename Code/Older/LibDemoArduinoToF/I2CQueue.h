@@ -0,0 +1,118 @@
+/**
+ * @file I2CQueue.h
+ * @brief Asynchronous register transactions from a fixed descriptor pool.
+ *
+ * I2CHelper blocks on TwoWire for every transfer (hundreds of microseconds
+ * per register at 100 kHz). I2CQueue takes the same 16-bit register reads
+ * and writes as descriptors and runs them one after the other on an
+ * I2CAsyncBus (HubSchedulerLibrary): the SERCOM interrupt moves the bytes
+ * and starts the next descriptor, poll() hands finished ones to their
+ * callback in loop() context.
+ *
+ * Usage:
+ *   I2CAsyncBus busA(&WireSensorA, SERCOM1);
+ *   I2CQueue queueA(busA);
+ *   void SERCOM1_Handler() { queueA.onService(); }
+ *
+ *   queueA.enqueueRead(0x29, 0x0062, 1, rangeDone, nullptr);
+ *   loop(): queueA.poll();
+ *
+ * Without a SERCOM (or on other targets) each descriptor runs blocking as
+ * soon as it is started; callbacks still come from poll().
+ */
+
+#ifndef I2CQUEUE_H
+#define I2CQUEUE_H
+
+#include <Arduino.h>
+#include "I2CAsyncBus.h"
+
+#define I2C_QUEUE_POOL_SIZE 8    // Descriptors in flight per bus
+#define I2C_QUEUE_MAX_DATA 16    // Payload bytes per descriptor
+#define I2C_QUEUE_TIMEOUT_US 5000
+
+struct I2CTransaction;
+
+// Completion callback, runs from poll(); context is the pointer given to enqueue
+typedef void (*I2CCallback)(const I2CTransaction &transaction, void *context);
+
+/**
+ * @brief One queued register transaction.
+ */
+struct I2CTransaction {
+    uint8_t address;
+    uint16_t reg;
+    uint8_t length;                         // Payload bytes to write or read
+    bool read;
+    I2CAsyncBus::Result result;             // DONE when the transfer succeeded
+    I2CCallback callback;
+    void *context;
+    uint8_t buffer[2 + I2C_QUEUE_MAX_DATA]; // Register index (MSB first), then payload
+
+    bool ok() const { return result == I2CAsyncBus::DONE; }
+    const uint8_t *data() const { return buffer + 2; }
+};
+
+class I2CQueue {
+public:
+    explicit I2CQueue(I2CAsyncBus &bus);
+
+    /**
+     * @brief Queue a read of length consecutive registers (auto-increment).
+     * @return false if the pool is full or length exceeds I2C_QUEUE_MAX_DATA
+     */
+    bool enqueueRead(uint8_t address, uint16_t reg, uint8_t length,
+                     I2CCallback callback = nullptr, void *context = nullptr);
+
+    /**
+     * @brief Queue a write; the data is copied, so the caller's buffer may be reused.
+     */
+    bool enqueueWrite(uint8_t address, uint16_t reg, const uint8_t *data, uint8_t length,
+                      I2CCallback callback = nullptr, void *context = nullptr);
+
+    bool enqueueWrite8(uint8_t address, uint16_t reg, uint8_t value,
+                       I2CCallback callback = nullptr, void *context = nullptr) {
+        return enqueueWrite(address, reg, &value, 1, callback, context);
+    }
+
+    /**
+     * @brief Run callbacks of finished descriptors (oldest first) and keep the
+     * bus going; call every loop(). Aborts a transfer that exceeds the timeout.
+     */
+    void poll();
+
+    /**
+     * @brief Interrupt service; call from the SERCOMx_Handler of the bus.
+     */
+    void onService();
+
+    void setTimeout(uint32_t timeoutUs) { _timeoutUs = timeoutUs; }
+
+    uint8_t getPending() const;      // Queued or running, callback not yet run
+    bool isIdle() const { return getPending() == 0; }
+    uint32_t getErrorCount() const { return _errors; }
+
+private:
+    I2CTransaction *reserve(uint8_t address, uint16_t reg, uint8_t length, bool read,
+                            I2CCallback callback, void *context);
+    void commit();
+    void pump();
+    void finishActive();
+    bool claimNext();
+    void startActive();
+
+    I2CAsyncBus &_bus;
+    I2CTransaction _pool[I2C_QUEUE_POOL_SIZE];
+
+    // Ring over _pool: [_head, _active) finished, [_active, _tail) queued
+    volatile uint8_t _head;
+    volatile uint8_t _active;
+    volatile uint8_t _tail;
+    volatile bool _running;      // _pool[_active] is on the bus
+    volatile uint32_t _startUs;
+
+    uint32_t _timeoutUs;
+    uint32_t _errors;
+};
+
+#endif // I2CQUEUE_H
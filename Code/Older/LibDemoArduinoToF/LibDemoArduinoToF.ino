@@ -4,6 +4,8 @@
 #include "wiring_private.h"
 #include "WireScanner.h"
 #include "BlinkWithoutDelay.h"
+#include "SoftTimer.h"
+#include "RangeTracker.h"
 
 // Heartbeat LED pin
 #define ledHb 14
@@ -19,6 +21,8 @@ TwoWire WireSensorB(&sercom4, W2_SDA, W2_SCL);
 VL6180X* sensor = nullptr;
 
 BlinkWithoutDelay heartBeat(ledHb, blinkInterval);
+SoftTimerService timers;  // Heartbeat and other periodic work, no millis() polling in loop()
+RangeTracker rangeTracker;  // Filtered range and closing speed of the continuous samples
 
 
 // Sensor configuration
@@ -76,8 +80,11 @@ void scanAndInitializeSensor() {
       if (sensor->begin()) {
         Serial.print("VL6180X sensor initialized on ");
         Serial.println(sensorConfigs[i].label);
-        sensor->init();
-        sensor->configureDefault();
+        // After a reset of the MCU only, the sensor keeps its settings
+        const VL6180xStartup start = sensor->startup();
+        Serial.println(start == VL6180X_WARM_START ? "Warm start"
+                       : start == VL6180X_COLD_START ? "Cold start" : "Configuration failed");
+        sensor->startRangeContinuous(100);  // Results arrive through update()
       } else {
         Serial.print("Sensor initialization failed on ");
         Serial.println(sensorConfigs[i].label);
@@ -98,16 +105,29 @@ void setup() {
   setupI2CBuses();
   digitalWrite(ledHb, LOW);
   scanAndInitializeSensor();
+
+  timers.begin();
+  heartBeat.start(timers);
 }
 
 void loop() {
-  heartBeat.update();
+  timers.service();
 
   if (sensor != nullptr) {
-    uint8_t range = sensor->readRangeSingle();  // seems to have an issue...
-    Serial.print("Range from sensor: ");
-    Serial.print(range);
-    Serial.println(" mm");
+    // No GPIO1 line wired here: update() polls the status at a low rate
+    sensor->update();
+
+    VL6180xSample sample;
+    while (sensor->readSample(sample)) {
+      if (!rangeTracker.update(sample)) continue;  // Range status error or outlier
+      Serial.print("Range from sensor: ");
+      Serial.print(sample.range);
+      Serial.print(" mm, filtered: ");
+      Serial.print(rangeTracker.getRangeMm());
+      Serial.print(" mm, closing: ");
+      Serial.print(rangeTracker.getClosingSpeedMmPerS());
+      Serial.println(" mm/s");
+    }
   }
 
 }
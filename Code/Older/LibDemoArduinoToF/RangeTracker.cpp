@@ -0,0 +1,133 @@
+/**
+ * @file RangeTracker.cpp
+ * @brief Implementation of the RangeTracker class.
+ */
+
+#include "RangeTracker.h"
+
+#define ONE_Q (1L << RANGE_TRACKER_Q)
+
+// Divide by 2^Q, rounded to nearest for both signs
+static inline int32_t roundQ(int32_t value) {
+  return (value >= 0 ? value + ONE_Q / 2 : value - ONE_Q / 2) / ONE_Q;
+}
+
+RangeTracker::RangeTracker(uint16_t alphaQ8, uint8_t gateMm)
+  : _alphaQ8(0),
+    _betaQ8(0),
+    _gateQ8(0),
+    _gateLimit(3),
+    _maxCoastMs(1000),
+    _rangeQ8(0),
+    _velocityQ8(0),
+    _lastMs(0),
+    _tracking(false),
+    _gatedInRow(0),
+    _lastResult(REJECTED_STATUS),
+    _statusRejects(0),
+    _gateRejects(0),
+    _restarts(0) {
+  setGainsFromAlpha(alphaQ8);
+  setGate(gateMm);
+}
+
+void RangeTracker::setGains(uint16_t alphaQ8, uint16_t betaQ8) {
+  _alphaQ8 = constrain(alphaQ8, 1, ONE_Q);
+  _betaQ8 = constrain(betaQ8, 0, ONE_Q);
+}
+
+void RangeTracker::setGainsFromAlpha(uint16_t alphaQ8) {
+  const uint32_t alpha = constrain(alphaQ8, 1, ONE_Q);
+  setGains(alpha, (alpha * alpha) / (2 * ONE_Q - alpha));
+}
+
+void RangeTracker::setGate(uint8_t gateMm, uint8_t gateRejects) {
+  _gateQ8 = (int32_t)gateMm * ONE_Q;
+  _gateLimit = gateRejects > 0 ? gateRejects : 1;
+}
+
+void RangeTracker::setMaxCoastMs(uint16_t maxCoastMs) {
+  _maxCoastMs = maxCoastMs;
+}
+
+bool RangeTracker::update(const VL6180xSample &sample) {
+  checkTimeout(sample.timestampMs);
+
+  if (sample.rangeStatus != 0) {
+    _statusRejects++;
+    _lastResult = REJECTED_STATUS;
+    return false;
+  }
+
+  if (!_tracking) {
+    start(sample);
+    return true;
+  }
+
+  uint32_t dt = sample.timestampMs - _lastMs;
+  if (dt == 0) dt = RANGE_TRACKER_NOMINAL_PERIOD_MS;
+
+  const int32_t predicted = _rangeQ8 + (int32_t)(((int64_t)_velocityQ8 * dt) / 1000);
+  const int32_t residual = (int32_t)sample.range * ONE_Q - predicted;
+
+  if (residual > _gateQ8 || residual < -_gateQ8) {
+    _gateRejects++;
+    if (++_gatedInRow >= _gateLimit) {
+      start(sample);  // Not a spike: the target moved (or another one came in view)
+      return true;
+    }
+    _lastResult = REJECTED_GATE;
+    return false;
+  }
+  _gatedInRow = 0;
+
+  const int32_t corrected = predicted + (int32_t)(((int64_t)_alphaQ8 * residual) / ONE_Q);
+  const int32_t rateStep = (int32_t)(((int64_t)_betaQ8 * residual * 1000) / ((int64_t)dt * ONE_Q));
+  _rangeQ8 = constrain(corrected, 0, 255L * ONE_Q);
+  _velocityQ8 = clampVelocity(_velocityQ8 + rateStep);
+  _lastMs = sample.timestampMs;
+  _lastResult = TRACK_UPDATED;
+  return true;
+}
+
+void RangeTracker::checkTimeout(uint32_t nowMs) {
+  if (_tracking && _maxCoastMs != 0 && (int32_t)(nowMs - _lastMs) > (int32_t)_maxCoastMs) {
+    _tracking = false;
+  }
+}
+
+void RangeTracker::reset() {
+  _tracking = false;
+  _gatedInRow = 0;
+  _rangeQ8 = 0;
+  _velocityQ8 = 0;
+}
+
+uint8_t RangeTracker::getRangeMm() const {
+  return (uint8_t)constrain(roundQ(_rangeQ8), 0, 255);
+}
+
+int16_t RangeTracker::getVelocityMmPerS() const {
+  return (int16_t)roundQ(_velocityQ8);
+}
+
+uint8_t RangeTracker::predictRangeMm(uint32_t nowMs) const {
+  if (!_tracking) return 0;
+  const int32_t dt = (int32_t)(nowMs - _lastMs);
+  const int32_t predicted = _rangeQ8 + (int32_t)(((int64_t)_velocityQ8 * dt) / 1000);
+  return (uint8_t)constrain(roundQ(predicted), 0, 255);
+}
+
+void RangeTracker::start(const VL6180xSample &sample) {
+  _rangeQ8 = (int32_t)sample.range * ONE_Q;
+  _velocityQ8 = 0;
+  _lastMs = sample.timestampMs;
+  _tracking = true;
+  _gatedInRow = 0;
+  _restarts++;
+  _lastResult = TRACK_STARTED;
+}
+
+int32_t RangeTracker::clampVelocity(int32_t velocityQ8) {
+  return constrain(velocityQ8, -(int32_t)RANGE_TRACKER_MAX_SPEED * ONE_Q, (int32_t)RANGE_TRACKER_MAX_SPEED * ONE_Q);
+}
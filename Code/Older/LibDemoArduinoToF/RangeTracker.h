@@ -0,0 +1,111 @@
+/**
+ * @file RangeTracker.h
+ * @brief Fixed-point alpha-beta tracker for VL6180X range samples.
+ *
+ * Smooths the raw millimetres of the continuous ranging mode and
+ * estimates the range rate, with a constant-velocity model:
+ *
+ *   predict:  x' = x + v * dt
+ *   correct:  r  = z - x'
+ *             x  = x' + alpha * r
+ *             v  = v  + beta * r / dt
+ *
+ * This is the steady-state form of a 1D Kalman filter; setGainsFromAlpha()
+ * picks beta for alpha (Benedict-Bordner), a lower alpha smooths more,
+ * but follows a moving target later.
+ *
+ * Outliers do not enter the filter:
+ *   - samples with RESULT__RANGE_STATUS != 0 (no target, overflow, ...)
+ *   - residuals larger than the gate, until 'gateRejects' in a row show
+ *     that the target really moved (the track then restarts there)
+ * Without a merged sample for 'maxCoastMs' the track is lost.
+ *
+ * Usage:
+ *   RangeTracker tracker;
+ *   VL6180xSample sample;
+ *   while (sensor->readSample(sample)) {
+ *     if (tracker.update(sample)) use(tracker.getRangeMm(), tracker.getClosingSpeedMmPerS());
+ *   }
+ */
+
+#ifndef RANGETRACKER_H
+#define RANGETRACKER_H
+
+#include <Arduino.h>
+#include "VL6180X.h"
+
+#define RANGE_TRACKER_Q 8                    // Fraction bits of range and velocity
+#define RANGE_TRACKER_MAX_SPEED 5000         // mm/s, velocity clamp
+#define RANGE_TRACKER_NOMINAL_PERIOD_MS 100  // dt when two samples share a timestamp
+
+class RangeTracker {
+public:
+  enum Result : uint8_t {
+    TRACK_STARTED,    // First valid sample, or restart after loss / a jump
+    TRACK_UPDATED,    // Sample merged into the track
+    REJECTED_STATUS,  // rangeStatus != 0
+    REJECTED_GATE     // Residual outside the gate
+  };
+
+  /**
+   * @param alphaQ8 Position gain, 1..256 (256 = 1.0); beta follows from it
+   * @param gateMm Largest accepted residual
+   */
+  explicit RangeTracker(uint16_t alphaQ8 = 128, uint8_t gateMm = 30);
+
+  void setGains(uint16_t alphaQ8, uint16_t betaQ8);
+  void setGainsFromAlpha(uint16_t alphaQ8);   // beta = alpha^2 / (2 - alpha)
+  void setGate(uint8_t gateMm, uint8_t gateRejects = 3);
+  void setMaxCoastMs(uint16_t maxCoastMs);    // 0 = never lose the track
+
+  /**
+   * @brief Feed one sample, oldest first (as readSample() returns them).
+   * @return true when the sample was used (TRACK_STARTED / TRACK_UPDATED)
+   */
+  bool update(const VL6180xSample &sample);
+  Result getLastResult() const { return _lastResult; }
+
+  /**
+   * @brief Also called by update(); call it when no samples arrive to drop a stale track.
+   */
+  void checkTimeout(uint32_t nowMs);
+  void reset();
+
+  bool isTracking() const { return _tracking; }
+  uint8_t getRangeMm() const;                  // Filtered, rounded
+  int32_t getRangeQ8() const { return _rangeQ8; }
+  int16_t getVelocityMmPerS() const;           // Range rate: > 0 moving away
+  int16_t getClosingSpeedMmPerS() const { return -getVelocityMmPerS(); }  // > 0 approaching
+
+  /**
+   * @brief Range predicted at 'nowMs', between samples or at a lower sensor rate.
+   */
+  uint8_t predictRangeMm(uint32_t nowMs) const;
+
+  uint16_t getStatusRejects() const { return _statusRejects; }
+  uint16_t getGateRejects() const { return _gateRejects; }
+  uint16_t getRestarts() const { return _restarts; }  // Track starts, the first included
+
+private:
+  void start(const VL6180xSample &sample);
+  static int32_t clampVelocity(int32_t velocityQ8);
+
+  uint16_t _alphaQ8;
+  uint16_t _betaQ8;
+  int32_t _gateQ8;
+  uint8_t _gateLimit;     // Gated samples in a row before a restart
+  uint16_t _maxCoastMs;
+
+  int32_t _rangeQ8;       // mm << RANGE_TRACKER_Q
+  int32_t _velocityQ8;    // mm/s << RANGE_TRACKER_Q
+  uint32_t _lastMs;       // Timestamp of the last merged sample
+  bool _tracking;
+  uint8_t _gatedInRow;
+  Result _lastResult;
+
+  uint16_t _statusRejects;
+  uint16_t _gateRejects;
+  uint16_t _restarts;
+};
+
+#endif
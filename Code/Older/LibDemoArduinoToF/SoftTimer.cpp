@@ -0,0 +1,178 @@
+/**
+ * @file SoftTimer.cpp
+ * @brief Implementation of the SoftTimer and SoftTimerService classes.
+ */
+
+#include "SoftTimer.h"
+
+// Wrap-safe "a is not before b" for millis() values
+static inline bool reached(uint32_t a, uint32_t b) {
+    return (int32_t)(a - b) >= 0;
+}
+
+SoftTimer::SoftTimer(SoftTimerCallback callback, void *context)
+    : _callback(callback), _context(context), _dueMs(0), _periodMs(0), _next(nullptr), _active(false) {}
+
+#if SOFT_TIMER_HARDWARE
+static SoftTimerService *activeService = nullptr;
+
+#define SOFT_TIMER_HZ (F_CPU / 1024UL)  // 46.875 kHz at 48 MHz
+
+void TC5_Handler() {
+    TC5->COUNT16.INTFLAG.reg = TC_INTFLAG_MC0;
+    if (activeService) activeService->onCompare();
+}
+
+static void startCompareTimer() {
+    PM->APBCMASK.reg |= PM_APBCMASK_TC5;
+    GCLK->CLKCTRL.reg = GCLK_CLKCTRL_CLKEN | GCLK_CLKCTRL_GEN_GCLK0 | GCLK_CLKCTRL_ID_TC4_TC5;
+    while (GCLK->STATUS.bit.SYNCBUSY) {}
+
+    // Free running 16-bit counter (normal frequency mode), CC0 is the compare point
+    TC5->COUNT16.CTRLA.reg = TC_CTRLA_SWRST;
+    while (TC5->COUNT16.CTRLA.bit.SWRST) {}
+    TC5->COUNT16.CTRLA.reg = TC_CTRLA_MODE_COUNT16 | TC_CTRLA_WAVEGEN_NFRQ | TC_CTRLA_PRESCALER_DIV1024;
+    while (TC5->COUNT16.STATUS.bit.SYNCBUSY) {}
+
+    NVIC_SetPriority(TC5_IRQn, 3);  // Lowest: it only sets a flag
+    NVIC_EnableIRQ(TC5_IRQn);
+    TC5->COUNT16.CTRLA.bit.ENABLE = 1;
+    while (TC5->COUNT16.STATUS.bit.SYNCBUSY) {}
+}
+
+static uint16_t readCount() {
+    TC5->COUNT16.READREQ.reg = TC_READREQ_RREQ | TC_READREQ_ADDR(0x10);  // COUNT
+    while (TC5->COUNT16.STATUS.bit.SYNCBUSY) {}
+    return TC5->COUNT16.COUNT.reg;
+}
+#endif
+
+SoftTimerService::SoftTimerService() : _head(nullptr), _expired(false), _hardware(false) {}
+
+void SoftTimerService::begin() {
+#if SOFT_TIMER_HARDWARE
+    activeService = this;
+    startCompareTimer();
+    _hardware = true;
+    arm();
+#endif
+}
+
+void SoftTimerService::startOnce(SoftTimer &timer, uint32_t delayMs) {
+    unlink(timer);
+    timer._periodMs = 0;
+    timer._dueMs = millis() + delayMs;
+    insert(timer);
+    arm();
+}
+
+void SoftTimerService::startPeriodic(SoftTimer &timer, uint32_t periodMs, uint32_t firstDelayMs) {
+    if (periodMs == 0) return;
+    unlink(timer);
+    timer._periodMs = periodMs;
+    timer._dueMs = millis() + (firstDelayMs == NO_TIMER ? periodMs : firstDelayMs);
+    insert(timer);
+    arm();
+}
+
+void SoftTimerService::stop(SoftTimer &timer) {
+    unlink(timer);
+    arm();
+}
+
+uint8_t SoftTimerService::service() {
+    if (_hardware && !_expired) return 0;  // The common case: one flag test
+    _expired = false;
+
+    const uint32_t now = millis();
+    uint8_t count = 0;
+    while (_head != nullptr && reached(now, _head->_dueMs)) {
+        SoftTimer &timer = *_head;
+        unlink(timer);
+
+        // Re-queue first, so the callback may stop or restart its own timer
+        if (timer._periodMs != 0) {
+            timer._dueMs += timer._periodMs;
+            if (reached(now, timer._dueMs)) {
+                // Blocked for more than a period: next release on the grid
+                timer._dueMs += ((now - timer._dueMs) / timer._periodMs + 1) * timer._periodMs;
+            }
+            insert(timer);
+        }
+        if (timer._callback) timer._callback(timer._context);
+        count++;
+    }
+
+    arm();
+    return count;
+}
+
+uint32_t SoftTimerService::msUntilNext() const {
+    if (_head == nullptr) return NO_TIMER;
+    const uint32_t now = millis();
+    return reached(now, _head->_dueMs) ? 0 : _head->_dueMs - now;
+}
+
+void SoftTimerService::sleepUntilNext() {
+    if (_expired || msUntilNext() == 0) return;
+#if defined(__arm__)
+    __DSB();
+    __WFI();
+#endif
+}
+
+uint8_t SoftTimerService::getActiveCount() const {
+    uint8_t count = 0;
+    for (const SoftTimer *t = _head; t != nullptr; t = t->_next) count++;
+    return count;
+}
+
+void SoftTimerService::onCompare() {
+    _expired = true;
+}
+
+// Sorted insert; equal due times keep their start order
+void SoftTimerService::insert(SoftTimer &timer) {
+    SoftTimer **link = &_head;
+    while (*link != nullptr && reached(timer._dueMs, (*link)->_dueMs)) {
+        link = &(*link)->_next;
+    }
+    timer._next = *link;
+    *link = &timer;
+    timer._active = true;
+}
+
+void SoftTimerService::unlink(SoftTimer &timer) {
+    if (!timer._active) return;
+    for (SoftTimer **link = &_head; *link != nullptr; link = &(*link)->_next) {
+        if (*link == &timer) {
+            *link = timer._next;
+            break;
+        }
+    }
+    timer._next = nullptr;
+    timer._active = false;
+}
+
+// Program the compare channel for the first timer (or switch it off)
+void SoftTimerService::arm() {
+    if (!_hardware) return;
+#if SOFT_TIMER_HARDWARE
+    TC5->COUNT16.INTENCLR.reg = TC_INTENCLR_MC0;
+    if (_head == nullptr) return;
+
+    uint32_t ms = msUntilNext();
+    if (ms == 0) {
+        _expired = true;  // Already due: service() runs it on the next pass
+        return;
+    }
+    if (ms > SOFT_TIMER_MAX_ARM_MS) ms = SOFT_TIMER_MAX_ARM_MS;  // Wakes early, re-arms
+
+    // Round up: millis() may tick up to 1 ms after the exact compare time
+    const uint32_t ticks = (ms * SOFT_TIMER_HZ + 999UL) / 1000UL;
+    TC5->COUNT16.CC[0].reg = (uint16_t)(readCount() + ticks);
+    while (TC5->COUNT16.STATUS.bit.SYNCBUSY) {}
+    TC5->COUNT16.INTFLAG.reg = TC_INTFLAG_MC0;
+    TC5->COUNT16.INTENSET.reg = TC_INTENSET_MC0;
+#endif
+}
@@ -0,0 +1,120 @@
+/**
+ * @file SoftTimer.h
+ * @brief One-shot and periodic software timers on one hardware compare channel.
+ *
+ * Instead of every object comparing millis() against its own interval in
+ * every loop() pass (BlinkWithoutDelay::update(), HeartBeat::blink(),
+ * isTimeForNextStep(), ...), the timers are kept in one list sorted on
+ * their due time. Only the first one is programmed into the compare
+ * channel (TC5 CC0 on SAMD21); its interrupt only sets a flag. service()
+ * in loop() then costs one flag test until a timer is due, and runs the
+ * callbacks there, in the deferred (loop) context: they may use Serial,
+ * I2C and start or stop timers.
+ *
+ * Usage:
+ *   SoftTimerService timers;
+ *   SoftTimer sample(readSensor);
+ *
+ *   setup(): timers.begin(); timers.startPeriodic(sample, 100);
+ *   loop():  timers.service();  // or timers.sleepUntilNext(); timers.service();
+ *
+ * Uses TC5 (not together with the Servo or Tone library). On other
+ * targets service() compares the first due time itself, still only one
+ * comparison per pass.
+ */
+
+#ifndef SOFTTIMER_H
+#define SOFTTIMER_H
+
+#include <Arduino.h>
+
+#if defined(__SAMD21G18A__) || defined(__SAMD21J18A__) || defined(__SAMD21E18A__)
+#define SOFT_TIMER_HARDWARE 1
+#else
+#define SOFT_TIMER_HARDWARE 0
+#endif
+
+#define SOFT_TIMER_MAX_ARM_MS 1000  // Longest compare distance (16-bit TC at 46.875 kHz: 1398 ms)
+
+// Runs from SoftTimerService::service(); context is the pointer given to the timer
+typedef void (*SoftTimerCallback)(void *context);
+
+/**
+ * @brief One timer; owned by the caller, linked into the service while active.
+ */
+class SoftTimer {
+public:
+    explicit SoftTimer(SoftTimerCallback callback, void *context = nullptr);
+
+    bool isActive() const { return _active; }
+    uint32_t getPeriodMs() const { return _periodMs; }  // 0 = one-shot
+
+private:
+    friend class SoftTimerService;
+
+    SoftTimerCallback _callback;
+    void *_context;
+    uint32_t _dueMs;
+    uint32_t _periodMs;
+    SoftTimer *_next;
+    bool _active;
+};
+
+class SoftTimerService {
+public:
+    static const uint32_t NO_TIMER = 0xFFFFFFFF;
+
+    SoftTimerService();
+
+    /**
+     * @brief Set up the compare channel (TC5 on SAMD21); call once in setup().
+     */
+    void begin();
+
+    /**
+     * @brief Run the callback once, delayMs from now; restarts an active timer.
+     */
+    void startOnce(SoftTimer &timer, uint32_t delayMs);
+
+    /**
+     * @brief Run the callback every periodMs (> 0), first after firstDelayMs
+     *        (default: one period). Releases stay on the period grid; periods
+     *        missed because loop() was blocked are skipped, not replayed.
+     */
+    void startPeriodic(SoftTimer &timer, uint32_t periodMs, uint32_t firstDelayMs = NO_TIMER);
+
+    void stop(SoftTimer &timer);
+
+    /**
+     * @brief Call every loop(): runs the callbacks of due timers.
+     * @return Number of callbacks run
+     */
+    uint8_t service();
+
+    /**
+     * @brief Milliseconds until the first timer is due (0 = due), NO_TIMER if none.
+     */
+    uint32_t msUntilNext() const;
+
+    /**
+     * @brief Idle (WFI) until an interrupt, unless a timer is already due.
+     *        SysTick (millis()) still wakes the core every millisecond.
+     */
+    void sleepUntilNext();
+
+    uint8_t getActiveCount() const;
+
+    // From the compare interrupt (TC5_Handler in SoftTimer.cpp)
+    void onCompare();
+
+private:
+    void insert(SoftTimer &timer);
+    void unlink(SoftTimer &timer);
+    void arm();
+
+    SoftTimer *_head;        // Sorted on _dueMs, earliest first
+    volatile bool _expired;  // Set by the compare interrupt
+    bool _hardware;          // begin() done on a SAMD21
+};
+
+#endif
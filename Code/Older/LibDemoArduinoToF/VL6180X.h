@@ -11,9 +11,14 @@
 
 #include "Arduino.h"
 #include "I2CHelper.h"
+#include "I2CQueue.h"
 
 #define VL6180x_FAILURE_RESET -1
 
+#define VL6180X_SAMPLE_RING 8             // Continuous samples buffered per sensor
+#define VL6180X_MAX_INTERRUPT_SENSORS 4   // Sensors that can use attachGpio1()
+#define VL6180X_NO_PIN 0xFF
+
 #define VL6180X_IDENTIFICATION_MODEL_ID 0x0000
 #define VL6180X_IDENTIFICATION_MODEL_REV_MAJOR 0x0001
 #define VL6180X_IDENTIFICATION_MODEL_REV_MINOR 0x0002
@@ -100,6 +105,24 @@ struct VL6180xIdentification
   uint16_t idTime;
 };
 
+// Outcome of VL6180X::startup()
+enum VL6180xStartup : uint8_t
+{
+  VL6180X_START_FAILED,
+  VL6180X_COLD_START,    // Settings tables written
+  VL6180X_WARM_START     // Sensor kept its configuration, nothing written
+};
+
+// One result of continuous ranging
+struct VL6180xSample
+{
+  uint32_t timestampMs;  // millis() when the result was read
+  uint8_t range;         // mm
+  uint8_t rangeStatus;   // Error code (RESULT__RANGE_STATUS >> 4), 0 = valid
+  uint16_t als;          // Raw ALS count, interleaved mode only
+  bool hasAls;
+};
+
 
 
 class VL6180X {
@@ -112,8 +135,21 @@ public:
 
   bool begin();
   bool init();
+
+  // Move the sensor to a new 7-bit address (lost again on reset/XSHUT)
+  bool setAddress(uint8_t newAddress);
+  uint8_t getAddress() const;
   bool configureDefault();
 
+  // init() + configureDefault() when needed. After an MCU-only reset
+  // (watchdog, upload) the sensor still holds its settings: one burst read
+  // of the signature and the configuration then replaces the whole
+  // sequence. Works whether or not SYSTEM_FRESH_OUT_OF_RESET is set.
+  VL6180xStartup startup();
+
+  // Model, revisions, date and time in one burst read
+  bool readIdentification(VL6180xIdentification &id);
+
   uint8_t readRangeSingle();
   uint8_t readRangeContinuous();
 
@@ -124,10 +160,47 @@ public:
   uint8_t getRange();
   void clearInterrupt();
 
+  // Continuous measurements without busy polling. After configureDefault()
+  // GPIO1 is an open-drain, active-low "new sample" output: with
+  // attachGpio1() the bus is only used when it fires, otherwise update()
+  // polls the interrupt status every few milliseconds.
+  bool attachGpio1(uint8_t pin);    // false if all interrupt slots are taken
+  void setQueue(I2CQueue *queue);   // Read results through an async queue (nullptr = blocking)
+  bool startRangeContinuous(uint16_t periodMs = 100);
+  bool startInterleaved(uint16_t periodMs = 100);  // ALS followed by range every period
+  bool stopContinuous();
+  void update();                    // Call every loop()
+
+  uint8_t available() const;        // Samples in the ring
+  bool readSample(VL6180xSample &sample);  // Oldest first
+  uint16_t getOverruns() const;     // Samples dropped because the ring was full
+
+  void onGpio1();                   // GPIO1 interrupt hook
+
 private:
+  enum Mode : uint8_t { MODE_IDLE, MODE_RANGE, MODE_INTERLEAVED };
+
+  void readResults();
+  void pushSample(const VL6180xSample &sample);
+  static void onResultStatus(const I2CTransaction &t, void *context);
+  static void onRangeValue(const I2CTransaction &t, void *context);
+
   uint8_t _address;
   I2CHelper _i2cHelper;  // Store the I2CHelper object directly
 
+  // Continuous mode
+  I2CQueue *_queue;
+  Mode _mode;
+  uint8_t _gpio1Pin;
+  volatile bool _dataReady;
+  bool _readBusy;                   // Queued result read not finished yet
+  uint32_t _lastPollMs;
+  VL6180xSample _current;           // Result being assembled from the queue
+  VL6180xSample _ring[VL6180X_SAMPLE_RING];
+  uint8_t _ringHead;
+  uint8_t _ringCount;
+  uint16_t _overruns;
+
   // Constants for register addresses (consider using enums for clarity)
   static const uint16_t IDENTIFICATION__MODEL_ID = 0x0000;
   static const uint16_t SYSRANGE__START = 0x0018;
@@ -0,0 +1,134 @@
+/**
+ * @file VL6180XArray.cpp
+ * @brief Implementation of the VL6180XArray class.
+ */
+
+#include "VL6180XArray.h"
+
+VL6180XArray::VL6180XArray(TwoWire *wire, I2CQueue *queue)
+  : _wire(wire),
+    _queue(queue),
+    _count(0),
+    _running(false),
+    _interleaved(false),
+    _periodMs(100),
+    _startMs(0),
+    _nextRead(0) {}
+
+int8_t VL6180XArray::addSensor(uint8_t xshutPin, uint8_t address, uint8_t gpio1Pin) {
+  if (_count >= VL6180X_ARRAY_MAX) return -1;
+
+  Slot &slot = _slots[_count];
+  slot.xshutPin = xshutPin;
+  slot.address = address;
+  slot.gpio1Pin = gpio1Pin;
+  slot.present = false;
+  slot.started = false;
+  return _count++;
+}
+
+uint8_t VL6180XArray::begin() {
+  // Hold every sensor in reset, so none answers at the default address
+  for (uint8_t i = 0; i < _count; i++) {
+    pinMode(_slots[i].xshutPin, OUTPUT);
+    digitalWrite(_slots[i].xshutPin, LOW);
+  }
+  delay(VL6180X_XSHUT_RESET_MS);
+
+  uint8_t present = 0;
+  for (uint8_t i = 0; i < _count; i++) {
+    if (bringUp(i)) present++;
+  }
+  return present;
+}
+
+// Wake one sensor at 0x29, move it to its address, then configure it there
+bool VL6180XArray::bringUp(uint8_t index) {
+  Slot &slot = _slots[index];
+  digitalWrite(slot.xshutPin, HIGH);
+  delay(VL6180X_BOOT_MS);
+
+  VL6180X &sensor = _sensors[index];
+  sensor = VL6180X(VL6180X::DEFAULT_SENSOR_ADDRESS, I2CHelper(_wire));
+  if (!sensor.begin() || !sensor.setAddress(slot.address)) {
+    digitalWrite(slot.xshutPin, LOW);  // Keep a dead or unknown part off the bus
+    return false;
+  }
+
+  if (sensor.startup() == VL6180X_START_FAILED) {
+    digitalWrite(slot.xshutPin, LOW);
+    return false;
+  }
+  sensor.setQueue(_queue);
+  if (slot.gpio1Pin != VL6180X_NO_PIN) sensor.attachGpio1(slot.gpio1Pin);
+
+  slot.present = true;
+  return true;
+}
+
+bool VL6180XArray::startStaggered(uint16_t periodMs, bool interleaved) {
+  _periodMs = periodMs;
+  _interleaved = interleaved;
+  _startMs = millis();
+  _running = false;
+
+  for (uint8_t i = 0; i < _count; i++) {
+    _slots[i].started = false;
+    if (_slots[i].present) _running = true;
+  }
+  update();  // Sensor 0 starts right away
+  return _running;
+}
+
+void VL6180XArray::stop() {
+  for (uint8_t i = 0; i < _count; i++) {
+    if (_slots[i].started) _sensors[i].stopContinuous();
+    _slots[i].started = false;
+  }
+  _running = false;
+}
+
+void VL6180XArray::update() {
+  if (_queue != nullptr) _queue->poll();
+  if (!_running) return;
+
+  const uint32_t elapsed = millis() - _startMs;
+  for (uint8_t i = 0; i < _count; i++) {
+    Slot &slot = _slots[i];
+    if (!slot.present) continue;
+
+    if (!slot.started) {
+      // Sensor i starts i/N of a period after sensor 0
+      if (elapsed < (uint32_t)_periodMs * i / _count) continue;
+      slot.started = _interleaved ? _sensors[i].startInterleaved(_periodMs)
+                                  : _sensors[i].startRangeContinuous(_periodMs);
+      if (!slot.started) slot.present = false;  // Lost since begin()
+      continue;
+    }
+    _sensors[i].update();
+  }
+}
+
+bool VL6180XArray::readSample(uint8_t &index, VL6180xSample &sample) {
+  for (uint8_t n = 0; n < _count; n++) {
+    const uint8_t i = _nextRead;
+    _nextRead = (_nextRead + 1) % _count;
+    if (_slots[i].present && _sensors[i].readSample(sample)) {
+      index = i;
+      return true;
+    }
+  }
+  return false;
+}
+
+uint8_t VL6180XArray::getCount() const {
+  return _count;
+}
+
+bool VL6180XArray::isPresent(uint8_t index) const {
+  return index < _count && _slots[index].present;
+}
+
+VL6180X &VL6180XArray::sensor(uint8_t index) {
+  return _sensors[index];
+}
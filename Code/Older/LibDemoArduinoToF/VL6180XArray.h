@@ -0,0 +1,81 @@
+/**
+ * @file VL6180XArray.h
+ * @brief Several VL6180X sensors on one bus.
+ *
+ * Every VL6180X starts at address 0x29. The array holds all sensors in
+ * reset through their XSHUT (GPIO0) pins, then releases them one by one
+ * and moves each to its own address before the next one wakes up.
+ *
+ * startStaggered() starts continuous ranging on all sensors with the same
+ * period, but the starts are spread evenly over that period: the emitters
+ * never fire together and the bus sees one result at a time. With an
+ * I2CQueue the result reads are asynchronous, so N sensors give N samples
+ * per period.
+ *
+ * Usage:
+ *   VL6180XArray tof(&WireSensorA, &queueA);
+ *   tof.addSensor(XSHUT_0, 0x30, GPIO1_0);
+ *   tof.addSensor(XSHUT_1, 0x31);           // No GPIO1 line: status polling
+ *   tof.begin();
+ *   tof.startStaggered(100);
+ *   loop(): tof.update(); while (tof.readSample(i, sample)) { ... }
+ */
+
+#ifndef VL6180XARRAY_H
+#define VL6180XARRAY_H
+
+#include "Arduino.h"
+#include "VL6180X.h"
+
+#define VL6180X_ARRAY_MAX 8
+#define VL6180X_XSHUT_RESET_MS 1   // XSHUT low time
+#define VL6180X_BOOT_MS 2          // Firmware boot after XSHUT goes high
+
+class VL6180XArray {
+public:
+  // queue: optional, result reads are blocking without it
+  VL6180XArray(TwoWire *wire, I2CQueue *queue = nullptr);
+
+  // Register a sensor; returns its index or -1 if the array is full
+  int8_t addSensor(uint8_t xshutPin, uint8_t address, uint8_t gpio1Pin = VL6180X_NO_PIN);
+
+  // Reset all, then bring them up one by one; returns the number present
+  uint8_t begin();
+
+  bool startStaggered(uint16_t periodMs = 100, bool interleaved = false);
+  void stop();
+  void update();  // Call every loop(); also polls the queue
+
+  // Next sample of any sensor (round robin); index receives the sensor
+  bool readSample(uint8_t &index, VL6180xSample &sample);
+
+  uint8_t getCount() const;
+  bool isPresent(uint8_t index) const;
+  VL6180X &sensor(uint8_t index);
+
+private:
+  struct Slot {
+    uint8_t xshutPin;
+    uint8_t address;
+    uint8_t gpio1Pin;
+    bool present;
+    bool started;
+  };
+
+  bool bringUp(uint8_t index);
+
+  TwoWire *_wire;
+  I2CQueue *_queue;
+  VL6180X _sensors[VL6180X_ARRAY_MAX];
+  Slot _slots[VL6180X_ARRAY_MAX];
+  uint8_t _count;
+
+  // Staggered start
+  bool _running;
+  bool _interleaved;
+  uint16_t _periodMs;
+  uint32_t _startMs;
+  uint8_t _nextRead;
+};
+
+#endif // VL6180XARRAY_H
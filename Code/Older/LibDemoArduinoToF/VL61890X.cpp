@@ -8,10 +8,167 @@
 
 #include "VL6180X.h"
 
+// Mandatory private register settings after a fresh reset (datasheet order).
+// Consecutive addresses are merged into one transaction by writeSequence().
+static const I2CRegisterWrite MANDATORY_SETTINGS[] = {
+  {0x0207, 0x01}, {0x0208, 0x01},
+  {0x0096, 0x00}, {0x0097, 0xfd},
+  {0x00e3, 0x00}, {0x00e4, 0x04}, {0x00e5, 0x02}, {0x00e6, 0x01}, {0x00e7, 0x03},
+  {0x00f5, 0x02},
+  {0x00d9, 0x05},
+  {0x00db, 0xce}, {0x00dc, 0x03}, {0x00dd, 0xf8},
+  {0x009f, 0x00},
+  {0x00a3, 0x3c},
+  {0x00b7, 0x00},
+  {0x00bb, 0x3c},
+  {0x00b2, 0x09},
+  {0x00ca, 0x09},
+  {0x0198, 0x01},
+  {0x01b0, 0x17},
+  {0x01ad, 0x00},
+  {0x00ff, 0x05}, {0x0100, 0x05},
+  {0x0199, 0x05},
+  {0x01a6, 0x1b},
+  {0x01ac, 0x3e},
+  {0x01a7, 0x1f},
+  {0x0030, 0x00},
+};
+
+// Default configuration, applied in this order. 16-bit registers are
+// listed as two bytes, MSB first.
+static const I2CRegisterWrite DEFAULT_SETTINGS[] = {
+  // Recommended settings from datasheet
+  // http://www.st.com/st-web-ui/static/active/en/resource/technical/document/application_note/DM00122600.pdf
+  {VL6180X_SYSTEM_INTERRUPT_CONFIG_GPIO, (4 << 3) | (4)},   // Interrupts on conversion complete (any source)
+  {VL6180X_SYSTEM_MODE_GPIO1, 0x10},                        // Set GPIO1 high when sample complete
+  {VL6180X_READOUT_AVERAGING_SAMPLE_PERIOD, 0x30},          // Set Avg sample period
+  {VL6180X_SYSALS_ANALOGUE_GAIN, 0x46},                     // Set the ALS gain
+  {VL6180X_SYSRANGE_VHV_REPEAT_RATE, 0xFF},                 // Set auto calibration period (Max = 255)/(OFF = 0)
+  {VL6180X_SYSALS_INTEGRATION_PERIOD, 0x63},                // Set ALS integration time to 100ms
+  {VL6180X_SYSRANGE_VHV_RECALIBRATE, 0x01},                 // Perform a single temperature calibration
+
+  // Optional settings from datasheet
+  {VL6180X_SYSRANGE_INTERMEASUREMENT_PERIOD, 0x09},         // Default ranging inter-measurement period 100ms
+  {VL6180X_SYSALS_INTERMEASUREMENT_PERIOD, 0x0A},           // Default ALS inter-measurement period 100ms
+  {VL6180X_SYSTEM_INTERRUPT_CONFIG_GPIO, 0x24},             // Interrupt on 'New Sample Ready threshold event'
+
+  // Additional settings defaults from community
+  {VL6180X_SYSRANGE_MAX_CONVERGENCE_TIME, 0x32},
+  {VL6180X_SYSRANGE_RANGE_CHECK_ENABLES, 0x10 | 0x01},
+  {VL6180X_SYSRANGE_EARLY_CONVERGENCE_ESTIMATE, 0x00}, {VL6180X_SYSRANGE_EARLY_CONVERGENCE_ESTIMATE + 1, 0x7B},
+  {VL6180X_SYSALS_INTEGRATION_PERIOD, 0x00}, {VL6180X_SYSALS_INTEGRATION_PERIOD + 1, 0x64},
+  {VL6180X_READOUT_AVERAGING_SAMPLE_PERIOD, 0x30},
+  {VL6180X_SYSALS_ANALOGUE_GAIN, 0x40},
+  {VL6180X_FIRMWARE_RESULT_SCALER, 0x01},
+};
+
+// Registers the sensor changes itself: never taken from the shadow cache.
+// Everything else (configuration) is written once and skipped after that.
+static const I2CRegisterRange VOLATILE_REGISTERS[] = {
+  {VL6180X_IDENTIFICATION_MODEL_ID, VL6180X_IDENTIFICATION_TIME + 1},  // Read by begin() as presence check
+  {VL6180X_SYSTEM_INTERRUPT_CLEAR, VL6180X_SYSRANGE_START},  // Clear, reset flag, hold, start
+  {VL6180X_SYSRANGE_VHV_RECALIBRATE, VL6180X_SYSRANGE_VHV_RECALIBRATE},  // Self-clearing
+  {VL6180X_SYSALS_START, VL6180X_SYSALS_START},
+  {VL6180X_RESULT_RANGE_STATUS, 0x0083},  // Results
+  {VL6180X_FIRMWARE_BOOTUP, VL6180X_FIRMWARE_BOOTUP},
+  {VL6180X_I2C_SLAVE_DEVICE_ADDRESS, VL6180X_I2C_SLAVE_DEVICE_ADDRESS},
+};
+
+// Warm start. SYSRANGE_THRESH_HIGH/LOW are free (GPIO1 signals new
+// samples, not thresholds), so startup() leaves a checksum of both
+// settings tables there. CHECK_FIRST..CHECK_LAST is one transfer and
+// holds the reset flag, that signature and most of the configuration.
+#define VL6180X_SIGNATURE_HIGH VL6180X_SYSRANGE_THRESH_HIGH
+#define VL6180X_SIGNATURE_LOW VL6180X_SYSRANGE_THRESH_LOW
+#define VL6180X_CHECK_FIRST VL6180X_SYSTEM_INTERRUPT_CONFIG_GPIO  // 0x0014
+#define VL6180X_CHECK_LAST VL6180X_SYSRANGE_VHV_REPEAT_RATE        // 0x0031
+#define VL6180X_CHECK_SIZE (VL6180X_CHECK_LAST - VL6180X_CHECK_FIRST + 1)
+
+// Interrupt status codes (RESULT__INTERRUPT_STATUS_GPIO bits 2:0 / 5:3)
+#define VL6180X_INT_NEW_SAMPLE 0x04
+#define VL6180X_INT_CLEAR_ALL 0x07
+#define VL6180X_STATUS_POLL_MS 5
+
+// attachInterrupt() takes no context, so each slot has its own trampoline
+static VL6180X *gpio1Sensors[VL6180X_MAX_INTERRUPT_SENSORS] = {nullptr};
+
+static void gpio1Isr0() { gpio1Sensors[0]->onGpio1(); }
+static void gpio1Isr1() { gpio1Sensors[1]->onGpio1(); }
+static void gpio1Isr2() { gpio1Sensors[2]->onGpio1(); }
+static void gpio1Isr3() { gpio1Sensors[3]->onGpio1(); }
+
+static void (*const gpio1Isrs[VL6180X_MAX_INTERRUPT_SENSORS])() = {
+  gpio1Isr0, gpio1Isr1, gpio1Isr2, gpio1Isr3
+};
+
+// Inter-measurement period register: (value + 1) * 10 ms
+static uint8_t periodCode(uint16_t periodMs) {
+  if (periodMs < 10) return 0;
+  if (periodMs > 2550) return 254;
+  return (uint8_t)(periodMs / 10 - 1);
+}
+
+// Fletcher-16, one byte at a time
+static void checksumAdd(uint16_t &sum, uint8_t byte) {
+  uint8_t low = sum & 0xFF;
+  uint8_t high = sum >> 8;
+  low = (low + byte) % 255;
+  high = (high + low) % 255;
+  sum = ((uint16_t)high << 8) | low;
+}
+
+static void checksumTable(uint16_t &sum, const I2CRegisterWrite *table, size_t count) {
+  for (size_t i = 0; i < count; i++) {
+    checksumAdd(sum, table[i].reg >> 8);
+    checksumAdd(sum, table[i].reg & 0xFF);
+    checksumAdd(sum, table[i].value);
+  }
+}
+
+// Changes whenever a firmware configures the sensor differently
+static uint16_t settingsSignature() {
+  uint16_t sum = 0;
+  checksumTable(sum, MANDATORY_SETTINGS, sizeof(MANDATORY_SETTINGS) / sizeof(MANDATORY_SETTINGS[0]));
+  checksumTable(sum, DEFAULT_SETTINGS, sizeof(DEFAULT_SETTINGS) / sizeof(DEFAULT_SETTINGS[0]));
+  return sum;
+}
+
+// Checksum of the check window registers that DEFAULT_SETTINGS sets: of
+// the values read back (window), or of the table itself (nullptr)
+static uint16_t configChecksum(const uint8_t *window) {
+  uint16_t sum = 0;
+  for (uint16_t reg = VL6180X_CHECK_FIRST; reg <= VL6180X_CHECK_LAST; reg++) {
+    if (reg == VL6180X_SYSRANGE_VHV_RECALIBRATE) continue;  // Self-clearing
+
+    bool set = false;
+    uint8_t expected = 0;
+    for (const I2CRegisterWrite &entry : DEFAULT_SETTINGS) {
+      if (entry.reg == reg) {
+        expected = entry.value;  // Last write wins
+        set = true;
+      }
+    }
+    if (set) checksumAdd(sum, window ? window[reg - VL6180X_CHECK_FIRST] : expected);
+  }
+  return sum;
+}
+
 // Constructor
 VL6180X::VL6180X(uint8_t address, I2CHelper i2cHelper)
   : _address(address),
-    _i2cHelper(i2cHelper) {}
+    _i2cHelper(i2cHelper),
+    _queue(nullptr),
+    _mode(MODE_IDLE),
+    _gpio1Pin(VL6180X_NO_PIN),
+    _dataReady(false),
+    _readBusy(false),
+    _lastPollMs(0),
+    _current(),
+    _ringHead(0),
+    _ringCount(0),
+    _overruns(0) {
+  _i2cHelper.enableShadow(VOLATILE_REGISTERS);
+}
 
 bool VL6180X::begin() {
   // Check sensor ID using the convenience method
@@ -21,6 +178,18 @@ bool VL6180X::begin() {
   return true;
 }
 
+bool VL6180X::setAddress(uint8_t newAddress) {
+  const uint8_t value = newAddress & 0x7F;
+  if (!_i2cHelper.writeBlock(_address, VL6180X_I2C_SLAVE_DEVICE_ADDRESS, &value, 1))
+    return false;
+  _address = value;
+  return true;
+}
+
+uint8_t VL6180X::getAddress() const {
+  return _address;
+}
+
 bool VL6180X::init() {
 
   uint8_t data;  // for temp data storage
@@ -30,76 +199,75 @@ bool VL6180X::init() {
   if (data != 1)
     return false; // VL6180x_FAILURE_RESET;
 
-  // Mandatory register settings (refer to datasheet for details)
-  _i2cHelper.writeRegister<uint8_t>(_address, 0x0207, 0x01);
-  _i2cHelper.writeRegister<uint8_t>(_address, 0x0208, 0x01);
-  _i2cHelper.writeRegister<uint8_t>(_address, 0x0096, 0x00);
-  _i2cHelper.writeRegister<uint8_t>(_address, 0x0097, 0xfd);
-  _i2cHelper.writeRegister<uint8_t>(_address, 0x00e3, 0x00);
-  _i2cHelper.writeRegister<uint8_t>(_address, 0x00e4, 0x04);
-  _i2cHelper.writeRegister<uint8_t>(_address, 0x00e5, 0x02);
-  _i2cHelper.writeRegister<uint8_t>(_address, 0x00e6, 0x01);
-  _i2cHelper.writeRegister<uint8_t>(_address, 0x00e7, 0x03);
-  _i2cHelper.writeRegister<uint8_t>(_address, 0x00f5, 0x02);
-  _i2cHelper.writeRegister<uint8_t>(_address, 0x00d9, 0x05);
-  _i2cHelper.writeRegister<uint8_t>(_address, 0x00db, 0xce);
-  _i2cHelper.writeRegister<uint8_t>(_address, 0x00dc, 0x03);
-  _i2cHelper.writeRegister<uint8_t>(_address, 0x00dd, 0xf8);
-  _i2cHelper.writeRegister<uint8_t>(_address, 0x009f, 0x00);
-  _i2cHelper.writeRegister<uint8_t>(_address, 0x00a3, 0x3c);
-  _i2cHelper.writeRegister<uint8_t>(_address, 0x00b7, 0x00);
-  _i2cHelper.writeRegister<uint8_t>(_address, 0x00bb, 0x3c);
-  _i2cHelper.writeRegister<uint8_t>(_address, 0x00b2, 0x09);
-  _i2cHelper.writeRegister<uint8_t>(_address, 0x00ca, 0x09);
-  _i2cHelper.writeRegister<uint8_t>(_address, 0x0198, 0x01);
-  _i2cHelper.writeRegister<uint8_t>(_address, 0x01b0, 0x17);
-  _i2cHelper.writeRegister<uint8_t>(_address, 0x01ad, 0x00);
-  _i2cHelper.writeRegister<uint8_t>(_address, 0x00ff, 0x05);
-  _i2cHelper.writeRegister<uint8_t>(_address, 0x0100, 0x05);
-  _i2cHelper.writeRegister<uint8_t>(_address, 0x0199, 0x05);
-  _i2cHelper.writeRegister<uint8_t>(_address, 0x01a6, 0x1b);
-  _i2cHelper.writeRegister<uint8_t>(_address, 0x01ac, 0x3e);
-  _i2cHelper.writeRegister<uint8_t>(_address, 0x01a7, 0x1f);
-  _i2cHelper.writeRegister<uint8_t>(_address, 0x0030, 0x00);
+  // Fresh out of reset: whatever the shadow remembers is gone
+  _i2cHelper.invalidateShadow();
+
+  // Mandatory register settings (refer to datasheet for details),
+  // streamed as auto-increment runs
+  if (_i2cHelper.writeSequence(_address, MANDATORY_SETTINGS) == 0)
+    return false;
 
   return true;
 }
 
 bool VL6180X::configureDefault() {
-//void VL6180X::VL6180xDefaultSettings() {
-    // Recommended settings from datasheet
-    // http://www.st.com/st-web-ui/static/active/en/resource/technical/document/application_note/DM00122600.pdf
-
-    // Enable Interrupts on Conversion Complete (any source)   
-
-    _i2cHelper.writeRegister<uint8_t>(_address, VL6180X_SYSTEM_INTERRUPT_CONFIG_GPIO, (4 << 3) | (4)); // Set GPIO1 high when sample complete
-
-    _i2cHelper.writeRegister<uint8_t>(_address, VL6180X_SYSTEM_MODE_GPIO1, 0x10); // Set GPIO1 high when sample complete
-    _i2cHelper.writeRegister<uint8_t>(_address, VL6180X_READOUT_AVERAGING_SAMPLE_PERIOD, 0x30); // Set Avg sample period
-    _i2cHelper.writeRegister<uint8_t>(_address, VL6180X_SYSALS_ANALOGUE_GAIN, 0x46); // Set the ALS gain
-    _i2cHelper.writeRegister<uint8_t>(_address, VL6180X_SYSRANGE_VHV_REPEAT_RATE, 0xFF); // Set auto calibration period (Max = 255)/(OFF = 0)
-    _i2cHelper.writeRegister<uint8_t>(_address, VL6180X_SYSALS_INTEGRATION_PERIOD, 0x63); // Set ALS integration time to 100ms
-    _i2cHelper.writeRegister<uint8_t>(_address, VL6180X_SYSRANGE_VHV_RECALIBRATE, 0x01); // perform a single temperature calibration
-
-    // Optional settings from datasheet
-    // http://www.st.com/st-web-ui/static/active/en/resource/technical/document/application_note/DM00122600.pdf   
-
-    _i2cHelper.writeRegister<uint8_t>(_address, VL6180X_SYSRANGE_INTERMEASUREMENT_PERIOD, 0x09); // Set default ranging inter-measurement period to 100ms
-    _i2cHelper.writeRegister<uint8_t>(_address, VL6180X_SYSALS_INTERMEASUREMENT_PERIOD, 0x0A);  // Set default ALS inter-measurement period to 100ms
-    _i2cHelper.writeRegister<uint8_t>(_address, VL6180X_SYSTEM_INTERRUPT_CONFIG_GPIO, 0x24);   // Configures interrupt on ‘New Sample Ready threshold event’
+  // Recommended, optional and community settings, see DEFAULT_SETTINGS
+  return _i2cHelper.writeSequence(_address, DEFAULT_SETTINGS) != 0;
+}
 
-    // Additional settings defaults from community   
+VL6180xStartup VL6180X::startup() {
+  uint8_t window[VL6180X_CHECK_SIZE];
+  if (!_i2cHelper.readBlock(_address, VL6180X_CHECK_FIRST, window))
+    return VL6180X_START_FAILED;
+
+  const uint16_t signature = settingsSignature();
+  const bool fresh = window[VL6180X_SYSTEM_FRESH_OUT_OF_RESET - VL6180X_CHECK_FIRST] & 0x01;
+  const uint16_t stored = ((uint16_t)window[VL6180X_SIGNATURE_HIGH - VL6180X_CHECK_FIRST] << 8) |
+                          window[VL6180X_SIGNATURE_LOW - VL6180X_CHECK_FIRST];
+
+  if (!fresh && stored == signature && configChecksum(window) == configChecksum(nullptr)) {
+    // Only stop a range measurement the previous run left going
+    if (window[VL6180X_SYSRANGE_START - VL6180X_CHECK_FIRST] & 0x01) {
+      const I2CRegisterWrite stop[] = {
+        {VL6180X_SYSRANGE_START, 0x01},
+        {VL6180X_SYSTEM_INTERRUPT_CLEAR, VL6180X_INT_CLEAR_ALL},
+      };
+      if (_i2cHelper.writeSequence(_address, stop) == 0)
+        return VL6180X_START_FAILED;
+    }
+    return VL6180X_WARM_START;
+  }
 
-    _i2cHelper.writeRegister<uint8_t>(_address, VL6180X_SYSRANGE_MAX_CONVERGENCE_TIME, 0x32);
-    _i2cHelper.writeRegister<uint8_t>(_address, VL6180X_SYSRANGE_RANGE_CHECK_ENABLES, 0x10 | 0x01);
-    _i2cHelper.writeRegister<uint16_t>(_address, VL6180X_SYSRANGE_EARLY_CONVERGENCE_ESTIMATE, 0x7B);
-    _i2cHelper.writeRegister<uint16_t>(_address, VL6180X_SYSALS_INTEGRATION_PERIOD, 0x64);
+  // Cold: both tables as auto-increment runs, signature last, so an
+  // interrupted start is never taken for a configured sensor
+  _i2cHelper.invalidateShadow();
+  if (_i2cHelper.writeSequence(_address, MANDATORY_SETTINGS) == 0 || !configureDefault())
+    return VL6180X_START_FAILED;
+
+  const I2CRegisterWrite done[] = {
+    {VL6180X_SYSTEM_FRESH_OUT_OF_RESET, 0x00},
+    {VL6180X_SIGNATURE_HIGH, (uint8_t)(signature >> 8)},
+    {VL6180X_SIGNATURE_LOW, (uint8_t)(signature & 0xFF)},
+  };
+  if (_i2cHelper.writeSequence(_address, done) == 0)
+    return VL6180X_START_FAILED;
+  return VL6180X_COLD_START;
+}
 
-    _i2cHelper.writeRegister<uint8_t>(_address, VL6180X_READOUT_AVERAGING_SAMPLE_PERIOD, 0x30);
-    _i2cHelper.writeRegister<uint8_t>(_address, VL6180X_SYSALS_ANALOGUE_GAIN, 0x40);
-    _i2cHelper.writeRegister<uint8_t>(_address, VL6180X_FIRMWARE_RESULT_SCALER, 0x01);
+bool VL6180X::readIdentification(VL6180xIdentification &id) {
+  // 0x0000..0x0009 in one burst (0x0005 is reserved)
+  uint8_t data[10];
+  if (!_i2cHelper.readBlock(_address, VL6180X_IDENTIFICATION_MODEL_ID, data))
+    return false;
 
-    return true;
+  id.idModel = data[0];
+  id.idModelRevMajor = data[1];
+  id.idModelRevMinor = data[2];
+  id.idModuleRevMajor = data[3];
+  id.idModuleRevMinor = data[4];
+  id.idDate = ((uint16_t)data[6] << 8) | data[7];
+  id.idTime = ((uint16_t)data[8] << 8) | data[9];
+  return true;
 }
 
 uint8_t VL6180X::readRangeSingle() {
@@ -150,4 +318,156 @@ void VL6180X::clearInterrupt() {
   _i2cHelper.writeRegister<uint8_t>(_address, SYSTEM__INTERRUPT_CLEAR, 0x01);
 }
 
-//
\ No newline at end of file
+bool VL6180X::attachGpio1(uint8_t pin) {
+  for (uint8_t i = 0; i < VL6180X_MAX_INTERRUPT_SENSORS; i++) {
+    if (gpio1Sensors[i] == nullptr || gpio1Sensors[i] == this) {
+      gpio1Sensors[i] = this;
+      _gpio1Pin = pin;
+      pinMode(pin, INPUT_PULLUP);  // Open drain
+      attachInterrupt(digitalPinToInterrupt(pin), gpio1Isrs[i], FALLING);
+      return true;
+    }
+  }
+  return false;
+}
+
+void VL6180X::setQueue(I2CQueue *queue) {
+  _queue = queue;
+}
+
+void VL6180X::onGpio1() {
+  _dataReady = true;
+}
+
+bool VL6180X::startRangeContinuous(uint16_t periodMs) {
+  const I2CRegisterWrite start[] = {
+    {VL6180X_SYSTEM_INTERRUPT_CONFIG_GPIO, 0x24},  // Range and ALS new sample (configureDefault)
+    {VL6180X_SYSTEM_INTERRUPT_CLEAR, VL6180X_INT_CLEAR_ALL},
+    {VL6180X_SYSRANGE_INTERMEASUREMENT_PERIOD, periodCode(periodMs)},
+    {VL6180X_SYSRANGE_START, 0x03},                // Start, continuous
+  };
+  _dataReady = false;
+  _mode = MODE_RANGE;
+  return _i2cHelper.writeSequence(_address, start) != 0;
+}
+
+bool VL6180X::startInterleaved(uint16_t periodMs) {
+  // Interleaved: every ALS measurement is followed by a range measurement,
+  // so only the range event is routed to GPIO1; both results are new then
+  const I2CRegisterWrite start[] = {
+    {VL6180X_SYSTEM_INTERRUPT_CONFIG_GPIO, 0x04},
+    {VL6180X_SYSTEM_INTERRUPT_CLEAR, VL6180X_INT_CLEAR_ALL},
+    {VL6180X_SYSALS_INTERMEASUREMENT_PERIOD, periodCode(periodMs)},
+    {VL6180X_INTERLEAVED_MODE_ENABLE, 0x01},
+    {VL6180X_SYSALS_START, 0x03},                  // Start, continuous
+  };
+  _dataReady = false;
+  _mode = MODE_INTERLEAVED;
+  return _i2cHelper.writeSequence(_address, start) != 0;
+}
+
+bool VL6180X::stopContinuous() {
+  // Writing the start bit again stops continuous mode
+  const uint16_t startReg = (_mode == MODE_INTERLEAVED) ? VL6180X_SYSALS_START : VL6180X_SYSRANGE_START;
+  const I2CRegisterWrite stop[] = {
+    {startReg, 0x01},
+    {VL6180X_INTERLEAVED_MODE_ENABLE, 0x00},
+    {VL6180X_SYSTEM_INTERRUPT_CONFIG_GPIO, 0x24},
+    {VL6180X_SYSTEM_INTERRUPT_CLEAR, VL6180X_INT_CLEAR_ALL},
+  };
+  _mode = MODE_IDLE;
+  _dataReady = false;
+  return _i2cHelper.writeSequence(_address, stop) != 0;
+}
+
+void VL6180X::update() {
+  if (_mode == MODE_IDLE || _readBusy) return;
+
+  if (_gpio1Pin == VL6180X_NO_PIN && !_dataReady) {
+    // No interrupt line: check the status register at a modest rate
+    const uint32_t now = millis();
+    if (now - _lastPollMs < VL6180X_STATUS_POLL_MS) return;
+    _lastPollMs = now;
+    const uint8_t status = _i2cHelper.readRegister<uint8_t>(_address, RESULT__INTERRUPT_STATUS_GPIO);
+    _dataReady = (status & 0x07) == VL6180X_INT_NEW_SAMPLE;
+  }
+
+  if (!_dataReady) return;
+  _dataReady = false;
+  readResults();
+}
+
+// Results: 0x004D..0x0051 (range status, ALS status, interrupt status, ALS
+// value) in one burst, then the range value, then clear the interrupt
+void VL6180X::readResults() {
+  _current.hasAls = (_mode == MODE_INTERLEAVED);
+
+  if (_queue != nullptr) {
+    // All three or none, so a full pool never leaves the interrupt set
+    if (_queue->getPending() + 3 > I2C_QUEUE_POOL_SIZE - 1) {
+      _dataReady = true;  // Retry on the next update()
+      return;
+    }
+    _readBusy = true;
+    _queue->enqueueRead(_address, RESULT__RANGE_STATUS, 5, onResultStatus, this);
+    _queue->enqueueRead(_address, RESULT__RANGE_VAL, 1, onRangeValue, this);
+    _queue->enqueueWrite8(_address, SYSTEM__INTERRUPT_CLEAR, VL6180X_INT_CLEAR_ALL);
+    return;
+  }
+
+  uint8_t data[5];
+  if (_i2cHelper.readBlock(_address, RESULT__RANGE_STATUS, data)) {
+    _current.rangeStatus = data[0] >> 4;
+    _current.als = ((uint16_t)data[3] << 8) | data[4];
+    _current.range = getRange();
+    _current.timestampMs = millis();
+    pushSample(_current);
+  }
+  _i2cHelper.writeRegister<uint8_t>(_address, SYSTEM__INTERRUPT_CLEAR, VL6180X_INT_CLEAR_ALL);
+}
+
+void VL6180X::onResultStatus(const I2CTransaction &t, void *context) {
+  VL6180X *sensor = static_cast<VL6180X *>(context);
+  if (!t.ok()) {
+    sensor->_current.rangeStatus = 0xFF;  // Marks the sample as unusable
+    return;
+  }
+  sensor->_current.rangeStatus = t.data()[0] >> 4;
+  sensor->_current.als = ((uint16_t)t.data()[3] << 8) | t.data()[4];
+}
+
+void VL6180X::onRangeValue(const I2CTransaction &t, void *context) {
+  VL6180X *sensor = static_cast<VL6180X *>(context);
+  sensor->_readBusy = false;
+  if (!t.ok() || sensor->_current.rangeStatus == 0xFF) return;
+  sensor->_current.range = t.data()[0];
+  sensor->_current.timestampMs = millis();
+  sensor->pushSample(sensor->_current);
+}
+
+void VL6180X::pushSample(const VL6180xSample &sample) {
+  if (_ringCount == VL6180X_SAMPLE_RING) {
+    // Keep the newest: drop the oldest
+    _ringHead = (_ringHead + 1) % VL6180X_SAMPLE_RING;
+    _ringCount--;
+    _overruns++;
+  }
+  _ring[(_ringHead + _ringCount) % VL6180X_SAMPLE_RING] = sample;
+  _ringCount++;
+}
+
+uint8_t VL6180X::available() const {
+  return _ringCount;
+}
+
+bool VL6180X::readSample(VL6180xSample &sample) {
+  if (_ringCount == 0) return false;
+  sample = _ring[_ringHead];
+  _ringHead = (_ringHead + 1) % VL6180X_SAMPLE_RING;
+  _ringCount--;
+  return true;
+}
+
+uint16_t VL6180X::getOverruns() const {
+  return _overruns;
+}
@@ -0,0 +1,270 @@
+/*
+  ObjectPool.h - Fixed-block object pool for firmware (no heap)
+
+  new/delete on a microcontroller takes an unpredictable time and, with
+  objects of different sizes coming and going, fragments the few KB of
+  heap until an allocation fails hours after boot. An ObjectPool<T, N>
+  reserves room for N objects of type T up front (a global or static
+  pool ends up in .bss, so its size shows at link time):
+
+    - create(args...) constructs a T in a free block (placement new),
+      nullptr when the pool is empty: never a hidden heap fallback
+    - destroy(p) runs the destructor and returns the block
+    - both are O(1): the free blocks form a linked list through
+      their own storage, so there is no per-block overhead
+    - makeUnique(args...) returns a std::unique_ptr whose deleter gives
+      the object back to this pool (where <memory> exists; not on AVR)
+    - getStats(): in use, peak, allocations and failed allocations,
+      to size N from a real run instead of a guess
+
+  The Lock parameter decides who may use the pool:
+
+    ObjectPool<Event, 16>                 main loop only (NoLock)
+    ObjectPool<Event, 16, InterruptLock>  main loop and interrupts:
+                                          the free list is changed with
+                                          interrupts off (a few cycles);
+                                          constructors and destructors
+                                          run with interrupts on
+
+  Compile the host demo with: g++ -std=c++14 poolLifecycle.cpp
+*/
+
+#ifndef OBJECT_POOL_H
+#define OBJECT_POOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__AVR__)
+#include <avr/io.h>
+#include <new.h>
+#else
+#include <new>
+#if defined(__has_include)
+#if __has_include(<memory>)
+#include <memory>
+#define OBJECT_POOL_UNIQUE_PTR 1
+#endif
+#endif
+#endif
+
+#if defined(__ARM_ARCH_6M__) || defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || \
+    defined(__ARM_ARCH_8M_BASE__) || defined(__ARM_ARCH_8M_MAIN__)
+#define OBJECT_POOL_CORTEX_M 1
+#include <Arduino.h>  // CMSIS __get_PRIMASK() / __disable_irq()
+#endif
+
+// Single context: no locking at all
+struct NoLock {
+};
+
+// Interrupts off while the object exists, previous state restored after,
+// so it nests and works inside an ISR. On the host (demo, tests) there
+// are no interrupts and it does nothing.
+class InterruptLock {
+public:
+#if defined(__AVR__)
+    InterruptLock() : sreg(SREG) { __asm__ __volatile__("cli" ::: "memory"); }
+    ~InterruptLock() {
+        __asm__ __volatile__("" ::: "memory");  // Pool writes stay inside
+        SREG = sreg;
+    }
+
+private:
+    uint8_t sreg;
+#elif defined(OBJECT_POOL_CORTEX_M)
+    InterruptLock() : primask(__get_PRIMASK()) { __disable_irq(); }
+    ~InterruptLock() { __set_PRIMASK(primask); }
+
+private:
+    uint32_t primask;
+#else
+    InterruptLock() {}
+#endif
+
+    InterruptLock(const InterruptLock&) = delete;
+    InterruptLock& operator=(const InterruptLock&) = delete;
+};
+
+struct ObjectPoolStats {
+    uint16_t capacity;
+    uint16_t used;         // Objects alive now
+    uint16_t peak;         // Most objects alive at once since resetPeak()
+    uint32_t allocations;  // Successful create() calls
+    uint32_t failures;     // create() calls that found the pool empty
+};
+
+template <typename T, uint16_t N, typename Lock = NoLock>
+class ObjectPool {
+    static_assert(N > 0, "ObjectPool needs at least one block");
+
+private:
+    // A free block holds the link to the next free block, a used block
+    // holds the object: the free list costs no memory of its own
+    union Block {
+        Block* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    // No-op lock for NoLock, the real one otherwise
+    template <typename L, typename Dummy = void>
+    struct Guard {
+        L lock;
+    };
+    template <typename Dummy>
+    struct Guard<NoLock, Dummy> {
+    };
+
+    Block blocks[N];
+    Block* freeList;
+    uint8_t inUse[(N + 7) / 8];  // Catches double frees and foreign pointers
+    uint16_t used;
+    uint16_t peak;
+    uint32_t allocations;
+    uint32_t failures;
+
+    uint16_t indexOf(const void* p) const {
+        return (uint16_t)(static_cast<const Block*>(p) - blocks);
+    }
+
+    bool isUsed(uint16_t index) const {
+        return inUse[index >> 3] & (1U << (index & 7));
+    }
+
+    void* allocate() {
+        Guard<Lock> guard;
+        (void)guard;
+        Block* block = freeList;
+        if (block == nullptr) {
+            failures++;
+            return nullptr;
+        }
+        freeList = block->next;
+        const uint16_t index = indexOf(block);
+        inUse[index >> 3] |= (uint8_t)(1U << (index & 7));
+        allocations++;
+        if (++used > peak) {
+            peak = used;
+        }
+        return block->storage;
+    }
+
+    void release(void* p) {
+        Guard<Lock> guard;
+        (void)guard;
+        const uint16_t index = indexOf(p);
+        inUse[index >> 3] &= (uint8_t)~(1U << (index & 7));
+        Block* block = &blocks[index];
+        block->next = freeList;
+        freeList = block;
+        used--;
+    }
+
+public:
+    static constexpr uint16_t CAPACITY = N;
+
+    ObjectPool() : freeList(nullptr), used(0), peak(0), allocations(0), failures(0) {
+        for (uint16_t i = N; i > 0; i--) {
+            blocks[i - 1].next = freeList;
+            freeList = &blocks[i - 1];
+        }
+        for (uint16_t i = 0; i < sizeof(inUse); i++) {
+            inUse[i] = 0;
+        }
+    }
+
+    // Objects still alive are not destroyed: a pool normally lives as
+    // long as the program (global or static)
+    ~ObjectPool() = default;
+
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    // Construct a T in a free block; nullptr when all N are in use
+    template <typename... Args>
+    T* create(Args&&... args) {
+        void* memory = allocate();
+        if (memory == nullptr) {
+            return nullptr;
+        }
+        return new (memory) T(static_cast<Args&&>(args)...);
+    }
+
+    // Destroy an object from create(). false (and nothing happens) for
+    // nullptr, a pointer from somewhere else or an object destroyed twice.
+    bool destroy(T* object) {
+        if (!owns(object)) {
+            return false;
+        }
+        {
+            Guard<Lock> guard;
+            (void)guard;
+            if (!isUsed(indexOf(object))) {
+                return false;
+            }
+        }
+        object->~T();
+        release(object);
+        return true;
+    }
+
+    // true for a live object or any block of this pool
+    bool owns(const T* object) const {
+        const unsigned char* p = reinterpret_cast<const unsigned char*>(object);
+        const unsigned char* first = reinterpret_cast<const unsigned char*>(blocks);
+        if (p < first || p >= first + sizeof(blocks)) {
+            return false;
+        }
+        return (size_t)(p - first) % sizeof(Block) == 0;
+    }
+
+    uint16_t getUsed() const {
+        Guard<Lock> guard;
+        (void)guard;
+        return used;
+    }
+
+    uint16_t getFree() const {
+        return N - getUsed();
+    }
+
+    // All blocks in use: the next create() fails
+    bool isExhausted() const {
+        return getUsed() == N;
+    }
+
+    ObjectPoolStats getStats() const {
+        Guard<Lock> guard;
+        (void)guard;
+        ObjectPoolStats stats = {N, used, peak, allocations, failures};
+        return stats;
+    }
+
+    // Start a new peak measurement (e.g. after start-up)
+    void resetPeak() {
+        Guard<Lock> guard;
+        (void)guard;
+        peak = used;
+    }
+
+#if defined(OBJECT_POOL_UNIQUE_PTR)
+    // unique_ptr deleter that returns the object to its pool
+    struct Deleter {
+        ObjectPool* pool;
+
+        void operator()(T* object) const {
+            pool->destroy(object);
+        }
+    };
+
+    using Ptr = std::unique_ptr<T, Deleter>;
+
+    // Like std::make_unique, but from the pool; empty Ptr when exhausted
+    template <typename... Args>
+    Ptr makeUnique(Args&&... args) {
+        return Ptr(create(static_cast<Args&&>(args)...), Deleter{this});
+    }
+#endif
+};
+
+#endif
@@ -0,0 +1,77 @@
+/*
+  poolLifecycle.cpp - Demo of object lifecycles without the heap
+
+  The other Lifecycle demos get their objects from new / make_unique.
+  On a microcontroller that heap is small, slow to search and fragments.
+  Here the objects live in an ObjectPool: room for a fixed number of
+  them, reserved when the program starts.
+
+  Note: compile using C++ 14
+  (e.g. g++ -std=c++14 poolLifecycle.cpp)
+*/
+
+#include <iostream>
+
+#include "ObjectPool.h"
+
+class IamAlife {
+
+public:
+    explicit IamAlife(int number) : number(number) {
+        std::cout << "Hamlet " << number << " was created in a pool block!" << std::endl;
+    }
+
+    ~IamAlife() {
+        std::cout << "My lifecycle ended: Hamlet " << number << " is no more, the block is free again" << std::endl;
+    }
+
+    void shoutAloud() {
+        std::cout << "Whoohoo, Hamlet " << number << " IamAlife!" << std::endl;
+    }
+
+private:
+    int number;
+};
+
+// Room for three, instead of std::vector<IamAlife *> and new
+ObjectPool<IamAlife, 3> _hamlets;
+
+void printStats() {
+    const ObjectPoolStats stats = _hamlets.getStats();
+    std::cout << "  pool: " << stats.used << "/" << stats.capacity << " in use, peak " << stats.peak
+              << ", " << stats.allocations << " created, " << stats.failures << " refused" << std::endl;
+}
+
+int main() {
+    std::cout << "There we go..." << std::endl;
+    std::cout << std::endl;
+
+    { // local sub scope: unique_ptr gives the object back to the pool
+        ObjectPool<IamAlife, 3>::Ptr toBeOrNotToBe = _hamlets.makeUnique(1);
+        toBeOrNotToBe->shoutAloud();
+        printStats();
+    }
+    printStats();
+    std::cout << std::endl;
+
+    // Plain pointers: create() and destroy() instead of new and delete
+    IamAlife* first = _hamlets.create(2);
+    IamAlife* second = _hamlets.create(3);
+    IamAlife* third = _hamlets.create(4);
+    IamAlife* fourth = _hamlets.create(5);  // No block left: nullptr, no heap
+    if (fourth == nullptr) {
+        std::cout << "No room for Hamlet 5: the pool is full" << std::endl;
+    }
+    printStats();
+
+    _hamlets.destroy(second);
+    if (!_hamlets.destroy(second)) {
+        std::cout << "Hamlet 3 was already gone: double destroy refused" << std::endl;
+    }
+    _hamlets.destroy(first);
+    _hamlets.destroy(third);
+    printStats();
+
+    std::cout << std::endl;
+    std::cout << "Main goes out of scope after this..." << std::endl;
+}
@@ -0,0 +1,76 @@
+#ifndef LINE_ASSEMBLER_H
+#define LINE_ASSEMBLER_H
+
+#include <Arduino.h>
+#include <string.h>
+
+// Read-only view on characters owned by someone else (like std::string_view,
+// which the AVR toolchain does not have). No copy, no heap.
+struct TextView {
+    const char* data;
+    uint8_t length;
+
+    TextView() : data(""), length(0) {}
+    TextView(const char* text, uint8_t len) : data(text), length(len) {}
+
+    bool empty() const {
+        return length == 0;
+    }
+
+    bool equals(const char* text) const {
+        return strlen(text) == length && strncmp(data, text, length) == 0;
+    }
+};
+
+// Collects bytes into lines in a fixed buffer. Call feed() with every
+// received byte; when it returns true, line() holds the complete line
+// (without "\r\n") until the next feed(). Longer lines are truncated.
+template <uint8_t SIZE>
+class LineAssembler {
+private:
+    char buffer[SIZE + 1];  // +1 keeps line() null terminated
+    uint8_t length;
+    bool complete;
+    bool truncated;
+
+public:
+    LineAssembler() : length(0), complete(false), truncated(false) {
+        buffer[0] = '\0';
+    }
+
+    bool feed(char c) {
+        if (complete) {
+            // Previous line has been handed out, start a new one
+            length = 0;
+            complete = false;
+            truncated = false;
+        }
+
+        if (c == '\r') {
+            return false;
+        }
+        if (c == '\n') {
+            buffer[length] = '\0';
+            complete = true;
+            return true;
+        }
+
+        if (length < SIZE) {
+            buffer[length++] = c;
+        } else {
+            truncated = true;
+        }
+        return false;
+    }
+
+    TextView line() const {
+        return complete ? TextView(buffer, length) : TextView();
+    }
+
+    // The last line was longer than SIZE characters
+    bool wasTruncated() const {
+        return truncated;
+    }
+};
+
+#endif
@@ -0,0 +1,101 @@
+#include "I2CBatchReader.h"
+#include "SensirionCrc.h"
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <linux/i2c-dev.h>
+
+I2CBatchReader::I2CBatchReader(const char* i2cDevice)
+    : _i2cDevice(i2cDevice), _fd(-1), _count(0), _command{0, 0},
+      _writes(), _reads(), _rx(), _words(), _valid(), _crcErrors(0), _syscalls(0) {}
+
+I2CBatchReader::~I2CBatchReader() {
+    if (_fd != -1) close(_fd);
+}
+
+bool I2CBatchReader::begin() {
+    _fd = open(_i2cDevice, O_RDWR);
+    if (_fd == -1) return false;
+
+    // Combined transfers need I2C_FUNC_I2C (not just SMBus)
+    unsigned long funcs = 0;
+    if (ioctl(_fd, I2C_FUNCS, &funcs) < 0 || !(funcs & I2C_FUNC_I2C)) return false;
+    return true;
+}
+
+int I2CBatchReader::addDevice(uint8_t address, uint8_t words) {
+    if (_count >= MaxDevices || words == 0 || words > MaxWords) return -1;
+
+    i2c_msg& w = _writes[_count];
+    w.addr = address;
+    w.flags = 0;
+    w.len = sizeof(_command);
+    w.buf = _command;
+
+    i2c_msg& r = _reads[_count];
+    r.addr = address;
+    r.flags = I2C_M_RD;
+    r.len = words * 3;
+    r.buf = _rx[_count];
+
+    _valid[_count] = false;
+    return static_cast<int>(_count++);
+}
+
+bool I2CBatchReader::sendCommand(uint16_t command) {
+    _command[0] = command >> 8;
+    _command[1] = command & 0xFF;
+    if (transfer(_writes, _count)) return true;
+
+    // Someone NACKed: still reach the others
+    bool all = true;
+    for (size_t i = 0; i < _count; i++) {
+        all = transfer(&_writes[i], 1) && all;
+    }
+    return all;
+}
+
+size_t I2CBatchReader::readAll() {
+    size_t valid = 0;
+
+    if (transfer(_reads, _count)) {
+        for (size_t i = 0; i < _count; i++) {
+            if (decode(i)) valid++;
+        }
+        return valid;
+    }
+
+    // Not ready or missing device somewhere: fall back to one read each
+    for (size_t i = 0; i < _count; i++) {
+        _valid[i] = false;
+        if (transfer(&_reads[i], 1) && decode(i)) valid++;
+    }
+    return valid;
+}
+
+bool I2CBatchReader::transfer(i2c_msg* messages, size_t count) {
+    if (_fd == -1 || count == 0) return false;
+
+    i2c_rdwr_ioctl_data batch;
+    batch.msgs = messages;
+    batch.nmsgs = static_cast<uint32_t>(count);
+    _syscalls++;
+    return ioctl(_fd, I2C_RDWR, &batch) == static_cast<int>(count);
+}
+
+// Check the CRC of every word of one device and store the words
+bool I2CBatchReader::decode(size_t index) {
+    const uint8_t* data = _rx[index];
+    const size_t words = _reads[index].len / 3;
+
+    for (size_t word = 0; word < words; word++) {
+        if (!sensirionWordValid(data + 3 * word)) {
+            _crcErrors++;
+            _valid[index] = false;
+            return false;
+        }
+        _words[index][word] = (data[3 * word] << 8) | data[3 * word + 1];
+    }
+    _valid[index] = true;
+    return true;
+}
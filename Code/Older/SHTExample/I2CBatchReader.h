@@ -0,0 +1,64 @@
+#ifndef I2C_BATCH_READER_H
+#define I2C_BATCH_READER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <linux/i2c.h>
+
+// Reads many Sensirion-style devices (16-bit words, each followed by a
+// CRC byte) on one Linux I2C bus with the I2C_RDWR ioctl: one syscall sends
+// a command to every device, one syscall reads every device back. All
+// message buffers are allocated once in addDevice().
+//
+// A sampling round for SHT31 single shot:
+//   reader.sendCommand(0x2400); usleep(15000); reader.readAll();
+// The kernel stops a combined transfer at the first NACK; readAll() then
+// retries device by device, so one missing sensor does not lose the round.
+class I2CBatchReader {
+public:
+    static const size_t MaxDevices = 16;
+    static const size_t MaxWords = 2;   // SHT31: temperature, humidity
+
+    explicit I2CBatchReader(const char* i2cDevice = "/dev/i2c-1");
+    ~I2CBatchReader();
+
+    bool begin();
+
+    // Returns the device index, or -1 if the table is full
+    int addDevice(uint8_t address, uint8_t words = MaxWords);
+
+    // Same 2-byte command to every device, one syscall
+    bool sendCommand(uint16_t command);
+
+    // Read all devices in one syscall and check every CRC.
+    // Returns the number of devices with valid data.
+    size_t readAll();
+
+    bool isValid(size_t index) const { return _valid[index]; }
+    uint16_t getWord(size_t index, size_t word) const { return _words[index][word]; }
+    uint8_t getAddress(size_t index) const { return _reads[index].addr; }
+    size_t getDeviceCount() const { return _count; }
+
+    uint32_t getCrcErrors() const { return _crcErrors; }
+    uint32_t getSyscalls() const { return _syscalls; }
+
+private:
+    bool transfer(i2c_msg* messages, size_t count);
+    bool decode(size_t index);
+
+    const char* _i2cDevice;
+    int _fd;
+    size_t _count;
+
+    uint8_t _command[2];                     // Shared by all write messages
+    i2c_msg _writes[MaxDevices];
+    i2c_msg _reads[MaxDevices];
+    uint8_t _rx[MaxDevices][MaxWords * 3];
+    uint16_t _words[MaxDevices][MaxWords];
+    bool _valid[MaxDevices];
+
+    uint32_t _crcErrors;
+    uint32_t _syscalls;
+};
+
+#endif // I2C_BATCH_READER_H
@@ -0,0 +1,214 @@
+#include "I2CMuxBus.h"
+#include "SHT31.h"
+#include "SensirionCrc.h"
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <linux/i2c-dev.h>
+
+static const uint16_t CMD_SINGLE_SHOT = 0x2400;  // High repeatability, no clock stretching
+static const uint8_t MUX_CHANNELS = 8;
+
+I2CMuxBus::I2CMuxBus(const char* i2cDevice)
+    : _i2cDevice(i2cDevice), _fd(-1), _muxes(), _muxCount(0), _sensors(), _count(0), _order(), _groups(),
+      _groupCount(0), _planned(false), _command{0, 0}, _off(0), _switches(0), _crcErrors(0), _syscalls(0) {}
+
+I2CMuxBus::~I2CMuxBus() {
+    if (_fd != -1) close(_fd);
+}
+
+bool I2CMuxBus::begin() {
+    _fd = open(_i2cDevice, O_RDWR);
+    if (_fd == -1) return false;
+
+    // Per-message addresses need I2C_FUNC_I2C (not just SMBus)
+    unsigned long funcs = 0;
+    if (ioctl(_fd, I2C_FUNCS, &funcs) < 0 || !(funcs & I2C_FUNC_I2C)) return false;
+    return true;
+}
+
+int I2CMuxBus::addMux(uint8_t address) {
+    if (_muxCount >= MaxMuxes) return -1;
+
+    Mux& mux = _muxes[_muxCount];
+    mux.address = address;
+    mux.buffer = 0;
+    i2c_msg message = {address, 0, 1, &mux.buffer};
+    if (!transfer(&message, 1)) return -1;
+
+    mux.selected = 0;
+    mux.known = true;
+    return static_cast<int>(_muxCount++);
+}
+
+int I2CMuxBus::addSensor(uint8_t address, int mux, uint8_t channel) {
+    if (_count >= MaxSensors) return -1;
+    if (mux != NoMux && (mux < 0 || static_cast<size_t>(mux) >= _muxCount || channel >= MUX_CHANNELS)) return -1;
+    if (conflicts(address, mux, channel)) return -1;
+
+    Sensor& sensor = _sensors[_count];
+    sensor.address = address;
+    sensor.mux = mux;
+    sensor.channel = mux == NoMux ? 0 : channel;
+    sensor.valid = false;
+    sensor.temperature = 0.0f;
+    sensor.humidity = 0.0f;
+    _planned = false;
+    return static_cast<int>(_count++);
+}
+
+// Two sensors with one address must never be connected at the same time:
+// not on one channel, and not one of them directly on the bus
+bool I2CMuxBus::conflicts(uint8_t address, int mux, uint8_t channel) const {
+    for (size_t i = 0; i < _count; i++) {
+        const Sensor& other = _sensors[i];
+        if (other.address != address) continue;
+        if (mux == NoMux || other.mux == NoMux) return true;
+        if (other.mux == mux && other.channel == channel) return true;
+    }
+    return false;
+}
+
+// Sensors on the bus itself first, then by mux and channel; one group each
+void I2CMuxBus::plan() {
+    for (size_t i = 0; i < _count; i++) {
+        size_t j = i;
+        const Sensor& sensor = _sensors[i];
+        while (j > 0) {
+            const Sensor& before = _sensors[_order[j - 1]];
+            if (before.mux < sensor.mux || (before.mux == sensor.mux && before.channel <= sensor.channel)) break;
+            _order[j] = _order[j - 1];
+            j--;
+        }
+        _order[j] = i;
+    }
+
+    _groupCount = 0;
+    for (size_t i = 0; i < _count; i++) {
+        const Sensor& sensor = _sensors[_order[i]];
+        if (_groupCount == 0 || _groups[_groupCount - 1].mux != sensor.mux ||
+            _groups[_groupCount - 1].channel != sensor.channel) {
+            _groups[_groupCount++] = Group{sensor.mux, sensor.channel, i, 0};
+        }
+        _groups[_groupCount - 1].count++;
+    }
+    _planned = true;
+}
+
+bool I2CMuxBus::trigger() {
+    if (!_planned) plan();
+    _command[0] = CMD_SINGLE_SHOT >> 8;
+    _command[1] = CMD_SINGLE_SHOT & 0xFF;
+
+    bool all = true;
+    for (size_t g = 0; g < _groupCount; g++) {
+        all = transferGroup(_groups[g], false) && all;
+    }
+    return all;
+}
+
+size_t I2CMuxBus::fetch() {
+    if (!_planned) plan();
+
+    // Backwards: the channel trigger() ended on is still selected
+    for (size_t g = _groupCount; g > 0; g--) {
+        transferGroup(_groups[g - 1], true);
+    }
+
+    size_t valid = 0;
+    for (size_t i = 0; i < _count; i++) {
+        if (_sensors[i].valid) valid++;
+    }
+    return valid;
+}
+
+size_t I2CMuxBus::readRound(uint32_t conversionUs) {
+    trigger();
+    usleep(conversionUs);  // One conversion time for all sensors
+    return fetch();
+}
+
+// Channel selects and the command or read of every sensor of the group in
+// one syscall. The kernel stops at the first NACK: then the selects and
+// every sensor are done one by one, so one missing sensor does not cost
+// the others their round.
+bool I2CMuxBus::transferGroup(const Group& group, bool read) {
+    i2c_msg messages[MaxMuxes + MaxSensors];
+    const size_t selects = appendSelect(messages, group.mux, group.channel);
+    size_t count = selects;
+    for (size_t k = 0; k < group.count; k++) {
+        Sensor& sensor = _sensors[_order[group.first + k]];
+        i2c_msg& message = messages[count++];
+        message.addr = sensor.address;
+        message.flags = read ? I2C_M_RD : 0;
+        message.len = read ? sizeof(sensor.rx) : sizeof(_command);
+        message.buf = read ? sensor.rx : _command;
+        if (read) sensor.valid = false;
+    }
+
+    if (transfer(messages, count)) {
+        for (size_t k = 0; read && k < group.count; k++) decode(_sensors[_order[group.first + k]]);
+        return true;
+    }
+
+    if (selects != 0 && !transfer(messages, selects)) {
+        for (size_t m = 0; m < _muxCount; m++) _muxes[m].known = false;  // Write them all again
+        return false;
+    }
+    bool all = true;
+    for (size_t k = 0; k < group.count; k++) {
+        Sensor& sensor = _sensors[_order[group.first + k]];
+        const bool done = transfer(&messages[selects + k], 1);
+        if (done && read) decode(sensor);
+        all = done && all;
+    }
+    return all;
+}
+
+// Messages that connect the channel of mux (nothing for the bus itself):
+// every other mux off, then this one, each only if it is not so already
+size_t I2CMuxBus::appendSelect(i2c_msg* messages, int mux, uint8_t channel) {
+    if (mux == NoMux) return 0;
+
+    size_t count = 0;
+    for (size_t m = 0; m < _muxCount; m++) {
+        Mux& other = _muxes[m];
+        if (static_cast<int>(m) == mux || (other.known && other.selected == 0)) continue;
+        messages[count++] = i2c_msg{other.address, 0, 1, &_off};
+        other.selected = 0;
+        other.known = true;
+    }
+
+    Mux& target = _muxes[mux];
+    const uint8_t mask = static_cast<uint8_t>(1u << channel);
+    if (!target.known || target.selected != mask) {
+        target.buffer = mask;
+        messages[count++] = i2c_msg{target.address, 0, 1, &target.buffer};
+        target.selected = mask;
+        target.known = true;
+        _switches++;
+    }
+    return count;
+}
+
+bool I2CMuxBus::transfer(i2c_msg* messages, size_t count) {
+    if (_fd == -1 || count == 0) return false;
+
+    i2c_rdwr_ioctl_data batch;
+    batch.msgs = messages;
+    batch.nmsgs = static_cast<uint32_t>(count);
+    _syscalls++;
+    return ioctl(_fd, I2C_RDWR, &batch) == static_cast<int>(count);
+}
+
+// Each word is followed by its CRC (rx[2], rx[5])
+bool I2CMuxBus::decode(Sensor& sensor) {
+    if (!sensirionWordValid(sensor.rx) || !sensirionWordValid(sensor.rx + 3)) {
+        _crcErrors++;
+        return false;
+    }
+    sensor.temperature = SHT31::toCelsius((sensor.rx[0] << 8) | sensor.rx[1]);
+    sensor.humidity = SHT31::toHumidity((sensor.rx[3] << 8) | sensor.rx[4]);
+    sensor.valid = true;
+    return true;
+}
@@ -0,0 +1,116 @@
+#ifndef I2C_MUX_BUS_H
+#define I2C_MUX_BUS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <linux/i2c.h>
+
+// Many SHT31s on one Linux I2C bus, behind TCA9548A multiplexers. The bus
+// owns the one file descriptor; sensors are addressed per message
+// (I2C_RDWR), so there is no I2C_SLAVE ioctl per sensor and sensors with
+// the same address may sit on different mux channels.
+//
+// A round triggers a single shot on every sensor, waits one conversion
+// time and fetches every result: N sensors take about 15 ms per round,
+// not N * 15 ms. Sensors are grouped by mux channel; every group is one
+// syscall that selects the channel and talks to all its sensors. The
+// fetch walks the groups in reverse, so it starts on the channel the
+// trigger ended on, and ends on the one the next trigger starts with:
+// 2 * (channels - 1) channel switches per round.
+//
+// Sensors directly on the bus are reachable whatever channel is selected,
+// so their address must not be used behind a mux. With several muxes, the
+// channels of the one not in use are all switched off.
+class I2CMuxBus {
+public:
+    static const size_t MaxMuxes = 8;      // TCA9548A 0x70..0x77
+    static const size_t MaxSensors = 64;
+    static const int NoMux = -1;
+
+    explicit I2CMuxBus(const char* i2cDevice = "/dev/i2c-1");
+    ~I2CMuxBus();
+
+    bool begin();
+
+    // Returns the mux index, or -1 if the table is full or the mux does
+    // not answer (all its channels are switched off here)
+    int addMux(uint8_t address);
+
+    // Returns the sensor index, or -1 if full, the channel does not exist
+    // or the address cannot be told apart from another sensor
+    int addSensor(uint8_t address, int mux = NoMux, uint8_t channel = 0);
+
+    // Single shot (high repeatability) on every sensor, channel by channel
+    bool trigger();
+
+    // Results of every sensor, CRC checked; call one conversion time after
+    // trigger(). Returns the number of sensors with valid data.
+    size_t fetch();
+
+    // trigger(), wait conversionUs, fetch()
+    size_t readRound(uint32_t conversionUs = 15000);
+
+    bool isValid(size_t index) const { return _sensors[index].valid; }
+    float getTemperature(size_t index) const { return _sensors[index].temperature; }
+    float getHumidity(size_t index) const { return _sensors[index].humidity; }
+    uint8_t getAddress(size_t index) const { return _sensors[index].address; }
+    size_t getSensorCount() const { return _count; }
+
+    uint32_t getChannelSwitches() const { return _switches; }
+    uint32_t getCrcErrors() const { return _crcErrors; }
+    uint32_t getSyscalls() const { return _syscalls; }
+
+private:
+    struct Mux {
+        uint8_t address;
+        uint8_t selected;    // Channel mask written last
+        bool known;          // false after a failed transfer: write it again
+        uint8_t buffer;      // Message buffer of the next select
+    };
+
+    struct Sensor {
+        uint8_t address;
+        int mux;
+        uint8_t channel;
+        uint8_t rx[6];
+        bool valid;
+        float temperature;
+        float humidity;
+    };
+
+    struct Group {
+        int mux;
+        uint8_t channel;
+        size_t first;        // Into _order
+        size_t count;
+    };
+
+    void plan();
+    bool transferGroup(const Group& group, bool read);
+    bool conflicts(uint8_t address, int mux, uint8_t channel) const;
+    size_t appendSelect(i2c_msg* messages, int mux, uint8_t channel);
+    bool transfer(i2c_msg* messages, size_t count);
+    bool decode(Sensor& sensor);
+
+    const char* _i2cDevice;
+    int _fd;
+
+    Mux _muxes[MaxMuxes];
+    size_t _muxCount;
+
+    Sensor _sensors[MaxSensors];
+    size_t _count;
+    size_t _order[MaxSensors];           // Sensor indices sorted by mux and channel
+    Group _groups[MaxSensors];
+    size_t _groupCount;
+    bool _planned;
+
+    uint8_t _command[2];
+    uint8_t _off;                        // Buffer of a deselect (all channels off)
+
+    uint32_t _switches;
+    uint32_t _crcErrors;
+    uint32_t _syscalls;
+};
+
+#endif // I2C_MUX_BUS_H
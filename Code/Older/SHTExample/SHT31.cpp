@@ -1,15 +1,40 @@
 #include "SHT31.h"
+#include "SensirionCrc.h"
 #include <unistd.h>
 #include <fcntl.h>
+#include <time.h>
 #include <sys/ioctl.h>
 #include <linux/i2c-dev.h>
 
+// Periodic mode commands [rate][repeatability], datasheet table 10
+static const uint16_t PERIODIC_COMMANDS[5][3] = {
+    {0x2032, 0x2024, 0x202F},  // 0.5 mps
+    {0x2130, 0x2126, 0x212D},  // 1 mps
+    {0x2236, 0x2220, 0x222B},  // 2 mps
+    {0x2334, 0x2322, 0x2329},  // 4 mps
+    {0x2737, 0x2721, 0x272A},  // 10 mps
+};
+static const uint32_t PERIODIC_INTERVAL_US[5] = {2000000, 1000000, 500000, 250000, 100000};
+
+static const uint16_t CMD_FETCH_DATA = 0xE000;
+static const uint16_t CMD_BREAK = 0x3093;
+static const uint32_t RETRY_US = 2000;  // Fetch was early: try again after this
+
+static uint64_t monotonicUs() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + ts.tv_nsec / 1000;
+}
 
 SHT31::SHT31(const char* i2cDevice, uint8_t i2cAddr)
-    : _i2cDevice(i2cDevice), _i2cAddr(i2cAddr), _fd(-1) {}
+    : _i2cDevice(i2cDevice), _i2cAddr(i2cAddr), _fd(-1),
+      _periodUs(0), _nextFetchUs(0), _temperature(0.0f), _humidity(0.0f), _crcErrors(0) {}
 
 SHT31::~SHT31() {
-    if (_fd != -1) close(_fd);
+    if (_fd != -1) {
+        if (isPeriodic()) stopPeriodic();
+        close(_fd);
+    }
 }
 
 bool SHT31::begin() {
@@ -20,19 +45,79 @@ bool SHT31::begin() {
 }
 
 bool SHT31::readSensor(float &temperature, float &humidity) {
-    uint8_t cmd[] = {0x24, 0x00}; // High repeatability measurement command
-    if (write(_fd, cmd, 2) != 2) return false;
+    if (isPeriodic()) return false;  // The sensor ignores single shot commands now
+
+    if (!writeCommand(0x2400)) return false; // High repeatability measurement command
     usleep(15000);  // 15ms measurement delay
 
+    return readMeasurement(temperature, humidity);
+}
+
+bool SHT31::startPeriodic(Rate rate, Repeatability repeatability) {
+    const int r = static_cast<int>(rate);
+    if (isPeriodic() && !stopPeriodic()) return false;
+    if (!writeCommand(PERIODIC_COMMANDS[r][static_cast<int>(repeatability)])) return false;
+
+    _periodUs = PERIODIC_INTERVAL_US[r];
+    _nextFetchUs = monotonicUs() + _periodUs;
+    return true;
+}
+
+bool SHT31::stopPeriodic() {
+    _periodUs = 0;
+    if (!writeCommand(CMD_BREAK)) return false;
+    usleep(1000);  // Back to idle within 1 ms
+    return true;
+}
+
+bool SHT31::poll(float &temperature, float &humidity) {
+    if (!isPeriodic()) return false;
+
+    const uint64_t now = monotonicUs();
+    if (now < _nextFetchUs) return false;  // Not due: no bus traffic
+
+    // Without new data the sensor NACKs the read
+    if (!writeCommand(CMD_FETCH_DATA) || !readMeasurement(temperature, humidity)) {
+        _nextFetchUs = now + RETRY_US;
+        return false;
+    }
+
+    // The sensor clock drifts; schedule from the moment data was found
+    _nextFetchUs = now + _periodUs;
+    return true;
+}
+
+bool SHT31::writeCommand(uint16_t command) {
+    uint8_t cmd[] = {(uint8_t)(command >> 8), (uint8_t)(command & 0xFF)};
+    return write(_fd, cmd, 2) == 2;
+}
+
+bool SHT31::readMeasurement(float &temperature, float &humidity) {
     uint8_t data[6];
     if (read(_fd, data, 6) != 6) return false;
 
-    int rawTemp = (data[0] << 8) | data[1];
-    int rawHum = (data[3] << 8) | data[4];
+    // Each word is followed by its CRC (data[2], data[5])
+    if (!sensirionWordValid(data) || !sensirionWordValid(data + 3)) {
+        _crcErrors++;
+        return false;
+    }
 
-    // Convert raw values to actual temperature and humidity
-    temperature = 175.0f * rawTemp / 65535.0f - 45.0f;
-    humidity = 100.0f * rawHum / 65535.0f;
+    uint16_t rawTemp = (data[0] << 8) | data[1];
+    uint16_t rawHum = (data[3] << 8) | data[4];
 
+    temperature = toCelsius(rawTemp);
+    humidity = toHumidity(rawHum);
+
+    _temperature = temperature;
+    _humidity = humidity;
     return true;
-}
\ No newline at end of file
+}
+
+// Convert raw values to actual temperature and humidity
+float SHT31::toCelsius(uint16_t rawTemp) {
+    return 175.0f * rawTemp / 65535.0f - 45.0f;
+}
+
+float SHT31::toHumidity(uint16_t rawHum) {
+    return 100.0f * rawHum / 65535.0f;
+}
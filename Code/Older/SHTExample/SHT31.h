@@ -5,16 +5,51 @@
 
 class SHT31 {
 public:
+    // Periodic acquisition rates (measurements per second)
+    enum class Rate : uint8_t { Mps0_5, Mps1, Mps2, Mps4, Mps10 };
+    enum class Repeatability : uint8_t { High, Medium, Low };
+
     SHT31(const char* i2cDevice = "/dev/i2c-1", uint8_t i2cAddr = 0x44);
     ~SHT31();
 
     bool begin();
+
+    // Single shot: blocks for the 15 ms conversion
     bool readSensor(float &temperature, float &humidity);
 
+    // Periodic mode: the sensor measures on its own, poll() fetches the
+    // result. poll() never sleeps; it returns false right away when no new
+    // sample is due yet, so one thread can serve many sensors.
+    bool startPeriodic(Rate rate = Rate::Mps1, Repeatability repeatability = Repeatability::High);
+    bool stopPeriodic();
+    bool poll(float &temperature, float &humidity);
+    bool isPeriodic() const { return _periodUs != 0; }
+    uint32_t getPeriodUs() const { return _periodUs; }
+    uint8_t getAddress() const { return _i2cAddr; }
+
+    // Latest sample from readSensor() or poll()
+    float getTemperature() const { return _temperature; }
+    float getHumidity() const { return _humidity; }
+
+    // Raw words (after CRC check) to units; also for I2CBatchReader results
+    static float toCelsius(uint16_t rawTemp);
+    static float toHumidity(uint16_t rawHum);
+
+    uint32_t getCrcErrors() const { return _crcErrors; }
+
 private:
+    bool writeCommand(uint16_t command);
+    bool readMeasurement(float &temperature, float &humidity);
+
     const char* _i2cDevice;
     uint8_t _i2cAddr;
     int _fd;
+
+    uint32_t _periodUs;      // 0 = single shot mode
+    uint64_t _nextFetchUs;   // Earliest time a new sample can be ready
+    float _temperature;
+    float _humidity;
+    uint32_t _crcErrors;
 };
 
-#endif // SHT31_H
\ No newline at end of file
+#endif // SHT31_H
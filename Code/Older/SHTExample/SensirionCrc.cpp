@@ -0,0 +1,30 @@
+#include "SensirionCrc.h"
+
+namespace {
+
+struct CrcTable {
+    uint8_t value[256];
+
+    // Built at compile time, one entry per possible input byte
+    constexpr CrcTable() : value() {
+        for (int i = 0; i < 256; i++) {
+            uint8_t crc = static_cast<uint8_t>(i);
+            for (int bit = 0; bit < 8; bit++) {
+                crc = (crc & 0x80) ? static_cast<uint8_t>((crc << 1) ^ 0x31) : static_cast<uint8_t>(crc << 1);
+            }
+            value[i] = crc;
+        }
+    }
+};
+
+constexpr CrcTable CRC_TABLE;
+
+} // namespace
+
+uint8_t sensirionCrc8(const uint8_t* data, size_t length) {
+    uint8_t crc = 0xFF;
+    for (size_t i = 0; i < length; i++) {
+        crc = CRC_TABLE.value[crc ^ data[i]];
+    }
+    return crc;
+}
@@ -0,0 +1,16 @@
+#ifndef SENSIRION_CRC_H
+#define SENSIRION_CRC_H
+
+#include <cstddef>
+#include <cstdint>
+
+// CRC-8 as used by Sensirion sensors: polynomial 0x31, init 0xFF, no reflection.
+// Every 16-bit word on the bus is followed by its CRC byte.
+uint8_t sensirionCrc8(const uint8_t* data, size_t length);
+
+// Check a word + CRC triplet: data[0..1] word, data[2] CRC
+inline bool sensirionWordValid(const uint8_t* data) {
+    return sensirionCrc8(data, 2) == data[2];
+}
+
+#endif // SENSIRION_CRC_H
@@ -0,0 +1,143 @@
+#include "SensorGateway.h"
+#include <arpa/inet.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+
+static const uint32_t RETRY_US = 2000;
+static const uint32_t STOP_TAG = 0xFFFFFFFF;  // epoll data of the stop eventfd
+
+static uint64_t monotonicNs() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+SensorGateway::SensorGateway(ShmRing& ring)
+    : _ring(ring), _epollFd(-1), _stopFd(-1), _udpFd(-1), _udpTarget(), _entries(), _count(0),
+      _running(false), _published(0), _missed(0) {}
+
+SensorGateway::~SensorGateway() {
+    for (int i = 0; i < _count; i++) close(_entries[i].timerFd);
+    if (_udpFd != -1) close(_udpFd);
+    if (_stopFd != -1) close(_stopFd);
+    if (_epollFd != -1) close(_epollFd);
+}
+
+bool SensorGateway::begin() {
+    _epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (_epollFd == -1) return false;
+
+    _stopFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (_stopFd == -1) return false;
+
+    epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.u32 = STOP_TAG;
+    return epoll_ctl(_epollFd, EPOLL_CTL_ADD, _stopFd, &event) == 0;
+}
+
+int SensorGateway::addSensor(SHT31* sensor, SHT31::Rate rate) {
+    if (_count >= MaxSensors || !sensor->startPeriodic(rate)) return -1;
+
+    const int timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (timerFd == -1) return -1;
+
+    const uint32_t periodUs = sensor->getPeriodUs();
+    epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.u32 = static_cast<uint32_t>(_count);
+    if (!armTimer(timerFd, periodUs, periodUs) || epoll_ctl(_epollFd, EPOLL_CTL_ADD, timerFd, &event) != 0) {
+        close(timerFd);
+        return -1;
+    }
+
+    _entries[_count].sensor = sensor;
+    _entries[_count].timerFd = timerFd;
+    return _count++;
+}
+
+bool SensorGateway::setUdpTarget(const char* ipv4, uint16_t port) {
+    _udpTarget.sin_family = AF_INET;
+    _udpTarget.sin_port = htons(port);
+    if (inet_pton(AF_INET, ipv4, &_udpTarget.sin_addr) != 1) return false;
+
+    _udpFd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    return _udpFd != -1;
+}
+
+bool SensorGateway::armTimer(int timerFd, uint32_t firstUs, uint32_t periodUs) {
+    itimerspec spec = {};
+    spec.it_value.tv_sec = firstUs / 1000000;
+    spec.it_value.tv_nsec = (firstUs % 1000000) * 1000L;
+    spec.it_interval.tv_sec = periodUs / 1000000;
+    spec.it_interval.tv_nsec = (periodUs % 1000000) * 1000L;
+    return timerfd_settime(timerFd, 0, &spec, nullptr) == 0;
+}
+
+bool SensorGateway::runOnce(int timeoutMs) {
+    epoll_event events[16];
+    const int ready = epoll_wait(_epollFd, events, 16, timeoutMs);
+    if (ready < 0) return false;
+
+    for (int i = 0; i < ready; i++) {
+        if (events[i].data.u32 == STOP_TAG) {
+            uint64_t value;
+            if (read(_stopFd, &value, sizeof(value)) < 0) { /* Already drained */ }
+            _running = false;
+            continue;
+        }
+        handleTimer(static_cast<int>(events[i].data.u32));
+    }
+    return true;
+}
+
+void SensorGateway::run() {
+    _running = true;
+    while (_running) {
+        runOnce();
+    }
+}
+
+void SensorGateway::stop() {
+    _running = false;
+    const uint64_t one = 1;
+    if (write(_stopFd, &one, sizeof(one)) < 0) { /* Counter full: already stopping */ }
+}
+
+void SensorGateway::handleTimer(int index) {
+    Entry& entry = _entries[index];
+
+    uint64_t expirations;
+    if (read(entry.timerFd, &expirations, sizeof(expirations)) != sizeof(expirations)) return;
+
+    float temperature, humidity;
+    const uint32_t periodUs = entry.sensor->getPeriodUs();
+    if (!entry.sensor->poll(temperature, humidity)) {
+        // The sensor clock runs slightly slow: look again shortly
+        _missed++;
+        armTimer(entry.timerFd, RETRY_US, periodUs);
+        return;
+    }
+    // Phase the timer to the sample just found
+    armTimer(entry.timerFd, periodUs, periodUs);
+
+    GatewayReading reading = {};
+    reading.timestampNs = monotonicNs();
+    reading.sensor = static_cast<uint16_t>(index);
+    reading.address = entry.sensor->getAddress();
+    reading.temperature = temperature;
+    reading.humidity = humidity;
+
+    _ring.publish(reading);
+    _published++;
+
+    if (_udpFd != -1) {
+        // Best effort: a full socket buffer drops the datagram, never blocks the loop
+        sendto(_udpFd, &reading, sizeof(reading), MSG_DONTWAIT,
+               reinterpret_cast<const sockaddr*>(&_udpTarget), sizeof(_udpTarget));
+    }
+}
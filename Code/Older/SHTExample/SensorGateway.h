@@ -0,0 +1,62 @@
+#ifndef SENSOR_GATEWAY_H
+#define SENSOR_GATEWAY_H
+
+#include <cstdint>
+#include <netinet/in.h>
+#include "SHT31.h"
+#include "ShmRing.h"
+
+// Runs many SHT31 sensors from one thread. Every sensor is in periodic
+// mode and has its own timerfd at the sensor's rate; one epoll_wait()
+// sleeps until any timer expires, then only that sensor is fetched
+// (non-blocking poll()). Readings are timestamped, published to a shared
+// memory ring for local consumers, and optionally sent as UDP datagrams.
+//
+// i2c-dev has no readiness notification, so the timers are what is
+// waited on; a fetch that comes too early is retried after 2 ms.
+class SensorGateway {
+public:
+    static const int MaxSensors = 64;
+
+    explicit SensorGateway(ShmRing& ring);
+    ~SensorGateway();
+
+    bool begin();
+
+    // Starts periodic mode; the sensor must stay valid. Returns its index or -1.
+    int addSensor(SHT31* sensor, SHT31::Rate rate = SHT31::Rate::Mps1);
+
+    // Also send every reading as a GatewayReading datagram
+    bool setUdpTarget(const char* ipv4, uint16_t port);
+
+    // Wait up to timeoutMs (-1 = forever) and handle what is due
+    bool runOnce(int timeoutMs = -1);
+    void run();   // Until stop()
+    void stop();  // Async-signal-safe
+
+    uint64_t getPublished() const { return _published; }
+    uint64_t getMissed() const { return _missed; }
+
+private:
+    struct Entry {
+        SHT31* sensor;
+        int timerFd;
+    };
+
+    void handleTimer(int index);
+    bool armTimer(int timerFd, uint32_t firstUs, uint32_t periodUs);
+
+    ShmRing& _ring;
+    int _epollFd;
+    int _stopFd;       // eventfd, wakes epoll_wait() from stop()
+    int _udpFd;
+    sockaddr_in _udpTarget;
+    Entry _entries[MaxSensors];
+    int _count;
+    volatile bool _running;
+
+    uint64_t _published;
+    uint64_t _missed;  // Fetches that found no new data
+};
+
+#endif // SENSOR_GATEWAY_H
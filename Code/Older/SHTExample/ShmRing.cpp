@@ -0,0 +1,92 @@
+#include "ShmRing.h"
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+static const uint32_t RING_MAGIC = 0x53485452;  // "SHTR"
+
+static_assert((ShmRing::Capacity & (ShmRing::Capacity - 1)) == 0, "Capacity must be a power of two");
+
+ShmRing::ShmRing() : _layout(nullptr), _fd(-1), _owner(false), _name{0} {}
+
+ShmRing::~ShmRing() {
+    if (_layout != nullptr) munmap(_layout, sizeof(Layout));
+    if (_fd != -1) close(_fd);
+    if (_owner) shm_unlink(_name);
+}
+
+bool ShmRing::create(const char* name) {
+    if (!map(name, true)) return false;
+
+    _owner = true;
+    _layout->magic = 0;
+    _layout->capacity = Capacity;
+    _layout->writeIndex.store(0, std::memory_order_relaxed);
+    for (uint32_t i = 0; i < Capacity; i++) {
+        _layout->slots[i].sequence.store(0, std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+    _layout->magic = RING_MAGIC;
+    return true;
+}
+
+bool ShmRing::open(const char* name) {
+    if (!map(name, false)) return false;
+    return _layout->magic == RING_MAGIC && _layout->capacity == Capacity;
+}
+
+bool ShmRing::map(const char* name, bool writable) {
+    strncpy(_name, name, sizeof(_name) - 1);
+
+    _fd = shm_open(name, writable ? (O_RDWR | O_CREAT) : O_RDONLY, 0644);
+    if (_fd == -1) return false;
+    if (writable && ftruncate(_fd, sizeof(Layout)) != 0) return false;
+
+    void* memory = mmap(nullptr, sizeof(Layout), writable ? (PROT_READ | PROT_WRITE) : PROT_READ,
+                        MAP_SHARED, _fd, 0);
+    if (memory == MAP_FAILED) return false;
+    _layout = static_cast<Layout*>(memory);
+    return true;
+}
+
+void ShmRing::publish(const GatewayReading& reading) {
+    const uint64_t n = _layout->writeIndex.load(std::memory_order_relaxed);
+    Slot& slot = _layout->slots[n & (Capacity - 1)];
+
+    slot.sequence.store(2 * n + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.reading = reading;
+    slot.sequence.store(2 * n + 2, std::memory_order_release);
+    _layout->writeIndex.store(n + 1, std::memory_order_release);
+}
+
+bool ShmRing::read(uint64_t& cursor, GatewayReading& reading, uint64_t& lost) const {
+    lost = 0;
+    for (;;) {
+        const uint64_t written = _layout->writeIndex.load(std::memory_order_acquire);
+        if (cursor >= written) return false;
+
+        if (written - cursor > Capacity) {
+            // Overtaken: skip to the oldest reading still in the ring
+            lost += written - Capacity - cursor;
+            cursor = written - Capacity;
+        }
+
+        const Slot& slot = _layout->slots[cursor & (Capacity - 1)];
+        const uint64_t before = slot.sequence.load(std::memory_order_acquire);
+        reading = slot.reading;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const uint64_t after = slot.sequence.load(std::memory_order_relaxed);
+
+        if (before == 2 * cursor + 2 && after == before) {
+            cursor++;
+            return true;
+        }
+        // Slot rewritten while copying: the writer is a full ring ahead, retry
+    }
+}
+
+uint64_t ShmRing::getWriteIndex() const {
+    return _layout->writeIndex.load(std::memory_order_acquire);
+}
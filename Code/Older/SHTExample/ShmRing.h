@@ -0,0 +1,61 @@
+#ifndef SHM_RING_H
+#define SHM_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// One timestamped sensor reading as published by the gateway
+struct GatewayReading {
+    uint64_t timestampNs;   // CLOCK_MONOTONIC when the sample was fetched
+    uint16_t sensor;        // Index in the gateway
+    uint8_t address;        // I2C address
+    uint8_t flags;
+    float temperature;
+    float humidity;
+};
+
+// Single producer, many consumers ring in POSIX shared memory.
+// Consumers map the segment read-only and read the slots in place: no
+// socket, no copy through the kernel, no effect on the producer. A slow
+// consumer is simply overtaken and told how many readings it lost.
+class ShmRing {
+public:
+    static const uint32_t Capacity = 1024;  // Power of two
+
+    ShmRing();
+    ~ShmRing();
+
+    bool create(const char* name);  // Producer: create (or reset) the segment
+    bool open(const char* name);    // Consumer: map read-only
+
+    void publish(const GatewayReading& reading);
+
+    // Copy the reading at cursor and advance it. Returns false if nothing
+    // new; lost receives the readings that were overwritten before reading.
+    bool read(uint64_t& cursor, GatewayReading& reading, uint64_t& lost) const;
+
+    uint64_t getWriteIndex() const;
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> sequence;  // 2n+1 while slot n is written, 2n+2 when done
+        GatewayReading reading;
+    };
+
+    struct Layout {
+        uint32_t magic;
+        uint32_t capacity;
+        std::atomic<uint64_t> writeIndex;
+        Slot slots[Capacity];
+    };
+
+    bool map(const char* name, bool writable);
+
+    Layout* _layout;
+    int _fd;
+    bool _owner;
+    char _name[64];
+};
+
+#endif // SHM_RING_H
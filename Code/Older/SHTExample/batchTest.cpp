@@ -0,0 +1,36 @@
+#include "SHT31.h"
+#include "I2CBatchReader.h"
+#include <iostream>
+#include <unistd.h>
+
+// Two SHT31 on one bus (ADDR pin low / high), read in two syscalls per round
+int main() {
+    I2CBatchReader reader;
+    if (!reader.begin()) {
+        std::cerr << "Failed to open I2C bus." << std::endl;
+        return 1;
+    }
+    reader.addDevice(0x44);
+    reader.addDevice(0x45);
+
+    for (int round = 0; round < 5; round++) {
+        reader.sendCommand(0x2400);  // Single shot, high repeatability
+        usleep(15000);               // One conversion time for all sensors
+        reader.readAll();
+
+        for (size_t i = 0; i < reader.getDeviceCount(); i++) {
+            std::cout << "0x" << std::hex << int(reader.getAddress(i)) << std::dec << ": ";
+            if (reader.isValid(i)) {
+                std::cout << SHT31::toCelsius(reader.getWord(i, 0)) << " C, "
+                          << SHT31::toHumidity(reader.getWord(i, 1)) << " %" << std::endl;
+            } else {
+                std::cout << "no data" << std::endl;
+            }
+        }
+        sleep(1);
+    }
+
+    std::cout << "Syscalls: " << reader.getSyscalls()
+              << ", CRC errors: " << reader.getCrcErrors() << std::endl;
+    return 0;
+}
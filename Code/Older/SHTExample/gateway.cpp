@@ -0,0 +1,58 @@
+#include "SensorGateway.h"
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Usage: gateway [/dev/i2c-N:addr ...]   (default /dev/i2c-1:0x44)
+// Readings are published in the shared memory ring "/sht_gateway".
+
+static SensorGateway* activeGateway = nullptr;
+
+static void onSignal(int) {
+    if (activeGateway) activeGateway->stop();
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> specs(argv + 1, argv + argc);
+    if (specs.empty()) specs.push_back("/dev/i2c-1:0x44");
+
+    ShmRing ring;
+    if (!ring.create("/sht_gateway")) {
+        std::cerr << "Failed to create shared memory ring." << std::endl;
+        return 1;
+    }
+
+    SensorGateway gateway(ring);
+    if (!gateway.begin()) {
+        std::cerr << "Failed to set up the event loop." << std::endl;
+        return 1;
+    }
+
+    // SHT31 keeps the device name pointer: the strings live in devices
+    std::vector<std::string> devices;
+    devices.reserve(specs.size());
+    std::vector<std::unique_ptr<SHT31>> sensors;
+    for (const std::string& spec : specs) {
+        const size_t colon = spec.find(':');
+        const uint8_t address = colon == std::string::npos ? 0x44 : std::strtoul(spec.c_str() + colon + 1, nullptr, 0);
+        devices.push_back(spec.substr(0, colon));
+
+        sensors.emplace_back(new SHT31(devices.back().c_str(), address));
+        if (!sensors.back()->begin() || gateway.addSensor(sensors.back().get(), SHT31::Rate::Mps10) < 0) {
+            std::cerr << "Skipping sensor " << spec << std::endl;
+        }
+    }
+
+    activeGateway = &gateway;
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    gateway.run();
+
+    std::cout << "Published: " << gateway.getPublished()
+              << ", missed fetches: " << gateway.getMissed() << std::endl;
+    return 0;
+}
@@ -0,0 +1,50 @@
+#include "I2CMuxBus.h"
+#include <cstdlib>
+#include <iostream>
+#include <time.h>
+
+// Usage: muxTest [channels] [mux address]   (default 8 channels, 0x70)
+// An SHT31 at 0x44 and one at 0x45 on every channel of one TCA9548A,
+// all read in one conversion time per round
+static uint64_t monotonicUs() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + ts.tv_nsec / 1000;
+}
+
+int main(int argc, char* argv[]) {
+    const int channels = argc > 1 ? std::atoi(argv[1]) : 8;
+    const uint8_t muxAddress = argc > 2 ? std::strtoul(argv[2], nullptr, 0) : 0x70;
+
+    I2CMuxBus bus;
+    if (!bus.begin()) {
+        std::cerr << "Failed to open I2C bus." << std::endl;
+        return 1;
+    }
+    const int mux = bus.addMux(muxAddress);
+    if (mux < 0) {
+        std::cerr << "No TCA9548A at 0x" << std::hex << int(muxAddress) << std::endl;
+        return 1;
+    }
+    for (int channel = 0; channel < channels; channel++) {
+        bus.addSensor(0x44, mux, channel);
+        bus.addSensor(0x45, mux, channel);
+    }
+
+    for (int round = 0; round < 5; round++) {
+        const uint64_t startUs = monotonicUs();
+        const size_t valid = bus.readRound();
+        std::cout << "Round " << round << ": " << valid << " of " << bus.getSensorCount() << " sensors in "
+                  << (monotonicUs() - startUs) / 1000.0 << " ms" << std::endl;
+
+        for (size_t i = 0; i < bus.getSensorCount(); i++) {
+            if (!bus.isValid(i)) continue;
+            std::cout << "  " << i / 2 << ":0x" << std::hex << int(bus.getAddress(i)) << std::dec << " "
+                      << bus.getTemperature(i) << " C, " << bus.getHumidity(i) << " %" << std::endl;
+        }
+    }
+
+    std::cout << "Syscalls: " << bus.getSyscalls() << ", channel switches: " << bus.getChannelSwitches()
+              << ", CRC errors: " << bus.getCrcErrors() << std::endl;
+    return 0;
+}
@@ -0,0 +1,24 @@
+#include "ShmRing.h"
+#include <iostream>
+#include <unistd.h>
+
+// Local consumer: follows the gateway ring without any syscall per reading
+int main() {
+    ShmRing ring;
+    if (!ring.open("/sht_gateway")) {
+        std::cerr << "Gateway ring not found." << std::endl;
+        return 1;
+    }
+
+    uint64_t cursor = ring.getWriteIndex();  // Only new readings
+    for (;;) {
+        GatewayReading reading;
+        uint64_t lost;
+        while (ring.read(cursor, reading, lost)) {
+            if (lost) std::cerr << "Lost " << lost << " readings" << std::endl;
+            std::cout << reading.timestampNs << " sensor " << reading.sensor << ": "
+                      << reading.temperature << " C, " << reading.humidity << " %" << std::endl;
+        }
+        usleep(50000);
+    }
+}
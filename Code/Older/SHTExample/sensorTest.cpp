@@ -1,5 +1,6 @@
 #include "SHT31.h"
 #include <iostream>
+#include <unistd.h>
 
 int main() {
     SHT31 sensor;
@@ -16,5 +17,19 @@ int main() {
         std::cerr << "Failed to read from sensor." << std::endl;
     }
 
+    // Periodic mode: 2 measurements per second, polled without blocking
+    if (!sensor.startPeriodic(SHT31::Rate::Mps2)) {
+        std::cerr << "Failed to start periodic mode." << std::endl;
+        return 1;
+    }
+    for (int samples = 0; samples < 5; ) {
+        if (sensor.poll(temperature, humidity)) {
+            std::cout << "Periodic: " << temperature << " C, " << humidity << " %" << std::endl;
+            samples++;
+        }
+        usleep(10000);  // Other work would go here
+    }
+    sensor.stopPeriodic();
+
     return 0;
 }
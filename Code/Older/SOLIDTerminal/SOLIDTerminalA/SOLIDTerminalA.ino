@@ -4,6 +4,9 @@
     Johan Korten johan.korten@han.nl
     Oct 2023 v1.0
 
+    Input assembled in a fixed line buffer (no String, no blocking read)
+      (LineAssembler.h: the Code/Older/LineAssembler library, shared by A, B and C)
+
 */
 
 #include "SerialConnectionManager.h"
@@ -10,18 +10,26 @@ public:
     UserInterface(IOHandler& handler) : ioHandler(handler) {}
 
     void start() {
+        displayMessage("Hello! Type anything and press Enter:");
         while (true) { // Main loop
-            displayMessage("Hello! Type anything and press Enter:");
-            String input = getUserInput();
-            displayMessage("You typed: " + input);
+            TextView input = getUserInput();
+            if (!input.empty()) {
+                displayMessage("You typed: ", input);
+                displayMessage("Hello! Type anything and press Enter:");
+            }
         }
     }
 
-    void displayMessage(const String& message) {
+    void displayMessage(const char* message) {
         ioHandler.write(message);
     }
 
-    String getUserInput() {
+    void displayMessage(const char* prefix, const TextView& text) {
+        ioHandler.write(prefix, text);
+    }
+
+    // Empty until a complete line has been received
+    TextView getUserInput() {
         return ioHandler.read();
     }
 };
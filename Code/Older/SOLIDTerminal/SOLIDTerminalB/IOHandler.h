@@ -2,24 +2,45 @@
 #define IOHANDLER_H
 
 #include "IConnectionManager.h"
+#include "LineAssembler.h"
 
 class IOHandler {
+public:
+    static const uint8_t MAX_LINE_LENGTH = 64;
+
 private:
     IConnectionManager& connManager;
+    LineAssembler<MAX_LINE_LENGTH> lineAssembler;
+
 public:
     IOHandler(IConnectionManager& manager) : connManager(manager) {}
 
-    void write(const String& data) {
+    void write(const char* data) {
         if (connManager.isConnected()) {
             Serial.println(data);
         }
     }
 
-    String read() {
-        if (connManager.isConnected() && Serial.available()) {
-            return Serial.readStringUntil('\n');
+    void write(const char* prefix, const TextView& text) {
+        if (connManager.isConnected()) {
+            Serial.print(prefix);
+            Serial.write((const uint8_t*)text.data, text.length);
+            Serial.println();
+        }
+    }
+
+    // Non-blocking: takes what the UART has received so far and returns a
+    // line once it is complete, otherwise an empty view. The view points
+    // into the line buffer and stays valid until the next read().
+    TextView read() {
+        if (connManager.isConnected()) {
+            while (Serial.available()) {
+                if (lineAssembler.feed((char)Serial.read())) {
+                    return lineAssembler.line();
+                }
+            }
         }
-        return "";
+        return TextView();
     }
 };
 
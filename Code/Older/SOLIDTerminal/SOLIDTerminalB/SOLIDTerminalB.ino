@@ -5,6 +5,8 @@
     Oct 2023 v1.0
 
     Added a call-back method
+    Input assembled in a fixed line buffer (no String, no blocking read)
+      (LineAssembler.h: the Code/Older/LineAssembler library, shared by A, B and C)
 
 */
 
@@ -17,10 +19,13 @@ IOHandler ioHandler(connManager);
 UserInterface userInterface(ioHandler);
 
 void myCallback() {
+    userInterface.displayMessage("Hello! Type anything and press Enter:");
     while (true) { // Main loop
-        userInterface.displayMessage("Hello! Type anything and press Enter:");
-        String input = userInterface.getUserInput();
-        userInterface.displayMessage("You typed: " + input);
+        TextView input = userInterface.getUserInput();
+        if (!input.empty()) {
+            userInterface.displayMessage("You typed: ", input);
+            userInterface.displayMessage("Hello! Type anything and press Enter:");
+        }
     }
 }
 
@@ -22,11 +22,16 @@ public:
     if (callback) callback();  // Only call if callback is set
   }
 
-  void displayMessage(const String& message) {
+  void displayMessage(const char* message) {
     ioHandler.write(message);
   }
 
-  String getUserInput() {
+  void displayMessage(const char* prefix, const TextView& text) {
+    ioHandler.write(prefix, text);
+  }
+
+  // Empty until a complete line has been received
+  TextView getUserInput() {
     return ioHandler.read();
   }
 };
@@ -1,12 +1,21 @@
 #ifndef ICONNECTION_MANAGER_H
 #define ICONNECTION_MANAGER_H
 
+#include <Arduino.h>
+
 class IConnectionManager {
 public:
     virtual void connect() = 0;
     virtual void disconnect() = 0;
     virtual bool isConnected() const = 0;
+
+    // Byte I/O, never blocks
+    virtual int available() = 0;
+    virtual int read() = 0;  // -1 when nothing has been received
+    // Queues as much of data as fits and returns the number of bytes accepted
+    virtual size_t tryWrite(const uint8_t* data, size_t length) = 0;
+
     virtual ~IConnectionManager() {}
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -2,25 +2,59 @@
 #define IOHANDLER_H
 
 #include "IConnectionManager.h"
+#include "LineAssembler.h"
+
+// Connection is IConnectionManager (virtual calls, any manager at run
+// time) or a concrete final manager: then every call below is direct and
+// can be inlined. Same source for both; IOHandler is the virtual one.
+template <typename Connection = IConnectionManager>
+class BasicIOHandler {
+public:
+    static const uint8_t MAX_LINE_LENGTH = 64;
 
-class IOHandler {
 private:
-    IConnectionManager& connManager;
+    Connection& connManager;
+    LineAssembler<MAX_LINE_LENGTH> lineAssembler;
+
+    bool send(const char* data, size_t length) {
+        return connManager.tryWrite((const uint8_t*)data, length) == length;
+    }
+
 public:
-    IOHandler(IConnectionManager& manager) : connManager(manager) {}
+    BasicIOHandler(Connection& manager) : connManager(manager) {}
 
-    void write(const String& data) {
-        if (connManager.isConnected()) {
-            Serial.println(data);
+    // Never blocks: returns false when the transmit buffer could not take
+    // the whole line (the rest is dropped)
+    bool write(const char* data) {
+        if (!connManager.isConnected()) {
+            return false;
         }
+        return send(data, strlen(data)) && send("\r\n", 2);
     }
 
-    String read() {
-        if (connManager.isConnected() && Serial.available()) {
-            return Serial.readStringUntil('\n');
+    bool write(const char* prefix, const TextView& text) {
+        if (!connManager.isConnected()) {
+            return false;
         }
-        return "";
+        return send(prefix, strlen(prefix)) && send(text.data, text.length) && send("\r\n", 2);
+    }
+
+    // Non-blocking: takes what the connection has received so far and
+    // returns a line once it is complete, otherwise an empty view. The view
+    // points into the line buffer and stays valid until the next read().
+    TextView read() {
+        if (connManager.isConnected()) {
+            int value;
+            while ((value = connManager.read()) >= 0) {
+                if (lineAssembler.feed((char)value)) {
+                    return lineAssembler.line();
+                }
+            }
+        }
+        return TextView();
     }
 };
 
+typedef BasicIOHandler<> IOHandler;
+
 #endif
@@ -5,16 +5,35 @@
     Oct 2023 v1.0
 
     DesignPattern (Singleton) added
+    Input assembled in a fixed line buffer (no String, no blocking read)
+      (LineAssembler.h: the Code/Older/LineAssembler library, shared by A, B and C)
+    Interrupt driven RX/TX rings (UartConnectionManager), update() from loop()
+    Objects in static storage (StaticInstance), constructed in setup()
+    Terminal on the concrete manager: no virtual calls (BasicIOHandler)
 
 */
 
+// 1 = own UART rings (writes never wait), 0 = Arduino Serial
+#define USE_UART_RINGS 1
+
+#if USE_UART_RINGS
+#include "UartConnectionManager.h"
+typedef UartConnectionManager ConnectionManager;
+#else
 #include "SerialConnectionManager.h"
+typedef SerialConnectionManager ConnectionManager;
+#endif
 #include "IOHandler.h"
 #include "UserInterface.h"
 
-SerialConnectionManager* connManager = SerialConnectionManager::getInstance();
-IOHandler ioHandler(*connManager);
-UserInterface userInterface(ioHandler);
+// Bound to the concrete (final) manager, so all I/O calls are direct.
+// IOHandler / UserInterface are the same code on IConnectionManager.
+typedef BasicIOHandler<ConnectionManager> TerminalIO;
+typedef BasicUserInterface<TerminalIO> TerminalUI;
+
+// Constructed in setup(), in dependency order; get() is a plain reference
+typedef StaticInstance<TerminalIO> IO;
+typedef StaticInstance<TerminalUI> UI;
 
 unsigned long lastUpdateTime = 0;
 const unsigned long updateInterval = 1000; // 1 second
@@ -24,10 +43,10 @@ void myCallback() {
 
     // Check if it's time to update the message
     if(currentMillis - lastUpdateTime > updateInterval) {
-        userInterface.displayMessage("Hello! Type anything and press Enter:");
-        String input = userInterface.getUserInput();
-        if (input.length() > 0) {
-            userInterface.displayMessage("You typed: " + input);
+        UI::get().displayMessage("Hello! Type anything and press Enter:");
+        TextView input = UI::get().getUserInput();
+        if (!input.empty()) {
+            UI::get().displayMessage("You typed: ", input);
         }
 
         lastUpdateTime = currentMillis;
@@ -36,11 +55,15 @@ void myCallback() {
 
 
 void setup() {
+    ConnectionManager* connManager = ConnectionManager::getInstance();
+    UI::init(IO::init(*connManager));
+
     connManager->connect();
-    userInterface.setCallback(myCallback); // Set the callback
-    userInterface.start(); // This will call the callback
+    UI::get().setCallback(myCallback); // Set the callback
+    UI::get().start(); // This will call the callback
 }
 
 void loop() {
-    // Nothing here for this demo, as the callback is running indefinitely
+    // Returns at once: input is only taken when complete, output is queued
+    UI::get().update();
 }
\ No newline at end of file
@@ -2,11 +2,12 @@
 #define SERIAL_CONNECTION_MANAGER_H
 
 #include "IConnectionManager.h"
+#include "StaticInstance.h"
 
-class SerialConnectionManager : public IConnectionManager {
+class SerialConnectionManager final : public IConnectionManager {
 
 private:
-    static SerialConnectionManager* instance;
+    friend class StaticInstance<SerialConnectionManager>;
 
     SerialConnectionManager() {
         // private constructor
@@ -14,11 +15,15 @@ private:
 
 public:
 
+    // Constructs the instance on the first call (in static storage, no
+    // heap). Call it once in setup(); after that use get()
     static SerialConnectionManager* getInstance() {
-        if (!instance) {
-            instance = new SerialConnectionManager();
-        }
-        return instance;
+        return &StaticInstance<SerialConnectionManager>::init();
+    }
+
+    // Unchecked reference for hot paths, after getInstance()
+    static SerialConnectionManager& get() {
+        return StaticInstance<SerialConnectionManager>::get();
     }
 
     void connect() override {
@@ -32,8 +37,24 @@ public:
         // For demonstration. Actual check might be more complex.
         return Serial;
     }
-};
 
-SerialConnectionManager* SerialConnectionManager::instance = nullptr;
+    int available() override {
+        return Serial.available();
+    }
+    int read() override {
+        return Serial.read();
+    }
+    size_t tryWrite(const uint8_t* data, size_t length) override {
+        // Only what fits in the core's TX buffer, so Serial never blocks
+        const int space = Serial.availableForWrite();
+        if (space <= 0) {
+            return 0;
+        }
+        if (length > (size_t)space) {
+            length = space;
+        }
+        return Serial.write(data, length);
+    }
+};
 
 #endif
\ No newline at end of file
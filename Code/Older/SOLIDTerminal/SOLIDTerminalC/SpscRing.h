@@ -0,0 +1,72 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <Arduino.h>
+
+// Single-producer single-consumer byte ring. One side may run in an
+// interrupt: the producer only writes head, the consumer only writes tail,
+// and both are single bytes, so no locking is needed.
+// SIZE must be a power of two, at most 128 (free-running 8-bit indices).
+template <uint8_t SIZE>
+class SpscRing {
+    static_assert(SIZE > 0 && SIZE <= 128 && (SIZE & (SIZE - 1)) == 0,
+                  "SpscRing size must be a power of two up to 128");
+
+private:
+    uint8_t buffer[SIZE];
+    volatile uint8_t head;     // Written by the producer
+    volatile uint8_t tail;     // Written by the consumer
+    volatile uint8_t highWater;
+
+public:
+    SpscRing() : head(0), tail(0), highWater(0) {}
+
+    // Producer side
+    bool push(uint8_t value) {
+        const uint8_t h = head;
+        const uint8_t used = (uint8_t)(h - tail);
+        if (used >= SIZE) {
+            return false;
+        }
+        buffer[h & (SIZE - 1)] = value;
+        head = h + 1;  // Publish after the data is in place
+        if (used + 1 > highWater) {
+            highWater = used + 1;
+        }
+        return true;
+    }
+
+    uint8_t space() const {
+        return SIZE - count();
+    }
+
+    // Consumer side
+    bool pop(uint8_t& value) {
+        const uint8_t t = tail;
+        if (t == head) {
+            return false;
+        }
+        value = buffer[t & (SIZE - 1)];
+        tail = t + 1;
+        return true;
+    }
+
+    uint8_t count() const {
+        return (uint8_t)(head - tail);
+    }
+
+    bool isEmpty() const {
+        return head == tail;
+    }
+
+    // Highest fill level seen since construction
+    uint8_t getHighWater() const {
+        return highWater;
+    }
+
+    static uint8_t capacity() {
+        return SIZE;
+    }
+};
+
+#endif
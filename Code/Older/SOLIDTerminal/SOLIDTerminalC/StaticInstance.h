@@ -0,0 +1,82 @@
+#ifndef STATIC_INSTANCE_H
+#define STATIC_INSTANCE_H
+
+/*
+    Construct-on-first-use without heap and without a check on every use.
+
+    StaticInstance<T> reserves aligned storage for one T in .bss (so its
+    size shows at link time). init() constructs the object in it, once;
+    call it early in setup(), in the order the objects depend on each
+    other. After that get() is a plain reference to a fixed address: no
+    null check, no branch, no heap, so hot paths can call it freely.
+
+        typedef StaticInstance<IOHandler> IO;
+
+        void setup() {
+            IO::init(connection);   // construct, in a known order
+        }
+        void loop() {
+            IO::get().read();       // unchecked reference
+        }
+
+    get() before init() is undefined, like using an uninitialised
+    pointer; isInitialized() / tryGet() are for code that can run first,
+    such as an interrupt handler. The object is never destroyed:
+    firmware does not return from main(), and it saves the atexit()
+    registration of a function-local static.
+
+    A class with a private constructor (a singleton) makes its
+    StaticInstance a friend:  friend class StaticInstance<Manager>;
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__AVR__)
+#include <new.h>
+#else
+#include <new>
+#endif
+
+template <typename T>
+class StaticInstance {
+private:
+    alignas(T) static unsigned char storage[sizeof(T)];
+    static bool constructed;
+
+public:
+    // Construct the instance from args; later calls return the existing one
+    // and ignore their arguments
+    template <typename... Args>
+    static T& init(Args&&... args) {
+        if (!constructed) {
+            new (storage) T(static_cast<Args&&>(args)...);
+            constructed = true;
+        }
+        return get();
+    }
+
+    // Unchecked: only after init()
+    static T& get() {
+        return *reinterpret_cast<T*>(storage);
+    }
+
+    static bool isInitialized() {
+        return constructed;
+    }
+
+    // nullptr before init(), for code that may run earlier
+    static T* tryGet() {
+        return constructed ? &get() : nullptr;
+    }
+
+    StaticInstance() = delete;
+};
+
+template <typename T>
+alignas(T) unsigned char StaticInstance<T>::storage[sizeof(T)];
+
+template <typename T>
+bool StaticInstance<T>::constructed = false;
+
+#endif
@@ -0,0 +1,188 @@
+#ifndef UART_CONNECTION_MANAGER_H
+#define UART_CONNECTION_MANAGER_H
+
+/*
+    Connection manager with its own receive and transmit rings.
+
+    AVR: owns USART0 directly. The RX interrupt fills the receive ring and
+    the data-register-empty interrupt drains the transmit ring, so writing
+    only copies into RAM and never waits for the UART. Do not use Serial in
+    the same sketch: it would claim the same interrupt vectors.
+    Other cores: their Serial is already interrupt driven; service() moves
+    bytes between Serial and the rings without blocking.
+
+    Ring sizes can be set before including this file (power of two, <= 128).
+*/
+
+#include "IConnectionManager.h"
+#include "StaticInstance.h"
+#include "SpscRing.h"
+
+#ifndef UART_RX_BUFFER_SIZE
+#define UART_RX_BUFFER_SIZE 64
+#endif
+#ifndef UART_TX_BUFFER_SIZE
+#define UART_TX_BUFFER_SIZE 128
+#endif
+#ifndef UART_BAUD_RATE
+#define UART_BAUD_RATE 115200UL
+#endif
+
+class UartConnectionManager final : public IConnectionManager {
+
+private:
+    friend class StaticInstance<UartConnectionManager>;
+
+    SpscRing<UART_RX_BUFFER_SIZE> rxRing;
+    SpscRing<UART_TX_BUFFER_SIZE> txRing;
+    volatile uint16_t rxOverruns;  // Bytes lost because the RX ring was full
+    bool connected;
+
+    UartConnectionManager() : rxOverruns(0), connected(false) {
+        // private constructor
+    }
+
+    // Non-AVR: pump between the core's Serial and the rings
+    void service() {
+#if !defined(__AVR__)
+        while (Serial.available()) {
+            if (!rxRing.push((uint8_t)Serial.read())) {
+                rxOverruns++;
+            }
+        }
+        int space = Serial.availableForWrite();
+        uint8_t value;
+        while (space-- > 0 && txRing.pop(value)) {
+            Serial.write(value);
+        }
+#endif
+    }
+
+public:
+
+    // Constructs the instance on the first call (in static storage, no
+    // heap). Call it once in setup(); after that use get()
+    static UartConnectionManager* getInstance() {
+        return &StaticInstance<UartConnectionManager>::init();
+    }
+
+    // Unchecked reference for hot paths, after getInstance()
+    static UartConnectionManager& get() {
+        return StaticInstance<UartConnectionManager>::get();
+    }
+
+    // For the interrupt handlers: never creates the instance
+    static UartConnectionManager* activeInstance() {
+        return StaticInstance<UartConnectionManager>::tryGet();
+    }
+
+    void connect() override {
+#if defined(__AVR__)
+        // Double speed mode, same divisor rounding as the Arduino core
+        const uint16_t ubrr = (uint16_t)((F_CPU / 4UL / UART_BAUD_RATE - 1UL) / 2UL);
+        UCSR0A = _BV(U2X0);
+        UBRR0H = (uint8_t)(ubrr >> 8);
+        UBRR0L = (uint8_t)ubrr;
+        UCSR0C = _BV(UCSZ01) | _BV(UCSZ00);  // 8N1
+        UCSR0B = _BV(RXEN0) | _BV(TXEN0) | _BV(RXCIE0);
+#else
+        Serial.begin(UART_BAUD_RATE);
+#endif
+        connected = true;
+    }
+    void disconnect() override {
+#if defined(__AVR__)
+        UCSR0B = 0;
+#else
+        Serial.end();
+#endif
+        connected = false;
+    }
+    bool isConnected() const override {
+        return connected;
+    }
+
+    int available() override {
+        service();
+        return rxRing.count();
+    }
+    int read() override {
+        service();
+        uint8_t value;
+        return rxRing.pop(value) ? value : -1;
+    }
+    size_t tryWrite(const uint8_t* data, size_t length) override {
+        size_t accepted = 0;
+        while (accepted < length && txRing.push(data[accepted])) {
+            accepted++;
+        }
+#if defined(__AVR__)
+        if (accepted > 0) {
+            UCSR0B |= _BV(UDRIE0);  // The ISR switches it off when empty
+        }
+#endif
+        service();
+        return accepted;
+    }
+
+    // Statistics, to size the rings
+    uint8_t getRxHighWater() const {
+        return rxRing.getHighWater();
+    }
+    uint8_t getTxHighWater() const {
+        return txRing.getHighWater();
+    }
+    uint16_t getRxOverruns() const {
+        return rxOverruns;
+    }
+    uint8_t getTxSpace() const {
+        return txRing.space();
+    }
+
+    // Interrupt hooks (AVR)
+    void onReceive(uint8_t value) {
+        if (!rxRing.push(value)) {
+            rxOverruns++;
+        }
+    }
+    void onTransmitReady() {
+#if defined(__AVR__)
+        uint8_t value;
+        if (txRing.pop(value)) {
+            UDR0 = value;
+        } else {
+            UCSR0B &= ~_BV(UDRIE0);
+        }
+#endif
+    }
+};
+
+#if defined(__AVR__)
+#if defined(USART_RX_vect)
+ISR(USART_RX_vect) {
+#else
+ISR(USART0_RX_vect) {
+#endif
+    const uint8_t status = UCSR0A;   // Read before UDR0
+    const uint8_t value = UDR0;
+    UartConnectionManager* manager = UartConnectionManager::activeInstance();
+    if (manager && !(status & _BV(FE0))) {
+        manager->onReceive(value);
+    }
+}
+
+#if defined(USART_UDRE_vect)
+ISR(USART_UDRE_vect) {
+#else
+ISR(USART0_UDRE_vect) {
+#endif
+    UartConnectionManager* manager = UartConnectionManager::activeInstance();
+    if (manager) {
+        manager->onTransmitReady();
+    } else {
+        UCSR0B &= ~_BV(UDRIE0);
+    }
+}
+#endif
+
+#endif
@@ -5,13 +5,15 @@
 
 typedef void (*CallbackType)();
 
-class UserInterface {
+// IO is IOHandler or a BasicIOHandler on a concrete connection (see there)
+template <typename IO = IOHandler>
+class BasicUserInterface {
 private:
-  IOHandler& ioHandler;
+  IO& ioHandler;
   CallbackType callback;
 
 public:
-  UserInterface(IOHandler& handler)
+  BasicUserInterface(IO& handler)
     : ioHandler(handler), callback(nullptr) {}
 
   void setCallback(CallbackType cb) {
@@ -22,11 +24,16 @@ public:
     if (callback) callback();  // Only call if callback is set
   }
 
-  void displayMessage(const String& message) {
+  void displayMessage(const char* message) {
     ioHandler.write(message);
   }
 
-  String getUserInput() {
+  void displayMessage(const char* prefix, const TextView& text) {
+    ioHandler.write(prefix, text);
+  }
+
+  // Empty until a complete line has been received
+  TextView getUserInput() {
     return ioHandler.read();
   }
 
@@ -35,4 +42,6 @@ public:
   }
 };
 
+typedef BasicUserInterface<> UserInterface;
+
 #endif
@@ -1,36 +1,98 @@
 #include "TwiPinHelper.h"
 
-TwiPinPair::TwiPinPair(uint32_t dataPin, uint32_t clockPin) : _dataPin(dataPin), _clockPin(clockPin) {}
+// Port pin names, index port * 32 + pin
+static const char portPinNames[][5] = {
+    "PA0",  "PA1",  "PA2",  "PA3",  "PA4",  "PA5",  "PA6",  "PA7",
+    "PA8",  "PA9",  "PA10", "PA11", "PA12", "PA13", "PA14", "PA15",
+    "PA16", "PA17", "PA18", "PA19", "PA20", "PA21", "PA22", "PA23",
+    "PA24", "PA25", "PA26", "PA27", "PA28", "PA29", "PA30", "PA31",
+    "PB0",  "PB1",  "PB2",  "PB3",  "PB4",  "PB5",  "PB6",  "PB7",
+    "PB8",  "PB9",  "PB10", "PB11", "PB12", "PB13", "PB14", "PB15",
+    "PB16", "PB17", "PB18", "PB19", "PB20", "PB21", "PB22", "PB23",
+    "PB24", "PB25", "PB26", "PB27", "PB28", "PB29", "PB30", "PB31"
+};
+static const char notAPin[] = "NA";
 
-String TwiPinPair::getPortPin(uint32_t ulPin) {
-    if (g_APinDescription[ulPin].ulPinType == PIO_NOT_A_PIN) {
-        return "NA";
+// Pins to mux, per port group, port half (WRCONFIG HWSEL) and function
+struct MuxMasks {
+    uint16_t mask[2][2][2];
+};
+
+static void addPin(MuxMasks& masks, uint32_t ulPin, TwiPinMux mux) {
+    const PinDescription& desc = g_APinDescription[ulPin];
+    if (desc.ulPinType == PIO_NOT_A_PIN || desc.ulPort > 1) {
+        return;
+    }
+    masks.mask[desc.ulPort][desc.ulPin >> 4][mux - TWI_MUX_SERCOM] |= 1u << (desc.ulPin & 15);
+}
+
+static void writeMasks(const MuxMasks& masks) {
+    for (uint8_t port = 0; port < 2; port++) {
+        for (uint8_t half = 0; half < 2; half++) {
+            for (uint8_t function = 0; function < 2; function++) {
+                const uint16_t pins = masks.mask[port][half][function];
+                if (pins == 0) {
+                    continue;
+                }
+                PORT->Group[port].WRCONFIG.reg = (half ? PORT_WRCONFIG_HWSEL : 0)
+                    | PORT_WRCONFIG_WRPINCFG | PORT_WRCONFIG_PMUXEN | PORT_WRCONFIG_INEN
+                    | PORT_WRCONFIG_WRPMUX | PORT_WRCONFIG_PMUX(TWI_MUX_SERCOM + function)
+                    | PORT_WRCONFIG_PINMASK(pins);
+            }
+        }
     }
+}
 
-    EPortType port = g_APinDescription[ulPin].ulPort;
-    uint32_t pin = g_APinDescription[ulPin].ulPin;
-    String result = "P";
-    char portLetter = 'A';
-    portLetter += port;
-    result += portLetter;
-    result += String(pin);
-    return result;
+const char* TwiPinPair::getPortPin(uint32_t ulPin) {
+    const PinDescription& desc = g_APinDescription[ulPin];
+    if (desc.ulPinType == PIO_NOT_A_PIN || desc.ulPort > 1) {
+        return notAPin;
+    }
+    return portPinNames[desc.ulPort * 32 + desc.ulPin];
 }
 
-String TwiPinPair::getPortPinSDA() {
+const char* TwiPinPair::getPortPinSDA() const {
     return getPortPin(_dataPin);
 }
 
-String TwiPinPair::getPortPinSCL() {
+const char* TwiPinPair::getPortPinSCL() const {
     return getPortPin(_clockPin);
 }
 
-void TwiPinPair::setPinPeripheralStates() {
-    pinPeripheral(_dataPin, PIO_SERCOM);
-    pinPeripheral(_clockPin, PIO_SERCOM);
+void TwiPinPair::apply() const {
+    applyAll(this, 1);
+}
+
+void TwiPinPair::setPinPeripheralStates() const {
+    MuxMasks masks = {};
+    addPin(masks, _dataPin, TWI_MUX_SERCOM);
+    addPin(masks, _clockPin, TWI_MUX_SERCOM);
+    writeMasks(masks);
 }
 
-void TwiPinPair::setPinPeripheralAltStates() {
-    pinPeripheral(_dataPin, PIO_SERCOM_ALT);
-    pinPeripheral(_clockPin, PIO_SERCOM_ALT);
-}
\ No newline at end of file
+void TwiPinPair::setPinPeripheralAltStates() const {
+    MuxMasks masks = {};
+    addPin(masks, _dataPin, TWI_MUX_SERCOM_ALT);
+    addPin(masks, _clockPin, TWI_MUX_SERCOM_ALT);
+    writeMasks(masks);
+}
+
+void TwiPinPair::setStrongDrive(bool strong) const {
+    const uint32_t pins[] = { _dataPin, _clockPin };
+    for (uint32_t ulPin : pins) {
+        const PinDescription& desc = g_APinDescription[ulPin];
+        if (desc.ulPinType == PIO_NOT_A_PIN || desc.ulPort > 1) {
+            continue;
+        }
+        PORT->Group[desc.ulPort].PINCFG[desc.ulPin].bit.DRVSTR = strong ? 1 : 0;
+    }
+}
+
+void TwiPinPair::applyAll(const TwiPinPair* pairs, size_t count) {
+    MuxMasks masks = {};
+    for (size_t i = 0; i < count; i++) {
+        addPin(masks, pairs[i]._dataPin, pairs[i]._mux);
+        addPin(masks, pairs[i]._clockPin, pairs[i]._mux);
+    }
+    writeMasks(masks);
+}
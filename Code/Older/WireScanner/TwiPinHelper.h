@@ -2,22 +2,60 @@
 #define TwiPinHelper_h
 
 #include <Arduino.h>
-#include "wiring_private.h" 
+#include "wiring_private.h"
 
+// PORT PMUX function of the SERCOM pads (C and D)
+enum TwiPinMux : uint8_t {
+    TWI_MUX_SERCOM = 2,      // As PIO_SERCOM
+    TWI_MUX_SERCOM_ALT = 3   // As PIO_SERCOM_ALT
+};
+
+// One I2C bus of the board. Constexpr, so a table of them is the board
+// description in flash:
+//
+//   constexpr TwiPinPair buses[] = {
+//       { W1_SDA, W1_SCL, TWI_MUX_SERCOM_ALT },
+//       { W2_SDA, W2_SCL, TWI_MUX_SERCOM },
+//   };
+//   TwiPinPair::applyAll(buses);
+//
+// Muxing goes through PORT WRCONFIG: one register write for all pins of
+// a port half with the same function, instead of pinPeripheral() per pin.
+// WRCONFIG also clears the pull-up of those pins (the bus pull-ups are
+// external) and leaves the input buffer on, so the line levels can still
+// be read while the SERCOM drives them.
 class TwiPinPair {
 public:
-    TwiPinPair(uint32_t dataPin, uint32_t clockPin);
+    constexpr TwiPinPair(uint32_t dataPin, uint32_t clockPin, TwiPinMux mux = TWI_MUX_SERCOM)
+        : _dataPin(dataPin), _clockPin(clockPin), _mux(mux) {}
+
+    // "PA12"; "NA" when the Arduino pin has no port pin. Static strings,
+    // no heap
+    const char* getPortPinSDA() const;
+    const char* getPortPinSCL() const;
+    static const char* getPortPin(uint32_t ulPin);
+
+    uint32_t getDataPin() const { return _dataPin; }
+    uint32_t getClockPin() const { return _clockPin; }
+
+    // Mux as given in the constructor
+    void apply() const;
+    void setPinPeripheralStates() const;
+    void setPinPeripheralAltStates() const;
 
-    String getPortPinSDA();
-    String getPortPinSCL();
+    // Strong drive (PINCFG DRVSTR) on both pins, for the 20 mA of Fm+.
+    // apply() clears it again: call after muxing
+    void setStrongDrive(bool strong) const;
 
-    void setPinPeripheralStates();
-    void setPinPeripheralAltStates();
+    // Mux a whole table at boot, at most one write per port half and function
+    static void applyAll(const TwiPinPair* pairs, size_t count);
+    template <size_t N>
+    static void applyAll(const TwiPinPair (&pairs)[N]) { applyAll(pairs, N); }
 
 private:
     uint32_t _dataPin;
     uint32_t _clockPin;
-    String getPortPin(uint32_t ulPin); 
+    TwiPinMux _mux;
 };
 
-#endif
\ No newline at end of file
+#endif
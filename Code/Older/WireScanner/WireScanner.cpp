@@ -1,16 +1,45 @@
 #include <utility>
 #include "WireScanner.h"
 
+// Sorted by address: getDeviceName() does a binary search
 const std::pair<int, const char*> deviceNames[] = {
     {0x25, "Sensirion SDP8xx-500Pa"},
     {0x26, "Sensirion SDP8xx-501Pa"},
     {0x29, "DLC-L01G-U2 or VL6180"},
+    {0x2A, "VitalSignsBox ECG module"},
+    {0x2B, "VitalSignsBox SpO2 module"},
     {0x40, "Sensirion SDP610-500Pa"},
     {0x50, "FRAM/EEPROM"},
     {0x51, "More memory? Could be 1M FRAM"},
+    {0x68, "MCP3426 ADC"},
     {0x7C, "RESERVED"}
 };
 
+const size_t deviceNameCount = sizeof(deviceNames) / sizeof(deviceNames[0]);
+
+void WireScanResult::clear() {
+    for (uint32_t& word : bits) word = 0;
+}
+
+void WireScanResult::set(uint8_t address) {
+    bits[(address >> 5) & 0x03] |= (1UL << (address & 0x1F));
+}
+
+bool WireScanResult::isPresent(uint8_t address) const {
+    return (bits[(address >> 5) & 0x03] >> (address & 0x1F)) & 1UL;
+}
+
+uint8_t WireScanResult::count() const {
+    uint8_t total = 0;
+    for (uint32_t word : bits) {
+        while (word) {
+            word &= word - 1;  // Clear lowest set bit
+            total++;
+        }
+    }
+    return total;
+}
+
 WireScanner::WireScanner(TwoWire *wire, const char* label) : _wire(wire), _label(label) {}
 
 
@@ -39,17 +68,65 @@ bool WireScanner::reportDevicesWithAddress(byte deviceAddress) {
 }
 
 void WireScanner::printDeviceName(int address) {
-    for (const auto& pair : deviceNames) {
-        if (pair.first == address) {
-            Serial.println(pair.second);
-            return; // Found, exit early
-        }
+    const char* name = getDeviceName(address);
+    if (name) {
+        Serial.println(name);
+        return;
     }
     // Handle unrecognized addresses if needed
     Serial.print("Unknown Device found");
     Serial.println(address, HEX);
 }
 
+const char* WireScanner::getDeviceName(uint8_t address) {
+    size_t low = 0;
+    size_t high = deviceNameCount;
+    while (low < high) {
+        const size_t mid = (low + high) / 2;
+        if (deviceNames[mid].first < address) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    if (low < deviceNameCount && deviceNames[low].first == address) {
+        return deviceNames[low].second;
+    }
+    return nullptr;
+}
+
+void WireScanner::beginFastScan(uint32_t fastClock) {
+    _wire->setClock(fastClock);
+#if defined(WIRE_HAS_TIMEOUT)
+    _wire->setWireTimeout(WIRE_SCAN_TIMEOUT_US, true);
+#endif
+}
+
+void WireScanner::endFastScan(uint32_t normalClock) {
+#if defined(WIRE_HAS_TIMEOUT)
+    _wire->setWireTimeout();  // Core default
+#endif
+    _wire->setClock(normalClock);
+}
+
+void WireScanner::scanFast(WireScanResult& result, uint32_t fastClock, uint32_t normalClock) {
+    result.clear();
+    beginFastScan(fastClock);
+    for (byte address = 1; address < 127; address++) {
+        if (scanForDevice(address)) result.set(address);
+    }
+    endFastScan(normalClock);
+}
+
+void WireScanner::scanKnown(WireScanResult& result, uint32_t fastClock, uint32_t normalClock) {
+    result.clear();
+    beginFastScan(fastClock);
+    for (const auto& pair : deviceNames) {
+        if (scanForDevice(pair.first)) result.set(pair.first);
+    }
+    endFastScan(normalClock);
+}
+
 // Default implementation of scanForDevice
 bool WireScanner::scanForDevice(byte address) {
     return reportDevicesWithAddress(address);
@@ -5,6 +5,20 @@
 #include <Wire.h>
 #include "TwiPinHelper.h"
 
+#define WIRE_SCAN_NORMAL_CLOCK 100000  // Bus clock restored after a fast scan
+#define WIRE_SCAN_FAST_CLOCK 400000    // Bus clock during a fast scan
+#define WIRE_SCAN_TIMEOUT_US 1000      // Per-probe timeout, where the core supports it
+
+// Presence bitmap: bit n set = device answered at address n
+struct WireScanResult {
+    uint32_t bits[4];
+
+    void clear();
+    void set(uint8_t address);
+    bool isPresent(uint8_t address) const;
+    uint8_t count() const;
+};
+
 class WireScanner {
 public:
     WireScanner(TwoWire *wire, const char* label);
@@ -12,6 +26,18 @@ public:
     void scan();
     void printDeviceName(int address);
 
+    // Silent scan of all addresses at fastClock with a short timeout, then
+    // back to normalClock. Results only in the bitmap.
+    void scanFast(WireScanResult& result, uint32_t fastClock = WIRE_SCAN_FAST_CLOCK,
+                  uint32_t normalClock = WIRE_SCAN_NORMAL_CLOCK);
+
+    // As scanFast(), but only probes the addresses in the device table
+    void scanKnown(WireScanResult& result, uint32_t fastClock = WIRE_SCAN_FAST_CLOCK,
+                   uint32_t normalClock = WIRE_SCAN_NORMAL_CLOCK);
+
+    // Name from the device table, or nullptr if unknown
+    static const char* getDeviceName(uint8_t address);
+
     // New virtual function to allow overriding the scanning behavior
     virtual bool scanForDevice(byte address);
 
@@ -19,6 +45,8 @@ private:
     TwoWire *_wire;
     const char* _label;
     bool reportDevicesWithAddress(byte deviceAddress);
+    void beginFastScan(uint32_t fastClock);
+    void endFastScan(uint32_t normalClock);
 };
 
 #endif
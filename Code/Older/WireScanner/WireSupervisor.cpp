@@ -0,0 +1,291 @@
+#include "WireSupervisor.h"
+
+#define RECOVERY_HALF_PERIOD_US 5   // 100 kHz while clocking out a slave
+#define MAX_BACKOFF_LEVEL 7         // BACKOFF_MS << 7 is past BACKOFF_MAX_MS
+
+void WireSupervisor::Backoff::reset() {
+    failures = 0;
+    level = 0;
+    retryAt = 0;
+}
+
+bool WireSupervisor::Backoff::ready(uint32_t now) const {
+    return failures < WIRE_SUPERVISOR_FAILURE_LIMIT || (int32_t)(now - retryAt) >= 0;
+}
+
+void WireSupervisor::Backoff::fail(uint32_t now) {
+    if (failures < 255) failures++;
+    if (failures < WIRE_SUPERVISOR_FAILURE_LIMIT) return;
+
+    // One retry per backoff period; every failed retry doubles the period
+    uint32_t delayMs = (uint32_t)WIRE_SUPERVISOR_BACKOFF_MS << level;
+    if (delayMs > WIRE_SUPERVISOR_BACKOFF_MAX_MS) delayMs = WIRE_SUPERVISOR_BACKOFF_MAX_MS;
+    retryAt = now + delayMs;
+    if (level < MAX_BACKOFF_LEVEL) level++;
+}
+
+WireSupervisor::WireSupervisor(TwoWire* wire, const TwiPinPair& pins, uint32_t clock)
+    : _wire(wire), _pins(pins), _clock(clock), _segmentClock(0), _activeClock(0),
+      _clockSwitches(0), _clockMode(WIRE_CLOCK_SEGMENT), _started(false),
+#if WIRE_SUPERVISOR_SAMD
+      _fastModePlus(nullptr),
+#endif
+      _timeoutUs(WIRE_SUPERVISOR_TIMEOUT_US), _startMicros(0), _deviceCount(0), _recoveries(0) {
+    _segmentClock = limit(_clock);
+    _activeClock = _segmentClock;
+    _bus.reset();
+}
+
+void WireSupervisor::begin() {
+    _started = true;
+    startSercom();
+    if (!isBusIdle()) recover();
+}
+
+int8_t WireSupervisor::addDevice(uint8_t address, uint32_t maxClock) {
+    if (_deviceCount >= WIRE_SUPERVISOR_MAX_DEVICES) return -1;
+
+    Device& device = _devices[_deviceCount++];
+    device.address = address;
+    device.errors = 0;
+    device.maxClock = maxClock;
+    device.backoff.reset();
+
+    updateSegmentClock();
+    return _deviceCount - 1;
+}
+
+void WireSupervisor::setClockMode(WireClockMode mode) {
+    _clockMode = mode;
+    if (mode == WIRE_CLOCK_SEGMENT) applyClock(_segmentClock);
+}
+
+#if WIRE_SUPERVISOR_SAMD
+void WireSupervisor::enableFastModePlus(Sercom* hw) {
+    _fastModePlus = hw;
+    updateSegmentClock();
+}
+#endif
+
+bool WireSupervisor::isAvailable(uint8_t device) const {
+    if (device >= _deviceCount) return false;
+    const uint32_t now = millis();
+    return _devices[device].backoff.ready(now) && (isBusIdle() || _bus.ready(now));
+}
+
+WireResult WireSupervisor::write(uint8_t device, const uint8_t* data, size_t length) {
+    if (!beginTransaction(device)) return WIRE_SKIPPED;
+
+    _wire->beginTransmission(_devices[device].address);
+    _wire->write(data, length);
+    return endTransaction(device, _wire->endTransmission());
+}
+
+WireResult WireSupervisor::read(uint8_t device, uint8_t* data, size_t length) {
+    if (!beginTransaction(device)) return WIRE_SKIPPED;
+
+    const size_t received = _wire->requestFrom(_devices[device].address, (uint8_t)length);
+    for (size_t i = 0; i < received && i < length; i++) {
+        data[i] = _wire->read();
+    }
+    return endTransaction(device, received == length ? 0 : 2);
+}
+
+WireResult WireSupervisor::writeRead(uint8_t device, const uint8_t* command, size_t commandLength,
+                                     uint8_t* data, size_t length) {
+    if (!beginTransaction(device)) return WIRE_SKIPPED;
+
+    _wire->beginTransmission(_devices[device].address);
+    _wire->write(command, commandLength);
+    uint8_t status = _wire->endTransmission(false);  // Repeated start
+    if (status == 0) {
+        const size_t received = _wire->requestFrom(_devices[device].address, (uint8_t)length);
+        for (size_t i = 0; i < received && i < length; i++) {
+            data[i] = _wire->read();
+        }
+        if (received != length) status = 2;
+    }
+    return endTransaction(device, status);
+}
+
+bool WireSupervisor::beginTransaction(uint8_t device) {
+    if (device >= _deviceCount) return false;
+    if (!_devices[device].backoff.ready(millis())) return false;
+    if (!ensureBus()) return false;
+
+    if (_clockMode == WIRE_CLOCK_PER_DEVICE) applyClock(limit(_devices[device].maxClock));
+
+    _startMicros = micros();
+    return true;
+}
+
+WireResult WireSupervisor::endTransaction(uint8_t device, uint8_t wireStatus) {
+#if defined(WIRE_HAS_TIMEOUT)
+    if (_wire->getWireTimeoutFlag()) {
+        _wire->clearWireTimeoutFlag();
+        wireStatus = 5;
+    }
+#endif
+    WireResult result;
+    switch (wireStatus) {
+        case 0: result = WIRE_OK; break;
+        case 4: result = WIRE_BUS_ERROR; break;
+        case 5: result = WIRE_TIMEOUT; break;
+        default: result = WIRE_NACK; break;  // 1 too long, 2/3 NACK
+    }
+
+    if (result == WIRE_OK) {
+        if (micros() - _startMicros > _timeoutUs) result = WIRE_TIMEOUT;  // Stretched too long
+    } else if (result == WIRE_NACK && !isBusIdle()) {
+        result = WIRE_BUS_ERROR;  // SAMD reports a lost arbitration as a NACK
+    }
+
+    if (device < _deviceCount) {
+        Device& entry = _devices[device];
+        if (result == WIRE_OK) {
+            entry.backoff.reset();
+        } else {
+            entry.errors++;
+            entry.backoff.fail(millis());
+        }
+    }
+
+    // The SERCOM can be left waiting for a bus state that never comes
+    if (result == WIRE_BUS_ERROR || wireStatus == 5) recover();
+    return result;
+}
+
+bool WireSupervisor::recover() {
+    _recoveries++;
+    _wire->end();
+
+    const uint32_t sda = _pins.getDataPin();
+    const uint32_t scl = _pins.getClockPin();
+
+    // Open drain by hand: output latch low, the direction pulls the line
+    // low (OUTPUT) or releases it to the pull-up (INPUT)
+    pinMode(sda, INPUT);
+    pinMode(scl, INPUT);
+    digitalWrite(sda, LOW);
+    digitalWrite(scl, LOW);
+
+    // A slave holding SDA is in the middle of a byte: clock until it lets go
+    for (uint8_t i = 0; i < WIRE_SUPERVISOR_CLOCK_PULSES && digitalRead(sda) == LOW; i++) {
+        pinMode(scl, OUTPUT);
+        delayMicroseconds(RECOVERY_HALF_PERIOD_US);
+        pinMode(scl, INPUT);
+        delayMicroseconds(RECOVERY_HALF_PERIOD_US);
+    }
+
+    // STOP: SDA rises while SCL is high
+    pinMode(scl, OUTPUT);
+    pinMode(sda, OUTPUT);
+    delayMicroseconds(RECOVERY_HALF_PERIOD_US);
+    pinMode(scl, INPUT);
+    delayMicroseconds(RECOVERY_HALF_PERIOD_US);
+    pinMode(sda, INPUT);
+    delayMicroseconds(RECOVERY_HALF_PERIOD_US);
+
+    const bool idle = isBusIdle();
+
+    // Fresh SERCOM: also resets its bus state to idle
+    startSercom();
+    return idle;
+}
+
+bool WireSupervisor::ensureBus() {
+    if (isBusIdle()) {
+        _bus.reset();
+        return true;
+    }
+    const uint32_t now = millis();
+    if (!_bus.ready(now)) return false;  // Shorted or unpowered: do not retry every call
+
+    if (recover()) {
+        _bus.reset();
+        return true;
+    }
+    _bus.fail(now);
+    return false;
+}
+
+void WireSupervisor::setTimeout(uint32_t timeoutUs) {
+    _timeoutUs = timeoutUs;
+#if defined(WIRE_HAS_TIMEOUT)
+    _wire->setWireTimeout(_timeoutUs, true);
+#endif
+}
+
+bool WireSupervisor::isBusIdle() const {
+    return digitalRead(_pins.getDataPin()) == HIGH && digitalRead(_pins.getClockPin()) == HIGH;
+}
+
+uint32_t WireSupervisor::getErrorCount(uint8_t device) const {
+    return device < _deviceCount ? _devices[device].errors : 0;
+}
+
+uint32_t WireSupervisor::getRecoveryCount() const {
+    return _recoveries;
+}
+
+uint32_t WireSupervisor::getDeviceClock(uint8_t device) const {
+    return device < _deviceCount ? limit(_devices[device].maxClock) : 0;
+}
+
+// Bus maximum, and Fm on a SAMD21 without the Fm+ setup
+uint32_t WireSupervisor::limit(uint32_t clock) const {
+    if (clock > _clock) clock = _clock;
+#if WIRE_SUPERVISOR_SAMD
+    if (_fastModePlus == nullptr && clock > WIRE_CLOCK_FAST) clock = WIRE_CLOCK_FAST;
+#endif
+    return clock;
+}
+
+// Slowest device, or the bus maximum while there are none
+void WireSupervisor::updateSegmentClock() {
+    _segmentClock = limit(_clock);
+    for (uint8_t i = 0; i < _deviceCount; i++) {
+        const uint32_t clock = limit(_devices[i].maxClock);
+        if (clock < _segmentClock) _segmentClock = clock;
+    }
+    if (_clockMode == WIRE_CLOCK_SEGMENT) applyClock(_segmentClock);
+}
+
+void WireSupervisor::applyClock(uint32_t clock) {
+    if (clock == _activeClock) return;
+    _activeClock = clock;
+    if (!_started) return;  // begin() sets it
+    _clockSwitches++;
+    setBusClock();
+}
+
+// begin() muxes the variant's function, not the pair's: mux again
+void WireSupervisor::startSercom() {
+    _wire->begin();
+#if defined(WIRE_HAS_TIMEOUT)
+    _wire->setWireTimeout(_timeoutUs, true);
+#endif
+    _pins.apply();
+    setBusClock();
+}
+
+void WireSupervisor::setBusClock() {
+    _wire->setClock(_activeClock);
+
+#if WIRE_SUPERVISOR_SAMD
+    if (_fastModePlus == nullptr) return;
+
+    // setClock() left CTRLA at Sm/Fm timing; SPEED is enable-protected
+    SercomI2cm& i2c = _fastModePlus->I2CM;
+    const bool fastPlus = _activeClock > WIRE_CLOCK_FAST;
+    i2c.CTRLA.bit.ENABLE = 0;
+    while (i2c.SYNCBUSY.bit.ENABLE);
+    i2c.CTRLA.bit.SPEED = fastPlus ? 1 : 0;
+    i2c.CTRLA.bit.ENABLE = 1;
+    while (i2c.SYNCBUSY.bit.ENABLE);
+    i2c.STATUS.bit.BUSSTATE = WIRE_BUS_STATE_IDLE;
+    while (i2c.SYNCBUSY.bit.SYSOP);
+
+    _pins.setStrongDrive(fastPlus);
+#endif
+}
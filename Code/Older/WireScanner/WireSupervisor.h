@@ -0,0 +1,158 @@
+#ifndef WireSupervisor_h
+#define WireSupervisor_h
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "TwiPinHelper.h"
+
+#define WIRE_SUPERVISOR_MAX_DEVICES 8
+#define WIRE_SUPERVISOR_TIMEOUT_US 25000      // Budget per transaction
+#define WIRE_SUPERVISOR_FAILURE_LIMIT 3       // Failures in a row before a device backs off
+#define WIRE_SUPERVISOR_BACKOFF_MS 100        // First backoff, doubles per failure
+#define WIRE_SUPERVISOR_BACKOFF_MAX_MS 10000
+#define WIRE_SUPERVISOR_CLOCK_PULSES 9        // Enough for a slave stuck in any bit of a byte
+
+#define WIRE_CLOCK_STANDARD 100000UL           // Sm
+#define WIRE_CLOCK_FAST 400000UL               // Fm
+#define WIRE_CLOCK_FAST_PLUS 1000000UL         // Fm+
+
+#if defined(__SAMD21G18A__) || defined(__SAMD21J18A__) || defined(__SAMD21E18A__)
+#define WIRE_SUPERVISOR_SAMD 1
+#else
+#define WIRE_SUPERVISOR_SAMD 0
+#endif
+
+// Outcome of one transaction
+enum WireResult : uint8_t {
+    WIRE_OK = 0,
+    WIRE_NACK,        // Device did not answer: only that device backs off
+    WIRE_BUS_ERROR,   // Arbitration lost or bus error: the bus is recovered
+    WIRE_TIMEOUT,     // Over the time budget
+    WIRE_SKIPPED      // Not started: device backing off, or bus stuck
+};
+
+// How the bus clock follows the devices' maximum clocks
+enum WireClockMode : uint8_t {
+    WIRE_CLOCK_SEGMENT,     // Always the fastest clock every device tolerates
+    WIRE_CLOCK_PER_DEVICE   // Switched per transaction to the device's own maximum
+};
+
+// Supervises one I2C bus. Transactions go through it (or are reported to
+// it by drivers that talk to TwoWire themselves), so that:
+//
+// - a stuck bus is found before a transaction starts, because TwoWire on
+//   SAMD waits without a timeout; SDA held low is cleared by clocking
+//   SCL up to 9 times and sending a STOP, then the SERCOM is restarted
+//   and the pins are muxed again through the TwiPinPair
+// - every transaction has a time budget; cores with WIRE_HAS_TIMEOUT
+//   abort it, elsewhere a transaction over budget counts as a failure
+// - every device has an error counter; after a few failures in a row it
+//   backs off exponentially, so a bad sensor is asked less and less
+//   often instead of costing every loop() a timeout
+//
+// The pair must be constructed with SDA first.
+class WireSupervisor {
+public:
+    // clock: the fastest the bus itself allows (pull-ups, capacitance);
+    // no device is clocked faster
+    WireSupervisor(TwoWire* wire, const TwiPinPair& pins, uint32_t clock = WIRE_CLOCK_STANDARD);
+
+    // Instead of wire->begin(): starts the SERCOM, muxes the pins and
+    // clears the bus if a slave holds it
+    void begin();
+
+    // Returns the device handle, or -1 when full. maxClock from the
+    // device's datasheet; a device added without one is clocked at 100 kHz
+    int8_t addDevice(uint8_t address, uint32_t maxClock = WIRE_CLOCK_STANDARD);
+
+    // Segment (default) sets the clock once per device added. Per device
+    // restarts the SERCOM (a few microseconds) whenever the next device
+    // has another maximum, worth it for one slow device among fast ones
+    void setClockMode(WireClockMode mode);
+
+#if WIRE_SUPERVISOR_SAMD
+    // Fm+ above 400 kHz: TwoWire::setClock() only sets the baud rate, the
+    // SERCOM also needs its Fm+ timing and the pins their strong drive.
+    // Without this call clocks are capped at 400 kHz. hw: the SERCOM of
+    // the bus, e.g. SERCOM1
+    void enableFastModePlus(Sercom* hw);
+#endif
+
+    // False while the device backs off or the bus is stuck
+    bool isAvailable(uint8_t device) const;
+
+    // Complete transactions
+    WireResult write(uint8_t device, const uint8_t* data, size_t length);
+    WireResult read(uint8_t device, uint8_t* data, size_t length);
+    WireResult writeRead(uint8_t device, const uint8_t* command, size_t commandLength,
+                         uint8_t* data, size_t length);
+
+    // For drivers that use TwoWire directly: beginTransaction() returns
+    // false when the transaction must be skipped; endTransaction() takes
+    // the endTransmission() status (0 ok, 2/3 NACK, 4 bus error, 5 timeout)
+    bool beginTransaction(uint8_t device);
+    WireResult endTransaction(uint8_t device, uint8_t wireStatus);
+
+    // Clock out a stuck slave and restart the SERCOM; true if the bus is idle
+    bool recover();
+
+    void setTimeout(uint32_t timeoutUs);
+    bool isBusIdle() const;   // SDA and SCL both high
+
+    uint32_t getErrorCount(uint8_t device) const;
+    uint32_t getRecoveryCount() const;
+
+    uint32_t getClock() const { return _activeClock; }            // Now on the bus
+    uint32_t getDeviceClock(uint8_t device) const;                 // Bus limit included
+    uint32_t getSegmentClock() const { return _segmentClock; }     // Slowest device
+    uint32_t getClockSwitches() const { return _clockSwitches; }
+    TwoWire* getWire() const { return _wire; }
+
+private:
+    // Exponential backoff, shared by the devices and the bus itself
+    struct Backoff {
+        uint8_t failures;   // In a row
+        uint8_t level;      // Backoff doubles per level
+        uint32_t retryAt;   // millis()
+
+        void reset();
+        bool ready(uint32_t now) const;
+        void fail(uint32_t now);
+    };
+
+    struct Device {
+        uint8_t address;
+        uint32_t errors;
+        uint32_t maxClock;
+        Backoff backoff;
+    };
+
+    WireResult finish(uint8_t device, WireResult result);
+    bool ensureBus();
+    uint32_t limit(uint32_t clock) const;
+    void updateSegmentClock();
+    void applyClock(uint32_t clock);
+    void startSercom();
+    void setBusClock();
+
+    TwoWire* _wire;
+    TwiPinPair _pins;
+    uint32_t _clock;          // Bus maximum
+    uint32_t _segmentClock;
+    uint32_t _activeClock;
+    uint32_t _clockSwitches;
+    WireClockMode _clockMode;
+    bool _started;            // begin() called: clock changes go to the SERCOM
+#if WIRE_SUPERVISOR_SAMD
+    Sercom* _fastModePlus;    // nullptr: capped at 400 kHz
+#endif
+    uint32_t _timeoutUs;
+    uint32_t _startMicros;
+
+    Device _devices[WIRE_SUPERVISOR_MAX_DEVICES];
+    uint8_t _deviceCount;
+    Backoff _bus;
+    uint32_t _recoveries;
+};
+
+#endif
@@ -0,0 +1,99 @@
+#include "WireWatcher.h"
+
+#define FIRST_ADDRESS 1
+#define END_ADDRESS 127  // Same range as WireScanner::scan()
+
+WireWatcher::WireWatcher(uint32_t rescanIntervalMs)
+    : _busCount(0), _callback(nullptr), _intervalMs(rescanIntervalMs),
+      _probesPerStep(WIRE_WATCH_DEFAULT_PROBES), _scanning(false), _passStart(0), _passCount(0) {}
+
+int8_t WireWatcher::addBus(WireScanner* scanner) {
+    if (scanner == nullptr || _busCount >= WIRE_WATCH_MAX_BUSES) return -1;
+
+    BusState& bus = _buses[_busCount];
+    bus.scanner = scanner;
+    bus.present.clear();
+    bus.working.clear();
+    bus.next = END_ADDRESS;  // Idle until the next pass starts
+    bus.enumerated = false;
+    return _busCount++;
+}
+
+void WireWatcher::onChange(WireWatchCallback callback) {
+    _callback = callback;
+}
+
+void WireWatcher::setRescanInterval(uint32_t intervalMs) {
+    _intervalMs = intervalMs;
+}
+
+void WireWatcher::setProbesPerStep(uint8_t probes) {
+    _probesPerStep = probes ? probes : 1;
+}
+
+void WireWatcher::update() {
+    if (_busCount == 0) return;
+
+    if (!_scanning) {
+        const uint32_t now = millis();
+        if (_passCount > 0 && now - _passStart < _intervalMs) return;
+
+        // Start a pass on all buses at once
+        _passStart = now;
+        _scanning = true;
+        for (uint8_t i = 0; i < _busCount; i++) {
+            _buses[i].working.clear();
+            _buses[i].next = FIRST_ADDRESS;
+        }
+    }
+
+    // Interleave: a few probes on every bus, then return to the caller
+    bool busy = false;
+    for (uint8_t i = 0; i < _busCount; i++) {
+        BusState& bus = _buses[i];
+        if (bus.next >= END_ADDRESS) continue;
+
+        for (uint8_t n = 0; n < _probesPerStep && bus.next < END_ADDRESS; n++, bus.next++) {
+            if (bus.scanner->scanForDevice(bus.next)) bus.working.set(bus.next);
+        }
+        if (bus.next >= END_ADDRESS) {
+            finishPass(i);
+        } else {
+            busy = true;
+        }
+    }
+
+    if (!busy) {
+        _scanning = false;
+        _passCount++;
+    }
+}
+
+// Report the differences with the previous pass
+void WireWatcher::finishPass(uint8_t index) {
+    BusState& bus = _buses[index];
+
+    for (uint8_t word = 0; word < 4; word++) {
+        uint32_t changed = bus.present.bits[word] ^ bus.working.bits[word];
+        while (changed && _callback) {
+            const uint8_t bit = __builtin_ctz(changed);
+            changed &= changed - 1;
+            const uint8_t address = word * 32 + bit;
+            _callback(index, address, bus.working.isPresent(address));
+        }
+    }
+    bus.present = bus.working;
+    bus.enumerated = true;
+}
+
+const WireScanResult& WireWatcher::getPresent(uint8_t bus) const {
+    return _buses[bus < _busCount ? bus : 0].present;
+}
+
+bool WireWatcher::isEnumerated(uint8_t bus) const {
+    return bus < _busCount && _buses[bus].enumerated;
+}
+
+uint32_t WireWatcher::getPassCount() const {
+    return _passCount;
+}
@@ -0,0 +1,63 @@
+#ifndef WireWatcher_h
+#define WireWatcher_h
+
+#include <Arduino.h>
+#include "WireScanner.h"
+
+#define WIRE_WATCH_MAX_BUSES 4
+#define WIRE_WATCH_DEFAULT_INTERVAL 1000  // ms between the start of two passes
+#define WIRE_WATCH_DEFAULT_PROBES 2        // Addresses per bus per update()
+
+// Called when a device appears (attached = true) or disappears on a bus
+typedef void (*WireWatchCallback)(uint8_t bus, uint8_t address, bool attached);
+
+// Background enumeration of several buses. Every update() probes only a few
+// addresses per bus, interleaved over all buses, so a full pass is spread
+// over many loop() calls instead of stalling one of them. After each pass
+// the presence bitmap of a bus is compared with the previous pass and the
+// callback fires once per change. The first pass reports every device
+// found as attached.
+class WireWatcher {
+public:
+    WireWatcher(uint32_t rescanIntervalMs = WIRE_WATCH_DEFAULT_INTERVAL);
+
+    // Returns the bus index, or -1 when full
+    int8_t addBus(WireScanner* scanner);
+
+    void onChange(WireWatchCallback callback);
+    void setRescanInterval(uint32_t intervalMs);
+    void setProbesPerStep(uint8_t probes);
+
+    // Call every loop(); probes at most probesPerStep addresses per bus
+    void update();
+
+    // Devices seen in the last complete pass
+    const WireScanResult& getPresent(uint8_t bus) const;
+
+    // True once the bus has completed its first pass
+    bool isEnumerated(uint8_t bus) const;
+
+    uint32_t getPassCount() const;
+
+private:
+    struct BusState {
+        WireScanner* scanner;
+        WireScanResult present;  // Last complete pass
+        WireScanResult working;  // Pass in progress
+        uint8_t next;            // Next address to probe
+        bool enumerated;
+    };
+
+    void finishPass(uint8_t bus);
+
+    BusState _buses[WIRE_WATCH_MAX_BUSES];
+    uint8_t _busCount;
+    WireWatchCallback _callback;
+    uint32_t _intervalMs;
+    uint8_t _probesPerStep;
+    bool _scanning;
+    uint32_t _passStart;
+    uint32_t _passCount;
+};
+
+#endif
@@ -0,0 +1,58 @@
+#include "WireScanner.h"
+#include "WireWatcher.h"
+#include "TwiPinHelper.h"
+
+// Sensor buses
+#define W1_SCL 39  // PA13
+#define W1_SDA 28  // PA12
+
+#define W2_SCL 13  // PA17
+#define W2_SDA 11  // PA16
+
+TwiPinPair portSensorsA(W1_SCL, W1_SDA);
+TwiPinPair portSensorsB(W2_SCL, W2_SDA);
+
+#define ledHb 14
+
+TwoWire WireSensorA(&sercom1, W1_SDA, W1_SCL);  // Sensor A
+TwoWire WireSensorB(&sercom4, W2_SDA, W2_SCL);  // Sensor B
+
+WireScanner scannerSensorA(&WireSensorA, "Sensors A");
+WireScanner scannerSensorB(&WireSensorB, "Sensors B");
+
+// Re-scan both buses every 2 s in the background
+WireWatcher watcher(2000);
+
+void onDeviceChange(uint8_t bus, uint8_t address, bool attached) {
+  Serial.print(bus == 0 ? "Sensors A" : "Sensors B");
+  Serial.print(attached ? ": attached 0x" : ": detached 0x");
+  Serial.print(address, HEX);
+  const char* name = WireScanner::getDeviceName(address);
+  if (name) {
+    Serial.print(" ");
+    Serial.print(name);
+  }
+  Serial.println();
+}
+
+void setup() {
+  Serial.begin(115200);
+
+  WireSensorA.begin();
+  WireSensorB.begin();
+  portSensorsA.setPinPeripheralAltStates();
+  portSensorsB.setPinPeripheralStates();
+
+  pinMode(ledHb, OUTPUT);
+
+  watcher.addBus(&scannerSensorA);
+  watcher.addBus(&scannerSensorB);
+  watcher.onChange(onDeviceChange);
+}
+
+void loop() {
+  watcher.update();  // A few probes per bus, then back to the application
+
+  // Acquisition keeps running here
+  digitalWrite(ledHb, (millis() / 500) & 1);
+}
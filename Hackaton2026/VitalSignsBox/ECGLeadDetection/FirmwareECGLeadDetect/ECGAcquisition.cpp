@@ -0,0 +1,327 @@
+/*
+    ECGAcquisition.cpp
+
+    Timer-triggered ECG acquisition implementation
+*/
+
+#include "ECGAcquisition.h"
+
+#if defined(__SAMD21G18A__) || defined(__SAMD21J18A__) || defined(__SAMD21E18A__)
+#define ECG_ACQ_DMA 1
+#include "wiring_private.h"
+#else
+#define ECG_ACQ_DMA 0
+#endif
+
+// Same pins as ECGSensing.h: A1 = LL (red), A2 = LA (black), A3 = RA (white)
+#define ACQ_PIN_LL A1
+#define ACQ_PIN_LA A2
+#define ACQ_PIN_RA A3
+
+// Critical section that is also safe inside an ISR (restores the old state)
+#if defined(__arm__)
+#define ACQ_LOCK() uint32_t acqPrimask = __get_PRIMASK(); __disable_irq()
+#define ACQ_UNLOCK() __set_PRIMASK(acqPrimask)
+#else
+#define ACQ_LOCK() uint8_t acqSreg = SREG; noInterrupts()
+#define ACQ_UNLOCK() SREG = acqSreg
+#endif
+
+static const uint16_t TOTAL_SAMPLES = ECGAcquisition::RING_FRAMES * ECGAcquisition::CHANNELS;
+
+#if ECG_ACQ_DMA
+
+#define ECG_DMA_CHANNEL 0
+#define ECG_EVSYS_CHANNEL 0
+
+// DMAC descriptors must be 128-bit aligned; the write-back copy shows progress
+static DmacDescriptor dmaDescriptor[1] __attribute__((aligned(16)));
+static volatile DmacDescriptor dmaWriteback[1] __attribute__((aligned(16)));
+
+static ECGAcquisition* activeAcquisition = nullptr;
+
+void DMAC_Handler() {
+  DMAC->CHID.reg = ECG_DMA_CHANNEL;
+  if (DMAC->CHINTFLAG.bit.TCMPL) {
+    DMAC->CHINTFLAG.reg = DMAC_CHINTFLAG_TCMPL;
+    if (activeAcquisition) activeAcquisition->onBlockDone();
+  }
+}
+
+static void startDma(volatile uint16_t* buffer) {
+  PM->AHBMASK.reg |= PM_AHBMASK_DMAC;
+  PM->APBBMASK.reg |= PM_APBBMASK_DMAC;
+
+  DMAC->CTRL.reg = 0;
+  DMAC->CTRL.reg = DMAC_CTRL_SWRST;
+  while (DMAC->CTRL.bit.SWRST) {}
+  DMAC->BASEADDR.reg = (uint32_t)dmaDescriptor;
+  DMAC->WRBADDR.reg = (uint32_t)dmaWriteback;
+  DMAC->CTRL.reg = DMAC_CTRL_DMAENABLE | DMAC_CTRL_LVLEN(0xF);
+
+  // One 16-bit beat per ADC result, destination increments, then wraps:
+  // the descriptor links to itself, so the buffer is filled forever
+  dmaDescriptor[0].BTCTRL.reg = DMAC_BTCTRL_VALID | DMAC_BTCTRL_BEATSIZE_HWORD
+                              | DMAC_BTCTRL_DSTINC | DMAC_BTCTRL_BLOCKACT_INT;
+  dmaDescriptor[0].BTCNT.reg = TOTAL_SAMPLES;
+  dmaDescriptor[0].SRCADDR.reg = (uint32_t)&ADC->RESULT.reg;
+  dmaDescriptor[0].DSTADDR.reg = (uint32_t)(buffer + TOTAL_SAMPLES);  // End address when DSTINC
+  dmaDescriptor[0].DESCADDR.reg = (uint32_t)&dmaDescriptor[0];
+
+  DMAC->CHID.reg = ECG_DMA_CHANNEL;
+  DMAC->CHCTRLA.reg = 0;
+  DMAC->CHCTRLA.reg = DMAC_CHCTRLA_SWRST;
+  while (DMAC->CHCTRLA.bit.SWRST) {}
+  DMAC->CHCTRLB.reg = DMAC_CHCTRLB_TRIGSRC(ADC_DMAC_ID_RESRDY) | DMAC_CHCTRLB_TRIGACT_BEAT;
+  DMAC->CHINTENSET.reg = DMAC_CHINTENSET_TCMPL;
+  NVIC_EnableIRQ(DMAC_IRQn);
+  DMAC->CHCTRLA.reg = DMAC_CHCTRLA_ENABLE;
+}
+
+static void startAdcScan() {
+  // The core's init() has clocked and calibrated the ADC
+  ADC->CTRLA.bit.ENABLE = 0;
+  while (ADC->STATUS.bit.SYNCBUSY) {}
+
+  // A1/A2/A3 are PB08/PB09/PA04 = AIN2/AIN3/AIN4: one contiguous scan
+  pinPeripheral(ACQ_PIN_LL, PIO_ANALOG);
+  pinPeripheral(ACQ_PIN_LA, PIO_ANALOG);
+  pinPeripheral(ACQ_PIN_RA, PIO_ANALOG);
+
+  ADC->CTRLB.reg = ADC_CTRLB_PRESCALER_DIV128 | ADC_CTRLB_RESSEL_10BIT;  // ~37 us per conversion
+  ADC->SAMPCTRL.reg = 15;
+  while (ADC->STATUS.bit.SYNCBUSY) {}
+  ADC->INPUTCTRL.reg = ADC_INPUTCTRL_MUXPOS_PIN2 | ADC_INPUTCTRL_MUXNEG_GND
+                     | ADC_INPUTCTRL_INPUTSCAN(ECGAcquisition::CHANNELS - 1)
+                     | ADC_INPUTCTRL_GAIN_DIV2;  // Same range as analogRead() with AR_DEFAULT
+  while (ADC->STATUS.bit.SYNCBUSY) {}
+  ADC->EVCTRL.reg = ADC_EVCTRL_STARTEI;  // Every event converts the next input
+  ADC->CTRLA.bit.ENABLE = 1;
+  while (ADC->STATUS.bit.SYNCBUSY) {}
+}
+
+static uint16_t timerTop(uint16_t sampleRateHz) {
+  return (uint16_t)((F_CPU / 64UL) / (3UL * sampleRateHz) - 1UL);  // 3 conversions per frame
+}
+
+static void startTimer(uint16_t sampleRateHz) {
+  // TC3 overflow -> event channel -> ADC START
+  PM->APBCMASK.reg |= PM_APBCMASK_TC3 | PM_APBCMASK_EVSYS;
+  GCLK->CLKCTRL.reg = GCLK_CLKCTRL_CLKEN | GCLK_CLKCTRL_GEN_GCLK0 | GCLK_CLKCTRL_ID_TCC2_TC3;
+  while (GCLK->STATUS.bit.SYNCBUSY) {}
+
+  EVSYS->USER.reg = EVSYS_USER_CHANNEL(ECG_EVSYS_CHANNEL + 1) | EVSYS_USER_USER(EVSYS_ID_USER_ADC_START);
+  EVSYS->CHANNEL.reg = EVSYS_CHANNEL_CHANNEL(ECG_EVSYS_CHANNEL) | EVSYS_CHANNEL_EVGEN(EVSYS_ID_GEN_TC3_OVF)
+                     | EVSYS_CHANNEL_PATH_ASYNCHRONOUS;
+
+  TC3->COUNT16.CTRLA.reg = TC_CTRLA_SWRST;
+  while (TC3->COUNT16.CTRLA.bit.SWRST) {}
+  TC3->COUNT16.CTRLA.reg = TC_CTRLA_MODE_COUNT16 | TC_CTRLA_WAVEGEN_MFRQ | TC_CTRLA_PRESCALER_DIV64;
+  TC3->COUNT16.CC[0].reg = timerTop(sampleRateHz);
+  TC3->COUNT16.EVCTRL.reg = TC_EVCTRL_OVFEO;
+  while (TC3->COUNT16.STATUS.bit.SYNCBUSY) {}
+  TC3->COUNT16.CTRLA.bit.ENABLE = 1;
+  while (TC3->COUNT16.STATUS.bit.SYNCBUSY) {}
+}
+
+// Running: the ADC and DMA go on, only the trigger period changes
+static void retuneTimer(uint16_t sampleRateHz) {
+  TC3->COUNT16.CC[0].reg = timerTop(sampleRateHz);
+  while (TC3->COUNT16.STATUS.bit.SYNCBUSY) {}
+  TC3->COUNT16.CTRLBSET.reg = TC_CTRLBSET_CMD_RETRIGGER;  // From 0: a count past the new top would run to 0xFFFF
+  while (TC3->COUNT16.STATUS.bit.SYNCBUSY) {}
+}
+
+#endif  // ECG_ACQ_DMA
+
+ECGAcquisition::ECGAcquisition()
+  : _blocks(0), _anchorFrame(0), _anchorMicros(0), _rateFrame(0), _previousAnchorFrame(0),
+    _previousAnchorMicros(0), _previousPeriodMicros(0), _readIndex(0), _overruns(0), _rateHz(0),
+    _decimation(1), _softWrite(0), _periodMicros(0), _lastMicros(0), _useDma(false) {
+  for (uint16_t i = 0; i < TOTAL_SAMPLES; i++) _samples[i] = 0;
+}
+
+void ECGAcquisition::begin(uint16_t sampleRateHz) {
+  _rateHz = sampleRateHz ? sampleRateHz : 250;
+  _periodMicros = 1000000UL / _rateHz;
+  _lastMicros = micros();
+  _anchorFrame = (uint32_t)-1;  // Frame 0 is complete one period after the start
+  _anchorMicros = _lastMicros;
+  _rateFrame = 0;
+  _previousAnchorFrame = _anchorFrame;
+  _previousAnchorMicros = _anchorMicros;
+  _previousPeriodMicros = _periodMicros;
+
+#if ECG_ACQ_DMA
+  activeAcquisition = this;
+  _useDma = true;
+  startAdcScan();
+  startDma(_samples);
+  startTimer(_rateHz);
+#endif
+}
+
+void ECGAcquisition::setSampleRate(uint16_t sampleRateHz) {
+  const uint16_t rate = sampleRateHz < MIN_RATE ? MIN_RATE : sampleRateHz > MAX_RATE ? MAX_RATE : sampleRateHz;
+  if (rate == _rateHz) return;
+
+  // The frame in progress is the first at the new rate, to within one frame
+  const uint32_t frame = getFrameCount();
+  ACQ_LOCK();
+  const uint32_t now = micros();
+  _previousAnchorFrame = _anchorFrame;
+  _previousAnchorMicros = _anchorMicros;
+  _previousPeriodMicros = _periodMicros;
+  _rateFrame = frame;
+  _anchorFrame = frame - 1;
+  _anchorMicros = now;
+  _rateHz = rate;
+  _periodMicros = 1000000UL / rate;
+  _lastMicros = now;
+#if ECG_ACQ_DMA
+  if (_useDma) retuneTimer(rate);
+#endif
+  ACQ_UNLOCK();
+}
+
+void ECGAcquisition::setDecimation(uint8_t decimation) {
+  _decimation = decimation == 0 ? 1 : decimation;
+}
+
+uint8_t ECGAcquisition::getDecimation() const {
+  return _decimation;
+}
+
+void ECGAcquisition::poll() {
+  if (_useDma) return;
+
+  const unsigned long now = micros();
+  if (now - _lastMicros < _periodMicros) return;
+  _lastMicros += _periodMicros;
+
+  const uint16_t base = (_softWrite % TOTAL_SAMPLES);
+  _samples[base] = analogRead(ACQ_PIN_LL);
+  _samples[base + 1] = analogRead(ACQ_PIN_LA);
+  _samples[base + 2] = analogRead(ACQ_PIN_RA);
+
+  ACQ_LOCK();
+  _softWrite += CHANNELS;
+  _anchorFrame = _softWrite / CHANNELS - 1;
+  _anchorMicros = _lastMicros;  // Scheduled time, without the loop() jitter
+  ACQ_UNLOCK();
+}
+
+// The last conversion of the last frame in the ring just landed
+void ECGAcquisition::onBlockDone() {
+  _blocks++;
+  _anchorFrame = _blocks * RING_FRAMES - 1;
+  _anchorMicros = micros();
+}
+
+uint32_t ECGAcquisition::getFrameCount() const {
+  uint32_t written;
+  ACQ_LOCK();
+#if ECG_ACQ_DMA
+  if (_useDma) {
+    uint32_t blocks = _blocks;
+    uint16_t remaining = dmaWriteback[0].BTCNT.reg;
+    DMAC->CHID.reg = ECG_DMA_CHANNEL;
+    if (DMAC->CHINTFLAG.bit.TCMPL && remaining > TOTAL_SAMPLES / 2) {
+      blocks++;  // Wrapped, but the interrupt has not run yet
+    }
+    written = blocks * TOTAL_SAMPLES + (TOTAL_SAMPLES - remaining);
+  } else
+#endif
+  {
+    written = _softWrite;
+  }
+  ACQ_UNLOCK();
+  return written / CHANNELS;  // Complete frames only
+}
+
+uint32_t ECGAcquisition::getFrameMicros(uint32_t index) const {
+  ACQ_LOCK();
+  const bool before = (int32_t)(index - _rateFrame) < 0;
+  const uint32_t anchorFrame = before ? _previousAnchorFrame : _anchorFrame;
+  const uint32_t anchorMicros = before ? _previousAnchorMicros : _anchorMicros;
+  const uint32_t period = before ? _previousPeriodMicros : _periodMicros;
+  ACQ_UNLOCK();
+  return anchorMicros + (int32_t)(index - anchorFrame) * (int32_t)period;
+}
+
+bool ECGAcquisition::latest(ECGFrame& frame) {
+  const uint32_t count = getFrameCount();
+  if (count == 0) return false;
+  frame = frameAt(count - 1);
+  return true;
+}
+
+bool ECGAcquisition::peek(uint32_t index, ECGFrame& frame) const {
+  const uint32_t count = getFrameCount();
+  if (index >= count || count - index > RING_FRAMES - 1) return false;
+  frame = frameAt(index);
+  return true;
+}
+
+uint8_t ECGAcquisition::readFrames(ECGFrame* frames, uint8_t maxFrames, uint32_t& firstIndex) {
+  const uint32_t count = getFrameCount();
+  catchUp(count);
+
+  const uint8_t decimation = _decimation;
+  uint8_t n = 0;
+  firstIndex = _readIndex;
+  if (decimation == 1) {
+    while (n < maxFrames && _readIndex < count) {
+      frames[n++] = frameAt(_readIndex++);
+    }
+    return n;
+  }
+
+  // Only whole groups: the rest waits for the next read
+  while (n < maxFrames && count - _readIndex >= decimation) {
+    uint32_t ll = 0, la = 0, ra = 0;
+    for (uint8_t i = 0; i < decimation; i++) {
+      const ECGFrame frame = frameAt(_readIndex++);
+      ll += frame.ll;
+      la += frame.la;
+      ra += frame.ra;
+    }
+    frames[n].ll = (uint16_t)((ll + decimation / 2) / decimation);
+    frames[n].la = (uint16_t)((la + decimation / 2) / decimation);
+    frames[n].ra = (uint16_t)((ra + decimation / 2) / decimation);
+    n++;
+  }
+  return n;
+}
+
+// Read-only, so loop() can call it while readFrames() runs in the I2C interrupt
+uint16_t ECGAcquisition::getAvailable() const {
+  uint32_t unread = getFrameCount() - _readIndex;
+  if (unread > RING_FRAMES - 1) unread = RING_FRAMES - 1;
+  return (uint16_t)(unread / _decimation);
+}
+
+uint16_t ECGAcquisition::getOverruns() const {
+  return _overruns;
+}
+
+uint16_t ECGAcquisition::getSampleRate() const {
+  return _rateHz;
+}
+
+// Drop frames the acquisition has already overwritten (keep one slot margin)
+void ECGAcquisition::catchUp(uint32_t written) {
+  if (written - _readIndex > RING_FRAMES - 1) {
+    _overruns++;
+    _readIndex = written - (RING_FRAMES - 1);
+  }
+}
+
+ECGFrame ECGAcquisition::frameAt(uint32_t index) const {
+  const uint16_t base = (uint16_t)((index % RING_FRAMES) * CHANNELS);
+  ECGFrame frame;
+  frame.ll = _samples[base];
+  frame.la = _samples[base + 1];
+  frame.ra = _samples[base + 2];
+  return frame;
+}
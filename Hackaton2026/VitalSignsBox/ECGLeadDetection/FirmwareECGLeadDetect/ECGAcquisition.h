@@ -0,0 +1,108 @@
+/*
+    ECGAcquisition.h
+
+    Timer-triggered ECG acquisition into a ring buffer.
+
+    On SAMD21: TC3 fires at 3x the frame rate and starts the ADC through the
+    event system; the ADC scans AIN2..AIN4 (A1 = LL, A2 = LA, A3 = RA) and
+    the DMAC copies every result into a circular buffer. No CPU time per
+    sample, and the rate is exact.
+    Elsewhere: poll() paces analogRead() with micros() into the same ring.
+
+    setSampleRate() retunes the timer while the DMA runs on: the frame
+    numbers continue, getFrameMicros() places the frames before and after
+    the change at their own rate. With setDecimation(n) readFrames() hands
+    out the mean of every n frames, for a master that needs fewer of them.
+*/
+
+#ifndef ECG_ACQUISITION_H
+#define ECG_ACQUISITION_H
+
+#include "Arduino.h"
+
+struct ECGFrame {
+  uint16_t ll;
+  uint16_t la;
+  uint16_t ra;
+};
+
+class ECGAcquisition {
+public:
+  static const uint16_t RING_FRAMES = 128;  // 0.25 s at 500 Hz
+  static const uint8_t CHANNELS = 3;
+  static const uint16_t MIN_RATE = 100;
+  static const uint16_t MAX_RATE = 1000;    // 3 conversions of ~37 us per frame, ring of 0.128 s
+
+  ECGAcquisition();
+
+  // sampleRateHz: frames per second, e.g. 250 or 500
+  void begin(uint16_t sampleRateHz);
+
+  // New frame rate (clamped to MIN_RATE..MAX_RATE) from the next frame on;
+  // loop() only
+  void setSampleRate(uint16_t sampleRateHz);
+
+  // Frames per frame handed out by readFrames() and counted by
+  // getAvailable(), 1..255; the frames peek() sees are not decimated
+  void setDecimation(uint8_t decimation);
+  uint8_t getDecimation() const;
+
+  // Software fallback only (no-op with DMA); call every loop()
+  void poll();
+
+  // Frames captured since begin(); doubles as the timestamp, in sample periods
+  uint32_t getFrameCount() const;
+
+  // Local micros() at which frame index was complete. The rate is exact, so
+  // one anchor per ring pass places every frame; frames before the last
+  // rate change keep their old rate. Safe from any context
+  uint32_t getFrameMicros(uint32_t index) const;
+
+  // Copy the newest complete frame; false before the first one
+  bool latest(ECGFrame& frame);
+
+  // Copy frame number index without consuming it, so loop() can process
+  // every frame while the master burst-reads them; false if not captured
+  // yet or already overwritten
+  bool peek(uint32_t index, ECGFrame& frame) const;
+
+  // Copy up to maxFrames unread frames (oldest first) and consume them.
+  // firstIndex receives the frame number of frames[0]. With a decimation
+  // of n every frame is the mean of n frames, frames[i] starts at frame
+  // firstIndex + i * n. Safe from an ISR, but must be used from one
+  // context only.
+  uint8_t readFrames(ECGFrame* frames, uint8_t maxFrames, uint32_t& firstIndex);
+
+  // Unread frames after decimation (at most one ring minus one); safe from any context
+  uint16_t getAvailable() const;
+  uint16_t getOverruns() const;
+  uint16_t getSampleRate() const;
+
+  // DMAC interrupt hook (block wrapped)
+  void onBlockDone();
+
+private:
+  void catchUp(uint32_t written);
+  ECGFrame frameAt(uint32_t index) const;
+
+  volatile uint16_t _samples[RING_FRAMES * CHANNELS];
+  volatile uint32_t _blocks;     // Completed passes over _samples
+  volatile uint32_t _anchorFrame;   // Last frame complete at _anchorMicros
+  volatile uint32_t _anchorMicros;
+  volatile uint32_t _rateFrame;          // First frame at _rateHz
+  volatile uint32_t _previousAnchorFrame;   // Frames before _rateFrame
+  volatile uint32_t _previousAnchorMicros;
+  volatile uint32_t _previousPeriodMicros;
+  uint32_t _readIndex;           // Next frame for readFrames()
+  uint16_t _overruns;
+  uint16_t _rateHz;
+  volatile uint8_t _decimation;
+
+  // Software fallback
+  uint32_t _softWrite;
+  unsigned long _periodMicros;
+  unsigned long _lastMicros;
+  bool _useDma;
+};
+
+#endif // ECG_ACQUISITION_H
@@ -0,0 +1,63 @@
+/*
+    ECGLeads.cpp
+
+    Derived limb leads implementation
+*/
+
+#include "ECGLeads.h"
+
+// All six leads of one frame from two differences: III = II - I and the
+// augmented leads as halves of sums of the Einthoven leads, e.g.
+// aVR = (2 RA - LA - LL) / 2 = -(I + II) / 2
+static void allLeads(const ECGFrame& frame, int16_t (&leads)[ECGLeads::NUM_LEADS]) {
+  const int32_t i = (int32_t)frame.la - frame.ra;
+  const int32_t ii = (int32_t)frame.ll - frame.ra;
+  const int32_t iii = ii - i;
+  leads[0] = (int16_t)i;
+  leads[1] = (int16_t)ii;
+  leads[2] = (int16_t)iii;
+  leads[3] = (int16_t)((-(i + ii)) >> 1);
+  leads[4] = (int16_t)((i - iii) >> 1);
+  leads[5] = (int16_t)((ii + iii) >> 1);
+}
+
+int16_t ECGLeads::compute(const ECGFrame& frame, uint8_t lead) {
+  int16_t leads[NUM_LEADS];
+  allLeads(frame, leads);
+  for (uint8_t n = 0; n < NUM_LEADS; n++) {
+    if (lead == (1 << n)) return leads[n];
+  }
+  return 0;
+}
+
+uint16_t ECGLeads::compute(const ECGFrame* frames, uint8_t count, uint8_t mask, int16_t* out) {
+  uint16_t written = 0;
+  int16_t leads[NUM_LEADS];
+  for (uint8_t f = 0; f < count; f++) {
+    allLeads(frames[f], leads);
+    for (uint8_t n = 0; n < NUM_LEADS; n++) {
+      if (mask & (1 << n)) out[written++] = leads[n];
+    }
+  }
+  return written;
+}
+
+uint16_t ECGLeads::pack(const ECGFrame* frames, uint8_t count, uint8_t mask, uint8_t* out) {
+  uint16_t written = 0;
+  int16_t leads[NUM_LEADS];
+  for (uint8_t f = 0; f < count; f++) {
+    allLeads(frames[f], leads);
+    for (uint8_t n = 0; n < NUM_LEADS; n++) {
+      if (!(mask & (1 << n))) continue;
+      out[written++] = (uint16_t)leads[n] >> 8;
+      out[written++] = (uint16_t)leads[n] & 0xFF;
+    }
+  }
+  return written;
+}
+
+uint8_t ECGLeads::getCount(uint8_t mask) {
+  uint8_t count = 0;
+  for (mask &= ALL_LEADS; mask; mask &= mask - 1) count++;
+  return count;
+}
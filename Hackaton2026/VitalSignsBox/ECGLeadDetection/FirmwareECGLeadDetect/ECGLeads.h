@@ -0,0 +1,51 @@
+/*
+    ECGLeads.h
+
+    Derived limb leads from the three electrodes, integer only.
+
+    Einthoven:  I = LA - RA,  II = LL - RA,  III = LL - LA
+    Goldberger: aVR = RA - (LA + LL) / 2
+                aVL = LA - (RA + LL) / 2
+                aVF = LL - (RA + LA) / 2
+
+    In ADC counts, signed. The augmented leads are rounded down (an
+    arithmetic shift of the doubled value), so they are exact to half a
+    count. A batch over frames from the acquisition ring writes only the
+    selected leads, frame after frame, in bit order: what the hub asked
+    for is what goes on the wire.
+*/
+
+#ifndef ECG_LEADS_H
+#define ECG_LEADS_H
+
+#include "Arduino.h"
+#include "ECGAcquisition.h"
+
+class ECGLeads {
+public:
+  static const uint8_t NUM_LEADS = 6;
+
+  // Lead bits, also the order of the leads in a batch
+  static const uint8_t LEAD_I = 0x01;
+  static const uint8_t LEAD_II = 0x02;
+  static const uint8_t LEAD_III = 0x04;
+  static const uint8_t LEAD_AVR = 0x08;
+  static const uint8_t LEAD_AVL = 0x10;
+  static const uint8_t LEAD_AVF = 0x20;
+  static const uint8_t ALL_LEADS = 0x3F;
+
+  // One lead (a single lead bit) of one frame; 0 for an unknown bit
+  static int16_t compute(const ECGFrame& frame, uint8_t lead);
+
+  // The leads in mask for count frames into out (count x getCount(mask)
+  // values, frame-major); returns the number of values written
+  static uint16_t compute(const ECGFrame* frames, uint8_t count, uint8_t mask, int16_t* out);
+
+  // As above, packed 16 bit big endian into a response; returns bytes written
+  static uint16_t pack(const ECGFrame* frames, uint8_t count, uint8_t mask, uint8_t* out);
+
+  // Leads selected by mask (bits above ALL_LEADS are ignored)
+  static uint8_t getCount(uint8_t mask);
+};
+
+#endif // ECG_LEADS_H
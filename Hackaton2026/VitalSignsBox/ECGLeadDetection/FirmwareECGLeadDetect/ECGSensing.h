@@ -3,9 +3,14 @@
     for HAN ESE, WKZ, Capgemini / GET Hackaton Challenge 2025
 
     V1.0 Jan 2025
+    V1.1 Oct 2026 - Reports as deferred-format trace records (TraceLog)
 
 */ 
 
+#include "TraceLog.h"
+
+extern TraceLog trace;  // Defined in the main .ino
+
 // Sensor Definitions:
 
 #define SENSOR_LL A1  // PB08 red
@@ -13,11 +18,14 @@
 #define SENSOR_RA A3  // PA04 white
 
 
+// 14 bytes on the wire; tracelog.py prints "LL LA RA" as before
 void readAndReportECGLeads() {
-  Serial.print(analogRead(SENSOR_LL));
-  Serial.print(" ");
-  Serial.print(analogRead(SENSOR_LA));
-  Serial.print(" ");
-  Serial.print(analogRead(SENSOR_RA));
-  Serial.println();
+  TRACE(trace, "%u %u %u", analogRead(SENSOR_LL), analogRead(SENSOR_LA), analogRead(SENSOR_RA));
+}
+
+
+// Same report from values that were already sampled (no analogRead, so it
+// does not disturb a running ADC scan)
+void reportECGLeads(uint16_t ll, uint16_t la, uint16_t ra) {
+  TRACE(trace, "%u %u %u", ll, la, ra);
 }
@@ -8,11 +8,18 @@
 
 
 #include "ECGSensor.h"
+#include "AdcScanner.h"
 
-ECGSensor::ECGSensor(uint8_t pin) : pin(pin), value(0) {}
+ECGSensor::ECGSensor(uint8_t pin) : scanner(nullptr), pin(pin), value(0) {}
+
+ECGSensor::ECGSensor(AdcScanner& scanner, uint8_t channel) : scanner(&scanner), pin(channel), value(0) {}
 
 void ECGSensor::read() {
-  value = analogRead(pin);
+  value = scanner ? scanner->getValue(pin) : analogRead(pin);
+}
+
+void ECGSensor::setValue(uint16_t newValue) {
+  value = newValue;
 }
 
 uint16_t ECGSensor::getValue() const {
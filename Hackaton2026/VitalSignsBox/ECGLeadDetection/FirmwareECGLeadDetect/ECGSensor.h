@@ -11,16 +11,21 @@
 
 #include "Arduino.h"
 
+class AdcScanner;
+
 class ECGSensor {
 public:
   ECGSensor(uint8_t pin);
+  ECGSensor(AdcScanner& scanner, uint8_t channel);  // View on a scanner channel, no analogRead()
   void read();
+  void setValue(uint16_t newValue);  // When sampled elsewhere (ECGAcquisition)
   uint16_t getValue() const;
   uint8_t getHighByte() const;
   uint8_t getLowByte() const;
 
 private:
-  uint8_t pin;
+  AdcScanner* scanner;
+  uint8_t pin;      // Analog pin, or scanner channel
   uint16_t value;
 };
 
@@ -9,6 +9,39 @@
     For your convenience we implemented:
     - continous reading of the Left-Leg (LL, RED), Left-Arm (LA, BLACK) and Right-Arm (WHITE) sensors
     - we provide six bytes to the client, for each sensor 
+    - V1.1: responses come from a pre-packed, double-buffered snapshot published by loop(),
+      followed by a sequence byte so the master can detect stale or duplicate frames
+    - V1.2: timer-triggered DMA sampling at a fixed rate into a ring buffer (ECGAcquisition), and a
+      small register map so the master can burst-read buffered frames with their frame number
+    - V1.3: diagnostics as non-blocking, rate-limited binary telemetry instead of Serial.print per loop
+    - V1.4: byte-addressed register map with auto-increment (I2CRegisterSlave), so the master
+      reads only the fields it needs and gets frame plus status in one transaction
+    - V1.5: text diagnostics as deferred-format trace records (TraceLog, decoded by
+      Utils/TraceLog/tracelog.py)
+    - V1.6: on-module R-peak detection (QRSDetector, Pan-Tompkins on lead II) over every frame,
+      heart rate, RR interval and beat count in the register map
+    - V1.7: on-module lead-off detection (LeadOffDetector: per-lead thresholds, hysteresis and
+      debounce), one lead status register and an interrupt line to the hub on every change
+    - V1.8: RAM instrumentation (MemoryMonitor): stack high-water mark from a painted stack and
+      the peak fill of the sample ring and telemetry ring, in the MEMORY register and telemetry
+    - V1.9: heartbeat LED driven by a timer interrupt (no work in loop()); it blinks the number
+      of leads off as a code and flashes on every I2C read
+    - V1.10: hub timebase (TimeSync): the hub's general-call syncs give an offset and drift
+      estimate, and BURST_TIMED stamps the buffered frames in hub time
+    - V1.11: signal quality of lead II (SignalQuality): fixed-point FFT over 2 s blocks in the
+      idle time of loop(), mains / baseline / EMG shares and a quality index for the hub
+    - V1.12: load counters (RuntimeStats): loop rate and longest pass, I2C handler time, samples
+      per second, overruns and bus errors in the RUNTIME register, the same block on every module
+    - V1.13: derived limb leads on the module (ECGLeads: I, II, III, aVR, aVL, aVF in integer
+      counts); BURST_LEADS streams only the leads the hub selects, computed over the burst
+    - V1.14: on the common module runtime (ModuleRuntime): RUNTIME block, hub time syncs and
+      load counters in the runtime; sampling stays on timer + DMA
+    - V1.15: lead-off changes as timestamped events (ModuleEvents) in the EVENTS FIFO at 0x26,
+      stamped with the hub time of the frame that completed the debounce; every change
+      asserts the lead interrupt line, reading LEAD_STATUS or emptying EVENTS releases it
+    - V1.16: frame rate and decimation set by the hub (ModuleRates, RATES at 0x27): the timer of
+      the ADC scan is retuned while the DMA runs on (100-1000 frames/s), bursts carry the mean
+      of every n frames; above 500 frames/s the detectors see the mean of pairs
 
 */
 
@@ -18,9 +51,26 @@
 
 #include "SerialHelper.h"
 #include "ECGSensor.h"
+#include "ECGAcquisition.h"
+#include "ECGLeads.h"
+#include "Telemetry.h"
+#include "TraceLog.h"
+#include "I2CRegisterSlave.h"
+#include "QRSDetector.h"
+#include "LeadOffDetector.h"
+#include "MemoryMonitor.h"
+#include "TimeSync.h"
+#include "SignalQuality.h"
+#include "RuntimeStats.h"
+#include "ModuleEvents.h"
+#include "ModuleRates.h"
+#include "ModuleRuntime.h"
 
 #define ECG_MODULE_ADDR 0x2A
 #define HEARTBEAT_LEDPIN 14
+#define LEAD_INT_PIN 9    // Active low, open drain to the hub; released by reading LEAD_STATUS or EVENTS
+#define LEAD_DEBOUNCE_MS 100
+#define LEAD_CHANGES_PER_PASS 6  // Each lead off and on again within one batch of frames
 #define DEFAULT_HEARTBEAT_INTERVAL 1000
 
 #define TESTING 1 // This enables/disables serial output.
@@ -31,61 +81,356 @@ ECGSensor sensorLL(A1);  // PB08 red
 ECGSensor sensorLA(A2);  // PB09 black
 ECGSensor sensorRA(A3);  // PA04 white
 
+#define ECG_SAMPLE_RATE 500  // Frames per second at boot; the hub may change it (RATES)
+#define ECG_RATE_CHANNEL 0   // LL, LA and RA: one scan, one rate
+#define ECG_DECIMATION_MAX 16
+#define ECG_ANALYSIS_RATE_MAX 500  // QRSDetector and SignalQuality
+
+// Telemetry record types and rates
+#define TLM_ECG_FRAME 2            // Payload: LL, LA, RA (16 bit big endian)
+#define TLM_ECG_INTERVAL_MS 10     // 100 records/s, well inside 115200 baud
+#define TLM_MEMORY 6               // Payload: MemoryMonitor report (see REG_MEMORY)
+#define TLM_MEMORY_INTERVAL_MS 1000
+#define TLM_RUNTIME 8              // Payload: RuntimeStats report (see REG_RUNTIME), once per second
+
 #define NUM_SENSOR_BYTES 6
 
+// I2C register map (byte addresses, multi-byte values big endian). The master
+// writes a register pointer, then reads: the response auto-increments, so one
+// read from 0x00 returns the latest frame and the status. Without a write the
+// pointer stays at 0x00, which keeps the original 7-byte layout.
+#define REG_LL          0x00  // 16 bit
+#define REG_LA          0x02  // 16 bit
+#define REG_RA          0x04  // 16 bit
+#define REG_SEQUENCE    0x06  // 8 bit, +1 per published frame
+#define REG_SAMPLE_RATE 0x08  // 16 bit
+#define REG_AVAILABLE   0x0A  // 16 bit, frames waiting for BURST
+#define REG_OVERRUNS    0x0C  // 16 bit
+#define REG_FRAME_COUNT 0x0E  // 32 bit
+#define REG_HEART_RATE  0x12  // 16 bit, 0.1 bpm, 0 = no rate
+#define REG_RR_INTERVAL 0x14  // 16 bit, ms
+#define REG_BEAT_COUNT  0x16  // 16 bit, +1 per detected beat
+#define REG_BEAT_FRAME  0x18  // 32 bit, frame number of the last R peak
+#define REG_LEAD_STATUS 0x1C  // 8 bit, bit set = lead off: 0 LL, 1 LA, 2 RA
+#define REG_LEAD_CHANGES 0x1D // 8 bit, +1 per lead status change
+#define REG_SYNC_STATE  0x1E  // 8 bit, TimeSync::State: 0 no hub time, 1 offset, 2 locked
+#define REG_SIGNAL_QUALITY 0x1F  // 8 bit, % of lead II power in the ECG band, 0 = flat / none yet
+#define ECG_REGISTER_COUNT 0x20
+#define REG_BURST       0x20  // 5 + 6n bytes: first frame number (32 bit), n, n frames
+#define REG_MEMORY      0x21  // 11 + 4n bytes: RAM use and buffer peaks (MemoryMonitor::pack())
+#define REG_BURST_TIMED 0x22  // 9 + 6n bytes: as BURST, hub time of the first frame (32 bit) after its number
+#define REG_QUALITY     0x23  // 6 bytes: index, flags, mains %, baseline %, EMG %, mains Hz (SignalQualityReport)
+#define REG_RUNTIME     MODULE_REG_RUNTIME  // 0x24, 36 bytes: load counters, served by ModuleRuntime
+#define REG_BURST_LEADS 0x25  // 6 + 2mn bytes: first frame number (32), lead mask, n, n x m selected leads
+#define REG_EVENTS      MODULE_REG_EVENTS  // 0x26, 4 + 8n bytes: lead-off changes (ModuleEvents), served by ModuleRuntime
+#define REG_RATES       MODULE_REG_RATES   // 0x27, 1 + 8n bytes: frame rate and decimation (ModuleRates), written by the hub
+#define ECG_WIRE_BUFFER 64
+#define ECG_BURST_MAX 8       // Keeps a burst inside the 64-byte Wire buffer
+#define ECG_LEADS_HEADER 6
+#define ECG_LEADS_BURST_MAX ((ECG_WIRE_BUFFER - ECG_LEADS_HEADER) / 2)  // One lead selected
+
+ECGAcquisition acquisition;
+QRSDetector qrs;
+LeadOffDetector leads;
+SignalQuality quality;
+volatile uint8_t qualityReport[sizeof(SignalQualityReport)];  // Copy for REG_QUALITY
+MemoryMonitor memory;
+RuntimeStats stats;
+uint8_t memorySamples = MemoryMonitor::NO_BUFFER;    // Frames waiting in the acquisition ring
+uint8_t memoryTelemetry = MemoryMonitor::NO_BUFFER;  // Bytes queued in the telemetry ring
+I2CRegisterSlave registers(&Wire, ECG_REGISTER_COUNT);
+TimeSync timeSync;
+ModuleRuntime runtime(registers, stats);
+ModuleEvents events(registers);
+ModuleRates rates;
+uint8_t analysisStep = 1;    // Frames per detector sample: 2 above ECG_ANALYSIS_RATE_MAX
+int32_t analysisSum = 0;     // Lead II of the frames of the step so far
+uint8_t analysisCount = 0;
+uint32_t beatFrame = 0;      // Acquisition frame of the last R peak, for REG_BEAT_FRAME
+volatile uint8_t burstFrames = ECG_BURST_MAX;
+volatile uint8_t leadMask = ECGLeads::LEAD_I | ECGLeads::LEAD_II;  // The other four follow from these
+volatile uint8_t leadFrames = ECG_LEADS_BURST_MAX;
+uint8_t frameSequence = 0;
+uint32_t lastFrameCount = 0;
+
 HeartBeat heartBeat = HeartBeat();  // (HEARTBEAT_LEDPIN, DEFAULT_HEARTBEAT_INTERVAL) ;
+Telemetry telemetry(Serial);
+TraceLog trace(telemetry);
 
 void setup() {
+  memory.begin();  // First: paints the RAM the rest of the program has not used yet
+  memorySamples = memory.addBuffer(ECGAcquisition::RING_FRAMES - 1);
+  memoryTelemetry = memory.addBuffer(Telemetry::RING_SIZE - 1);
   heartBeat.begin();
   initSerial();
-  Wire.begin(ECG_MODULE_ADDR);   // join i2c bus with address #4
-  Wire.onReceive(receiveEvent);  // register event maybe for future usage
-  Wire.onRequest(requestEvent);  // register event
+  runtime.onWrite(writeRegister);
+  runtime.onRead(readRegister);
+  runtime.setTimeSync(&timeSync);  // Hub time syncs on the general call
+  telemetry.setMinInterval(TLM_ECG_FRAME, TLM_ECG_INTERVAL_MS);
+  telemetry.setMinInterval(TLM_MEMORY, TLM_MEMORY_INTERVAL_MS);
+  acquisition.begin(ECG_SAMPLE_RATE);
+  qrs.begin(ECG_SAMPLE_RATE);
+  quality.begin(ECG_SAMPLE_RATE);
+  leads.begin(ECG_SAMPLE_RATE, LEAD_DEBOUNCE_MS);
+  rates.addChannel(ECG_SAMPLE_RATE, ECGAcquisition::MIN_RATE, ECGAcquisition::MAX_RATE, ECG_DECIMATION_MAX);
+  rates.onChange(changeRate);
+  runtime.setRates(&rates);
+  events.setTimeSync(&timeSync);
+  events.setInterruptPin(LEAD_INT_PIN);  // Released; the hub pulls the line up
+  runtime.setEvents(&events);
+  if (TESTING) {
+    TRACE(trace, "ECG module 0x%02x, %u frames/s", ECG_MODULE_ADDR, ECG_SAMPLE_RATE);
+  }
+  runtime.begin(ECG_MODULE_ADDR);  // join i2c bus as slave
 }
 
 void loop() {
-  heartBeat.blink();
+  if (runtime.run() && TESTING) {
+    uint8_t report[RuntimeStats::REPORT_BYTES];
+    telemetry.send(TLM_RUNTIME, report, stats.pack(report));
+  }
+  heartBeat.blink();  // Empty on SAMD21: TC4 drives the LED
+  memory.setLevel(memoryTelemetry, telemetry.getUsed());  // Fullest just before draining
+  telemetry.drain();  // Never blocks: only fills free TX buffer space
+  if (memory.update() && TESTING) {
+    uint8_t report[MemoryMonitor::REPORT_MAX];
+    telemetry.send(TLM_MEMORY, report, memory.pack(report));
+  }
 
-  // Update all sensors
-  sensorLL.read();
-  sensorLA.read();
-  sensorRA.read();
+  // Sampling runs on timer + DMA; only publish when a new frame is in
+  acquisition.poll();
+  memory.setLevel(memorySamples, acquisition.getAvailable());
+  if (quality.step()) publishQuality();  // One piece of the FFT per pass, also between frames
+  const uint32_t frameCount = acquisition.getFrameCount();
+  stats.setOverruns(acquisition.getOverruns() + telemetry.getDropped());
+  if (frameCount == lastFrameCount) return;
+  stats.addSamples((uint16_t)((frameCount - lastFrameCount) * 3));  // LL, LA, RA per frame
 
-  if (TESTING) readAndReportECGLeads();  // Just for testing / development
+  // Every frame goes through the detectors, not just the latest. peek() does
+  // not consume, so BURST reads by the master are unaffected.
+  ECGFrame frame;
+  uint8_t leadChanges = 0;
+  uint8_t changeStatus[LEAD_CHANGES_PER_PASS];
+  uint32_t changeMicros[LEAD_CHANGES_PER_PASS];
+  uint32_t index = lastFrameCount;
+  if (frameCount - index > ECGAcquisition::RING_FRAMES - 1) {
+    index = frameCount - (ECGAcquisition::RING_FRAMES - 1);  // Fell behind: resume at the oldest
+  }
+  for (; index < frameCount; index++) {
+    if (!acquisition.peek(index, frame)) continue;
+    if (leads.update(frame)) {
+      restartAnalysis();           // A lead II gap is not a missed beat, nor part of the spectrum
+      if (leadChanges < LEAD_CHANGES_PER_PASS) {
+        changeStatus[leadChanges] = leads.getStatus();
+        changeMicros[leadChanges] = acquisition.getFrameMicros(index);
+        leadChanges++;
+      }
+    }
+    if ((leads.getStatus() & (LeadOffDetector::LEAD_LL | LeadOffDetector::LEAD_RA)) == 0) {
+      analysisSum += ECGLeads::compute(frame, ECGLeads::LEAD_II);
+      if (++analysisCount == analysisStep) {
+        const int16_t leadII = (int16_t)(analysisSum / analysisStep);
+        if (qrs.process(leadII, index / analysisStep)) {
+          beatFrame = qrs.getBeatFrame() * analysisStep;  // Detector frames, with the step of this beat
+        }
+        quality.addSample(leadII);
+        analysisSum = 0;
+        analysisCount = 0;
+      }
+    }
+  }
+  lastFrameCount = frameCount;
+
+  const bool haveFrame = acquisition.latest(frame);
+  if (haveFrame) {
+    sensorLL.setValue(frame.ll);
+    sensorLA.setValue(frame.la);
+    sensorRA.setValue(frame.ra);
+    publishRegisters();
+  }
+  // After publishing, so a hub woken by the line reads the new status
+  for (uint8_t i = 0; i < leadChanges; i++) events.post(ModuleEvents::LEADS, changeStatus[i], changeMicros[i]);
+  if (leadChanges > 0) showLeads();
+  if (!haveFrame) return;
+
+  // Just for testing / development: queued, sent by the UART in the background
+  if (TESTING) {
+    uint8_t payload[NUM_SENSOR_BYTES];
+    putU16(payload, frame.ll);
+    putU16(payload + 2, frame.la);
+    putU16(payload + 4, frame.ra);
+    telemetry.send(TLM_ECG_FRAME, payload, NUM_SENSOR_BYTES);
+  }
+}
+
+// Update the shadow registers with one complete frame plus status and
+// publish them together, so a read never mixes two frames
+void publishRegisters() {
+  registers.set16(REG_LL, sensorLL.getValue());
+  registers.set16(REG_LA, sensorLA.getValue());
+  registers.set16(REG_RA, sensorRA.getValue());
+  registers.set8(REG_SEQUENCE, ++frameSequence);  // Wraps at 255
+  registers.set16(REG_SAMPLE_RATE, acquisition.getSampleRate());
+  registers.set16(REG_AVAILABLE, acquisition.getAvailable());
+  registers.set16(REG_OVERRUNS, acquisition.getOverruns());
+  registers.set32(REG_FRAME_COUNT, acquisition.getFrameCount());
+  registers.set16(REG_HEART_RATE, qrs.getHeartRate());
+  registers.set16(REG_RR_INTERVAL, qrs.getRRInterval());
+  registers.set16(REG_BEAT_COUNT, qrs.getBeatCount());
+  registers.set32(REG_BEAT_FRAME, beatFrame);
+  registers.set8(REG_LEAD_STATUS, leads.getStatus());
+  registers.set8(REG_LEAD_CHANGES, leads.getChanges());
+  registers.set8(REG_SYNC_STATE, timeSync.getState());
+  registers.set8(REG_SIGNAL_QUALITY, quality.getIndex());
+  registers.publish();
+}
+
+// The detectors start over at the analysis rate
+void restartAnalysis() {
+  const uint16_t rate = acquisition.getSampleRate() / analysisStep;
+  qrs.begin(rate);
+  quality.begin(rate);
+  analysisSum = 0;
+  analysisCount = 0;
 }
 
-// function that executes whenever data is received from master
-// this function is registered as an event, see setup()
-// Maybe useful for future usage
+// Called by the runtime in loop() context when the hub writes RATES: retune
+// the scan, keep the lead status, relearn the heart rate at the new rate
+uint16_t changeRate(uint8_t channel, uint16_t rateHz, uint8_t decimation) {
+  if (channel != ECG_RATE_CHANNEL) return 0;
+  acquisition.setSampleRate(rateHz);
+  acquisition.setDecimation(decimation);
+  const uint16_t rate = acquisition.getSampleRate();
+  analysisStep = rate > ECG_ANALYSIS_RATE_MAX ? 2 : 1;
+  leads.setSampleRate(rate, LEAD_DEBOUNCE_MS);
+  restartAnalysis();
+  if (TESTING) {
+    TRACE(trace, "Rate %u frames/s, 1 in %u to the hub", rate, decimation);
+  }
+  return rate;
+}
 
-void receiveEvent(int howMany) {
-  (void)howMany;  // avoid compiler warning about unused parameter
+// A new signal quality report: copy it for REG_QUALITY, which the I2C
+// interrupt serves; the index follows with the next published frame
+void publishQuality() {
+  const SignalQualityReport& report = quality.getReport();
+  noInterrupts();
+  qualityReport[0] = report.index;
+  qualityReport[1] = report.flags;
+  qualityReport[2] = report.mains;
+  qualityReport[3] = report.baseline;
+  qualityReport[4] = report.emg;
+  qualityReport[5] = report.mainsHz;
+  interrupts();
+  if (TESTING) {
+    TRACE(trace, "Quality %u%% flags 0x%02x mains %u%% @%u Hz", report.index, report.flags, report.mains,
+          report.mainsHz);
+  }
+}
 
-  while (1 < Wire.available())  // loop through all but the last
-  {
-    char c = Wire.read();  // receive byte as a character
-    if (TESTING) Serial.print(c);       // print the character
+// A lead came off or back on: the events pulled the interrupt line low
+void showLeads() {
+  const uint8_t status = leads.getStatus();
+  heartBeat.showCode(((status & LeadOffDetector::LEAD_LL) ? 1 : 0) + ((status & LeadOffDetector::LEAD_LA) ? 1 : 0)
+                     + ((status & LeadOffDetector::LEAD_RA) ? 1 : 0));  // Flashes = leads off
+  if (TESTING) {
+    TRACE(trace, "Leads off 0x%02x", leads.getStatus());
   }
-  int x = Wire.read();  // receive byte as an integer
-  if (TESTING) Serial.println(x);    // print the integer
 }
 
-// function that executes whenever data is requested by master
-// this function is registered as an event, see setup()
-void requestEvent() {
-  uint8_t response[NUM_SENSOR_BYTES];
-
-  // Helper function to add sensor data to the buffer
-  auto populateBuffer = [](uint8_t* buffer, const ECGSensor& sensor, int offset) {
-    buffer[offset] = sensor.getHighByte();
-    buffer[offset + 1] = sensor.getLowByte();
-  };
-
-  // Populate response buffer
-  populateBuffer(response, sensorLL, 0);
-  populateBuffer(response, sensorLA, 2);
-  populateBuffer(response, sensorRA, 4);
-
-  // Send the response over I2C
-  Wire.write(response, NUM_SENSOR_BYTES);
-}
\ No newline at end of file
+// Runs in the I2C interrupt: a byte written to BURST sets the frame count;
+// the two bytes after the BURST_LEADS pointer set the lead mask and the
+// frame count of a lead burst (0 = as many as fit)
+void writeRegister(uint8_t reg, uint8_t value) {
+  if (reg == REG_BURST) {
+    burstFrames = (value == 0 || value > ECG_BURST_MAX) ? ECG_BURST_MAX : value;
+  } else if (reg == REG_BURST_LEADS) {
+    leadMask = (value & ECGLeads::ALL_LEADS) ? (value & ECGLeads::ALL_LEADS) : ECGLeads::ALL_LEADS;
+  } else if (reg == REG_BURST_LEADS + 1) {
+    leadFrames = (value == 0 || value > ECG_LEADS_BURST_MAX) ? ECG_LEADS_BURST_MAX : value;
+  }
+}
+
+// Runs in the I2C interrupt: BURST, BURST_TIMED and BURST_LEADS are served live
+// from the ring buffer, MEMORY from the monitor's counters, QUALITY from the last report,
+// and a read of LEAD_STATUS acknowledges the lead interrupt; the runtime serves
+// RUNTIME and EVENTS
+bool readRegister(uint8_t reg) {
+  heartBeat.flash();  // Bus activity
+  if (reg == REG_LEAD_STATUS) events.release();
+  if (reg == REG_MEMORY) {
+    uint8_t report[MemoryMonitor::REPORT_MAX];
+    Wire.write(report, memory.pack(report));
+    return true;
+  }
+  if (reg == REG_QUALITY) {
+    uint8_t report[sizeof(qualityReport)];
+    for (uint8_t i = 0; i < sizeof(report); i++) report[i] = qualityReport[i];
+    Wire.write(report, sizeof(report));
+    return true;
+  }
+  if (reg == REG_BURST_LEADS) {
+    writeLeadBurst();
+    return true;
+  }
+  if (reg != REG_BURST && reg != REG_BURST_TIMED) return false;
+  writeBurst(reg == REG_BURST_TIMED);
+  return true;
+}
+
+void putU16(uint8_t* buffer, uint16_t value) {
+  buffer[0] = value >> 8;
+  buffer[1] = value & 0xFF;
+}
+
+void putU32(uint8_t* buffer, uint32_t value) {
+  putU16(buffer, value >> 16);
+  putU16(buffer + 2, value & 0xFFFF);
+}
+
+// Frames are consumed: the next burst continues where this one stopped.
+// The frame number times 1/rate is the sample time (at a fixed rate). Timed
+// bursts add the hub time of the first frame; with decimation n, frame i is
+// the mean of n frames and starts i * n / rate later.
+void writeBurst(bool timed) {
+  ECGFrame frames[ECG_BURST_MAX];
+  uint32_t firstIndex;
+  const uint8_t count = acquisition.readFrames(frames, burstFrames, firstIndex);
+
+  uint8_t response[9 + ECG_BURST_MAX * NUM_SENSOR_BYTES];
+  uint8_t header = 4;
+  putU32(response, firstIndex);
+  if (timed) {
+    putU32(response + 4, timeSync.toHub(acquisition.getFrameMicros(firstIndex)));
+    header = 8;
+  }
+  response[header++] = count;
+  for (uint8_t i = 0; i < count; i++) {
+    uint8_t* out = response + header + i * NUM_SENSOR_BYTES;
+    putU16(out, frames[i].ll);
+    putU16(out + 2, frames[i].la);
+    putU16(out + 4, frames[i].ra);
+  }
+  Wire.write(response, header + count * NUM_SENSOR_BYTES);
+}
+
+// As BURST, but the selected derived leads of each frame instead of the raw
+// electrodes. The frame count is capped so the response fits the Wire
+// buffer: 29 frames of one lead, 4 frames of all six.
+void writeLeadBurst() {
+  const uint8_t mask = leadMask;
+  const uint8_t leads = ECGLeads::getCount(mask);
+  uint8_t frameLimit = (ECG_WIRE_BUFFER - ECG_LEADS_HEADER) / (2 * leads);
+  if (frameLimit > leadFrames) frameLimit = leadFrames;
+
+  ECGFrame frames[ECG_LEADS_BURST_MAX];
+  uint32_t firstIndex;
+  const uint8_t count = acquisition.readFrames(frames, frameLimit, firstIndex);
+
+  uint8_t response[ECG_WIRE_BUFFER];
+  putU32(response, firstIndex);
+  response[4] = mask;
+  response[5] = count;
+  const uint16_t length = ECGLeads::pack(frames, count, mask, response + ECG_LEADS_HEADER);
+  Wire.write(response, ECG_LEADS_HEADER + length);
+}
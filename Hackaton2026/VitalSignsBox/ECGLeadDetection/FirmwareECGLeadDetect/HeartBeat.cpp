@@ -3,34 +3,136 @@
     for HAN ESE, WKZ, Capgemini / GET Hackaton Challenge 2025
 
     V1.0 Jan 2025
+    V1.1 Oct 2026 - Timer driven (TC4) with status patterns
 
-*/ 
+*/
 
 #include "HeartBeat.h"
-#include "Arduino.h"
 
-HeartBeat::HeartBeat() {
-  _ledPin = 14;
-  _interval = 100;
+// Pattern updates must not be seen half done by the tick interrupt
+#if defined(__arm__)
+#define HB_LOCK() uint32_t hbPrimask = __get_PRIMASK(); __disable_irq()
+#define HB_UNLOCK() __set_PRIMASK(hbPrimask)
+#else
+#define HB_LOCK() uint8_t hbSreg = SREG; noInterrupts()
+#define HB_UNLOCK() SREG = hbSreg
+#endif
+
+#if HEARTBEAT_TIMER
+static HeartBeat* activeHeartBeat = nullptr;
+
+void TC4_Handler() {
+  TC4->COUNT16.INTFLAG.reg = TC_INTFLAG_MC0;
+  if (activeHeartBeat) activeHeartBeat->onTick();
+}
+
+// TC4 in match frequency mode: 48 MHz / 256 = 187.5 kHz, one match per tick
+static void startTickTimer() {
+  PM->APBCMASK.reg |= PM_APBCMASK_TC4;
+  GCLK->CLKCTRL.reg = GCLK_CLKCTRL_CLKEN | GCLK_CLKCTRL_GEN_GCLK0 | GCLK_CLKCTRL_ID_TC4_TC5;
+  while (GCLK->STATUS.bit.SYNCBUSY) {}
+
+  TC4->COUNT16.CTRLA.reg = TC_CTRLA_SWRST;
+  while (TC4->COUNT16.CTRLA.bit.SWRST) {}
+  TC4->COUNT16.CTRLA.reg = TC_CTRLA_MODE_COUNT16 | TC_CTRLA_WAVEGEN_MFRQ | TC_CTRLA_PRESCALER_DIV256;
+  TC4->COUNT16.CC[0].reg = (uint16_t)((F_CPU / 256UL) * HEARTBEAT_TICK_MS / 1000UL - 1UL);
+  while (TC4->COUNT16.STATUS.bit.SYNCBUSY) {}
+  TC4->COUNT16.INTENSET.reg = TC_INTENSET_MC0;
+
+  NVIC_SetPriority(TC4_IRQn, 3);  // Lowest: never delays sampling or I2C
+  NVIC_EnableIRQ(TC4_IRQn);
+  TC4->COUNT16.CTRLA.bit.ENABLE = 1;
+  while (TC4->COUNT16.STATUS.bit.SYNCBUSY) {}
+}
+#endif
+
+HeartBeat::HeartBeat() : HeartBeat(14, 100) {
 }
 
 HeartBeat::HeartBeat(unsigned int ledPin, long interval) {
-   _ledPin = ledPin;
-   _interval = interval;
+  _ledPin = ledPin;
+  _interval = interval;
+  _previousMillis = 0;
+  _pattern = 0b01;  // On for one interval, off for one
+  _length = 2;
+  _slotTicks = interval > HEARTBEAT_TICK_MS ? interval / HEARTBEAT_TICK_MS : 1;
+  _bit = 0;
+  _slotLeft = _slotTicks;
+  _flashLeft = 0;
 }
 
 void HeartBeat::begin() {
-    pinMode(_ledPin, OUTPUT);
-}
-
-void HeartBeat::blink() {
-  unsigned long currentMillis = millis();
-  if (currentMillis - _previousMillis >= _interval) {
-    _previousMillis = currentMillis;
-    if (digitalRead(_ledPin) == LOW) {
-      digitalWrite(_ledPin, HIGH);   // Turn it on
-    } else {
-      digitalWrite(_ledPin, LOW);    // Turn it off
-    }
+  pinMode(_ledPin, OUTPUT);
+  _previousMillis = millis();
+#if HEARTBEAT_TIMER
+  PortGroup& group = PORT->Group[g_APinDescription[_ledPin].ulPort];
+  _outSet = &group.OUTSET.reg;
+  _outClr = &group.OUTCLR.reg;
+  _mask = 1UL << g_APinDescription[_ledPin].ulPin;
+  activeHeartBeat = this;
+  startTickTimer();
+#endif
+  write(_pattern & 1);
+}
+
+void HeartBeat::setPattern(uint32_t pattern, uint8_t length, uint16_t slotMs) {
+  if (length == 0 || length > 32) return;
+  const uint16_t ticks = slotMs > HEARTBEAT_TICK_MS ? slotMs / HEARTBEAT_TICK_MS : 1;
+  HB_LOCK();
+  if (pattern != _pattern || length != _length || ticks != _slotTicks) {
+    _pattern = pattern;
+    _length = length;
+    _slotTicks = ticks;
+    _bit = 0;
+    _slotLeft = ticks;
+  }
+  HB_UNLOCK();
+}
+
+void HeartBeat::showCode(uint8_t code) {
+  if (code == 0) {
+    setPattern(0b01, 2, _interval);
+    return;
   }
-}
\ No newline at end of file
+  if (code > MAX_CODE) code = MAX_CODE;
+  uint32_t pattern = 0;
+  for (uint8_t i = 0; i < code; i++) {
+    pattern |= 1UL << (2 * i);  // On, off, on, off, ... then 4 slots off
+  }
+  setPattern(pattern, 2 * code + 4, HEARTBEAT_CODE_SLOT_MS);
+}
+
+void HeartBeat::flash() {
+  _flashLeft = HEARTBEAT_FLASH_TICKS;
+}
+
+void HeartBeat::onTick() {
+  if (--_slotLeft == 0) {
+    _slotLeft = _slotTicks;
+    _bit = (_bit + 1 < _length) ? _bit + 1 : 0;
+  }
+  bool on = (_pattern >> _bit) & 1;
+  if (_flashLeft) {
+    _flashLeft--;
+    on = !on;
+  }
+  write(on);
+}
+
+void HeartBeat::write(bool on) {
+#if HEARTBEAT_TIMER
+  if (on) *_outSet = _mask; else *_outClr = _mask;  // Single store, no read-modify-write
+#else
+  digitalWrite(_ledPin, on ? HIGH : LOW);
+#endif
+}
+
+// No timer: catch up on the ticks since the last call
+void HeartBeat::poll() {
+  const unsigned long now = millis();
+  if (now - _previousMillis > 1000UL) _previousMillis = now - HEARTBEAT_TICK_MS;  // Was blocked: do not replay
+  while (now - _previousMillis >= HEARTBEAT_TICK_MS) {
+    _previousMillis += HEARTBEAT_TICK_MS;
+    onTick();
+  }
+}
@@ -3,22 +3,82 @@
     for HAN ESE, WKZ, Capgemini / GET Hackaton Challenge 2025
 
     V1.0 Jan 2025
+    V1.1 Oct 2026 - Timer driven (TC4) with status patterns, no work per loop()
 
-*/ 
+    The LED shows a repeating bit pattern, one bit per slot. On SAMD21 a
+    lowest-priority TC4 interrupt every HEARTBEAT_TICK_MS steps it and
+    writes the port directly, so loop() no longer has to call blink().
+    (The LED pin on the Feather M0, A0 = PA02, has no TC/TCC output, so
+    the timer cannot drive it as a waveform by itself.) Elsewhere blink()
+    runs the same ticks from millis().
+
+    showCode() blinks an error code (n short flashes, pause), flash()
+    briefly inverts the LED to show bus activity and is safe in an ISR.
+    Uses TC4: not together with the Servo library.
+
+*/
 
 #ifndef HeartBeat_h
 #define HeartBeat_h
 
+#include "Arduino.h"
+
+#if defined(__SAMD21G18A__) || defined(__SAMD21J18A__) || defined(__SAMD21E18A__)
+#define HEARTBEAT_TIMER 1
+#else
+#define HEARTBEAT_TIMER 0
+#endif
+
+#define HEARTBEAT_TICK_MS 10
+#define HEARTBEAT_FLASH_TICKS 3   // flash(): 30 ms
+#define HEARTBEAT_CODE_SLOT_MS 200
+
 class HeartBeat {
   private:
     unsigned int _ledPin;
     long _interval;
-    long _previousMillis;
+    unsigned long _previousMillis;
+#if HEARTBEAT_TIMER
+    volatile uint32_t* _outSet;
+    volatile uint32_t* _outClr;
+    uint32_t _mask;
+#endif
+    // Read by the tick interrupt
+    volatile uint32_t _pattern;
+    volatile uint8_t _length;
+    volatile uint16_t _slotTicks;
+    volatile uint8_t _bit;
+    volatile uint16_t _slotLeft;
+    volatile uint8_t _flashLeft;
+
+    void write(bool on);
+    void poll();
   public:
+    static const uint8_t MAX_CODE = 14;  // 2 slots per flash + 4 pause fit in 32 bits
+
     HeartBeat();
     HeartBeat(unsigned int ledPin, long interval);
     void begin();
-    void blink();
+
+    // Only needed without the timer; with it an empty inline call
+    void blink() {
+#if !HEARTBEAT_TIMER
+      poll();
+#endif
+    }
+
+    // Bit i of pattern (LSB first) lights the LED in slot i; repeats every
+    // length slots (1..32). Setting the running pattern again is a no-op.
+    void setPattern(uint32_t pattern, uint8_t length, uint16_t slotMs);
+
+    // code short flashes and a pause (1..MAX_CODE); 0 = normal heartbeat
+    void showCode(uint8_t code);
+
+    // Invert the LED for HEARTBEAT_FLASH_TICKS; safe in an ISR
+    void flash();
+
+    // One tick (timer interrupt or poll())
+    void onTick();
 };
 
 #endif
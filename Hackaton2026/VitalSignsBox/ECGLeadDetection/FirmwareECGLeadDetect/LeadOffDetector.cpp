@@ -0,0 +1,107 @@
+/*
+    LeadOffDetector.cpp
+
+    Lead-off detection implementation
+*/
+
+#include "LeadOffDetector.h"
+
+// Rails at 10 bit: a floating input ends up within a few percent of 0 or 1023
+static const LeadThresholds DEFAULT_THRESHOLDS = { 16, 48, 975, 1007 };
+
+AnalogDebouncer::AnalogDebouncer() {
+  begin(DEFAULT_THRESHOLDS, 1);
+}
+
+void AnalogDebouncer::begin(const LeadThresholds& thresholds, uint16_t maxCount) {
+  _thresholds = thresholds;
+  _maxCount = maxCount == 0 ? 1 : maxCount;
+  _counter = 0;
+  _off = false;
+}
+
+void AnalogDebouncer::setMaxCount(uint16_t maxCount) {
+  if (maxCount == 0) maxCount = 1;
+  _counter = (uint16_t)(((uint32_t)_counter * maxCount + _maxCount / 2) / _maxCount);
+  if (_counter == 0 && _off) _counter = 1;  // Still at its end: no change from rounding
+  if (_counter == maxCount && !_off) _counter = maxCount - 1;
+  _maxCount = maxCount;
+}
+
+bool AnalogDebouncer::update(uint16_t value) {
+  // The hysteresis: which band applies depends on the current state
+  const bool rawOff = _off ? (value < _thresholds.onAbove || value > _thresholds.onBelow)
+                           : (value < _thresholds.offBelow || value > _thresholds.offAbove);
+
+  if (rawOff) {
+    if (_counter < _maxCount && ++_counter == _maxCount && !_off) {
+      _off = true;
+      return true;
+    }
+  } else {
+    if (_counter > 0 && --_counter == 0 && _off) {
+      _off = false;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool AnalogDebouncer::isOff() const {
+  return _off;
+}
+
+uint16_t AnalogDebouncer::getCounter() const {
+  return _counter;
+}
+
+LeadOffDetector::LeadOffDetector() : _maxCount(1), _status(0), _changes(0) {}
+
+void LeadOffDetector::begin(uint16_t sampleRateHz, uint16_t debounceMs) {
+  _maxCount = (uint16_t)(((uint32_t)sampleRateHz * debounceMs + 500) / 1000);
+  for (uint8_t i = 0; i < LEADS; i++) {
+    _leads[i].begin(DEFAULT_THRESHOLDS, _maxCount);
+  }
+  _status = 0;
+  _changes = 0;
+}
+
+void LeadOffDetector::setSampleRate(uint16_t sampleRateHz, uint16_t debounceMs) {
+  _maxCount = (uint16_t)(((uint32_t)sampleRateHz * debounceMs + 500) / 1000);
+  if (_maxCount == 0) _maxCount = 1;
+  for (uint8_t i = 0; i < LEADS; i++) {
+    _leads[i].setMaxCount(_maxCount);
+  }
+}
+
+void LeadOffDetector::setThresholds(uint8_t lead, const LeadThresholds& thresholds) {
+  if (lead >= LEADS) return;
+  _leads[lead].begin(thresholds, _maxCount);
+  _status &= (uint8_t)~(1 << lead);
+}
+
+bool LeadOffDetector::update(const ECGFrame& frame) {
+  const uint16_t values[LEADS] = { frame.ll, frame.la, frame.ra };
+
+  bool changed = false;
+  for (uint8_t i = 0; i < LEADS; i++) {
+    if (_leads[i].update(values[i])) changed = true;
+  }
+  if (!changed) return false;
+
+  uint8_t status = 0;
+  for (uint8_t i = 0; i < LEADS; i++) {
+    if (_leads[i].isOff()) status |= (uint8_t)(1 << i);
+  }
+  _status = status;
+  _changes++;
+  return true;
+}
+
+uint8_t LeadOffDetector::getStatus() const {
+  return _status;
+}
+
+uint8_t LeadOffDetector::getChanges() const {
+  return _changes;
+}
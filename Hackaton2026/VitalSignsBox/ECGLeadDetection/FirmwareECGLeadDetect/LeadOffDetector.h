@@ -0,0 +1,87 @@
+/*
+    LeadOffDetector.h
+
+    Lead-off detection per electrode.
+
+    A loose electrode lets its input drift to a rail. Every lead has a band
+    of valid values with hysteresis (the "on" band lies inside the "off"
+    limits) and an integrator debouncer, as the IntegratorDebouncer for
+    buttons but on an analog value: the counter runs up while the value
+    says "off" and down while it says "on", and the state only changes at
+    the ends. A single spike or a slow crossing of a limit does not toggle it.
+*/
+
+#ifndef LEAD_OFF_DETECTOR_H
+#define LEAD_OFF_DETECTOR_H
+
+#include "Arduino.h"
+#include "ECGAcquisition.h"
+
+// ADC counts (10 bit). off: outside [offBelow, offAbove]; on again: inside [onAbove, onBelow]
+struct LeadThresholds {
+  uint16_t offBelow;
+  uint16_t onAbove;
+  uint16_t onBelow;
+  uint16_t offAbove;
+};
+
+// IntegratorDebouncer on an analog value with a hysteresis band
+class AnalogDebouncer {
+public:
+  AnalogDebouncer();
+
+  void begin(const LeadThresholds& thresholds, uint16_t maxCount);
+
+  // New debounce length; keeps the state, the counter scales along
+  void setMaxCount(uint16_t maxCount);
+
+  // One sample; true if the debounced state changed
+  bool update(uint16_t value);
+
+  bool isOff() const;
+  uint16_t getCounter() const;
+
+private:
+  LeadThresholds _thresholds;
+  uint16_t _maxCount;
+  uint16_t _counter;
+  bool _off;
+};
+
+class LeadOffDetector {
+public:
+  static const uint8_t LEADS = 3;
+
+  // Bits of getStatus(): set = lead off
+  static const uint8_t LEAD_LL = 0x01;
+  static const uint8_t LEAD_LA = 0x02;
+  static const uint8_t LEAD_RA = 0x04;
+
+  LeadOffDetector();
+
+  // debounceMs: how long a lead must be off (or back on) before it counts
+  void begin(uint16_t sampleRateHz, uint16_t debounceMs = 100);
+
+  // The frame rate changed: same debounce time, the status is kept
+  void setSampleRate(uint16_t sampleRateHz, uint16_t debounceMs = 100);
+
+  // lead: 0 = LL, 1 = LA, 2 = RA. Resets that lead to "on"
+  void setThresholds(uint8_t lead, const LeadThresholds& thresholds);
+
+  // One frame; true if the status changed
+  bool update(const ECGFrame& frame);
+
+  // Lead-off bits; all leads start as "on"
+  uint8_t getStatus() const;
+
+  // +1 per status change (wraps)
+  uint8_t getChanges() const;
+
+private:
+  AnalogDebouncer _leads[LEADS];
+  uint16_t _maxCount;
+  uint8_t _status;
+  uint8_t _changes;
+};
+
+#endif // LEAD_OFF_DETECTOR_H
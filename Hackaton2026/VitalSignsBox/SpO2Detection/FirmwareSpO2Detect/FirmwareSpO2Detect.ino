@@ -11,6 +11,32 @@
     for HAN ESE / WKZ Hackaton Challenge 2026
 
     V1.0 Jan 2026
+    V1.1 Oct 2026 - Diagnostics as non-blocking binary telemetry (no delay() in loop)
+    V1.2 Oct 2026 - Byte-addressed register map (I2CRegisterSlave); LED and threshold writable
+    V1.3 Oct 2026 - Averaged readings, threshold hysteresis and slow polling once stable
+    V1.4 Oct 2026 - ADC owned by AdcScanner (interrupt driven, no analogRead() per sample)
+    V1.5 Oct 2026 - Text diagnostics as deferred-format trace records (TraceLog)
+    V1.6 Oct 2026 - SpO2 and pulse rate from the red/IR photoplethysmogram (SpO2Estimator)
+                    in the register map
+    V1.7 Oct 2026 - RAM instrumentation (MemoryMonitor): stack high-water mark and telemetry
+                    ring peak in the MEMORY register and telemetry
+    V1.8 Oct 2026 - Heartbeat LED driven by a timer interrupt (no work in loop()); one-flash
+                    code while no probe is connected, short flash on every I2C read
+    V1.9 Oct 2026 - Hub timebase (TimeSync): general-call syncs from the hub, hub time of the
+                    latest sample in the register map
+    V1.10 Oct 2026 - No probe: the ADC window monitor watches the detection pin and interrupts
+                     on a connect, no conversions for the CPU until then
+    V1.11 Oct 2026 - Load counters (RuntimeStats): loop rate and longest pass, I2C handler
+                     time, samples per second, overruns and bus errors in the RUNTIME register
+    V1.12 Oct 2026 - Data-ready line to the hub: asserted when the status block (0x00-0x03)
+                     changes, so the hub reads the module only then
+    V1.13 Oct 2026 - On the common module runtime (ModuleRuntime): plethysmogram sampling as a
+                     10 ms CyclicExecutive task, RUNTIME block and hub time syncs in the runtime
+    V1.14 Oct 2026 - Probe connects and disconnects as timestamped events (ModuleEvents) in the
+                     EVENTS FIFO at 0x26, each one asserts the data-ready line
+    V1.15 Oct 2026 - Plethysmogram rate and decimation set by the hub (ModuleRates, RATES at
+                     0x27): the sample task period follows the rate (25-200 Hz), the registers
+                     are published every n samples
 */
 
 #include <Wire.h>
@@ -18,6 +44,17 @@
 #include "SerialHelper.h"
 #include "SPO2Sensor.h"
 #include "SPO2Sensing.h"
+#include "Telemetry.h"
+#include "TraceLog.h"
+#include "I2CRegisterSlave.h"
+#include "AdcScanner.h"
+#include "SpO2Estimator.h"
+#include "MemoryMonitor.h"
+#include "TimeSync.h"
+#include "RuntimeStats.h"
+#include "ModuleEvents.h"
+#include "ModuleRates.h"
+#include "ModuleRuntime.h"
 
 // I2C Configuration
 #define SPO2_MODULE_ADDR 0x2B  // I2C slave address for SpO2 detection module
@@ -25,13 +62,25 @@
 // Pin Configuration (defined in SPO2Sensor.h)
 // SPO2_CONNECTION_A2 = A2  // Detection pin with 10k pull-up to 3.3V
 // SPO2_LED_D12 = 12        // RED LED output pin
+#define SPO2_RED_A3 A3           // Red photoplethysmogram from the probe front end
+#define SPO2_IR_A4 A4            // Infrared photoplethysmogram
 #define HEARTBEAT_LEDPIN 14
+#define SPO2_DATA_READY_PIN 9    // Active low, open drain to the hub; released by any read
 #define DEFAULT_HEARTBEAT_INTERVAL 1000
 
 // Detection threshold (below this value = sensor connected)
 // At 10-bit ADC: 1023 = 3.3V, so ~512 = 1.65V
 // With 10k pull-up, connected sensor should pull well below this
 #define DETECTION_THRESHOLD 512
+#define DETECTION_HYSTERESIS 32  // Connect below 480, disconnect above 544
+
+// Photoplethysmogram sampling: one scanner round per task period
+#define SPO2_SAMPLE_RATE 100  // Samples per second per channel at boot; the hub may change it (RATES)
+#define SPO2_SAMPLE_PERIOD_MS (1000 / SPO2_SAMPLE_RATE)
+#define SPO2_RATE_MIN 25      // 40 ms task period
+#define SPO2_RATE_MAX 200     // 5 ms: a round of 3 channels with 8x averaging fits well
+#define SPO2_DECIMATION_MAX 10
+#define SPO2_RATE_CHANNEL 0   // Red and IR: one scanner round, one rate
 
 // Debug mode
 #define TESTING 1  // Set to 0 to disable serial output
@@ -39,68 +88,258 @@
 // Response size: 1 byte status + 2 bytes raw ADC value + 1 byte LED state
 #define NUM_RESPONSE_BYTES 4
 
+// I2C register map (byte addresses, 16-bit values big endian). The master
+// writes a register pointer, then reads with auto-increment; more bytes in
+// the write set the writable registers. Without a write the pointer stays at
+// 0x00, so a 4-byte read returns the original response.
+#define REG_STATUS     0x00  // 8 bit, 1 = connected (read only)
+#define REG_RAW        0x01  // 16 bit raw ADC value (read only)
+#define REG_LED        0x03  // 8 bit, 0 = off, 1 = on (read/write)
+#define REG_THRESHOLD  0x04  // 16 bit detection threshold (read/write, applied on the low byte)
+#define REG_SPO2       0x06  // 16 bit, 0.1 %, 0 = no reading (read only)
+#define REG_PULSE_RATE 0x08  // 16 bit, 0.1 bpm, 0 = no reading (read only)
+#define REG_PERFUSION  0x0A  // 16 bit, IR perfusion index in 0.01 % (read only)
+#define REG_RATIO      0x0C  // 16 bit, ratio of ratios x 1000 (read only)
+#define REG_QUALITY    0x0E  // 8 bit, accepted beats among the last 8 in % (read only)
+#define REG_BEAT_COUNT 0x0F  // 8 bit, +1 per accepted beat (read only)
+#define REG_SAMPLE_TIME 0x10 // 32 bit, hub time in us of the last red/IR sample processed (read only)
+#define REG_SYNC_STATE 0x14  // 8 bit, TimeSync::State: 0 no hub time, 1 offset, 2 locked (read only)
+#define SPO2_REGISTER_COUNT 0x15
+#define REG_MEMORY     0x21  // 11 + 4n bytes: RAM use and buffer peaks (MemoryMonitor::pack(), read only)
+#define REG_RUNTIME    MODULE_REG_RUNTIME  // 0x24, 36 bytes: load counters, served by ModuleRuntime (read only)
+#define REG_EVENTS     MODULE_REG_EVENTS   // 0x26, 4 + 8n bytes: probe changes (ModuleEvents), served by ModuleRuntime (read only)
+#define REG_RATES      MODULE_REG_RATES    // 0x27, 1 + 8n bytes: plethysmogram rate and decimation (ModuleRates, read/write)
+
+// Telemetry record types and rates
+#define TLM_SPO2_STATUS 1          // Payload: same 4 bytes as the I2C response
+#define TLM_SPO2_INTERVAL_MS 500
+#define TLM_MEMORY 6               // Payload: MemoryMonitor report (see REG_MEMORY)
+#define TLM_MEMORY_INTERVAL_MS 1000
+#define TLM_RUNTIME 8              // Payload: RuntimeStats report (see REG_RUNTIME), once per second
+
+// ADC channels: the scanner owns the ADC, the sensor is a view on channel 0
+const uint8_t adcPins[] = { SPO2_CONNECTION_A2, SPO2_RED_A3, SPO2_IR_A4 };
+#define ADC_CHANNEL_RED 1
+#define ADC_CHANNEL_IR 2
+AdcScanner adcScanner(adcPins, sizeof(adcPins));
+
 // Create instances (using default pins: A2 for detection, D12 for LED)
-SPO2Sensor spo2Sensor(SPO2_CONNECTION_A2, SPO2_LED_D12, DETECTION_THRESHOLD);
+SPO2Sensor spo2Sensor(adcScanner, 0, SPO2_LED_D12, DETECTION_THRESHOLD);
 HeartBeat heartBeat = HeartBeat(HEARTBEAT_LEDPIN, DEFAULT_HEARTBEAT_INTERVAL);
+Telemetry telemetry(Serial);
+TraceLog trace(telemetry);
+I2CRegisterSlave registers(&Wire, SPO2_REGISTER_COUNT);
+SpO2Estimator estimator;
+MemoryMonitor memory;
+RuntimeStats stats;
+ModuleRuntime runtime(registers, stats);
+ModuleEvents events(registers);  // On the data-ready line
+ModuleRates rates;
+int8_t plethTask = -1;
+uint8_t publishEvery = 1;    // Decimation: samples per publish
+uint8_t samplesToPublish = 1;
+uint8_t memoryTelemetry = MemoryMonitor::NO_BUFFER;  // Bytes queued in the telemetry ring
+uint32_t roundMicros = 0;    // Start of the scanner round in progress
+uint32_t sampleMicros = 0;   // Local time of the last sample given to the estimator
+TimeSync timeSync;
+bool wasConnected = false;
+bool probeConnected = false;  // State of the last PROBE event
+uint32_t countedRounds = 0;  // Scanner rounds already in stats
+
+// Written by the I2C interrupt, applied by loop()
+volatile int16_t pendingLed = -1;
+volatile int32_t pendingThreshold = -1;
+volatile uint8_t thresholdHigh = 0;
 
 void setup() {
+    memory.begin();  // First: paints the RAM the rest of the program has not used yet
+    memoryTelemetry = memory.addBuffer(Telemetry::RING_SIZE - 1);
     heartBeat.begin();
     initSerial();
 
+    // 10-bit scale, 8x hardware averaging, one round per sensor poll
+    adcScanner.begin(10, SPO2_DEFAULT_OVERSAMPLING, false);
+
     // Initialize SpO2 sensor detection
+    spo2Sensor.setHysteresis(DETECTION_HYSTERESIS);
+    spo2Sensor.setDetectionMode(SPO2Sensor::DETECT_WINDOW_DISCONNECTED);  // Red/IR only matter with a probe
     spo2Sensor.begin();
+    estimator.begin(SPO2_SAMPLE_RATE);
+    plethTask = runtime.addTask("pleth", samplePlethysmogram, SPO2_SAMPLE_PERIOD_MS);
+    rates.addChannel(SPO2_SAMPLE_RATE, SPO2_RATE_MIN, SPO2_RATE_MAX, SPO2_DECIMATION_MAX);
+    rates.onChange(changeRate);
+    runtime.setRates(&rates);
+
+    // Setup I2C slave: RUNTIME and the time syncs are the runtime's
+    runtime.onWrite(writeRegister);
+    runtime.onRead(readRegister);
+    runtime.setTimeSync(&timeSync);
+    events.setTimeSync(&timeSync);
+    runtime.setEvents(&events);
+    registers.setDataReadyPin(SPO2_DATA_READY_PIN, REG_STATUS, NUM_RESPONSE_BYTES);  // What the hub polls
 
-    // Setup I2C slave
-    Wire.begin(SPO2_MODULE_ADDR);
-    Wire.onReceive(receiveEvent);
-    Wire.onRequest(requestEvent);
+    telemetry.setMinInterval(TLM_SPO2_STATUS, TLM_SPO2_INTERVAL_MS);
+    telemetry.setMinInterval(TLM_MEMORY, TLM_MEMORY_INTERVAL_MS);
 
     if (TESTING) {
-        Serial.println("SpO2 Detection Module initialized");
-        Serial.print("I2C Address: 0x");
-        Serial.println(SPO2_MODULE_ADDR, HEX);
-        Serial.print("Detection Pin: A2 (threshold: ");
-        Serial.print(DETECTION_THRESHOLD);
-        Serial.println(")");
-        Serial.println("RED LED Pin: D12");
+        // Decoded by Utils/TraceLog/tracelog.py
+        TRACE(trace, "SpO2 Detection Module initialized, I2C address 0x%02x", SPO2_MODULE_ADDR);
+        TRACE(trace, "Detection Pin: A2 (threshold: %u), RED LED Pin: D12", DETECTION_THRESHOLD);
     }
+    runtime.begin(SPO2_MODULE_ADDR);  // Last: the first sample is due one period from here
 }
 
 void loop() {
-    heartBeat.blink();
+    // Due tasks first: the plethysmogram sample publishes its own result
+    if (runtime.run() && TESTING) {
+        uint8_t report[RuntimeStats::REPORT_BYTES];
+        telemetry.send(TLM_RUNTIME, report, stats.pack(report));
+    }
+    heartBeat.blink();  // Empty on SAMD21: TC4 drives the LED
+
+    const bool written = applyWrites();
 
-    // Update sensor detection state
-    spo2Sensor.update();
+    // Update sensor detection state (reads the ADC only when a poll is due)
+    const bool sampled = spo2Sensor.update();
+    if (written || sampled) publishRegisters();
+    postProbeChange();
 
     if (TESTING) {
-        readAndReportSpO2Status();
-        delay(500);  // Slow down serial output for readability
+        // Queued and rate limited; the UART sends it in the background
+        uint8_t record[NUM_RESPONSE_BYTES];
+        packResponse(record);
+        telemetry.send(TLM_SPO2_STATUS, record, NUM_RESPONSE_BYTES);
     }
+    if (memory.update() && TESTING) {
+        uint8_t report[MemoryMonitor::REPORT_MAX];
+        telemetry.send(TLM_MEMORY, report, memory.pack(report));
+    }
+    memory.setLevel(memoryTelemetry, telemetry.getUsed());  // Fullest just before draining
+    countSamples();
+    stats.setOverruns(telemetry.getDropped() + runtime.getTaskOverruns());
+    telemetry.drain();
 }
 
-// I2C receive event handler (for future use)
-void receiveEvent(int howMany) {
-    (void)howMany;  // Avoid compiler warning
+// Task, every SPO2_SAMPLE_PERIOD_MS: feed the estimator with the latest
+// red/IR values, start the next scanner round and publish the result
+void samplePlethysmogram() {
+    const bool connected = spo2Sensor.isConnected();
+    if (connected && !wasConnected) estimator.begin(rates.getRate(SPO2_RATE_CHANNEL));  // New probe or new finger
+    wasConnected = connected;
+    heartBeat.showCode(connected ? 0 : 1);  // No-op unless the state changed
 
-    while (Wire.available() > 1) {
-        char c = Wire.read();
-        if (TESTING) Serial.print(c);
+    if (connected) {
+        estimator.process(adcScanner.getValue(ADC_CHANNEL_RED), adcScanner.getValue(ADC_CHANNEL_IR));
+        sampleMicros = roundMicros;  // The values are from the round started one period ago
+    }
+    roundMicros = micros();
+    if (!adcScanner.isWatching()) adcScanner.start();  // No probe: the window monitor has the ADC
+    if (--samplesToPublish > 0) return;
+    samplesToPublish = publishEvery;
+    publishRegisters();
+}
+
+// Called by the runtime in loop() context when the hub writes RATES: the
+// task period follows from its next release, the estimator settles again
+uint16_t changeRate(uint8_t channel, uint16_t rateHz, uint8_t decimation) {
+    if (channel != SPO2_RATE_CHANNEL) return 0;
+    const uint32_t periodMs = (1000UL + rateHz / 2) / rateHz;
+    if (!runtime.setTaskPeriod(plethTask, periodMs)) return 0;
+    const uint16_t rate = (uint16_t)(1000UL / periodMs);
+    estimator.begin(rate);
+    publishEvery = decimation;
+    samplesToPublish = decimation;
+    if (TESTING) {
+        TRACE(trace, "Plethysmogram %u Hz, published 1 in %u", rate, decimation);
     }
-    if (Wire.available()) {
-        int x = Wire.read();
-        if (TESTING) Serial.println(x);
+    return rate;
+}
+
+// The probe was plugged in or pulled out: one event per change, after the
+// status that goes with it is published
+void postProbeChange() {
+    const bool connected = spo2Sensor.isConnected();
+    if (connected == probeConnected) return;
+    probeConnected = connected;
+    events.post(ModuleEvents::PROBE, connected ? 1 : 0);
+    if (TESTING) {
+        TRACE(trace, "Probe %s", connected ? "connected" : "disconnected");
     }
 }
 
-// I2C request event handler
-// Sends 4 bytes: [status, rawHigh, rawLow, ledState]
-void requestEvent() {
-    uint8_t response[NUM_RESPONSE_BYTES];
+// Conversions since the last call: every completed scanner round, whoever started it
+void countSamples() {
+    const uint32_t rounds = adcScanner.getScanCount();
+    stats.addSamples((uint16_t)((rounds - countedRounds) * adcScanner.getChannelCount()));
+    countedRounds = rounds;
+}
 
+// Pack [status, rawHigh, rawLow, ledState]
+void packResponse(uint8_t* response) {
     response[0] = spo2Sensor.getStatusByte();           // 1 = connected, 0 = disconnected
     response[1] = spo2Sensor.getHighByte();             // Raw ADC high byte
     response[2] = spo2Sensor.getLowByte();              // Raw ADC low byte
     response[3] = spo2Sensor.isLedOn() ? 1 : 0;         // LED state
+}
+
+// Apply register writes from the master outside the interrupt
+// Returns true if anything changed
+bool applyWrites() {
+    bool changed = false;
+    if (pendingLed >= 0) {
+        spo2Sensor.setLed(pendingLed != 0);
+        pendingLed = -1;
+        changed = true;
+    }
+    if (pendingThreshold >= 0) {
+        spo2Sensor.setThreshold((uint16_t)pendingThreshold);
+        pendingThreshold = -1;
+        changed = true;
+    }
+    return changed;
+}
+
+// Update the shadow registers and make them visible to the master at once
+void publishRegisters() {
+    registers.set8(REG_STATUS, spo2Sensor.getStatusByte());
+    registers.set16(REG_RAW, spo2Sensor.getRawValue());
+    registers.set8(REG_LED, spo2Sensor.isLedOn() ? 1 : 0);
+    registers.set16(REG_THRESHOLD, spo2Sensor.getThreshold());
+    const bool connected = spo2Sensor.isConnected();
+    registers.set16(REG_SPO2, connected ? estimator.getSpO2() : 0);
+    registers.set16(REG_PULSE_RATE, connected ? estimator.getPulseRate() : 0);
+    registers.set16(REG_PERFUSION, estimator.getPerfusionIndex());
+    registers.set16(REG_RATIO, estimator.getRatio());
+    registers.set8(REG_QUALITY, connected ? estimator.getQuality() : 0);
+    registers.set8(REG_BEAT_COUNT, estimator.getBeatCount());
+    registers.set32(REG_SAMPLE_TIME, timeSync.toHub(sampleMicros));
+    registers.set8(REG_SYNC_STATE, timeSync.getState());
+    registers.publish();
+}
+
+// Runs in the I2C interrupt: only record the write, loop() applies it
+void writeRegister(uint8_t reg, uint8_t value) {
+    switch (reg) {
+        case REG_LED:
+            pendingLed = value;
+            break;
+        case REG_THRESHOLD:
+            thresholdHigh = value;
+            break;
+        case REG_THRESHOLD + 1:
+            pendingThreshold = ((uint16_t)thresholdHigh << 8) | value;
+            break;
+        default:
+            break;  // Read-only register
+    }
+}
 
-    Wire.write(response, NUM_RESPONSE_BYTES);
+// Runs in the I2C interrupt: MEMORY is served live from the monitor's counters;
+// the runtime serves RUNTIME and EVENTS
+bool readRegister(uint8_t reg) {
+    heartBeat.flash();  // Bus activity
+    if (reg != REG_MEMORY) return false;
+    uint8_t report[MemoryMonitor::REPORT_MAX];
+    Wire.write(report, memory.pack(report));
+    return true;
 }
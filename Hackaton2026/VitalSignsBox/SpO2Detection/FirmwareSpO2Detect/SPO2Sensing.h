@@ -7,30 +7,29 @@
     for HAN ESE / WKZ Hackaton Challenge 2026
 
     V1.0 Jan 2026
+    V1.1 Oct 2026 - Report as a deferred-format trace record (TraceLog)
 */
 
 #ifndef SPO2_SENSING_H
 #define SPO2_SENSING_H
 
 #include "SPO2Sensor.h"
+#include "TraceLog.h"
 
 // Pin definitions
 #define SENSOR_SPO2 A2  // SPO2_CONNECTION_A2
 
-// External reference to sensor instance (defined in main .ino)
+// External references to the sensor and trace instances (defined in main .ino)
 extern SPO2Sensor spo2Sensor;
+extern TraceLog trace;
 
 /**
- * Read and report SpO2 sensor connection status via Serial
+ * Report SpO2 sensor connection status as a trace record
+ * (10 bytes on the wire; the text is added by tracelog.py on the host)
  */
 void readAndReportSpO2Status() {
-    Serial.print("SpO2 Sensor: ");
-    Serial.print(spo2Sensor.isConnected() ? "CONNECTED" : "DISCONNECTED");
-    Serial.print(" (raw: ");
-    Serial.print(spo2Sensor.getRawValue());
-    Serial.print(", LED: ");
-    Serial.print(spo2Sensor.isLedOn() ? "ON" : "OFF");
-    Serial.println(")");
+    TRACE(trace, "SpO2 Sensor: connected=%u (raw: %u, LED: %u)",
+          spo2Sensor.isConnected(), spo2Sensor.getRawValue(), spo2Sensor.isLedOn());
 }
 
 #endif // SPO2_SENSING_H
@@ -8,29 +8,163 @@
 */
 
 #include "SPO2Sensor.h"
+#include "AdcScanner.h"
+
+#if defined(__SAMD21G18A__) || defined(__SAMD21J18A__) || defined(__SAMD21E18A__)
+#define SPO2_HW_AVERAGING 1
+#include "wiring_private.h"  // pinPeripheral()
+#else
+#define SPO2_HW_AVERAGING 0
+#endif
 
 SPO2Sensor::SPO2Sensor(uint8_t pin, uint8_t ledPin, uint16_t threshold)
-    : _pin(pin)
+    : _scanner(nullptr)
+    , _pin(pin)
     , _ledPin(ledPin)
     , _threshold(threshold)
+    , _hysteresis(SPO2_DEFAULT_HYSTERESIS)
     , _rawValue(0)
+    , _oversampling(SPO2_DEFAULT_OVERSAMPLING)
+    , _mode(DETECT_POLL)
     , _connected(false)
     , _ledState(false)
+    , _fastPollMs(SPO2_FAST_POLL_MS)
+    , _slowPollMs(SPO2_SLOW_POLL_MS)
+    , _stableMs(SPO2_STABLE_MS)
+    , _lastPoll(0)
+    , _lastChange(0)
+    , _changeCount(0)
 {
 }
 
+SPO2Sensor::SPO2Sensor(AdcScanner& scanner, uint8_t channel, uint8_t ledPin, uint16_t threshold)
+    : SPO2Sensor(channel, ledPin, threshold)
+{
+    _scanner = &scanner;
+}
+
 void SPO2Sensor::begin() {
-    pinMode(_pin, INPUT);
     pinMode(_ledPin, OUTPUT);
     digitalWrite(_ledPin, LOW);
-}
+    _lastPoll = millis();
+    _lastChange = _lastPoll;
+
+    // The scanner owns the pin; its first round may still be running, so
+    // start disconnected and let update() decide
+    if (_scanner) return;
 
-void SPO2Sensor::update() {
-    _rawValue = analogRead(_pin);
-    // Sensor connected when line is pulled low (below threshold)
+    pinMode(_pin, INPUT);
+#if SPO2_HW_AVERAGING
+    pinPeripheral(_pin, PIO_ANALOG);  // analogRead() does this on every call
+#endif
+
+    // Initial state from one reading, without hysteresis
+    _rawValue = readAveraged();
     _connected = (_rawValue < _threshold);
 }
 
+bool SPO2Sensor::update() {
+    if (useWindow()) return updateWindow();
+
+    const uint32_t now = millis();
+    const uint16_t interval = isStable() ? _slowPollMs : _fastPollMs;
+    if (now - _lastPoll < interval) return false;
+    if (_scanner && _scanner->getScanCount() == 0) return false;  // No result yet
+    _lastPoll = now;
+
+    _rawValue = readAveraged();
+    applyReading(now);
+    return true;
+}
+
+// Sensor connected when line is pulled low; the dead band in between keeps the state
+void SPO2Sensor::applyReading(uint32_t now) {
+    const int32_t low = (int32_t)_threshold - _hysteresis;
+    const int32_t high = (int32_t)_threshold + _hysteresis;
+    bool connected = _connected;
+    if (_rawValue < low) connected = true;
+    else if (_rawValue > high) connected = false;
+
+    if (connected != _connected) {
+        _connected = connected;
+        _lastChange = now;
+        _changeCount++;
+    }
+}
+
+bool SPO2Sensor::useWindow() const {
+    return _scanner && (_mode == DETECT_WINDOW || (_mode == DETECT_WINDOW_DISCONNECTED && !_connected));
+}
+
+// The ADC watches the pin; only a window exit (= a state change) costs work
+bool SPO2Sensor::updateWindow() {
+    if (!_scanner->pollWindow()) {
+        if (!_scanner->isWatching()) armWindow();  // After begin(), a poll phase or a start()
+        return false;
+    }
+
+    const uint32_t now = millis();
+    _lastPoll = now;
+    _rawValue = _scanner->getValue(_pin);
+    applyReading(now);
+
+    if (useWindow()) armWindow();
+    else _scanner->start();  // Connected in DETECT_WINDOW_DISCONNECTED: back to scanning
+    return true;
+}
+
+// Window around the current state: leaving it means crossing the far threshold
+void SPO2Sensor::armWindow() {
+    const int32_t low = (int32_t)_threshold - _hysteresis;
+    const int32_t high = (int32_t)_threshold + _hysteresis;
+    if (_connected) {
+        _scanner->watch(_pin, 0, high > 0xFFFF ? 0xFFFF : (uint16_t)high);  // Exit above high
+    } else {
+        _scanner->watch(_pin, low < 0 ? 0 : (uint16_t)low, 0xFFFF);          // Exit below low
+    }
+}
+
+// Average of 2^_oversampling samples, on the 10-bit analogRead() scale
+uint16_t SPO2Sensor::readAveraged() {
+    if (_scanner) {
+        // Result of the round started at the previous poll; start the next one
+        const uint16_t value = _scanner->getValue(_pin);
+        _scanner->start();
+        return value;
+    }
+
+#if SPO2_HW_AVERAGING
+    // One triggered conversion: the ADC accumulates, divides (ADJRES) and
+    // returns a 12-bit average, without one analogRead() setup per sample
+    while (ADC->STATUS.bit.SYNCBUSY);
+    const uint16_t ctrlb = ADC->CTRLB.reg;
+    ADC->INPUTCTRL.bit.MUXPOS = g_APinDescription[_pin].ulADCChannelNumber;
+    ADC->AVGCTRL.reg = ADC_AVGCTRL_SAMPLENUM(_oversampling) | ADC_AVGCTRL_ADJRES(_oversampling);
+    ADC->CTRLB.bit.RESSEL = _oversampling ? ADC_CTRLB_RESSEL_16BIT_Val : ADC_CTRLB_RESSEL_12BIT_Val;
+    while (ADC->STATUS.bit.SYNCBUSY);
+    ADC->CTRLA.bit.ENABLE = 1;
+    while (ADC->STATUS.bit.SYNCBUSY);
+
+    ADC->INTFLAG.reg = ADC_INTFLAG_RESRDY;
+    ADC->SWTRIG.bit.START = 1;
+    while (!ADC->INTFLAG.bit.RESRDY);
+    const uint16_t result = ADC->RESULT.reg;
+
+    // Leave the ADC as analogRead() expects it
+    ADC->CTRLA.bit.ENABLE = 0;
+    while (ADC->STATUS.bit.SYNCBUSY);
+    ADC->AVGCTRL.reg = ADC_AVGCTRL_SAMPLENUM_1 | ADC_AVGCTRL_ADJRES(0);
+    ADC->CTRLB.reg = ctrlb;
+    while (ADC->STATUS.bit.SYNCBUSY);
+    return result >> 2;
+#else
+    uint32_t sum = 0;
+    const uint8_t count = 1 << _oversampling;
+    for (uint8_t i = 0; i < count; i++) sum += analogRead(_pin);
+    return (uint16_t)(sum >> _oversampling);
+#endif
+}
+
 bool SPO2Sensor::isConnected() const {
     return _connected;
 }
@@ -53,12 +187,49 @@ uint8_t SPO2Sensor::getStatusByte() const {
 
 void SPO2Sensor::setThreshold(uint16_t threshold) {
     _threshold = threshold;
+    if (useWindow() && _scanner->isWatching()) armWindow();
 }
 
 uint16_t SPO2Sensor::getThreshold() const {
     return _threshold;
 }
 
+void SPO2Sensor::setHysteresis(uint16_t hysteresis) {
+    _hysteresis = hysteresis;
+    if (useWindow() && _scanner->isWatching()) armWindow();
+}
+
+uint16_t SPO2Sensor::getHysteresis() const {
+    return _hysteresis;
+}
+
+void SPO2Sensor::setOversampling(uint8_t log2Samples) {
+    _oversampling = log2Samples > 4 ? 4 : log2Samples;
+}
+
+void SPO2Sensor::setDetectionMode(DetectionMode mode) {
+    _mode = mode;
+    if (_scanner && !useWindow() && _scanner->isWatching()) _scanner->start();  // Back to polling
+}
+
+SPO2Sensor::DetectionMode SPO2Sensor::getDetectionMode() const {
+    return _mode;
+}
+
+void SPO2Sensor::setPollIntervals(uint16_t fastMs, uint16_t slowMs, uint16_t stableMs) {
+    _fastPollMs = fastMs;
+    _slowPollMs = slowMs;
+    _stableMs = stableMs;
+}
+
+bool SPO2Sensor::isStable() const {
+    return millis() - _lastChange >= _stableMs;
+}
+
+uint16_t SPO2Sensor::getChangeCount() const {
+    return _changeCount;
+}
+
 void SPO2Sensor::ledOn() {
     _ledState = true;
     digitalWrite(_ledPin, HIGH);
@@ -10,6 +10,16 @@
       When sensor is disconnected, the line reads high (3.3V).
     - RED LED output on SPO2_LED_D12 pin for sensor indication.
 
+    Detection uses an averaged reading (hardware ADC averaging on SAMD21) and
+    a Schmitt-style threshold pair, so noise near the threshold does not
+    toggle the state. Once the state has been stable for a while the pin is
+    polled less often.
+
+    On an AdcScanner channel the detection can also be left to the ADC
+    window monitor (setDetectionMode()): the ADC watches the line and
+    interrupts only when it crosses the far side of the dead band, so
+    update() costs one flag test until the connection state changes.
+
     Johan Korten
     for HAN ESE / WKZ Hackaton Challenge 2026
 */
@@ -19,12 +29,27 @@
 
 #include <Arduino.h>
 
+class AdcScanner;
+
 // Default pin definitions
 #define SPO2_CONNECTION_A2 A2
 #define SPO2_LED_D12 12
 
+// Detection defaults (10-bit ADC scale)
+#define SPO2_DEFAULT_HYSTERESIS 32     // Connect below threshold - 32, disconnect above threshold + 32
+#define SPO2_DEFAULT_OVERSAMPLING 3    // 2^3 = 8 samples per reading
+#define SPO2_FAST_POLL_MS 10           // While the state is changing
+#define SPO2_SLOW_POLL_MS 200          // Once the state is stable
+#define SPO2_STABLE_MS 2000            // No change for this long = stable
+
 class SPO2Sensor {
 public:
+    enum DetectionMode : uint8_t {
+        DETECT_POLL,                // Averaged reading every poll interval
+        DETECT_WINDOW,              // Window monitor in both states; the scanner only watches this pin
+        DETECT_WINDOW_DISCONNECTED  // Window monitor while disconnected, scanning (polls) while connected
+    };
+
     /**
      * Constructor
      * @param pin Analog pin for detection (default: A2)
@@ -33,6 +58,17 @@ public:
      */
     SPO2Sensor(uint8_t pin = SPO2_CONNECTION_A2, uint8_t ledPin = SPO2_LED_D12, uint16_t threshold = 512);
 
+    /**
+     * Constructor for a sensor that reads through an AdcScanner
+     * The scanner owns pin and averaging; run it in one-shot mode, update()
+     * takes the latest value and starts the next conversion round.
+     * @param scanner AdcScanner, begun before begin()
+     * @param channel Position of the detection pin in the scanner's pin list
+     * @param ledPin Digital pin for RED LED (default: D12)
+     * @param threshold ADC threshold for detection (default: 512)
+     */
+    SPO2Sensor(AdcScanner& scanner, uint8_t channel, uint8_t ledPin = SPO2_LED_D12, uint16_t threshold = 512);
+
     /**
      * Initialize the sensor detection pin and LED pin
      * Call this in setup()
@@ -41,9 +77,10 @@ public:
 
     /**
      * Update the sensor detection state
-     * Call this regularly in loop()
+     * Call this every loop(); only reads the ADC when a poll is due
+     * @return true if a new reading was taken
      */
-    void update();
+    bool update();
 
     /**
      * Check if SpO2 sensor is connected
@@ -87,6 +124,49 @@ public:
      */
     uint16_t getThreshold() const;
 
+    /**
+     * Set the hysteresis around the threshold
+     * Connected below threshold - hysteresis, disconnected above threshold + hysteresis
+     * @param hysteresis Half width of the dead band in ADC counts (0 = single threshold)
+     */
+    void setHysteresis(uint16_t hysteresis);
+    uint16_t getHysteresis() const;
+
+    /**
+     * Set the number of ADC samples averaged per reading
+     * Without effect with an AdcScanner (set in AdcScanner::begin())
+     * @param log2Samples 0 (single sample) .. 4 (16 samples)
+     */
+    void setOversampling(uint8_t log2Samples);
+
+    /**
+     * Set the poll intervals
+     * @param fastMs   Interval while the state is changing (0 = every update())
+     * @param slowMs   Interval once the state is stable
+     * @param stableMs No state change for this long switches to slowMs
+     */
+    void setPollIntervals(uint16_t fastMs, uint16_t slowMs, uint16_t stableMs);
+
+    /**
+     * Select how update() detects the connection (default DETECT_POLL)
+     * The window modes need the AdcScanner constructor; without a scanner
+     * the sensor keeps polling. While the window monitor watches the pin
+     * the scanner converts no other channel: do not call start() on it
+     * then (AdcScanner::isWatching()).
+     */
+    void setDetectionMode(DetectionMode mode);
+    DetectionMode getDetectionMode() const;
+
+    /**
+     * Check if the connection state has been stable for stableMs
+     */
+    bool isStable() const;
+
+    /**
+     * Number of connect/disconnect transitions since begin()
+     */
+    uint16_t getChangeCount() const;
+
     /**
      * Turn the RED LED on
      */
@@ -110,12 +190,29 @@ public:
     bool isLedOn() const;
 
 private:
-    uint8_t _pin;
+    uint16_t readAveraged();
+    void applyReading(uint32_t now);
+    bool useWindow() const;
+    bool updateWindow();
+    void armWindow();
+
+    AdcScanner* _scanner;
+    uint8_t _pin;             // Analog pin, or scanner channel
     uint8_t _ledPin;
     uint16_t _threshold;
+    uint16_t _hysteresis;
     uint16_t _rawValue;
+    uint8_t _oversampling;
+    DetectionMode _mode;
     bool _connected;
     bool _ledState;
+
+    uint16_t _fastPollMs;
+    uint16_t _slowPollMs;
+    uint16_t _stableMs;
+    uint32_t _lastPoll;
+    uint32_t _lastChange;
+    uint16_t _changeCount;
 };
 
 #endif // SPO2_SENSOR_H
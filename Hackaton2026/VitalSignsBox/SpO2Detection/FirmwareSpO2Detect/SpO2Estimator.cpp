@@ -0,0 +1,192 @@
+/*
+    SpO2Estimator.cpp
+
+    Streaming ratio-of-ratios SpO2 implementation
+*/
+
+#include "SpO2Estimator.h"
+#include <string.h>
+
+static const int32_t MIN_HYSTERESIS = 512;  // Half an ADC count in the moving sum
+
+// 94.845 + 30.354 R - 45.060 R^2 in 0.1 %, R = 0.30 .. 1.30 in steps of 0.05
+static const uint16_t DEFAULT_CALIBRATION[] = {
+    999, 999, 998, 994, 988, 979, 968, 955, 940, 923, 903,
+    881, 857, 830, 801, 770, 737, 702, 664, 624, 582
+};
+
+SpO2Estimator::SpO2Estimator() {
+    begin(100);
+}
+
+void SpO2Estimator::begin(uint16_t sampleRateHz) {
+    memset(this, 0, sizeof(*this));  // Plain data only
+
+    _rate = sampleRateHz == 0 ? 1 : sampleRateHz;
+    while ((1UL << (_dcShift + 1)) <= _rate * 13UL / 10UL) _dcShift++;
+    setCalibration(DEFAULT_CALIBRATION, sizeof(DEFAULT_CALIBRATION) / sizeof(DEFAULT_CALIBRATION[0]), 300, 50);
+}
+
+void SpO2Estimator::setCalibration(const uint16_t* spo2, uint8_t entries, uint16_t firstRatio, uint16_t ratioStep) {
+    if (entries < 2 || ratioStep == 0) return;
+    if (entries > MAX_CALIBRATION) entries = MAX_CALIBRATION;
+    memcpy(_calibration, spo2, entries * sizeof(uint16_t));
+    _calibrationEntries = entries;
+    _firstRatio = firstRatio;
+    _ratioStep = ratioStep;
+}
+
+// DC removal: returns the AC part in Q8 and tracks the AC extremes of the beat
+int32_t SpO2Estimator::track(Channel& channel, uint16_t value) {
+    const int32_t x = (int32_t)value << 16;
+    if (_samples == 1) channel.dc = x;  // Start at the first value instead of settling from 0
+    channel.dc += (x - channel.dc) >> _dcShift;
+
+    const int32_t ac = ((int32_t)value << 8) - (channel.dc >> 8);
+    if (ac > channel.acMax) channel.acMax = ac;
+    if (ac < channel.acMin) channel.acMin = ac;
+    return ac;
+}
+
+bool SpO2Estimator::process(uint16_t red, uint16_t ir) {
+    _samples++;
+    const int32_t redAc = track(_red, red);
+    const int32_t irAc = track(_ir, ir);
+
+    // Moving sum of 4 against high-frequency noise on the crossing
+    _irSum += irAc - _irSmooth[_smoothPos];
+    _irSmooth[_smoothPos] = irAc;
+    _smoothPos = (uint8_t)((_smoothPos + 1) & 3);
+
+    // No reading after 5 s without an accepted beat (probe off, heavy motion)
+    if (_samples - _lastAccepted > 5UL * _rate) {
+        _spo2 = 0;
+        _pulseRate = 0;
+        _periodCount = 0;
+        _periodPos = 0;
+    }
+
+    if (_samples < 2UL * _rate) return false;  // DC trackers settling
+
+    // Nothing turns any more (amplitude dropped): start over with the minimum hysteresis
+    if (_lastTrough != 0 && _samples - _lastTrough > 2UL * _rate) {
+        _lastTrough = 0;
+        _ppAverage = 0;
+    }
+
+    // A beat runs from trough to trough of the smoothed IR. A turn counts once
+    // the signal has moved back by a quarter of the amplitude, so baseline
+    // drift and small notches do not split a beat.
+    int32_t hysteresis = _ppAverage;  // Moving sum of 4: a quarter of the amplitude
+    if (hysteresis < MIN_HYSTERESIS) hysteresis = MIN_HYSTERESIS;
+    const uint8_t beatsBefore = _beatCount;
+    if (_rising) {
+        if (_irSum > _extreme) _extreme = _irSum;
+        if (_irSum < _extreme - hysteresis) {
+            _rising = false;
+            _extreme = _irSum;
+        }
+    } else {
+        if (_irSum < _extreme) _extreme = _irSum;
+        if (_irSum > _extreme + hysteresis) {
+            _rising = true;
+            _extreme = _irSum;
+            if (_lastTrough != 0) endBeat(_samples - _lastTrough);
+            _lastTrough = _samples;
+            _dcIrAtTrough = _ir.dc;
+            _red.acMax = _red.acMin = redAc;
+            _ir.acMax = _ir.acMin = irAc;
+        }
+    }
+    return _beatCount != beatsBefore;
+}
+
+void SpO2Estimator::endBeat(uint32_t period) {
+    const int32_t ppRed = _red.acMax - _red.acMin;
+    const int32_t ppIr = _ir.acMax - _ir.acMin;
+    const bool ok = accept(period, ppIr) && ppRed > 0;
+    _history = (uint8_t)((_history << 1) | (ok ? 1 : 0));
+    if (_historyCount < 8) _historyCount++;
+    if (!ok) {
+        _rejected++;
+        return;
+    }
+
+    // R = (ppRed / dcRed) / (ppIr / dcIr); AC and DC both Q8 (one division per beat)
+    const int32_t dcRed = _red.dc >> 8;
+    const int32_t dcIr = _ir.dc >> 8;
+    if (dcRed <= 0 || dcIr <= 0) return;
+    const uint32_t ratio = (uint32_t)(((uint64_t)ppRed * (uint64_t)dcIr * 1000U) / ((uint64_t)ppIr * (uint64_t)dcRed));
+    _ratio = (uint16_t)(ratio > 0xFFFF ? 0xFFFF : ratio);
+
+    const uint16_t spo2 = calibrate(ratio);
+    if (spo2 == 0) {  // Outside the calibration: not a plausible reading
+        _history &= (uint8_t)~1;
+        _rejected++;
+        return;
+    }
+    _perfusion = (uint16_t)(((uint32_t)ppIr * 10000U) / (uint32_t)dcIr);
+    _lastAccepted = _samples;
+    _beatCount++;
+
+    // Right after artifacts the accepted beats may be motion too: hold the reading
+    if (getQuality() < 75) return;
+
+    _spo2 = _spo2 == 0 ? spo2 : (uint16_t)(_spo2 + (((int32_t)spo2 - _spo2) >> 2));
+
+    _periods[_periodPos] = (uint16_t)period;
+    _periodPos = (uint8_t)((_periodPos + 1) % RATE_AVERAGE);
+    if (_periodCount < RATE_AVERAGE) _periodCount++;
+    uint32_t sum = 0;
+    for (uint8_t i = 0; i < _periodCount; i++) sum += _periods[i];
+    _pulseRate = (uint16_t)((600UL * _rate * _periodCount + sum / 2) / sum);
+}
+
+// Motion artifacts: implausible period, amplitude jump or a moving DC level
+bool SpO2Estimator::accept(uint32_t period, int32_t ppIr) {
+    const bool periodOk = period >= _rate / 4U && period <= 2UL * _rate;  // 30-240 bpm
+
+    const int32_t dcMove = _ir.dc - _dcIrAtTrough;
+    const bool dcOk = (dcMove < 0 ? -dcMove : dcMove) <= (_ir.dc >> 4);  // Within 6 %
+
+    bool amplitudeOk = true;
+    if (_ppAverage != 0) {
+        amplitudeOk = ppIr >= _ppAverage / 2 && ppIr <= _ppAverage * 2;
+    }
+
+    if (periodOk && dcOk && amplitudeOk && ppIr > 0) {
+        _ppAverage = _ppAverage == 0 ? ppIr : _ppAverage + ((ppIr - _ppAverage) >> 2);
+        _misses = 0;
+        return true;
+    }
+
+    // A lasting change of amplitude (probe moved, gain changed) is not motion: relearn it
+    if (++_misses >= 6) {
+        _ppAverage = 0;
+        _misses = 0;
+    }
+    return false;
+}
+
+// Linear interpolation in the table; 0 outside it
+uint16_t SpO2Estimator::calibrate(uint32_t ratio) const {
+    const uint32_t last = _firstRatio + (uint32_t)_ratioStep * (_calibrationEntries - 1);
+    if (ratio < _firstRatio || ratio > last) return 0;
+
+    const uint32_t offset = ratio - _firstRatio;
+    const uint8_t index = (uint8_t)(offset / _ratioStep);
+    if (index >= _calibrationEntries - 1) return _calibration[_calibrationEntries - 1];
+    const int32_t fraction = (int32_t)(offset - (uint32_t)index * _ratioStep);
+    const int32_t from = _calibration[index];
+    const int32_t to = _calibration[index + 1];
+    return (uint16_t)(from + ((to - from) * fraction) / (int32_t)_ratioStep);
+}
+
+uint8_t SpO2Estimator::getQuality() const {
+    if (_historyCount == 0) return 0;
+    uint8_t accepted = 0;
+    for (uint8_t i = 0; i < _historyCount; i++) {
+        if (_history & (1 << i)) accepted++;
+    }
+    return (uint8_t)((accepted * 100U) / _historyCount);
+}
@@ -0,0 +1,124 @@
+/*
+    SpO2Estimator.h
+
+    Streaming SpO2 and pulse rate from the red and infrared photoplethysmogram
+
+    Per sample, integer arithmetic only: the DC level of each channel is
+    tracked with a first-order IIR, the AC part is smoothed and the IR AC
+    troughs (with hysteresis) split the signal into beats. Per beat
+    the peak-to-peak AC of both channels gives the ratio of ratios
+
+        R = (AC red / DC red) / (AC IR / DC IR)
+
+    which a calibration table maps to SpO2. Beats with an implausible
+    period, a jump in amplitude or a moving DC level (motion) are rejected
+    and lower the quality figure instead of the reading.
+*/
+
+#ifndef SPO2_ESTIMATOR_H
+#define SPO2_ESTIMATOR_H
+
+#include <stdint.h>
+
+class SpO2Estimator {
+public:
+    static const uint8_t MAX_CALIBRATION = 32;  // Table entries
+    static const uint8_t RATE_AVERAGE = 4;      // Beats in the pulse rate average
+
+    SpO2Estimator();
+
+    /**
+     * Reset; the first 2 s settle the DC trackers
+     * @param sampleRateHz Samples per second per channel (e.g. 100)
+     */
+    void begin(uint16_t sampleRateHz);
+
+    /**
+     * Process one sample pair, at the rate given to begin()
+     * @param red Red channel (ADC counts)
+     * @param ir  Infrared channel (ADC counts)
+     * @return true if a beat was accepted with this sample
+     */
+    bool process(uint16_t red, uint16_t ir);
+
+    /**
+     * Replace the R -> SpO2 calibration (default: the common quadratic fit
+     * 94.845 + 30.354 R - 45.060 R^2 for R = 0.30..1.30)
+     * @param spo2 SpO2 in 0.1 % per table entry, for decreasing saturation
+     * @param entries Number of entries (2..MAX_CALIBRATION)
+     * @param firstRatio R x 1000 of the first entry
+     * @param ratioStep R x 1000 between entries
+     */
+    void setCalibration(const uint16_t* spo2, uint8_t entries, uint16_t firstRatio, uint16_t ratioStep);
+
+    // SpO2 in 0.1 %, 0 = no reading
+    uint16_t getSpO2() const { return _spo2; }
+
+    // Pulse rate in 0.1 bpm, 0 = no reading
+    uint16_t getPulseRate() const { return _pulseRate; }
+
+    // IR perfusion index (AC / DC) in 0.01 % of the last accepted beat
+    uint16_t getPerfusionIndex() const { return _perfusion; }
+
+    // Ratio of ratios x 1000 of the last beat
+    uint16_t getRatio() const { return _ratio; }
+
+    // Accepted beats among the last 8, in %
+    uint8_t getQuality() const;
+
+    // +1 per accepted beat, wraps
+    uint8_t getBeatCount() const { return _beatCount; }
+
+    // Beats rejected as artifacts since begin()
+    uint16_t getRejected() const { return _rejected; }
+
+private:
+    struct Channel {
+        int32_t dc;     // Q16 ADC counts
+        int32_t acMax;  // Q8, this beat
+        int32_t acMin;
+    };
+
+    int32_t track(Channel& channel, uint16_t value);
+    void endBeat(uint32_t period);
+    bool accept(uint32_t period, int32_t ppIr);
+    uint16_t calibrate(uint32_t ratio) const;
+
+    uint16_t _rate;
+    uint8_t _dcShift;  // IIR time constant 2^_dcShift samples, about 1.3 s
+    uint32_t _samples;
+
+    Channel _red;
+    Channel _ir;
+    int32_t _irSmooth[4];  // Last IR AC values, for a 4-sample moving sum
+    uint8_t _smoothPos;
+    int32_t _irSum;
+    bool _rising;
+    int32_t _extreme;      // Highest (rising) or lowest (falling) moving sum since the last turn
+    uint32_t _lastTrough;  // Sample of the last trough, 0 = none
+    int32_t _dcIrAtTrough;
+
+    int32_t _ppAverage;   // IR peak-to-peak of accepted beats, Q8
+    uint8_t _misses;      // Consecutive rejected beats
+    uint8_t _history;     // Bit per beat, 1 = accepted
+    uint8_t _historyCount;
+    uint32_t _lastAccepted;
+
+    uint16_t _periods[RATE_AVERAGE];
+    uint8_t _periodCount;
+    uint8_t _periodPos;
+
+    uint16_t _calibration[MAX_CALIBRATION];
+    uint8_t _calibrationEntries;
+    uint16_t _firstRatio;
+    uint16_t _ratioStep;
+
+    uint16_t _spo2;
+    uint16_t _pulseRate;
+    uint16_t _perfusion;
+    uint16_t _ratio;
+    uint8_t _beatCount;
+    uint16_t _rejected;
+};
+
+#endif // SPO2_ESTIMATOR_H
@@ -9,12 +9,37 @@
     For your convenience we implemented:
     - Reading both channels of the MCP3426 (CH1+ and CH2+). This detects if a temperature sensor is connected.
     - Very basic implementation just as proof of concept. (ToDo: serious refactoring ;)).
+    - V1.1: MCP3426 driver class, non-blocking: polls RDY instead of delay(), both buses convert in parallel.
+    - V1.2: WireSupervisor per bus: a stuck bus is cleared, a missing ADC backs off.
+    - V1.3: Results in integer microvolts, float only for printing.
+    - V1.4: Temperature per channel from a probe table, converted at the ADC rate.
+    - V1.5: RuntimeStats: loop rate, longest pass, samples per second and bus errors in the report.
+    - V1.6: TemperatureFusion: CH1 of both buses (and CH2) as redundant probes, one fused temperature
+            per channel with a noise estimate per probe and a fault when they disagree.
+    - V1.7: BootSequencer: serial port and both ADCs start in parallel, setup() waits for the
+            slowest of them instead of three fixed delays, and reports what did not boot.
+    - V1.8: Both sensor buses at 400 kHz: the supervisors run each bus at the fastest clock
+            its devices tolerate (the MCP3426 registers Fm), a 4x shorter transaction.
+    - V1.9: TemperatureAcquisition: both ADCs convert continuously, round-robin over CH1/CH2,
+            latest values per channel. Served to the hub as an I2C register map (address 0x2C
+            on Wire), so a hub read never waits for a conversion.
+    - V1.10: on the common module runtime (ModuleRuntime): the serial report as a 1 s
+             CyclicExecutive task, the RUNTIME block served by the runtime
 
 */
 
 #include <Wire.h>
 #include "WireScanner.h"
 #include "TwiPinHelper.h"
+#include "WireSupervisor.h"
+#include "MCP3426.h"
+#include "TemperatureProbe.h"
+#include "TemperatureFusion.h"
+#include "TemperatureAcquisition.h"
+#include "RuntimeStats.h"
+#include "BootSequencer.h"
+#include "I2CRegisterSlave.h"
+#include "ModuleRuntime.h"
 
 // I2C System Bus Configuration
 #define W1_SCL 39  // PA13
@@ -22,13 +47,17 @@
 #define W2_SCL 13  // PA17
 #define W2_SDA 11  // PA16
 
-// Pin Setup for I2C Ports
-TwiPinPair portSensorsA(W1_SCL, W1_SDA);
-TwiPinPair portSensorsB(W2_SCL, W2_SDA);
+// Pin Setup for I2C Ports (SDA first: the supervisor clocks SCL)
+TwiPinPair portSensorsA(W1_SDA, W1_SCL, TWI_MUX_SERCOM_ALT);
+TwiPinPair portSensorsB(W2_SDA, W2_SCL, TWI_MUX_SERCOM);
 
 TwoWire WireSensorA(&sercom1, W1_SDA, W1_SCL);  // Sensor A
 TwoWire WireSensorB(&sercom4, W2_SDA, W2_SCL);  // Sensor B
 
+// One bad sensor must not hang or slow down the other bus
+WireSupervisor busSensorA(&WireSensorA, portSensorsA, WIRE_CLOCK_FAST);  // Pull-ups sized for Fm
+WireSupervisor busSensorB(&WireSensorB, portSensorsB, WIRE_CLOCK_FAST);
+
 #define LED_HB 14  // Heartbeat LED
 
 // MCP3426A0 Default Address (A0 connected to GND)
@@ -38,72 +67,267 @@ TwoWire WireSensorB(&sercom4, W2_SDA, W2_SCL);  // Sensor B
 WireScanner scannerSensorA(&WireSensorA, "Sensors A");
 WireScanner scannerSensorB(&WireSensorB, "Sensors B");
 
-// Function to Read MCP3426 Channel
-float readMCP3426Channel(TwoWire* wire, uint8_t channel) {
-  uint8_t configByte = 0x10;  // Start single-shot conversion, 16-bit resolution
-  configByte |= (channel << 5);  // Set Channel (0: CH1+, 1: CH2+)
-  configByte |= 0x00;  // Gain x1
-  
-  wire->beginTransmission(MCP3426_ADDR);
-  wire->write(configByte);
-  wire->endTransmission();
-  delay(100);  // Wait for conversion (16-bit mode needs ~100ms)
-
-  wire->requestFrom(MCP3426_ADDR, (uint8_t)3);  // 3 bytes: 2 data + 1 config
-  if (wire->available() == 3) {
-    uint16_t data = (wire->read() << 8) | wire->read();  // Combine two bytes
-    wire->read();  // Read the config byte (not used here)
-
-    if (data & 0x8000) {  // Check for negative value
-      data = ~data + 1;
-      return -((float)data / 32768.0 * 2.048);  // Scale for ±2.048V
-    }
-    return (float)data / 32768.0 * 2.048;  // Scale for 16-bit ADC
-  }
-  return NAN;  // Return Not-a-Number if read failed
+// Non-blocking ADC drivers, one per bus: both convert at the same time
+MCP3426 adcSensorA(&WireSensorA, MCP3426_ADDR);
+MCP3426 adcSensorB(&WireSensorB, MCP3426_ADDR);
+
+// Probe type per channel (CH1, CH2); PROBE_NONE for an unused input
+TemperatureProbe probesA[MCP3426::NUM_CHANNELS] = { TemperatureProbe(PROBE_NTC_10K), TemperatureProbe(PROBE_NTC_10K) };
+TemperatureProbe probesB[MCP3426::NUM_CHANNELS] = { TemperatureProbe(PROBE_NTC_10K), TemperatureProbe(PROBE_NTC_10K) };
+
+// Both ADCs converting all the time; latest values per input, and channel n
+// of bus A and of bus B fused as redundant probes of the same site
+TemperatureAcquisition acquisition(adcSensorA, probesA, adcSensorB, probesB);
+#define INPUT_A1 0
+#define INPUT_A2 1
+#define INPUT_B1 2
+#define INPUT_B2 3
+#define FUSION_PROBE_A TemperatureAcquisition::FUSION_PROBE_A
+#define FUSION_PROBE_B TemperatureAcquisition::FUSION_PROBE_B
+
+// I2C slave to the hub, on Wire (SERCOM3): the sensor buses stay masters
+#define TEMP_MODULE_ADDR 0x2C
+
+// I2C register map (byte addresses, multi-byte values big endian), as on the
+// ECG and SpO2 modules: write a register pointer, then read with
+// auto-increment. Temperatures in 0.01 C, 0x8000 = no probe.
+#define REG_PROBES        0x00  // 8 bit, bit n = input n has a probe (A1, A2, B1, B2)
+#define REG_SEQUENCE      0x01  // 8 bit, +1 per published result
+#define REG_TEMP_A1       0x02  // 16 bit, signed
+#define REG_TEMP_A2       0x04  // 16 bit
+#define REG_TEMP_B1       0x06  // 16 bit
+#define REG_TEMP_B2       0x08  // 16 bit
+#define REG_FUSED_1       0x0A  // 16 bit, CH1 of A and B fused
+#define REG_FUSED_2       0x0C  // 16 bit, CH2 fused
+#define REG_UNCERTAINTY_1 0x0E  // 16 bit, one sigma of FUSED_1
+#define REG_UNCERTAINTY_2 0x10  // 16 bit
+#define REG_FUSION_1      0x12  // 8 bit, TemperatureFusion::Status of CH1
+#define REG_FUSION_2      0x13  // 8 bit
+#define REG_SAMPLE_COUNT  0x14  // 32 bit, conversions since boot, all inputs
+#define REG_SAMPLE_AGE    0x18  // 16 bit, ms from the latest conversion to the publish, 0xFFFF = none
+#define REG_BUS_ERRORS    0x1A  // 16 bit, failed ADC transactions, both buses
+#define REG_RECOVERIES    0x1C  // 16 bit, bus recoveries, both buses
+#define TEMP_REGISTER_COUNT 0x1E
+#define REG_MICROVOLTS    0x20  // 16 bytes: A1, A2, B1, B2 in uV (32 bit signed), served live
+#define REG_RUNTIME       MODULE_REG_RUNTIME  // 0x24, 36 bytes: load counters, served by ModuleRuntime
+
+I2CRegisterSlave registers(&Wire, TEMP_REGISTER_COUNT);
+uint8_t publishSequence = 0;
+
+#define REPORT_INTERVAL 1000  // ms between serial reports
+
+// Same counters as the ECG and SpO2 modules: in the RUNTIME register and the report
+RuntimeStats stats;
+ModuleRuntime runtime(registers, stats);
+
+// Boot: the ADCs take their first command well within a millisecond of
+// power-on; the USB host may take a while to open the port, or never do
+#define SERIAL_WAIT_MS 1500
+#define MCP3426_POWER_UP_MS 1
+
+int16_t serialStep(uint8_t step, void* context) {
+  (void)step;
+  (void)context;
+  return Serial ? BootDevice::DONE : BootDevice::RETRY;
+}
+
+BootSequencer boot;
+CallbackBootDevice serialBoot(serialStep);
+I2CBootDevice adcBootA(WireSensorA, MCP3426_ADDR, nullptr, 0, MCP3426_POWER_UP_MS);
+I2CBootDevice adcBootB(WireSensorB, MCP3426_ADDR, nullptr, 0, MCP3426_POWER_UP_MS);
+int8_t adcBootIdA, adcBootIdB;
+
+void printBootState(const char* label, int8_t id) {
+  Serial.print(label);
+  Serial.print(boot.isReady(id) ? ": ready after " : ": not found after ");
+  Serial.print(boot.getDoneMs(id));
+  Serial.println(" ms");
 }
 
 void setup() {
-  delay(1500);
   Serial.begin(115200);
-  delay(1500);
 
-  // Start I2C ports
-  WireSensorA.begin();
-  WireSensorB.begin();
-
-  portSensorsA.setPinPeripheralAltStates();
-  portSensorsB.setPinPeripheralStates();
+  // Start I2C ports (begin, pin mux, clear a stuck bus)
+  busSensorA.begin();
+  busSensorB.begin();
 
   pinMode(LED_HB, OUTPUT);
   digitalWrite(LED_HB, LOW);
 
+  // 16-bit, one-shot, CH1+ and CH2+ in turn (use RES_12BIT for 240 SPS;
+  // with the fusion, RES_14BIT at 60 SPS gives about the same fused noise)
+  acquisition.begin(MCP3426::RES_16BIT, 0x03);
+  adcSensorA.attach(&busSensorA);
+  adcSensorB.attach(&busSensorB);
+
+  // A missing ADC is reported, not waited for: the supervisor backs off
+  // and picks it up once it answers
+  boot.add(&serialBoot, -1, SERIAL_WAIT_MS);
+  adcBootIdA = boot.add(&adcBootA);
+  adcBootIdB = boot.add(&adcBootB);
+  boot.run();
+
   Serial.println("MCP3426 Dual Sensor Reader Ready...");
-  delay(1500);
+  printBootState("Sensors A", adcBootIdA);
+  printBootState("Sensors B", adcBootIdB);
+
+  // Hub link: the register map is served from the last publish
+  runtime.onRead(readRegister);
+  runtime.addTask("report", printReport, REPORT_INTERVAL);
+  publishRegisters();
+  runtime.begin(TEMP_MODULE_ADDR);
+}
+
+void printCentiCelsius(int16_t centiCelsius) {
+  if (centiCelsius < 0) {
+    Serial.print('-');
+    centiCelsius = -centiCelsius;
+  }
+  Serial.print(centiCelsius / 100);
+  Serial.print('.');
+  if (centiCelsius % 100 < 10) Serial.print('0');
+  Serial.print(centiCelsius % 100);
+}
+
+// Float only here, for display
+void printChannel(const char* label, int32_t microvolts, int16_t centiCelsius) {
+  Serial.print(label);
+  if (microvolts == MCP3426::NO_VALUE) {
+    Serial.println("-");
+    return;
+  }
+  Serial.print(MCP3426::toVolts(microvolts), 4);
+  Serial.print(" V  ");
+  if (centiCelsius == TemperatureProbe::NO_TEMPERATURE) {
+    Serial.println("no probe");
+    return;
+  }
+  printCentiCelsius(centiCelsius);
+  Serial.println(" C");
+}
+
+// Fused value, its one sigma, the noise of each probe and any fault
+void printFused(const char* label, const TemperatureFusion& fused) {
+  Serial.print(label);
+  const int16_t centiCelsius = fused.getTemperature();
+  if (centiCelsius == TemperatureProbe::NO_TEMPERATURE) {
+    Serial.println("no probe");
+    return;
+  }
+  printCentiCelsius(centiCelsius);
+  Serial.print(" C  +-");
+  printCentiCelsius(fused.getUncertainty());
+  Serial.print("  noise A/B ");
+  printCentiCelsius(fused.getNoise(FUSION_PROBE_A));
+  Serial.print(" / ");
+  printCentiCelsius(fused.getNoise(FUSION_PROBE_B));
+  const uint8_t status = fused.getStatus();
+  if (status & TemperatureFusion::FUSION_DISAGREE) Serial.print("  DISAGREE");
+  if (status & TemperatureFusion::FUSION_PROBE0_REJECTED) Serial.print("  A rejected");
+  if (status & TemperatureFusion::FUSION_PROBE1_REJECTED) Serial.print("  B rejected");
+  Serial.println();
+}
+
+uint16_t clamp16(uint32_t value) {
+  return value > 0xFFFF ? 0xFFFF : (uint16_t)value;
+}
+
+// Latest values of every input into the shadow registers, visible to the
+// hub at once
+void publishRegisters() {
+  registers.set8(REG_PROBES, acquisition.getProbeMask());
+  registers.set8(REG_SEQUENCE, publishSequence++);
+  for (uint8_t input = 0; input < TemperatureAcquisition::NUM_INPUTS; input++) {
+    registers.set16(REG_TEMP_A1 + 2 * input, (uint16_t)acquisition.getTemperature(input));
+  }
+  for (uint8_t ch = 0; ch < MCP3426::NUM_CHANNELS; ch++) {
+    const TemperatureFusion& fused = acquisition.getFusion(ch);
+    registers.set16(REG_FUSED_1 + 2 * ch, (uint16_t)fused.getTemperature());
+    registers.set16(REG_UNCERTAINTY_1 + 2 * ch, fused.getUncertainty());
+    registers.set8(REG_FUSION_1 + ch, fused.getStatus());
+  }
+  registers.set32(REG_SAMPLE_COUNT, acquisition.getSampleCount());
+  registers.set16(REG_SAMPLE_AGE, acquisition.getSampleCount() == 0
+                                    ? 0xFFFF : clamp16(millis() - acquisition.getLastSampleMs()));
+  registers.set16(REG_BUS_ERRORS, clamp16(acquisition.getErrorCount()));
+  registers.set16(REG_RECOVERIES, clamp16(busSensorA.getRecoveryCount() + busSensorB.getRecoveryCount()));
+  registers.publish();
+}
+
+// Runs in the I2C interrupt: MICROVOLTS from the latest results (each value
+// is one 32-bit word, read atomically); the runtime serves RUNTIME
+bool readRegister(uint8_t reg) {
+  if (reg == REG_MICROVOLTS) {
+    uint8_t report[4 * TemperatureAcquisition::NUM_INPUTS];
+    for (uint8_t input = 0; input < TemperatureAcquisition::NUM_INPUTS; input++) {
+      const uint32_t value = (uint32_t)acquisition.getMicrovolts(input);
+      report[4 * input] = value >> 24;
+      report[4 * input + 1] = value >> 16;
+      report[4 * input + 2] = value >> 8;
+      report[4 * input + 3] = value;
+    }
+    Wire.write(report, sizeof(report));
+    return true;
+  }
+  return false;
+}
+
+uint8_t countBits(uint8_t mask) {
+  uint8_t count = 0;
+  for (; mask; mask &= mask - 1) count++;
+  return count;
 }
 
 void loop() {
-  digitalWrite(LED_HB, HIGH);
+  runtime.run();
 
-  // Read CH1+ and CH2+ on Sensor A
-  float sensorA_CH1 = readMCP3426Channel(&WireSensorA, 0);  // Channel 1
-  float sensorA_CH2 = readMCP3426Channel(&WireSensorA, 1);  // Channel 2
+  // Never blocks: picks up finished conversions and sets up the next channel.
+  // The ADCs set the sample rate; temperatures and fusion follow every new
+  // result, the hub sees it at once
+  const uint8_t updated = acquisition.update();
+  if (updated) {
+    stats.addSamples(countBits(updated));
+    publishRegisters();
+  }
+  stats.setOverruns(runtime.getTaskOverruns());
+}
 
-  // Read CH1+ and CH2+ on Sensor B
-  float sensorB_CH1 = readMCP3426Channel(&WireSensorB, 0);  // Channel 1
-  float sensorB_CH2 = readMCP3426Channel(&WireSensorB, 1);  // Channel 2
+// Task, every REPORT_INTERVAL
+void printReport() {
+  digitalWrite(LED_HB, HIGH);
 
   // Print results
   Serial.println("Sensor A:");
-  Serial.print("  CH1+ Voltage: "); Serial.println(sensorA_CH1, 4);
-  Serial.print("  CH2+ Voltage: "); Serial.println(sensorA_CH2, 4);
+  printChannel("  CH1+: ", acquisition.getMicrovolts(INPUT_A1), acquisition.getTemperature(INPUT_A1));
+  printChannel("  CH2+: ", acquisition.getMicrovolts(INPUT_A2), acquisition.getTemperature(INPUT_A2));
 
   Serial.println("Sensor B:");
-  Serial.print("  CH1+ Voltage: "); Serial.println(sensorB_CH1, 4);
-  Serial.print("  CH2+ Voltage: "); Serial.println(sensorB_CH2, 4);
+  printChannel("  CH1+: ", acquisition.getMicrovolts(INPUT_B1), acquisition.getTemperature(INPUT_B1));
+  printChannel("  CH2+: ", acquisition.getMicrovolts(INPUT_B2), acquisition.getTemperature(INPUT_B2));
+
+  Serial.println("Fused A+B:");
+  printFused("  CH1+: ", acquisition.getFusion(0));
+  printFused("  CH2+: ", acquisition.getFusion(1));
+
+  Serial.print("Bus recoveries A/B: ");
+  Serial.print(busSensorA.getRecoveryCount());
+  Serial.print(" / ");
+  Serial.println(busSensorB.getRecoveryCount());
+
+  stats.setBusErrors(acquisition.getErrorCount());
+  const RuntimeReport& report = stats.getReport();
+  Serial.print("Loop: ");
+  Serial.print(report.loopRate);
+  Serial.print(" /s, max ");
+  Serial.print(report.loopMaxUs);
+  Serial.print(" us (ever ");
+  Serial.print(report.loopMaxEverUs);
+  Serial.print(" us)  Samples: ");
+  Serial.print(report.sampleRate);
+  Serial.print(" /s  Bus errors: ");
+  Serial.println(report.busErrors);
 
   Serial.println("-------------------------------------");
 
   digitalWrite(LED_HB, LOW);
-  delay(1000);  // 1-second delay between reads
 }
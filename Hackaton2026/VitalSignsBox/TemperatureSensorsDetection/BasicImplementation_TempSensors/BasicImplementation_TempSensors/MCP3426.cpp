@@ -0,0 +1,174 @@
+/*
+    MCP3426.cpp
+
+    Non-blocking driver for the MCP3426 16-bit delta-sigma ADC
+*/
+
+#include "MCP3426.h"
+#include "WireSupervisor.h"
+
+MCP3426::MCP3426(TwoWire* wire, uint8_t address)
+  : _wire(wire), _supervisor(nullptr), _device(-1), _address(address), _resolution(RES_16BIT),
+    _mode(ONE_SHOT), _gain(GAIN_1), _channelMask(0x03), _multiplier(125), _shift(1), _state(IDLE), _channel(0), _discard(false), _startMillis(0), _errors(0) {
+  for (uint8_t i = 0; i < NUM_CHANNELS; i++) {
+    _raw[i] = 0;
+    _valid[i] = false;
+    _new[i] = false;
+  }
+}
+
+void MCP3426::begin(Resolution resolution, Mode mode, uint8_t channelMask, Gain gain) {
+  _resolution = resolution;
+  _mode = mode;
+  _gain = gain;
+  _multiplier = multiplierFor(resolution);
+  _shift = 1 + gain;
+  _channelMask = channelMask & 0x03;
+  _channel = nextChannel(NUM_CHANNELS - 1);  // First enabled channel
+  _state = IDLE;
+  _discard = false;
+}
+
+bool MCP3426::attach(WireSupervisor* supervisor) {
+  _device = supervisor ? supervisor->addDevice(_address, MAX_CLOCK) : -1;
+  _supervisor = _device >= 0 ? supervisor : nullptr;
+  return _supervisor != nullptr;
+}
+
+bool MCP3426::update() {
+  if (_channelMask == 0) return false;
+
+  if (_state == IDLE) {
+    if (startConversion()) {
+      _state = CONVERTING;
+      _discard = _mode == CONTINUOUS;
+      _startMillis = millis();
+    }
+    return false;
+  }
+
+  // Do not poll the bus before the result can possibly be there
+  if (millis() - _startMillis < conversionTimeMs()) return false;
+
+  int16_t raw;
+  if (!readResult(raw)) return false;  // Not ready yet: poll again next time
+
+  // Continuous mode: the first result after writing the configuration can
+  // come from the conversion that was running on the previous channel
+  if (_discard) {
+    _discard = false;
+    _startMillis = millis();
+    return false;
+  }
+
+  _raw[_channel] = raw;
+  _valid[_channel] = true;
+  _new[_channel] = true;
+
+  const uint8_t next = nextChannel(_channel);
+  if (_mode == CONTINUOUS && next == _channel) {
+    _startMillis = millis();  // Single channel free-running: keep collecting
+  } else {
+    _channel = next;
+    _state = IDLE;  // Reconfigure for the next channel on the next call
+  }
+  return true;
+}
+
+bool MCP3426::hasNewValue(uint8_t channel) const {
+  return channel < NUM_CHANNELS && _new[channel];
+}
+
+float MCP3426::getVoltage(uint8_t channel) {
+  if (channel >= NUM_CHANNELS || !_valid[channel]) return NAN;
+  return toVolts(getMicrovolts(channel));
+}
+
+int32_t MCP3426::getMicrovolts(uint8_t channel) {
+  if (channel >= NUM_CHANNELS || !_valid[channel]) return NO_VALUE;
+  _new[channel] = false;
+
+  // Full scale is +/-2.048 V / gain at every resolution
+  return scale(_raw[channel], _multiplier, _shift);
+}
+
+uint8_t MCP3426::getMicrovolts(int32_t (&microvolts)[NUM_CHANNELS]) {
+  uint8_t valid = 0;
+  for (uint8_t i = 0; i < NUM_CHANNELS; i++) {
+    microvolts[i] = getMicrovolts(i);
+    if (_valid[i]) valid |= 1 << i;
+  }
+  return valid;
+}
+
+void MCP3426::toMicrovolts(const int16_t* raw, int32_t* microvolts, size_t count,
+                           Resolution resolution, Gain gain) {
+  const int32_t multiplier = multiplierFor(resolution);
+  for (size_t i = 0; i < count; i++) {
+    microvolts[i] = scale(raw[i], multiplier, 1 + gain);
+  }
+}
+
+int16_t MCP3426::getRaw(uint8_t channel) const {
+  return channel < NUM_CHANNELS ? _raw[channel] : 0;
+}
+
+uint32_t MCP3426::getErrorCount() const {
+  return _errors;
+}
+
+bool MCP3426::startConversion() {
+  uint8_t config = (_channel << 5) | _resolution | _gain;
+  if (_mode == CONTINUOUS) {
+    config |= CFG_CONTINUOUS;
+  } else {
+    config |= CFG_RDY;  // Writing RDY starts a one-shot conversion
+  }
+
+  if (_supervisor && !_supervisor->beginTransaction(_device)) return false;  // Backing off
+
+  _wire->beginTransmission(_address);
+  _wire->write(config);
+  const uint8_t status = _wire->endTransmission();
+  if (_supervisor) _supervisor->endTransaction(_device, status);
+  if (status != 0) {
+    _errors++;
+    return false;
+  }
+  return true;
+}
+
+bool MCP3426::readResult(int16_t& raw) {
+  if (_supervisor && !_supervisor->beginTransaction(_device)) return false;
+
+  const uint8_t received = _wire->requestFrom(_address, (uint8_t)3);
+  if (_supervisor) _supervisor->endTransaction(_device, received == 3 ? 0 : 2);
+  if (received != 3) {
+    _errors++;
+    return false;
+  }
+  const uint8_t high = _wire->read();
+  const uint8_t low = _wire->read();
+  const uint8_t config = _wire->read();
+
+  if (config & CFG_RDY) return false;  // RDY still set: conversion running
+
+  raw = (int16_t)((high << 8) | low);  // Result is sign-extended by the ADC
+  return true;
+}
+
+uint8_t MCP3426::nextChannel(uint8_t channel) const {
+  for (uint8_t i = 1; i <= NUM_CHANNELS; i++) {
+    const uint8_t candidate = (channel + i) % NUM_CHANNELS;
+    if (_channelMask & (1 << candidate)) return candidate;
+  }
+  return channel;
+}
+
+uint16_t MCP3426::conversionTimeMs() const {
+  switch (_resolution) {
+    case RES_12BIT: return 4;    // 1/240 s
+    case RES_14BIT: return 16;   // 1/60 s
+    default:        return 66;   // 1/15 s
+  }
+}
@@ -0,0 +1,132 @@
+/*
+    MCP3426.h
+
+    Non-blocking driver for the MCP3426 16-bit delta-sigma ADC.
+
+    Call update() from loop(): it starts a conversion, then polls the RDY bit
+    once the expected conversion time has passed, and moves on to the next
+    enabled channel when a result is in. No delay(), so several ADCs (one per
+    I2C bus) convert at the same time and the sample rate is set by the ADC.
+
+    With attach() every transaction is reported to a WireSupervisor: a
+    missing or failing ADC then backs off instead of being polled every
+    loop(), and a stuck bus is recovered before the next transaction.
+
+    Results are converted in integers: microvolts = (raw * multiplier +
+    round) >> shift, with multiplier and shift set per resolution and gain
+    in begin(). The M0+ has no FPU, so float (getVoltage(), toVolts()) is
+    left as the last step for display.
+*/
+
+#ifndef MCP3426_H
+#define MCP3426_H
+
+#include "Arduino.h"
+#include <Wire.h>
+
+class WireSupervisor;
+
+class MCP3426 {
+public:
+  static const uint8_t DEFAULT_ADDR = 0x68;  // A0 to GND
+  static const uint8_t NUM_CHANNELS = 2;
+  static const uint32_t MAX_CLOCK = 400000;  // Fm; 3.4 MHz only in HS mode, which TwoWire does not do
+
+  // S1-S0 bits: resolution and sample rate
+  enum Resolution : uint8_t {
+    RES_12BIT = 0x00,  // 240 SPS, 1 mV LSB
+    RES_14BIT = 0x04,  //  60 SPS, 250 uV LSB
+    RES_16BIT = 0x08   //  15 SPS, 62.5 uV LSB
+  };
+
+  // G1-G0 bits: PGA gain
+  enum Gain : uint8_t {
+    GAIN_1 = 0x00,
+    GAIN_2 = 0x01,
+    GAIN_4 = 0x02,
+    GAIN_8 = 0x03
+  };
+
+  static const int32_t NO_VALUE = INT32_MIN;  // getMicrovolts() before the first result
+
+  enum Mode : uint8_t {
+    ONE_SHOT,    // Start every conversion explicitly (lowest power)
+    CONTINUOUS   // ADC free-runs, results are picked up when RDY clears; the
+                 // first one after a channel switch is discarded, so for
+                 // round-robin over both channels ONE_SHOT is twice as fast
+  };
+
+  MCP3426(TwoWire* wire, uint8_t address = DEFAULT_ADDR);
+
+  // channelMask: bit 0 = CH1, bit 1 = CH2
+  void begin(Resolution resolution = RES_16BIT, Mode mode = ONE_SHOT, uint8_t channelMask = 0x03,
+             Gain gain = GAIN_1);
+
+  // Supervisor of the bus this ADC is on, registered with MAX_CLOCK; false
+  // when it has no device slot left
+  bool attach(WireSupervisor* supervisor);
+
+  // Advance the state machine; returns true when a new result was stored
+  bool update();
+
+  bool hasNewValue(uint8_t channel) const;
+  float getVoltage(uint8_t channel);  // Clears the new-value flag, NAN if never read
+  int32_t getMicrovolts(uint8_t channel);  // Clears the new-value flag, NO_VALUE if never read
+
+  // All channels in one pass; returns the mask of channels with a value
+  uint8_t getMicrovolts(int32_t (&microvolts)[NUM_CHANNELS]);
+
+  // Raw code to microvolts. 2 x LSB in uV is an integer at every
+  // resolution (2000, 500, 125), so the shift is 1 plus the gain bits.
+  static int32_t multiplierFor(Resolution resolution) {
+    return resolution == RES_12BIT ? 2000 : resolution == RES_14BIT ? 500 : 125;
+  }
+  static int32_t toMicrovolts(int16_t raw, Resolution resolution, Gain gain = GAIN_1) {
+    return scale(raw, multiplierFor(resolution), 1 + gain);
+  }
+  static void toMicrovolts(const int16_t* raw, int32_t* microvolts, size_t count,
+                           Resolution resolution, Gain gain = GAIN_1);
+
+  // For display only: one float multiply
+  static float toVolts(int32_t microvolts) { return (float)microvolts * 1e-6f; }
+  int16_t getRaw(uint8_t channel) const;
+  uint32_t getErrorCount() const;
+
+private:
+  enum State : uint8_t { IDLE, CONVERTING };
+
+  static const uint8_t CFG_RDY = 0x80;
+  static const uint8_t CFG_CONTINUOUS = 0x10;
+
+  static int32_t scale(int16_t raw, int32_t multiplier, uint8_t shift) {
+    return ((int32_t)raw * multiplier + (1L << (shift - 1))) >> shift;  // Rounded
+  }
+
+  bool startConversion();
+  bool readResult(int16_t& raw);
+  uint8_t nextChannel(uint8_t channel) const;
+  uint16_t conversionTimeMs() const;
+
+  TwoWire* _wire;
+  WireSupervisor* _supervisor;
+  int8_t _device;
+  uint8_t _address;
+  Resolution _resolution;
+  Mode _mode;
+  Gain _gain;
+  uint8_t _channelMask;
+  int32_t _multiplier;  // Set in begin(), see toMicrovolts()
+  uint8_t _shift;
+
+  State _state;
+  uint8_t _channel;
+  bool _discard;  // Continuous mode: drop the next ready result
+  unsigned long _startMillis;
+
+  int16_t _raw[NUM_CHANNELS];
+  bool _valid[NUM_CHANNELS];
+  bool _new[NUM_CHANNELS];
+  uint32_t _errors;
+};
+
+#endif // MCP3426_H
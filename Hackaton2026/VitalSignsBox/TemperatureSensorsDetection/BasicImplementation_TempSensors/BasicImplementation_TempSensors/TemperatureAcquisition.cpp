@@ -0,0 +1,96 @@
+/*
+    TemperatureAcquisition.cpp
+
+    Temperature module acquisition engine implementation
+*/
+
+#include "TemperatureAcquisition.h"
+
+TemperatureAcquisition::TemperatureAcquisition(MCP3426& adcA, const TemperatureProbe* probesA,
+                                               MCP3426& adcB, const TemperatureProbe* probesB)
+  : _samples(0), _lastSampleMs(0) {
+  _adcs[0] = &adcA;
+  _adcs[1] = &adcB;
+  _probes[0] = probesA;
+  _probes[1] = probesB;
+  for (uint8_t i = 0; i < NUM_INPUTS; i++) {
+    _microvolts[i] = MCP3426::NO_VALUE;
+    _temperatures[i] = TemperatureProbe::NO_TEMPERATURE;
+  }
+}
+
+void TemperatureAcquisition::begin(MCP3426::Resolution resolution, uint8_t channelMask, MCP3426::Gain gain) {
+  // One channel: continuous, the ADC keeps converting and is never set up
+  // again. Round-robin: one-shot, the next conversion is started by the
+  // update() after the one that read a result. In continuous mode a channel switch costs
+  // a discarded conversion (see MCP3426.h).
+  const MCP3426::Mode mode = (channelMask & 0x03) == 0x03 ? MCP3426::ONE_SHOT : MCP3426::CONTINUOUS;
+  for (uint8_t adc = 0; adc < NUM_ADCS; adc++) {
+    _adcs[adc]->begin(resolution, mode, channelMask, gain);
+  }
+  for (uint8_t ch = 0; ch < MCP3426::NUM_CHANNELS; ch++) {
+    _fusion[ch].reset();
+  }
+  _samples = 0;
+}
+
+uint8_t TemperatureAcquisition::update() {
+  uint8_t updated = 0;
+  for (uint8_t adc = 0; adc < NUM_ADCS; adc++) {
+    if (_adcs[adc]->update()) updated |= collect(adc) << (adc * MCP3426::NUM_CHANNELS);
+  }
+  return updated;
+}
+
+// Table lookup and fusion, no float: cheap enough for every result
+uint8_t TemperatureAcquisition::collect(uint8_t adc) {
+  MCP3426& converter = *_adcs[adc];
+  uint8_t fresh = 0;
+  for (uint8_t ch = 0; ch < MCP3426::NUM_CHANNELS; ch++) {
+    if (converter.hasNewValue(ch)) fresh |= 1 << ch;
+  }
+
+  int32_t* microvolts = &_microvolts[adc * MCP3426::NUM_CHANNELS];
+  int16_t* centiCelsius = &_temperatures[adc * MCP3426::NUM_CHANNELS];
+  for (uint8_t ch = 0; ch < MCP3426::NUM_CHANNELS; ch++) {
+    if (!(fresh & (1 << ch))) continue;
+    microvolts[ch] = converter.getMicrovolts(ch);
+    centiCelsius[ch] = _probes[adc][ch].toCentiCelsius(microvolts[ch]);
+    _fusion[ch].addSample(adc == 0 ? FUSION_PROBE_A : FUSION_PROBE_B, centiCelsius[ch]);
+    _samples++;
+  }
+  if (fresh) _lastSampleMs = millis();
+  return fresh;
+}
+
+int32_t TemperatureAcquisition::getMicrovolts(uint8_t input) const {
+  return input < NUM_INPUTS ? _microvolts[input] : MCP3426::NO_VALUE;
+}
+
+int16_t TemperatureAcquisition::getTemperature(uint8_t input) const {
+  return input < NUM_INPUTS ? _temperatures[input] : TemperatureProbe::NO_TEMPERATURE;
+}
+
+const TemperatureFusion& TemperatureAcquisition::getFusion(uint8_t channel) const {
+  return _fusion[channel < MCP3426::NUM_CHANNELS ? channel : 0];
+}
+
+uint8_t TemperatureAcquisition::getProbeMask() const {
+  uint8_t mask = 0;
+  for (uint8_t i = 0; i < NUM_INPUTS; i++) {
+    if (_temperatures[i] != TemperatureProbe::NO_TEMPERATURE) mask |= 1 << i;
+  }
+  return mask;
+}
+
+uint32_t TemperatureAcquisition::getSampleCount() const {
+  return _samples;
+}
+
+uint32_t TemperatureAcquisition::getLastSampleMs() const {
+  return _lastSampleMs;
+}
+
+uint32_t TemperatureAcquisition::getErrorCount() const {
+  return _adcs[0]->getErrorCount() + _adcs[1]->getErrorCount();
+}
@@ -0,0 +1,73 @@
+/*
+    TemperatureAcquisition.h
+
+    Acquisition engine for the temperature module: both MCP3426 ADCs
+    converting all the time, results kept as latest values.
+
+    Each ADC goes round-robin over its enabled channels in one-shot mode:
+    a finished result is picked up and the next conversion is started by
+    the following update(), so the ADC is only idle for about one loop()
+    pass. With a single channel it runs in continuous mode. Both
+    buses convert at the same time.
+
+    Every new result is converted to a temperature (probe table) and fed
+    to the fusion of its channel straight away. The latest microvolts,
+    temperature and fused temperature per input stay available until the
+    next result replaces them, so whoever asks (the serial report, the
+    I2C register map) gets an answer without waiting for a conversion.
+
+    Inputs are numbered bus A CH1, bus A CH2, bus B CH1, bus B CH2.
+*/
+
+#ifndef TEMPERATURE_ACQUISITION_H
+#define TEMPERATURE_ACQUISITION_H
+
+#include "Arduino.h"
+#include "MCP3426.h"
+#include "TemperatureProbe.h"
+#include "TemperatureFusion.h"
+
+class TemperatureAcquisition {
+public:
+  static const uint8_t NUM_ADCS = 2;
+  static const uint8_t NUM_INPUTS = NUM_ADCS * MCP3426::NUM_CHANNELS;
+
+  // Fusion probe per ADC: channel n of ADC A and of ADC B measure the same site
+  static const uint8_t FUSION_PROBE_A = 0;
+  static const uint8_t FUSION_PROBE_B = 1;
+
+  // probesA / probesB: MCP3426::NUM_CHANNELS probes each, kept by pointer
+  TemperatureAcquisition(MCP3426& adcA, const TemperatureProbe* probesA,
+                         MCP3426& adcB, const TemperatureProbe* probesB);
+
+  // channelMask: bit 0 = CH1, bit 1 = CH2, the same on both ADCs
+  void begin(MCP3426::Resolution resolution, uint8_t channelMask = 0x03, MCP3426::Gain gain = MCP3426::GAIN_1);
+
+  // Advance both ADCs; call every loop(). Never blocks.
+  // Returns the mask of inputs with a new result (bit = input)
+  uint8_t update();
+
+  int32_t getMicrovolts(uint8_t input) const;   // MCP3426::NO_VALUE before the first result
+  int16_t getTemperature(uint8_t input) const;  // 0.01 C, NO_TEMPERATURE without a probe
+  const TemperatureFusion& getFusion(uint8_t channel) const;
+
+  // Mask of inputs that have a temperature (probe connected)
+  uint8_t getProbeMask() const;
+
+  uint32_t getSampleCount() const;   // Results since begin(), all inputs
+  uint32_t getLastSampleMs() const;  // millis() of the latest result
+  uint32_t getErrorCount() const;    // Failed ADC transactions, both buses
+
+private:
+  uint8_t collect(uint8_t adc);
+
+  MCP3426* _adcs[NUM_ADCS];
+  const TemperatureProbe* _probes[NUM_ADCS];
+  int32_t _microvolts[NUM_INPUTS];
+  int16_t _temperatures[NUM_INPUTS];
+  TemperatureFusion _fusion[MCP3426::NUM_CHANNELS];
+  uint32_t _samples;
+  uint32_t _lastSampleMs;
+};
+
+#endif // TEMPERATURE_ACQUISITION_H
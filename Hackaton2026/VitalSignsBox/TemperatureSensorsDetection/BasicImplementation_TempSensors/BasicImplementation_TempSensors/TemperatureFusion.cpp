@@ -0,0 +1,160 @@
+/*
+    TemperatureFusion.cpp
+
+    Redundant probe fusion implementation
+*/
+
+#include "TemperatureFusion.h"
+
+namespace {
+
+const uint8_t FRACTION_BITS = 4;           // State and variances in 1/16
+const uint8_t GAIN_BITS = 12;              // Kalman gain, Q12
+const uint32_t MAX_VARIANCE = 1UL << 19;   // Keeps variance << GAIN_BITS in 32 bits
+const int32_t MIN_NOISE = 16;              // (0.01 C)^2: a gain of 1 would follow every LSB
+const int32_t INITIAL_NOISE = 25L * 16;    // 0.05 C until the probe's own estimate builds up
+const int16_t MAX_STEP_CENTI_C = 1000;     // Larger steps are faults, not noise
+const int32_t NOISE_AVERAGE = 16;          // Readings the noise estimate averages over
+
+uint16_t squareRoot(uint32_t value) {
+  uint32_t root = 0;
+  uint32_t bit = 1UL << 30;
+  while (bit > value) bit >>= 2;
+  while (bit != 0) {
+    if (value >= root + bit) {
+      value -= root + bit;
+      root = (root >> 1) + bit;
+    } else {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+  return (uint16_t)root;
+}
+
+}  // namespace
+
+TemperatureFusion::TemperatureFusion()
+  : _processNoise(DEFAULT_PROCESS_NOISE), _disagreeLimit(DEFAULT_DISAGREE_CENTI_C) {
+  reset();
+}
+
+void TemperatureFusion::reset() {
+  for (uint8_t i = 0; i < NUM_PROBES; i++) {
+    _probes[i].last = TemperatureProbe::NO_TEMPERATURE;
+    _probes[i].noise = INITIAL_NOISE;
+    _probes[i].rejects = 0;
+  }
+  _state = 0;
+  _variance = MAX_VARIANCE;
+  _valid = false;
+}
+
+int16_t TemperatureFusion::addSample(uint8_t probe, int16_t centiCelsius) {
+  if (probe >= NUM_PROBES) return getTemperature();
+  Probe& p = _probes[probe];
+
+  if (centiCelsius == TemperatureProbe::NO_TEMPERATURE) {
+    p.last = TemperatureProbe::NO_TEMPERATURE;
+    p.rejects = 0;
+    bool any = false;
+    for (uint8_t i = 0; i < NUM_PROBES; i++) {
+      if (_probes[i].last != TemperatureProbe::NO_TEMPERATURE) any = true;
+    }
+    if (!any) _valid = false;
+    return getTemperature();
+  }
+
+  // Noise from successive readings: for white noise on a slow signal
+  // the variance of the difference is twice that of a reading
+  if (p.last != TemperatureProbe::NO_TEMPERATURE) {
+    int32_t step = (int32_t)centiCelsius - p.last;
+    if (step > MAX_STEP_CENTI_C) step = MAX_STEP_CENTI_C;
+    if (step < -MAX_STEP_CENTI_C) step = -MAX_STEP_CENTI_C;
+    const int32_t sample = step * step * (1 << FRACTION_BITS) / 2;
+    p.noise += (sample - p.noise) / NOISE_AVERAGE;
+  }
+  p.last = centiCelsius;
+
+  const uint32_t noise = (uint32_t)(p.noise < MIN_NOISE ? MIN_NOISE : p.noise);
+  if (!_valid) {
+    restart(centiCelsius, noise);
+    return getTemperature();
+  }
+
+  // Predict: the temperature may have drifted
+  _variance += _processNoise;
+  if (_variance > MAX_VARIANCE) _variance = MAX_VARIANCE;
+
+  // Gate: beyond 3 sigma of the innovation and beyond the disagree limit
+  const int32_t innovation = (int32_t)centiCelsius * (1 << FRACTION_BITS) - _state;
+  const uint32_t distance = (uint32_t)(innovation < 0 ? -innovation : innovation);
+  const uint64_t spread = 9ULL * (_variance + noise) << FRACTION_BITS;
+  if ((uint64_t)distance * distance > spread &&
+      distance > ((uint32_t)_disagreeLimit << FRACTION_BITS)) {
+    if (p.rejects < UINT8_MAX) p.rejects++;
+    if (p.rejects >= REJECT_SAMPLES) {
+      bool otherTrusted = false;
+      for (uint8_t i = 0; i < NUM_PROBES; i++) {
+        if (i != probe && isTrusted(i)) otherTrusted = true;
+      }
+      if (!otherTrusted) restart(centiCelsius, noise);
+    }
+    return getTemperature();
+  }
+  p.rejects = 0;
+
+  // Update, gain = P / (P + R)
+  const uint32_t gain = (_variance << GAIN_BITS) / (_variance + noise);
+  _state += (int32_t)(((int64_t)gain * innovation) >> GAIN_BITS);
+  _variance -= (gain * _variance) >> GAIN_BITS;
+  return getTemperature();
+}
+
+int16_t TemperatureFusion::getTemperature() const {
+  if (!_valid) return TemperatureProbe::NO_TEMPERATURE;
+  const int32_t half = 1 << (FRACTION_BITS - 1);
+  return (int16_t)((_state >= 0 ? _state + half : _state - half) / (1 << FRACTION_BITS));
+}
+
+uint16_t TemperatureFusion::getUncertainty() const {
+  return squareRoot(_variance >> FRACTION_BITS);
+}
+
+uint16_t TemperatureFusion::getNoise(uint8_t probe) const {
+  if (probe >= NUM_PROBES) return 0;
+  return squareRoot((uint32_t)_probes[probe].noise >> FRACTION_BITS);
+}
+
+uint8_t TemperatureFusion::getStatus() const {
+  if (!_valid) return FUSION_NO_PROBE;
+  uint8_t status = FUSION_OK;
+  const int16_t a = _probes[0].last;
+  const int16_t b = _probes[1].last;
+  if (a != TemperatureProbe::NO_TEMPERATURE && b != TemperatureProbe::NO_TEMPERATURE) {
+    const int32_t difference = (int32_t)a - b;
+    if (difference > _disagreeLimit || -difference > _disagreeLimit) status |= FUSION_DISAGREE;
+  }
+  if (isRejected(0)) status |= FUSION_PROBE0_REJECTED;
+  if (isRejected(1)) status |= FUSION_PROBE1_REJECTED;
+  return status;
+}
+
+bool TemperatureFusion::isRejected(uint8_t probe) const {
+  if (probe >= NUM_PROBES) return false;
+  return _probes[probe].last != TemperatureProbe::NO_TEMPERATURE && _probes[probe].rejects >= REJECT_SAMPLES;
+}
+
+// PRIVATE
+
+bool TemperatureFusion::isTrusted(uint8_t probe) const {
+  return _probes[probe].last != TemperatureProbe::NO_TEMPERATURE && _probes[probe].rejects < REJECT_SAMPLES;
+}
+
+// Start over from one reading, e.g. the first, or after a real step
+void TemperatureFusion::restart(int16_t centiCelsius, uint32_t noise) {
+  _state = (int32_t)centiCelsius * (1 << FRACTION_BITS);
+  _variance = noise > MAX_VARIANCE ? MAX_VARIANCE : noise;
+  _valid = true;
+  for (uint8_t i = 0; i < NUM_PROBES; i++) _probes[i].rejects = 0;
+}
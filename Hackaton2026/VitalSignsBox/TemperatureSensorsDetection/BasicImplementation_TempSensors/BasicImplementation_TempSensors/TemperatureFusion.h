@@ -0,0 +1,85 @@
+/*
+    TemperatureFusion.h
+
+    Two redundant probes (same site, one on each bus) fused into one
+    temperature, integer only.
+
+    A scalar Kalman filter tracks the temperature in 1/16 of 0.01 C. Every
+    probe reading is a predict step (the temperature may drift by the
+    process noise) and a measurement update, weighted by that probe's
+    noise. The noise of each probe is estimated from its own successive
+    readings, so a noisy probe counts for less without any tuning. With
+    two probes of equal noise the fused value has about 1/sqrt(2) of
+    their noise, and averaging over time lowers it further: the ADC can
+    run at a lower resolution and a higher rate for the same accuracy.
+
+    Fault detection:
+    - A reading too far from the estimate (beyond 3 sigma and beyond the
+      disagree limit) is not used. After REJECT_SAMPLES of those in a
+      row the probe is reported as rejected while the other one is
+      trusted; when no probe is trusted either (a real step change), the
+      filter restarts on the probe.
+    - FUSION_DISAGREE is set while the latest readings of the two probes
+      differ by more than the disagree limit.
+
+    Feed it straight from TemperatureProbe::toCentiCelsius(), one reading
+    per probe per conversion.
+*/
+
+#ifndef TEMPERATURE_FUSION_H
+#define TEMPERATURE_FUSION_H
+
+#include "Arduino.h"
+#include "TemperatureProbe.h"
+
+class TemperatureFusion {
+public:
+  static const uint8_t NUM_PROBES = 2;
+  static const uint8_t REJECT_SAMPLES = 8;              // Bad readings in a row before a probe is rejected
+  static const int16_t DEFAULT_DISAGREE_CENTI_C = 50;   // 0.50 C
+  static const uint16_t DEFAULT_PROCESS_NOISE = 16;     // Drift variance per reading, (0.01 C)^2 * 16
+
+  enum Status : uint8_t {
+    FUSION_OK = 0x00,
+    FUSION_DISAGREE = 0x01,         // Latest readings further apart than the disagree limit
+    FUSION_PROBE0_REJECTED = 0x02,
+    FUSION_PROBE1_REJECTED = 0x04,
+    FUSION_NO_PROBE = 0x08          // No reading yet, or every probe open
+  };
+
+  TemperatureFusion();
+
+  void reset();
+
+  // One reading of a probe in 0.01 C; NO_TEMPERATURE when it is open
+  // or missing. Returns the fused temperature.
+  int16_t addSample(uint8_t probe, int16_t centiCelsius);
+
+  int16_t getTemperature() const;           // 0.01 C, NO_TEMPERATURE without a probe
+  uint16_t getUncertainty() const;          // One sigma of the fused value, 0.01 C
+  uint16_t getNoise(uint8_t probe) const;   // Estimated one sigma of a probe, 0.01 C
+  uint8_t getStatus() const;                // Status bits
+  bool isRejected(uint8_t probe) const;
+
+  void setProcessNoise(uint16_t variance) { _processNoise = variance; }  // (0.01 C)^2 * 16
+  void setDisagreeLimit(int16_t centiCelsius) { _disagreeLimit = centiCelsius; }
+
+private:
+  struct Probe {
+    int16_t last;       // Latest reading, NO_TEMPERATURE if open
+    int32_t noise;      // Variance, (0.01 C)^2 * 16
+    uint8_t rejects;    // Readings in a row outside the gate
+  };
+
+  bool isTrusted(uint8_t probe) const;
+  void restart(int16_t centiCelsius, uint32_t noise);
+
+  Probe _probes[NUM_PROBES];
+  int32_t _state;       // Fused temperature, 0.01 C * 16
+  uint32_t _variance;   // Of _state, (0.01 C)^2 * 16
+  bool _valid;
+  uint16_t _processNoise;
+  int16_t _disagreeLimit;
+};
+
+#endif // TEMPERATURE_FUSION_H
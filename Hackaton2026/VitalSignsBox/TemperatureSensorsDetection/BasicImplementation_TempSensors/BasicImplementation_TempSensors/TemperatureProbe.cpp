@@ -0,0 +1,155 @@
+/*
+    TemperatureProbe.cpp
+
+    Probe voltage to temperature implementation
+*/
+
+#include "TemperatureProbe.h"
+
+// --- Compile time: probe models -------------------------------------------
+// Evaluated by the compiler only, so double and series are fine here.
+
+namespace {
+
+constexpr double squared(double x) { return x * x; }
+
+// Taylor series, enough terms for |x| < 1
+constexpr double expSeries(double x, int n, double term, double sum) {
+  return n > 20 ? sum : expSeries(x, n + 1, term * x / n, sum + term * x / n);
+}
+
+// exp(x) = exp(x / 16) ^ 16, keeps the series argument small
+constexpr double exponential(double x) {
+  return squared(squared(squared(squared(expSeries(x / 16, 1, 1.0, 1.0)))));
+}
+
+constexpr int32_t roundMicrovolts(double uv) {
+  return (int32_t)(uv + 0.5);
+}
+
+constexpr int32_t dividerMicrovolts(double resistance, double reference) {
+  return roundMicrovolts(PROBE_SUPPLY_UV * resistance / (resistance + reference));
+}
+
+// B-parameter model: R = R25 * exp(B * (1 / T - 1 / T25))
+constexpr double ntcResistance(double r25, double beta, int centiC) {
+  return r25 * exponential(beta * (1.0 / (centiC / 100.0 + 273.15) - 1.0 / 298.15));
+}
+
+// Callendar-Van Dusen, IEC 60751 coefficients; C only below 0 C
+constexpr double rtdRatio(double t) {
+  return 1.0 + 3.9083e-3 * t - 5.775e-7 * t * t + (t < 0 ? -4.183e-12 * (t - 100.0) * t * t * t : 0.0);
+}
+
+constexpr double pt1000Resistance(int centiC) {
+  return 1000.0 * rtdRatio(centiC / 100.0);
+}
+
+struct Ntc10k {
+  static const int FIRST = 1500, STEP = 250, COUNT = 29;  // 15.00 .. 85.00 C
+  static constexpr int32_t microvolts(int centiC) {
+    return dividerMicrovolts(ntcResistance(10000.0, 3950.0, centiC), 10000.0);
+  }
+};
+
+struct Ntc2252 {
+  static const int FIRST = 1500, STEP = 250, COUNT = 29;  // 15.00 .. 85.00 C
+  static constexpr int32_t microvolts(int centiC) {
+    return dividerMicrovolts(ntcResistance(2252.0, 3891.0, centiC), 2200.0);
+  }
+};
+
+struct Pt1000 {
+  static const int FIRST = -4000, STEP = 500, COUNT = 39;  // -40.00 .. 150.00 C
+  static constexpr int32_t microvolts(int centiC) {
+    return dividerMicrovolts(pt1000Resistance(centiC), 4700.0);
+  }
+};
+
+// C++11 has no std::index_sequence: 0 .. N-1 as a parameter pack
+template <int... I> struct Indices {};
+template <int N, int... I> struct MakeIndices : MakeIndices<N - 1, N - 1, I...> {};
+template <int... I> struct MakeIndices<0, I...> { typedef Indices<I...> Type; };
+
+// One table entry per step, each a constant expression
+template <class Probe, class = typename MakeIndices<Probe::COUNT>::Type> struct Table;
+template <class Probe, int... I> struct Table<Probe, Indices<I...> > {
+  static constexpr int32_t microvolts[sizeof...(I)] = { Probe::microvolts(Probe::FIRST + I * Probe::STEP)... };
+};
+template <class Probe, int... I> constexpr int32_t Table<Probe, Indices<I...> >::microvolts[sizeof...(I)];
+
+constexpr bool isMonotonic(const int32_t* v, int n, bool falling) {
+  return n < 2 || ((falling ? v[1] < v[0] : v[1] > v[0]) && isMonotonic(v + 1, n - 1, falling));
+}
+
+// Monotonic, so the binary search works, and inside the ADC range
+template <class Probe> constexpr bool isValid(bool falling) {
+  return isMonotonic(Table<Probe>::microvolts, Probe::COUNT, falling)
+         && Table<Probe>::microvolts[falling ? 0 : Probe::COUNT - 1] < PROBE_FULL_SCALE_UV
+         && Probe::COUNT <= 255;
+}
+
+static_assert(isValid<Ntc10k>(true), "PROBE_NTC_10K table");
+static_assert(isValid<Ntc2252>(true), "PROBE_NTC_2252 table");
+static_assert(isValid<Pt1000>(false), "PROBE_PT1000 table");
+
+template <class Probe> constexpr ProbeTable tableOf() {
+  return ProbeTable{ Probe::FIRST, Probe::STEP, Probe::COUNT, Table<Probe>::microvolts };
+}
+
+}  // namespace
+
+// Index ProbeType
+static const ProbeTable probeTables[NUM_PROBE_TYPES - 1] = {
+  tableOf<Ntc10k>(),
+  tableOf<Ntc2252>(),
+  tableOf<Pt1000>()
+};
+
+// --- Run time --------------------------------------------------------------
+
+const ProbeTable* TemperatureProbe::tableFor(ProbeType type) {
+  return (type == PROBE_NONE || type >= NUM_PROBE_TYPES) ? nullptr : &probeTables[type - 1];
+}
+
+int16_t TemperatureProbe::toCentiCelsius(ProbeType type, int32_t microvolts) {
+  const ProbeTable* table = tableFor(type);
+  return table ? lookup(*table, microvolts) : NO_TEMPERATURE;
+}
+
+void TemperatureProbe::toCentiCelsius(const TemperatureProbe* probes, const int32_t* microvolts,
+                                      int16_t* centiCelsius, size_t count) {
+  for (size_t i = 0; i < count; i++) {
+    centiCelsius[i] = probes[i].toCentiCelsius(microvolts[i]);
+  }
+}
+
+int16_t TemperatureProbe::lookup(const ProbeTable& table, int32_t microvolts) {
+  const int32_t* v = table.microvolts;
+  const uint8_t last = table.count - 1;
+  const bool falling = v[0] > v[last];  // NTC: voltage drops as it warms
+
+  // Outside the table: open or shorted probe (MCP3426::NO_VALUE is too)
+  if (falling ? (microvolts > v[0] || microvolts < v[last])
+              : (microvolts < v[0] || microvolts > v[last])) {
+    return NO_TEMPERATURE;
+  }
+
+  // v[lo] .. v[hi] brackets the voltage
+  uint8_t lo = 0;
+  uint8_t hi = last;
+  while (hi - lo > 1) {
+    const uint8_t mid = (lo + hi) / 2;
+    if ((v[mid] > microvolts) == falling) {
+      lo = mid;
+    } else {
+      hi = mid;
+    }
+  }
+
+  // step * (uv - v[lo]) has the sign of the span: the quotient is >= 0
+  // and adding half the span rounds it. Fits int32: < 500 * 2 048 000.
+  const int32_t span = v[hi] - v[lo];
+  const int32_t offset = ((int32_t)table.stepCentiC * (microvolts - v[lo]) + span / 2) / span;
+  return (int16_t)(table.firstCentiC + lo * table.stepCentiC + offset);
+}
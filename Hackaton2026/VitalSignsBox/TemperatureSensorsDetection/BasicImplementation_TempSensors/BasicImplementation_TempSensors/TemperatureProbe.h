@@ -0,0 +1,71 @@
+/*
+    TemperatureProbe.h
+
+    Probe voltage (MCP3426 microvolts) to temperature in centi-degrees
+    Celsius, integer only.
+
+    Per probe type there is a table of the divider voltage at fixed
+    temperature steps. The tables are computed by the compiler from the
+    probe model (B-parameter for the NTCs, Callendar-Van Dusen for the
+    PT1000) and end up in flash; at run time a conversion is a binary
+    search over about 30 entries and one linear interpolation. No log(),
+    no float, so converting every sample at the ADC rate is cheap.
+
+    Each probe sits at the bottom of a divider from PROBE_SUPPLY_UV,
+    the reference resistor on top (as in the API.md example). Change the
+    defines below, or add a probe type in TemperatureProbe.cpp, when the
+    hardware differs: static_asserts there check that every table stays
+    below the ADC full scale and is monotonic.
+*/
+
+#ifndef TEMPERATURE_PROBE_H
+#define TEMPERATURE_PROBE_H
+
+#include "Arduino.h"
+
+#define PROBE_SUPPLY_UV 3300000L    // Divider supply
+#define PROBE_FULL_SCALE_UV 2048000L  // MCP3426 at gain 1
+
+enum ProbeType : uint8_t {
+  PROBE_NONE = 0,      // Channel not used: never a temperature
+  PROBE_NTC_10K,       // 10k NTC, B 3950, 10k reference: 15.00 .. 85.00 C
+  PROBE_NTC_2252,      // 2252 Ohm NTC, B 3891 (YSI 400 style), 2k2 reference: 15.00 .. 85.00 C
+  PROBE_PT1000,        // PT1000 RTD, 4k7 reference: -40.00 .. 150.00 C
+  NUM_PROBE_TYPES
+};
+
+// Divider voltage at FIRST + i * STEP centi-degrees, i < count
+struct ProbeTable {
+  int16_t firstCentiC;
+  int16_t stepCentiC;
+  uint8_t count;
+  const int32_t* microvolts;
+};
+
+class TemperatureProbe {
+public:
+  static const int16_t NO_TEMPERATURE = INT16_MIN;  // No value, probe open or shorted, or PROBE_NONE
+
+  explicit TemperatureProbe(ProbeType type = PROBE_NONE) : _type(type) {}
+
+  void setType(ProbeType type) { _type = type; }
+  ProbeType getType() const { return _type; }
+
+  int16_t toCentiCelsius(int32_t microvolts) const { return toCentiCelsius(_type, microvolts); }
+
+  // Outside the table gives NO_TEMPERATURE; so does MCP3426::NO_VALUE
+  static int16_t toCentiCelsius(ProbeType type, int32_t microvolts);
+
+  // One probe per channel, e.g. straight from MCP3426::getMicrovolts(array)
+  static void toCentiCelsius(const TemperatureProbe* probes, const int32_t* microvolts,
+                             int16_t* centiCelsius, size_t count);
+
+  static const ProbeTable* tableFor(ProbeType type);  // nullptr for PROBE_NONE
+
+private:
+  static int16_t lookup(const ProbeTable& table, int32_t microvolts);
+
+  ProbeType _type;
+};
+
+#endif // TEMPERATURE_PROBE_H
@@ -0,0 +1,293 @@
+/*
+    AdcScanner.cpp
+
+    Interrupt-driven multi-channel ADC scanner implementation
+*/
+
+#include "AdcScanner.h"
+
+#if ADC_SCANNER_IRQ
+#include "wiring_private.h"  // pinPeripheral()
+
+static AdcScanner* activeScanner = nullptr;
+
+void ADC_Handler() {
+    if (activeScanner) activeScanner->onResult();
+}
+#endif
+
+AdcScanner::AdcScanner(const uint8_t* pins, uint8_t count)
+    : _count(count > MAX_CHANNELS ? MAX_CHANNELS : count)
+    , _shift(2)
+    , _continuous(true)
+    , _enabled(0xFF)
+    , _running(false)
+    , _paused(false)
+    , _current(0)
+    , _scans(0)
+    , _lastPolled(0)
+    , _watching(false)
+    , _windowExit(false)
+    , _watchLow(0)
+    , _watchHigh(0)
+{
+    for (uint8_t i = 0; i < _count; i++) {
+        _pins[i] = pins[i];
+        _values[i] = 0;
+    }
+}
+
+void AdcScanner::begin(uint8_t resolutionBits, uint8_t log2Average, bool continuous) {
+    _shift = (resolutionBits >= 12) ? 0 : 12 - resolutionBits;
+    _continuous = continuous;
+    if (log2Average > 4) log2Average = 4;
+
+#if ADC_SCANNER_IRQ
+    // The core's init() has clocked and calibrated the ADC
+    ADC->CTRLA.bit.ENABLE = 0;
+    while (ADC->STATUS.bit.SYNCBUSY) {}
+
+    for (uint8_t i = 0; i < _count; i++) {
+        pinPeripheral(_pins[i], PIO_ANALOG);
+    }
+
+    // Averaging needs the 16-bit accumulator; ADJRES divides it back to 12 bit
+    ADC->CTRLB.reg = ADC_CTRLB_PRESCALER_DIV128
+                   | (log2Average ? ADC_CTRLB_RESSEL_16BIT : ADC_CTRLB_RESSEL_12BIT);  // ~37 us per conversion
+    ADC->SAMPCTRL.reg = 15;
+    ADC->AVGCTRL.reg = ADC_AVGCTRL_SAMPLENUM(log2Average) | ADC_AVGCTRL_ADJRES(log2Average);
+    while (ADC->STATUS.bit.SYNCBUSY) {}
+    ADC->INPUTCTRL.reg = ADC_INPUTCTRL_MUXPOS(g_APinDescription[_pins[0]].ulADCChannelNumber)
+                       | ADC_INPUTCTRL_MUXNEG_GND
+                       | ADC_INPUTCTRL_GAIN_DIV2;  // Same range as analogRead() with AR_DEFAULT
+    while (ADC->STATUS.bit.SYNCBUSY) {}
+
+    activeScanner = this;
+    ADC->INTFLAG.reg = ADC_INTFLAG_RESRDY;
+    ADC->INTENSET.reg = ADC_INTENSET_RESRDY;
+    NVIC_EnableIRQ(ADC_IRQn);
+
+    ADC->CTRLA.bit.ENABLE = 1;
+    while (ADC->STATUS.bit.SYNCBUSY) {}
+#else
+    (void)log2Average;  // Fallback takes single samples
+#endif
+
+    start();
+}
+
+void AdcScanner::start() {
+    if (_watching) endWatch();
+    if (_running) return;
+    const int8_t first = firstEnabled(0);
+    if (first < 0) {
+        _paused = _continuous;  // Resumed by setChannelEnabled()
+        return;
+    }
+    _paused = false;
+    _running = true;
+    _current = first;
+    startConversion(first);
+}
+
+void AdcScanner::stop() {
+    if (_watching) endWatch();
+    _running = false;  // The interrupt does not start the next conversion
+}
+
+void AdcScanner::watch(uint8_t index, uint16_t low, uint16_t high) {
+    if (index >= _count) return;
+    if (_watching) endWatch();
+    _running = false;
+    _paused = false;
+    _current = index;
+    _watchLow = low;
+    _watchHigh = high;
+    _windowExit = false;
+
+#if ADC_SCANNER_IRQ
+    // Window in 12-bit RESULT counts: the value is RESULT >> _shift
+    const uint16_t lo = low << _shift;
+    uint32_t hi = ((uint32_t)high << _shift) | ((1 << _shift) - 1);
+    if (hi > 4095) hi = 4095;
+
+    // WINMODE compares strictly: MODE1 RESULT > WINLT, MODE2 RESULT < WINUT,
+    // MODE4 outside WINLT < RESULT < WINUT
+    uint8_t mode;
+    uint16_t winlt = 0;
+    uint16_t winut = 0;
+    if (lo == 0 && hi == 4095) {
+        mode = ADC_WINCTRL_WINMODE_DISABLE_Val;  // Cannot leave the window
+    } else if (lo == 0) {
+        mode = ADC_WINCTRL_WINMODE_MODE1_Val;
+        winlt = hi;
+    } else if (hi == 4095) {
+        mode = ADC_WINCTRL_WINMODE_MODE2_Val;
+        winut = lo;
+    } else {
+        mode = ADC_WINCTRL_WINMODE_MODE4_Val;
+        winlt = lo - 1;
+        winut = hi + 1;
+    }
+
+    // Disabling aborts a conversion of the scan, so no stale result reaches the window
+    ADC->INTENCLR.reg = ADC_INTENCLR_RESRDY | ADC_INTENCLR_WINMON;
+    ADC->CTRLA.bit.ENABLE = 0;
+    while (ADC->STATUS.bit.SYNCBUSY) {}
+    ADC->INPUTCTRL.bit.MUXPOS = g_APinDescription[_pins[index]].ulADCChannelNumber;
+    while (ADC->STATUS.bit.SYNCBUSY) {}
+    ADC->WINLT.reg = winlt;
+    while (ADC->STATUS.bit.SYNCBUSY) {}
+    ADC->WINUT.reg = winut;
+    while (ADC->STATUS.bit.SYNCBUSY) {}
+    ADC->WINCTRL.reg = ADC_WINCTRL_WINMODE(mode);
+    while (ADC->STATUS.bit.SYNCBUSY) {}
+    ADC->CTRLB.bit.FREERUN = 1;
+    while (ADC->STATUS.bit.SYNCBUSY) {}
+
+    _watching = true;
+    ADC->INTFLAG.reg = ADC_INTFLAG_RESRDY | ADC_INTFLAG_WINMON;
+    ADC->INTENSET.reg = ADC_INTENSET_WINMON;
+    ADC->CTRLA.bit.ENABLE = 1;
+    while (ADC->STATUS.bit.SYNCBUSY) {}
+    ADC->SWTRIG.bit.START = 1;
+#else
+    _watching = true;  // pollWindow() converts
+#endif
+}
+
+// Back from the window monitor to triggered scan conversions
+void AdcScanner::endWatch() {
+    noInterrupts();
+    const bool watching = _watching;
+    _watching = false;
+#if ADC_SCANNER_IRQ
+    ADC->INTENCLR.reg = ADC_INTENCLR_WINMON;
+#endif
+    interrupts();
+    if (!watching) return;  // The window interrupt was first
+
+#if ADC_SCANNER_IRQ
+    ADC->CTRLA.bit.ENABLE = 0;
+    while (ADC->STATUS.bit.SYNCBUSY) {}
+    ADC->CTRLB.bit.FREERUN = 0;
+    while (ADC->STATUS.bit.SYNCBUSY) {}
+    ADC->WINCTRL.reg = ADC_WINCTRL_WINMODE_DISABLE;
+    while (ADC->STATUS.bit.SYNCBUSY) {}
+    ADC->INTFLAG.reg = ADC_INTFLAG_RESRDY | ADC_INTFLAG_WINMON;
+    ADC->INTENSET.reg = ADC_INTENSET_RESRDY;
+    ADC->CTRLA.bit.ENABLE = 1;
+    while (ADC->STATUS.bit.SYNCBUSY) {}
+#endif
+}
+
+bool AdcScanner::isWatching() const {
+    return _watching;
+}
+
+bool AdcScanner::pollWindow() {
+#if !ADC_SCANNER_IRQ
+    if (_watching) {
+        const uint16_t value = (analogRead(_pins[_current]) << 2) >> _shift;
+        if (value < _watchLow || value > _watchHigh) {
+            _values[_current] = value;
+            _watching = false;
+            _windowExit = true;
+        }
+    }
+#endif
+    if (!_windowExit) return false;
+    _windowExit = false;
+    return true;
+}
+
+void AdcScanner::startConversion(uint8_t index) {
+#if ADC_SCANNER_IRQ
+    while (ADC->STATUS.bit.SYNCBUSY) {}
+    ADC->INPUTCTRL.bit.MUXPOS = g_APinDescription[_pins[index]].ulADCChannelNumber;
+    while (ADC->STATUS.bit.SYNCBUSY) {}
+    ADC->SWTRIG.bit.START = 1;
+#else
+    (void)index;  // poll() converts
+#endif
+}
+
+// Store the result and move on to the next channel
+void AdcScanner::onResult() {
+#if ADC_SCANNER_IRQ
+    if (_watching) {
+        // Window monitor: the watched channel left its window
+        _values[_current] = ADC->RESULT.reg >> _shift;
+        endWatch();
+        _windowExit = true;
+        return;
+    }
+    if (!ADC->INTFLAG.bit.RESRDY) return;  // Window interrupt that lost the race with endWatch()
+    const uint16_t result = ADC->RESULT.reg;  // Reading RESULT clears RESRDY
+#else
+    const uint16_t result = analogRead(_pins[_current]) << 2;  // 10 -> 12 bit
+#endif
+    _values[_current] = result >> _shift;
+
+    int8_t next = firstEnabled(_current + 1);
+    if (next < 0) {
+        _scans++;
+        if (!_continuous) _running = false;
+        next = firstEnabled(0);
+        if (next < 0) {
+            // Last channel was switched off during the round
+            _running = false;
+            _paused = _continuous;
+            return;
+        }
+    }
+    _current = next;
+    if (_running) startConversion(next);
+}
+
+int8_t AdcScanner::firstEnabled(uint8_t from) const {
+    const uint8_t enabled = _enabled;
+    for (uint8_t i = from; i < _count; i++) {
+        if (enabled & (1 << i)) return i;
+    }
+    return -1;
+}
+
+void AdcScanner::setChannelEnabled(uint8_t index, bool enabled) {
+    if (index >= _count) return;
+    noInterrupts();
+    if (enabled) {
+        _enabled |= (1 << index);
+    } else {
+        _enabled &= ~(1 << index);
+    }
+    const bool resume = enabled && _paused;
+    interrupts();
+    if (resume) start();
+}
+
+bool AdcScanner::isChannelEnabled(uint8_t index) const {
+    return index < _count && (_enabled & (1 << index));
+}
+
+bool AdcScanner::poll() {
+#if !ADC_SCANNER_IRQ
+    if (_running) onResult();
+#endif
+    const uint32_t scans = _scans;
+    const bool completed = (scans != _lastPolled);
+    _lastPolled = scans;
+    return completed;
+}
+
+uint16_t AdcScanner::getValue(uint8_t index) const {
+    return index < _count ? _values[index] : 0;
+}
+
+uint8_t AdcScanner::getChannelCount() const {
+    return _count;
+}
+
+uint32_t AdcScanner::getScanCount() const {
+    return _scans;
+}
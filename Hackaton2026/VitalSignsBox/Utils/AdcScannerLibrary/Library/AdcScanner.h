@@ -0,0 +1,144 @@
+/*
+    AdcScanner.h
+
+    Interrupt-driven multi-channel ADC scanner
+
+    analogRead() reconfigures the ADC, enables it, throws away a first
+    conversion and disables it again for every single sample. AdcScanner
+    owns the ADC: it is set up once in begin(), and the result-ready
+    interrupt stores each result, switches the mux to the next channel and
+    starts the next conversion. The latest value of every channel is
+    always available through getValue(), without waiting.
+
+    Sensor classes (ECGSensor, SPO2Sensor) can be attached to a channel
+    and become views on the scanner.
+
+    watch() hands one channel to the hardware window monitor instead: the
+    ADC free-runs on it without interrupts, and interrupts only once the
+    value leaves a window (e.g. a connection detection line crossing its
+    threshold).
+
+    Do not mix with analogRead() on the same ADC after begin().
+    Other targets fall back to one analogRead() per poll() call.
+*/
+
+#ifndef ADC_SCANNER_H
+#define ADC_SCANNER_H
+
+#include <Arduino.h>
+
+#if defined(__SAMD21G18A__) || defined(__SAMD21J18A__) || defined(__SAMD21E18A__)
+#define ADC_SCANNER_IRQ 1
+#else
+#define ADC_SCANNER_IRQ 0
+#endif
+
+class AdcScanner {
+public:
+    static const uint8_t MAX_CHANNELS = 8;
+
+    /**
+     * Constructor
+     * @param pins  Analog pins to scan, in order (copied)
+     * @param count Number of pins (at most MAX_CHANNELS)
+     */
+    AdcScanner(const uint8_t* pins, uint8_t count);
+
+    /**
+     * Configure the ADC and start scanning
+     * @param resolutionBits Scale of getValue(): 10 (as analogRead()) or 12
+     * @param log2Average    Hardware-averaged samples per result, 2^n (0..4)
+     * @param continuous     true: restart after every round;
+     *                       false: one round per start()
+     */
+    void begin(uint8_t resolutionBits = 10, uint8_t log2Average = 0, bool continuous = true);
+
+    /**
+     * Start a round (one-shot mode); ignored while a round is running
+     */
+    void start();
+
+    /**
+     * Stop after the current conversion
+     */
+    void stop();
+
+    /**
+     * Stop scanning and watch one channel with the window monitor
+     * The ADC converts that channel in free-running mode without raising
+     * an interrupt, until its value leaves [low, high]. The value is then
+     * stored, watching ends and pollWindow() returns true. start() stops
+     * watching and resumes scanning.
+     * @param index Position in the pin list
+     * @param low   Lowest value inside the window (getValue() scale; 0 = no lower limit)
+     * @param high  Highest value inside the window (full scale = no upper limit)
+     */
+    void watch(uint8_t index, uint16_t low, uint16_t high);
+
+    bool isWatching() const;
+
+    /**
+     * Check whether the watched channel left its window; call every loop()
+     * One flag test on SAMD21; other targets take one analogRead() per call
+     * @return true once per window exit
+     */
+    bool pollWindow();
+
+    /**
+     * Check for a completed round; call every loop()
+     * Drives the conversions on targets without the scan interrupt
+     * @return true if a round completed since the last call
+     */
+    bool poll();
+
+    /**
+     * Latest result of a channel (0 before its first conversion)
+     * @param index Position in the pin list
+     */
+    uint16_t getValue(uint8_t index) const;
+
+    uint8_t getChannelCount() const;
+
+    /**
+     * Include or skip a channel in the scan (all are enabled after construction)
+     * A skipped channel keeps its last value and costs no conversion time.
+     * With every channel skipped scanning pauses; enabling one resumes it.
+     * @param index Position in the pin list
+     */
+    void setChannelEnabled(uint8_t index, bool enabled);
+
+    bool isChannelEnabled(uint8_t index) const;
+
+    /**
+     * Completed rounds since begin()
+     */
+    uint32_t getScanCount() const;
+
+    /**
+     * Interrupt service; called from ADC_Handler
+     */
+    void onResult();
+
+private:
+    void startConversion(uint8_t index);
+    void endWatch();
+    int8_t firstEnabled(uint8_t from) const;  // -1 if none from 'from' on
+
+    uint8_t _pins[MAX_CHANNELS];
+    uint8_t _count;
+    uint8_t _shift;           // 12-bit result -> resolutionBits
+    bool _continuous;
+    volatile uint8_t _enabled;  // Bit per channel
+    volatile bool _running;
+    volatile bool _paused;      // Stopped because no channel was enabled
+    volatile uint8_t _current;
+    volatile uint16_t _values[MAX_CHANNELS];
+    volatile uint32_t _scans;
+    uint32_t _lastPolled;
+    volatile bool _watching;    // Window monitor on _current instead of scanning
+    volatile bool _windowExit;  // Set when the watched value left its window
+    uint16_t _watchLow;
+    uint16_t _watchHigh;
+};
+
+#endif // ADC_SCANNER_H
@@ -0,0 +1,32 @@
+#include "AdcScanner.h"
+
+/*
+    Scan A1..A3 continuously and print the latest values every 100 ms.
+    The loop never waits for the ADC.
+*/
+
+const uint8_t adcPins[] = { A1, A2, A3 };
+AdcScanner adc(adcPins, sizeof(adcPins));
+
+#define REPORT_INTERVAL 100  // ms
+unsigned long lastReport = 0;
+
+void setup() {
+  Serial.begin(115200);
+  adc.begin(10, 2);  // 10-bit scale, 4x hardware averaging
+}
+
+void loop() {
+  adc.poll();
+
+  if (millis() - lastReport < REPORT_INTERVAL) return;
+  lastReport = millis();
+
+  for (uint8_t i = 0; i < adc.getChannelCount(); i++) {
+    Serial.print(adc.getValue(i));
+    Serial.print(" ");
+  }
+  Serial.print("(rounds: ");
+  Serial.print(adc.getScanCount());
+  Serial.println(")");
+}
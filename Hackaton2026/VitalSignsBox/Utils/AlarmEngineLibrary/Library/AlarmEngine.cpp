@@ -0,0 +1,277 @@
+/*
+    AlarmEngine.cpp
+
+    Incremental alarm rule evaluation implementation
+*/
+
+#include "AlarmEngine.h"
+
+// Step in a ring of the window size without '%'
+static inline uint8_t ringNext(uint8_t index, uint8_t size) {
+    return (uint8_t)(index + 1 == size ? 0 : index + 1);
+}
+
+static inline uint8_t ringAt(uint8_t head, uint8_t offset, uint8_t size) {
+    const uint16_t index = (uint16_t)head + offset;
+    return (uint8_t)(index >= size ? index - size : index);
+}
+
+AlarmEngine::AlarmEngine()
+    : _channelCount(0)
+    , _ruleCount(0)
+    , _compiledCount(0)
+    , _dirty(false)
+    , _head(0)
+    , _count(0)
+    , _dropped(0)
+    , _maxLatencyUs(0)
+    , _maxUpdateUs(0)
+{
+}
+
+int8_t AlarmEngine::addChannel(uint8_t window) {
+    if (_channelCount >= ALARM_MAX_CHANNELS || window == 0 || window > ALARM_WINDOW_MAX) return -1;
+
+    Channel& ch = _channels[_channelCount];
+    memset(&ch, 0, sizeof(ch));
+    ch.window = window;
+    const int64_t n = window;
+    ch.trendDenominator = n * (n - 1) * (2 * n - 1) / 6 * n - (n * (n - 1) / 2) * (n * (n - 1) / 2);
+    return _channelCount++;
+}
+
+int8_t AlarmEngine::addRule(const AlarmRule& rule) {
+    if (_ruleCount >= ALARM_MAX_RULES || rule.channel >= _channelCount) return -1;
+    _added[_ruleCount] = rule;
+    _dirty = true;
+    return _ruleCount++;
+}
+
+// Group the rules by channel, keeping the states of rules that were already there
+void AlarmEngine::compile() {
+    RuleState previous[ALARM_MAX_RULES];
+    bool known[ALARM_MAX_RULES];
+    for (uint8_t i = 0; i < _ruleCount; i++) known[i] = false;
+    for (uint8_t i = 0; i < _compiledCount; i++) {
+        previous[_table[i].id] = _table[i];
+        known[_table[i].id] = true;
+    }
+
+    uint8_t position = 0;
+    for (uint8_t c = 0; c < _channelCount; c++) {
+        Channel& ch = _channels[c];
+        ch.firstRule = position;
+        for (uint8_t id = 0; id < _ruleCount; id++) {
+            if (_added[id].channel != c) continue;
+            RuleState& state = _table[position];
+            state.rule = _added[id];
+            state.id = id;
+            state.active = known[id] && previous[id].active;
+            state.pending = known[id] ? previous[id].pending : 0;
+            _tableIndex[id] = position++;
+        }
+        ch.ruleCount = (uint8_t)(position - ch.firstRule);
+    }
+    _compiledCount = _ruleCount;
+    _dirty = false;
+}
+
+uint8_t AlarmEngine::update(uint8_t channel, int32_t value, uint32_t sampleUs) {
+    const uint32_t start = micros();
+    if (channel >= _channelCount) return 0;
+    if (_dirty) compile();
+
+    Channel& ch = _channels[channel];
+    push(ch, value);
+
+    // Only the rules of this channel: a flat slice of the compiled table
+    uint8_t changes = 0;
+    for (uint8_t i = 0; i < ch.ruleCount; i++) {
+        RuleState& state = _table[ch.firstRule + i];
+        if (!evaluate(ch, state)) continue;
+        state.active = !state.active;
+        state.pending = 0;
+        emit(ch, state, sampleUs, micros());
+        changes++;
+    }
+
+    const uint32_t now = micros();
+    if (now - sampleUs > _maxLatencyUs) _maxLatencyUs = now - sampleUs;
+    if (now - start > _maxUpdateUs) _maxUpdateUs = now - start;
+    return changes;
+}
+
+// Insert into the window: ring, sums and both monotonic queues
+void AlarmEngine::push(Channel& ch, int32_t value) {
+    const uint8_t n = ch.window;
+    const uint8_t position = ch.head;
+
+    if (ch.count == n) {
+        // The oldest sample (at position) leaves the window and its queues
+        const int32_t oldest = ch.values[position];
+        ch.weighted += (int64_t)(n - 1) * value - (ch.sum - oldest);
+        ch.sum += (int64_t)value - oldest;
+        if (ch.minCount > 0 && ch.minQueue[ch.minHead] == position) {
+            ch.minHead = ringNext(ch.minHead, n);
+            ch.minCount--;
+        }
+        if (ch.maxCount > 0 && ch.maxQueue[ch.maxHead] == position) {
+            ch.maxHead = ringNext(ch.maxHead, n);
+            ch.maxCount--;
+        }
+    } else {
+        ch.weighted += (int64_t)ch.count * value;
+        ch.sum += value;
+        ch.count++;
+    }
+    ch.values[position] = value;
+    ch.head = ringNext(position, n);
+
+    // Drop queue entries the new value makes irrelevant, then append it
+    while (ch.minCount > 0 && ch.values[ch.minQueue[ringAt(ch.minHead, ch.minCount - 1, n)]] >= value) ch.minCount--;
+    ch.minQueue[ringAt(ch.minHead, ch.minCount++, n)] = position;
+    while (ch.maxCount > 0 && ch.values[ch.maxQueue[ringAt(ch.maxHead, ch.maxCount - 1, n)]] <= value) ch.maxCount--;
+    ch.maxQueue[ringAt(ch.maxHead, ch.maxCount++, n)] = position;
+}
+
+// true if the rule changes state with this sample (after its delay)
+bool AlarmEngine::evaluate(const Channel& ch, RuleState& state) const {
+    const AlarmRule& rule = state.rule;
+    const bool full = ch.count == ch.window;
+    bool condition;
+
+    if (rule.compare == ALARM_ANY_BIT) {
+        const int32_t latest = ch.values[ch.head == 0 ? ch.window - 1 : ch.head - 1];
+        condition = (latest & rule.threshold) != 0;
+        if (state.active) condition = !condition;  // Clear when no bit is left
+    } else if (rule.source == ALARM_VALUE || rule.source == ALARM_MIN || rule.source == ALARM_MAX) {
+        if (rule.source != ALARM_VALUE && !full) return false;
+        const int32_t value = sourceValue(ch, rule.source);
+        const bool above = rule.compare == ALARM_ABOVE;
+        if (!state.active) {
+            condition = above ? value > rule.threshold : value < rule.threshold;
+        } else {
+            condition = above ? value <= rule.threshold - rule.hysteresis : value >= rule.threshold + rule.hysteresis;
+        }
+    } else {
+        // Mean and trend without a division: compare the scaled sums
+        if (!full || (rule.source == ALARM_TREND && ch.window < 2)) return false;
+        const int64_t n = ch.window;
+        int64_t lhs, scale;
+        if (rule.source == ALARM_MEAN) {
+            lhs = ch.sum;
+            scale = n;
+        } else {
+            lhs = (n * ch.weighted - (n * (n - 1) / 2) * ch.sum) * (n - 1);
+            scale = ch.trendDenominator;
+        }
+        const bool above = rule.compare == ALARM_ABOVE;
+        if (!state.active) {
+            condition = above ? lhs > rule.threshold * scale : lhs < rule.threshold * scale;
+        } else {
+            condition = above ? lhs <= (rule.threshold - rule.hysteresis) * scale
+                              : lhs >= (rule.threshold + rule.hysteresis) * scale;
+        }
+    }
+
+    if (!condition) {
+        state.pending = 0;
+        return false;
+    }
+    if (state.pending < rule.delay) state.pending++;
+    return state.pending >= rule.delay;
+}
+
+int32_t AlarmEngine::sourceValue(const Channel& ch, AlarmSource source) const {
+    switch (source) {
+        case ALARM_MIN:
+            return ch.minCount > 0 ? ch.values[ch.minQueue[ch.minHead]] : 0;
+        case ALARM_MAX:
+            return ch.maxCount > 0 ? ch.values[ch.maxQueue[ch.maxHead]] : 0;
+        case ALARM_MEAN:
+            return ch.count > 0 ? (int32_t)(ch.sum / ch.count) : 0;
+        case ALARM_TREND: {
+            if (ch.count < 2 || ch.count != ch.window) return 0;
+            const int64_t n = ch.window;
+            return (int32_t)(((n * ch.weighted - (n * (n - 1) / 2) * ch.sum) * (n - 1)) / ch.trendDenominator);
+        }
+        case ALARM_VALUE:
+        default:
+            return ch.values[ch.head == 0 ? ch.window - 1 : ch.head - 1];
+    }
+}
+
+// Divisions only here, for the event (rare), not in the evaluation
+void AlarmEngine::emit(const Channel& ch, const RuleState& state, uint32_t sampleUs, uint32_t now) {
+    if (_count >= ALARM_QUEUE_SIZE) {
+        _dropped++;
+        return;
+    }
+    AlarmEvent& event = _queue[(_head + _count) % ALARM_QUEUE_SIZE];
+    event.rule = state.id;
+    event.active = state.active;
+    event.priority = state.rule.priority;
+    event.value = state.rule.compare == ALARM_ANY_BIT ? sourceValue(ch, ALARM_VALUE) : sourceValue(ch, state.rule.source);
+    event.sampleUs = sampleUs;
+    event.latencyUs = now - sampleUs;
+    _count++;
+}
+
+bool AlarmEngine::read(AlarmEvent& event) {
+    if (_count == 0) return false;
+    event = _queue[_head];
+    _head = (_head + 1) % ALARM_QUEUE_SIZE;
+    _count--;
+    return true;
+}
+
+bool AlarmEngine::isActive(uint8_t rule) const {
+    if (rule >= _ruleCount || _dirty) return false;
+    return _table[_tableIndex[rule]].active;
+}
+
+uint8_t AlarmEngine::getActiveCount() const {
+    uint8_t active = 0;
+    for (uint8_t i = 0; i < _ruleCount; i++) {
+        if (isActive(i)) active++;
+    }
+    return active;
+}
+
+int8_t AlarmEngine::getHighestPriority() const {
+    int8_t highest = -1;
+    for (uint8_t i = 0; i < _ruleCount; i++) {
+        if (isActive(i) && (int8_t)_added[i].priority > highest) highest = (int8_t)_added[i].priority;
+    }
+    return highest;
+}
+
+bool AlarmEngine::isWindowFull(uint8_t channel) const {
+    return channel < _channelCount && _channels[channel].count == _channels[channel].window;
+}
+
+int32_t AlarmEngine::getMin(uint8_t channel) const {
+    return channel < _channelCount ? sourceValue(_channels[channel], ALARM_MIN) : 0;
+}
+
+int32_t AlarmEngine::getMax(uint8_t channel) const {
+    return channel < _channelCount ? sourceValue(_channels[channel], ALARM_MAX) : 0;
+}
+
+uint32_t AlarmEngine::getMaxLatencyUs() const {
+    return _maxLatencyUs;
+}
+
+uint32_t AlarmEngine::getMaxUpdateUs() const {
+    return _maxUpdateUs;
+}
+
+uint32_t AlarmEngine::getDropped() const {
+    return _dropped;
+}
+
+void AlarmEngine::resetStatistics() {
+    _maxLatencyUs = 0;
+    _maxUpdateUs = 0;
+    _dropped = 0;
+}
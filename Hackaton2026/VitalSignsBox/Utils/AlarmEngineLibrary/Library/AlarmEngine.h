@@ -0,0 +1,167 @@
+/*
+    AlarmEngine.h
+
+    Threshold and trend alarms for the hub, evaluated on every new sample
+
+    Every input (heart rate, SpO2, a temperature, the lead status, ...) is
+    a channel with a sliding window. The window keeps its minimum and
+    maximum (monotonic queues, O(1) per sample amortised), its sum and the
+    sums for a least-squares trend, all updated incrementally.
+
+    Rules are added once and compiled into one flat table ordered by
+    channel, with a start index per channel. update() then only checks the
+    rules of the channel that got the sample: the cost of a sample does not
+    grow with the number of channels. Each rule has hysteresis and a
+    delay (consecutive samples) before it fires.
+
+    Every state change is queued with the time of the sample that caused
+    it and its evaluation latency; the maximum latency is kept as well.
+
+    No dynamic memory, no division per sample.
+*/
+
+#ifndef ALARM_ENGINE_H
+#define ALARM_ENGINE_H
+
+#include <Arduino.h>
+
+#define ALARM_MAX_CHANNELS 8
+#define ALARM_MAX_RULES 32
+#define ALARM_WINDOW_MAX 64    // Samples per channel window
+#define ALARM_QUEUE_SIZE 8     // Events waiting for read()
+
+// What a rule looks at
+enum AlarmSource : uint8_t {
+    ALARM_VALUE,   // Latest sample
+    ALARM_MIN,     // Window minimum
+    ALARM_MAX,     // Window maximum
+    ALARM_MEAN,    // Window mean
+    ALARM_TREND    // Change over the window (least-squares slope x window length - 1)
+};
+
+enum AlarmCompare : uint8_t {
+    ALARM_ABOVE,   // Source > threshold; clears at <= threshold - hysteresis
+    ALARM_BELOW,   // Source < threshold; clears at >= threshold + hysteresis
+    ALARM_ANY_BIT  // Latest sample & threshold != 0 (e.g. lead-off bits); clears when 0
+};
+
+struct AlarmRule {
+    uint8_t channel;       // From addChannel()
+    AlarmSource source;
+    AlarmCompare compare;
+    uint8_t priority;      // Free for the application (e.g. 0 = low .. 2 = high)
+    int32_t threshold;     // In channel units (ALARM_TREND: units per window)
+    int32_t hysteresis;
+    uint16_t delay;        // Consecutive samples the condition must hold (0 = at once)
+};
+
+struct AlarmEvent {
+    uint8_t rule;          // Id from addRule()
+    bool active;           // true = raised, false = cleared
+    uint8_t priority;
+    int32_t value;         // Source value that decided it (ALARM_MEAN: rounded down)
+    uint32_t sampleUs;     // Timestamp of the sample
+    uint32_t latencyUs;    // Sample timestamp to decision
+};
+
+class AlarmEngine {
+public:
+    AlarmEngine();
+
+    /**
+     * Add an input channel
+     * @param window Samples in the sliding window, 1 .. ALARM_WINDOW_MAX
+     *               (MIN, MAX, MEAN and TREND need a full window)
+     * @return Channel id, or -1 on a bad window or when full
+     */
+    int8_t addChannel(uint8_t window);
+
+    /**
+     * Add a rule; the table is recompiled on the next update()
+     * @return Rule id, or -1 on an unknown channel or when full
+     */
+    int8_t addRule(const AlarmRule& rule);
+
+    /**
+     * Feed a sample and evaluate the rules of its channel
+     * @param channel  Id from addChannel()
+     * @param value    Sample in channel units (e.g. 0.1 bpm)
+     * @param sampleUs micros() when the sample was taken (e.g. HubReading::timestampUs)
+     * @return Number of alarm state changes it caused
+     */
+    uint8_t update(uint8_t channel, int32_t value, uint32_t sampleUs);
+
+    /**
+     * Take the oldest state change
+     * @return false if none is waiting
+     */
+    bool read(AlarmEvent& event);
+
+    bool isActive(uint8_t rule) const;
+    uint8_t getActiveCount() const;
+
+    /**
+     * Highest priority of the active alarms, -1 if none
+     */
+    int8_t getHighestPriority() const;
+
+    // Window state of a channel (valid once the window is full)
+    bool isWindowFull(uint8_t channel) const;
+    int32_t getMin(uint8_t channel) const;
+    int32_t getMax(uint8_t channel) const;
+
+    uint32_t getMaxLatencyUs() const;   // Worst sample-to-decision latency so far
+    uint32_t getMaxUpdateUs() const;    // Worst time spent inside update()
+    uint32_t getDropped() const;        // Events lost to a full queue
+    void resetStatistics();
+
+private:
+    struct Channel {
+        int32_t values[ALARM_WINDOW_MAX];  // Ring of the window
+        uint8_t window;
+        uint8_t head;                      // Next write position
+        uint8_t count;
+        int64_t sum;                       // Sum of y over the window
+        int64_t weighted;                  // Sum of i * y, i = 0 (oldest) .. count - 1
+        int64_t trendDenominator;          // N sum(i^2) - sum(i)^2 for a full window
+        // Monotonic queues of ring positions: values rising (min) or falling (max)
+        uint8_t minQueue[ALARM_WINDOW_MAX];
+        uint8_t maxQueue[ALARM_WINDOW_MAX];
+        uint8_t minHead, minCount;
+        uint8_t maxHead, maxCount;
+        uint8_t firstRule;                 // Compiled table: firstRule .. firstRule + ruleCount - 1
+        uint8_t ruleCount;
+    };
+
+    struct RuleState {
+        AlarmRule rule;
+        uint8_t id;        // Index in addRule() order
+        bool active;
+        uint16_t pending;  // Consecutive samples the change has held
+    };
+
+    void compile();
+    void push(Channel& ch, int32_t value);
+    bool evaluate(const Channel& ch, RuleState& state) const;
+    int32_t sourceValue(const Channel& ch, AlarmSource source) const;
+    void emit(const Channel& ch, const RuleState& state, uint32_t sampleUs, uint32_t now);
+
+    Channel _channels[ALARM_MAX_CHANNELS];
+    uint8_t _channelCount;
+
+    AlarmRule _added[ALARM_MAX_RULES];   // In addRule() order
+    RuleState _table[ALARM_MAX_RULES];   // Compiled, grouped by channel
+    uint8_t _tableIndex[ALARM_MAX_RULES];  // Rule id -> table position
+    uint8_t _ruleCount;
+    uint8_t _compiledCount;
+    bool _dirty;
+
+    AlarmEvent _queue[ALARM_QUEUE_SIZE];
+    uint8_t _head;
+    uint8_t _count;
+    uint32_t _dropped;
+    uint32_t _maxLatencyUs;
+    uint32_t _maxUpdateUs;
+};
+
+#endif // ALARM_ENGINE_H
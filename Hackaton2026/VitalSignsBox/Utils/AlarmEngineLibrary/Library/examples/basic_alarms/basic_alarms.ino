@@ -0,0 +1,82 @@
+#include <Wire.h>
+#include "TwiPinHelper.h"
+#include "I2CAsyncBus.h"
+#include "HubScheduler.h"
+#include "AlarmEngine.h"
+
+/*
+    Hub alarms on the module registers: heart rate and leads from the ECG
+    module, SpO2 from the SpO2 module. Every reading is fed to the engine
+    as it arrives; alarm changes are printed with their latency.
+*/
+
+#define W1_SCL 39  // PA13
+#define W1_SDA 28  // PA12
+
+TwiPinPair portSensorsA(W1_SCL, W1_SDA);
+TwoWire WireSensorA(&sercom1, W1_SDA, W1_SCL);
+I2CAsyncBus busA(&WireSensorA, SERCOM1);
+void SERCOM1_Handler() { busA.onService(); }
+
+#define ECG_MODULE_ADDR  0x2A
+#define SPO2_MODULE_ADDR 0x2B
+#define ECG_REG_HEART_RATE 0x12  // HEART_RATE .. LEAD_CHANGES, 12 bytes
+#define SPO2_REG_SPO2      0x06  // SPO2 .. BEAT_COUNT, 10 bytes
+
+HubScheduler hub;
+AlarmEngine alarms;
+int8_t ecgId, spo2Id;
+int8_t heartRate, leads, spo2;
+
+uint16_t getU16(const uint8_t* data) {
+  return ((uint16_t)data[0] << 8) | data[1];
+}
+
+void setup() {
+  Serial.begin(115200);
+
+  WireSensorA.begin();
+  portSensorsA.setPinPeripheralAltStates();
+  busA.begin();
+  const int8_t a = hub.addBus(&busA);
+  ecgId  = hub.addModule(a, ECG_MODULE_ADDR, ECG_REG_HEART_RATE, 12, 200000);  // 5 Hz
+  spo2Id = hub.addModule(a, SPO2_MODULE_ADDR, SPO2_REG_SPO2, 10, 200000);      // 5 Hz
+
+  heartRate = alarms.addChannel(25);  // 5 s at 5 Hz
+  leads     = alarms.addChannel(1);
+  spo2      = alarms.addChannel(50);  // 10 s
+
+  // channel, source, compare, priority, threshold, hysteresis, delay (samples)
+  alarms.addRule({ (uint8_t)heartRate, ALARM_VALUE, ALARM_ABOVE, 2, 1500, 50, 10 });  // HR > 150 bpm for 2 s
+  alarms.addRule({ (uint8_t)heartRate, ALARM_MAX, ALARM_BELOW, 2, 400, 20, 0 });      // HR < 40 bpm for 5 s
+  alarms.addRule({ (uint8_t)heartRate, ALARM_TREND, ALARM_ABOVE, 1, 300, 50, 0 });    // HR up 30 bpm in 5 s
+  alarms.addRule({ (uint8_t)leads, ALARM_VALUE, ALARM_ANY_BIT, 1, 0x07, 0, 0 });      // Any lead off
+  alarms.addRule({ (uint8_t)spo2, ALARM_MEAN, ALARM_BELOW, 2, 900, 10, 0 });          // SpO2 < 90 % over 10 s
+}
+
+void loop() {
+  hub.poll();
+
+  HubReading reading;
+  while (hub.read(reading)) {
+    if (!reading.ok) continue;
+    if (reading.module == ecgId) {
+      alarms.update(heartRate, getU16(reading.data), reading.timestampUs);
+      alarms.update(leads, reading.data[10], reading.timestampUs);
+    } else if (reading.module == spo2Id) {
+      const uint16_t value = getU16(reading.data);
+      if (value != 0) alarms.update(spo2, value, reading.timestampUs);  // 0 = no reading
+    }
+  }
+
+  AlarmEvent event;
+  while (alarms.read(event)) {
+    Serial.print(event.active ? "ALARM " : "clear ");
+    Serial.print(event.rule);
+    Serial.print(" value ");
+    Serial.print(event.value);
+    Serial.print(" latency ");
+    Serial.print(event.latencyUs);
+    Serial.println(" us");
+  }
+}
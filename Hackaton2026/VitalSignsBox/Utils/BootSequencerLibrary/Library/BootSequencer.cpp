@@ -0,0 +1,168 @@
+/*
+    BootSequencer.cpp
+
+    Parallel device start-up implementation
+*/
+
+#include "BootSequencer.h"
+
+BootSequencer::BootSequencer()
+    : _count(0)
+    , _retryMs(BOOT_DEFAULT_RETRY_MS)
+{
+}
+
+int8_t BootSequencer::add(BootDevice* device, int8_t after, uint16_t timeoutMs) {
+    if (device == nullptr || _count >= BOOT_SEQUENCER_MAX) return -1;
+    if (after >= (int8_t)_count) return -1;  // Parents come first: no cycles
+
+    Entry& entry = _entries[_count];
+    entry.device = device;
+    entry.parent = after;
+    entry.state = BOOT_WAITING;
+    entry.step = 0;
+    entry.timeoutMs = timeoutMs;
+    entry.startMs = 0;
+    entry.dueMs = device->getPowerUpMs();  // Counted from power-on, not from add()
+    entry.doneMs = 0;
+    return _count++;
+}
+
+void BootSequencer::setRetryMs(uint16_t ms) {
+    _retryMs = ms;
+}
+
+bool BootSequencer::update() {
+    const uint32_t now = millis();
+    bool done = true;
+
+    // Parents have lower ids: a parent that becomes ready starts its
+    // children in the same pass
+    for (uint8_t i = 0; i < _count; i++) {
+        Entry& entry = _entries[i];
+        if (entry.state == BOOT_WAITING) {
+            const BootState parent = entry.parent < 0 ? BOOT_READY : _entries[entry.parent].state;
+            if (parent == BOOT_FAILED) {
+                finish(entry, BOOT_FAILED, now);
+            } else if (parent == BOOT_READY && reached(now, entry.dueMs)) {
+                entry.state = BOOT_RUNNING;
+                entry.startMs = now;
+            }
+        }
+        if (entry.state == BOOT_RUNNING) advance(entry, now);
+        if (entry.state == BOOT_WAITING || entry.state == BOOT_RUNNING) done = false;
+    }
+    return done;
+}
+
+void BootSequencer::run() {
+    while (!update()) {
+        yield();
+    }
+}
+
+bool BootSequencer::isDone() const {
+    for (uint8_t i = 0; i < _count; i++) {
+        if (_entries[i].state == BOOT_WAITING || _entries[i].state == BOOT_RUNNING) return false;
+    }
+    return true;
+}
+
+bool BootSequencer::isReady(uint8_t id) const {
+    return id < _count && _entries[id].state == BOOT_READY;
+}
+
+BootState BootSequencer::getState(uint8_t id) const {
+    return id < _count ? _entries[id].state : BOOT_FAILED;
+}
+
+uint32_t BootSequencer::getDoneMs(uint8_t id) const {
+    return id < _count ? _entries[id].doneMs : 0;
+}
+
+uint8_t BootSequencer::getReadyCount() const {
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < _count; i++) {
+        if (_entries[i].state == BOOT_READY) count++;
+    }
+    return count;
+}
+
+uint8_t BootSequencer::getFailedCount() const {
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < _count; i++) {
+        if (_entries[i].state == BOOT_FAILED) count++;
+    }
+    return count;
+}
+
+// PRIVATE
+
+void BootSequencer::advance(Entry& entry, uint32_t now) {
+    if (now - entry.startMs >= entry.timeoutMs) {
+        finish(entry, BOOT_FAILED, now);
+        return;
+    }
+    if (!reached(now, entry.dueMs)) return;
+
+    const int16_t result = entry.device->bootStep(entry.step);
+    if (result == BootDevice::DONE) {
+        finish(entry, BOOT_READY, now);
+    } else if (result == BootDevice::RETRY) {
+        entry.dueMs = now + _retryMs;
+    } else if (result < 0) {
+        finish(entry, BOOT_FAILED, now);
+    } else {
+        entry.step++;
+        entry.dueMs = now + result;
+    }
+}
+
+void BootSequencer::finish(Entry& entry, BootState state, uint32_t now) {
+    entry.state = state;
+    entry.doneMs = now;
+}
+
+bool BootSequencer::reached(uint32_t now, uint32_t deadline) {
+    return (int32_t)(now - deadline) >= 0;
+}
+
+// ============================================================================
+// Adapters
+// ============================================================================
+
+I2CBootDevice::I2CBootDevice(TwoWire& wire, uint8_t address, const uint8_t* command,
+                             uint8_t length, uint16_t powerUpMs)
+    : _wire(wire)
+    , _address(address)
+    , _length(command == nullptr ? 0 : (length > BOOT_SEQUENCER_MAX_COMMAND ? BOOT_SEQUENCER_MAX_COMMAND : length))
+    , _powerUpMs(powerUpMs)
+{
+    for (uint8_t i = 0; i < _length; i++) _command[i] = command[i];
+}
+
+uint16_t I2CBootDevice::getPowerUpMs() const {
+    return _powerUpMs;
+}
+
+int16_t I2CBootDevice::bootStep(uint8_t step) {
+    (void)step;
+    _wire.beginTransmission(_address);
+    for (uint8_t i = 0; i < _length; i++) _wire.write(_command[i]);
+    return _wire.endTransmission() == 0 ? DONE : RETRY;
+}
+
+CallbackBootDevice::CallbackBootDevice(StepFn onStep, void* context, uint16_t powerUpMs)
+    : _onStep(onStep)
+    , _context(context)
+    , _powerUpMs(powerUpMs)
+{
+}
+
+uint16_t CallbackBootDevice::getPowerUpMs() const {
+    return _powerUpMs;
+}
+
+int16_t CallbackBootDevice::bootStep(uint8_t step) {
+    return _onStep ? _onStep(step, _context) : DONE;
+}
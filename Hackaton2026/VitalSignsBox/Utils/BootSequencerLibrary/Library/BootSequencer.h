@@ -0,0 +1,177 @@
+/*
+    BootSequencer.h
+
+    Device start-up in parallel instead of one delay() after another
+
+    A setup() that waits 1.5 s for the serial port, then for every sensor
+    in turn, boots in the sum of all those waits. BootSequencer runs the
+    init sequence of every device as a state machine: each step is one
+    short transaction, followed by the wait the device really needs before
+    the next. While one device waits the others make progress, on their
+    own bus or the same one, so booting takes as long as the slowest
+    device rather than all of them together.
+
+    A device can depend on another one (e.g. a sensor on a bus switch, or
+    behind a rail that another device enables): it starts once its parent
+    is ready, and fails when the parent fails. A device that does not
+    finish within its timeout fails too, without holding up the others.
+    getState() reports the outcome per device.
+
+    Adapters for an I2C device that only has to answer (and optionally
+    take one command) and for plain callbacks are included.
+*/
+
+#ifndef BOOT_SEQUENCER_H
+#define BOOT_SEQUENCER_H
+
+#include <Arduino.h>
+#include <Wire.h>
+
+#define BOOT_SEQUENCER_MAX 8
+#define BOOT_SEQUENCER_MAX_COMMAND 4     // Bytes in an I2CBootDevice command
+#define BOOT_DEFAULT_TIMEOUT_MS 1000     // From the first step until the device must be ready
+#define BOOT_DEFAULT_RETRY_MS 10         // Between polls of a step that returned RETRY
+
+enum BootState : uint8_t {
+    BOOT_WAITING,   // For its parent, or for its power-up time
+    BOOT_RUNNING,   // Init sequence in progress
+    BOOT_READY,
+    BOOT_FAILED     // A step failed, the timeout ran out or the parent failed
+};
+
+/**
+ * A device with a non-blocking init sequence
+ */
+class BootDevice {
+public:
+    static const int16_t DONE = -1;    // Sequence complete, device ready
+    static const int16_t FAIL = -2;    // Give up
+    static const int16_t RETRY = -3;   // Run the same step again after the retry time
+
+    virtual ~BootDevice() {}
+
+    /**
+     * Time from power-on (millis() 0) until the device takes its first
+     * command
+     */
+    virtual uint16_t getPowerUpMs() const { return 0; }
+
+    /**
+     * Run one step of the init sequence without blocking
+     * @param step 0 for the first step, counting up
+     * @return Milliseconds before the next step (0: next update()),
+     *         DONE, FAIL or RETRY
+     */
+    virtual int16_t bootStep(uint8_t step) = 0;
+};
+
+class BootSequencer {
+public:
+    BootSequencer();
+
+    /**
+     * Add a device
+     * @param after     Id of a device that must be ready first, -1 for none
+     * @param timeoutMs From the first step until it must be ready
+     * @return Device id, or -1 when full or when after is invalid
+     */
+    int8_t add(BootDevice* device, int8_t after = -1, uint16_t timeoutMs = BOOT_DEFAULT_TIMEOUT_MS);
+
+    /**
+     * Wait between polls of a step that returned RETRY
+     */
+    void setRetryMs(uint16_t ms);
+
+    /**
+     * Run the steps that are due; call every loop() until it returns true
+     * @return true when every device is READY or FAILED
+     */
+    bool update();
+
+    /**
+     * Call update() until every device is done: blocks for as long as the
+     * slowest device takes
+     */
+    void run();
+
+    bool isDone() const;
+    bool isReady(uint8_t id) const;
+    BootState getState(uint8_t id) const;
+
+    /**
+     * millis() when the device became READY or FAILED, 0 while it is not
+     */
+    uint32_t getDoneMs(uint8_t id) const;
+
+    uint8_t getReadyCount() const;
+    uint8_t getFailedCount() const;
+
+private:
+    struct Entry {
+        BootDevice* device;
+        int8_t parent;
+        BootState state;
+        uint8_t step;
+        uint16_t timeoutMs;
+        uint32_t startMs;        // First step
+        uint32_t dueMs;          // Next step
+        uint32_t doneMs;
+    };
+
+    void advance(Entry& entry, uint32_t now);
+    void finish(Entry& entry, BootState state, uint32_t now);
+    static bool reached(uint32_t now, uint32_t deadline);
+
+    Entry _entries[BOOT_SEQUENCER_MAX];
+    uint8_t _count;
+    uint16_t _retryMs;
+};
+
+// ============================================================================
+// Adapters
+// ============================================================================
+
+/**
+ * I2C device that is ready once it acknowledges, optionally after one
+ * command (e.g. the MCP3426 configuration byte); polled until it answers
+ */
+class I2CBootDevice : public BootDevice {
+public:
+    /**
+     * @param command Bytes written, copied (at most BOOT_SEQUENCER_MAX_COMMAND);
+     *                nullptr (or length 0) only probes the address
+     */
+    I2CBootDevice(TwoWire& wire, uint8_t address, const uint8_t* command = nullptr,
+                  uint8_t length = 0, uint16_t powerUpMs = 0);
+
+    uint16_t getPowerUpMs() const;
+    int16_t bootStep(uint8_t step);
+
+private:
+    TwoWire& _wire;
+    uint8_t _address;
+    uint8_t _command[BOOT_SEQUENCER_MAX_COMMAND];
+    uint8_t _length;
+    uint16_t _powerUpMs;
+};
+
+/**
+ * Init sequence in a function, e.g. a driver's own begin steps or the
+ * serial port: return Serial ? BootDevice::DONE : BootDevice::RETRY
+ */
+class CallbackBootDevice : public BootDevice {
+public:
+    typedef int16_t (*StepFn)(uint8_t step, void* context);
+
+    CallbackBootDevice(StepFn onStep, void* context = nullptr, uint16_t powerUpMs = 0);
+
+    uint16_t getPowerUpMs() const;
+    int16_t bootStep(uint8_t step);
+
+private:
+    StepFn _onStep;
+    void* _context;
+    uint16_t _powerUpMs;
+};
+
+#endif // BOOT_SEQUENCER_H
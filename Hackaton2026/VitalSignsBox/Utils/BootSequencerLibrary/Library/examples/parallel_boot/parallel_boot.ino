@@ -0,0 +1,71 @@
+#include <Wire.h>
+#include "BootSequencer.h"
+
+/*
+    Three devices that used to boot one delay() after another: the serial
+    port, an MCP3426 on each sensor bus and a device behind a load switch
+    that needs 50 ms after its rail comes up. With the BootSequencer they
+    start together and setup() takes as long as the slowest one.
+*/
+
+#define W1_SCL 39  // PA13
+#define W1_SDA 28  // PA12
+#define W2_SCL 13  // PA17
+#define W2_SDA 11  // PA16
+
+TwoWire WireSensorA(&sercom1, W1_SDA, W1_SCL);
+TwoWire WireSensorB(&sercom4, W2_SDA, W2_SCL);
+
+#define MCP3426_ADDR 0x68
+#define RAIL_PIN 12
+#define RAIL_DEVICE_ADDR 0x29
+#define RAIL_DEVICE_POWER_UP_MS 50
+
+// Step 0 switches the rail on, step 1 (after the power-up time) is done
+int16_t railStep(uint8_t step, void* context) {
+  (void)context;
+  if (step > 0) return BootDevice::DONE;
+  pinMode(RAIL_PIN, OUTPUT);
+  digitalWrite(RAIL_PIN, HIGH);
+  return RAIL_DEVICE_POWER_UP_MS;
+}
+
+int16_t serialStep(uint8_t step, void* context) {
+  (void)step;
+  (void)context;
+  return Serial ? BootDevice::DONE : BootDevice::RETRY;
+}
+
+const uint8_t mcpConfig[] = { 0x18 };  // Continuous, 16-bit, CH1
+
+BootSequencer boot;
+CallbackBootDevice serialBoot(serialStep);
+I2CBootDevice adcA(WireSensorA, MCP3426_ADDR, mcpConfig, 1);
+I2CBootDevice adcB(WireSensorB, MCP3426_ADDR, mcpConfig, 1);
+CallbackBootDevice rail(railStep);
+I2CBootDevice railDevice(WireSensorA, RAIL_DEVICE_ADDR);
+
+const char* const names[] = { "Serial", "ADC A", "ADC B", "Rail", "Rail device" };
+
+void setup() {
+  Serial.begin(115200);
+  WireSensorA.begin();
+  WireSensorB.begin();
+
+  boot.add(&serialBoot, -1, 1500);
+  boot.add(&adcA);
+  boot.add(&adcB);
+  const int8_t railId = boot.add(&rail);
+  boot.add(&railDevice, railId);  // Probed once the rail is up
+  boot.run();
+
+  for (uint8_t i = 0; i < 5; i++) {
+    Serial.print(names[i]);
+    Serial.print(boot.isReady(i) ? ": ready at " : ": failed at ");
+    Serial.print(boot.getDoneMs(i));
+    Serial.println(" ms");
+  }
+}
+
+void loop() {
+}
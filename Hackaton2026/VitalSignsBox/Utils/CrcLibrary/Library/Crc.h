@@ -0,0 +1,91 @@
+/*
+    Crc.h
+
+    CRC-8, CRC-16 and CRC-32 for every frame protocol of the box
+
+    The frame libraries each had their own bit-by-bit CRC, 8 shifts per
+    byte. Here the checks are shared and table driven:
+
+    - Crc8:  poly 0x07, init 0x00 (TraceRecorder frames, WaveCodec
+             header) or the Sensirion CRC, poly 0x31, init 0xFF (SHT3x)
+    - Crc16: CRC-16/CCITT-FALSE, poly 0x1021, init 0xFFFF (HubLink
+             frames, WaveCodec payload)
+    - Crc32: CRC-32 as in Ethernet and zlib, slice-by-4 in software. On
+             the SAMD21 the word aligned middle of a long buffer is run
+             through the CRC32 engine of the DSU instead
+
+    All three are incremental: update() over the scattered parts of a
+    frame (header, payload) gives the same value as one pass over all of
+    it. The tables are const, so they stay in flash.
+
+    The code is plain C++ and builds on the host too, for the readers.
+*/
+
+#ifndef CRC_H
+#define CRC_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+class Crc8 {
+public:
+    enum Variant : uint8_t {
+        SMBUS,      // Poly 0x07, init 0x00
+        SENSIRION   // Poly 0x31, init 0xFF
+    };
+
+    explicit Crc8(Variant variant = SMBUS);
+
+    void reset();
+    Crc8& update(const uint8_t* data, size_t length);
+    Crc8& update(uint8_t data) { _crc = _table[_crc ^ data]; return *this; }
+    uint8_t value() const { return _crc; }
+
+    static uint8_t compute(const uint8_t* data, size_t length, Variant variant = SMBUS);
+
+private:
+    const uint8_t* _table;
+    uint8_t _init;
+    uint8_t _crc;
+};
+
+class Crc16 {
+public:
+    Crc16() : _crc(INIT) {}
+
+    void reset() { _crc = INIT; }
+    Crc16& update(const uint8_t* data, size_t length);
+    Crc16& update(uint8_t data);
+    uint16_t value() const { return _crc; }
+
+    static uint16_t compute(const uint8_t* data, size_t length);
+
+private:
+    static const uint16_t INIT = 0xFFFF;
+    uint16_t _crc;
+};
+
+class Crc32 {
+public:
+    // Shorter buffers are cheaper in software than setting up the DSU
+    static const size_t HARDWARE_MIN_BYTES = 64;
+
+    Crc32() : _state(INIT) {}
+
+    void reset() { _state = INIT; }
+    Crc32& update(const uint8_t* data, size_t length);
+    uint32_t value() const { return ~_state; }
+
+    static uint32_t compute(const uint8_t* data, size_t length);
+
+    /**
+     * True on the SAMD21, where long buffers go through the DSU
+     */
+    static bool hasHardware();
+
+private:
+    static const uint32_t INIT = 0xFFFFFFFF;
+    uint32_t _state;  // Not complemented, as the DSU takes and leaves it
+};
+
+#endif // CRC_H
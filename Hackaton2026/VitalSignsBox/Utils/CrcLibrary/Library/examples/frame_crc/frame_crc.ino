@@ -0,0 +1,44 @@
+#include "Crc.h"
+
+/*
+    Check values of the CRCs, a CRC-32 over a frame in two parts and the
+    time the CRC-32 takes for a 4 KB block.
+*/
+
+#define BLOCK_BYTES 4096
+
+uint8_t block[BLOCK_BYTES];
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial && millis() < 3000) {}
+
+  const uint8_t check[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+  Serial.println(Crc8::compute(check, sizeof(check)), HEX);   // F4
+  Serial.println(Crc16::compute(check, sizeof(check)), HEX);  // 29B1
+  Serial.println(Crc32::compute(check, sizeof(check)), HEX);  // CBF43926
+
+  // SHT3x measurement word 0xBEEF, followed by its CRC 0x92
+  const uint8_t word[] = {0xBE, 0xEF};
+  Serial.println(Crc8::compute(word, 2, Crc8::SENSIRION), HEX);
+
+  // Header and payload in separate buffers: one CRC over both
+  const uint8_t header[] = {0xA5, 0x01, 0x00, 0x04};
+  const uint8_t payload[] = {0x10, 0x20, 0x30, 0x40};
+  Crc32 crc;
+  crc.update(header, sizeof(header)).update(payload, sizeof(payload));
+  Serial.println(crc.value(), HEX);
+
+  for (uint16_t i = 0; i < BLOCK_BYTES; i++) block[i] = (uint8_t)i;
+  uint32_t start = micros();
+  uint32_t value = Crc32::compute(block, BLOCK_BYTES);
+  uint32_t elapsed = micros() - start;
+  Serial.print("CRC-32 of 4 KB: ");
+  Serial.print(value, HEX);
+  Serial.print(" in ");
+  Serial.print(elapsed);
+  Serial.println(Crc32::hasHardware() ? " us (DSU)" : " us");
+}
+
+void loop() {
+}
@@ -0,0 +1,404 @@
+/*
+    HubLink.cpp
+
+    SPI slave with DMA (SAMD21) and COBS UART modes of the hub link
+*/
+
+#include "HubLink.h"
+
+#define CHANNEL_MASK (HUB_LINK_CHANNEL_BYTES - 1)
+
+#if HUB_LINK_SPI
+// DMAC descriptors of all channels, unless the sketch already set them up
+static DmacDescriptor linkDescriptors[DMAC_CH_NUM] __attribute__((aligned(16)));
+static DmacDescriptor linkWriteback[DMAC_CH_NUM] __attribute__((aligned(16)));
+
+static inline DmacDescriptor* descriptors() {
+    return (DmacDescriptor*)DMAC->BASEADDR.reg;
+}
+
+static inline DmacDescriptor* writeback() {
+    return (DmacDescriptor*)DMAC->WRBADDR.reg;
+}
+
+HubLink::HubLink(Sercom* hw, SercomSpiTXPad txPad, SercomRXPad rxPad, uint8_t readyPin, uint8_t dmaTx, uint8_t dmaRx)
+    : _serial(nullptr)
+    , _hw(hw)
+    , _txPad(txPad)
+    , _rxPad(rxPad)
+    , _readyPin(readyPin)
+    , _dmaTx(dmaTx)
+    , _dmaRx(dmaRx)
+    , _bulk(_frames, HUB_LINK_BUFFERS, 0)
+    , _priority(_priorityFrames, HUB_LINK_PRIORITY_BUFFERS, HubLinkFrame::FLAG_PRIORITY)
+    , _sending(&_bulk)
+    , _armed(false)
+    , _maxLatencyUs(HUB_LINK_DEFAULT_LATENCY_US)
+    , _nextChannel(0)
+    , _credited(false)
+    , _framesSent(0)
+    , _priorityFramesSent(0)
+    , _lastAck(0)
+    , _dropped(0)
+    , _encodedBytes(0)
+    , _written(0)
+{
+}
+#endif
+
+HubLink::HubLink(Stream& serial)
+    : _serial(&serial)
+#if HUB_LINK_SPI
+    , _hw(nullptr)
+    , _txPad(SPI_PAD_2_SCK_3)
+    , _rxPad(SERCOM_RX_PAD_0)
+    , _readyPin(0)
+    , _dmaTx(0)
+    , _dmaRx(0)
+#endif
+    , _bulk(_frames, HUB_LINK_BUFFERS, 0)
+    , _priority(_priorityFrames, HUB_LINK_PRIORITY_BUFFERS, HubLinkFrame::FLAG_PRIORITY)
+    , _sending(&_bulk)
+    , _armed(false)
+    , _maxLatencyUs(HUB_LINK_DEFAULT_LATENCY_US)
+    , _nextChannel(0)
+    , _credited(false)
+    , _framesSent(0)
+    , _priorityFramesSent(0)
+    , _lastAck(0)
+    , _dropped(0)
+    , _encodedBytes(0)
+    , _written(0)
+{
+}
+
+void HubLink::begin() {
+    for (uint8_t i = 0; i < HUB_LINK_BUFFERS; i++) HubLinkFrame::begin(_frames[i]);
+    for (uint8_t i = 0; i < HUB_LINK_PRIORITY_BUFFERS; i++) HubLinkFrame::begin(_priorityFrames[i]);
+    memset(_ack, 0, sizeof(_ack));
+#if HUB_LINK_SPI
+    if (_serial != nullptr) return;
+    pinMode(_readyPin, OUTPUT);
+    digitalWrite(_readyPin, LOW);
+    setupDma();
+    setupSercom();
+#endif
+}
+
+void HubLink::setMaxLatency(uint32_t latencyUs) {
+    _maxLatencyUs = latencyUs;
+}
+
+void HubLink::setWeight(uint8_t channel, uint8_t weight) {
+    if (channel >= HUB_LINK_CHANNELS) return;
+    _channels[channel].weight = weight > 0 ? weight : 1;
+}
+
+// Bulk: into the channel ring as a frame record; schedule() moves it on.
+// The rings only fill up while the bulk frames are full.
+bool HubLink::add(uint8_t module, uint32_t timestampUs, const uint8_t* data, uint8_t length) {
+    Channel& channel = _channels[module % HUB_LINK_CHANNELS];
+    const uint16_t bytes = (uint16_t)(HubLinkFrame::RECORD_HEADER + length);
+    if (bytes > HUB_LINK_CHANNEL_BYTES - channel.used) schedule();
+    if (bytes > HUB_LINK_CHANNEL_BYTES - channel.used) {
+        channel.dropped++;
+        _dropped++;
+        _bulk.droppedSinceFrame++;
+        return false;
+    }
+
+    const uint8_t header[HubLinkFrame::RECORD_HEADER] = {
+        module, length, (uint8_t)(timestampUs >> 24), (uint8_t)(timestampUs >> 16),
+        (uint8_t)(timestampUs >> 8), (uint8_t)timestampUs
+    };
+    uint16_t tail = (uint16_t)(channel.head + channel.used);
+    for (uint8_t i = 0; i < HubLinkFrame::RECORD_HEADER; i++) channel.ring[tail++ & CHANNEL_MASK] = header[i];
+    for (uint8_t i = 0; i < length; i++) channel.ring[tail++ & CHANNEL_MASK] = data[i];
+    channel.used = (uint16_t)(channel.used + bytes);
+    return true;
+}
+
+bool HubLink::addPriority(uint8_t module, uint32_t timestampUs, const uint8_t* data, uint8_t length) {
+    if (length > HubLinkFrame::MAX_PAYLOAD - HubLinkFrame::RECORD_HEADER ||
+        !append(_priority, module, timestampUs, data, length)) {
+        _dropped++;
+        _priority.droppedSinceFrame++;
+        return false;
+    }
+    return true;
+}
+
+// Into the fill frame of lane; a full fill frame is closed first
+bool HubLink::append(Lane& lane, uint8_t module, uint32_t timestampUs, const uint8_t* data, uint8_t length) {
+    uint8_t* frame = lane.frames[lane.fill];
+    if (!HubLinkFrame::append(frame, module, timestampUs, data, length)) {
+        close(lane);
+        frame = lane.frames[lane.fill];
+        // Still the full frame: every other buffer is waiting for the Pi
+        if (HubLinkFrame::getRecords(frame) > 0 || !HubLinkFrame::append(frame, module, timestampUs, data, length)) {
+            return false;
+        }
+    }
+    if (HubLinkFrame::getRecords(frame) == 1) lane.fillStartUs = micros();
+    return true;
+}
+
+// Hand the fill frame over and start the next one, if a buffer is free
+void HubLink::close(Lane& lane) {
+    if (lane.queued >= lane.buffers - 1) return;
+    HubLinkFrame::finish(lane.frames[lane.fill], lane.sequence++, lane.droppedSinceFrame, lane.flags);
+    lane.droppedSinceFrame = 0;
+
+    noInterrupts();
+    lane.queued++;
+    interrupts();
+    lane.fill = (uint8_t)((lane.fill + 1) % lane.buffers);
+    HubLinkFrame::begin(lane.frames[lane.fill]);
+}
+
+// Deficit round robin over the bulk channels: a visit adds weight x
+// HUB_LINK_QUANTUM bytes of credit, and the channel sends records while
+// the credit lasts. When the bulk buffers are full, the records wait in
+// their rings and the round resumes at the same channel in the next poll().
+void HubLink::schedule() {
+    uint8_t record[HubLinkFrame::RECORD_HEADER + 255];
+    uint8_t idle = 0;
+    while (idle < HUB_LINK_CHANNELS) {
+        Channel& channel = _channels[_nextChannel];
+        if (channel.used > 0) {
+            idle = 0;
+            if (!_credited) {
+                channel.deficit = (uint16_t)(channel.deficit + channel.weight * HUB_LINK_QUANTUM);
+                _credited = true;
+            }
+            while (channel.used > 0) {
+                const uint8_t length = channel.ring[(channel.head + 1) & CHANNEL_MASK];
+                const uint16_t bytes = (uint16_t)(HubLinkFrame::RECORD_HEADER + length);
+                if (bytes > channel.deficit) break;
+
+                for (uint16_t i = 0; i < bytes; i++) record[i] = channel.ring[(channel.head + i) & CHANNEL_MASK];
+                const uint32_t timestampUs = ((uint32_t)record[2] << 24) | ((uint32_t)record[3] << 16) |
+                                             ((uint32_t)record[4] << 8) | record[5];
+                if (!append(_bulk, record[0], timestampUs, record + HubLinkFrame::RECORD_HEADER, length)) return;
+                channel.head = (uint16_t)((channel.head + bytes) & CHANNEL_MASK);
+                channel.used = (uint16_t)(channel.used - bytes);
+                channel.deficit = (uint16_t)(channel.deficit - bytes);
+            }
+        } else {
+            idle++;
+        }
+        if (channel.used == 0) channel.deficit = 0;  // No credit saved up while idle
+        _credited = false;
+        _nextChannel = (uint8_t)((_nextChannel + 1) % HUB_LINK_CHANNELS);
+    }
+}
+
+HubLink::Lane& HubLink::nextLane() {
+    return _priority.queued > 0 ? _priority : _bulk;
+}
+
+void HubLink::poll() {
+    schedule();
+    if (HubLinkFrame::getRecords(_priority.frames[_priority.fill]) > 0) close(_priority);  // No latency
+    if (HubLinkFrame::getRecords(_bulk.frames[_bulk.fill]) > 0 && micros() - _bulk.fillStartUs >= _maxLatencyUs) {
+        close(_bulk);
+    }
+
+    if (_serial != nullptr) {
+        pollUart();
+        return;
+    }
+#if HUB_LINK_SPI
+    noInterrupts();
+    if (!_armed && (_priority.queued > 0 || _bulk.queued > 0)) startTransfer();
+    interrupts();
+#endif
+}
+
+// Write as much of the oldest frame as the UART buffer takes, never wait;
+// the next frame is picked when the previous one is complete
+void HubLink::pollUart() {
+    const int room = _serial->availableForWrite();
+    if (room <= 0) return;  // Not committed to a frame before the first byte goes out
+    if (_encodedBytes == 0) {
+        if (_priority.queued == 0 && _bulk.queued == 0) return;
+        _sending = &nextLane();
+        const uint8_t* frame = _sending->frames[_sending->head];
+        const uint16_t bytes = (uint16_t)(HubLinkFrame::HEADER_BYTES + HubLinkFrame::getPayloadBytes(frame) + 2);
+        _encodedBytes = (uint16_t)HubLinkFrame::cobsEncode(frame, bytes, _encoded);
+        _written = 0;
+    }
+
+    const uint16_t chunk = (uint16_t)min((int)(_encodedBytes - _written), room);
+    _written = (uint16_t)(_written + _serial->write(_encoded + _written, chunk));
+    if (_written < _encodedBytes) return;
+
+    Lane& lane = *_sending;
+    _framesSent++;
+    if (&lane == &_priority) _priorityFramesSent++;
+    _encodedBytes = 0;
+    lane.head = (uint8_t)((lane.head + 1) % lane.buffers);
+    lane.queued--;
+}
+
+uint32_t HubLink::getFramesSent() const {
+    return _framesSent;
+}
+
+uint32_t HubLink::getPriorityFramesSent() const {
+    return _priorityFramesSent;
+}
+
+uint32_t HubLink::getDropped() const {
+    return _dropped;
+}
+
+uint32_t HubLink::getChannelDropped(uint8_t channel) const {
+    return channel < HUB_LINK_CHANNELS ? _channels[channel].dropped : 0;
+}
+
+uint16_t HubLink::getLastAck() const {
+    return _lastAck;
+}
+
+uint8_t HubLink::getQueued() const {
+    return (uint8_t)(_bulk.queued + _priority.queued);
+}
+
+#if HUB_LINK_SPI
+uint8_t HubLink::sercomIndex() const {
+    if (_hw == SERCOM0) return 0;
+    if (_hw == SERCOM1) return 1;
+    if (_hw == SERCOM2) return 2;
+    if (_hw == SERCOM3) return 3;
+#if defined(SERCOM4)
+    if (_hw == SERCOM4) return 4;
+#endif
+#if defined(SERCOM5)
+    if (_hw == SERCOM5) return 5;
+#endif
+    return 0;
+}
+
+void HubLink::setupDma() {
+    PM->AHBMASK.reg |= PM_AHBMASK_DMAC;
+    PM->APBBMASK.reg |= PM_APBBMASK_DMAC;
+    if (DMAC->BASEADDR.reg == 0) {
+        DMAC->CTRL.reg = 0;
+        DMAC->CTRL.reg = DMAC_CTRL_SWRST;
+        while (DMAC->CTRL.bit.SWRST);
+        DMAC->BASEADDR.reg = (uint32_t)linkDescriptors;
+        DMAC->WRBADDR.reg = (uint32_t)linkWriteback;
+        DMAC->CTRL.reg = DMAC_CTRL_DMAENABLE | DMAC_CTRL_LVLEN(0xF);
+    }
+    stopChannel(_dmaTx);
+    stopChannel(_dmaRx);
+}
+
+// SPI slave, mode 0, MSB first; SS low/high raise SSL/TXC
+void HubLink::setupSercom() {
+    const uint8_t index = sercomIndex();
+    PM->APBCMASK.reg |= PM_APBCMASK_SERCOM0 << index;
+    GCLK->CLKCTRL.reg = GCLK_CLKCTRL_ID(SERCOM0_GCLK_ID_CORE + index) | GCLK_CLKCTRL_GEN_GCLK0 | GCLK_CLKCTRL_CLKEN;
+    while (GCLK->STATUS.bit.SYNCBUSY);
+
+    SercomSpi& spi = _hw->SPI;
+    spi.CTRLA.bit.ENABLE = 0;
+    while (spi.SYNCBUSY.bit.ENABLE);
+    spi.CTRLA.bit.SWRST = 1;
+    while (spi.CTRLA.bit.SWRST || spi.SYNCBUSY.bit.SWRST);
+
+    spi.CTRLA.reg = SERCOM_SPI_CTRLA_MODE(0x2) | SERCOM_SPI_CTRLA_DOPO(_txPad) | SERCOM_SPI_CTRLA_DIPO(_rxPad);
+    spi.CTRLB.reg = SERCOM_SPI_CTRLB_RXEN | SERCOM_SPI_CTRLB_SSDE | SERCOM_SPI_CTRLB_PLOADEN;
+    while (spi.SYNCBUSY.bit.CTRLB);
+    spi.INTENSET.reg = SERCOM_SPI_INTENSET_SSL | SERCOM_SPI_INTENSET_TXC;
+    spi.CTRLA.bit.ENABLE = 1;
+    while (spi.SYNCBUSY.bit.ENABLE);
+
+    const IRQn_Type irq = (IRQn_Type)(SERCOM0_IRQn + index);
+    NVIC_ClearPendingIRQ(irq);
+    NVIC_SetPriority(irq, 1);  // SS edges must not wait for the I2C buses
+    NVIC_EnableIRQ(irq);
+}
+
+void HubLink::stopChannel(uint8_t channel) {
+    DMAC->CHID.reg = DMAC_CHID_ID(channel);
+    DMAC->CHCTRLA.reg &= ~DMAC_CHCTRLA_ENABLE;
+    while (DMAC->CHCTRLA.bit.ENABLE);  // Also writes its descriptor back
+}
+
+void HubLink::armChannel(uint8_t channel, uint8_t trigger, uint8_t* buffer, bool transmit) {
+    DmacDescriptor& descriptor = descriptors()[channel];
+    descriptor.BTCTRL.reg = DMAC_BTCTRL_VALID | DMAC_BTCTRL_BEATSIZE_BYTE | DMAC_BTCTRL_BLOCKACT_NOACT |
+                            (transmit ? DMAC_BTCTRL_SRCINC : DMAC_BTCTRL_DSTINC);
+    descriptor.BTCNT.reg = HubLinkFrame::FRAME_BYTES;
+    // An incrementing address is given as the end of the block
+    if (transmit) {
+        descriptor.SRCADDR.reg = (uint32_t)(buffer + HubLinkFrame::FRAME_BYTES);
+        descriptor.DSTADDR.reg = (uint32_t)&_hw->SPI.DATA.reg;
+    } else {
+        descriptor.SRCADDR.reg = (uint32_t)&_hw->SPI.DATA.reg;
+        descriptor.DSTADDR.reg = (uint32_t)(buffer + HubLinkFrame::FRAME_BYTES);
+    }
+    descriptor.DESCADDR.reg = 0;
+    writeback()[channel].BTCNT.reg = HubLinkFrame::FRAME_BYTES;  // Stays if the Pi never clocks a byte
+
+    DMAC->CHID.reg = DMAC_CHID_ID(channel);
+    DMAC->CHCTRLA.reg = DMAC_CHCTRLA_SWRST;
+    while (DMAC->CHCTRLA.bit.SWRST);
+    DMAC->CHCTRLB.reg = DMAC_CHCTRLB_LVL(0) | DMAC_CHCTRLB_TRIGSRC(trigger) | DMAC_CHCTRLB_TRIGACT_BEAT;
+    DMAC->CHCTRLA.reg = DMAC_CHCTRLA_ENABLE;
+}
+
+// With interrupts off or from the handler: the oldest closed priority
+// frame goes out next, else the oldest bulk frame
+void HubLink::startTransfer() {
+    const uint8_t index = sercomIndex();
+    _sending = &nextLane();
+    armChannel(_dmaRx, (uint8_t)(SERCOM0_DMAC_ID_RX + 2 * index), _ack, false);
+    armChannel(_dmaTx, (uint8_t)(SERCOM0_DMAC_ID_TX + 2 * index), _sending->frames[_sending->head], true);  // Preloads byte 0
+    _armed = true;
+    digitalWrite(_readyPin, HIGH);
+}
+
+// SS went high: the Pi has clocked a frame, or given up part way
+void HubLink::endTransfer() {
+    stopChannel(_dmaTx);
+    stopChannel(_dmaRx);
+    if (!_armed) return;  // Clocked while nothing was ready: ignored
+    _armed = false;
+
+    if (writeback()[_dmaTx].BTCNT.reg == 0) {
+        Lane& lane = *_sending;
+        _framesSent++;
+        if (&lane == &_priority) _priorityFramesSent++;
+        lane.head = (uint8_t)((lane.head + 1) % lane.buffers);
+        lane.queued--;
+        if (_ack[0] == HubLinkFrame::ACK_1 && _ack[1] == HubLinkFrame::ACK_2) {
+            _lastAck = (uint16_t)((uint16_t)_ack[2] << 8 | _ack[3]);
+        }
+    } else {
+        setupSercom();  // Flush the byte left in DATA; the frame stays at the head of its lane
+    }
+    if (_priority.queued > 0 || _bulk.queued > 0) startTransfer();
+}
+
+void HubLink::onService() {
+    if (_hw == nullptr) return;
+    SercomSpi& spi = _hw->SPI;
+    const uint8_t flags = spi.INTFLAG.reg;
+
+    // Transfer started: the Pi sees ready low until the next frame is armed
+    if (flags & SERCOM_SPI_INTFLAG_SSL) {
+        spi.INTFLAG.reg = SERCOM_SPI_INTFLAG_SSL;
+        digitalWrite(_readyPin, LOW);
+    }
+    if (flags & SERCOM_SPI_INTFLAG_TXC) {
+        spi.INTFLAG.reg = SERCOM_SPI_INTFLAG_TXC;
+        endTransfer();
+    }
+}
+#else
+void HubLink::onService() {}
+void HubLink::startTransfer() {}
+#endif
@@ -0,0 +1,197 @@
+/*
+    HubLink.h
+
+    Fast SensorHub -> SensorHubPi link: SPI slave with DMA, or COBS over a UART
+
+    The hub batches the readings of all modules into HubLinkFrame frames
+    instead of printing them one by one at 115200 baud. In SPI mode the Pi
+    is the master: the hub keeps a closed frame armed in DMA and raises the
+    ready line; the Pi clocks one FRAME_BYTES transfer (8 MHz: 0.5 ms) and
+    sends its acknowledge in the same transfer. Neither side touches the
+    bytes one at a time: DMA moves them on the hub, the spidev driver on
+    the Pi. About 1 MB/s instead of 11.5 kB/s.
+
+    Flow control: the ready line is high while a frame is armed and drops
+    at the start of every transfer. A Pi that falls behind leaves up to
+    HUB_LINK_BUFFERS - 1 closed frames waiting on the hub; records that
+    still do not fit are dropped and counted in the next frame.
+
+    In UART mode (any target, e.g. Serial1 at 2 Mbaud) the same frames are
+    COBS encoded and written as fast as the UART takes them.
+
+    Two classes of traffic: alarm and status records (addPriority()) go in
+    small priority frames that are closed at the next poll() and sent
+    before any bulk frame at the next frame boundary, so their latency is
+    at most one bulk frame on the wire, whatever the waveform load. Bulk
+    records (add()) wait per channel and are moved into frames by deficit
+    round robin: under backlog every channel gets link bytes in proportion
+    to its weight, and a flooding channel only drops its own records.
+*/
+
+#ifndef HUB_LINK_H
+#define HUB_LINK_H
+
+#include <Arduino.h>
+#include "HubLinkFrame.h"
+
+#if defined(__SAMD21G18A__) || defined(__SAMD21J18A__) || defined(__SAMD21E18A__)
+#define HUB_LINK_SPI 1
+#include "SERCOM.h"
+#else
+#define HUB_LINK_SPI 0
+#endif
+
+#define HUB_LINK_BUFFERS 4                  // Frames: one filling, the rest closed or in DMA
+#define HUB_LINK_PRIORITY_BUFFERS 2         // Priority frames: one filling, one closed or in DMA
+#define HUB_LINK_CHANNELS 4                 // Bulk channels: module id % channels
+#define HUB_LINK_CHANNEL_BYTES 512          // Records waiting per channel (more than a frame), power of 2
+#define HUB_LINK_QUANTUM 64                 // Bytes a channel of weight 1 sends per round
+#define HUB_LINK_DEFAULT_LATENCY_US 10000   // Close a frame that is this old
+
+class HubLink {
+public:
+#if HUB_LINK_SPI
+    /**
+     * SPI slave mode
+     * @param hw       SERCOM of the link, e.g. SERCOM2 (pins muxed by the sketch)
+     * @param txPad    MISO / SCK / SS pads, as for SPIClass
+     * @param rxPad    MOSI pad
+     * @param readyPin Output to the Pi, high while a frame is waiting
+     * @param dmaTx    DMAC channel for MISO
+     * @param dmaRx    DMAC channel for MOSI
+     */
+    HubLink(Sercom* hw, SercomSpiTXPad txPad, SercomRXPad rxPad, uint8_t readyPin,
+            uint8_t dmaTx = 0, uint8_t dmaRx = 1);
+#endif
+
+    /**
+     * UART mode: COBS frames on serial (begin() it at the link baud rate first)
+     */
+    explicit HubLink(Stream& serial);
+
+    /**
+     * Set up SERCOM, DMAC and the ready pin (SPI), or nothing (UART)
+     */
+    void begin();
+
+    /**
+     * Queue one bulk reading, e.g. a HubReading's module, timestampUs and data
+     * @return false if it was dropped (its channel is full)
+     */
+    bool add(uint8_t module, uint32_t timestampUs, const uint8_t* data, uint8_t length);
+
+    /**
+     * Queue an alarm or status record on the priority lane: sent before
+     * all bulk frames, at the next frame boundary
+     * @return false if it was dropped (priority frames full, or too long)
+     */
+    bool addPriority(uint8_t module, uint32_t timestampUs, const uint8_t* data, uint8_t length);
+
+    /**
+     * Share of a bulk channel under backlog (default 1): weight x
+     * HUB_LINK_QUANTUM bytes per round
+     * @param channel Module id % HUB_LINK_CHANNELS
+     * @param weight  1 to 255
+     */
+    void setWeight(uint8_t channel, uint8_t weight);
+
+    /**
+     * Call every loop(): closes a frame that is older than the latency,
+     * arms it (SPI) or writes what the UART can take
+     */
+    void poll();
+
+    /**
+     * SPI mode: call from the SERCOMx_Handler of the link
+     */
+    void onService();
+
+    void setMaxLatency(uint32_t latencyUs);
+
+    uint32_t getFramesSent() const;     // Transfers completed (SPI) or frames written (UART)
+    uint32_t getPriorityFramesSent() const;
+    uint32_t getDropped() const;        // Records dropped in total
+    uint32_t getChannelDropped(uint8_t channel) const;
+    uint16_t getLastAck() const;        // Last bulk sequence the Pi confirmed (SPI)
+    uint8_t getQueued() const;          // Closed frames waiting, both lanes
+
+private:
+    // A set of frame buffers with its own sequence: bulk or priority
+    struct Lane {
+        Lane(uint8_t (*buffer)[HubLinkFrame::FRAME_BYTES], uint8_t count, uint8_t frameFlags)
+            : frames(buffer), buffers(count), flags(frameFlags), head(0), queued(0), fill(0),
+              fillStartUs(0), sequence(0), droppedSinceFrame(0) {}
+
+        uint8_t (*frames)[HubLinkFrame::FRAME_BYTES];
+        uint8_t buffers;
+        uint8_t flags;                  // HubLinkFrame flags of its frames
+        volatile uint8_t head;          // Oldest closed frame
+        volatile uint8_t queued;        // Closed frames
+        uint8_t fill;                   // Frame being filled
+        uint32_t fillStartUs;
+        uint16_t sequence;
+        uint16_t droppedSinceFrame;
+    };
+
+    // Bulk records waiting for the scheduler, as frame records
+    struct Channel {
+        Channel() : head(0), used(0), deficit(0), weight(1), dropped(0) {}
+
+        uint8_t ring[HUB_LINK_CHANNEL_BYTES];
+        uint16_t head;                  // Oldest record
+        uint16_t used;
+        uint16_t deficit;               // Bytes it may still send this round
+        uint8_t weight;
+        uint32_t dropped;
+    };
+
+    bool append(Lane& lane, uint8_t module, uint32_t timestampUs, const uint8_t* data, uint8_t length);
+    void close(Lane& lane);
+    void schedule();
+    Lane& nextLane();                   // Priority first
+    void startTransfer();               // SPI: arm the head frame of nextLane() and raise ready
+    void pollUart();
+#if HUB_LINK_SPI
+    void setupSercom();
+    void setupDma();
+    void armChannel(uint8_t channel, uint8_t trigger, uint8_t* buffer, bool transmit);
+    void stopChannel(uint8_t channel);
+    void endTransfer();
+    uint8_t sercomIndex() const;
+#endif
+
+    Stream* _serial;
+#if HUB_LINK_SPI
+    Sercom* _hw;
+    SercomSpiTXPad _txPad;
+    SercomRXPad _rxPad;
+    uint8_t _readyPin;
+    uint8_t _dmaTx;
+    uint8_t _dmaRx;
+#endif
+
+    uint8_t _frames[HUB_LINK_BUFFERS][HubLinkFrame::FRAME_BYTES];
+    uint8_t _priorityFrames[HUB_LINK_PRIORITY_BUFFERS][HubLinkFrame::FRAME_BYTES];
+    uint8_t _ack[HubLinkFrame::FRAME_BYTES];     // MOSI of the last transfer
+    Lane _bulk;
+    Lane _priority;
+    Lane* _sending;                     // Lane of the armed (SPI) or encoded (UART) frame
+    volatile bool _armed;
+    uint32_t _maxLatencyUs;
+
+    Channel _channels[HUB_LINK_CHANNELS];
+    uint8_t _nextChannel;               // Round robin position
+    bool _credited;                     // _nextChannel got its quantum this round
+
+    volatile uint32_t _framesSent;
+    volatile uint32_t _priorityFramesSent;
+    volatile uint16_t _lastAck;
+    uint32_t _dropped;
+
+    // UART: the encoded head frame and how much of it is written
+    uint8_t _encoded[HubLinkFrame::FRAME_BYTES + HubLinkFrame::FRAME_BYTES / 254 + 2];
+    uint16_t _encodedBytes;
+    uint16_t _written;
+};
+
+#endif // HUB_LINK_H
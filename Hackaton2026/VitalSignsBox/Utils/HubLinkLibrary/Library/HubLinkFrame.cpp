@@ -0,0 +1,133 @@
+/*
+    HubLinkFrame.cpp
+
+    Building, checking and COBS framing of SensorHub link frames
+*/
+
+#include "HubLinkFrame.h"
+#include "Crc.h"
+#include <string.h>
+
+static inline void put16(uint8_t* p, uint16_t value) {
+    p[0] = (uint8_t)(value >> 8);
+    p[1] = (uint8_t)value;
+}
+
+static inline uint16_t get16(const uint8_t* p) {
+    return (uint16_t)((uint16_t)p[0] << 8 | p[1]);
+}
+
+uint16_t HubLinkFrame::crc16(const uint8_t* data, size_t length) {
+    return Crc16::compute(data, length);
+}
+
+void HubLinkFrame::begin(uint8_t* frame) {
+    memset(frame, 0, HEADER_BYTES);
+    frame[0] = SYNC_1;
+    frame[1] = SYNC_2;
+    frame[2] = VERSION;
+}
+
+uint16_t HubLinkFrame::getPayloadBytes(const uint8_t* frame) {
+    return get16(frame + 6);
+}
+
+uint16_t HubLinkFrame::getRecords(const uint8_t* frame) {
+    return get16(frame + 8);
+}
+
+bool HubLinkFrame::append(uint8_t* frame, uint8_t module, uint32_t timestampUs, const uint8_t* data, uint8_t length) {
+    const uint16_t used = getPayloadBytes(frame);
+    if ((uint32_t)used + RECORD_HEADER + length > MAX_PAYLOAD) return false;
+
+    uint8_t* p = frame + HEADER_BYTES + used;
+    p[0] = module;
+    p[1] = length;
+    p[2] = (uint8_t)(timestampUs >> 24);
+    p[3] = (uint8_t)(timestampUs >> 16);
+    p[4] = (uint8_t)(timestampUs >> 8);
+    p[5] = (uint8_t)timestampUs;
+    if (length > 0) memcpy(p + RECORD_HEADER, data, length);
+    put16(frame + 6, (uint16_t)(used + RECORD_HEADER + length));
+    put16(frame + 8, (uint16_t)(getRecords(frame) + 1));
+    return true;
+}
+
+uint16_t HubLinkFrame::finish(uint8_t* frame, uint16_t sequence, uint16_t dropped, uint8_t flags) {
+    frame[3] = flags;
+    put16(frame + 4, sequence);
+    put16(frame + 10, dropped);
+    const uint16_t end = (uint16_t)(HEADER_BYTES + getPayloadBytes(frame));
+    put16(frame + end, crc16(frame, end));
+    return (uint16_t)(end + 2);
+}
+
+bool HubLinkFrame::check(const uint8_t* frame, size_t length, HubLinkFrameInfo& info) {
+    if (length < (size_t)HEADER_BYTES + 2) return false;
+    if (frame[0] != SYNC_1 || frame[1] != SYNC_2 || frame[2] != VERSION) return false;
+    const uint16_t payload = get16(frame + 6);
+    if (payload > MAX_PAYLOAD || (size_t)HEADER_BYTES + payload + 2 > length) return false;
+    const uint16_t end = (uint16_t)(HEADER_BYTES + payload);
+    if (get16(frame + end) != crc16(frame, end)) return false;
+
+    info.sequence = get16(frame + 4);
+    info.flags = frame[3];
+    info.payloadBytes = payload;
+    info.records = get16(frame + 8);
+    info.dropped = get16(frame + 10);
+    info.frameBytes = (uint16_t)(end + 2);
+    return true;
+}
+
+bool HubLinkFrame::nextRecord(const uint8_t* frame, const HubLinkFrameInfo& info, uint16_t& offset,
+                              HubLinkRecord& record) {
+    if ((uint32_t)offset + RECORD_HEADER > info.payloadBytes) return false;
+    const uint8_t* p = frame + HEADER_BYTES + offset;
+    if ((uint32_t)offset + RECORD_HEADER + p[1] > info.payloadBytes) return false;  // Cannot happen after check()
+
+    record.module = p[0];
+    record.length = p[1];
+    record.timestampUs = ((uint32_t)p[2] << 24) | ((uint32_t)p[3] << 16) | ((uint32_t)p[4] << 8) | p[5];
+    record.data = p + RECORD_HEADER;
+    offset = (uint16_t)(offset + RECORD_HEADER + record.length);
+    return true;
+}
+
+// Every run of up to 254 non-zero bytes gets a code byte: its length + 1
+size_t HubLinkFrame::cobsEncode(const uint8_t* in, size_t length, uint8_t* out) {
+    size_t code = 0;     // Position of the current code byte
+    size_t pos = 1;
+    uint8_t run = 1;
+    for (size_t i = 0; i < length; i++) {
+        if (in[i] != 0) {
+            out[pos++] = in[i];
+            run++;
+        }
+        if (in[i] == 0 || run == 0xFF) {
+            out[code] = run;
+            code = pos++;
+            run = 1;
+        }
+    }
+    out[code] = run;
+    out[pos++] = 0;
+    return pos;
+}
+
+size_t HubLinkFrame::cobsDecode(const uint8_t* in, size_t length, uint8_t* out, size_t capacity) {
+    size_t pos = 0;
+    size_t i = 0;
+    while (i < length) {
+        const uint8_t code = in[i++];
+        if (code == 0 || i + code - 1 > length) return 0;
+        for (uint8_t k = 1; k < code; k++) {
+            if (pos >= capacity || in[i] == 0) return 0;
+            out[pos++] = in[i++];
+        }
+        if (code != 0xFF && i < length) {
+            if (pos >= capacity) return 0;
+            out[pos++] = 0;
+        }
+    }
+    return pos;
+}
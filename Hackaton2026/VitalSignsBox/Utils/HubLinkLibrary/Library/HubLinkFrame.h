@@ -0,0 +1,110 @@
+/*
+    HubLinkFrame.h
+
+    Frame format of the SensorHub -> SensorHubPi link
+
+    One frame batches the readings of many modules: a 12-byte header,
+    records of module id, hub time stamp and the raw response bytes, and
+    a CRC-16. Over SPI every transfer is one frame of FRAME_BYTES (the
+    rest is padding); over a UART the used part is COBS encoded and closed
+    by a zero byte, so the receiver resynchronises on the next zero.
+
+    No Arduino dependencies: the same code builds the frames on the hub
+    and parses them on the Pi (see hub_link_reader.cpp).
+*/
+
+#ifndef HUB_LINK_FRAME_H
+#define HUB_LINK_FRAME_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+struct HubLinkFrameInfo {
+    uint16_t sequence;     // Frame number per lane, wraps
+    uint8_t flags;         // FLAG_PRIORITY: from the priority lane
+    uint16_t records;
+    uint16_t dropped;      // Records the hub could not queue since the previous frame
+    uint16_t payloadBytes;
+    uint16_t frameBytes;   // Header, payload and CRC
+};
+
+struct HubLinkRecord {
+    uint8_t module;        // HubScheduler module id
+    uint8_t length;        // Bytes at data
+    uint32_t timestampUs;  // Hub micros() of the reading
+    const uint8_t* data;   // Into the frame
+};
+
+class HubLinkFrame {
+public:
+    // Layout (multi-byte values big endian):
+    //   'H' 'L', version, flags, sequence (16), payload bytes (16), records (16),
+    //   dropped (16), payload, CRC-16/CCITT-FALSE over header and payload.
+    // Record: module, length, time stamp (32), length bytes.
+    static const uint8_t SYNC_1 = 'H';
+    static const uint8_t SYNC_2 = 'L';
+    static const uint8_t VERSION = 1;
+    static const uint16_t FRAME_BYTES = 512;       // One SPI transfer
+    static const uint8_t HEADER_BYTES = 12;
+    static const uint8_t RECORD_HEADER = 6;
+    static const uint16_t MAX_PAYLOAD = FRAME_BYTES - HEADER_BYTES - 2;
+
+    // Flags: a priority frame (alarms, status) has its own sequence
+    static const uint8_t FLAG_PRIORITY = 0x01;
+
+    // Pi -> hub, at the start of every SPI transfer: 'P' 'I', last sequence received (16)
+    static const uint8_t ACK_1 = 'P';
+    static const uint8_t ACK_2 = 'I';
+    static const uint8_t ACK_BYTES = 4;
+
+    /**
+     * Start an empty frame in frame (FRAME_BYTES)
+     */
+    static void begin(uint8_t* frame);
+
+    /**
+     * Append one record
+     * @return false if it does not fit; the frame is unchanged
+     */
+    static bool append(uint8_t* frame, uint8_t module, uint32_t timestampUs, const uint8_t* data, uint8_t length);
+
+    static uint16_t getPayloadBytes(const uint8_t* frame);
+    static uint16_t getRecords(const uint8_t* frame);
+
+    /**
+     * Write flags, sequence, dropped count and CRC
+     * @return Bytes of the frame up to and including the CRC
+     */
+    static uint16_t finish(uint8_t* frame, uint16_t sequence, uint16_t dropped, uint8_t flags = 0);
+
+    /**
+     * Check sync, version, lengths and CRC of a received frame
+     */
+    static bool check(const uint8_t* frame, size_t length, HubLinkFrameInfo& info);
+
+    /**
+     * Iterate the records of a checked frame; start with offset = 0
+     * @return false after the last record
+     */
+    static bool nextRecord(const uint8_t* frame, const HubLinkFrameInfo& info, uint16_t& offset,
+                           HubLinkRecord& record);
+
+    /**
+     * COBS encode length bytes (no zero byte in the output) and append the
+     * zero delimiter
+     * @param out Room for cobsMaxBytes(length)
+     * @return Bytes written, delimiter included
+     */
+    static size_t cobsEncode(const uint8_t* in, size_t length, uint8_t* out);
+    static size_t cobsMaxBytes(size_t length) { return length + length / 254 + 2; }
+
+    /**
+     * Decode one COBS block (without its delimiter)
+     * @return Bytes decoded, 0 if it is malformed or does not fit capacity
+     */
+    static size_t cobsDecode(const uint8_t* in, size_t length, uint8_t* out, size_t capacity);
+
+    static uint16_t crc16(const uint8_t* data, size_t length);
+};
+
+#endif // HUB_LINK_FRAME_H
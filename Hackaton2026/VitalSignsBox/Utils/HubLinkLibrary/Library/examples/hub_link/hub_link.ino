@@ -0,0 +1,121 @@
+#include <Wire.h>
+#include "wiring_private.h"
+#include "TwiPinHelper.h"
+#include "I2CAsyncBus.h"
+#include "HubScheduler.h"
+#include "HubLink.h"
+
+/*
+    basic_hub, but the readings go to the SensorHubPi in HubLink frames
+    instead of one println per reading at 115200 baud.
+
+    SPI (default): SERCOM2 as slave on the SERCOM-ALT pads of PA08..PA11,
+    ready line on D5. Wiring to the Pi (SPI0, CE0):
+      PA08 (D4) MOSI <- GPIO10    PA09 (D3) SCK <- GPIO11
+      PA10 (D1) SS   <- GPIO8     PA11 (D0) MISO -> GPIO9
+      D5 ready -> GPIO25
+    Read with: hub_link_reader spi /dev/spidev0.0 /dev/gpiochip0 25
+
+    Set LINK_UART to 1 for COBS frames on Serial1 at 2 Mbaud instead:
+      hub_link_reader uart /dev/ttyAMA0 2000000
+    (Serial1 sits on PA10/PA11 as well: use one or the other.)
+*/
+
+#define LINK_UART 0
+
+// I2C sensor buses (same as basic_hub)
+#define W1_SCL 39  // PA13
+#define W1_SDA 28  // PA12
+#define W2_SCL 13  // PA17
+#define W2_SDA 11  // PA16
+
+TwiPinPair portSensorsA(W1_SCL, W1_SDA);
+TwiPinPair portSensorsB(W2_SCL, W2_SDA);
+
+TwoWire WireSensorA(&sercom1, W1_SDA, W1_SCL);
+TwoWire WireSensorB(&sercom4, W2_SDA, W2_SCL);
+
+I2CAsyncBus busA(&WireSensorA, SERCOM1);
+I2CAsyncBus busB(&WireSensorB, SERCOM4);
+
+void SERCOM1_Handler() { busA.onService(); }
+void SERCOM4_Handler() { busB.onService(); }
+
+#if LINK_UART
+HubLink link(Serial1);
+#else
+#define LINK_READY 5
+HubLink link(SERCOM2, SPI_PAD_3_SCK_1, SERCOM_RX_PAD_0, LINK_READY);
+void SERCOM2_Handler() { link.onService(); }
+#endif
+
+#define ECG_MODULE_ADDR  0x2A
+#define SPO2_MODULE_ADDR 0x2B
+#define MCP3426_ADDR     0x68
+
+HubScheduler hub;
+
+void setup() {
+  Serial.begin(115200);
+
+#if LINK_UART
+  Serial1.begin(2000000);
+#else
+  pinPeripheral(4, PIO_SERCOM_ALT);
+  pinPeripheral(3, PIO_SERCOM_ALT);
+  pinPeripheral(1, PIO_SERCOM_ALT);
+  pinPeripheral(0, PIO_SERCOM_ALT);
+#endif
+  link.begin();
+
+  WireSensorA.begin();
+  WireSensorB.begin();
+  portSensorsA.setPinPeripheralAltStates();
+  portSensorsB.setPinPeripheralStates();
+
+  WireSensorB.beginTransmission(MCP3426_ADDR);
+  WireSensorB.write(0x18);
+  WireSensorB.endTransmission();
+
+  busA.begin();
+  busB.begin();
+  const int8_t a = hub.addBus(&busA);
+  const int8_t b = hub.addBus(&busB);
+
+  const uint8_t ecgBurst[] = { 0x22, 8 };
+  const int8_t ecg = hub.addModule(a, ECG_MODULE_ADDR, ecgBurst, 2, 9 + 8 * 6, 10000);  // 100 Hz
+  hub.addModule(a, SPO2_MODULE_ADDR, 0x00, 4, 100000);              // 10 Hz
+  hub.addModule(b, MCP3426_ADDR, nullptr, 0, 3, 100000);            // 10 Hz
+
+  // When the Pi falls behind the waveform gets 4 of every 6 link bytes
+  link.setWeight(ecg % HUB_LINK_CHANNELS, 4);
+
+  hub.setTimeSync(1000000);
+  link.setMaxLatency(20000);  // A frame at least every 20 ms while readings come in
+}
+
+void loop() {
+  hub.poll();
+
+  HubReading reading;
+  while (hub.read(reading)) {
+    // A failed reading is a status: no data, on the priority lane, so
+    // the Pi sees the gap before the waveform queued in front of it
+    if (reading.ok) link.add(reading.module, reading.timestampUs, reading.data, reading.length);
+    else link.addPriority(reading.module, reading.timestampUs, nullptr, 0);
+  }
+  link.poll();
+
+  static uint32_t lastReportMs = 0;
+  if (millis() - lastReportMs >= 5000) {
+    lastReportMs = millis();
+    Serial.print("link frames ");
+    Serial.print(link.getFramesSent());
+    Serial.print(", priority ");
+    Serial.print(link.getPriorityFramesSent());
+    Serial.print(", dropped ");
+    Serial.print(link.getDropped());
+    Serial.print(", acked ");
+    Serial.println(link.getLastAck());
+  }
+}
@@ -0,0 +1,269 @@
+/*
+    hub_link_reader.cpp
+
+    Reader for the HubLink frames on the SensorHubPi (Linux)
+
+    SPI: the Pi is master on spidev (mode 0, 8 MHz) and waits for the
+    hub's ready line on a GPIO character device line. Each transfer is
+    one FRAME_BYTES frame in and the acknowledge out; the spidev driver
+    moves the bytes with DMA. UART: COBS frames on a tty, split on the
+    zero delimiters.
+
+    Writes one line per record (frame sequence, module, hub time stamp,
+    data in hex; the sequence of a priority frame starts with 'P') on
+    stdout, or only the statistics with -q; once a second frames, priority
+    frames, bytes, missed frames, CRC errors and records the hub dropped
+    go to stderr. Bulk and priority frames are numbered separately.
+
+        g++ -O2 -Wall -I Library -I ../CrcLibrary/Library hub_link_reader.cpp Library/HubLinkFrame.cpp \
+            ../CrcLibrary/Library/Crc.cpp -o hub_link_reader
+        ./hub_link_reader spi /dev/spidev0.0 /dev/gpiochip0 25
+        ./hub_link_reader uart /dev/ttyAMA0 2000000 -q
+*/
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <vector>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/gpio.h>
+#include <linux/spi/spidev.h>
+#include "HubLinkFrame.h"
+
+static const uint32_t SPI_HZ = 8000000;
+
+struct Stats {
+    unsigned long frames, priority, bytes, records, missed, duplicates, errors, dropped;
+};
+
+// Sequence tracking of one lane
+struct Lane {
+    bool started;
+    uint16_t lastSequence;
+};
+
+static bool quiet = false;
+static Lane bulk = {};
+static Lane priority = {};
+static Stats stats = {};
+
+static double seconds() {
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+// Check one frame, track the sequence and print its records
+static void handleFrame(const uint8_t* frame, size_t length) {
+    HubLinkFrameInfo info;
+    if (!HubLinkFrame::check(frame, length, info)) {
+        stats.errors++;
+        return;
+    }
+    const bool urgent = (info.flags & HubLinkFrame::FLAG_PRIORITY) != 0;
+    Lane& lane = urgent ? priority : bulk;
+    if (lane.started) {
+        const uint16_t step = (uint16_t)(info.sequence - lane.lastSequence);
+        if (step == 0) {
+            stats.duplicates++;
+            return;
+        }
+        stats.missed += step - 1u;
+    }
+    lane.started = true;
+    lane.lastSequence = info.sequence;
+    stats.frames++;
+    if (urgent) stats.priority++;
+    stats.bytes += info.frameBytes;
+    stats.dropped += info.dropped;
+
+    uint16_t offset = 0;
+    HubLinkRecord record;
+    while (HubLinkFrame::nextRecord(frame, info, offset, record)) {
+        stats.records++;
+        if (quiet) continue;
+        printf("%s%u %u %lu", urgent ? "P" : "", info.sequence, record.module, (unsigned long)record.timestampUs);
+        if (record.length == 0) printf(" -");
+        else putchar(' ');
+        for (uint8_t i = 0; i < record.length; i++) printf("%02X", record.data[i]);
+        putchar('\n');
+    }
+}
+
+static void report(double& last) {
+    const double now = seconds();
+    if (now - last < 1.0) return;
+    fprintf(stderr, "%lu frames/s (%lu priority), %.1f kB/s, %lu records/s, missed %lu, duplicates %lu, errors %lu, "
+                    "hub dropped %lu\n",
+            (unsigned long)(stats.frames / (now - last)), (unsigned long)(stats.priority / (now - last)), stats.bytes / (now - last) / 1000.0,
+            (unsigned long)(stats.records / (now - last)), stats.missed, stats.duplicates, stats.errors, stats.dropped);
+    fflush(stdout);
+    stats = Stats();
+    last = now;
+}
+
+static int readSpi(const char* device, const char* chip, unsigned line) {
+    const int spi = open(device, O_RDWR);
+    if (spi < 0) {
+        perror(device);
+        return 1;
+    }
+    uint8_t mode = SPI_MODE_0, bits = 8;
+    uint32_t hz = SPI_HZ;
+    if (ioctl(spi, SPI_IOC_WR_MODE, &mode) < 0 || ioctl(spi, SPI_IOC_WR_BITS_PER_WORD, &bits) < 0 ||
+        ioctl(spi, SPI_IOC_WR_MAX_SPEED_HZ, &hz) < 0) {
+        perror("spidev setup");
+        return 1;
+    }
+
+    const int gpio = open(chip, O_RDONLY);
+    if (gpio < 0) {
+        perror(chip);
+        return 1;
+    }
+    gpioevent_request request;
+    memset(&request, 0, sizeof(request));
+    request.lineoffset = line;
+    request.handleflags = GPIOHANDLE_REQUEST_INPUT;
+    request.eventflags = GPIOEVENT_REQUEST_RISING_EDGE;
+    strncpy(request.consumer_label, "hub_link_ready", sizeof(request.consumer_label) - 1);
+    if (ioctl(gpio, GPIO_GET_LINEEVENT_IOCTL, &request) < 0) {
+        perror("ready line");
+        return 1;
+    }
+    const int ready = request.fd;
+    fcntl(ready, F_SETFL, O_NONBLOCK);
+
+    uint8_t tx[HubLinkFrame::FRAME_BYTES] = {};
+    uint8_t rx[HubLinkFrame::FRAME_BYTES];
+    spi_ioc_transfer transfer;
+    memset(&transfer, 0, sizeof(transfer));
+    transfer.tx_buf = (unsigned long)tx;
+    transfer.rx_buf = (unsigned long)rx;
+    transfer.len = HubLinkFrame::FRAME_BYTES;
+    transfer.speed_hz = SPI_HZ;
+    transfer.bits_per_word = 8;
+
+    double last = seconds();
+    for (;;) {
+        // Edges only wake us up; the level decides, so none can be missed
+        gpioevent_data event;
+        while (read(ready, &event, sizeof(event)) == (ssize_t)sizeof(event));
+        gpiohandle_data level;
+        if (ioctl(ready, GPIOHANDLE_GET_LINE_VALUES_IOCTL, &level) < 0) {
+            perror("ready line");
+            return 1;
+        }
+        if (!level.values[0]) {
+            pollfd wait = { ready, POLLIN, 0 };
+            poll(&wait, 1, 100);
+            report(last);
+            continue;
+        }
+
+        tx[0] = HubLinkFrame::ACK_1;
+        tx[1] = HubLinkFrame::ACK_2;
+        tx[2] = (uint8_t)(bulk.lastSequence >> 8);
+        tx[3] = (uint8_t)bulk.lastSequence;
+        if (ioctl(spi, SPI_IOC_MESSAGE(1), &transfer) < 0) {
+            perror("spi transfer");
+            return 1;
+        }
+        handleFrame(rx, sizeof(rx));
+        report(last);
+    }
+}
+
+static speed_t baudConstant(unsigned long baud) {
+    switch (baud) {
+        case 115200: return B115200;
+        case 230400: return B230400;
+        case 460800: return B460800;
+        case 921600: return B921600;
+        case 1000000: return B1000000;
+        case 2000000: return B2000000;
+        case 3000000: return B3000000;
+        default: return B0;
+    }
+}
+
+static int readUart(const char* device, unsigned long baud) {
+    const speed_t speed = baudConstant(baud);
+    if (speed == B0) {
+        fprintf(stderr, "Unsupported baud rate %lu\n", baud);
+        return 1;
+    }
+    const int tty = open(device, O_RDONLY | O_NOCTTY);
+    if (tty < 0) {
+        perror(device);
+        return 1;
+    }
+    termios options;
+    if (tcgetattr(tty, &options) < 0) {
+        perror("tcgetattr");
+        return 1;
+    }
+    cfmakeraw(&options);
+    cfsetispeed(&options, speed);
+    cfsetospeed(&options, speed);
+    options.c_cflag |= CLOCAL | CREAD;
+    options.c_cc[VMIN] = 0;
+    options.c_cc[VTIME] = 1;  // Return after 0.1 s without bytes, for the statistics
+    tcsetattr(tty, TCSANOW, &options);
+    tcflush(tty, TCIFLUSH);
+
+    const size_t maxBlock = HubLinkFrame::cobsMaxBytes(HubLinkFrame::FRAME_BYTES);
+    std::vector<uint8_t> block;
+    block.reserve(maxBlock);
+    uint8_t chunk[4096];
+    uint8_t frame[HubLinkFrame::FRAME_BYTES];
+    bool synced = false;  // The first block is likely cut off: skip to the first zero
+    double last = seconds();
+
+    for (;;) {
+        const ssize_t n = read(tty, chunk, sizeof(chunk));
+        if (n < 0 && errno != EINTR) {
+            perror(device);
+            return 1;
+        }
+        for (ssize_t i = 0; i < n; i++) {
+            if (chunk[i] != 0) {
+                if (block.size() < maxBlock) block.push_back(chunk[i]);
+                else block.clear(), stats.errors++;  // No delimiter where one was due
+                continue;
+            }
+            if (synced && !block.empty()) {
+                const size_t length = HubLinkFrame::cobsDecode(block.data(), block.size(), frame, sizeof(frame));
+                if (length == 0) stats.errors++;
+                else handleFrame(frame, length);
+            }
+            synced = true;
+            block.clear();
+        }
+        report(last);
+    }
+}
+
+int main(int argc, char** argv) {
+    std::vector<const char*> args;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-q") == 0) quiet = true;
+        else args.push_back(argv[i]);
+    }
+
+    if (args.size() == 4 && strcmp(args[0], "spi") == 0) {
+        return readSpi(args[1], args[2], (unsigned)strtoul(args[3], nullptr, 10));
+    }
+    if (args.size() == 3 && strcmp(args[0], "uart") == 0) {
+        return readUart(args[1], strtoul(args[2], nullptr, 10));
+    }
+    fprintf(stderr, "Usage: %s spi <spidev> <gpiochip> <ready line> [-q]\n"
+                    "       %s uart <tty> <baud> [-q]\n", argv[0], argv[0]);
+    return 1;
+}
@@ -0,0 +1,174 @@
+/*
+    HubCache.cpp
+
+    Read-through register cache implementation
+*/
+
+#include "HubCache.h"
+
+#define HUB_CACHE_IDLE_PERIOD_US 1000000  // Placeholder period while an entry has no consumers
+
+HubCache::HubCache(HubScheduler& hub)
+    : _hub(hub)
+    , _entryCount(0)
+{
+    for (uint8_t i = 0; i < HUB_CACHE_MAX_CONSUMERS; i++) {
+        _consumers[i].active = false;
+    }
+}
+
+int8_t HubCache::subscribe(uint8_t bus, uint8_t address, uint8_t reg, uint8_t length, uint32_t maxAgeUs) {
+    if (length == 0 || length > HUB_MAX_READ || maxAgeUs == 0) return -1;
+
+    int8_t id = -1;
+    for (uint8_t i = 0; i < HUB_CACHE_MAX_CONSUMERS; i++) {
+        if (!_consumers[i].active) {
+            id = i;
+            break;
+        }
+    }
+    if (id < 0) return -1;
+
+    uint8_t offset = 0;
+    int8_t entry = findEntry(bus, address, reg, length, offset);
+    if (entry < 0) entry = addEntry(bus, address, reg, length);
+    if (entry < 0) return -1;
+
+    Consumer& c = _consumers[id];
+    c.active = true;
+    c.entry = entry;
+    c.offset = offset;
+    c.length = length;
+    c.maxAgeUs = maxAgeUs;
+    reschedule(entry);
+    return id;
+}
+
+void HubCache::unsubscribe(uint8_t consumer) {
+    if (consumer >= HUB_CACHE_MAX_CONSUMERS || !_consumers[consumer].active) return;
+    _consumers[consumer].active = false;
+    reschedule(_consumers[consumer].entry);
+}
+
+// An entry that holds the whole block: same device, block inside its registers
+int8_t HubCache::findEntry(uint8_t bus, uint8_t address, uint8_t reg, uint8_t length, uint8_t& offset) const {
+    for (uint8_t i = 0; i < _entryCount; i++) {
+        const Entry& e = _entries[i];
+        if (e.bus != bus || e.address != address) continue;
+
+        if (reg == NO_REGISTER || e.reg == NO_REGISTER) {
+            if (reg != e.reg || length > e.length) continue;
+            offset = 0;
+            return i;
+        }
+        if (reg < e.reg || reg + length > e.reg + e.length) continue;
+        offset = reg - e.reg;
+        return i;
+    }
+    return -1;
+}
+
+int8_t HubCache::addEntry(uint8_t bus, uint8_t address, uint8_t reg, uint8_t length) {
+    if (_entryCount >= HUB_CACHE_MAX_ENTRIES) return -1;
+
+    const int8_t module = _hub.addModule(bus, address, &reg, reg == NO_REGISTER ? 0 : 1, length,
+                                         HUB_CACHE_IDLE_PERIOD_US);
+    if (module < 0) return -1;
+    _hub.setEnabled(module, false);  // Until reschedule() knows the bound
+
+    Entry& e = _entries[_entryCount];
+    e.bus = bus;
+    e.address = address;
+    e.reg = reg;
+    e.length = length;
+    e.module = module;
+    e.valid = false;
+    e.timestampUs = 0;
+    e.durationUs = 0;
+    e.periodUs = 0;
+    e.reads = 0;
+    return _entryCount++;
+}
+
+// Period from the strictest bound: read again when the data would reach it
+void HubCache::reschedule(uint8_t entry) {
+    Entry& e = _entries[entry];
+
+    bool any = false;
+    uint32_t strictest = 0;
+    for (uint8_t i = 0; i < HUB_CACHE_MAX_CONSUMERS; i++) {
+        const Consumer& c = _consumers[i];
+        if (!c.active || c.entry != entry) continue;
+        if (!any || c.maxAgeUs < strictest) strictest = c.maxAgeUs;
+        any = true;
+    }
+
+    if (!any) {
+        e.periodUs = 0;
+        _hub.setEnabled(e.module, false);
+        return;
+    }
+
+    // The data is stamped when its read starts and usable when it ends
+    uint32_t period = strictest > e.durationUs ? strictest - e.durationUs : 0;
+    if (period < HUB_CACHE_MIN_PERIOD_US) period = HUB_CACHE_MIN_PERIOD_US;
+    if (period == e.periodUs) return;
+
+    // Enable first: setPeriod() then counts from the last read, so data that
+    // is still young enough is not read again
+    if (e.periodUs == 0) _hub.setEnabled(e.module, true);
+    e.periodUs = period;
+    _hub.setPeriod(e.module, period);
+}
+
+bool HubCache::update(const HubReading& reading) {
+    for (uint8_t i = 0; i < _entryCount; i++) {
+        Entry& e = _entries[i];
+        if (e.module != reading.module) continue;
+
+        if (reading.ok && reading.length == e.length) {
+            memcpy(e.data, reading.data, e.length);
+            e.timestampUs = reading.timestampUs;
+            e.valid = true;
+            e.reads++;
+            if (reading.durationUs > e.durationUs) {
+                e.durationUs = reading.durationUs;
+                reschedule(i);  // Start earlier by the longer lead
+            }
+        }
+        return true;  // A failed read keeps the old data; get() tells when it is too old
+    }
+    return false;
+}
+
+bool HubCache::get(uint8_t consumer, uint8_t* data, uint32_t* timestampUs) const {
+    const uint32_t age = getAge(consumer);  // UINT32_MAX for a bad id as well
+    if (age == UINT32_MAX || age > _consumers[consumer].maxAgeUs) return false;
+
+    const Consumer& c = _consumers[consumer];
+    const Entry& e = _entries[c.entry];
+    memcpy(data, &e.data[c.offset], c.length);
+    if (timestampUs) *timestampUs = e.timestampUs;
+    return true;
+}
+
+uint32_t HubCache::getAge(uint8_t consumer) const {
+    if (consumer >= HUB_CACHE_MAX_CONSUMERS || !_consumers[consumer].active) return UINT32_MAX;
+
+    const Entry& e = _entries[_consumers[consumer].entry];
+    return e.valid ? micros() - e.timestampUs : UINT32_MAX;
+}
+
+uint8_t HubCache::getEntryCount() const {
+    return _entryCount;
+}
+
+uint32_t HubCache::getReadCount(uint8_t consumer) const {
+    if (consumer >= HUB_CACHE_MAX_CONSUMERS || !_consumers[consumer].active) return 0;
+    return _entries[_consumers[consumer].entry].reads;
+}
+
+uint32_t HubCache::getRefreshUs(uint8_t consumer) const {
+    if (consumer >= HUB_CACHE_MAX_CONSUMERS || !_consumers[consumer].active) return 0;
+    return _entries[_consumers[consumer].entry].periodUs;
+}
@@ -0,0 +1,111 @@
+/*
+    HubCache.h
+
+    Read-through register cache on the hub
+
+    Display, alarms and the Pi uplink each want the same module registers,
+    at their own rate. Instead of one bus read per consumer, every
+    consumer subscribes to a register block with the oldest data it still
+    accepts. The cache keeps one entry per module address and block; a
+    block that lies inside a cached one is served from that entry.
+
+    Each entry is a HubScheduler module. Its period follows the strictest
+    bound of the consumers it has, minus the time a read takes, so the
+    entry is read again just before the strictest consumer would find it
+    too old, and never more often. Without consumers it is not read at
+    all. Bus load per block is then one read per strictest bound, however
+    many consumers share it.
+*/
+
+#ifndef HUB_CACHE_H
+#define HUB_CACHE_H
+
+#include <Arduino.h>
+#include "HubScheduler.h"
+
+#define HUB_CACHE_MAX_ENTRIES HUB_MAX_MODULES
+#define HUB_CACHE_MAX_CONSUMERS 16
+#define HUB_CACHE_MIN_PERIOD_US 1000  // Lower bound for a refresh period
+
+class HubCache {
+public:
+    static const uint8_t NO_REGISTER = 0xFF;  // Device read without a register pointer (e.g. MCP3426)
+
+    explicit HubCache(HubScheduler& hub);
+
+    /**
+     * Declare a consumer of a register block
+     * @param bus      Index from HubScheduler::addBus()
+     * @param address  7-bit module address
+     * @param reg      First register, or NO_REGISTER
+     * @param length   Bytes, 1 .. HUB_MAX_READ
+     * @param maxAgeUs Oldest data this consumer accepts, from the start of
+     *                 the read that fetched it
+     * @return Consumer id, or -1 on a bad argument or when full
+     */
+    int8_t subscribe(uint8_t bus, uint8_t address, uint8_t reg, uint8_t length, uint32_t maxAgeUs);
+
+    /**
+     * Drop the consumer's bound; an entry without consumers is no longer read
+     */
+    void unsubscribe(uint8_t consumer);
+
+    /**
+     * Take a scheduler reading into the cache; call for every
+     * HubScheduler::read() result
+     * @return true if it was a cache entry's read (consumed)
+     */
+    bool update(const HubReading& reading);
+
+    /**
+     * Copy the consumer's block from the cache; never reads the bus
+     * @param data        At least the subscribed length
+     * @param timestampUs Set to when the data was read, may be nullptr
+     * @return false if there is no data yet, or it is older than the
+     *         consumer's bound (the bus could not keep up)
+     */
+    bool get(uint8_t consumer, uint8_t* data, uint32_t* timestampUs = nullptr) const;
+
+    /**
+     * Age of the consumer's data, UINT32_MAX if none
+     */
+    uint32_t getAge(uint8_t consumer) const;
+
+    uint8_t getEntryCount() const;
+    uint32_t getReadCount(uint8_t consumer) const;     // Reads of the consumer's entry
+    uint32_t getRefreshUs(uint8_t consumer) const;      // Current period of that entry, 0 = idle
+
+private:
+    struct Entry {
+        uint8_t bus;
+        uint8_t address;
+        uint8_t reg;
+        uint8_t length;
+        int8_t module;         // HubScheduler module id
+        bool valid;
+        uint32_t timestampUs;
+        uint32_t durationUs;   // Longest read so far, the refresh lead
+        uint32_t periodUs;     // 0 = no consumers
+        uint32_t reads;
+        uint8_t data[HUB_MAX_READ];
+    };
+
+    struct Consumer {
+        bool active;
+        uint8_t entry;
+        uint8_t offset;        // Of the block in the entry
+        uint8_t length;
+        uint32_t maxAgeUs;
+    };
+
+    int8_t findEntry(uint8_t bus, uint8_t address, uint8_t reg, uint8_t length, uint8_t& offset) const;
+    int8_t addEntry(uint8_t bus, uint8_t address, uint8_t reg, uint8_t length);
+    void reschedule(uint8_t entry);
+
+    HubScheduler& _hub;
+    Entry _entries[HUB_CACHE_MAX_ENTRIES];
+    Consumer _consumers[HUB_CACHE_MAX_CONSUMERS];
+    uint8_t _entryCount;
+};
+
+#endif // HUB_CACHE_H
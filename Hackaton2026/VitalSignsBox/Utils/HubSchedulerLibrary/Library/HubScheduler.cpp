@@ -0,0 +1,289 @@
+/*
+    HubScheduler.cpp
+
+    Hub-side acquisition scheduler implementation
+*/
+
+#include "HubScheduler.h"
+
+HubScheduler::HubScheduler()
+    : _busCount(0)
+    , _moduleCount(0)
+    , _timeoutUs(HUB_DEFAULT_TIMEOUT_US)
+    , _syncPeriodUs(0)
+    , _syncs(0)
+    , _head(0)
+    , _count(0)
+    , _dropped(0)
+{
+}
+
+int8_t HubScheduler::addBus(I2CAsyncBus* bus) {
+    if (bus == nullptr || _busCount >= HUB_MAX_BUSES) return -1;
+
+    Bus& b = _buses[_busCount];
+    b.bus = bus;
+    b.active = NONE;
+    b.startUs = 0;
+    b.syncSequence = 0;
+    b.syncDueUs = micros();
+    return _busCount++;
+}
+
+int8_t HubScheduler::addModule(uint8_t bus, uint8_t address, const uint8_t* tx, uint8_t txLength,
+                               uint8_t rxLength, uint32_t periodUs) {
+    if (_moduleCount >= HUB_MAX_MODULES || bus >= _busCount) return -1;
+    if (txLength > HUB_MAX_TX || (txLength > 0 && tx == nullptr)) return -1;
+    if (rxLength == 0 || rxLength > HUB_MAX_READ || periodUs == 0) return -1;
+
+    Module& m = _modules[_moduleCount];
+    m.bus = bus;
+    m.address = address;
+    if (txLength > 0) memcpy(m.tx, tx, txLength);
+    m.txLength = txLength;
+    m.rxLength = rxLength;
+    m.enabled = true;
+    m.polled = false;
+    m.periodUs = periodUs;
+    m.errors = 0;
+    m.late = 0;
+    m.readyPin = -1;
+    m.fallbackUs = 0;
+    m.lastUs = micros();
+    m.signals = 0;
+
+    // Spread first polls over the period so modules on one bus interleave
+    m.dueUs = micros() + (periodUs / HUB_MAX_MODULES) * _moduleCount;
+    return _moduleCount++;
+}
+
+int8_t HubScheduler::addModule(uint8_t bus, uint8_t address, uint8_t reg, uint8_t rxLength, uint32_t periodUs) {
+    return addModule(bus, address, &reg, 1, rxLength, periodUs);
+}
+
+void HubScheduler::setTimeout(uint32_t timeoutUs) {
+    _timeoutUs = timeoutUs;
+}
+
+void HubScheduler::setEnabled(uint8_t module, bool enabled) {
+    if (module >= _moduleCount) return;
+    if (enabled && !_modules[module].enabled) {
+        _modules[module].dueUs = micros();
+    }
+    _modules[module].enabled = enabled;
+}
+
+bool HubScheduler::setPeriod(uint8_t module, uint32_t periodUs) {
+    if (module >= _moduleCount || periodUs == 0) return false;
+
+    Module& m = _modules[module];
+    const uint32_t now = micros();
+    m.periodUs = periodUs;
+    if (!m.polled) return true;  // Keeps its first poll
+
+    m.dueUs = m.lastUs + periodUs;
+    if ((int32_t)(now - m.dueUs) > 0) m.dueUs = now;  // Not a late period: there was no grid for it
+    return true;
+}
+
+bool HubScheduler::setDataReady(uint8_t module, int8_t pin, uint32_t fallbackUs) {
+    if (module >= _moduleCount) return false;
+
+    Module& m = _modules[module];
+    if (pin >= 0) pinMode(pin, INPUT_PULLUP);
+    m.readyPin = pin;
+    m.fallbackUs = fallbackUs;
+    m.lastUs = micros();
+    return true;
+}
+
+void HubScheduler::setTimeSync(uint32_t periodUs) {
+    _syncPeriodUs = periodUs;
+    const uint32_t now = micros();
+    for (uint8_t i = 0; i < _busCount; i++) {
+        _buses[i].syncDueUs = now;  // First sync right away
+    }
+}
+
+void HubScheduler::poll() {
+    const uint32_t now = micros();
+
+    for (uint8_t i = 0; i < _busCount; i++) {
+        Bus& b = _buses[i];
+
+        if (b.active != NONE) {
+            if (b.bus->isBusy()) {
+                if (now - b.startUs < _timeoutUs) continue;
+                b.bus->abort();
+            }
+            complete(b, now);
+        }
+        if (!startSync(b, now)) startNext(i, now);
+    }
+}
+
+// Turn the finished transaction into a reading
+void HubScheduler::complete(Bus& b, uint32_t now) {
+    if (b.active == SYNC) {
+        b.active = NONE;  // No reading; modules do not answer a broadcast
+        return;
+    }
+
+    Module& m = _modules[b.active];
+    const bool ok = (b.bus->getResult() == I2CAsyncBus::DONE);
+
+    HubReading reading;
+    reading.module = b.active;
+    reading.ok = ok;
+    reading.length = ok ? b.bus->getReceived() : 0;
+    reading.timestampUs = b.startUs;
+    reading.durationUs = now - b.startUs;
+    memcpy(reading.data, b.rx, reading.length);
+
+    if (!ok) m.errors++;
+    b.active = NONE;
+    push(reading);
+}
+
+// Start the most overdue module on this bus, if any is due
+void HubScheduler::startNext(uint8_t index, uint32_t now) {
+    int8_t next = -1;
+    int32_t mostOverdue = -1;
+
+    for (uint8_t i = 0; i < _moduleCount; i++) {
+        const Module& m = _modules[i];
+        if (m.bus != index || !m.enabled || !isDue(m, now)) continue;
+
+        const int32_t overdue = (int32_t)(now - m.dueUs);
+        if (overdue > mostOverdue) {
+            mostOverdue = overdue;
+            next = i;
+        }
+    }
+    if (next < 0) return;
+
+    Bus& b = _buses[index];
+    Module& m = _modules[next];
+    if (!b.bus->start(m.address, m.tx, m.txLength, b.rx, m.rxLength)) return;
+
+    b.active = next;
+    b.startUs = now;
+    m.lastUs = now;
+    m.polled = true;
+
+    if (m.readyPin >= 0) {
+        // No grid: the period only limits the rate
+        if (digitalRead(m.readyPin) == LOW) m.signals++;
+        m.dueUs = now + m.periodUs;
+        return;
+    }
+
+    // Keep the grid, but skip (and count) periods that are already lost
+    m.dueUs += m.periodUs;
+    if ((int32_t)(now - m.dueUs) >= 0) {
+        const uint32_t missed = (now - m.dueUs) / m.periodUs + 1;
+        m.late += missed;
+        m.dueUs += missed * m.periodUs;
+    }
+}
+
+// Polled modules on their grid; the others when signalled or silent for too long
+bool HubScheduler::isDue(const Module& m, uint32_t now) const {
+    if ((int32_t)(now - m.dueUs) < 0) return false;
+    if (m.readyPin < 0 || digitalRead(m.readyPin) == LOW) return true;
+    return m.fallbackUs != 0 && now - m.lastUs >= m.fallbackUs;
+}
+
+// Sync first when due: it is short, and a late sync costs accuracy
+bool HubScheduler::startSync(Bus& b, uint32_t now) {
+    if (_syncPeriodUs == 0 || (int32_t)(now - b.syncDueUs) < 0) return false;
+
+    // Stamp as late as possible; the modules add the transfer time
+    TimeSync::pack(b.sync, b.syncSequence, micros());
+    if (!b.bus->start(0x00, b.sync, TIMESYNC_FRAME_LENGTH, nullptr, 0)) return false;
+
+    b.active = SYNC;
+    b.startUs = now;
+    b.syncSequence++;
+    b.syncDueUs = now + _syncPeriodUs;
+    _syncs++;
+    return true;
+}
+
+void HubScheduler::push(const HubReading& reading) {
+    if (_count >= HUB_QUEUE_SIZE) {
+        _dropped++;
+        return;
+    }
+    _queue[(_head + _count) % HUB_QUEUE_SIZE] = reading;
+    _count++;
+}
+
+bool HubScheduler::read(HubReading& reading) {
+    if (_count == 0) return false;
+
+    reading = _queue[_head];
+    _head = (_head + 1) % HUB_QUEUE_SIZE;
+    _count--;
+    return true;
+}
+
+bool HubScheduler::getNextDue(uint32_t& dueUs) const {
+    const uint32_t now = micros();
+    int32_t soonest = 0;
+    bool any = false;
+
+    for (uint8_t i = 0; i < _busCount; i++) {
+        const Bus& b = _buses[i];
+        if (b.active != NONE) {
+            // The SERCOM interrupt ends the transaction; the timeout is the fallback
+            earliest(soonest, any, b.bus->isBusy() ? (int32_t)(b.startUs + _timeoutUs - now) : 0);
+        } else if (_syncPeriodUs != 0) {
+            earliest(soonest, any, (int32_t)(b.syncDueUs - now));
+        }
+    }
+    for (uint8_t i = 0; i < _moduleCount; i++) {
+        const Module& m = _modules[i];
+        if (!m.enabled) continue;
+        if (m.readyPin < 0 || digitalRead(m.readyPin) == LOW) {
+            earliest(soonest, any, (int32_t)(m.dueUs - now));
+        } else if (m.fallbackUs != 0) {
+            // Not before the rate limit; a signal earlier must wake the hub itself
+            const int32_t rate = (int32_t)(m.dueUs - now);
+            const int32_t fallback = (int32_t)(m.lastUs + m.fallbackUs - now);
+            earliest(soonest, any, rate > fallback ? rate : fallback);
+        }
+    }
+
+    dueUs = now + (soonest > 0 ? soonest : 0);
+    return any;
+}
+
+void HubScheduler::earliest(int32_t& soonest, bool& any, int32_t candidate) {
+    if (!any || candidate < soonest) soonest = candidate;
+    any = true;
+}
+
+uint8_t HubScheduler::getPending() const {
+    return _count;
+}
+
+uint32_t HubScheduler::getDropped() const {
+    return _dropped;
+}
+
+uint32_t HubScheduler::getErrorCount(uint8_t module) const {
+    return module < _moduleCount ? _modules[module].errors : 0;
+}
+
+uint32_t HubScheduler::getLateCount(uint8_t module) const {
+    return module < _moduleCount ? _modules[module].late : 0;
+}
+
+uint32_t HubScheduler::getSignalCount(uint8_t module) const {
+    return module < _moduleCount ? _modules[module].signals : 0;
+}
+
+uint32_t HubScheduler::getSyncCount() const {
+    return _syncs;
+}
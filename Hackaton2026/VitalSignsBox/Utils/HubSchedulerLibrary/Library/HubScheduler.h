@@ -0,0 +1,189 @@
+/*
+    HubScheduler.h
+
+    Hub-side acquisition scheduler for the VitalSignsBox modules
+
+    Every module is polled with its own period. Each bus runs one
+    transaction at a time, but the buses run in parallel (I2CAsyncBus), so
+    e.g. ECG bursts on one SERCOM do not hold up SpO2 or temperature reads
+    on another. poll() never waits: it collects finished transactions and
+    starts the most overdue module on every idle bus.
+
+    Every reading carries the micros() time its request started, so
+    downstream code can align data from different modules. With
+    setTimeSync() the hub also broadcasts its micros() on every bus, so
+    the modules can stamp their own buffered samples in hub time
+    (TimeSync).
+
+    A module with a data-ready line (I2CRegisterSlave::setDataReadyPin())
+    is read only when it signalled new data, instead of every period;
+    the hub skips the transactions that would return the same registers.
+*/
+
+#ifndef HUB_SCHEDULER_H
+#define HUB_SCHEDULER_H
+
+#include <Arduino.h>
+#include "I2CAsyncBus.h"
+#include "TimeSync.h"
+
+#define HUB_MAX_BUSES 4
+#define HUB_MAX_MODULES 8
+#define HUB_MAX_TX 2         // Register pointer + one argument (e.g. ECG BURST count)
+#define HUB_MAX_READ 57      // Largest response: ECG BURST_TIMED of 8 frames
+#define HUB_QUEUE_SIZE 8     // Readings waiting for read()
+#define HUB_DEFAULT_TIMEOUT_US 5000
+
+struct HubReading {
+    uint8_t module;          // Id returned by addModule()
+    bool ok;                 // false: NACK, bus error or timeout (no data)
+    uint8_t length;          // Bytes in data
+    uint32_t timestampUs;    // micros() when the request started
+    uint32_t durationUs;     // Request start to completion
+    uint8_t data[HUB_MAX_READ];
+};
+
+class HubScheduler {
+public:
+    HubScheduler();
+
+    /**
+     * Add a bus; its TwoWire and I2CAsyncBus must already be started
+     * @return Bus index, or -1 if full
+     */
+    int8_t addBus(I2CAsyncBus* bus);
+
+    /**
+     * Add a module to poll
+     * @param bus      Index from addBus()
+     * @param address  7-bit I2C address
+     * @param tx       Bytes written before the read (register pointer, ...);
+     *                 copied, may be nullptr
+     * @param txLength 0 .. HUB_MAX_TX
+     * @param rxLength Bytes to read, 1 .. HUB_MAX_READ
+     * @param periodUs Poll period in microseconds
+     * @return Module id, or -1 on a bad argument or when full
+     */
+    int8_t addModule(uint8_t bus, uint8_t address, const uint8_t* tx, uint8_t txLength,
+                     uint8_t rxLength, uint32_t periodUs);
+
+    /**
+     * Convenience: read rxLength bytes starting at register reg
+     */
+    int8_t addModule(uint8_t bus, uint8_t address, uint8_t reg, uint8_t rxLength, uint32_t periodUs);
+
+    /**
+     * Give up on a transaction after timeoutUs (default 5 ms)
+     */
+    void setTimeout(uint32_t timeoutUs);
+
+    /**
+     * Pause or resume polling a module (e.g. when it does not answer)
+     */
+    void setEnabled(uint8_t module, bool enabled);
+
+    /**
+     * Change the poll period; the next poll is one new period after the
+     * last one started, or right away if that has passed or the module
+     * was never polled
+     * @return false on a bad module id or a zero period
+     */
+    bool setPeriod(uint8_t module, uint32_t periodUs);
+
+    /**
+     * Read a module when its data-ready line is asserted, not every period.
+     * The pin is an input with pull-up, active low (open drain, may be
+     * shared by several modules). The period of addModule() becomes the
+     * minimum time between two reads.
+     * @param pin        Hub pin of the module's line, -1 = poll every period again
+     * @param fallbackUs Also read after this long without a signal (a stuck
+     *                   or unconnected line), 0 = only when signalled
+     * @return false on a bad module id
+     */
+    bool setDataReady(uint8_t module, int8_t pin, uint32_t fallbackUs = 0);
+
+    /**
+     * Broadcast the hub time (general call) on every bus
+     * @param periodUs Time between syncs, 0 = off (default)
+     */
+    void setTimeSync(uint32_t periodUs);
+
+    /**
+     * Collect finished transactions and start new ones; call every loop()
+     */
+    void poll();
+
+    /**
+     * Take the oldest reading
+     * @return false if none is waiting
+     */
+    bool read(HubReading& reading);
+
+    /**
+     * When poll() has work next: a module or sync due, a transaction to
+     * collect or to time out (e.g. a PowerManager deadline)
+     * @return false if there is nothing to poll
+     */
+    bool getNextDue(uint32_t& dueUs) const;
+
+    uint8_t getPending() const;
+    uint32_t getDropped() const;                  // Readings lost to a full queue
+    uint32_t getErrorCount(uint8_t module) const;
+    uint32_t getLateCount(uint8_t module) const;  // Periods skipped because the bus was busy
+    uint32_t getSignalCount(uint8_t module) const;  // Reads started by the data-ready line
+    uint32_t getSyncCount() const;                // Sync broadcasts sent
+
+private:
+    struct Module {
+        uint8_t bus;
+        uint8_t address;
+        uint8_t tx[HUB_MAX_TX];
+        uint8_t txLength;
+        uint8_t rxLength;
+        bool enabled;
+        bool polled;          // A read was started since addModule()
+        uint32_t periodUs;
+        uint32_t dueUs;
+        uint32_t errors;
+        uint32_t late;
+        int8_t readyPin;      // Data-ready line, -1 = polled every period
+        uint32_t fallbackUs;
+        uint32_t lastUs;      // Start of the last read (or of the schedule)
+        uint32_t signals;
+    };
+
+    static const int8_t NONE = -1;
+    static const int8_t SYNC = -2;  // Bus busy with a time sync broadcast
+
+    struct Bus {
+        I2CAsyncBus* bus;
+        int8_t active;        // Module in progress, NONE or SYNC
+        uint32_t startUs;
+        uint8_t rx[HUB_MAX_READ];
+        uint8_t sync[TIMESYNC_FRAME_LENGTH];
+        uint8_t syncSequence;
+        uint32_t syncDueUs;
+    };
+
+    void complete(Bus& bus, uint32_t now);
+    void startNext(uint8_t index, uint32_t now);
+    bool isDue(const Module& m, uint32_t now) const;
+    bool startSync(Bus& bus, uint32_t now);
+    void push(const HubReading& reading);
+    static void earliest(int32_t& soonest, bool& any, int32_t candidate);
+
+    Bus _buses[HUB_MAX_BUSES];
+    Module _modules[HUB_MAX_MODULES];
+    uint8_t _busCount;
+    uint8_t _moduleCount;
+    uint32_t _timeoutUs;
+    uint32_t _syncPeriodUs;
+    uint32_t _syncs;
+
+    HubReading _queue[HUB_QUEUE_SIZE];
+    uint8_t _head;
+    uint8_t _count;
+    uint32_t _dropped;
+};
+
+#endif // HUB_SCHEDULER_H
@@ -0,0 +1,273 @@
+/*
+    I2CAsyncBus.cpp
+
+    Interrupt-driven I2C master implementation
+*/
+
+#include "I2CAsyncBus.h"
+
+#if I2C_ASYNC_SERCOM
+I2CAsyncBus::I2CAsyncBus(TwoWire* wire, Sercom* hw)
+    : _wire(wire)
+    , _hw(hw)
+#else
+I2CAsyncBus::I2CAsyncBus(TwoWire* wire)
+    : _wire(wire)
+#endif
+    , _address(0)
+    , _tx(nullptr)
+    , _rx(nullptr)
+    , _txLength(0)
+    , _rxLength(0)
+    , _txIndex(0)
+    , _rxIndex(0)
+    , _result(IDLE)
+    , _clockCount(0)
+    , _clockMode(CLOCK_SEGMENT)
+    , _segmentClock(0)
+    , _activeClock(0)
+    , _clockSwitches(0)
+{
+}
+
+void I2CAsyncBus::begin() {
+#if I2C_ASYNC_SERCOM
+    if (_hw == nullptr) return;
+
+    _hw->I2CM.INTENCLR.reg = SERCOM_I2CM_INTENCLR_MASK;
+    const IRQn_Type irq = irqNumber();
+    NVIC_ClearPendingIRQ(irq);
+    NVIC_SetPriority(irq, 2);  // Below the sampling interrupts
+    NVIC_EnableIRQ(irq);
+#endif
+}
+
+bool I2CAsyncBus::setDeviceClock(uint8_t address, uint32_t maxClock) {
+    uint8_t i = 0;
+    while (i < _clockCount && _clocks[i].address != address) i++;
+    if (i == _clockCount) {
+        if (_clockCount >= I2C_ASYNC_MAX_DEVICES) return false;
+        _clocks[_clockCount++].address = address;
+    }
+    _clocks[i].maxClock = maxClock;
+
+    _segmentClock = _clocks[0].maxClock;
+    for (i = 1; i < _clockCount; i++) {
+        if (_clocks[i].maxClock < _segmentClock) _segmentClock = _clocks[i].maxClock;
+    }
+    if (_clockMode == CLOCK_SEGMENT && _result != BUSY) applyClock(_segmentClock);
+    return true;
+}
+
+void I2CAsyncBus::setClockMode(ClockMode mode) {
+    _clockMode = mode;
+    if (mode == CLOCK_SEGMENT && _clockCount > 0 && _result != BUSY) applyClock(_segmentClock);
+}
+
+uint32_t I2CAsyncBus::getClock() const {
+    return _activeClock;
+}
+
+uint32_t I2CAsyncBus::getClockSwitches() const {
+    return _clockSwitches;
+}
+
+uint32_t I2CAsyncBus::clockFor(uint8_t address) const {
+    for (uint8_t i = 0; i < _clockCount; i++) {
+        if (_clocks[i].address == address) return _clocks[i].maxClock;
+    }
+    return _segmentClock;
+}
+
+void I2CAsyncBus::applyClock(uint32_t clock) {
+    if (clock == _activeClock) return;
+    _activeClock = clock;
+    _clockSwitches++;
+    _wire->setClock(clock);
+
+#if I2C_ASYNC_SERCOM
+    if (_hw == nullptr) return;
+
+    // setClock() left CTRLA at Sm/Fm timing; SPEED is enable-protected
+    SercomI2cm& i2c = _hw->I2CM;
+    if (clock > I2C_ASYNC_CLOCK_FAST) {
+        i2c.CTRLA.bit.ENABLE = 0;
+        while (i2c.SYNCBUSY.bit.ENABLE);
+        i2c.CTRLA.bit.SPEED = 1;  // Fm+
+        i2c.CTRLA.bit.ENABLE = 1;
+        while (i2c.SYNCBUSY.bit.ENABLE);
+        i2c.STATUS.bit.BUSSTATE = WIRE_BUS_STATE_IDLE;
+        while (i2c.SYNCBUSY.bit.SYSOP);
+    }
+    begin();  // setClock() also set the NVIC priority back to the core's
+#endif
+}
+
+bool I2CAsyncBus::start(uint8_t address, const uint8_t* tx, uint8_t txLength, uint8_t* rx, uint8_t rxLength) {
+    if (_result == BUSY) return false;
+
+    if (_clockMode == CLOCK_PER_DEVICE && _clockCount > 0) applyClock(clockFor(address));
+
+    _address = address;
+    _tx = tx;
+    _rx = rx;
+    _txLength = tx ? txLength : 0;
+    _rxLength = rx ? rxLength : 0;
+    _txIndex = 0;
+    _rxIndex = 0;
+
+#if I2C_ASYNC_SERCOM
+    if (_hw != nullptr) {
+        SercomI2cm& i2c = _hw->I2CM;
+
+        // Bus owned by another master
+        if (i2c.STATUS.bit.BUSSTATE == WIRE_BUS_STATE_BUSY) {
+            _result = BUS_ERROR;
+            return true;
+        }
+
+        _result = BUSY;
+        i2c.INTFLAG.reg = SERCOM_I2CM_INTFLAG_MASK;
+        i2c.INTENSET.reg = SERCOM_I2CM_INTENSET_MB | SERCOM_I2CM_INTENSET_SB | SERCOM_I2CM_INTENSET_ERROR;
+
+        // Read-only transactions skip the write phase
+        const bool read = (_txLength == 0 && _rxLength > 0);
+        i2c.ADDR.reg = SERCOM_I2CM_ADDR_ADDR((address << 1) | (read ? 1 : 0));
+        return true;
+    }
+#endif
+
+    // Blocking fallback: complete before returning
+    _wire->beginTransmission(address);
+    for (uint8_t i = 0; i < _txLength; i++) _wire->write(_tx[i]);
+    if (_txLength > 0 || _rxLength == 0) {
+        if (_wire->endTransmission(_rxLength == 0) != 0) {
+            _result = NACK;
+            return true;
+        }
+    }
+    if (_rxLength > 0) {
+        const uint8_t received = _wire->requestFrom(address, _rxLength);
+        while (_rxIndex < received && _wire->available()) {
+            _rx[_rxIndex++] = _wire->read();
+        }
+        _result = (_rxIndex == _rxLength) ? DONE : NACK;
+        return true;
+    }
+    _result = DONE;
+    return true;
+}
+
+void I2CAsyncBus::abort() {
+    if (_result != BUSY) return;
+
+#if I2C_ASYNC_SERCOM
+    if (_hw != nullptr) {
+        _hw->I2CM.INTENCLR.reg = SERCOM_I2CM_INTENCLR_MASK;
+        sendStop();
+        // Force the bus state back to idle in case the stop did not go out
+        _hw->I2CM.STATUS.bit.BUSSTATE = WIRE_BUS_STATE_IDLE;
+        while (_hw->I2CM.SYNCBUSY.bit.SYSOP);
+    }
+#endif
+    _result = ABORTED;
+}
+
+I2CAsyncBus::Result I2CAsyncBus::getResult() const {
+    return _result;
+}
+
+bool I2CAsyncBus::isBusy() const {
+    return _result == BUSY;
+}
+
+uint8_t I2CAsyncBus::getReceived() const {
+    return _rxIndex;
+}
+
+void I2CAsyncBus::finish(Result result) {
+#if I2C_ASYNC_SERCOM
+    if (_hw != nullptr) _hw->I2CM.INTENCLR.reg = SERCOM_I2CM_INTENCLR_MASK;
+#endif
+    _result = result;
+}
+
+void I2CAsyncBus::onService() {
+#if I2C_ASYNC_SERCOM
+    if (_hw == nullptr) return;
+    SercomI2cm& i2c = _hw->I2CM;
+    const uint8_t flags = i2c.INTFLAG.reg;
+
+    if (_result != BUSY) {
+        i2c.INTENCLR.reg = SERCOM_I2CM_INTENCLR_MASK;
+        return;
+    }
+
+    if (flags & SERCOM_I2CM_INTFLAG_ERROR) {
+        i2c.INTFLAG.reg = SERCOM_I2CM_INTFLAG_ERROR;
+        finish(BUS_ERROR);
+        return;
+    }
+
+    // Master on bus: address or data byte sent
+    if (flags & SERCOM_I2CM_INTFLAG_MB) {
+        if (i2c.STATUS.bit.ARBLOST || i2c.STATUS.bit.BUSERR) {
+            i2c.INTFLAG.reg = SERCOM_I2CM_INTFLAG_MB;  // Bus already released
+            finish(BUS_ERROR);
+            return;
+        }
+        if (i2c.STATUS.bit.RXNACK) {
+            sendStop();
+            finish(NACK);
+            return;
+        }
+        if (_txIndex < _txLength) {
+            i2c.DATA.reg = _tx[_txIndex++];
+            return;
+        }
+        if (_rxLength > 0) {
+            i2c.ADDR.reg = SERCOM_I2CM_ADDR_ADDR((_address << 1) | 1);  // Repeated start
+            return;
+        }
+        sendStop();
+        finish(DONE);
+        return;
+    }
+
+    // Slave on bus: one byte received, SCL held low until the next command
+    if (flags & SERCOM_I2CM_INTFLAG_SB) {
+        const bool last = (_rxIndex + 1 >= _rxLength);
+        _rx[_rxIndex++] = i2c.DATA.reg;
+        if (last) {
+            i2c.CTRLB.bit.ACKACT = 1;  // NACK the last byte
+            sendStop();
+            finish(DONE);
+        } else {
+            i2c.CTRLB.bit.ACKACT = 0;
+            i2c.CTRLB.bit.CMD = WIRE_MASTER_ACT_READ;
+            while (i2c.SYNCBUSY.bit.SYSOP);
+        }
+    }
+#endif
+}
+
+#if I2C_ASYNC_SERCOM
+void I2CAsyncBus::sendStop() {
+    _hw->I2CM.CTRLB.bit.CMD = WIRE_MASTER_ACT_STOP;
+    while (_hw->I2CM.SYNCBUSY.bit.SYSOP);
+}
+
+IRQn_Type I2CAsyncBus::irqNumber() const {
+    if (_hw == SERCOM0) return SERCOM0_IRQn;
+    if (_hw == SERCOM1) return SERCOM1_IRQn;
+    if (_hw == SERCOM2) return SERCOM2_IRQn;
+    if (_hw == SERCOM3) return SERCOM3_IRQn;
+#if defined(SERCOM4)
+    if (_hw == SERCOM4) return SERCOM4_IRQn;
+#endif
+#if defined(SERCOM5)
+    if (_hw == SERCOM5) return SERCOM5_IRQn;
+#endif
+    return SERCOM0_IRQn;
+}
+#endif
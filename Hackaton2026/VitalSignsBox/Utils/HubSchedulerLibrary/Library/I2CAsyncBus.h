@@ -0,0 +1,153 @@
+/*
+    I2CAsyncBus.h
+
+    Interrupt-driven I2C master transactions on a SAMD21 SERCOM
+
+    TwoWire::requestFrom() blocks until the last byte is in, so a hub that
+    polls several buses can only use one of them at a time. I2CAsyncBus runs
+    one write-then-read transaction per bus from the SERCOM interrupt:
+    start() returns immediately and getResult() tells when it is done, so
+    transactions on different buses overlap.
+
+    The TwoWire instance still owns pins, clock and baud rate: call its
+    begin() first. Between transactions the SERCOM interrupt is disabled
+    again, so blocking Wire calls (drivers, WireScanner) keep working.
+    Call onService() from the SERCOMx_Handler of the bus.
+
+    With setDeviceClock() per device the bus runs at the fastest clock all
+    its devices tolerate, or switches per transaction (setClockMode()).
+
+    Other targets fall back to a blocking transaction inside start().
+*/
+
+#ifndef I2C_ASYNC_BUS_H
+#define I2C_ASYNC_BUS_H
+
+#include <Arduino.h>
+#include <Wire.h>
+
+#if defined(__SAMD21G18A__) || defined(__SAMD21J18A__) || defined(__SAMD21E18A__)
+#define I2C_ASYNC_SERCOM 1
+#else
+#define I2C_ASYNC_SERCOM 0
+#endif
+
+#define I2C_ASYNC_MAX_DEVICES 8         // Devices with their own maximum clock
+#define I2C_ASYNC_CLOCK_FAST 400000UL   // Above: Fm+ timing on the SERCOM
+
+class I2CAsyncBus {
+public:
+    enum Result : uint8_t {
+        IDLE,       // No transaction started yet
+        BUSY,       // Transaction running
+        DONE,       // All bytes sent and received
+        NACK,       // Address or data byte not acknowledged
+        BUS_ERROR,  // Bus error or arbitration lost
+        ABORTED     // Stopped by abort() (e.g. timeout)
+    };
+
+    enum ClockMode : uint8_t {
+        CLOCK_SEGMENT,     // The slowest registered device sets the clock once
+        CLOCK_PER_DEVICE   // start() switches to the addressed device's clock
+    };
+
+    /**
+     * Constructor
+     * @param wire Pointer to the TwoWire instance of the bus (setup only)
+     * @param hw   SERCOM registers of the same bus, e.g. SERCOM1;
+     *             nullptr uses blocking Wire calls
+     */
+#if I2C_ASYNC_SERCOM
+    I2CAsyncBus(TwoWire* wire, Sercom* hw = nullptr);
+#else
+    explicit I2CAsyncBus(TwoWire* wire);
+#endif
+
+    /**
+     * Enable the SERCOM interrupt in the NVIC; call after wire->begin()
+     */
+    void begin();
+
+    /**
+     * Maximum clock of a device on this bus, from its datasheet; call
+     * after begin(). Until the first call the bus keeps its TwoWire clock.
+     * Above 400 kHz (Fm+, up to 1 MHz) also give the pins strong drive
+     * (TwiPinPair::setStrongDrive())
+     * @return false when I2C_ASYNC_MAX_DEVICES addresses are registered
+     */
+    bool setDeviceClock(uint8_t address, uint32_t maxClock);
+
+    /**
+     * Per device restarts the SERCOM (a few microseconds) whenever the
+     * next device has another clock; an address without setDeviceClock()
+     * gets the segment clock
+     */
+    void setClockMode(ClockMode mode);
+
+    /**
+     * Clock set by the bus, 0 while it never set one
+     */
+    uint32_t getClock() const;
+    uint32_t getClockSwitches() const;
+
+    /**
+     * Start a transaction: write txLength bytes, then (repeated start)
+     * read rxLength bytes. Either length may be 0. Buffers must stay valid
+     * until the transaction is no longer BUSY.
+     * @return false if the bus is still busy
+     */
+    bool start(uint8_t address, const uint8_t* tx, uint8_t txLength, uint8_t* rx, uint8_t rxLength);
+
+    /**
+     * Stop a running transaction and release the bus
+     */
+    void abort();
+
+    Result getResult() const;
+    bool isBusy() const;
+
+    /**
+     * Bytes received by the last transaction
+     */
+    uint8_t getReceived() const;
+
+    /**
+     * Interrupt service; call from the SERCOMx_Handler of this bus
+     */
+    void onService();
+
+private:
+    struct DeviceClock {
+        uint8_t address;
+        uint32_t maxClock;
+    };
+
+    void finish(Result result);
+    uint32_t clockFor(uint8_t address) const;
+    void applyClock(uint32_t clock);
+
+    TwoWire* _wire;
+#if I2C_ASYNC_SERCOM
+    Sercom* _hw;
+    void sendStop();
+    IRQn_Type irqNumber() const;
+#endif
+
+    uint8_t _address;
+    const uint8_t* _tx;
+    uint8_t* _rx;
+    uint8_t _txLength;
+    uint8_t _rxLength;
+    volatile uint8_t _txIndex;
+    volatile uint8_t _rxIndex;
+    volatile Result _result;
+
+    DeviceClock _clocks[I2C_ASYNC_MAX_DEVICES];
+    uint8_t _clockCount;
+    ClockMode _clockMode;
+    uint32_t _segmentClock;
+    uint32_t _activeClock;
+    uint32_t _clockSwitches;
+};
+
+#endif // I2C_ASYNC_BUS_H
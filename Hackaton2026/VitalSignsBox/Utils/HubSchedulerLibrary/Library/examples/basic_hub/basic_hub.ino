@@ -0,0 +1,96 @@
+#include <Wire.h>
+#include "TwiPinHelper.h"
+#include "I2CAsyncBus.h"
+#include "HubScheduler.h"
+
+/*
+    Hub polling ECG and SpO2 on one sensor bus and the MCP3426 on the other.
+    Both SERCOMs run their transactions at the same time. Once a second the
+    hub broadcasts its micros(), so the ECG bursts carry hub time stamps.
+    The SpO2 status is only read when the module signals a change on its
+    data-ready line.
+*/
+
+// I2C sensor buses (same as the temperature sketch)
+#define W1_SCL 39  // PA13
+#define W1_SDA 28  // PA12
+#define W2_SCL 13  // PA17
+#define W2_SDA 11  // PA16
+
+TwiPinPair portSensorsA(W1_SCL, W1_SDA);
+TwiPinPair portSensorsB(W2_SCL, W2_SDA);
+
+TwoWire WireSensorA(&sercom1, W1_SDA, W1_SCL);
+TwoWire WireSensorB(&sercom4, W2_SDA, W2_SCL);
+
+I2CAsyncBus busA(&WireSensorA, SERCOM1);
+I2CAsyncBus busB(&WireSensorB, SERCOM4);
+
+// TwoWire only uses these in slave mode; here they drive the async master
+void SERCOM1_Handler() { busA.onService(); }
+void SERCOM4_Handler() { busB.onService(); }
+
+#define ECG_MODULE_ADDR  0x2A
+#define SPO2_MODULE_ADDR 0x2B
+#define MCP3426_ADDR     0x68
+#define SPO2_READY_PIN   7     // SpO2 data-ready line (module pin 9), active low
+
+HubScheduler hub;
+int8_t ecgId, spo2Id, tempId;
+
+void setup() {
+  Serial.begin(115200);
+
+  WireSensorA.begin();
+  WireSensorB.begin();
+  portSensorsA.setPinPeripheralAltStates();
+  portSensorsB.setPinPeripheralStates();
+
+  // MCP3426: continuous 16-bit conversions on CH1, set once (blocking is fine here)
+  WireSensorB.beginTransmission(MCP3426_ADDR);
+  WireSensorB.write(0x18);
+  WireSensorB.endTransmission();
+
+  busA.begin();
+  busB.begin();
+
+  // Every device on a bus tolerates Fm: both buses run at 400 kHz, an ECG
+  // burst takes about 1.5 ms instead of 5 ms
+  busA.setDeviceClock(ECG_MODULE_ADDR, 400000);
+  busA.setDeviceClock(SPO2_MODULE_ADDR, 400000);
+  busB.setDeviceClock(MCP3426_ADDR, 400000);
+  const int8_t a = hub.addBus(&busA);
+  const int8_t b = hub.addBus(&busB);
+
+  const uint8_t ecgBurst[] = { 0x22, 8 };                        // BURST_TIMED, 8 frames
+  ecgId  = hub.addModule(a, ECG_MODULE_ADDR, ecgBurst, 2, 9 + 8 * 6, 10000);  // 100 Hz
+  spo2Id = hub.addModule(a, SPO2_MODULE_ADDR, 0x00, 4, 100000);              // 10 Hz
+  tempId = hub.addModule(b, MCP3426_ADDR, nullptr, 0, 3, 100000);            // 10 Hz
+  hub.setDataReady(spo2Id, SPO2_READY_PIN, 2000000);  // At most 10 Hz, at least every 2 s
+
+  hub.setTimeSync(1000000);  // 1 s: modules track offset and drift between syncs
+}
+
+void loop() {
+  hub.poll();
+
+  HubReading reading;
+  while (hub.read(reading)) {
+    Serial.print(reading.timestampUs);
+    Serial.print(reading.module == ecgId ? " ECG " : reading.module == spo2Id ? " SpO2 " : " Temp ");
+    if (!reading.ok) {
+      Serial.println("no answer");
+      continue;
+    }
+    Serial.print(reading.length);
+    Serial.print(" bytes");
+    if (reading.module == ecgId && reading.length >= 9) {
+      // First frame of the burst in hub time: aligned with timestampUs
+      const uint32_t frameUs = ((uint32_t)reading.data[4] << 24) | ((uint32_t)reading.data[5] << 16)
+                             | ((uint32_t)reading.data[6] << 8) | reading.data[7];
+      Serial.print(", first frame at ");
+      Serial.print(frameUs);
+    }
+    Serial.println();
+  }
+}
@@ -0,0 +1,84 @@
+#include <Wire.h>
+#include "TwiPinHelper.h"
+#include "I2CAsyncBus.h"
+#include "HubScheduler.h"
+#include "HubCache.h"
+
+/*
+    Three consumers of the SpO2 module registers through one cache entry:
+    the alarms need SpO2 within 200 ms, the display SpO2 and pulse rate
+    within 500 ms, the uplink the whole block within 1 s. The module is
+    read every 200 ms, not three times; after a minute the alarms leave
+    and the entry falls back to the display's 500 ms.
+*/
+
+#define W1_SCL 39  // PA13
+#define W1_SDA 28  // PA12
+
+TwiPinPair portSensorsA(W1_SCL, W1_SDA);
+TwoWire WireSensorA(&sercom1, W1_SDA, W1_SCL);
+I2CAsyncBus busA(&WireSensorA, SERCOM1);
+void SERCOM1_Handler() { busA.onService(); }
+
+#define SPO2_MODULE_ADDR 0x2B
+#define SPO2_REG_SPO2       0x06  // 16 bit, 0.1 %
+#define SPO2_REG_PULSE_RATE 0x08  // 16 bit, 0.1 bpm
+
+HubScheduler hub;
+HubCache cache(hub);
+int8_t alarms, display, uplink;
+unsigned long lastDisplay = 0;
+
+uint16_t getU16(const uint8_t* data) {
+  return ((uint16_t)data[0] << 8) | data[1];
+}
+
+void setup() {
+  Serial.begin(115200);
+
+  WireSensorA.begin();
+  portSensorsA.setPinPeripheralAltStates();
+  busA.begin();
+  const int8_t a = hub.addBus(&busA);
+
+  // The widest block first: the others lie inside it and share the entry
+  uplink  = cache.subscribe(a, SPO2_MODULE_ADDR, SPO2_REG_SPO2, 10, 1000000);  // SPO2 .. BEAT_COUNT
+  display = cache.subscribe(a, SPO2_MODULE_ADDR, SPO2_REG_SPO2, 4, 500000);    // SPO2, PULSE_RATE
+  alarms  = cache.subscribe(a, SPO2_MODULE_ADDR, SPO2_REG_SPO2, 2, 200000);    // SPO2
+}
+
+void loop() {
+  hub.poll();
+
+  HubReading reading;
+  while (hub.read(reading)) {
+    cache.update(reading);  // Readings of other modules would be handled here
+  }
+
+  uint8_t data[10];
+  if (alarms >= 0 && cache.get(alarms, data) && getU16(data) != 0 && getU16(data) < 900) {
+    Serial.println("SpO2 below 90 %");
+  }
+
+  if (millis() - lastDisplay >= 1000) {
+    lastDisplay = millis();
+    if (cache.get(display, data)) {
+      Serial.print("SpO2 ");
+      Serial.print(getU16(data) / 10.0f, 1);
+      Serial.print(" % pulse ");
+      Serial.print(getU16(data + 2) / 10.0f, 1);
+    } else {
+      Serial.print("no data");
+    }
+    Serial.print(", module reads ");
+    Serial.print(cache.getReadCount(display));
+    Serial.print(", every ");
+    Serial.print(cache.getRefreshUs(display));
+    Serial.println(" us");
+  }
+
+  if (alarms >= 0 && millis() > 60000) {
+    cache.unsubscribe(alarms);
+    alarms = -1;
+  }
+}
@@ -0,0 +1,139 @@
+/*
+    HubSnapshot.cpp
+
+    Coherent multi-module view implementation
+*/
+
+#include "HubSnapshot.h"
+
+// Single core: only the compiler may reorder around the sequence counter
+#define SNAPSHOT_BARRIER() __asm__ volatile("" ::: "memory")
+
+HubSnapshot::HubSnapshot()
+    : _sourceCount(0)
+    , _changed(false)
+    , _sequence(0)
+    , _version(0)
+    , _retries(0)
+{
+    memset(&_working, 0, sizeof(_working));
+    memset(_published, 0, sizeof(_published));
+}
+
+int8_t HubSnapshot::addSource(uint8_t module, uint8_t offset, uint8_t length, uint32_t maxAgeUs,
+                              int8_t stampOffset) {
+    if (_sourceCount >= SNAPSHOT_MAX_SOURCES) return -1;
+    if (length == 0 || length > SNAPSHOT_MAX_RECORD || offset + length > HUB_MAX_READ) return -1;
+    if (stampOffset >= 0 && stampOffset + 4 > HUB_MAX_READ) return -1;
+
+    Source& s = _sources[_sourceCount];
+    s.module = module;
+    s.offset = offset;
+    s.length = length;
+    s.stampOffset = stampOffset;
+    s.maxAgeUs = maxAgeUs;
+    _working.sourceCount = _sourceCount + 1;
+    return _sourceCount++;
+}
+
+bool HubSnapshot::update(const HubReading& reading) {
+    if (!reading.ok) return false;
+
+    bool taken = false;
+    for (uint8_t i = 0; i < _sourceCount; i++) {
+        const Source& s = _sources[i];
+        if (s.module != reading.module || s.offset + s.length > reading.length) continue;
+
+        uint32_t stamp = reading.timestampUs;
+        if (s.stampOffset >= 0) {
+            if (s.stampOffset + 4 > reading.length) continue;
+            const uint8_t* p = &reading.data[s.stampOffset];
+            stamp = ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+        }
+        set(i, &reading.data[s.offset], s.length, stamp);
+        taken = true;
+    }
+    return taken;
+}
+
+void HubSnapshot::set(uint8_t source, const uint8_t* data, uint8_t length, uint32_t timestampUs) {
+    if (source >= _sourceCount || data == nullptr) return;
+
+    SnapshotRecord& r = _working.records[source];
+    r.length = length > SNAPSHOT_MAX_RECORD ? SNAPSHOT_MAX_RECORD : length;
+    memcpy(r.data, data, r.length);
+    r.timestampUs = timestampUs;
+    r.valid = true;
+    r.version = _working.version + 1;  // The version the next publish() gives out
+    _changed = true;
+}
+
+bool HubSnapshot::publish() {
+    const uint32_t now = micros();
+
+    // Ageing alone is a change too: consumers must not keep trusting a stale record
+    bool changed = _changed;
+    uint8_t freshCount = 0;
+    int32_t newest = 0;
+    int32_t oldest = 0;
+    for (uint8_t i = 0; i < _sourceCount; i++) {
+        SnapshotRecord& r = _working.records[i];
+        const int32_t age = (int32_t)(now - r.timestampUs);  // Negative: stamped by a module slightly ahead
+        const bool fresh = r.valid && (_sources[i].maxAgeUs == 0 || age <= (int32_t)_sources[i].maxAgeUs);
+        if (fresh != r.fresh) {
+            r.fresh = fresh;
+            r.version = _working.version + 1;
+            changed = true;
+        }
+        if (!fresh) continue;
+
+        const int32_t stamp = -age;  // Relative to now, so the spread survives the micros() wrap
+        if (freshCount == 0 || stamp > newest) newest = stamp;
+        if (freshCount == 0 || stamp < oldest) oldest = stamp;
+        freshCount++;
+    }
+    if (!changed) return false;
+
+    _working.version++;
+    _working.publishedUs = now;
+    _working.freshCount = freshCount;
+    _working.spreadUs = (uint32_t)(newest - oldest);
+    _changed = false;
+
+    // Latch: send the readers to the other copy before writing each one
+    const uint32_t sequence = _sequence;
+    _sequence = sequence + 1;
+    SNAPSHOT_BARRIER();
+    _published[sequence & 1] = _working;
+    SNAPSHOT_BARRIER();
+    _sequence = sequence + 2;
+    SNAPSHOT_BARRIER();
+    _published[(sequence + 1) & 1] = _working;
+    SNAPSHOT_BARRIER();
+    _version = _working.version;
+    return true;
+}
+
+bool HubSnapshot::read(SnapshotFrame& frame) const {
+    for (uint8_t attempt = 0; attempt < SNAPSHOT_READ_RETRIES; attempt++) {
+        const uint32_t sequence = _sequence;
+        SNAPSHOT_BARRIER();
+        frame = _published[sequence & 1];
+        SNAPSHOT_BARRIER();
+        if (_sequence == sequence) return frame.version != 0;
+        _retries = _retries + 1;  // A publish() came in between: that copy may be torn
+    }
+    return false;
+}
+
+uint32_t HubSnapshot::getVersion() const {
+    return _version;
+}
+
+uint8_t HubSnapshot::getSourceCount() const {
+    return _sourceCount;
+}
+
+uint32_t HubSnapshot::getRetries() const {
+    return _retries;
+}
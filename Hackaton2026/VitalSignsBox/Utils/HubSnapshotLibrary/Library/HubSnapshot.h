@@ -0,0 +1,126 @@
+/*
+    HubSnapshot.h
+
+    Coherent multi-module view on the hub
+
+    Every module reading (HubScheduler) updates that module's record in a
+    working frame: the bytes the consumers need and the time the values
+    were taken. publish() makes the whole working frame visible in one
+    step as a new version, so a consumer sees ECG, SpO2 and temperature
+    from one composite frame instead of values picked up at different
+    moments. Records come from readings the hub already does; the
+    snapshot never touches a bus.
+
+    The frame is published with a seqlock in its latch form: two copies
+    and a sequence counter whose lowest bit selects the copy readers use.
+    The writer only ever writes the copy readers are not sent to, so a
+    reader never waits, also in an interrupt that preempts publish().
+    A reader that is overtaken by a publish sees the counter change and
+    simply copies again; there are no locks and interrupts stay enabled.
+*/
+
+#ifndef HUB_SNAPSHOT_H
+#define HUB_SNAPSHOT_H
+
+#include <Arduino.h>
+#include "HubScheduler.h"
+
+#define SNAPSHOT_MAX_SOURCES 8
+#define SNAPSHOT_MAX_RECORD 16   // Bytes kept per source
+#define SNAPSHOT_READ_RETRIES 4  // Copies tried before read() gives up
+
+struct SnapshotRecord {
+    bool valid;                  // A reading arrived since start-up
+    bool fresh;                  // Not older than the source's maxAgeUs at publish()
+    uint8_t length;              // Bytes in data
+    uint32_t timestampUs;        // When the values were taken (hub micros())
+    uint32_t version;            // Frame version that last changed this record
+    uint8_t data[SNAPSHOT_MAX_RECORD];
+};
+
+struct SnapshotFrame {
+    uint32_t version;            // +1 per publish(), 0 = nothing published yet
+    uint32_t publishedUs;        // micros() at publish()
+    uint32_t spreadUs;           // Newest minus oldest timestamp of the fresh records
+    uint8_t sourceCount;
+    uint8_t freshCount;
+    SnapshotRecord records[SNAPSHOT_MAX_SOURCES];
+};
+
+class HubSnapshot {
+public:
+    HubSnapshot();
+
+    /**
+     * Take part of a module's response into the snapshot
+     * @param module      Id from HubScheduler::addModule()
+     * @param offset      First response byte to keep
+     * @param length      Bytes to keep, 1 .. SNAPSHOT_MAX_RECORD
+     * @param maxAgeUs    Older records are marked not fresh, 0 = never stale
+     * @param stampOffset Response byte of a 32-bit hub time stamp taken by
+     *                    the module itself (e.g. SpO2 SAMPLE_TIME), -1 = the
+     *                    time the hub started the read (default)
+     * @return Source index into SnapshotFrame::records, or -1 on a bad
+     *         argument or when full
+     */
+    int8_t addSource(uint8_t module, uint8_t offset, uint8_t length, uint32_t maxAgeUs,
+                     int8_t stampOffset = -1);
+
+    /**
+     * Writer: record a reading in the working frame (not visible until
+     * publish()); readings that failed or belong to no source are ignored
+     * @return true if a source took it
+     */
+    bool update(const HubReading& reading);
+
+    /**
+     * Writer: record values that did not come from the scheduler
+     */
+    void set(uint8_t source, const uint8_t* data, uint8_t length, uint32_t timestampUs);
+
+    /**
+     * Writer: make the working frame the new version, if anything changed
+     * since the last publish(). One writer only (e.g. loop())
+     * @return true if a new version was published
+     */
+    bool publish();
+
+    /**
+     * Reader: copy the latest published frame; safe from loop() and from
+     * interrupts, never blocks
+     * @return false if nothing was published yet, or if every retry was
+     *         overtaken by a publish() (only an interrupt that publishes
+     *         faster than one copy takes)
+     */
+    bool read(SnapshotFrame& frame) const;
+
+    /**
+     * Version of the latest published frame, 0 if none; cheap check for
+     * "anything new" before a read()
+     */
+    uint32_t getVersion() const;
+
+    uint8_t getSourceCount() const;
+    uint32_t getRetries() const;   // Copies read() had to repeat
+
+private:
+    struct Source {
+        uint8_t module;
+        uint8_t offset;
+        uint8_t length;
+        int8_t stampOffset;
+        uint32_t maxAgeUs;
+    };
+
+    Source _sources[SNAPSHOT_MAX_SOURCES];
+    uint8_t _sourceCount;
+    bool _changed;
+
+    SnapshotFrame _working;               // Writer only
+    SnapshotFrame _published[2];
+    volatile uint32_t _sequence;          // Lowest bit: copy the readers use
+    volatile uint32_t _version;
+    mutable volatile uint32_t _retries;
+};
+
+#endif // HUB_SNAPSHOT_H
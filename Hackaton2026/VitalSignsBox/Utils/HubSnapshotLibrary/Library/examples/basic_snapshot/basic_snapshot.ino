@@ -0,0 +1,109 @@
+#include <Wire.h>
+#include "TwiPinHelper.h"
+#include "I2CAsyncBus.h"
+#include "HubScheduler.h"
+#include "HubSnapshot.h"
+
+/*
+    Hub combining heart rate, SpO2 and temperature into one snapshot.
+    Every reading updates its record; after each poll the snapshot is
+    published as a new version. The consumer prints once a second from a
+    single consistent frame, with the time between the oldest and the
+    newest value.
+*/
+
+#define W1_SCL 39  // PA13
+#define W1_SDA 28  // PA12
+#define W2_SCL 13  // PA17
+#define W2_SDA 11  // PA16
+
+TwiPinPair portSensorsA(W1_SCL, W1_SDA);
+TwiPinPair portSensorsB(W2_SCL, W2_SDA);
+TwoWire WireSensorA(&sercom1, W1_SDA, W1_SCL);
+TwoWire WireSensorB(&sercom4, W2_SDA, W2_SCL);
+I2CAsyncBus busA(&WireSensorA, SERCOM1);
+I2CAsyncBus busB(&WireSensorB, SERCOM4);
+void SERCOM1_Handler() { busA.onService(); }
+void SERCOM4_Handler() { busB.onService(); }
+
+#define ECG_MODULE_ADDR  0x2A
+#define SPO2_MODULE_ADDR 0x2B
+#define MCP3426_ADDR     0x68
+#define ECG_REG_HEART_RATE 0x12  // HEART_RATE .. LEAD_CHANGES, 12 bytes
+#define SPO2_REG_SPO2      0x06  // SPO2 .. SAMPLE_TIME, 14 bytes
+
+HubScheduler hub;
+HubSnapshot snapshot;
+int8_t heartRate, leads, spo2, temperature;
+unsigned long lastPrint = 0;
+
+uint16_t getU16(const uint8_t* data) {
+  return ((uint16_t)data[0] << 8) | data[1];
+}
+
+void setup() {
+  Serial.begin(115200);
+
+  WireSensorA.begin();
+  WireSensorB.begin();
+  portSensorsA.setPinPeripheralAltStates();
+  portSensorsB.setPinPeripheralStates();
+
+  // MCP3426: continuous 16-bit conversions on CH1
+  WireSensorB.beginTransmission(MCP3426_ADDR);
+  WireSensorB.write(0x18);
+  WireSensorB.endTransmission();
+
+  busA.begin();
+  busB.begin();
+  const int8_t a = hub.addBus(&busA);
+  const int8_t b = hub.addBus(&busB);
+  const int8_t ecgId  = hub.addModule(a, ECG_MODULE_ADDR, ECG_REG_HEART_RATE, 12, 200000);  // 5 Hz
+  const int8_t spo2Id = hub.addModule(a, SPO2_MODULE_ADDR, SPO2_REG_SPO2, 14, 200000);      // 5 Hz
+  const int8_t tempId = hub.addModule(b, MCP3426_ADDR, nullptr, 0, 3, 500000);              // 2 Hz
+  hub.setTimeSync(1000000);
+
+  // module, offset, length, max age, module time stamp
+  heartRate   = snapshot.addSource(ecgId, 0, 2, 1000000);       // HEART_RATE
+  leads       = snapshot.addSource(ecgId, 10, 1, 1000000);      // LEAD_STATUS
+  spo2        = snapshot.addSource(spo2Id, 0, 2, 1000000, 10);  // SPO2, stamped by SAMPLE_TIME
+  temperature = snapshot.addSource(tempId, 0, 2, 2000000);      // MCP3426 code
+}
+
+void loop() {
+  hub.poll();
+
+  HubReading reading;
+  while (hub.read(reading)) {
+    snapshot.update(reading);
+  }
+  snapshot.publish();  // No-op unless a record changed or went stale
+
+  // Consumer: could as well run in a timer interrupt
+  if (millis() - lastPrint < 1000) return;
+  lastPrint = millis();
+
+  SnapshotFrame frame;
+  if (!snapshot.read(frame)) return;
+  Serial.print("v");
+  Serial.print(frame.version);
+  Serial.print(" HR ");
+  printRecord(frame.records[heartRate], getU16(frame.records[heartRate].data));
+  Serial.print(" leads ");
+  printRecord(frame.records[leads], frame.records[leads].data[0]);
+  Serial.print(" SpO2 ");
+  printRecord(frame.records[spo2], getU16(frame.records[spo2].data));
+  Serial.print(" temp ");
+  printRecord(frame.records[temperature], (int16_t)getU16(frame.records[temperature].data));
+  Serial.print(" spread ");
+  Serial.print(frame.spreadUs);
+  Serial.println(" us");
+}
+
+void printRecord(const SnapshotRecord& record, int32_t value) {
+  if (!record.fresh) {
+    Serial.print("-");
+    return;
+  }
+  Serial.print(value);
+}
@@ -0,0 +1,227 @@
+/*
+    I2CRegisterSlave.cpp
+
+    Register-mapped I2C slave implementation
+*/
+
+#include "I2CRegisterSlave.h"
+#include "RuntimeStats.h"
+
+#if defined(TRACE_RECORDER_ENABLED)
+#include <TraceRecorder.h>
+#else
+#define TRACE_BEGIN(event, arg) ((void)0)
+#define TRACE_END(event, arg) ((void)0)
+#endif
+
+I2CRegisterSlave* I2CRegisterSlave::_instance = nullptr;
+
+I2CRegisterSlave::I2CRegisterSlave(TwoWire* wire, uint8_t size)
+    : _wire(wire)
+    , _size(size > MAX_REGISTERS ? MAX_REGISTERS : size)
+    , _front(0)
+    , _pointer(0)
+    , _writeHandler(nullptr)
+    , _readHandler(nullptr)
+    , _commandHandler(nullptr)
+    , _stats(nullptr)
+    , _readyPin(-1)
+    , _readyFirst(0)
+    , _readyCount(0)
+    , _ready(false)
+#if I2C_SLAVE_SERCOM
+    , _hw(nullptr)
+#endif
+{
+    memset(_banks, 0, sizeof(_banks));
+}
+
+void I2CRegisterSlave::begin(uint8_t address) {
+    _instance = this;
+    _wire->begin(address);
+    _wire->onReceive(receiveTrampoline);
+    _wire->onRequest(requestTrampoline);
+}
+
+void I2CRegisterSlave::onWrite(WriteHandler handler) {
+    _writeHandler = handler;
+}
+
+void I2CRegisterSlave::onRead(ReadHandler handler) {
+    _readHandler = handler;
+}
+
+void I2CRegisterSlave::onCommand(CommandHandler handler) {
+    _commandHandler = handler;
+}
+
+void I2CRegisterSlave::setStats(RuntimeStats* stats) {
+    _stats = stats;
+}
+
+void I2CRegisterSlave::setDataReadyPin(int8_t pin, uint8_t first, uint8_t count) {
+    _readyPin = pin;
+    _readyFirst = first < _size ? first : _size;
+    _readyCount = count < _size - _readyFirst ? count : _size - _readyFirst;
+    if (pin < 0) return;
+    pinMode(pin, INPUT);
+    digitalWrite(pin, LOW);  // Output latch low for the asserted state, pull-up off
+    _ready = false;
+}
+
+void I2CRegisterSlave::notifyDataReady() {
+    if (_readyPin >= 0) assertDataReady();
+}
+
+bool I2CRegisterSlave::isDataReady() const {
+    return _ready;
+}
+
+// From loop(): the request handler must not release between flag and pin
+void I2CRegisterSlave::assertDataReady() {
+    noInterrupts();
+    setDataReady(true);
+    interrupts();
+}
+
+// Open drain: drive low to assert, float to release
+void I2CRegisterSlave::setDataReady(bool asserted) {
+    if (_readyPin < 0 || _ready == asserted) return;
+    _ready = asserted;
+    pinMode(_readyPin, asserted ? OUTPUT : INPUT);
+}
+
+#if I2C_SLAVE_SERCOM
+void I2CRegisterSlave::enableGeneralCall(Sercom* hw) {
+    _hw = hw;
+
+    // The address register is enable-protected
+    hw->I2CS.CTRLA.bit.ENABLE = 0;
+    while (hw->I2CS.SYNCBUSY.bit.ENABLE);
+    hw->I2CS.ADDR.bit.GENCEN = 1;
+    hw->I2CS.CTRLA.bit.ENABLE = 1;
+    while (hw->I2CS.SYNCBUSY.bit.ENABLE);
+}
+#endif
+
+void I2CRegisterSlave::set8(uint8_t reg, uint8_t value) {
+    if (reg < _size) {
+        _banks[_front ^ 1][reg] = value;
+    }
+}
+
+void I2CRegisterSlave::set16(uint8_t reg, uint16_t value) {
+    set8(reg, value >> 8);
+    set8(reg + 1, value & 0xFF);
+}
+
+void I2CRegisterSlave::set32(uint8_t reg, uint32_t value) {
+    set16(reg, value >> 16);
+    set16(reg + 2, value & 0xFFFF);
+}
+
+void I2CRegisterSlave::publish() {
+    const uint8_t back = _front ^ 1;
+
+    __asm__ volatile("" ::: "memory");  // Bank complete before it is published
+    _front = back;                      // Single byte store: atomic
+
+    // Tell the hub only when there is something new to read
+    if (_readyPin >= 0
+        && memcmp(&_banks[back][_readyFirst], &_banks[back ^ 1][_readyFirst], _readyCount) != 0) {
+        assertDataReady();
+    }
+
+    // Start the next round from what was just published
+    memcpy(_banks[back ^ 1], _banks[back], _size);
+}
+
+uint8_t I2CRegisterSlave::getPointer() const {
+    return _pointer;
+}
+
+void I2CRegisterSlave::receiveTrampoline(int howMany) {
+    TRACE_BEGIN(TraceRecorder::EV_I2C_RECEIVE, howMany);
+    if (_instance) {
+        RuntimeStats* const stats = _instance->_stats;
+        const uint32_t start = stats ? stats->isrBegin() : 0;
+        _instance->handleReceive(howMany);
+        if (stats) {
+            _instance->checkBusErrors();
+            stats->isrEnd(start);
+        }
+    }
+    TRACE_END(TraceRecorder::EV_I2C_RECEIVE, howMany);
+}
+
+void I2CRegisterSlave::requestTrampoline() {
+    TRACE_BEGIN(TraceRecorder::EV_I2C_REQUEST, _instance ? _instance->_pointer : 0);
+    if (_instance) {
+        RuntimeStats* const stats = _instance->_stats;
+        const uint32_t start = stats ? stats->isrBegin() : 0;
+        _instance->handleRequest();
+        if (stats) {
+            _instance->checkBusErrors();
+            stats->isrEnd(start);
+        }
+    }
+    TRACE_END(TraceRecorder::EV_I2C_REQUEST, 0);
+}
+
+// Error flags the Wire driver does not look at: count and clear them
+void I2CRegisterSlave::checkBusErrors() {
+#if I2C_SLAVE_SERCOM
+    if (_hw == nullptr) return;
+    const uint16_t errors = _hw->I2CS.STATUS.reg
+                            & (SERCOM_I2CS_STATUS_BUSERR | SERCOM_I2CS_STATUS_COLL | SERCOM_I2CS_STATUS_LOWTOUT);
+    if (errors != 0) {
+        _hw->I2CS.STATUS.reg = errors;  // Write one to clear
+        _stats->onBusError();
+    }
+#endif
+}
+
+// First byte sets the pointer, further bytes go to the write handler;
+// a command goes to the command handler and leaves the pointer alone
+void I2CRegisterSlave::handleReceive(int howMany) {
+    if (howMany < 1) return;
+
+    uint8_t reg = _wire->read();
+    if (reg >= COMMAND_FIRST) {
+        uint8_t command[MAX_COMMAND];
+        uint8_t length = 0;
+        bool tooLong = false;
+        command[length++] = reg;
+        while (_wire->available()) {
+            const uint8_t value = _wire->read();
+            if (length < MAX_COMMAND) {
+                command[length++] = value;
+            } else {
+                tooLong = true;
+            }
+        }
+        if (tooLong && _stats) _stats->onBusError();
+        if (_commandHandler && !tooLong) _commandHandler(command, length);
+        return;
+    }
+    _pointer = reg;
+    while (_wire->available()) {
+        const uint8_t value = _wire->read();
+        if (_writeHandler) _writeHandler(reg, value);
+        reg++;
+    }
+}
+
+// Send from the pointer to the end of the map; the master stops when it has enough
+void I2CRegisterSlave::handleRequest() {
+    const uint8_t reg = _pointer;
+
+    setDataReady(false);  // The master is reading: anything published so far is seen
+    if (_readHandler && _readHandler(reg)) return;
+
+    if (reg < _size) {
+        _wire->write(&_banks[_front][reg], _size - reg);
+    } else {
+        _wire->write((uint8_t)0xFF);  // Unmapped register
+    }
+}
@@ -0,0 +1,164 @@
+/*
+    I2CRegisterSlave.h
+
+    Register-mapped I2C slave for the VitalSignsBox modules
+
+    The master writes a register pointer, then reads N bytes: the response
+    starts at the pointer and auto-increments. loop() updates a shadow
+    register file with set8()/set16()/set32() and makes it visible in one
+    step with publish(), so a read never mixes old and new values and the
+    request handler only copies bytes.
+
+    Master writes with more than one byte store the extra bytes from the
+    pointer on, through an optional write handler. Registers that cannot be
+    precomputed (e.g. a FIFO) are served by an optional read handler.
+
+    A write whose first byte is COMMAND_FIRST or above is a command, not a
+    register pointer: it goes to an optional command handler as a whole.
+    With enableGeneralCall() the slave also accepts writes to address 0x00,
+    so the hub can send one command to all modules (e.g. the time sync).
+
+    With setStats() both handlers are timed and bus errors counted in a
+    RuntimeStats, for the module's diagnostics register block.
+
+    With setDataReadyPin() the slave drives an open-drain data-ready line
+    to the hub: publish() pulls it low when the registers changed, the
+    next read by the master releases it. The hub then reads only the
+    modules that signalled instead of polling them all.
+*/
+
+#ifndef I2C_REGISTER_SLAVE_H
+#define I2C_REGISTER_SLAVE_H
+
+#include <Arduino.h>
+#include <Wire.h>
+
+class RuntimeStats;
+
+#if defined(__SAMD21G18A__) || defined(__SAMD21J18A__) || defined(__SAMD21E18A__)
+#define I2C_SLAVE_SERCOM 1
+#else
+#define I2C_SLAVE_SERCOM 0
+#endif
+
+class I2CRegisterSlave {
+public:
+    static const uint8_t MAX_REGISTERS = 32;
+    static const uint8_t COMMAND_FIRST = 0xF0;   // Above every register map
+    static const uint8_t MAX_COMMAND = 16;       // Longer commands are dropped
+
+    // Called from the I2C interrupt for every byte written to 'reg'
+    typedef void (*WriteHandler)(uint8_t reg, uint8_t value);
+
+    // Called from the I2C interrupt before a read at 'reg'; return true if
+    // the handler wrote the response itself with Wire.write()
+    typedef bool (*ReadHandler)(uint8_t reg);
+
+    // Called from the I2C interrupt with a complete command write
+    typedef void (*CommandHandler)(const uint8_t* data, uint8_t length);
+
+    /**
+     * Constructor
+     * @param wire Pointer to the I2C bus to serve
+     * @param size Number of shadow registers (at most MAX_REGISTERS)
+     */
+    I2CRegisterSlave(TwoWire* wire, uint8_t size);
+
+    /**
+     * Join the bus as slave and register the event handlers
+     * Only one register slave per program (the Wire callbacks are global)
+     * @param address 7-bit slave address
+     */
+    void begin(uint8_t address);
+
+    void onWrite(WriteHandler handler);
+    void onRead(ReadHandler handler);
+    void onCommand(CommandHandler handler);
+
+    /**
+     * Time the receive and request handlers and count bus errors (dropped
+     * commands; on SAMD21 also the SERCOM error flags, once
+     * enableGeneralCall() has given the SERCOM)
+     */
+    void setStats(RuntimeStats* stats);
+
+#if I2C_SLAVE_SERCOM
+    /**
+     * Also accept writes to the general call address 0x00; call after begin()
+     * @param hw SERCOM of the bus, e.g. SERCOM3 for Wire on the Zero variant
+     */
+    void enableGeneralCall(Sercom* hw);
+#endif
+
+    /**
+     * Update shadow registers (not visible to the master until publish())
+     * Multi-byte values are stored big endian
+     */
+    void set8(uint8_t reg, uint8_t value);
+    void set16(uint8_t reg, uint16_t value);
+    void set32(uint8_t reg, uint32_t value);
+
+    /**
+     * Make all shadow updates visible to the master at once
+     */
+    void publish();
+
+    /**
+     * Drive an open-drain data-ready (INT) line, active low; call before
+     * begin(). The line is released (input, no pull-up: the hub pulls it
+     * up) and asserted by publish() when a watched register differs from
+     * the previous publish, or by notifyDataReady(). Any read by the
+     * master releases it. Several modules may share one line.
+     * @param pin   Data-ready pin, -1 to disable (default)
+     * @param first First watched register, e.g. the block the hub polls
+     * @param count Watched registers (clipped to the map)
+     */
+    void setDataReadyPin(int8_t pin, uint8_t first = 0, uint8_t count = MAX_REGISTERS);
+
+    /**
+     * Assert the data-ready line without a register change, e.g. for a FIFO
+     * served by the read handler; call from loop()
+     */
+    void notifyDataReady();
+
+    /**
+     * True while the data-ready line is asserted (not yet read by the master)
+     */
+    bool isDataReady() const;
+
+    /**
+     * Get current register pointer (last register written by the master)
+     */
+    uint8_t getPointer() const;
+
+private:
+    static void receiveTrampoline(int howMany);
+    static void requestTrampoline();
+
+    void handleReceive(int howMany);
+    void handleRequest();
+    void checkBusErrors();
+    void assertDataReady();
+    void setDataReady(bool asserted);
+
+    static I2CRegisterSlave* _instance;
+
+    TwoWire* _wire;
+    uint8_t _size;
+    uint8_t _banks[2][MAX_REGISTERS];
+    volatile uint8_t _front;     // Bank the interrupt reads from
+    volatile uint8_t _pointer;
+    WriteHandler _writeHandler;
+    ReadHandler _readHandler;
+    CommandHandler _commandHandler;
+    RuntimeStats* _stats;
+    int8_t _readyPin;
+    uint8_t _readyFirst;
+    uint8_t _readyCount;
+    volatile bool _ready;
+#if I2C_SLAVE_SERCOM
+    Sercom* _hw;
+#endif
+};
+
+#endif // I2C_REGISTER_SLAVE_H
@@ -0,0 +1,46 @@
+#include <Wire.h>
+#include "I2CRegisterSlave.h"
+
+/*
+    Minimal register-mapped I2C slave
+
+    0x00  16 bit  analog value of A1 (read only)
+    0x02  32 bit  millis() at the last update (read only)
+    0x06   8 bit  built-in LED, 0 = off, 1 = on (read/write)
+*/
+
+#define SLAVE_ADDR 0x30
+
+#define REG_VALUE   0x00
+#define REG_MILLIS  0x02
+#define REG_LED     0x06
+#define REGISTER_COUNT 7
+
+I2CRegisterSlave registers(&Wire, REGISTER_COUNT);
+
+// Written by the I2C interrupt, applied in loop()
+volatile int16_t pendingLed = -1;
+bool ledOn = false;
+
+void writeRegister(uint8_t reg, uint8_t value) {
+  if (reg == REG_LED) pendingLed = value;
+}
+
+void setup() {
+  pinMode(LED_BUILTIN, OUTPUT);
+  registers.onWrite(writeRegister);
+  registers.begin(SLAVE_ADDR);
+}
+
+void loop() {
+  if (pendingLed >= 0) {
+    ledOn = pendingLed != 0;
+    digitalWrite(LED_BUILTIN, ledOn ? HIGH : LOW);
+    pendingLed = -1;
+  }
+
+  registers.set16(REG_VALUE, analogRead(A1));
+  registers.set32(REG_MILLIS, millis());
+  registers.set8(REG_LED, ledOn ? 1 : 0);
+  registers.publish();
+}
@@ -0,0 +1,159 @@
+/*
+    MemoryMonitor.cpp
+
+    Stack painting and buffer peak tracking implementation
+*/
+
+#include "MemoryMonitor.h"
+
+#if defined(__AVR__)
+
+#include <avr/io.h>
+
+extern uint8_t __data_start;
+extern uint8_t __bss_end;
+extern uint8_t __heap_start;
+extern void* __brkval;  // 0 until the first malloc()
+
+static uint8_t* ramStart() { return &__data_start; }
+static uint8_t* staticEnd() { return &__bss_end; }
+static uint8_t* ramEnd() { return (uint8_t*)(RAMEND + 1); }
+static uint8_t* heapEnd() { return __brkval != 0 ? (uint8_t*)__brkval : &__heap_start; }
+#define MEMORY_MONITOR_SUPPORTED 1
+
+#elif defined(ARDUINO_ARCH_SAMD)
+
+extern "C" char* sbrk(int increment);
+extern uint8_t __data_start__;
+extern uint8_t __bss_end__;
+extern uint8_t __StackTop;
+
+static uint8_t* ramStart() { return &__data_start__; }
+static uint8_t* staticEnd() { return &__bss_end__; }
+static uint8_t* ramEnd() { return &__StackTop; }
+static uint8_t* heapEnd() { return (uint8_t*)sbrk(0); }
+#define MEMORY_MONITOR_SUPPORTED 1
+
+#endif
+
+static void putU16(uint8_t* out, uint16_t value) {
+    out[0] = value >> 8;
+    out[1] = value & 0xFF;
+}
+
+MemoryMonitor::MemoryMonitor()
+    : _scan(0)
+    , _boundary(0)
+    , _top(0)
+    , _totalRam(0)
+    , _staticRam(0)
+    , _stackPeak(0)
+    , _minHeadroom(0)
+    , _passes(0)
+    , _painted(false)
+    , _bufferCount(0)
+{
+    for (uint8_t i = 0; i < MAX_BUFFERS; i++) {
+        _capacity[i] = 0;
+        _peak[i] = 0;
+    }
+}
+
+void MemoryMonitor::begin() {
+#ifdef MEMORY_MONITOR_SUPPORTED
+    _top = ramEnd();
+    _totalRam = (uint16_t)(_top - ramStart());
+    _staticRam = (uint16_t)(staticEnd() - ramStart());
+
+    // Everything from the heap to just below this frame is unused now
+    uint8_t* const bottom = heapEnd();
+    uint8_t* const frame = (uint8_t*)__builtin_frame_address(0);
+    uint8_t* const end = frame - STACK_MARGIN > bottom ? frame - STACK_MARGIN : bottom;
+    for (volatile uint8_t* p = bottom; p < end; p++) *p = PAINT;
+
+    _boundary = end;
+    _scan = bottom;
+    _stackPeak = (uint16_t)(_top - end);
+    _minHeadroom = (uint16_t)(end - bottom);
+    _painted = true;
+#endif
+}
+
+uint8_t MemoryMonitor::addBuffer(uint16_t capacity) {
+    if (_bufferCount >= MAX_BUFFERS) return NO_BUFFER;
+    _capacity[_bufferCount] = capacity;
+    _peak[_bufferCount] = 0;
+    return _bufferCount++;
+}
+
+void MemoryMonitor::setLevel(uint8_t id, uint16_t level) {
+    if (id < _bufferCount && level > _peak[id]) _peak[id] = level;
+}
+
+bool MemoryMonitor::update() {
+#ifdef MEMORY_MONITOR_SUPPORTED
+    if (!_painted) return false;
+
+    // The heap may have grown into the painted area since the last pass
+    uint8_t* const bottom = heapEnd();
+    if (_scan < bottom) _scan = bottom;
+
+    for (uint8_t n = 0; n < SCAN_BYTES && _scan < _boundary; n++, _scan++) {
+        if (*(volatile uint8_t*)_scan != PAINT) {
+            _boundary = _scan;  // The stack reached this far down
+            break;
+        }
+    }
+    if (_scan < _boundary) return false;
+
+    // Pass complete: everything up to the boundary is still untouched
+    _stackPeak = (uint16_t)(_top - _boundary);
+    const uint16_t headroom = _boundary > bottom ? (uint16_t)(_boundary - bottom) : 0;
+    if (headroom < _minHeadroom) _minHeadroom = headroom;
+    _scan = bottom;
+    _passes++;
+    return true;
+#else
+    return false;
+#endif
+}
+
+uint16_t MemoryMonitor::getFreeRam() const {
+#ifdef MEMORY_MONITOR_SUPPORTED
+    uint8_t* const frame = (uint8_t*)__builtin_frame_address(0);
+    uint8_t* const bottom = heapEnd();
+    return frame > bottom ? (uint16_t)(frame - bottom) : 0;
+#else
+    return 0;
+#endif
+}
+
+uint16_t MemoryMonitor::getBufferCapacity(uint8_t id) const {
+    return id < _bufferCount ? _capacity[id] : 0;
+}
+
+uint16_t MemoryMonitor::getBufferPeak(uint8_t id) const {
+    return id < _bufferCount ? _peak[id] : 0;
+}
+
+uint8_t MemoryMonitor::getBufferPeakPercent(uint8_t id) const {
+    if (id >= _bufferCount || _capacity[id] == 0) return 0;
+    return (uint8_t)(((uint32_t)_peak[id] * 100 + _capacity[id] / 2) / _capacity[id]);
+}
+
+uint8_t MemoryMonitor::pack(uint8_t* out) const {
+    putU16(out, _totalRam);
+    putU16(out + 2, _staticRam);
+    putU16(out + 4, _stackPeak);
+    putU16(out + 6, _minHeadroom);
+    putU16(out + 8, getFreeRam());
+    out[10] = _bufferCount;
+
+    uint8_t length = REPORT_HEADER;
+    for (uint8_t i = 0; i < _bufferCount; i++) {
+        putU16(out + length, _capacity[i]);
+        putU16(out + length + 2, _peak[i]);
+        length += 4;
+    }
+    return length;
+}
@@ -0,0 +1,105 @@
+/*
+    MemoryMonitor.h
+
+    Stack high-water mark and buffer fill levels, measured on the board
+
+    begin() paints the free RAM between the heap and the stack with a
+    fixed pattern. update() checks a slice of it per call (a full pass
+    takes many loop() iterations, so the loop timing hardly changes); the
+    lowest overwritten byte is the deepest the stack has been. Buffers
+    (rings, queues) report their fill level with setLevel(), the monitor
+    keeps the peak.
+
+    pack() gives all counters as one compact record, for an I2C register
+    or a Telemetry record. SAMD21 (ARM) and AVR; elsewhere all counters
+    stay 0.
+*/
+
+#ifndef MEMORY_MONITOR_H
+#define MEMORY_MONITOR_H
+
+#include <stdint.h>
+
+class MemoryMonitor {
+public:
+    static const uint8_t MAX_BUFFERS = 5;
+    static const uint8_t NO_BUFFER = 0xFF;
+    static const uint8_t PAINT = 0xC5;
+    static const uint8_t SCAN_BYTES = 128;    // Checked per update()
+    static const uint8_t STACK_MARGIN = 64;   // Not painted below begin()'s frame
+    static const uint8_t REPORT_HEADER = 11;
+    static const uint8_t REPORT_MAX = REPORT_HEADER + 4 * MAX_BUFFERS;  // Fits one Telemetry record
+
+    MemoryMonitor();
+
+    /**
+     * Paint the free RAM; call first in setup(), before anything deep runs
+     */
+    void begin();
+
+    /**
+     * Register a buffer to track
+     * @param capacity Size in the buffer's own unit (bytes, frames, entries)
+     * @return Buffer id for setLevel(), NO_BUFFER if all are taken
+     */
+    uint8_t addBuffer(uint16_t capacity);
+
+    /**
+     * Report the current fill level of a buffer; the peak is kept
+     */
+    void setLevel(uint8_t id, uint16_t level);
+
+    /**
+     * Check the next slice of the painted area; call regularly in loop()
+     * @return true when a full pass has completed
+     */
+    bool update();
+
+    // Total RAM, .data + .bss, in bytes
+    uint16_t getTotalRam() const { return _totalRam; }
+    uint16_t getStaticRam() const { return _staticRam; }
+
+    // Deepest stack seen since begin() (measured by the last full pass)
+    uint16_t getStackPeak() const { return _stackPeak; }
+
+    // Smallest gap between heap and stack seen: RAM that was never needed
+    uint16_t getMinHeadroom() const { return _minHeadroom; }
+
+    // Gap between heap and stack right now
+    uint16_t getFreeRam() const;
+
+    uint8_t getBufferCount() const { return _bufferCount; }
+    uint16_t getBufferCapacity(uint8_t id) const;
+    uint16_t getBufferPeak(uint8_t id) const;
+
+    // Peak fill level in percent of the capacity
+    uint8_t getBufferPeakPercent(uint8_t id) const;
+
+    uint32_t getPasses() const { return _passes; }
+
+    /**
+     * Write all counters, big endian:
+     * total, static, stack peak, min headroom, free (16 bit each),
+     * buffer count (8 bit), per buffer capacity and peak (16 bit each)
+     * @param out At least REPORT_MAX bytes
+     * @return Number of bytes written
+     */
+    uint8_t pack(uint8_t* out) const;
+
+private:
+    uint8_t* _scan;      // Next byte to check
+    uint8_t* _boundary;  // Lowest byte the stack has overwritten
+    uint8_t* _top;       // End of RAM (initial stack pointer)
+    uint16_t _totalRam;
+    uint16_t _staticRam;
+    uint16_t _stackPeak;
+    uint16_t _minHeadroom;
+    uint32_t _passes;
+    bool _painted;
+
+    uint8_t _bufferCount;
+    uint16_t _capacity[MAX_BUFFERS];
+    uint16_t _peak[MAX_BUFFERS];
+};
+
+#endif // MEMORY_MONITOR_H
@@ -0,0 +1,49 @@
+#include "MemoryMonitor.h"
+
+/*
+    Paint the stack at boot, track a small command buffer and print the
+    stack high-water mark and the buffer peak after every full check.
+*/
+
+#define LINE_SIZE 32
+
+MemoryMonitor memory;
+uint8_t lineBuffer = MemoryMonitor::NO_BUFFER;
+char line[LINE_SIZE];
+uint8_t lineLength = 0;
+
+void setup() {
+  memory.begin();  // Before anything else uses the stack
+  lineBuffer = memory.addBuffer(LINE_SIZE);
+  Serial.begin(115200);
+}
+
+void loop() {
+  while (Serial.available() > 0) {
+    const char c = Serial.read();
+    if (c == '\n' || lineLength == LINE_SIZE) {
+      lineLength = 0;
+    } else {
+      line[lineLength++] = c;
+    }
+    memory.setLevel(lineBuffer, lineLength);
+  }
+
+  if (!memory.update()) return;  // Pass not complete yet
+
+  static uint32_t lastReport = 0;
+  if (millis() - lastReport < 1000) return;
+  lastReport = millis();
+
+  Serial.print("RAM ");
+  Serial.print(memory.getTotalRam());
+  Serial.print(", static ");
+  Serial.print(memory.getStaticRam());
+  Serial.print(", stack peak ");
+  Serial.print(memory.getStackPeak());
+  Serial.print(", headroom ");
+  Serial.print(memory.getMinHeadroom());
+  Serial.print(", line buffer ");
+  Serial.print(memory.getBufferPeakPercent(lineBuffer));
+  Serial.println("%");
+}
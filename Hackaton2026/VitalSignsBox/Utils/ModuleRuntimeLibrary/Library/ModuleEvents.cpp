@@ -0,0 +1,119 @@
+/*
+    ModuleEvents.cpp
+
+    Timestamped state-change events of a module in an I2C-readable FIFO
+*/
+
+#include "ModuleEvents.h"
+
+static_assert((MODULE_EVENTS_CAPACITY & (MODULE_EVENTS_CAPACITY - 1)) == 0 && MODULE_EVENTS_CAPACITY <= 128,
+              "MODULE_EVENTS_CAPACITY: a power of two the uint8_t indices wrap on");
+
+ModuleEvents::ModuleEvents(I2CRegisterSlave& registers)
+    : _registers(registers)
+    , _timeSync(nullptr)
+    , _pin(-1)
+    , _asserted(false)
+    , _sequence(0)
+    , _head(0)
+    , _tail(0)
+    , _dropped(0)
+{
+}
+
+void ModuleEvents::setTimeSync(TimeSync* sync) {
+    _timeSync = sync;
+}
+
+void ModuleEvents::setInterruptPin(int8_t pin) {
+    _pin = pin;
+    _asserted = false;
+    if (pin < 0) return;
+    pinMode(pin, INPUT);
+    digitalWrite(pin, LOW);  // Output latch low for the asserted state, pull-up off
+}
+
+bool ModuleEvents::post(uint8_t source, uint8_t state, uint32_t localMicros) {
+    const uint16_t sequence = _sequence++;
+    const uint8_t head = _head;
+    const bool queued = (uint8_t)(head - _tail) < MODULE_EVENTS_CAPACITY;
+    if (queued) {
+        volatile Event& event = _ring[head & (MODULE_EVENTS_CAPACITY - 1)];
+        event.source = source;
+        event.state = state;
+        event.sequence = sequence;
+        event.time = _timeSync ? _timeSync->toHub(localMicros) : localMicros;
+        _head = head + 1;  // Publishes the slot
+    } else {
+        _dropped = _dropped + 1;
+    }
+
+    if (_pin < 0) {
+        _registers.notifyDataReady();
+        return queued;
+    }
+    // The interrupt must not release between a pop and this assert
+    noInterrupts();
+    setLine(true);
+    interrupts();
+    return queued;
+}
+
+void ModuleEvents::release() {
+    setLine(false);
+}
+
+// Big endian, as the register maps
+uint8_t ModuleEvents::pack(uint8_t* out) {
+    uint8_t tail = _tail;
+    uint8_t waiting = (uint8_t)(_head - tail);
+    const uint8_t count = waiting < MAX_PER_READ ? waiting : MAX_PER_READ;
+    const uint16_t dropped = (uint16_t)_dropped;
+
+    uint8_t* p = out + HEADER_BYTES;
+    for (uint8_t i = 0; i < count; i++, tail++, p += EVENT_BYTES) {
+        const volatile Event& event = _ring[tail & (MODULE_EVENTS_CAPACITY - 1)];
+        const uint16_t sequence = event.sequence;
+        const uint32_t time = event.time;
+        p[0] = event.source;
+        p[1] = event.state;
+        p[2] = sequence >> 8;
+        p[3] = sequence & 0xFF;
+        p[4] = time >> 24;
+        p[5] = (time >> 16) & 0xFF;
+        p[6] = (time >> 8) & 0xFF;
+        p[7] = time & 0xFF;
+    }
+    _tail = tail;  // Frees the slots
+    waiting = (uint8_t)(_head - tail);
+
+    out[0] = count;
+    out[1] = waiting;
+    out[2] = dropped >> 8;
+    out[3] = dropped & 0xFF;
+    if (waiting == 0) setLine(false);
+    return HEADER_BYTES + count * EVENT_BYTES;
+}
+
+uint8_t ModuleEvents::getPending() const {
+    return count();
+}
+
+uint32_t ModuleEvents::getDropped() const {
+    return _dropped;
+}
+
+uint16_t ModuleEvents::getSequence() const {
+    return _sequence;
+}
+
+// Open drain: drive low to assert, float to release
+void ModuleEvents::setLine(bool asserted) {
+    if (_pin < 0 || _asserted == asserted) return;
+    _asserted = asserted;
+    pinMode(_pin, asserted ? OUTPUT : INPUT);
+}
+
+uint8_t ModuleEvents::count() const {
+    return (uint8_t)(_head - _tail);
+}
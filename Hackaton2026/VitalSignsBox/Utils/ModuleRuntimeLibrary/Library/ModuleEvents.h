@@ -0,0 +1,123 @@
+/*
+    ModuleEvents.h
+
+    Timestamped state-change events of a module in an I2C-readable FIFO
+
+    Some module states change rarely but must reach the hub at once: an
+    ECG lead coming off, the SpO2 probe being unplugged. A status register
+    only shows the state at the moment the hub reads it, and a change and
+    its return between two reads are lost. ModuleEvents queues every change
+    with its time, asserts a line to the hub, and hands the queue out at
+    MODULE_REG_EVENTS (0x26, the same address on every module), served by
+    ModuleRuntime.
+
+    The detector posts from loop() (tasks included), the I2C interrupt
+    takes the events: a single-producer single-consumer ring between the
+    two, as the SpscQueue of Workshops/PatternsArchitecture. loop() only
+    writes the head, the interrupt only the tail, so neither side masks
+    the other. A full ring drops the event and counts it; the sequence
+    number has a gap then, the hub can see what it missed.
+
+    The line is either the module's data-ready line of I2CRegisterSlave
+    (notifyDataReady(), released by any read) or a line of its own
+    (setInterruptPin(), asserted while events wait, released when a read
+    empties the FIFO).
+*/
+
+#ifndef MODULE_EVENTS_H
+#define MODULE_EVENTS_H
+
+#include <Arduino.h>
+#include "I2CRegisterSlave.h"
+#include "TimeSync.h"
+
+#define MODULE_REG_EVENTS 0x26          // Event FIFO, the same address on every module
+#define MODULE_EVENTS_CAPACITY 16       // Power of two
+
+class ModuleEvents {
+public:
+    // Event sources; 0x80 and up are free for the module
+    enum Source : uint8_t {
+        LEADS = 1,   // state: lead-off bits (ECG LEAD_STATUS)
+        PROBE = 2    // state: 1 = connected (SpO2 STATUS)
+    };
+
+    struct Event {
+        uint8_t source;
+        uint8_t state;       // The state after the change
+        uint16_t sequence;   // +1 per posted event, dropped ones included
+        uint32_t time;       // Hub time in us (local micros() while unsynced)
+    };
+
+    static const uint8_t HEADER_BYTES = 4;   // Events, still waiting, dropped (16 bit)
+    static const uint8_t EVENT_BYTES = 8;    // Source, state, sequence (16), time (32)
+    static const uint8_t MAX_PER_READ = 7;   // Response inside the 64-byte Wire buffer
+    static const uint8_t MAX_BYTES = HEADER_BYTES + MAX_PER_READ * EVENT_BYTES;
+
+    /**
+     * Constructor
+     * @param registers Register slave whose data-ready line signals an event
+     */
+    explicit ModuleEvents(I2CRegisterSlave& registers);
+
+    /**
+     * Stamp events in hub time; call before the first post()
+     */
+    void setTimeSync(TimeSync* sync);
+
+    /**
+     * Signal events on an open-drain line of their own (active low, the
+     * hub pulls it up) instead of the register slave's data-ready line
+     * @param pin Pin, -1 for the data-ready line (default)
+     */
+    void setInterruptPin(int8_t pin);
+
+    /**
+     * Queue a change and signal the hub; loop() only (one producer)
+     * @param source      Source of the change
+     * @param state       State after the change
+     * @param localMicros micros() when the change happened
+     * @return false when the FIFO was full and the event dropped
+     */
+    bool post(uint8_t source, uint8_t state, uint32_t localMicros);
+    bool post(uint8_t source, uint8_t state) { return post(source, state, micros()); }
+
+    /**
+     * Release the own line with events still waiting, e.g. when the hub
+     * acknowledges a status register instead; the next post() asserts it
+     * again
+     */
+    void release();
+
+    /**
+     * The response at MODULE_REG_EVENTS; I2C interrupt only (one consumer).
+     * Up to MAX_PER_READ events, oldest first, taken from the FIFO. A read
+     * with events still waiting leaves the own line asserted.
+     * @param out MAX_BYTES
+     * @return Bytes written
+     */
+    uint8_t pack(uint8_t* out);
+
+    uint8_t getPending() const;
+    uint32_t getDropped() const;
+    uint16_t getSequence() const;   // Of the next event
+
+private:
+    void setLine(bool asserted);
+    uint8_t count() const;
+
+    I2CRegisterSlave& _registers;
+    TimeSync* _timeSync;
+    int8_t _pin;
+    volatile bool _asserted;
+    uint16_t _sequence;              // loop() only
+
+    // Indices run freely (uint8_t wraps at a multiple of the capacity);
+    // the slots are volatile so a slot is written before the head moves
+    volatile Event _ring[MODULE_EVENTS_CAPACITY];
+    volatile uint8_t _head;          // Written by loop() only
+    volatile uint8_t _tail;          // Written by the I2C interrupt only
+    volatile uint32_t _dropped;      // Written by loop() only
+};
+
+#endif // MODULE_EVENTS_H
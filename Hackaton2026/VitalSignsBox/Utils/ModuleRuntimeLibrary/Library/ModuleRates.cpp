@@ -0,0 +1,135 @@
+/*
+    ModuleRates.cpp
+
+    Sample rates of a module, set by the hub over I2C
+*/
+
+#include "ModuleRates.h"
+
+#define RATES_NO_CHANNEL 0xFF
+
+ModuleRates::ModuleRates()
+    : _count(0)
+    , _handler(nullptr)
+    , _changes(0)
+    , _refused(0)
+    , _pending(0)
+    , _writeChannel(RATES_NO_CHANNEL)
+    , _writeRate(0)
+{
+}
+
+int8_t ModuleRates::addChannel(uint16_t rateHz, uint16_t minHz, uint16_t maxHz, uint8_t maxDecimation) {
+    if (_count >= MODULE_RATES_MAX_CHANNELS || minHz == 0 || minHz > maxHz) return -1;
+    if (rateHz < minHz || rateHz > maxHz || maxDecimation == 0) return -1;
+    Channel& channel = _channels[_count];
+    channel.rate = rateHz;
+    channel.minRate = minHz;
+    channel.maxRate = maxHz;
+    channel.decimation = 1;
+    channel.maxDecimation = maxDecimation;
+    return (int8_t)_count++;
+}
+
+void ModuleRates::onChange(ChangeHandler handler) {
+    _handler = handler;
+}
+
+// I2C interrupt: collect the four bytes, the last one queues the request
+void ModuleRates::onWrite(uint8_t offset, uint8_t value) {
+    switch (offset) {
+        case 0:
+            _writeChannel = value < _count ? value : RATES_NO_CHANNEL;
+            _writeRate = 0;
+            break;
+        case 1:
+            _writeRate = (uint16_t)value << 8;
+            break;
+        case 2:
+            _writeRate |= value;
+            break;
+        case 3:
+            if (_writeChannel == RATES_NO_CHANNEL) break;  // No channel byte in front
+            _pendingRate[_writeChannel] = _writeRate;
+            _pendingDecimation[_writeChannel] = value;
+            _pending |= (uint8_t)(1 << _writeChannel);
+            _writeChannel = RATES_NO_CHANNEL;
+            break;
+        default:
+            break;
+    }
+}
+
+bool ModuleRates::update() {
+    if (_pending == 0) return false;
+
+    bool changed = false;
+    for (uint8_t i = 0; i < _count; i++) {
+        noInterrupts();
+        const bool requested = (_pending & (1 << i)) != 0;
+        const uint16_t requestedRate = _pendingRate[i];
+        const uint8_t requestedDecimation = _pendingDecimation[i];
+        _pending &= (uint8_t)~(1 << i);
+        interrupts();
+        if (!requested) continue;
+
+        const Channel& channel = _channels[i];
+        uint16_t rate = requestedRate == 0 ? channel.rate : requestedRate;
+        if (rate < channel.minRate) rate = channel.minRate;
+        if (rate > channel.maxRate) rate = channel.maxRate;
+        uint8_t decimation = requestedDecimation == 0 ? channel.decimation : requestedDecimation;
+        if (decimation > channel.maxDecimation) decimation = channel.maxDecimation;
+        if (rate == channel.rate && decimation == channel.decimation) continue;
+
+        const uint16_t achieved = _handler ? _handler(i, rate, decimation) : rate;
+        if (achieved == 0) {
+            _refused++;
+            continue;
+        }
+        noInterrupts();  // pack() must not see half a channel
+        _channels[i].rate = achieved;
+        _channels[i].decimation = decimation;
+        interrupts();
+        _changes++;
+        changed = true;
+    }
+    return changed;
+}
+
+// Big endian, as the register maps
+uint8_t ModuleRates::pack(uint8_t* out) const {
+    out[0] = _count;
+    uint8_t* p = out + HEADER_BYTES;
+    for (uint8_t i = 0; i < _count; i++, p += CHANNEL_BYTES) {
+        const Channel& channel = _channels[i];
+        p[0] = channel.rate >> 8;
+        p[1] = channel.rate & 0xFF;
+        p[2] = channel.decimation;
+        p[3] = channel.minRate >> 8;
+        p[4] = channel.minRate & 0xFF;
+        p[5] = channel.maxRate >> 8;
+        p[6] = channel.maxRate & 0xFF;
+        p[7] = channel.maxDecimation;
+    }
+    return HEADER_BYTES + _count * CHANNEL_BYTES;
+}
+
+uint8_t ModuleRates::getChannelCount() const {
+    return _count;
+}
+
+uint16_t ModuleRates::getRate(uint8_t channel) const {
+    return channel < _count ? _channels[channel].rate : 0;
+}
+
+uint8_t ModuleRates::getDecimation(uint8_t channel) const {
+    return channel < _count ? _channels[channel].decimation : 0;
+}
+
+uint32_t ModuleRates::getChanges() const {
+    return _changes;
+}
+
+uint32_t ModuleRates::getRefused() const {
+    return _refused;
+}
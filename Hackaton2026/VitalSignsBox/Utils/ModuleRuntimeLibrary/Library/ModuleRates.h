@@ -0,0 +1,114 @@
+/*
+    ModuleRates.h
+
+    Sample rates of a module, set by the hub over I2C
+
+    A module samples at the rate its firmware was built for, whatever the
+    hub needs at the moment. ModuleRates gives every sampled channel of a
+    module a rate and a decimation that the hub writes at MODULE_REG_RATES
+    (0x27, the same address on every module), served by ModuleRuntime. The
+    hub can raise the ECG to 1 kHz during an event and let every module
+    trickle otherwise.
+
+    rate:       conversions per second of the channel (the module's timer,
+                task or ADC scan)
+    decimation: the module hands the hub one (averaged) value per
+                decimation conversions, in its registers and streams
+
+    The I2C interrupt only records a request; ModuleRuntime::run() applies
+    it in loop() context through the module's change handler, which
+    reconfigures the sampling and returns the rate it achieved. Requests
+    are clamped to the limits of the channel.
+*/
+
+#ifndef MODULE_RATES_H
+#define MODULE_RATES_H
+
+#include <Arduino.h>
+
+#define MODULE_REG_RATES 0x27           // Rate control, the same address on every module
+#define MODULE_RATES_MAX_CHANNELS 4
+
+class ModuleRates {
+public:
+    /**
+     * Reconfigure a channel; called from loop() context by update()
+     * @param channel    Channel index
+     * @param rateHz     Requested rate, within the limits of the channel
+     * @param decimation Requested decimation, 1..max
+     * @return The rate achieved (e.g. rounded to the timer), 0 = refused,
+     *         the channel keeps its settings
+     */
+    typedef uint16_t (*ChangeHandler)(uint8_t channel, uint16_t rateHz, uint8_t decimation);
+
+    static const uint8_t WRITE_BYTES = 4;    // Channel, rate (16), decimation
+    static const uint8_t HEADER_BYTES = 1;   // Channels
+    static const uint8_t CHANNEL_BYTES = 8;  // Rate (16), decimation, min rate (16), max rate (16), max decimation
+    static const uint8_t MAX_BYTES = HEADER_BYTES + MODULE_RATES_MAX_CHANNELS * CHANNEL_BYTES;
+
+    ModuleRates();
+
+    /**
+     * Declare a channel; call in setup(), in channel order
+     * @param rateHz        Rate the module starts at (the change handler is not called for it)
+     * @param minHz         Lowest rate the module supports
+     * @param maxHz         Highest rate the module supports
+     * @param maxDecimation Highest decimation, >= 1
+     * @return Channel index, or -1 when full or the limits are inconsistent
+     */
+    int8_t addChannel(uint16_t rateHz, uint16_t minHz, uint16_t maxHz, uint8_t maxDecimation = 1);
+
+    void onChange(ChangeHandler handler);
+
+    /**
+     * A byte written at MODULE_REG_RATES + offset; I2C interrupt only.
+     * Offset 0 selects the channel, 1-2 are the rate (0 = keep), 3 the
+     * decimation (0 = keep) and completes the request. Later requests for
+     * the same channel replace one not applied yet.
+     */
+    void onWrite(uint8_t offset, uint8_t value);
+
+    /**
+     * Apply the requests written since the last call; loop() only
+     * @return true when a channel changed
+     */
+    bool update();
+
+    /**
+     * The response at MODULE_REG_RATES: the channel count, then per
+     * channel the rate, decimation and limits; I2C interrupt only
+     * @param out MAX_BYTES
+     * @return Bytes written
+     */
+    uint8_t pack(uint8_t* out) const;
+
+    uint8_t getChannelCount() const;
+    uint16_t getRate(uint8_t channel) const;
+    uint8_t getDecimation(uint8_t channel) const;
+    uint32_t getChanges() const;             // Applied requests
+    uint32_t getRefused() const;             // Requests the change handler refused
+
+private:
+    struct Channel {
+        uint16_t rate;
+        uint16_t minRate;
+        uint16_t maxRate;
+        uint8_t decimation;
+        uint8_t maxDecimation;
+    };
+
+    Channel _channels[MODULE_RATES_MAX_CHANNELS];
+    uint8_t _count;
+    ChangeHandler _handler;
+    uint32_t _changes;
+    uint32_t _refused;
+
+    // Written by the I2C interrupt
+    volatile uint8_t _pending;               // Bit per channel with a request
+    volatile uint16_t _pendingRate[MODULE_RATES_MAX_CHANNELS];
+    volatile uint8_t _pendingDecimation[MODULE_RATES_MAX_CHANNELS];
+    uint8_t _writeChannel;                   // 0xFF until offset 0 of a request
+    uint16_t _writeRate;
+};
+
+#endif // MODULE_RATES_H
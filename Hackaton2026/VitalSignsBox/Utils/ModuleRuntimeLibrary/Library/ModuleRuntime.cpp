@@ -0,0 +1,148 @@
+/*
+    ModuleRuntime.cpp
+
+    Common runtime of the VitalSignsBox module firmwares
+*/
+
+#include "ModuleRuntime.h"
+
+ModuleRuntime* ModuleRuntime::_instance = nullptr;
+
+ModuleRuntime::ModuleRuntime(I2CRegisterSlave& registers, RuntimeStats& stats, TwoWire* wire)
+    : _registers(registers)
+    , _stats(stats)
+    , _wire(wire)
+    , _timeSync(nullptr)
+    , _events(nullptr)
+    , _rates(nullptr)
+    , _writeHandler(nullptr)
+    , _readHandler(nullptr)
+    , _commandHandler(nullptr)
+    , _lastMs(0)
+{
+}
+
+int8_t ModuleRuntime::addTask(const char* name, TaskFunction function, uint32_t periodMs) {
+    const uint8_t index = _scheduler.getTaskCount();
+    if (!_scheduler.addTask(name, function, periodMs)) return -1;
+    return index;
+}
+
+bool ModuleRuntime::setTaskPeriod(uint8_t task, uint32_t periodMs) {
+    return _scheduler.setTaskPeriodMs(task, periodMs);
+}
+
+uint32_t ModuleRuntime::getTaskPeriod(uint8_t task) const {
+    return _scheduler.getTaskPeriodMs(task);
+}
+
+void ModuleRuntime::onWrite(I2CRegisterSlave::WriteHandler handler) {
+    _writeHandler = handler;
+}
+
+void ModuleRuntime::onRead(I2CRegisterSlave::ReadHandler handler) {
+    _readHandler = handler;
+}
+
+void ModuleRuntime::onCommand(I2CRegisterSlave::CommandHandler handler) {
+    _commandHandler = handler;
+}
+
+void ModuleRuntime::setTimeSync(TimeSync* sync) {
+    _timeSync = sync;
+}
+
+void ModuleRuntime::setEvents(ModuleEvents* events) {
+    _events = events;
+}
+
+void ModuleRuntime::setRates(ModuleRates* rates) {
+    _rates = rates;
+}
+
+void ModuleRuntime::begin(uint8_t address) {
+    _instance = this;
+    _registers.onWrite(writeTrampoline);
+    _registers.onRead(readTrampoline);
+    _registers.onCommand(commandTrampoline);
+    _registers.setStats(&_stats);
+    _registers.begin(address);
+#if I2C_SLAVE_SERCOM
+    if (_timeSync) _registers.enableGeneralCall(MODULE_WIRE_SERCOM);  // Hub time syncs
+#endif
+
+    // Task time 0 is now: a task added with period p first runs at p
+    _lastMs = millis();
+    _stats.begin();
+}
+
+bool ModuleRuntime::run() {
+    const bool report = _stats.loopTick();
+    if (_timeSync) _timeSync->update();
+    if (_rates) _rates->update();  // Before the tasks: a new period applies from their next release
+
+    const uint32_t now = millis();
+    _scheduler.catchUp(now - _lastMs);
+    _lastMs = now;
+    _scheduler.run();
+    return report;
+}
+
+uint8_t ModuleRuntime::getTaskCount() const {
+    return _scheduler.getTaskCount();
+}
+
+uint32_t ModuleRuntime::getTaskRunCount(uint8_t task) const {
+    return _scheduler.getTaskRunCount(task);
+}
+
+ModuleTaskStats ModuleRuntime::getTaskStats(uint8_t task) const {
+    return _scheduler.getTaskStats(task);
+}
+
+uint32_t ModuleRuntime::getTaskOverruns() const {
+    uint32_t total = 0;
+    for (uint8_t i = 0; i < _scheduler.getTaskCount(); i++) {
+        total += _scheduler.getTaskStats(i).overrunCount;
+    }
+    return total;
+}
+
+// I2C interrupt: every byte to the module, the RATES bytes also to the rates
+void ModuleRuntime::writeTrampoline(uint8_t reg, uint8_t value) {
+    ModuleRuntime* self = _instance;
+    if (self->_writeHandler) self->_writeHandler(reg, value);
+    if (self->_rates && reg >= MODULE_REG_RATES && reg < MODULE_REG_RATES + ModuleRates::WRITE_BYTES) {
+        self->_rates->onWrite(reg - MODULE_REG_RATES, value);
+    }
+}
+
+// I2C interrupt: the module's blocks first, then the EVENTS, RATES and RUNTIME blocks
+bool ModuleRuntime::readTrampoline(uint8_t reg) {
+    ModuleRuntime* self = _instance;
+    if (self->_readHandler && self->_readHandler(reg)) return true;
+    if (reg == MODULE_REG_EVENTS && self->_events) {
+        uint8_t response[ModuleEvents::MAX_BYTES];
+        self->_wire->write(response, self->_events->pack(response));
+        return true;
+    }
+    if (reg == MODULE_REG_RATES && self->_rates) {
+        uint8_t response[ModuleRates::MAX_BYTES];
+        self->_wire->write(response, self->_rates->pack(response));
+        return true;
+    }
+    if (reg != MODULE_REG_RUNTIME) return false;
+    uint8_t report[RuntimeStats::REPORT_BYTES];
+    self->_wire->write(report, self->_stats.pack(report));
+    return true;
+}
+
+// I2C interrupt: a sync is stamped here and folded into the estimate by run()
+void ModuleRuntime::commandTrampoline(const uint8_t* data, uint8_t length) {
+    ModuleRuntime* self = _instance;
+    if (self->_timeSync && data[0] == TIMESYNC_COMMAND) {
+        self->_timeSync->onFrame(data, length);
+        return;
+    }
+    if (self->_commandHandler) self->_commandHandler(data, length);
+}
@@ -0,0 +1,149 @@
+/*
+    ModuleRuntime.h
+
+    Common runtime of the VitalSignsBox module firmwares
+
+    Every module firmware needs the same plumbing around its sensor code:
+    a register-mapped I2C slave with the RUNTIME block at 0x24, the load
+    counters behind it, the hub time syncs on the general call, and
+    sampling at a fixed rate. ModuleRuntime does that once; the module
+    registers its sensor work as tasks and its own register blocks and
+    commands as handlers.
+
+    Tasks run on a ModuleScheduler, the CyclicExecutive of
+    Workshops/PatternsArchitecture cut down to gnu++11: a task released
+    every 10 ms runs at 10, 20, 30 ms after begin(), also when a pass was
+    late, so the sample rate has no drift. The scheduler clock follows
+    millis() in run(); there is no tick interrupt. Every task is timed
+    with micros() (ModuleTaskStats): a task that is still running at its
+    next release counts as an overrun.
+
+    Work without a deadline (draining telemetry, FFT steps) stays in
+    loop(), after run().
+
+    With setEvents() the runtime also serves the event FIFO of the module
+    (ModuleEvents) at MODULE_REG_EVENTS. With setRates() it takes the
+    hub's rate requests (ModuleRates) at MODULE_REG_RATES and applies them
+    in run(), before the tasks.
+*/
+
+#ifndef MODULE_RUNTIME_H
+#define MODULE_RUNTIME_H
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "I2CRegisterSlave.h"
+#include "ModuleEvents.h"
+#include "ModuleRates.h"
+#include "ModuleScheduler.h"
+#include "RuntimeStats.h"
+#include "TimeSync.h"
+
+#define MODULE_RUNTIME_MAX_TASKS MODULE_SCHEDULER_MAX_TASKS
+#define MODULE_REG_RUNTIME 0x24            // RuntimeStats::pack(), the same address on every module
+#define MODULE_WIRE_SERCOM SERCOM3         // Wire on the Zero variant, for the general call
+
+class ModuleRuntime {
+public:
+    // A task body; runs in loop() context
+    typedef ModuleScheduler::TaskFunction TaskFunction;
+
+    /**
+     * Constructor
+     * @param registers Register map of the module (size and content are the module's)
+     * @param stats     Load counters, served as the RUNTIME block
+     * @param wire      Bus the register slave serves
+     */
+    ModuleRuntime(I2CRegisterSlave& registers, RuntimeStats& stats, TwoWire* wire = &Wire);
+
+    /**
+     * Run a function at a fixed rate; call before or after begin()
+     * @param name     For diagnostics
+     * @param function Task body, must not block
+     * @param periodMs Release period, > 0
+     * @return Task index, or -1 when full or the period is 0
+     */
+    int8_t addTask(const char* name, TaskFunction function, uint32_t periodMs);
+
+    /**
+     * Change the period of a task, effective from its next release
+     * @return false for an unknown task or a period of 0
+     */
+    bool setTaskPeriod(uint8_t task, uint32_t periodMs);
+    uint32_t getTaskPeriod(uint8_t task) const;
+
+    /**
+     * Module register blocks and commands; called from the I2C interrupt.
+     * A read that the handler does not serve at MODULE_REG_RUNTIME gets
+     * the load counters, at MODULE_REG_EVENTS the event FIFO, at
+     * MODULE_REG_RATES the rates; writes go to the module first, then to
+     * the rates. TimeSync frames go to the TimeSync (if set) before the
+     * command handler sees anything else.
+     */
+    void onWrite(I2CRegisterSlave::WriteHandler handler);
+    void onRead(I2CRegisterSlave::ReadHandler handler);
+    void onCommand(I2CRegisterSlave::CommandHandler handler);
+
+    /**
+     * Follow the hub timebase: accept general calls and feed the syncs to
+     * sync; call before begin()
+     */
+    void setTimeSync(TimeSync* sync);
+
+    /**
+     * Serve the module's event FIFO at MODULE_REG_EVENTS; the module posts
+     * to it from loop()
+     */
+    void setEvents(ModuleEvents* events);
+
+    /**
+     * Take the hub's rate requests at MODULE_REG_RATES and apply them in
+     * run() through the rates' change handler; call before begin()
+     */
+    void setRates(ModuleRates* rates);
+
+    /**
+     * Join the bus as slave, start the load counters and the task clock
+     * @param address 7-bit slave address
+     */
+    void begin(uint8_t address);
+
+    /**
+     * Call first in every loop(): counts the pass, folds in time syncs,
+     * applies rate requests and runs the tasks that are due
+     * @return true when a new load report was latched (once per second)
+     */
+    bool run();
+
+    uint8_t getTaskCount() const;
+    uint32_t getTaskRunCount(uint8_t task) const;
+    ModuleTaskStats getTaskStats(uint8_t task) const;  // Execution time in us
+
+    /**
+     * Task runs still busy at their next release, all tasks; add this to
+     * the module's own overruns for RuntimeStats::setOverruns()
+     */
+    uint32_t getTaskOverruns() const;
+
+private:
+    static void writeTrampoline(uint8_t reg, uint8_t value);
+    static bool readTrampoline(uint8_t reg);
+    static void commandTrampoline(const uint8_t* data, uint8_t length);
+
+    static ModuleRuntime* _instance;
+
+    I2CRegisterSlave& _registers;
+    RuntimeStats& _stats;
+    TwoWire* _wire;
+    TimeSync* _timeSync;
+    ModuleEvents* _events;
+    ModuleRates* _rates;
+    I2CRegisterSlave::WriteHandler _writeHandler;
+    I2CRegisterSlave::ReadHandler _readHandler;
+    I2CRegisterSlave::CommandHandler _commandHandler;
+
+    ModuleScheduler _scheduler;
+    uint32_t _lastMs;
+};
+
+#endif // MODULE_RUNTIME_H
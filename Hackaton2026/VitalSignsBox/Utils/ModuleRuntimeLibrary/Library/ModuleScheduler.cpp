@@ -0,0 +1,121 @@
+/*
+    ModuleScheduler.cpp
+
+    Fixed-rate tasks of ModuleRuntime
+*/
+
+#include "ModuleScheduler.h"
+
+ModuleScheduler::ModuleScheduler()
+    : _count(0)
+    , _nowMs(0)
+{
+}
+
+bool ModuleScheduler::addTask(const char* name, TaskFunction function, uint32_t periodMs) {
+    if (_count >= MODULE_SCHEDULER_MAX_TASKS || function == nullptr || periodMs == 0) return false;
+    Task& task = _tasks[_count];
+    task.function = function;
+    task.name = name;
+    task.periodMs = periodMs;
+    task.nextDueMs = _nowMs + periodMs;
+    task.runCount = 0;
+    task.totalExecUs = 0;
+    task.stats.minExecTicks = UINT32_MAX;
+    task.stats.maxExecTicks = 0;
+    task.stats.avgExecTicks = 0;
+    task.stats.minReleaseDelayMs = UINT32_MAX;
+    task.stats.maxReleaseDelayMs = 0;
+    task.stats.overrunCount = 0;
+    task.stats.samples = 0;
+    _count++;
+    return true;
+}
+
+void ModuleScheduler::catchUp(uint32_t elapsedMs) {
+    _nowMs += elapsedMs;
+}
+
+void ModuleScheduler::run() {
+    const uint32_t now = _nowMs;
+    int8_t index;
+    while ((index = nextDue(now)) >= 0) {
+        Task& task = _tasks[index];
+        const uint32_t releaseDelayMs = now - task.nextDueMs;
+        const uint32_t start = micros();
+        task.function();
+        const uint32_t execUs = micros() - start;
+
+        // A full period or more behind: run once, skip the missed releases
+        // instead of running them back to back on stale inputs, and count
+        // each one as an overrun. The releases stay on the grid.
+        uint32_t skipped = 0;
+        uint32_t nextDueMs = task.nextDueMs + task.periodMs;
+        if (!isBefore(now, nextDueMs)) {
+            skipped = (now - nextDueMs) / task.periodMs + 1;
+            nextDueMs += skipped * task.periodMs;
+        }
+
+        // The clock does not move during run(): the run ended at now + its duration
+        const bool overrun = !isBefore(now + execUs / 1000, task.nextDueMs + task.periodMs);
+        ModuleTaskStats& s = task.stats;
+        if (execUs < s.minExecTicks) s.minExecTicks = execUs;
+        if (execUs > s.maxExecTicks) s.maxExecTicks = execUs;
+        if (releaseDelayMs < s.minReleaseDelayMs) s.minReleaseDelayMs = releaseDelayMs;
+        if (releaseDelayMs > s.maxReleaseDelayMs) s.maxReleaseDelayMs = releaseDelayMs;
+        s.overrunCount += skipped > 0 ? skipped : (overrun ? 1 : 0);
+        s.samples++;
+        task.totalExecUs += execUs;
+        s.avgExecTicks = (uint32_t)(task.totalExecUs / s.samples);
+
+        task.runCount++;
+        task.nextDueMs = nextDueMs;
+    }
+}
+
+bool ModuleScheduler::setTaskPeriodMs(uint8_t task, uint32_t periodMs) {
+    if (task >= _count || periodMs == 0) return false;
+    _tasks[task].periodMs = periodMs;
+    return true;
+}
+
+uint32_t ModuleScheduler::getCurrentTimeMs() const {
+    return _nowMs;
+}
+
+uint8_t ModuleScheduler::getTaskCount() const {
+    return _count;
+}
+
+const char* ModuleScheduler::getTaskName(uint8_t task) const {
+    return task < _count ? _tasks[task].name : nullptr;
+}
+
+uint32_t ModuleScheduler::getTaskPeriodMs(uint8_t task) const {
+    return task < _count ? _tasks[task].periodMs : 0;
+}
+
+uint32_t ModuleScheduler::getTaskRunCount(uint8_t task) const {
+    return task < _count ? _tasks[task].runCount : 0;
+}
+
+ModuleTaskStats ModuleScheduler::getTaskStats(uint8_t task) const {
+    if (task < _count) return _tasks[task].stats;
+    ModuleTaskStats none = {0, 0, 0, 0, 0, 0, 0};
+    return none;
+}
+
+bool ModuleScheduler::isBefore(uint32_t a, uint32_t b) {
+    return (int32_t)(a - b) < 0;
+}
+
+// The due task with the earliest release, -1 when none is due; a linear
+// scan, MODULE_SCHEDULER_MAX_TASKS is small
+int8_t ModuleScheduler::nextDue(uint32_t now) const {
+    int8_t earliest = -1;
+    for (uint8_t i = 0; i < _count; i++) {
+        if (isBefore(now, _tasks[i].nextDueMs)) continue;
+        if (earliest < 0 || isBefore(_tasks[i].nextDueMs, _tasks[earliest].nextDueMs)) earliest = (int8_t)i;
+    }
+    return earliest;
+}
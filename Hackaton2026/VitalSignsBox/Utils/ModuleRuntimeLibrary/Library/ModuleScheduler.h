@@ -0,0 +1,103 @@
+/*
+    ModuleScheduler.h
+
+    Fixed-rate tasks of ModuleRuntime
+
+    The part of the CyclicExecutive (Workshops/PatternsArchitecture) that
+    the runtime uses, in the C++ of the stock SAMD core (gnu++11, no
+    include paths outside the library). A task released every 10 ms runs
+    at 10, 20, 30 ms on the scheduler clock, also when a pass was late:
+    releases stay on their grid. A task that has fallen a full period or
+    more behind runs once; the releases it missed are skipped and counted
+    as overruns, so a sampling task never sees the same inputs twice in
+    one pass. Due tasks run in deadline order.
+
+    There is no tick interrupt: the caller moves the clock with catchUp()
+    before run(). Every run is timed with micros(); a run that finishes
+    at or after the task's next release counts as an overrun.
+*/
+
+#ifndef MODULE_SCHEDULER_H
+#define MODULE_SCHEDULER_H
+
+#include <Arduino.h>
+
+#define MODULE_SCHEDULER_MAX_TASKS 8
+
+/*
+    Timing of one task; the fields of cyclic_executive::TaskStats, with
+    the execution times in us
+*/
+struct ModuleTaskStats {
+    uint32_t minExecTicks;                   // Shortest run, us
+    uint32_t maxExecTicks;                   // Longest run (observed WCET), us
+    uint32_t avgExecTicks;                   // Mean over all runs, us
+    uint32_t minReleaseDelayMs;              // Smallest delay between release and dispatch
+    uint32_t maxReleaseDelayMs;              // Largest delay between release and dispatch
+    uint32_t overrunCount;                   // Runs that finished after the next release, plus skipped releases
+    uint32_t samples;                        // Measured runs
+
+    uint32_t releaseJitterMs() const { return maxReleaseDelayMs - minReleaseDelayMs; }
+};
+
+class ModuleScheduler {
+public:
+    // A task body; runs in loop() context
+    typedef void (*TaskFunction)();
+
+    ModuleScheduler();
+
+    /**
+     * Register a task, first released one period from now
+     * @param name     For diagnostics
+     * @param function Task body, must not block
+     * @param periodMs Release period, > 0
+     * @return false when full, without a function or with a period of 0
+     */
+    bool addTask(const char* name, TaskFunction function, uint32_t periodMs);
+
+    /**
+     * Advance the clock by elapsedMs
+     */
+    void catchUp(uint32_t elapsedMs);
+
+    /**
+     * Run the tasks that are due, in deadline order
+     */
+    void run();
+
+    /**
+     * Change the period of a task, effective from its next release
+     * @return false for an unknown task or a period of 0
+     */
+    bool setTaskPeriodMs(uint8_t task, uint32_t periodMs);
+
+    uint32_t getCurrentTimeMs() const;
+    uint8_t getTaskCount() const;
+    const char* getTaskName(uint8_t task) const;
+    uint32_t getTaskPeriodMs(uint8_t task) const;  // 0 for an unknown task
+    uint32_t getTaskRunCount(uint8_t task) const;
+    ModuleTaskStats getTaskStats(uint8_t task) const;  // All zero for an unknown task
+
+private:
+    struct Task {
+        TaskFunction function;
+        const char* name;
+        uint32_t periodMs;
+        uint32_t nextDueMs;
+        uint32_t runCount;
+        uint64_t totalExecUs;
+        ModuleTaskStats stats;
+    };
+
+    // Wrap-safe "a happens before b" on the 32-bit ms clock
+    static bool isBefore(uint32_t a, uint32_t b);
+
+    int8_t nextDue(uint32_t now) const;
+
+    Task _tasks[MODULE_SCHEDULER_MAX_TASKS];
+    uint8_t _count;
+    uint32_t _nowMs;
+};
+
+#endif // MODULE_SCHEDULER_H
@@ -0,0 +1,61 @@
+#include <Wire.h>
+#include "I2CRegisterSlave.h"
+#include "RuntimeStats.h"
+#include "TimeSync.h"
+#include "ModuleRuntime.h"
+
+/*
+    Minimal module on the common runtime: A0 sampled at exactly 100 Hz,
+    averaged over 10 samples into a register map at 0x30. The runtime
+    serves the RUNTIME block (0x24) and follows the hub time syncs; the
+    module only supplies its task and its registers.
+*/
+
+#define MODULE_ADDR 0x30
+#define SAMPLE_PERIOD_MS 10  // 100 Hz
+
+#define REG_AVERAGE     0x00  // 16 bit, mean of the last 10 samples
+#define REG_SAMPLE_TIME 0x02  // 32 bit, hub time of the last sample
+#define REGISTER_COUNT  0x06
+
+I2CRegisterSlave registers(&Wire, REGISTER_COUNT);
+RuntimeStats stats;
+TimeSync timeSync;
+ModuleRuntime runtime(registers, stats);
+
+uint32_t sum = 0;
+uint8_t count = 0;
+
+// Task: released every 10 ms on a fixed grid, whatever loop() does in between
+void sample() {
+  sum += analogRead(A0);
+  stats.addSamples(1);
+  if (++count < 10) return;
+  registers.set16(REG_AVERAGE, sum / count);
+  registers.set32(REG_SAMPLE_TIME, timeSync.now());
+  registers.publish();
+  sum = 0;
+  count = 0;
+}
+
+void setup() {
+  Serial.begin(115200);
+  runtime.addTask("sample", sample, SAMPLE_PERIOD_MS);
+  runtime.setTimeSync(&timeSync);
+  runtime.begin(MODULE_ADDR);
+}
+
+void loop() {
+  if (runtime.run()) {
+    const ModuleTaskStats task = runtime.getTaskStats(0);
+    Serial.print("sample: ");
+    Serial.print(runtime.getTaskRunCount(0));
+    Serial.print(" runs, max ");
+    Serial.print(task.maxExecTicks);
+    Serial.print(" us, release delay up to ");
+    Serial.print(task.maxReleaseDelayMs);
+    Serial.print(" ms, overruns ");
+    Serial.println(task.overrunCount);
+  }
+  stats.setOverruns(runtime.getTaskOverruns());
+}
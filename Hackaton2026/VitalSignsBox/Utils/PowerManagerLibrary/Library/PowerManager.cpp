@@ -0,0 +1,173 @@
+/*
+    PowerManager.cpp
+
+    Sleep state selection implementation
+*/
+
+#include "PowerManager.h"
+
+namespace {
+
+// Conservative for the Feather M0: standby restarts the DFLL48M, which
+// has to lock again on the 32 kHz crystal. Measure with a pin toggle in
+// the wake-up interrupt and set the real values with setWakeLatency().
+const uint16_t DEFAULT_LATENCY_US[POWER_STATES] = { 0, 5, 10, 15, 1500 };
+
+}  // namespace
+
+PowerManager::PowerManager()
+    : _count(0)
+    , _wakePending(false)
+{
+    for (uint8_t i = 0; i < POWER_STATES; i++) {
+        _latencyUs[i] = DEFAULT_LATENCY_US[i];
+        _sleeps[i] = 0;
+        _sleepUs[i] = 0;
+    }
+}
+
+int8_t PowerManager::add(PowerState deepest) {
+    if (_count >= POWER_MANAGER_MAX || deepest >= POWER_STATES) return -1;
+
+    Requirement& r = _requirements[_count];
+    r.deepest = deepest;
+    r.enabled = true;
+    r.timed = false;
+    r.dueUs = 0;
+    return _count++;
+}
+
+#if POWER_MANAGER_SAMD
+int8_t PowerManager::addI2CSlave(Sercom* sercom) {
+    if (sercom == nullptr) return -1;
+    const int8_t id = add(POWER_STANDBY);
+    if (id < 0) return id;
+
+    // Without RUNSTDBY the slave drops everything in standby, address included
+    SercomI2cs& i2cs = sercom->I2CS;
+    i2cs.CTRLA.bit.ENABLE = 0;
+    while (i2cs.SYNCBUSY.bit.ENABLE) {}
+    i2cs.CTRLA.bit.RUNSTDBY = 1;
+    i2cs.CTRLA.bit.ENABLE = 1;
+    while (i2cs.SYNCBUSY.bit.ENABLE) {}
+    return id;
+}
+#else
+int8_t PowerManager::addI2CSlave() {
+    return add(POWER_STANDBY);
+}
+#endif
+
+int8_t PowerManager::addAdcWindow() {
+    return add(POWER_IDLE2);
+}
+
+int8_t PowerManager::addTimer() {
+    const int8_t id = add(POWER_IDLE2);
+    if (id >= 0) _requirements[id].enabled = false;  // Until there is a deadline
+    return id;
+}
+
+void PowerManager::setDeadline(uint8_t id, uint32_t dueUs) {
+    if (id >= _count) return;
+    _requirements[id].dueUs = dueUs;
+    _requirements[id].timed = true;
+    _requirements[id].enabled = true;
+}
+
+void PowerManager::clearDeadline(uint8_t id) {
+    if (id >= _count) return;
+    _requirements[id].timed = false;
+    _requirements[id].enabled = false;
+}
+
+void PowerManager::setEnabled(uint8_t id, bool enabled) {
+    if (id < _count) _requirements[id].enabled = enabled;
+}
+
+void PowerManager::setDeepest(uint8_t id, PowerState deepest) {
+    if (id < _count && deepest < POWER_STATES) _requirements[id].deepest = deepest;
+}
+
+void PowerManager::setWakeLatency(PowerState state, uint16_t us) {
+    if (state < POWER_STATES) _latencyUs[state] = us;
+}
+
+uint16_t PowerManager::getWakeLatency(PowerState state) const {
+    return state < POWER_STATES ? _latencyUs[state] : 0;
+}
+
+PowerState PowerManager::select(uint32_t nowUs) const {
+    uint8_t deepest = POWER_STANDBY;
+
+    for (uint8_t i = 0; i < _count && deepest > POWER_RUN; i++) {
+        const Requirement& r = _requirements[i];
+        if (!r.enabled) continue;
+        if (r.deepest < deepest) deepest = r.deepest;
+        if (!r.timed) continue;
+
+        // Standby has no timer to wake on. In the idle states the
+        // wake-up is the next tick, up to a full tick away, and then the
+        // wake latency: anything deeper is too late for the deadline.
+        if (deepest > POWER_IDLE2) deepest = POWER_IDLE2;
+        const int32_t remaining = (int32_t)(r.dueUs - nowUs);
+        while (deepest > POWER_RUN && remaining < (int32_t)(POWER_MANAGER_TICK_US + _latencyUs[deepest])) {
+            deepest--;
+        }
+    }
+    return (PowerState)deepest;
+}
+
+PowerState PowerManager::sleep() {
+    // With interrupts masked, a pending interrupt still ends __WFI(), but
+    // none can slip in between the check and the sleep
+    noInterrupts();
+    const uint32_t start = micros();
+    const PowerState state = _wakePending ? POWER_RUN : select(start);
+    if (state != POWER_RUN) enter(state);
+    _wakePending = false;
+    interrupts();
+
+    if (state != POWER_RUN) {
+        _sleeps[state]++;
+        if (state != POWER_STANDBY) _sleepUs[state] += micros() - start;
+    }
+    return state;
+}
+
+void PowerManager::wake() {
+    _wakePending = true;
+}
+
+uint32_t PowerManager::getSleepCount(PowerState state) const {
+    return state < POWER_STATES ? _sleeps[state] : 0;
+}
+
+uint32_t PowerManager::getSleepUs(PowerState state) const {
+    return state < POWER_STATES ? _sleepUs[state] : 0;
+}
+
+// PRIVATE
+
+void PowerManager::enter(PowerState state) {
+#if POWER_MANAGER_SAMD
+    if (state == POWER_STANDBY) {
+        // A pending tick would end the standby at once; and errata: the
+        // NVM must not sleep with the CPU, or the first fetch after the
+        // wake-up can fail
+        SysTick->CTRL &= ~SysTick_CTRL_TICKINT_Msk;
+        NVMCTRL->CTRLB.bit.SLEEPPRM = NVMCTRL_CTRLB_SLEEPPRM_DISABLED_Val;
+        SCB->SCR |= SCB_SCR_SLEEPDEEP_Msk;
+    } else {
+        SCB->SCR &= ~SCB_SCR_SLEEPDEEP_Msk;
+        PM->SLEEP.reg = PM_SLEEP_IDLE(state - POWER_IDLE0);
+    }
+    __DSB();
+    __WFI();
+    if (state == POWER_STANDBY) {
+        SysTick->CTRL |= SysTick_CTRL_TICKINT_Msk;
+    }
+#else
+    (void)state;
+#endif
+}
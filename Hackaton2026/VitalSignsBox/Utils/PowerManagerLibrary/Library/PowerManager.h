@@ -0,0 +1,156 @@
+/*
+    PowerManager.h
+
+    Sleep between events without missing a deadline
+
+    loop() usually spins: it polls the scheduler, finds nothing due and
+    polls again, at full CPU current. PowerManager puts the CPU to sleep
+    instead, as deep as the drivers allow. Every driver registers what it
+    needs to wake the device:
+
+    - an I2C slave waiting for its address (SERCOM address match), which
+      works down to standby
+    - the ADC window monitor, whose clock stops in standby
+    - a timer deadline, e.g. HubScheduler::getNextDue(): micros() and the
+      SysTick wake-up stop in standby, and the sleep must end, wake
+      latency included, before the deadline
+
+    sleep() takes the deepest state every enabled requirement allows and
+    enters it; any enabled interrupt ends it. An interrupt handler whose
+    work loop() has to see first calls wake(): without it, an interrupt
+    between the last check in loop() and sleep() would wait for the next.
+
+    SAMD21 states, from light to deep:
+    IDLE0    CPU clock stopped
+    IDLE1    and the AHB clocks (no DMA, no USB)
+    IDLE2    and the APB clocks; peripherals on their GCLK keep running
+    STANDBY  all clocks stopped but those with RUNSTDBY; the 1 ms tick
+             stops, so millis() and micros() fall behind by the time asleep
+
+    Other targets never sleep: sleep() only selects.
+*/
+
+#ifndef POWER_MANAGER_H
+#define POWER_MANAGER_H
+
+#include <Arduino.h>
+
+#if defined(__SAMD21G18A__) || defined(__SAMD21J18A__) || defined(__SAMD21E18A__)
+#define POWER_MANAGER_SAMD 1
+#else
+#define POWER_MANAGER_SAMD 0
+#endif
+
+#define POWER_MANAGER_MAX 8
+#define POWER_MANAGER_TICK_US 1000   // SysTick period: the timer wake-up in the idle states
+
+enum PowerState : uint8_t {
+    POWER_RUN,        // Do not sleep
+    POWER_IDLE0,
+    POWER_IDLE1,
+    POWER_IDLE2,
+    POWER_STANDBY,
+    POWER_STATES
+};
+
+class PowerManager {
+public:
+    PowerManager();
+
+    /**
+     * Add a requirement: the device must wake from the state it sleeps in
+     * @param deepest Deepest state the wake source (or a running
+     *                peripheral) still works in
+     * @return Requirement id, or -1 when full
+     */
+    int8_t add(PowerState deepest);
+
+    /**
+     * I2C slave on a SERCOM: sets RUNSTDBY, so the address match wakes
+     * the device from standby. Call after the Wire begin(address).
+     * Other targets: add(POWER_STANDBY)
+     */
+#if POWER_MANAGER_SAMD
+    int8_t addI2CSlave(Sercom* sercom);
+#else
+    int8_t addI2CSlave();
+#endif
+
+    /**
+     * ADC window monitor (AdcScanner::watch()): the ADC runs on GCLK0,
+     * which stops in standby, so IDLE2 at most
+     */
+    int8_t addAdcWindow();
+
+    /**
+     * Timer deadline, set with setDeadline(); IDLE2 at most
+     */
+    int8_t addTimer();
+
+    /**
+     * Wake before dueUs (micros()); the requirement is enabled until
+     * clearDeadline()
+     */
+    void setDeadline(uint8_t id, uint32_t dueUs);
+    void clearDeadline(uint8_t id);
+
+    /**
+     * Only enabled requirements count, e.g. the window monitor only while
+     * a channel is watched
+     */
+    void setEnabled(uint8_t id, bool enabled);
+
+    /**
+     * Change the deepest state, e.g. IDLE0 while a DMA transfer runs
+     */
+    void setDeepest(uint8_t id, PowerState deepest);
+
+    /**
+     * Time from the wake-up interrupt to the first instruction after the
+     * sleep; defaults are for the Feather M0 with the Arduino clock setup
+     */
+    void setWakeLatency(PowerState state, uint16_t us);
+    uint16_t getWakeLatency(PowerState state) const;
+
+    /**
+     * Deepest state all enabled requirements allow at nowUs
+     */
+    PowerState select(uint32_t nowUs) const;
+
+    /**
+     * Sleep in the selected state until an interrupt; call at the end of
+     * loop(), with interrupts enabled
+     * @return The state slept in, POWER_RUN if it did not sleep
+     */
+    PowerState sleep();
+
+    /**
+     * Skip the next sleep(); safe from interrupt handlers
+     */
+    void wake();
+
+    /**
+     * Statistics
+     */
+    uint32_t getSleepCount(PowerState state) const;
+    uint32_t getSleepUs(PowerState state) const;   // Standby not included: micros() stops
+
+private:
+    struct Requirement {
+        PowerState deepest;
+        bool enabled;
+        bool timed;
+        uint32_t dueUs;
+    };
+
+    void enter(PowerState state);
+
+    Requirement _requirements[POWER_MANAGER_MAX];
+    uint8_t _count;
+    uint16_t _latencyUs[POWER_STATES];
+    uint32_t _sleeps[POWER_STATES];
+    uint32_t _sleepUs[POWER_STATES];
+    volatile bool _wakePending;
+};
+
+#endif // POWER_MANAGER_H
@@ -0,0 +1,98 @@
+#include <Wire.h>
+#include "TwiPinHelper.h"
+#include "I2CAsyncBus.h"
+#include "HubScheduler.h"
+#include "PowerManager.h"
+
+/*
+    The basic_hub polling of ECG, SpO2 and the MCP3426, sleeping in between.
+    The next hub deadline is the wake-up requirement: with 10 ms between ECG
+    bursts the CPU sleeps most of the time and spins only in the last tick
+    before a poll. The SERCOM handlers end a sleep early, so finished
+    transactions are collected at once. USB serial keeps it in IDLE0;
+    without it, drop that requirement and the hub sleeps in IDLE2.
+*/
+
+// I2C sensor buses (same as the temperature sketch)
+#define W1_SCL 39  // PA13
+#define W1_SDA 28  // PA12
+#define W2_SCL 13  // PA17
+#define W2_SDA 11  // PA16
+
+TwiPinPair portSensorsA(W1_SCL, W1_SDA);
+TwiPinPair portSensorsB(W2_SCL, W2_SDA);
+
+TwoWire WireSensorA(&sercom1, W1_SDA, W1_SCL);
+TwoWire WireSensorB(&sercom4, W2_SDA, W2_SCL);
+
+I2CAsyncBus busA(&WireSensorA, SERCOM1);
+I2CAsyncBus busB(&WireSensorB, SERCOM4);
+
+PowerManager power;
+int8_t hubTimer;
+
+void SERCOM1_Handler() { busA.onService(); power.wake(); }
+void SERCOM4_Handler() { busB.onService(); power.wake(); }
+
+#define ECG_MODULE_ADDR  0x2A
+#define SPO2_MODULE_ADDR 0x2B
+#define MCP3426_ADDR     0x68
+
+HubScheduler hub;
+int8_t ecgId, spo2Id, tempId;
+
+void setup() {
+  Serial.begin(115200);
+
+  WireSensorA.begin();
+  WireSensorB.begin();
+  portSensorsA.setPinPeripheralAltStates();
+  portSensorsB.setPinPeripheralStates();
+
+  WireSensorB.beginTransmission(MCP3426_ADDR);
+  WireSensorB.write(0x18);
+  WireSensorB.endTransmission();
+
+  busA.begin();
+  busB.begin();
+  const int8_t a = hub.addBus(&busA);
+  const int8_t b = hub.addBus(&busB);
+
+  const uint8_t ecgBurst[] = { 0x22, 8 };
+  ecgId  = hub.addModule(a, ECG_MODULE_ADDR, ecgBurst, 2, 9 + 8 * 6, 10000);  // 100 Hz
+  spo2Id = hub.addModule(a, SPO2_MODULE_ADDR, 0x00, 4, 100000);              // 10 Hz
+  tempId = hub.addModule(b, MCP3426_ADDR, nullptr, 0, 3, 100000);            // 10 Hz
+
+  hubTimer = power.addTimer();
+  power.add(POWER_IDLE0);  // USB serial needs the AHB clock
+}
+
+void loop() {
+  hub.poll();
+
+  HubReading reading;
+  while (hub.read(reading)) {
+    Serial.print(reading.timestampUs);
+    Serial.print(reading.module == ecgId ? " ECG " : reading.module == spo2Id ? " SpO2 " : " Temp ");
+    Serial.println(reading.ok ? reading.length : 0);
+  }
+
+  static uint32_t reportMs = 0;
+  static uint32_t asleepUs = 0;
+  if (millis() - reportMs >= 10000) {
+    reportMs = millis();
+    const uint32_t total = power.getSleepUs(POWER_IDLE0);
+    Serial.print("Asleep: ");
+    Serial.print((total - asleepUs) / 100000);  // Of 10 s, in %
+    Serial.println(" %");
+    asleepUs = total;
+  }
+
+  uint32_t dueUs;
+  if (hub.getNextDue(dueUs)) {
+    power.setDeadline(hubTimer, dueUs);
+  } else {
+    power.clearDeadline(hubTimer);
+  }
+  power.sleep();
+}
@@ -0,0 +1,214 @@
+/*
+    QRSDetector.cpp
+
+    Streaming Pan-Tompkins QRS detector implementation
+*/
+
+#include "QRSDetector.h"
+#include <string.h>
+
+// Pan-Tompkins taps at 200 Hz, scaled to the sample rate
+static uint8_t scaledTaps(uint8_t tapsAt200Hz, uint16_t rate) {
+    return (uint8_t)((tapsAt200Hz * (uint32_t)rate + 100) / 200);
+}
+
+// Ring index step without '%' (a library division on the Cortex-M0+)
+static inline uint8_t nextIndex(uint8_t index, uint8_t size) {
+    return (uint8_t)(index + 1 == size ? 0 : index + 1);
+}
+
+QRSDetector::QRSDetector() {
+    begin(250);
+}
+
+void QRSDetector::begin(uint16_t sampleRateHz) {
+    memset(this, 0, sizeof(*this));  // Plain data only
+
+    _rate = sampleRateHz < MIN_SAMPLE_RATE ? MIN_SAMPLE_RATE
+          : sampleRateHz > MAX_SAMPLE_RATE ? MAX_SAMPLE_RATE : sampleRateHz;
+    _lpLength = scaledTaps(6, _rate);
+    _hpLength = scaledTaps(32, _rate);
+    _mwiLength = scaledTaps(30, _rate);
+    _hpReciprocal = (uint16_t)(65536UL / _hpLength);
+
+    // The low-pass gain is _lpLength^2; scale it back to below 2
+    const uint16_t lpGain = (uint16_t)_lpLength * _lpLength;
+    while ((1U << (_lpShift + 1)) <= lpGain) _lpShift++;
+
+    // Low-pass, high-pass centre, derivative, half the integration window
+    _delay = (uint16_t)(_lpLength - 1 + _hpLength / 2 + 2 + _mwiLength / 2);
+
+    // Impulse responses: low-pass 2M, high-pass window, derivative, integration
+    _settle = (uint16_t)(2 * _lpLength + _hpLength + 4 + _mwiLength);
+    _learning = true;
+}
+
+bool QRSDetector::process(int16_t sample, uint32_t frame) {
+    // Relative to the first sample: the filter states start at zero, an
+    // input offset would be a step that swamps the learning phase
+    if (_samples == 0) _baseline = sample;
+    int32_t relative = (int32_t)sample - _baseline;
+    if (relative > INT16_MAX) relative = INT16_MAX;
+    if (relative < INT16_MIN) relative = INT16_MIN;
+    sample = (int16_t)relative;
+
+    // Low-pass: y[n] = 2y[n-1] - y[n-2] + x[n] - 2x[n-M] + x[n-2M]
+    const uint8_t lpSize = 2 * _lpLength + 1;
+    _lpIn[_lpPos] = sample;
+    const uint8_t atM = (uint8_t)(_lpPos >= _lpLength ? _lpPos - _lpLength : _lpPos + lpSize - _lpLength);
+    const uint8_t at2M = nextIndex(_lpPos, lpSize);
+    const int32_t lpOut = 2 * _lpOut1 - _lpOut2 + sample - 2 * (int32_t)_lpIn[atM] + _lpIn[at2M];
+    _lpOut2 = _lpOut1;
+    _lpOut1 = lpOut;
+    _lpPos = at2M;
+    const int16_t lp = (int16_t)(lpOut >> _lpShift);
+
+    // High-pass: the sample in the middle of the window minus the window mean
+    _hpSum += lp - _hpIn[_hpPos];
+    _hpIn[_hpPos] = lp;
+    _hpPos = nextIndex(_hpPos, _hpLength);
+    uint8_t middle = (uint8_t)(_hpPos + (_hpLength >> 1));
+    if (middle >= _hpLength) middle -= _hpLength;
+    const int16_t centre = _hpIn[middle];
+    const int16_t hp = (int16_t)(centre - ((_hpSum * _hpReciprocal) >> 16));
+
+    // Five-point derivative: 2x[n] + x[n-1] - x[n-3] - 2x[n-4], halved (the
+    // original /8 leaves too few levels for the T-wave slope test)
+    const int32_t deriv = (2 * (int32_t)hp + _derivIn[0] - _derivIn[2] - 2 * (int32_t)_derivIn[3]) >> 1;
+    _derivIn[3] = _derivIn[2];
+    _derivIn[2] = _derivIn[1];
+    _derivIn[1] = _derivIn[0];
+    _derivIn[0] = hp;
+    const int32_t magnitude = deriv < 0 ? -deriv : deriv;
+    const uint16_t slope = (uint16_t)(magnitude > 0xFFFF ? 0xFFFF : magnitude);
+
+    // Squaring and moving-window integration (a sum: the thresholds adapt to
+    // the scale). The shift keeps MWI_MAX squares within 32 bits.
+    const uint32_t squared = ((uint32_t)slope * slope) >> 7;
+    _mwiSum += squared - _mwiIn[_mwiPos];
+    _mwiIn[_mwiPos] = squared;
+    _mwiPos = nextIndex(_mwiPos, _mwiLength);
+    const uint32_t integrated = _mwiSum;
+
+    _samples++;
+    if (_samples <= (uint32_t)_settle) return false;  // Filters still settling
+
+    // Learning: the first 2 s set the initial signal and noise levels
+    if (_learning) {
+        if (integrated > _learnMax) _learnMax = integrated;
+        _learnSum += integrated;
+        if (_samples - _settle >= 2UL * _rate) {
+            _signalLevel = _learnMax / 3;
+            _noiseLevel = (uint32_t)(_learnSum / (2UL * _rate)) / 2;
+            updateThresholds();
+            _learning = false;
+        }
+        return false;
+    }
+
+    const uint16_t beatsBefore = _beatCount;
+
+    // No beat for a while: the levels may be too high to ever see one
+    if (++_quiet >= DECAY_AFTER_S * (uint32_t)_rate) {
+        _signalLevel -= _signalLevel >> 1;
+        _noiseLevel -= _noiseLevel >> 1;
+        updateThresholds();
+        _quiet = (DECAY_AFTER_S - 1) * (uint32_t)_rate;  // Again in 1 s
+    }
+
+    // A peak of the integrated signal ends when it has fallen to half
+    if (integrated > _peakValue) {
+        _peakValue = integrated;
+        _peakFrame = frame;
+    } else if (_peakValue != 0 && integrated < _peakValue / 2) {
+        classifyPeak(_peakValue, _peakFrame, _peakSlope);
+        _peakValue = 0;
+        _peakSlope = 0;
+    }
+    if (slope > _peakSlope) _peakSlope = slope;
+
+    if (_haveBeat) {
+        const uint32_t since = frame - _lastPeakFrame;
+
+        // Searchback: no beat for 166% of the average RR, take the best lower peak
+        if (_rrCount >= 2 && since > _searchbackAfter && _searchPeak != 0) {
+            acceptBeat(_searchPeak, _searchFrame, _searchSlope, true);
+        }
+
+        // Lost the signal (lead off, asystole): no rate rather than a stale one
+        if (since > 3UL * _rate) {
+            _heartRate = 0;
+            _rrCount = 0;
+            _rrPos = 0;
+            _searchbackAfter = 0;
+        }
+    }
+    return _beatCount != beatsBefore;
+}
+
+void QRSDetector::classifyPeak(uint32_t peak, uint32_t frame, uint16_t slope) {
+    const uint32_t since = frame - _lastPeakFrame;
+    const bool refractory = _haveBeat && since < _rate / 5U;  // 200 ms
+
+    if (peak > _threshold1 && !refractory) {
+        // Within 360 ms, a peak with less than half the slope of the last QRS is a T wave
+        const bool tWave = _haveBeat && since < (_rate * 9U) / 25U && slope < _lastSlope / 2;
+        if (!tWave) {
+            acceptBeat(peak, frame, slope, false);
+            return;
+        }
+    }
+
+    _noiseLevel = _noiseLevel - (_noiseLevel >> 3) + (peak >> 3);
+    updateThresholds();
+    if (peak > _threshold2 && peak > _searchPeak && !refractory) {
+        _searchPeak = peak;
+        _searchFrame = frame;
+        _searchSlope = slope;
+    }
+}
+
+void QRSDetector::acceptBeat(uint32_t peak, uint32_t frame, uint16_t slope, bool searchback) {
+    if (searchback) {
+        _signalLevel = _signalLevel - (_signalLevel >> 2) + (peak >> 2);
+    } else {
+        _signalLevel = _signalLevel - (_signalLevel >> 3) + (peak >> 3);
+    }
+    updateThresholds();
+
+    if (_haveBeat) {
+        const uint32_t rr = frame - _lastPeakFrame;
+        _rrMs = framesToMs(rr);
+
+        // Physiological range only (30-250 bpm), the average uses the last RR_AVERAGE
+        if (rr >= (_rate * 6U) / 25U && rr <= 2UL * _rate) {
+            _rr[_rrPos] = (uint16_t)rr;
+            _rrPos = nextIndex(_rrPos, RR_AVERAGE);
+            if (_rrCount < RR_AVERAGE) _rrCount++;
+
+            uint32_t sum = 0;
+            for (uint8_t i = 0; i < _rrCount; i++) sum += _rr[i];
+            _searchbackAfter = (sum / _rrCount) * 5U / 3U;  // 166%
+            _heartRate = (uint16_t)((600UL * _rate * _rrCount + sum / 2) / sum);  // 0.1 bpm
+        }
+    }
+
+    _haveBeat = true;
+    _lastPeakFrame = frame;
+    _lastSlope = slope;
+    _beatFrame = frame - _delay;
+    _beatCount++;
+    _searchPeak = 0;
+    _quiet = 0;
+}
+
+void QRSDetector::updateThresholds() {
+    const uint32_t gap = _signalLevel > _noiseLevel ? _signalLevel - _noiseLevel : 0;
+    _threshold1 = _noiseLevel + gap / 4;
+    _threshold2 = _threshold1 / 2;
+}
+
+uint16_t QRSDetector::framesToMs(uint32_t frames) const {
+    const uint32_t ms = (frames * 1000UL + _rate / 2) / _rate;
+    return (uint16_t)(ms > 0xFFFF ? 0xFFFF : ms);
+}
@@ -0,0 +1,146 @@
+/*
+    QRSDetector.h
+
+    Streaming QRS (R-peak) detector and heart rate, Pan-Tompkins style
+
+    One lead sample in per call, integer arithmetic only: band-pass
+    (recursive low-pass and high-pass with integer coefficients),
+    five-point derivative, squaring, 150 ms moving-window integration and
+    adaptive signal/noise thresholds with T-wave rejection and
+    searchback. Runs on the ECG module (SAMD21, no hardware divide: the
+    per-sample path has no division) as well as on the hub or a Pi.
+
+    The filter lengths follow the sample rate (100-500 Hz), so the
+    frequency response is the same as the original 200 Hz design.
+
+    The first sample after begin() is taken as the baseline and
+    subtracted, so the DC offset of the input (an ADC at mid scale) is no
+    step for the filters; learning starts once they have settled. Without
+    a beat for 3 s the signal and noise levels halve, once per second, so
+    a start with too high levels (a transient, a lead reconnected with a
+    different amplitude) recovers instead of waiting for a beat forever.
+*/
+
+#ifndef QRS_DETECTOR_H
+#define QRS_DETECTOR_H
+
+#include <stdint.h>
+
+class QRSDetector {
+public:
+    static const uint16_t MIN_SAMPLE_RATE = 100;
+    static const uint16_t MAX_SAMPLE_RATE = 500;
+    static const uint8_t RR_AVERAGE = 8;  // Beats in the heart rate average
+    static const uint8_t DECAY_AFTER_S = 3;  // Seconds without a beat before the levels decay
+
+    QRSDetector();
+
+    /**
+     * Reset and set the rate; starts a 2 s learning phase
+     * @param sampleRateHz Samples per second (clamped to 100-500)
+     */
+    void begin(uint16_t sampleRateHz);
+
+    /**
+     * Process the next sample of one lead, e.g. lead II = LL - RA
+     * @param sample Lead value (ADC counts, any offset)
+     * @param frame Frame number of the sample (sample time in periods)
+     * @return true if a beat was detected with this sample
+     */
+    bool process(int16_t sample, uint32_t frame);
+
+    // Heart rate in 0.1 bpm over the last RR_AVERAGE beats; 0 = no rate (yet)
+    uint16_t getHeartRate() const { return _heartRate; }
+
+    // Last beat-to-beat interval in ms; 0 = none yet
+    uint16_t getRRInterval() const { return _rrMs; }
+
+    // +1 per detected beat, wraps
+    uint16_t getBeatCount() const { return _beatCount; }
+
+    // Frame number of the last R peak (corrected for the filter delay)
+    uint32_t getBeatFrame() const { return _beatFrame; }
+
+    // Samples between an R peak and its detection, at least
+    uint16_t getDelay() const { return _delay; }
+
+    bool isLearning() const { return _learning; }
+
+    // Current signal level and threshold I1 (for diagnostics and tests)
+    uint32_t getSignalLevel() const { return _signalLevel; }
+    uint32_t getThreshold() const { return _threshold1; }
+
+private:
+    // Buffer sizes for MAX_SAMPLE_RATE (Pan-Tompkins taps x 500 / 200)
+    static const uint8_t LP_MAX = 15;   // Low-pass notch spacing (6 at 200 Hz)
+    static const uint8_t HP_MAX = 80;   // High-pass window (32 at 200 Hz)
+    static const uint8_t MWI_MAX = 75;  // Integration window, 150 ms
+
+    void classifyPeak(uint32_t peak, uint32_t frame, uint16_t slope);
+    void acceptBeat(uint32_t peak, uint32_t frame, uint16_t slope, bool searchback);
+    void updateThresholds();
+    uint16_t framesToMs(uint32_t frames) const;
+
+    uint16_t _rate;
+    uint8_t _lpLength;
+    uint8_t _hpLength;
+    uint8_t _mwiLength;
+    uint8_t _lpShift;
+    uint16_t _hpReciprocal;  // 65536 / _hpLength
+    uint16_t _delay;
+    uint16_t _settle;        // Samples until the filters have settled, learning starts
+
+    // Band-pass and derivative state
+    int16_t _baseline;       // First sample, subtracted from all
+    int16_t _lpIn[2 * LP_MAX + 1];
+    uint8_t _lpPos;
+    int32_t _lpOut1;
+    int32_t _lpOut2;
+    int16_t _hpIn[HP_MAX];
+    uint8_t _hpPos;
+    int32_t _hpSum;
+    int16_t _derivIn[4];
+
+    // Integration
+    uint32_t _mwiIn[MWI_MAX];
+    uint8_t _mwiPos;
+    uint32_t _mwiSum;
+
+    // Peak search in the integrated signal
+    uint32_t _peakValue;
+    uint32_t _peakFrame;
+    uint16_t _peakSlope;
+    uint32_t _samples;
+    uint32_t _quiet;         // Samples since the last beat or decay
+
+    // Learning phase
+    bool _learning;
+    uint32_t _learnMax;
+    uint64_t _learnSum;
+
+    // Adaptive thresholds (Pan-Tompkins SPKI, NPKI, THRESHOLD I1 and I2)
+    uint32_t _signalLevel;
+    uint32_t _noiseLevel;
+    uint32_t _threshold1;
+    uint32_t _threshold2;
+
+    // Best peak between the two thresholds since the last beat, for searchback
+    uint32_t _searchPeak;
+    uint32_t _searchFrame;
+    uint16_t _searchSlope;
+
+    // Beats
+    bool _haveBeat;
+    uint32_t _lastPeakFrame;  // Detection time of the last beat
+    uint16_t _lastSlope;
+    uint16_t _rr[RR_AVERAGE];  // In samples
+    uint8_t _rrCount;
+    uint8_t _rrPos;
+    uint32_t _searchbackAfter;  // Samples without a beat before searchback
+    uint16_t _heartRate;
+    uint16_t _rrMs;
+    uint16_t _beatCount;
+    uint32_t _beatFrame;
+};
+
+#endif // QRS_DETECTOR_H
@@ -0,0 +1,38 @@
+#include "QRSDetector.h"
+
+/*
+    Sample lead II (A1 = LL, A3 = RA) at 250 Hz and print the heart rate
+    and RR interval at every detected beat.
+*/
+
+#define SAMPLE_RATE 250
+#define SAMPLE_PERIOD_US (1000000UL / SAMPLE_RATE)
+
+QRSDetector qrs;
+uint32_t frame = 0;
+unsigned long lastSample = 0;
+
+void setup() {
+  Serial.begin(115200);
+  qrs.begin(SAMPLE_RATE);
+  lastSample = micros();
+}
+
+void loop() {
+  if (micros() - lastSample < SAMPLE_PERIOD_US) return;
+  lastSample += SAMPLE_PERIOD_US;
+
+  const int16_t leadII = (int16_t)(analogRead(A1) - analogRead(A3));
+  if (!qrs.process(leadII, frame++)) return;
+
+  const uint16_t rate = qrs.getHeartRate();
+  Serial.print("beat ");
+  Serial.print(qrs.getBeatCount());
+  Serial.print(": ");
+  Serial.print(rate / 10);
+  Serial.print(".");
+  Serial.print(rate % 10);
+  Serial.print(" bpm, RR ");
+  Serial.print(qrs.getRRInterval());
+  Serial.println(" ms");
+}
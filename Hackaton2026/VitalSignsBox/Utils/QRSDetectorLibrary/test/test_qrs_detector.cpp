@@ -0,0 +1,102 @@
+#include "CppUTest/TestHarness.h"
+#include "QRSDetector.h"
+
+#include <cmath>
+
+// Host test, outside Library/ so the Arduino IDE does not build it:
+//   g++ -I../Library test_qrs_detector.cpp ../Library/QRSDetector.cpp -lCppUTest -lCppUTestExt
+
+namespace {
+
+const double RR_SECONDS = 60.0 / 72.0;  // 72 bpm
+
+/**
+ * Synthetic lead: a narrow R wave and a broad T wave per beat on a DC
+ * offset, as lead II of the module with the ADC at mid scale
+ */
+int16_t ecgSample(uint32_t n, uint16_t rate, double offset, double amplitude) {
+    const double t = static_cast<double>(n) / rate;
+    const double phase = std::fmod(t, RR_SECONDS) - 0.3;
+    const double r = std::exp(-phase * phase / (2 * 0.012 * 0.012));
+    const double tWave = 0.15 * std::exp(-std::pow(phase - 0.25, 2) / (2 * 0.04 * 0.04));
+    return static_cast<int16_t>(std::lround(offset + amplitude * (r + tWave)));
+}
+
+/**
+ * Beats detected after the learning phase (from 2.5 s on) in 'seconds'
+ */
+int countBeats(QRSDetector& qrs, uint16_t rate, double offset, double amplitude, double seconds) {
+    int beats = 0;
+    const uint32_t samples = static_cast<uint32_t>(seconds * rate);
+    for (uint32_t n = 0; n < samples; n++) {
+        if (qrs.process(ecgSample(n, rate, offset, amplitude), n) && n > 2.5 * rate) beats++;
+    }
+    return beats;
+}
+
+const int EXPECTED_BEATS = static_cast<int>((30.0 - 2.5) / RR_SECONDS);  // 33
+
+}  // namespace
+
+TEST_GROUP(QRSDetectorOffset) {
+    QRSDetector qrs;
+};
+
+TEST(QRSDetectorOffset, DetectsBeatsWithoutOffset) {
+    qrs.begin(250);
+    CHECK(std::abs(countBeats(qrs, 250, 0, 50, 30) - EXPECTED_BEATS) <= 1);
+}
+
+TEST(QRSDetectorOffset, DetectsSmallBeatsOnMidScaleOffset250Hz) {
+    qrs.begin(250);
+    CHECK(std::abs(countBeats(qrs, 250, 512, 50, 30) - EXPECTED_BEATS) <= 1);
+}
+
+TEST(QRSDetectorOffset, DetectsSmallBeatsOnMidScaleOffset500Hz) {
+    qrs.begin(500);
+    CHECK(std::abs(countBeats(qrs, 500, 512, 100, 30) - EXPECTED_BEATS) <= 1);
+}
+
+TEST(QRSDetectorOffset, DetectsBeatsOnLargeOffset) {
+    qrs.begin(500);
+    CHECK(std::abs(countBeats(qrs, 500, 2000, 50, 30) - EXPECTED_BEATS) <= 1);
+}
+
+TEST(QRSDetectorOffset, HeartRateFromOffsetInput) {
+    qrs.begin(500);
+    countBeats(qrs, 500, 512, 100, 30);
+    CHECK(std::abs(static_cast<int>(qrs.getHeartRate()) - 720) <= 10);  // 0.1 bpm
+}
+
+TEST(QRSDetectorOffset, RelearnAfterBeginSeesTheSameBeats) {
+    qrs.begin(250);
+    countBeats(qrs, 250, 512, 80, 10);
+    qrs.begin(250);  // As the firmware does on every lead change
+    CHECK(std::abs(countBeats(qrs, 250, 512, 80, 30) - EXPECTED_BEATS) <= 1);
+}
+
+TEST_GROUP(QRSDetectorDecay) {
+    QRSDetector qrs;
+};
+
+TEST(QRSDetectorDecay, RecoversAfterAmplitudeDrop) {
+    const uint16_t rate = 500;
+    qrs.begin(rate);
+    int late = 0;
+    for (uint32_t n = 0; n < 40UL * rate; n++) {
+        const double amplitude = n < 10UL * rate ? 800 : 40;  // Learned on large beats
+        if (qrs.process(ecgSample(n, rate, 512, amplitude), n) && n > 20UL * rate) late++;
+    }
+    CHECK(std::abs(late - static_cast<int>(20.0 / RR_SECONDS)) <= 1);
+}
+
+TEST(QRSDetectorDecay, LevelsDecayWithoutBeats) {
+    const uint16_t rate = 250;
+    qrs.begin(rate);
+    uint32_t n = 0;
+    for (; n < 10UL * rate; n++) qrs.process(ecgSample(n, rate, 512, 200), n);
+    const uint32_t threshold = qrs.getThreshold();
+    CHECK(threshold > 0);
+    for (uint32_t i = 0; i < 5UL * rate; i++, n++) qrs.process(512, n);  // Flat: 3 s, then twice 1 s
+    CHECK(qrs.getThreshold() <= threshold / 4 + 1);
+}
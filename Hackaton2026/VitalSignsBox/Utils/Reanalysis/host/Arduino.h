@@ -0,0 +1,19 @@
+/*
+    Arduino.h (host)
+
+    The part of Arduino.h that the DSP libraries use, for host builds of
+    the firmware code (reanalyse.cpp). micros() is defined by the tool:
+    the time in the recording that is being processed, so latencies and
+    time stamps follow the recording, not the host clock.
+*/
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+uint32_t micros();
+
+#endif // HOST_ARDUINO_H
@@ -0,0 +1,326 @@
+/*
+    reanalyse.cpp
+
+    Offline reanalysis of recordings with the firmware DSP, for the Pi or any host
+
+    Runs the same QRSDetector, SpO2Estimator and AlarmEngine code as the
+    modules and the hub over WaveCodec recordings (files or directories
+    of .wv files): blocks of 3 channels are ECG (LL, LA, RA; QRS on lead
+    II = LL - RA), blocks of 2 channels are the red and IR
+    photoplethysmogram (SpO2 and pulse rate). The recordings are memory
+    mapped and shared out over a pool of threads, largest first; each
+    thread decodes a whole block at a time and runs the detectors over
+    its samples. Heart rate and SpO2 go to the alarm rules of
+    basic_alarms.ino at 5 Hz of recording time.
+
+    Writes one CSV line per recording on stdout, in the order given;
+    with -e every alarm state change to a second CSV file.
+
+        g++ -std=c++17 -O2 -pthread -I host -I ../QRSDetectorLibrary/Library \
+            -I ../AlarmEngineLibrary/Library -I ../WaveCodecLibrary/Library -I ../CrcLibrary/Library \
+            -I ../../SpO2Detection/FirmwareSpO2Detect reanalyse.cpp \
+            ../QRSDetectorLibrary/Library/QRSDetector.cpp ../AlarmEngineLibrary/Library/AlarmEngine.cpp \
+            ../WaveCodecLibrary/Library/WaveCodec.cpp ../../SpO2Detection/FirmwareSpO2Detect/SpO2Estimator.cpp \
+            ../CrcLibrary/Library/Crc.cpp \
+            -o reanalyse
+        ./reanalyse -j 4 -e alarms.csv /mnt/archive > summary.csv
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "AlarmEngine.h"
+#include "QRSDetector.h"
+#include "SpO2Estimator.h"
+#include "WaveCodec.h"
+
+// The recording time (us) of the sample being processed, per thread
+static thread_local uint64_t recordingUs = 0;
+
+uint32_t micros() {
+    return (uint32_t)recordingUs;
+}
+
+struct Options {
+    unsigned threads;
+    uint16_t ecgRate;
+    uint16_t ppgRate;
+    const char* eventsPath;
+};
+
+struct Event {
+    double timeS;
+    AlarmEvent event;
+};
+
+struct Result {
+    bool ok;
+    uint64_t bytes;
+    uint64_t ecgFrames;
+    uint64_t ppgFrames;
+    uint32_t blocks;
+    uint32_t corrupt;       // Bytes skipped in damaged blocks
+    uint32_t gaps;          // Jumps in the frame numbers
+    uint32_t beats;
+    uint16_t hrMin, hrMax;  // 0.1 bpm
+    uint64_t hrSum;
+    uint32_t hrCount;
+    uint16_t spo2Min;       // 0.1 %
+    uint64_t spo2Sum;
+    uint32_t spo2Count;
+    uint32_t alarms;        // Raised
+    std::vector<Event> events;
+};
+
+// One signal in a recording: its frame numbers and the 5 Hz alarm tick
+struct Stream {
+    bool started;
+    uint32_t firstFrame;
+    uint32_t nextFrame;
+    uint64_t frames;        // Since the start, gaps included
+    uint32_t tick;          // Frames per alarm update
+};
+
+static void drain(AlarmEngine& alarms, Result& result, bool keep) {
+    AlarmEvent event;
+    while (alarms.read(event)) {
+        if (event.active) result.alarms++;
+        if (keep) result.events.push_back({recordingUs / 1e6, event});
+    }
+}
+
+// Frame numbers of a block: count gaps, return the frame offset from the stream start
+static uint64_t advance(Stream& stream, const WaveBlockInfo& info, Result& result) {
+    if (!stream.started) {
+        stream.started = true;
+        stream.firstFrame = info.firstFrame;
+        stream.nextFrame = info.firstFrame;
+    }
+    if (info.firstFrame != stream.nextFrame) result.gaps++;
+    const uint64_t offset = stream.frames + (uint32_t)(info.firstFrame - stream.nextFrame);
+    stream.frames = offset + info.frames;
+    stream.nextFrame = info.firstFrame + info.frames;
+    return offset;
+}
+
+static Result analyse(const std::string& path, const Options& options) {
+    Result result = {};
+    result.hrMin = 0xFFFF;
+    result.spo2Min = 0xFFFF;
+
+    const int fd = open(path.c_str(), O_RDONLY);
+    struct stat status;
+    if (fd < 0 || fstat(fd, &status) != 0) {
+        if (fd >= 0) close(fd);
+        return result;
+    }
+    const size_t size = (size_t)status.st_size;
+    const uint8_t* data = nullptr;
+    if (size > 0) {
+        void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping != MAP_FAILED) {
+            madvise(mapping, size, MADV_SEQUENTIAL);
+            data = (const uint8_t*)mapping;
+        }
+    }
+    close(fd);
+    if (size > 0 && data == nullptr) return result;
+    result.ok = true;
+    result.bytes = size;
+    recordingUs = 0;
+
+    QRSDetector qrs;
+    qrs.begin(options.ecgRate);
+    SpO2Estimator spo2;
+    spo2.begin(options.ppgRate);
+
+    // As basic_alarms.ino, without the lead status (not in the recording)
+    AlarmEngine alarms;
+    const int8_t heartRate = alarms.addChannel(25);  // 5 s at 5 Hz
+    const int8_t saturation = alarms.addChannel(50); // 10 s
+    alarms.addRule({ (uint8_t)heartRate, ALARM_VALUE, ALARM_ABOVE, 2, 1500, 50, 10 });  // HR > 150 bpm for 2 s
+    alarms.addRule({ (uint8_t)heartRate, ALARM_MAX, ALARM_BELOW, 2, 400, 20, 0 });      // HR < 40 bpm for 5 s
+    alarms.addRule({ (uint8_t)heartRate, ALARM_TREND, ALARM_ABOVE, 1, 300, 50, 0 });    // HR up 30 bpm in 5 s
+    alarms.addRule({ (uint8_t)saturation, ALARM_MEAN, ALARM_BELOW, 2, 900, 10, 0 });    // SpO2 < 90 % over 10 s
+    const bool keep = options.eventsPath != nullptr;
+
+    Stream ecg = {}, ppg = {};
+    ecg.tick = options.ecgRate / 5;
+    ppg.tick = options.ppgRate / 5;
+    std::vector<int16_t> samples((size_t)WaveCodec::MAX_FRAMES * WaveCodec::MAX_CHANNELS);
+    std::vector<int16_t> lead(WaveCodec::MAX_FRAMES);
+
+    size_t pos = 0;
+    while (pos < size) {
+        const size_t start = WaveCodec::findBlock(data, size, pos);
+        result.corrupt += (uint32_t)(start - pos);
+        if (start == size) break;
+        WaveBlockInfo info;
+        if (WaveCodec::decode(data + start, size - start, samples.data(), samples.size(), info) == 0) {
+            result.corrupt++;
+            pos = start + 1;
+            continue;
+        }
+        pos = start + info.blockBytes;
+        result.blocks++;
+
+        if (info.channels == 3) {
+            const uint64_t first = advance(ecg, info, result);
+            const int16_t* frame = samples.data();
+            for (uint16_t f = 0; f < info.frames; f++, frame += 3) lead[f] = (int16_t)(frame[0] - frame[2]);
+            for (uint16_t f = 0; f < info.frames; f++) {
+                const uint64_t n = first + f;
+                recordingUs = n * 1000000ull / options.ecgRate;
+                if (qrs.process(lead[f], ecg.firstFrame + (uint32_t)n)) {
+                    result.beats++;
+                    const uint16_t rate = qrs.getHeartRate();
+                    if (rate != 0) {
+                        result.hrMin = std::min(result.hrMin, rate);
+                        result.hrMax = std::max(result.hrMax, rate);
+                        result.hrSum += rate;
+                        result.hrCount++;
+                    }
+                }
+                if (n % ecg.tick == 0 && qrs.getHeartRate() != 0) {
+                    alarms.update((uint8_t)heartRate, qrs.getHeartRate(), micros());
+                    drain(alarms, result, keep);
+                }
+            }
+            result.ecgFrames += info.frames;
+        } else if (info.channels == 2) {
+            const uint64_t first = advance(ppg, info, result);
+            const int16_t* frame = samples.data();
+            for (uint16_t f = 0; f < info.frames; f++, frame += 2) {
+                const uint64_t n = first + f;
+                recordingUs = n * 1000000ull / options.ppgRate;
+                if (spo2.process((uint16_t)frame[0], (uint16_t)frame[1]) && spo2.getSpO2() != 0) {
+                    result.spo2Min = std::min(result.spo2Min, spo2.getSpO2());
+                    result.spo2Sum += spo2.getSpO2();
+                    result.spo2Count++;
+                }
+                if (n % ppg.tick == 0 && spo2.getSpO2() != 0) {
+                    alarms.update((uint8_t)saturation, spo2.getSpO2(), micros());
+                    drain(alarms, result, keep);
+                }
+            }
+            result.ppgFrames += info.frames;
+        }
+    }
+
+    if (data != nullptr) munmap((void*)data, size);
+    return result;
+}
+
+static void collect(const std::filesystem::path& path, std::vector<std::string>& files) {
+    std::error_code error;
+    if (!std::filesystem::is_directory(path, error)) {
+        files.push_back(path.string());
+        return;
+    }
+    std::vector<std::string> found;
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(path, error)) {
+        if (entry.is_regular_file() && entry.path().extension() == ".wv") found.push_back(entry.path().string());
+    }
+    std::sort(found.begin(), found.end());
+    files.insert(files.end(), found.begin(), found.end());
+}
+
+static void usage(const char* name) {
+    fprintf(stderr, "Usage: %s [-j threads] [-r ecg Hz] [-p ppg Hz] [-e events.csv] recording.wv|directory ...\n",
+            name);
+}
+
+int main(int argc, char** argv) {
+    Options options = { std::max(1u, std::thread::hardware_concurrency()), 500, 100, nullptr };
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; i++) {
+        const bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "-j") == 0 && hasValue) options.threads = std::max(1, atoi(argv[++i]));
+        else if (strcmp(argv[i], "-r") == 0 && hasValue) options.ecgRate = (uint16_t)atoi(argv[++i]);
+        else if (strcmp(argv[i], "-p") == 0 && hasValue) options.ppgRate = (uint16_t)atoi(argv[++i]);
+        else if (strcmp(argv[i], "-e") == 0 && hasValue) options.eventsPath = argv[++i];
+        else if (argv[i][0] == '-') {
+            usage(argv[0]);
+            return 1;
+        } else {
+            collect(argv[i], files);
+        }
+    }
+    if (files.empty() || options.ecgRate < 5 || options.ppgRate < 5) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    // Largest recordings first, so no thread is left with a long one at the end
+    std::vector<size_t> order(files.size());
+    std::vector<uint64_t> sizes(files.size());
+    for (size_t i = 0; i < files.size(); i++) {
+        order[i] = i;
+        std::error_code error;
+        sizes[i] = std::filesystem::file_size(files[i], error);
+    }
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return sizes[a] > sizes[b]; });
+
+    std::vector<Result> results(files.size());
+    std::atomic<size_t> next(0);
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < std::min<size_t>(options.threads, files.size()); t++) {
+        pool.emplace_back([&]() {
+            for (size_t i; (i = next.fetch_add(1)) < order.size();) results[order[i]] = analyse(files[order[i]], options);
+        });
+    }
+    for (std::thread& thread : pool) thread.join();
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    FILE* events = nullptr;
+    if (options.eventsPath != nullptr) {
+        if ((events = fopen(options.eventsPath, "w")) == nullptr) {
+            perror(options.eventsPath);
+            return 1;
+        }
+        fprintf(events, "file,time_s,rule,active,priority,value\n");
+    }
+
+    printf("file,ecg_s,ppg_s,blocks,corrupt_bytes,gaps,beats,hr_min,hr_mean,hr_max,spo2_min,spo2_mean,alarms\n");
+    double signalS = 0;
+    unsigned failed = 0;
+    for (size_t i = 0; i < files.size(); i++) {
+        const Result& r = results[i];
+        if (!r.ok) {
+            fprintf(stderr, "%s: cannot read\n", files[i].c_str());
+            failed++;
+            continue;
+        }
+        const double ecgS = (double)r.ecgFrames / options.ecgRate;
+        const double ppgS = (double)r.ppgFrames / options.ppgRate;
+        signalS += std::max(ecgS, ppgS);
+        printf("%s,%.1f,%.1f,%u,%u,%u,%u,", files[i].c_str(), ecgS, ppgS, r.blocks, r.corrupt, r.gaps, r.beats);
+        if (r.hrCount != 0) printf("%.1f,%.1f,%.1f,", r.hrMin / 10.0, r.hrSum / 10.0 / r.hrCount, r.hrMax / 10.0);
+        else printf(",,,");
+        if (r.spo2Count != 0) printf("%.1f,%.1f,", r.spo2Min / 10.0, r.spo2Sum / 10.0 / r.spo2Count);
+        else printf(",,");
+        printf("%u\n", r.alarms);
+        for (const Event& e : r.events) {
+            fprintf(events, "%s,%.3f,%u,%d,%u,%ld\n", files[i].c_str(), e.timeS, e.event.rule, e.event.active ? 1 : 0,
+                    e.event.priority, (long)e.event.value);
+        }
+    }
+    if (events != nullptr) fclose(events);
+
+    fprintf(stderr, "%zu recordings, %.1f h of signal in %.1f s on %u threads (%.0fx real time)%s\n", files.size(),
+            signalS / 3600, elapsed, options.threads, elapsed > 0 ? signalS / elapsed : 0.0,
+            failed != 0 ? ", some could not be read" : "");
+    return failed != 0 ? 2 : 0;
+}
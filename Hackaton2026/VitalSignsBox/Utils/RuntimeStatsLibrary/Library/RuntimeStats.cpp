@@ -0,0 +1,147 @@
+/*
+    RuntimeStats.cpp
+
+    Loop, interrupt and acquisition counters implementation
+*/
+
+#include "RuntimeStats.h"
+
+static void putU16(uint8_t* out, uint16_t value) {
+    out[0] = value >> 8;
+    out[1] = value & 0xFF;
+}
+
+static void putU32(uint8_t* out, uint32_t value) {
+    putU16(out, value >> 16);
+    putU16(out + 2, value & 0xFFFF);
+}
+
+static uint16_t getU16(const uint8_t* in) {
+    return ((uint16_t)in[0] << 8) | in[1];
+}
+
+static uint32_t getU32(const uint8_t* in) {
+    return ((uint32_t)getU16(in) << 16) | getU16(in + 2);
+}
+
+// Events per window scaled to per second
+static uint32_t perSecond(uint32_t count, uint32_t elapsedUs) {
+    return (uint32_t)(((uint64_t)count * 1000000UL + elapsedUs / 2) / elapsedUs);
+}
+
+RuntimeStats::RuntimeStats()
+    : _windowUs(DEFAULT_WINDOW_MS * 1000UL)
+    , _windowStartUs(0)
+    , _lastTickUs(0)
+    , _started(false)
+    , _loops(0)
+    , _loopMaxUs(0)
+    , _samples(0)
+    , _isrCount(0)
+    , _isrBusyUs(0)
+    , _isrMaxUs(0)
+    , _loopMaxEverUs(0)
+    , _overruns(0)
+    , _busErrors(0)
+    , _isrBusErrors(0)
+    , _front(0)
+{
+    memset(&_report, 0, sizeof(_report));
+    memset(_reports, 0, sizeof(_reports));
+}
+
+void RuntimeStats::begin(uint16_t windowMs) {
+    _windowUs = (windowMs > 0 ? windowMs : DEFAULT_WINDOW_MS) * 1000UL;
+    _windowStartUs = micros();
+    _started = false;  // The time before the first loopTick() is setup(), not a pass
+}
+
+bool RuntimeStats::loopTick() {
+    const uint32_t now = micros();
+    if (_started) {
+        const uint32_t pass = now - _lastTickUs;
+        if (pass > _loopMaxUs) _loopMaxUs = pass;
+    }
+    _started = true;
+    _lastTickUs = now;
+    _loops++;
+
+    if (now - _windowStartUs < _windowUs) return false;
+    closeWindow(now);
+    return true;
+}
+
+void RuntimeStats::isrEnd(uint32_t startUs) {
+    const uint32_t elapsed = micros() - startUs;
+    _isrCount++;
+    _isrBusyUs += elapsed;
+    if (elapsed > _isrMaxUs) _isrMaxUs = elapsed;
+}
+
+void RuntimeStats::closeWindow(uint32_t now) {
+    const uint32_t elapsed = now - _windowStartUs;
+
+    noInterrupts();
+    const uint32_t isrCount = _isrCount;
+    const uint32_t isrBusyUs = _isrBusyUs;
+    const uint32_t isrMaxUs = _isrMaxUs;
+    const uint32_t isrBusErrors = _isrBusErrors;
+    _isrCount = 0;
+    _isrBusyUs = 0;
+    _isrMaxUs = 0;
+    interrupts();
+
+    if (_loopMaxUs > _loopMaxEverUs) _loopMaxEverUs = _loopMaxUs;
+    const uint32_t load = (uint32_t)(((uint64_t)isrBusyUs * 1000 + elapsed / 2) / elapsed);
+
+    _report.seconds++;
+    _report.loopRate = perSecond(_loops, elapsed);
+    _report.loopMaxUs = _loopMaxUs;
+    _report.loopMaxEverUs = _loopMaxEverUs;
+    _report.isrMaxUs = isrMaxUs > 0xFFFF ? 0xFFFF : (uint16_t)isrMaxUs;
+    _report.isrLoad = load > 1000 ? 1000 : (uint16_t)load;
+    _report.isrRate = perSecond(isrCount, elapsed);
+    _report.sampleRate = perSecond(_samples, elapsed);
+    _report.overruns = _overruns;
+    _report.busErrors = _busErrors + isrBusErrors;
+
+    // Fill the back report, then flip: the interrupt never sees half of one
+    uint8_t* out = _reports[_front ^ 1];
+    putU32(out, _report.seconds);
+    putU32(out + 4, _report.loopRate);
+    putU32(out + 8, _report.loopMaxUs);
+    putU32(out + 12, _report.loopMaxEverUs);
+    putU16(out + 16, _report.isrMaxUs);
+    putU16(out + 18, _report.isrLoad);
+    putU32(out + 20, _report.isrRate);
+    putU32(out + 24, _report.sampleRate);
+    putU32(out + 28, _report.overruns);
+    putU32(out + 32, _report.busErrors);
+    __asm__ volatile("" ::: "memory");
+    _front ^= 1;
+
+    _windowStartUs = now;
+    _loops = 0;
+    _loopMaxUs = 0;
+    _samples = 0;
+}
+
+uint8_t RuntimeStats::pack(uint8_t* out) const {
+    memcpy(out, _reports[_front], REPORT_BYTES);
+    return REPORT_BYTES;
+}
+
+bool RuntimeStats::unpack(const uint8_t* data, uint8_t length, RuntimeReport& report) {
+    if (length < REPORT_BYTES) return false;
+    report.seconds = getU32(data);
+    report.loopRate = getU32(data + 4);
+    report.loopMaxUs = getU32(data + 8);
+    report.loopMaxEverUs = getU32(data + 12);
+    report.isrMaxUs = getU16(data + 16);
+    report.isrLoad = getU16(data + 18);
+    report.isrRate = getU32(data + 20);
+    report.sampleRate = getU32(data + 24);
+    report.overruns = getU32(data + 28);
+    report.busErrors = getU32(data + 32);
+    return true;
+}
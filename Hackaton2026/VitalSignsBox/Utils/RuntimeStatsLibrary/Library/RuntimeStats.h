@@ -0,0 +1,117 @@
+/*
+    RuntimeStats.h
+
+    Load counters of a module firmware, one register block for the hub
+
+    When the hub sees stale data it needs to know whether the module is
+    overloaded (slow loop, long I2C handler, dropped samples) or the bus
+    is. Every module keeps the same counters, updated where the work
+    happens and cheap enough to leave in:
+
+    - loopTick() at the top of loop(): loop rate and longest pass
+    - isrBegin() / isrEnd() around the I2C handlers (I2CRegisterSlave does
+      this after setStats()): longest handler, handler load
+    - addSamples(), setOverruns(), setBusErrors() from the acquisition
+      and the buses
+
+    Once per window (1 s) the counters are latched into a double buffered
+    report, so the I2C request handler copies one consistent block with
+    pack() and a burst read of REPORT_BYTES gets all of it.
+*/
+
+#ifndef RUNTIME_STATS_H
+#define RUNTIME_STATS_H
+
+#include <Arduino.h>
+
+// Decoded report, for the hub
+struct RuntimeReport {
+    uint32_t seconds;          // Windows since begin(): changes when the report is fresh
+    uint32_t loopRate;         // loop() passes per second
+    uint32_t loopMaxUs;        // Longest pass in the last window
+    uint32_t loopMaxEverUs;    // Longest pass since begin()
+    uint16_t isrMaxUs;         // Longest I2C handler in the last window
+    uint16_t isrLoad;          // Time in the I2C handlers, 0.1 % of the window
+    uint32_t isrRate;          // I2C handler calls per second
+    uint32_t sampleRate;       // ADC samples per second
+    uint32_t overruns;         // Samples or records lost, since begin()
+    uint32_t busErrors;        // Bus errors, since begin()
+};
+
+class RuntimeStats {
+public:
+    static const uint8_t REPORT_BYTES = 36;
+    static const uint16_t DEFAULT_WINDOW_MS = 1000;
+
+    RuntimeStats();
+
+    /**
+     * Start the first window
+     * @param windowMs Period of the rates and maxima
+     */
+    void begin(uint16_t windowMs = DEFAULT_WINDOW_MS);
+
+    /**
+     * Call first in every loop(); closes the window when it is complete
+     * @return true when a new report was latched
+     */
+    bool loopTick();
+
+    /**
+     * Time an interrupt handler (one interrupt only, e.g. the I2C slave):
+     * uint32_t start = stats.isrBegin(); ... stats.isrEnd(start);
+     */
+    uint32_t isrBegin() const { return micros(); }
+    void isrEnd(uint32_t startUs);
+
+    // From the interrupt timed above: a bus error it saw
+    void onBusError() { _isrBusErrors++; }
+
+    // From loop()
+    void addSamples(uint16_t count) { _samples += count; }
+    void setOverruns(uint32_t total) { _overruns = total; }
+    void setBusErrors(uint32_t total) { _busErrors = total; }  // Other buses; onBusError() adds to it
+
+    /**
+     * Copy the latest report (ISR safe)
+     * @param out At least REPORT_BYTES
+     * @return REPORT_BYTES
+     */
+    uint8_t pack(uint8_t* out) const;
+
+    /**
+     * Decode a report read from a module
+     * @return false if length is too short
+     */
+    static bool unpack(const uint8_t* data, uint8_t length, RuntimeReport& report);
+
+    const RuntimeReport& getReport() const { return _report; }
+
+private:
+    void closeWindow(uint32_t now);
+
+    uint32_t _windowUs;
+    uint32_t _windowStartUs;
+    uint32_t _lastTickUs;
+    bool _started;
+
+    // Current window
+    uint32_t _loops;
+    uint32_t _loopMaxUs;
+    uint32_t _samples;
+    volatile uint32_t _isrCount;
+    volatile uint32_t _isrBusyUs;
+    volatile uint32_t _isrMaxUs;
+
+    // Totals
+    uint32_t _loopMaxEverUs;
+    uint32_t _overruns;
+    uint32_t _busErrors;
+    volatile uint32_t _isrBusErrors;
+
+    RuntimeReport _report;
+    uint8_t _reports[2][REPORT_BYTES];
+    volatile uint8_t _front;   // Report the interrupt copies
+};
+
+#endif // RUNTIME_STATS_H
@@ -0,0 +1,40 @@
+#include "RuntimeStats.h"
+
+/*
+    Sample A0 every millisecond, with a slow pass now and then, and print
+    the loop rate, the longest pass and the sample rate once per second.
+*/
+
+#define SAMPLE_PERIOD_US 1000
+
+RuntimeStats stats;
+uint32_t lastSampleUs = 0;
+uint32_t sum = 0;
+
+void setup() {
+  Serial.begin(115200);
+  stats.begin();
+}
+
+void loop() {
+  if (stats.loopTick()) {
+    const RuntimeReport& report = stats.getReport();
+    Serial.print("loop ");
+    Serial.print(report.loopRate);
+    Serial.print("/s, max ");
+    Serial.print(report.loopMaxUs);
+    Serial.print(" us, ever ");
+    Serial.print(report.loopMaxEverUs);
+    Serial.print(" us, samples ");
+    Serial.print(report.sampleRate);
+    Serial.println("/s");
+  }
+
+  if (micros() - lastSampleUs >= SAMPLE_PERIOD_US) {
+    lastSampleUs += SAMPLE_PERIOD_US;
+    sum += analogRead(A0);
+    stats.addSamples(1);
+  }
+
+  if (random(1000) == 0) delay(5);  // A slow pass: shows in the maximum
+}
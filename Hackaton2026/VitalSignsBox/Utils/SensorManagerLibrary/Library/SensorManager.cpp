@@ -0,0 +1,266 @@
+/*
+    SensorManager.cpp
+
+    Demand-driven power gating for sensors implementation
+*/
+
+#include "SensorManager.h"
+
+SensorManager::SensorManager()
+    : _count(0)
+    , _lingerMs(0)
+    , _retryMs(SENSOR_MANAGER_RETRY_MS)
+{
+}
+
+int8_t SensorManager::add(ManagedSensor* sensor, int8_t parent) {
+    if (sensor == nullptr || _count >= SENSOR_MANAGER_MAX) return -1;
+    if (parent >= (int8_t)_count) return -1;  // Parents come first: no cycles
+
+    Entry& entry = _entries[_count];
+    entry.sensor = sensor;
+    entry.parent = parent;
+    entry.state = SENSOR_OFF;
+    entry.subscribers = 0;
+    entry.deadlineMs = 0;
+    entry.onSinceMs = 0;
+    entry.onTimeMs = 0;
+    entry.activations = 0;
+
+    sensor->standby();
+    return _count++;
+}
+
+bool SensorManager::subscribe(uint8_t id) {
+    if (id >= _count) return false;
+    Entry& entry = _entries[id];
+    if (entry.subscribers == 255) return false;
+
+    if (entry.subscribers++ == 0) {
+        if (entry.state == SENSOR_LINGER) {
+            entry.state = SENSOR_READY;  // Still powered and configured
+        } else if (entry.state == SENSOR_OFF) {
+            activate(id);
+        }
+    }
+    return true;
+}
+
+void SensorManager::unsubscribe(uint8_t id) {
+    if (id >= _count) return;
+    Entry& entry = _entries[id];
+    if (entry.subscribers == 0 || --entry.subscribers > 0) return;
+
+    switch (entry.state) {
+    case SENSOR_FAULT:
+        entry.state = SENSOR_OFF;  // Nobody waits for the retry any more
+        break;
+    case SENSOR_STARTING:
+    case SENSOR_READY:
+        if (_lingerMs == 0) {
+            powerDown(id);
+        } else {
+            entry.state = SENSOR_LINGER;
+            entry.deadlineMs = millis() + _lingerMs;
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void SensorManager::setLingerMs(uint16_t ms) {
+    _lingerMs = ms;
+}
+
+void SensorManager::setRetryMs(uint16_t ms) {
+    _retryMs = ms;
+}
+
+void SensorManager::update() {
+    const uint32_t now = millis();
+
+    for (uint8_t id = 0; id < _count; id++) {
+        Entry& entry = _entries[id];
+        switch (entry.state) {
+        case SENSOR_STARTING:
+            if (reached(now, entry.deadlineMs)) entry.state = SENSOR_READY;
+            break;
+        case SENSOR_LINGER:
+            if (reached(now, entry.deadlineMs)) powerDown(id);
+            break;
+        case SENSOR_FAULT:
+            if (reached(now, entry.deadlineMs)) activate(id);
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+// Parent first, then the sensor itself
+void SensorManager::activate(uint8_t id) {
+    Entry& entry = _entries[id];
+    if (entry.parent >= 0) subscribe(entry.parent);
+
+    const uint32_t now = millis();
+    if (!entry.sensor->activate()) {
+        if (entry.parent >= 0) unsubscribe(entry.parent);
+        entry.state = SENSOR_FAULT;
+        entry.deadlineMs = now + _retryMs;
+        return;
+    }
+
+    entry.activations++;
+    entry.onSinceMs = now;
+    const uint16_t startupMs = entry.sensor->getStartupMs();
+    if (startupMs == 0) {
+        entry.state = SENSOR_READY;
+    } else {
+        entry.state = SENSOR_STARTING;
+        entry.deadlineMs = now + startupMs;
+    }
+}
+
+void SensorManager::powerDown(uint8_t id) {
+    Entry& entry = _entries[id];
+    entry.sensor->standby();
+    entry.onTimeMs += millis() - entry.onSinceMs;
+    entry.state = SENSOR_OFF;
+    if (entry.parent >= 0) unsubscribe(entry.parent);
+}
+
+// Wrap-safe: millis() overflows after 49 days
+bool SensorManager::reached(uint32_t now, uint32_t deadline) {
+    return (int32_t)(now - deadline) >= 0;
+}
+
+bool SensorManager::isReady(uint8_t id) const {
+    return id < _count && _entries[id].state == SENSOR_READY;
+}
+
+SensorState SensorManager::getState(uint8_t id) const {
+    return id < _count ? _entries[id].state : SENSOR_OFF;
+}
+
+uint8_t SensorManager::getSubscribers(uint8_t id) const {
+    return id < _count ? _entries[id].subscribers : 0;
+}
+
+uint8_t SensorManager::getActiveCount() const {
+    uint8_t active = 0;
+    for (uint8_t id = 0; id < _count; id++) {
+        const SensorState state = _entries[id].state;
+        if (state != SENSOR_OFF && state != SENSOR_FAULT) active++;
+    }
+    return active;
+}
+
+uint32_t SensorManager::getActivations(uint8_t id) const {
+    return id < _count ? _entries[id].activations : 0;
+}
+
+uint32_t SensorManager::getOnTimeMs(uint8_t id) const {
+    if (id >= _count) return 0;
+    const Entry& entry = _entries[id];
+    const bool powered = entry.state != SENSOR_OFF && entry.state != SENSOR_FAULT;
+    return entry.onTimeMs + (powered ? millis() - entry.onSinceMs : 0);
+}
+
+// ============================================================================
+// SensorSubscription
+// ============================================================================
+
+SensorSubscription::SensorSubscription(SensorManager& manager, uint8_t id)
+    : _manager(manager)
+    , _id(id)
+{
+    _manager.subscribe(_id);
+}
+
+SensorSubscription::~SensorSubscription() {
+    _manager.unsubscribe(_id);
+}
+
+bool SensorSubscription::isReady() const {
+    return _manager.isReady(_id);
+}
+
+// ============================================================================
+// Adapters
+// ============================================================================
+
+PinPowerSensor::PinPowerSensor(uint8_t pin, bool activeHigh, uint16_t startupMs)
+    : _pin(pin)
+    , _activeHigh(activeHigh)
+    , _startupMs(startupMs)
+{
+}
+
+bool PinPowerSensor::activate() {
+    pinMode(_pin, OUTPUT);
+    digitalWrite(_pin, _activeHigh ? HIGH : LOW);
+    return true;
+}
+
+void PinPowerSensor::standby() {
+    pinMode(_pin, OUTPUT);
+    digitalWrite(_pin, _activeHigh ? LOW : HIGH);
+}
+
+uint16_t PinPowerSensor::getStartupMs() const {
+    return _startupMs;
+}
+
+I2CCommandSensor::I2CCommandSensor(TwoWire& wire, uint8_t address,
+                                   const uint8_t* wake, uint8_t wakeLength,
+                                   const uint8_t* sleep, uint8_t sleepLength,
+                                   uint16_t startupMs)
+    : _wire(wire)
+    , _address(address)
+    , _wakeLength(wakeLength > SENSOR_MANAGER_MAX_COMMAND ? SENSOR_MANAGER_MAX_COMMAND : wakeLength)
+    , _sleepLength(sleepLength > SENSOR_MANAGER_MAX_COMMAND ? SENSOR_MANAGER_MAX_COMMAND : sleepLength)
+    , _startupMs(startupMs)
+{
+    for (uint8_t i = 0; i < _wakeLength; i++) _wake[i] = wake[i];
+    for (uint8_t i = 0; i < _sleepLength; i++) _sleep[i] = sleep[i];
+}
+
+bool I2CCommandSensor::activate() {
+    return write(_wake, _wakeLength);
+}
+
+void I2CCommandSensor::standby() {
+    write(_sleep, _sleepLength);
+}
+
+uint16_t I2CCommandSensor::getStartupMs() const {
+    return _startupMs;
+}
+
+bool I2CCommandSensor::write(const uint8_t* data, uint8_t length) {
+    _wire.beginTransmission(_address);
+    for (uint8_t i = 0; i < length; i++) _wire.write(data[i]);
+    return _wire.endTransmission() == 0;
+}
+
+CallbackSensor::CallbackSensor(ActivateFn onActivate, StandbyFn onStandby, void* context,
+                               uint16_t startupMs)
+    : _onActivate(onActivate)
+    , _onStandby(onStandby)
+    , _context(context)
+    , _startupMs(startupMs)
+{
+}
+
+bool CallbackSensor::activate() {
+    return _onActivate ? _onActivate(_context) : true;
+}
+
+void CallbackSensor::standby() {
+    if (_onStandby) _onStandby(_context);
+}
+
+uint16_t CallbackSensor::getStartupMs() const {
+    return _startupMs;
+}
@@ -0,0 +1,237 @@
+/*
+    SensorManager.h
+
+    Demand-driven power gating for sensors
+
+    A sensor draws current whether anyone reads it or not: the SpO2 LED,
+    an ADC converting in continuous mode, a ToF emitter. SensorManager
+    counts the consumers of every sensor. The first subscribe() powers it
+    up and configures it, the last unsubscribe() puts it in standby. In
+    between a sensor reports STARTING until its start-up time has passed,
+    so consumers never see the first, invalid samples.
+
+    A sensor can depend on another one (e.g. two sensors on a switched
+    supply rail): activating it subscribes its parent first, and its
+    standby releases the parent again.
+
+    A ManagedSensor only has to power up and go to standby. Adapters for
+    a power pin, I2C wake/sleep commands and plain callbacks are included;
+    drivers with a fast warm-start path (registers kept in standby) use
+    that path in activate().
+*/
+
+#ifndef SENSOR_MANAGER_H
+#define SENSOR_MANAGER_H
+
+#include <Arduino.h>
+#include <Wire.h>
+
+#define SENSOR_MANAGER_MAX 8
+#define SENSOR_MANAGER_MAX_COMMAND 4     // Bytes per I2C wake/sleep command
+#define SENSOR_MANAGER_RETRY_MS 1000     // Default wait before retrying a failed activate()
+
+enum SensorState : uint8_t {
+    SENSOR_OFF,        // In standby, no consumers
+    SENSOR_STARTING,   // Activated, samples not valid yet
+    SENSOR_READY,      // Activated and valid
+    SENSOR_LINGER,     // No consumers, standby when the linger time ends
+    SENSOR_FAULT       // activate() failed, retried while consumers wait
+};
+
+/**
+ * A sensor that can be powered up and put in standby
+ */
+class ManagedSensor {
+public:
+    virtual ~ManagedSensor() {}
+
+    /**
+     * Power up and configure
+     * @return false if the device did not respond (retried later)
+     */
+    virtual bool activate() = 0;
+
+    /**
+     * Lowest power state from which activate() still works
+     */
+    virtual void standby() = 0;
+
+    /**
+     * Time from activate() until samples are valid
+     */
+    virtual uint16_t getStartupMs() const { return 0; }
+};
+
+class SensorManager {
+public:
+    SensorManager();
+
+    /**
+     * Add a sensor and put it in standby, so it starts in a known state
+     * @param sensor Kept by pointer, must outlive the manager
+     * @param parent Id of a sensor this one needs (added earlier), or -1
+     * @return Sensor id, or -1 if full or parent is invalid
+     */
+    int8_t add(ManagedSensor* sensor, int8_t parent = -1);
+
+    /**
+     * Register a consumer; the first one activates the sensor
+     * @return false for an unknown id
+     */
+    bool subscribe(uint8_t id);
+
+    /**
+     * Remove a consumer; after the last one the sensor goes to standby
+     */
+    void unsubscribe(uint8_t id);
+
+    /**
+     * Keep a sensor powered for ms after its last consumer left (default 0)
+     * A consumer returning within that time finds it still READY.
+     */
+    void setLingerMs(uint16_t ms);
+
+    /**
+     * Wait between retries of a failed activate()
+     */
+    void setRetryMs(uint16_t ms);
+
+    /**
+     * Advance start-up, linger and retry timers; call every loop()
+     */
+    void update();
+
+    /**
+     * Activated and past its start-up time
+     */
+    bool isReady(uint8_t id) const;
+
+    SensorState getState(uint8_t id) const;
+    uint8_t getSubscribers(uint8_t id) const;
+
+    /**
+     * Number of sensors currently powered (not OFF or FAULT)
+     */
+    uint8_t getActiveCount() const;
+
+    /**
+     * Statistics
+     */
+    uint32_t getActivations(uint8_t id) const;   // Successful activate() calls
+    uint32_t getOnTimeMs(uint8_t id) const;      // Total powered time
+
+private:
+    struct Entry {
+        ManagedSensor* sensor;
+        int8_t parent;
+        SensorState state;
+        uint8_t subscribers;
+        uint32_t deadlineMs;     // STARTING: ready, LINGER: standby, FAULT: retry
+        uint32_t onSinceMs;
+        uint32_t onTimeMs;
+        uint32_t activations;
+    };
+
+    void activate(uint8_t id);
+    void powerDown(uint8_t id);
+    static bool reached(uint32_t now, uint32_t deadline);
+
+    Entry _entries[SENSOR_MANAGER_MAX];
+    uint8_t _count;
+    uint16_t _lingerMs;
+    uint16_t _retryMs;
+};
+
+/**
+ * Subscription for the lifetime of an object (RAII)
+ */
+class SensorSubscription {
+public:
+    SensorSubscription(SensorManager& manager, uint8_t id);
+    ~SensorSubscription();
+
+    bool isReady() const;
+
+private:
+    SensorSubscription(const SensorSubscription&);
+    SensorSubscription& operator=(const SensorSubscription&);
+
+    SensorManager& _manager;
+    uint8_t _id;
+};
+
+// ============================================================================
+// Adapters
+// ============================================================================
+
+/**
+ * Sensor behind a power pin (load switch, LED, enable input)
+ */
+class PinPowerSensor : public ManagedSensor {
+public:
+    PinPowerSensor(uint8_t pin, bool activeHigh = true, uint16_t startupMs = 0);
+
+    bool activate();
+    void standby();
+    uint16_t getStartupMs() const;
+
+private:
+    uint8_t _pin;
+    bool _activeHigh;
+    uint16_t _startupMs;
+};
+
+/**
+ * I2C device woken and put to sleep by writing command bytes
+ * e.g. MCP3426: wake { 0x18 } (continuous), sleep { 0x08 } (one-shot, idles between conversions)
+ */
+class I2CCommandSensor : public ManagedSensor {
+public:
+    /**
+     * @param wake / sleep Command bytes, copied (at most SENSOR_MANAGER_MAX_COMMAND)
+     */
+    I2CCommandSensor(TwoWire& wire, uint8_t address,
+                     const uint8_t* wake, uint8_t wakeLength,
+                     const uint8_t* sleep, uint8_t sleepLength,
+                     uint16_t startupMs = 0);
+
+    bool activate();   // false on NACK
+    void standby();
+    uint16_t getStartupMs() const;
+
+private:
+    bool write(const uint8_t* data, uint8_t length);
+
+    TwoWire& _wire;
+    uint8_t _address;
+    uint8_t _wake[SENSOR_MANAGER_MAX_COMMAND];
+    uint8_t _sleep[SENSOR_MANAGER_MAX_COMMAND];
+    uint8_t _wakeLength;
+    uint8_t _sleepLength;
+    uint16_t _startupMs;
+};
+
+/**
+ * Sensor controlled by two functions, e.g. a driver's warm start and
+ * standby, AdcScanner::setChannelEnabled() or HubScheduler::setEnabled()
+ */
+class CallbackSensor : public ManagedSensor {
+public:
+    typedef bool (*ActivateFn)(void* context);
+    typedef void (*StandbyFn)(void* context);
+
+    CallbackSensor(ActivateFn onActivate, StandbyFn onStandby, void* context = nullptr,
+                   uint16_t startupMs = 0);
+
+    bool activate();
+    void standby();
+    uint16_t getStartupMs() const;
+
+private:
+    ActivateFn _onActivate;
+    StandbyFn _onStandby;
+    void* _context;
+    uint16_t _startupMs;
+};
+
+#endif // SENSOR_MANAGER_H
@@ -0,0 +1,109 @@
+#include <Wire.h>
+#include "AdcScanner.h"
+#include "SensorManager.h"
+
+/*
+    SpO2 LED, its photodiode channels and the MCP3426 powered only while
+    a consumer needs them.
+
+    Send 's' to start or stop the SpO2 consumer, 't' for the temperature
+    consumer. Every second the state of each sensor is printed.
+*/
+
+#define SPO2_LED_D12 12
+#define MCP3426_ADDR 0x68
+
+const uint8_t adcPins[] = { A3, A4 };  // Red, infrared
+AdcScanner adc(adcPins, sizeof(adcPins));
+
+// The photodiode channels are only worth converting with the LED on
+bool enableChannels(void* context) {
+  AdcScanner* scanner = static_cast<AdcScanner*>(context);
+  scanner->setChannelEnabled(0, true);
+  scanner->setChannelEnabled(1, true);
+  return true;
+}
+
+void disableChannels(void* context) {
+  AdcScanner* scanner = static_cast<AdcScanner*>(context);
+  scanner->setChannelEnabled(0, false);
+  scanner->setChannelEnabled(1, false);
+}
+
+const uint8_t mcpWake[] = { 0x18 };   // Continuous, 12 bit, gain 1
+const uint8_t mcpSleep[] = { 0x08 };  // One-shot: idles after one conversion
+
+PinPowerSensor spo2Led(SPO2_LED_D12, true, 20);   // Front end settles in ~20 ms
+CallbackSensor spo2Adc(enableChannels, disableChannels, &adc);
+I2CCommandSensor temperature(Wire, MCP3426_ADDR, mcpWake, 1, mcpSleep, 1, 5);
+
+SensorManager sensors;
+int8_t ledId, spo2Id, tempId;
+
+bool spo2Wanted = false;
+bool tempWanted = false;
+
+#define REPORT_INTERVAL 1000  // ms
+unsigned long lastReport = 0;
+
+const char* stateName(SensorState state) {
+  switch (state) {
+    case SENSOR_OFF:      return "off";
+    case SENSOR_STARTING: return "starting";
+    case SENSOR_READY:    return "ready";
+    case SENSOR_LINGER:   return "linger";
+    default:              return "fault";
+  }
+}
+
+void report(const char* name, int8_t id) {
+  Serial.print(name);
+  Serial.print(": ");
+  Serial.print(stateName(sensors.getState(id)));
+  Serial.print(" (on ");
+  Serial.print(sensors.getOnTimeMs(id));
+  Serial.print(" ms) ");
+}
+
+void setup() {
+  Serial.begin(115200);
+  Wire.begin();
+  adc.begin(10, 2);
+
+  ledId = sensors.add(&spo2Led);
+  spo2Id = sensors.add(&spo2Adc, ledId);  // Starting the channels powers the LED first
+  tempId = sensors.add(&temperature);
+  sensors.setLingerMs(500);  // Short gaps between consumers keep the sensor up
+}
+
+void loop() {
+  sensors.update();
+  adc.poll();
+
+  if (Serial.available()) {
+    const char c = Serial.read();
+    if (c == 's') {
+      spo2Wanted = !spo2Wanted;
+      if (spo2Wanted) sensors.subscribe(spo2Id);
+      else sensors.unsubscribe(spo2Id);
+    } else if (c == 't') {
+      tempWanted = !tempWanted;
+      if (tempWanted) sensors.subscribe(tempId);
+      else sensors.unsubscribe(tempId);
+    }
+  }
+
+  if (millis() - lastReport < REPORT_INTERVAL) return;
+  lastReport = millis();
+
+  report("LED", ledId);
+  report("SpO2", spo2Id);
+  report("temp", tempId);
+  if (sensors.isReady(spo2Id)) {
+    Serial.print("red ");
+    Serial.print(adc.getValue(0));
+    Serial.print(" ir ");
+    Serial.print(adc.getValue(1));
+  }
+  Serial.println();
+}
@@ -0,0 +1,256 @@
+/*
+    SignalQuality.cpp
+
+    Fixed-point FFT and band powers for ECG signal quality
+*/
+
+#include "SignalQuality.h"
+#include <string.h>
+
+#if SIGNAL_QUALITY_CMSIS
+#include <arm_math.h>
+#include <arm_const_structs.h>
+#endif
+
+// sin(2 pi k / 512) in Q15 for the first quadrant, k = 0..128
+static const int16_t SINE_TABLE[129] = {
+    0, 402, 804, 1206, 1608, 2009, 2411, 2811, 3212, 3612, 4011, 4410,
+    4808, 5205, 5602, 5998, 6393, 6787, 7180, 7571, 7962, 8351, 8740, 9127,
+    9512, 9896, 10279, 10660, 11039, 11417, 11793, 12167, 12540, 12910, 13279, 13646,
+    14010, 14373, 14733, 15091, 15447, 15800, 16151, 16500, 16846, 17190, 17531, 17869,
+    18205, 18538, 18868, 19195, 19520, 19841, 20160, 20475, 20788, 21097, 21403, 21706,
+    22006, 22302, 22595, 22884, 23170, 23453, 23732, 24008, 24279, 24548, 24812, 25073,
+    25330, 25583, 25833, 26078, 26320, 26557, 26791, 27020, 27246, 27467, 27684, 27897,
+    28106, 28311, 28511, 28707, 28899, 29086, 29269, 29448, 29622, 29792, 29957, 30118,
+    30274, 30425, 30572, 30715, 30853, 30986, 31114, 31238, 31357, 31471, 31581, 31686,
+    31786, 31881, 31972, 32058, 32138, 32214, 32286, 32352, 32413, 32470, 32522, 32568,
+    32610, 32647, 32679, 32706, 32729, 32746, 32758, 32766, 32767,
+};
+
+#if !SIGNAL_QUALITY_CMSIS
+// Index of a complex point in bit-reversed order (8 bits, 256 points)
+static inline uint8_t bitReverse(uint8_t value) {
+    value = (uint8_t)((value & 0xF0) >> 4 | (value & 0x0F) << 4);
+    value = (uint8_t)((value & 0xCC) >> 2 | (value & 0x33) << 2);
+    return (uint8_t)((value & 0xAA) >> 1 | (value & 0x55) << 1);
+}
+#endif
+
+SignalQuality::SignalQuality() {
+    memset(&_report, 0, sizeof(_report));
+    memset(_power, 0, sizeof(_power));
+    _analyses = 0;
+    begin(250);
+}
+
+void SignalQuality::begin(uint16_t sampleRateHz) {
+    const uint16_t rate = sampleRateHz < 100 ? 100 : sampleRateHz > 500 ? 500 : sampleRateHz;
+    _decimation = rate > MAX_ANALYSIS_RATE ? 2 : 1;
+    _analysisRate = rate / _decimation;
+    restart();
+}
+
+void SignalQuality::restart() {
+    _phase = 0;
+    _pairSum = 0;
+    _fill = 0;
+    _blockReady = false;
+    _step = 0;
+}
+
+bool SignalQuality::addSample(int16_t sample) {
+    int16_t value = sample;
+    if (_decimation == 2) {
+        if (_phase == 0) {
+            _pairSum = sample;
+            _phase = 1;
+            return false;
+        }
+        value = (int16_t)((_pairSum + sample) >> 1);
+        _phase = 0;
+    }
+
+    if (_blockReady) return false;  // The previous block is not copied out yet
+    _input[_fill++] = value;
+    if (_fill < FFT_SIZE) return false;
+    _blockReady = true;
+    return true;
+}
+
+bool SignalQuality::step() {
+    if (_step == 0) {
+        if (!_blockReady) return false;
+        prepare();
+        _fill = 0;  // _input is free again: the next block starts now
+        _blockReady = false;
+        _step = 1;
+        return false;
+    }
+
+#if SIGNAL_QUALITY_CMSIS
+    if (_step == 1) {
+        arm_cfft_q15(&arm_cfft_sR_q15_len256, _work, 0, 1);  // Radix-4, scaled by 1/256 as below
+        _step = STAGES + 1;
+        return false;
+    }
+#else
+    if (_step <= STAGES) {
+        butterflies(_step - 1);
+        _step++;
+        return false;
+    }
+#endif
+
+    spectrum();
+    analyse();
+    _analyses++;
+    _step = 0;
+    return true;
+}
+
+int16_t SignalQuality::sinQ15(uint16_t k) {
+    k &= FFT_SIZE - 1;
+    const uint16_t quarter = FFT_SIZE / 4;
+    if (k <= quarter) return SINE_TABLE[k];
+    if (k <= 2 * quarter) return SINE_TABLE[2 * quarter - k];
+    if (k <= 3 * quarter) return (int16_t)-SINE_TABLE[k - 2 * quarter];
+    return (int16_t)-SINE_TABLE[FFT_SIZE - k];
+}
+
+// Mean removal, block scaling, Hann window, and even/odd samples packed as
+// re/im of the complex input (bit-reversed for the radix-2 stages)
+void SignalQuality::prepare() {
+    int32_t sum = 0;
+    int16_t low = _input[0];
+    int16_t high = _input[0];
+    for (uint16_t n = 0; n < FFT_SIZE; n++) {
+        sum += _input[n];
+        if (_input[n] < low) low = _input[n];
+        if (_input[n] > high) high = _input[n];
+    }
+    const int16_t mean = (int16_t)(sum / (int32_t)FFT_SIZE);
+    _peakToPeak = (uint16_t)(high - low);
+
+    // Largest deviation to just below 2^14: headroom for the window and the FFT
+    const int32_t deviation = (high - mean) > (mean - low) ? high - mean : mean - low;
+    uint8_t shift = 0;
+    while (deviation != 0 && shift < 14 && (deviation << (shift + 1)) < 16384) shift++;
+
+    for (uint16_t n = 0; n < FFT_SIZE; n++) {
+        const int32_t hann = (32768 - cosQ15(n)) >> 1;
+        const int32_t x = ((int32_t)(_input[n] - mean) << shift) * hann >> 15;
+#if SIGNAL_QUALITY_CMSIS
+        const uint16_t point = n >> 1;
+#else
+        const uint16_t point = bitReverse((uint8_t)(n >> 1));
+#endif
+        _work[2 * point + (n & 1)] = (int16_t)x;
+    }
+}
+
+#if !SIGNAL_QUALITY_CMSIS
+// One radix-2 decimation-in-time stage, halved to stay in range (1/256 over all stages)
+void SignalQuality::butterflies(uint8_t stage) {
+    const uint16_t half = 1U << stage;
+    const uint16_t span = half << 1;
+    const uint16_t twiddleStep = (FFT_SIZE / span);  // W_span^j = W_512^(j * 512 / span)
+
+    for (uint16_t j = 0; j < half; j++) {
+        const int32_t c = cosQ15(j * twiddleStep);
+        const int32_t s = sinQ15(j * twiddleStep);
+        for (uint16_t a = j; a < POINTS; a += span) {
+            int16_t* x = &_work[2 * a];
+            int16_t* y = &_work[2 * (a + half)];
+            // y * (c - js)
+            const int32_t tr = ((int32_t)y[0] * c + (int32_t)y[1] * s) >> 15;
+            const int32_t ti = ((int32_t)y[1] * c - (int32_t)y[0] * s) >> 15;
+            const int32_t xr = x[0];
+            const int32_t xi = x[1];
+            x[0] = (int16_t)((xr + tr) >> 1);
+            x[1] = (int16_t)((xi + ti) >> 1);
+            y[0] = (int16_t)((xr - tr) >> 1);
+            y[1] = (int16_t)((xi - ti) >> 1);
+        }
+    }
+}
+#else
+void SignalQuality::butterflies(uint8_t) {}
+#endif
+
+// Split the 256-point complex spectrum Z into the 257 bins of the real input:
+// 2X[k] = (Z[k] + Z*[M-k]) - j W^k (Z[k] - Z*[M-k]), W = e^(-j 2 pi / 512)
+void SignalQuality::spectrum() {
+    for (uint16_t k = 0; k <= POINTS; k++) {
+        const uint16_t a = k == POINTS ? 0 : k;
+        const uint16_t b = k == 0 ? 0 : POINTS - k;
+        const int32_t zkr = _work[2 * a];
+        const int32_t zki = _work[2 * a + 1];
+        const int32_t zmr = _work[2 * b];
+        const int32_t zmi = _work[2 * b + 1];
+
+        const int32_t er = zkr + zmr;
+        const int32_t ei = zki - zmi;
+        const int32_t orr = zkr - zmr;
+        const int32_t oi = zki + zmi;
+        const int32_t c = cosQ15(k);
+        const int32_t s = sinQ15(k);
+
+        const int32_t xr = er + ((oi * c - orr * s) >> 15);
+        const int32_t xi = ei - ((orr * c + oi * s) >> 15);
+        _power[k] = (uint32_t)(((int64_t)xr * xr + (int64_t)xi * xi) >> 4);
+    }
+}
+
+uint16_t SignalQuality::binOf(uint16_t hz) const {
+    const uint32_t bin = ((uint32_t)hz * FFT_SIZE + _analysisRate / 2) / _analysisRate;
+    return (uint16_t)(bin > POINTS ? POINTS : bin);
+}
+
+uint64_t SignalQuality::bandSum(uint16_t fromBin, uint16_t toBin) const {
+    uint64_t sum = 0;
+    for (uint16_t k = fromBin; k <= toBin && k <= POINTS; k++) sum += _power[k];
+    return sum;
+}
+
+uint8_t SignalQuality::percent(uint64_t part, uint64_t total) const {
+    if (total == 0) return 0;
+    const uint64_t value = (part * 100 + total / 2) / total;
+    return (uint8_t)(value > 100 ? 100 : value);
+}
+
+void SignalQuality::analyse() {
+    memset(&_report, 0, sizeof(_report));
+    _report.mainsHz = 50;
+    if (_peakToPeak < FLAT_COUNTS) {
+        _report.flags = FLAG_FLAT;
+        return;
+    }
+
+    const uint16_t nyquist = _analysisRate / 2;
+    const uint16_t baselineTop = (uint16_t)(FFT_SIZE / _analysisRate);  // Last bin below 1 Hz
+    const uint16_t ecgTop = binOf(40);
+    const uint64_t total = bandSum(1, POINTS);
+    const uint64_t baseline = bandSum(1, baselineTop);
+    const uint64_t ecg = bandSum(baselineTop + 1, ecgTop);
+
+    const uint64_t mains50 = nyquist > 51 ? bandSum(binOf(49), binOf(51)) : 0;
+    const uint64_t mains60 = nyquist > 61 ? bandSum(binOf(59), binOf(61)) : 0;
+    uint64_t emg = bandSum(ecgTop + 1, binOf(100));
+    emg = emg > mains50 + mains60 ? emg - mains50 - mains60 : 0;
+
+    const uint64_t mains = mains60 > mains50 ? mains60 : mains50;
+    _report.mainsHz = mains60 > mains50 ? 60 : 50;
+    _report.mains = percent(mains, total);
+    _report.baseline = percent(baseline, total);
+    _report.emg = percent(emg, total);
+    _report.index = percent(ecg, total);
+
+    if (_report.mains >= MAINS_LIMIT) _report.flags |= FLAG_MAINS;
+    if (_report.baseline >= BASELINE_LIMIT) _report.flags |= FLAG_BASELINE;
+    if (_report.emg >= EMG_LIMIT) _report.flags |= FLAG_EMG;
+}
+
+uint32_t SignalQuality::getBandPower(uint16_t fromHz, uint16_t toHz) const {
+    const uint64_t sum = bandSum(binOf(fromHz), binOf(toHz));
+    return sum > 0xFFFFFFFFULL ? 0xFFFFFFFFUL : (uint32_t)sum;
+}
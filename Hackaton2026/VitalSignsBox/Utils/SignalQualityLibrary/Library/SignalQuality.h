@@ -0,0 +1,136 @@
+/*
+    SignalQuality.h
+
+    ECG signal quality from the spectrum of one lead, on the module
+
+    Collects FFT_SIZE samples of a lead (about 2 s), removes the mean,
+    applies a Hann window and takes a fixed-point real FFT: the 512 real
+    samples are packed into 256 complex values, transformed and split
+    into 257 bins. The band powers give the share of the signal power in
+
+      - the mains bands (50 and 60 Hz, +/- 1 Hz)
+      - baseline wander (below 1 Hz: breathing, electrode motion)
+      - the EMG band (40-100 Hz without the mains bands: muscle noise)
+      - the ECG band (1-40 Hz), which is the quality index
+
+    so the hub gets one byte per analysis instead of the raw stream.
+
+    The work is split in steps of a few hundred microseconds (window and
+    packing, one step per FFT stage, the spectrum), one per step() call,
+    so it fits in the idle time of loop() next to the sampling. With
+    CMSIS-DSP (ARM_MATH_CM0PLUS or another ARM_MATH_ core defined, as
+    arm_math.h requires) the FFT is one arm_cfft_q15() call (radix-4);
+    otherwise a portable radix-2 transform with the same scaling.
+
+    Rates above 250 Hz are averaged in pairs first (500 Hz -> 250 Hz),
+    which keeps the 2 s window and costs 0.4 dB at 50 Hz.
+*/
+
+#ifndef SIGNAL_QUALITY_H
+#define SIGNAL_QUALITY_H
+
+#include <stdint.h>
+
+#if defined(ARM_MATH_CM0PLUS) || defined(ARM_MATH_CM0) || defined(ARM_MATH_CM3) \
+    || defined(ARM_MATH_CM4) || defined(ARM_MATH_CM7)
+#define SIGNAL_QUALITY_CMSIS 1
+#else
+#define SIGNAL_QUALITY_CMSIS 0
+#endif
+
+struct SignalQualityReport {
+    uint8_t index;     // % of the power in the ECG band (1-40 Hz); 0 = flat or no analysis yet
+    uint8_t flags;     // SignalQuality::FLAG_...
+    uint8_t mains;     // % at 50 or 60 Hz, the stronger of the two
+    uint8_t baseline;  // % below 1 Hz
+    uint8_t emg;       // % from 40 to 100 Hz, without mains
+    uint8_t mainsHz;   // 50 or 60 (the stronger band), 0 = no analysis yet
+};
+
+class SignalQuality {
+public:
+    static const uint16_t FFT_SIZE = 512;      // Real samples per analysis
+    static const uint16_t MAX_ANALYSIS_RATE = 250;
+
+    // Bits of SignalQualityReport::flags
+    static const uint8_t FLAG_MAINS = 0x01;     // Mains share >= MAINS_LIMIT
+    static const uint8_t FLAG_BASELINE = 0x02;  // Baseline share >= BASELINE_LIMIT
+    static const uint8_t FLAG_EMG = 0x04;       // EMG share >= EMG_LIMIT
+    static const uint8_t FLAG_FLAT = 0x08;      // Peak-to-peak below FLAT_COUNTS: shorted or open lead
+
+    static const uint8_t MAINS_LIMIT = 20;      // %
+    static const uint8_t BASELINE_LIMIT = 30;   // %
+    static const uint8_t EMG_LIMIT = 20;        // %
+    static const uint16_t FLAT_COUNTS = 4;      // ADC counts
+
+    SignalQuality();
+
+    /**
+     * Reset and set the rate of the samples passed to addSample()
+     * Discards a block in progress; the report keeps its last value
+     * @param sampleRateHz Samples per second (100-500 Hz)
+     */
+    void begin(uint16_t sampleRateHz);
+
+    /**
+     * Add the next sample of the lead, e.g. lead II = LL - RA
+     * Samples are dropped while a full block waits for its first step()
+     * @return true if this sample completed a block
+     */
+    bool addSample(int16_t sample);
+
+    /**
+     * Do the next piece of the analysis; call it in the idle time of loop()
+     * @return true when a new report is ready
+     */
+    bool step();
+
+    /**
+     * Drop the block in progress, e.g. after a lead came off
+     */
+    void restart();
+
+    const SignalQualityReport& getReport() const { return _report; }
+    uint8_t getIndex() const { return _report.index; }
+
+    // Completed analyses (wraps)
+    uint16_t getAnalysisCount() const { return _analyses; }
+
+    // Power in the bins of [fromHz, toHz] of the last spectrum, for tests and tuning
+    uint32_t getBandPower(uint16_t fromHz, uint16_t toHz) const;
+
+private:
+    static const uint16_t POINTS = FFT_SIZE / 2;  // Complex FFT length
+    static const uint8_t STAGES = 8;              // log2(POINTS)
+    static const uint16_t BINS = POINTS + 1;
+
+    static int16_t sinQ15(uint16_t k);            // sin(2 pi k / FFT_SIZE)
+    static int16_t cosQ15(uint16_t k) { return sinQ15(k + FFT_SIZE / 4); }
+
+    void prepare();
+    void butterflies(uint8_t stage);
+    void spectrum();
+    void analyse();
+    uint16_t binOf(uint16_t hz) const;
+    uint64_t bandSum(uint16_t fromBin, uint16_t toBin) const;
+    uint8_t percent(uint64_t part, uint64_t total) const;
+
+    uint16_t _analysisRate;
+    uint8_t _decimation;     // 1 or 2
+    uint8_t _phase;          // Samples in the current pair
+    int32_t _pairSum;
+
+    int16_t _input[FFT_SIZE];
+    uint16_t _fill;
+    bool _blockReady;
+    uint16_t _peakToPeak;    // Of the block being analysed
+
+    int16_t _work[2 * POINTS];  // Complex FFT in place: re, im
+    uint32_t _power[BINS];      // |X[k]|^2 of the last spectrum, scaled
+    uint8_t _step;
+
+    SignalQualityReport _report;
+    uint16_t _analyses;
+};
+
+#endif // SIGNAL_QUALITY_H
@@ -0,0 +1,42 @@
+#include "SignalQuality.h"
+
+/*
+    Sample lead II (A1 = LL, A3 = RA) at 250 Hz and print the signal
+    quality report every 512 samples (about 2 s).
+*/
+
+#define SAMPLE_RATE 250
+#define SAMPLE_PERIOD_US (1000000UL / SAMPLE_RATE)
+
+SignalQuality quality;
+unsigned long lastSample = 0;
+
+void setup() {
+  Serial.begin(115200);
+  quality.begin(SAMPLE_RATE);
+  lastSample = micros();
+}
+
+void loop() {
+  if (micros() - lastSample >= SAMPLE_PERIOD_US) {
+    lastSample += SAMPLE_PERIOD_US;
+    quality.addSample((int16_t)(analogRead(A1) - analogRead(A3)));
+  }
+
+  // One piece of the analysis per pass, between the samples
+  if (!quality.step()) return;
+
+  const SignalQualityReport& report = quality.getReport();
+  Serial.print("quality ");
+  Serial.print(report.index);
+  Serial.print("% mains ");
+  Serial.print(report.mains);
+  Serial.print("% @ ");
+  Serial.print(report.mainsHz);
+  Serial.print(" Hz, baseline ");
+  Serial.print(report.baseline);
+  Serial.print("%, EMG ");
+  Serial.print(report.emg);
+  Serial.print("%, flags 0x");
+  Serial.println(report.flags, HEX);
+}
@@ -0,0 +1,85 @@
+/*
+    Telemetry.cpp
+
+    Non-blocking, rate-limited binary telemetry implementation
+*/
+
+#include "Telemetry.h"
+
+Telemetry::Telemetry(Print& port)
+    : _port(port)
+    , _head(0)
+    , _tail(0)
+    , _dropped(0)
+{
+    for (uint8_t i = 0; i < MAX_TYPES; i++) {
+        _minInterval[i] = 0;
+        _lastSent[i] = 0;
+    }
+}
+
+void Telemetry::setMinInterval(uint8_t type, uint16_t intervalMs) {
+    if (type < MAX_TYPES) {
+        _minInterval[type] = intervalMs;
+    }
+}
+
+bool Telemetry::send(uint8_t type, const uint8_t* payload, uint8_t length) {
+    if (type >= MAX_TYPES || length > MAX_PAYLOAD) {
+        return false;
+    }
+
+    const unsigned long now = millis();
+    if (_minInterval[type] != 0 && now - _lastSent[type] < _minInterval[type]) {
+        return false;  // Rate limited: not an error, not counted
+    }
+
+    if (freeSpace() < (uint16_t)length + 4) {
+        _dropped++;
+        return false;
+    }
+    _lastSent[type] = now;
+
+    uint8_t checksum = type ^ length;
+    put(SYNC);
+    put(type);
+    put(length);
+    for (uint8_t i = 0; i < length; i++) {
+        put(payload[i]);
+        checksum ^= payload[i];
+    }
+    put(checksum);
+    return true;
+}
+
+void Telemetry::drain() {
+    int room = _port.availableForWrite();
+    while (room > 0 && _tail != _head) {
+        // Write the contiguous part in one call
+        const uint16_t end = (_head > _tail) ? _head : RING_SIZE;
+        uint16_t chunk = end - _tail;
+        if (chunk > (uint16_t)room) {
+            chunk = room;
+        }
+        _port.write(&_ring[_tail], chunk);
+        _tail = (_tail + chunk) & (RING_SIZE - 1);
+        room -= chunk;
+    }
+}
+
+uint16_t Telemetry::getDropped() const {
+    return _dropped;
+}
+
+uint16_t Telemetry::getUsed() const {
+    return (_head - _tail) & (RING_SIZE - 1);
+}
+
+uint16_t Telemetry::freeSpace() const {
+    return (RING_SIZE - 1) - ((_head - _tail) & (RING_SIZE - 1));
+}
+
+void Telemetry::put(uint8_t value) {
+    _ring[_head] = value;
+    _head = (_head + 1) & (RING_SIZE - 1);
+}
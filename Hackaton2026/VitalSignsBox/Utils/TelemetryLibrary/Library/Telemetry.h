@@ -0,0 +1,78 @@
+/*
+    Telemetry.h
+
+    Non-blocking, rate-limited binary telemetry
+
+    send() copies a compact record into a RAM ring and returns at once;
+    drain() hands bytes to the serial port only as far as its TX buffer has
+    room, so the UART interrupt does the actual sending and loop() never
+    waits. Switching diagnostics on does not change the loop timing.
+
+    Record: 0xA5, type, length, payload[length], checksum (XOR of type,
+    length and payload). Records that do not fit or come too soon after
+    the previous one of the same type are dropped and counted.
+*/
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <Arduino.h>
+
+class Telemetry {
+public:
+    static const uint8_t SYNC = 0xA5;
+    static const uint16_t RING_SIZE = 256;   // Power of two
+    static const uint8_t MAX_TYPES = 8;
+    static const uint8_t MAX_PAYLOAD = 32;
+
+    /**
+     * Constructor
+     * @param port Serial port to drain into (must report availableForWrite())
+     */
+    explicit Telemetry(Print& port);
+
+    /**
+     * Limit how often records of one type are queued
+     * @param type Record type (0 .. MAX_TYPES-1)
+     * @param intervalMs Minimum time between two records, 0 = no limit
+     */
+    void setMinInterval(uint8_t type, uint16_t intervalMs);
+
+    /**
+     * Queue a record
+     * @return false if dropped (rate limit, ring full or too long)
+     */
+    bool send(uint8_t type, const uint8_t* payload, uint8_t length);
+
+    /**
+     * Move queued bytes into the serial TX buffer without blocking
+     * Call this regularly in loop()
+     */
+    void drain();
+
+    /**
+     * Get number of records dropped because the ring was full
+     * @return Dropped record count
+     */
+    uint16_t getDropped() const;
+
+    /**
+     * Get number of bytes queued and not yet handed to the serial port
+     * @return Ring fill level (at most RING_SIZE - 1)
+     */
+    uint16_t getUsed() const;
+
+private:
+    uint16_t freeSpace() const;
+    void put(uint8_t value);
+
+    Print& _port;
+    uint8_t _ring[RING_SIZE];
+    uint16_t _head;
+    uint16_t _tail;
+    uint16_t _dropped;
+    uint16_t _minInterval[MAX_TYPES];
+    unsigned long _lastSent[MAX_TYPES];
+};
+
+#endif // TELEMETRY_H
@@ -0,0 +1,161 @@
+/*
+    TraceLog.h
+
+    Deferred-format diagnostics on top of Telemetry
+
+    TRACE(trace, "raw %u, led %u", raw, led) does not format anything on
+    the board and does not store the text: the format string is reduced to
+    a 16-bit ID at compile time (FNV-1a), and only the ID plus the raw
+    argument bytes are queued as a Telemetry record. The host tool
+    Utils/TraceLog/tracelog.py finds every TRACE() in the sources, builds
+    the ID table (and reports ID collisions) and turns the records back
+    into text.
+
+    Record payload (type RECORD_TYPE): ID (16 bit big endian), then per
+    argument: integers as 32 bit big endian, float/double as 32-bit IEEE
+    big endian, strings as one length byte plus at most MAX_STRING bytes.
+    The number of arguments is checked against the format at compile time;
+    records whose arguments do not fit in one payload are dropped.
+*/
+
+#ifndef TRACE_LOG_H
+#define TRACE_LOG_H
+
+#include <Arduino.h>
+#include <string.h>
+#include "Telemetry.h"
+
+// Compile-time helpers (C++11 constexpr: one return statement each)
+constexpr uint32_t traceFnv(const char* s, uint32_t h) {
+    return *s == '\0' ? h : traceFnv(s + 1, (h ^ (uint8_t)*s) * 16777619UL);
+}
+
+constexpr uint16_t traceId(const char* format) {
+    return (uint16_t)((traceFnv(format, 2166136261UL) >> 16) ^ (traceFnv(format, 2166136261UL) & 0xFFFF));
+}
+
+// Conversions in the format ("%%" is a literal percent sign)
+constexpr uint8_t traceArgCount(const char* s) {
+    return *s == '\0' ? 0 :
+           (*s == '%' && s[1] == '%') ? traceArgCount(s + 2) :
+           (*s == '%') ? 1 + traceArgCount(s + 1) : traceArgCount(s + 1);
+}
+
+template <uint16_t ID>
+struct TraceIdConstant {
+    static const uint16_t value = ID;
+};
+
+// The tool looks for TRACE(<object>, "<format>" ...): keep the format a literal
+#define TRACE(log, format, ...) \
+    (log).write<traceArgCount(format)>(TraceIdConstant<traceId(format)>::value, ##__VA_ARGS__)
+
+class TraceLog {
+public:
+    static const uint8_t RECORD_TYPE = 7;
+    static const uint8_t MAX_STRING = 12;
+
+    /**
+     * Constructor
+     * @param telemetry Telemetry channel the records are queued on
+     * @param type Record type used for trace records
+     */
+    explicit TraceLog(Telemetry& telemetry, uint8_t type = RECORD_TYPE)
+        : _telemetry(telemetry), _type(type), _tooLong(0) {}
+
+    /**
+     * Queue one trace record; use the TRACE() macro instead of calling this
+     * @return false if Telemetry dropped it
+     */
+    template <uint8_t COUNT, typename... Args>
+    bool write(uint16_t id, Args... args) {
+        static_assert(COUNT == sizeof...(Args), "TRACE: argument count does not match the format");
+        uint8_t payload[Telemetry::MAX_PAYLOAD];
+        uint8_t length = 0;
+        put16(payload, length, id);
+        encode(payload, length, args...);
+        if (length == LENGTH_OVERFLOW) {
+            _tooLong++;  // Partial records would not decode
+            return false;
+        }
+        return _telemetry.send(_type, payload, length);
+    }
+
+    /**
+     * Get number of records dropped because the arguments did not fit
+     * @return Dropped record count
+     */
+    uint16_t getTooLong() const {
+        return _tooLong;
+    }
+
+private:
+    void encode(uint8_t*, uint8_t&) {}
+
+    template <typename First, typename... Rest>
+    void encode(uint8_t* payload, uint8_t& length, First first, Rest... rest) {
+        put(payload, length, first);
+        encode(payload, length, rest...);
+    }
+
+    // One overload per fundamental type: no <type_traits> on every core
+    void put(uint8_t* p, uint8_t& n, bool v) { putUnsigned(p, n, v); }
+    void put(uint8_t* p, uint8_t& n, char v) { putSigned(p, n, v); }
+    void put(uint8_t* p, uint8_t& n, signed char v) { putSigned(p, n, v); }
+    void put(uint8_t* p, uint8_t& n, unsigned char v) { putUnsigned(p, n, v); }
+    void put(uint8_t* p, uint8_t& n, short v) { putSigned(p, n, v); }
+    void put(uint8_t* p, uint8_t& n, unsigned short v) { putUnsigned(p, n, v); }
+    void put(uint8_t* p, uint8_t& n, int v) { putSigned(p, n, v); }
+    void put(uint8_t* p, uint8_t& n, unsigned int v) { putUnsigned(p, n, v); }
+    void put(uint8_t* p, uint8_t& n, long v) { putSigned(p, n, v); }
+    void put(uint8_t* p, uint8_t& n, unsigned long v) { putUnsigned(p, n, v); }
+    void put(uint8_t* p, uint8_t& n, float v) { putFloat(p, n, v); }
+    void put(uint8_t* p, uint8_t& n, double v) { putFloat(p, n, (float)v); }
+    void put(uint8_t* p, uint8_t& n, const char* v) { putString(p, n, v); }
+
+    void putSigned(uint8_t* p, uint8_t& n, int32_t v) { put32(p, n, (uint32_t)v); }
+    void putUnsigned(uint8_t* p, uint8_t& n, uint32_t v) { put32(p, n, v); }
+
+    void putFloat(uint8_t* p, uint8_t& n, float v) {
+        uint32_t bits;
+        memcpy(&bits, &v, sizeof(bits));
+        put32(p, n, bits);
+    }
+
+    void putString(uint8_t* p, uint8_t& n, const char* s) {
+        uint8_t length = (uint8_t)strnlen(s, MAX_STRING);
+        if (!fits(n, 1 + length)) return;
+        p[n++] = length;
+        memcpy(p + n, s, length);
+        n += length;
+    }
+
+    void put16(uint8_t* p, uint8_t& n, uint16_t v) {
+        if (!fits(n, 2)) return;
+        p[n++] = v >> 8;
+        p[n++] = v & 0xFF;
+    }
+
+    void put32(uint8_t* p, uint8_t& n, uint32_t v) {
+        if (!fits(n, 4)) return;
+        p[n++] = v >> 24;
+        p[n++] = (v >> 16) & 0xFF;
+        p[n++] = (v >> 8) & 0xFF;
+        p[n++] = v & 0xFF;
+    }
+
+    // Once an argument does not fit, n stays at LENGTH_OVERFLOW
+    static bool fits(uint8_t& n, uint8_t size) {
+        if (n != LENGTH_OVERFLOW && n + size <= Telemetry::MAX_PAYLOAD) return true;
+        n = LENGTH_OVERFLOW;
+        return false;
+    }
+
+    static const uint8_t LENGTH_OVERFLOW = 0xFF;
+
+    Telemetry& _telemetry;
+    uint8_t _type;
+    uint16_t _tooLong;
+};
+
+#endif // TRACE_LOG_H
@@ -0,0 +1,139 @@
+/*
+    TimeSync.cpp
+
+    Hub timebase implementation
+*/
+
+#include "TimeSync.h"
+
+// Critical section that is also safe inside an ISR (restores the old state)
+#if defined(__arm__)
+#define TS_LOCK() uint32_t tsPrimask = __get_PRIMASK(); __disable_irq()
+#define TS_UNLOCK() __set_PRIMASK(tsPrimask)
+#else
+#define TS_LOCK() uint8_t tsSreg = SREG; noInterrupts()
+#define TS_UNLOCK() SREG = tsSreg
+#endif
+
+uint8_t TimeSync::pack(uint8_t* frame, uint8_t sequence, uint32_t hubMicros) {
+    frame[0] = TIMESYNC_COMMAND;
+    frame[1] = sequence;
+    frame[2] = hubMicros >> 24;
+    frame[3] = (hubMicros >> 16) & 0xFF;
+    frame[4] = (hubMicros >> 8) & 0xFF;
+    frame[5] = hubMicros & 0xFF;
+    return TIMESYNC_FRAME_LENGTH;
+}
+
+TimeSync::TimeSync()
+    : _pending(false)
+    , _sequence(0)
+    , _rxHub(0)
+    , _rxLocal(0)
+    , _refLocal(0)
+    , _refHub(0)
+    , _drift(0)
+    , _state(UNSYNCED)
+    , _lastSequence(0)
+    , _latencyUs(TIMESYNC_LATENCY_US)
+    , _lastError(0)
+    , _syncs(0)
+    , _missed(0)
+{
+}
+
+void TimeSync::setLatency(uint16_t latencyUs) {
+    _latencyUs = latencyUs;
+}
+
+bool TimeSync::onFrame(const uint8_t* data, uint8_t length) {
+    const uint32_t local = micros();  // First: the stamp is the point of it
+    if (length != TIMESYNC_FRAME_LENGTH || data[0] != TIMESYNC_COMMAND) return false;
+
+    _rxLocal = local;
+    _rxHub = ((uint32_t)data[2] << 24) | ((uint32_t)data[3] << 16) | ((uint32_t)data[4] << 8) | data[5];
+    _sequence = data[1];
+    _pending = true;
+    return true;
+}
+
+bool TimeSync::update() {
+    if (!_pending) return false;
+
+    uint32_t local;
+    uint32_t hub;
+    uint8_t sequence;
+    {
+        TS_LOCK();
+        local = _rxLocal;
+        hub = _rxHub + _latencyUs;
+        sequence = _sequence;
+        _pending = false;
+        TS_UNLOCK();
+    }
+
+    _syncs++;
+    if (_state != UNSYNCED && sequence != (uint8_t)(_lastSequence + 1)) _missed++;
+    _lastSequence = sequence;
+
+    if (_state == UNSYNCED) {
+        commit(local, hub, 0, OFFSET);
+        return true;
+    }
+
+    const int32_t elapsed = (int32_t)(local - _refLocal);
+    const uint32_t predicted = toHub(local);
+    const int32_t error = (int32_t)(hub - predicted);
+    _lastError = error;
+
+    if (error > TIMESYNC_STEP_US || error < -TIMESYNC_STEP_US || elapsed <= 0) {
+        _missed++;
+        commit(local, hub, 0, OFFSET);
+        return true;
+    }
+
+    // Frequency: the error accumulated over 'elapsed'; a quarter of it per sync
+    const int32_t correction = (int32_t)(((int64_t)error << TIMESYNC_DRIFT_SHIFT) / elapsed);
+
+    // Phase: halfway, so one late sync does not jump the timeline
+    commit(local, predicted + error / 2, _drift + correction / 4, LOCKED);
+    return true;
+}
+
+// The only writer of the estimate: toHub() in an interrupt sees all or nothing
+void TimeSync::commit(uint32_t local, uint32_t hub, int32_t drift, State state) {
+    TS_LOCK();
+    _refLocal = local;
+    _refHub = hub;
+    _drift = drift;
+    _state = state;
+    TS_UNLOCK();
+}
+
+uint32_t TimeSync::toHub(uint32_t localMicros) const {
+    if (_state == UNSYNCED) return localMicros;
+
+    // Signed: a sample can be older than the last sync
+    const int32_t dt = (int32_t)(localMicros - _refLocal);
+    return _refHub + dt + (int32_t)(((int64_t)dt * _drift) >> TIMESYNC_DRIFT_SHIFT);
+}
+
+TimeSync::State TimeSync::getState() const {
+    return _state;
+}
+
+int32_t TimeSync::getDriftPpm() const {
+    return (int32_t)(((int64_t)_drift * 1000000) >> TIMESYNC_DRIFT_SHIFT);
+}
+
+int32_t TimeSync::getLastError() const {
+    return _lastError;
+}
+
+uint16_t TimeSync::getSyncCount() const {
+    return _syncs;
+}
+
+uint16_t TimeSync::getMissed() const {
+    return _missed;
+}
@@ -0,0 +1,104 @@
+/*
+    TimeSync.h
+
+    Hub timebase for the VitalSignsBox modules
+
+    The hub broadcasts its micros() with an I2C general call (address
+    0x00) about once a second (HubScheduler::setTimeSync()). A module
+    stamps every sync with its own micros() on arrival and keeps an offset
+    and drift estimate, so any local micros() value, e.g. the time a
+    sample was taken, converts to hub time. Samples from different modules
+    then line up on one timeline without oversampling.
+
+    The interrupt only stores the received pair; update() in loop() folds
+    it into the estimate (a phase and frequency loop: half of the error
+    corrects the offset, a quarter of it per elapsed time the drift).
+    toHub() is safe in loop() and in interrupts.
+
+    Sync frame: TIMESYNC_COMMAND, sequence (+1 per sync), hub micros()
+    (32 bit big endian) taken just before the write starts.
+*/
+
+#ifndef TIME_SYNC_H
+#define TIME_SYNC_H
+
+#include <Arduino.h>
+
+#define TIMESYNC_COMMAND 0xF4       // First byte: above every register map
+#define TIMESYNC_FRAME_LENGTH 6
+#define TIMESYNC_LATENCY_US 630     // Write start to STOP at 100 kHz: 7 bytes of 9 bits
+#define TIMESYNC_STEP_US 5000       // Larger errors restart the estimate (hub reset, long gap)
+#define TIMESYNC_DRIFT_SHIFT 24     // Drift in 2^-24 (0.06 ppm)
+
+class TimeSync {
+public:
+    enum State : uint8_t {
+        UNSYNCED = 0,  // No sync yet: toHub() returns the local time
+        OFFSET,        // One sync: offset known, drift not yet
+        LOCKED         // Offset and drift tracked
+    };
+
+    /**
+     * Hub side: build a sync frame
+     * @param frame At least TIMESYNC_FRAME_LENGTH bytes
+     * @return Frame length
+     */
+    static uint8_t pack(uint8_t* frame, uint8_t sequence, uint32_t hubMicros);
+
+    TimeSync();
+
+    /**
+     * Time from the hub's micros() to the module's receive interrupt
+     * (default TIMESYNC_LATENCY_US, for 100 kHz)
+     */
+    void setLatency(uint16_t latencyUs);
+
+    /**
+     * Module side, from the I2C receive interrupt (e.g. the command
+     * handler of I2CRegisterSlave); stamps the frame with micros()
+     * @return false if it is not a sync frame
+     */
+    bool onFrame(const uint8_t* data, uint8_t length);
+
+    /**
+     * Fold a received sync into the estimate; call every loop()
+     * @return true if a sync was used
+     */
+    bool update();
+
+    /**
+     * Local micros() to hub micros(); the local time itself while UNSYNCED
+     */
+    uint32_t toHub(uint32_t localMicros) const;
+    uint32_t now() const { return toHub(micros()); }
+
+    State getState() const;
+    int32_t getDriftPpm() const;     // Local clock against the hub, + = local runs slow
+    int32_t getLastError() const;    // Last sync minus the prediction, us
+    uint16_t getSyncCount() const;
+    uint16_t getMissed() const;      // Sequence gaps and restarts
+
+private:
+    void commit(uint32_t local, uint32_t hub, int32_t drift, State state);
+
+    // Written by onFrame() in the interrupt
+    volatile bool _pending;
+    volatile uint8_t _sequence;
+    volatile uint32_t _rxHub;
+    volatile uint32_t _rxLocal;
+
+    // Estimate: hub = refHub + dt + dt * drift, dt = local - refLocal.
+    // Only update() writes it, under a lock
+    uint32_t _refLocal;
+    uint32_t _refHub;
+    int32_t _drift;
+    State _state;
+
+    uint8_t _lastSequence;
+    uint16_t _latencyUs;
+    int32_t _lastError;
+    uint16_t _syncs;
+    uint16_t _missed;
+};
+
+#endif // TIME_SYNC_H
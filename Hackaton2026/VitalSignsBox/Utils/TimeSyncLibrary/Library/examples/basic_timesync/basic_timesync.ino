@@ -0,0 +1,55 @@
+#include <Wire.h>
+#include "I2CRegisterSlave.h"
+#include "TimeSync.h"
+
+/*
+    Module side: follow the hub timebase and publish the hub time of the
+    latest A1 sample. Every second print the sync state and the drift.
+    The hub sends the syncs with HubScheduler::setTimeSync().
+*/
+
+#define MODULE_ADDR 0x30
+#define REG_VALUE 0x00        // 16 bit
+#define REG_SAMPLE_TIME 0x02  // 32 bit, hub time in us of VALUE
+#define REGISTER_COUNT 6
+
+I2CRegisterSlave registers(&Wire, REGISTER_COUNT);
+TimeSync timeSync;
+unsigned long lastSample = 0;
+unsigned long lastReport = 0;
+
+// I2C interrupt: stamp the sync, loop() does the math
+void onCommand(const uint8_t* data, uint8_t length) {
+  if (data[0] == TIMESYNC_COMMAND) timeSync.onFrame(data, length);
+}
+
+void setup() {
+  Serial.begin(115200);
+  registers.onCommand(onCommand);
+  registers.begin(MODULE_ADDR);
+#if I2C_SLAVE_SERCOM
+  registers.enableGeneralCall(SERCOM3);  // Wire on the Zero variant
+#endif
+}
+
+void loop() {
+  timeSync.update();
+
+  if (micros() - lastSample >= 10000) {  // 100 Hz
+    lastSample += 10000;
+    const uint32_t sampledAt = micros();
+    registers.set16(REG_VALUE, analogRead(A1));
+    registers.set32(REG_SAMPLE_TIME, timeSync.toHub(sampledAt));
+    registers.publish();
+  }
+
+  if (millis() - lastReport < 1000) return;
+  lastReport = millis();
+  Serial.print("state ");
+  Serial.print(timeSync.getState());
+  Serial.print(", error ");
+  Serial.print(timeSync.getLastError());
+  Serial.print(" us, drift ");
+  Serial.print(timeSync.getDriftPpm());
+  Serial.println(" ppm");
+}
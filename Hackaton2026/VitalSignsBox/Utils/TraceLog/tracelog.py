@@ -0,0 +1,197 @@
+#!/usr/bin/env python3
+"""
+tracelog.py - ID table and decoder for TraceLog records
+
+The firmware sends TRACE(...) calls as Telemetry records holding only a
+16-bit format ID and the raw arguments (see TraceLog.h). This tool
+finds the format strings in the sources and turns the records back into
+text.
+
+    # Build the ID table (fails on ID collisions)
+    tracelog.py ids ../../SpO2Detection/FirmwareSpO2Detect -o spo2.json
+
+    # Decode a serial port (needs pyserial) or a captured file
+    tracelog.py decode --table spo2.json --port /dev/ttyACM0
+    tracelog.py decode --sources ../../ECGLeadDetection/FirmwareECGLeadDetect capture.bin
+
+Other Telemetry records are printed as type plus hex payload.
+"""
+
+import argparse
+import json
+import os
+import re
+import struct
+import sys
+
+SYNC = 0xA5
+TRACE_TYPE = 7
+
+# TRACE(<object>, "<format>" ...); adjacent literals are not supported
+TRACE_CALL = re.compile(r'TRACE\s*\(\s*[\w.\->]+\s*,\s*"((?:[^"\\]|\\.)*)"')
+CONVERSION = re.compile(r'%(?:%|[-+ #0]*\d*(?:\.\d+)?(?:hh|h|ll|l|z)?([diuxXocfFeEgGs]))')
+SOURCE_SUFFIXES = ('.ino', '.cpp', '.h', '.hpp')
+
+
+def fnv1a(data):
+    h = 2166136261
+    for b in data:
+        h = ((h ^ b) * 16777619) & 0xFFFFFFFF
+    return h
+
+
+def trace_id(fmt):
+    """Same as traceId() in TraceLog.h: 32-bit FNV-1a folded to 16 bits"""
+    h = fnv1a(fmt.encode('latin-1'))
+    return ((h >> 16) ^ (h & 0xFFFF)) & 0xFFFF
+
+
+def unescape(literal):
+    """C string literal body -> the characters the compiler hashes"""
+    return literal.encode('latin-1').decode('unicode_escape')
+
+
+def scan(paths):
+    """Map ID -> format for every TRACE() below paths"""
+    table = {}
+    for path in paths:
+        files = [path] if os.path.isfile(path) else [
+            os.path.join(root, name)
+            for root, _, names in os.walk(path) for name in sorted(names)
+            if name.endswith(SOURCE_SUFFIXES)]
+        for name in files:
+            with open(name, encoding='latin-1') as source:
+                text = source.read()
+            if '#define TRACE(' in text:
+                continue  # TraceLog.h itself (examples in comments)
+            for match in TRACE_CALL.finditer(text):
+                fmt = unescape(match.group(1))
+                ident = trace_id(fmt)
+                if ident in table and table[ident] != fmt:
+                    raise SystemExit('ID collision 0x%04x: "%s" and "%s" - reword one of them'
+                                     % (ident, table[ident], fmt))
+                table[ident] = fmt
+    return table
+
+
+def format_record(table, payload):
+    if len(payload) < 2:
+        return '<short trace record>'
+    ident = (payload[0] << 8) | payload[1]
+    fmt = table.get(ident)
+    if fmt is None:
+        return '<unknown trace 0x%04x: %s>' % (ident, payload[2:].hex())
+
+    args = []
+    pos = 2
+    for match in CONVERSION.finditer(fmt):
+        kind = match.group(1)
+        if kind is None:
+            continue  # %%
+        if kind == 's':
+            length = payload[pos]
+            args.append(payload[pos + 1:pos + 1 + length].decode('latin-1'))
+            pos += 1 + length
+            continue
+        raw = payload[pos:pos + 4]
+        pos += 4
+        if kind in 'fFeEgG':
+            args.append(struct.unpack('>f', raw)[0])
+        elif kind in 'di':
+            args.append(struct.unpack('>i', raw)[0])
+        elif kind == 'c':
+            args.append(chr(struct.unpack('>I', raw)[0] & 0xFF))
+        else:
+            args.append(struct.unpack('>I', raw)[0])
+    # Python's % understands the C conversions, minus the length modifiers
+    return re.sub(r'(%[-+ #0]*\d*(?:\.\d+)?)(?:hh|h|ll|l|z)', r'\1', fmt) % tuple(args)
+
+
+def records(stream, live=False):
+    """Yield (type, payload) for every record with a valid checksum"""
+    buffer = bytearray()
+    while True:
+        chunk = stream.read(256)
+        if not chunk:
+            if live:
+                continue  # Serial timeout, keep the partial record
+            return
+        buffer.extend(chunk)
+        while True:
+            start = buffer.find(SYNC)
+            if start < 0:
+                buffer.clear()
+                break
+            del buffer[:start]
+            if len(buffer) < 3 or len(buffer) < 4 + buffer[2]:
+                break
+            kind, length = buffer[1], buffer[2]
+            payload = bytes(buffer[3:3 + length])
+            checksum = kind ^ length
+            for b in payload:
+                checksum ^= b
+            if checksum != buffer[3 + length]:
+                del buffer[:1]  # Not a record start, resync
+                continue
+            del buffer[:4 + length]
+            yield kind, payload
+
+
+def open_input(args):
+    if args.port:
+        import serial  # pyserial, only needed for live decoding
+        return serial.Serial(args.port, args.baud, timeout=0.1)
+    if args.file in (None, '-'):
+        return sys.stdin.buffer
+    return open(args.file, 'rb')
+
+
+def main():
+    parser = argparse.ArgumentParser(description='TraceLog ID table and decoder')
+    sub = parser.add_subparsers(dest='command', required=True)
+
+    ids = sub.add_parser('ids', help='scan sources and write the ID table')
+    ids.add_argument('paths', nargs='+')
+    ids.add_argument('-o', '--output', default='-')
+
+    decode = sub.add_parser('decode', help='decode Telemetry records')
+    decode.add_argument('file', nargs='?', help='capture file (default: stdin)')
+    decode.add_argument('--table', help='ID table written by "ids"')
+    decode.add_argument('--sources', action='append', help='scan this source directory instead of a table (repeatable)')
+    decode.add_argument('--port', help='serial port to read live')
+    decode.add_argument('--baud', type=int, default=115200)
+    args = parser.parse_args()
+
+    if args.command == 'ids':
+        table = scan(args.paths)
+        text = json.dumps({'0x%04x' % k: v for k, v in sorted(table.items())}, indent=2)
+        if args.output == '-':
+            print(text)
+        else:
+            with open(args.output, 'w') as out:
+                out.write(text + '\n')
+            print('%d formats -> %s' % (len(table), args.output), file=sys.stderr)
+        return
+
+    if args.table:
+        with open(args.table) as f:
+            table = {int(k, 16): v for k, v in json.load(f).items()}
+    elif args.sources:
+        table = scan(args.sources)
+    else:
+        parser.error('decode needs --table or --sources')
+
+    stream = open_input(args)
+    try:
+        for kind, payload in records(stream, live=bool(args.port)):
+            if kind == TRACE_TYPE:
+                print(format_record(table, payload))
+            else:
+                print('[type %d] %s' % (kind, payload.hex()))
+            sys.stdout.flush()
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,110 @@
+/*
+    TraceRecorder.cpp
+
+    Trace rings and the dump frames
+*/
+
+#include "TraceRecorder.h"
+#include "Crc.h"
+
+TraceRecorder traceRecorder;
+
+// Little endian, the byte order of the events in RAM on all supported targets
+static uint8_t* putU16(uint8_t* out, uint16_t value) {
+    out[0] = value & 0xFF;
+    out[1] = value >> 8;
+    return out + 2;
+}
+
+static uint8_t* putU32(uint8_t* out, uint32_t value) {
+    out = putU16(out, value & 0xFFFF);
+    return putU16(out, value >> 16);
+}
+
+TraceRecorder::TraceRecorder()
+    : _running(false)
+{
+    clear();
+}
+
+void TraceRecorder::begin() {
+#if TRACE_RECORDER_CYCLES
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+    _running = true;
+}
+
+void TraceRecorder::clear() {
+    for (uint8_t core = 0; core < CORES; core++) {
+        _rings[core].written = 0;
+    }
+}
+
+uint32_t TraceRecorder::getWritten(uint8_t core) const {
+    return core < CORES ? _rings[core].written : 0;
+}
+
+uint16_t TraceRecorder::getCount(uint8_t core) const {
+    const uint32_t written = getWritten(core);
+    return written < CAPACITY ? (uint16_t)written : CAPACITY;
+}
+
+uint32_t TraceRecorder::getClockHz() const {
+#if TRACE_RECORDER_CYCLES
+    return SystemCoreClock;
+#else
+    return 1000000UL;
+#endif
+}
+
+void TraceRecorder::dump(Print& out) {
+    const bool wasRunning = _running;
+    _running = false;  // An ISR may still be inside record(): let it finish
+    delayMicroseconds(10);
+
+    uint8_t payload[1 + EVENTS_PER_FRAME * sizeof(TraceEvent)];
+    payload[0] = VERSION;
+    payload[1] = CORES;
+    putU32(payload + 2, getClockHz());
+    sendFrame(out, FRAME_HEADER, payload, 6);
+
+    for (uint8_t core = 0; core < CORES; core++) {
+        const Ring& ring = _rings[core];
+        const uint32_t written = ring.written;
+        const uint16_t count = getCount(core);
+
+        payload[0] = core;
+        putU16(putU32(payload + 1, written), count);
+        sendFrame(out, FRAME_STREAM, payload, 7);
+
+        // Oldest first
+        uint32_t index = written - count;
+        uint16_t left = count;
+        while (left > 0) {
+            const uint8_t chunk = left < EVENTS_PER_FRAME ? left : EVENTS_PER_FRAME;
+            uint8_t* p = payload + 1;
+            for (uint8_t i = 0; i < chunk; i++) {
+                const TraceEvent& event = ring.events[index++ & (CAPACITY - 1)];
+                p = putU16(putU16(putU32(p, event.timestamp), event.id), event.arg);
+            }
+            sendFrame(out, FRAME_EVENTS, payload, (uint8_t)(p - payload));
+            left -= chunk;
+        }
+    }
+
+    sendFrame(out, FRAME_END, payload, 0);
+    _running = wasRunning;
+}
+
+void TraceRecorder::sendFrame(Print& out, uint8_t type, const uint8_t* payload, uint8_t length) {
+    Crc8 crc;
+    crc.update(type).update(length).update(payload, length);
+
+    out.write(SYNC);
+    out.write(type);
+    out.write(length);
+    out.write(payload, length);
+    out.write(crc.value());
+}
@@ -0,0 +1,214 @@
+/*
+    TraceRecorder.h
+
+    Timestamped hot-path events in a RAM ring, for timing problems
+    between I2C interrupts, loop() and scheduler tasks
+
+    Every event is 8 bytes: timestamp, event id and a 16-bit argument.
+    TRACE_BEGIN / TRACE_END / TRACE_INSTANT / TRACE_COUNTER write one
+    event with interrupts locked for a few instructions, so they can be
+    used in ISRs as well as in tasks. Each core has its own ring (no
+    atomics between cores); the oldest events are overwritten, so the
+    ring always holds the last CAPACITY events (flight recorder).
+
+    The macros compile to nothing unless TRACE_RECORDER_ENABLED is
+    defined for the whole build (all libraries included), e.g.
+    build_flags = -DTRACE_RECORDER_ENABLED in PlatformIO. dump() sends
+    the rings as checked frames; trace_export.py turns them into a
+    Perfetto / Chrome trace or CTF.
+*/
+
+#ifndef TRACE_RECORDER_H
+#define TRACE_RECORDER_H
+
+#include <Arduino.h>
+#include <stdint.h>
+
+#if defined(ARDUINO_ARCH_RP2040)
+#include <pico/platform.h>  // get_core_num()
+#endif
+
+// Events per core, power of two
+#ifndef TRACE_RECORDER_EVENTS
+#if defined(__AVR__)
+#define TRACE_RECORDER_EVENTS 32
+#else
+#define TRACE_RECORDER_EVENTS 256
+#endif
+#endif
+
+#ifndef TRACE_RECORDER_CORES
+#if defined(ARDUINO_ARCH_RP2040)
+#define TRACE_RECORDER_CORES 2
+#else
+#define TRACE_RECORDER_CORES 1
+#endif
+#endif
+
+// Cycle counter on Cortex-M3/M4/M7, micros() elsewhere (SAMD21, AVR)
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__)
+#define TRACE_RECORDER_CYCLES 1
+#else
+#define TRACE_RECORDER_CYCLES 0
+#endif
+
+struct TraceEvent {
+    uint32_t timestamp;
+    uint16_t id;   // Kind (top 2 bits) | event number
+    uint16_t arg;
+};
+
+class TraceRecorder {
+public:
+    static const uint16_t CAPACITY = TRACE_RECORDER_EVENTS;
+    static const uint8_t CORES = TRACE_RECORDER_CORES;
+
+    // Kind, in the top two bits of the id
+    static const uint16_t INSTANT = 0x0000;
+    static const uint16_t BEGIN = 0x4000;
+    static const uint16_t END = 0x8000;
+    static const uint16_t COUNTER = 0xC000;  // arg is the value
+    static const uint16_t KIND_MASK = 0xC000;
+
+    // Event numbers used by the instrumented libraries
+    static const uint16_t EV_TASK = 1;         // Scheduler task, arg = task index
+    static const uint16_t EV_SLOT = 2;         // TimeSlotScheduler slot, arg = slot
+    static const uint16_t EV_I2C_RECEIVE = 3;  // I2CRegisterSlave write, arg = bytes
+    static const uint16_t EV_I2C_REQUEST = 4;  // I2CRegisterSlave read, arg = register
+    static const uint16_t EV_STEP_TICK = 5;    // StepTimer interrupt (SimpleStepper)
+    static const uint16_t EV_USER = 0x100;     // First number for the application
+
+    // Dump frames: SYNC, type, length, payload, CRC-8 (poly 0x07) over type to payload
+    static const uint8_t SYNC = 0xA5;
+    static const uint8_t FRAME_HEADER = 'T';   // version, cores, clock Hz
+    static const uint8_t FRAME_STREAM = 'S';   // core, written, count
+    static const uint8_t FRAME_EVENTS = 'R';   // core, up to EVENTS_PER_FRAME events
+    static const uint8_t FRAME_END = 'E';
+    static const uint8_t VERSION = 1;
+    static const uint8_t EVENTS_PER_FRAME = 30;
+
+    TraceRecorder();
+
+    /**
+     * Start the cycle counter (Cortex-M3 and up) and start recording
+     */
+    void begin();
+
+    /**
+     * Write one event; safe from interrupts, normally used through the macros
+     * @param id Kind | event number
+     * @param arg Argument, or the value of a COUNTER
+     */
+    void record(uint16_t id, uint16_t arg) {
+        if (!_running) return;
+        Ring& ring = _rings[coreId()];
+        const uint32_t state = lock();
+        TraceEvent& event = ring.events[ring.written & (CAPACITY - 1)];
+        event.timestamp = now();
+        event.id = id;
+        event.arg = arg;
+        ring.written++;
+        unlock(state);
+    }
+
+    // Recording on / off; the rings keep their contents
+    void start() { _running = true; }
+    void stop() { _running = false; }
+    bool isRunning() const { return _running; }
+
+    // Empty all rings
+    void clear();
+
+    // Events written to a core's ring since clear(), including overwritten ones
+    uint32_t getWritten(uint8_t core) const;
+
+    // Events in a core's ring now
+    uint16_t getCount(uint8_t core) const;
+
+    // Timestamp ticks per second
+    uint32_t getClockHz() const;
+
+    /**
+     * Send every ring, oldest event first; recording pauses meanwhile
+     * @param out Serial or any other Print
+     */
+    void dump(Print& out);
+
+private:
+    struct Ring {
+        TraceEvent events[CAPACITY];
+        volatile uint32_t written;
+    };
+
+    static uint8_t coreId() {
+#if TRACE_RECORDER_CORES > 1
+        return get_core_num();
+#else
+        return 0;
+#endif
+    }
+
+    static uint32_t now() {
+#if TRACE_RECORDER_CYCLES
+        return DWT->CYCCNT;
+#else
+        return micros();
+#endif
+    }
+
+    static uint32_t lock() {
+#if defined(__AVR__)
+        const uint8_t sreg = SREG;
+        cli();
+        return sreg;
+#elif defined(__arm__)
+        const uint32_t primask = __get_PRIMASK();
+        __disable_irq();
+        return primask;
+#else
+        return 0;
+#endif
+    }
+
+    static void unlock(uint32_t state) {
+#if defined(__AVR__)
+        SREG = (uint8_t)state;
+#elif defined(__arm__)
+        __set_PRIMASK(state);
+#else
+        (void)state;
+#endif
+    }
+
+    void sendFrame(Print& out, uint8_t type, const uint8_t* payload, uint8_t length);
+
+    Ring _rings[CORES];
+    volatile bool _running;
+};
+
+extern TraceRecorder traceRecorder;
+
+#if defined(TRACE_RECORDER_ENABLED)
+#define TRACE_BEGIN(event, arg) traceRecorder.record(TraceRecorder::BEGIN | (event), (uint16_t)(arg))
+#define TRACE_END(event, arg) traceRecorder.record(TraceRecorder::END | (event), (uint16_t)(arg))
+#define TRACE_INSTANT(event, arg) traceRecorder.record(TraceRecorder::INSTANT | (event), (uint16_t)(arg))
+#define TRACE_COUNTER(event, value) traceRecorder.record(TraceRecorder::COUNTER | (event), (uint16_t)(value))
+#else
+#define TRACE_BEGIN(event, arg) ((void)0)
+#define TRACE_END(event, arg) ((void)0)
+#define TRACE_INSTANT(event, arg) ((void)0)
+#define TRACE_COUNTER(event, value) ((void)0)
+#endif
+
+/**
+ * Tracer policy for CyclicExecutive and TimeSlotScheduler
+ * (Workshops/PatternsArchitecture): task and slot spans as EV_TASK / EV_SLOT
+ */
+struct SchedulerTracer {
+    static void taskBegin(size_t task) { TRACE_BEGIN(TraceRecorder::EV_TASK, task); (void)task; }
+    static void taskEnd(size_t task) { TRACE_END(TraceRecorder::EV_TASK, task); (void)task; }
+    static void slotBegin(size_t slot) { TRACE_BEGIN(TraceRecorder::EV_SLOT, slot); (void)slot; }
+    static void slotEnd(size_t slot) { TRACE_END(TraceRecorder::EV_SLOT, slot); (void)slot; }
+};
+
+#endif // TRACE_RECORDER_H
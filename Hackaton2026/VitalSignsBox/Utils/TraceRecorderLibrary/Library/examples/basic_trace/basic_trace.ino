@@ -0,0 +1,45 @@
+// Only this sketch is traced; build with -DTRACE_RECORDER_ENABLED to
+// trace the instrumented libraries as well
+#define TRACE_RECORDER_ENABLED
+#include "TraceRecorder.h"
+
+/*
+    Trace a sampling loop and a slower filter step, and send the rings
+    when 'd' arrives on the serial port:
+
+        trace_export.py --port /dev/ttyACM0 --trigger d --chrome trace.json
+*/
+
+#define EV_SAMPLE (TraceRecorder::EV_USER + 0)
+#define EV_FILTER (TraceRecorder::EV_USER + 1)
+#define EV_LEVEL (TraceRecorder::EV_USER + 2)
+
+uint16_t level = 0;
+
+void setup() {
+  Serial.begin(115200);
+  traceRecorder.begin();
+}
+
+void loop() {
+  static uint32_t lastSample = 0;
+  if (micros() - lastSample >= 2000) {
+    lastSample = micros();
+    TRACE_BEGIN(EV_SAMPLE, 0);
+    level = analogRead(A0);
+    TRACE_END(EV_SAMPLE, 0);
+    TRACE_COUNTER(EV_LEVEL, level);
+  }
+
+  static uint8_t samples = 0;
+  if (++samples == 0) {
+    TRACE_BEGIN(EV_FILTER, 0);
+    delayMicroseconds(300);  // Stands in for a slow step
+    TRACE_END(EV_FILTER, 0);
+  }
+
+  if (Serial.available() > 0 && Serial.read() == 'd') {
+    traceRecorder.dump(Serial);
+    traceRecorder.clear();
+  }
+}
@@ -0,0 +1,266 @@
+#!/usr/bin/env python3
+"""
+trace_export.py - converter for TraceRecorder dumps
+
+traceRecorder.dump() sends a header frame, per core a stream frame and
+the events oldest first, and an end frame (see TraceRecorder.h). This
+tool writes them as a Chrome trace (JSON, opens in ui.perfetto.dev and
+chrome://tracing) or as a CTF 1.8 trace (metadata + one stream per
+core, for Babeltrace and Trace Compass).
+
+    # Ask a board for a dump ('d' in the basic_trace example)
+    trace_export.py --port /dev/ttyACM0 --trigger d --chrome trace.json
+
+    # Convert a captured dump, with names for the application events
+    trace_export.py dump.bin --names events.txt --ctf trace_ctf
+
+A names file has one event per line, 'number name', e.g. '0x100 adc'.
+A name ending in [] shows the argument in the span name ('filter[]'
+gives 'filter[3]'), like the built-in task and slot events.
+"""
+
+import argparse
+import json
+import os
+import struct
+import sys
+
+SYNC = 0xA5
+FRAME_HEADER = ord('T')
+FRAME_STREAM = ord('S')
+FRAME_EVENTS = ord('R')
+FRAME_END = ord('E')
+
+INSTANT, BEGIN, END, COUNTER = 0, 1, 2, 3
+KIND_NAMES = ['instant', 'begin', 'end', 'counter']
+
+# TraceRecorder::EV_* (True: the argument is an index, shown in the name)
+BUILTIN = {
+    1: ('task', True),
+    2: ('slot', True),
+    3: ('i2c_receive', False),
+    4: ('i2c_request', False),
+    5: ('step_tick', False),
+}
+
+
+def crc8(data):
+    """Same as the frame CRC in TraceRecorder.cpp (Crc8::SMBUS): poly 0x07, init 0"""
+    crc = 0
+    for b in data:
+        crc ^= b
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x07) & 0xFF if crc & 0x80 else (crc << 1) & 0xFF
+    return crc
+
+
+def frames(read):
+    """Yield (type, payload) for every frame with a valid checksum"""
+    while True:
+        b = read(1)
+        if not b:
+            return
+        if b[0] != SYNC:
+            continue
+        head = read(2)
+        if len(head) < 2:
+            return
+        rest = read(head[1] + 1)
+        if len(rest) < head[1] + 1:
+            return
+        if crc8(head + rest[:-1]) != rest[-1]:
+            print('checksum error, frame dropped', file=sys.stderr)
+            continue
+        yield head[0], rest[:-1]
+
+
+def collect(read):
+    """Decode one dump. Returns a dict or None"""
+    dump = None
+    for kind, payload in frames(read):
+        if kind == FRAME_HEADER:
+            version, cores, clock = struct.unpack('<BBI', payload[:6])
+            dump = {'version': version, 'clockHz': clock, 'cores': {}}
+        elif kind == FRAME_STREAM and dump is not None:
+            core, written, count = struct.unpack('<BIH', payload[:7])
+            dump['cores'][core] = {'written': written, 'count': count, 'events': []}
+        elif kind == FRAME_EVENTS and dump is not None:
+            stream = dump['cores'].get(payload[0])
+            if stream is None:
+                continue
+            for offset in range(1, len(payload) - 7, 8):
+                stream['events'].append(struct.unpack('<IHH', payload[offset:offset + 8]))
+        elif kind == FRAME_END and dump is not None:
+            return dump
+    return dump
+
+
+def load_names(path):
+    names = dict(BUILTIN)
+    if path:
+        with open(path) as f:
+            for line in f:
+                line = line.split('#')[0].split()
+                if len(line) < 2:
+                    continue
+                name = line[1]
+                indexed = name.endswith('[]')
+                names[int(line[0], 0)] = (name[:-2] if indexed else name, indexed)
+    return names
+
+
+def unwrap(events):
+    """32-bit timestamps to a rising 64-bit tick count (gaps below one wrap)"""
+    ticks, high, last = [], 0, None
+    for timestamp, _, _ in events:
+        if last is not None and timestamp < last:
+            high += 1 << 32
+        last = timestamp
+        ticks.append(high + timestamp)
+    return ticks
+
+
+def label(names, number, arg, kind):
+    name, indexed = names.get(number, ('event_%d' % number, False))
+    if indexed and kind in (BEGIN, END):
+        return '%s[%d]' % (name, arg)
+    return name
+
+
+def write_chrome(dump, names, path):
+    per_us = dump['clockHz'] / 1e6 if dump['clockHz'] else 1.0
+    start = min((unwrap(s['events'])[0] for s in dump['cores'].values() if s['events']), default=0)
+    out = [{'name': 'thread_name', 'ph': 'M', 'pid': 1, 'tid': core,
+            'args': {'name': 'core %d' % core}} for core in dump['cores']]
+
+    for core, stream in sorted(dump['cores'].items()):
+        for (_, event_id, arg), tick in zip(stream['events'], unwrap(stream['events'])):
+            kind, number = event_id >> 14, event_id & 0x3FFF
+            entry = {'name': label(names, number, arg, kind), 'pid': 1, 'tid': core,
+                     'ts': (tick - start) / per_us}
+            if kind == BEGIN:
+                entry.update(ph='B', args={'arg': arg})
+            elif kind == END:
+                entry.update(ph='E')
+            elif kind == COUNTER:
+                entry.update(ph='C', args={'value': arg})
+            else:
+                entry.update(ph='i', s='t', args={'arg': arg})
+            out.append(entry)
+
+    with open(path, 'w') as f:
+        json.dump({'traceEvents': out, 'displayTimeUnit': 'ns',
+                   'otherData': {'clockHz': dump['clockHz']}}, f, indent=1)
+
+
+CTF_METADATA = """/* CTF 1.8 */
+
+typealias integer { size = 16; align = 8; signed = false; } := uint16_t;
+typealias integer { size = 32; align = 8; signed = false; } := uint32_t;
+
+trace {
+    major = 1;
+    minor = 8;
+    byte_order = le;
+    packet.header := struct {
+        uint32_t magic;
+        uint32_t stream_id;
+    };
+};
+
+clock {
+    name = target;
+    freq = %(freq)d;
+};
+
+typealias integer { size = 64; align = 8; signed = false; map = clock.target.value; } := target_clock_t;
+
+typealias enum : uint16_t {
+%(enum)s
+} := trace_event_t;
+
+stream {
+    id = 0;
+    packet.context := struct {
+        uint32_t cpu_id;
+    };
+    event.header := struct {
+        uint16_t id;
+        target_clock_t timestamp;
+    };
+};
+"""
+
+CTF_EVENT = """
+event {
+    name = %(name)s;
+    id = %(id)d;
+    stream_id = 0;
+    fields := struct {
+        trace_event_t event;
+        uint16_t %(arg)s;
+    };
+};
+"""
+
+
+def write_ctf(dump, names, path):
+    os.makedirs(path, exist_ok=True)
+    enum = ',\n'.join('    "%s" = %d' % (name, number) for number, (name, _) in sorted(names.items()))
+    metadata = CTF_METADATA % {'freq': dump['clockHz'] or 1, 'enum': enum}
+    for kind, name in enumerate(KIND_NAMES):
+        metadata += CTF_EVENT % {'name': name, 'id': kind, 'arg': 'value' if kind == COUNTER else 'arg'}
+    with open(os.path.join(path, 'metadata'), 'w') as f:
+        f.write(metadata)
+
+    for core, stream in sorted(dump['cores'].items()):
+        with open(os.path.join(path, 'stream_%d' % core), 'wb') as f:
+            f.write(struct.pack('<III', 0xC1FC1FC1, 0, core))
+            for (_, event_id, arg), tick in zip(stream['events'], unwrap(stream['events'])):
+                f.write(struct.pack('<HQHH', event_id >> 14, tick, event_id & 0x3FFF, arg))
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Convert TraceRecorder dumps')
+    parser.add_argument('capture', nargs='?', help='captured binary file (instead of --port)')
+    parser.add_argument('--port', help='serial port of the board')
+    parser.add_argument('--baud', type=int, default=115200)
+    parser.add_argument('--trigger', help='characters to send to start the dump')
+    parser.add_argument('--timeout', type=float, default=5.0, help='serial timeout in seconds')
+    parser.add_argument('--names', help="names file: 'number name' per line")
+    parser.add_argument('--chrome', help='write a Chrome / Perfetto JSON trace')
+    parser.add_argument('--ctf', help='write a CTF trace into this directory')
+    args = parser.parse_args()
+
+    if args.port:
+        import serial
+        with serial.Serial(args.port, args.baud, timeout=args.timeout) as port:
+            if args.trigger:
+                port.reset_input_buffer()
+                port.write(args.trigger.encode('ascii'))
+            dump = collect(port.read)
+    elif args.capture:
+        with open(args.capture, 'rb') as f:
+            dump = collect(f.read)
+    else:
+        parser.error('give a capture file or --port')
+
+    if dump is None:
+        print('no dump received', file=sys.stderr)
+        return 2
+
+    names = load_names(args.names)
+    for core, stream in sorted(dump['cores'].items()):
+        lost = stream['written'] - stream['count']
+        print('core %d: %d events, %d received, %d overwritten' %
+              (core, stream['count'], len(stream['events']), lost))
+
+    if args.chrome:
+        write_chrome(dump, names, args.chrome)
+    if args.ctf:
+        write_ctf(dump, names, args.ctf)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
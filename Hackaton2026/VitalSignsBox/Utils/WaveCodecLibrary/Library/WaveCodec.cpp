@@ -0,0 +1,336 @@
+/*
+    WaveCodec.cpp
+
+    Lossless block codec for multi-channel biosignals (ECG leads)
+*/
+
+#include "WaveCodec.h"
+#include "Crc.h"
+
+static const uint8_t HEADER_FIXED = 12;  // Up to the mode bytes
+
+static uint16_t getU16(const uint8_t* data) {
+    return ((uint16_t)data[0] << 8) | data[1];
+}
+
+static void putU16(uint8_t* data, uint16_t value) {
+    data[0] = value >> 8;
+    data[1] = value & 0xFF;
+}
+
+// Signed residual to unsigned: 0, -1, 1, -2, ... -> 0, 1, 2, 3, ...
+static inline uint32_t zigzag(int32_t value) {
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static inline int32_t unzigzag(uint32_t value) {
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+// MSB-first bit stream into a bounded buffer; past the end it only counts
+struct BitWriter {
+    uint8_t* out;
+    size_t capacity;
+    size_t pos;
+    uint32_t acc;
+    uint8_t bits;  // Pending bits in acc, < 8 between calls
+
+    struct Mark {
+        size_t pos;
+        uint32_t acc;
+        uint8_t bits;
+    };
+
+    BitWriter(uint8_t* buffer, size_t size) : out(buffer), capacity(size), pos(0), acc(0), bits(0) {}
+
+    // n <= 16
+    void put(uint32_t value, uint8_t n) {
+        acc = (acc << n) | value;
+        bits += n;
+        while (bits >= 8) {
+            bits -= 8;
+            if (pos < capacity) out[pos] = (uint8_t)(acc >> bits);
+            pos++;
+        }
+    }
+
+    void putRice(uint32_t value, uint8_t k) {
+        const uint32_t quotient = value >> k;
+        if (quotient < WaveCodec::ESCAPE_QUOTIENT) {
+            put(((1UL << quotient) - 1) << 1, (uint8_t)(quotient + 1));  // quotient ones, a zero
+            if (k > 0) put(value & ((1UL << k) - 1), k);
+        } else {
+            put(0xFFFF, WaveCodec::ESCAPE_QUOTIENT);
+            put(value >> 10, WaveCodec::ESCAPE_BITS - 10);
+            put(value & 0x3FF, 10);
+        }
+    }
+
+    void flush() {
+        if (bits > 0) put(0, (uint8_t)(8 - bits));
+    }
+
+    uint32_t bitCount() const { return pos * 8 + bits; }
+    bool overflow() const { return pos > capacity; }
+    Mark mark() const { return Mark{pos, acc, bits}; }
+    void restore(const Mark& m) {
+        pos = m.pos;
+        acc = m.acc;
+        bits = m.bits;
+    }
+};
+
+// MSB-first reader, left-aligned in a 32-bit word; reads past the end as
+// zeros and counts them, so one check at the end finds a truncated stream
+struct BitReader {
+    const uint8_t* data;
+    size_t length;
+    size_t pos;
+    uint32_t acc;
+    uint8_t bits;       // Valid bits at the top of acc
+    uint32_t consumed;
+
+    BitReader(const uint8_t* buffer, size_t size) : data(buffer), length(size), pos(0), acc(0), bits(0), consumed(0) {}
+
+    void refill() {
+        while (bits <= 24) {
+            const uint32_t byte = pos < length ? data[pos] : 0;
+            pos++;
+            acc |= byte << (24 - bits);
+            bits += 8;
+        }
+    }
+
+    // n <= 16
+    uint32_t get(uint8_t n) {
+        if (n == 0) return 0;
+        refill();
+        const uint32_t value = acc >> (32 - n);
+        acc <<= n;
+        bits -= n;
+        consumed += n;
+        return value;
+    }
+
+    uint32_t getRice(uint8_t k) {
+        refill();
+        uint8_t ones;
+#if defined(__GNUC__)
+        ones = ~acc == 0 ? 32 : (uint8_t)__builtin_clz(~acc);
+#else
+        ones = 0;
+        while (ones < 32 && (acc & (0x80000000UL >> ones))) ones++;
+#endif
+        if (ones >= WaveCodec::ESCAPE_QUOTIENT) {
+            get(WaveCodec::ESCAPE_QUOTIENT);
+            const uint32_t high = get(WaveCodec::ESCAPE_BITS - 10);
+            return (high << 10) | get(10);
+        }
+        acc <<= ones + 1;
+        bits -= ones + 1;
+        consumed += ones + 1;
+        return ((uint32_t)ones << k) | get(k);
+    }
+
+    bool overrun() const { return consumed > length * 8; }
+};
+
+size_t WaveCodec::maxBlockBytes(uint16_t frames, uint8_t channels) {
+    // A coded channel is only kept while it is smaller than verbatim
+    return HEADER_FIXED + channels + 1 + (size_t)frames * channels * 2 + 2;
+}
+
+// Fixed polynomial prediction of x[0] from the samples stride, 2 x stride
+// and 3 x stride before it
+int32_t WaveCodec::residual(const int16_t* x, uint8_t order, uint8_t stride) {
+    const int32_t x0 = x[0];
+    if (order == 0) return x0;
+    const int32_t x1 = x[-stride];
+    if (order == 1) return x0 - x1;
+    const int32_t x2 = x[-2 * stride];
+    if (order == 2) return x0 - (x1 + x1) + x2;
+    const int32_t x3 = x[-3 * stride];
+    return x0 - (x1 + x1 + x1) + (x2 + x2 + x2) - x3;
+}
+
+// k = floor(log2(mean)) of the zigzag residuals of one partition
+uint8_t WaveCodec::riceParameter(uint32_t sum, uint16_t count) {
+    uint8_t k = 0;
+    while (k < 15 && ((uint32_t)count << (k + 1)) <= sum) k++;
+    return k;
+}
+
+// The order with the smallest estimated code: per partition count x (k + 1)
+// bits plus the quotients, about sum / 2^k. A plain sum of the residuals
+// would let one spike pick order 0 for a block that is flat otherwise.
+uint8_t WaveCodec::chooseOrder(const int16_t* samples, uint16_t frames, uint8_t channels) {
+    const uint8_t maxOrder = frames > MAX_ORDER ? MAX_ORDER : (uint8_t)(frames - 1);
+    uint8_t best = 0;
+    uint32_t bestBits = 0xFFFFFFFFUL;
+    for (uint8_t order = 0; order <= maxOrder; order++) {
+        uint32_t bits = 16UL * order;
+        for (uint16_t first = order; first < frames; first += PARTITION) {
+            const uint16_t last = (frames - first > PARTITION) ? first + PARTITION : frames;
+            uint32_t sum = 0;
+            for (uint16_t t = first; t < last; t++) {
+                sum += zigzag(residual(samples + (size_t)t * channels, order, channels));
+            }
+            const uint8_t k = riceParameter(sum, last - first);
+            bits += 4 + (uint32_t)(last - first) * (k + 1) + (sum >> k);
+        }
+        if (bits < bestBits) {
+            best = order;
+            bestBits = bits;
+        }
+    }
+    return best;
+}
+
+size_t WaveCodec::encode(const int16_t* samples, uint16_t frames, uint8_t channels, uint32_t firstFrame,
+                         uint8_t* out, size_t capacity) {
+    if (samples == nullptr || out == nullptr) return 0;
+    if (frames == 0 || frames > MAX_FRAMES || channels == 0 || channels > MAX_CHANNELS) return 0;
+    const uint8_t headerBytes = HEADER_FIXED + channels + 1;
+    if (capacity < (size_t)headerBytes + 2) return 0;
+
+    BitWriter writer(out + headerBytes, capacity - headerBytes - 2);
+    for (uint8_t c = 0; c < channels; c++) {
+        const int16_t* x = samples + c;
+        const uint8_t order = chooseOrder(x, frames, channels);
+        const BitWriter::Mark start = writer.mark();
+
+        for (uint8_t t = 0; t < order; t++) writer.put((uint16_t)x[(size_t)t * channels], 16);
+        for (uint16_t first = order; first < frames; first += PARTITION) {
+            const uint16_t last = (frames - first > PARTITION) ? first + PARTITION : frames;
+
+            uint32_t sum = 0;
+            for (uint16_t t = first; t < last; t++) {
+                sum += zigzag(residual(x + (size_t)t * channels, order, channels));
+            }
+            const uint8_t k = riceParameter(sum, last - first);
+
+            writer.put(k, 4);
+            for (uint16_t t = first; t < last; t++) {
+                writer.putRice(zigzag(residual(x + (size_t)t * channels, order, channels)), k);
+            }
+        }
+
+        if (writer.bitCount() - start.pos * 8 - start.bits < (uint32_t)frames * 16) {
+            out[HEADER_FIXED + c] = (uint8_t)(order << 5);
+            continue;
+        }
+        writer.restore(start);  // Noise or a step: verbatim is smaller
+        for (uint16_t t = 0; t < frames; t++) writer.put((uint16_t)x[(size_t)t * channels], 16);
+        out[HEADER_FIXED + c] = MODE_VERBATIM;
+    }
+    writer.flush();
+    if (writer.overflow()) return 0;
+
+    const uint16_t payloadBytes = (uint16_t)writer.pos;
+    out[0] = SYNC_1;
+    out[1] = SYNC_2;
+    out[2] = VERSION;
+    out[3] = channels;
+    putU16(out + 4, frames);
+    putU16(out + 6, firstFrame >> 16);
+    putU16(out + 8, firstFrame & 0xFFFF);
+    putU16(out + 10, payloadBytes);
+    out[headerBytes - 1] = Crc8::compute(out, headerBytes - 1);
+    putU16(out + headerBytes + payloadBytes, Crc16::compute(out + headerBytes, payloadBytes));
+    return headerBytes + payloadBytes + 2;
+}
+
+bool WaveCodec::readHeader(const uint8_t* data, size_t length, WaveBlockInfo& info) {
+    if (length < HEADER_FIXED + 2 || data[0] != SYNC_1 || data[1] != SYNC_2 || data[2] != VERSION) return false;
+    const uint8_t channels = data[3];
+    const uint16_t frames = getU16(data + 4);
+    if (channels == 0 || channels > MAX_CHANNELS || frames == 0 || frames > MAX_FRAMES) return false;
+    const uint8_t headerBytes = HEADER_FIXED + channels + 1;
+    if (length < headerBytes) return false;
+
+    if (Crc8::compute(data, headerBytes - 1) != data[headerBytes - 1]) return false;
+    for (uint8_t c = 0; c < channels; c++) {
+        const uint8_t mode = data[HEADER_FIXED + c];
+        if (mode != MODE_VERBATIM && (mode & 0x1F || (mode >> 5) > MAX_ORDER)) return false;
+    }
+
+    info.firstFrame = ((uint32_t)getU16(data + 6) << 16) | getU16(data + 8);
+    info.frames = frames;
+    info.channels = channels;
+    info.headerBytes = headerBytes;
+    info.blockBytes = headerBytes + getU16(data + 10) + 2;
+    return true;
+}
+
+size_t WaveCodec::decode(const uint8_t* data, size_t length, int16_t* samples, size_t capacity,
+                         WaveBlockInfo& info) {
+    if (data == nullptr || samples == nullptr || !readHeader(data, length, info)) return 0;
+    if (length < info.blockBytes || capacity < (size_t)info.frames * info.channels) return 0;
+    const uint8_t* payload = data + info.headerBytes;
+    const uint16_t payloadBytes = info.blockBytes - info.headerBytes - 2;
+    if (Crc16::compute(payload, payloadBytes) != getU16(payload + payloadBytes)) return 0;
+
+    const uint8_t stride = info.channels;
+    const uint16_t frames = info.frames;
+    BitReader reader(payload, payloadBytes);
+    for (uint8_t c = 0; c < info.channels; c++) {
+        int16_t* x = samples + c;
+        const uint8_t mode = data[HEADER_FIXED + c];
+        if (mode == MODE_VERBATIM) {
+            for (uint16_t t = 0; t < frames; t++) x[(size_t)t * stride] = (int16_t)reader.get(16);
+            continue;
+        }
+
+        const uint8_t order = mode >> 5;
+        if (order >= frames) return 0;
+        for (uint8_t t = 0; t < order; t++) x[(size_t)t * stride] = (int16_t)reader.get(16);
+
+        // Previous samples in registers; one loop per order keeps the inner loop free of branches
+        int32_t x1 = order > 0 ? x[(size_t)(order - 1) * stride] : 0;
+        int32_t x2 = order > 1 ? x[(size_t)(order - 2) * stride] : 0;
+        int32_t x3 = order > 2 ? x[(size_t)(order - 3) * stride] : 0;
+        for (uint16_t first = order; first < frames; first += PARTITION) {
+            const uint16_t last = (frames - first > PARTITION) ? first + PARTITION : frames;
+            const uint8_t k = (uint8_t)reader.get(4);
+            int16_t* out = x + (size_t)first * stride;
+            switch (order) {
+            case 0:
+                for (uint16_t t = first; t < last; t++, out += stride) *out = (int16_t)unzigzag(reader.getRice(k));
+                break;
+            case 1:
+                for (uint16_t t = first; t < last; t++, out += stride) {
+                    x1 += unzigzag(reader.getRice(k));
+                    *out = (int16_t)x1;
+                }
+                break;
+            case 2:
+                for (uint16_t t = first; t < last; t++, out += stride) {
+                    const int32_t x0 = unzigzag(reader.getRice(k)) + x1 + x1 - x2;
+                    x2 = x1;
+                    x1 = x0;
+                    *out = (int16_t)x0;
+                }
+                break;
+            default:
+                for (uint16_t t = first; t < last; t++, out += stride) {
+                    const int32_t x0 = unzigzag(reader.getRice(k)) + x1 + x1 + x1 - (x2 + x2 + x2) + x3;
+                    x3 = x2;
+                    x2 = x1;
+                    x1 = x0;
+                    *out = (int16_t)x0;
+                }
+                break;
+            }
+        }
+    }
+    if (reader.overrun()) return 0;
+    return info.blockBytes;
+}
+
+size_t WaveCodec::findBlock(const uint8_t* data, size_t length, size_t from) {
+    WaveBlockInfo info;
+    for (size_t i = from; i + 1 < length; i++) {
+        if (data[i] == SYNC_1 && data[i + 1] == SYNC_2 && readHeader(data + i, length - i, info)) return i;
+    }
+    return length;
+}
@@ -0,0 +1,107 @@
+/*
+    WaveCodec.h
+
+    Lossless block codec for multi-channel biosignals (ECG leads)
+
+    Every channel of a block is predicted with the best of four fixed
+    polynomial predictors (order 0-3: the value, its first, second or
+    third difference) and the residuals are Rice coded, with a new Rice
+    parameter for every PARTITION frames so a QRS complex does not
+    inflate the code of the flat parts around it. A channel that would
+    not get smaller is stored verbatim.
+
+    The encoder is adds, subtractions and shifts only (no multiplications
+    or divisions per sample), so it runs on the hub next to the
+    scheduler. The decoder reads the bit stream a word at a time and
+    counts the unary part with one count-leading-zeros; it builds
+    unchanged on the Raspberry Pi (see wave_decode.cpp).
+
+    Blocks are self-contained: a sync word, the first frame number and a
+    header CRC allow random access and resynchronisation after a gap,
+    and a CRC-16 over the payload catches corrupted blocks.
+*/
+
+#ifndef WAVE_CODEC_H
+#define WAVE_CODEC_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+struct WaveBlockInfo {
+    uint32_t firstFrame;   // Frame number of the first frame in the block
+    uint16_t frames;       // Frames in the block
+    uint8_t channels;      // Samples per frame
+    uint8_t headerBytes;   // Sync word up to and including the header CRC
+    uint16_t blockBytes;   // Whole block: header, payload and payload CRC
+};
+
+class WaveCodec {
+public:
+    static const uint8_t MAX_CHANNELS = 4;
+    static const uint16_t MAX_FRAMES = 1024;
+    static const uint8_t PARTITION = 64;           // Frames per Rice parameter
+    static const uint8_t MAX_HEADER = 12 + MAX_CHANNELS + 1;
+
+    // Block layout (multi-byte values big endian):
+    //   'W' 'V', version, channels, frames (16), first frame (32), payload bytes (16),
+    //   one mode byte per channel (predictor order << 5, or MODE_VERBATIM),
+    //   CRC-8 (poly 0x07) over the header, payload, CRC-16 (CCITT) over the payload.
+    // The payload is one bit stream, channel after channel: 'order' warm-up
+    // samples (16 bits), then per PARTITION residuals a 4-bit Rice parameter k
+    // and the residuals (zigzag, unary quotient, k bits). A quotient of
+    // ESCAPE_QUOTIENT ones is followed by the zigzag value in ESCAPE_BITS bits.
+    // Verbatim channels are 16 bits per sample.
+    static const uint8_t SYNC_1 = 'W';
+    static const uint8_t SYNC_2 = 'V';
+    static const uint8_t VERSION = 1;
+    static const uint8_t MODE_VERBATIM = 0xE0;
+    static const uint8_t MAX_ORDER = 3;
+    static const uint8_t ESCAPE_QUOTIENT = 16;
+    static const uint8_t ESCAPE_BITS = 20;        // Order 3 of 16-bit samples: 19 bits + sign
+
+    /**
+     * Largest block encode() can write for this shape
+     */
+    static size_t maxBlockBytes(uint16_t frames, uint8_t channels);
+
+    /**
+     * Encode one block
+     * @param samples    frames x channels samples, interleaved (frame 0 channel 0, frame 0 channel 1, ...)
+     * @param frames     1 .. MAX_FRAMES
+     * @param channels   1 .. MAX_CHANNELS
+     * @param firstFrame Frame number of the first frame, e.g. from an ECG BURST
+     * @param out        Receives the block
+     * @param capacity   Bytes available at out; maxBlockBytes() always fits
+     * @return Bytes written, 0 on a bad argument or when out is too small
+     */
+    static size_t encode(const int16_t* samples, uint16_t frames, uint8_t channels, uint32_t firstFrame,
+                         uint8_t* out, size_t capacity);
+
+    /**
+     * Check the sync word and header CRC at data and describe the block
+     * @return false if there is no valid header (or not all of it) at data
+     */
+    static bool readHeader(const uint8_t* data, size_t length, WaveBlockInfo& info);
+
+    /**
+     * Decode the block at data
+     * @param samples  Receives info.frames x info.channels samples, interleaved
+     * @param capacity Samples available at samples
+     * @return Bytes of the block, 0 if it is invalid, incomplete, corrupt or too large
+     */
+    static size_t decode(const uint8_t* data, size_t length, int16_t* samples, size_t capacity,
+                         WaveBlockInfo& info);
+
+    /**
+     * Find the next valid block header at or after from, e.g. after a gap
+     * @return Its offset, or length if there is none
+     */
+    static size_t findBlock(const uint8_t* data, size_t length, size_t from = 0);
+
+private:
+    static uint8_t riceParameter(uint32_t sum, uint16_t count);
+    static uint8_t chooseOrder(const int16_t* samples, uint16_t frames, uint8_t channels);
+    static int32_t residual(const int16_t* x, uint8_t order, uint8_t stride);
+};
+
+#endif // WAVE_CODEC_H
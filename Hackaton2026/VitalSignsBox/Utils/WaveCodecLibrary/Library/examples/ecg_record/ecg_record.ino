@@ -0,0 +1,84 @@
+#include <Wire.h>
+#include "TwiPinHelper.h"
+#include "I2CAsyncBus.h"
+#include "HubScheduler.h"
+#include "WaveCodec.h"
+
+/*
+    Hub recording the three ECG leads losslessly: BURST reads collect the
+    frames, every 250 frames (0.5 s at 500 Hz) become one WaveCodec block,
+    written to Serial as binary. wave_decode on the Pi turns a capture back
+    into CSV. A gap in the frame numbers (overrun) closes the block early,
+    so every block stays gapless.
+*/
+
+#define W1_SCL 39  // PA13
+#define W1_SDA 28  // PA12
+
+TwiPinPair portSensorsA(W1_SCL, W1_SDA);
+TwoWire WireSensorA(&sercom1, W1_SDA, W1_SCL);
+I2CAsyncBus busA(&WireSensorA, SERCOM1);
+void SERCOM1_Handler() { busA.onService(); }
+
+#define ECG_MODULE_ADDR 0x2A
+#define ECG_LEADS 3
+#define BLOCK_FRAMES 250
+
+HubScheduler hub;
+int8_t ecgId;
+
+int16_t block[BLOCK_FRAMES * ECG_LEADS];
+uint16_t blockFill = 0;
+uint32_t blockFirst = 0;
+uint8_t encoded[WaveCodec::MAX_HEADER + BLOCK_FRAMES * ECG_LEADS * 2 + 2];  // >= maxBlockBytes()
+
+uint16_t getU16(const uint8_t* data) {
+  return ((uint16_t)data[0] << 8) | data[1];
+}
+
+uint32_t getU32(const uint8_t* data) {
+  return ((uint32_t)getU16(data) << 16) | getU16(data + 2);
+}
+
+void writeBlock() {
+  if (blockFill == 0) return;
+  const size_t length = WaveCodec::encode(block, blockFill, ECG_LEADS, blockFirst, encoded, sizeof(encoded));
+  Serial.write(encoded, length);
+  blockFirst += blockFill;
+  blockFill = 0;
+}
+
+void setup() {
+  Serial.begin(921600);  // Raw 500 Hz x 3 leads is 3 kB/s, the blocks about a third of that
+
+  WireSensorA.begin();
+  portSensorsA.setPinPeripheralAltStates();
+  busA.begin();
+  const int8_t a = hub.addBus(&busA);
+  const uint8_t ecgBurst[] = { 0x20, 8 };  // BURST, 8 frames
+  ecgId = hub.addModule(a, ECG_MODULE_ADDR, ecgBurst, 2, 5 + 8 * 6, 10000);  // 800 frames/s max
+}
+
+void loop() {
+  hub.poll();
+
+  HubReading reading;
+  while (hub.read(reading)) {
+    if (!reading.ok || reading.module != ecgId || reading.length < 5) continue;
+    const uint32_t first = getU32(reading.data);
+    const uint8_t count = reading.data[4];
+    if (count == 0) continue;
+    if (first != blockFirst + blockFill) {
+      writeBlock();  // Frames were lost: start a new block at the new frame number
+      blockFirst = first;
+    }
+
+    for (uint8_t i = 0; i < count; i++) {
+      const uint8_t* frame = reading.data + 5 + i * 6;
+      for (uint8_t lead = 0; lead < ECG_LEADS; lead++) {
+        block[blockFill * ECG_LEADS + lead] = (int16_t)getU16(frame + lead * 2);
+      }
+      if (++blockFill == BLOCK_FRAMES) writeBlock();
+    }
+  }
+}
@@ -0,0 +1,97 @@
+/*
+    wave_decode.cpp
+
+    Decoder for WaveCodec streams, for the Raspberry Pi or any host
+
+    Reads blocks as written by WaveCodec::encode() (a capture of the hub's
+    serial port, a file on the SD card, ...) and writes one CSV line per
+    frame: frame number and the samples of every channel. Damaged or
+    partial blocks are skipped up to the next valid header; gaps in the
+    frame numbers are reported on stderr.
+
+        g++ -O2 -I Library -I ../CrcLibrary/Library wave_decode.cpp Library/WaveCodec.cpp \
+            ../CrcLibrary/Library/Crc.cpp -o wave_decode
+        ./wave_decode ecg.wv > ecg.csv
+        ./wave_decode < /dev/ttyACM0      # Live, until end of input
+*/
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "WaveCodec.h"
+
+int main(int argc, char** argv) {
+    FILE* in = stdin;
+    if (argc > 1 && (in = fopen(argv[1], "rb")) == nullptr) {
+        perror(argv[1]);
+        return 1;
+    }
+
+    // Room for one largest block, plus what came with it
+    const size_t maxBlock = WaveCodec::maxBlockBytes(WaveCodec::MAX_FRAMES, WaveCodec::MAX_CHANNELS);
+    std::vector<uint8_t> buffer(2 * maxBlock);
+    std::vector<int16_t> samples((size_t)WaveCodec::MAX_FRAMES * WaveCodec::MAX_CHANNELS);
+    size_t used = 0;
+    bool more = true;
+    bool started = false;
+    uint32_t nextFrame = 0;
+    unsigned long blocks = 0, skipped = 0, bytesIn = 0;
+    unsigned long long framesOut = 0;
+
+    while (more || used > 0) {
+        if (more) {
+            const size_t n = fread(buffer.data() + used, 1, buffer.size() - used, in);
+            if (n == 0) more = false;
+            used += n;
+            bytesIn += n;
+        }
+
+        size_t pos = 0;
+        while (pos < used) {
+            const size_t start = WaveCodec::findBlock(buffer.data(), used, pos);
+            if (start == used && more) {
+                // The next header may be cut off at the end: keep its bytes for the next read
+                const size_t keep = used - pos < WaveCodec::MAX_HEADER ? used - pos : WaveCodec::MAX_HEADER;
+                skipped += used - keep - pos;
+                pos = used - keep;
+                break;
+            }
+            skipped += start - pos;
+            pos = start;
+            if (pos == used) break;
+
+            WaveBlockInfo info;
+            WaveCodec::readHeader(buffer.data() + pos, used - pos, info);
+            if (used - pos < info.blockBytes && more) break;  // Rest of the block still to come
+
+            if (WaveCodec::decode(buffer.data() + pos, used - pos, samples.data(), samples.size(), info) == 0) {
+                pos++;  // Corrupt: look for the next header inside it
+                skipped++;
+                continue;
+            }
+            if (started && info.firstFrame != nextFrame) {
+                fprintf(stderr, "gap: frames %lu..%lu missing\n", (unsigned long)nextFrame,
+                        (unsigned long)(info.firstFrame - 1));
+            }
+            for (uint16_t f = 0; f < info.frames; f++) {
+                printf("%lu", (unsigned long)(info.firstFrame + f));
+                for (uint8_t c = 0; c < info.channels; c++) printf(",%d", samples[(size_t)f * info.channels + c]);
+                printf("\n");
+            }
+            started = true;
+            nextFrame = info.firstFrame + info.frames;
+            framesOut += info.frames;
+            blocks++;
+            pos += info.blockBytes;
+        }
+
+        // A partial block stays for the next read; at the end of input it has been skipped
+        memmove(buffer.data(), buffer.data() + pos, used - pos);
+        used -= pos;
+    }
+
+    fprintf(stderr, "%lu blocks, %llu frames, %lu bytes in, %lu bytes skipped\n", blocks, framesOut, bytesIn,
+            skipped);
+    if (in != stdin) fclose(in);
+    return 0;
+}
@@ -11,9 +11,12 @@
 #define W2_SCL 13  // PA17
 #define W2_SDA 11  // PA16
 
-TwiPinPair portBackbone(W0_SCL, W0_SDA);
-TwiPinPair portSensorsA(W1_SCL, W1_SDA);
-TwiPinPair portSensorsB(W2_SCL, W2_SDA);
+// Board description: muxed in one go in setup()
+constexpr TwiPinPair twiBuses[] = {
+  { W0_SDA, W0_SCL, TWI_MUX_SERCOM },      // Backbone
+  { W1_SDA, W1_SCL, TWI_MUX_SERCOM_ALT },  // Sensors A
+  { W2_SDA, W2_SCL, TWI_MUX_SERCOM },      // Sensors B
+};
 
 #define ledHb 14
 
@@ -38,14 +41,19 @@ void setup() {
   pinMode(ledHb, OUTPUT);
   digitalWrite(ledHb, HIGH);
 
-  portBackbone.setPinPeripheralStates();
-  portSensorsA.setPinPeripheralAltStates();
-  portSensorsB.setPinPeripheralStates();
+  TwiPinPair::applyAll(twiBuses);
 
   while (!Serial)
     ;
 
   Serial.println("Ready...");
+
+  // Quick startup enumeration: only the known addresses, at 400 kHz, no printing
+  WireScanResult found;
+  scannerSensorA.scanKnown(found);
+  Serial.print("Known devices on Sensors A: ");
+  Serial.println(found.count());
+  if (found.isPresent(0x68)) Serial.println(WireScanner::getDeviceName(0x68));
   delay(1500);
   digitalWrite(ledHb, LOW);
 
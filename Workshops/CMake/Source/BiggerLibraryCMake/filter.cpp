@@ -1,6 +1,44 @@
 // filter.cpp
 #include "filter.hpp"
 
+#include <cmath>
+
 float Filter::apply(float value) const {
     return value * FILTER_COEFFICIENT;
 }
+
+namespace {
+
+constexpr float PI = 3.14159265F;
+
+}  // namespace
+
+BiquadCoefficients BiquadCoefficients::lowPass(float sampleRateHz, float cutoffHz, float q) {
+    const float w0 = 2.0F * PI * cutoffHz / sampleRateHz;
+    const float cosW0 = std::cos(w0);
+    const float alpha = std::sin(w0) / (2.0F * q);
+    const float a0 = 1.0F + alpha;
+
+    return {
+        (1.0F - cosW0) / 2.0F / a0,
+        (1.0F - cosW0) / a0,
+        (1.0F - cosW0) / 2.0F / a0,
+        -2.0F * cosW0 / a0,
+        (1.0F - alpha) / a0
+    };
+}
+
+BiquadCoefficients BiquadCoefficients::notch(float sampleRateHz, float notchHz, float q) {
+    const float w0 = 2.0F * PI * notchHz / sampleRateHz;
+    const float cosW0 = std::cos(w0);
+    const float alpha = std::sin(w0) / (2.0F * q);
+    const float a0 = 1.0F + alpha;
+
+    return {
+        1.0F / a0,
+        -2.0F * cosW0 / a0,
+        1.0F / a0,
+        -2.0F * cosW0 / a0,
+        (1.0F - alpha) / a0
+    };
+}
@@ -1,6 +1,15 @@
 // filter.hpp
 #pragma once
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(FILTER_USE_CMSIS_DSP)
+#include "arm_math.h"
+#endif
+
 /// @brief Signal filtering utility
 /// @details Stateless filter - safe to copy and move
 class Filter {
@@ -22,3 +31,308 @@ public:
 private:
     static constexpr float FILTER_COEFFICIENT = 0.9F;
 };
+
+// ============================================================================
+// Stateful filters
+//
+// All filters below use fixed-size storage (no heap) and share the same
+// interface:
+//   T    process(T sample)                              one sample
+//   void process(const T* in, T* out, size_t count)     a block (in == out ok)
+//   void reset()
+// ============================================================================
+
+/// @brief Exponential moving average, alpha = 1 / 2^SHIFT
+/// @details Integer samples keep SHIFT extra fraction bits in the state,
+///          so the update is an add and a shift with no truncation bias.
+///          The first sample initialises the output (no start-up ramp).
+template<typename T, uint8_t SHIFT>
+class EmaFilter {
+public:
+    static_assert(std::is_arithmetic<T>::value, "EmaFilter needs a numeric sample type");
+    static_assert(SHIFT > 0U && SHIFT < 16U, "SHIFT must be 1..15");
+
+    T process(T sample) {
+        if constexpr (std::is_floating_point<T>::value) {
+            if (!primed_) {
+                state_ = sample;
+                primed_ = true;
+            } else {
+                state_ += (sample - state_) * ALPHA;
+            }
+            return state_;
+        } else {
+            const Accumulator scaled = static_cast<Accumulator>(sample) * (Accumulator{1} << SHIFT);
+            if (!primed_) {
+                state_ = scaled;
+                primed_ = true;
+            } else {
+                state_ += static_cast<Accumulator>(sample) - (state_ >> SHIFT);
+            }
+            return static_cast<T>(state_ >> SHIFT);
+        }
+    }
+
+    void process(const T* in, T* out, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = process(in[i]);
+        }
+    }
+
+    void reset() {
+        state_ = 0;
+        primed_ = false;
+    }
+
+private:
+    using Accumulator = std::conditional_t<std::is_floating_point<T>::value, T,
+                        std::conditional_t<(sizeof(T) < 4), int32_t, int64_t>>;
+
+    static constexpr T ALPHA = std::is_floating_point<T>::value
+                                   ? static_cast<T>(1.0 / static_cast<double>(1UL << SHIFT))
+                                   : T{};
+
+    Accumulator state_ = 0;
+    bool primed_ = false;
+};
+
+/// @brief Sliding median over the last N samples
+/// @details Keeps a sorted copy of the window next to the arrival-order
+///          ring: each sample costs one removal and one sorted insert,
+///          O(N) moves and no full sort. Removes spikes without smearing
+///          edges, unlike a moving average.
+template<typename T, size_t N>
+class MedianFilter {
+public:
+    static_assert(N >= 3U && (N % 2U) == 1U, "Median window must be odd and >= 3");
+
+    T process(T sample) {
+        size_t pos;
+        if (count_ < N) {
+            pos = count_++;
+        } else {
+            pos = find(ring_[head_]);  // Evict the oldest sample
+        }
+
+        // Shift to close the gap at 'pos' and open one where 'sample' belongs
+        while (pos > 0U && sorted_[pos - 1U] > sample) {
+            sorted_[pos] = sorted_[pos - 1U];
+            --pos;
+        }
+        while (pos + 1U < count_ && sorted_[pos + 1U] < sample) {
+            sorted_[pos] = sorted_[pos + 1U];
+            ++pos;
+        }
+        sorted_[pos] = sample;
+
+        ring_[head_] = sample;
+        head_ = (head_ + 1U) % N;
+
+        return sorted_[count_ / 2U];
+    }
+
+    void process(const T* in, T* out, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = process(in[i]);
+        }
+    }
+
+    void reset() {
+        head_ = 0;
+        count_ = 0;
+    }
+
+private:
+    size_t find(T value) const {
+        for (size_t i = 0; i < count_; ++i) {
+            if (!(sorted_[i] < value) && !(value < sorted_[i])) {
+                return i;
+            }
+        }
+        return count_ - 1U;  // Not reached for a consistent window
+    }
+
+    std::array<T, N> ring_{};
+    std::array<T, N> sorted_{};
+    size_t head_ = 0;
+    size_t count_ = 0;
+};
+
+/// @brief Normalised biquad coefficients (a0 == 1)
+/// @details y[n] = b0*x[n] + b1*x[n-1] + b2*x[n-2] - a1*y[n-1] - a2*y[n-2]
+struct BiquadCoefficients {
+    float b0;
+    float b1;
+    float b2;
+    float a1;
+    float a2;
+
+    /// @brief Second-order Butterworth-style low-pass (RBJ cookbook)
+    /// @param sampleRateHz Sample rate
+    /// @param cutoffHz -3 dB frequency (below sampleRateHz / 2)
+    /// @param q Quality factor, 0.7071 for Butterworth
+    static BiquadCoefficients lowPass(float sampleRateHz, float cutoffHz, float q = 0.70710678F);
+
+    /// @brief Notch, e.g. 50 or 60 Hz mains hum on an ECG channel
+    /// @param sampleRateHz Sample rate
+    /// @param notchHz Frequency to remove
+    /// @param q Quality factor; higher is narrower (30 suits mains hum)
+    static BiquadCoefficients notch(float sampleRateHz, float notchHz, float q = 30.0F);
+};
+
+/// @brief Cascade of STAGES biquad sections, float samples
+/// @details Transposed direct form II. With FILTER_USE_CMSIS_DSP defined the
+///          block process() runs on arm_biquad_cascade_df1_f32 instead.
+template<size_t STAGES, typename T = float>
+class BiquadCascade {
+public:
+    static_assert(std::is_same<T, float>::value,
+                  "Use float or int16_t (Q15 samples, Q14 coefficients)");
+
+    explicit BiquadCascade(const std::array<BiquadCoefficients, STAGES>& coefficients)
+        : coefficients_(coefficients)
+    {
+#if defined(FILTER_USE_CMSIS_DSP)
+        for (size_t s = 0; s < STAGES; ++s) {
+            // CMSIS adds the feedback terms: a1/a2 are negated
+            cmsisCoefficients_[s * 5U + 0U] = coefficients_[s].b0;
+            cmsisCoefficients_[s * 5U + 1U] = coefficients_[s].b1;
+            cmsisCoefficients_[s * 5U + 2U] = coefficients_[s].b2;
+            cmsisCoefficients_[s * 5U + 3U] = -coefficients_[s].a1;
+            cmsisCoefficients_[s * 5U + 4U] = -coefficients_[s].a2;
+        }
+        arm_biquad_cascade_df1_init_f32(&cmsis_, STAGES, cmsisCoefficients_.data(), cmsisState_.data());
+#endif
+        reset();
+    }
+
+    float process(float sample) {
+#if defined(FILTER_USE_CMSIS_DSP)
+        float out;
+        arm_biquad_cascade_df1_f32(&cmsis_, &sample, &out, 1U);
+        return out;
+#else
+        for (size_t s = 0; s < STAGES; ++s) {
+            const BiquadCoefficients& c = coefficients_[s];
+            State& z = state_[s];
+            const float y = c.b0 * sample + z.z1;
+            z.z1 = c.b1 * sample - c.a1 * y + z.z2;
+            z.z2 = c.b2 * sample - c.a2 * y;
+            sample = y;
+        }
+        return sample;
+#endif
+    }
+
+    void process(const float* in, float* out, size_t count) {
+#if defined(FILTER_USE_CMSIS_DSP)
+        arm_biquad_cascade_df1_f32(&cmsis_, const_cast<float*>(in), out, static_cast<uint32_t>(count));
+#else
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = process(in[i]);
+        }
+#endif
+    }
+
+    void reset() {
+#if defined(FILTER_USE_CMSIS_DSP)
+        cmsisState_.fill(0.0F);
+#else
+        state_.fill(State{});
+#endif
+    }
+
+private:
+    struct State {
+        float z1 = 0.0F;
+        float z2 = 0.0F;
+    };
+
+    std::array<BiquadCoefficients, STAGES> coefficients_;
+#if defined(FILTER_USE_CMSIS_DSP)
+    std::array<float, STAGES * 5U> cmsisCoefficients_{};
+    std::array<float, STAGES * 4U> cmsisState_{};
+    arm_biquad_casd_df1_inst_f32 cmsis_{};
+#else
+    std::array<State, STAGES> state_{};
+#endif
+};
+
+/// @brief Cascade of STAGES biquad sections, Q15 samples (int16_t)
+/// @details Direct form I with Q14 coefficients (range +/-2) and a 32-bit
+///          accumulator; the output of every stage saturates to int16_t.
+///          For targets without an FPU. Cut-offs far below the sample rate
+///          get small b coefficients: expect some DC gain error in Q14.
+template<size_t STAGES>
+class BiquadCascade<STAGES, int16_t> {
+public:
+    static constexpr uint8_t COEFFICIENT_FRACTION_BITS = 14U;
+
+    explicit BiquadCascade(const std::array<BiquadCoefficients, STAGES>& coefficients) {
+        for (size_t s = 0; s < STAGES; ++s) {
+            coefficients_[s] = {toQ14(coefficients[s].b0), toQ14(coefficients[s].b1),
+                                toQ14(coefficients[s].b2), toQ14(coefficients[s].a1),
+                                toQ14(coefficients[s].a2)};
+        }
+        reset();
+    }
+
+    int16_t process(int16_t sample) {
+        for (size_t s = 0; s < STAGES; ++s) {
+            const Q14Coefficients& c = coefficients_[s];
+            State& z = state_[s];
+            int64_t acc = static_cast<int64_t>(c.b0) * sample
+                        + static_cast<int64_t>(c.b1) * z.x1
+                        + static_cast<int64_t>(c.b2) * z.x2
+                        - static_cast<int64_t>(c.a1) * z.y1
+                        - static_cast<int64_t>(c.a2) * z.y2;
+            acc += int64_t{1} << (COEFFICIENT_FRACTION_BITS - 1U);  // Round
+            const int16_t y = saturate(acc >> COEFFICIENT_FRACTION_BITS);
+
+            z.x2 = z.x1;
+            z.x1 = sample;
+            z.y2 = z.y1;
+            z.y1 = y;
+            sample = y;
+        }
+        return sample;
+    }
+
+    void process(const int16_t* in, int16_t* out, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = process(in[i]);
+        }
+    }
+
+    void reset() {
+        state_.fill(State{});
+    }
+
+private:
+    struct Q14Coefficients {
+        int16_t b0, b1, b2, a1, a2;
+    };
+
+    struct State {
+        int16_t x1 = 0;
+        int16_t x2 = 0;
+        int16_t y1 = 0;
+        int16_t y2 = 0;
+    };
+
+    static int16_t toQ14(float value) {
+        const float scaled = value * static_cast<float>(1U << COEFFICIENT_FRACTION_BITS);
+        if (scaled >= 32767.0F) return INT16_MAX;
+        if (scaled <= -32768.0F) return INT16_MIN;
+        return static_cast<int16_t>(scaled < 0.0F ? scaled - 0.5F : scaled + 0.5F);
+    }
+
+    static int16_t saturate(int64_t value) {
+        if (value > INT16_MAX) return INT16_MAX;
+        if (value < INT16_MIN) return INT16_MIN;
+        return static_cast<int16_t>(value);
+    }
+
+    std::array<Q14Coefficients, STAGES> coefficients_{};
+    std::array<State, STAGES> state_{};
+};
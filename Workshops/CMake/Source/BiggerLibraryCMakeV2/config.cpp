@@ -1,15 +1,6 @@
 // config.cpp
 #include "config.hpp"
 
-Config::Config() {
-    // RAII: Configuration loaded on construction
-    // In real implementation, would read from file/EEPROM
-}
-
-int32_t Config::getSampleRate() const {
-    return DEFAULT_SAMPLE_RATE_MS;
-}
-
-bool Config::isDebugMode() const {
-    return DEFAULT_DEBUG_MODE;
-}
+// Getters are inline in config.hpp: a default is a constant, an override
+// one read from the mapped ConfigStore page. Nothing to load here.
+static_assert(Config::DEFAULT_SAMPLE_RATE_MS > 0, "sample rate must be positive");
@@ -0,0 +1,205 @@
+// config_store.cpp
+#include "config_store.hpp"
+
+#include <array>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr uint8_t ERASED = 0xFF;
+
+constexpr std::array<uint32_t, 256> makeCrcTable() {
+    std::array<uint32_t, 256> table{};
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t c = i;
+        for (int bit = 0; bit < 8; ++bit) {
+            c = (c & 1U) ? (0xEDB88320U ^ (c >> 1)) : (c >> 1);
+        }
+        table[i] = c;
+    }
+    return table;
+}
+
+constexpr std::array<uint32_t, 256> CRC_TABLE = makeCrcTable();
+
+bool isErased(const void* bytes, std::size_t length) {
+    const auto* p = static_cast<const uint8_t*>(bytes);
+    for (std::size_t i = 0; i < length; ++i) {
+        if (p[i] != ERASED) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+uint32_t crc32(const void* data, std::size_t length) {
+    const auto* p = static_cast<const uint8_t*>(data);
+    uint32_t crc = 0xFFFFFFFFU;
+    for (std::size_t i = 0; i < length; ++i) {
+        crc = CRC_TABLE[(crc ^ p[i]) & 0xFFU] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFU;
+}
+
+// --- MappedFileFlash ---
+
+MappedFileFlash::MappedFileFlash(const std::string& path, std::size_t size) {
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd_ < 0) {
+        return;
+    }
+
+    struct stat info {};
+    const bool fresh = ::fstat(fd_, &info) == 0 && info.st_size == 0;
+    if (fresh && ::ftruncate(fd_, static_cast<off_t>(size)) != 0) {
+        return;
+    }
+
+    void* map = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (map == MAP_FAILED) {
+        return;
+    }
+    map_ = static_cast<uint8_t*>(map);
+    size_ = size;
+    if (fresh) {
+        erase();  // A new file is an erased page
+    }
+}
+
+MappedFileFlash::~MappedFileFlash() {
+    if (map_ != nullptr) {
+        ::munmap(map_, size_);
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+}
+
+bool MappedFileFlash::isOpen() const {
+    return map_ != nullptr;
+}
+
+const uint8_t* MappedFileFlash::data() const {
+    return map_;
+}
+
+std::size_t MappedFileFlash::size() const {
+    return size_;
+}
+
+bool MappedFileFlash::erase() {
+    if (map_ == nullptr) {
+        return false;
+    }
+    std::memset(map_, ERASED, size_);
+    return ::msync(map_, size_, MS_SYNC) == 0;
+}
+
+bool MappedFileFlash::program(std::size_t offset, const void* bytes, std::size_t length) {
+    if (map_ == nullptr || offset + length > size_ || !isErased(map_ + offset, length)) {
+        return false;
+    }
+    std::memcpy(map_ + offset, bytes, length);
+    return ::msync(map_, size_, MS_SYNC) == 0;
+}
+
+// --- ConfigStore ---
+
+ConfigStore::ConfigStore(FlashRegion& flash) : flash_(flash) {
+    if (flash_.data() == nullptr) {
+        return;
+    }
+    // Records are appended in order: everything before the first erased
+    // slot has been written, the newest one with a good CRC wins
+    while (next_ < capacity() && !isErased(slot(next_), sizeof(ConfigRecord))) {
+        ++next_;
+    }
+    for (std::size_t i = next_; i > 0; --i) {
+        if (isValid(*slot(i - 1))) {
+            active_ = slot(i - 1);
+            break;
+        }
+    }
+}
+
+bool ConfigStore::setSampleRate(int32_t sampleRateMs) {
+    ConfigRecord record = current();
+    record.present |= ConfigRecord::HAS_SAMPLE_RATE;
+    record.sampleRateMs = sampleRateMs;
+    return append(record);
+}
+
+bool ConfigStore::setDebugMode(bool debugMode) {
+    ConfigRecord record = current();
+    record.present |= ConfigRecord::HAS_DEBUG_MODE;
+    record.debugMode = debugMode ? 1U : 0U;
+    return append(record);
+}
+
+bool ConfigStore::clear() {
+    ConfigRecord record = current();
+    record.present = 0;
+    return append(record);
+}
+
+std::size_t ConfigStore::capacity() const {
+    return flash_.size() / sizeof(ConfigRecord);
+}
+
+uint16_t ConfigStore::getEraseCount() const {
+    return active_ != nullptr ? active_->eraseCount : 0;
+}
+
+bool ConfigStore::append(ConfigRecord record) {
+    if (flash_.data() == nullptr || capacity() == 0) {
+        return false;
+    }
+    if (active_ != nullptr && std::memcmp(active_, &record, offsetof(ConfigRecord, crc)) == 0) {
+        return true;  // Unchanged: no flash write at all
+    }
+    if (next_ >= capacity()) {
+        // Page full: the only erase, once per capacity() writes
+        if (!flash_.erase()) {
+            return false;
+        }
+        ++record.eraseCount;
+        active_ = nullptr;
+        next_ = 0;
+    }
+
+    record.crc = crc32(&record, offsetof(ConfigRecord, crc));
+    const std::size_t offset = next_ * sizeof(ConfigRecord);
+    ++next_;  // Even a failed write has used the slot
+    if (!flash_.program(offset, &record, sizeof(record))) {
+        return false;
+    }
+    active_ = slot(next_ - 1);
+    return true;
+}
+
+ConfigRecord ConfigStore::current() const {
+    if (active_ != nullptr) {
+        return *active_;
+    }
+    ConfigRecord record{};
+    record.magic = ConfigRecord::MAGIC;
+    record.version = ConfigRecord::LAYOUT_VERSION;
+    return record;
+}
+
+const ConfigRecord* ConfigStore::slot(std::size_t index) const {
+    return reinterpret_cast<const ConfigRecord*>(flash_.data() + index * sizeof(ConfigRecord));
+}
+
+bool ConfigStore::isValid(const ConfigRecord& record) {
+    return record.magic == ConfigRecord::MAGIC &&
+           record.version == ConfigRecord::LAYOUT_VERSION &&
+           record.crc == crc32(&record, offsetof(ConfigRecord, crc));
+}
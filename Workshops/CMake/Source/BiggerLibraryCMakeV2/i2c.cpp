@@ -1,16 +1,44 @@
 // i2c.cpp
 #include "i2c.hpp"
 
-I2C::I2C() {
-    // RAII: I2C bus initialized on construction
-    // In real implementation, would configure hardware registers
+#include <fcntl.h>
+#include <linux/i2c-dev.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+I2C::I2C(const std::string& device) {
+    // RAII: I2C bus opened on construction
+    fd_ = ::open(device.c_str(), O_RDWR);
+}
+
+I2C::~I2C() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+}
+
+bool I2C::isOpen() const {
+    return fd_ >= 0;
+}
+
+bool I2C::select(uint8_t address) {
+    if (fd_ < 0) {
+        return false;
+    }
+    if (address_ != address) {
+        if (::ioctl(fd_, I2C_SLAVE, address) < 0) {
+            address_ = NO_ADDRESS;
+            return false;
+        }
+        address_ = address;
+    }
+    return true;
 }
 
-void I2C::write([[maybe_unused]] uint8_t data) {
-    // Simulated write operation
-    // In real implementation, would write to I2C data register
+bool I2C::write(uint8_t address, const uint8_t* data, std::size_t length) {
+    return select(address) && ::write(fd_, data, length) == static_cast<ssize_t>(length);
 }
 
-uint8_t I2C::read() const {
-    return SIMULATED_READ_VALUE;
+bool I2C::read(uint8_t address, uint8_t* data, std::size_t length) {
+    return select(address) && ::read(fd_, data, length) == static_cast<ssize_t>(length);
 }
@@ -3,12 +3,23 @@
 
 #include <cstdint>
 
+#include "config_store.hpp"
+
 /// @brief Configuration management
-/// @details Follows RAII - configuration loaded on construction
+/// @details Defaults are compile-time constants. Overrides, if any, are
+/// read in place from the active ConfigStore record: nothing is loaded or
+/// copied at startup, and a setting that was never changed costs no RAM.
 class Config {
 public:
-    /// @brief Load configuration on construction
-    Config();
+    static constexpr int32_t DEFAULT_SAMPLE_RATE_MS = 1000;
+    static constexpr bool DEFAULT_DEBUG_MODE = true;
+
+    /// @brief Defaults only
+    constexpr Config() = default;
+
+    /// @brief Defaults with the overrides in store
+    explicit constexpr Config(const ConfigStore& store) : store_(&store) {}
+
     ~Config() = default;
 
     // Explicitly default copy/move operations (Rule of Five)
@@ -19,13 +30,24 @@ public:
 
     /// @brief Get sensor sampling rate
     /// @return Sample rate in milliseconds
-    int32_t getSampleRate() const;
+    int32_t getSampleRate() const {
+        const ConfigRecord* record = overrides();
+        return (record != nullptr && (record->present & ConfigRecord::HAS_SAMPLE_RATE) != 0)
+            ? record->sampleRateMs : DEFAULT_SAMPLE_RATE_MS;
+    }
 
     /// @brief Check if debug mode is enabled
     /// @return true if debug mode is enabled, false otherwise
-    bool isDebugMode() const;
+    bool isDebugMode() const {
+        const ConfigRecord* record = overrides();
+        return (record != nullptr && (record->present & ConfigRecord::HAS_DEBUG_MODE) != 0)
+            ? record->debugMode != 0 : DEFAULT_DEBUG_MODE;
+    }
 
 private:
-    static constexpr int32_t DEFAULT_SAMPLE_RATE_MS = 1000;
-    static constexpr bool DEFAULT_DEBUG_MODE = true;
+    const ConfigRecord* overrides() const {
+        return store_ != nullptr ? store_->active() : nullptr;
+    }
+
+    const ConfigStore* store_ = nullptr;
 };
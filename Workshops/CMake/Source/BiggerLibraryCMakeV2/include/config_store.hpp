@@ -0,0 +1,124 @@
+// config_store.hpp
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/// @brief A page of flash (or a file standing in for it on the host)
+/// @details The contents are memory-mapped: data() is read in place.
+/// Like flash, programming only works on erased (0xFF) bytes.
+class FlashRegion {
+public:
+    virtual ~FlashRegion() = default;
+
+    /// @brief Memory-mapped contents, size() bytes
+    virtual const uint8_t* data() const = 0;
+    virtual std::size_t size() const = 0;
+
+    /// @brief Set every byte to 0xFF
+    virtual bool erase() = 0;
+
+    /// @brief Write bytes into erased space
+    virtual bool program(std::size_t offset, const void* bytes, std::size_t length) = 0;
+};
+
+/// @brief Host stand-in for a flash page: a file mapped with mmap()
+/// @details Follows RAII - mapped on construction, unmapped on destruction
+class MappedFileFlash : public FlashRegion {
+public:
+    static constexpr std::size_t DEFAULT_SIZE = 1024;
+
+    /// @brief Map path, creating an erased file of size bytes if needed
+    explicit MappedFileFlash(const std::string& path, std::size_t size = DEFAULT_SIZE);
+    ~MappedFileFlash() override;
+
+    // Owns the mapping: not copyable or movable
+    MappedFileFlash(const MappedFileFlash&) = delete;
+    MappedFileFlash& operator=(const MappedFileFlash&) = delete;
+    MappedFileFlash(MappedFileFlash&&) = delete;
+    MappedFileFlash& operator=(MappedFileFlash&&) = delete;
+
+    /// @brief Check if the file could be mapped
+    bool isOpen() const;
+
+    const uint8_t* data() const override;
+    std::size_t size() const override;
+    bool erase() override;
+    bool program(std::size_t offset, const void* bytes, std::size_t length) override;
+
+private:
+    int fd_ = -1;
+    uint8_t* map_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+/// @brief One version of the overrides, as stored in the page
+struct ConfigRecord {
+    static constexpr uint32_t MAGIC = 0x43464731U;  // "CFG1"
+    static constexpr uint16_t LAYOUT_VERSION = 1;
+
+    // Bits in present: a field without its bit keeps the constexpr default
+    static constexpr uint32_t HAS_SAMPLE_RATE = 1U << 0;
+    static constexpr uint32_t HAS_DEBUG_MODE = 1U << 1;
+
+    uint32_t magic;
+    uint16_t version;
+    uint16_t eraseCount;   // Page erases so far (wear statistics)
+    uint32_t present;
+    int32_t sampleRateMs;
+    uint8_t debugMode;
+    uint8_t reserved[3];
+    uint32_t crc;          // CRC-32 of all bytes before it
+};
+static_assert(sizeof(ConfigRecord) == 24, "ConfigRecord layout is stored in flash");
+
+/// @brief Versioned, CRC-protected overrides in one flash page
+/// @details Records are appended one after the other; the last valid one
+/// is active and is read in place from the mapped page (no copy in RAM).
+/// Only when the page is full is it erased, so every byte of the page
+/// wears evenly. A torn write fails its CRC and the previous record
+/// stays active; power loss between an erase and the next write falls
+/// back to the defaults.
+class ConfigStore {
+public:
+    /// @brief Find the active record (one pass over the record headers)
+    explicit ConfigStore(FlashRegion& flash);
+    ~ConfigStore() = default;
+
+    // Refers to the flash region: not copyable or movable
+    ConfigStore(const ConfigStore&) = delete;
+    ConfigStore& operator=(const ConfigStore&) = delete;
+    ConfigStore(ConfigStore&&) = delete;
+    ConfigStore& operator=(ConfigStore&&) = delete;
+
+    /// @brief Active record in the mapped page, nullptr if none
+    const ConfigRecord* active() const { return active_; }
+
+    /// @brief Store a new override (appends a record)
+    /// @return false if the flash could not be written
+    bool setSampleRate(int32_t sampleRateMs);
+    bool setDebugMode(bool debugMode);
+
+    /// @brief Drop all overrides (back to the constexpr defaults)
+    bool clear();
+
+    /// @brief Record slots in the page
+    std::size_t capacity() const;
+
+    /// @brief Page erases so far
+    uint16_t getEraseCount() const;
+
+private:
+    bool append(ConfigRecord record);
+    ConfigRecord current() const;
+    const ConfigRecord* slot(std::size_t index) const;
+    static bool isValid(const ConfigRecord& record);
+
+    FlashRegion& flash_;
+    const ConfigRecord* active_ = nullptr;
+    std::size_t next_ = 0;  // First erased slot
+};
+
+/// @brief CRC-32 (IEEE 802.3), table generated at compile time
+uint32_t crc32(const void* data, std::size_t length);
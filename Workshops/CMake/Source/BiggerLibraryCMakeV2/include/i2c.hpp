@@ -1,30 +1,53 @@
 // i2c.hpp
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <string>
 
-/// @brief I2C Communication Interface
-/// @details Follows RAII - bus is initialized on construction
-class I2C {
+/// @brief I2C bus: whole transfers to one device address
+/// @details A transfer is one START..STOP transaction; a device that does
+/// not acknowledge (e.g. a sensor still converting) makes it return false.
+class I2CBus {
 public:
-    /// @brief Initialize I2C bus on construction
-    I2C();
-    ~I2C() = default;
+    virtual ~I2CBus() = default;
 
-    // Explicitly default copy/move operations (Rule of Five)
-    I2C(const I2C&) = default;
-    I2C& operator=(const I2C&) = default;
-    I2C(I2C&&) = default;
-    I2C& operator=(I2C&&) = default;
+    /// @brief Write length bytes to the device at address
+    /// @return false on NACK or bus error
+    virtual bool write(uint8_t address, const uint8_t* data, std::size_t length) = 0;
 
-    /// @brief Write single byte to I2C bus
-    /// @param data Byte to write
-    void write(uint8_t data);
+    /// @brief Read length bytes from the device at address
+    /// @return false on NACK or bus error
+    virtual bool read(uint8_t address, uint8_t* data, std::size_t length) = 0;
+};
+
+/// @brief Linux I2C bus through the i2c-dev driver (/dev/i2c-N)
+/// @details Follows RAII - bus is opened on construction, closed on destruction
+class I2C : public I2CBus {
+public:
+    static constexpr const char* DEFAULT_DEVICE = "/dev/i2c-1";
+
+    /// @brief Open the i2c-dev device
+    explicit I2C(const std::string& device = DEFAULT_DEVICE);
+    ~I2C() override;
 
-    /// @brief Read single byte from I2C bus
-    /// @return Byte read from bus
-    uint8_t read() const;
+    // Owns the file descriptor: not copyable or movable
+    I2C(const I2C&) = delete;
+    I2C& operator=(const I2C&) = delete;
+    I2C(I2C&&) = delete;
+    I2C& operator=(I2C&&) = delete;
+
+    /// @brief Check if the bus could be opened
+    bool isOpen() const;
+
+    bool write(uint8_t address, const uint8_t* data, std::size_t length) override;
+    bool read(uint8_t address, uint8_t* data, std::size_t length) override;
 
 private:
-    static constexpr uint8_t SIMULATED_READ_VALUE = 0x42U;
+    bool select(uint8_t address);
+
+    static constexpr int NO_ADDRESS = -1;
+
+    int fd_ = -1;
+    int address_ = NO_ADDRESS;  // Device the driver currently talks to
 };
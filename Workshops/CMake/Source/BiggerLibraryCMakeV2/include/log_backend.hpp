@@ -0,0 +1,91 @@
+// log_backend.hpp
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// 1 = host: a background thread drains the ring
+// 0 = MCU: call LogBackend::instance().drain() from the idle loop
+#ifndef LOG_BACKGROUND_THREAD
+#define LOG_BACKGROUND_THREAD 1
+#endif
+
+#if LOG_BACKGROUND_THREAD
+#include <thread>
+#endif
+
+/// @brief Log severity, lowest first
+enum class LogLevel : uint8_t {
+    Debug,
+    Info,
+    Warning,
+    Error
+};
+
+/// @brief Buffered log output shared by all Logger objects
+/// @details Messages are copied into a preallocated ring of fixed-size
+/// records (bounded lock-free MPMC queue), so logging never allocates,
+/// never locks and never waits for the console. The records are written
+/// out by drain(): from a background thread on the host
+/// (LOG_BACKGROUND_THREAD=1), or from the idle loop on an MCU.
+/// A full ring drops the message and counts it.
+class LogBackend {
+public:
+    static constexpr std::size_t CAPACITY = 64;       // Records, power of two
+    static constexpr std::size_t MESSAGE_SIZE = 120;  // Characters per record
+
+    /// @brief The process-wide backend (started on first use)
+    static LogBackend& instance();
+
+    /// @brief Stops the background thread and writes what is left
+    ~LogBackend();
+
+    LogBackend(const LogBackend&) = delete;
+    LogBackend& operator=(const LogBackend&) = delete;
+    LogBackend(LogBackend&&) = delete;
+    LogBackend& operator=(LogBackend&&) = delete;
+
+    /// @brief Queue a message; safe from any thread, never blocks
+    /// @return false if the ring was full and the message was dropped
+    bool push(LogLevel level, std::string_view text);
+
+    /// @brief Write all queued messages to the console
+    /// @details Called by the background thread; without it, call this
+    /// from one place (the idle loop) only
+    /// @return Number of messages written
+    std::size_t drain();
+
+    /// @brief Messages lost because the ring was full
+    uint32_t getDropped() const;
+
+private:
+    LogBackend();
+
+    struct Slot {
+        std::atomic<std::size_t> sequence;
+        LogLevel level;
+        uint8_t length;
+        std::array<char, MESSAGE_SIZE> text;
+    };
+
+#if LOG_BACKGROUND_THREAD
+    void run();
+#endif
+
+    static_assert((CAPACITY & (CAPACITY - 1)) == 0, "CAPACITY must be a power of two");
+    static_assert(MESSAGE_SIZE <= 255, "length is stored in one byte");
+
+    std::array<Slot, CAPACITY> slots_;
+    alignas(64) std::atomic<std::size_t> enqueuePos_{0};
+    alignas(64) std::atomic<std::size_t> dequeuePos_{0};
+    std::atomic<uint32_t> dropped_{0};
+    uint32_t reportedDrops_ = 0;
+
+#if LOG_BACKGROUND_THREAD
+    std::atomic<bool> running_{false};
+    std::thread worker_;
+#endif
+};
@@ -1,10 +1,54 @@
 // logger.hpp
 #pragma once
 
-#include <string>
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <string_view>
+#include <type_traits>
+
+#include "log_backend.hpp"
+
+// Messages below this level are removed at compile time:
+// 0 = Debug, 1 = Info, 2 = Warning, 3 = Error. Release builds (NDEBUG)
+// drop debug messages unless overridden with -DLOG_MIN_LEVEL=0.
+#ifndef LOG_MIN_LEVEL
+#ifdef NDEBUG
+#define LOG_MIN_LEVEL 1
+#else
+#define LOG_MIN_LEVEL 0
+#endif
+#endif
+
+/// @brief Formats one message into a fixed buffer (no heap)
+/// @details Text that does not fit is cut off
+class LogMessage {
+public:
+    void append(std::string_view text);
+    void append(const char* text) { append(std::string_view(text)); }
+    void append(char c) { append(std::string_view(&c, 1)); }
+    void append(bool value) { append(value ? std::string_view("true") : std::string_view("false")); }
+    void append(double value);
+
+    template <typename T, typename std::enable_if<std::is_integral<T>::value, int>::type = 0>
+    void append(T value) {
+        const auto result = std::to_chars(buffer_.data() + length_, buffer_.data() + buffer_.size(), value);
+        if (result.ec == std::errc()) {
+            length_ = static_cast<std::size_t>(result.ptr - buffer_.data());
+        }
+    }
+
+    std::string_view view() const { return std::string_view(buffer_.data(), length_); }
+
+private:
+    std::array<char, LogBackend::MESSAGE_SIZE> buffer_{};
+    std::size_t length_ = 0;
+};
 
 /// @brief Simple logging utility
-/// @details Stateless logger - safe to copy and move
+/// @details Stateless logger - safe to copy and move. Arguments are
+/// concatenated in order, e.g. logger.log("Temperature: ", temp, " C").
+/// Messages go to the buffered LogBackend and are written out later.
 class Logger {
 public:
     Logger() = default;
@@ -16,11 +60,33 @@ public:
     Logger(Logger&&) = default;
     Logger& operator=(Logger&&) = default;
 
+    /// @brief Log debug message (removed when LOG_MIN_LEVEL > 0)
+    /// @param args Message parts
+    template <typename... Args>
+    void debug(const Args&... args) const { write<LogLevel::Debug>(args...); }
+
     /// @brief Log informational message
-    /// @param message Message to log
-    void log(const std::string& message) const;
+    /// @param args Message parts
+    template <typename... Args>
+    void log(const Args&... args) const { write<LogLevel::Info>(args...); }
+
+    /// @brief Log warning message
+    /// @param args Message parts
+    template <typename... Args>
+    void warning(const Args&... args) const { write<LogLevel::Warning>(args...); }
 
     /// @brief Log error message
-    /// @param message Error message to log
-    void error(const std::string& message) const;
+    /// @param args Error message parts
+    template <typename... Args>
+    void error(const Args&... args) const { write<LogLevel::Error>(args...); }
+
+private:
+    template <LogLevel Level, typename... Args>
+    void write(const Args&... args) const {
+        if constexpr (static_cast<int>(Level) >= LOG_MIN_LEVEL) {
+            LogMessage message;
+            (message.append(args), ...);
+            LogBackend::instance().push(Level, message.view());
+        }
+    }
 };
@@ -0,0 +1,380 @@
+// pipeline.hpp
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Items per batch between two stages (fixed, no heap per batch)
+#ifndef PIPELINE_BATCH_CAPACITY
+#define PIPELINE_BATCH_CAPACITY 16
+#endif
+
+/// @brief Statically composed processing chains
+/// @details A pipeline is written as
+///     source("sensor", s) | stage("filter", f) | async<4>("queue") | sink("log", k)
+/// and each | produces a new type, so the whole chain is one object with
+/// no virtual calls. Data moves in Batch<T> blocks of at most
+/// BATCH_CAPACITY items; every stage owns the buffer for its input.
+///
+/// - A source has `using value_type = T;` and `bool read(Batch<T>&)`,
+///   returning false when the stream has ended.
+/// - A stage is any callable T -> U.
+/// - A sink has `void write(const Batch<T>&)`.
+/// - async<DEPTH>() runs everything before it on its own thread, passing
+///   batches through a lock-free queue of DEPTH batches (host builds).
+///
+/// Every node counts items, batches and the time it spent (for async: the
+/// time the downstream side waited), see Pipeline::stats().
+namespace pipeline {
+
+constexpr std::size_t BATCH_CAPACITY = PIPELINE_BATCH_CAPACITY;
+
+/// @brief Fixed-capacity block of items
+template <typename T>
+class Batch {
+public:
+    using value_type = T;
+
+    bool push(const T& item) {
+        if (size_ == BATCH_CAPACITY) {
+            return false;
+        }
+        items_[size_++] = item;
+        return true;
+    }
+
+    void clear() { size_ = 0; }
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    bool full() const { return size_ == BATCH_CAPACITY; }
+
+    const T& operator[](std::size_t index) const { return items_[index]; }
+    const T* begin() const { return items_.data(); }
+    const T* end() const { return items_.data() + size_; }
+
+private:
+    std::array<T, BATCH_CAPACITY> items_{};
+    std::size_t size_ = 0;
+};
+
+/// @brief Throughput of one node
+struct StageStats {
+    std::string_view name;
+    uint64_t items;
+    uint64_t batches;
+    std::chrono::nanoseconds busy;
+
+    /// @brief Items per second of busy time (0 if not measurable)
+    double itemsPerSecond() const {
+        return busy.count() > 0 ? static_cast<double>(items) * 1e9 / static_cast<double>(busy.count()) : 0.0;
+    }
+};
+
+/// @brief Counters of one node; atomic because an async node's upstream
+/// counts on its own thread while stats() is read on the caller's
+class Counters {
+public:
+    Counters() = default;
+    Counters(const Counters& other)
+        : items_(other.items_.load(std::memory_order_relaxed)),
+          batches_(other.batches_.load(std::memory_order_relaxed)),
+          busyNs_(other.busyNs_.load(std::memory_order_relaxed)) {}
+    Counters& operator=(const Counters&) = delete;
+
+    void add(std::size_t items, std::chrono::steady_clock::duration busy) {
+        items_.fetch_add(items, std::memory_order_relaxed);
+        batches_.fetch_add(1, std::memory_order_relaxed);
+        busyNs_.fetch_add(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(busy).count()),
+                          std::memory_order_relaxed);
+    }
+
+    StageStats snapshot(std::string_view name) const {
+        return StageStats{name, items_.load(std::memory_order_relaxed), batches_.load(std::memory_order_relaxed),
+                          std::chrono::nanoseconds(busyNs_.load(std::memory_order_relaxed))};
+    }
+
+private:
+    std::atomic<uint64_t> items_{0};
+    std::atomic<uint64_t> batches_{0};
+    std::atomic<uint64_t> busyNs_{0};
+};
+
+using Clock = std::chrono::steady_clock;
+
+// --- Building blocks written by the user (see source(), stage(), ...) ---
+
+template <typename S>
+struct SourceSpec {
+    std::string_view name;
+    S source;
+};
+
+template <typename F>
+struct StageSpec {
+    std::string_view name;
+    F function;
+};
+
+template <typename K>
+struct SinkSpec {
+    std::string_view name;
+    K sink;
+};
+
+template <std::size_t DEPTH>
+struct AsyncSpec {
+    std::string_view name;
+};
+
+template <typename S>
+SourceSpec<std::decay_t<S>> source(std::string_view name, S&& s) {
+    return {name, std::forward<S>(s)};
+}
+
+template <typename F>
+StageSpec<std::decay_t<F>> stage(std::string_view name, F&& f) {
+    return {name, std::forward<F>(f)};
+}
+
+template <typename K>
+SinkSpec<std::decay_t<K>> sink(std::string_view name, K&& k) {
+    return {name, std::forward<K>(k)};
+}
+
+template <std::size_t DEPTH>
+AsyncSpec<DEPTH> async(std::string_view name = "async") {
+    static_assert(DEPTH > 0, "async: DEPTH must be at least one batch");
+    return {name};
+}
+
+// --- Nodes: what the | operators build ---
+
+template <typename S>
+class SourceNode {
+public:
+    using value_type = typename S::value_type;
+
+    explicit SourceNode(SourceSpec<S> spec) : name_(spec.name), source_(std::move(spec.source)) {}
+
+    bool read(Batch<value_type>& out) {
+        out.clear();
+        const auto start = Clock::now();
+        const bool more = source_.read(out);
+        if (more || !out.empty()) {
+            counters_.add(out.size(), Clock::now() - start);
+        }
+        return more;
+    }
+
+    void collect(std::vector<StageStats>& stats) const { stats.push_back(counters_.snapshot(name_)); }
+
+private:
+    std::string_view name_;
+    S source_;
+    Counters counters_;
+};
+
+template <typename Up, typename F>
+class StageNode {
+public:
+    using input_type = typename Up::value_type;
+    using value_type = std::decay_t<std::invoke_result_t<F&, const input_type&>>;
+
+    StageNode(Up upstream, StageSpec<F> spec)
+        : upstream_(std::move(upstream)), name_(spec.name), function_(std::move(spec.function)) {}
+
+    bool read(Batch<value_type>& out) {
+        out.clear();
+        if (!upstream_.read(input_)) {
+            return false;
+        }
+        const auto start = Clock::now();
+        for (const input_type& item : input_) {
+            out.push(function_(item));
+        }
+        counters_.add(out.size(), Clock::now() - start);
+        return true;
+    }
+
+    void collect(std::vector<StageStats>& stats) const {
+        upstream_.collect(stats);
+        stats.push_back(counters_.snapshot(name_));
+    }
+
+private:
+    Up upstream_;
+    std::string_view name_;
+    F function_;
+    Batch<input_type> input_;
+    Counters counters_;
+};
+
+/// @brief Thread boundary: upstream runs on a worker thread
+/// @details The worker is started on the first read(), so the node can be
+/// moved around while the pipeline is being composed.
+template <typename Up, std::size_t DEPTH>
+class AsyncNode {
+public:
+    using value_type = typename Up::value_type;
+
+    AsyncNode(Up upstream, AsyncSpec<DEPTH> spec)
+        : name_(spec.name), shared_(std::make_unique<Shared>(std::move(upstream))) {}
+
+    ~AsyncNode() {
+        if (worker_.joinable()) {
+            shared_->stop.store(true, std::memory_order_relaxed);
+            worker_.join();
+        }
+    }
+
+    AsyncNode(AsyncNode&&) = default;
+    AsyncNode(const AsyncNode&) = delete;
+    AsyncNode& operator=(const AsyncNode&) = delete;
+    AsyncNode& operator=(AsyncNode&&) = delete;
+
+    bool read(Batch<value_type>& out) {
+        if (!worker_.joinable()) {
+            worker_ = std::thread(&Shared::produce, shared_.get());
+        }
+
+        const auto start = Clock::now();
+        Shared& s = *shared_;
+        const std::size_t tail = s.tail.load(std::memory_order_relaxed);
+        while (s.head.load(std::memory_order_acquire) == tail) {
+            // done is set after the last head update: re-check once it is seen
+            if (s.done.load(std::memory_order_acquire) && s.head.load(std::memory_order_acquire) == tail) {
+                return false;
+            }
+            std::this_thread::yield();
+        }
+        out = s.slots[tail % DEPTH];
+        s.tail.store(tail + 1, std::memory_order_release);
+        counters_.add(out.size(), Clock::now() - start);
+        return true;
+    }
+
+    void collect(std::vector<StageStats>& stats) const {
+        shared_->upstream.collect(stats);
+        stats.push_back(counters_.snapshot(name_));
+    }
+
+private:
+    // Single producer (worker), single consumer (read); indices only grow
+    struct Shared {
+        explicit Shared(Up up) : upstream(std::move(up)) {}
+
+        void produce() {
+            while (!stop.load(std::memory_order_relaxed)) {
+                const std::size_t at = head.load(std::memory_order_relaxed);
+                if (at - tail.load(std::memory_order_acquire) == DEPTH) {
+                    std::this_thread::yield();  // Queue full
+                    continue;
+                }
+                if (!upstream.read(slots[at % DEPTH])) {
+                    break;
+                }
+                head.store(at + 1, std::memory_order_release);
+            }
+            done.store(true, std::memory_order_release);
+        }
+
+        Up upstream;
+        std::array<Batch<value_type>, DEPTH> slots{};
+        std::atomic<std::size_t> head{0};
+        std::atomic<std::size_t> tail{0};
+        std::atomic<bool> done{false};
+        std::atomic<bool> stop{false};
+    };
+
+    std::string_view name_;
+    std::unique_ptr<Shared> shared_;
+    std::thread worker_;
+    Counters counters_;
+};
+
+/// @brief A complete chain: run() pulls batches from the source side
+/// into the sink until the stream ends or maxBatches were delivered
+template <typename Up, typename K>
+class Pipeline {
+public:
+    using value_type = typename Up::value_type;
+
+    static constexpr std::size_t UNLIMITED = std::numeric_limits<std::size_t>::max();
+
+    Pipeline(Up upstream, SinkSpec<K> spec)
+        : upstream_(std::move(upstream)), name_(spec.name), sink_(std::move(spec.sink)) {}
+
+    /// @brief Run the chain
+    /// @return Items delivered to the sink
+    std::size_t run(std::size_t maxBatches = UNLIMITED) {
+        std::size_t items = 0;
+        for (std::size_t batches = 0; batches < maxBatches && upstream_.read(buffer_); ++batches) {
+            const auto start = Clock::now();
+            sink_.write(static_cast<const Batch<value_type>&>(buffer_));
+            counters_.add(buffer_.size(), Clock::now() - start);
+            items += buffer_.size();
+        }
+        return items;
+    }
+
+    /// @brief Counters of every node, source first
+    std::vector<StageStats> stats() const {
+        std::vector<StageStats> result;
+        upstream_.collect(result);
+        result.push_back(counters_.snapshot(name_));
+        return result;
+    }
+
+    K& getSink() { return sink_; }
+
+private:
+    Up upstream_;
+    std::string_view name_;
+    K sink_;
+    Batch<value_type> buffer_;
+    Counters counters_;
+};
+
+// --- Composition ---
+
+template <typename S, typename F>
+StageNode<SourceNode<S>, F> operator|(SourceSpec<S> source, StageSpec<F> stage) {
+    return {SourceNode<S>(std::move(source)), std::move(stage)};
+}
+
+template <typename Up, typename F>
+StageNode<Up, F> operator|(Up upstream, StageSpec<F> stage) {
+    return {std::move(upstream), std::move(stage)};
+}
+
+template <typename S, std::size_t DEPTH>
+AsyncNode<SourceNode<S>, DEPTH> operator|(SourceSpec<S> source, AsyncSpec<DEPTH> spec) {
+    return {SourceNode<S>(std::move(source)), spec};
+}
+
+template <typename Up, std::size_t DEPTH>
+AsyncNode<Up, DEPTH> operator|(Up upstream, AsyncSpec<DEPTH> spec) {
+    return {std::move(upstream), spec};
+}
+
+template <typename S, typename K>
+Pipeline<SourceNode<S>, K> operator|(SourceSpec<S> source, SinkSpec<K> sink) {
+    return {SourceNode<S>(std::move(source)), std::move(sink)};
+}
+
+template <typename Up, typename K>
+Pipeline<Up, K> operator|(Up upstream, SinkSpec<K> sink) {
+    return {std::move(upstream), std::move(sink)};
+}
+
+}  // namespace pipeline
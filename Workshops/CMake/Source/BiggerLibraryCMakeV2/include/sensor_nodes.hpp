@@ -0,0 +1,62 @@
+// sensor_nodes.hpp
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include "logger.hpp"
+#include "pipeline.hpp"
+#include "sht45.hpp"
+
+/// @brief Pipeline source: SHT45 measurements
+/// @details Uses the sensor's start()/fetch() and sleeps while it converts.
+/// Failed measurements are counted and skipped, not passed on.
+class SHT45Source {
+public:
+    using value_type = SHT45::Measurement;
+
+    static constexpr std::size_t CONTINUOUS = std::numeric_limits<std::size_t>::max();
+
+    /// @param samples Measurements to take, CONTINUOUS for no end
+    explicit SHT45Source(SHT45& sensor, std::size_t samples = 1,
+                         SHT45::Precision precision = SHT45::Precision::High);
+
+    bool read(pipeline::Batch<value_type>& out);
+
+    /// @brief Measurements that failed (bus or CRC error)
+    uint32_t getErrors() const { return errors_; }
+
+private:
+    SHT45* sensor_;  // Pointer, not reference: sources are moved into the pipeline
+    std::size_t remaining_;
+    SHT45::Precision precision_;
+    uint32_t errors_ = 0;
+};
+
+/// @brief Pipeline sink: one log line per item
+template <typename T>
+class LogSink {
+public:
+    explicit LogSink(const char* label, const char* unit = "") : label_(label), unit_(unit) {}
+
+    void write(const pipeline::Batch<T>& batch) const {
+        for (const T& item : batch) {
+            logger_.log(label_, item, unit_);
+        }
+    }
+
+private:
+    Logger logger_;
+    const char* label_;
+    const char* unit_;
+};
+
+/// @brief Log the throughput counters of a pipeline
+template <typename P>
+void logPipelineStats(const Logger& logger, const P& pipeline) {
+    for (const pipeline::StageStats& stats : pipeline.stats()) {
+        logger.log("Stage ", stats.name, ": ", stats.items, " items in ", stats.batches,
+                     " batches, ", stats.itemsPerSecond(), " items/s");
+    }
+}
@@ -1,25 +1,84 @@
 // sht45.hpp
 #pragma once
 
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
 
+#include "i2c.hpp"
+
+/// @brief Sensirion CRC-8 (polynomial 0x31, init 0xFF), table generated at compile time
+uint8_t crc8(const uint8_t* data, std::size_t length);
+
 /// @brief SHT45 Temperature and Humidity Sensor Interface
-/// @details Follows RAII - sensor is ready after construction
+/// @details Non-blocking: start() sends the measurement command and returns,
+/// fetch() reads temperature and humidity in one 6-byte transfer once the
+/// conversion time of the chosen mode has passed. measure() does both.
 class SHT45 {
 public:
-    SHT45() = default;
+    static constexpr uint8_t DEFAULT_ADDRESS = 0x44U;
+
+    /// @brief Repeatability: higher costs more conversion time
+    enum class Precision : uint8_t { High, Medium, Low };
+
+    /// @brief Heater pulse, followed by a high precision measurement
+    /// @details Keep the heater duty cycle below 10% (datasheet)
+    enum class Heater : uint8_t {
+        Power200mW1s, Power200mW100ms,
+        Power110mW1s, Power110mW100ms,
+        Power20mW1s, Power20mW100ms
+    };
+
+    enum class Status : uint8_t {
+        Ok,
+        Busy,       ///< Conversion still running, try again later
+        Idle,       ///< fetch() without start()
+        BusError,   ///< No acknowledge or short transfer
+        CrcError    ///< Data corrupted, measurement discarded
+    };
+
+    struct Measurement {
+        float temperature;  ///< Degrees Celsius
+        float humidity;     ///< Percent relative humidity, 0..100
+    };
+
+    explicit SHT45(I2CBus& bus, uint8_t address = DEFAULT_ADDRESS);
     ~SHT45() = default;
 
-    // Explicitly default copy/move operations (Rule of Five)
-    SHT45(const SHT45&) = default;
-    SHT45& operator=(const SHT45&) = default;
-    SHT45(SHT45&&) = default;
-    SHT45& operator=(SHT45&&) = default;
+    // Refers to the bus: not copyable or movable
+    SHT45(const SHT45&) = delete;
+    SHT45& operator=(const SHT45&) = delete;
+    SHT45(SHT45&&) = delete;
+    SHT45& operator=(SHT45&&) = delete;
 
-    /// @brief Read temperature from sensor
-    /// @return Temperature in degrees Celsius
-    float read_temperature() const;
+    /// @brief Start a measurement
+    /// @return false if the command was not acknowledged
+    bool start(Precision precision = Precision::High);
+
+    /// @brief Switch the heater on, then measure
+    /// @return false if the command was not acknowledged
+    bool startHeater(Heater heater);
+
+    /// @brief Read the result of the last start()
+    /// @param[out] result Filled in when Status::Ok
+    Status fetch(Measurement& result);
+
+    /// @brief Blocking start() + wait + fetch()
+    Status measure(Measurement& result, Precision precision = Precision::High);
+
+    /// @brief Check if a started conversion is still running
+    bool isBusy() const;
+
+    /// @brief Soft reset
+    bool reset();
 
 private:
-    static constexpr float SIMULATED_TEMPERATURE = 22.5F;
+    using Clock = std::chrono::steady_clock;
+
+    bool command(uint8_t code, std::chrono::microseconds duration);
+
+    I2CBus& bus_;
+    uint8_t address_;
+    bool pending_ = false;
+    Clock::time_point readyAt_{};
 };
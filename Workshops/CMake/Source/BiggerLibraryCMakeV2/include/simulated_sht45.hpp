@@ -0,0 +1,24 @@
+// simulated_sht45.hpp
+#pragma once
+
+#include <cstdint>
+
+#include "i2c.hpp"
+
+/// @brief I2C bus with a simulated SHT45 on it, for hosts without the sensor
+/// @details Answers measurement commands with a fixed, CRC-protected reading
+/// in the same 6-byte format as the real device.
+class SimulatedSHT45 : public I2CBus {
+public:
+    static constexpr float SIMULATED_TEMPERATURE = 22.5F;
+    static constexpr float SIMULATED_HUMIDITY = 45.0F;
+
+    explicit SimulatedSHT45(uint8_t address = 0x44U);
+
+    bool write(uint8_t address, const uint8_t* data, std::size_t length) override;
+    bool read(uint8_t address, uint8_t* data, std::size_t length) override;
+
+private:
+    uint8_t address_;
+    bool measured_ = false;  // A measurement command was received
+};
@@ -0,0 +1,130 @@
+// log_backend.cpp
+#include "log_backend.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+constexpr std::string_view prefix(LogLevel level) {
+    switch (level) {
+        case LogLevel::Debug:   return "[DEBUG] ";
+        case LogLevel::Info:    return "[LOG] ";
+        case LogLevel::Warning: return "[WARN] ";
+        case LogLevel::Error:   return "[ERROR] ";
+    }
+    return "";
+}
+
+#if LOG_BACKGROUND_THREAD
+// How long the worker sleeps when the ring is empty
+constexpr auto IDLE_PERIOD = std::chrono::milliseconds(1);
+#endif
+
+}  // namespace
+
+LogBackend& LogBackend::instance() {
+    static LogBackend backend;
+    return backend;
+}
+
+LogBackend::LogBackend() {
+    // Slot i is free for the producer with ticket i
+    for (std::size_t i = 0; i < CAPACITY; ++i) {
+        slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+#if LOG_BACKGROUND_THREAD
+    running_.store(true, std::memory_order_relaxed);
+    worker_ = std::thread(&LogBackend::run, this);
+#endif
+}
+
+LogBackend::~LogBackend() {
+#if LOG_BACKGROUND_THREAD
+    running_.store(false, std::memory_order_relaxed);
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+#endif
+    drain();
+}
+
+bool LogBackend::push(LogLevel level, std::string_view text) {
+    std::size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+    Slot* slot = nullptr;
+    for (;;) {
+        slot = &slots_[pos & (CAPACITY - 1)];
+        const std::size_t seq = slot->sequence.load(std::memory_order_acquire);
+        const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+        if (diff == 0) {
+            if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);  // Full
+            return false;
+        } else {
+            pos = enqueuePos_.load(std::memory_order_relaxed);
+        }
+    }
+
+    const std::size_t length = std::min(text.size(), MESSAGE_SIZE);
+    std::memcpy(slot->text.data(), text.data(), length);
+    slot->length = static_cast<uint8_t>(length);
+    slot->level = level;
+    slot->sequence.store(pos + 1, std::memory_order_release);  // Publish
+    return true;
+}
+
+std::size_t LogBackend::drain() {
+    std::size_t written = 0;
+    bool wroteInfo = false;
+    for (;;) {
+        std::size_t pos = dequeuePos_.load(std::memory_order_relaxed);
+        Slot& slot = slots_[pos & (CAPACITY - 1)];
+        const std::size_t seq = slot.sequence.load(std::memory_order_acquire);
+        if (static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1) < 0) {
+            break;  // Empty
+        }
+        if (!dequeuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+            continue;
+        }
+
+        std::ostream& out = slot.level == LogLevel::Error ? std::cerr : std::cout;
+        const std::string_view tag = prefix(slot.level);
+        out.write(tag.data(), static_cast<std::streamsize>(tag.size()));
+        out.write(slot.text.data(), slot.length);
+        out.put('\n');
+        wroteInfo = wroteInfo || &out == &std::cout;
+
+        slot.sequence.store(pos + CAPACITY, std::memory_order_release);  // Free again
+        ++written;
+    }
+
+    const uint32_t dropped = dropped_.load(std::memory_order_relaxed);
+    if (dropped != reportedDrops_) {
+        std::cerr << "[WARN] " << (dropped - reportedDrops_) << " log messages dropped\n";
+        reportedDrops_ = dropped;
+    }
+    // One flush per batch instead of one per message
+    if (wroteInfo) {
+        std::cout.flush();
+    }
+    return written;
+}
+
+uint32_t LogBackend::getDropped() const {
+    return dropped_.load(std::memory_order_relaxed);
+}
+
+#if LOG_BACKGROUND_THREAD
+void LogBackend::run() {
+    while (running_.load(std::memory_order_relaxed)) {
+        if (drain() == 0) {
+            std::this_thread::sleep_for(IDLE_PERIOD);
+        }
+    }
+}
+#endif
@@ -1,11 +1,21 @@
 // logger.cpp
 #include "logger.hpp"
-#include <iostream>
 
-void Logger::log(const std::string& message) const {
-    std::cout << "[LOG] " << message << std::endl;
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+void LogMessage::append(std::string_view text) {
+    const std::size_t count = std::min(text.size(), buffer_.size() - length_);
+    std::memcpy(buffer_.data() + length_, text.data(), count);
+    length_ += count;
 }
 
-void Logger::error(const std::string& message) const {
-    std::cerr << "[ERROR] " << message << std::endl;
+void LogMessage::append(double value) {
+    // snprintf needs room for the terminator; the buffer has no spare byte
+    char digits[32];
+    const int count = std::snprintf(digits, sizeof(digits), "%g", value);
+    if (count > 0) {
+        append(std::string_view(digits, std::min(static_cast<std::size_t>(count), sizeof(digits) - 1)));
+    }
 }
@@ -6,28 +6,52 @@
 //
 // main.cpp
 // compile using:
-// g++ main.cpp sht45.cpp i2c.cpp logger.cpp config.cpp filter.cpp -I./include -std=c++17 -Wall -O2 -o sensor_app
+// g++ main.cpp sht45.cpp i2c.cpp logger.cpp log_backend.cpp config.cpp config_store.cpp filter.cpp simulated_sht45.cpp sensor_nodes.cpp -I./include -std=c++17 -Wall -O2 -pthread -o sensor_app
 
-#include <iostream>
 #include "sht45.hpp"
 #include "i2c.hpp"
+#include "simulated_sht45.hpp"
 #include "logger.hpp"
 #include "config.hpp"
+#include "config_store.hpp"
 #include "filter.hpp"
+#include "pipeline.hpp"
+#include "sensor_nodes.hpp"
 
-int main() {
+int main(int argc, char* argv[]) {
     Logger logger;
-    Config config;      // Config loaded in constructor
-    I2C i2c;           // I2C bus initialized in constructor
+    // Persistent overrides live in a mapped file on the host (flash on the MCU)
+    MappedFileFlash flash(argc > 1 ? argv[1] : "sensor_config.bin");
+    ConfigStore store(flash);
+    Config config(store);  // Defaults plus stored overrides, nothing copied
+    I2C i2c;           // I2C bus opened in constructor
+    SimulatedSHT45 simulated;
     Filter filter;
-    SHT45 sensor;
+    SHT45 sensor(i2c.isOpen() ? static_cast<I2CBus&>(i2c) : simulated);
 
     logger.log("Starting sensor application...");
+    if (!flash.isOpen()) {
+        logger.warning("Config storage unavailable, using defaults");
+    }
+    logger.log("Sample rate: ", config.getSampleRate(), " ms");
 
-    float temp = sensor.read_temperature();
-    float filtered_temp = filter.apply(temp);
+    if (!i2c.isOpen()) {
+        logger.warning("No I2C bus, using simulated SHT45");
+    }
+
+    // SHT45 -> temperature -> Filter -> Logger, one sample; raise the sample
+    // count (or use SHT45Source::CONTINUOUS) for continuous acquisition
+    auto chain = pipeline::source("sht45", SHT45Source(sensor, 1))
+        | pipeline::stage("temperature", [](const SHT45::Measurement& m) { return m.temperature; })
+        | pipeline::stage("filter", [&filter](float temp) { return filter.apply(temp); })
+        | pipeline::sink("logger", LogSink<float>("Temperature: "));
+
+    if (chain.run() == 0) {
+        logger.error("SHT45 measurement failed");
+        return 1;
+    }
+    logPipelineStats(logger, chain);
 
-    std::cout << "Temperature: " << filtered_temp << std::endl;
     logger.log("Application complete");
 
     return 0;
@@ -0,0 +1,37 @@
+// sensor_nodes.cpp
+#include "sensor_nodes.hpp"
+
+#include <chrono>
+#include <thread>
+
+namespace {
+
+constexpr std::chrono::microseconds POLL_INTERVAL(200);
+
+}  // namespace
+
+SHT45Source::SHT45Source(SHT45& sensor, std::size_t samples, SHT45::Precision precision)
+    : sensor_(&sensor), remaining_(samples), precision_(precision) {}
+
+bool SHT45Source::read(pipeline::Batch<value_type>& out) {
+    while (remaining_ > 0 && !out.full()) {
+        if (remaining_ != CONTINUOUS) {
+            --remaining_;
+        }
+
+        SHT45::Measurement measurement{};
+        SHT45::Status status = SHT45::Status::BusError;
+        if (sensor_->start(precision_)) {
+            while ((status = sensor_->fetch(measurement)) == SHT45::Status::Busy && sensor_->isBusy()) {
+                std::this_thread::sleep_for(POLL_INTERVAL);
+            }
+        }
+
+        if (status == SHT45::Status::Ok) {
+            out.push(measurement);
+        } else {
+            ++errors_;
+        }
+    }
+    return !out.empty() || remaining_ > 0;
+}
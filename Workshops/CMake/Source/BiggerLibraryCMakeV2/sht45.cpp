@@ -1,6 +1,128 @@
 // sht45.cpp
 #include "sht45.hpp"
 
-float SHT45::read_temperature() const {
-    return SIMULATED_TEMPERATURE;
+#include <array>
+#include <thread>
+
+namespace {
+
+using std::chrono::microseconds;
+
+// Commands and maximum durations from the SHT4x datasheet
+struct CommandSpec {
+    uint8_t code;
+    microseconds duration;
+};
+
+constexpr CommandSpec MEASURE[] = {
+    {0xFDU, microseconds(8300)},   // High repeatability
+    {0xF6U, microseconds(4500)},   // Medium
+    {0xE0U, microseconds(1700)},   // Low
+};
+
+constexpr CommandSpec HEATER[] = {
+    {0x39U, microseconds(1100000)},
+    {0x32U, microseconds(110000)},
+    {0x2FU, microseconds(1100000)},
+    {0x24U, microseconds(110000)},
+    {0x1EU, microseconds(1100000)},
+    {0x15U, microseconds(110000)},
+};
+
+constexpr uint8_t SOFT_RESET = 0x94U;
+constexpr microseconds RESET_DURATION(1000);
+
+constexpr std::size_t RESPONSE_SIZE = 6;  // T msb, lsb, crc, RH msb, lsb, crc
+
+constexpr std::array<uint8_t, 256> makeCrcTable() {
+    std::array<uint8_t, 256> table{};
+    for (unsigned i = 0; i < 256; ++i) {
+        uint8_t c = static_cast<uint8_t>(i);
+        for (int bit = 0; bit < 8; ++bit) {
+            c = static_cast<uint8_t>((c & 0x80U) ? ((c << 1) ^ 0x31U) : (c << 1));
+        }
+        table[i] = c;
+    }
+    return table;
+}
+
+constexpr std::array<uint8_t, 256> CRC_TABLE = makeCrcTable();
+
+uint16_t word(const uint8_t* bytes) {
+    return static_cast<uint16_t>((bytes[0] << 8) | bytes[1]);
+}
+
+}  // namespace
+
+uint8_t crc8(const uint8_t* data, std::size_t length) {
+    uint8_t crc = 0xFFU;
+    for (std::size_t i = 0; i < length; ++i) {
+        crc = CRC_TABLE[crc ^ data[i]];
+    }
+    return crc;
+}
+
+SHT45::SHT45(I2CBus& bus, uint8_t address) : bus_(bus), address_(address) {}
+
+bool SHT45::command(uint8_t code, std::chrono::microseconds duration) {
+    pending_ = bus_.write(address_, &code, 1);
+    readyAt_ = Clock::now() + duration;
+    return pending_;
+}
+
+bool SHT45::start(Precision precision) {
+    const CommandSpec& spec = MEASURE[static_cast<uint8_t>(precision)];
+    return command(spec.code, spec.duration);
+}
+
+bool SHT45::startHeater(Heater heater) {
+    const CommandSpec& spec = HEATER[static_cast<uint8_t>(heater)];
+    return command(spec.code, spec.duration);
+}
+
+bool SHT45::isBusy() const {
+    return pending_ && Clock::now() < readyAt_;
+}
+
+SHT45::Status SHT45::fetch(Measurement& result) {
+    if (!pending_) {
+        return Status::Idle;
+    }
+    if (isBusy()) {
+        return Status::Busy;
+    }
+
+    uint8_t response[RESPONSE_SIZE];
+    if (!bus_.read(address_, response, RESPONSE_SIZE)) {
+        return Status::Busy;  // Sensor NACKs until the conversion is done
+    }
+    pending_ = false;
+
+    if (crc8(response, 2) != response[2] || crc8(response + 3, 2) != response[5]) {
+        return Status::CrcError;
+    }
+
+    result.temperature = -45.0F + 175.0F * static_cast<float>(word(response)) / 65535.0F;
+    float humidity = -6.0F + 125.0F * static_cast<float>(word(response + 3)) / 65535.0F;
+    result.humidity = humidity < 0.0F ? 0.0F : (humidity > 100.0F ? 100.0F : humidity);
+    return Status::Ok;
+}
+
+SHT45::Status SHT45::measure(Measurement& result, Precision precision) {
+    if (!start(precision)) {
+        return Status::BusError;
+    }
+    std::this_thread::sleep_until(readyAt_);
+    Status status = fetch(result);
+    return status == Status::Busy ? Status::BusError : status;
+}
+
+bool SHT45::reset() {
+    const uint8_t code = SOFT_RESET;
+    pending_ = false;
+    if (!bus_.write(address_, &code, 1)) {
+        return false;
+    }
+    std::this_thread::sleep_for(RESET_DURATION);
+    return true;
 }
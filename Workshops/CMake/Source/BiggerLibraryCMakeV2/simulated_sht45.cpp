@@ -0,0 +1,40 @@
+// simulated_sht45.cpp
+#include "simulated_sht45.hpp"
+
+#include "sht45.hpp"
+
+namespace {
+
+constexpr uint8_t SOFT_RESET = 0x94U;
+
+uint16_t ticks(float value, float offset, float span) {
+    return static_cast<uint16_t>((value - offset) * 65535.0F / span + 0.5F);
+}
+
+void putWord(uint8_t* out, uint16_t value) {
+    out[0] = static_cast<uint8_t>(value >> 8);
+    out[1] = static_cast<uint8_t>(value & 0xFFU);
+    out[2] = crc8(out, 2);
+}
+
+}  // namespace
+
+SimulatedSHT45::SimulatedSHT45(uint8_t address) : address_(address) {}
+
+bool SimulatedSHT45::write(uint8_t address, const uint8_t* data, std::size_t length) {
+    if (address != address_ || length != 1) {
+        return false;
+    }
+    measured_ = data[0] != SOFT_RESET;  // Measurement and heater commands alike
+    return true;
+}
+
+bool SimulatedSHT45::read(uint8_t address, uint8_t* data, std::size_t length) {
+    if (address != address_ || length != 6 || !measured_) {
+        return false;
+    }
+    measured_ = false;
+    putWord(data, ticks(SIMULATED_TEMPERATURE, -45.0F, 175.0F));
+    putWord(data + 3, ticks(SIMULATED_HUMIDITY, -6.0F, 125.0F));
+    return true;
+}
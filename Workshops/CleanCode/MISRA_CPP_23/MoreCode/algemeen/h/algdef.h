@@ -14,6 +14,7 @@
 #include <stdio.h>
 #include <stdint.h>
 #include <math.h>
+#include <assert.h>
 
 /* standaard definities */
 
@@ -115,163 +116,135 @@ typedef WiskundeFloatType WFT;
 /* funkties en inline funkties */
 
 /* bitsgewijze operatie macros . Geef bits aan als nummer en niet als 2 tot de macht (nummer) */
+/* Alle hulpjes zijn constexpr en zonder sprongen; ook bruikbaar op volatile registers.
+ * Voor getypeerde registervelden en gebundelde schrijfakties: zie bitVeld.h */
+
+/*! @brief masker met alleen bit y, in de breedte van ttype */
 template <typename ttype>
-void SetBit(ttype &x,const Teller y)
+constexpr ttype BitMasker(const Teller y)
 {
-	static const ttype schuiver = 1;
-	const ttype verschuiving = (schuiver << y);
-	x |= verschuiving;       /* Set bit y in byte x*/
+	return(static_cast<ttype>(static_cast<ttype>(1U) << y));
 }
 
-//template <typename ttype1,typename ttype2>
-//void SetBit(ttype1 &x,const ttype2 y)
-//{
-//    x |= (1<<y);       /* Set bit y in byte x*/
-//}
-//
+template <typename ttype>
+constexpr void SetBit(ttype &x,const Teller y)
+{
+	x |= BitMasker<ttype>(y);       /* Set bit y in byte x*/
+}
 
 template <typename ttype>
-void SetBit(ttype * const x,const Teller y)
+constexpr void SetBit(ttype * const x,const Teller y)
 {
-	static const ttype schuiver = 1;
-	const ttype verschuiving = (schuiver << y);
-	ttype inhoud = *x;
-	inhoud |= verschuiving;       /* Set bit y in byte x*/
-	*x = inhoud;
+	const auto inhoud = *x;
+	*x = static_cast<ttype>(inhoud | BitMasker<ttype>(y));       /* Set bit y in byte x*/
 }
 
 template <typename ttype>
-void SetBitM(ttype &x,const ttype y)
+constexpr void SetBitM(ttype &x,const ttype y)
 {
 	x |= y;       /* Set bit y in byte x*/
 }
 
 template <typename ttype>
-void SetBitM(ttype * const x,const ttype y)
+constexpr void SetBitM(ttype * const x,const ttype y)
 {
-	ttype inhoud = *x;
-	inhoud |= y;       /* Set bit y in byte x*/
-	*x = inhoud;
+	const auto inhoud = *x;
+	*x = static_cast<ttype>(inhoud | y);       /* Set bit y in byte x*/
 }
 
 template <typename ttype>
-void ClearBit(ttype &x,const Teller y)
+constexpr void ClearBit(ttype &x,const Teller y)
 {
-	static const ttype schuiver = 1;
-	const ttype verschuiving = ~(schuiver << y);
-	x &= verschuiving;       /* Clear bit y in byte x*/
+	x &= static_cast<ttype>(~BitMasker<ttype>(y));       /* Clear bit y in byte x*/
 }
 
 template <typename ttype>
-void ClearBit(ttype * const x,const Teller y)
+constexpr void ClearBit(ttype * const x,const Teller y)
 {
-	static const ttype schuiver = 1;
-	const ttype verschuiving = ~(schuiver << y);
-	ttype inhoud = *x;
-	inhoud &= verschuiving;       /* Clear bit y in byte x*/
-	*x = inhoud;
+	const auto inhoud = *x;
+	*x = static_cast<ttype>(inhoud & static_cast<ttype>(~BitMasker<ttype>(y)));       /* Clear bit y in byte x*/
 }
 
 template <typename ttype>
-void ClearBitM(ttype &x,const ttype y)
+constexpr void ClearBitM(ttype &x,const ttype y)
 {
-	x &= (~y);       /* Clear bit y in byte x*/
+	x &= static_cast<ttype>(~y);       /* Clear bit y in byte x*/
 }
 
 template <typename ttype>
-bool CheckBit(const ttype x,const Teller y)
+constexpr bool CheckBit(const ttype x,const Teller y)
 {
-	static const ttype schuiver=1;
-	const ttype verschuiving = static_cast<ttype>(schuiver << y);
-	return(((0==(x & verschuiving)) ? false : true));
+	return(0 != (x & BitMasker<ttype>(y)));
 }
 
 template <typename ttype>
-bool InvCheckBit(const ttype x,const Teller y)
+constexpr bool InvCheckBit(const ttype x,const Teller y)
 {
-	static const ttype schuiver=1;
-	const ttype verschuiving = static_cast<ttype>(schuiver << y);
-	return(((0==(x & verschuiving)) ? true : false));
+	return(0 == (x & BitMasker<ttype>(y)));
 }
 
 template <typename ttype>
-bool CheckBit(ttype const * const x,const Teller y)
+constexpr bool CheckBit(ttype const * const x,const Teller y)
 {
-	static const ttype schuiver=1;
-	const ttype verschuiving = static_cast<ttype>(schuiver << y);
-	return(((0==((*x) & verschuiving)) ? false : true));
+	return(0 != ((*x) & BitMasker<ttype>(y)));
 }
 
 template <typename ttype>
-bool CheckBitM(const ttype x,const ttype y)
+constexpr bool CheckBitM(const ttype x,const ttype y)
 {
-	return(((0==(x & y)) ? false : true));
+	return(0 != (x & y));
 }
 
 template <typename ttype>
-bool CheckBitM(const ttype *x,const ttype y)
+constexpr bool CheckBitM(const ttype *x,const ttype y)
 {
-	return(((0==((*x) & y)) ? false : true));
+	return(0 != ((*x) & y));
 }
 
 
 /*! @brief klap het bit op nummer y om */
 template <typename ttype>
-void ToggleBit(ttype &x,const Teller y)
+constexpr void ToggleBit(ttype &x,const Teller y)
 {
-	static const ttype schuiver=1;
-	const ttype verschuiving = (schuiver << y);
-	x ^=  verschuiving;  /* verander bit y in byte x */
+	x ^= BitMasker<ttype>(y);  /* verander bit y in byte x */
 }
 
 /*! @brief klap het bitpatroon y om */
 template <typename ttype>
-void ToggleBitM(ttype &x,const Teller y)
+constexpr void ToggleBitM(ttype &x,const Teller y)
 {
 	x ^= y;  /* verander bit y in byte x */
 }
 
 /*! @brief klap het bit op nummer y om */
 template <typename ttype>
-void ToggleBit(ttype *x,const Teller y)
+constexpr void ToggleBit(ttype *x,const Teller y)
 {
-	static const ttype schuiver = 1;
-	const ttype verschuiving = (schuiver << y);
-	ttype inhoud = *x;
-	inhoud ^= verschuiving;       /* toggle bit y in byte x*/
-	*x = inhoud;
+	const auto inhoud = *x;
+	*x = static_cast<ttype>(inhoud ^ BitMasker<ttype>(y));       /* toggle bit y in byte x*/
 }
 
-/*! @brief Zet bit y in byte x gelijk aan de boolean b */
+/*! @brief zet bitpatroon y in x gelijk aan de boolean b.
+ *  Zonder sprong: het patroon wordt gewist en daarna b maal y geplaatst */
 template <typename ttype>
-void EnterBit(ttype &x,const Teller y,const bool b)
+constexpr void EnterBitM(ttype &x,const ttype y,const bool b)
 {
-	if (true==b)
-		SetBit<ttype>(x,y);
-	else
-		ClearBit<ttype>(x,y);
+	const auto aan = static_cast<ttype>(0U - static_cast<ttype>(b));  /* alle bits 1 als b waar is */
+	x = static_cast<ttype>((x & static_cast<ttype>(~y)) | (y & aan));
 }
 
-/*! @brief zet bitpatroon y in x gelijk aan de boolean b */
+/*! @brief Zet bit y in byte x gelijk aan de boolean b */
 template <typename ttype>
-void EnterBitM(ttype &x,const ttype y,const bool b)
+constexpr void EnterBit(ttype &x,const Teller y,const bool b)
 {
-	if (true==b)
-		SetBitM<ttype>(x,y);
-	else
-		ClearBitM<ttype>(x,y);
+	EnterBitM<ttype>(x,BitMasker<ttype>(y),b);
 }
 
-
-
 /*! @brief zet bit y in byte x aan als Schakelaar==aan, anders uit */
 template <typename ttype>
-void EnterBit(ttype &x,const Teller y,const Schakelaar knop)
+constexpr void EnterBit(ttype &x,const Teller y,const Schakelaar knop)
 {
-	if (knop==Schakelaar::Aan)
-		SetBit<ttype>(x,y);
-	else
-		ClearBit<ttype>(x,y);
+	EnterBitM<ttype>(x,BitMasker<ttype>(y),knop==Schakelaar::Aan);
 }
 
 /* tel b bij a op binnen 'bits' aantal bits. Bij een overflow over 'bits' bits wordt slechts het restant doorgegeven */
@@ -313,64 +286,292 @@ typedef enum
     BreukRelNummers_Einde
 } BreukRelAantalRelevanteNummers;
 
+class BreukVermenigvuldiger;
+
+/*! @class Breuk
+ *  @brief Exacte breuk met Int16 teller en noemer, altijd genormaliseerd (noemer > 0, ggd 1).
+ *  Alle rekenkunde is constexpr en rekent tussendoor in Int32, zodat geen
+ *  tussenresultaat kan overlopen. Past het genormaliseerde resultaat niet in
+ *  Int16 (+/- 32767), dan wordt het zo dicht mogelijk benaderd (verzadigd) en
+ *  onthoudt de breuk dit : zie heeftOverloop(). */
 class Breuk
 {
 public:
-    Breuk(const Int16 t,     /* de teller */
-          const Int16 n=1);  /* de noemer. standaard = 1 --> geheel getal */
+    static constexpr Int32 Maximum = 32767;   /* symmetrisch bereik : -32768 is verzadigd */
+
+    constexpr Breuk(const Int16 t,     /* de teller */
+                    const Int16 n=1) : Breuk(maak(t,n,false))  /* de noemer. standaard = 1 --> geheel getal */
+        {
+            assert(n != 0);
+        }
 
     Breuk(const WiskundeFloatType,          /* input: floating point getal */
 	  const BreukRelAantalRelevanteNummers );           /* aantal relevante cijfers in het drijvende komma getal */
 
-    bool operator != (const Breuk &) const;
-    bool operator == (const Breuk &) const;
+    constexpr bool operator != (const Breuk &rhs) const
+        {
+            return((tel != rhs.tel) || (noem != rhs.noem));
+        }
+
+    constexpr bool operator == (const Breuk &rhs) const
+        {
+            return((tel == rhs.tel) && (noem == rhs.noem));
+        }
+
+    constexpr Breuk operator + (const Breuk &rhs) const
+        {
+            return(maak((static_cast<Int32>(tel)*rhs.noem)+(static_cast<Int32>(rhs.tel)*noem),
+                        static_cast<Int32>(noem)*rhs.noem,overloop || rhs.overloop));
+        }
+
+    constexpr Breuk operator + (const Int16 rhs) const
+        {
+            return(operator + (Breuk(rhs)));
+        }
+
+    constexpr Breuk operator - (const Breuk &rhs) const
+        {
+            return(maak((static_cast<Int32>(tel)*rhs.noem)-(static_cast<Int32>(rhs.tel)*noem),
+                        static_cast<Int32>(noem)*rhs.noem,overloop || rhs.overloop));
+        }
+
+    constexpr Breuk operator - (const Int16 rhs) const
+        {
+            return(operator - (Breuk(rhs)));
+        }
 
-    Breuk operator + (const Breuk &) const;
+    constexpr Breuk & operator += (const Breuk &rhs)
+        {
+            *this = operator + (rhs);
+            return(*this);
+        }
 
-    Breuk operator + (const Int16 ) const;
-  
-    Breuk operator - (const Breuk &) const;
+    constexpr Breuk & operator -= (const Breuk &rhs)
+        {
+            *this = operator - (rhs);
+            return(*this);
+        }
 
-    Breuk operator - (const Int16 ) const;
+    constexpr Breuk & operator *= (const Int16 getal)
+        {
+            *this = operator * (getal);
+            return(*this);
+        }
 
-    Breuk & operator += (const Breuk &);
-    Breuk & operator -= (const Breuk &);
-   
-    Breuk & operator *= (const Int16);
-    Breuk & operator *= (const Breuk &);
+    constexpr Breuk & operator *= (const Breuk &rhs)
+        {
+            *this = operator * (rhs);
+            return(*this);
+        }
 
-    Breuk  operator * (const Int16) const;
-    Breuk  operator * (const Breuk &) const;
+    constexpr Breuk operator * (const Int16 getal) const
+        {
+            return(operator * (Breuk(getal)));
+        }
 
-    Breuk & operator /= (const Int16);
-    Breuk  operator / (const Int16) const;
-    Breuk  operator / (const Breuk &) const;
+    constexpr Breuk operator * (const Breuk &rhs) const
+        {
+            return(maak(static_cast<Int32>(tel)*rhs.tel,static_cast<Int32>(noem)*rhs.noem,
+                        overloop || rhs.overloop));
+        }
 
+    constexpr Breuk & operator /= (const Int16 getal)
+        {
+            *this = operator / (getal);
+            return(*this);
+        }
 
-    Int16 teller() const
+    constexpr Breuk operator / (const Int16 getal) const
+        {
+            return(operator / (Breuk(getal)));
+        }
+
+    constexpr Breuk operator / (const Breuk &rhs) const
+        {
+            assert(rhs.tel != 0);
+            return(maak(static_cast<Int32>(tel)*rhs.noem,static_cast<Int32>(noem)*rhs.tel,
+                        overloop || rhs.overloop));
+        }
+
+    constexpr Int16 teller() const
         {
             return(tel);
         }
 
-    Int16 noemer() const
+    constexpr Int16 noemer() const
         {
             return(noem);
         }
-    
-    Int16 vermenigvuldig(const Int16) const; /* vermenigvuldig breuk met Int16 en rond af naar dichtbijzijnde Int16*/
 
-    float geefFloat() const;  /* geefType breuk als float */
- 
-    Int16 rondAf() const;   /* rond breuk af naar integer */
-    
+    /*! @brief is deze breuk (of een van de breuken waaruit hij berekend is) verzadigd */
+    constexpr bool heeftOverloop() const
+        {
+            return(overloop);
+        }
+
+    /* vermenigvuldig breuk met Int16 en rond af naar dichtbijzijnde Int16 (verzadigd) */
+    constexpr Int16 vermenigvuldig(const Int16 getal) const
+        {
+            const Int32 product = static_cast<Int32>(getal)*tel;
+            const Int32 half = noem/2;
+            const Int32 uitkomst = ((product < 0) ? (product-half) : (product+half))/noem;
+            return(static_cast<Int16>((uitkomst > Maximum) ? Maximum : ((uitkomst < -Maximum) ? -Maximum : uitkomst)));
+        }
+
+    /*! @brief snelle vermenigvuldiger voor reeksen samples, zonder deling per sample */
+    constexpr BreukVermenigvuldiger vermenigvuldiger() const;
+
+    constexpr float geefFloat() const  /* geefType breuk als float */
+        {
+            return(static_cast<float>(tel)/static_cast<float>(noem));
+        }
+
+    constexpr Int16 rondAf() const   /* rond breuk af naar integer */
+        {
+            return(static_cast<Int16>(tel/noem));
+        }
+
 protected:
-    void normaliseer();
+    constexpr void normaliseer()
+        {
+            *this = maak(tel,noem,overloop);
+        }
 
 private:
+    constexpr Breuk(const Int16 t,const Int16 n,const bool o) : tel(t),noem(n),overloop(o)
+        {
+        }
+
+    static constexpr Int32 absoluut(const Int32 x)
+        {
+            return((x < 0) ? -x : x);
+        }
+
+    static constexpr Int32 ggd(Int32 a,Int32 b)
+        {
+            while (b != 0)
+            {
+                const Int32 rest = a % b;
+                a = b;
+                b = rest;
+            }
+            return((a == 0) ? 1 : a);
+        }
+
+    /*! @brief normaliseer een Int32 tussenresultaat en verzadig naar Int16 */
+    static constexpr Breuk maak(Int32 t,Int32 n,bool o)
+        {
+            if (n < 0)
+            {
+                t = -t;
+                n = -n;
+            }
+            const Int32 deler = ggd(absoluut(t),n);
+            t /= deler;
+            n /= deler;
+
+            const Int32 grootste = (absoluut(t) > n) ? absoluut(t) : n;
+            if (grootste > Maximum)
+            {
+                o = true;
+                if ((absoluut(t)/n) >= Maximum)
+                {
+                    /* waarde zelf past niet : verzadig */
+                    return(Breuk(static_cast<Int16>((t < 0) ? -Maximum : Maximum),1,o));
+                }
+                /* waarde past wel : kleinere noemer, teller afgerond (alleen hier Int64) */
+                const Int32 kleiner = n/((grootste/Maximum)+1);
+                const Int32 nieuweNoemer = (kleiner > 0) ? kleiner : 1;
+                const Int64 geschaald = static_cast<Int64>(t)*nieuweNoemer;
+                const Int64 afronding = (geschaald < 0) ? -(n/2) : (n/2);
+                return(maak(static_cast<Int32>((geschaald+afronding)/n),nieuweNoemer,o));
+            }
+            return(Breuk(static_cast<Int16>(t),static_cast<Int16>(n),o));
+        }
+
     Int16 tel,noem;
+    bool overloop;
     static const Int32 nulWerkers[];
 };
 
+/*! @class BreukVermenigvuldiger
+ *  @brief Vermenigvuldig samples met een vaste breuk : afronden naar dichtbijzijnde, verzadigd.
+ *  De deling door de noemer is vooraf vervangen door een vermenigvuldiging met een
+ *  32 bits reciproke en een verschuiving (Granlund-Montgomery), exact voor elk sample.
+ *  Op een Cortex-M is dat een UMULL per sample in plaats van een deling. */
+class BreukVermenigvuldiger
+{
+public:
+    constexpr explicit BreukVermenigvuldiger(const Breuk &breuk) : tel(breuk.teller()),
+                                                                  half(breuk.noemer()/2),
+                                                                  schuif(31U+plafondLog2(static_cast<UInt32>(breuk.noemer()))),
+                                                                  reciproke(bepaalReciproke(static_cast<UInt32>(breuk.noemer())))
+        {
+        }
+
+    /*! @brief een sample */
+    constexpr Int16 operator () (const Int16 getal) const
+        {
+            return(verzadig(schaal(getal)));
+        }
+
+    /*! @brief een reeks samples (in == uit mag)
+     *  @return het aantal verzadigde samples */
+    Teller vermenigvuldig(Int16 const * const in,Int16 * const uit,const Teller aantal) const
+        {
+            Teller verzadigd = 0;
+            for (Teller i=0;i<aantal;i++)
+            {
+                const Int32 waarde = schaal(in[i]);
+                verzadigd += ((waarde > Breuk::Maximum) || (waarde < -Breuk::Maximum)) ? 1U : 0U;
+                uit[i] = verzadig(waarde);
+            }
+            return(verzadigd);
+        }
+
+private:
+    static constexpr UInt32 plafondLog2(const UInt32 d)
+        {
+            UInt32 l = 0;
+            while ((1UL << l) < d)
+            {
+                l++;
+            }
+            return(l);
+        }
+
+    /* m = plafond(2^(31+l) / d) : exact voor tellers < 2^31 */
+    static constexpr UInt32 bepaalReciproke(const UInt32 d)
+        {
+            const UInt64 macht = static_cast<UInt64>(1) << (31U+plafondLog2(d));
+            return(static_cast<UInt32>((macht + d - 1U)/d));
+        }
+
+    constexpr Int32 schaal(const Int16 getal) const
+        {
+            const Int32 product = static_cast<Int32>(getal)*tel;
+            const UInt32 grootte = static_cast<UInt32>((product < 0) ? -product : product) + static_cast<UInt32>(half);
+            const auto quotient = static_cast<Int32>((static_cast<UInt64>(grootte)*reciproke) >> schuif);
+            return((product < 0) ? -quotient : quotient);
+        }
+
+    static constexpr Int16 verzadig(const Int32 waarde)
+        {
+            return(static_cast<Int16>((waarde > Breuk::Maximum) ? Breuk::Maximum :
+                                      ((waarde < -Breuk::Maximum) ? -Breuk::Maximum : waarde)));
+        }
+
+    Int32 tel;
+    Int32 half;
+    UInt32 schuif;
+    UInt32 reciproke;
+};
+
+constexpr BreukVermenigvuldiger Breuk::vermenigvuldiger() const
+{
+    return(BreukVermenigvuldiger(*this));
+}
+
 /*! @Brefi English typedef of Breuk */
 using Fraction = Breuk;
 
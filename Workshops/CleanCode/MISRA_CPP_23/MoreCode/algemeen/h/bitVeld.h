@@ -0,0 +1,219 @@
+/******************************************************************************
+ * Project        : Embedded Systems Project en DSB Practicum
+ * Copyright : 2010-2020 Original Authors
+ ******************************************************************************
+
+ Getypeerde bitvelden in (hardware)registers.
+
+ Een BitVeld<UInt32,4,3> beschrijft bits 4..6 van een 32 bits register.
+ Masker en positie zijn compile-time constanten; lezen en schrijven is
+ een AND/OR zonder sprongen. Meerdere velden van hetzelfde register worden
+ met | samengevoegd tot een VeldWaarde en in een enkele lees-wijzig-schrijf
+ (of een enkele schrijfaktie) naar het register gebracht:
+
+     using Modus  = BitVeld<UInt32,0,2>;
+     using Snelh  = BitVeld<UInt32,2,2>;
+     schrijfVelden(GPIOA->MODER, Modus::met(1U) | Snelh::met(3U));
+
+ Voor flags die ook vanuit een interrupt worden gewijzigd zijn er
+ atomaire varianten zonder lees-wijzig-schrijf: bit-banding (Cortex-M3/M4)
+ en set/reset registers (zoals GPIOx->BSRR).
+
+******************************************************************************/
+
+#ifndef ESE_BitVeld_H_
+#define ESE_BitVeld_H_
+
+#include <algdef.h>
+
+/*! @brief Aantal bits in een register van het type RegType */
+template<typename RegType>
+constexpr Teller RegisterBreedte()
+{
+	return(static_cast<Teller>(sizeof(RegType)*8U));
+}
+
+/*! @brief Masker van Breedte bits vanaf bit Offset. Een veld over het hele register
+ *  schuift niet over de registerbreedte heen (dat is ongedefinieerd gedrag) */
+template<typename RegType>
+constexpr RegType VeldMasker(const Teller offset,const Teller breedte)
+{
+	return(static_cast<RegType>(((breedte >= RegisterBreedte<RegType>()) ?
+	                             static_cast<RegType>(~static_cast<RegType>(0U)) :
+	                             static_cast<RegType>((static_cast<RegType>(1U) << breedte) - 1U)) << offset));
+}
+
+/*! @brief Waarden voor een of meer velden van een register : welke bits (masker) en hun inhoud */
+template<typename RegType>
+struct VeldWaarde
+{
+	RegType masker;
+	RegType waarde;
+
+	/*! @brief voeg velden van hetzelfde register samen */
+	constexpr VeldWaarde<RegType> operator | (const VeldWaarde<RegType> &rhs) const
+	{
+		return(VeldWaarde<RegType>{static_cast<RegType>(masker | rhs.masker),
+		                           static_cast<RegType>((waarde & static_cast<RegType>(~rhs.masker)) | rhs.waarde)});
+	}
+
+	/*! @brief pas toe op een registerinhoud : velden buiten het masker blijven ongewijzigd */
+	constexpr RegType toepassen(const RegType inhoud) const
+	{
+		return(static_cast<RegType>((inhoud & static_cast<RegType>(~masker)) | waarde));
+	}
+};
+
+/*! @class BitVeld
+ *  @brief Veld van Breedte bits vanaf bit Offset in een register van het type RegType */
+template<typename RegType,const Teller Offset,const Teller Breedte>
+struct BitVeld
+{
+	static_assert(Breedte > 0U,"BitVeld : breedte moet minstens 1 bit zijn");
+	static_assert((Offset + Breedte) <= RegisterBreedte<RegType>(),"BitVeld : veld past niet in het register");
+
+	using RegisterType = RegType;
+
+	static constexpr RegType masker = VeldMasker<RegType>(Offset,Breedte);
+	static constexpr RegType maximum = VeldMasker<RegType>(0U,Breedte);
+
+	/*! @brief veldwaarde v op zijn plaats; bits buiten het veld worden afgekapt */
+	static constexpr VeldWaarde<RegType> met(const RegType v)
+	{
+		return(VeldWaarde<RegType>{masker,static_cast<RegType>(static_cast<RegType>(v << Offset) & masker)});
+	}
+
+	/*! @brief haal de veldwaarde uit een registerinhoud */
+	static constexpr RegType lees(const RegType inhoud)
+	{
+		return(static_cast<RegType>((inhoud & masker) >> Offset));
+	}
+
+	/*! @brief registerinhoud met veldwaarde v, de rest ongewijzigd */
+	static constexpr RegType schrijf(const RegType inhoud,const RegType v)
+	{
+		return(met(v).toepassen(inhoud));
+	}
+
+	/*! @brief lees het veld uit een register */
+	static RegType leesRegister(volatile RegType const &reg)
+	{
+		return(lees(static_cast<RegType>(reg)));
+	}
+
+	/*! @brief schrijf het veld in een register : een lezing en een schrijfaktie */
+	static void zet(volatile RegType &reg,const RegType v)
+	{
+		reg = schrijf(static_cast<RegType>(reg),v);
+	}
+};
+
+/*! @brief schrijf een of meer samengevoegde velden met een enkele lees-wijzig-schrijf */
+template<typename RegType>
+void schrijfVelden(volatile RegType &reg,const VeldWaarde<RegType> velden)
+{
+	reg = velden.toepassen(static_cast<RegType>(reg));
+}
+
+/*! @brief initialiseer een register : alleen de opgegeven velden, de rest 0, zonder lezing */
+template<typename RegType>
+void initialiseerVelden(volatile RegType &reg,const VeldWaarde<RegType> velden)
+{
+	reg = velden.waarde;
+}
+
+/*! @brief registerinhoud met alleen de opgegeven velden, als compile-time constante */
+template<typename RegType>
+constexpr RegType VeldenWaarde(const VeldWaarde<RegType> velden)
+{
+	return(velden.waarde);
+}
+
+/*! @class SetResetRegister
+ *  @brief Atomair zetten en wissen via een alleen-schrijven set/reset register.
+ *  Een 1 in de onderste helft zet, een 1 op bit (n + ResetVerschuiving) wist, een 0 doet niets.
+ *  GPIOx->BSRR : SetResetRegister<UInt32,16>. Aparte SET en CLR registers : ResetVerschuiving 0
+ *  en zet()/wis() elk op hun eigen register. */
+template<typename RegType,const Teller ResetVerschuiving>
+struct SetResetRegister
+{
+	static_assert(ResetVerschuiving < RegisterBreedte<RegType>(),"SetResetRegister : verschuiving te groot");
+
+	static void zet(volatile RegType &reg,const RegType zetMasker)
+	{
+		reg = zetMasker;
+	}
+
+	static void wis(volatile RegType &reg,const RegType wisMasker)
+	{
+		reg = static_cast<RegType>(wisMasker << ResetVerschuiving);
+	}
+
+	/*! @brief zet en wis tegelijk, in een schrijfaktie */
+	static void zetWis(volatile RegType &reg,const RegType zetMasker,const RegType wisMasker)
+	{
+		reg = static_cast<RegType>(zetMasker | static_cast<RegType>(wisMasker << ResetVerschuiving));
+	}
+
+	/*! @brief zet bit nummer y gelijk aan b, zonder sprong */
+	static void enter(volatile RegType &reg,const Teller y,const bool b)
+	{
+		const auto masker = BitMasker<RegType>(y);
+		const auto aan = static_cast<RegType>(0U - static_cast<RegType>(b));
+		zetWis(reg,static_cast<RegType>(masker & aan),static_cast<RegType>(masker & static_cast<RegType>(~aan)));
+	}
+};
+
+/* Bit-banding bestaat alleen op Cortex-M3 en Cortex-M4 en niet op elk derivaat.
+ * Zet BITBAND_BESCHIKBAAR op 0 als de chip het niet heeft. */
+#ifndef BITBAND_BESCHIKBAAR
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__)
+#define BITBAND_BESCHIKBAAR 1
+#else
+#define BITBAND_BESCHIKBAAR 0
+#endif
+#endif
+
+/*! @brief adres van het bit-band alias woord van bit 'bit' op adres 'adres'
+ *  (SRAM 0x20000000 -> 0x22000000, randapparatuur 0x40000000 -> 0x42000000) */
+constexpr UInt32 BitBandAdres(const UInt32 adres,const Teller bit)
+{
+	return((adres & 0xF0000000U) + 0x02000000U + ((adres & 0x000FFFFFU) * 32U) + (bit * 4U));
+}
+
+#if (BITBAND_BESCHIKBAAR == 1)
+/*! @class BitBand
+ *  @brief Een bit van het 32 bits woord op Adres, atomair te lezen en te schrijven via zijn alias */
+template<const UInt32 Adres,const Teller Bit>
+struct BitBand
+{
+	static_assert(Bit < 32U,"BitBand : bitnummer te groot");
+	static_assert(((Adres & 0xF0000000U) == 0x20000000U) || ((Adres & 0xF0000000U) == 0x40000000U),
+	              "BitBand : adres ligt niet in een bit-band gebied");
+	static_assert((Adres & 0x0FF00000U) == 0U,"BitBand : adres ligt buiten de eerste megabyte");
+
+	static constexpr UInt32 alias = BitBandAdres(Adres,Bit);
+
+	static void zet()
+	{
+		*reinterpret_cast<volatile UInt32 *>(alias) = 1U;
+	}
+
+	static void wis()
+	{
+		*reinterpret_cast<volatile UInt32 *>(alias) = 0U;
+	}
+
+	static void enter(const bool b)
+	{
+		*reinterpret_cast<volatile UInt32 *>(alias) = static_cast<UInt32>(b);
+	}
+
+	static bool lees()
+	{
+		return(0U != *reinterpret_cast<volatile UInt32 const *>(alias));
+	}
+};
+#endif
+
+#endif /* ESE_BitVeld_H_ */
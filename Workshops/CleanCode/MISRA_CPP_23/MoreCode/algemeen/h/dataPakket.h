@@ -175,5 +175,470 @@ private:
 };
 
 
+template<typename Layout>
+class PakketView;
+
+/*! @brief Een stuk van een samengesteld bericht, zoals een iovec : begin en lengte in bytes */
+struct ZendSegment
+{
+	UInt8 const * bron;
+	UInt32 aantalBytes;
+};
+
+/*! @class De segmenten van een bericht dat uit meerdere DataPakket objecten bestaat.
+ *
+ * Een titel, een kommando en een databuffer hoeven niet eerst achter elkaar
+ * in een zendbuffer gekopieerd te worden : de lijst onthoudt alleen waar
+ * ze staan. De pakketten moeten geldig blijven tot de verzending klaar is. */
+template<const UInt32 MaxSegmenten>
+class SegmentLijst
+{
+public:
+
+	static_assert(0U != MaxSegmenten, "SegmentLijst : minstens een segment");
+
+	/*! @brief voeg een heel pakket toe.
+	 * @return FoutCode::Fout als de lijst vol is. */
+	template<typename ttype>
+	FoutCode voegToe(const DataPakket<ttype> &pakket)
+	{
+		return(voegToe(reinterpret_cast<UInt8 const *>(pakket.geefPtr()),
+		               pakket.geefGrootte()*sizeof(ttype)));
+	};
+
+	template<typename Layout>
+	FoutCode voegToe(const PakketView<Layout> &bericht)
+	{
+		return(voegToe(bericht.geefPtr(),bericht.geefGrootte()));
+	};
+
+	/*! @brief voeg een deel van een buffer toe, bijvoorbeeld alleen de geladen samples.
+	 * Een leeg segment wordt overgeslagen. */
+	FoutCode voegToe(UInt8 const * const bron, const UInt32 aantalBytes)
+	{
+		if (0U == aantalBytes)
+			return(FoutCode::Ok);
+
+		assert(nullptr != bron);
+		if (aantal == MaxSegmenten)
+			return(FoutCode::Fout);
+
+		segmenten[aantal++] = ZendSegment{bron,aantalBytes};
+		return(FoutCode::Ok);
+	};
+
+	void reset()
+	{
+		aantal = 0;
+	};
+
+	UInt32 geefAantal() const
+	{
+		return(aantal);
+	};
+
+	ZendSegment const * geefSegmenten() const
+	{
+		return(segmenten);
+	};
+
+	const ZendSegment & operator [] (const UInt32 index) const
+	{
+		assert(index < aantal);
+		return(segmenten[index]);
+	};
+
+	UInt32 geefTotaalBytes() const
+	{
+		UInt32 totaal = 0;
+		for (UInt32 i=0; i < aantal; i++)
+			totaal += segmenten[i].aantalBytes;
+		return(totaal);
+	};
+
+private:
+	ZendSegment segmenten[MaxSegmenten] = {};
+	UInt32 aantal = 0;
+};
+
+/*! @class Wordt aangeroepen als een DMA overdracht klaar is (vanuit de DMA ISR). */
+class DMAAfhandelaar
+{
+public:
+	virtual ~DMAAfhandelaar() = default;
+	virtual void overdrachtKlaar() = 0;
+};
+
+/*! @class Een DMA kanaal naar UART of USB.
+ * Een implementatie start de overdracht en roept na afloop de afhandelaar aan. */
+class DMAKanaal
+{
+public:
+	virtual ~DMAKanaal() = default;
+
+	/*! @brief start een overdracht zonder kopie : bron moet geldig blijven tot overdrachtKlaar().
+	 * @return FoutCode::Ok als het kanaal de overdracht heeft geaccepteerd. */
+	virtual FoutCode start(UInt8 const * const bron,
+	                       const UInt32 aantalBytes,
+	                       DMAAfhandelaar &afhandelaar) = 0;
+
+	/*! @brief kan het kanaal segmenten in een keer versturen (gekoppelde DMA descriptors) */
+	virtual bool kanKetenen() const
+	{
+		return(false);
+	};
+
+	/*! @brief start een overdracht van alle segmenten achter elkaar, zonder kopie.
+	 * Alleen als kanKetenen() : het kanaal zet een descriptor per segment in een
+	 * keten en roept de afhandelaar een keer aan, na het laatste segment. */
+	virtual FoutCode startKetting(ZendSegment const * const segmenten,
+	                              const UInt32 aantal,
+	                              DMAAfhandelaar &afhandelaar)
+	{
+		static_cast<void>(segmenten);
+		static_cast<void>(aantal);
+		static_cast<void>(afhandelaar);
+		return(FoutCode::Fout);
+	};
+};
+
+/*! @class Verzendt een VerzendOntvangBuffer in een keer via DMA.
+ *
+ * In plaats van zend() per element aan te roepen en de bytes een voor een
+ * in de UART te schrijven, krijgt het DMA kanaal geefPtr() en het aantal
+ * geladen bytes : geefIndex() elementen, niet de hele capaciteit. Er wordt
+ * niets gekopieerd ; de CPU is vrij tot de completion interrupt, die de
+ * buffer met zetKlaar() als verzonden markeert. */
+template<typename ttype, const UInt32 Grootte>
+class DMAZender : public DMAAfhandelaar
+{
+public:
+
+	using Buffer = VerzendOntvangBuffer<ttype,Grootte>;
+
+	explicit DMAZender(DMAKanaal &k) : kanaal(k)
+	{
+
+	};
+
+	/*! @brief start de verzending van de geladen elementen van de buffer.
+	 * @return FoutCode::Fout als er nog een overdracht loopt, de buffer leeg is
+	 * of het kanaal weigert. */
+	FoutCode zend(Buffer &buffer)
+	{
+		if (true == isBezig())
+			return(FoutCode::Fout);
+
+		const UInt32 geladen = buffer.geefIndex();
+		if (0U == geladen)
+			return(FoutCode::Fout);
+
+		actief = &buffer;
+		actief->reset();
+
+		const auto retkode = kanaal.start(reinterpret_cast<UInt8 const *>(buffer.geefPtr()),
+		                                  geladen*sizeof(ttype),
+		                                  *this);
+		if (FoutCode::Ok != retkode)
+			actief = nullptr;
+
+		return(retkode);
+	};
+
+	/*! @brief aangeroepen vanuit de DMA completion ISR. */
+	void overdrachtKlaar() override
+	{
+		if (nullptr != actief)
+		{
+			actief->zetKlaar();
+			actief = nullptr;
+		}
+	};
+
+	bool isBezig() const
+	{
+		return(nullptr != actief);
+	};
+
+private:
+	DMAKanaal &kanaal;
+	Buffer * volatile actief = nullptr;
+};
+
+/*! @class Verzendt de segmenten van een SegmentLijst als een bericht via DMA.
+ *
+ * Kan het kanaal ketenen, dan gaat de hele lijst in een overdracht. Anders
+ * start de completion interrupt van elk segment het volgende ; er wordt
+ * ook dan niets gekopieerd. De lijst en de pakketten erin moeten geldig
+ * blijven zolang isBezig(). */
+template<const UInt32 MaxSegmenten>
+class GatherZender : public DMAAfhandelaar
+{
+public:
+
+	using Lijst = SegmentLijst<MaxSegmenten>;
+
+	explicit GatherZender(DMAKanaal &k) : kanaal(k)
+	{
+
+	};
+
+	/*! @brief start de verzending van alle segmenten.
+	 * @return FoutCode::Fout als er nog een bericht loopt, de lijst leeg is of het kanaal weigert. */
+	FoutCode zend(const Lijst &lijst)
+	{
+		if ((true == isBezig()) || (0U == lijst.geefAantal()))
+			return(FoutCode::Fout);
+
+		actief = &lijst;
+		afgebroken = false;
+
+		FoutCode retkode;
+		if (true == kanaal.kanKetenen())
+		{
+			volgende = lijst.geefAantal();
+			retkode = kanaal.startKetting(lijst.geefSegmenten(),lijst.geefAantal(),*this);
+		}
+		else
+		{
+			volgende = 0;
+			retkode = startVolgende();
+		}
+
+		if (FoutCode::Ok != retkode)
+			actief = nullptr;
+
+		return(retkode);
+	};
+
+	/*! @brief aangeroepen vanuit de DMA completion ISR. */
+	void overdrachtKlaar() override
+	{
+		if (nullptr == actief)
+			return;
+
+		if (volgende < actief->geefAantal())
+		{
+			if (FoutCode::Ok == startVolgende())
+				return;
+			afgebroken = true;  /* de rest van het bericht is niet verzonden */
+		}
+		actief = nullptr;
+	};
+
+	bool isBezig() const
+	{
+		return(nullptr != actief);
+	};
+
+	/*! @brief is het laatste bericht halverwege gestopt omdat het kanaal een segment weigerde */
+	bool isAfgebroken() const
+	{
+		return(true == afgebroken);
+	};
+
+private:
+
+	FoutCode startVolgende()
+	{
+		const ZendSegment &segment = (*actief)[volgende++];
+		return(kanaal.start(segment.bron,segment.aantalBytes,*this));
+	};
+
+	DMAKanaal &kanaal;
+	Lijst const * volatile actief = nullptr;
+	UInt32 volgende = 0;
+	volatile bool afgebroken = false;
+};
+
+/*! @brief Ongetekend type van N bytes, voor het (de)serialiseren van een veld */
+template<const UInt32 N> struct DraadWoord;
+template<> struct DraadWoord<1> { using Type = UInt8; };
+template<> struct DraadWoord<2> { using Type = UInt16; };
+template<> struct DraadWoord<4> { using Type = UInt32; };
+template<> struct DraadWoord<8> { using Type = UInt64; };
+
+/*! @brief lees een ttype (geheel getal, enum of float) in little endian.
+ *  De bytes worden altijd als LE samengesteld ; op de STM32 wordt dit een enkele load. */
+template<typename ttype>
+ttype leesLittleEndian(UInt8 const * const bron)
+{
+	using Woord = typename DraadWoord<sizeof(ttype)>::Type;
+	Woord ruw = 0;
+	for (UInt32 i=0; i < sizeof(ttype); i++)
+		ruw = static_cast<Woord>(ruw | (static_cast<Woord>(bron[i]) << (8U*i)));
+
+	ttype uit;
+	memcpy(&uit,&ruw,sizeof(uit));
+	return(uit);
+}
+
+/*! @brief schrijf een ttype in little endian */
+template<typename ttype>
+void schrijfLittleEndian(UInt8 * const bestemming, const ttype waarde)
+{
+	using Woord = typename DraadWoord<sizeof(ttype)>::Type;
+	Woord ruw;
+	memcpy(&ruw,&waarde,sizeof(ruw));
+	for (UInt32 i=0; i < sizeof(ttype); i++)
+		bestemming[i] = static_cast<UInt8>(ruw >> (8U*i));
+}
+
+/*! @brief Een veld in een draadformaat : type en plaats in bytes */
+template<typename ttype, const UInt32 Plaats>
+struct DraadVeld
+{
+	using Type = ttype;
+	static constexpr UInt32 plaats = Plaats;
+	static constexpr UInt32 einde = Plaats + sizeof(ttype);
+};
+
+/*! @class Niet-eigenaar, getypeerd zicht op een ontvangen bericht.
+ *
+ * Een Layout is een struct met de velden als DraadVeld typedefs en de
+ * berichtgrootte in Grootte, bijvoorbeeld :
+ *
+ *     struct MijnLayout
+ *     {
+ *         using Kommando = DraadVeld<UInt8,0>;
+ *         using Waarde   = DraadVeld<float,4>;
+ *         static constexpr UInt32 Grootte = 8;
+ *     };
+ *     const PakketView<MijnLayout> bericht(dmaBuffer, ontvangen);
+ *     const float w = bericht.lees<MijnLayout::Waarde>();
+ *
+ * Het zicht ligt over de buffer waarin het bericht binnenkwam (DMA, USB) ;
+ * er wordt niets gekopieerd. Velden worden pas bij lees() omgezet, little
+ * endian en zonder uitlijningseisen. Een FixedDataPakket is alleen nodig als
+ * het bericht zelf bewaard moet blijven. */
+template<typename Layout>
+class PakketView
+{
+public:
+	PakketView(UInt8 const * const dataPtr, const UInt32 gr) : data(dataPtr),grootte(gr)
+	{
+	};
+
+	explicit PakketView(const DataPakket<UInt8> &pakket) : PakketView(pakket.geefPtr(),pakket.geefGrootte())
+	{
+	};
+
+	/*! @brief is de buffer groot genoeg voor het hele bericht */
+	bool isVolledig() const
+	{
+		return((nullptr != data) && (grootte >= Layout::Grootte));
+	};
+
+	template<typename Veld>
+	typename Veld::Type lees() const
+	{
+		static_assert(Veld::einde <= Layout::Grootte, "PakketView : veld valt buiten de layout");
+		assert(true == isVolledig());
+		return(leesLittleEndian<typename Veld::Type>(data + Veld::plaats));
+	};
+
+	/*! @brief de bytes van het bericht, om zonder kopie door te sturen (bijvoorbeeld met DMAKanaal) */
+	UInt8 const * geefPtr() const
+	{
+		return(data);
+	};
+
+	static constexpr UInt32 geefGrootte()
+	{
+		return(Layout::Grootte);
+	};
+
+protected:
+	UInt8 const * data;
+	UInt32 grootte;
+};
+
+/*! @class Als PakketView, maar de velden kunnen ook ter plaatse worden geschreven */
+template<typename Layout>
+class SchrijfbarePakketView : public PakketView<Layout>
+{
+public:
+	SchrijfbarePakketView(UInt8 * const dataPtr, const UInt32 gr) : PakketView<Layout>(dataPtr,gr),schrijfData(dataPtr)
+	{
+	};
+
+	explicit SchrijfbarePakketView(DataPakket<UInt8> &pakket) : SchrijfbarePakketView(pakket.geefPtr(),pakket.geefGrootte())
+	{
+	};
+
+	template<typename Veld>
+	void schrijf(const typename Veld::Type waarde)
+	{
+		static_assert(Veld::einde <= Layout::Grootte, "PakketView : veld valt buiten de layout");
+		assert(true == PakketView<Layout>::isVolledig());
+		schrijfLittleEndian<typename Veld::Type>(schrijfData + Veld::plaats, waarde);
+	};
+
+private:
+	UInt8 * schrijfData;
+};
+
+/*! @class Zicht op een buffer met een reeks berichten van dezelfde Layout achter elkaar */
+template<typename Layout>
+class ReeksView
+{
+public:
+	ReeksView(UInt8 const * const dataPtr, const UInt32 gr) : data(dataPtr),aantalBerichten(gr/Layout::Grootte)
+	{
+	};
+
+	UInt32 aantal() const
+	{
+		return(aantalBerichten);
+	};
+
+	PakketView<Layout> operator [] (const UInt32 index) const
+	{
+		assert(index < aantalBerichten);
+		return(PakketView<Layout>(data + (index*Layout::Grootte), Layout::Grootte));
+	};
+
+private:
+	UInt8 const * data;
+	UInt32 aantalBerichten;
+};
+
+#ifdef HAL_UART_MODULE_ENABLED
+
+/*! @class DMAKanaal op een STM32 HAL UART.
+ * Roep tekKlaar() aan vanuit HAL_UART_TxCpltCallback() voor deze UART. */
+class HALUartDMAKanaal : public DMAKanaal
+{
+public:
+	explicit HALUartDMAKanaal(UART_HandleTypeDef &uart) : huart(uart)
+	{
+
+	};
+
+	FoutCode start(UInt8 const * const bron,
+	               const UInt32 aantalBytes,
+	               DMAAfhandelaar &a) override
+	{
+		assert(aantalBytes <= 0xffff);  /* HAL beperking */
+
+		afhandelaar = &a;
+		const auto status = HAL_UART_Transmit_DMA(&huart,
+		                                          const_cast<UInt8 *>(bron),
+		                                          static_cast<UInt16>(aantalBytes));
+		return((HAL_OK == status) ? FoutCode::Ok : FoutCode::Fout);
+	};
+
+	void tekKlaar()
+	{
+		if (nullptr != afhandelaar)
+			afhandelaar->overdrachtKlaar();
+	};
+
+private:
+	UART_HandleTypeDef &huart;
+	DMAAfhandelaar * volatile afhandelaar = nullptr;
+};
+
+#endif /* HAL_UART_MODULE_ENABLED */
 
 #endif /* DataPakket */
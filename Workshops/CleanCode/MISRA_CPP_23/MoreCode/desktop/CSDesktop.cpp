@@ -0,0 +1,432 @@
+/******************************************************************************
+ * Project        : University Project 3 - ControlSystem
+ * File           : Desktop ontvanger voor het CSData protocol
+ * Copyright      : 2010-2020 Original Authors
+ ******************************************************************************/
+
+#include <CSDesktop.h>
+
+#include <algorithm>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <termios.h>
+#include <unistd.h>
+
+static bool zoekBaudrate(const UInt32 baudrate, speed_t &snelheid)
+{
+	static const struct { UInt32 baud; speed_t snelheid; } tabel[] =
+	{
+		{9600U,B9600}, {19200U,B19200}, {38400U,B38400}, {57600U,B57600}, {115200U,B115200},
+		{230400U,B230400},
+#ifdef B460800
+		{460800U,B460800},
+#endif
+#ifdef B921600
+		{921600U,B921600},
+#endif
+#ifdef B2000000
+		{2000000U,B2000000},
+#endif
+	};
+
+	for (const auto &regel : tabel)
+	{
+		if (regel.baud == baudrate)
+		{
+			snelheid = regel.snelheid;
+			return(true);
+		}
+	}
+	return(false);
+}
+
+/* Wacht op data en lees wat er is. lees() retourneert direct na poll(),
+ * dus een groot blok kost een systeemaanroep in plaats van een per byte. */
+static Int32 leesMetWacht(const int fd, UInt8 * const bestemming, const UInt32 maximum, const Int32 wachtMs)
+{
+	struct pollfd wacht = {fd,POLLIN,0};
+	const auto klaar = poll(&wacht,1,wachtMs);
+	if (klaar == 0)
+		return(0);
+	if (klaar < 0)
+		return((errno == EINTR) ? 0 : -1);
+
+	const auto gelezen = read(fd,bestemming,maximum);
+	if (gelezen > 0)
+		return(static_cast<Int32>(gelezen));
+	if ((gelezen < 0) && ((errno == EAGAIN) || (errno == EINTR)))
+		return(0);
+	return(-1);  /* opgehangen (USB losgetrokken) of fout */
+}
+
+SeriePoort::SeriePoort(const std::string &pad, const UInt32 baudrate)
+{
+	speed_t snelheid;
+	if (false == zoekBaudrate(baudrate,snelheid))
+		return;
+
+	fd = open(pad.c_str(),O_RDWR | O_NOCTTY | O_NONBLOCK);
+	if (fd < 0)
+		return;
+
+	struct termios instelling;
+	if (tcgetattr(fd,&instelling) != 0)
+	{
+		close(fd);
+		fd = -1;
+		return;
+	}
+
+	/* ruw : geen echo, geen regelbewerking, geen vertaling van CR/LF */
+	cfmakeraw(&instelling);
+	instelling.c_cflag |= (CLOCAL | CREAD);
+	instelling.c_cc[VMIN] = 0;
+	instelling.c_cc[VTIME] = 0;
+	cfsetispeed(&instelling,snelheid);
+	cfsetospeed(&instelling,snelheid);
+
+	if (tcsetattr(fd,TCSANOW,&instelling) != 0)
+	{
+		close(fd);
+		fd = -1;
+		return;
+	}
+	tcflush(fd,TCIFLUSH);
+}
+
+SeriePoort::~SeriePoort()
+{
+	if (fd >= 0)
+		close(fd);
+}
+
+bool SeriePoort::isOpen() const
+{
+	return(fd >= 0);
+}
+
+Int32 SeriePoort::lees(UInt8 * const bestemming, const UInt32 maximum, const Int32 wachtMs)
+{
+	assert(nullptr != bestemming);
+	if (fd < 0)
+		return(-1);
+	return(leesMetWacht(fd,bestemming,maximum,wachtMs));
+}
+
+BestandBron::BestandBron(const std::string &pad) : fd(open(pad.c_str(),O_RDONLY))
+{
+}
+
+BestandBron::~BestandBron()
+{
+	if (fd >= 0)
+		close(fd);
+}
+
+bool BestandBron::isOpen() const
+{
+	return(fd >= 0);
+}
+
+Int32 BestandBron::lees(UInt8 * const bestemming, const UInt32 maximum, const Int32)
+{
+	assert(nullptr != bestemming);
+	if (fd < 0)
+		return(-1);
+
+	const auto gelezen = read(fd,bestemming,maximum);
+	return((gelezen > 0) ? static_cast<Int32>(gelezen) : -1);
+}
+
+KolomBestand::KolomBestand(const std::string &pad, const UInt32 elementGrootte) :
+	fd(open(pad.c_str(),O_RDWR | O_CREAT | O_TRUNC,0644)),grootte(elementGrootte)
+{
+	assert(elementGrootte > 0);
+}
+
+KolomBestand::~KolomBestand()
+{
+	if (nullptr != kaart)
+		munmap(kaart,gemapt);
+
+	if (fd >= 0)
+	{
+		/* het laatste blok is maar ten dele gebruikt */
+		if (ftruncate(fd,static_cast<off_t>(gebruikt)) != 0)
+			perror("KolomBestand : afkappen");
+		close(fd);
+	}
+}
+
+bool KolomBestand::isOpen() const
+{
+	return(fd >= 0);
+}
+
+bool KolomBestand::groei(const UInt64 nodig)
+{
+	const UInt64 nieuw = ((nodig + Blok - 1U)/Blok)*Blok;
+
+	if (ftruncate(fd,static_cast<off_t>(nieuw)) != 0)
+		return(false);
+
+	if (nullptr != kaart)
+	{
+		munmap(kaart,gemapt);
+		kaart = nullptr;
+		gemapt = 0;
+	}
+
+	void * const adres = mmap(nullptr,nieuw,PROT_READ | PROT_WRITE,MAP_SHARED,fd,0);
+	if (MAP_FAILED == adres)
+		return(false);
+
+	kaart = static_cast<UInt8 *>(adres);
+	gemapt = nieuw;
+	return(true);
+}
+
+void * KolomBestand::reserveer(const UInt32 aantal)
+{
+	if (fd < 0)
+		return(nullptr);
+
+	const UInt64 nodig = gebruikt + (static_cast<UInt64>(aantal)*grootte);
+	if ((nodig > gemapt) && (false == groei(nodig)))
+		return(nullptr);
+
+	return(kaart + gebruikt);
+}
+
+void KolomBestand::bevestig(const UInt32 aantal)
+{
+	gebruikt += static_cast<UInt64>(aantal)*grootte;
+	assert(gebruikt <= gemapt);
+}
+
+UInt64 KolomBestand::geefAantal() const
+{
+	return(gebruikt/grootte);
+}
+
+/* Zelfde som als CSKompaktData::konverteerFixedPoint(), zonder aanroep per
+ * sample zodat de compiler de lus kan vectoriseren. */
+void naarSpanningen(UInt16 const * const draad, float * const uit, const UInt32 aantal)
+{
+	static constexpr UInt16 fraktieBereik = 0xfff;
+
+	for (UInt32 i=0; i < aantal; i++)
+	{
+		const UInt16 geheel = static_cast<UInt16>(draad[i] >> 12);
+		const UInt16 fraktie = static_cast<UInt16>(draad[i] & fraktieBereik);
+		uit[i] = static_cast<float>(geheel) + static_cast<float>(fraktie)/fraktieBereik;
+	}
+}
+
+static void schrijfBeschrijving(const std::string &map, const CSStroomOntvanger::Formaat formaat)
+{
+	FILE * const bestand = fopen((map + "/kolommen.txt").c_str(),"w");
+	if (nullptr == bestand)
+		return;
+
+	const bool kompakt = (CSStroomOntvanger::Formaat::Kompakt == formaat);
+	fprintf(bestand,"# CSData desktop opname, formaat %s\n",kompakt ? "kompakt" : "volledig");
+	fprintf(bestand,"# bestand type aantal_samples = grootte / bytes_per_element, little endian\n");
+	fprintf(bestand,"n.bin %s\n",kompakt ? "uint16" : "uint32");
+	fprintf(bestand,"meting.bin float32\n");
+	fprintf(bestand,"referentie.bin float32\n");
+	fprintf(bestand,"controle.bin float32\n");
+	fclose(bestand);
+}
+
+CSStroomOntvanger::CSStroomOntvanger(const Formaat f, const std::string &map) :
+	formaat(f),
+	sampleGrootte((Formaat::Kompakt == f) ? CSKompaktData::DraadGrootte : CSVolledigData::DraadGrootte),
+	nMasker((Formaat::Kompakt == f) ? 0xFFFFU : 0xFFFFFFFFU),
+	kolomN(map + "/n.bin",(Formaat::Kompakt == f) ? sizeof(UInt16) : sizeof(UInt32)),
+	kolomMeting(map + "/meting.bin",sizeof(float)),
+	kolomReferentie(map + "/referentie.bin",sizeof(float)),
+	kolomControle(map + "/controle.bin",sizeof(float))
+{
+	schrijfBeschrijving(map,f);
+}
+
+bool CSStroomOntvanger::isOpen() const
+{
+	return(kolomN.isOpen() && kolomMeting.isOpen() && kolomReferentie.isOpen() && kolomControle.isOpen());
+}
+
+UInt32 CSStroomOntvanger::leesN(UInt8 const * const sample) const
+{
+	if (Formaat::Kompakt == formaat)
+		return(PakketView<CSKompaktData::Layout>(sample,sampleGrootte).lees<CSKompaktData::Layout::N>());
+	else
+		return(PakketView<CSVolledigData::Layout>(sample,sampleGrootte).lees<CSVolledigData::Layout::N>());
+}
+
+/* De eerste byte-positie van waaruit n UitlijnSamples keer een oploopt,
+ * of sampleGrootte als er geen is. */
+UInt32 CSStroomOntvanger::zoekUitlijning(UInt8 const * const data, const UInt32 lengte) const
+{
+	assert(lengte >= ((UitlijnSamples + 1U)*sampleGrootte));
+
+	for (UInt32 begin=0; begin < sampleGrootte; begin++)
+	{
+		bool oplopend = true;
+		for (UInt32 i=1; (i < UitlijnSamples) && (true == oplopend); i++)
+		{
+			const auto vorige = leesN(data + begin + ((i - 1U)*sampleGrootte));
+			const auto deze = leesN(data + begin + (i*sampleGrootte));
+			oplopend = (((vorige + 1U) & nMasker) == deze);
+		}
+		if (true == oplopend)
+			return(begin);
+	}
+	return(sampleGrootte);
+}
+
+void CSStroomOntvanger::telSprongen(const UInt32 n)
+{
+	if (false == eersteSample)
+		verloren += ((n - (vorigeN + 1U)) & nMasker);
+
+	eersteSample = false;
+	vorigeN = n;
+}
+
+FoutCode CSStroomOntvanger::decodeerKompakt(UInt8 const * const data, const UInt32 aantal)
+{
+	using Layout = CSKompaktData::Layout;
+
+	auto * const n = kolomN.reserveer<UInt16>(aantal);
+	auto * const meting = kolomMeting.reserveer<float>(aantal);
+	auto * const referentie = kolomReferentie.reserveer<float>(aantal);
+	auto * const controle = kolomControle.reserveer<float>(aantal);
+	if ((nullptr == n) || (nullptr == meting) || (nullptr == referentie) || (nullptr == controle))
+		return(FoutCode::Fout);
+
+	UInt16 ruwMeting[Stuk];
+	UInt16 ruwReferentie[Stuk];
+	UInt16 ruwControle[Stuk];
+
+	const ReeksView<Layout> reeks(data,aantal*sampleGrootte);
+	for (UInt32 i=0; i < aantal; i++)
+	{
+		const auto sample = reeks[i];
+		n[i] = sample.lees<Layout::N>();
+		ruwMeting[i] = sample.lees<Layout::Meting>();
+		ruwReferentie[i] = sample.lees<Layout::Referentie>();
+		ruwControle[i] = sample.lees<Layout::Controle>();
+		telSprongen(n[i]);
+	}
+	naarSpanningen(ruwMeting,meting,aantal);
+	naarSpanningen(ruwReferentie,referentie,aantal);
+	naarSpanningen(ruwControle,controle,aantal);
+
+	kolomN.bevestig(aantal);
+	kolomMeting.bevestig(aantal);
+	kolomReferentie.bevestig(aantal);
+	kolomControle.bevestig(aantal);
+	return(FoutCode::Ok);
+}
+
+FoutCode CSStroomOntvanger::decodeerVolledig(UInt8 const * const data, const UInt32 aantal)
+{
+	using Layout = CSVolledigData::Layout;
+
+	auto * const n = kolomN.reserveer<UInt32>(aantal);
+	auto * const meting = kolomMeting.reserveer<float>(aantal);
+	auto * const referentie = kolomReferentie.reserveer<float>(aantal);
+	auto * const controle = kolomControle.reserveer<float>(aantal);
+	if ((nullptr == n) || (nullptr == meting) || (nullptr == referentie) || (nullptr == controle))
+		return(FoutCode::Fout);
+
+	const ReeksView<Layout> reeks(data,aantal*sampleGrootte);
+	for (UInt32 i=0; i < aantal; i++)
+	{
+		const auto sample = reeks[i];
+		n[i] = sample.lees<Layout::N>();
+		meting[i] = sample.lees<Layout::Meting>();
+		referentie[i] = sample.lees<Layout::Referentie>();
+		controle[i] = sample.lees<Layout::Controle>();
+		telSprongen(n[i]);
+	}
+
+	kolomN.bevestig(aantal);
+	kolomMeting.bevestig(aantal);
+	kolomReferentie.bevestig(aantal);
+	kolomControle.bevestig(aantal);
+	return(FoutCode::Ok);
+}
+
+FoutCode CSStroomOntvanger::decodeer(UInt8 const * const data, const UInt32 aantal)
+{
+	for (UInt32 klaar=0; klaar < aantal; )
+	{
+		const auto stuk = std::min(Stuk,aantal - klaar);
+		const auto retkode = (Formaat::Kompakt == formaat) ?
+		                     decodeerKompakt(data + (klaar*sampleGrootte),stuk) :
+		                     decodeerVolledig(data + (klaar*sampleGrootte),stuk);
+		if (FoutCode::Ok != retkode)
+			return(retkode);
+
+		klaar += stuk;
+		samples += stuk;
+	}
+	return(FoutCode::Ok);
+}
+
+FoutCode CSStroomOntvanger::verwerk(UInt8 const * const data, const UInt32 lengte)
+{
+	assert((nullptr != data) || (0 == lengte));
+	UInt32 plek = 0;
+
+	/* begin van de stroom : verzamel genoeg samples om de uitlijning te vinden */
+	const UInt32 uitlijnGrootte = (UitlijnSamples + 1U)*sampleGrootte;
+	while (false == uitgelijnd)
+	{
+		const auto kopie = std::min(lengte - plek,uitlijnGrootte - restLengte);
+		memcpy(rest + restLengte,data + plek,kopie);
+		restLengte += kopie;
+		plek += kopie;
+		if (restLengte < uitlijnGrootte)
+			return(FoutCode::Ok);
+
+		const auto begin = zoekUitlijning(rest,restLengte);
+		const auto weg = (begin < sampleGrootte) ? begin : sampleGrootte;
+		memmove(rest,rest + weg,restLengte - weg);
+		restLengte -= weg;
+		overgeslagen += weg;
+		uitgelijnd = (begin < sampleGrootte);
+	}
+
+	/* maak een sample uit het vorige blok af */
+	if (0 != restLengte)
+	{
+		const auto ontbreekt = (sampleGrootte - (restLengte % sampleGrootte)) % sampleGrootte;
+		const auto kopie = std::min(lengte - plek,ontbreekt);
+		memcpy(rest + restLengte,data + plek,kopie);
+		restLengte += kopie;
+		plek += kopie;
+		if (0 != (restLengte % sampleGrootte))
+			return(FoutCode::Ok);
+
+		const auto retkode = decodeer(rest,restLengte/sampleGrootte);
+		restLengte = 0;
+		if (FoutCode::Ok != retkode)
+			return(retkode);
+	}
+
+	/* de hele samples direct uit het ontvangen blok */
+	const auto aantal = (lengte - plek)/sampleGrootte;
+	const auto retkode = decodeer(data + plek,aantal);
+	plek += aantal*sampleGrootte;
+
+	restLengte = lengte - plek;
+	memcpy(rest,data + plek,restLengte);
+	return(retkode);
+}
@@ -0,0 +1,167 @@
+/******************************************************************************
+ * Project        : University Project 3 - ControlSystem
+ * File           : csontvang : CSData meetstroom opnemen op de desktop
+ * Copyright      : 2010-2020 Original Authors
+ ******************************************************************************
+
+ Gebruik :
+     csontvang --poort /dev/ttyACM0 [--baud 115200] [--formaat kompakt|volledig] [--uit map]
+     csontvang --bestand opname.raw [--formaat kompakt|volledig] [--uit map]
+
+ De samples komen als kolommen in de map (standaard .), zie kolommen.txt.
+ Elke seconde gaan doorvoer en verloren samples naar stderr. Stop met Ctrl-C.
+
+ Vertalen, vanuit MoreCode (CSData.h is de header in rgtData/h) :
+     g++ -std=c++17 -O2 -Ialgemeen/h -IrgtData/h -Idesktop/h desktop/csontvang.cpp \
+         desktop/CSDesktop.cpp rgtData/RGTData.cpp algemeen/algdef.cpp -o csontvang
+
+******************************************************************************/
+
+#include <CSDesktop.h>
+
+#include <chrono>
+#include <memory>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static volatile sig_atomic_t stoppen = 0;
+
+static void stopSignaal(int)
+{
+	stoppen = 1;
+}
+
+static void gebruik(const char * const naam)
+{
+	fprintf(stderr,"gebruik : %s (--poort <apparaat> [--baud <n>] | --bestand <opname>)"
+	               " [--formaat kompakt|volledig] [--uit <map>]\n",naam);
+}
+
+int main(int argc, char *argv[])
+{
+	std::string poort;
+	std::string bestand;
+	std::string map = ".";
+	UInt32 baudrate = 115200U;
+	auto formaat = CSStroomOntvanger::Formaat::Kompakt;
+
+	for (int i=1; i < argc; i++)
+	{
+		const bool heeftWaarde = (i + 1) < argc;
+		if ((0 == strcmp(argv[i],"--poort")) && heeftWaarde)
+			poort = argv[++i];
+		else if ((0 == strcmp(argv[i],"--bestand")) && heeftWaarde)
+			bestand = argv[++i];
+		else if ((0 == strcmp(argv[i],"--uit")) && heeftWaarde)
+			map = argv[++i];
+		else if ((0 == strcmp(argv[i],"--baud")) && heeftWaarde)
+			baudrate = static_cast<UInt32>(strtoul(argv[++i],nullptr,10));
+		else if ((0 == strcmp(argv[i],"--formaat")) && heeftWaarde)
+		{
+			const std::string keuze = argv[++i];
+			if (keuze == "kompakt")
+				formaat = CSStroomOntvanger::Formaat::Kompakt;
+			else if (keuze == "volledig")
+				formaat = CSStroomOntvanger::Formaat::Volledig;
+			else
+			{
+				gebruik(argv[0]);
+				return(EXIT_FAILURE);
+			}
+		}
+		else
+		{
+			gebruik(argv[0]);
+			return(EXIT_FAILURE);
+		}
+	}
+
+	if (poort.empty() == bestand.empty())
+	{
+		gebruik(argv[0]);
+		return(EXIT_FAILURE);
+	}
+
+	std::unique_ptr<ByteBron> bron;
+	if (false == poort.empty())
+	{
+		auto seriePoort = std::make_unique<SeriePoort>(poort,baudrate);
+		if (false == seriePoort->isOpen())
+		{
+			fprintf(stderr,"kan %s niet openen op %u baud\n",poort.c_str(),static_cast<unsigned>(baudrate));
+			return(EXIT_FAILURE);
+		}
+		bron = std::move(seriePoort);
+	}
+	else
+	{
+		auto opname = std::make_unique<BestandBron>(bestand);
+		if (false == opname->isOpen())
+		{
+			fprintf(stderr,"kan %s niet openen\n",bestand.c_str());
+			return(EXIT_FAILURE);
+		}
+		bron = std::move(opname);
+	}
+
+	CSStroomOntvanger ontvanger(formaat,map);
+	if (false == ontvanger.isOpen())
+	{
+		fprintf(stderr,"kan de kolombestanden in %s niet aanmaken\n",map.c_str());
+		return(EXIT_FAILURE);
+	}
+
+	signal(SIGINT,stopSignaal);
+	signal(SIGTERM,stopSignaal);
+
+	/* groot genoeg om een USB CDC stroom met een systeemaanroep per poll() te lezen */
+	static UInt8 blok[64U*1024U];
+
+	using Klok = std::chrono::steady_clock;
+	const auto start = Klok::now();
+	auto melding = start;
+	UInt64 bytes = 0;
+	UInt64 bytesSindsMelding = 0;
+	UInt64 samplesSindsMelding = 0;
+	auto retkode = FoutCode::Ok;
+
+	while ((0 == stoppen) && (FoutCode::Ok == retkode))
+	{
+		const auto gelezen = bron->lees(blok,sizeof(blok),200);
+		if (gelezen < 0)
+			break;
+
+		retkode = ontvanger.verwerk(blok,static_cast<UInt32>(gelezen));
+		bytes += static_cast<UInt64>(gelezen);
+
+		const auto nu = Klok::now();
+		const std::chrono::duration<double> verstreken = nu - melding;
+		if (verstreken.count() >= 1.0)
+		{
+			fprintf(stderr,"%.0f B/s, %.0f samples/s, %llu samples, %llu verloren\n",
+			        static_cast<double>(bytes - bytesSindsMelding)/verstreken.count(),
+			        static_cast<double>(ontvanger.geefSamples() - samplesSindsMelding)/verstreken.count(),
+			        static_cast<unsigned long long>(ontvanger.geefSamples()),
+			        static_cast<unsigned long long>(ontvanger.geefVerloren()));
+			melding = nu;
+			bytesSindsMelding = bytes;
+			samplesSindsMelding = ontvanger.geefSamples();
+		}
+	}
+
+	const std::chrono::duration<double> totaal = Klok::now() - start;
+	fprintf(stderr,"klaar : %llu bytes in %.2f s, %llu samples, %llu verloren, %u bytes overgeslagen bij het uitlijnen\n",
+	        static_cast<unsigned long long>(bytes),totaal.count(),
+	        static_cast<unsigned long long>(ontvanger.geefSamples()),
+	        static_cast<unsigned long long>(ontvanger.geefVerloren()),
+	        static_cast<unsigned>(ontvanger.geefOvergeslagenBytes()));
+
+	if (FoutCode::Ok != retkode)
+	{
+		fprintf(stderr,"schrijven naar %s mislukt\n",map.c_str());
+		return(EXIT_FAILURE);
+	}
+	return(EXIT_SUCCESS);
+}
@@ -0,0 +1,174 @@
+/******************************************************************************
+ * Project        : University Project 3 - ControlSystem
+ * File           : Desktop ontvanger voor het CSData protocol
+ * Copyright      : 2010-2020 Original Authors
+ ******************************************************************************
+
+ De desktop (host) kant van het CSKompaktData / CSVolledigData protocol.
+
+ Een ByteBron (seriele poort of opgenomen bestand) wordt in grote blokken
+ gelezen. De samples worden in het leesblok zelf gedecodeerd (ReeksView,
+ geen kopie per sample), de Q4.12 spanningen worden per blok omgezet, en de
+ uitkomst gaat kolomsgewijs naar gemapte bestanden : een bestand per veld,
+ direct te laden met bijvoorbeeld numpy.fromfile of memmap.
+
+ Alleen POSIX (Linux, macOS).
+
+******************************************************************************/
+
+#ifndef ESE_ControlSystem_CSDesktop_H
+#define ESE_ControlSystem_CSDesktop_H
+
+#include <CSData.h>
+#include <string>
+#include <assert.h>
+
+/*! @class Bron van ontvangen bytes */
+class ByteBron
+{
+public:
+	virtual ~ByteBron() = default;
+
+	/*! @brief lees wat er is, hoogstens maximum bytes, wacht hoogstens wachtMs.
+	 * @return het aantal bytes, 0 bij een time-out, -1 aan het einde of bij een fout. */
+	virtual Int32 lees(UInt8 * const bestemming, const UInt32 maximum, const Int32 wachtMs) = 0;
+};
+
+/*! @class Seriele poort of USB CDC apparaat, ruw en niet-blokkerend */
+class SeriePoort : public ByteBron
+{
+public:
+	SeriePoort(const std::string &pad, const UInt32 baudrate);
+	~SeriePoort() override;
+
+	SeriePoort(const SeriePoort &) = delete;
+	SeriePoort & operator = (const SeriePoort &) = delete;
+
+	bool isOpen() const;
+
+	Int32 lees(UInt8 * const bestemming, const UInt32 maximum, const Int32 wachtMs) override;
+
+private:
+	int fd = -1;
+};
+
+/*! @class Eerder opgenomen ruwe stroom, voor het opnieuw afspelen */
+class BestandBron : public ByteBron
+{
+public:
+	explicit BestandBron(const std::string &pad);
+	~BestandBron() override;
+
+	BestandBron(const BestandBron &) = delete;
+	BestandBron & operator = (const BestandBron &) = delete;
+
+	bool isOpen() const;
+
+	Int32 lees(UInt8 * const bestemming, const UInt32 maximum, const Int32 wachtMs) override;
+
+private:
+	int fd = -1;
+};
+
+/*! @class Een kolom van vaste elementgrootte in een gemapt bestand.
+ *  Het bestand groeit per Blok bytes ; bij het sluiten wordt het op de
+ *  exacte lengte afgekapt. */
+class KolomBestand
+{
+public:
+	static constexpr UInt32 Blok = 16U*1024U*1024U;
+
+	KolomBestand(const std::string &pad, const UInt32 elementGrootte);
+	~KolomBestand();
+
+	KolomBestand(const KolomBestand &) = delete;
+	KolomBestand & operator = (const KolomBestand &) = delete;
+
+	bool isOpen() const;
+
+	/*! @brief ruimte voor aantal elementen achter elkaar, nullptr als het bestand niet kan groeien */
+	void * reserveer(const UInt32 aantal);
+
+	template<typename ttype>
+	ttype * reserveer(const UInt32 aantal)
+	{
+		assert(sizeof(ttype) == grootte);
+		return(static_cast<ttype *>(reserveer(aantal)));
+	};
+
+	/*! @brief de aantal elementen van de laatste reserveer() zijn geschreven */
+	void bevestig(const UInt32 aantal);
+
+	UInt64 geefAantal() const;
+
+private:
+	bool groei(const UInt64 nodig);
+
+	int fd = -1;
+	UInt8 * kaart = nullptr;
+	UInt64 gemapt = 0;
+	UInt64 gebruikt = 0;
+	const UInt32 grootte;
+};
+
+/*! @brief Q4.12 draadwaarden naar spanningen, een blok tegelijk (vectoriseerbaar).
+ *  Geeft hetzelfde resultaat als CSKompaktData::naarSpanning(). */
+void naarSpanningen(UInt16 const * const draad, float * const uit, const UInt32 aantal);
+
+/*! @class Decodeert een stroom samples naar kolombestanden.
+ *
+ * De stroom heeft geen synchronisatie : de eerste samples worden gebruikt
+ * om de uitlijning te vinden (n loopt per sample een op). Sprongen in n
+ * worden geteld als verloren samples. */
+class CSStroomOntvanger
+{
+public:
+	enum class Formaat : UInt8
+	{
+		Kompakt,     /* CSKompaktData, 8 bytes */
+		Volledig     /* CSVolledigData, 20 bytes */
+	};
+
+	/*! @param map : de map voor de kolombestanden (moet bestaan) */
+	CSStroomOntvanger(const Formaat, const std::string &map);
+
+	bool isOpen() const;
+
+	/*! @brief verwerk ontvangen bytes ; een onvolledig sample wordt bewaard tot het volgende blok */
+	FoutCode verwerk(UInt8 const * const data, const UInt32 lengte);
+
+	UInt64 geefSamples() const { return(samples); }
+	UInt64 geefVerloren() const { return(verloren); }
+	UInt32 geefOvergeslagenBytes() const { return(overgeslagen); }
+
+private:
+	UInt32 zoekUitlijning(UInt8 const * const data, const UInt32 lengte) const;
+	UInt32 leesN(UInt8 const * const sample) const;
+	FoutCode decodeer(UInt8 const * const data, const UInt32 aantal);
+	FoutCode decodeerKompakt(UInt8 const * const data, const UInt32 aantal);
+	FoutCode decodeerVolledig(UInt8 const * const data, const UInt32 aantal);
+	void telSprongen(const UInt32 n);
+
+	static constexpr UInt32 UitlijnSamples = 8;
+	static constexpr UInt32 MaxSampleGrootte = CSVolledigData::DraadGrootte;
+	static constexpr UInt32 Stuk = 1024;  /* samples per omzetting */
+
+	const Formaat formaat;
+	const UInt32 sampleGrootte;
+	const UInt32 nMasker;
+	KolomBestand kolomN;
+	KolomBestand kolomMeting;
+	KolomBestand kolomReferentie;
+	KolomBestand kolomControle;
+
+	UInt8 rest[MaxSampleGrootte*(UitlijnSamples+1)] = {};
+	UInt32 restLengte = 0;
+	bool uitgelijnd = false;
+	bool eersteSample = true;
+	UInt32 vorigeN = 0;
+	UInt64 samples = 0;
+	UInt64 verloren = 0;
+	UInt32 overgeslagen = 0;
+};
+
+#endif
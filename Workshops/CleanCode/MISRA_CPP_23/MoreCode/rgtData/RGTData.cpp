@@ -17,6 +17,42 @@ $Id: CSData.cpp 3290 2019-01-21 16:32:56Z dev $
 #include <CSData.h>
 #include <assert.h>
 
+/* Het draadformaat is little endian. Op een little endian doel (STM32) is het
+ * geheugenformaat gelijk aan het draadformaat en volstaat een memcpy. */
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+static constexpr bool DraadIsGeheugen = true;
+#else
+static constexpr bool DraadIsGeheugen = false;
+#endif
+
+static void schrijfLE(UInt8 * const bestemming, const UInt32 waarde, const UInt32 aantalBytes)
+{
+	for (UInt32 i=0; i < aantalBytes; i++)
+		bestemming[i] = static_cast<UInt8>(waarde >> (8*i));
+}
+
+static UInt32 leesLE(UInt8 const * const bron, const UInt32 aantalBytes)
+{
+	UInt32 uit=0;
+	for (UInt32 i=0; i < aantalBytes; i++)
+		uit |= static_cast<UInt32>(bron[i]) << (8*i);
+	return(uit);
+}
+
+static UInt32 floatBits(const float waarde)
+{
+	UInt32 uit;
+	memcpy(&uit,&waarde,sizeof(uit));
+	return(uit);
+}
+
+static float bitsFloat(const UInt32 bits)
+{
+	float uit;
+	memcpy(&uit,&bits,sizeof(uit));
+	return(uit);
+}
+
 CSKommando::CSKommando(const Kommando cmd,
                          const Spanning setp,
                          const UInt16 aantalPunten,
@@ -230,6 +266,185 @@ void CSKommando::schrijfIndex( const UInt32 index,const float waarde)
 
 
 
+/* Veldnummers : volgorde van CSKommandoOntvanger::veldSchemas */
+enum KommandoVeld : UInt8
+{
+	VeldAantalPerioden=0,
+	VeldKeuze,
+	VeldAantalPunten,
+	VeldVertraging,
+	VeldSetPoint,
+	VeldP,              /* ook beginfrequentie */
+	VeldI,              /* ook amplitude */
+	VeldD,
+	VeldVersterking,
+	AantalKommandoVelden
+};
+
+static constexpr UInt16 veldBit(const KommandoVeld veld)
+{
+	return(static_cast<UInt16>(1U << veld));
+}
+
+static constexpr UInt16 SignaalVelden = veldBit(VeldSetPoint) | veldBit(VeldAantalPunten) |
+                                        veldBit(VeldVertraging) | veldBit(VeldVersterking);
+static constexpr UInt16 PeriodiekeVelden = SignaalVelden | veldBit(VeldAantalPerioden) | veldBit(VeldP) | veldBit(VeldI);
+static constexpr UInt16 ParameterVelden = veldBit(VeldP) | veldBit(VeldI) | veldBit(VeldD);
+
+/* Spanningen in het Q4.12 bereik van CSKompaktData */
+static constexpr float MaxSpanning = 16.0f;
+static constexpr float MaxParameter = 10000.0f;
+static constexpr float MaxVersterking = 1000.0f;
+
+const CSKommandoOntvanger::VeldSchema CSKommandoOntvanger::veldSchemas[AantalKommandoVelden] =
+{
+	{ CSKommando::AantalPeriodenIndex, sizeof(UInt8),    VeldSoort::U8,       1.0f,            255.0f },
+	{ CSKommando::RegelaarKeuzeIndex,  sizeof(UInt8),    VeldSoort::Keuze,    0.0f,            0.0f },
+	{ CSKommando::AantalPuntenIndex,   sizeof(UInt16),   VeldSoort::U16,      1.0f,            65535.0f },
+	{ CSKommando::VertragingIndex,     sizeof(UInt16),   VeldSoort::U16,      0.0f,            65535.0f },
+	{ CSKommando::SetPointIndex,       sizeof(Spanning), VeldSoort::Drijvend, -MaxSpanning,    MaxSpanning },
+	{ CSKommando::PwaardeIndex,        sizeof(PIDveld),  VeldSoort::Drijvend, -MaxParameter,   MaxParameter },
+	{ CSKommando::IwaardeIndex,        sizeof(PIDveld),  VeldSoort::Drijvend, -MaxParameter,   MaxParameter },
+	{ CSKommando::DwaardeIndex,        sizeof(PIDveld),  VeldSoort::Drijvend, -MaxParameter,   MaxParameter },
+	{ CSKommando::VersterkingIndex,    sizeof(float),    VeldSoort::Drijvend, -MaxVersterking, MaxVersterking },
+};
+
+const CSKommandoOntvanger::KommandoSchema CSKommandoOntvanger::kommandoSchemas[static_cast<UInt8>(CSKommando::Kommando::Laatste)] =
+{
+	{ SignaalVelden,    0 },   /* Stap */
+	{ SignaalVelden,    0 },   /* Helling */
+	{ SignaalVelden,    0 },   /* Impuls */
+	{ PeriodiekeVelden, 0 },   /* Blok */
+	{ PeriodiekeVelden, 0 },   /* Cosinus */
+	{ veldBit(VeldKeuze), static_cast<UInt8>(CSKommando::RegelaarKeuze::Fuzzy) },
+	{ veldBit(VeldKeuze), static_cast<UInt8>(CSKommando::ProcesKeuze::Digitaal) },
+	{ ParameterVelden,  0 },   /* ZetOnOffParameters */
+	{ ParameterVelden,  0 },   /* ZetFuzzyParameters */
+	{ ParameterVelden,  0 },   /* ZetPIDParameters */
+	{ 0,                0 },   /* GeefVersie */
+	{ 0,                0 },   /* GaSlapen */
+	{ 0,                0 },   /* AntwoordNaarDesktop */
+	{ 0,                0 },   /* Leeg */
+};
+
+void CSKommandoOntvanger::reset()
+{
+	positie = 0;
+	afgekeurd = false;
+}
+
+CSKommandoOntvanger::Status CSKommandoOntvanger::keurAf(const Fout f)
+{
+	fout = f;
+	foutPositie = positie;
+	/* sla de rest van het frame over, tenzij dit de laatste byte was */
+	afgekeurd = ((positie+1U) < CSKommandoGrootte);
+	positie = (true == afgekeurd) ? static_cast<UInt8>(positie+1U) : static_cast<UInt8>(0U);
+	return(Status::Afgekeurd);
+}
+
+CSKommandoOntvanger::Status CSKommandoOntvanger::ontvang(const UInt8 byte)
+{
+	if (true == afgekeurd)
+	{
+		positie++;
+		if (positie == CSKommandoGrootte)
+			reset();
+		return(Status::Bezig);
+	}
+
+	if (CSKommando::CmdIndex == positie)
+	{
+		if (byte >= static_cast<UInt8>(CSKommando::Kommando::Laatste))
+			return(keurAf(Fout::OnbekendKommando));
+
+		ontvangen = CSOntvangenKommando();
+		ontvangen.kommando = static_cast<CSKommando::Kommando>(byte);
+		schemaVelden = kommandoSchemas[byte].velden;
+		keuzeMaximum = kommandoSchemas[byte].keuzeMaximum;
+	}
+	else if (CSKommando::VersieIndex == positie)
+	{
+		if (CSKommando::VERSION != byte)
+			return(keurAf(Fout::VerkeerdeVersie));
+
+		ontvangen.versie = byte;
+	}
+	else
+	{
+		/* alleen de velden van dit kommando ; regelaarkeuze en aantal punten delen een plaats */
+		for (UInt8 veld=0; veld < AantalKommandoVelden; veld++)
+		{
+			const VeldSchema &schema = veldSchemas[veld];
+			const bool gebruikt = (0U != (schemaVelden & veldBit(static_cast<KommandoVeld>(veld))));
+			if ((false == gebruikt) || (positie < schema.index) || (positie >= (schema.index + schema.grootte)))
+				continue;
+
+			const UInt8 plaats = static_cast<UInt8>(positie - schema.index);
+			ruw = (0U == plaats) ? 0U : ruw;
+			ruw |= static_cast<UInt32>(byte) << (8U*plaats);
+
+			if (((plaats+1U) == schema.grootte) && (false == neemVeldOp(veld)))
+				return(keurAf(Fout::BuitenBereik));
+		}
+	}
+
+	positie++;
+	if (positie < CSKommandoGrootte)
+		return(Status::Bezig);
+
+	positie = 0;
+	kommando = ontvangen;
+	fout = Fout::Geen;
+	return(Status::Klaar);
+}
+
+bool CSKommandoOntvanger::neemVeldOp(const UInt8 veldNummer)
+{
+	const VeldSchema &schema = veldSchemas[veldNummer];
+
+	float waarde = 0.0f;
+	switch (schema.soort)
+	{
+	case VeldSoort::Keuze:
+		if (ruw > keuzeMaximum)
+			return(false);
+		ontvangen.keuze = static_cast<UInt8>(ruw);
+		return(true);
+
+	case VeldSoort::Drijvend:
+		waarde = bitsFloat(ruw);
+		break;
+
+	case VeldSoort::U8:
+	case VeldSoort::U16:
+	default:
+		waarde = static_cast<float>(ruw);
+		break;
+	}
+
+	/* zo geschreven dat ook NaN wordt afgekeurd */
+	if (!((waarde >= schema.minimum) && (waarde <= schema.maximum)))
+		return(false);
+
+	switch (static_cast<KommandoVeld>(veldNummer))
+	{
+	case VeldAantalPerioden: ontvangen.aantalPerioden = static_cast<UInt8>(ruw); break;
+	case VeldAantalPunten:   ontvangen.aantalPunten = static_cast<UInt16>(ruw); break;
+	case VeldVertraging:     ontvangen.vertraging = static_cast<UInt16>(ruw); break;
+	case VeldSetPoint:       ontvangen.setPoint = waarde; break;
+	case VeldP:              ontvangen.veldP = waarde; break;
+	case VeldI:              ontvangen.veldI = waarde; break;
+	case VeldD:              ontvangen.veldD = waarde; break;
+	case VeldVersterking:    ontvangen.versterking = waarde; break;
+	case VeldKeuze:
+	case AantalKommandoVelden:
+	default:
+		break;
+	}
+	return(true);
+}
+
 CSTitel::CSTitel(char const *const titel) : FixedDataPakket(reinterpret_cast<const UInt8 *>(titel))
 {
 #ifndef NDEBUG
@@ -257,6 +472,50 @@ CSVolledigData::CSVolledigData(const SampleMoment nm,
 };
 
 
+static_assert(sizeof(CSVolledigData) == CSVolledigData::DraadGrootte, "CSVolledigData bevat padding");
+
+UInt32 CSVolledigData::serialiseer(UInt8 * const bestemming, const UInt32 ruimte) const
+{
+	assert(nullptr != bestemming);
+	if (ruimte < DraadGrootte)
+		return(0);
+
+	if (true == DraadIsGeheugen)
+	{
+		memcpy(bestemming,this,DraadGrootte);
+	}
+	else
+	{
+		schrijfLE(&bestemming[0],n,sizeof(UInt32));
+		schrijfLE(&bestemming[4],reserveWaarde,sizeof(UInt32));
+		schrijfLE(&bestemming[8],floatBits(measurementValue),sizeof(UInt32));
+		schrijfLE(&bestemming[12],floatBits(referenceValue),sizeof(UInt32));
+		schrijfLE(&bestemming[16],floatBits(controlValue),sizeof(UInt32));
+	}
+	return(DraadGrootte);
+}
+
+FoutCode CSVolledigData::deserialiseer(UInt8 const * const bron, const UInt32 grootte)
+{
+	assert(nullptr != bron);
+	if (grootte < DraadGrootte)
+		return(FoutCode::Fout);
+
+	if (true == DraadIsGeheugen)
+	{
+		memcpy(this,bron,DraadGrootte);
+	}
+	else
+	{
+		n = leesLE(&bron[0],sizeof(UInt32));
+		reserveWaarde = leesLE(&bron[4],sizeof(UInt32));
+		measurementValue = bitsFloat(leesLE(&bron[8],sizeof(UInt32)));
+		referenceValue = bitsFloat(leesLE(&bron[12],sizeof(UInt32)));
+		controlValue = bitsFloat(leesLE(&bron[16],sizeof(UInt32)));
+	}
+	return(FoutCode::Ok);
+}
+
 /** kompakte versie */
 CSKompaktData::CSKompaktData(const SampleMoment nm,
                                const Spanning mv,
@@ -286,23 +545,42 @@ Spanning CSKompaktData::geefSetpoint() const
 	return(uit);
 }
 
-UInt16 CSKompaktData::konverteerSpanning(const Spanning &u)
+/* CSKompaktData mengt public en private velden, de geheugenvolgorde is dus
+ * niet gegarandeerd : schrijf per veld. Vier 16 bit stores, geen marshalling. */
+UInt32 CSKompaktData::serialiseer(UInt8 * const bestemming, const UInt32 ruimte) const
 {
-	static constexpr UInt8 geheelGrens = 0b00001111;
-	const auto geheel = (geheelGrens & static_cast<UInt8>(u));
-	const auto fraktie = static_cast<UInt16>((u-geheel)*fraktieBereik);
+	assert(nullptr != bestemming);
+	if (ruimte < DraadGrootte)
+		return(0);
 
-	const UInt16 uit = (geheel<<12)+fraktie;
+	schrijfLE(&bestemming[0],n,sizeof(UInt16));
+	schrijfLE(&bestemming[2],measurementValue,sizeof(UInt16));
+	schrijfLE(&bestemming[4],referenceValue,sizeof(UInt16));
+	schrijfLE(&bestemming[6],controlValue,sizeof(UInt16));
+	return(DraadGrootte);
+}
 
-	return(uit);
+FoutCode CSKompaktData::deserialiseer(UInt8 const * const bron, const UInt32 grootte)
+{
+	assert(nullptr != bron);
+	if (grootte < DraadGrootte)
+		return(FoutCode::Fout);
+
+	n = static_cast<SampleMoment>(leesLE(&bron[0],sizeof(UInt16)));
+	measurementValue = static_cast<UInt16>(leesLE(&bron[2],sizeof(UInt16)));
+	referenceValue = static_cast<UInt16>(leesLE(&bron[4],sizeof(UInt16)));
+	controlValue = static_cast<UInt16>(leesLE(&bron[6],sizeof(UInt16)));
+	return(FoutCode::Ok);
+}
+
+UInt16 CSKompaktData::konverteerSpanning(const Spanning &u)
+{
+	return(CSNumeriek::Q412::vanSpanning(u));
 }
 
 Spanning CSKompaktData::konverteerFixedPoint(const UInt16 &fpw)
 {
-	const UInt16 geheel = fpw>>12;
-	const UInt16 fraktie = (fraktieBereik & fpw);
-	const Spanning u = static_cast<Spanning >(geheel) + static_cast<Spanning >(fraktie)/fraktieBereik;
-	return(u);
+	return(CSNumeriek::Q412::naarSpanning(fpw));
 };
 
 FoutCode CSKompaktData::doeZelftest()
@@ -323,3 +601,218 @@ FoutCode CSKompaktData::doeZelftest()
 
 
 
+
+/** kompressie van CSKompaktData reeksen */
+
+namespace
+{
+	/* bits per klasse ; klasse 0 = geen verschil */
+	constexpr UInt8 klasseBits[] = { 0, 4, 8, 16 };
+
+	UInt8 bepaalKlasse(const Int16 verschil)
+	{
+		if (0 == verschil)
+			return(0);
+		if ((verschil >= -8) && (verschil <= 7))
+			return(1);
+		if ((verschil >= -128) && (verschil <= 127))
+			return(2);
+		return(3);
+	}
+
+	class BitSchrijver
+	{
+	public:
+		BitSchrijver(UInt8 * const b, const UInt32 r) : buffer(b),ruimte(r)
+		{
+		}
+
+		void schrijf(const UInt32 waarde, const UInt8 aantalBits)
+		{
+			for (UInt8 i=0; i < aantalBits; i++)
+			{
+				if (0U == (bitPositie % 8U))
+				{
+					if ((bitPositie/8U) >= ruimte)
+					{
+						vol = true;
+						return;
+					}
+					buffer[bitPositie/8U] = 0;
+				}
+				buffer[bitPositie/8U] = static_cast<UInt8>(buffer[bitPositie/8U] | (((waarde >> i) & 1U) << (bitPositie % 8U)));
+				bitPositie++;
+			}
+		}
+
+		UInt32 geefBytes() const
+		{
+			return((bitPositie + 7U)/8U);
+		}
+
+		bool isVol() const
+		{
+			return(vol);
+		}
+
+	private:
+		UInt8 * const buffer;
+		const UInt32 ruimte;
+		UInt32 bitPositie = 0;
+		bool vol = false;
+	};
+
+	class BitLezer
+	{
+	public:
+		BitLezer(UInt8 const * const b, const UInt32 l) : buffer(b),lengte(l)
+		{
+		}
+
+		UInt32 lees(const UInt8 aantalBits)
+		{
+			UInt32 waarde = 0;
+			for (UInt8 i=0; i < aantalBits; i++)
+			{
+				if ((bitPositie/8U) >= lengte)
+				{
+					tekort = true;
+					return(0);
+				}
+				waarde |= static_cast<UInt32>((buffer[bitPositie/8U] >> (bitPositie % 8U)) & 1U) << i;
+				bitPositie++;
+			}
+			return(waarde);
+		}
+
+		bool heeftTekort() const
+		{
+			return(tekort);
+		}
+
+	private:
+		UInt8 const * const buffer;
+		const UInt32 lengte;
+		UInt32 bitPositie = 0;
+		bool tekort = false;
+	};
+
+	/* teken-uitbreiding van een residu van aantalBits bits */
+	Int16 metTeken(const UInt32 waarde, const UInt8 aantalBits)
+	{
+		const UInt32 tekenBit = 1UL << (aantalBits-1U);
+		return(static_cast<Int16>(static_cast<Int32>((waarde ^ tekenBit)) - static_cast<Int32>(tekenBit)));
+	}
+}
+
+UInt32 CSKompaktEncoder::comprimeer(const ReeksView<CSKompaktData::Layout> &samples, UInt8 * const uit, const UInt32 ruimte)
+{
+	assert(nullptr != uit);
+	using L = CSKompaktData::Layout;
+
+	if ((ruimte < CSKompressie::KopGrootte) || (samples.aantal() > 255U))
+		return(0);
+
+	const bool sleutel = (0U == framesSindsSleutel);
+	if (true == sleutel)
+	{
+		for (auto &v : vorige)
+			v = 0;
+	}
+
+	uit[0] = static_cast<UInt8>(((true == sleutel) ? CSKompressie::SleutelframeBit : 0U) | (volgnummer & CSKompressie::VolgnummerMasker));
+	uit[1] = static_cast<UInt8>(samples.aantal());
+
+	BitSchrijver bits(&uit[CSKompressie::KopGrootte], ruimte - CSKompressie::KopGrootte);
+	for (UInt32 i=0; i < samples.aantal(); i++)
+	{
+		const auto sample = samples[i];
+		const UInt16 velden[CSKompressie::AantalVelden] = { sample.lees<L::N>(), sample.lees<L::Meting>(),
+		                                                    sample.lees<L::Referentie>(), sample.lees<L::Controle>() };
+
+		UInt8 klassen[CSKompressie::AantalVelden];
+		Int16 verschillen[CSKompressie::AantalVelden];
+		for (UInt32 v=0; v < CSKompressie::AantalVelden; v++)
+		{
+			/* n loopt normaal een op ; de andere velden blijven normaal gelijk */
+			const auto voorspelling = static_cast<UInt16>(vorige[v] + ((0U == v) ? 1U : 0U));
+			verschillen[v] = static_cast<Int16>(static_cast<UInt16>(velden[v] - voorspelling));
+			klassen[v] = bepaalKlasse(verschillen[v]);
+			vorige[v] = velden[v];
+		}
+
+		bits.schrijf(static_cast<UInt32>(klassen[0] | (klassen[1] << 2) | (klassen[2] << 4) | (klassen[3] << 6)), 8);
+		for (UInt32 v=0; v < CSKompressie::AantalVelden; v++)
+			bits.schrijf(static_cast<UInt16>(verschillen[v]), klasseBits[klassen[v]]);
+	}
+
+	if (true == bits.isVol())
+	{
+		/* de voorspeller is al bijgewerkt : begin opnieuw met een sleutelframe */
+		framesSindsSleutel = 0;
+		return(0);
+	}
+
+	volgnummer = static_cast<UInt8>((volgnummer+1U) & CSKompressie::VolgnummerMasker);
+	framesSindsSleutel = static_cast<UInt8>((framesSindsSleutel+1U) % sleutelInterval);
+	return(CSKompressie::KopGrootte + bits.geefBytes());
+}
+
+FoutCode CSKompaktDecoder::decomprimeer(UInt8 const * const frame, const UInt32 lengte,
+                                        CSKompaktData * const uit, const UInt32 ruimte, UInt32 &aantal)
+{
+	assert(nullptr != frame);
+	assert(nullptr != uit);
+	aantal = 0;
+
+	if (lengte < CSKompressie::KopGrootte)
+		return(FoutCode::Fout);
+
+	const bool sleutel = (0U != (frame[0] & CSKompressie::SleutelframeBit));
+	const UInt8 nummer = static_cast<UInt8>(frame[0] & CSKompressie::VolgnummerMasker);
+	const UInt32 aantalSamples = frame[1];
+
+	if (aantalSamples > ruimte)
+		return(FoutCode::Fout);
+
+	if (true == sleutel)
+	{
+		for (auto &v : vorige)
+			v = 0;
+	}
+	else if ((false == gesynchroniseerd) || (nummer != verwachtVolgnummer))
+	{
+		gesynchroniseerd = false;
+		return(FoutCode::Waarschuwing);
+	}
+
+	BitLezer bits(&frame[CSKompressie::KopGrootte], lengte - CSKompressie::KopGrootte);
+	for (UInt32 i=0; i < aantalSamples; i++)
+	{
+		const auto klassen = bits.lees(8);
+		UInt8 draad[CSKompaktData::DraadGrootte];
+		for (UInt32 v=0; v < CSKompressie::AantalVelden; v++)
+		{
+			const UInt8 klasse = static_cast<UInt8>((klassen >> (2U*v)) & 0x3U);
+			const UInt8 aantalBits = klasseBits[klasse];
+			const Int16 verschil = (0U == aantalBits) ? static_cast<Int16>(0) : metTeken(bits.lees(aantalBits), aantalBits);
+
+			const auto voorspelling = static_cast<UInt16>(vorige[v] + ((0U == v) ? 1U : 0U));
+			vorige[v] = static_cast<UInt16>(voorspelling + static_cast<UInt16>(verschil));
+			schrijfLE(&draad[2U*v], vorige[v], sizeof(UInt16));
+		}
+
+		if (true == bits.heeftTekort())
+		{
+			gesynchroniseerd = false;
+			aantal = 0;
+			return(FoutCode::Fout);
+		}
+		uit[i].deserialiseer(draad, sizeof(draad));
+	}
+
+	aantal = aantalSamples;
+	gesynchroniseerd = true;
+	verwachtVolgnummer = static_cast<UInt8>((nummer+1U) & CSKompressie::VolgnummerMasker);
+	return(FoutCode::Ok);
+}
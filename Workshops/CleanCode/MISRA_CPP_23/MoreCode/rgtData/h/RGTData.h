@@ -16,6 +16,8 @@ $Id: CSData.h 3683 2019-11-05 10:53:25Z dev $
 
 #include <algdef.h>
 #include <dataPakket.h>
+#include <atomic>
+#include <type_traits>
 
 using Spanning = float;
 using PIDveld = float;
@@ -149,6 +151,9 @@ public:
 	/* vergelijk de inkomende versie met de hier gecompileerde versie */
 	FoutCode vergelijkVersies() const;
 
+	/*! @brief draadformaat, voor een PakketView op een ontvangen frame */
+	struct Layout;
+
 private:
 
 	UInt16 leesIndexU16(const UInt32 index) const;
@@ -181,6 +186,150 @@ private:
 	/* proces uitvoer versterking faktor */
 	static constexpr auto VersterkingIndex =  DwaardeIndex+sizeof(PIDveld);
 
+	/* het schema van de ontvanger gebruikt dezelfde indices */
+	friend class CSKommandoOntvanger;
+};
+
+struct CSKommando::Layout
+{
+	using Commando = DraadVeld<UInt8,CSKommando::CmdIndex>;
+	using Versie = DraadVeld<UInt8,CSKommando::VersieIndex>;
+	using AantalPerioden = DraadVeld<UInt8,CSKommando::AantalPeriodenIndex>;
+	using Keuze = DraadVeld<UInt8,CSKommando::RegelaarKeuzeIndex>;
+	using AantalPunten = DraadVeld<UInt16,CSKommando::AantalPuntenIndex>;
+	using Vertraging = DraadVeld<UInt16,CSKommando::VertragingIndex>;
+	using SetPoint = DraadVeld<Spanning,CSKommando::SetPointIndex>;
+	using Pwaarde = DraadVeld<PIDveld,CSKommando::PwaardeIndex>;
+	using BeginFreq = DraadVeld<float,CSKommando::BeginFreqIndex>;
+	using Iwaarde = DraadVeld<PIDveld,CSKommando::IwaardeIndex>;
+	using Amplitude = DraadVeld<float,CSKommando::AmplitudeIndex>;
+	using Dwaarde = DraadVeld<PIDveld,CSKommando::DwaardeIndex>;
+	using Versterking = DraadVeld<float,CSKommando::VersterkingIndex>;
+	static constexpr UInt32 Grootte = CSKommandoGrootte;
+};
+
+/*! @class De inhoud van een ontvangen CSKommando, eenmalig gedecodeerd en gecontroleerd.
+ *  De getters lezen alleen een veld; er wordt niets meer uit de buffer gehaald. */
+class CSOntvangenKommando
+{
+public:
+	CSKommando::Kommando geefCommando() const { return(kommando); }
+	UInt8 geefVersie() const { return(versie); }
+
+	CSKommando::RegelaarKeuze geefRegelaarKeuze() const { return(static_cast<CSKommando::RegelaarKeuze>(keuze)); }
+	CSKommando::ProcesKeuze geefProcesKeuze() const { return(static_cast<CSKommando::ProcesKeuze>(keuze)); }
+
+	Spanning geefSetPoint() const { return(setPoint); }
+	UInt16 geefVertraging() const { return(vertraging); }
+	UInt16 geefAantalPunten() const { return(aantalPunten); }
+	UInt8 geefAantalPerioden() const { return(aantalPerioden); }
+
+	PIDveld geefPwaarde() const { return(veldP); }
+	PIDveld geefIwaarde() const { return(veldI); }
+	PIDveld geefDwaarde() const { return(veldD); }
+
+	float geefStartFreq() const { return(veldP); }
+	float geefAmplitude() const { return(veldI); }
+
+	Spanning geefVersterking() const { return(versterking); }
+
+private:
+	friend class CSKommandoOntvanger;
+
+	CSKommando::Kommando kommando = CSKommando::Kommando::Leeg;
+	UInt8 versie = 0;
+	UInt8 aantalPerioden = 0;
+	UInt8 keuze = 0;            /* regelaar- of proceskeuze, zelfde plaats als aantalPunten */
+	UInt16 aantalPunten = 0;
+	UInt16 vertraging = 0;
+	Spanning setPoint = 0.0f;
+	float veldP = 0.0f;         /* P waarde of beginfrequentie */
+	float veldI = 0.0f;         /* I waarde of amplitude */
+	PIDveld veldD = 0.0f;
+	Spanning versterking = 0.0f;
+};
+
+/*! @class Ontvangt een CSKommando byte voor byte en controleert het tijdens de ontvangst.
+ *
+ * Het opcode, de VERSION en de velden worden gecontroleerd zodra ze binnen zijn,
+ * tegen een schema in flash (welke velden een kommando gebruikt en hun bereik).
+ * Een fout frame wordt bij de eerste foute byte afgekeurd; de rest van het frame
+ * wordt overgeslagen zodat het volgende frame weer op zijn plaats begint.
+ * Het draadformaat is little endian, gelijk aan het geheugenformaat op de STM32. */
+class CSKommandoOntvanger
+{
+public:
+	enum class Status : UInt8
+	{
+		Bezig,       /* frame nog niet compleet */
+		Klaar,       /* geefKommando() bevat een geldig kommando */
+		Afgekeurd,   /* frame fout, zie geefFout() ; wordt verder overgeslagen */
+	};
+
+	enum class Fout : UInt8
+	{
+		Geen,
+		OnbekendKommando,
+		VerkeerdeVersie,
+		BuitenBereik
+	};
+
+	/*! @brief verwerk een ontvangen byte
+	 *  @return Klaar op de laatste byte van een geldig frame, Afgekeurd op de eerste foute byte */
+	Status ontvang(const UInt8 byte);
+
+	/*! @brief het laatst geldig ontvangen kommando */
+	const CSOntvangenKommando & geefKommando() const { return(kommando); }
+
+	Fout geefFout() const { return(fout); }
+
+	/*! @brief byte in het frame waar de fout gevonden werd */
+	UInt8 geefFoutPositie() const { return(foutPositie); }
+
+	/*! @brief begin opnieuw, bijvoorbeeld na een time-out tussen twee bytes */
+	void reset();
+
+private:
+	enum class VeldSoort : UInt8
+	{
+		U8,
+		U16,
+		Drijvend,
+		Keuze       /* U8 met het maximum uit het kommandoschema */
+	};
+
+	/*! @brief een veld in het frame en zijn toegestane bereik */
+	struct VeldSchema
+	{
+		UInt8 index;
+		UInt8 grootte;
+		VeldSoort soort;
+		float minimum;
+		float maximum;
+	};
+
+	/*! @brief welke velden een kommando gebruikt (bit per veldnummer) */
+	struct KommandoSchema
+	{
+		UInt16 velden;
+		UInt8 keuzeMaximum;
+	};
+
+	static const VeldSchema veldSchemas[];
+	static const KommandoSchema kommandoSchemas[];
+
+	Status keurAf(const Fout);
+	bool neemVeldOp(const UInt8 veldNummer);
+
+	CSOntvangenKommando ontvangen;   /* wordt gevuld tijdens de ontvangst */
+	CSOntvangenKommando kommando;    /* laatste geldige */
+	UInt32 ruw = 0;                  /* bytes van het huidige veld */
+	UInt8 positie = 0;
+	UInt16 schemaVelden = 0;
+	UInt8 keuzeMaximum = 0;
+	bool afgekeurd = false;
+	Fout fout = Fout::Geen;
+	UInt8 foutPositie = 0;
 };
 
 static constexpr auto TitelGrootte = 30;
@@ -225,8 +374,31 @@ public:
 	Spanning referenceValue;
 	Spanning controlValue;
 
-	/* payload bestaat uit : 2 long (4 bytes) = 8bytes  + 3 floats (4 bytes) = 12 bytes = 24 bytes */
+	/* payload bestaat uit : 2 long (4 bytes) = 8bytes  + 3 floats (4 bytes) = 12 bytes = 20 bytes */
+
+	/*! @brief Grootte in draadformaat : little endian, gepakt, velden in declaratievolgorde. */
+	static constexpr UInt32 DraadGrootte = 2*sizeof(UInt32)+3*sizeof(Spanning);
+
+	/*! @brief Schrijf naar draadformaat.
+	 * @param bestemming : de buffer.
+	 * @param ruimte : de grootte van de buffer in bytes.
+	 * @return het aantal geschreven bytes, 0 als de ruimte te klein is. */
+	UInt32 serialiseer(UInt8 * const bestemming, const UInt32 ruimte) const;
+
+	/*! @brief Lees uit draadformaat.
+	 * @return FoutCode::Fout als er te weinig bytes zijn. */
+	FoutCode deserialiseer(UInt8 const * const bron, const UInt32 grootte);
 
+	/*! @brief draadformaat, voor een PakketView of ReeksView zonder deserialiseren */
+	struct Layout
+	{
+		using N = DraadVeld<UInt32,0>;
+		using Reserve = DraadVeld<UInt32,4>;
+		using Meting = DraadVeld<Spanning,8>;
+		using Referentie = DraadVeld<Spanning,12>;
+		using Controle = DraadVeld<Spanning,16>;
+		static constexpr UInt32 Grootte = DraadGrootte;
+	};
 };
 
 /*! @class Dit is een container met floating point voor ControlSystem data */
@@ -256,6 +428,33 @@ public:
 
 	FoutCode doeZelftest();
 
+	/*! @brief Grootte in draadformaat : little endian, n gevolgd door meting, referentie, setpoint (Q4.12). */
+	static constexpr UInt32 DraadGrootte = 4*sizeof(UInt16);
+
+	/*! @brief Schrijf naar draadformaat.
+	 * @return het aantal geschreven bytes, 0 als de ruimte te klein is. */
+	UInt32 serialiseer(UInt8 * const bestemming, const UInt32 ruimte) const;
+
+	/*! @brief Lees uit draadformaat.
+	 * @return FoutCode::Fout als er te weinig bytes zijn. */
+	FoutCode deserialiseer(UInt8 const * const bron, const UInt32 grootte);
+
+	/*! @brief draadformaat, voor een PakketView of ReeksView zonder deserialiseren.
+	 *  De spanningen zijn Q4.12 ; zet om met naarSpanning(). */
+	struct Layout
+	{
+		using N = DraadVeld<UInt16,0>;
+		using Meting = DraadVeld<UInt16,2>;
+		using Referentie = DraadVeld<UInt16,4>;
+		using Controle = DraadVeld<UInt16,6>;
+		static constexpr UInt32 Grootte = DraadGrootte;
+	};
+
+	static Spanning naarSpanning(const UInt16 draadWaarde)
+	{
+		return(konverteerFixedPoint(draadWaarde));
+	}
+
 	SampleMoment n;
 
 private:
@@ -271,28 +470,323 @@ private:
 
 	/* payload bestaat uit : 4 unsigned short ints (2 bytes) = 8 bytes */
 
-	/* Q4.12 : 12 bits = 3 nibbles van 0xf */
-	static constexpr UInt16 fraktieBereik = 0xfff;
+};
+
+/*! @brief Numerieke representaties voor de velden van CSBeleidData.
+ *
+ * Een representatie zet een Spanning om naar haar Type en terug. Een veld
+ * kiest er twee : een in het geheugen (daar wordt mee gerekend) en een op
+ * de draad. Een beleid kiest per veld en bepaalt het type van het
+ * samplemoment ; de draadgrootte volgt daaruit. */
+namespace CSNumeriek
+{
+	/*! @brief float, 4 bytes */
+	struct Drijvend
+	{
+		using Type = Spanning;
 
+		static Type vanSpanning(const Spanning u)
+		{
+			return(u);
+		}
+
+		static Spanning naarSpanning(const Type w)
+		{
+			return(w);
+		}
+	};
+
+	/*! @brief Q4.12 in 16 bits, het formaat van CSKompaktData */
+	struct Q412
+	{
+		using Type = UInt16;
+
+		/* 12 bits = 3 nibbles van 0xf */
+		static constexpr UInt16 FraktieBereik = 0xfff;
+
+		static Type vanSpanning(const Spanning u)
+		{
+			static constexpr UInt8 geheelGrens = 0b00001111;
+			const auto geheel = (geheelGrens & static_cast<UInt8>(u));
+			const auto fraktie = static_cast<UInt16>((u-geheel)*FraktieBereik);
+			return(static_cast<Type>((geheel<<12)+fraktie));
+		}
+
+		static Spanning naarSpanning(const Type w)
+		{
+			const UInt16 geheel = w>>12;
+			const UInt16 fraktie = (FraktieBereik & w);
+			return(static_cast<Spanning>(geheel) + static_cast<Spanning>(fraktie)/FraktieBereik);
+		}
+	};
+
+	/*! @brief Een veld : representatie in het geheugen en op de draad.
+	 *  Zijn beide gelijk, dan is de draadkonversie een kopie. */
+	template<typename InGeheugen, typename OpDraad>
+	struct Veld
+	{
+		using Geheugen = typename InGeheugen::Type;
+		using Draad = typename OpDraad::Type;
+
+		static Geheugen vanSpanning(const Spanning u)
+		{
+			return(InGeheugen::vanSpanning(u));
+		}
+
+		static Spanning naarSpanning(const Geheugen w)
+		{
+			return(InGeheugen::naarSpanning(w));
+		}
+
+		static Draad naarDraad(const Geheugen w)
+		{
+			if constexpr (std::is_same<InGeheugen,OpDraad>::value)
+				return(w);
+			else
+				return(OpDraad::vanSpanning(InGeheugen::naarSpanning(w)));
+		}
+
+		static Geheugen vanDraad(const Draad d)
+		{
+			if constexpr (std::is_same<InGeheugen,OpDraad>::value)
+				return(d);
+			else
+				return(InGeheugen::vanSpanning(OpDraad::naarSpanning(d)));
+		}
+	};
+
+	/*! @brief alles float ; de draad van CSVolledigData (20 bytes) */
+	struct Volledig
+	{
+		using SampleMoment = UInt32;
+		static constexpr UInt32 ReserveGrootte = sizeof(UInt32);
+		using Meting = Veld<Drijvend,Drijvend>;
+		using Referentie = Veld<Drijvend,Drijvend>;
+		using Controle = Veld<Drijvend,Drijvend>;
+	};
+
+	/*! @brief alles Q4.12, voor een doel zonder FPU ; de draad van CSKompaktData (8 bytes) */
+	struct Kompakt
+	{
+		using SampleMoment = UInt16;
+		static constexpr UInt32 ReserveGrootte = 0;
+		using Meting = Veld<Q412,Q412>;
+		using Referentie = Veld<Q412,Q412>;
+		using Controle = Veld<Q412,Q412>;
+	};
+
+	/*! @brief rekenen in float (FPU), verzenden in Q4.12 ; de draad van CSKompaktData */
+	struct FpuKompakt
+	{
+		using SampleMoment = UInt16;
+		static constexpr UInt32 ReserveGrootte = 0;
+		using Meting = Veld<Drijvend,Q412>;
+		using Referentie = Veld<Drijvend,Q412>;
+		using Controle = Veld<Drijvend,Q412>;
+	};
+}
+
+/*! @class ControlSystem data met een numeriek beleid per veld.
+ *
+ * Het beleid (zie CSNumeriek) bepaalt per veld de representatie in het
+ * geheugen en op de draad. Met CSNumeriek::FpuKompakt rekent een doel met
+ * FPU in float en verzendt het toch de 8 bytes van CSKompaktData ; met
+ * CSNumeriek::Kompakt blijft alles geheel getal. De Layout en de
+ * DraadGrootte volgen uit het beleid, dus CSProtoDataBuffer en de
+ * desktop werken ongewijzigd.
+ *
+ * @tparam Beleid : een struct zoals CSNumeriek::Kompakt. */
+template<typename Beleid>
+class CSBeleidData
+{
+public:
+
+	using SampleMoment = typename Beleid::SampleMoment;
+	using MetingVeld = typename Beleid::Meting;
+	using ReferentieVeld = typename Beleid::Referentie;
+	using ControleVeld = typename Beleid::Controle;
+
+	/*! @brief voor ontvangst. */
+	CSBeleidData() = default;
+
+	/*! @brief Constructor voor CSData.
+	 * @param n : Het samplemoment.
+	 * @param mv  : de meetwaarde.
+	 * @param rv  : de regelwaarde (setpoint).
+	 * @param cv  : de controle waarde  (proces input).
+	 */
+	explicit CSBeleidData(const SampleMoment nm,
+	                       const Spanning mv,
+	                       const Spanning rv,
+	                       const Spanning cv) : n(nm),measurementValue(MetingVeld::vanSpanning(mv)),
+	                                            referenceValue(ReferentieVeld::vanSpanning(rv)),
+	                                            controlValue(ControleVeld::vanSpanning(cv))
+	{
+	};
+
+	/*! @brief Sample uit waarden die al in de geheugenrepresentatie zijn,
+	 *  bijvoorbeeld Q4.12 van de ADC : geen omzetting via float. */
+	static CSBeleidData vanGeheugenWaarden(const SampleMoment nm,
+	                                       const typename MetingVeld::Geheugen mv,
+	                                       const typename ReferentieVeld::Geheugen rv,
+	                                       const typename ControleVeld::Geheugen cv)
+	{
+		CSBeleidData uit;
+		uit.n = nm;
+		uit.measurementValue = mv;
+		uit.referenceValue = rv;
+		uit.controlValue = cv;
+		return(uit);
+	};
+
+	Spanning geefMeting() const
+	{
+		return(MetingVeld::naarSpanning(measurementValue));
+	};
+
+	Spanning geefReferentie() const
+	{
+		return(ReferentieVeld::naarSpanning(referenceValue));
+	};
+
+	Spanning geefSetpoint() const
+	{
+		return(ControleVeld::naarSpanning(controlValue));
+	};
+
+	typename MetingVeld::Geheugen geefGeheugenMeting() const
+	{
+		return(measurementValue);
+	};
+
+	typename ReferentieVeld::Geheugen geefGeheugenReferentie() const
+	{
+		return(referenceValue);
+	};
+
+	typename ControleVeld::Geheugen geefGeheugenSetpoint() const
+	{
+		return(controlValue);
+	};
+
+	/*! @brief draadformaat, voor een PakketView of ReeksView zonder deserialiseren.
+	 *  Little endian, n, de reserve van het beleid, dan meting, referentie en controle. */
+	struct Layout
+	{
+		using N = DraadVeld<SampleMoment,0>;
+		using Meting = DraadVeld<typename MetingVeld::Draad,sizeof(SampleMoment)+Beleid::ReserveGrootte>;
+		using Referentie = DraadVeld<typename ReferentieVeld::Draad,Meting::einde>;
+		using Controle = DraadVeld<typename ControleVeld::Draad,Referentie::einde>;
+		static constexpr UInt32 Grootte = Controle::einde;
+	};
+
+	static constexpr UInt32 DraadGrootte = Layout::Grootte;
+
+	/*! @brief Schrijf naar draadformaat.
+	 * @return het aantal geschreven bytes, 0 als de ruimte te klein is. */
+	UInt32 serialiseer(UInt8 * const bestemming, const UInt32 ruimte) const
+	{
+		assert(nullptr != bestemming);
+		if (ruimte < DraadGrootte)
+			return(0);
+
+		schrijfLittleEndian(&bestemming[Layout::N::plaats],n);
+		memset(&bestemming[Layout::N::einde],0,Beleid::ReserveGrootte);
+		schrijfLittleEndian(&bestemming[Layout::Meting::plaats],MetingVeld::naarDraad(measurementValue));
+		schrijfLittleEndian(&bestemming[Layout::Referentie::plaats],ReferentieVeld::naarDraad(referenceValue));
+		schrijfLittleEndian(&bestemming[Layout::Controle::plaats],ControleVeld::naarDraad(controlValue));
+		return(DraadGrootte);
+	};
+
+	/*! @brief Lees uit draadformaat.
+	 * @return FoutCode::Fout als er te weinig bytes zijn. */
+	FoutCode deserialiseer(UInt8 const * const bron, const UInt32 grootte)
+	{
+		assert(nullptr != bron);
+		if (grootte < DraadGrootte)
+			return(FoutCode::Fout);
+
+		n = leesLittleEndian<SampleMoment>(&bron[Layout::N::plaats]);
+		measurementValue = MetingVeld::vanDraad(leesLittleEndian<typename MetingVeld::Draad>(&bron[Layout::Meting::plaats]));
+		referenceValue = ReferentieVeld::vanDraad(leesLittleEndian<typename ReferentieVeld::Draad>(&bron[Layout::Referentie::plaats]));
+		controlValue = ControleVeld::vanDraad(leesLittleEndian<typename ControleVeld::Draad>(&bron[Layout::Controle::plaats]));
+		return(FoutCode::Ok);
+	};
+
+	SampleMoment n;
+
+private:
+
+	typename MetingVeld::Geheugen measurementValue;
+	typename ReferentieVeld::Geheugen referenceValue;
+	typename ControleVeld::Geheugen controlValue;
 };
 
 static constexpr UInt32 CSDataBufferGrootte=10;
 
-template<typename ttype>
-class CSProtoDataBuffer : public VerzendOntvangBuffer<UInt8,CSDataBufferGrootte*sizeof(ttype)>
+/*! @brief De buffer bevat de samples in draadformaat, zodat de hele buffer
+ * in een keer (bijvoorbeeld met DMA) verzonden kan worden. De grootte volgt
+ * ttype::DraadGrootte, ook als het geheugenformaat groter is (CSBeleidData
+ * met float in het geheugen en Q4.12 op de draad). operator[] geeft een
+ * Element : lezen deserialiseert, toekennen serialiseert, zodat er nooit een
+ * ttype over de draadbytes gelegd wordt (uitlijning, endianness, padding). */
+template<typename ttype, UInt32 BufferDiepte=CSDataBufferGrootte>
+class CSProtoDataBuffer : public VerzendOntvangBuffer<UInt8,BufferDiepte*ttype::DraadGrootte>
 {
 public:
 
-	using CSVZBuffer = VerzendOntvangBuffer<UInt8,CSDataBufferGrootte*sizeof(ttype)> ;
+	using CSVZBuffer = VerzendOntvangBuffer<UInt8,BufferDiepte*ttype::DraadGrootte> ;
+
+	static constexpr UInt32 Diepte = BufferDiepte;
 
 	CSProtoDataBuffer() = default;
 
-	/*! @brief vind een object in de databuffer */
-	ttype & operator [] (const UInt32 index)
+	/*! @class Een sample in de buffer, in draadformaat.
+	 *  Lezen geeft een kopie (deserialiseer), toekennen schrijft de draadbytes (serialiseer). */
+	class Element
+	{
+	public:
+		explicit Element(UInt8 * const p) : plek(p)
+		{
+
+		};
+
+		operator ttype () const
+		{
+			ttype veld{};
+			static_cast<void>(veld.deserialiseer(plek,ttype::DraadGrootte));
+			return(veld);
+		};
+
+		Element & operator = (const ttype &veld)
+		{
+			static_cast<void>(veld.serialiseer(plek,ttype::DraadGrootte));
+			return(*this);
+		};
+
+		Element & operator = (const Element &rhs)
+		{
+			return(operator = (static_cast<ttype>(rhs)));
+		};
+
+	private:
+		UInt8 * const plek;
+	};
+
+	/*! @brief een sample in de databuffer, als Element */
+	Element operator [] (const UInt32 index)
+	{
+		assert(index < BufferDiepte);
+		return(Element(&CSVZBuffer::operator[](index*ttype::DraadGrootte)));
+	};
+
+	/*! @brief een sample uit de databuffer, gedeserialiseerd */
+	ttype operator [] (const UInt32 index) const
 	{
-		const auto plek = index*sizeof(ttype);
-		auto & dref = reinterpret_cast<ttype &>(CSVZBuffer::operator[](plek));
-		return(dref);
+		assert(index < BufferDiepte);
+		ttype veld{};
+		static_cast<void>(veld.deserialiseer(&CSVZBuffer::operator[](index*ttype::DraadGrootte),ttype::DraadGrootte));
+		return(veld);
 	};
 
 	/* buf management */
@@ -301,7 +795,8 @@ public:
 	{
 		assert(false == isBufferVol());
 
-		(*this).operator [] (bufTeller++) = veld;
+		const auto plek = (bufTeller++)*ttype::DraadGrootte;
+		veld.serialiseer(&CSVZBuffer::operator[](plek),ttype::DraadGrootte);
 
 		return(isBufferVol());
 	};
@@ -311,7 +806,8 @@ public:
 	{
 		assert(false == isBufferVol());
 
-		veld = (*this).operator [] (bufTeller++);
+		const auto plek = (bufTeller++)*ttype::DraadGrootte;
+		veld.deserialiseer(&CSVZBuffer::operator[](plek),ttype::DraadGrootte);
 
 		return(isBufferVol());
 	};
@@ -325,7 +821,13 @@ public:
 	/* geef aan of de buffer vol is */
 	bool isBufferVol() const
 	{
-		return(bufTeller == CSDataBufferGrootte);
+		return(bufTeller == BufferDiepte);
+	};
+
+	/* het aantal geladen samples */
+	UInt32 geefAantal() const
+	{
+		return(bufTeller);
 	};
 
 	/* zet de bufferteller naar nul */
@@ -339,9 +841,589 @@ private:
 	UInt32 bufTeller=0;
 };
 
+/*! @class Wisselbuffer (ping-pong) voor continue acquisitie.
+ *
+ * De acquisitie (ISR) vult een buffer terwijl het transport (hoofdlus) een
+ * volle buffer verzendt. Elke buffer heeft een eigenaar volgens zijn staat :
+ *
+ *   Vrij -> Vullen -> Vol      : geschreven door de acquisitie
+ *   Vol  -> Zenden -> Vrij     : geschreven door het transport
+ *
+ * Iedere overgang wordt door precies een kant gedaan, dus er is geen
+ * kritieke sektie nodig. Zijn alle buffers vol of in verzending, dan wordt
+ * het sample weggegooid en geteld (de ISR wacht nooit).
+ *
+ * @tparam AantalBuffers : 2 voor ping-pong, meer om langere zendtijden op te vangen.
+ * @tparam BufferDiepte  : aantal samples per buffer.
+ */
+template<typename ttype, UInt32 AantalBuffers=2, UInt32 BufferDiepte=CSDataBufferGrootte>
+class CSWisselDataBuffer
+{
+public:
+
+	static_assert(AantalBuffers >= 2, "een wisselbuffer heeft minstens twee buffers");
+
+	using Buffer = CSProtoDataBuffer<ttype,BufferDiepte>;
+
+	CSWisselDataBuffer()
+	{
+		for (auto & staat : staten)
+			staat.store(BufferStaat::Vrij);
+	};
+
+	/*! @brief acquisitie kant : laad een sample.
+	 * @return false als het sample is weggegooid omdat er geen vrije buffer is. */
+	bool laad(const ttype &veld)
+	{
+		if (BufferStaat::Vullen != staten[vulIndex].load(std::memory_order_acquire))
+		{
+			if (BufferStaat::Vrij != staten[vulIndex].load(std::memory_order_acquire))
+			{
+				verlorenSamples++;
+				return(false);
+			}
+			staten[vulIndex].store(BufferStaat::Vullen,std::memory_order_relaxed);
+		}
+
+		const bool vol = buffers[vulIndex].laadBuffer(veld);
+		if (true == vol)
+		{
+			/* overdracht naar het transport */
+			staten[vulIndex].store(BufferStaat::Vol,std::memory_order_release);
+			vulIndex = (vulIndex+1) % AantalBuffers;
+		}
+		return(true);
+	};
+
+	/*! @brief transport kant : neem de oudste volle buffer in bezit.
+	 * @return nullptr als er (nog) geen volle buffer is. */
+	Buffer * neemVolleBuffer()
+	{
+		if (BufferStaat::Vol != staten[zendIndex].load(std::memory_order_acquire))
+			return(nullptr);
+
+		staten[zendIndex].store(BufferStaat::Zenden,std::memory_order_relaxed);
+		return(&buffers[zendIndex]);
+	};
+
+	/*! @brief transport kant : de buffer is verzonden, geef hem terug aan de acquisitie. */
+	void geefBufferVrij()
+	{
+		assert(BufferStaat::Zenden == staten[zendIndex].load(std::memory_order_relaxed));
+
+		buffers[zendIndex].resetBuffer();
+		staten[zendIndex].store(BufferStaat::Vrij,std::memory_order_release);
+		zendIndex = (zendIndex+1) % AantalBuffers;
+	};
+
+	UInt32 geefVerlorenSamples() const
+	{
+		return(verlorenSamples);
+	};
+
+private:
+
+	enum class BufferStaat : UInt8
+	{
+		Vrij,
+		Vullen,
+		Vol,
+		Zenden
+	};
+
+	Buffer buffers[AantalBuffers];
+	std::atomic<BufferStaat> staten[AantalBuffers];
+
+	UInt32 vulIndex=0;         /* alleen acquisitie */
+	UInt32 zendIndex=0;        /* alleen transport */
+	UInt32 verlorenSamples=0;  /* alleen acquisitie */
+};
+
 using CSVolledigDataBuffer = CSProtoDataBuffer<CSVolledigData>;
 using CSKompaktDataBuffer = CSProtoDataBuffer<CSKompaktData>;
 
+/*! @brief Blok drijvende komma voor reeksen samples : per blok en per veld
+ * een exponent, per sample een mantisse.
+ *
+ * Q4.12 heeft een vaste stap (1/4095 V) : een signaal van 50 mV gebruikt 8
+ * van de 16 bits, en onder 0 of boven 16 V past niets. Hier kiest de
+ * buffer per veld de kleinste exponent waarbij de grootste waarde van het
+ * blok nog past, dus de mantissen gebruiken altijd hun hele bereik :
+ *
+ *   waarde = mantisse * 2^exponent,  |mantisse| <= 2^(MantisseBits-1) - 1
+ *
+ * Draad (little endian) : n van het eerste sample (UInt16), het aantal
+ * samples (UInt16), de exponenten van meting, referentie en controle
+ * (Int8), dan per veld de mantissen van alle samples : 16 bits, of 12 bits
+ * met twee mantissen in drie bytes. Het samplemoment van sample i is n+i.
+ * Per sample zijn dat 6 bytes (16 bits) of 4,5 bytes (12 bits), tegen 8
+ * voor CSKompaktData. De SSE2/NEON versie van de kernels staat met tests
+ * in PatternsArchitecture (BlockFloatingPoint.hpp) ; de lussen hier zijn
+ * die van het scalaire pad. */
+namespace CSBlokDrijvend
+{
+	static constexpr UInt32 AantalVelden = 3;
+	static constexpr UInt32 KopGrootte = 2*sizeof(UInt16)+AantalVelden*sizeof(Int8);
+	static constexpr Int8 MinExponent = -100;  /* ver onder elk signaal ; 2^-e blijft een normale float */
+	static constexpr Int8 MaxExponent = 100;
+	static constexpr Int8 ExponentNul = MinExponent;  /* een blok met alleen nullen */
+
+	/*! @brief bytes van de mantissen van een veld */
+	constexpr UInt32 mantisseGrootte(const UInt32 aantal, const UInt32 mantisseBits)
+	{
+		return((16U == mantisseBits) ? 2U*aantal : (3U*aantal+1U)/2U);
+	}
+
+	/*! @brief bytes van een blok van aantal samples */
+	constexpr UInt32 blokGrootte(const UInt32 aantal, const UInt32 mantisseBits)
+	{
+		return(KopGrootte + AantalVelden*mantisseGrootte(aantal,mantisseBits));
+	}
+
+	template<UInt32 MantisseBits>
+	struct Mantisse
+	{
+		static_assert((12U == MantisseBits) || (16U == MantisseBits), "mantissen zijn 12 of 16 bits");
+
+		static constexpr Int32 Maximum = (1 << (MantisseBits-1U)) - 1;
+
+		/*! @brief de kleinste exponent waarbij de grootste waarde nog past ; NaN telt als 0 */
+		static Int8 kiesExponent(Spanning const * const in, const UInt32 aantal)
+		{
+			assert(nullptr != in);
+			Spanning piek = 0.0f;
+			for (UInt32 i=0; i < aantal; i++)
+			{
+				const Spanning grootte = fabsf(in[i]);
+				if (grootte > piek)
+					piek = grootte;
+			}
+
+			if (!(piek > 0.0f))
+				return(ExponentNul);
+			if (!(piek < HUGE_VALF))
+				return(MaxExponent);
+
+			int macht = 0;
+			static_cast<void>(frexpf(piek,&macht));  /* piek = f * 2^macht, f in [0.5,1) */
+			Int32 exponent = macht - static_cast<Int32>(MantisseBits-1U);
+			if (exponent < MinExponent)
+				exponent = MinExponent;
+			if (exponent > MaxExponent)
+				exponent = MaxExponent;
+			return(static_cast<Int8>(exponent));
+		}
+
+		/*! @brief afgerond naar dichtstbijzijnde (even), verzadigd op +-Maximum ; NaN wordt 0 */
+		static void naarMantissen(Spanning const * const in, Int16 * const uit, const UInt32 aantal, const Int8 exponent)
+		{
+			assert((nullptr != in) && (nullptr != uit));
+			const Spanning schaal = ldexpf(1.0f,-exponent);
+			const Spanning grens = static_cast<Spanning>(Maximum);
+			for (UInt32 i=0; i < aantal; i++)
+			{
+				Spanning geschaald = (in[i] == in[i]) ? in[i]*schaal : 0.0f;
+				if (geschaald > grens)
+					geschaald = grens;
+				if (geschaald < -grens)
+					geschaald = -grens;
+				uit[i] = static_cast<Int16>(nearbyintf(geschaald));
+			}
+		}
+
+		/*! @brief terug naar spanningen : exact mantisse * 2^exponent */
+		static void naarSpanningen(Int16 const * const in, Spanning * const uit, const UInt32 aantal, const Int8 exponent)
+		{
+			assert((nullptr != in) && (nullptr != uit));
+			const Spanning stap = ldexpf(1.0f,exponent);
+			for (UInt32 i=0; i < aantal; i++)
+				uit[i] = static_cast<Spanning>(in[i])*stap;
+		}
+
+		static void schrijf(Int16 const * const mantissen, UInt8 * const bestemming, const UInt32 aantal)
+		{
+			if constexpr (16U == MantisseBits)
+			{
+				for (UInt32 i=0; i < aantal; i++)
+					schrijfLittleEndian(&bestemming[2U*i],mantissen[i]);
+			}
+			else
+			{
+				/* twee mantissen a,b in drie bytes : a[7:0], b[3:0]a[11:8], b[11:4] */
+				for (UInt32 i=0; i < aantal; i+=2U)
+				{
+					const UInt16 a = static_cast<UInt16>(mantissen[i]) & 0xfffU;
+					const UInt16 b = ((i+1U) < aantal) ? (static_cast<UInt16>(mantissen[i+1U]) & 0xfffU) : 0U;
+					UInt8 * const plek = &bestemming[(3U*i)/2U];
+					plek[0] = static_cast<UInt8>(a);
+					plek[1] = static_cast<UInt8>((a >> 8) | ((b & 0xfU) << 4));
+					if ((i+1U) < aantal)
+						plek[2] = static_cast<UInt8>(b >> 4);
+				}
+			}
+		}
+
+		static void lees(UInt8 const * const bron, Int16 * const mantissen, const UInt32 aantal)
+		{
+			if constexpr (16U == MantisseBits)
+			{
+				for (UInt32 i=0; i < aantal; i++)
+					mantissen[i] = leesLittleEndian<Int16>(&bron[2U*i]);
+			}
+			else
+			{
+				for (UInt32 i=0; i < aantal; i++)
+				{
+					UInt8 const * const plek = &bron[(3U*(i & ~1U))/2U];
+					const UInt16 ruw = (0U == (i & 1U)) ? static_cast<UInt16>(plek[0] | ((plek[1] & 0xfU) << 8))
+					                                    : static_cast<UInt16>((plek[1] >> 4) | (plek[2] << 4));
+					/* teken van bit 11 uitbreiden */
+					mantissen[i] = static_cast<Int16>(static_cast<Int32>(ruw ^ 0x800U) - 0x800);
+				}
+			}
+		}
+	};
+}
+
+/*! @class Buffer in blok drijvende komma, als alternatief voor CSKompaktDataBuffer.
+ *
+ * De samples worden als float verzameld ; is de buffer vol (of na sluit())
+ * dan kiest hij per veld de exponent en schrijft het blok in draadformaat
+ * (zie CSBlokDrijvend) naar de VerzendOntvangBuffer, klaar voor DMA.
+ * geefDraadGrootte() is de lengte van het blok.
+ *
+ * De samplemomenten moeten opeenvolgend zijn ; CSWisselDataBuffer gooit
+ * alleen samples weg voordat een buffer begint, dus een gat valt altijd
+ * tussen twee blokken.
+ *
+ * @tparam MantisseBits : 16, of 12 voor de kleinste draad. */
+template<UInt32 BufferDiepte=CSDataBufferGrootte, UInt32 MantisseBits=16U>
+class CSBlokDataBuffer : public VerzendOntvangBuffer<UInt8,CSBlokDrijvend::blokGrootte(BufferDiepte,MantisseBits)>
+{
+public:
+
+	using CSVZBuffer = VerzendOntvangBuffer<UInt8,CSBlokDrijvend::blokGrootte(BufferDiepte,MantisseBits)>;
+	using Mantisse = CSBlokDrijvend::Mantisse<MantisseBits>;
+
+	static_assert(BufferDiepte <= 0xffffU, "het aantal samples staat in 16 bits");
+
+	static constexpr UInt32 Diepte = BufferDiepte;
+
+	CSBlokDataBuffer() = default;
+
+	/*! @brief laad een sample ; het blok wordt geschreven als de buffer vol is.
+	 * @return true als de buffer vol is. */
+	bool laadBuffer(const UInt16 n, const Spanning mv, const Spanning rv, const Spanning cv)
+	{
+		assert(false == isBufferVol());
+		assert((0U == bufTeller) || (static_cast<UInt16>(eersteN+bufTeller) == n));
+
+		if (0U == bufTeller)
+			eersteN = n;
+		waarden[0][bufTeller] = mv;
+		waarden[1][bufTeller] = rv;
+		waarden[2][bufTeller] = cv;
+		bufTeller++;
+
+		if (true == isBufferVol())
+			schrijfBlok();
+		return(isBufferVol());
+	};
+
+	/*! @brief laad een CSKompaktData ; de precisie is dan die van Q4.12 */
+	bool laadBuffer(const CSKompaktData &veld)
+	{
+		return(laadBuffer(veld.n,veld.geefMeting(),veld.geefReferentie(),veld.geefSetpoint()));
+	};
+
+	/*! @brief schrijf een gedeeltelijk gevulde buffer als blok, bijvoorbeeld aan het eind van een meting */
+	void sluit()
+	{
+		if ((true == bevatBufferData()) && (false == gesloten))
+			schrijfBlok();
+	};
+
+	/*! @brief lees een ontvangen blok ; daarna geven geefN() en de geef..() functies de samples.
+	 * @return FoutCode::Fout als het blok niet volledig is of niet in de buffer past. */
+	FoutCode pakUit(UInt8 const * const bron, const UInt32 lengte)
+	{
+		assert(nullptr != bron);
+		if (lengte < CSBlokDrijvend::KopGrootte)
+			return(FoutCode::Fout);
+
+		const auto aantal = leesLittleEndian<UInt16>(&bron[2]);
+		if ((aantal > BufferDiepte) || (lengte < CSBlokDrijvend::blokGrootte(aantal,MantisseBits)))
+			return(FoutCode::Fout);
+
+		eersteN = leesLittleEndian<UInt16>(&bron[0]);
+		Int16 mantissen[BufferDiepte];
+		for (UInt32 veld=0; veld < CSBlokDrijvend::AantalVelden; veld++)
+		{
+			const auto exponent = static_cast<Int8>(bron[4U+veld]);
+			Mantisse::lees(&bron[CSBlokDrijvend::KopGrootte+veld*CSBlokDrijvend::mantisseGrootte(aantal,MantisseBits)],mantissen,aantal);
+			Mantisse::naarSpanningen(mantissen,waarden[veld],aantal,exponent);
+			exponenten[veld] = exponent;
+		}
+		bufTeller = aantal;
+		gesloten = true;
+		return(FoutCode::Ok);
+	};
+
+	UInt16 geefN(const UInt32 index) const
+	{
+		return(static_cast<UInt16>(eersteN+index));
+	};
+
+	Spanning geefMeting(const UInt32 index) const
+	{
+		return(waarden[0][index]);
+	};
+
+	Spanning geefReferentie(const UInt32 index) const
+	{
+		return(waarden[1][index]);
+	};
+
+	Spanning geefSetpoint(const UInt32 index) const
+	{
+		return(waarden[2][index]);
+	};
+
+	/*! @brief de stap (een mantisse) van een veld (0 = meting, 1 = referentie, 2 = controle) ;
+	 *  de fout van een waarde in het blok is hoogstens een halve stap */
+	Spanning geefStap(const UInt32 veld) const
+	{
+		return(ldexpf(1.0f,exponenten[veld]));
+	};
+
+	/*! @brief de lengte van het geschreven blok */
+	UInt32 geefDraadGrootte() const
+	{
+		return(CSBlokDrijvend::blokGrootte(bufTeller,MantisseBits));
+	};
+
+	bool bevatBufferData() const
+	{
+		return(0 != bufTeller);
+	};
+
+	bool isBufferVol() const
+	{
+		return(bufTeller == BufferDiepte);
+	};
+
+	UInt32 geefAantal() const
+	{
+		return(bufTeller);
+	};
+
+	void resetBuffer()
+	{
+		bufTeller=0;
+		gesloten=false;
+		CSVZBuffer::reset();
+	};
+
+private:
+
+	void schrijfBlok()
+	{
+		UInt8 * const blok = &CSVZBuffer::operator[](0);
+		schrijfLittleEndian(&blok[0],eersteN);
+		schrijfLittleEndian(&blok[2],static_cast<UInt16>(bufTeller));
+
+		Int16 mantissen[BufferDiepte];
+		for (UInt32 veld=0; veld < CSBlokDrijvend::AantalVelden; veld++)
+		{
+			exponenten[veld] = Mantisse::kiesExponent(waarden[veld],bufTeller);
+			Mantisse::naarMantissen(waarden[veld],mantissen,bufTeller,exponenten[veld]);
+			blok[4U+veld] = static_cast<UInt8>(exponenten[veld]);
+			Mantisse::schrijf(mantissen,&blok[CSBlokDrijvend::KopGrootte+veld*CSBlokDrijvend::mantisseGrootte(bufTeller,MantisseBits)],bufTeller);
+		}
+		gesloten = true;
+	};
+
+	Spanning waarden[CSBlokDrijvend::AantalVelden][BufferDiepte] = {};
+	Int8 exponenten[CSBlokDrijvend::AantalVelden] = {};
+	UInt32 bufTeller=0;
+	UInt16 eersteN=0;
+	bool gesloten=false;
+};
+
+using CSBlokKompaktBuffer = CSBlokDataBuffer<>;
+using CSBlok12KompaktBuffer = CSBlokDataBuffer<CSDataBufferGrootte,12U>;
+
+static_assert(CSBlokKompaktBuffer::Diepte*CSKompaktData::DraadGrootte >= CSBlokDrijvend::blokGrootte(CSDataBufferGrootte,16U),
+              "een blok is niet groter dan de CSKompaktData buffer");
+
+/*! @brief Gecomprimeerd frameformaat voor CSKompaktData reeksen.
+ *
+ * Frame : kop (bit 7 = sleutelframe, bit 0..6 = volgnummer), aantal samples,
+ * dan een bitstroom (LSB eerst). Per sample en per veld (n, meting, referentie,
+ * controle) een 2 bits klasse met het verschil met de voorspelling :
+ * 0 = gelijk, 1 = 4 bits, 2 = 8 bits (met teken), 3 = 16 bits (modulo 2^16).
+ * De voorspelling is het vorige sample, voor n het vorige n + 1.
+ * Een sleutelframe voorspelt vanaf nul en hangt niet van eerdere frames af ;
+ * na een verloren frame wacht de decoder op het volgende sleutelframe. */
+namespace CSKompressie
+{
+	static constexpr UInt8 SleutelframeBit = 0x80;
+	static constexpr UInt8 VolgnummerMasker = 0x7F;
+	static constexpr UInt32 KopGrootte = 2;
+	static constexpr UInt32 AantalVelden = 4;
+
+	/*! @brief grootste frame voor aantal samples (alles 16 bits) */
+	constexpr UInt32 maximaleFrameGrootte(const UInt32 aantal)
+	{
+		return(KopGrootte + (aantal*(AantalVelden*(2U+16U)) + 7U)/8U);
+	}
+}
+
+/*! @class Comprimeert CSKompaktData frames (delta + bitpakking) */
+class CSKompaktEncoder
+{
+public:
+	/*! @param interval : om de hoeveel frames een sleutelframe wordt verzonden (1 = altijd) */
+	explicit CSKompaktEncoder(const UInt8 interval=8U) : sleutelInterval((0U == interval) ? 1U : interval)
+	{
+	};
+
+	/*! @brief comprimeer een reeks samples in draadformaat tot een frame.
+	 * @return het aantal bytes in uit, 0 als de ruimte te klein is of er meer dan 255 samples zijn. */
+	UInt32 comprimeer(const ReeksView<CSKompaktData::Layout> &samples, UInt8 * const uit, const UInt32 ruimte);
+
+	/*! @brief de volgende frame wordt een sleutelframe */
+	void forceerSleutelframe()
+	{
+		framesSindsSleutel = 0;
+	};
+
+private:
+	UInt16 vorige[CSKompressie::AantalVelden] = {};
+	UInt8 volgnummer = 0;
+	UInt8 framesSindsSleutel = 0;
+	UInt8 sleutelInterval;
+};
+
+/*! @class Pakt frames van CSKompaktEncoder weer uit */
+class CSKompaktDecoder
+{
+public:
+	/*! @brief decomprimeer een frame.
+	 * @param aantal : het aantal samples in uit.
+	 * @return FoutCode::Waarschuwing als het frame is overgeslagen (wacht op sleutelframe),
+	 *         FoutCode::Fout als het frame beschadigd is of niet in uit past. */
+	FoutCode decomprimeer(UInt8 const * const frame, const UInt32 lengte,
+	                      CSKompaktData * const uit, const UInt32 ruimte, UInt32 &aantal);
+
+private:
+	UInt16 vorige[CSKompressie::AantalVelden] = {};
+	UInt8 verwachtVolgnummer = 0;
+	bool gesynchroniseerd = false;
+};
+
+/*! @class Comprimeert een gevulde CSProtoDataBuffer en verzendt het frame via DMA.
+ *  Alternatief voor DMAZender als de link de ruwe samples niet bijhoudt. */
+template<UInt32 BufferDiepte=CSDataBufferGrootte>
+class CSGecomprimeerdeZender : public DMAAfhandelaar
+{
+public:
+	using Buffer = CSProtoDataBuffer<CSKompaktData,BufferDiepte>;
+
+	static_assert(BufferDiepte <= 255U, "een frame bevat hoogstens 255 samples");
+
+	explicit CSGecomprimeerdeZender(DMAKanaal &k, const UInt8 sleutelInterval=8U) : kanaal(k),encoder(sleutelInterval)
+	{
+	};
+
+	/*! @brief comprimeer de buffer en start de verzending ; de buffer is daarna direct weer vrij.
+	 * @return FoutCode::Fout als er nog een frame wordt verzonden of het kanaal weigert. */
+	FoutCode zend(const Buffer &buffer)
+	{
+		if (true == isBezig())
+			return(FoutCode::Fout);
+
+		const ReeksView<CSKompaktData::Layout> samples(buffer.geefPtr(), buffer.geefAantal()*CSKompaktData::DraadGrootte);
+		const auto lengte = encoder.comprimeer(samples, frame, sizeof(frame));
+		if (0U == lengte)
+			return(FoutCode::Fout);
+
+		bezig = true;
+		const auto retkode = kanaal.start(frame, lengte, *this);
+		if (FoutCode::Ok != retkode)
+		{
+			bezig = false;
+			encoder.forceerSleutelframe();  /* het frame is niet verzonden */
+		}
+		return(retkode);
+	};
+
+	void overdrachtKlaar() override
+	{
+		bezig = false;
+	};
+
+	bool isBezig() const
+	{
+		return(true == bezig);
+	};
+
+private:
+	DMAKanaal &kanaal;
+	CSKompaktEncoder encoder;
+	UInt8 frame[CSKompressie::maximaleFrameGrootte(BufferDiepte)];
+	volatile bool bezig = false;
+};
+
+/*! @class Verzendt een titel, een kommando en de geladen samples als een bericht.
+ *  De drie delen worden niet samengevoegd : de DMA leest ze elk uit hun eigen buffer.
+ *  Titel, kommando en buffer moeten ongewijzigd blijven zolang isBezig(). */
+template<UInt32 BufferDiepte=CSDataBufferGrootte>
+class CSBerichtZender
+{
+public:
+	using Buffer = CSProtoDataBuffer<CSKompaktData,BufferDiepte>;
+
+	explicit CSBerichtZender(DMAKanaal &k) : zender(k)
+	{
+	};
+
+	/*! @return FoutCode::Fout als er nog een bericht wordt verzonden of het kanaal weigert. */
+	FoutCode zend(const CSTitel &titel, const CSKommando &kommando, const Buffer &buffer)
+	{
+		if (true == isBezig())
+			return(FoutCode::Fout);
+
+		segmenten.reset();
+		static_cast<void>(segmenten.voegToe(titel));
+		static_cast<void>(segmenten.voegToe(kommando));
+		static_cast<void>(segmenten.voegToe(buffer.geefPtr(), buffer.geefAantal()*CSKompaktData::DraadGrootte));
+		return(zender.zend(segmenten));
+	};
+
+	bool isBezig() const
+	{
+		return(zender.isBezig());
+	};
+
+private:
+	SegmentLijst<3> segmenten;
+	GatherZender<3> zender;
+};
+
+/* Het numerieke beleid van het doel : met een FPU (Cortex-M4F, __ARM_FP)
+ * wordt in float gerekend, zonder FPU blijft alles geheel getal. De draad
+ * is in beide gevallen die van CSKompaktData. */
+#if defined(__ARM_FP)
+	using CSDoelBeleid = CSNumeriek::FpuKompakt;
+#else
+	using CSDoelBeleid = CSNumeriek::Kompakt;
+#endif
+using CSDoelData = CSBeleidData<CSDoelBeleid>;
+using CSDoelDataBuffer = CSProtoDataBuffer<CSDoelData>;
+
+static_assert(CSDoelData::DraadGrootte == CSKompaktData::DraadGrootte, "het doelbeleid verzendt CSKompaktData");
+
 #ifdef USE_STM32412G_DISCOVERY
 	using CSData = CSVolledigData;
 	using CSDataBuffer = CSVolledigDataBuffer;
@@ -0,0 +1,89 @@
+#include <benchmark/benchmark.h>
+#include "CyclicExecutive.hpp"
+
+#include <array>
+#include <utility>
+
+using namespace cyclic_executive;
+
+// CounterTask has no default constructor; every task gets the same name
+template<size_t... I>
+static std::array<CounterTask, sizeof...(I)> makeTasks(std::index_sequence<I...>) {
+    return {{ ((void)I, CounterTask("bench"))... }};
+}
+
+template<size_t N>
+static std::array<CounterTask, N> makeTasks() {
+    return makeTasks(std::make_index_sequence<N>{});
+}
+
+// ============================================================================
+// run() with N tasks, all due every tick: cost of one scheduler pass
+// ============================================================================
+
+template<size_t N>
+static void BM_CyclicExecutive_RunAllDue(benchmark::State& state) {
+    CyclicExecutive<N> executive;
+    std::array<CounterTask, N> tasks = makeTasks<N>();
+    for (CounterTask& task : tasks) {
+        executive.addTask(&task, 1);
+    }
+
+    for (auto _ : state) {
+        executive.tick();
+        executive.run();
+    }
+    benchmark::DoNotOptimize(tasks[0].getCount());
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * N));
+}
+
+// ============================================================================
+// run() with N tasks and nothing due: the idle check of the main loop
+// ============================================================================
+
+template<size_t N>
+static void BM_CyclicExecutive_RunIdle(benchmark::State& state) {
+    CyclicExecutive<N> executive;
+    std::array<CounterTask, N> tasks = makeTasks<N>();
+    for (CounterTask& task : tasks) {
+        executive.addTask(&task, 1000);
+    }
+
+    for (auto _ : state) {
+        executive.run();
+    }
+    benchmark::DoNotOptimize(tasks[0].getCount());
+}
+
+// ============================================================================
+// run() with N tasks on different periods (1, 2, 5, 10 ms): a realistic mix
+// ============================================================================
+
+template<size_t N>
+static void BM_CyclicExecutive_RunMixedPeriods(benchmark::State& state) {
+    static constexpr uint32_t PERIODS[] = {1, 2, 5, 10};
+    CyclicExecutive<N> executive;
+    std::array<CounterTask, N> tasks = makeTasks<N>();
+    for (size_t i = 0; i < N; ++i) {
+        executive.addTask(&tasks[i], PERIODS[i % 4]);
+    }
+
+    for (auto _ : state) {
+        executive.tick();
+        executive.run();
+    }
+    benchmark::DoNotOptimize(tasks[0].getCount());
+}
+
+BENCHMARK_TEMPLATE(BM_CyclicExecutive_RunAllDue, 1);
+BENCHMARK_TEMPLATE(BM_CyclicExecutive_RunAllDue, 4);
+BENCHMARK_TEMPLATE(BM_CyclicExecutive_RunAllDue, 16);
+BENCHMARK_TEMPLATE(BM_CyclicExecutive_RunAllDue, 64);
+
+BENCHMARK_TEMPLATE(BM_CyclicExecutive_RunIdle, 1);
+BENCHMARK_TEMPLATE(BM_CyclicExecutive_RunIdle, 16);
+BENCHMARK_TEMPLATE(BM_CyclicExecutive_RunIdle, 64);
+
+BENCHMARK_TEMPLATE(BM_CyclicExecutive_RunMixedPeriods, 4);
+BENCHMARK_TEMPLATE(BM_CyclicExecutive_RunMixedPeriods, 16);
+BENCHMARK_TEMPLATE(BM_CyclicExecutive_RunMixedPeriods, 64);
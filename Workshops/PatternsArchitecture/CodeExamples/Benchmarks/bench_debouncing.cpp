@@ -0,0 +1,87 @@
+#include <benchmark/benchmark.h>
+#include "Debouncing.hpp"
+
+#include <array>
+
+using namespace debouncing;
+
+// 1ms samples of a press and release with contact bounce, repeated
+static constexpr std::array<bool, 64> BOUNCY_INPUT = {
+    0, 0, 0, 0, 1, 0, 1, 1, 0, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 0, 1, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+};
+
+// ============================================================================
+// update() of the polled debouncers, one call per 1ms sample
+// ============================================================================
+
+template<typename Debouncer>
+static void BM_Debouncer_Update(benchmark::State& state) {
+    MockButton button;
+    Debouncer debouncer(button);
+    size_t sample = 0;
+
+    for (auto _ : state) {
+        button.setState(BOUNCY_INPUT[sample]);
+        sample = (sample + 1) % BOUNCY_INPUT.size();
+        debouncer.update();
+        benchmark::DoNotOptimize(debouncer.isPressed());
+    }
+}
+
+// ============================================================================
+// InterruptDebouncer: onEdge() plus onTimer(), the work per sample period
+// ============================================================================
+
+static void BM_InterruptDebouncer_Sample(benchmark::State& state) {
+    MockButton button;
+    MockOneShotTimer timer;
+    InterruptDebouncer debouncer(button, timer);
+    size_t sample = 0;
+
+    for (auto _ : state) {
+        button.setState(BOUNCY_INPUT[sample]);
+        sample = (sample + 1) % BOUNCY_INPUT.size();
+        debouncer.onEdge();
+        timer.expire();
+        debouncer.onTimer();
+        benchmark::DoNotOptimize(debouncer.isPressed());
+    }
+}
+
+// ============================================================================
+// PortDebouncer::update(): all 8 inputs of each port per call
+// ============================================================================
+
+template<size_t PORTS>
+static void BM_PortDebouncer_Update(benchmark::State& state) {
+    PortDebouncer<PORTS> debouncer;
+    std::array<uint8_t, PORTS> raw{};
+    size_t sample = 0;
+
+    for (auto _ : state) {
+        // Every input bounces with a different phase
+        for (size_t i = 0; i < PORTS; ++i) {
+            uint8_t word = 0;
+            for (uint8_t bit = 0; bit < 8; ++bit) {
+                const size_t at = (sample + bit * 8U + i) % BOUNCY_INPUT.size();
+                word = static_cast<uint8_t>(word | (BOUNCY_INPUT[at] << bit));
+            }
+            raw[i] = word;
+        }
+        sample = (sample + 1) % BOUNCY_INPUT.size();
+        benchmark::DoNotOptimize(raw);
+        debouncer.update(raw);
+        benchmark::DoNotOptimize(debouncer.isPressed(0, 0));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * PORTS * 8));
+}
+
+BENCHMARK_TEMPLATE(BM_Debouncer_Update, DelayDebouncer);
+BENCHMARK_TEMPLATE(BM_Debouncer_Update, ShiftRegisterDebouncer);
+BENCHMARK_TEMPLATE(BM_Debouncer_Update, IntegratorDebouncer);
+BENCHMARK(BM_InterruptDebouncer_Sample);
+BENCHMARK_TEMPLATE(BM_PortDebouncer_Update, 1);
+BENCHMARK_TEMPLATE(BM_PortDebouncer_Update, 3);
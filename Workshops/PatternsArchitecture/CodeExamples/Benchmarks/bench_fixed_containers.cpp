@@ -0,0 +1,158 @@
+#include <benchmark/benchmark.h>
+#include "FixedContainers.hpp"
+
+#include <array>
+#include <cstdint>
+
+using namespace fixed_containers;
+
+// ============================================================================
+// StaticVector: removal that keeps the order versus swap-with-last
+// ============================================================================
+
+// Fill to N, remove the first element, put it back: worst case for removeAt()
+template<size_t N>
+static void BM_StaticVector_RemoveAtFront(benchmark::State& state) {
+    StaticVector<uint32_t, N> vector;
+    for (uint32_t i = 0; i < N; ++i) vector.pushBack(i);
+
+    for (auto _ : state) {
+        const uint32_t value = vector.front();
+        vector.removeAt(0);
+        vector.pushBack(value);
+        benchmark::DoNotOptimize(vector.back());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+template<size_t N>
+static void BM_StaticVector_RemoveAtUnorderedFront(benchmark::State& state) {
+    StaticVector<uint32_t, N> vector;
+    for (uint32_t i = 0; i < N; ++i) vector.pushBack(i);
+
+    for (auto _ : state) {
+        const uint32_t value = vector.front();
+        vector.removeAtUnordered(0);
+        vector.pushBack(value);
+        benchmark::DoNotOptimize(vector.back());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+// ============================================================================
+// RingBuffer: one push and one pop per iteration
+// ============================================================================
+
+template<size_t N>
+static void BM_RingBuffer_PushPop(benchmark::State& state) {
+    RingBuffer<uint32_t, N> ring;
+    for (uint32_t i = 0; i < N / 2; ++i) ring.push(i);
+
+    uint32_t value = 0;
+    for (auto _ : state) {
+        ring.push(value);
+        ring.pop(value);
+        benchmark::DoNotOptimize(value);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+// ============================================================================
+// Lookup by key: FlatMap (binary search) versus a linear scan of pairs
+// ============================================================================
+
+template<size_t N>
+static void BM_FlatMap_Find(benchmark::State& state) {
+    FlatMap<uint16_t, uint32_t, N> map;
+    for (uint16_t key = 0; key < N; ++key) map.insert(static_cast<uint16_t>(key * 3), key);
+
+    uint16_t key = 0;
+    for (auto _ : state) {
+        const uint32_t* value = map.find(static_cast<uint16_t>(key * 3));
+        benchmark::DoNotOptimize(value);
+        key = static_cast<uint16_t>((key + 7) % N);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+template<size_t N>
+static void BM_LinearScan_Find(benchmark::State& state) {
+    struct Pair {
+        uint16_t key;
+        uint32_t value;
+        bool operator==(const Pair& other) const { return key == other.key; }
+    };
+    StaticVector<Pair, N> pairs;
+    for (uint16_t key = 0; key < N; ++key) pairs.pushBack({static_cast<uint16_t>(key * 3), key});
+
+    uint16_t key = 0;
+    for (auto _ : state) {
+        const size_t index = pairs.indexOf({static_cast<uint16_t>(key * 3), 0});
+        benchmark::DoNotOptimize(index);
+        key = static_cast<uint16_t>((key + 7) % N);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+// ============================================================================
+// IntrusiveList: O(1) unlink of an element in the middle
+// ============================================================================
+
+struct Timer : IntrusiveListNode<Timer> {
+    uint32_t dueMs = 0;
+};
+
+template<size_t N>
+static void BM_IntrusiveList_RemoveMiddle(benchmark::State& state) {
+    std::array<Timer, N> timers;
+    IntrusiveList<Timer> list;
+    for (Timer& timer : timers) list.pushBack(timer);
+
+    Timer& middle = timers[N / 2];
+    for (auto _ : state) {
+        list.remove(middle);
+        list.pushBack(middle);
+        benchmark::DoNotOptimize(list.back());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+template<size_t N>
+static void BM_StaticVector_RemoveMiddle(benchmark::State& state) {
+    std::array<Timer, N> timers;
+    StaticVector<Timer*, N> vector;
+    for (Timer& timer : timers) vector.pushBack(&timer);
+
+    Timer* middle = &timers[N / 2];
+    for (auto _ : state) {
+        vector.remove(middle);
+        vector.pushBack(middle);
+        benchmark::DoNotOptimize(vector.back());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+BENCHMARK_TEMPLATE(BM_StaticVector_RemoveAtFront, 4);
+BENCHMARK_TEMPLATE(BM_StaticVector_RemoveAtFront, 64);
+BENCHMARK_TEMPLATE(BM_StaticVector_RemoveAtFront, 1024);
+
+BENCHMARK_TEMPLATE(BM_StaticVector_RemoveAtUnorderedFront, 4);
+BENCHMARK_TEMPLATE(BM_StaticVector_RemoveAtUnorderedFront, 64);
+BENCHMARK_TEMPLATE(BM_StaticVector_RemoveAtUnorderedFront, 1024);
+
+BENCHMARK_TEMPLATE(BM_RingBuffer_PushPop, 16);
+BENCHMARK_TEMPLATE(BM_RingBuffer_PushPop, 1024);
+
+BENCHMARK_TEMPLATE(BM_FlatMap_Find, 8);
+BENCHMARK_TEMPLATE(BM_FlatMap_Find, 64);
+BENCHMARK_TEMPLATE(BM_FlatMap_Find, 512);
+
+BENCHMARK_TEMPLATE(BM_LinearScan_Find, 8);
+BENCHMARK_TEMPLATE(BM_LinearScan_Find, 64);
+BENCHMARK_TEMPLATE(BM_LinearScan_Find, 512);
+
+BENCHMARK_TEMPLATE(BM_IntrusiveList_RemoveMiddle, 16);
+BENCHMARK_TEMPLATE(BM_IntrusiveList_RemoveMiddle, 256);
+
+BENCHMARK_TEMPLATE(BM_StaticVector_RemoveMiddle, 16);
+BENCHMARK_TEMPLATE(BM_StaticVector_RemoveMiddle, 256);
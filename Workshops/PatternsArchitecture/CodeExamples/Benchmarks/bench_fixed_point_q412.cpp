@@ -0,0 +1,86 @@
+#include <benchmark/benchmark.h>
+#include "FixedPointQ412.hpp"
+
+#include <vector>
+
+using namespace fixedpoint;
+
+// Voltages spread over the whole Q4.12 range
+static std::vector<float> makeVoltages(size_t count) {
+    std::vector<float> values(count);
+    for (size_t i = 0; i < count; ++i) {
+        values[i] = static_cast<float>(i % 4096) * (15.99F / 4096.0F);
+    }
+    return values;
+}
+
+static std::vector<uint16_t> makeFixed(size_t count) {
+    std::vector<uint16_t> values(count);
+    for (size_t i = 0; i < count; ++i) {
+        values[i] = static_cast<uint16_t>(i * 40503U);
+    }
+    return values;
+}
+
+// ============================================================================
+// Scalar conversions, one value per call
+// ============================================================================
+
+static void BM_Q412_ToFixed(benchmark::State& state) {
+    const std::vector<float> in = makeVoltages(1024);
+    size_t next = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(FixedPointQ412::toFixed(in[next]));
+        next = (next + 1) & 1023U;
+    }
+}
+
+static void BM_Q412_ToFixedSaturated(benchmark::State& state) {
+    const std::vector<float> in = makeVoltages(1024);
+    size_t next = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(FixedPointQ412::toFixedSaturated(in[next]));
+        next = (next + 1) & 1023U;
+    }
+}
+
+static void BM_Q412_ToFloat(benchmark::State& state) {
+    const std::vector<uint16_t> in = makeFixed(1024);
+    size_t next = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(FixedPointQ412::toFloat(in[next]));
+        next = (next + 1) & 1023U;
+    }
+}
+
+// ============================================================================
+// Batch conversions (SIMD where available), count values per call
+// ============================================================================
+
+static void BM_Q412_ToFixedBatch(benchmark::State& state) {
+    const size_t count = static_cast<size_t>(state.range(0));
+    const std::vector<float> in = makeVoltages(count);
+    std::vector<uint16_t> out(count);
+    for (auto _ : state) {
+        FixedPointQ412::toFixed(in.data(), out.data(), count);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * count));
+}
+
+static void BM_Q412_ToFloatBatch(benchmark::State& state) {
+    const size_t count = static_cast<size_t>(state.range(0));
+    const std::vector<uint16_t> in = makeFixed(count);
+    std::vector<float> out(count);
+    for (auto _ : state) {
+        FixedPointQ412::toFloat(in.data(), out.data(), count);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * count));
+}
+
+BENCHMARK(BM_Q412_ToFixed);
+BENCHMARK(BM_Q412_ToFixedSaturated);
+BENCHMARK(BM_Q412_ToFloat);
+BENCHMARK(BM_Q412_ToFixedBatch)->RangeMultiplier(8)->Range(8, 4096);
+BENCHMARK(BM_Q412_ToFloatBatch)->RangeMultiplier(8)->Range(8, 4096);
@@ -0,0 +1,45 @@
+#include <benchmark/benchmark.h>
+#include "LockFreeQueue.hpp"
+
+#include <cstdint>
+
+using namespace lockfree_queue;
+
+// ============================================================================
+// One push and one pop per item, same thread: the uncontended cost
+// ============================================================================
+
+template<typename Queue>
+static void BM_Queue_PushPop(benchmark::State& state) {
+    static Queue queue;
+    uint32_t value = 0;
+    for (auto _ : state) {
+        queue.push(value);
+        queue.pop(value);
+        benchmark::DoNotOptimize(value);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+// ============================================================================
+// The same items moved in batches of BATCH: one index update per batch
+// ============================================================================
+
+template<typename Queue, size_t BATCH>
+static void BM_Queue_Batch(benchmark::State& state) {
+    static Queue queue;
+    uint32_t items[BATCH] = {};
+    uint32_t out[BATCH];
+    for (auto _ : state) {
+        queue.pushBatch(items, BATCH);
+        queue.popBatch(out, BATCH);
+        benchmark::DoNotOptimize(out[0]);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * BATCH));
+}
+
+BENCHMARK_TEMPLATE(BM_Queue_PushPop, SpscQueue<uint32_t, 64>);
+BENCHMARK_TEMPLATE(BM_Queue_PushPop, MpscQueue<uint32_t, 64>);
+
+BENCHMARK_TEMPLATE(BM_Queue_Batch, SpscQueue<uint32_t, 64>, 16);
+BENCHMARK_TEMPLATE(BM_Queue_Batch, MpscQueue<uint32_t, 64>, 16);
@@ -0,0 +1,94 @@
+#include <benchmark/benchmark.h>
+#include "Observer.hpp"
+
+#include <array>
+
+using namespace observer;
+
+// ============================================================================
+// ButtonSubject::notify*() with N observers (virtual dispatch per observer)
+// ============================================================================
+
+template<size_t N>
+static void BM_ButtonSubject_NotifyPressed(benchmark::State& state) {
+    ButtonSubject<N> subject;
+    std::array<LedController, N> leds;
+    for (LedController& led : leds) {
+        subject.attach(&led);
+    }
+
+    uint8_t buttonId = 0;
+    for (auto _ : state) {
+        subject.notifyPressed(buttonId++);
+    }
+    benchmark::DoNotOptimize(leds[0].getPressCount());
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * N));
+}
+
+template<size_t N>
+static void BM_ButtonSubject_NotifyReleased(benchmark::State& state) {
+    ButtonSubject<N> subject;
+    std::array<LedController, N> leds;
+    for (LedController& led : leds) {
+        subject.attach(&led);
+    }
+
+    uint8_t buttonId = 0;
+    for (auto _ : state) {
+        subject.notifyReleased(buttonId++);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * N));
+}
+
+// ============================================================================
+// TemperatureSubject::updateTemperature() with N observers
+// ============================================================================
+
+template<size_t N>
+static void BM_TemperatureSubject_Update(benchmark::State& state) {
+    TemperatureSubject<N> subject(50.0f);
+    std::array<TemperatureDisplay, N> displays;
+    for (TemperatureDisplay& display : displays) {
+        subject.attach(&display);
+    }
+
+    // Alternates below and above the threshold: both notifications run
+    float celsius = 45.0f;
+    uint32_t nowMs = 0;
+    for (auto _ : state) {
+        subject.updateTemperature(celsius, nowMs);
+        nowMs += 10;
+        celsius = celsius < 50.0f ? 55.0f : 45.0f;
+    }
+    benchmark::DoNotOptimize(subject.getLastTemperature());
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * N));
+}
+
+// ============================================================================
+// StaticSubject::notifyPressed(): the same fan-out without virtual calls
+// ============================================================================
+
+static void BM_StaticSubject_NotifyPressed4(benchmark::State& state) {
+    StaticSubject<LedController, LedController, LedController, LedController> subject;
+
+    uint8_t buttonId = 0;
+    for (auto _ : state) {
+        subject.notifyPressed(buttonId++);
+    }
+    benchmark::DoNotOptimize(subject.get<0>().getPressCount());
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * 4));
+}
+
+BENCHMARK_TEMPLATE(BM_ButtonSubject_NotifyPressed, 1);
+BENCHMARK_TEMPLATE(BM_ButtonSubject_NotifyPressed, 4);
+BENCHMARK_TEMPLATE(BM_ButtonSubject_NotifyPressed, 16);
+BENCHMARK_TEMPLATE(BM_ButtonSubject_NotifyPressed, 64);
+
+BENCHMARK_TEMPLATE(BM_ButtonSubject_NotifyReleased, 4);
+BENCHMARK_TEMPLATE(BM_ButtonSubject_NotifyReleased, 16);
+
+BENCHMARK_TEMPLATE(BM_TemperatureSubject_Update, 1);
+BENCHMARK_TEMPLATE(BM_TemperatureSubject_Update, 4);
+BENCHMARK_TEMPLATE(BM_TemperatureSubject_Update, 16);
+
+BENCHMARK(BM_StaticSubject_NotifyPressed4);
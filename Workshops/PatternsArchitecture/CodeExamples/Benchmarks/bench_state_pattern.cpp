@@ -0,0 +1,38 @@
+#include <benchmark/benchmark.h>
+#include "StatePattern.hpp"
+
+using namespace state_pattern;
+
+// Cycles through every state and includes ignored events:
+// OFF -> HEATING -> TARGET_REACHED -> HEATING -> OFF
+static constexpr HeaterEvent EVENTS[] = {
+    HeaterEvent::TEMP_LOW,   // OFF: ignored
+    HeaterEvent::TURN_ON,
+    HeaterEvent::TURN_ON,    // HEATING: ignored
+    HeaterEvent::TEMP_OK,
+    HeaterEvent::TEMP_LOW,
+    HeaterEvent::TURN_OFF,
+    HeaterEvent::TURN_OFF,   // OFF: ignored
+    HeaterEvent::TEMP_OK,    // OFF: ignored
+};
+static constexpr size_t NUM_EVENTS = sizeof(EVENTS) / sizeof(EVENTS[0]);
+
+// ============================================================================
+// handleEvent() of the three heater variants, same event sequence
+// ============================================================================
+
+template<typename Heater>
+static void BM_Heater_HandleEvent(benchmark::State& state) {
+    Heater heater;
+    size_t next = 0;
+
+    for (auto _ : state) {
+        heater.handleEvent(EVENTS[next]);
+        next = (next + 1) % NUM_EVENTS;
+        benchmark::DoNotOptimize(heater.isHeaterOn());
+    }
+}
+
+BENCHMARK_TEMPLATE(BM_Heater_HandleEvent, HeaterSwitchCase);
+BENCHMARK_TEMPLATE(BM_Heater_HandleEvent, HeaterStateTable);
+BENCHMARK_TEMPLATE(BM_Heater_HandleEvent, HeaterContext);
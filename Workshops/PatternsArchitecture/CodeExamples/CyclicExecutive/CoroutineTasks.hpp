@@ -0,0 +1,455 @@
+#ifndef COROUTINE_TASKS_HPP
+#define COROUTINE_TASKS_HPP
+
+#if __cplusplus < 202002L
+#error "CoroutineTasks.hpp needs C++20 (-std=c++20, -fcoroutines on GCC 10)"
+#endif
+
+#include "CyclicExecutive.hpp"
+
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+
+/**
+ * =============================================================================
+ * COROUTINE TASKS (sequential code on a cyclic executive)
+ * =============================================================================
+ *
+ * Problem:
+ *   ITask::run() must not block, so every multi-step job (start a
+ *   conversion, wait 20ms, read the result, ...) becomes a hand-written
+ *   state machine. It is tempting to use delay() instead, which blocks
+ *   every other task.
+ *
+ * Solution:
+ *   C++20 stackless coroutines. The job is written top to bottom and
+ *   suspends at co_await:
+ *
+ *     Coroutine<> readSensor(II2cBus& bus) {
+ *         for (;;) {
+ *             co_await i2cTransfer(bus, 0x48, startCmd, 1, nullptr, 0);
+ *             co_await sleep_ms(20);
+ *             co_await i2cTransfer(bus, 0x48, readCmd, 1, result, 2);
+ *             co_await dataReady;    // Event set from an ISR
+ *         }
+ *     }
+ *
+ *   A CoroutineExecutor is an ordinary ITask. Registered in the cyclic
+ *   executive with a 1ms period, it resumes every coroutine whose wait
+ *   is over. Coroutine frames come from a fixed FramePool: no heap, and
+ *   the number of live coroutines is bounded at compile time.
+ *
+ * Advantages:
+ *   - Readable sequential code, still run-to-completion and non-blocking
+ *   - Local variables survive a suspension (they live in the frame)
+ *   - No stack per task, unlike an RTOS thread
+ *
+ * Disadvantages:
+ *   - C++20 compiler needed
+ *   - The frame size is only known to the compiler: spawn() fails when
+ *     the frame does not fit, FramePool::largestRequest() shows the need
+ *   - An Event wakes one waiter (auto-reset)
+ *
+ * =============================================================================
+ */
+
+namespace cyclic_executive {
+
+// ============================================================================
+// Frame Pool
+// ============================================================================
+
+/**
+ * @brief Fixed pool of coroutine frames, shared by all coroutines using it
+ *
+ * Allocation happens when a coroutine is created (in the main loop), so
+ * no lock is needed. A request larger than FRAME_SIZE or an empty pool
+ * gives an empty Coroutine instead of a heap allocation.
+ */
+template<size_t FRAME_SIZE, size_t FRAMES>
+class FramePool {
+public:
+    static constexpr size_t SIZE = FRAME_SIZE;
+    static constexpr size_t COUNT = FRAMES;
+
+    static void* allocate(size_t size) noexcept {
+        if (size > largest_) largest_ = size;
+        if (size > FRAME_SIZE) return nullptr;
+        for (size_t i = 0; i < FRAMES; i++) {
+            if (!used_[i]) {
+                used_[i] = true;
+                return frames_[i].bytes;
+            }
+        }
+        return nullptr;
+    }
+
+    static void release(void* frame) noexcept {
+        for (size_t i = 0; i < FRAMES; i++) {
+            if (frames_[i].bytes == frame) {
+                used_[i] = false;
+                return;
+            }
+        }
+    }
+
+    static size_t available() {
+        size_t count = 0;
+        for (size_t i = 0; i < FRAMES; i++) {
+            if (!used_[i]) count++;
+        }
+        return count;
+    }
+
+    /** Largest frame ever requested: the FRAME_SIZE the coroutines need */
+    static size_t largestRequest() { return largest_; }
+
+private:
+    struct Frame {
+        alignas(std::max_align_t) unsigned char bytes[FRAME_SIZE];
+    };
+
+    static inline Frame frames_[FRAMES];
+    static inline bool used_[FRAMES] = {};
+    static inline size_t largest_ = 0;
+};
+
+using DefaultFramePool = FramePool<256, 8>;
+
+// ============================================================================
+// Promise and Coroutine
+// ============================================================================
+
+namespace detail {
+
+/**
+ * @brief What a suspended coroutine waits for, polled by the executor
+ *
+ * ready(context, argument, nowMs) is true when the wait is over; no
+ * ready function means "resume on the next pass" (a plain yield).
+ */
+struct CoroutinePromiseBase {
+    using ReadyFn = bool (*)(void* context, uint32_t argument, uint32_t nowMs);
+
+    ReadyFn ready = nullptr;
+    void* context = nullptr;
+    uint32_t argument = 0;
+    uint32_t resumedAtMs = 0;  // Executor time of the current resume
+
+    void waitFor(ReadyFn fn, void* ctx, uint32_t arg) {
+        ready = fn;
+        context = ctx;
+        argument = arg;
+    }
+
+    bool isReady(uint32_t nowMs) {
+        return ready == nullptr || ready(context, argument, nowMs);
+    }
+};
+
+} // namespace detail
+
+/**
+ * @brief Return type of a coroutine task
+ *
+ * Created suspended; nothing runs until CoroutineExecutor::spawn() takes
+ * it over. An unspawned Coroutine frees its frame when destroyed.
+ *
+ * @tparam Pool Frame pool (FramePool<size, count>)
+ */
+template<typename Pool = DefaultFramePool>
+class Coroutine {
+public:
+    struct promise_type : detail::CoroutinePromiseBase {
+        static void* operator new(size_t size) noexcept { return Pool::allocate(size); }
+        static void operator delete(void* frame) noexcept { Pool::release(frame); }
+        static Coroutine get_return_object_on_allocation_failure() { return Coroutine(); }
+
+        Coroutine get_return_object() {
+            return Coroutine(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+
+    using Handle = std::coroutine_handle<promise_type>;
+
+    Coroutine() : handle_(nullptr) {}
+    explicit Coroutine(Handle handle) : handle_(handle) {}
+
+    Coroutine(Coroutine&& other) noexcept : handle_(other.handle_) { other.handle_ = nullptr; }
+    Coroutine& operator=(Coroutine&& other) noexcept {
+        if (this != &other) {
+            if (handle_) handle_.destroy();
+            handle_ = other.handle_;
+            other.handle_ = nullptr;
+        }
+        return *this;
+    }
+    Coroutine(const Coroutine&) = delete;
+    Coroutine& operator=(const Coroutine&) = delete;
+
+    ~Coroutine() {
+        if (handle_) handle_.destroy();
+    }
+
+    /** false when the frame pool could not provide a frame */
+    bool isValid() const { return static_cast<bool>(handle_); }
+
+    /** Hand the frame over (to the executor) */
+    Handle release() {
+        Handle handle = handle_;
+        handle_ = nullptr;
+        return handle;
+    }
+
+private:
+    Handle handle_;
+};
+
+// ============================================================================
+// Awaitables
+// ============================================================================
+
+/**
+ * @brief co_await sleep_ms(n): resume n ms after the current resume
+ *
+ * Measured on the executor clock, so the resolution is the executor's
+ * period. sleep_ms(0) yields until the next pass.
+ */
+class SleepAwaiter {
+public:
+    explicit SleepAwaiter(uint32_t ms) : ms_(ms) {}
+
+    bool await_ready() const noexcept { return false; }
+
+    template<typename Promise>
+    void await_suspend(std::coroutine_handle<Promise> handle) const noexcept {
+        detail::CoroutinePromiseBase& promise = handle.promise();
+        promise.waitFor(&SleepAwaiter::isDue, nullptr, promise.resumedAtMs + ms_);
+    }
+
+    void await_resume() const noexcept {}
+
+private:
+    static bool isDue(void*, uint32_t wakeMs, uint32_t nowMs) {
+        return static_cast<int32_t>(nowMs - wakeMs) >= 0;
+    }
+
+    uint32_t ms_;
+};
+
+inline SleepAwaiter sleep_ms(uint32_t ms) { return SleepAwaiter(ms); }
+
+/** co_await yield(): let the other coroutines and tasks run first */
+inline SleepAwaiter yield() { return SleepAwaiter(0); }
+
+/**
+ * @brief Flag an ISR (or another task) sets; `co_await event` waits for it
+ *
+ * Auto-reset: the resumed waiter clears it. set() is one volatile store
+ * and safe in an interrupt.
+ */
+class Event {
+public:
+    Event() : signaled_(false) {}
+
+    void set() { signaled_ = true; }
+    void clear() { signaled_ = false; }
+    bool isSet() const { return signaled_; }
+
+    class Awaiter {
+    public:
+        explicit Awaiter(Event& event) : event_(event) {}
+
+        bool await_ready() const noexcept { return event_.signaled_; }
+
+        template<typename Promise>
+        void await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+            handle.promise().waitFor(&Awaiter::isSignaled, &event_, 0);
+        }
+
+        void await_resume() noexcept { event_.signaled_ = false; }
+
+    private:
+        static bool isSignaled(void* event, uint32_t, uint32_t) {
+            return static_cast<Event*>(event)->signaled_;
+        }
+
+        Event& event_;
+    };
+
+    Awaiter operator co_await() { return Awaiter(*this); }
+
+private:
+    volatile bool signaled_;
+};
+
+/**
+ * @brief Interrupt- or DMA-driven I2C master, as used by i2cTransfer()
+ *
+ * startTransfer() only starts the transfer (write tx, then read rx) and
+ * returns false while the bus is busy. On SAMD21 this maps to the
+ * SERCOM interrupts, on STM32 to HAL_I2C_Master_Transmit_IT and friends.
+ */
+class II2cBus {
+public:
+    virtual ~II2cBus() = default;
+    virtual bool startTransfer(uint8_t address, const uint8_t* tx, size_t txLength,
+                               uint8_t* rx, size_t rxLength) = 0;
+    virtual bool isBusy() const = 0;
+    virtual bool lastTransferOk() const = 0;  // ACKed and complete
+};
+
+/**
+ * @brief co_await i2cTransfer(...): start when the bus is free, resume
+ *        when the transfer is done
+ *
+ * @return (from co_await) true when the transfer succeeded
+ */
+class I2cTransferAwaiter {
+public:
+    I2cTransferAwaiter(II2cBus& bus, uint8_t address, const uint8_t* tx, size_t txLength,
+                       uint8_t* rx, size_t rxLength)
+        : bus_(bus), tx_(tx), rx_(rx), txLength_(txLength), rxLength_(rxLength)
+        , address_(address), started_(false) {}
+
+    bool await_ready() noexcept {
+        started_ = bus_.startTransfer(address_, tx_, txLength_, rx_, rxLength_);
+        return false;
+    }
+
+    template<typename Promise>
+    void await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+        handle.promise().waitFor(&I2cTransferAwaiter::isDone, this, 0);
+    }
+
+    bool await_resume() const noexcept { return bus_.lastTransferOk(); }
+
+private:
+    // Lives in the suspended frame, so 'self' stays valid while polled
+    static bool isDone(void* self, uint32_t, uint32_t) {
+        I2cTransferAwaiter& awaiter = *static_cast<I2cTransferAwaiter*>(self);
+        if (!awaiter.started_) {
+            awaiter.started_ = awaiter.bus_.startTransfer(awaiter.address_, awaiter.tx_, awaiter.txLength_,
+                                                          awaiter.rx_, awaiter.rxLength_);
+            return false;
+        }
+        return !awaiter.bus_.isBusy();
+    }
+
+    II2cBus& bus_;
+    const uint8_t* tx_;
+    uint8_t* rx_;
+    size_t txLength_;
+    size_t rxLength_;
+    uint8_t address_;
+    bool started_;
+};
+
+inline I2cTransferAwaiter i2cTransfer(II2cBus& bus, uint8_t address, const uint8_t* tx, size_t txLength,
+                                      uint8_t* rx, size_t rxLength) {
+    return I2cTransferAwaiter(bus, address, tx, txLength, rx, rxLength);
+}
+
+// ============================================================================
+// Executor
+// ============================================================================
+
+/**
+ * @brief Runs coroutines as one task of a scheduler
+ *
+ * Usage:
+ *   CyclicExecutive<8> scheduler;
+ *   CoroutineExecutor<CyclicExecutive<8>> coroutines(scheduler);
+ *   scheduler.addTask(&coroutines, 1);    // Pass every 1ms
+ *   coroutines.spawn(readSensor(bus));
+ *
+ * Each run() resumes, in spawn order, every coroutine whose wait is over,
+ * each up to its next co_await. Finished coroutines free their frame and
+ * their slot.
+ *
+ * @tparam Clock Anything with getCurrentTimeMs() (CyclicExecutive, TimeSlotScheduler)
+ * @tparam MAX_COROUTINES Slots for live coroutines
+ */
+template<typename Clock, size_t MAX_COROUTINES = 4>
+class CoroutineExecutor : public ITask {
+public:
+    explicit CoroutineExecutor(const Clock& clock, const char* name = "coroutines")
+        : clock_(clock), name_(name), active_(0) {
+        for (size_t i = 0; i < MAX_COROUTINES; i++) {
+            slots_[i] = Slot{};
+        }
+    }
+
+    ~CoroutineExecutor() override {
+        for (size_t i = 0; i < MAX_COROUTINES; i++) {
+            if (slots_[i].handle) slots_[i].handle.destroy();
+        }
+    }
+
+    CoroutineExecutor(const CoroutineExecutor&) = delete;
+    CoroutineExecutor& operator=(const CoroutineExecutor&) = delete;
+
+    /**
+     * @brief Take over a coroutine; it starts on the next run()
+     * @return false when it has no frame (pool full, frame too large)
+     *         or all slots are in use
+     */
+    template<typename Pool>
+    bool spawn(Coroutine<Pool>&& coroutine) {
+        if (!coroutine.isValid()) return false;
+        for (size_t i = 0; i < MAX_COROUTINES; i++) {
+            if (!slots_[i].handle) {
+                typename Coroutine<Pool>::Handle handle = coroutine.release();
+                slots_[i].handle = handle;
+                slots_[i].promise = &handle.promise();
+                active_++;
+                return true;
+            }
+        }
+        return false;  // Still owned by 'coroutine', freed with it
+    }
+
+    void run() override {
+        const uint32_t now = clock_.getCurrentTimeMs();
+        for (size_t i = 0; i < MAX_COROUTINES; i++) {
+            Slot& slot = slots_[i];
+            if (!slot.handle || !slot.promise->isReady(now)) continue;
+
+            slot.promise->waitFor(nullptr, nullptr, 0);
+            slot.promise->resumedAtMs = now;
+            slot.handle.resume();
+
+            if (slot.handle.done()) {
+                slot.handle.destroy();
+                slot = Slot{};
+                active_--;
+            }
+        }
+    }
+
+    const char* getName() const override { return name_; }
+
+    size_t getActiveCount() const { return active_; }
+    static constexpr size_t capacity() { return MAX_COROUTINES; }
+
+private:
+    struct Slot {
+        std::coroutine_handle<> handle;
+        detail::CoroutinePromiseBase* promise = nullptr;
+    };
+
+    const Clock& clock_;
+    const char* name_;
+    Slot slots_[MAX_COROUTINES];
+    size_t active_;
+};
+
+} // namespace cyclic_executive
+
+#endif // COROUTINE_TASKS_HPP
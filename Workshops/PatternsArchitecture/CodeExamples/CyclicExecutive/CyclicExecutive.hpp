@@ -3,6 +3,14 @@
 
 #include <cstdint>
 #include <array>
+#include <type_traits>
+#include <utility>
+
+#include "../FixedContainers/FixedContainers.hpp"
+
+#if !defined(STM32) && !defined(ARDUINO)
+#include <chrono>
+#endif
 
 /**
  * =============================================================================
@@ -49,6 +57,307 @@ public:
     virtual const char* getName() const = 0;
 };
 
+/**
+ * @brief Interface for work that only uses idle time
+ *
+ * Log flushing, compression, CRC over flash, self-tests: jobs without a
+ * deadline. The scheduler calls runChunk() in the time no periodic task
+ * is due, so each chunk must be short (well below one tick); between
+ * chunks the scheduler checks whether a periodic task became due.
+ */
+class IBackgroundTask {
+public:
+    virtual ~IBackgroundTask() = default;
+
+    /**
+     * @brief Do one small piece of the work
+     * @return false when there is nothing left to do (for now)
+     */
+    virtual bool runChunk() = 0;
+};
+
+// ============================================================================
+// Optional Instrumentation (WCET / jitter)
+// ============================================================================
+
+/**
+ * @brief Per-task timing statistics
+ *
+ * Execution times are in ticks of the selected cycle counter,
+ * release delay in scheduler milliseconds.
+ */
+struct TaskStats {
+    uint32_t minExecTicks;      // Shortest measured run()
+    uint32_t maxExecTicks;      // Longest measured run() (observed WCET)
+    uint32_t avgExecTicks;      // Mean over all runs
+    uint32_t minReleaseDelayMs; // Smallest delay between due time and dispatch
+    uint32_t maxReleaseDelayMs; // Largest delay between due time and dispatch
+    uint32_t overrunCount;      // Runs that finished after the next release
+    uint32_t samples;           // Number of measured runs
+
+    uint32_t releaseJitterMs() const { return maxReleaseDelayMs - minReleaseDelayMs; }
+};
+
+/**
+ * @brief Default cycle counter: instrumentation disabled
+ *
+ * Selecting this counter removes all measurement code and storage.
+ */
+struct NoCycleCounter {
+    static constexpr bool ENABLED = false;
+    static uint32_t now() { return 0; }
+};
+
+#if defined(STM32)
+
+/**
+ * @brief Cortex-M3/M4/M7 DWT cycle counter (core clock resolution)
+ *
+ * Call enable() once at startup before the scheduler runs.
+ */
+struct DwtCycleCounter {
+    static constexpr bool ENABLED = true;
+    static void enable() {
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CYCCNT = 0;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+    static uint32_t now() { return DWT->CYCCNT; }
+};
+
+#elif defined(ARDUINO)
+
+/**
+ * @brief Arduino micros() counter (4us resolution on 16MHz AVR)
+ */
+struct MicrosCounter {
+    static constexpr bool ENABLED = true;
+    static uint32_t now() { return micros(); }
+};
+
+#else
+
+/**
+ * @brief Host counter based on std::chrono::steady_clock (nanoseconds)
+ */
+struct SteadyClockCounter {
+    static constexpr bool ENABLED = true;
+    static uint32_t now() {
+        return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+};
+
+#endif
+
+/**
+ * @brief Default tracer: no trace events
+ *
+ * A tracer gets the start and end of every task run (task index) and,
+ * for TimeSlotScheduler, of every slot. SchedulerTracer in the
+ * TraceRecorder library (Hackaton2026 Utils) writes them as timestamped
+ * events to a RAM ring; timelines show releases, overruns and jitter.
+ */
+struct NoTracer {
+    static void taskBegin(size_t /*task*/) {}
+    static void taskEnd(size_t /*task*/) {}
+    static void slotBegin(size_t /*slot*/) {}
+    static void slotEnd(size_t /*slot*/) {}
+};
+
+namespace detail {
+
+/**
+ * @brief Statistics storage, only present when the counter is enabled
+ */
+template<size_t MAX_TASKS, bool ENABLED>
+class TaskStatsTable {
+public:
+    TaskStatsTable() : stats_{}, totalExecTicks_{}, busyTicks_(0) {}
+
+    void resetStats(size_t index) {
+        stats_[index] = TaskStats{UINT32_MAX, 0, 0, UINT32_MAX, 0, 0, 0};
+        totalExecTicks_[index] = 0;
+    }
+
+    void recordRun(size_t index, uint32_t execTicks, uint32_t releaseDelayMs, bool overrun) {
+        TaskStats& s = stats_[index];
+        if (execTicks < s.minExecTicks) s.minExecTicks = execTicks;
+        if (execTicks > s.maxExecTicks) s.maxExecTicks = execTicks;
+        if (releaseDelayMs < s.minReleaseDelayMs) s.minReleaseDelayMs = releaseDelayMs;
+        if (releaseDelayMs > s.maxReleaseDelayMs) s.maxReleaseDelayMs = releaseDelayMs;
+        if (overrun) s.overrunCount++;
+        s.samples++;
+        totalExecTicks_[index] += execTicks;
+        busyTicks_ += execTicks;
+        s.avgExecTicks = static_cast<uint32_t>(totalExecTicks_[index] / s.samples);
+    }
+
+    // Releases dropped because the task was more than a period late
+    void recordSkipped(size_t index, uint32_t releases) {
+        stats_[index].overrunCount += releases;
+    }
+
+    TaskStats statsFor(size_t index) const { return stats_[index]; }
+    uint64_t busyTicks() const { return busyTicks_; }
+
+private:
+    std::array<TaskStats, MAX_TASKS> stats_;
+    std::array<uint64_t, MAX_TASKS> totalExecTicks_;
+    uint64_t busyTicks_;
+};
+
+template<size_t MAX_TASKS>
+class TaskStatsTable<MAX_TASKS, false> {
+public:
+    void resetStats(size_t) {}
+    void recordRun(size_t, uint32_t, uint32_t, bool) {}
+    void recordSkipped(size_t, uint32_t) {}
+    TaskStats statsFor(size_t) const { return TaskStats{}; }
+    uint64_t busyTicks() const { return 0; }
+};
+
+/**
+ * @brief The background slot of a scheduler: one task, a chunk budget
+ */
+class BackgroundSlot {
+public:
+    BackgroundSlot() : task_(nullptr), maxChunks_(0), chunks_(0), pending_(false) {}
+
+    void set(IBackgroundTask* task, uint16_t maxChunks) {
+        task_ = task;
+        maxChunks_ = maxChunks;
+        pending_ = (task != nullptr);
+    }
+
+    /**
+     * @brief Run chunks while idle() holds, at most maxChunks_; nothing
+     *        after the task said it was done, until wake()
+     */
+    template<typename IdlePredicate>
+    void run(IdlePredicate idle) {
+        if (!hasWork()) return;
+        for (uint16_t n = 0; n < maxChunks_ && idle(); n++) {
+            pending_ = task_->runChunk();
+            chunks_++;
+            if (!pending_) break;
+        }
+    }
+
+    /** More work reported by the last chunk; also true before the first */
+    bool hasWork() const { return task_ != nullptr && pending_; }
+
+    /** A stopped task gets another chance, e.g. after new log data */
+    void wake() { pending_ = (task_ != nullptr); }
+
+    uint32_t chunks() const { return chunks_; }
+
+private:
+    IBackgroundTask* task_;
+    uint16_t maxChunks_;
+    uint32_t chunks_;
+    bool pending_;
+};
+
+}  // namespace detail
+
+// ============================================================================
+// Power Policies (periodic tick or tickless)
+// ============================================================================
+
+/**
+ * @brief Default policy: a 1ms tick() interrupt keeps time
+ *
+ * sleepUntilNextDeadline() is a no-op, the tick ISR owns the clock.
+ */
+struct PeriodicTickPolicy {
+    static constexpr bool TICKLESS = false;
+    static constexpr uint32_t MAX_SLEEP_MS = 0;
+    static uint32_t sleepFor(uint32_t /*ms*/) { return 0; }
+};
+
+/*
+ * A tickless policy provides:
+ *   static constexpr bool TICKLESS = true;
+ *   static constexpr uint32_t MAX_SLEEP_MS = ...;   // longest one-shot the timer supports
+ *   static uint32_t sleepFor(uint32_t ms);          // arm one-shot, sleep, return ms actually slept
+ *
+ * sleepFor() may return early when another interrupt wakes the core,
+ * the scheduler then only catches up by the time that really passed.
+ */
+
+#if defined(__SAMD21G18A__) || defined(__SAMD21E18A__)
+
+/**
+ * @brief SAMD21 tickless policy on the RTC in 32-bit counter mode (MODE0)
+ *
+ * Expects the RTC to be clocked at 1024Hz (OSCULP32K / 32) and enabled
+ * with the CMP0 interrupt routed to the NVIC by the application.
+ *
+ * Every RTC register access waits for clock-domain synchronisation, up to
+ * SYNC_TICKS RTC periods. The count read before arming is that old, and
+ * the COMP write takes as long again, so a compare only a few ticks ahead
+ * can already have passed when __WFI() runs; CMP0 would then only fire
+ * when the 32-bit counter wraps (about 48 days). Requests shorter than
+ * MIN_SLEEP_TICKS are waited out on the counter without sleeping (the
+ * scheduler clock only moves by what sleepFor() returns, so returning 0
+ * would stop it). After arming the count is read again: with less than
+ * SYNC_TICKS + 2 left the core does not sleep and the time that passed
+ * is returned.
+ */
+struct Samd21RtcTicklessPolicy {
+    static constexpr bool TICKLESS = true;
+    static constexpr uint32_t MAX_SLEEP_MS = 60000;
+    static constexpr uint32_t RTC_HZ = 1024;
+    static constexpr uint32_t SYNC_TICKS = 6;                          // Worst-case sync, in RTC periods
+    static constexpr uint32_t MIN_SLEEP_TICKS = 2 * SYNC_TICKS + 2;    // Read + write sync, plus margin
+
+    static uint32_t sleepFor(uint32_t ms) {
+        const uint32_t ticks = (ms * RTC_HZ) / 1000U;
+        const uint32_t start = readCount();
+        if (ticks < MIN_SLEEP_TICKS) {
+            while (readCount() - start < ticks) {}
+            return elapsedMs(start);
+        }
+
+        const uint32_t compare = start + ticks;
+        RTC->MODE0.COMP[0].reg = compare;
+        while (RTC->MODE0.STATUS.bit.SYNCBUSY) {}
+        RTC->MODE0.INTFLAG.reg = RTC_MODE0_INTFLAG_CMP0;
+        RTC->MODE0.INTENSET.reg = RTC_MODE0_INTENSET_CMP0;
+
+        // Armed too late: the compare is (nearly) passed, sleeping would
+        // wait for the counter to wrap
+        const int32_t left = static_cast<int32_t>(compare - readCount());
+        if (left < static_cast<int32_t>(SYNC_TICKS + 2)) return elapsedMs(start);
+
+        SCB->SCR |= SCB_SCR_SLEEPDEEP_Msk;
+        __DSB();
+        __WFI();
+        SCB->SCR &= ~SCB_SCR_SLEEPDEEP_Msk;
+
+        return elapsedMs(start);
+    }
+
+private:
+    static uint32_t readCount() {
+        RTC->MODE0.READREQ.reg = RTC_READREQ_RREQ;
+        while (RTC->MODE0.STATUS.bit.SYNCBUSY) {}
+        return RTC->MODE0.COUNT.reg;
+    }
+
+    // Keep the sub-millisecond remainder so repeated sleeps do not drift
+    static uint32_t elapsedMs(uint32_t start) {
+        const uint32_t scaled = (readCount() - start) * 1000U + residual_;
+        residual_ = scaled % RTC_HZ;
+        return scaled / RTC_HZ;
+    }
+
+    static inline uint32_t residual_ = 0;
+};
+
+#endif
+
 // ============================================================================
 // Simple Cyclic Executive
 // ============================================================================
@@ -61,6 +370,8 @@ struct TaskEntry {
     uint32_t periodMs;      // How often to run (ms)
     uint32_t lastRunMs;     // When it last ran
     uint32_t runCount;      // Statistics
+    uint32_t nextDueMs;     // Next release time (deadline heap key)
+    bool enabled;           // false = released but not run (load shedding)
 };
 
 /**
@@ -68,26 +379,67 @@ struct TaskEntry {
  *
  * Call tick() every 1ms from a timer interrupt.
  * Call run() from the main loop.
+ *
+ * Tasks are kept in a fixed-capacity min-heap ordered on their next due
+ * time. run() only has to look at the top of the heap, so an idle pass
+ * costs one compare no matter how many tasks are registered, and a due
+ * task costs O(log n) to re-insert. Releases are periodic: a task that
+ * was due at 10ms with a 10ms period is next due at 20ms, even if run()
+ * was called late, so there is no drift. Catch-up is bounded: a task
+ * that has fallen a full period or more behind (after a stall or a large
+ * catchUp()) runs once per run(). Its missed releases are skipped to the
+ * first grid point after now and counted as overruns in TaskStats, so a
+ * 1ms task does not run once per missed millisecond and starve the loop.
+ *
+ * Pass an enabled CycleCounter (DwtCycleCounter, MicrosCounter,
+ * SteadyClockCounter or your own) to collect per-task TaskStats.
+ * With the default NoCycleCounter no timing code is generated.
+ *
+ * With a tickless PowerPolicy there is no tick() interrupt: call
+ * sleepUntilNextDeadline() after run() and the scheduler sleeps until
+ * the earliest task is due, then catches its clock up.
+ *
+ * A Tracer records every task run; its cost is outside the TaskStats
+ * measurement.
+ *
+ * An optional background task (setBackgroundTask()) gets the rest of
+ * each run() pass, in chunks, until a periodic task is due again. It
+ * can delay a release by at most one chunk.
  */
-template<size_t MAX_TASKS = 8>
-class CyclicExecutive {
+template<size_t MAX_TASKS = 8, typename CycleCounter = NoCycleCounter,
+         typename PowerPolicy = PeriodicTickPolicy, typename Tracer = NoTracer>
+class CyclicExecutive : private detail::TaskStatsTable<MAX_TASKS, CycleCounter::ENABLED> {
+    using StatsTable = detail::TaskStatsTable<MAX_TASKS, CycleCounter::ENABLED>;
+
 public:
-    CyclicExecutive() : numTasks_(0), currentTimeMs_(0) {}
+    static constexpr uint32_t NO_DEADLINE = UINT32_MAX;
+    static constexpr size_t CAPACITY = MAX_TASKS;
+
+    CyclicExecutive() : currentTimeMs_(0) {}
 
     /**
      * @brief Register a task with a period
      * @param task The task to run
-     * @param periodMs How often to run (in milliseconds)
+     * @param periodMs How often to run (in milliseconds), must be > 0
+     * @return false when the table is full or the period is zero
      */
     bool addTask(ITask* task, uint32_t periodMs) {
-        if (numTasks_ >= MAX_TASKS) return false;
+        if (tasks_.isFull()) return false;
+        if (periodMs == 0) return false;
 
-        tasks_[numTasks_++] = {
+        const uint32_t now = currentTimeMs_;
+        const size_t index = tasks_.size();
+        tasks_.pushBack({
             task,
             periodMs,
-            0,  // lastRunMs
-            0   // runCount
-        };
+            now,            // lastRunMs
+            0,              // runCount
+            now + periodMs, // nextDueMs
+            true            // enabled
+        });
+        StatsTable::resetStats(index);
+        heap_[index] = static_cast<HeapIndex>(index);
+        siftUp(index);
         return true;
     }
 
@@ -95,49 +447,238 @@ public:
      * @brief Call this every 1ms (from SysTick or timer ISR)
      */
     void tick() {
-        currentTimeMs_++;
+        currentTimeMs_ = currentTimeMs_ + 1;
     }
 
     /**
      * @brief Call this from main loop - runs due tasks
+     *
+     * O(1) when nothing is due. Tasks that are due run in deadline order.
      */
     void run() {
-        for (size_t i = 0; i < numTasks_; ++i) {
-            TaskEntry& entry = tasks_[i];
+        const uint32_t now = currentTimeMs_;  // one volatile read per pass
+
+        while (!tasks_.isEmpty() && !isBefore(now, tasks_[heap_[0]].nextDueMs)) {
+            const size_t index = heap_[0];
+            TaskEntry& entry = tasks_[index];
 
-            uint32_t elapsed = currentTimeMs_ - entry.lastRunMs;
-            if (elapsed >= entry.periodMs) {
+            if (!entry.enabled) {
+                skipMissedReleases(entry, now);  // Keep the release grid, skip the work
+                siftDown(0);
+                continue;
+            }
+
+            Tracer::taskBegin(index);
+            if constexpr (CycleCounter::ENABLED) {
+                const uint32_t releaseDelayMs = now - entry.nextDueMs;
+                const uint32_t start = CycleCounter::now();
+                entry.task->run();
+                const uint32_t execTicks = CycleCounter::now() - start;
+                const uint32_t finishedMs = currentTimeMs_;
+                const bool overrun = !isBefore(finishedMs, entry.nextDueMs + entry.periodMs);
+                const uint32_t skipped = skipMissedReleases(entry, now);
+                StatsTable::recordRun(index, execTicks, releaseDelayMs, overrun && skipped == 0);
+                StatsTable::recordSkipped(index, skipped);
+            } else {
                 entry.task->run();
-                entry.lastRunMs = currentTimeMs_;
-                entry.runCount++;
+                skipMissedReleases(entry, now);
             }
+            Tracer::taskEnd(index);
+
+            entry.lastRunMs = now;
+            entry.runCount++;
+            siftDown(0);
+        }
+
+        background_.run([this]() {
+            return tasks_.isEmpty() || isBefore(currentTimeMs_, tasks_[heap_[0]].nextDueMs);
+        });
+    }
+
+    /**
+     * @brief Use idle time for a background task
+     * @param task Called after the due tasks of each run(); nullptr removes it
+     * @param maxChunks Upper bound of runChunk() calls per run()
+     */
+    void setBackgroundTask(IBackgroundTask* task, uint16_t maxChunks = 8) {
+        background_.set(task, maxChunks);
+    }
+
+    /** Let a background task that reported "done" run again */
+    void wakeBackgroundTask() { background_.wake(); }
+
+    uint32_t getBackgroundChunkCount() const { return background_.chunks(); }
+
+    /**
+     * @brief Absolute time (ms) at which the earliest task is due
+     * @return NO_DEADLINE when no task is registered
+     */
+    uint32_t getNextDeadlineMs() const {
+        if (tasks_.isEmpty()) return NO_DEADLINE;
+        return tasks_[heap_[0]].nextDueMs;
+    }
+
+    /**
+     * @brief Milliseconds until the earliest task is due
+     *
+     * Use this to decide how long the MCU may sleep after run().
+     * @return 0 if a task is already due, NO_DEADLINE when there are no tasks
+     */
+    uint32_t getTimeToNextDeadlineMs() const {
+        if (tasks_.isEmpty()) return NO_DEADLINE;
+        const uint32_t now = currentTimeMs_;
+        const uint32_t due = tasks_[heap_[0]].nextDueMs;
+        return isBefore(now, due) ? (due - now) : 0U;
+    }
+
+    /**
+     * @brief Tickless mode: sleep until the next task is due
+     *
+     * Does nothing with PeriodicTickPolicy or when a task is already due.
+     */
+    void sleepUntilNextDeadline() {
+        if constexpr (PowerPolicy::TICKLESS) {
+            if (background_.hasWork()) return;  // Idle time is not idle yet
+            uint32_t sleepMs = getTimeToNextDeadlineMs();
+            if (sleepMs == 0) return;
+            if (sleepMs > PowerPolicy::MAX_SLEEP_MS) sleepMs = PowerPolicy::MAX_SLEEP_MS;
+            catchUp(PowerPolicy::sleepFor(sleepMs));
         }
     }
 
+    /**
+     * @brief Advance the clock by elapsedMs at once (tickless wake-up)
+     */
+    void catchUp(uint32_t elapsedMs) {
+        currentTimeMs_ = currentTimeMs_ + elapsedMs;
+    }
+
     // For testing and monitoring
     uint32_t getCurrentTimeMs() const { return currentTimeMs_; }
-    size_t getTaskCount() const { return numTasks_; }
+    size_t getTaskCount() const { return tasks_.size(); }
 
     uint32_t getTaskRunCount(size_t index) const {
-        if (index < numTasks_) {
+        if (index < tasks_.size()) {
             return tasks_[index].runCount;
         }
         return 0;
     }
 
+    uint32_t getTaskPeriodMs(size_t index) const {
+        return (index < tasks_.size()) ? tasks_[index].periodMs : 0U;
+    }
+
+    /**
+     * @brief Change a task's period, effective from its next release
+     */
+    bool setTaskPeriodMs(size_t index, uint32_t periodMs) {
+        if (index >= tasks_.size() || periodMs == 0) return false;
+        tasks_[index].periodMs = periodMs;
+        return true;
+    }
+
+    /**
+     * @brief Disabled tasks keep their release times but are not run
+     */
+    bool setTaskEnabled(size_t index, bool enabled) {
+        if (index >= tasks_.size()) return false;
+        tasks_[index].enabled = enabled;
+        return true;
+    }
+
+    bool isTaskEnabled(size_t index) const {
+        return (index < tasks_.size()) && tasks_[index].enabled;
+    }
+
+    /**
+     * @brief Total measured execution time of all tasks, in counter ticks
+     *
+     * Always 0 with NoCycleCounter.
+     */
+    uint64_t getBusyTicks() const { return StatsTable::busyTicks(); }
+
+    /**
+     * @brief Timing statistics for a task (all zero when instrumentation is off)
+     */
+    TaskStats getTaskStats(size_t index) const {
+        if (index < tasks_.size()) {
+            return StatsTable::statsFor(index);
+        }
+        return TaskStats{};
+    }
+
     // For testing - manually set time
     void setTimeMs(uint32_t ms) { currentTimeMs_ = ms; }
 
 private:
-    std::array<TaskEntry, MAX_TASKS> tasks_;
-    size_t numTasks_;
+    // Heap slots only need to address MAX_TASKS entries
+    using HeapIndex = typename std::conditional<(MAX_TASKS <= 0xFFU), uint8_t, uint16_t>::type;
+
+    // Wrap-safe "a happens before b" for a free-running 32-bit ms counter
+    static bool isBefore(uint32_t a, uint32_t b) {
+        return static_cast<int32_t>(a - b) < 0;
+    }
+
+    bool earlier(size_t heapA, size_t heapB) const {
+        return isBefore(tasks_[heap_[heapA]].nextDueMs, tasks_[heap_[heapB]].nextDueMs);
+    }
+
+    // Next release of a task that was just handled at now. When that one
+    // is due already the task is more than a period late: jump to the
+    // first grid point after now and return the releases skipped.
+    static uint32_t skipMissedReleases(TaskEntry& entry, uint32_t now) {
+        entry.nextDueMs += entry.periodMs;
+        if (isBefore(now, entry.nextDueMs)) return 0;
+        const uint32_t skipped = (now - entry.nextDueMs) / entry.periodMs + 1;
+        entry.nextDueMs += skipped * entry.periodMs;
+        return skipped;
+    }
+
+    void siftUp(size_t pos) {
+        while (pos > 0) {
+            const size_t parent = (pos - 1) / 2;
+            if (!earlier(pos, parent)) break;
+            std::swap(heap_[pos], heap_[parent]);
+            pos = parent;
+        }
+    }
+
+    void siftDown(size_t pos) {
+        for (;;) {
+            const size_t left = 2 * pos + 1;
+            if (left >= tasks_.size()) break;
+
+            size_t smallest = left;
+            const size_t right = left + 1;
+            if (right < tasks_.size() && earlier(right, left)) {
+                smallest = right;
+            }
+            if (!earlier(smallest, pos)) break;
+            std::swap(heap_[pos], heap_[smallest]);
+            pos = smallest;
+        }
+    }
+
+    fixed_containers::StaticVector<TaskEntry, MAX_TASKS> tasks_;
+    std::array<HeapIndex, MAX_TASKS> heap_;  // indices into tasks_, min-heap on nextDueMs
     volatile uint32_t currentTimeMs_;  // volatile: modified by ISR
+    detail::BackgroundSlot background_;
 };
 
 // ============================================================================
 // Time Slot Scheduler (more deterministic variant)
 // ============================================================================
 
+/**
+ * @brief Budget accounting of one TimeSlotScheduler slot, in scheduler ms
+ */
+struct SlotStats {
+    uint32_t budgetMs;   // Allowed time for the slot's tasks
+    uint32_t runs;
+    uint32_t maxUsedMs;  // Longest observed run of the slot's tasks
+    uint32_t overruns;   // Runs that used the whole budget or more
+};
+
 /**
  * @brief Fixed time-slot scheduler
  *
@@ -150,19 +691,45 @@ private:
  *   Slot 1: TaskA
  *   Slot 2: TaskA, TaskC
  *   ... etc
+ *
+ * With a tickless PowerPolicy, sleepUntilNextDeadline() sleeps across
+ * empty slots in one go and only wakes for slots that have tasks.
+ * A Tracer sees each slot, and each task by its position in the slot.
+ *
+ * Slots start on a fixed grid (slot n at n * slotDurationMs): a late
+ * run() does not shift the slots after it. Each slot keeps SlotStats;
+ * a slot whose tasks take its whole budget (setSlotBudgetMs(), default
+ * the slot duration) counts an overrun, a slot that starts a full slot
+ * late counts a late start. More than one major cycle behind, the grid
+ * restarts at the current time (getResyncCount()).
+ *
+ * Slack reclamation: the time left until the next slot boundary first
+ * runs sporadic tasks (postSporadic(), oldest first), then a background
+ * task (setBackgroundTask()) in chunks. Neither starts after the boundary,
+ * so the slots stay time-triggered.
  */
-template<size_t SLOTS_PER_CYCLE = 10, size_t MAX_TASKS_PER_SLOT = 4>
+template<size_t SLOTS_PER_CYCLE = 10, size_t MAX_TASKS_PER_SLOT = 4,
+         typename PowerPolicy = PeriodicTickPolicy, typename Tracer = NoTracer>
 class TimeSlotScheduler {
 public:
+    static constexpr uint32_t NO_DEADLINE = UINT32_MAX;
+
+    static constexpr size_t SPORADIC_CAPACITY = 8;
+
     TimeSlotScheduler(uint32_t slotDurationMs = 10)
         : slotDurationMs_(slotDurationMs)
         , currentSlot_(0)
         , currentTimeMs_(0)
         , lastSlotTimeMs_(0)
+        , lateStarts_(0)
+        , resyncs_(0)
+        , sporadicHead_(0)
+        , sporadicTail_(0)
+        , sporadicDropped_(0)
     {
-        // Initialize all slots as empty
-        for (auto& slot : slots_) {
-            slot.taskCount = 0;
+        for (auto& stats : stats_) {
+            stats = SlotStats{};
+            stats.budgetMs = slotDurationMs;
         }
     }
 
@@ -172,52 +739,540 @@ public:
     bool addTaskToSlot(size_t slotIndex, ITask* task) {
         if (slotIndex >= SLOTS_PER_CYCLE) return false;
 
-        Slot& slot = slots_[slotIndex];
-        if (slot.taskCount >= MAX_TASKS_PER_SLOT) return false;
+        return slots_[slotIndex].pushBack(task);
+    }
 
-        slot.tasks[slot.taskCount++] = task;
+    /**
+     * @brief Call this every 1ms from timer
+     */
+    void tick() {
+        currentTimeMs_ = currentTimeMs_ + 1;
+    }
+
+    /**
+     * @brief Call this from main loop
+     */
+    void run() {
+        const uint32_t now = currentTimeMs_;
+
+        if (now - lastSlotTimeMs_ >= slotDurationMs_) {
+            runSlot(now);
+        }
+        reclaimSlack();
+    }
+
+    /**
+     * @brief Queue a one-shot task for the slack of the current or a later slot
+     *
+     * Single producer: one ISR, or the main loop, not both.
+     * @return false when SPORADIC_CAPACITY tasks are already waiting
+     */
+    bool postSporadic(ITask* task) {
+        const uint8_t head = sporadicHead_;
+        if (static_cast<uint8_t>(head - sporadicTail_) >= SPORADIC_CAPACITY) {
+            sporadicDropped_ = sporadicDropped_ + 1;
+            return false;
+        }
+        sporadic_[head & SPORADIC_MASK] = task;
+        sporadicHead_ = static_cast<uint8_t>(head + 1);  // Publish after the entry
         return true;
     }
 
+    size_t getSporadicPending() const { return static_cast<uint8_t>(sporadicHead_ - sporadicTail_); }
+    uint32_t getSporadicDroppedCount() const { return sporadicDropped_; }
+
+    /**
+     * @brief Budget of one slot's tasks, at most the slot duration
+     */
+    bool setSlotBudgetMs(size_t slotIndex, uint32_t budgetMs) {
+        if (slotIndex >= SLOTS_PER_CYCLE || budgetMs == 0 || budgetMs > slotDurationMs_) return false;
+        stats_[slotIndex].budgetMs = budgetMs;
+        return true;
+    }
+
+    SlotStats getSlotStats(size_t slotIndex) const {
+        return (slotIndex < SLOTS_PER_CYCLE) ? stats_[slotIndex] : SlotStats{};
+    }
+
+    /** Overruns of all slots */
+    uint32_t getOverrunCount() const {
+        uint32_t total = 0;
+        for (const SlotStats& stats : stats_) total += stats.overruns;
+        return total;
+    }
+
+    uint32_t getLateStartCount() const { return lateStarts_; }
+    uint32_t getResyncCount() const { return resyncs_; }
+
+    /**
+     * @brief Use the rest of each slot for a background task
+     * @param maxChunks Upper bound of runChunk() calls per run()
+     */
+    void setBackgroundTask(IBackgroundTask* task, uint16_t maxChunks = 8) {
+        background_.set(task, maxChunks);
+    }
+
+    void wakeBackgroundTask() { background_.wake(); }
+
+    uint32_t getBackgroundChunkCount() const { return background_.chunks(); }
+
+    /**
+     * @brief Milliseconds until the next slot that contains tasks
+     * @return NO_DEADLINE when every slot is empty
+     */
+    uint32_t getTimeToNextDeadlineMs() const {
+        const size_t emptySlots = countEmptySlotsFrom(currentSlot_);
+        if (emptySlots == SLOTS_PER_CYCLE) return NO_DEADLINE;
+
+        const uint32_t sinceSlot = currentTimeMs_ - lastSlotTimeMs_;
+        const uint32_t toBoundary = (sinceSlot >= slotDurationMs_) ? 0U : slotDurationMs_ - sinceSlot;
+        return toBoundary + static_cast<uint32_t>(emptySlots) * slotDurationMs_;
+    }
+
+    /**
+     * @brief Tickless mode: sleep until the next non-empty slot is due
+     *
+     * Empty slots that elapse while asleep are stepped over, so the
+     * major cycle keeps its position. No-op with PeriodicTickPolicy.
+     */
+    void sleepUntilNextDeadline() {
+        if constexpr (PowerPolicy::TICKLESS) {
+            if (background_.hasWork() || getSporadicPending() > 0) return;  // Idle time is not idle yet
+            uint32_t sleepMs = getTimeToNextDeadlineMs();
+            if (sleepMs == 0) return;
+            if (sleepMs > PowerPolicy::MAX_SLEEP_MS) sleepMs = PowerPolicy::MAX_SLEEP_MS;
+            catchUp(PowerPolicy::sleepFor(sleepMs));
+        }
+    }
+
+    /**
+     * @brief Advance the clock by elapsedMs at once, skipping elapsed empty slots
+     */
+    void catchUp(uint32_t elapsedMs) {
+        currentTimeMs_ = currentTimeMs_ + elapsedMs;
+
+        size_t skipped = 0;
+        while (skipped < SLOTS_PER_CYCLE &&
+               slots_[currentSlot_].isEmpty() &&
+               (currentTimeMs_ - lastSlotTimeMs_) >= slotDurationMs_) {
+            currentSlot_ = (currentSlot_ + 1) % SLOTS_PER_CYCLE;
+            lastSlotTimeMs_ += slotDurationMs_;
+            skipped++;
+        }
+    }
+
+    size_t getCurrentSlot() const { return currentSlot_; }
+    uint32_t getCurrentTimeMs() const { return currentTimeMs_; }
+
+private:
+    static constexpr uint8_t SPORADIC_MASK = SPORADIC_CAPACITY - 1;
+    static_assert((SPORADIC_CAPACITY & SPORADIC_MASK) == 0, "SPORADIC_CAPACITY must be a power of 2");
+
+    void runSlot(uint32_t now) {
+        // Grid time of this slot, not the time run() came around
+        lastSlotTimeMs_ += slotDurationMs_;
+        const uint32_t lateMs = now - lastSlotTimeMs_;
+        if (lateMs >= slotDurationMs_ * SLOTS_PER_CYCLE) {
+            lastSlotTimeMs_ = now;  // Catching up would only run stale slots back to back
+            resyncs_++;
+        } else if (lateMs >= slotDurationMs_) {
+            lateStarts_++;
+        }
+
+        Slot& slot = slots_[currentSlot_];
+        Tracer::slotBegin(currentSlot_);
+        for (size_t i = 0; i < slot.size(); ++i) {
+            Tracer::taskBegin(i);
+            slot[i]->run();
+            Tracer::taskEnd(i);
+        }
+        Tracer::slotEnd(currentSlot_);
+
+        SlotStats& stats = stats_[currentSlot_];
+        const uint32_t usedMs = currentTimeMs_ - now;
+        stats.runs++;
+        if (usedMs > stats.maxUsedMs) stats.maxUsedMs = usedMs;
+        if (usedMs >= stats.budgetMs) stats.overruns++;
+
+        // Move to next slot
+        currentSlot_ = (currentSlot_ + 1) % SLOTS_PER_CYCLE;
+    }
+
+    // Time left until the next slot boundary: sporadic tasks, then background
+    void reclaimSlack() {
+        auto inSlack = [this]() {
+            return static_cast<uint32_t>(currentTimeMs_ - lastSlotTimeMs_) < slotDurationMs_;
+        };
+        while (sporadicTail_ != sporadicHead_ && inSlack()) {
+            const uint8_t tail = sporadicTail_;
+            ITask* task = sporadic_[tail & SPORADIC_MASK];
+            sporadicTail_ = static_cast<uint8_t>(tail + 1);
+            task->run();
+        }
+        background_.run(inSlack);
+    }
+
+    size_t countEmptySlotsFrom(size_t start) const {
+        size_t count = 0;
+        while (count < SLOTS_PER_CYCLE &&
+               slots_[(start + count) % SLOTS_PER_CYCLE].isEmpty()) {
+            count++;
+        }
+        return count;
+    }
+
+    using Slot = fixed_containers::StaticVector<ITask*, MAX_TASKS_PER_SLOT>;
+
+    std::array<Slot, SLOTS_PER_CYCLE> slots_;
+    uint32_t slotDurationMs_;
+    size_t currentSlot_;
+    volatile uint32_t currentTimeMs_;
+    uint32_t lastSlotTimeMs_;  // Grid time of the last slot started
+    std::array<SlotStats, SLOTS_PER_CYCLE> stats_;
+    uint32_t lateStarts_;
+    uint32_t resyncs_;
+    ITask* volatile sporadic_[SPORADIC_CAPACITY];
+    volatile uint8_t sporadicHead_;   // Written by postSporadic() only
+    volatile uint8_t sporadicTail_;   // Written by run() only
+    volatile uint32_t sporadicDropped_;
+    detail::BackgroundSlot background_;
+};
+
+// ============================================================================
+// Static Time Slot Scheduler (schedule fixed at compile time)
+// ============================================================================
+
+/**
+ * A static task is a type with:
+ *   static void run();
+ *   static constexpr uint32_t WCET_US = ...;   // optional, used for utilization checks
+ *
+ * TaskRef<object> turns an existing task object with static storage
+ * into such a type. The call goes to the object's concrete type, so
+ * the compiler can inline it (no vtable lookup).
+ */
+template<auto& Object>
+struct TaskRef {
+    static void run() { Object.run(); }
+};
+
+namespace detail {
+
+template<typename T, typename = void>
+struct TaskWcetUs : std::integral_constant<uint32_t, 0> {};
+
+template<typename T>
+struct TaskWcetUs<T, std::void_t<decltype(T::WCET_US)>>
+    : std::integral_constant<uint32_t, T::WCET_US> {};
+
+}  // namespace detail
+
+/**
+ * @brief One slot of a static schedule: the tasks run in the listed order
+ */
+template<typename... Tasks>
+struct StaticSlot {
+    static constexpr size_t TASK_COUNT = sizeof...(Tasks);
+    static constexpr uint32_t WCET_US = (0U + ... + detail::TaskWcetUs<Tasks>::value);
+
+    static void run() { (Tasks::run(), ...); }
+};
+
+/**
+ * @brief Time slot scheduler whose major cycle is declared as types
+ *
+ * Same slot grid as TimeSlotScheduler: a late run() does not shift the
+ * slots after it, a slot that starts a full slot late counts a late
+ * start, and more than one major cycle behind the grid restarts at the
+ * current time (getResyncCount()). The slot table only exists in the
+ * type system: no RAM slot arrays, no ITask* calls. Each slot's task
+ * calls are expanded inline into run(). There are no SlotStats, budgets
+ * or slack tasks.
+ *
+ * Example:
+ *   using Schedule = StaticTimeSlotScheduler<10, 4,
+ *       StaticSlot<ReadSensors, Control>,   // slot 0
+ *       StaticSlot<ReadSensors>,            // slot 1
+ *       StaticSlot<ReadSensors, Report>>;   // slot 2
+ *
+ * Capacity and declared WCET per slot are checked with static_assert.
+ */
+template<uint32_t SLOT_DURATION_MS, size_t MAX_TASKS_PER_SLOT, typename... Slots>
+class StaticTimeSlotScheduler {
+public:
+    static constexpr size_t SLOTS_PER_CYCLE = sizeof...(Slots);
+    static constexpr uint32_t SLOT_BUDGET_US = SLOT_DURATION_MS * 1000U;
+
+    static_assert(SLOTS_PER_CYCLE > 0, "schedule needs at least one slot");
+    static_assert(SLOT_DURATION_MS > 0, "slot duration must be > 0");
+    static_assert(((Slots::TASK_COUNT <= MAX_TASKS_PER_SLOT) && ...),
+                  "a slot has more tasks than MAX_TASKS_PER_SLOT");
+    static_assert(((Slots::WCET_US <= SLOT_BUDGET_US) && ...),
+                  "declared WCET of a slot exceeds the slot duration");
+
+    /**
+     * @brief CPU utilization of the major cycle in permille (from declared WCETs)
+     */
+    static constexpr uint32_t utilizationPermille() {
+        return static_cast<uint32_t>(
+            ((0ULL + ... + Slots::WCET_US) * 1000ULL) / (SLOTS_PER_CYCLE * 1ULL * SLOT_BUDGET_US));
+    }
+
+    StaticTimeSlotScheduler()
+        : currentSlot_(0), currentTimeMs_(0), lastSlotTimeMs_(0), lateStarts_(0), resyncs_(0) {}
+
     /**
      * @brief Call this every 1ms from timer
      */
     void tick() {
-        currentTimeMs_++;
+        currentTimeMs_ = currentTimeMs_ + 1;
     }
 
     /**
      * @brief Call this from main loop
      */
     void run() {
-        uint32_t elapsed = currentTimeMs_ - lastSlotTimeMs_;
+        const uint32_t now = currentTimeMs_;
 
-        if (elapsed >= slotDurationMs_) {
-            // Run all tasks in current slot
-            Slot& slot = slots_[currentSlot_];
-            for (size_t i = 0; i < slot.taskCount; ++i) {
-                slot.tasks[i]->run();
+        if (now - lastSlotTimeMs_ >= SLOT_DURATION_MS) {
+            // Grid time of this slot, not the time run() came around
+            lastSlotTimeMs_ += SLOT_DURATION_MS;
+            const uint32_t lateMs = now - lastSlotTimeMs_;
+            if (lateMs >= SLOT_DURATION_MS * SLOTS_PER_CYCLE) {
+                lastSlotTimeMs_ = now;  // Catching up would only run stale slots back to back
+                resyncs_++;
+            } else if (lateMs >= SLOT_DURATION_MS) {
+                lateStarts_++;
             }
 
-            // Move to next slot
+            dispatch(currentSlot_, std::index_sequence_for<Slots...>{});
+
             currentSlot_ = (currentSlot_ + 1) % SLOTS_PER_CYCLE;
-            lastSlotTimeMs_ = currentTimeMs_;
         }
     }
 
     size_t getCurrentSlot() const { return currentSlot_; }
+    uint32_t getCurrentTimeMs() const { return currentTimeMs_; }
+    uint32_t getLateStartCount() const { return lateStarts_; }
+    uint32_t getResyncCount() const { return resyncs_; }
 
 private:
-    struct Slot {
-        std::array<ITask*, MAX_TASKS_PER_SLOT> tasks;
-        size_t taskCount;
-    };
+    template<size_t... I>
+    static void dispatch(size_t slot, std::index_sequence<I...>) {
+        // Expands to: if (slot == 0) Slot0::run(); else if (slot == 1) ...
+        (void)((slot == I ? (Slots::run(), true) : false) || ...);
+    }
 
-    std::array<Slot, SLOTS_PER_CYCLE> slots_;
-    uint32_t slotDurationMs_;
     size_t currentSlot_;
     volatile uint32_t currentTimeMs_;
-    uint32_t lastSlotTimeMs_;
+    uint32_t lastSlotTimeMs_;  // Grid time of the last slot started
+    uint32_t lateStarts_;
+    uint32_t resyncs_;
+};
+
+// ============================================================================
+// Preemptive Run-to-Completion Kernel (SST / QK style)
+// ============================================================================
+
+/**
+ * @brief Interrupt lock policy for host builds and tests (no-op)
+ */
+struct NoInterruptLock {
+    using State = uint32_t;
+    static State lock() { return 0; }
+    static void unlock(State) {}
+};
+
+#if defined(STM32) || defined(ARDUINO_ARCH_SAMD)
+
+/**
+ * @brief Cortex-M interrupt lock via PRIMASK (nesting-safe)
+ */
+struct PrimaskInterruptLock {
+    using State = uint32_t;
+    static State lock() {
+        const State primask = __get_PRIMASK();
+        __disable_irq();
+        return primask;
+    }
+    static void unlock(State primask) { __set_PRIMASK(primask); }
+};
+
+#endif
+
+/**
+ * @brief Dispatch policy: isrExit() runs the activated tasks itself
+ *
+ * The tasks then run in handler mode, at the priority of the ISR that
+ * activated them: every interrupt at that priority or below waits until
+ * they are done. For host builds and tests; on a target only when the
+ * longest chain of activated tasks fits the latency budget of every
+ * interrupt at or below the activating ISR.
+ */
+struct InlineDispatch {
+    static constexpr bool DEFERRED = false;
+    static void pend() {}
+};
+
+#if defined(STM32) || defined(ARDUINO_ARCH_SAMD)
+
+/**
+ * @brief Dispatch policy: isrExit() pends PendSV, whose handler runs the tasks
+ *
+ * Give PendSV the lowest priority in the system and call runPended() from
+ * PendSV_Handler. The activated tasks then run once every ISR has
+ * returned, and every interrupt can preempt them.
+ *
+ * PendSV does not nest: a task that an ISR activates while a PendSV
+ * dispatched task runs starts right after it, in priority order, not in
+ * the middle of it. Activation from task code (activate() outside an
+ * ISR) still preempts at once.
+ */
+struct PendSvDispatch {
+    static constexpr bool DEFERRED = true;
+    static void pend() { SCB->ICSR = SCB_ICSR_PENDSVSET_Msk; }
+};
+
+using DefaultDispatch = PendSvDispatch;
+
+#else
+
+using DefaultDispatch = InlineDispatch;
+
+#endif
+
+/**
+ * @brief Single-stack preemptive scheduler for run-to-completion tasks
+ *
+ * Adds the missing "priority preemption" to the cyclic executive without
+ * an RTOS: every task runs to completion, but activating a task with a
+ * higher priority than the one currently running executes it right away,
+ * nested on the same stack. No per-task stack is needed.
+ *
+ * Priorities 1..MAX_PRIORITIES, higher number = more urgent. Priority 0
+ * is the background (main loop / CyclicExecutive::run()).
+ *
+ * From an interrupt handler:
+ *   void TC3_Handler() {
+ *       auto saved = kernel.isrEnter();
+ *       kernel.activate(ECG_SAMPLE_PRIO);   // only marks it ready
+ *       kernel.isrExit(saved);              // pends PendSV if it outranks the preempted work
+ *   }
+ *   void PendSV_Handler() {
+ *       kernel.runPended();                 // lowest priority: after every ISR
+ *   }
+ *
+ * The Dispatch policy decides where ISR-activated tasks run: on Cortex-M
+ * targets PendSvDispatch (in PendSV, below every interrupt), on the host
+ * InlineDispatch (inside isrExit()). Inline dispatch on a target runs the
+ * tasks in handler mode at the ISR's priority; see InlineDispatch for
+ * when that is acceptable.
+ */
+template<uint8_t MAX_PRIORITIES = 8, typename InterruptLock = NoInterruptLock,
+         typename Dispatch = DefaultDispatch>
+class PreemptiveKernel {
+    static_assert(MAX_PRIORITIES >= 1 && MAX_PRIORITIES <= 31, "1..31 priorities supported");
+
+public:
+    using Priority = uint8_t;
+    static constexpr Priority IDLE_PRIORITY = 0;
+    static constexpr Priority ISR_PRIORITY = 0xFF;  // Blocks scheduling while inside an ISR
+
+    PreemptiveKernel() : tasks_{}, readySet_(0), currentPriority_(IDLE_PRIORITY) {}
+
+    /**
+     * @brief Bind a task to a priority level (one task per level)
+     */
+    bool addTask(ITask* task, Priority priority) {
+        if (priority == IDLE_PRIORITY || priority > MAX_PRIORITIES) return false;
+        if (tasks_[priority] != nullptr) return false;
+        tasks_[priority] = task;
+        return true;
+    }
+
+    /**
+     * @brief Make a task ready; it runs immediately if it outranks the current one
+     *
+     * Safe to call from tasks and from ISRs (between isrEnter/isrExit).
+     */
+    void activate(Priority priority) {
+        if (priority == IDLE_PRIORITY || priority > MAX_PRIORITIES) return;
+        if (tasks_[priority] == nullptr) return;
+
+        const typename InterruptLock::State state = InterruptLock::lock();
+        readySet_ = readySet_ | (1UL << priority);
+        InterruptLock::unlock(state);
+
+        schedule();
+    }
+
+    /**
+     * @brief Run all ready tasks that outrank the current priority
+     */
+    void schedule() {
+        typename InterruptLock::State state = InterruptLock::lock();
+        Priority next = highestReady();
+
+        while (next > currentPriority_ && currentPriority_ != ISR_PRIORITY) {
+            const Priority preempted = currentPriority_;
+            readySet_ = readySet_ & ~(1UL << next);
+            currentPriority_ = next;
+            InterruptLock::unlock(state);
+
+            tasks_[next]->run();  // Interrupts enabled, may itself be preempted
+
+            state = InterruptLock::lock();
+            currentPriority_ = preempted;
+            next = highestReady();
+        }
+        InterruptLock::unlock(state);
+    }
+
+    /**
+     * @brief Call first thing in an ISR that may activate tasks
+     * @return Priority to hand back to isrExit()
+     */
+    Priority isrEnter() {
+        const Priority preempted = currentPriority_;
+        currentPriority_ = ISR_PRIORITY;
+        return preempted;
+    }
+
+    /**
+     * @brief Call last thing in the ISR: dispatches the tasks activated by
+     *        it, through the Dispatch policy
+     */
+    void isrExit(Priority preempted) {
+        currentPriority_ = preempted;
+        if constexpr (Dispatch::DEFERRED) {
+            if (preempted != ISR_PRIORITY && highestReady() > preempted) {
+                Dispatch::pend();  // The outermost ISR pends, nested ones leave it
+            }
+        } else {
+            schedule();
+        }
+    }
+
+    /**
+     * @brief Body of the pended interrupt (PendSV_Handler) with a deferred
+     *        Dispatch policy: runs the ready tasks that outrank the
+     *        preempted work
+     */
+    void runPended() { schedule(); }
+
+    Priority getCurrentPriority() const { return currentPriority_; }
+    bool isReady(Priority priority) const { return (readySet_ & (1UL << priority)) != 0; }
+
+private:
+    Priority highestReady() const {
+        const uint32_t ready = readySet_;
+        if (ready == 0) return IDLE_PRIORITY;
+        return static_cast<Priority>(31 - __builtin_clz(ready));
+    }
+
+    std::array<ITask*, MAX_PRIORITIES + 1> tasks_;  // index = priority, [0] unused
+    volatile uint32_t readySet_;                    // bit n = priority n ready
+    volatile Priority currentPriority_;
 };
 
 // ============================================================================
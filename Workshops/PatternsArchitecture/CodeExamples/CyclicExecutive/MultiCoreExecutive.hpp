@@ -0,0 +1,269 @@
+#ifndef MULTI_CORE_EXECUTIVE_HPP
+#define MULTI_CORE_EXECUTIVE_HPP
+
+#include "CyclicExecutive.hpp"
+#include "../LockFreeQueue/LockFreeQueue.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(ARDUINO_ARCH_RP2040)
+#include <pico/multicore.h>
+#elif defined(ESP32)
+#include <freertos/FreeRTOS.h>
+#endif
+
+/**
+ * =============================================================================
+ * MULTI-CORE CYCLIC EXECUTIVE (RP2040, ESP32)
+ * =============================================================================
+ *
+ * Problem:
+ *   One CyclicExecutive runs on one core. On a dual-core MCU the second
+ *   core idles, or both cores share one task table behind a lock and
+ *   wait on each other.
+ *
+ * Solution:
+ *   One executive per core and a fixed core per task (affinity), chosen
+ *   at addTask(). A core only touches its own executive, so there is no
+ *   lock between them. Data crosses cores through CoreMailbox: a
+ *   single-producer / single-consumer ring with one writer per index.
+ *   On RP2040 the post also rings the SIO FIFO of the other core, which
+ *   wakes it from __wfe().
+ *
+ *   Typical split: acquisition on core 0 (tight, periodic), communication
+ *   and logging on core 1 (bursty, may block on a UART).
+ *
+ * Advantages:
+ *   - No shared-lock contention, each core keeps its deterministic timing
+ *   - Same ITask interface, tasks can move cores by changing one number
+ *
+ * Disadvantages:
+ *   - A mailbox connects exactly one producer to one consumer
+ *   - Tasks on different cores must not share data except via mailboxes
+ *
+ * Usage on RP2040 (Arduino-pico: loop() is core 0, loop1() is core 1):
+ *
+ *   MultiCoreExecutive<Rp2040Cores, 8> executive;
+ *   void setup()  { executive.addTask(&sampler, 1, 0); }
+ *   void setup1() { executive.addTask(&logger, 100, 1); }
+ *   void loop()   { executive.runCurrentCore(); }
+ *   void loop1()  { executive.runCurrentCore(); }
+ *
+ *   with a 1ms timer on core 0 calling executive.tickAll().
+ *
+ * =============================================================================
+ */
+
+namespace cyclic_executive {
+
+// ============================================================================
+// Core Identification
+// ============================================================================
+
+/**
+ * A core policy provides:
+ *   static constexpr size_t COUNT = ...;    // number of cores
+ *   static size_t current();                // core executing the call
+ */
+
+struct SingleCore {
+    static constexpr size_t COUNT = 1;
+    static size_t current() { return 0; }
+};
+
+#if defined(ARDUINO_ARCH_RP2040)
+
+struct Rp2040Cores {
+    static constexpr size_t COUNT = 2;
+    static size_t current() { return get_core_num(); }
+};
+
+using DefaultCores = Rp2040Cores;
+
+#elif defined(ESP32)
+
+struct Esp32Cores {
+    static constexpr size_t COUNT = portNUM_PROCESSORS;
+    static size_t current() { return xPortGetCoreID(); }
+};
+
+using DefaultCores = Esp32Cores;
+
+#else
+
+using DefaultCores = SingleCore;
+
+#endif
+
+// ============================================================================
+// Doorbells
+// ============================================================================
+
+/**
+ * A doorbell provides:
+ *   static void ring(size_t core);  // tell 'core' a mailbox has data
+ *   static bool take();             // on the receiving core: was it rung?
+ */
+
+/**
+ * @brief Default: the consumer polls its mailboxes (ESP32, host)
+ */
+struct NoDoorbell {
+    static void ring(size_t /*core*/) {}
+    static bool take() { return false; }
+};
+
+#if defined(ARDUINO_ARCH_RP2040)
+
+/**
+ * @brief RP2040 SIO FIFO: a word to the other core, which also sets its event flag
+ *
+ * Non-blocking: when the FIFO is full the doorbell is already pending.
+ * The SDK uses the same FIFO for multicore_lockout (flash writes,
+ * rp2040.idleOtherCore()); do not combine the two.
+ */
+struct SioFifoDoorbell {
+    static constexpr uint32_t DOORBELL = 0xD00B3E11;
+
+    static void ring(size_t /*core*/) {
+        if (multicore_fifo_wready()) {
+            sio_hw->fifo_wr = DOORBELL;
+            __sev();
+        }
+    }
+
+    static bool take() {
+        bool rung = false;
+        while (multicore_fifo_rvalid()) {
+            rung = (sio_hw->fifo_rd == DOORBELL) || rung;
+        }
+        return rung;
+    }
+};
+
+using DefaultDoorbell = SioFifoDoorbell;
+
+#else
+
+using DefaultDoorbell = NoDoorbell;
+
+#endif
+
+// ============================================================================
+// Cross-Core Mailbox
+// ============================================================================
+
+/**
+ * @brief Lock-free SPSC ring from one core to another
+ *
+ * A lockfree_queue::SpscQueue plus a doorbell: the producer only writes
+ * the head index, the consumer only writes the tail index. Only plain
+ * 32-bit loads and stores are used, which Cortex-M0+ (no LDREX/STREX)
+ * supports as well.
+ *
+ * @tparam T Message type (copied, keep it small)
+ * @tparam CAPACITY Power of two
+ * @tparam Doorbell Rung after every post, for the consumer core
+ */
+template<typename T, size_t CAPACITY = 16, typename Doorbell = DefaultDoorbell>
+class CoreMailbox {
+public:
+    explicit CoreMailbox(size_t consumerCore = 1) : consumerCore_(consumerCore) {}
+
+    /**
+     * @brief Producer core: queue a copy of 'message'
+     * @return false (and counted) when the ring is full
+     */
+    bool post(const T& message) {
+        if (!queue_.push(message)) return false;
+        Doorbell::ring(consumerCore_);
+        return true;
+    }
+
+    /**
+     * @brief Consumer core: take the oldest message
+     */
+    bool pop(T& message) { return queue_.pop(message); }
+
+    size_t size() const { return queue_.size(); }
+    bool isEmpty() const { return queue_.isEmpty(); }
+    uint32_t getDroppedCount() const { return queue_.getDroppedCount(); }
+    size_t getConsumerCore() const { return consumerCore_; }
+
+private:
+    lockfree_queue::SpscQueue<T, CAPACITY> queue_;
+    size_t consumerCore_;
+};
+
+// ============================================================================
+// Per-Core Executives
+// ============================================================================
+
+/**
+ * @brief One CyclicExecutive per core, tasks pinned to a core
+ *
+ * addTask(), run() and the statistics of a core are only used on that
+ * core (or before it starts). tick() may come from a timer on another
+ * core: the time counter has a single writer.
+ *
+ * @tparam Cores Core policy (DefaultCores fits the target)
+ * @tparam MAX_TASKS_PER_CORE Task table size of each executive
+ */
+template<typename Cores = DefaultCores, size_t MAX_TASKS_PER_CORE = 8,
+         typename CycleCounter = NoCycleCounter, typename PowerPolicy = PeriodicTickPolicy,
+         typename Tracer = NoTracer>
+class MultiCoreExecutive {
+public:
+    using Executive = CyclicExecutive<MAX_TASKS_PER_CORE, CycleCounter, PowerPolicy, Tracer>;
+    static constexpr size_t CORES = Cores::COUNT;
+
+    /**
+     * @brief Register a task on a core
+     * @param core Affinity, 0 .. CORES-1
+     * @return false for an unknown core, a full table or a zero period
+     */
+    bool addTask(ITask* task, uint32_t periodMs, size_t core) {
+        if (core >= CORES) return false;
+        return executives_[core].addTask(task, periodMs);
+    }
+
+    /** 1ms tick of one core */
+    void tick(size_t core) {
+        if (core < CORES) executives_[core].tick();
+    }
+
+    /** 1ms tick of every core, from one timer */
+    void tickAll() {
+        for (size_t core = 0; core < CORES; core++) {
+            executives_[core].tick();
+        }
+    }
+
+    /** Main loop of a core: run its due tasks */
+    void run(size_t core) {
+        if (core < CORES) executives_[core].run();
+    }
+
+    void runCurrentCore() { run(Cores::current()); }
+
+    Executive& executive(size_t core) { return executives_[core]; }
+    const Executive& executive(size_t core) const { return executives_[core]; }
+
+    size_t getTaskCount() const {
+        size_t count = 0;
+        for (size_t core = 0; core < CORES; core++) {
+            count += executives_[core].getTaskCount();
+        }
+        return count;
+    }
+
+private:
+    std::array<Executive, CORES> executives_;
+};
+
+} // namespace cyclic_executive
+
+#endif // MULTI_CORE_EXECUTIVE_HPP
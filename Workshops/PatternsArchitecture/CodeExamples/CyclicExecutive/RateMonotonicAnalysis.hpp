@@ -0,0 +1,377 @@
+#ifndef RATE_MONOTONIC_ANALYSIS_HPP
+#define RATE_MONOTONIC_ANALYSIS_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+#include "CyclicExecutive.hpp"
+
+/**
+ * =============================================================================
+ * RATE MONOTONIC ANALYSIS AND OVERLOAD GUARD
+ * =============================================================================
+ *
+ * Problem:
+ *   "Sum of all task WCETs must fit within the shortest period" is the
+ *   rule of thumb in the workshop notes, but nothing checks it. A task
+ *   set that does not fit only shows up as slipping periods on the scope.
+ *
+ * Solution:
+ *   1. At startup (or offline on the host), feed periods and WCETs into
+ *      RateMonotonicAnalyzer. It computes utilization, the Liu-Layland
+ *      bound and the exact response time of every task, and tells you
+ *      which task misses its deadline.
+ *   2. At runtime, OverloadGuard watches the measured utilization and
+ *      down-rates or sheds the lowest-priority tasks when the CPU is
+ *      overloaded, instead of letting every period slip.
+ *
+ * Rate monotonic: shorter period = higher priority. Deadline = period.
+ *
+ * Liu & Layland (1973), Joseph & Pandya (1986): response time analysis
+ *
+ * =============================================================================
+ */
+
+namespace cyclic_executive {
+
+/**
+ * @brief Timing parameters of one task
+ */
+struct TaskTiming {
+    uint32_t periodUs;
+    uint32_t wcetUs;
+};
+
+/**
+ * @brief How the tasks are dispatched
+ *
+ * NON_PREEMPTIVE matches CyclicExecutive / TimeSlotScheduler: a running
+ * task blocks more urgent ones until it returns.
+ * PREEMPTIVE matches PreemptiveKernel.
+ */
+enum class Dispatch {
+    NON_PREEMPTIVE,
+    PREEMPTIVE
+};
+
+/**
+ * @brief Liu-Layland utilization bound n(2^(1/n) - 1) in permille
+ */
+constexpr uint32_t liuLaylandBoundPermille(size_t taskCount) {
+    constexpr uint32_t BOUNDS[] = {
+        1000, 1000, 828, 779, 756, 743, 734, 728, 724,
+        720, 717, 715, 713, 711, 710, 709, 708
+    };
+    return (taskCount < sizeof(BOUNDS) / sizeof(BOUNDS[0])) ? BOUNDS[taskCount] : 693U;  // ln 2
+}
+
+/**
+ * @brief Result of a schedulability analysis
+ */
+struct SchedulabilityReport {
+    uint32_t utilizationPermille;  // Sum of wcet/period
+    uint32_t boundPermille;        // Liu-Layland bound for this task count
+    bool withinUtilizationBound;   // Sufficient test (preemptive only)
+    bool responseTimesMet;         // Exact test: every response time <= period
+    size_t firstMissIndex;         // Task index that misses first, NO_TASK if none
+
+    static constexpr size_t NO_TASK = SIZE_MAX;
+
+    bool isSchedulable() const { return responseTimesMet; }
+};
+
+/**
+ * @brief Rate monotonic schedulability analyzer
+ *
+ * Usage:
+ *   RateMonotonicAnalyzer<8> rma;
+ *   rma.loadDeclared(scheduler, WCET_US);     // or loadMeasured()
+ *   if (!rma.analyze().isSchedulable()) { ...refuse to start... }
+ */
+template<size_t MAX_TASKS = 8>
+class RateMonotonicAnalyzer {
+public:
+    static constexpr uint32_t NO_RESPONSE = UINT32_MAX;  // Does not converge within the period
+
+    RateMonotonicAnalyzer() : numTasks_(0) {}
+
+    bool addTask(uint32_t periodUs, uint32_t wcetUs) {
+        if (numTasks_ >= MAX_TASKS || periodUs == 0) return false;
+        tasks_[numTasks_++] = {periodUs, wcetUs};
+        return true;
+    }
+
+    /**
+     * @brief Take periods from a scheduler and WCETs from a table (us per task)
+     */
+    template<typename Executive>
+    bool loadDeclared(const Executive& executive, const uint32_t* wcetUs) {
+        clear();
+        for (size_t i = 0; i < executive.getTaskCount(); ++i) {
+            if (!addTask(executive.getTaskPeriodMs(i) * 1000U, wcetUs[i])) return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Take periods from a scheduler and WCETs from its measured TaskStats
+     * @param ticksPerUs Cycle counter ticks per microsecond (e.g. 48 for DWT at 48MHz)
+     */
+    template<typename Executive>
+    bool loadMeasured(const Executive& executive, uint32_t ticksPerUs) {
+        clear();
+        for (size_t i = 0; i < executive.getTaskCount(); ++i) {
+            const uint32_t wcetUs = (executive.getTaskStats(i).maxExecTicks + ticksPerUs - 1) / ticksPerUs;
+            if (!addTask(executive.getTaskPeriodMs(i) * 1000U, wcetUs)) return false;
+        }
+        return true;
+    }
+
+    void clear() { numTasks_ = 0; }
+    size_t getTaskCount() const { return numTasks_; }
+
+    /**
+     * @brief Run the utilization and response time tests
+     */
+    SchedulabilityReport analyze(Dispatch dispatch = Dispatch::NON_PREEMPTIVE) {
+        SchedulabilityReport report{};
+        report.boundPermille = liuLaylandBoundPermille(numTasks_);
+        report.firstMissIndex = SchedulabilityReport::NO_TASK;
+
+        uint64_t utilization = 0;  // in parts per million
+        for (size_t i = 0; i < numTasks_; ++i) {
+            utilization += (static_cast<uint64_t>(tasks_[i].wcetUs) * 1000000ULL) / tasks_[i].periodUs;
+        }
+        report.utilizationPermille = static_cast<uint32_t>(utilization / 1000U);
+        report.withinUtilizationBound = (dispatch == Dispatch::PREEMPTIVE) &&
+                                        (report.utilizationPermille <= report.boundPermille);
+
+        sortByPriority();
+        report.responseTimesMet = true;
+        for (size_t rank = 0; rank < numTasks_; ++rank) {
+            const size_t index = order_[rank];
+            responseUs_[index] = responseTime(rank, dispatch);
+            if (responseUs_[index] > tasks_[index].periodUs && report.responseTimesMet) {
+                report.responseTimesMet = false;
+                report.firstMissIndex = index;
+            }
+        }
+        return report;
+    }
+
+    /**
+     * @brief Worst-case response time from the last analyze() call
+     */
+    uint32_t getResponseTimeUs(size_t index) const {
+        return (index < numTasks_) ? responseUs_[index] : NO_RESPONSE;
+    }
+
+private:
+    // Rate monotonic order: shortest period first, ties by registration order
+    void sortByPriority() {
+        for (size_t i = 0; i < numTasks_; ++i) {
+            order_[i] = i;
+        }
+        for (size_t i = 1; i < numTasks_; ++i) {
+            const size_t key = order_[i];
+            size_t j = i;
+            while (j > 0 && tasks_[order_[j - 1]].periodUs > tasks_[key].periodUs) {
+                order_[j] = order_[j - 1];
+                --j;
+            }
+            order_[j] = key;
+        }
+    }
+
+    uint32_t responseTime(size_t rank, Dispatch dispatch) const {
+        const TaskTiming& task = tasks_[order_[rank]];
+
+        // Non-preemptive: one lower-priority job may have just started
+        uint64_t blocking = 0;
+        if (dispatch == Dispatch::NON_PREEMPTIVE) {
+            for (size_t lower = rank + 1; lower < numTasks_; ++lower) {
+                if (tasks_[order_[lower]].wcetUs > blocking) blocking = tasks_[order_[lower]].wcetUs;
+            }
+        }
+
+        // Fixed-point iteration, starting below the smallest solution.
+        // Non-preemptive: window = time until the task starts, its own
+        // execution is added afterwards because nothing can interrupt it.
+        uint64_t window = blocking + ((dispatch == Dispatch::PREEMPTIVE) ? task.wcetUs : 0U);
+        for (;;) {
+            uint64_t next = blocking;
+            if (dispatch == Dispatch::PREEMPTIVE) {
+                next += task.wcetUs;
+            }
+            for (size_t higher = 0; higher < rank; ++higher) {
+                const TaskTiming& hp = tasks_[order_[higher]];
+                const uint64_t releases = (dispatch == Dispatch::PREEMPTIVE)
+                    ? (window + hp.periodUs - 1) / hp.periodUs  // ceil(w / T)
+                    : window / hp.periodUs + 1;                 // releases up to our start
+                next += releases * hp.wcetUs;
+            }
+            if (next == window || next > task.periodUs) {
+                window = next;
+                break;
+            }
+            window = next;
+        }
+
+        const uint64_t response = (dispatch == Dispatch::NON_PREEMPTIVE) ? window + task.wcetUs : window;
+        return (response > task.periodUs) ? NO_RESPONSE : static_cast<uint32_t>(response);
+    }
+
+    std::array<TaskTiming, MAX_TASKS> tasks_;
+    std::array<size_t, MAX_TASKS> order_;
+    std::array<uint32_t, MAX_TASKS> responseUs_;
+    size_t numTasks_;
+};
+
+// ============================================================================
+// Runtime Overload Guard
+// ============================================================================
+
+/**
+ * @brief Keeps high-rate tasks on time when the CPU is overloaded
+ *
+ * Call evaluate() periodically with the measured utilization, or sample()
+ * with the cycle counter when the executive is instrumented. Above the
+ * overload threshold one step of degradation is applied to the lowest
+ * priority (longest period) task that is not protected:
+ *   DOWN_RATE: its period is doubled, up to 2^maxShift times the original
+ *   SHED:      it is disabled (released but not run)
+ * Below the recovery threshold the most urgent degraded task gets one
+ * step back. The gap between both thresholds is the hysteresis.
+ */
+template<typename Executive>
+class OverloadGuard {
+public:
+    enum class Action { DOWN_RATE, SHED };
+
+    OverloadGuard(Executive& executive, uint16_t overloadPermille, uint16_t recoverPermille,
+                  Action action = Action::DOWN_RATE, uint8_t maxShift = 3)
+        : executive_(executive)
+        , overloadPermille_(overloadPermille)
+        , recoverPermille_(recoverPermille)
+        , action_(action)
+        , maxShift_(action == Action::SHED ? 1 : maxShift)
+        , nominalPeriodMs_{}
+        , level_{}
+        , protected_{}
+        , lastNowTicks_(0)
+        , lastBusyTicks_(0)
+        , sampled_(false)
+    {}
+
+    /**
+     * @brief Never degrade this task (e.g. acquisition or the watchdog kick)
+     */
+    void protect(size_t index) {
+        if (index < Executive::CAPACITY) protected_[index] = true;
+    }
+
+    /**
+     * @brief Apply one degradation or recovery step for this utilization
+     */
+    void evaluate(uint32_t utilizationPermille) {
+        if (utilizationPermille > overloadPermille_) {
+            degradeOneStep();
+        } else if (utilizationPermille < recoverPermille_) {
+            recoverOneStep();
+        }
+    }
+
+    /**
+     * @brief Measure utilization since the previous call and evaluate it
+     * @param nowTicks Current cycle counter value (same counter as the executive)
+     * @return Measured utilization in permille (0 on the first call)
+     */
+    uint32_t sample(uint32_t nowTicks) {
+        const uint64_t busy = executive_.getBusyTicks();
+        uint32_t utilization = 0;
+
+        if (sampled_) {
+            const uint32_t window = nowTicks - lastNowTicks_;
+            if (window > 0) {
+                utilization = static_cast<uint32_t>(((busy - lastBusyTicks_) * 1000ULL) / window);
+                evaluate(utilization);
+            }
+        }
+        lastNowTicks_ = nowTicks;
+        lastBusyTicks_ = busy;
+        sampled_ = true;
+        return utilization;
+    }
+
+    uint8_t getDegradeLevel(size_t index) const {
+        return (index < Executive::CAPACITY) ? level_[index] : 0;
+    }
+
+    bool isDegraded() const {
+        for (size_t i = 0; i < executive_.getTaskCount(); ++i) {
+            if (level_[i] != 0) return true;
+        }
+        return false;
+    }
+
+private:
+    uint32_t nominalPeriod(size_t index) const {
+        return (level_[index] == 0) ? executive_.getTaskPeriodMs(index) : nominalPeriodMs_[index];
+    }
+
+    void degradeOneStep() {
+        size_t victim = Executive::CAPACITY;
+        for (size_t i = 0; i < executive_.getTaskCount(); ++i) {
+            if (protected_[i] || level_[i] >= maxShift_) continue;
+            if (victim == Executive::CAPACITY || nominalPeriod(i) > nominalPeriod(victim)) {
+                victim = i;
+            }
+        }
+        if (victim == Executive::CAPACITY) return;  // Nothing left to give up
+
+        if (level_[victim] == 0) {
+            nominalPeriodMs_[victim] = executive_.getTaskPeriodMs(victim);
+        }
+        level_[victim]++;
+        apply(victim);
+    }
+
+    void recoverOneStep() {
+        size_t chosen = Executive::CAPACITY;
+        for (size_t i = 0; i < executive_.getTaskCount(); ++i) {
+            if (level_[i] == 0) continue;
+            if (chosen == Executive::CAPACITY || nominalPeriodMs_[i] < nominalPeriodMs_[chosen]) {
+                chosen = i;
+            }
+        }
+        if (chosen == Executive::CAPACITY) return;
+
+        level_[chosen]--;
+        apply(chosen);
+    }
+
+    void apply(size_t index) {
+        if (action_ == Action::SHED) {
+            executive_.setTaskEnabled(index, level_[index] == 0);
+        } else {
+            executive_.setTaskPeriodMs(index, nominalPeriodMs_[index] << level_[index]);
+        }
+    }
+
+    Executive& executive_;
+    uint16_t overloadPermille_;
+    uint16_t recoverPermille_;
+    Action action_;
+    uint8_t maxShift_;
+    std::array<uint32_t, Executive::CAPACITY> nominalPeriodMs_;
+    std::array<uint8_t, Executive::CAPACITY> level_;
+    std::array<bool, Executive::CAPACITY> protected_;
+    uint32_t lastNowTicks_;
+    uint64_t lastBusyTicks_;
+    bool sampled_;
+};
+
+}  // namespace cyclic_executive
+
+#endif  // RATE_MONOTONIC_ANALYSIS_HPP
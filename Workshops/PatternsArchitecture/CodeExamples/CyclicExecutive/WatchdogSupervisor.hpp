@@ -0,0 +1,309 @@
+#ifndef WATCHDOG_SUPERVISOR_HPP
+#define WATCHDOG_SUPERVISOR_HPP
+
+#include "CyclicExecutive.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * =============================================================================
+ * WATCHDOG SUPERVISOR (per-task check-in)
+ * =============================================================================
+ *
+ * Problem:
+ *   A hardware watchdog fed from loop() only notices that the loop
+ *   stopped. A task that never runs any more (starved, disabled by
+ *   mistake) or that runs without doing its work (stuck state machine)
+ *   leaves the loop spinning, and the watchdog keeps being fed.
+ *
+ * Solution:
+ *   Every expected task owns one bit. A task run checks in by ORing its
+ *   bit into a mask. Once per window, check() compares the mask with the
+ *   expected one. The watchdog is fed only when every expected task has
+ *   checked in. Otherwise the missing bits are written to a record in RAM
+ *   that survives the reset, and the watchdog is left to bite.
+ *
+ *   Check-in per run, either way:
+ *   - automatic: WatchdogTaskTracer (CyclicExecutive, bit = task index)
+ *     or WatchdogSlotTracer (TimeSlotScheduler, bit = slot and position)
+ *     as the scheduler's Tracer; catches a task that is no longer run
+ *   - explicit: checkIn(bit) from the task itself, at the point where it
+ *     made progress; also catches a task that runs but is stuck
+ *
+ * Cost:
+ *   One OR per task run, one AND and compare per window.
+ *
+ * Window:
+ *   Every expected task must run at least once per window. Use at least
+ *   twice the longest period of an expected task, so a release that is
+ *   delayed across a check is not taken for a missing one. The hardware
+ *   timeout must be longer than the window.
+ *
+ * Usage (CyclicExecutive, tasks in registration order):
+ *
+ *   WATCHDOG_RETAINED WatchdogRecord resetLog;
+ *   WatchdogSupervisor<Samd21Watchdog> supervisor(resetLog);
+ *   CyclicExecutive<8, NoCycleCounter, PeriodicTickPolicy,
+ *                   WatchdogTaskTracer<supervisor>> scheduler;
+ *
+ *   setup():
+ *     uint32_t missing;
+ *     if (WatchdogSupervisor<>::takeResetRecord(resetLog, missing)) report(missing);
+ *     scheduler.addTask(&sensor, 10);       // bit 0
+ *     scheduler.addTask(&control, 20);      // bit 1
+ *     scheduler.addTask(&supervisor, 100);  // check() every 100ms, bit 2 not expected
+ *     supervisor.expect(0);
+ *     supervisor.expect(1);
+ *
+ * =============================================================================
+ */
+
+// RAM that the startup code does not zero: the linker script must have a
+// .noinit section outside .bss (the AVR toolchain does; add one to a
+// Cortex-M script that lacks it)
+#if defined(__GNUC__) && (defined(ARDUINO) || defined(STM32))
+#define WATCHDOG_RETAINED __attribute__((section(".noinit")))
+#else
+#define WATCHDOG_RETAINED
+#endif
+
+namespace cyclic_executive {
+
+// ============================================================================
+// Hardware Watchdogs
+// ============================================================================
+
+/*
+ * A watchdog policy provides:
+ *   static void feed();   // restart the hardware timeout
+ *
+ * Enabling the watchdog and choosing its timeout stay with the
+ * application.
+ */
+
+/**
+ * @brief No hardware watchdog: check() still records missing tasks
+ */
+struct NoWatchdog {
+    static void feed() {}
+};
+
+#if defined(__SAMD21G18A__) || defined(__SAMD21E18A__)
+
+/**
+ * @brief SAMD21 WDT
+ *
+ * A clear while the previous one is still synchronising would be lost
+ * anyway; the next window clears again.
+ */
+struct Samd21Watchdog {
+    static void feed() {
+        if (!WDT->STATUS.bit.SYNCBUSY) {
+            WDT->CLEAR.reg = WDT_CLEAR_CLEAR_KEY;
+        }
+    }
+};
+
+#elif defined(STM32)
+
+/**
+ * @brief STM32 independent watchdog (IWDG)
+ */
+struct Stm32Iwdg {
+    static void feed() { IWDG->KR = 0xAAAAU; }
+};
+
+#endif
+
+// ============================================================================
+// Retained Reset Record
+// ============================================================================
+
+/**
+ * @brief Why the supervisor stopped feeding, kept across the reset
+ *
+ * Place the instance in WATCHDOG_RETAINED memory. After a power-on reset
+ * the contents are random; magic and the inverted copy make a false
+ * record unlikely.
+ */
+struct WatchdogRecord {
+    uint32_t magic;
+    uint32_t missing;       // Expected tasks that had not checked in
+    uint32_t failedChecks;  // Checks in a row that found a task missing
+    uint32_t inverse;       // ~missing
+};
+
+// ============================================================================
+// Supervisor
+// ============================================================================
+
+/**
+ * @brief Feeds the watchdog only while every expected task checks in
+ *
+ * Up to 32 tasks, one bit each. checkIn() and check() run in the main
+ * loop (tasks and the scheduler), not in interrupts: the OR is a
+ * read-modify-write.
+ *
+ * The supervisor is an ITask itself: register it with the window as its
+ * period, or call check() at the end of every major cycle.
+ */
+template<typename Watchdog = NoWatchdog>
+class WatchdogSupervisor : public ITask {
+public:
+    using Mask = uint32_t;
+    static constexpr size_t MAX_TASKS = 32;
+    static constexpr uint32_t MAGIC = 0x57444F47U;  // "WDOG"
+
+    explicit WatchdogSupervisor(WatchdogRecord& record)
+        : record_(record)
+        , expected_(0)
+        , reported_(0)
+        , failedChecks_(0)
+        , feeds_(0)
+    {
+    }
+
+    /**
+     * @brief Require a check-in from task (bit) in every window
+     * @return false for a bit beyond MAX_TASKS
+     */
+    bool expect(size_t task) {
+        if (task >= MAX_TASKS) return false;
+        expected_ |= bitFor(task);
+        return true;
+    }
+
+    /** No longer require task, e.g. while it is disabled on purpose */
+    void ignore(size_t task) {
+        if (task < MAX_TASKS) expected_ &= ~bitFor(task);
+    }
+
+    /** One OR; bits beyond MAX_TASKS are dropped by the mask */
+    void checkIn(size_t task) { reported_ |= bitFor(task); }
+
+    /** For a mask computed once, e.g. a constexpr bit */
+    void checkInMask(Mask bits) { reported_ |= bits; }
+
+    /**
+     * @brief End of a window: feed if every expected task checked in
+     *
+     * Starts the next window either way. A failing check writes the
+     * missing tasks to the record, the last one before the reset wins;
+     * a passing check after failures withdraws it again.
+     * @return true if the watchdog was fed
+     */
+    bool check() {
+        const Mask reported = reported_;
+        reported_ = 0;
+        if ((reported & expected_) == expected_) {
+            Watchdog::feed();
+            if (failedChecks_ != 0) {
+                failedChecks_ = 0;
+                record_.magic = 0;  // Recovered before the watchdog fired
+            }
+            feeds_++;
+            return true;
+        }
+
+        const Mask missing = expected_ & ~reported;
+        failedChecks_++;
+        record_.missing = missing;
+        record_.failedChecks = failedChecks_;
+        record_.inverse = ~missing;
+        record_.magic = MAGIC;
+        return false;
+    }
+
+    void run() override { check(); }
+    const char* getName() const override { return "watchdog"; }
+
+    /**
+     * @brief Read and clear the record of the previous reset
+     * @param missing Tasks that had not checked in before the reset
+     * @return false if the previous reset was not the supervisor's
+     *         (power-on, reset pin, no record)
+     */
+    static bool takeResetRecord(WatchdogRecord& record, Mask& missing) {
+        const bool valid = record.magic == MAGIC && record.inverse == ~record.missing;
+        missing = valid ? record.missing : 0;
+        record.magic = 0;
+        return valid;
+    }
+
+    /** Lowest task bit in a mask, MAX_TASKS for none: the task to blame */
+    static size_t firstTask(Mask bits) {
+        for (size_t task = 0; task < MAX_TASKS; task++) {
+            if (bits & bitFor(task)) return task;
+        }
+        return MAX_TASKS;
+    }
+
+    Mask getExpected() const { return expected_; }
+    Mask getReported() const { return reported_; }
+    uint32_t getFailedChecks() const { return failedChecks_; }
+    uint32_t getFeedCount() const { return feeds_; }
+
+private:
+    static Mask bitFor(size_t task) {
+        return task < MAX_TASKS ? (Mask(1) << task) : Mask(0);
+    }
+
+    WatchdogRecord& record_;
+    Mask expected_;
+    Mask reported_;
+    uint32_t failedChecks_;
+    uint32_t feeds_;
+};
+
+// ============================================================================
+// Scheduler Tracers
+// ============================================================================
+
+/**
+ * @brief CyclicExecutive Tracer: each task run checks in its task index
+ *
+ * Chains to another tracer (e.g. SchedulerTracer) through Inner.
+ */
+template<auto& Supervisor, typename Inner = NoTracer>
+struct WatchdogTaskTracer {
+    static void taskBegin(size_t task) { Inner::taskBegin(task); }
+    static void taskEnd(size_t task) {
+        Supervisor.checkIn(task);
+        Inner::taskEnd(task);
+    }
+    static void slotBegin(size_t slot) { Inner::slotBegin(slot); }
+    static void slotEnd(size_t slot) { Inner::slotEnd(slot); }
+};
+
+/**
+ * @brief TimeSlotScheduler Tracer: each task run checks in its own bit
+ *
+ * TimeSlotScheduler passes a task's position within its slot, so the bit
+ * is slot * TASKS_PER_SLOT + position (bitFor()); pass the scheduler's
+ * MAX_TASKS_PER_SLOT. A single tracer instance per supervisor.
+ */
+template<auto& Supervisor, size_t TASKS_PER_SLOT, typename Inner = NoTracer>
+struct WatchdogSlotTracer {
+    static constexpr size_t bitFor(size_t slot, size_t position) {
+        return slot * TASKS_PER_SLOT + position;
+    }
+
+    static void taskBegin(size_t task) { Inner::taskBegin(task); }
+    static void taskEnd(size_t task) {
+        Supervisor.checkIn(slotBit_ + task);
+        Inner::taskEnd(task);
+    }
+    static void slotBegin(size_t slot) {
+        slotBit_ = bitFor(slot, 0);
+        Inner::slotBegin(slot);
+    }
+    static void slotEnd(size_t slot) { Inner::slotEnd(slot); }
+
+private:
+    static inline size_t slotBit_ = 0;
+};
+
+} // namespace cyclic_executive
+
+#endif // WATCHDOG_SUPERVISOR_HPP
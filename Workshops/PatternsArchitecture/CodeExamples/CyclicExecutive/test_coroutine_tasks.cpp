@@ -0,0 +1,247 @@
+#include "CppUTest/TestHarness.h"
+#include "CoroutineTasks.hpp"
+
+#include <cstring>
+
+using namespace cyclic_executive;
+
+// Needs -std=c++20
+
+namespace {
+
+using Scheduler = CyclicExecutive<4>;
+using SmallPool = FramePool<256, 2>;
+using TinyPool = FramePool<16, 1>;
+
+/**
+ * I2C master that completes a transfer after 'latency' polls of isBusy();
+ * foreignPolls refuses that many starts, as if another master used the bus
+ */
+class MockI2cBus : public II2cBus {
+public:
+    bool startTransfer(uint8_t address, const uint8_t* tx, size_t txLength,
+                       uint8_t* rx, size_t rxLength) override {
+        if (foreignPolls > 0) {
+            foreignPolls--;  // Someone else's transfer, still running
+            return false;
+        }
+        lastAddress = address;
+        lastTxLength = txLength;
+        if (tx && txLength > 0) lastTx = tx[0];
+        for (size_t i = 0; i < rxLength; i++) rx[i] = static_cast<uint8_t>(0xA0 + i);
+        busyPolls = latency;
+        starts++;
+        return true;
+    }
+    bool isBusy() const override {
+        if (busyPolls > 0) busyPolls--;
+        return busyPolls > 0;
+    }
+    bool lastTransferOk() const override { return ack; }
+
+    mutable int busyPolls = 0;
+    int foreignPolls = 0;
+    int latency = 3;
+    int starts = 0;
+    bool ack = true;
+    uint8_t lastAddress = 0;
+    uint8_t lastTx = 0;
+    size_t lastTxLength = 0;
+};
+
+Coroutine<> countEvery(uint32_t periodMs, int& counter) {
+    for (;;) {
+        co_await sleep_ms(periodMs);
+        counter++;
+    }
+}
+
+Coroutine<> stepThrough(int& step, Event& event) {
+    step = 1;
+    co_await yield();
+    step = 2;
+    co_await event;
+    step = 3;
+}
+
+Coroutine<> readRegister(II2cBus& bus, uint8_t* result, bool& ok, bool& done) {
+    const uint8_t reg = 0x05;
+    ok = co_await i2cTransfer(bus, 0x48, &reg, 1, result, 2);
+    done = true;
+}
+
+Coroutine<SmallPool> parked(int& started) {
+    started++;
+    co_await sleep_ms(1000);
+}
+
+Coroutine<TinyPool> tooLarge(int& started) {
+    uint8_t buffer[64];
+    std::memset(buffer, started, sizeof(buffer));
+    co_await yield();
+    started += buffer[10];
+}
+
+} // namespace
+
+// ============================================================================
+// CoroutineExecutor Tests
+// ============================================================================
+
+TEST_GROUP(CoroutineTasks) {
+    Scheduler* scheduler;
+    CoroutineExecutor<Scheduler>* coroutines;
+
+    void setup() {
+        scheduler = new Scheduler();
+        coroutines = new CoroutineExecutor<Scheduler>(*scheduler);
+        scheduler->addTask(coroutines, 1);
+    }
+
+    void teardown() {
+        delete coroutines;
+        delete scheduler;
+    }
+
+    void advanceTimeMs(uint32_t ms) {
+        for (uint32_t i = 0; i < ms; i++) {
+            scheduler->tick();
+            scheduler->run();
+        }
+    }
+};
+
+TEST(CoroutineTasks, SleepResumesAfterThePeriod) {
+    int counter = 0;
+    CHECK_TRUE(coroutines->spawn(countEvery(10, counter)));
+
+    advanceTimeMs(1);     // Starts, sleeps until 11
+    LONGS_EQUAL(0, counter);
+    advanceTimeMs(9);
+    LONGS_EQUAL(0, counter);
+    advanceTimeMs(1);
+    LONGS_EQUAL(1, counter);
+    advanceTimeMs(100);
+    LONGS_EQUAL(11, counter);
+}
+
+TEST(CoroutineTasks, TwoCoroutinesInterleave) {
+    int fast = 0;
+    int slow = 0;
+    coroutines->spawn(countEvery(5, fast));
+    coroutines->spawn(countEvery(20, slow));
+
+    advanceTimeMs(101);
+    LONGS_EQUAL(20, fast);
+    LONGS_EQUAL(5, slow);
+    LONGS_EQUAL(2, coroutines->getActiveCount());
+}
+
+TEST(CoroutineTasks, EventWakesTheWaiterOnceAndFinishes) {
+    int step = 0;
+    Event event;
+    coroutines->spawn(stepThrough(step, event));
+
+    advanceTimeMs(1);
+    LONGS_EQUAL(1, step);
+    advanceTimeMs(1);
+    LONGS_EQUAL(2, step);
+    advanceTimeMs(10);
+    LONGS_EQUAL(2, step);
+
+    event.set();  // E.g. from a data-ready interrupt
+    advanceTimeMs(1);
+    LONGS_EQUAL(3, step);
+    CHECK_FALSE(event.isSet());
+    LONGS_EQUAL(0, coroutines->getActiveCount());
+}
+
+TEST(CoroutineTasks, EventAlreadySetDoesNotSuspend) {
+    int step = 0;
+    Event event;
+    event.set();
+    coroutines->spawn(stepThrough(step, event));
+
+    advanceTimeMs(2);
+    LONGS_EQUAL(3, step);
+}
+
+TEST(CoroutineTasks, I2cTransferResumesWhenTheBusIsDone) {
+    MockI2cBus bus;
+    uint8_t result[2] = {0, 0};
+    bool ok = false;
+    bool done = false;
+    coroutines->spawn(readRegister(bus, result, ok, done));
+
+    advanceTimeMs(1);
+    LONGS_EQUAL(1, bus.starts);
+    LONGS_EQUAL(0x48, bus.lastAddress);
+    LONGS_EQUAL(0x05, bus.lastTx);
+    CHECK_FALSE(done);
+
+    advanceTimeMs(3);
+    CHECK_TRUE(done);
+    CHECK_TRUE(ok);
+    LONGS_EQUAL(0xA0, result[0]);
+    LONGS_EQUAL(0xA1, result[1]);
+}
+
+TEST(CoroutineTasks, I2cTransferWaitsForABusyBus) {
+    MockI2cBus bus;
+    bus.foreignPolls = 5;
+    bus.ack = false;
+    uint8_t result[2] = {0, 0};
+    bool ok = true;
+    bool done = false;
+    coroutines->spawn(readRegister(bus, result, ok, done));
+
+    advanceTimeMs(3);
+    LONGS_EQUAL(0, bus.starts);
+    advanceTimeMs(20);
+    LONGS_EQUAL(1, bus.starts);
+    CHECK_TRUE(done);
+    CHECK_FALSE(ok);  // NACK reported by co_await
+}
+
+TEST(CoroutineTasks, FramesComeFromTheFixedPool) {
+    int started = 0;
+    LONGS_EQUAL(2, SmallPool::available());
+
+    CHECK_TRUE(coroutines->spawn(parked(started)));
+    CHECK_TRUE(coroutines->spawn(parked(started)));
+    LONGS_EQUAL(0, SmallPool::available());
+
+    CHECK_FALSE(coroutines->spawn(parked(started)));  // Pool empty: no heap
+    advanceTimeMs(1);
+    LONGS_EQUAL(2, started);
+    CHECK_TRUE(SmallPool::largestRequest() <= SmallPool::SIZE);
+}
+
+TEST(CoroutineTasks, FrameLargerThanThePoolIsRefused) {
+    int started = 0;
+    CHECK_FALSE(coroutines->spawn(tooLarge(started)));
+    CHECK_TRUE(TinyPool::largestRequest() > TinyPool::SIZE);
+    LONGS_EQUAL(1, TinyPool::available());
+}
+
+TEST(CoroutineTasks, FinishedCoroutineReturnsItsFrame) {
+    int step = 0;
+    Event event;
+    const size_t before = DefaultFramePool::available();
+    coroutines->spawn(stepThrough(step, event));
+    LONGS_EQUAL(before - 1, DefaultFramePool::available());
+
+    event.set();
+    advanceTimeMs(3);
+    LONGS_EQUAL(before, DefaultFramePool::available());
+}
+
+TEST(CoroutineTasks, SlotsAreLimited) {
+    int counter = 0;
+    for (size_t i = 0; i < coroutines->capacity(); i++) {
+        CHECK_TRUE(coroutines->spawn(countEvery(10, counter)));
+    }
+    const size_t free = DefaultFramePool::available();
+    CHECK_FALSE(coroutines->spawn(countEvery(10, counter)));
+    LONGS_EQUAL(free, DefaultFramePool::available());  // Refused frame freed
+}
@@ -1,5 +1,8 @@
 #include "CppUTest/TestHarness.h"
 #include "CyclicExecutive.hpp"
+#include "../PerfBudget/PerfBudget.hpp"
+
+#include <string>
 
 using namespace cyclic_executive;
 
@@ -29,6 +32,14 @@ TEST_GROUP(CyclicExecutive) {
             scheduler->tick();
         }
     }
+
+    // A main loop that keeps up: run() after every tick
+    void advanceAndRunMs(uint32_t ms) {
+        for (uint32_t i = 0; i < ms; i++) {
+            scheduler->tick();
+            scheduler->run();
+        }
+    }
 };
 
 TEST(CyclicExecutive, CanAddTask) {
@@ -57,8 +68,7 @@ TEST(CyclicExecutive, TaskRunsAtPeriod) {
 TEST(CyclicExecutive, TaskRunsMultipleTimes) {
     scheduler->addTask(fastTask, 10);
 
-    advanceTimeMs(35);
-    scheduler->run();  // Runs at 10, 20, 30
+    advanceAndRunMs(35);  // Runs at 10, 20, 30
 
     LONGS_EQUAL(3, fastTask->getCount());
 }
@@ -67,8 +77,7 @@ TEST(CyclicExecutive, MultipleTasks) {
     scheduler->addTask(fastTask, 10);  // Runs at 10, 20, 30, 40, 50...
     scheduler->addTask(slowTask, 25);  // Runs at 25, 50...
 
-    advanceTimeMs(50);
-    scheduler->run();
+    advanceAndRunMs(50);
 
     LONGS_EQUAL(5, fastTask->getCount());
     LONGS_EQUAL(2, slowTask->getCount());
@@ -83,6 +92,232 @@ TEST(CyclicExecutive, RejectsWhenFull) {
     CHECK_FALSE(smallScheduler.addTask(&task3, 30));  // No room!
 }
 
+TEST(CyclicExecutive, RejectsZeroPeriod) {
+    CHECK_FALSE(scheduler->addTask(fastTask, 0));
+    LONGS_EQUAL(0, scheduler->getTaskCount());
+}
+
+TEST(CyclicExecutive, ReportsNoDeadlineWhenEmpty) {
+    UNSIGNED_LONGS_EQUAL(CyclicExecutive<8>::NO_DEADLINE, scheduler->getTimeToNextDeadlineMs());
+}
+
+TEST(CyclicExecutive, ReportsTimeToNextDeadline) {
+    scheduler->addTask(slowTask, 25);
+    scheduler->addTask(fastTask, 10);
+
+    UNSIGNED_LONGS_EQUAL(10, scheduler->getTimeToNextDeadlineMs());
+
+    advanceTimeMs(4);
+    UNSIGNED_LONGS_EQUAL(6, scheduler->getTimeToNextDeadlineMs());
+
+    advanceTimeMs(6);
+    UNSIGNED_LONGS_EQUAL(0, scheduler->getTimeToNextDeadlineMs());  // Due now
+
+    scheduler->run();
+    UNSIGNED_LONGS_EQUAL(20, scheduler->getNextDeadlineMs());
+    UNSIGNED_LONGS_EQUAL(10, scheduler->getTimeToNextDeadlineMs());
+}
+
+TEST(CyclicExecutive, IdleRunDoesNotDispatch) {
+    scheduler->addTask(fastTask, 10);
+    scheduler->addTask(slowTask, 25);
+
+    for (int i = 0; i < 9; i++) {
+        advanceTimeMs(1);
+        scheduler->run();
+    }
+
+    LONGS_EQUAL(0, fastTask->getCount());
+    LONGS_EQUAL(0, slowTask->getCount());
+}
+
+TEST(CyclicExecutive, KeepsPeriodWhenRunIsLate) {
+    scheduler->addTask(fastTask, 10);
+
+    advanceTimeMs(13);
+    scheduler->run();  // Released at 10, run late at 13
+    advanceTimeMs(7);
+    scheduler->run();  // Next release is still at 20
+
+    LONGS_EQUAL(2, fastTask->getCount());
+}
+
+TEST(CyclicExecutive, HandlesTimerWrapAround) {
+    scheduler->setTimeMs(UINT32_MAX - 4);
+    scheduler->addTask(fastTask, 10);  // Due at 5 after wrapping
+
+    advanceTimeMs(9);
+    scheduler->run();
+    LONGS_EQUAL(0, fastTask->getCount());
+
+    advanceTimeMs(1);
+    scheduler->run();
+    LONGS_EQUAL(1, fastTask->getCount());
+}
+
+TEST(CyclicExecutive, RunCountStaysPerRegistrationIndex) {
+    scheduler->addTask(slowTask, 25);  // index 0
+    scheduler->addTask(fastTask, 10);  // index 1, but top of the heap
+
+    advanceAndRunMs(50);
+
+    LONGS_EQUAL(2, scheduler->getTaskRunCount(0));
+    LONGS_EQUAL(5, scheduler->getTaskRunCount(1));
+}
+
+TEST(CyclicExecutive, RunsOnceAfterStallInsteadOfCatchingUp) {
+    scheduler->addTask(fastTask, 1);
+
+    advanceTimeMs(100);
+    scheduler->run();  // 100 releases missed: one run, not 100 back to back
+
+    LONGS_EQUAL(1, fastTask->getCount());
+    LONGS_EQUAL(1, scheduler->getTimeToNextDeadlineMs());
+}
+
+TEST(CyclicExecutive, KeepsGridAfterSkippingReleases) {
+    scheduler->addTask(fastTask, 10);
+
+    advanceTimeMs(37);
+    scheduler->run();  // Released at 10, 20 and 30: runs once
+    LONGS_EQUAL(1, fastTask->getCount());
+    LONGS_EQUAL(40, scheduler->getNextDeadlineMs());
+}
+
+// ============================================================================
+// Instrumentation Tests
+// ============================================================================
+
+namespace {
+
+// Fake cycle counter the test controls
+struct FakeCycleCounter {
+    static constexpr bool ENABLED = true;
+    static uint32_t ticks;
+    static uint32_t now() { return ticks; }
+};
+uint32_t FakeCycleCounter::ticks = 0;
+
+using InstrumentedExecutive = CyclicExecutive<4, FakeCycleCounter>;
+
+// Task that "takes" a configurable number of counter ticks and scheduler ms
+class BusyTask : public ITask {
+public:
+    BusyTask(InstrumentedExecutive& scheduler) : scheduler_(scheduler), costTicks_(0), costMs_(0) {}
+
+    void run() override {
+        FakeCycleCounter::ticks += costTicks_;
+        for (uint32_t i = 0; i < costMs_; i++) {
+            scheduler_.tick();
+        }
+    }
+    const char* getName() const override { return "busy"; }
+
+    void setCost(uint32_t ticks, uint32_t ms = 0) { costTicks_ = ticks; costMs_ = ms; }
+
+private:
+    InstrumentedExecutive& scheduler_;
+    uint32_t costTicks_;
+    uint32_t costMs_;
+};
+
+}  // namespace
+
+TEST_GROUP(CyclicExecutiveStats) {
+    InstrumentedExecutive* scheduler;
+    BusyTask* task;
+
+    void setup() {
+        FakeCycleCounter::ticks = 0;
+        scheduler = new InstrumentedExecutive();
+        task = new BusyTask(*scheduler);
+    }
+
+    void teardown() {
+        delete task;
+        delete scheduler;
+    }
+
+    void advanceTimeMs(uint32_t ms) {
+        for (uint32_t i = 0; i < ms; i++) {
+            scheduler->tick();
+        }
+    }
+};
+
+TEST(CyclicExecutiveStats, DisabledInstrumentationAddsNoStorage) {
+    LONGS_EQUAL(sizeof(CyclicExecutive<8>), sizeof(CyclicExecutive<8, NoCycleCounter>));
+    CHECK_TRUE(sizeof(CyclicExecutive<8>) < sizeof(CyclicExecutive<8, FakeCycleCounter>));
+}
+
+TEST(CyclicExecutiveStats, RecordsMinMaxAvgExecutionTime) {
+    scheduler->addTask(task, 10);
+
+    task->setCost(100);
+    advanceTimeMs(10);
+    scheduler->run();
+    task->setCost(300);
+    advanceTimeMs(10);
+    scheduler->run();
+
+    TaskStats stats = scheduler->getTaskStats(0);
+    LONGS_EQUAL(2, stats.samples);
+    LONGS_EQUAL(100, stats.minExecTicks);
+    LONGS_EQUAL(300, stats.maxExecTicks);
+    LONGS_EQUAL(200, stats.avgExecTicks);
+}
+
+TEST(CyclicExecutiveStats, RecordsReleaseJitter) {
+    scheduler->addTask(task, 10);
+
+    advanceTimeMs(10);
+    scheduler->run();  // On time
+    advanceTimeMs(13);
+    scheduler->run();  // Due at 20, runs at 23
+
+    TaskStats stats = scheduler->getTaskStats(0);
+    LONGS_EQUAL(0, stats.minReleaseDelayMs);
+    LONGS_EQUAL(3, stats.maxReleaseDelayMs);
+    LONGS_EQUAL(3, stats.releaseJitterMs());
+}
+
+TEST(CyclicExecutiveStats, CountsDeadlineOverrun) {
+    scheduler->addTask(task, 10);
+
+    task->setCost(0, 4);
+    advanceTimeMs(10);
+    scheduler->run();  // Finishes at 14, next release at 20: OK
+    LONGS_EQUAL(0, scheduler->getTaskStats(0).overrunCount);
+
+    advanceTimeMs(6);
+    task->setCost(0, 12);
+    scheduler->run();  // Finishes at 32, next release at 30: overrun
+    LONGS_EQUAL(1, scheduler->getTaskStats(0).overrunCount);
+}
+
+TEST(CyclicExecutiveStats, CountsSkippedReleasesAsOverruns) {
+    scheduler->addTask(task, 10);
+
+    advanceTimeMs(45);
+    scheduler->run();  // Released at 10, runs once; 20, 30, 40 skipped
+
+    TaskStats stats = scheduler->getTaskStats(0);
+    LONGS_EQUAL(1, stats.samples);
+    LONGS_EQUAL(3, stats.overrunCount);
+    LONGS_EQUAL(50, scheduler->getNextDeadlineMs());
+}
+
+TEST(CyclicExecutiveStats, UninstrumentedStatsAreZero) {
+    CyclicExecutive<2> plain;
+    CounterTask counter("c");
+    plain.addTask(&counter, 1);
+    plain.tick();
+    plain.run();
+
+    LONGS_EQUAL(0, plain.getTaskStats(0).samples);
+    LONGS_EQUAL(0, plain.getTaskStats(0).maxExecTicks);
+}
+
 // ============================================================================
 // TimeSlotScheduler Tests
 // ============================================================================
@@ -168,6 +403,812 @@ TEST(TimeSlotScheduler, DifferentTasksInDifferentSlots) {
     LONGS_EQUAL(1, taskB->getCount());
 }
 
+// ============================================================================
+// StaticTimeSlotScheduler Tests
+// ============================================================================
+
+namespace {
+
+struct SensorTask {
+    static constexpr uint32_t WCET_US = 2000;
+    static int count;
+    static void run() { count++; }
+};
+int SensorTask::count = 0;
+
+struct ReportTask {
+    static constexpr uint32_t WCET_US = 5000;
+    static int count;
+    static void run() { count++; }
+};
+int ReportTask::count = 0;
+
+CounterTask staticCounter("static");
+
+using StaticSchedule = StaticTimeSlotScheduler<10, 2,
+    StaticSlot<SensorTask, TaskRef<staticCounter>>,  // slot 0
+    StaticSlot<SensorTask>,                          // slot 1
+    StaticSlot<SensorTask, ReportTask>>;             // slot 2
+
+}  // namespace
+
+TEST_GROUP(StaticTimeSlotScheduler) {
+    StaticSchedule scheduler;
+
+    void setup() {
+        SensorTask::count = 0;
+        ReportTask::count = 0;
+        staticCounter.reset();
+    }
+
+    void runSlots(int n) {
+        for (int i = 0; i < n; i++) {
+            for (int ms = 0; ms < 10; ms++) {
+                scheduler.tick();
+            }
+            scheduler.run();
+        }
+    }
+};
+
+TEST(StaticTimeSlotScheduler, SlotCountFollowsDeclaration) {
+    LONGS_EQUAL(3, StaticSchedule::SLOTS_PER_CYCLE);
+}
+
+TEST(StaticTimeSlotScheduler, RunsDeclaredTasksPerSlot) {
+    runSlots(3);  // One major cycle
+
+    LONGS_EQUAL(3, SensorTask::count);
+    LONGS_EQUAL(1, ReportTask::count);
+    LONGS_EQUAL(1, staticCounter.getCount());
+    LONGS_EQUAL(0, scheduler.getCurrentSlot());
+}
+
+TEST(StaticTimeSlotScheduler, WaitsForSlotBoundary) {
+    for (int ms = 0; ms < 9; ms++) {
+        scheduler.tick();
+    }
+    scheduler.run();
+
+    LONGS_EQUAL(0, SensorTask::count);
+}
+
+TEST(StaticTimeSlotScheduler, LateRunDoesNotShiftTheGrid) {
+    for (int ms = 0; ms < 13; ms++) {
+        scheduler.tick();
+    }
+    scheduler.run();  // Slot 0 was due at 10, runs at 13
+    LONGS_EQUAL(1, SensorTask::count);
+
+    for (int ms = 0; ms < 7; ms++) {
+        scheduler.tick();
+    }
+    scheduler.run();  // Slot 1 is due at 20, not 23
+    LONGS_EQUAL(2, SensorTask::count);
+    LONGS_EQUAL(0, scheduler.getLateStartCount());
+}
+
+TEST(StaticTimeSlotScheduler, CountsLateStartsAndResyncsAfterALongStall) {
+    for (int ms = 0; ms < 25; ms++) {
+        scheduler.tick();
+    }
+    scheduler.run();  // Slot 0 was due at 10: 15ms late
+    LONGS_EQUAL(1, scheduler.getLateStartCount());
+
+    for (int ms = 0; ms < 100; ms++) {
+        scheduler.tick();
+    }
+    scheduler.run();  // More than a major cycle (30ms) behind
+    LONGS_EQUAL(1, scheduler.getResyncCount());
+    LONGS_EQUAL(2, SensorTask::count);  // Once, not once per missed slot
+
+    runSlots(1);
+    LONGS_EQUAL(1, scheduler.getLateStartCount());  // Back on a grid
+    LONGS_EQUAL(3, SensorTask::count);
+}
+
+TEST(StaticTimeSlotScheduler, ComputesUtilizationFromDeclaredWcet) {
+    // (2 + 2 + 7) ms of work in 30ms = 366 permille
+    LONGS_EQUAL(366, StaticSchedule::utilizationPermille());
+    LONGS_EQUAL(7000, (StaticSlot<SensorTask, ReportTask>::WCET_US));
+}
+
+// ============================================================================
+// PreemptiveKernel Tests
+// ============================================================================
+
+namespace {
+
+using Kernel = PreemptiveKernel<8>;
+
+// Records the order in which tasks start and finish
+struct ExecutionLog {
+    char entries[16];
+    int count = 0;
+    void add(char c) { if (count < 16) entries[count++] = c; }
+    bool equals(const char* expected) const {
+        int i = 0;
+        for (; expected[i] != '\0'; i++) {
+            if (i >= count || entries[i] != expected[i]) return false;
+        }
+        return i == count;
+    }
+};
+
+// Logs start (upper case) and end (lower case); optionally activates or "interrupts"
+class LoggingTask : public ITask {
+public:
+    LoggingTask(char id, ExecutionLog& log, Kernel& kernel)
+        : id_(id), log_(log), kernel_(kernel), activateOnRun_(0), fromIsr_(false) {}
+
+    void run() override {
+        log_.add(id_);
+        if (activateOnRun_ != 0) {
+            if (fromIsr_) {
+                Kernel::Priority saved = kernel_.isrEnter();
+                kernel_.activate(activateOnRun_);
+                log_.add('!');  // Still inside the ISR
+                kernel_.isrExit(saved);
+            } else {
+                kernel_.activate(activateOnRun_);
+            }
+        }
+        log_.add(static_cast<char>(id_ + ('a' - 'A')));
+    }
+    const char* getName() const override { return "log"; }
+
+    void activatesOnRun(Kernel::Priority priority, bool fromIsr = false) {
+        activateOnRun_ = priority;
+        fromIsr_ = fromIsr;
+    }
+
+private:
+    char id_;
+    ExecutionLog& log_;
+    Kernel& kernel_;
+    Kernel::Priority activateOnRun_;
+    bool fromIsr_;
+};
+
+}  // namespace
+
+TEST_GROUP(PreemptiveKernel) {
+    Kernel kernel;
+    ExecutionLog log;
+};
+
+TEST(PreemptiveKernel, RejectsIdleAndDuplicatePriorities) {
+    LoggingTask task('A', log, kernel);
+
+    CHECK_FALSE(kernel.addTask(&task, Kernel::IDLE_PRIORITY));
+    CHECK_FALSE(kernel.addTask(&task, 9));
+    CHECK_TRUE(kernel.addTask(&task, 3));
+    CHECK_FALSE(kernel.addTask(&task, 3));
+}
+
+TEST(PreemptiveKernel, ActivationFromBackgroundRunsImmediately) {
+    LoggingTask task('A', log, kernel);
+    kernel.addTask(&task, 1);
+
+    kernel.activate(1);
+
+    CHECK_TRUE(log.equals("Aa"));
+    LONGS_EQUAL(Kernel::IDLE_PRIORITY, kernel.getCurrentPriority());
+}
+
+TEST(PreemptiveKernel, HigherPriorityPreemptsLower) {
+    LoggingTask low('L', log, kernel);
+    LoggingTask high('H', log, kernel);
+    kernel.addTask(&low, 1);
+    kernel.addTask(&high, 5);
+    low.activatesOnRun(5);
+
+    kernel.activate(1);
+
+    CHECK_TRUE(log.equals("LHhl"));  // High runs to completion inside low
+}
+
+TEST(PreemptiveKernel, LowerPriorityWaitsForCompletion) {
+    LoggingTask low('L', log, kernel);
+    LoggingTask high('H', log, kernel);
+    kernel.addTask(&low, 1);
+    kernel.addTask(&high, 5);
+    high.activatesOnRun(1);
+
+    kernel.activate(5);
+
+    CHECK_TRUE(log.equals("HhLl"));
+}
+
+TEST(PreemptiveKernel, IsrActivationRunsOnIsrExit) {
+    LoggingTask low('L', log, kernel);
+    LoggingTask high('H', log, kernel);
+    kernel.addTask(&low, 1);
+    kernel.addTask(&high, 5);
+    low.activatesOnRun(5, true);
+
+    kernel.activate(1);
+
+    CHECK_TRUE(log.equals("L!Hhl"));  // Not inside the ISR, but before low resumes
+}
+
+namespace {
+
+// Stands in for PendSV: isrExit() only records the request
+struct FakePendedDispatch {
+    static constexpr bool DEFERRED = true;
+    static int pendCount;
+    static void pend() { pendCount++; }
+};
+int FakePendedDispatch::pendCount = 0;
+
+using PendedKernel = PreemptiveKernel<8, NoInterruptLock, FakePendedDispatch>;
+
+// Activates a priority from an "ISR" and logs where it is
+class IsrTask : public ITask {
+public:
+    IsrTask(char id, ExecutionLog& log, PendedKernel& kernel, PendedKernel::Priority activates)
+        : id_(id), log_(log), kernel_(kernel), activates_(activates) {}
+
+    void run() override {
+        log_.add(id_);
+        if (activates_ != 0) {
+            PendedKernel::Priority saved = kernel_.isrEnter();
+            kernel_.activate(activates_);
+            kernel_.isrExit(saved);
+            log_.add('!');  // After the ISR, before the pended dispatch
+        }
+        log_.add(static_cast<char>(id_ + ('a' - 'A')));
+    }
+    const char* getName() const override { return "isr"; }
+
+private:
+    char id_;
+    ExecutionLog& log_;
+    PendedKernel& kernel_;
+    PendedKernel::Priority activates_;
+};
+
+}  // namespace
+
+TEST_GROUP(PreemptiveKernelPended) {
+    PendedKernel kernel;
+    ExecutionLog log;
+
+    void setup() { FakePendedDispatch::pendCount = 0; }
+};
+
+TEST(PreemptiveKernelPended, IsrExitPendsInsteadOfRunning) {
+    IsrTask high('H', log, kernel, 0);
+    kernel.addTask(&high, 5);
+
+    PendedKernel::Priority saved = kernel.isrEnter();
+    kernel.activate(5);
+    kernel.isrExit(saved);
+
+    LONGS_EQUAL(1, FakePendedDispatch::pendCount);
+    CHECK_TRUE(kernel.isReady(5));
+    LONGS_EQUAL(0, log.count);  // Nothing ran in the ISR
+
+    kernel.runPended();  // PendSV_Handler
+    CHECK_TRUE(log.equals("Hh"));
+    CHECK_FALSE(kernel.isReady(5));
+}
+
+TEST(PreemptiveKernelPended, NestedIsrLeavesThePendToTheOuterOne) {
+    IsrTask high('H', log, kernel, 0);
+    kernel.addTask(&high, 5);
+
+    PendedKernel::Priority outer = kernel.isrEnter();
+    PendedKernel::Priority inner = kernel.isrEnter();
+    kernel.activate(5);
+    kernel.isrExit(inner);
+    LONGS_EQUAL(0, FakePendedDispatch::pendCount);
+    kernel.isrExit(outer);
+
+    LONGS_EQUAL(1, FakePendedDispatch::pendCount);
+}
+
+TEST(PreemptiveKernelPended, NoPendForWorkThatDoesNotOutrank) {
+    IsrTask low('L', log, kernel, 1);
+    IsrTask lowest('M', log, kernel, 0);
+    kernel.addTask(&low, 3);
+    kernel.addTask(&lowest, 1);
+
+    kernel.activate(3);  // Low activates priority 1 from an ISR while it runs
+
+    LONGS_EQUAL(0, FakePendedDispatch::pendCount);
+    CHECK_TRUE(log.equals("L!lMm"));  // Priority 1 ran when low completed
+}
+
+// ============================================================================
+// Tickless Mode Tests
+// ============================================================================
+
+namespace {
+
+// Pretends to sleep: records the requested time and "sleeps" all of it
+struct FakeTicklessPolicy {
+    static constexpr bool TICKLESS = true;
+    static constexpr uint32_t MAX_SLEEP_MS = 1000;
+    static uint32_t lastRequestMs;
+    static uint32_t wakeEarlyAfterMs;  // 0 = sleep the full request
+
+    static uint32_t sleepFor(uint32_t ms) {
+        lastRequestMs = ms;
+        if (wakeEarlyAfterMs != 0 && wakeEarlyAfterMs < ms) return wakeEarlyAfterMs;
+        return ms;
+    }
+};
+uint32_t FakeTicklessPolicy::lastRequestMs = 0;
+uint32_t FakeTicklessPolicy::wakeEarlyAfterMs = 0;
+
+}  // namespace
+
+TEST_GROUP(Tickless) {
+    CounterTask* taskA;
+    CounterTask* taskB;
+
+    void setup() {
+        FakeTicklessPolicy::lastRequestMs = 0;
+        FakeTicklessPolicy::wakeEarlyAfterMs = 0;
+        taskA = new CounterTask("A");
+        taskB = new CounterTask("B");
+    }
+
+    void teardown() {
+        delete taskB;
+        delete taskA;
+    }
+};
+
+TEST(Tickless, ExecutiveSleepsUntilNextTask) {
+    CyclicExecutive<4, NoCycleCounter, FakeTicklessPolicy> scheduler;
+    scheduler.addTask(taskA, 100);
+
+    scheduler.run();
+    scheduler.sleepUntilNextDeadline();
+
+    LONGS_EQUAL(100, FakeTicklessPolicy::lastRequestMs);
+    LONGS_EQUAL(100, scheduler.getCurrentTimeMs());
+
+    scheduler.run();
+    LONGS_EQUAL(1, taskA->getCount());
+}
+
+TEST(Tickless, ExecutiveCatchesUpOnEarlyWake) {
+    CyclicExecutive<4, NoCycleCounter, FakeTicklessPolicy> scheduler;
+    scheduler.addTask(taskA, 100);
+    FakeTicklessPolicy::wakeEarlyAfterMs = 30;
+
+    scheduler.sleepUntilNextDeadline();
+    scheduler.run();
+
+    LONGS_EQUAL(30, scheduler.getCurrentTimeMs());
+    LONGS_EQUAL(0, taskA->getCount());
+    LONGS_EQUAL(70, scheduler.getTimeToNextDeadlineMs());
+}
+
+TEST(Tickless, ExecutiveClampsToMaxSleep) {
+    CyclicExecutive<4, NoCycleCounter, FakeTicklessPolicy> scheduler;
+    scheduler.addTask(taskA, 5000);
+
+    scheduler.sleepUntilNextDeadline();
+
+    LONGS_EQUAL(FakeTicklessPolicy::MAX_SLEEP_MS, FakeTicklessPolicy::lastRequestMs);
+}
+
+TEST(Tickless, PeriodicPolicyDoesNotTouchTheClock) {
+    CyclicExecutive<4> scheduler;
+    scheduler.addTask(taskA, 100);
+
+    scheduler.sleepUntilNextDeadline();
+
+    LONGS_EQUAL(0, scheduler.getCurrentTimeMs());
+}
+
+TEST(Tickless, SlotSchedulerSkipsEmptySlots) {
+    TimeSlotScheduler<4, 4, FakeTicklessPolicy> scheduler(10);
+    scheduler.addTaskToSlot(2, taskA);
+
+    LONGS_EQUAL(30, scheduler.getTimeToNextDeadlineMs());  // Boundary at 10, slots 0 and 1 empty
+
+    scheduler.sleepUntilNextDeadline();
+    LONGS_EQUAL(30, FakeTicklessPolicy::lastRequestMs);
+    LONGS_EQUAL(2, scheduler.getCurrentSlot());
+
+    scheduler.run();
+    LONGS_EQUAL(1, taskA->getCount());
+    LONGS_EQUAL(3, scheduler.getCurrentSlot());
+}
+
+TEST(Tickless, SlotSchedulerWakesEveryCycle) {
+    TimeSlotScheduler<4, 4, FakeTicklessPolicy> scheduler(10);
+    scheduler.addTaskToSlot(0, taskA);
+
+    for (int cycle = 0; cycle < 3; cycle++) {
+        scheduler.sleepUntilNextDeadline();
+        scheduler.run();
+    }
+
+    LONGS_EQUAL(3, taskA->getCount());
+    LONGS_EQUAL(1, scheduler.getCurrentSlot());
+}
+
+TEST(Tickless, SlotSchedulerWithNoTasksHasNoDeadline) {
+    TimeSlotScheduler<4, 4, FakeTicklessPolicy> scheduler(10);
+
+    UNSIGNED_LONGS_EQUAL(UINT32_MAX, scheduler.getTimeToNextDeadlineMs());
+}
+
+// ============================================================================
+// Tracing Tests
+// ============================================================================
+
+namespace {
+
+// Records the tracer calls as text: "T+0" task 0 begins, "S-1" slot 1 ends
+struct RecordingTracer {
+    static std::string log;
+    static void add(char what, char edge, size_t index) {
+        if (!log.empty()) log += ' ';
+        log += what;
+        log += edge;
+        log += std::to_string(index);
+    }
+    static void taskBegin(size_t task) { add('T', '+', task); }
+    static void taskEnd(size_t task) { add('T', '-', task); }
+    static void slotBegin(size_t slot) { add('S', '+', slot); }
+    static void slotEnd(size_t slot) { add('S', '-', slot); }
+};
+std::string RecordingTracer::log;
+
+}  // namespace
+
+TEST_GROUP(Tracing) {
+    CounterTask* fastTask;
+    CounterTask* slowTask;
+
+    void setup() {
+        RecordingTracer::log.clear();
+        fastTask = new CounterTask("fast");
+        slowTask = new CounterTask("slow");
+    }
+
+    void teardown() {
+        delete slowTask;
+        delete fastTask;
+    }
+};
+
+TEST(Tracing, ExecutiveTracesEveryTaskRunInDeadlineOrder) {
+    CyclicExecutive<4, NoCycleCounter, PeriodicTickPolicy, RecordingTracer> scheduler;
+    scheduler.addTask(slowTask, 20);
+    scheduler.addTask(fastTask, 10);
+
+    scheduler.setTimeMs(20);
+    scheduler.run();  // fast (due at 10) first; its release at 20 is skipped
+
+    STRCMP_EQUAL("T+1 T-1 T+0 T-0", RecordingTracer::log.c_str());
+}
+
+TEST(Tracing, ExecutiveDoesNotTraceSkippedTasks) {
+    CyclicExecutive<4, NoCycleCounter, PeriodicTickPolicy, RecordingTracer> scheduler;
+    scheduler.addTask(fastTask, 10);
+    scheduler.setTaskEnabled(0, false);
+
+    scheduler.setTimeMs(10);
+    scheduler.run();
+
+    STRCMP_EQUAL("", RecordingTracer::log.c_str());
+}
+
+TEST(Tracing, SlotSchedulerTracesSlotsAndTheirTasks) {
+    TimeSlotScheduler<2, 4, PeriodicTickPolicy, RecordingTracer> scheduler(10);
+    scheduler.addTaskToSlot(0, fastTask);
+    scheduler.addTaskToSlot(0, slowTask);
+    scheduler.addTaskToSlot(1, fastTask);
+
+    for (int ms = 0; ms < 20; ms++) {
+        scheduler.tick();
+        scheduler.run();
+    }
+
+    STRCMP_EQUAL("S+0 T+0 T-0 T+1 T-1 S-0 S+1 T+0 T-0 S-1", RecordingTracer::log.c_str());
+}
+
+TEST(Tracing, TracerAddsNoStorage) {
+    LONGS_EQUAL(sizeof(CyclicExecutive<8>),
+                sizeof(CyclicExecutive<8, NoCycleCounter, PeriodicTickPolicy, RecordingTracer>));
+}
+
+// ============================================================================
+// Background Task Tests
+// ============================================================================
+
+namespace {
+
+// A job of 'remaining' chunks; every chunk lets 'msPerChunk' pass on the clock
+template<typename Scheduler>
+class ChunkedJob : public IBackgroundTask {
+public:
+    ChunkedJob(Scheduler& clock, int remaining, uint32_t msPerChunk)
+        : clock_(clock), remaining_(remaining), msPerChunk_(msPerChunk), chunks_(0) {}
+
+    bool runChunk() override {
+        for (uint32_t i = 0; i < msPerChunk_; i++) clock_.tick();
+        chunks_++;
+        return --remaining_ > 0;
+    }
+
+    void addWork(int chunks) { remaining_ += chunks; }
+    int getChunks() const { return chunks_; }
+
+private:
+    Scheduler& clock_;
+    int remaining_;
+    uint32_t msPerChunk_;
+    int chunks_;
+};
+
+}  // namespace
+
+TEST_GROUP(BackgroundTask) {
+    CounterTask* task;
+
+    void setup() { task = new CounterTask("periodic"); }
+    void teardown() { delete task; }
+};
+
+TEST(BackgroundTask, UsesTheBudgetWhenNothingIsDue) {
+    CyclicExecutive<4> scheduler;
+    scheduler.addTask(task, 100);
+    ChunkedJob<CyclicExecutive<4>> job(scheduler, 100, 0);
+    scheduler.setBackgroundTask(&job, 4);
+
+    scheduler.run();
+    LONGS_EQUAL(4, job.getChunks());
+    scheduler.run();
+    LONGS_EQUAL(8, job.getChunks());
+    UNSIGNED_LONGS_EQUAL(8, scheduler.getBackgroundChunkCount());
+}
+
+TEST(BackgroundTask, YieldsAsSoonAsAPeriodicTaskIsDue) {
+    CyclicExecutive<4> scheduler;
+    scheduler.addTask(task, 10);
+    ChunkedJob<CyclicExecutive<4>> job(scheduler, 100, 3);
+    scheduler.setBackgroundTask(&job, 8);
+
+    scheduler.run();  // Chunks end at 3, 6, 9, 12: the task is due since 10
+    LONGS_EQUAL(4, job.getChunks());
+    LONGS_EQUAL(0, task->getCount());
+
+    scheduler.run();  // Released late by less than one chunk
+    LONGS_EQUAL(1, task->getCount());
+}
+
+TEST(BackgroundTask, FinishedJobRestsUntilWoken) {
+    CyclicExecutive<4> scheduler;
+    scheduler.addTask(task, 100);
+    ChunkedJob<CyclicExecutive<4>> job(scheduler, 2, 0);
+    scheduler.setBackgroundTask(&job, 8);
+
+    scheduler.run();
+    scheduler.run();
+    LONGS_EQUAL(2, job.getChunks());
+
+    job.addWork(1);
+    scheduler.wakeBackgroundTask();
+    scheduler.run();
+    LONGS_EQUAL(3, job.getChunks());
+}
+
+TEST(BackgroundTask, TicklessDoesNotSleepWithPendingWork) {
+    CyclicExecutive<4, NoCycleCounter, FakeTicklessPolicy> scheduler;
+    scheduler.addTask(task, 100);
+    ChunkedJob<CyclicExecutive<4, NoCycleCounter, FakeTicklessPolicy>> job(scheduler, 3, 0);
+    scheduler.setBackgroundTask(&job, 2);
+    FakeTicklessPolicy::lastRequestMs = 0;
+
+    scheduler.run();
+    scheduler.sleepUntilNextDeadline();
+    LONGS_EQUAL(0, FakeTicklessPolicy::lastRequestMs);
+
+    scheduler.run();  // Last chunk: done
+    scheduler.sleepUntilNextDeadline();
+    LONGS_EQUAL(100, FakeTicklessPolicy::lastRequestMs);
+}
+
+TEST(BackgroundTask, SlotSchedulerUsesTheRestOfTheSlot) {
+    TimeSlotScheduler<2, 4> scheduler(10);
+    scheduler.addTaskToSlot(0, task);
+    ChunkedJob<TimeSlotScheduler<2, 4>> job(scheduler, 100, 4);
+    scheduler.setBackgroundTask(&job, 8);
+
+    for (int i = 0; i < 10; i++) scheduler.tick();
+    scheduler.run();  // Slot 0 runs at 10, chunks end at 14, 18, 22
+    LONGS_EQUAL(1, task->getCount());
+    LONGS_EQUAL(3, job.getChunks());
+    LONGS_EQUAL(1, scheduler.getCurrentSlot());
+}
+
+// ============================================================================
+// Slot Budget and Slack Tests
+// ============================================================================
+
+namespace {
+
+using SlotScheduler = TimeSlotScheduler<4, 4>;
+
+// Lets 'busyMs' pass on the scheduler clock while it runs
+class SlotBusyTask : public ITask {
+public:
+    SlotBusyTask(SlotScheduler& clock, uint32_t busyMs) : clock_(clock), busyMs_(busyMs), count_(0) {}
+
+    void run() override {
+        for (uint32_t i = 0; i < busyMs_; i++) clock_.tick();
+        count_++;
+    }
+    const char* getName() const override { return "busy"; }
+
+    void setBusyMs(uint32_t busyMs) { busyMs_ = busyMs; }
+    int getCount() const { return count_; }
+
+private:
+    SlotScheduler& clock_;
+    uint32_t busyMs_;
+    int count_;
+};
+
+}  // namespace
+
+TEST_GROUP(SlotBudget) {
+    SlotScheduler* scheduler;
+    SlotBusyTask* busy;
+    CounterTask* sporadic;
+
+    void setup() {
+        scheduler = new SlotScheduler(10);
+        busy = new SlotBusyTask(*scheduler, 2);
+        sporadic = new CounterTask("sporadic");
+    }
+
+    void teardown() {
+        delete sporadic;
+        delete busy;
+        delete scheduler;
+    }
+
+    void runFor(uint32_t ms) {
+        for (uint32_t i = 0; i < ms; i++) {
+            scheduler->tick();
+            scheduler->run();
+        }
+    }
+};
+
+TEST(SlotBudget, RecordsUsedTimeWithoutOverrun) {
+    scheduler->addTaskToSlot(0, busy);
+    runFor(10);
+
+    SlotStats stats = scheduler->getSlotStats(0);
+    LONGS_EQUAL(1, stats.runs);
+    LONGS_EQUAL(2, stats.maxUsedMs);
+    LONGS_EQUAL(0, stats.overruns);
+    LONGS_EQUAL(10, stats.budgetMs);
+}
+
+TEST(SlotBudget, CountsAnOverrunPerSlot) {
+    scheduler->addTaskToSlot(1, busy);
+    busy->setBusyMs(12);
+    runFor(20);  // Slot 1 starts at 20 and takes 12ms
+
+    LONGS_EQUAL(0, scheduler->getSlotStats(0).overruns);
+    LONGS_EQUAL(1, scheduler->getSlotStats(1).overruns);
+    LONGS_EQUAL(1, scheduler->getOverrunCount());
+}
+
+TEST(SlotBudget, TighterBudgetFlagsEarlier) {
+    scheduler->addTaskToSlot(0, busy);
+    CHECK_TRUE(scheduler->setSlotBudgetMs(0, 2));
+    CHECK_FALSE(scheduler->setSlotBudgetMs(0, 11));  // Beyond the slot
+    CHECK_FALSE(scheduler->setSlotBudgetMs(4, 5));
+
+    runFor(10);
+    LONGS_EQUAL(1, scheduler->getSlotStats(0).overruns);
+}
+
+TEST(SlotBudget, OverrunDoesNotShiftTheGrid) {
+    scheduler->addTaskToSlot(0, busy);
+    busy->setBusyMs(13);
+    runFor(10);  // Slot 0 from 10 to 23
+
+    // Slot 1 is due at 20 and runs late at 23; slot 2 is still due at 30
+    LONGS_EQUAL(23, scheduler->getCurrentTimeMs());
+    scheduler->run();
+    LONGS_EQUAL(2, scheduler->getCurrentSlot());
+    runFor(6);
+    LONGS_EQUAL(2, scheduler->getCurrentSlot());
+    runFor(1);
+    LONGS_EQUAL(3, scheduler->getCurrentSlot());
+}
+
+TEST(SlotBudget, CountsLateStartsAndResyncsAfterALongStall) {
+    for (int i = 0; i < 25; i++) scheduler->tick();
+    scheduler->run();  // Slot 0 was due at 10: 15ms late
+    LONGS_EQUAL(1, scheduler->getLateStartCount());
+
+    for (int i = 0; i < 100; i++) scheduler->tick();
+    scheduler->run();  // More than a major cycle (40ms) behind
+    LONGS_EQUAL(1, scheduler->getResyncCount());
+
+    runFor(10);
+    LONGS_EQUAL(1, scheduler->getLateStartCount());  // Back on a grid
+}
+
+TEST(SlotBudget, SporadicTasksRunInTheSlack) {
+    scheduler->addTaskToSlot(0, busy);
+    CHECK_TRUE(scheduler->postSporadic(sporadic));
+
+    scheduler->run();  // Slack before the first slot
+    LONGS_EQUAL(1, sporadic->getCount());
+    LONGS_EQUAL(0, scheduler->getSporadicPending());
+}
+
+TEST(SlotBudget, SporadicTasksWaitWhileTheSlotIsOverrun) {
+    scheduler->addTaskToSlot(0, busy);
+    busy->setBusyMs(10);
+    for (int i = 0; i < 9; i++) scheduler->tick();
+    scheduler->postSporadic(sporadic);
+    scheduler->tick();   // 10: slot 0 is due
+
+    scheduler->run();    // Slot 0 runs until 20: no slack left
+    LONGS_EQUAL(0, sporadic->getCount());
+
+    scheduler->run();    // Slot 1 at 20 is empty: slack until 30
+    LONGS_EQUAL(1, sporadic->getCount());
+}
+
+TEST(SlotBudget, SporadicQueueIsBounded) {
+    for (size_t i = 0; i < SlotScheduler::SPORADIC_CAPACITY; i++) {
+        CHECK_TRUE(scheduler->postSporadic(sporadic));
+    }
+    CHECK_FALSE(scheduler->postSporadic(sporadic));
+    LONGS_EQUAL(1, scheduler->getSporadicDroppedCount());
+
+    scheduler->run();
+    LONGS_EQUAL(SlotScheduler::SPORADIC_CAPACITY, sporadic->getCount());
+}
+
+// ============================================================================
+// Performance Budget Tests
+// ============================================================================
+
+TEST_GROUP(RunBudget) {
+    CyclicExecutive<8> one;
+    CyclicExecutive<8> eight;
+    CounterTask tasks[8] = {CounterTask("t0"), CounterTask("t1"), CounterTask("t2"), CounterTask("t3"),
+                            CounterTask("t4"), CounterTask("t5"), CounterTask("t6"), CounterTask("t7")};
+
+    void setup() {
+        // Nothing is due for an hour: every run() is an idle pass
+        one.addTask(&tasks[0], 3600000);
+        for (CounterTask& task : tasks) {
+            eight.addTask(&task, 3600000);
+        }
+    }
+};
+
+TEST(RunBudget, IdlePassWithEightTasksStaysSmall) {
+    // About 35 instructions with -O2 and 140 without optimisation
+    CHECK_INSTRUCTION_BUDGET(250, [this]() { eight.run(); });
+    LONGS_EQUAL(0, tasks[7].getCount());
+}
+
+TEST(RunBudget, IdlePassDoesNotGrowWithTheTaskCount) {
+    CHECK_CONSTANT_COST([this]() { one.run(); }, [this]() { eight.run(); });
+}
+
 // ============================================================================
 // Workshop Discussion
 // ============================================================================
@@ -0,0 +1,177 @@
+#include "CppUTest/TestHarness.h"
+#include "MultiCoreExecutive.hpp"
+
+#include <thread>
+
+using namespace cyclic_executive;
+
+namespace {
+
+/**
+ * Two cores on the host; the test says which one is running
+ */
+struct FakeDualCore {
+    static constexpr size_t COUNT = 2;
+    static size_t running;
+    static size_t current() { return running; }
+};
+size_t FakeDualCore::running = 0;
+
+/**
+ * Counts rings per core
+ */
+struct CountingDoorbell {
+    static int rings[2];
+    static void ring(size_t core) { rings[core]++; }
+    static bool take() { return false; }
+};
+int CountingDoorbell::rings[2] = {0, 0};
+
+struct Sample {
+    uint32_t sequence;
+    int16_t value;
+};
+
+} // namespace
+
+// ============================================================================
+// MultiCoreExecutive Tests
+// ============================================================================
+
+TEST_GROUP(MultiCoreExecutive) {
+    MultiCoreExecutive<FakeDualCore, 4>* executive;
+    CounterTask* acquisition;
+    CounterTask* logging;
+
+    void setup() {
+        executive = new MultiCoreExecutive<FakeDualCore, 4>();
+        acquisition = new CounterTask("acquisition");
+        logging = new CounterTask("logging");
+        FakeDualCore::running = 0;
+    }
+
+    void teardown() {
+        delete logging;
+        delete acquisition;
+        delete executive;
+    }
+};
+
+TEST(MultiCoreExecutive, TasksRunOnlyOnTheirCore) {
+    CHECK_TRUE(executive->addTask(acquisition, 1, 0));
+    CHECK_TRUE(executive->addTask(logging, 1, 1));
+
+    executive->tickAll();
+    executive->run(0);
+    LONGS_EQUAL(1, acquisition->getCount());
+    LONGS_EQUAL(0, logging->getCount());
+
+    executive->run(1);
+    LONGS_EQUAL(1, logging->getCount());
+}
+
+TEST(MultiCoreExecutive, RunCurrentCoreUsesTheCorePolicy) {
+    executive->addTask(acquisition, 1, 0);
+    executive->addTask(logging, 1, 1);
+    executive->tickAll();
+
+    FakeDualCore::running = 1;
+    executive->runCurrentCore();
+    LONGS_EQUAL(0, acquisition->getCount());
+    LONGS_EQUAL(1, logging->getCount());
+}
+
+TEST(MultiCoreExecutive, CoresKeepTheirOwnClock) {
+    executive->addTask(acquisition, 10, 0);
+    executive->addTask(logging, 10, 1);
+
+    for (int i = 0; i < 10; i++) executive->tick(0);
+    executive->run(0);
+    executive->run(1);
+
+    LONGS_EQUAL(1, acquisition->getCount());
+    LONGS_EQUAL(0, logging->getCount());
+    LONGS_EQUAL(10, executive->executive(0).getCurrentTimeMs());
+    LONGS_EQUAL(0, executive->executive(1).getCurrentTimeMs());
+}
+
+TEST(MultiCoreExecutive, RejectsUnknownCoreAndFullTable) {
+    CHECK_FALSE(executive->addTask(acquisition, 1, 2));
+
+    CounterTask extra("extra");
+    for (int i = 0; i < 4; i++) {
+        CHECK_TRUE(executive->addTask(&extra, 1, 1));
+    }
+    CHECK_FALSE(executive->addTask(&extra, 1, 1));
+    CHECK_TRUE(executive->addTask(&extra, 1, 0));  // Other core has room
+    LONGS_EQUAL(5, executive->getTaskCount());
+}
+
+// ============================================================================
+// CoreMailbox Tests
+// ============================================================================
+
+TEST_GROUP(CoreMailbox) {
+    void setup() {
+        CountingDoorbell::rings[0] = 0;
+        CountingDoorbell::rings[1] = 0;
+    }
+};
+
+TEST(CoreMailbox, DeliversInOrder) {
+    CoreMailbox<Sample, 4, NoDoorbell> mailbox;
+    mailbox.post({1, 100});
+    mailbox.post({2, 200});
+
+    Sample sample{};
+    CHECK_TRUE(mailbox.pop(sample));
+    LONGS_EQUAL(1, sample.sequence);
+    CHECK_TRUE(mailbox.pop(sample));
+    LONGS_EQUAL(200, sample.value);
+    CHECK_FALSE(mailbox.pop(sample));
+}
+
+TEST(CoreMailbox, FullRingDropsAndCounts) {
+    CoreMailbox<Sample, 2, NoDoorbell> mailbox;
+    CHECK_TRUE(mailbox.post({1, 0}));
+    CHECK_TRUE(mailbox.post({2, 0}));
+    CHECK_FALSE(mailbox.post({3, 0}));
+
+    LONGS_EQUAL(1, mailbox.getDroppedCount());
+    LONGS_EQUAL(2, mailbox.size());
+}
+
+TEST(CoreMailbox, RingsTheConsumerCore) {
+    CoreMailbox<Sample, 4, CountingDoorbell> toCore1(1);
+    toCore1.post({1, 0});
+    toCore1.post({2, 0});
+
+    LONGS_EQUAL(0, CountingDoorbell::rings[0]);
+    LONGS_EQUAL(2, CountingDoorbell::rings[1]);
+}
+
+TEST(CoreMailbox, TwoThreadsLoseNothing) {
+    CoreMailbox<Sample, 16, NoDoorbell> mailbox;
+    const uint32_t COUNT = 200000;
+
+    std::thread producer([&mailbox, COUNT]() {
+        for (uint32_t i = 0; i < COUNT;) {
+            if (mailbox.post({i, static_cast<int16_t>(i & 0x7FFF)})) i++;
+        }
+    });
+
+    uint32_t expected = 0;
+    bool inOrder = true;
+    Sample sample{};
+    while (expected < COUNT) {
+        if (mailbox.pop(sample)) {
+            inOrder = inOrder && sample.sequence == expected
+                      && sample.value == static_cast<int16_t>(expected & 0x7FFF);
+            expected++;
+        }
+    }
+    producer.join();
+
+    CHECK_TRUE(inOrder);
+    CHECK_TRUE(mailbox.isEmpty());
+}
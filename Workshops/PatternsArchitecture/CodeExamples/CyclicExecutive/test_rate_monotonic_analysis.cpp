@@ -0,0 +1,230 @@
+#include "CppUTest/TestHarness.h"
+#include "RateMonotonicAnalysis.hpp"
+
+using namespace cyclic_executive;
+
+// ============================================================================
+// RateMonotonicAnalyzer Tests
+// ============================================================================
+
+TEST_GROUP(RateMonotonicAnalyzer) {
+    RateMonotonicAnalyzer<8> rma;
+};
+
+TEST(RateMonotonicAnalyzer, LiuLaylandBoundDecreasesTowardsLn2) {
+    LONGS_EQUAL(1000, liuLaylandBoundPermille(1));
+    LONGS_EQUAL(828, liuLaylandBoundPermille(2));
+    LONGS_EQUAL(779, liuLaylandBoundPermille(3));
+    LONGS_EQUAL(693, liuLaylandBoundPermille(100));
+}
+
+TEST(RateMonotonicAnalyzer, ComputesUtilization) {
+    rma.addTask(10000, 2000);   // 20%
+    rma.addTask(100000, 5000);  // 5%
+
+    SchedulabilityReport report = rma.analyze(Dispatch::PREEMPTIVE);
+
+    LONGS_EQUAL(250, report.utilizationPermille);
+    CHECK_TRUE(report.withinUtilizationBound);
+    CHECK_TRUE(report.isSchedulable());
+}
+
+TEST(RateMonotonicAnalyzer, ExactTestAcceptsSetAboveBound) {
+    // Burns & Wellings: U = 100%, above the bound, yet schedulable
+    rma.addTask(80, 40);
+    rma.addTask(40, 10);
+    rma.addTask(20, 5);
+
+    SchedulabilityReport report = rma.analyze(Dispatch::PREEMPTIVE);
+
+    LONGS_EQUAL(1000, report.utilizationPermille);
+    CHECK_FALSE(report.withinUtilizationBound);
+    CHECK_TRUE(report.isSchedulable());
+    LONGS_EQUAL(80, rma.getResponseTimeUs(0));
+    LONGS_EQUAL(15, rma.getResponseTimeUs(1));
+    LONGS_EQUAL(5, rma.getResponseTimeUs(2));
+}
+
+TEST(RateMonotonicAnalyzer, ReportsTaskThatMissesDeadline) {
+    rma.addTask(50, 12);
+    rma.addTask(40, 10);
+    rma.addTask(30, 10);
+
+    SchedulabilityReport report = rma.analyze(Dispatch::PREEMPTIVE);
+
+    CHECK_FALSE(report.isSchedulable());
+    LONGS_EQUAL(0, report.firstMissIndex);  // Lowest priority task
+    UNSIGNED_LONGS_EQUAL(RateMonotonicAnalyzer<8>::NO_RESPONSE, rma.getResponseTimeUs(0));
+}
+
+TEST(RateMonotonicAnalyzer, NonPreemptiveAccountsForBlocking) {
+    rma.addTask(10000, 2000);   // Fast task
+    rma.addTask(100000, 9000);  // Long report task blocks it
+
+    CHECK_TRUE(rma.analyze(Dispatch::PREEMPTIVE).isSchedulable());
+
+    SchedulabilityReport report = rma.analyze(Dispatch::NON_PREEMPTIVE);
+    CHECK_FALSE(report.isSchedulable());
+    LONGS_EQUAL(0, report.firstMissIndex);
+}
+
+TEST(RateMonotonicAnalyzer, LoadsPeriodsFromExecutive) {
+    CyclicExecutive<4> scheduler;
+    CounterTask fast("fast"), slow("slow");
+    scheduler.addTask(&fast, 10);
+    scheduler.addTask(&slow, 100);
+    const uint32_t WCET_US[] = {1000, 20000};
+
+    CHECK_TRUE(rma.loadDeclared(scheduler, WCET_US));
+    SchedulabilityReport report = rma.analyze();
+
+    LONGS_EQUAL(2, rma.getTaskCount());
+    LONGS_EQUAL(300, report.utilizationPermille);
+    CHECK_FALSE(report.isSchedulable());  // 20ms report task blocks the 10ms task
+}
+
+// ============================================================================
+// OverloadGuard Tests
+// ============================================================================
+
+TEST_GROUP(OverloadGuard) {
+    CyclicExecutive<4>* scheduler;
+    OverloadGuard<CyclicExecutive<4>>* guard;
+    CounterTask* fast;
+    CounterTask* medium;
+    CounterTask* slow;
+
+    void setup() {
+        scheduler = new CyclicExecutive<4>();
+        fast = new CounterTask("fast");
+        medium = new CounterTask("medium");
+        slow = new CounterTask("slow");
+        scheduler->addTask(fast, 1);
+        scheduler->addTask(medium, 10);
+        scheduler->addTask(slow, 100);
+        guard = new OverloadGuard<CyclicExecutive<4>>(*scheduler, 900, 700);
+    }
+
+    void teardown() {
+        delete guard;
+        delete slow;
+        delete medium;
+        delete fast;
+        delete scheduler;
+    }
+};
+
+TEST(OverloadGuard, NormalLoadChangesNothing) {
+    guard->evaluate(800);
+
+    CHECK_FALSE(guard->isDegraded());
+    LONGS_EQUAL(100, scheduler->getTaskPeriodMs(2));
+}
+
+TEST(OverloadGuard, DownRatesLowestPriorityFirst) {
+    guard->evaluate(950);
+
+    LONGS_EQUAL(200, scheduler->getTaskPeriodMs(2));
+    LONGS_EQUAL(10, scheduler->getTaskPeriodMs(1));
+    LONGS_EQUAL(1, guard->getDegradeLevel(2));
+}
+
+TEST(OverloadGuard, MovesToNextTaskWhenFullyDegraded) {
+    for (int i = 0; i < 4; i++) {
+        guard->evaluate(950);
+    }
+
+    LONGS_EQUAL(800, scheduler->getTaskPeriodMs(2));  // 3 doublings max
+    LONGS_EQUAL(20, scheduler->getTaskPeriodMs(1));
+}
+
+TEST(OverloadGuard, RecoversMostUrgentTaskFirst) {
+    for (int i = 0; i < 4; i++) {
+        guard->evaluate(950);
+    }
+
+    guard->evaluate(500);
+
+    LONGS_EQUAL(10, scheduler->getTaskPeriodMs(1));
+    LONGS_EQUAL(800, scheduler->getTaskPeriodMs(2));
+
+    guard->evaluate(500);
+    LONGS_EQUAL(400, scheduler->getTaskPeriodMs(2));
+}
+
+TEST(OverloadGuard, HysteresisBandHoldsState) {
+    guard->evaluate(950);
+    guard->evaluate(800);  // Between recover and overload
+
+    LONGS_EQUAL(200, scheduler->getTaskPeriodMs(2));
+}
+
+TEST(OverloadGuard, ProtectedTaskIsNeverTouched) {
+    guard->protect(2);
+
+    guard->evaluate(950);
+
+    LONGS_EQUAL(100, scheduler->getTaskPeriodMs(2));
+    LONGS_EQUAL(20, scheduler->getTaskPeriodMs(1));
+}
+
+TEST(OverloadGuard, ShedModeDisablesAndRestoresTask) {
+    OverloadGuard<CyclicExecutive<4>> shedder(*scheduler, 900, 700,
+                                              OverloadGuard<CyclicExecutive<4>>::Action::SHED);
+
+    shedder.evaluate(950);
+    CHECK_FALSE(scheduler->isTaskEnabled(2));
+
+    for (uint32_t ms = 0; ms < 100; ms++) {
+        scheduler->tick();
+    }
+    scheduler->run();
+    LONGS_EQUAL(0, slow->getCount());
+
+    shedder.evaluate(500);
+    CHECK_TRUE(scheduler->isTaskEnabled(2));
+}
+
+namespace {
+
+struct GuardTestCounter {
+    static constexpr bool ENABLED = true;
+    static uint32_t ticks;
+    static uint32_t now() { return ticks; }
+};
+uint32_t GuardTestCounter::ticks = 0;
+
+// Burns a fixed number of counter ticks per run
+class LoadTask : public ITask {
+public:
+    explicit LoadTask(uint32_t costTicks) : costTicks_(costTicks) {}
+    void run() override { GuardTestCounter::ticks += costTicks_; }
+    const char* getName() const override { return "load"; }
+
+private:
+    uint32_t costTicks_;
+};
+
+}  // namespace
+
+TEST(OverloadGuard, SampleMeasuresUtilizationFromBusyTicks) {
+    using Instrumented = CyclicExecutive<4, GuardTestCounter>;
+    Instrumented executive;
+    LoadTask heavy(95);
+    LoadTask background(0);
+    executive.addTask(&heavy, 1);
+    executive.addTask(&background, 50);
+    OverloadGuard<Instrumented> loadGuard(executive, 900, 700);
+
+    GuardTestCounter::ticks = 0;
+    LONGS_EQUAL(0, loadGuard.sample(GuardTestCounter::ticks));  // Baseline
+
+    for (int ms = 0; ms < 10; ms++) {
+        executive.tick();
+        executive.run();                 // 95 busy ticks
+        GuardTestCounter::ticks += 5;    // 5 idle ticks
+    }
+
+    LONGS_EQUAL(950, loadGuard.sample(GuardTestCounter::ticks));
+    LONGS_EQUAL(100, executive.getTaskPeriodMs(1));  // Background task down-rated
+}
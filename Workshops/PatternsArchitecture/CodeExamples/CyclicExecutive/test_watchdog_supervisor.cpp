@@ -0,0 +1,322 @@
+#include "CppUTest/TestHarness.h"
+#include "WatchdogSupervisor.hpp"
+#include "../PerfBudget/PerfBudget.hpp"
+
+using namespace cyclic_executive;
+
+namespace {
+
+/**
+ * Counts feeds instead of restarting a hardware timeout
+ */
+struct FakeWatchdog {
+    static int feeds;
+    static void feed() { feeds++; }
+};
+int FakeWatchdog::feeds = 0;
+
+using Supervisor = WatchdogSupervisor<FakeWatchdog>;
+
+// Tracers take the supervisor by reference: static storage
+WatchdogRecord taskRecord;
+Supervisor taskSupervisor(taskRecord);
+WatchdogRecord slotRecord;
+Supervisor slotSupervisor(slotRecord);
+
+using SupervisedExecutive = CyclicExecutive<8, NoCycleCounter, PeriodicTickPolicy,
+                                            WatchdogTaskTracer<taskSupervisor>>;
+using SlotTracer = WatchdogSlotTracer<slotSupervisor, 2>;
+using SupervisedSlots = TimeSlotScheduler<4, 2, PeriodicTickPolicy, SlotTracer>;
+
+// The globals outlive the tests: forget what the previous one set up
+void restart(Supervisor& supervisor) {
+    for (size_t task = 0; task < Supervisor::MAX_TASKS; task++) supervisor.ignore(task);
+    supervisor.check();
+}
+
+} // namespace
+
+// ============================================================================
+// WatchdogSupervisor Tests
+// ============================================================================
+
+TEST_GROUP(WatchdogSupervisor) {
+    WatchdogRecord record;
+    Supervisor* supervisor;
+
+    void setup() {
+        FakeWatchdog::feeds = 0;
+        record = WatchdogRecord{};
+        supervisor = new Supervisor(record);
+    }
+
+    void teardown() {
+        delete supervisor;
+    }
+};
+
+TEST(WatchdogSupervisor, FeedsWhenEveryExpectedTaskCheckedIn) {
+    supervisor->expect(0);
+    supervisor->expect(3);
+
+    supervisor->checkIn(3);
+    supervisor->checkIn(0);
+
+    CHECK_TRUE(supervisor->check());
+    LONGS_EQUAL(1, FakeWatchdog::feeds);
+    LONGS_EQUAL(1, supervisor->getFeedCount());
+}
+
+TEST(WatchdogSupervisor, DoesNotFeedWhenATaskIsMissing) {
+    supervisor->expect(0);
+    supervisor->expect(1);
+
+    supervisor->checkIn(0);
+
+    CHECK_FALSE(supervisor->check());
+    LONGS_EQUAL(0, FakeWatchdog::feeds);
+    LONGS_EQUAL(1, supervisor->getFailedChecks());
+}
+
+TEST(WatchdogSupervisor, UnexpectedCheckInsDoNotMatter) {
+    supervisor->expect(1);
+
+    supervisor->checkIn(1);
+    supervisor->checkIn(5);
+
+    CHECK_TRUE(supervisor->check());
+}
+
+TEST(WatchdogSupervisor, EachWindowStartsEmpty) {
+    supervisor->expect(0);
+
+    supervisor->checkIn(0);
+    CHECK_TRUE(supervisor->check());
+
+    // No check-in since the last check: the earlier one does not count
+    CHECK_FALSE(supervisor->check());
+    LONGS_EQUAL(0U, supervisor->getReported());
+}
+
+TEST(WatchdogSupervisor, IgnoredTaskIsNotRequired) {
+    supervisor->expect(0);
+    supervisor->expect(1);
+    supervisor->ignore(1);
+
+    supervisor->checkIn(0);
+
+    CHECK_TRUE(supervisor->check());
+}
+
+TEST(WatchdogSupervisor, RejectsBitsBeyondTheMask) {
+    CHECK_FALSE(supervisor->expect(Supervisor::MAX_TASKS));
+
+    supervisor->checkIn(Supervisor::MAX_TASKS);
+    LONGS_EQUAL(0U, supervisor->getReported());
+}
+
+TEST(WatchdogSupervisor, FeedingAgainClearsTheFailureCount) {
+    supervisor->expect(0);
+    supervisor->check();
+    supervisor->check();
+    LONGS_EQUAL(2, supervisor->getFailedChecks());
+
+    supervisor->checkIn(0);
+    supervisor->check();
+    LONGS_EQUAL(0, supervisor->getFailedChecks());
+}
+
+TEST(WatchdogSupervisor, RecordNamesTheMissingTasks) {
+    supervisor->expect(0);
+    supervisor->expect(2);
+    supervisor->expect(4);
+    supervisor->checkIn(2);
+
+    supervisor->check();
+    supervisor->check();
+
+    uint32_t missing = 0;
+    CHECK_TRUE(Supervisor::takeResetRecord(record, missing));
+    LONGS_EQUAL(0x15U, missing);  // The last check: nothing checked in
+    LONGS_EQUAL(2, record.failedChecks);
+    LONGS_EQUAL(0, Supervisor::firstTask(missing));
+}
+
+TEST(WatchdogSupervisor, RecordIsTakenOnlyOnce) {
+    supervisor->expect(1);
+    supervisor->check();
+
+    uint32_t missing = 0;
+    CHECK_TRUE(Supervisor::takeResetRecord(record, missing));
+    CHECK_FALSE(Supervisor::takeResetRecord(record, missing));
+    LONGS_EQUAL(0U, missing);
+}
+
+TEST(WatchdogSupervisor, RandomRamIsNoRecord) {
+    // As after a power-on reset: magic right by chance, copy does not match
+    record.magic = Supervisor::MAGIC;
+    record.missing = 0x12345678U;
+    record.inverse = 0x12345678U;
+
+    uint32_t missing = 1;
+    CHECK_FALSE(Supervisor::takeResetRecord(record, missing));
+    LONGS_EQUAL(0U, missing);
+}
+
+TEST(WatchdogSupervisor, PassingCheckLeavesTheRecordAlone) {
+    supervisor->expect(0);
+    supervisor->checkIn(0);
+    supervisor->check();
+
+    uint32_t missing = 0;
+    CHECK_FALSE(Supervisor::takeResetRecord(record, missing));
+}
+
+TEST(WatchdogSupervisor, RecoveryWithdrawsTheRecord) {
+    supervisor->expect(0);
+    supervisor->check();  // Late once, within the hardware timeout
+
+    supervisor->checkIn(0);
+    supervisor->check();
+
+    uint32_t missing = 0;
+    CHECK_FALSE(Supervisor::takeResetRecord(record, missing));
+}
+
+TEST(WatchdogSupervisor, FirstTaskOfAnEmptyMaskIsNone) {
+    LONGS_EQUAL(Supervisor::MAX_TASKS, Supervisor::firstTask(0));
+    LONGS_EQUAL(7, Supervisor::firstTask(0x80U));
+}
+
+// ============================================================================
+// Scheduler Integration Tests
+// ============================================================================
+
+TEST_GROUP(WatchdogSchedulers) {
+    SupervisedExecutive* executive;
+    SupervisedSlots* slots;
+    CounterTask* sensor;
+    CounterTask* control;
+
+    void setup() {
+        taskRecord = WatchdogRecord{};
+        slotRecord = WatchdogRecord{};
+        restart(taskSupervisor);
+        restart(slotSupervisor);
+        FakeWatchdog::feeds = 0;
+        executive = new SupervisedExecutive();
+        slots = new SupervisedSlots(10);
+        sensor = new CounterTask("sensor");
+        control = new CounterTask("control");
+    }
+
+    void teardown() {
+        delete control;
+        delete sensor;
+        delete slots;
+        delete executive;
+    }
+
+    void runExecutiveMs(uint32_t ms) {
+        for (uint32_t i = 0; i < ms; i++) {
+            executive->tick();
+            executive->run();
+        }
+    }
+
+    void runSlotsMs(uint32_t ms) {
+        for (uint32_t i = 0; i < ms; i++) {
+            slots->tick();
+            slots->run();
+        }
+    }
+};
+
+TEST(WatchdogSchedulers, ExecutiveFeedsWhileAllTasksRun) {
+    executive->addTask(sensor, 10);
+    executive->addTask(control, 20);
+    executive->addTask(&taskSupervisor, 50);  // Window: more than twice the longest period
+    taskSupervisor.expect(0);
+    taskSupervisor.expect(1);
+
+    runExecutiveMs(500);
+
+    LONGS_EQUAL(10, FakeWatchdog::feeds);
+    LONGS_EQUAL(0, taskSupervisor.getFailedChecks());
+}
+
+TEST(WatchdogSchedulers, ExecutiveStopsFeedingForAStoppedTask) {
+    executive->addTask(sensor, 10);
+    executive->addTask(control, 20);
+    executive->addTask(&taskSupervisor, 50);
+    taskSupervisor.expect(0);
+    taskSupervisor.expect(1);
+
+    runExecutiveMs(100);
+    const int fed = FakeWatchdog::feeds;
+
+    executive->setTaskEnabled(1, false);  // Released but never run again
+    runExecutiveMs(100);
+
+    CHECK_TRUE(FakeWatchdog::feeds <= fed + 1);  // At most the window it stopped in
+    uint32_t missing = 0;
+    CHECK_TRUE(Supervisor::takeResetRecord(taskRecord, missing));
+    LONGS_EQUAL(0x2U, missing);
+    STRCMP_EQUAL("control", control->getName());
+}
+
+TEST(WatchdogSchedulers, SlotSchedulerChecksInPerTask) {
+    slots->addTaskToSlot(0, sensor);
+    slots->addTaskToSlot(2, sensor);
+    slots->addTaskToSlot(2, control);
+    slots->addTaskToSlot(3, &slotSupervisor);  // Once per major cycle
+    slotSupervisor.expect(SlotTracer::bitFor(0, 0));
+    slotSupervisor.expect(SlotTracer::bitFor(2, 0));
+    slotSupervisor.expect(SlotTracer::bitFor(2, 1));
+
+    runSlotsMs(400);
+
+    LONGS_EQUAL(10, FakeWatchdog::feeds);
+}
+
+TEST(WatchdogSchedulers, SlotSchedulerNamesTheMissingTask) {
+    slots->addTaskToSlot(0, sensor);
+    slots->addTaskToSlot(3, &slotSupervisor);
+    slotSupervisor.expect(SlotTracer::bitFor(0, 0));
+    slotSupervisor.expect(SlotTracer::bitFor(1, 1));  // Nothing there: never checks in
+
+    runSlotsMs(40);
+
+    LONGS_EQUAL(0, FakeWatchdog::feeds);
+    uint32_t missing = 0;
+    CHECK_TRUE(Supervisor::takeResetRecord(slotRecord, missing));
+    LONGS_EQUAL(SlotTracer::bitFor(1, 1), Supervisor::firstTask(missing));
+}
+
+// ============================================================================
+// Performance Budget Tests
+// ============================================================================
+
+TEST_GROUP(WatchdogBudget) {
+    WatchdogRecord record;
+    Supervisor* supervisor;
+
+    void setup() {
+        record = WatchdogRecord{};
+        supervisor = new Supervisor(record);
+        for (size_t task = 0; task < 8; task++) supervisor->expect(task);
+    }
+
+    void teardown() {
+        delete supervisor;
+    }
+};
+
+TEST(WatchdogBudget, CheckInIsAFewInstructions) {
+    CHECK_INSTRUCTION_BUDGET(30, [this]() { supervisor->checkIn(5); });
+}
+
+TEST(WatchdogBudget, CheckCostDoesNotDependOnTheMissingTasks) {
+    CHECK_CONSTANT_COST([this]() { supervisor->checkInMask(0xFFU); supervisor->check(); },
+                        [this]() { supervisor->check(); });
+}
@@ -2,6 +2,8 @@
 #define DEBOUNCING_HPP
 
 #include <cstdint>
+#include <cstddef>
+#include <array>
 
 /**
  * =============================================================================
@@ -19,6 +21,9 @@
  *   1. DELAY-BASED: Wait for signal to stabilize
  *   2. COUNTER-BASED: Require N consecutive same readings
  *   3. INTEGRATOR: Accumulate evidence for state change
+ *   3b. INTERRUPT: Integrator that only samples after a pin-change edge
+ *   4. PORT: Vertical counters debounce whole GPIO ports at once
+ *   5. MATRIX: Scan a key matrix row by row into the port debouncer
  *
  * Douglass (Ch.3): Debouncing Pattern
  *
@@ -231,6 +236,315 @@ private:
     bool stateChanged_;
 };
 
+// ============================================================================
+// APPROACH 3b: Interrupt-Driven Integrator
+// ============================================================================
+
+/**
+ * @brief One-shot timer interface (hardware timer, RTC compare, ...)
+ */
+class IOneShotTimer {
+public:
+    virtual ~IOneShotTimer() = default;
+    virtual void start(uint16_t ms) = 0;  // Fires once after ms
+    virtual void cancel() = 0;
+};
+
+/**
+ * @brief Integrator debouncer that only runs while the button is moving
+ *
+ * The pin-change ISR calls onEdge(), which arms a one-shot timer. Each
+ * timer expiry (onTimer()) takes one sample with IntegratorDebouncer
+ * semantics and re-arms, until the counter settles at 0 (released) or
+ * maxCount (pressed). Then the debouncer goes idle: a button nobody
+ * touches costs no CPU and the MCU can sleep between presses.
+ *
+ * Pros: Zero idle load, same noise immunity as the integrator
+ * Cons: Needs a pin-change interrupt and a spare timer per group
+ */
+class InterruptDebouncer {
+public:
+    InterruptDebouncer(IRawButton& button, IOneShotTimer& timer,
+                       uint8_t maxCount = 10, uint16_t sampleMs = 1)
+        : button_(button)
+        , timer_(timer)
+        , maxCount_(maxCount)
+        , sampleMs_(sampleMs)
+        , counter_(0)
+        , debouncedState_(false)
+        , stateChanged_(false)
+        , armed_(false)
+        , sampleCount_(0)
+    {}
+
+    /**
+     * @brief Call from the pin-change ISR (either edge)
+     */
+    void onEdge() {
+        if (!armed_) {
+            armed_ = true;
+            timer_.start(sampleMs_);
+        }
+        // Already sampling: further bounces are picked up by onTimer()
+    }
+
+    /**
+     * @brief Call from the one-shot timer ISR
+     */
+    void onTimer() {
+        stateChanged_ = false;
+        sampleCount_++;
+
+        if (button_.readRaw()) {
+            if (counter_ < maxCount_) {
+                counter_++;
+                if (counter_ >= maxCount_ && !debouncedState_) {
+                    debouncedState_ = true;
+                    stateChanged_ = true;
+                }
+            }
+        } else {
+            if (counter_ > 0) {
+                counter_--;
+                if (counter_ == 0 && debouncedState_) {
+                    debouncedState_ = false;
+                    stateChanged_ = true;
+                }
+            }
+        }
+
+        if (isSettled()) {
+            armed_ = false;  // Idle until the next edge
+        } else {
+            timer_.start(sampleMs_);
+        }
+    }
+
+    bool isPressed() const { return debouncedState_; }
+    bool stateChanged() const { return stateChanged_; }
+    bool isIdle() const { return !armed_; }
+
+    // For testing
+    uint8_t getCounter() const { return counter_; }
+    uint32_t getSampleCount() const { return sampleCount_; }
+
+private:
+    bool isSettled() const {
+        return debouncedState_ ? (counter_ == maxCount_) : (counter_ == 0);
+    }
+
+    IRawButton& button_;
+    IOneShotTimer& timer_;
+    uint8_t maxCount_;
+    uint16_t sampleMs_;
+    uint8_t counter_;
+    bool debouncedState_;
+    bool stateChanged_;
+    volatile bool armed_;
+    uint32_t sampleCount_;
+};
+
+// ============================================================================
+// APPROACH 4: Port Debouncing (Vertical Counter)
+// ============================================================================
+
+/**
+ * @brief Raw GPIO port interface, one register read per port
+ */
+template<typename PortWord = uint8_t>
+class IRawPort {
+public:
+    virtual ~IRawPort() = default;
+    virtual PortWord readPort(size_t index) const = 0;  // 1 = pressed
+};
+
+/**
+ * @brief Debounces every bit of N whole ports in parallel
+ *
+ * Each input bit has a 2-bit counter, stored "vertically": bit k of
+ * count0_ and count1_ together form the counter of input k. One update
+ * runs the same few bitwise operations for all inputs of a port:
+ *
+ *   delta   = raw ^ state            inputs that differ from debounced
+ *   count1  = (count1 ^ count0) & delta
+ *   count0  = ~count0 & delta        counts 1,2,3,0 while delta holds
+ *   toggle  = delta & ~(count0 | count1)
+ *   state  ^= toggle
+ *
+ * An input flips after 4 consecutive differing samples; any matching
+ * sample resets its counter. At 1ms polling that is a 4ms debounce, poll
+ * at 5ms for 20ms.
+ *
+ * activeLowMask inverts bits wired with pull-ups (pressed = 0).
+ *
+ * Pros: 24 inputs cost 3 register reads and ~15 instructions
+ * Cons: Fixed 4-sample depth (use more counter planes for longer)
+ */
+template<size_t PORTS, typename PortWord = uint8_t>
+class PortDebouncer {
+public:
+    explicit PortDebouncer(PortWord activeLowMask = 0)
+        : activeLowMask_(activeLowMask), state_{}, count0_{}, count1_{},
+          pressed_{}, released_{}
+    {}
+
+    /**
+     * @brief Feed one raw sample per port (e.g., copies of PINx registers)
+     */
+    void update(const std::array<PortWord, PORTS>& raw) {
+        for (size_t i = 0; i < PORTS; ++i) {
+            const PortWord sample = static_cast<PortWord>(raw[i] ^ activeLowMask_);
+            const PortWord delta = static_cast<PortWord>(sample ^ state_[i]);
+
+            count1_[i] = static_cast<PortWord>((count1_[i] ^ count0_[i]) & delta);
+            count0_[i] = static_cast<PortWord>(~count0_[i] & delta);
+
+            const PortWord toggle = static_cast<PortWord>(delta & ~(count0_[i] | count1_[i]));
+            state_[i] = static_cast<PortWord>(state_[i] ^ toggle);
+
+            pressed_[i] = static_cast<PortWord>(toggle & state_[i]);
+            released_[i] = static_cast<PortWord>(toggle & ~state_[i]);
+        }
+    }
+
+    /**
+     * @brief Read all ports through the interface (one call per port)
+     */
+    void update(const IRawPort<PortWord>& ports) {
+        std::array<PortWord, PORTS> raw;
+        for (size_t i = 0; i < PORTS; ++i) {
+            raw[i] = ports.readPort(i);
+        }
+        update(raw);
+    }
+
+    // Debounced level per port, bit set = pressed
+    PortWord getState(size_t port) const { return state_[port]; }
+
+    // Edges from the last update()
+    PortWord getPressed(size_t port) const { return pressed_[port]; }
+    PortWord getReleased(size_t port) const { return released_[port]; }
+
+    bool isPressed(size_t port, uint8_t bit) const {
+        return (state_[port] >> bit) & 1u;
+    }
+
+private:
+    PortWord activeLowMask_;
+    std::array<PortWord, PORTS> state_;
+    std::array<PortWord, PORTS> count0_;
+    std::array<PortWord, PORTS> count1_;
+    std::array<PortWord, PORTS> pressed_;
+    std::array<PortWord, PORTS> released_;
+};
+
+// ============================================================================
+// APPROACH 5: Key Matrix Scanning
+// ============================================================================
+
+/**
+ * @brief Key matrix wiring: one output per row, columns on one port
+ */
+template<typename ColumnWord = uint8_t>
+class IMatrixPort {
+public:
+    virtual ~IMatrixPort() = default;
+    virtual void driveRow(size_t row) = 0;          // Select row, release the others
+    virtual ColumnWord readColumns() const = 0;     // One port-wide read, 1 = pressed
+};
+
+/**
+ * @brief Scans ROWS x COLUMNS keys into a PortDebouncer, one row per tick
+ *
+ * A row is a "port" of the vertical-counter debouncer: an 8x8 matrix is
+ * PortDebouncer<8>, 64 keys debounced with 8 words of counter state and no
+ * per-key object. One IRawButton::readRaw() per key would be 64 calls.
+ *
+ * Tight ISR: a periodic timer calls onTimer(). Each tick reads the
+ * columns of the row driven by the previous tick (so the lines had a
+ * whole tick to settle) and drives the next row: one port read and one
+ * port write. The frame is complete after ROWS ticks and feeds the
+ * debouncer. E.g. a 125us tick scans 8 rows per ms; a key flips after 4
+ * equal frames, a 4ms debounce.
+ *
+ * DMA: the timer event triggers two channels instead. One writes a table
+ * of ROWS one-hot row patterns to the row port's output register, the
+ * other copies the column port's input register into a frame buffer (the
+ * read channel one beat behind, on the compare event half a period
+ * later). The block-complete interrupt calls onFrame() with the buffer,
+ * so the CPU runs once per frame, not once per row.
+ *
+ * activeLowMask inverts columns with pull-ups (pressed = 0).
+ *
+ * Pros: 64 keys per frame for ~ROWS x 15 instructions of debouncing
+ * Cons: Three keys on the corners of a rectangle also "press" the fourth
+ *       (ghosting); fit a diode per key if combinations matter
+ */
+template<size_t ROWS = 8, typename ColumnWord = uint8_t>
+class MatrixScanner {
+public:
+    static constexpr size_t COLUMNS = sizeof(ColumnWord) * 8;
+    static constexpr size_t KEYS = ROWS * COLUMNS;
+
+    explicit MatrixScanner(IMatrixPort<ColumnWord>& port, ColumnWord activeLowMask = 0)
+        : port_(port), debouncer_(activeLowMask), frame_{}, row_(0), frameCount_(0)
+    {}
+
+    /**
+     * @brief Drive the first row; call once before the timer starts
+     */
+    void start() {
+        row_ = 0;
+        port_.driveRow(0);
+    }
+
+    /**
+     * @brief Call from the periodic timer ISR
+     * @return true if this tick completed a frame (edges are new)
+     */
+    bool onTimer() {
+        frame_[row_] = port_.readColumns();
+        row_ = (row_ + 1 < ROWS) ? row_ + 1 : 0;
+        port_.driveRow(row_);
+
+        if (row_ != 0) return false;
+        return onFrame(frame_);
+    }
+
+    /**
+     * @brief A complete frame, one column word per row (DMA complete ISR)
+     */
+    bool onFrame(const std::array<ColumnWord, ROWS>& frame) {
+        debouncer_.update(frame);
+        frameCount_++;
+        return true;
+    }
+
+    // Debounced columns of a row, bit set = pressed
+    ColumnWord getState(size_t row) const { return debouncer_.getState(row); }
+
+    // Edges from the last frame
+    ColumnWord getPressed(size_t row) const { return debouncer_.getPressed(row); }
+    ColumnWord getReleased(size_t row) const { return debouncer_.getReleased(row); }
+
+    bool isPressed(size_t row, uint8_t column) const { return debouncer_.isPressed(row, column); }
+
+    // Key number row * COLUMNS + column
+    bool isKeyPressed(size_t key) const {
+        return isPressed(key / COLUMNS, static_cast<uint8_t>(key % COLUMNS));
+    }
+
+    size_t getCurrentRow() const { return row_; }
+    uint32_t getFrameCount() const { return frameCount_; }
+
+private:
+    IMatrixPort<ColumnWord>& port_;
+    PortDebouncer<ROWS, ColumnWord> debouncer_;
+    std::array<ColumnWord, ROWS> frame_;
+    size_t row_;
+    uint32_t frameCount_;
+};
+
 // ============================================================================
 // Mock button for testing
 // ============================================================================
@@ -250,6 +564,72 @@ private:
     bool pressed_;
 };
 
+class MockOneShotTimer : public IOneShotTimer {
+public:
+    MockOneShotTimer() : running_(false), lastMs_(0), startCount_(0) {}
+
+    void start(uint16_t ms) override { running_ = true; lastMs_ = ms; startCount_++; }
+    void cancel() override { running_ = false; }
+
+    // Test control: "expire" the timer, returns false if it was not running
+    bool expire() {
+        if (!running_) return false;
+        running_ = false;
+        return true;
+    }
+
+    bool isRunning() const { return running_; }
+    uint16_t getLastMs() const { return lastMs_; }
+    int getStartCount() const { return startCount_; }
+
+private:
+    bool running_;
+    uint16_t lastMs_;
+    int startCount_;
+};
+
+template<size_t PORTS, typename PortWord = uint8_t>
+class MockPort : public IRawPort<PortWord> {
+public:
+    MockPort() : values_{} {}
+
+    PortWord readPort(size_t index) const override { return values_[index]; }
+
+    // Test control
+    void set(size_t index, PortWord value) { values_[index] = value; }
+
+private:
+    std::array<PortWord, PORTS> values_;
+};
+
+/**
+ * @brief Key matrix whose columns show the keys of the driven row only
+ */
+template<size_t ROWS, typename ColumnWord = uint8_t>
+class MockMatrix : public IMatrixPort<ColumnWord> {
+public:
+    MockMatrix() : keys_{}, driven_(0), driveCount_(0) {}
+
+    void driveRow(size_t row) override { driven_ = row; driveCount_++; }
+    ColumnWord readColumns() const override { return keys_[driven_]; }
+
+    // Test control
+    void press(size_t row, uint8_t column) {
+        keys_[row] = static_cast<ColumnWord>(keys_[row] | (ColumnWord(1) << column));
+    }
+    void release(size_t row, uint8_t column) {
+        keys_[row] = static_cast<ColumnWord>(keys_[row] & ~(ColumnWord(1) << column));
+    }
+
+    size_t getDrivenRow() const { return driven_; }
+    int getDriveCount() const { return driveCount_; }
+
+private:
+    std::array<ColumnWord, ROWS> keys_;
+    size_t driven_;
+    int driveCount_;
+};
+
 }  // namespace debouncing
 
 #endif  // DEBOUNCING_HPP
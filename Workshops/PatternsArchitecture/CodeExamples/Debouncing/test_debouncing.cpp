@@ -1,5 +1,6 @@
 #include "CppUTest/TestHarness.h"
 #include "Debouncing.hpp"
+#include "../PerfBudget/PerfBudget.hpp"
 
 using namespace debouncing;
 
@@ -207,6 +208,286 @@ TEST(IntegratorDebouncer, HandlesBounceGracefully) {
     CHECK_TRUE(debouncer->isPressed());
 }
 
+// ============================================================================
+// InterruptDebouncer Tests
+// ============================================================================
+
+TEST_GROUP(InterruptDebouncer) {
+    MockButton button;
+    MockOneShotTimer timer;
+    InterruptDebouncer* debouncer;
+
+    void setup() {
+        debouncer = new InterruptDebouncer(button, timer, 5, 2);
+    }
+
+    void teardown() {
+        delete debouncer;
+    }
+
+    // Run timer expiries until the debouncer stops re-arming
+    int runUntilIdle() {
+        int samples = 0;
+        while (timer.expire()) {
+            debouncer->onTimer();
+            samples++;
+        }
+        return samples;
+    }
+};
+
+TEST(InterruptDebouncer, IdleWithoutEdges) {
+    CHECK_TRUE(debouncer->isIdle());
+    CHECK_FALSE(timer.isRunning());
+    LONGS_EQUAL(0, debouncer->getSampleCount());
+}
+
+TEST(InterruptDebouncer, EdgeArmsTimer) {
+    button.press();
+    debouncer->onEdge();
+
+    CHECK_TRUE(timer.isRunning());
+    LONGS_EQUAL(2, timer.getLastMs());
+    CHECK_FALSE(debouncer->isIdle());
+}
+
+TEST(InterruptDebouncer, BouncingEdgesArmOnce) {
+    button.press();
+    debouncer->onEdge();
+    debouncer->onEdge();
+    debouncer->onEdge();
+
+    LONGS_EQUAL(1, timer.getStartCount());
+}
+
+TEST(InterruptDebouncer, PressSettlesThenGoesIdle) {
+    button.press();
+    debouncer->onEdge();
+
+    LONGS_EQUAL(5, runUntilIdle());
+    CHECK_TRUE(debouncer->isPressed());
+    CHECK_TRUE(debouncer->stateChanged());
+    CHECK_TRUE(debouncer->isIdle());
+}
+
+TEST(InterruptDebouncer, ShortGlitchIsRejected) {
+    button.press();
+    debouncer->onEdge();
+    timer.expire();
+    debouncer->onTimer();  // counter = 1
+    button.release();      // Glitch over
+
+    runUntilIdle();
+    CHECK_FALSE(debouncer->isPressed());
+    CHECK_TRUE(debouncer->isIdle());
+}
+
+TEST(InterruptDebouncer, DetectsRelease) {
+    button.press();
+    debouncer->onEdge();
+    runUntilIdle();
+
+    button.release();
+    debouncer->onEdge();
+    LONGS_EQUAL(5, runUntilIdle());
+
+    CHECK_FALSE(debouncer->isPressed());
+    CHECK_TRUE(debouncer->stateChanged());
+}
+
+// ============================================================================
+// PortDebouncer Tests
+// ============================================================================
+
+TEST_GROUP(PortDebouncer) {
+    MockPort<3> ports;
+    PortDebouncer<3> debouncer;
+
+    void updateNTimes(int n) {
+        for (int i = 0; i < n; i++) {
+            debouncer.update(ports);
+        }
+    }
+};
+
+TEST(PortDebouncer, StartsReleased) {
+    updateNTimes(10);
+    BYTES_EQUAL(0x00, debouncer.getState(0));
+    BYTES_EQUAL(0x00, debouncer.getState(2));
+}
+
+TEST(PortDebouncer, NeedsFourConsecutiveSamples) {
+    ports.set(1, 0x05);
+    updateNTimes(3);
+    BYTES_EQUAL(0x00, debouncer.getState(1));
+
+    debouncer.update(ports);
+    BYTES_EQUAL(0x05, debouncer.getState(1));
+    BYTES_EQUAL(0x05, debouncer.getPressed(1));
+    CHECK_TRUE(debouncer.isPressed(1, 2));
+}
+
+TEST(PortDebouncer, EdgesLastOneUpdate) {
+    ports.set(0, 0x80);
+    updateNTimes(4);
+    BYTES_EQUAL(0x80, debouncer.getPressed(0));
+
+    debouncer.update(ports);
+    BYTES_EQUAL(0x00, debouncer.getPressed(0));
+    BYTES_EQUAL(0x80, debouncer.getState(0));
+}
+
+TEST(PortDebouncer, BounceResetsOnlyThatBit) {
+    ports.set(2, 0x03);
+    updateNTimes(2);
+    ports.set(2, 0x02);  // Bit 0 bounces
+    debouncer.update(ports);
+    ports.set(2, 0x03);
+    debouncer.update(ports);
+
+    BYTES_EQUAL(0x02, debouncer.getState(2));  // Bit 1 had 4 samples
+    updateNTimes(3);
+    BYTES_EQUAL(0x03, debouncer.getState(2));
+}
+
+TEST(PortDebouncer, ReportsRelease) {
+    ports.set(0, 0x10);
+    updateNTimes(4);
+    ports.set(0, 0x00);
+    updateNTimes(4);
+
+    BYTES_EQUAL(0x10, debouncer.getReleased(0));
+    BYTES_EQUAL(0x00, debouncer.getState(0));
+}
+
+TEST(PortDebouncer, ActiveLowMaskInvertsInputs) {
+    PortDebouncer<1> pullUps(0xFF);
+    std::array<uint8_t, 1> raw = {0xFE};  // Pin 0 pulled to ground
+
+    for (int i = 0; i < 4; i++) {
+        pullUps.update(raw);
+    }
+
+    BYTES_EQUAL(0x01, pullUps.getState(0));
+}
+
+// ============================================================================
+// MatrixScanner Tests
+// ============================================================================
+
+TEST_GROUP(MatrixScanner) {
+    MockMatrix<8> matrix;
+    MatrixScanner<8>* scanner;
+
+    void setup() {
+        scanner = new MatrixScanner<8>(matrix);
+        scanner->start();
+    }
+
+    void teardown() {
+        delete scanner;
+    }
+
+    void scanFrames(int frames) {
+        for (int i = 0; i < frames * 8; i++) {
+            scanner->onTimer();
+        }
+    }
+};
+
+TEST(MatrixScanner, OneFramePerRowsTicks) {
+    for (int i = 0; i < 7; i++) {
+        CHECK_FALSE(scanner->onTimer());
+    }
+    CHECK_TRUE(scanner->onTimer());
+    LONGS_EQUAL(1, scanner->getFrameCount());
+    LONGS_EQUAL(0, scanner->getCurrentRow());
+}
+
+TEST(MatrixScanner, EachTickDrivesTheNextRow) {
+    LONGS_EQUAL(0, matrix.getDrivenRow());
+    scanner->onTimer();
+    LONGS_EQUAL(1, matrix.getDrivenRow());
+    scanFrames(1);
+    LONGS_EQUAL(1, matrix.getDrivenRow());
+    LONGS_EQUAL(1 + 9, matrix.getDriveCount());  // start() and one per tick
+}
+
+TEST(MatrixScanner, KeyNeedsFourFrames) {
+    matrix.press(3, 5);
+    scanFrames(3);
+    CHECK_FALSE(scanner->isPressed(3, 5));
+
+    scanFrames(1);
+    CHECK_TRUE(scanner->isPressed(3, 5));
+    BYTES_EQUAL(0x20, scanner->getPressed(3));
+    CHECK_TRUE(scanner->isKeyPressed(3 * 8 + 5));
+}
+
+TEST(MatrixScanner, RowsDoNotSeeEachOthersKeys) {
+    matrix.press(0, 1);
+    matrix.press(7, 1);
+    matrix.press(7, 6);
+    scanFrames(4);
+
+    BYTES_EQUAL(0x02, scanner->getState(0));
+    BYTES_EQUAL(0x00, scanner->getState(3));
+    BYTES_EQUAL(0x42, scanner->getState(7));
+}
+
+TEST(MatrixScanner, ReportsRelease) {
+    matrix.press(2, 0);
+    scanFrames(4);
+    matrix.release(2, 0);
+    scanFrames(4);
+
+    CHECK_FALSE(scanner->isPressed(2, 0));
+    BYTES_EQUAL(0x01, scanner->getReleased(2));
+}
+
+TEST(MatrixScanner, BounceWithinAFrameIsRejected) {
+    matrix.press(4, 4);
+    scanFrames(3);
+    matrix.release(4, 4);
+    scanFrames(1);
+    matrix.press(4, 4);
+    scanFrames(3);
+
+    CHECK_FALSE(scanner->isPressed(4, 4));
+}
+
+TEST(MatrixScanner, DmaFrameFeedsTheDebouncer) {
+    MatrixScanner<4> dmaScanner(matrix, 0xFF);  // Columns with pull-ups
+    const std::array<uint8_t, 4> frame = {0xFF, 0x7F, 0xFF, 0xFF};
+
+    for (int i = 0; i < 4; i++) {
+        dmaScanner.onFrame(frame);
+    }
+
+    BYTES_EQUAL(0x80, dmaScanner.getState(1));
+    BYTES_EQUAL(0x00, dmaScanner.getState(0));
+    LONGS_EQUAL(4, dmaScanner.getFrameCount());
+}
+
+TEST(MatrixScanner, WiderColumnWord) {
+    MockMatrix<2, uint16_t> wide;
+    MatrixScanner<2, uint16_t> wideScanner(wide);
+    wideScanner.start();
+    wide.press(1, 12);
+
+    for (int i = 0; i < 4 * 2; i++) {
+        wideScanner.onTimer();
+    }
+
+    LONGS_EQUAL(32, (MatrixScanner<2, uint16_t>::KEYS));
+    CHECK_TRUE(wideScanner.isKeyPressed(16 + 12));
+}
+
+TEST(MatrixScanner, FrameOfSixtyFourKeysIsAFewInstructionsPerRow) {
+    const std::array<uint8_t, 8> frame = {0x01, 0x00, 0x80, 0x00, 0x00, 0x10, 0x00, 0x00};
+    CHECK_INSTRUCTION_BUDGET(300, [this, &frame]() { scanner->onFrame(frame); });
+}
+
 // ============================================================================
 // Workshop Discussion
 // ============================================================================
@@ -239,6 +520,10 @@ TEST(IntegratorDebouncer, HandlesBounceGracefully) {
  *   - Shift register: 8-16 samples
  *   - Integrator max: 5-20 counts
  *
+ * KEY MATRIX:
+ *   - Debounce rows as ports (MatrixScanner), not keys as buttons
+ *   - Scan rate = tick rate / rows
+ *
  * HARDWARE ALTERNATIVES:
  *   - RC filter on switch input (simple, passive)
  *   - Schmitt trigger IC (e.g., 74HC14)
@@ -0,0 +1,475 @@
+#ifndef FIXED_CONTAINERS_HPP
+#define FIXED_CONTAINERS_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * =============================================================================
+ * FIXED-CAPACITY CONTAINERS
+ * =============================================================================
+ *
+ * Problem:
+ *   Without a heap every subject, scheduler and table keeps "an array
+ *   plus a count" of its own: the bounds check, the append, the removal
+ *   that shifts the tail down, the ring with its index mask. Each copy
+ *   is small, but each one is written, reviewed and tested again, and
+ *   the slow variant (linear search, shifting) is the one that gets
+ *   copied.
+ *
+ * Solution:
+ *   Four containers with the storage inside the object, sized at compile
+ *   time:
+ *
+ *     StaticVector<T, N>      Array plus count. pushBack() O(1),
+ *                             removeAt() keeps the order (O(n) shift),
+ *                             removeAtUnordered() moves the last element
+ *                             into the gap (O(1)).
+ *     RingBuffer<T, N>        FIFO, N a power of two: index wrap is a mask.
+ *                             push() refuses when full, pushOverwrite()
+ *                             drops the oldest element.
+ *     FlatMap<K, V, N>        Sorted array of key/value pairs: find() is a
+ *                             binary search, iteration is in key order.
+ *     IntrusiveList<T>        Doubly linked list through a node embedded
+ *                             in T. No capacity: the elements are the
+ *                             storage. remove() is O(1).
+ *
+ * Embedded considerations:
+ *   - No dynamic memory, no exceptions: operations that can fail return
+ *     false (or nullptr) and leave the container unchanged
+ *   - Usable in constexpr code (C++17): storage is a plain array of T, so
+ *     T must be default constructible and assignable. Slots beyond
+ *     size() hold default-constructed values
+ *   - Not thread safe. Between an ISR and the main loop use
+ *     observer::EventQueue (lock-free SPSC) instead of RingBuffer
+ *
+ * =============================================================================
+ */
+
+namespace fixed_containers {
+
+// ============================================================================
+// StaticVector
+// ============================================================================
+
+/**
+ * @brief Up to CAPACITY elements in insertion order, stored in place
+ */
+template<typename T, size_t CAPACITY>
+class StaticVector {
+    static_assert(CAPACITY > 0, "CAPACITY must be at least 1");
+
+public:
+    static constexpr size_t NPOS = static_cast<size_t>(-1);
+
+    constexpr StaticVector() : data_{}, size_(0) {}
+
+    constexpr bool pushBack(const T& value) {
+        if (size_ >= CAPACITY) return false;
+        data_[size_++] = value;
+        return true;
+    }
+
+    constexpr bool popBack() {
+        if (size_ == 0) return false;
+        data_[--size_] = T{};
+        return true;
+    }
+
+    /**
+     * @brief Insert at index, shifting the elements behind it up
+     * @return false when full or index > size()
+     */
+    constexpr bool insertAt(size_t index, const T& value) {
+        if (size_ >= CAPACITY || index > size_) return false;
+        for (size_t i = size_; i > index; --i) {
+            data_[i] = data_[i - 1];
+        }
+        data_[index] = value;
+        size_++;
+        return true;
+    }
+
+    // Order preserving: the elements behind index move down one place
+    constexpr bool removeAt(size_t index) {
+        if (index >= size_) return false;
+        for (size_t i = index + 1; i < size_; ++i) {
+            data_[i - 1] = data_[i];
+        }
+        data_[--size_] = T{};
+        return true;
+    }
+
+    // O(1): the last element takes the place of the removed one
+    constexpr bool removeAtUnordered(size_t index) {
+        if (index >= size_) return false;
+        data_[index] = data_[size_ - 1];
+        data_[--size_] = T{};
+        return true;
+    }
+
+    // First element equal to value, order preserving
+    constexpr bool remove(const T& value) { return removeAt(indexOf(value)); }
+    constexpr bool removeUnordered(const T& value) { return removeAtUnordered(indexOf(value)); }
+
+    /** @return Index of the first element equal to value, NPOS if none */
+    constexpr size_t indexOf(const T& value) const {
+        for (size_t i = 0; i < size_; ++i) {
+            if (data_[i] == value) return i;
+        }
+        return NPOS;
+    }
+
+    constexpr bool contains(const T& value) const { return indexOf(value) != NPOS; }
+
+    constexpr void clear() {
+        while (size_ > 0) data_[--size_] = T{};
+    }
+
+    // Unchecked, like std::array
+    constexpr T& operator[](size_t index) { return data_[index]; }
+    constexpr const T& operator[](size_t index) const { return data_[index]; }
+    constexpr T& front() { return data_[0]; }
+    constexpr const T& front() const { return data_[0]; }
+    constexpr T& back() { return data_[size_ - 1]; }
+    constexpr const T& back() const { return data_[size_ - 1]; }
+
+    constexpr T* begin() { return data_; }
+    constexpr T* end() { return data_ + size_; }
+    constexpr const T* begin() const { return data_; }
+    constexpr const T* end() const { return data_ + size_; }
+
+    constexpr size_t size() const { return size_; }
+    static constexpr size_t capacity() { return CAPACITY; }
+    constexpr bool isEmpty() const { return size_ == 0; }
+    constexpr bool isFull() const { return size_ == CAPACITY; }
+
+private:
+    T data_[CAPACITY];
+    size_t size_;
+};
+
+// ============================================================================
+// RingBuffer
+// ============================================================================
+
+/**
+ * @brief FIFO of up to CAPACITY elements, CAPACITY a power of two
+ *
+ * head_ and tail_ run freely and wrap at SIZE_MAX; only the mask maps
+ * them into the array, so a full ring needs no extra flag.
+ */
+template<typename T, size_t CAPACITY>
+class RingBuffer {
+    static_assert(CAPACITY >= 2 && (CAPACITY & (CAPACITY - 1)) == 0,
+                  "CAPACITY must be a power of two");
+
+public:
+    constexpr RingBuffer() : data_{}, head_(0), tail_(0), dropped_(0) {}
+
+    /** @return false when full (nothing is stored) */
+    constexpr bool push(const T& value) {
+        if (isFull()) return false;
+        data_[head_++ & MASK] = value;
+        return true;
+    }
+
+    /**
+     * @brief Store value; when full the oldest element is dropped and counted
+     * @return false if an element was dropped
+     */
+    constexpr bool pushOverwrite(const T& value) {
+        const bool full = isFull();
+        if (full) {
+            tail_++;
+            dropped_++;
+        }
+        data_[head_++ & MASK] = value;
+        return !full;
+    }
+
+    constexpr bool pop(T& value) {
+        if (isEmpty()) return false;
+        value = data_[tail_++ & MASK];
+        return true;
+    }
+
+    constexpr bool pop() {
+        if (isEmpty()) return false;
+        tail_++;
+        return true;
+    }
+
+    // Oldest element first; unchecked
+    constexpr T& front() { return data_[tail_ & MASK]; }
+    constexpr const T& front() const { return data_[tail_ & MASK]; }
+    constexpr T& back() { return data_[(head_ - 1) & MASK]; }
+    constexpr const T& back() const { return data_[(head_ - 1) & MASK]; }
+    constexpr T& operator[](size_t index) { return data_[(tail_ + index) & MASK]; }
+    constexpr const T& operator[](size_t index) const { return data_[(tail_ + index) & MASK]; }
+
+    constexpr void clear() { tail_ = head_; }
+
+    constexpr size_t size() const { return head_ - tail_; }
+    static constexpr size_t capacity() { return CAPACITY; }
+    constexpr bool isEmpty() const { return head_ == tail_; }
+    constexpr bool isFull() const { return head_ - tail_ == CAPACITY; }
+    constexpr uint32_t getDroppedCount() const { return dropped_; }
+
+private:
+    static constexpr size_t MASK = CAPACITY - 1;
+
+    T data_[CAPACITY];
+    size_t head_;       // Next write
+    size_t tail_;       // Next read
+    uint32_t dropped_;  // By pushOverwrite()
+};
+
+// ============================================================================
+// FlatMap
+// ============================================================================
+
+/**
+ * @brief Up to CAPACITY key/value pairs, sorted by key
+ *
+ * Lookups are a binary search over contiguous entries: fewer compares
+ * than a linear search from about 8 entries on, and no pointers to
+ * chase. insert() and erase() shift the entries behind the position,
+ * which suits tables that are built once and read often.
+ * Keys need operator< and operator==.
+ */
+template<typename K, typename V, size_t CAPACITY>
+class FlatMap {
+public:
+    struct Entry {
+        K key;
+        V value;
+    };
+
+    constexpr FlatMap() : entries_() {}
+
+    /**
+     * @brief Add key, or replace its value if it is already present
+     * @return false when key is new and the map is full
+     */
+    constexpr bool insert(const K& key, const V& value) {
+        const size_t pos = lowerBound(key);
+        if (pos < entries_.size() && entries_[pos].key == key) {
+            entries_[pos].value = value;
+            return true;
+        }
+        return entries_.insertAt(pos, Entry{key, value});
+    }
+
+    constexpr bool erase(const K& key) {
+        const size_t pos = lowerBound(key);
+        if (pos >= entries_.size() || !(entries_[pos].key == key)) return false;
+        return entries_.removeAt(pos);
+    }
+
+    /** @return The value of key, nullptr if absent */
+    constexpr V* find(const K& key) {
+        const size_t pos = lowerBound(key);
+        return (pos < entries_.size() && entries_[pos].key == key) ? &entries_[pos].value : nullptr;
+    }
+
+    constexpr const V* find(const K& key) const {
+        const size_t pos = lowerBound(key);
+        return (pos < entries_.size() && entries_[pos].key == key) ? &entries_[pos].value : nullptr;
+    }
+
+    constexpr bool contains(const K& key) const { return find(key) != nullptr; }
+
+    constexpr void clear() { entries_.clear(); }
+
+    // Entries in key order
+    constexpr const Entry* begin() const { return entries_.begin(); }
+    constexpr const Entry* end() const { return entries_.end(); }
+
+    constexpr size_t size() const { return entries_.size(); }
+    static constexpr size_t capacity() { return CAPACITY; }
+    constexpr bool isEmpty() const { return entries_.isEmpty(); }
+    constexpr bool isFull() const { return entries_.isFull(); }
+
+private:
+    // First entry whose key is not less than key
+    constexpr size_t lowerBound(const K& key) const {
+        size_t low = 0;
+        size_t high = entries_.size();
+        while (low < high) {
+            const size_t mid = low + (high - low) / 2;
+            if (entries_[mid].key < key) {
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+        return low;
+    }
+
+    StaticVector<Entry, CAPACITY> entries_;
+};
+
+// ============================================================================
+// IntrusiveList
+// ============================================================================
+
+/**
+ * @brief Link fields a list element embeds by deriving from it
+ *
+ * An element is in at most one list per node base at a time. Copying an
+ * element does not copy its links.
+ */
+template<typename T>
+class IntrusiveListNode {
+public:
+    constexpr IntrusiveListNode() : prev_(nullptr), next_(nullptr), linked_(false) {}
+    constexpr IntrusiveListNode(const IntrusiveListNode&) : IntrusiveListNode() {}
+    constexpr IntrusiveListNode& operator=(const IntrusiveListNode&) { return *this; }
+
+    constexpr bool isLinked() const { return linked_; }
+
+private:
+    template<typename> friend class IntrusiveList;
+
+    T* prev_;
+    T* next_;
+    bool linked_;
+};
+
+/**
+ * @brief Doubly linked list of elements that derive from IntrusiveListNode<T>
+ *
+ * The list only holds pointers to its first and last element: adding and
+ * removing never copies or allocates, and removing an element it holds
+ * is O(1) wherever it is. The elements must outlive their membership.
+ *
+ * Usage:
+ *   struct Timer : IntrusiveListNode<Timer> { uint32_t dueMs; };
+ *   IntrusiveList<Timer> active;
+ *   active.pushBack(timerA);
+ *   active.remove(timerA);
+ */
+template<typename T>
+class IntrusiveList {
+    using Node = IntrusiveListNode<T>;
+
+public:
+    class Iterator {
+    public:
+        constexpr explicit Iterator(T* element) : element_(element) {}
+        constexpr T& operator*() const { return *element_; }
+        constexpr T* operator->() const { return element_; }
+        constexpr Iterator& operator++() {
+            element_ = static_cast<Node*>(element_)->next_;
+            return *this;
+        }
+        constexpr bool operator!=(const Iterator& other) const { return element_ != other.element_; }
+        constexpr bool operator==(const Iterator& other) const { return element_ == other.element_; }
+
+    private:
+        T* element_;
+    };
+
+    constexpr IntrusiveList() : head_(nullptr), tail_(nullptr), size_(0) {}
+
+    // Links point at the list's elements, not at the list: no copies
+    IntrusiveList(const IntrusiveList&) = delete;
+    IntrusiveList& operator=(const IntrusiveList&) = delete;
+
+    /** @return false if element is already in a list */
+    constexpr bool pushBack(T& element) {
+        Node& node = element;
+        if (node.linked_) return false;
+        node.prev_ = tail_;
+        node.next_ = nullptr;
+        node.linked_ = true;
+        if (tail_) {
+            static_cast<Node*>(tail_)->next_ = &element;
+        } else {
+            head_ = &element;
+        }
+        tail_ = &element;
+        size_++;
+        return true;
+    }
+
+    constexpr bool pushFront(T& element) {
+        Node& node = element;
+        if (node.linked_) return false;
+        node.prev_ = nullptr;
+        node.next_ = head_;
+        node.linked_ = true;
+        if (head_) {
+            static_cast<Node*>(head_)->prev_ = &element;
+        } else {
+            tail_ = &element;
+        }
+        head_ = &element;
+        size_++;
+        return true;
+    }
+
+    /**
+     * @brief Unlink element, O(1)
+     *
+     * The element must be in this list or in none: an element of another
+     * list of the same type would corrupt both (contains() checks, O(n)).
+     * @return false if element is not linked
+     */
+    constexpr bool remove(T& element) {
+        Node& node = element;
+        if (!node.linked_) return false;
+        if (node.prev_) {
+            static_cast<Node*>(node.prev_)->next_ = node.next_;
+        } else {
+            head_ = node.next_;
+        }
+        if (node.next_) {
+            static_cast<Node*>(node.next_)->prev_ = node.prev_;
+        } else {
+            tail_ = node.prev_;
+        }
+        node.prev_ = nullptr;
+        node.next_ = nullptr;
+        node.linked_ = false;
+        size_--;
+        return true;
+    }
+
+    /** @return The former first element, nullptr when empty */
+    constexpr T* popFront() {
+        T* element = head_;
+        if (element) remove(*element);
+        return element;
+    }
+
+    constexpr bool contains(const T& element) const {
+        for (const T* it = head_; it != nullptr; it = static_cast<const Node*>(it)->next_) {
+            if (it == &element) return true;
+        }
+        return false;
+    }
+
+    constexpr void clear() {
+        while (head_) remove(*head_);
+    }
+
+    constexpr T* front() const { return head_; }
+    constexpr T* back() const { return tail_; }
+
+    constexpr Iterator begin() const { return Iterator(head_); }
+    constexpr Iterator end() const { return Iterator(nullptr); }
+
+    constexpr size_t size() const { return size_; }
+    constexpr bool isEmpty() const { return head_ == nullptr; }
+
+private:
+    T* head_;
+    T* tail_;
+    size_t size_;
+};
+
+}  // namespace fixed_containers
+
+#endif  // FIXED_CONTAINERS_HPP
@@ -0,0 +1,388 @@
+#include "CppUTest/TestHarness.h"
+#include "FixedContainers.hpp"
+
+using namespace fixed_containers;
+
+// ============================================================================
+// Compile-time use
+// ============================================================================
+
+constexpr StaticVector<int, 4> makeVector() {
+    StaticVector<int, 4> vector;
+    vector.pushBack(1);
+    vector.pushBack(2);
+    vector.pushBack(3);
+    vector.removeAt(0);
+    return vector;
+}
+
+constexpr FlatMap<int, int, 4> makeMap() {
+    FlatMap<int, int, 4> map;
+    map.insert(30, 3);
+    map.insert(10, 1);
+    map.insert(20, 2);
+    return map;
+}
+
+constexpr int ringSum() {
+    RingBuffer<int, 4> ring;
+    for (int i = 1; i <= 6; ++i) ring.pushOverwrite(i);
+    int sum = 0;
+    int value = 0;
+    while (ring.pop(value)) sum += value;
+    return sum;
+}
+
+struct Item : IntrusiveListNode<Item> {
+    constexpr explicit Item(int v = 0) : value(v) {}
+    int value;
+};
+
+constexpr int listSum() {
+    Item a(1), b(2), c(3);
+    IntrusiveList<Item> list;
+    list.pushBack(a);
+    list.pushBack(b);
+    list.pushBack(c);
+    list.remove(b);
+    int sum = 0;
+    for (const Item& item : list) sum += item.value;
+    return sum;
+}
+
+static_assert(makeVector().size() == 2 && makeVector()[0] == 2, "StaticVector in constexpr");
+static_assert(*makeMap().find(20) == 2 && makeMap().begin()->key == 10, "FlatMap in constexpr");
+static_assert(ringSum() == 3 + 4 + 5 + 6, "RingBuffer in constexpr");
+static_assert(listSum() == 4, "IntrusiveList in constexpr");
+
+// ============================================================================
+// StaticVector Tests
+// ============================================================================
+
+TEST_GROUP(StaticVector) {
+    StaticVector<int, 4> vector;
+};
+
+TEST(StaticVector, StartsEmpty) {
+    CHECK_TRUE(vector.isEmpty());
+    LONGS_EQUAL(0, vector.size());
+    LONGS_EQUAL(4, vector.capacity());
+    CHECK_TRUE(vector.begin() == vector.end());
+}
+
+TEST(StaticVector, PushBackUpToCapacity) {
+    for (int i = 0; i < 4; ++i) {
+        CHECK_TRUE(vector.pushBack(i));
+    }
+    CHECK_TRUE(vector.isFull());
+    CHECK_FALSE(vector.pushBack(99));
+    LONGS_EQUAL(4, vector.size());
+    LONGS_EQUAL(3, vector.back());
+}
+
+TEST(StaticVector, RemoveAtKeepsOrder) {
+    vector.pushBack(10);
+    vector.pushBack(20);
+    vector.pushBack(30);
+    vector.pushBack(40);
+
+    CHECK_TRUE(vector.removeAt(1));
+
+    LONGS_EQUAL(3, vector.size());
+    LONGS_EQUAL(10, vector[0]);
+    LONGS_EQUAL(30, vector[1]);
+    LONGS_EQUAL(40, vector[2]);
+}
+
+TEST(StaticVector, RemoveAtUnorderedMovesLastIntoGap) {
+    vector.pushBack(10);
+    vector.pushBack(20);
+    vector.pushBack(30);
+    vector.pushBack(40);
+
+    CHECK_TRUE(vector.removeAtUnordered(0));
+
+    LONGS_EQUAL(3, vector.size());
+    LONGS_EQUAL(40, vector[0]);
+    LONGS_EQUAL(20, vector[1]);
+    LONGS_EQUAL(30, vector[2]);
+}
+
+TEST(StaticVector, RemoveOutOfRangeFails) {
+    vector.pushBack(1);
+    CHECK_FALSE(vector.removeAt(1));
+    CHECK_FALSE(vector.removeAtUnordered(5));
+    CHECK_FALSE(vector.remove(7));
+    LONGS_EQUAL(1, vector.size());
+}
+
+TEST(StaticVector, RemoveByValue) {
+    vector.pushBack(1);
+    vector.pushBack(2);
+    vector.pushBack(2);
+
+    CHECK_TRUE(vector.remove(2));
+
+    LONGS_EQUAL(2, vector.size());
+    CHECK_TRUE(vector.contains(2));
+    LONGS_EQUAL(1, vector.indexOf(2));
+    CHECK_TRUE(vector.indexOf(5) == (StaticVector<int, 4>::NPOS));
+}
+
+TEST(StaticVector, InsertAtShiftsUp) {
+    vector.pushBack(1);
+    vector.pushBack(3);
+
+    CHECK_TRUE(vector.insertAt(1, 2));
+    CHECK_TRUE(vector.insertAt(3, 4));
+    CHECK_FALSE(vector.insertAt(0, 0));  // Full
+
+    LONGS_EQUAL(1, vector[0]);
+    LONGS_EQUAL(2, vector[1]);
+    LONGS_EQUAL(3, vector[2]);
+    LONGS_EQUAL(4, vector[3]);
+}
+
+TEST(StaticVector, InsertPastEndFails) {
+    vector.pushBack(1);
+    CHECK_FALSE(vector.insertAt(2, 5));
+    LONGS_EQUAL(1, vector.size());
+}
+
+TEST(StaticVector, RangeForVisitsElementsInOrder) {
+    vector.pushBack(1);
+    vector.pushBack(2);
+    vector.pushBack(3);
+
+    int weighted = 0;
+    int position = 1;
+    for (int value : vector) {
+        weighted += value * position++;
+    }
+    LONGS_EQUAL(1 * 1 + 2 * 2 + 3 * 3, weighted);
+}
+
+TEST(StaticVector, PopBackAndClear) {
+    vector.pushBack(1);
+    vector.pushBack(2);
+
+    CHECK_TRUE(vector.popBack());
+    LONGS_EQUAL(1, vector.back());
+
+    vector.clear();
+    CHECK_TRUE(vector.isEmpty());
+    CHECK_FALSE(vector.popBack());
+}
+
+// ============================================================================
+// RingBuffer Tests
+// ============================================================================
+
+TEST_GROUP(RingBuffer) {
+    RingBuffer<int, 4> ring;
+};
+
+TEST(RingBuffer, FirstInFirstOut) {
+    ring.push(1);
+    ring.push(2);
+    ring.push(3);
+
+    int value = 0;
+    CHECK_TRUE(ring.pop(value));
+    LONGS_EQUAL(1, value);
+    CHECK_TRUE(ring.pop(value));
+    LONGS_EQUAL(2, value);
+    LONGS_EQUAL(1, ring.size());
+}
+
+TEST(RingBuffer, PushRefusesWhenFull) {
+    for (int i = 0; i < 4; ++i) {
+        CHECK_TRUE(ring.push(i));
+    }
+    CHECK_TRUE(ring.isFull());
+    CHECK_FALSE(ring.push(99));
+    LONGS_EQUAL(0, ring.front());
+    LONGS_EQUAL(3, ring.back());
+}
+
+TEST(RingBuffer, PushOverwriteDropsOldest) {
+    for (int i = 0; i < 4; ++i) {
+        CHECK_TRUE(ring.pushOverwrite(i));
+    }
+    CHECK_FALSE(ring.pushOverwrite(4));
+    CHECK_FALSE(ring.pushOverwrite(5));
+
+    LONGS_EQUAL(4, ring.size());
+    LONGS_EQUAL(2, ring.getDroppedCount());
+    LONGS_EQUAL(2, ring[0]);
+    LONGS_EQUAL(5, ring[3]);
+}
+
+TEST(RingBuffer, PopFromEmptyFails) {
+    int value = 7;
+    CHECK_FALSE(ring.pop(value));
+    CHECK_FALSE(ring.pop());
+    LONGS_EQUAL(7, value);
+}
+
+TEST(RingBuffer, WrapsAroundManyTimes) {
+    int value = 0;
+    for (int i = 0; i < 1000; ++i) {
+        CHECK_TRUE(ring.push(i));
+        CHECK_TRUE(ring.pop(value));
+        LONGS_EQUAL(i, value);
+    }
+    CHECK_TRUE(ring.isEmpty());
+}
+
+TEST(RingBuffer, ClearEmpties) {
+    ring.push(1);
+    ring.push(2);
+    ring.clear();
+    CHECK_TRUE(ring.isEmpty());
+    CHECK_TRUE(ring.push(3));
+    LONGS_EQUAL(3, ring.front());
+}
+
+// ============================================================================
+// FlatMap Tests
+// ============================================================================
+
+TEST_GROUP(FlatMap) {
+    FlatMap<uint8_t, int, 4> map;
+};
+
+TEST(FlatMap, FindsInsertedKeys) {
+    CHECK_TRUE(map.insert(0x20, 2));
+    CHECK_TRUE(map.insert(0x10, 1));
+
+    CHECK_TRUE(map.find(0x10) != nullptr);
+    LONGS_EQUAL(1, *map.find(0x10));
+    LONGS_EQUAL(2, *map.find(0x20));
+    POINTERS_EQUAL(nullptr, map.find(0x30));
+}
+
+TEST(FlatMap, InsertReplacesExistingValue) {
+    map.insert(5, 1);
+    CHECK_TRUE(map.insert(5, 9));
+    LONGS_EQUAL(1, map.size());
+    LONGS_EQUAL(9, *map.find(5));
+}
+
+TEST(FlatMap, IteratesInKeyOrder) {
+    map.insert(30, 3);
+    map.insert(10, 1);
+    map.insert(40, 4);
+    map.insert(20, 2);
+
+    uint8_t last = 0;
+    for (const auto& entry : map) {
+        CHECK_TRUE(entry.key > last);
+        LONGS_EQUAL(entry.key / 10, entry.value);
+        last = entry.key;
+    }
+}
+
+TEST(FlatMap, FullMapRefusesNewKeyButUpdatesOld) {
+    for (uint8_t key = 1; key <= 4; ++key) {
+        CHECK_TRUE(map.insert(key, key));
+    }
+    CHECK_FALSE(map.insert(9, 9));
+    CHECK_TRUE(map.insert(2, 20));
+    LONGS_EQUAL(20, *map.find(2));
+}
+
+TEST(FlatMap, EraseRemovesOnlyThatKey) {
+    map.insert(1, 1);
+    map.insert(2, 2);
+    map.insert(3, 3);
+
+    CHECK_TRUE(map.erase(2));
+    CHECK_FALSE(map.erase(2));
+
+    CHECK_FALSE(map.contains(2));
+    CHECK_TRUE(map.contains(1));
+    CHECK_TRUE(map.contains(3));
+    LONGS_EQUAL(2, map.size());
+}
+
+// ============================================================================
+// IntrusiveList Tests
+// ============================================================================
+
+TEST_GROUP(IntrusiveList) {
+    Item a{1};
+    Item b{2};
+    Item c{3};
+    IntrusiveList<Item> list;
+
+    int sum() const {
+        int total = 0;
+        for (const Item& item : list) total = total * 10 + item.value;
+        return total;
+    }
+};
+
+TEST(IntrusiveList, PushBackKeepsOrder) {
+    list.pushBack(a);
+    list.pushBack(b);
+    list.pushBack(c);
+
+    LONGS_EQUAL(3, list.size());
+    LONGS_EQUAL(123, sum());
+    POINTERS_EQUAL(&a, list.front());
+    POINTERS_EQUAL(&c, list.back());
+}
+
+TEST(IntrusiveList, PushFrontPrepends) {
+    list.pushBack(b);
+    list.pushFront(a);
+    LONGS_EQUAL(12, sum());
+}
+
+TEST(IntrusiveList, RemoveFromMiddleHeadAndTail) {
+    list.pushBack(a);
+    list.pushBack(b);
+    list.pushBack(c);
+
+    CHECK_TRUE(list.remove(b));
+    LONGS_EQUAL(13, sum());
+    CHECK_TRUE(list.remove(a));
+    LONGS_EQUAL(3, sum());
+    CHECK_TRUE(list.remove(c));
+    CHECK_TRUE(list.isEmpty());
+    POINTERS_EQUAL(nullptr, list.back());
+}
+
+TEST(IntrusiveList, ElementIsInOneListAtATime) {
+    IntrusiveList<Item> other;
+    CHECK_TRUE(list.pushBack(a));
+    CHECK_FALSE(other.pushBack(a));
+    CHECK_FALSE(list.pushBack(a));
+    CHECK_TRUE(a.isLinked());
+
+    list.remove(a);
+    CHECK_FALSE(a.isLinked());
+    CHECK_FALSE(list.remove(a));
+    CHECK_TRUE(other.pushBack(a));
+    other.clear();
+}
+
+TEST(IntrusiveList, PopFrontAndContains) {
+    list.pushBack(a);
+    list.pushBack(b);
+
+    CHECK_TRUE(list.contains(b));
+    CHECK_FALSE(list.contains(c));
+    POINTERS_EQUAL(&a, list.popFront());
+    POINTERS_EQUAL(&b, list.popFront());
+    POINTERS_EQUAL(nullptr, list.popFront());
+}
+
+TEST(IntrusiveList, CopiedElementIsNotLinked) {
+    list.pushBack(a);
+    Item copy = a;
+    CHECK_FALSE(copy.isLinked());
+    LONGS_EQUAL(1, copy.value);
+    list.clear();
+}
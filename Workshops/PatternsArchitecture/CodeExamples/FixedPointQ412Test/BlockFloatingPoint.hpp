@@ -0,0 +1,192 @@
+#ifndef BLOCK_FLOATING_POINT_HPP
+#define BLOCK_FLOATING_POINT_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "FixedPointQ412.hpp"  // SIMD selection
+
+namespace fixedpoint {
+
+/**
+ * @brief Block floating point: one exponent per block, signed mantissas
+ *
+ * Q4.12 has one fixed step (1/4095 V) for every signal: a 50 mV signal
+ * uses 8 of its 16 bits, and nothing below 0 or above 16 V fits. Here
+ * every block of samples shares one exponent, chosen from the largest
+ * magnitude in the block, so the mantissas always use their full range:
+ *
+ *   value = mantissa * 2^exponent,  |mantissa| <= 2^(MANTISSA_BITS - 1) - 1
+ *
+ * With 16-bit mantissas a 3.3 V block has a step of 2^-13 V (Q4.12:
+ * 2^-12), a 50 mV block 2^-19 V. A block of zeros gets EXPONENT_ZERO.
+ *
+ * The batch kernels follow FixedPointQ412: SSE2 (host) or NEON (AArch64)
+ * four values at a time, a scalar loop for the tail and other targets.
+ * Rounding is to nearest even on every path, so the results match bit
+ * for bit.
+ *
+ * @tparam MANTISSA_BITS Mantissa width including sign, 2..16 (12 for a
+ *         packed wire format, 16 for int16_t on the wire)
+ */
+template<unsigned MANTISSA_BITS>
+class BlockFloatingPoint {
+    static_assert(MANTISSA_BITS >= 2 && MANTISSA_BITS <= 16, "mantissa must fit int16_t");
+
+public:
+    using FloatType = float;
+    using MantissaType = int16_t;
+    using ExponentType = int8_t;
+
+    static constexpr int32_t MAX_MANTISSA = (1 << (MANTISSA_BITS - 1)) - 1;
+    static constexpr ExponentType MIN_EXPONENT = -100;   // Far below any signal; 2^-e stays a normal float
+    static constexpr ExponentType MAX_EXPONENT = 100;
+    static constexpr ExponentType EXPONENT_ZERO = MIN_EXPONENT;
+
+    /**
+     * @brief Smallest exponent at which the largest magnitude still fits
+     * @param in    Block of values; NaN counts as 0
+     * @param count Values in the block
+     * @return Exponent for toMantissas(), EXPONENT_ZERO for an all-zero block
+     */
+    static ExponentType chooseExponent(const FloatType* in, size_t count) {
+        FloatType peak = 0.0F;
+        size_t i = 0;
+#if defined(FIXED_POINT_Q412_SSE2)
+        const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+        __m128 peaks = _mm_setzero_ps();
+        for (; i + 4 <= count; i += 4) {
+            peaks = _mm_max_ps(_mm_and_ps(_mm_loadu_ps(in + i), signMask), peaks);  // NaN -> keeps peaks
+        }
+        alignas(16) FloatType lanes[4];
+        _mm_store_ps(lanes, peaks);
+        for (FloatType lane : lanes) {
+            if (lane > peak) peak = lane;
+        }
+#elif defined(FIXED_POINT_Q412_NEON) && defined(__aarch64__)
+        float32x4_t peaks = vdupq_n_f32(0.0F);
+        for (; i + 4 <= count; i += 4) {
+            const float32x4_t magnitude = vabsq_f32(vld1q_f32(in + i));
+            peaks = vbslq_f32(vcgtq_f32(magnitude, peaks), magnitude, peaks);  // NaN compares false
+        }
+        peak = vmaxvq_f32(peaks);
+#endif
+        for (; i < count; ++i) {
+            const FloatType magnitude = std::fabs(in[i]);
+            if (magnitude > peak) peak = magnitude;
+        }
+        return exponentFor(peak);
+    }
+
+    /**
+     * @brief Exponent for a block whose largest magnitude is peak
+     */
+    static ExponentType exponentFor(FloatType peak) {
+        if (!(peak > 0.0F)) return EXPONENT_ZERO;
+        if (!(peak < HUGE_VALF)) return MAX_EXPONENT;
+        int power = 0;
+        static_cast<void>(std::frexp(peak, &power));  // peak = f * 2^power, f in [0.5, 1)
+        int exponent = power - static_cast<int>(MANTISSA_BITS - 1);
+        if (exponent < MIN_EXPONENT) exponent = MIN_EXPONENT;
+        if (exponent > MAX_EXPONENT) exponent = MAX_EXPONENT;
+        return static_cast<ExponentType>(exponent);
+    }
+
+    /**
+     * @brief Batch convert floats to mantissas at exponent
+     *
+     * Rounded to nearest even and saturated at +-MAX_MANTISSA; NaN gives 0.
+     */
+    static void toMantissas(const FloatType* in, MantissaType* out, size_t count, ExponentType exponent) {
+        const FloatType scale = std::ldexp(1.0F, -exponent);
+        const FloatType limit = static_cast<FloatType>(MAX_MANTISSA);
+        size_t i = 0;
+#if defined(FIXED_POINT_Q412_SSE2)
+        const __m128 scales = _mm_set1_ps(scale);
+        const __m128 high = _mm_set1_ps(limit);
+        const __m128 low = _mm_set1_ps(-limit);
+        for (; i + 8 <= count; i += 8) {
+            __m128 a = _mm_loadu_ps(in + i);
+            __m128 b = _mm_loadu_ps(in + i + 4);
+            a = _mm_and_ps(a, _mm_cmpord_ps(a, a));  // NaN -> 0
+            b = _mm_and_ps(b, _mm_cmpord_ps(b, b));
+            a = _mm_min_ps(_mm_max_ps(_mm_mul_ps(a, scales), low), high);
+            b = _mm_min_ps(_mm_max_ps(_mm_mul_ps(b, scales), low), high);
+            const __m128i packed = _mm_packs_epi32(_mm_cvtps_epi32(a), _mm_cvtps_epi32(b));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), packed);
+        }
+#elif defined(FIXED_POINT_Q412_NEON) && defined(__aarch64__)
+        const float32x4_t high = vdupq_n_f32(limit);
+        const float32x4_t low = vdupq_n_f32(-limit);
+        for (; i + 4 <= count; i += 4) {
+            float32x4_t v = vld1q_f32(in + i);
+            v = vbslq_f32(vceqq_f32(v, v), v, vdupq_n_f32(0.0F));  // NaN -> 0
+            v = vminq_f32(vmaxq_f32(vmulq_n_f32(v, scale), low), high);
+            vst1_s16(out + i, vmovn_s32(vcvtnq_s32_f32(v)));
+        }
+#endif
+        for (; i < count; ++i) {
+            out[i] = toMantissa(in[i], scale);
+        }
+    }
+
+    /**
+     * @brief Batch convert mantissas back to floats (exact: mantissa * 2^exponent)
+     */
+    static void toFloat(const MantissaType* in, FloatType* out, size_t count, ExponentType exponent) {
+        const FloatType step = std::ldexp(1.0F, exponent);
+        size_t i = 0;
+#if defined(FIXED_POINT_Q412_SSE2)
+        const __m128 steps = _mm_set1_ps(step);
+        for (; i + 4 <= count; i += 4) {
+            const __m128i raw = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(in + i));
+            const __m128i wide = _mm_srai_epi32(_mm_unpacklo_epi16(raw, raw), 16);  // Sign extend
+            _mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(wide), steps));
+        }
+#elif defined(FIXED_POINT_Q412_NEON) && defined(__aarch64__)
+        for (; i + 4 <= count; i += 4) {
+            const int32x4_t wide = vmovl_s16(vld1_s16(in + i));
+            vst1q_f32(out + i, vmulq_n_f32(vcvtq_f32_s32(wide), step));
+        }
+#endif
+        for (; i < count; ++i) {
+            out[i] = static_cast<FloatType>(in[i]) * step;
+        }
+    }
+
+    /**
+     * @brief chooseExponent() and toMantissas() in one call
+     * @return The exponent of the block
+     */
+    static ExponentType toBlock(const FloatType* in, MantissaType* out, size_t count) {
+        const ExponentType exponent = chooseExponent(in, count);
+        toMantissas(in, out, count, exponent);
+        return exponent;
+    }
+
+    /**
+     * @brief Step (one mantissa LSB) at exponent; the error of a value in
+     *        the block is at most half a step, the peak at most one
+     */
+    static FloatType step(ExponentType exponent) {
+        return std::ldexp(1.0F, exponent);
+    }
+
+private:
+    static MantissaType toMantissa(FloatType value, FloatType scale) {
+        if (!(value == value)) return 0;  // NaN
+        const FloatType limit = static_cast<FloatType>(MAX_MANTISSA);
+        FloatType scaled = value * scale;
+        if (scaled > limit) scaled = limit;
+        if (scaled < -limit) scaled = -limit;
+        return static_cast<MantissaType>(std::nearbyint(scaled));
+    }
+};
+
+using BlockFloat12 = BlockFloatingPoint<12>;
+using BlockFloat16 = BlockFloatingPoint<16>;
+
+}  // namespace fixedpoint
+
+#endif  // BLOCK_FLOATING_POINT_HPP
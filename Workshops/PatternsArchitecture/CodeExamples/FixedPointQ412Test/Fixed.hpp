@@ -0,0 +1,208 @@
+#ifndef FIXED_HPP
+#define FIXED_HPP
+
+#include <cstdint>
+#include <type_traits>
+
+namespace fixedpoint {
+
+namespace detail {
+
+/// Smallest integer type holding BITS bits (plus sign if SIGNED)
+template<unsigned BITS, bool SIGNED>
+using StorageFor = std::conditional_t<SIGNED,
+    std::conditional_t<(BITS < 8), int8_t,
+        std::conditional_t<(BITS < 16), int16_t,
+            std::conditional_t<(BITS < 32), int32_t, int64_t>>>,
+    std::conditional_t<(BITS <= 8), uint8_t,
+        std::conditional_t<(BITS <= 16), uint16_t,
+            std::conditional_t<(BITS <= 32), uint32_t, uint64_t>>>>;
+
+/// Intermediate type for products and shifted dividends
+template<typename Storage>
+using WideFor = std::conditional_t<(sizeof(Storage) < 4), int32_t, int64_t>;
+
+}  // namespace detail
+
+/**
+ * @brief Q(INT_BITS).(FRAC_BITS) fixed-point number with saturating math
+ *
+ * Replaces float in control loops on targets without an FPU (Cortex-M0,
+ * AVR): every operation is integer add, shift or multiply.
+ *
+ * - Arithmetic saturates at the format limits instead of wrapping
+ * - Products and quotients are rounded to nearest
+ * - Division by zero saturates towards the sign of the dividend
+ * - Construction from a floating-point literal is constexpr, so
+ *   constants like Fixed<7, 8>(21.5) cost nothing at runtime
+ *
+ * Storage is signed unless given explicitly; Fixed<4, 12, uint16_t> has
+ * the same range as FixedPointQ412 (but a 1/4096 fraction step).
+ *
+ * Example:
+ *   using Celsius = Fixed<7, 8>;            // -128 .. +127.996, int16_t
+ *   constexpr Celsius SETPOINT{21.5};
+ *   Celsius error = SETPOINT - reading;
+ */
+template<unsigned INT_BITS, unsigned FRAC_BITS,
+         typename Storage = detail::StorageFor<INT_BITS + FRAC_BITS, true>>
+class Fixed {
+public:
+    using StorageType = Storage;
+    using Wide = detail::WideFor<Storage>;
+
+    static constexpr bool SIGNED = std::is_signed<Storage>::value;
+    static constexpr unsigned FRACTION_BITS = FRAC_BITS;
+    static constexpr unsigned INTEGER_BITS = INT_BITS;
+
+    static_assert(std::is_integral<Storage>::value, "Storage must be an integer type");
+    static_assert(INT_BITS + FRAC_BITS + (SIGNED ? 1U : 0U) <= sizeof(Storage) * 8U,
+                  "Format does not fit in Storage");
+    static_assert(sizeof(Storage) < 8, "64-bit storage has no wider intermediate type");
+
+    static constexpr Wide ONE_RAW = Wide{1} << FRAC_BITS;
+    static constexpr Wide MAX_RAW = (Wide{1} << (INT_BITS + FRAC_BITS)) - 1;
+    static constexpr Wide MIN_RAW = SIGNED ? -(Wide{1} << (INT_BITS + FRAC_BITS)) : 0;
+
+    constexpr Fixed() : raw_(0) {}
+
+    /// @brief Construct from a floating-point value (rounded, saturated)
+    constexpr explicit Fixed(double value) : raw_(fromDouble(value)) {}
+
+    /// @brief Construct from an integer value (saturated)
+    template<typename T, typename = std::enable_if_t<std::is_integral<T>::value>>
+    constexpr explicit Fixed(T value) : raw_(fromInteger(value)) {}
+
+    /// @brief Convert from another Q format (rounded, saturated)
+    template<unsigned I2, unsigned F2, typename S2>
+    constexpr explicit Fixed(const Fixed<I2, F2, S2>& other)
+        : raw_(saturate(rescale<F2>(static_cast<int64_t>(other.raw())))) {}
+
+    static constexpr Fixed fromRaw(Storage raw) {
+        Fixed f;
+        f.raw_ = raw;
+        return f;
+    }
+
+    static constexpr Fixed max() { return fromRaw(static_cast<Storage>(MAX_RAW)); }
+    static constexpr Fixed min() { return fromRaw(static_cast<Storage>(MIN_RAW)); }
+    static constexpr double resolution() { return 1.0 / static_cast<double>(ONE_RAW); }
+
+    constexpr Storage raw() const { return raw_; }
+
+    constexpr float toFloat() const { return static_cast<float>(raw_) / static_cast<float>(ONE_RAW); }
+    constexpr double toDouble() const { return static_cast<double>(raw_) / static_cast<double>(ONE_RAW); }
+
+    /// @brief Integer part, rounded towards minus infinity
+    constexpr Wide toInt() const { return static_cast<Wide>(raw_) >> FRAC_BITS; }
+
+    // ---- Saturating arithmetic -------------------------------------------
+
+    friend constexpr Fixed operator+(Fixed a, Fixed b) {
+        return fromWide(static_cast<Wide>(a.raw_) + b.raw_);
+    }
+
+    friend constexpr Fixed operator-(Fixed a, Fixed b) {
+        return fromWide(static_cast<Wide>(a.raw_) - b.raw_);
+    }
+
+    friend constexpr Fixed operator*(Fixed a, Fixed b) {
+        const Wide product = static_cast<Wide>(a.raw_) * b.raw_;
+        return fromWide(roundShift(product));
+    }
+
+    friend constexpr Fixed operator/(Fixed a, Fixed b) {
+        const Wide dividend = static_cast<Wide>(a.raw_) * ONE_RAW;
+        const Wide divisor = static_cast<Wide>(b.raw_);
+        if (divisor == 0) {
+            return dividend < 0 ? min() : max();
+        }
+        // Truncating division, then round half away from zero
+        Wide quotient = dividend / divisor;
+        const Wide remainder = dividend % divisor;
+        const Wide twiceRemainder = remainder < 0 ? -2 * remainder : 2 * remainder;
+        if (twiceRemainder >= (divisor < 0 ? -divisor : divisor)) {
+            quotient += ((dividend < 0) != (divisor < 0)) ? -1 : 1;
+        }
+        return fromWide(quotient);
+    }
+
+    constexpr Fixed operator-() const { return fromWide(-static_cast<Wide>(raw_)); }
+
+    Fixed& operator+=(Fixed other) { return *this = *this + other; }
+    Fixed& operator-=(Fixed other) { return *this = *this - other; }
+    Fixed& operator*=(Fixed other) { return *this = *this * other; }
+    Fixed& operator/=(Fixed other) { return *this = *this / other; }
+
+    // ---- Comparison ------------------------------------------------------
+
+    friend constexpr bool operator==(Fixed a, Fixed b) { return a.raw_ == b.raw_; }
+    friend constexpr bool operator!=(Fixed a, Fixed b) { return a.raw_ != b.raw_; }
+    friend constexpr bool operator<(Fixed a, Fixed b) { return a.raw_ < b.raw_; }
+    friend constexpr bool operator>(Fixed a, Fixed b) { return a.raw_ > b.raw_; }
+    friend constexpr bool operator<=(Fixed a, Fixed b) { return a.raw_ <= b.raw_; }
+    friend constexpr bool operator>=(Fixed a, Fixed b) { return a.raw_ >= b.raw_; }
+
+private:
+    static constexpr Storage saturate(Wide value) {
+        return static_cast<Storage>(value > MAX_RAW ? MAX_RAW : (value < MIN_RAW ? MIN_RAW : value));
+    }
+
+    static constexpr Fixed fromWide(Wide value) { return fromRaw(saturate(value)); }
+
+    // Shift right by FRAC_BITS, rounding half up
+    static constexpr Wide roundShift(Wide value) {
+        if constexpr (FRAC_BITS == 0) {
+            return value;
+        } else {
+            return (value + (Wide{1} << (FRAC_BITS - 1))) >> FRAC_BITS;
+        }
+    }
+
+    // Clamp to the integer range first: value * ONE_RAW overflows Wide
+    // (undefined behaviour) long before value overflows T
+    template<typename T>
+    static constexpr Storage fromInteger(T value) {
+        constexpr Wide MAX_INT = MAX_RAW >> FRAC_BITS;
+        if constexpr (std::is_signed<T>::value) {
+            constexpr Wide MIN_INT = SIGNED ? -(Wide{1} << INT_BITS) : 0;
+            if (value < MIN_INT) return static_cast<Storage>(MIN_RAW);
+            if (value > MAX_INT) return static_cast<Storage>(MAX_RAW);
+        } else {
+            if (value > static_cast<std::make_unsigned_t<Wide>>(MAX_INT)) return static_cast<Storage>(MAX_RAW);
+        }
+        return saturate(static_cast<Wide>(value) * ONE_RAW);
+    }
+
+    static constexpr Storage fromDouble(double value) {
+        const double scaled = value * static_cast<double>(ONE_RAW);
+        if (!(scaled == scaled)) return 0;  // NaN
+        if (scaled >= static_cast<double>(MAX_RAW)) return static_cast<Storage>(MAX_RAW);
+        if (scaled <= static_cast<double>(MIN_RAW)) return static_cast<Storage>(MIN_RAW);
+        return static_cast<Storage>(scaled < 0.0 ? static_cast<Wide>(scaled - 0.5)
+                                                 : static_cast<Wide>(scaled + 0.5));
+    }
+
+    // Convert a raw value with F2 fraction bits to FRAC_BITS, in 64-bit
+    template<unsigned F2>
+    static constexpr Wide rescale(int64_t raw) {
+        if constexpr (F2 > FRAC_BITS) {
+            constexpr unsigned SHIFT = F2 - FRAC_BITS;
+            const int64_t rounded = (raw + (int64_t{1} << (SHIFT - 1))) >> SHIFT;
+            return static_cast<Wide>(clamp64(rounded));
+        } else {
+            constexpr unsigned SHIFT = FRAC_BITS - F2;
+            return static_cast<Wide>(clamp64(raw * (int64_t{1} << SHIFT)));
+        }
+    }
+
+    static constexpr int64_t clamp64(int64_t value) {
+        return value > MAX_RAW ? MAX_RAW : (value < MIN_RAW ? MIN_RAW : value);
+    }
+
+    Storage raw_;
+};
+
+}  // namespace fixedpoint
+
+#endif  // FIXED_HPP
@@ -2,6 +2,15 @@
 #define FIXED_POINT_Q412_HPP
 
 #include <cstdint>
+#include <cstddef>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define FIXED_POINT_Q412_SSE2 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define FIXED_POINT_Q412_NEON 1
+#endif
 
 namespace fixedpoint {
 
@@ -28,6 +37,8 @@ public:
     static constexpr uint16_t FRACTION_BITS = 12U;
     static constexpr uint16_t FRACTION_MASK = 0x0FFFU;
     static constexpr uint8_t  INTEGER_MASK  = 0x0FU;
+    static constexpr FloatType MAX_INTEGER  = 15.0F;
+    static constexpr FloatType MAX_VALUE    = 16.0F;   // 0xFFFF: 15 + 4095/4095
 
     /**
      * @brief Convert floating-point to Q4.12 fixed-point
@@ -52,6 +63,105 @@ public:
                static_cast<FloatType>(fraction) / FRACTION_MASK;
     }
 
+    /**
+     * @brief Convert with rounding and saturation
+     * @param value Any floating-point value, clamped to [0.0, 16.0]
+     * @return Q4.12 value, fraction rounded to nearest
+     *
+     * toFixed() truncates and wraps out-of-range input; this variant is
+     * what the batch conversion below uses (and matches bit for bit).
+     */
+    static FixedType toFixedSaturated(FloatType value) {
+        if (!(value > 0.0F)) return 0U;  // Also catches NaN
+        if (value >= MAX_VALUE) return 0xFFFFU;
+        FloatType integer = static_cast<FloatType>(static_cast<uint16_t>(value));
+        if (integer > MAX_INTEGER) integer = MAX_INTEGER;
+        const auto fraction = static_cast<uint16_t>((value - integer) * FRACTION_MASK + 0.5F);
+        return static_cast<FixedType>((static_cast<uint16_t>(integer) << FRACTION_BITS) + fraction);
+    }
+
+    /**
+     * @brief Batch convert floats to Q4.12 (rounded, saturated)
+     *
+     * Uses SSE2 (host) or NEON (Cortex-A) four values at a time,
+     * scalar loop for the tail and on other targets. Cortex-M4/M7 have
+     * no float SIMD; there the scalar loop compiles to VCVT on the FPU,
+     * which is already one instruction per conversion.
+     */
+    static void toFixed(const FloatType* in, FixedType* out, size_t count) {
+        size_t i = 0;
+#if defined(FIXED_POINT_Q412_SSE2)
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 maxValue = _mm_set1_ps(MAX_VALUE);
+        const __m128 maxInteger = _mm_set1_ps(MAX_INTEGER);
+        const __m128 scale = _mm_set1_ps(static_cast<FloatType>(FRACTION_MASK));
+        const __m128 half = _mm_set1_ps(0.5F);
+        for (; i + 4 <= count; i += 4) {
+            __m128 v = _mm_loadu_ps(in + i);
+            v = _mm_min_ps(_mm_max_ps(v, zero), maxValue);  // NaN -> 0 via max(v, 0)
+            const __m128 integer = _mm_min_ps(_mm_cvtepi32_ps(_mm_cvttps_epi32(v)), maxInteger);
+            const __m128 fraction = _mm_add_ps(_mm_mul_ps(_mm_sub_ps(v, integer), scale), half);
+            const __m128i packed = _mm_add_epi32(_mm_slli_epi32(_mm_cvttps_epi32(integer), FRACTION_BITS),
+                                                 _mm_cvttps_epi32(fraction));
+            alignas(16) int32_t lanes[4];
+            _mm_store_si128(reinterpret_cast<__m128i*>(lanes), packed);
+            for (size_t k = 0; k < 4; ++k) {
+                out[i + k] = static_cast<FixedType>(lanes[k]);
+            }
+        }
+#elif defined(FIXED_POINT_Q412_NEON)
+        const float32x4_t zero = vdupq_n_f32(0.0F);
+        const float32x4_t maxValue = vdupq_n_f32(MAX_VALUE);
+        const float32x4_t maxInteger = vdupq_n_f32(MAX_INTEGER);
+        const float32x4_t scale = vdupq_n_f32(static_cast<FloatType>(FRACTION_MASK));
+        const float32x4_t half = vdupq_n_f32(0.5F);
+        for (; i + 4 <= count; i += 4) {
+            float32x4_t v = vminq_f32(vmaxq_f32(vld1q_f32(in + i), zero), maxValue);
+            const float32x4_t integer = vminq_f32(vcvtq_f32_u32(vcvtq_u32_f32(v)), maxInteger);
+            const float32x4_t fraction = vmlaq_f32(half, vsubq_f32(v, integer), scale);
+            const uint32x4_t packed = vaddq_u32(vshlq_n_u32(vcvtq_u32_f32(integer), FRACTION_BITS),
+                                                vcvtq_u32_f32(fraction));
+            vst1_u16(out + i, vmovn_u32(packed));
+        }
+#endif
+        for (; i < count; ++i) {
+            out[i] = toFixedSaturated(in[i]);
+        }
+    }
+
+    /**
+     * @brief Batch convert Q4.12 back to floats
+     *
+     * Same result as toFloat() per element (the division is kept, not
+     * replaced by a reciprocal, so the SIMD path matches bit for bit).
+     */
+    static void toFloat(const FixedType* in, FloatType* out, size_t count) {
+        size_t i = 0;
+#if defined(FIXED_POINT_Q412_SSE2)
+        const __m128i mask = _mm_set1_epi32(FRACTION_MASK);
+        const __m128 divisor = _mm_set1_ps(static_cast<FloatType>(FRACTION_MASK));
+        for (; i + 4 <= count; i += 4) {
+            const __m128i raw = _mm_unpacklo_epi16(
+                _mm_loadl_epi64(reinterpret_cast<const __m128i*>(in + i)), _mm_setzero_si128());
+            const __m128 integer = _mm_cvtepi32_ps(_mm_srli_epi32(raw, FRACTION_BITS));
+            const __m128 fraction = _mm_cvtepi32_ps(_mm_and_si128(raw, mask));
+            _mm_storeu_ps(out + i, _mm_add_ps(integer, _mm_div_ps(fraction, divisor)));
+        }
+#elif defined(FIXED_POINT_Q412_NEON) && defined(__aarch64__)
+        const uint32x4_t mask = vdupq_n_u32(FRACTION_MASK);
+        const float32x4_t divisor = vdupq_n_f32(static_cast<FloatType>(FRACTION_MASK));
+        for (; i + 4 <= count; i += 4) {
+            const uint32x4_t raw = vmovl_u16(vld1_u16(in + i));
+            const float32x4_t integer = vcvtq_f32_u32(vshrq_n_u32(raw, FRACTION_BITS));
+            const float32x4_t fraction = vcvtq_f32_u32(vandq_u32(raw, mask));
+            vst1q_f32(out + i, vaddq_f32(integer, vdivq_f32(fraction, divisor)));
+        }
+#endif
+        for (; i < count; ++i) {
+            out[i] = toFloat(in[i]);
+        }
+    }
+
     /**
      * @brief Maximum quantization error for this format
      * @return Approximately 1/4095 = 0.000244
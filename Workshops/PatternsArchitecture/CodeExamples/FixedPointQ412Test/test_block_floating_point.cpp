@@ -0,0 +1,159 @@
+#include "CppUTest/TestHarness.h"
+#include "BlockFloatingPoint.hpp"
+#include <cmath>
+#include <limits>
+
+using namespace fixedpoint;
+
+// ============================================================================
+// Exponent Selection Tests
+// ============================================================================
+
+TEST_GROUP(BlockExponent) {
+};
+
+TEST(BlockExponent, PeakUsesFullMantissaRange) {
+    // 3.3 = 0.825 * 2^2: 16-bit mantissas step 2^(2 - 15)
+    const float block[] = {0.1F, -1.2F, 3.3F, 2.0F};
+    LONGS_EQUAL(-13, BlockFloat16::chooseExponent(block, 4));
+    LONGS_EQUAL(-9, BlockFloat12::chooseExponent(block, 4));
+}
+
+TEST(BlockExponent, NegativePeakCountsByMagnitude) {
+    const float block[] = {0.5F, -20.0F, 1.0F, 3.0F, 0.0F};
+    LONGS_EQUAL(5 - 15, BlockFloat16::chooseExponent(block, 5));
+}
+
+TEST(BlockExponent, ZeroBlockGetsZeroExponent) {
+    const float block[] = {0.0F, -0.0F, 0.0F, 0.0F, 0.0F, 0.0F};
+    LONGS_EQUAL(BlockFloat16::EXPONENT_ZERO, BlockFloat16::chooseExponent(block, 6));
+    LONGS_EQUAL(BlockFloat16::EXPONENT_ZERO, BlockFloat16::chooseExponent(block, 0));
+}
+
+TEST(BlockExponent, NaNIsIgnored) {
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    const float block[] = {nan, 1.0F, nan, 0.25F, nan};
+    LONGS_EQUAL(1 - 15, BlockFloat16::chooseExponent(block, 5));
+}
+
+TEST(BlockExponent, PeakInScalarTailCounts) {
+    // 9 values: the largest one is only seen by the tail loop
+    const float block[] = {1.0F, 1.0F, 1.0F, 1.0F, 1.0F, 1.0F, 1.0F, 1.0F, 100.0F};
+    LONGS_EQUAL(7 - 15, BlockFloat16::chooseExponent(block, 9));
+}
+
+// ============================================================================
+// Batch Conversion Tests
+// ============================================================================
+
+TEST_GROUP(BlockConversion) {
+    // Reference: round to nearest even, saturate, NaN -> 0
+    static int16_t reference(float value, int8_t exponent, int32_t limit) {
+        if (std::isnan(value)) return 0;
+        float scaled = std::ldexp(value, -exponent);
+        if (scaled > limit) scaled = static_cast<float>(limit);
+        if (scaled < -limit) scaled = static_cast<float>(-limit);
+        return static_cast<int16_t>(std::nearbyint(scaled));
+    }
+};
+
+TEST(BlockConversion, BatchMatchesScalarReference) {
+    // 13 values: the 8-wide (SSE2) or 4-wide (NEON) kernel and the tail
+    const float input[] = {0.0F, 0.5F, -0.5F, 3.3F, -3.3F, 1e-6F, 2.0F,
+                           2.5F, -7.0F, 100.0F, -100.0F,
+                           std::numeric_limits<float>::quiet_NaN(), 0.123F};
+    constexpr size_t COUNT = sizeof(input) / sizeof(input[0]);
+    int16_t output[COUNT] = {};
+
+    BlockFloat16::toMantissas(input, output, COUNT, -12);
+
+    for (size_t i = 0; i < COUNT; ++i) {
+        LONGS_EQUAL(reference(input[i], -12, BlockFloat16::MAX_MANTISSA), output[i]);
+    }
+}
+
+TEST(BlockConversion, TwelveBitMantissasSaturate) {
+    const float input[] = {1000.0F, -1000.0F, 0.0F, 1.0F, 3.0F};
+    int16_t output[5] = {};
+
+    BlockFloat12::toMantissas(input, output, 5, -8);
+
+    LONGS_EQUAL(2047, output[0]);
+    LONGS_EQUAL(-2047, output[1]);
+    LONGS_EQUAL(0, output[2]);
+    LONGS_EQUAL(256, output[3]);
+    LONGS_EQUAL(768, output[4]);
+}
+
+TEST(BlockConversion, ToFloatIsExact) {
+    const int16_t input[] = {0, 1, -1, 32767, -32767, 1234, -4321};
+    constexpr size_t COUNT = sizeof(input) / sizeof(input[0]);
+    float output[COUNT] = {};
+
+    BlockFloat16::toFloat(input, output, COUNT, -13);
+
+    for (size_t i = 0; i < COUNT; ++i) {
+        DOUBLES_EQUAL(std::ldexp(static_cast<double>(input[i]), -13), output[i], 0.0);
+    }
+}
+
+TEST(BlockConversion, RoundTripWithinHalfStep) {
+    float input[64];
+    for (size_t i = 0; i < 64; ++i) {
+        input[i] = std::sin(static_cast<float>(i) * 0.3F) * 2.7F;
+    }
+    int16_t mantissas[64];
+    float result[64];
+
+    const int8_t exponent = BlockFloat16::toBlock(input, mantissas, 64);
+    BlockFloat16::toFloat(mantissas, result, 64, exponent);
+
+    for (size_t i = 0; i < 64; ++i) {
+        DOUBLES_EQUAL(input[i], result[i], BlockFloat16::step(exponent) / 2);
+    }
+}
+
+TEST(BlockConversion, PeakJustBelowPowerOfTwoStaysWithinOneStep) {
+    // 0.99999 rounds to 2^15 mantissas: saturated at 32767
+    const float input[] = {0.99999F, -0.99999F};
+    int16_t mantissas[2];
+    float result[2];
+
+    const int8_t exponent = BlockFloat16::toBlock(input, mantissas, 2);
+    BlockFloat16::toFloat(mantissas, result, 2, exponent);
+
+    LONGS_EQUAL(32767, mantissas[0]);
+    DOUBLES_EQUAL(input[0], result[0], BlockFloat16::step(exponent));
+    DOUBLES_EQUAL(input[1], result[1], BlockFloat16::step(exponent));
+}
+
+TEST(BlockConversion, SmallSignalBeatsQ412) {
+    // A 50 mV signal: Q4.12 resolves 1/4095 V, the block 2^-20 V
+    float input[16];
+    for (size_t i = 0; i < 16; ++i) {
+        input[i] = 0.05F * std::cos(static_cast<float>(i));
+    }
+    int16_t mantissas[16];
+    float result[16];
+
+    const int8_t exponent = BlockFloat16::toBlock(input, mantissas, 16);
+    BlockFloat16::toFloat(mantissas, result, 16, exponent);
+
+    CHECK(BlockFloat16::step(exponent) < FixedPointQ412::maxError() / 100);
+    for (size_t i = 0; i < 16; ++i) {
+        DOUBLES_EQUAL(input[i], result[i], BlockFloat16::step(exponent) / 2);
+    }
+}
+
+TEST(BlockConversion, RepresentsNegativeAndAboveSixteenVolts) {
+    const float input[] = {-5.0F, 24.0F, -0.75F, 18.5F};
+    int16_t mantissas[4];
+    float result[4];
+
+    const int8_t exponent = BlockFloat16::toBlock(input, mantissas, 4);
+    BlockFloat16::toFloat(mantissas, result, 4, exponent);
+
+    for (size_t i = 0; i < 4; ++i) {
+        DOUBLES_EQUAL(input[i], result[i], BlockFloat16::step(exponent) / 2);
+    }
+}
@@ -0,0 +1,127 @@
+#include "CppUTest/TestHarness.h"
+#include "Fixed.hpp"
+#include "FixedPointQ412.hpp"
+
+using namespace fixedpoint;
+
+using Q7_8 = Fixed<7, 8>;      // int16_t, -128 .. 127.996
+using Q15_16 = Fixed<15, 16>;  // int32_t
+using UQ4_12 = Fixed<4, 12, uint16_t>;
+
+// ============================================================================
+// Construction Tests
+// ============================================================================
+
+TEST_GROUP(FixedConstruction) {
+};
+
+TEST(FixedConstruction, PicksSmallestStorage) {
+    CHECK_TRUE((std::is_same<Q7_8::StorageType, int16_t>::value));
+    CHECK_TRUE((std::is_same<Q15_16::StorageType, int32_t>::value));
+    LONGS_EQUAL(2, sizeof(Q7_8));
+}
+
+TEST(FixedConstruction, LiteralIsCompileTimeConstant) {
+    constexpr Q7_8 SETPOINT{21.5};
+    static_assert(SETPOINT.raw() == 0x1580, "21.5 * 256");
+    LONGS_EQUAL(0x1580, SETPOINT.raw());
+}
+
+TEST(FixedConstruction, RoundsToNearest) {
+    LONGS_EQUAL(1, Q7_8(0.6 / 256.0).raw());
+    LONGS_EQUAL(-1, Q7_8(-0.6 / 256.0).raw());
+}
+
+TEST(FixedConstruction, SaturatesOutOfRange) {
+    CHECK_TRUE(Q7_8(1000.0) == Q7_8::max());
+    CHECK_TRUE(Q7_8(-1000.0) == Q7_8::min());
+    CHECK_TRUE(Q7_8(500) == Q7_8::max());
+    LONGS_EQUAL(0, UQ4_12(-3.0).raw());
+}
+
+TEST(FixedConstruction, SaturatesLargeIntegersWithoutOverflow) {
+    // value * 2^16 would overflow the int64 intermediate of Q15.16
+    CHECK_TRUE(Q15_16(INT64_MAX) == Q15_16::max());
+    CHECK_TRUE(Q15_16(INT64_MIN) == Q15_16::min());
+    CHECK_TRUE(Q15_16(UINT64_MAX) == Q15_16::max());
+    // ... and the int32 intermediate of Q7.8
+    CHECK_TRUE(Q7_8(INT32_MAX) == Q7_8::max());
+    CHECK_TRUE(Q7_8(INT32_MIN) == Q7_8::min());
+    CHECK_TRUE(UQ4_12(UINT32_MAX) == UQ4_12::max());
+    LONGS_EQUAL(0, UQ4_12(INT32_MIN).raw());
+
+    static_assert(Q7_8(INT32_MAX) == Q7_8::max(), "constexpr, no overflow");
+    LONGS_EQUAL(127 * 256, Q7_8(127).raw());
+    LONGS_EQUAL(-128 * 256, Q7_8(-128).raw());
+}
+
+TEST(FixedConstruction, ConvertsBetweenFormats) {
+    const Q15_16 precise{3.14159};
+    const Q7_8 coarse{precise};
+    DOUBLES_EQUAL(3.14159, coarse.toDouble(), Q7_8::resolution());
+
+    const Q15_16 back{coarse};
+    LONGS_EQUAL(coarse.raw() * 256, back.raw());
+
+    const Q7_8 clipped{Q15_16(30000.0)};
+    CHECK_TRUE(clipped == Q7_8::max());
+}
+
+TEST(FixedConstruction, MatchesQ412Range) {
+    DOUBLES_EQUAL(16.0, UQ4_12::max().toDouble(), UQ4_12::resolution());
+    LONGS_EQUAL(FixedPointQ412::toFixed(5.0F), UQ4_12(5.0).raw());
+}
+
+// ============================================================================
+// Arithmetic Tests
+// ============================================================================
+
+TEST_GROUP(FixedArithmetic) {
+};
+
+TEST(FixedArithmetic, AddAndSubtract) {
+    DOUBLES_EQUAL(3.75, (Q7_8(1.5) + Q7_8(2.25)).toDouble(), 0.0);
+    DOUBLES_EQUAL(-0.75, (Q7_8(1.5) - Q7_8(2.25)).toDouble(), 0.0);
+}
+
+TEST(FixedArithmetic, AddSaturatesInsteadOfWrapping) {
+    CHECK_TRUE(Q7_8(100.0) + Q7_8(100.0) == Q7_8::max());
+    CHECK_TRUE(Q7_8(-100.0) - Q7_8(100.0) == Q7_8::min());
+    LONGS_EQUAL(0, (UQ4_12(1.0) - UQ4_12(2.0)).raw());
+}
+
+TEST(FixedArithmetic, MultiplyRounds) {
+    DOUBLES_EQUAL(3.375, (Q7_8(1.5) * Q7_8(2.25)).toDouble(), 0.0);
+    DOUBLES_EQUAL(-3.375, (Q7_8(-1.5) * Q7_8(2.25)).toDouble(), 0.0);
+    CHECK_TRUE(Q7_8(20.0) * Q7_8(20.0) == Q7_8::max());
+}
+
+TEST(FixedArithmetic, Divide) {
+    DOUBLES_EQUAL(2.5, (Q7_8(5.0) / Q7_8(2.0)).toDouble(), 0.0);
+    DOUBLES_EQUAL(1.0 / 3.0, (Q15_16(1.0) / Q15_16(3.0)).toDouble(), Q15_16::resolution());
+    DOUBLES_EQUAL(-1.0 / 3.0, (Q15_16(-1.0) / Q15_16(3.0)).toDouble(), Q15_16::resolution());
+}
+
+TEST(FixedArithmetic, DivideByZeroSaturates) {
+    CHECK_TRUE(Q7_8(1.0) / Q7_8() == Q7_8::max());
+    CHECK_TRUE(Q7_8(-1.0) / Q7_8() == Q7_8::min());
+}
+
+TEST(FixedArithmetic, CompoundAndCompare) {
+    Q7_8 value{10.0};
+    value += Q7_8(0.5);
+    value *= Q7_8(2.0);
+    CHECK_TRUE(value == Q7_8(21.0));
+    CHECK_TRUE(Q7_8(1.0) < Q7_8(1.5));
+    LONGS_EQUAL(-2, Q7_8(-1.5).toInt());
+}
+
+TEST(FixedArithmetic, HysteresisDecisionInIntegerMath) {
+    // The TemperatureController decision, without float
+    constexpr Q7_8 SETPOINT{20.0};
+    constexpr Q7_8 HYSTERESIS{1.0};
+    const Q7_8 reading{18.5};
+
+    const Q7_8 error = SETPOINT - reading;
+    CHECK_TRUE(error > HYSTERESIS);
+}
@@ -1,5 +1,6 @@
 #include "CppUTest/TestHarness.h"
 #include "FixedPointQ412.hpp"
+#include "../PerfBudget/PerfBudget.hpp"
 
 using namespace fixedpoint;
 
@@ -126,3 +127,85 @@ TEST(EdgeCases, VoltageTypicalAdcRange) {
 // TEST(EdgeCases, NegativeValueBehavior)
 // Question: What happens with negative input? Is this a valid use case?
 // Hint: The current implementation uses unsigned types...
+
+// ============================================================================
+// Saturated and Batch Conversion Tests
+// ============================================================================
+
+TEST_GROUP(BatchConversion) {
+};
+
+TEST(BatchConversion, SaturatedRoundsToNearest) {
+    // 0.5 * 4095 = 2047.5 -> 2048 (toFixed() truncates to 2047)
+    LONGS_EQUAL(0x0800, FixedPointQ412::toFixedSaturated(0.5F));
+    LONGS_EQUAL(0x07FF, FixedPointQ412::toFixed(0.5F));
+}
+
+TEST(BatchConversion, SaturatedClampsOutOfRange) {
+    LONGS_EQUAL(0x0000, FixedPointQ412::toFixedSaturated(-1.0F));
+    LONGS_EQUAL(0xFFFF, FixedPointQ412::toFixedSaturated(16.0F));
+    LONGS_EQUAL(0xFFFF, FixedPointQ412::toFixedSaturated(100.0F));
+}
+
+TEST(BatchConversion, BatchMatchesSaturatedScalar) {
+    // 11 values: exercises the 4-wide kernel and the scalar tail
+    const float input[] = {0.0F, 0.5F, 1.0F, 3.3F, 5.25F, 15.0F,
+                           15.9999F, 16.0F, -2.0F, 42.0F, 7.77F};
+    constexpr size_t COUNT = sizeof(input) / sizeof(input[0]);
+    uint16_t output[COUNT] = {};
+
+    FixedPointQ412::toFixed(input, output, COUNT);
+
+    for (size_t i = 0; i < COUNT; ++i) {
+        LONGS_EQUAL(FixedPointQ412::toFixedSaturated(input[i]), output[i]);
+    }
+}
+
+TEST(BatchConversion, BatchToFloatMatchesScalar) {
+    const uint16_t input[] = {0x0000, 0x1000, 0x53FF, 0x8000, 0xF000, 0xFFFF, 0x0001};
+    constexpr size_t COUNT = sizeof(input) / sizeof(input[0]);
+    float output[COUNT] = {};
+
+    FixedPointQ412::toFloat(input, output, COUNT);
+
+    for (size_t i = 0; i < COUNT; ++i) {
+        DOUBLES_EQUAL(FixedPointQ412::toFloat(input[i]), output[i], 0.0);
+    }
+}
+
+TEST(BatchConversion, BatchRoundTripWithinHalfStep) {
+    float input[64];
+    for (size_t i = 0; i < 64; ++i) {
+        input[i] = static_cast<float>(i) * 0.2345F;
+    }
+    uint16_t fixed[64];
+    float result[64];
+
+    FixedPointQ412::toFixed(input, fixed, 64);
+    FixedPointQ412::toFloat(fixed, result, 64);
+
+    for (size_t i = 0; i < 64; ++i) {
+        DOUBLES_EQUAL(input[i], result[i], FixedPointQ412::maxError() / 2 + 1e-6);
+    }
+}
+
+// ============================================================================
+// Performance Budget
+// ============================================================================
+
+TEST_GROUP(ConversionBudget) {
+    volatile float input = 3.45678F;
+    float block[64] = {};
+    uint16_t fixed[64] = {};
+};
+
+TEST(ConversionBudget, ScalarConversionStaysSmall) {
+    // About 20 instructions with -O2 and 50 without optimisation
+    CHECK_INSTRUCTION_BUDGET(100, [this]() { perf_budget::keep(FixedPointQ412::toFixed(input)); });
+    CHECK_INSTRUCTION_BUDGET(100, [this]() { perf_budget::keep(FixedPointQ412::toFloat(fixed[0])); });
+}
+
+TEST(ConversionBudget, BatchConversionStaysSmall) {
+    // 64 values: about 400 instructions with -O2 (SIMD) and 2300 without optimisation
+    CHECK_INSTRUCTION_BUDGET(4000, [this]() { FixedPointQ412::toFixed(block, fixed, 64); });
+}
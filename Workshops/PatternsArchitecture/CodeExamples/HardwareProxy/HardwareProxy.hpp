@@ -2,6 +2,7 @@
 #define HARDWARE_PROXY_HPP
 
 #include <cstdint>
+#include <cstddef>
 
 /**
  * =============================================================================
@@ -182,6 +183,274 @@ private:
     ILed& led_;
 };
 
+// ============================================================================
+// Compile-Time Proxy (templates instead of virtual calls)
+// ============================================================================
+
+/**
+ * The interfaces above cost a vtable lookup and an indirect call per pin
+ * write. When the pin is fixed at build time (it always is on a PCB) the
+ * proxy can be a template instead: the port is a type with static
+ * set/clear/read, the pin is a template argument, and the whole call
+ * chain inlines to one store to BSRR (STM32) or one sbi/cbi (AVR).
+ *
+ * Testing still works by swapping a template parameter: FakePort<> for
+ * the real port, or MockLed for LedT<> in the application templates.
+ *
+ * Port policy interface (all static):
+ *   static void set(uint32_t mask);     // Drive masked pins high
+ *   static void clear(uint32_t mask);   // Drive masked pins low
+ *   static void write(uint32_t setMask, uint32_t clearMask);  // Both, one store
+ *   static uint32_t read();             // Input register
+ */
+
+#ifdef STM32
+
+/**
+ * @brief STM32 GPIO port at a fixed address (e.g. GPIOA_BASE)
+ *
+ * BSRR: lower half sets, upper half resets - a single atomic store,
+ * no read-modify-write, safe against ISRs touching the same port.
+ */
+template<uintptr_t BASE>
+struct Stm32Port {
+    static GPIO_TypeDef* regs() { return reinterpret_cast<GPIO_TypeDef*>(BASE); }
+    static void set(uint32_t mask) { regs()->BSRR = mask; }
+    static void clear(uint32_t mask) { regs()->BSRR = mask << 16; }
+    static void write(uint32_t setMask, uint32_t clearMask) {
+        regs()->BSRR = setMask | (clearMask << 16);  // Set wins if both
+    }
+    static uint32_t read() { return regs()->IDR; }
+};
+
+#elif defined(__AVR__)
+
+/**
+ * @brief AVR port from its PORTx/PINx I/O addresses
+ *
+ * With a constant single-bit mask GCC emits sbi/cbi, which are atomic.
+ */
+template<uintptr_t PORT_ADDR, uintptr_t PIN_ADDR>
+struct AvrPort {
+    static volatile uint8_t& port() { return *reinterpret_cast<volatile uint8_t*>(PORT_ADDR); }
+    static volatile uint8_t& pin() { return *reinterpret_cast<volatile uint8_t*>(PIN_ADDR); }
+    static void set(uint32_t mask) { port() |= static_cast<uint8_t>(mask); }
+    static void clear(uint32_t mask) { port() &= static_cast<uint8_t>(~mask); }
+    static void write(uint32_t setMask, uint32_t clearMask) {
+        // Read-modify-write: call with interrupts disabled if an ISR
+        // also writes this port
+        port() = static_cast<uint8_t>((port() & ~clearMask) | setMask);
+    }
+    static uint32_t read() { return pin(); }
+};
+
+#elif defined(ARDUINO_ARCH_SAMD)
+
+/**
+ * @brief SAMD21 port group (0 = PA, 1 = PB)
+ *
+ * OUTSET/OUTCLR are atomic but separate registers. write() reads OUT
+ * once and stores one toggle mask to OUTTGL, so all edges come from a
+ * single store; a write to OUT itself would be a read-modify-write that
+ * undoes what an ISR changed on the other pins in between. Pins in the
+ * masks must not also be driven from an ISR.
+ */
+template<uint8_t GROUP>
+struct SamdPort {
+    static PortGroup& regs() { return PORT->Group[GROUP]; }
+    static void set(uint32_t mask) { regs().OUTSET.reg = mask; }
+    static void clear(uint32_t mask) { regs().OUTCLR.reg = mask; }
+    static void write(uint32_t setMask, uint32_t clearMask) {
+        // Toggle the pins of the masks that differ from their target level;
+        // setMask wins for a pin in both, as with set-after-clear
+        regs().OUTTGL.reg = (regs().OUT.reg ^ setMask) & (setMask | clearMask);
+    }
+    static uint32_t read() { return regs().IN.reg; }
+};
+
+#endif
+
+/**
+ * @brief Fake port for off-target tests
+ *
+ * ID separates independent fake ports (FakePort<0>, FakePort<1>, ...).
+ */
+template<int ID = 0>
+struct FakePort {
+    static inline uint32_t output = 0;
+    static inline uint32_t input = 0;
+    static inline uint32_t writeCount = 0;
+
+    static void set(uint32_t mask) { output |= mask; writeCount++; }
+    static void clear(uint32_t mask) { output &= ~mask; writeCount++; }
+    static void write(uint32_t setMask, uint32_t clearMask) {
+        output = (output & ~clearMask) | setMask;
+        writeCount++;
+    }
+    static uint32_t read() { return input; }
+
+    static void reset() { output = 0; input = 0; writeCount = 0; }
+};
+
+/**
+ * @brief One GPIO pin, fully resolved at compile time
+ *
+ * Gpio<Stm32Port<GPIOA_BASE>, 5>::setHigh() is one store instruction.
+ */
+template<typename Port, uint8_t PIN>
+struct Gpio {
+    static_assert(PIN < 32, "Pin number out of range");
+    static constexpr uint32_t MASK = 1UL << PIN;
+
+    static void setHigh() { Port::set(MASK); }
+    static void setLow() { Port::clear(MASK); }
+    static bool read() { return (Port::read() & MASK) != 0; }
+};
+
+/**
+ * @brief Batched multi-pin writes on one port
+ *
+ * Collects set/clear masks and commits them in a single register write,
+ * so e.g. a stepper's DIR and EN lines, or a row of LEDs, change on the
+ * same clock edge instead of skewed by several calls.
+ *
+ * Usage:
+ *   GpioPort<Stm32Port<GPIOB_BASE>> port;
+ *   port.begin();
+ *   port.set(DirPin::MASK | EnablePin::MASK);
+ *   port.clear(StepPin::MASK);
+ *   port.commit();            // One BSRR store
+ *
+ * The last set()/clear() of a pin within a transaction wins.
+ */
+template<typename Port>
+class GpioPort {
+public:
+    GpioPort() : setMask_(0), clearMask_(0) {}
+
+    void begin() { setMask_ = 0; clearMask_ = 0; }
+
+    GpioPort& set(uint32_t mask) {
+        setMask_ |= mask;
+        clearMask_ &= ~mask;
+        return *this;
+    }
+
+    GpioPort& clear(uint32_t mask) {
+        clearMask_ |= mask;
+        setMask_ &= ~mask;
+        return *this;
+    }
+
+    GpioPort& write(uint32_t mask, bool high) { return high ? set(mask) : clear(mask); }
+
+    void commit() {
+        if (setMask_ != 0 || clearMask_ != 0) {
+            Port::write(setMask_, clearMask_);
+        }
+        begin();
+    }
+
+    uint32_t getPendingSet() const { return setMask_; }
+    uint32_t getPendingClear() const { return clearMask_; }
+
+private:
+    uint32_t setMask_;
+    uint32_t clearMask_;
+};
+
+/**
+ * @brief CRTP base: LED behaviour shared by all static LEDs
+ *
+ * Derived provides write(bool on). No virtual functions, so no vtable
+ * pointer and every call inlines into the caller.
+ */
+template<typename Derived>
+class LedBase {
+public:
+    void turnOn() { self().write(true); state_ = true; }
+    void turnOff() { self().write(false); state_ = false; }
+    void toggle() { state_ ? turnOff() : turnOn(); }
+    bool isOn() const { return state_; }
+
+protected:
+    LedBase() : state_(false) {}
+
+private:
+    Derived& self() { return static_cast<Derived&>(*this); }
+
+    bool state_;
+};
+
+/**
+ * @brief LED on a compile-time GPIO pin
+ *
+ * Example:
+ *   using StatusLed = LedT<Gpio<Stm32Port<GPIOA_BASE>, 5>>;
+ *   StatusLed led;
+ *   HeartbeatIndicatorT<StatusLed> heartbeat(led);
+ */
+template<typename GpioT, bool ACTIVE_LOW = false>
+class LedT : public LedBase<LedT<GpioT, ACTIVE_LOW>> {
+private:
+    friend class LedBase<LedT<GpioT, ACTIVE_LOW>>;
+
+    static void write(bool on) {
+        if (on != ACTIVE_LOW) {
+            GpioT::setHigh();
+        } else {
+            GpioT::setLow();
+        }
+    }
+};
+
+/**
+ * @brief HeartbeatIndicator with the LED type as template parameter
+ *
+ * Works with LedT<> on target and with MockLed (or LedT<Gpio<FakePort>>)
+ * in tests - the substitution happens at compile time.
+ */
+template<typename Led>
+class HeartbeatIndicatorT {
+public:
+    explicit HeartbeatIndicatorT(Led& led) : led_(led), beatCount_(0) {}
+
+    void beat() {
+        led_.toggle();
+        beatCount_++;
+    }
+
+    int getBeatCount() const { return beatCount_; }
+
+private:
+    Led& led_;
+    int beatCount_;
+};
+
+/**
+ * @brief ErrorIndicator with the LED type as template parameter
+ */
+template<typename Led>
+class ErrorIndicatorT {
+public:
+    explicit ErrorIndicatorT(Led& led) : led_(led) {}
+
+    void showError() {
+        // Quick double-blink for error
+        led_.turnOn();
+        led_.turnOff();
+        led_.turnOn();
+        led_.turnOff();
+    }
+
+    void showOk() {
+        led_.turnOff();
+    }
+
+private:
+    Led& led_;
+};
+
 }  // namespace hardware_proxy
 
 #endif  // HARDWARE_PROXY_HPP
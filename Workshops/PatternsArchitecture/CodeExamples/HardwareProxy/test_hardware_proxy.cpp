@@ -74,6 +74,121 @@ TEST(ErrorIndicator, ShowErrorEndsWithLedOff) {
     CHECK_FALSE(led->isOn());
 }
 
+// ============================================================================
+// Compile-Time Proxy Tests
+// ============================================================================
+
+using TestPort = FakePort<0>;
+using TestPin = Gpio<TestPort, 5>;
+
+TEST_GROUP(StaticGpio) {
+    void setup() { TestPort::reset(); }
+};
+
+TEST(StaticGpio, SetHighWritesOnlyItsBit) {
+    TestPin::setHigh();
+    UNSIGNED_LONGS_EQUAL(0x20, TestPort::output);
+    LONGS_EQUAL(1, TestPort::writeCount);
+}
+
+TEST(StaticGpio, SetLowClearsOnlyItsBit) {
+    TestPort::output = 0xFF;
+    TestPin::setLow();
+    UNSIGNED_LONGS_EQUAL(0xDF, TestPort::output);
+}
+
+TEST(StaticGpio, ReadsInputRegister) {
+    CHECK_FALSE(TestPin::read());
+    TestPort::input = 0x20;
+    CHECK_TRUE(TestPin::read());
+}
+
+TEST_GROUP(StaticLed) {
+    void setup() { TestPort::reset(); }
+};
+
+TEST(StaticLed, HasNoVtable) {
+    // No vtable pointer, only the state flag
+    LONGS_EQUAL(sizeof(bool), sizeof(LedT<TestPin>));
+}
+
+TEST(StaticLed, TurnOnDrivesPin) {
+    LedT<TestPin> led;
+    led.turnOn();
+    CHECK_TRUE(led.isOn());
+    UNSIGNED_LONGS_EQUAL(0x20, TestPort::output);
+}
+
+TEST(StaticLed, ActiveLowInvertsPin) {
+    LedT<TestPin, true> led;
+    led.turnOn();
+    CHECK_TRUE(led.isOn());
+    UNSIGNED_LONGS_EQUAL(0x00, TestPort::output);
+    led.turnOff();
+    UNSIGNED_LONGS_EQUAL(0x20, TestPort::output);
+}
+
+TEST(StaticLed, HeartbeatTogglesStaticLed) {
+    LedT<TestPin> led;
+    HeartbeatIndicatorT<LedT<TestPin>> heartbeat(led);
+
+    heartbeat.beat();
+    UNSIGNED_LONGS_EQUAL(0x20, TestPort::output);
+    heartbeat.beat();
+    UNSIGNED_LONGS_EQUAL(0x00, TestPort::output);
+    LONGS_EQUAL(2, heartbeat.getBeatCount());
+}
+
+TEST(StaticLed, MockLedSubstitutesViaTemplateParameter) {
+    MockLed led;
+    HeartbeatIndicatorT<MockLed> heartbeat(led);
+    ErrorIndicatorT<MockLed> error(led);
+
+    heartbeat.beat();
+    LONGS_EQUAL(1, led.getToggleCount());
+    error.showError();
+    CHECK_FALSE(led.isOn());
+}
+
+TEST_GROUP(GpioPort) {
+    GpioPort<TestPort> port;
+
+    void setup() { TestPort::reset(); }
+};
+
+TEST(GpioPort, NothingHappensBeforeCommit) {
+    port.begin();
+    port.set(0x03);
+    LONGS_EQUAL(0, TestPort::writeCount);
+    UNSIGNED_LONGS_EQUAL(0x03, port.getPendingSet());
+}
+
+TEST(GpioPort, CommitIsOneWrite) {
+    TestPort::output = 0xF0;
+    port.begin();
+    port.set(Gpio<TestPort, 0>::MASK | Gpio<TestPort, 1>::MASK).clear(0x80);
+    port.commit();
+
+    LONGS_EQUAL(1, TestPort::writeCount);
+    UNSIGNED_LONGS_EQUAL(0x73, TestPort::output);
+}
+
+TEST(GpioPort, LastOperationOnAPinWins) {
+    port.begin();
+    port.set(0x01);
+    port.clear(0x01);
+    port.write(0x02, true);
+    port.commit();
+
+    UNSIGNED_LONGS_EQUAL(0x02, TestPort::output);
+}
+
+TEST(GpioPort, EmptyCommitSkipsWrite) {
+    port.begin();
+    port.commit();
+    LONGS_EQUAL(0, TestPort::writeCount);
+}
+
 // ============================================================================
 // Workshop Discussion Points
 // ============================================================================
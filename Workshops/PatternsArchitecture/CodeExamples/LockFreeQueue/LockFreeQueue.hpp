@@ -0,0 +1,370 @@
+#ifndef LOCK_FREE_QUEUE_HPP
+#define LOCK_FREE_QUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * =============================================================================
+ * LOCK-FREE QUEUES (ISR -> MAIN LOOP, CORE -> CORE, THREAD -> THREAD)
+ * =============================================================================
+ *
+ * Problem:
+ *   Work that arrives in an interrupt (a received byte, a button edge, a
+ *   command) must reach the main loop without the ISR waiting for it and
+ *   without disabling interrupts around every access. Each module wrote
+ *   its own ring for this, each with its own subtle ordering rules.
+ *
+ * Solution:
+ *   Two bounded FIFOs with the storage inside the object:
+ *
+ *     SpscQueue<T, N>   One producer, one consumer. Every index has a
+ *                       single writer, so only plain loads and stores are
+ *                       needed: no read-modify-write, no LDREX/STREX.
+ *                       Works on Cortex-M0/M0+ as on the host.
+ *     MpscQueue<T, N>   Several producers (ISRs of different priority,
+ *                       the main loop, threads), one consumer. Producers
+ *                       claim slots on the shared head; each slot has its
+ *                       own "written" sequence, so a producer that is
+ *                       interrupted after its claim only delays the
+ *                       consumer, it never corrupts or blocks the others.
+ *
+ *   Both queues never wait: push() on a full queue returns false and
+ *   counts the item as dropped, pop() on an empty queue returns false.
+ *   pushBatch()/popBatch() move several items for one index update.
+ *
+ * Performance (host):
+ *   - Producer and consumer indices sit on separate cache lines
+ *     (CACHE_LINE bytes apart), so the two sides do not invalidate each
+ *     other's line on every operation (false sharing)
+ *   - Each side keeps a cached copy of the other side's index and only
+ *     re-reads the shared one when the cached value says full/empty
+ *
+ * Cortex-M0/M0+ (ARMv6-M, no LDREX/STREX):
+ *   - SpscQueue is unchanged: aligned 32-bit loads and stores are atomic
+ *   - MpscQueue claims its slots with interrupts masked for a few
+ *     instructions instead of a compare-and-swap loop. That is safe for
+ *     producers on one core (ISRs and the main loop); between the two
+ *     cores of an RP2040 use one SpscQueue per producer core instead
+ *
+ * Rules:
+ *   - CAPACITY is a power of two: index wrap is a mask, indices run freely
+ *   - T is copied in and out; keep it small and trivially copyable
+ *   - Exactly one consumer. For SpscQueue also exactly one producer
+ *
+ * =============================================================================
+ */
+
+namespace lockfree_queue {
+
+#if defined(ARDUINO) || defined(STM32) || defined(__ARM_ARCH_6M__) || defined(__ARM_ARCH_7M__) || \
+    defined(__ARM_ARCH_7EM__)
+static constexpr size_t CACHE_LINE = 4;    // No data cache: padding only wastes RAM
+#else
+static constexpr size_t CACHE_LINE = 64;
+#endif
+
+namespace detail {
+
+#if defined(__ARM_ARCH_6M__)
+/**
+ * @brief Masks interrupts for its lifetime, restores the previous state
+ */
+class InterruptLock {
+public:
+    InterruptLock() {
+        __asm__ volatile("mrs %0, primask\n\tcpsid i" : "=r"(primask_) : : "memory");
+    }
+    ~InterruptLock() {
+        __asm__ volatile("msr primask, %0" : : "r"(primask_) : "memory");
+    }
+
+    InterruptLock(const InterruptLock&) = delete;
+    InterruptLock& operator=(const InterruptLock&) = delete;
+
+private:
+    uint32_t primask_;
+};
+#endif
+
+// Index with a cache line of its own
+struct alignas(CACHE_LINE) PaddedIndex {
+    std::atomic<uint32_t> value{0};
+};
+
+}  // namespace detail
+
+// ============================================================================
+// Single Producer, Single Consumer
+// ============================================================================
+
+/**
+ * @brief Bounded FIFO for one producer and one consumer
+ *
+ * The producer writes head_ and the slots, the consumer writes tail_.
+ * The release store of head_ publishes the items written before it,
+ * the release store of tail_ hands the slots back.
+ */
+template<typename T, size_t CAPACITY>
+class SpscQueue {
+    static_assert(CAPACITY >= 2 && (CAPACITY & (CAPACITY - 1)) == 0,
+                  "CAPACITY must be a power of two");
+    static_assert(CAPACITY <= 0x80000000UL, "CAPACITY must fit the 32-bit indices");
+
+public:
+    SpscQueue() : buffer_{} {}
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // ---- Producer side -------------------------------------------------
+
+    bool push(const T& item) {
+        const uint32_t head = head_.value.load(std::memory_order_relaxed);
+        if (head - producer_.cachedTail >= CAPACITY) {
+            producer_.cachedTail = tail_.value.load(std::memory_order_acquire);
+            if (head - producer_.cachedTail >= CAPACITY) {
+                countDropped(1);
+                return false;
+            }
+        }
+        buffer_[head & MASK] = item;
+        head_.value.store(head + 1, std::memory_order_release);  // Publish after the data
+        return true;
+    }
+
+    /**
+     * @brief Push up to count items, oldest first, with one publish
+     * @return Items pushed; the rest are counted as dropped
+     */
+    size_t pushBatch(const T* items, size_t count) {
+        const uint32_t head = head_.value.load(std::memory_order_relaxed);
+        size_t space = CAPACITY - (head - producer_.cachedTail);
+        if (space < count) {
+            producer_.cachedTail = tail_.value.load(std::memory_order_acquire);
+            space = CAPACITY - (head - producer_.cachedTail);
+        }
+        const size_t pushed = count < space ? count : space;
+        for (size_t i = 0; i < pushed; ++i) {
+            buffer_[(head + i) & MASK] = items[i];
+        }
+        if (pushed > 0) head_.value.store(head + static_cast<uint32_t>(pushed), std::memory_order_release);
+        if (pushed < count) countDropped(count - pushed);
+        return pushed;
+    }
+
+    // ---- Consumer side -------------------------------------------------
+
+    bool pop(T& item) {
+        const uint32_t tail = tail_.value.load(std::memory_order_relaxed);
+        if (consumer_.cachedHead == tail) {
+            consumer_.cachedHead = head_.value.load(std::memory_order_acquire);
+            if (consumer_.cachedHead == tail) return false;
+        }
+        item = buffer_[tail & MASK];
+        tail_.value.store(tail + 1, std::memory_order_release);  // Free the slot after reading
+        return true;
+    }
+
+    /**
+     * @brief Pop up to maxItems, oldest first, with one slot release
+     * @return Items copied to out
+     */
+    size_t popBatch(T* out, size_t maxItems) {
+        const uint32_t tail = tail_.value.load(std::memory_order_relaxed);
+        size_t available = consumer_.cachedHead - tail;
+        if (available < maxItems) {
+            consumer_.cachedHead = head_.value.load(std::memory_order_acquire);
+            available = consumer_.cachedHead - tail;
+        }
+        const size_t popped = maxItems < available ? maxItems : available;
+        for (size_t i = 0; i < popped; ++i) {
+            out[i] = buffer_[(tail + i) & MASK];
+        }
+        if (popped > 0) tail_.value.store(tail + static_cast<uint32_t>(popped), std::memory_order_release);
+        return popped;
+    }
+
+    // ---- Either side (a snapshot, may be stale by the time it is used) --
+
+    size_t size() const {
+        const uint32_t tail = tail_.value.load(std::memory_order_acquire);
+        return head_.value.load(std::memory_order_acquire) - tail;
+    }
+    bool isEmpty() const { return size() == 0; }
+    static constexpr size_t capacity() { return CAPACITY; }
+
+    uint32_t getDroppedCount() const { return producer_.dropped.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr uint32_t MASK = CAPACITY - 1;
+
+    // Single writer: a load and a store, no read-modify-write
+    void countDropped(size_t count) {
+        producer_.dropped.store(producer_.dropped.load(std::memory_order_relaxed) + static_cast<uint32_t>(count),
+                                std::memory_order_relaxed);
+    }
+
+    struct alignas(CACHE_LINE) ProducerState {
+        uint32_t cachedTail = 0;        // Last tail_ the producer saw
+        std::atomic<uint32_t> dropped{0};  // Written by the producer only
+    };
+
+    struct alignas(CACHE_LINE) ConsumerState {
+        uint32_t cachedHead = 0;        // Last head_ the consumer saw
+    };
+
+    detail::PaddedIndex head_;  // Written by the producer only
+    detail::PaddedIndex tail_;  // Written by the consumer only
+    ProducerState producer_;
+    ConsumerState consumer_;
+    alignas(CACHE_LINE) T buffer_[CAPACITY];
+};
+
+// ============================================================================
+// Multiple Producers, Single Consumer
+// ============================================================================
+
+/**
+ * @brief Bounded FIFO for any number of producers and one consumer
+ *
+ * A producer claims one or more consecutive positions by advancing
+ * head_ (compare-and-swap, or masked interrupts on ARMv6-M), copies its
+ * items and marks each slot written by storing position + 1 in the
+ * slot's sequence. The consumer takes slots in position order while
+ * their sequence says written, then advances tail_, which producers
+ * read to see the free space.
+ *
+ * Items are delivered in claim order. A producer preempted between its
+ * claim and its writes holds back the items behind it until it resumes;
+ * pop() returns false meanwhile, even though size() is not zero.
+ */
+template<typename T, size_t CAPACITY>
+class MpscQueue {
+    static_assert(CAPACITY >= 2 && (CAPACITY & (CAPACITY - 1)) == 0,
+                  "CAPACITY must be a power of two");
+    static_assert(CAPACITY <= 0x80000000UL, "CAPACITY must fit the 32-bit indices");
+
+public:
+    MpscQueue() : cachedHead_(0) {}
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    // ---- Producer side (any context) -----------------------------------
+
+    bool push(const T& item) { return pushBatch(&item, 1) == 1; }
+
+    /**
+     * @brief Push up to count items as one consecutive run
+     * @return Items pushed; the rest are counted as dropped
+     */
+    size_t pushBatch(const T* items, size_t count) {
+        uint32_t first = 0;
+        const size_t claimed = claim(count, first);
+        for (size_t i = 0; i < claimed; ++i) {
+            const uint32_t position = first + static_cast<uint32_t>(i);
+            Slot& slot = slots_[position & MASK];
+            slot.item = items[i];
+            slot.sequence.store(position + 1, std::memory_order_release);  // Written
+        }
+        return claimed;
+    }
+
+    // ---- Consumer side -------------------------------------------------
+
+    bool pop(T& item) { return popBatch(&item, 1) == 1; }
+
+    /**
+     * @brief Pop up to maxItems written items, oldest first
+     * @return Items copied to out
+     */
+    size_t popBatch(T* out, size_t maxItems) {
+        const uint32_t tail = tail_.value.load(std::memory_order_relaxed);
+        size_t popped = 0;
+        while (popped < maxItems) {
+            const uint32_t position = tail + static_cast<uint32_t>(popped);
+            if (position == cachedHead_) {
+                cachedHead_ = head_.value.load(std::memory_order_acquire);
+                if (position == cachedHead_) break;
+            }
+            Slot& slot = slots_[position & MASK];
+            if (slot.sequence.load(std::memory_order_acquire) != position + 1) break;  // Claimed, not written yet
+            out[popped++] = slot.item;
+        }
+        if (popped > 0) tail_.value.store(tail + static_cast<uint32_t>(popped), std::memory_order_release);
+        return popped;
+    }
+
+    // ---- Either side ---------------------------------------------------
+
+    /** Claimed positions not yet consumed (includes items still being written) */
+    size_t size() const {
+        const uint32_t tail = tail_.value.load(std::memory_order_acquire);
+        return head_.value.load(std::memory_order_acquire) - tail;
+    }
+    bool isEmpty() const { return size() == 0; }
+    static constexpr size_t capacity() { return CAPACITY; }
+    uint32_t getDroppedCount() const { return dropped_.value.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr uint32_t MASK = CAPACITY - 1;
+
+    struct Slot {
+        std::atomic<uint32_t> sequence{0};  // Position + 1 once written
+        T item{};
+    };
+
+    // Reserve up to count positions starting at first; counts the rest as dropped
+    size_t claim(size_t count, uint32_t& first) {
+        size_t claimed = 0;
+#if defined(__ARM_ARCH_6M__)
+        {
+            detail::InterruptLock lock;  // No CAS on ARMv6-M; a few instructions only
+            const uint32_t head = head_.value.load(std::memory_order_relaxed);
+            const size_t space = CAPACITY - (head - tail_.value.load(std::memory_order_acquire));
+            claimed = count < space ? count : space;
+            head_.value.store(head + static_cast<uint32_t>(claimed), std::memory_order_relaxed);
+            if (claimed < count) {
+                dropped_.value.store(dropped_.value.load(std::memory_order_relaxed) +
+                                     static_cast<uint32_t>(count - claimed), std::memory_order_relaxed);
+            }
+            first = head;
+        }
+#else
+        uint32_t head = head_.value.load(std::memory_order_relaxed);
+        for (;;) {
+            const uint32_t tail = tail_.value.load(std::memory_order_acquire);
+            const uint32_t used = head - tail;
+            if (used > CAPACITY) {  // head is stale: the consumer passed it
+                head = head_.value.load(std::memory_order_relaxed);
+                continue;
+            }
+            const size_t space = CAPACITY - used;
+            claimed = count < space ? count : space;
+            if (claimed == 0) break;
+            if (head_.value.compare_exchange_weak(head, head + static_cast<uint32_t>(claimed),
+                                                  std::memory_order_acq_rel, std::memory_order_relaxed)) {
+                break;
+            }
+            // head was reloaded by the failed exchange
+        }
+        if (claimed < count) {
+            dropped_.value.fetch_add(static_cast<uint32_t>(count - claimed), std::memory_order_relaxed);
+        }
+        first = head;
+#endif
+        return claimed;
+    }
+
+    detail::PaddedIndex head_;     // Shared by the producers
+    detail::PaddedIndex dropped_;  // Shared by the producers
+    detail::PaddedIndex tail_;     // Written by the consumer only
+    alignas(CACHE_LINE) uint32_t cachedHead_;  // Consumer's copy of head_
+    Slot slots_[CAPACITY];
+};
+
+}  // namespace lockfree_queue
+
+#endif  // LOCK_FREE_QUEUE_HPP
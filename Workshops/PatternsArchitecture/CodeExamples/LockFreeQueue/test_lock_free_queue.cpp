@@ -0,0 +1,266 @@
+#include "CppUTest/TestHarness.h"
+#include "LockFreeQueue.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace lockfree_queue;
+
+// ============================================================================
+// SpscQueue Tests
+// ============================================================================
+
+TEST_GROUP(SpscQueue) {
+    SpscQueue<int, 4> queue;
+};
+
+TEST(SpscQueue, StartsEmpty) {
+    CHECK_TRUE(queue.isEmpty());
+    LONGS_EQUAL(0, queue.size());
+    LONGS_EQUAL(4, queue.capacity());
+    int value = 0;
+    CHECK_FALSE(queue.pop(value));
+}
+
+TEST(SpscQueue, PreservesOrder) {
+    queue.push(1);
+    queue.push(2);
+    queue.push(3);
+
+    int value = 0;
+    CHECK_TRUE(queue.pop(value));
+    LONGS_EQUAL(1, value);
+    CHECK_TRUE(queue.pop(value));
+    LONGS_EQUAL(2, value);
+    CHECK_TRUE(queue.pop(value));
+    LONGS_EQUAL(3, value);
+    CHECK_FALSE(queue.pop(value));
+}
+
+TEST(SpscQueue, DropsWhenFull) {
+    for (int i = 0; i < 4; ++i) {
+        CHECK_TRUE(queue.push(i));
+    }
+    CHECK_FALSE(queue.push(99));
+    LONGS_EQUAL(4, queue.size());
+    LONGS_EQUAL(1, queue.getDroppedCount());
+
+    int value = 0;
+    queue.pop(value);
+    CHECK_TRUE(queue.push(4));  // Cached tail is refreshed when it says full
+}
+
+TEST(SpscQueue, WrapsAround) {
+    int value = 0;
+    for (int i = 0; i < 100; ++i) {
+        CHECK_TRUE(queue.push(i));
+        CHECK_TRUE(queue.pop(value));
+        LONGS_EQUAL(i, value);
+    }
+    CHECK_TRUE(queue.isEmpty());
+}
+
+TEST(SpscQueue, PushBatchTakesWhatFits) {
+    const int items[] = {1, 2, 3, 4, 5, 6};
+    queue.push(0);
+
+    LONGS_EQUAL(3, queue.pushBatch(items, 6));
+    LONGS_EQUAL(3, queue.getDroppedCount());
+    LONGS_EQUAL(4, queue.size());
+}
+
+TEST(SpscQueue, PopBatchAcrossTheWrap) {
+    int value = 0;
+    queue.push(0);
+    queue.push(0);
+    queue.pop(value);
+    queue.pop(value);  // Indices now at 2
+
+    const int items[] = {10, 11, 12, 13};
+    LONGS_EQUAL(4, queue.pushBatch(items, 4));
+
+    int out[8] = {};
+    LONGS_EQUAL(4, queue.popBatch(out, 8));
+    LONGS_EQUAL(10, out[0]);
+    LONGS_EQUAL(13, out[3]);
+    LONGS_EQUAL(0, queue.popBatch(out, 8));
+}
+
+TEST(SpscQueue, PopBatchOfPartOfTheItems) {
+    for (int i = 0; i < 3; ++i) queue.push(i);
+
+    int out[2] = {};
+    LONGS_EQUAL(2, queue.popBatch(out, 2));
+    LONGS_EQUAL(1, queue.size());
+    LONGS_EQUAL(1, out[1]);
+}
+
+TEST(SpscQueue, IndicesOnSeparateCacheLines) {
+    // The producer and consumer state must not share a line on the host
+    CHECK_TRUE(sizeof(SpscQueue<uint8_t, 2>) >= 4 * CACHE_LINE);
+}
+
+TEST(SpscQueue, ThreadsDeliverEveryItemInOrder) {
+    static SpscQueue<uint32_t, 64> shared;
+    const uint32_t COUNT = 200000;
+
+    std::thread producer([&]() {
+        uint32_t batch[5];
+        uint32_t next = 0;
+        while (next < COUNT) {
+            // Mix single pushes and batches
+            if ((next & 1) == 0) {
+                if (shared.push(next)) {
+                    next++;
+                    continue;
+                }
+            } else {
+                size_t n = 0;
+                while (n < 5 && next + n < COUNT) {
+                    batch[n] = next + static_cast<uint32_t>(n);
+                    n++;
+                }
+                const size_t pushed = shared.pushBatch(batch, n);
+                next += static_cast<uint32_t>(pushed);
+                if (pushed > 0) continue;
+            }
+            std::this_thread::yield();  // Full: let the consumer run on a single core
+        }
+    });
+
+    uint32_t expected = 0;
+    bool inOrder = true;
+    uint32_t out[7];
+    while (expected < COUNT) {
+        const size_t n = shared.popBatch(out, 7);
+        if (n == 0) std::this_thread::yield();
+        for (size_t i = 0; i < n; ++i) {
+            if (out[i] != expected) inOrder = false;
+            expected++;
+        }
+    }
+    producer.join();
+
+    CHECK_TRUE(inOrder);
+    CHECK_TRUE(shared.isEmpty());
+}
+
+// ============================================================================
+// MpscQueue Tests
+// ============================================================================
+
+TEST_GROUP(MpscQueue) {
+    MpscQueue<int, 4> queue;
+};
+
+TEST(MpscQueue, StartsEmpty) {
+    CHECK_TRUE(queue.isEmpty());
+    int value = 0;
+    CHECK_FALSE(queue.pop(value));
+}
+
+TEST(MpscQueue, PreservesOrder) {
+    queue.push(1);
+    queue.push(2);
+
+    int value = 0;
+    CHECK_TRUE(queue.pop(value));
+    LONGS_EQUAL(1, value);
+    CHECK_TRUE(queue.pop(value));
+    LONGS_EQUAL(2, value);
+    CHECK_FALSE(queue.pop(value));
+}
+
+TEST(MpscQueue, DropsWhenFull) {
+    for (int i = 0; i < 4; ++i) {
+        CHECK_TRUE(queue.push(i));
+    }
+    CHECK_FALSE(queue.push(99));
+    LONGS_EQUAL(1, queue.getDroppedCount());
+
+    int out[4] = {};
+    LONGS_EQUAL(4, queue.popBatch(out, 4));
+    LONGS_EQUAL(3, out[3]);
+}
+
+TEST(MpscQueue, WrapsAround) {
+    int value = 0;
+    for (int i = 0; i < 100; ++i) {
+        CHECK_TRUE(queue.push(i));
+        CHECK_TRUE(queue.pop(value));
+        LONGS_EQUAL(i, value);
+    }
+}
+
+TEST(MpscQueue, PushBatchTakesWhatFits) {
+    const int items[] = {1, 2, 3, 4, 5};
+    queue.push(0);
+
+    LONGS_EQUAL(3, queue.pushBatch(items, 5));
+    LONGS_EQUAL(2, queue.getDroppedCount());
+
+    int out[8] = {};
+    LONGS_EQUAL(4, queue.popBatch(out, 8));
+    LONGS_EQUAL(0, out[0]);
+    LONGS_EQUAL(3, out[3]);
+}
+
+TEST(MpscQueue, ThreadsDeliverEveryItemOncePerProducerInOrder) {
+    static MpscQueue<uint32_t, 128> shared;
+    const uint32_t PRODUCERS = 4;
+    const uint32_t PER_PRODUCER = 50000;
+
+    // Item: producer id in the top byte, sequence number below
+    std::vector<std::thread> producers;
+    for (uint32_t id = 0; id < PRODUCERS; ++id) {
+        producers.emplace_back([id]() {
+            uint32_t sequence = 0;
+            uint32_t batch[3];
+            while (sequence < PER_PRODUCER) {
+                if (sequence % 3 == 0) {
+                    if (shared.push((id << 24) | sequence)) {
+                        sequence++;
+                        continue;
+                    }
+                } else {
+                    size_t n = 0;
+                    while (n < 3 && sequence + n < PER_PRODUCER) {
+                        batch[n] = (id << 24) | (sequence + static_cast<uint32_t>(n));
+                        n++;
+                    }
+                    const size_t pushed = shared.pushBatch(batch, n);
+                    sequence += static_cast<uint32_t>(pushed);
+                    if (pushed > 0) continue;
+                }
+                std::this_thread::yield();
+            }
+        });
+    }
+
+    uint32_t next[PRODUCERS] = {};
+    bool inOrder = true;
+    uint32_t received = 0;
+    uint32_t out[16];
+    while (received < PRODUCERS * PER_PRODUCER) {
+        const size_t n = shared.popBatch(out, 16);
+        if (n == 0) std::this_thread::yield();
+        for (size_t i = 0; i < n; ++i) {
+            const uint32_t id = out[i] >> 24;
+            const uint32_t sequence = out[i] & 0xFFFFFFU;
+            if (id >= PRODUCERS || sequence != next[id]) {
+                inOrder = false;
+            } else {
+                next[id]++;
+            }
+            received++;
+        }
+    }
+    for (std::thread& producer : producers) producer.join();
+
+    CHECK_TRUE(inOrder);
+    for (uint32_t id = 0; id < PRODUCERS; ++id) {
+        LONGS_EQUAL(PER_PRODUCER, next[id]);
+    }
+    CHECK_TRUE(shared.isEmpty());
+}
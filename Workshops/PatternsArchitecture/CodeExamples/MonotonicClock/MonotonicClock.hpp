@@ -0,0 +1,221 @@
+#ifndef MONOTONIC_CLOCK_HPP
+#define MONOTONIC_CLOCK_HPP
+
+#include <cstdint>
+
+#if !defined(STM32) && !defined(ARDUINO)
+#include <chrono>
+#endif
+
+/**
+ * =============================================================================
+ * MONOTONIC CLOCK PATTERN (64-bit extension of a wrapping timer)
+ * =============================================================================
+ *
+ * Problem:
+ *   Every module keeps its own time: the cyclic executive counts 32-bit
+ *   milliseconds, the stepper code uses micros() (wraps every ~71.6
+ *   minutes), HeartBeat stores a long. Deadlines, trace stamps and
+ *   sample times near a wrap need care in every single place.
+ *
+ * Solution:
+ *   One clock that extends a wrapping hardware counter to 64 bits.
+ *   At 1 MHz that lasts far longer than any device: no wrap handling
+ *   anywhere, plain subtraction and comparison of uint64_t values.
+ *
+ *   The extension keeps one 32-bit word in RAM: the counter value of the
+ *   last read divided by half the counter range (its "epoch"). A new
+ *   read is at most one epoch further, and the top bit of the hardware
+ *   counter tells whether it is. So a read needs no lock and no retry
+ *   loop, and it is safe in interrupts: a read preempted by another read
+ *   only stores an epoch that is one behind, which is still correct.
+ *
+ * Requirement:
+ *   The clock must be read (now() or refresh()) at least once per half
+ *   counter range: every 35 minutes for a 32-bit microsecond counter,
+ *   every 32 ms for a 16-bit timer at 1 MHz (its overflow interrupt).
+ *
+ * Advantages:
+ *   - Wrap-free timestamps for scheduling, tracing and sample stamping
+ *   - Lock-free, constant time read, usable in ISRs
+ *   - 4 bytes of state, any counter width
+ *
+ * Disadvantages:
+ *   - Silently wrong if no read happens for half the counter range
+ *   - 64-bit arithmetic costs a few extra instructions on 8/32-bit MCUs
+ *
+ * =============================================================================
+ */
+
+namespace monotonic_clock {
+
+// ============================================================================
+// Counter Sources
+// ============================================================================
+
+/**
+ * A source provides:
+ *   static constexpr unsigned BITS = ...;   // counter width, 2..32
+ *   static uint32_t read();                 // free running, wraps at 2^BITS
+ */
+
+#if defined(ARDUINO)
+
+/**
+ * @brief Arduino micros(): the core extends a hardware timer to 32 bits
+ *
+ * SysTick on SAMD, Timer0 overflows on AVR; safe to call from an ISR.
+ */
+struct MicrosSource {
+    static constexpr unsigned BITS = 32;
+    static uint32_t read() { return micros(); }
+};
+
+#elif !defined(STM32)
+
+/**
+ * @brief Host source: std::chrono::steady_clock, truncated to 32-bit us
+ */
+struct SteadyMicrosSource {
+    static constexpr unsigned BITS = 32;
+    static uint32_t read() {
+        return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+};
+
+#endif
+
+// ============================================================================
+// Epoch Storage
+// ============================================================================
+
+/**
+ * @brief Default: a plain volatile word
+ *
+ * 32-bit loads and stores are single instructions on Cortex-M and on
+ * hosts, so an interrupted read never sees half an update.
+ */
+struct VolatileEpoch {
+    static uint32_t load(const volatile uint32_t& epoch) { return epoch; }
+    static void store(volatile uint32_t& epoch, uint32_t value) { epoch = value; }
+};
+
+#if defined(__AVR__)
+
+/**
+ * @brief AVR: a 32-bit access is four byte accesses, keep them together
+ */
+struct AvrEpoch {
+    static uint32_t load(const volatile uint32_t& epoch) {
+        const uint8_t sreg = SREG;
+        cli();
+        const uint32_t value = epoch;
+        SREG = sreg;
+        return value;
+    }
+    static void store(volatile uint32_t& epoch, uint32_t value) {
+        const uint8_t sreg = SREG;
+        cli();
+        epoch = value;
+        SREG = sreg;
+    }
+};
+
+using DefaultEpoch = AvrEpoch;
+#else
+using DefaultEpoch = VolatileEpoch;
+#endif
+
+// ============================================================================
+// Extended Clock
+// ============================================================================
+
+/**
+ * @brief 64-bit monotonic time from a wrapping counter
+ *
+ * now() = epoch * 2^(BITS-1) + lower BITS-1 bits of the counter. The
+ * extended value covers 2^(BITS+31) counts: 292 000 years for a 32-bit
+ * microsecond counter, 4.4 years for a 16-bit timer at 1 MHz.
+ *
+ * Usage:
+ *   using Clock = ExtendedClock<MicrosSource>;
+ *   Clock clock;
+ *   const uint64_t t = clock.now();   // main loop or ISR
+ *
+ * @tparam Source Counter source (BITS, read())
+ * @tparam Epoch  Access to the epoch word (DefaultEpoch fits the target)
+ */
+template<typename Source, typename Epoch = DefaultEpoch>
+class ExtendedClock {
+public:
+    static_assert(Source::BITS >= 2 && Source::BITS <= 32, "Counter width must be 2..32 bits");
+
+    static constexpr unsigned HALF_BITS = Source::BITS - 1;
+    static constexpr uint32_t HALF_MASK = (uint32_t(1) << HALF_BITS) - 1;
+    static constexpr uint32_t COUNTER_MASK = HALF_MASK | (uint32_t(1) << HALF_BITS);
+
+    /** Longest allowed time between two reads, in counts */
+    static constexpr uint32_t MAX_READ_INTERVAL = HALF_MASK;
+
+    ExtendedClock() : epoch_(0) {}
+
+    /**
+     * @brief Counter value extended to 64 bits
+     *
+     * Lock-free and safe from ISRs. The epoch is read before the
+     * counter: the counter is then never older than the epoch.
+     */
+    uint64_t now() {
+        const uint32_t epoch = Epoch::load(epoch_);
+        const uint32_t counter = Source::read() & COUNTER_MASK;
+
+        // Bit 0 of the epoch is the top counter bit at the last read; if
+        // it differs now, the counter moved into the next half
+        const uint32_t current = epoch + (((counter >> HALF_BITS) ^ epoch) & 1U);
+        if (current != epoch) {
+            Epoch::store(epoch_, current);
+        }
+        return (static_cast<uint64_t>(current) << HALF_BITS) | (counter & HALF_MASK);
+    }
+
+    /**
+     * @brief Keep the epoch current without using the time
+     *
+     * Call from any periodic place (a tick ISR, the main loop) when
+     * now() itself may not run for half the counter range.
+     */
+    void refresh() { (void)now(); }
+
+    /**
+     * @brief Start over after the counter itself was restarted from zero
+     *
+     * Time then starts at zero again: only before any stored stamp is used.
+     */
+    void reset() { Epoch::store(epoch_, 0); }
+
+private:
+    volatile uint32_t epoch_;
+};
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+/**
+ * @brief True once a 64-bit deadline has passed (no wrap, plain compare)
+ */
+inline bool isDue(uint64_t now, uint64_t deadline) {
+    return now >= deadline;
+}
+
+/**
+ * @brief Microseconds to milliseconds, e.g. for CyclicExecutive periods
+ */
+inline uint64_t toMillis(uint64_t us) {
+    return us / 1000U;
+}
+
+} // namespace monotonic_clock
+
+#endif // MONOTONIC_CLOCK_HPP
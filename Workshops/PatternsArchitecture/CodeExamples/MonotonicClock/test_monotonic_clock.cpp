@@ -0,0 +1,188 @@
+#include "CppUTest/TestHarness.h"
+#include "MonotonicClock.hpp"
+
+using namespace monotonic_clock;
+
+// ============================================================================
+// Fake counter sources
+// ============================================================================
+
+namespace {
+
+/**
+ * Counter set by the test; onRead runs inside read(), like an interrupt
+ * that fires between the epoch load and the counter read.
+ */
+template<unsigned WIDTH>
+struct FakeSource {
+    static constexpr unsigned BITS = WIDTH;
+    static uint32_t value;
+    static void (*onRead)();
+
+    static uint32_t read() {
+        if (onRead) {
+            void (*hook)() = onRead;
+            onRead = nullptr;  // One interrupt, no recursion
+            hook();
+        }
+        return value;
+    }
+};
+
+template<unsigned WIDTH> uint32_t FakeSource<WIDTH>::value = 0;
+template<unsigned WIDTH> void (*FakeSource<WIDTH>::onRead)() = nullptr;
+
+using Source32 = FakeSource<32>;
+using Source16 = FakeSource<16>;
+
+ExtendedClock<Source32>* isrClock = nullptr;
+uint64_t isrTime = 0;
+
+void isrReadAfterWrap() {
+    Source32::value = 0x00000100;
+    isrTime = isrClock->now();
+}
+
+} // namespace
+
+// ============================================================================
+// ExtendedClock Tests
+// ============================================================================
+
+TEST_GROUP(ExtendedClock) {
+    void setup() {
+        Source32::value = 0;
+        Source32::onRead = nullptr;
+        Source16::value = 0;
+        Source16::onRead = nullptr;
+    }
+};
+
+TEST(ExtendedClock, StartsAtTheCounterValue) {
+    ExtendedClock<Source32> clock;
+    Source32::value = 123456;
+
+    UNSIGNED_LONGS_EQUAL(123456, clock.now());
+}
+
+TEST(ExtendedClock, UpperHalfOfFirstReadIsNotAWrap) {
+    ExtendedClock<Source32> clock;
+    Source32::value = 0xC0000000;
+
+    CHECK(clock.now() == 0xC0000000ULL);
+}
+
+TEST(ExtendedClock, ContinuesPastThe32BitWrap) {
+    ExtendedClock<Source32> clock;
+    Source32::value = 0xFFFFFFF0;
+    CHECK(clock.now() == 0xFFFFFFF0ULL);
+
+    Source32::value = 0x00000010;
+    CHECK(clock.now() == 0x100000010ULL);
+
+    Source32::value = 0x80000000;
+    CHECK(clock.now() == 0x180000000ULL);
+}
+
+TEST(ExtendedClock, TracksManyWrapsOfA16BitTimer) {
+    ExtendedClock<Source16> clock;
+    uint64_t expected = 0;
+    uint64_t previous = 0;
+
+    // Uneven steps below half the range, about 300 wraps
+    for (uint32_t i = 0; i < 20000; i++) {
+        expected += (i * 7919U) % ExtendedClock<Source16>::MAX_READ_INTERVAL;
+        Source16::value = static_cast<uint32_t>(expected & 0xFFFF);
+        const uint64_t t = clock.now();
+        CHECK(t == expected);
+        CHECK(t >= previous);
+        previous = t;
+    }
+    CHECK(expected > (300ULL << 16));
+}
+
+TEST(ExtendedClock, IgnoresBitsAboveTheCounterWidth) {
+    ExtendedClock<Source16> clock;
+    Source16::value = 0xABCD1234;  // Register read with stale upper bits
+
+    UNSIGNED_LONGS_EQUAL(0x1234, clock.now());
+}
+
+TEST(ExtendedClock, StepOfMaxReadIntervalIsStillTracked) {
+    ExtendedClock<Source16> clock;
+    Source16::value = 0x7000;
+    clock.now();
+
+    Source16::value = (0x7000 + ExtendedClock<Source16>::MAX_READ_INTERVAL) & 0xFFFF;
+    CHECK(clock.now() == 0x7000ULL + ExtendedClock<Source16>::MAX_READ_INTERVAL);
+}
+
+TEST(ExtendedClock, RefreshKeepsAnIdleClockCorrect) {
+    ExtendedClock<Source16> clock;
+    uint64_t expected = 0;
+
+    // A tick refreshes every 0x6000 counts, the time is only read rarely
+    for (int i = 0; i < 64; i++) {
+        expected += 0x6000;
+        Source16::value = static_cast<uint32_t>(expected & 0xFFFF);
+        clock.refresh();
+    }
+    CHECK(clock.now() == expected);
+}
+
+TEST(ExtendedClock, ReadInterruptedByAnotherReadStaysMonotonic) {
+    ExtendedClock<Source32> clock;
+    Source32::value = 0xFFFFFF00;
+    clock.now();
+
+    // The "ISR" sees the wrap first and stores the new epoch; the
+    // interrupted read then continues with the epoch it loaded before
+    isrClock = &clock;
+    Source32::onRead = isrReadAfterWrap;
+    const uint64_t interrupted = clock.now();
+
+    CHECK(isrTime == 0x100000100ULL);
+    CHECK(interrupted == 0x100000100ULL);
+
+    Source32::value = 0x00000200;
+    CHECK(clock.now() == 0x100000200ULL);
+}
+
+TEST(ExtendedClock, ResetStartsOverAtTheCounter) {
+    ExtendedClock<Source32> clock;
+    Source32::value = 0xFFFFFFF0;
+    clock.now();
+    Source32::value = 0x10;
+    clock.now();
+
+    clock.reset();
+    Source32::value = 0x20;
+    UNSIGNED_LONGS_EQUAL(0x20, clock.now());
+}
+
+// ============================================================================
+// Helper Tests
+// ============================================================================
+
+TEST_GROUP(ClockHelpers) {};
+
+TEST(ClockHelpers, DeadlinePastThe32BitWrapIsPlainComparison) {
+    const uint64_t deadline = 0x100000010ULL;
+
+    CHECK_FALSE(isDue(0xFFFFFFF0ULL, deadline));
+    CHECK_TRUE(isDue(0x100000010ULL, deadline));
+    CHECK_TRUE(isDue(0x200000000ULL, deadline));
+}
+
+TEST(ClockHelpers, ConvertsToMillis) {
+    CHECK(toMillis(0x100000000ULL) == 4294967ULL);
+    UNSIGNED_LONGS_EQUAL(0, toMillis(999));
+}
+
+TEST(ClockHelpers, SteadySourceIsMonotonicOnTheHost) {
+    ExtendedClock<SteadyMicrosSource> clock;
+    const uint64_t first = clock.now();
+    const uint64_t second = clock.now();
+
+    CHECK(second >= first);
+}
@@ -0,0 +1,298 @@
+#ifndef EVENT_BUS_HPP
+#define EVENT_BUS_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "Observer.hpp"
+
+/**
+ * =============================================================================
+ * TYPED EVENT BUS (topics are types)
+ * =============================================================================
+ *
+ * Problem:
+ *   Every new kind of event needs its own observer interface and subject
+ *   class (IButtonObserver + ButtonSubject, ITemperatureObserver +
+ *   TemperatureSubject), each with its own attach/notify boilerplate.
+ *   A generic bus with string or integer topics avoids that, but then
+ *   every publish looks the topic up at runtime and the payload is cast.
+ *
+ * Solution:
+ *   The event type is the topic. A subscriber handles a topic by having
+ *   onEvent(const Event&). Routing is overload resolution and template
+ *   selection, done by the compiler:
+ *
+ *   - StaticEventBus<Subscribers...>: the subscriber set is fixed at
+ *     compile time (like StaticSubject). publish(event) expands into a
+ *     direct call to every subscriber that handles that type and to no
+ *     other; a topic with no subscribers compiles to nothing.
+ *   - EventBus<MAX, Topics...>: one fixed table of ISubscriber<Event>*
+ *     per topic (like ButtonSubject). subscribe()/unsubscribe() at
+ *     runtime; publish(event) picks the topic's table at compile time and
+ *     walks only that table.
+ *
+ *   publishBatch(events, count) delivers an array of events of one topic,
+ *   subscriber by subscriber, so each handler stays hot in the cache for
+ *   the whole batch. dispatchPending() drains an EventQueue that way.
+ *
+ * Cost:
+ *   No topic ids, no lookup, no casts. Adding a topic costs one table
+ *   (EventBus) or nothing (StaticEventBus) for the buses that carry it,
+ *   and nothing for the others.
+ *
+ * Usage:
+ *   struct Display : ISubscriber<TemperatureReading>, ISubscriber<ButtonPressed> {
+ *       void onEvent(const TemperatureReading& event) override;
+ *       void onEvent(const ButtonPressed& event) override;
+ *   };
+ *
+ *   EventBus<4, ButtonPressed, ButtonReleased, TemperatureReading> bus;
+ *   bus.subscribe<TemperatureReading>(&display);
+ *   bus.publish(TemperatureReading{21.5f});
+ *
+ * =============================================================================
+ */
+
+namespace observer {
+
+// ============================================================================
+// Topics
+// ============================================================================
+
+/*
+ * Any copyable type is a topic. These carry what the button and
+ * temperature observer interfaces carry.
+ */
+
+struct ButtonPressed {
+    uint8_t buttonId;
+};
+
+struct ButtonReleased {
+    uint8_t buttonId;
+};
+
+struct TemperatureReading {
+    float celsius;
+};
+
+// ============================================================================
+// Subscriber Interface
+// ============================================================================
+
+/**
+ * @brief Runtime subscriber of one topic
+ *
+ * Replaces one hand-written observer interface per event kind: a class
+ * inherits ISubscriber<Event> once per topic it handles. Only needed for
+ * EventBus; StaticEventBus subscribers just have the onEvent() overloads.
+ */
+template<typename Event>
+class ISubscriber {
+public:
+    virtual ~ISubscriber() = default;
+    virtual void onEvent(const Event& event) = 0;
+};
+
+/**
+ * @brief True if Subscriber has onEvent(const Event&)
+ */
+template<typename Subscriber, typename Event, typename = void>
+struct Handles : std::false_type {};
+
+template<typename Subscriber, typename Event>
+struct Handles<Subscriber, Event,
+               std::void_t<decltype(std::declval<Subscriber&>().onEvent(std::declval<const Event&>()))>>
+    : std::true_type {};
+
+// ============================================================================
+// Static Event Bus (subscribers fixed at compile time)
+// ============================================================================
+
+/**
+ * @brief Bus whose subscribers are template parameters
+ *
+ * Owns its subscribers in a std::tuple, like StaticSubject. For each
+ * publish the fold keeps only the subscribers that handle the event type
+ * (if constexpr), so each call is direct and can be inlined.
+ *
+ * Usage:
+ *   StaticEventBus<LedDriver, Logger> bus;
+ *   bus.publish(ButtonPressed{1});      // Both, if both handle it
+ *   bus.get<Logger>().getCount();
+ *
+ * Trade-off: no subscribe()/unsubscribe() at runtime.
+ */
+template<typename... Subscribers>
+class StaticEventBus {
+public:
+    static constexpr size_t SUBSCRIBER_COUNT = sizeof...(Subscribers);
+
+    StaticEventBus() = default;
+    explicit StaticEventBus(const Subscribers&... subscribers) : subscribers_(subscribers...) {}
+
+    template<typename Event>
+    void publish(const Event& event) {
+        std::apply([&event](auto&... subscriber) { (deliver(subscriber, event), ...); }, subscribers_);
+    }
+
+    /**
+     * @brief Deliver count events of one topic, subscriber by subscriber
+     */
+    template<typename Event>
+    void publishBatch(const Event* events, size_t count) {
+        std::apply([events, count](auto&... subscriber) { (deliverBatch(subscriber, events, count), ...); },
+                   subscribers_);
+    }
+
+    /** Number of subscribers of a topic; zero is allowed */
+    template<typename Event>
+    static constexpr size_t getSubscriberCount() {
+        return (size_t{0} + ... + (Handles<Subscribers, Event>::value ? 1 : 0));
+    }
+
+    template<size_t INDEX>
+    auto& get() { return std::get<INDEX>(subscribers_); }
+
+    template<typename Subscriber>
+    Subscriber& get() { return std::get<Subscriber>(subscribers_); }
+
+private:
+    template<typename Subscriber, typename Event>
+    static void deliver(Subscriber& subscriber, const Event& event) {
+        if constexpr (Handles<Subscriber, Event>::value) {
+            subscriber.onEvent(event);
+        }
+    }
+
+    template<typename Subscriber, typename Event>
+    static void deliverBatch(Subscriber& subscriber, const Event* events, size_t count) {
+        if constexpr (Handles<Subscriber, Event>::value) {
+            for (size_t i = 0; i < count; i++) {
+                subscriber.onEvent(events[i]);
+            }
+        }
+    }
+
+    std::tuple<Subscribers...> subscribers_;
+};
+
+// ============================================================================
+// Event Bus (fixed subscriber table per topic)
+// ============================================================================
+
+/**
+ * @brief Subscriber table of one topic
+ *
+ * Subscribers are notified in subscribe order; unsubscribe() keeps the
+ * order of the others (as ButtonSubject).
+ */
+template<typename Event, size_t MAX_SUBSCRIBERS = 4>
+class Topic {
+public:
+    using EventType = Event;
+
+    bool subscribe(ISubscriber<Event>* subscriber) {
+        return subscribers_.pushBack(subscriber);  // false: no room
+    }
+
+    bool unsubscribe(ISubscriber<Event>* subscriber) {
+        return subscribers_.remove(subscriber);
+    }
+
+    void publish(const Event& event) {
+        for (ISubscriber<Event>* subscriber : subscribers_) {
+            subscriber->onEvent(event);
+        }
+    }
+
+    void publishBatch(const Event* events, size_t count) {
+        for (ISubscriber<Event>* subscriber : subscribers_) {
+            for (size_t i = 0; i < count; i++) {
+                subscriber->onEvent(events[i]);
+            }
+        }
+    }
+
+    size_t getSubscriberCount() const { return subscribers_.size(); }
+
+private:
+    fixed_containers::StaticVector<ISubscriber<Event>*, MAX_SUBSCRIBERS> subscribers_;
+};
+
+/**
+ * @brief One Topic table per event type, selected at compile time
+ *
+ * The topics are the bus's template parameters: publishing a type the
+ * bus does not carry is a compile error, not a silent drop. RAM is one
+ * table of MAX_SUBSCRIBERS pointers per topic.
+ */
+template<size_t MAX_SUBSCRIBERS, typename... Events>
+class EventBus {
+public:
+    static constexpr size_t TOPIC_COUNT = sizeof...(Events);
+
+    template<typename Event>
+    bool subscribe(ISubscriber<Event>* subscriber) { return topic<Event>().subscribe(subscriber); }
+
+    template<typename Event>
+    bool unsubscribe(ISubscriber<Event>* subscriber) { return topic<Event>().unsubscribe(subscriber); }
+
+    template<typename Event>
+    void publish(const Event& event) { topic<Event>().publish(event); }
+
+    template<typename Event>
+    void publishBatch(const Event* events, size_t count) { topic<Event>().publishBatch(events, count); }
+
+    /**
+     * @brief Main loop side: deliver queued events in batches, oldest first
+     *
+     * Pops up to BATCH events into a local array and publishes them as a
+     * batch, until the queue is empty or maxEvents were delivered.
+     * @return Number of events delivered
+     */
+    template<size_t BATCH = 8, typename Event, size_t CAPACITY>
+    size_t dispatchPending(EventQueue<Event, CAPACITY>& queue, size_t maxEvents = CAPACITY) {
+        Event batch[BATCH];
+        size_t dispatched = 0;
+        while (dispatched < maxEvents) {
+            size_t count = 0;
+            while (count < BATCH && dispatched + count < maxEvents && queue.pop(batch[count])) {
+                count++;
+            }
+            if (count == 0) break;
+            publishBatch(batch, count);
+            dispatched += count;
+        }
+        return dispatched;
+    }
+
+    template<typename Event>
+    size_t getSubscriberCount() const { return topic<Event>().getSubscriberCount(); }
+
+    template<typename Event>
+    static constexpr bool carries() { return (std::is_same_v<Event, Events> || ...); }
+
+private:
+    template<typename Event>
+    Topic<Event, MAX_SUBSCRIBERS>& topic() {
+        static_assert(carries<Event>(), "event type is not a topic of this bus");
+        return std::get<Topic<Event, MAX_SUBSCRIBERS>>(topics_);
+    }
+
+    template<typename Event>
+    const Topic<Event, MAX_SUBSCRIBERS>& topic() const {
+        static_assert(carries<Event>(), "event type is not a topic of this bus");
+        return std::get<Topic<Event, MAX_SUBSCRIBERS>>(topics_);
+    }
+
+    std::tuple<Topic<Events, MAX_SUBSCRIBERS>...> topics_;
+};
+
+}  // namespace observer
+
+#endif  // EVENT_BUS_HPP
@@ -2,7 +2,13 @@
 #define OBSERVER_HPP
 
 #include <cstdint>
+#include <cstddef>
 #include <array>
+#include <atomic>
+#include <tuple>
+
+#include "../FixedContainers/FixedContainers.hpp"
+#include "../LockFreeQueue/LockFreeQueue.hpp"
 
 /**
  * =============================================================================
@@ -62,97 +68,497 @@ public:
 /**
  * @brief Button subject - notifies observers of button events
  *
- * Note: Uses fixed-size array to avoid dynamic allocation.
- * This is typical for embedded systems.
+ * Note: Uses a fixed-capacity vector to avoid dynamic allocation.
+ * This is typical for embedded systems. Observers are notified in
+ * attach order, so detach() keeps the order of the others.
  */
 template<size_t MAX_OBSERVERS = 4>
 class ButtonSubject {
 public:
-    ButtonSubject() : numObservers_(0) {}
-
     bool attach(IButtonObserver* observer) {
-        if (numObservers_ >= MAX_OBSERVERS) {
-            return false;  // No room
-        }
-        observers_[numObservers_++] = observer;
-        return true;
+        return observers_.pushBack(observer);  // false: no room
     }
 
     bool detach(IButtonObserver* observer) {
-        for (size_t i = 0; i < numObservers_; ++i) {
-            if (observers_[i] == observer) {
-                // Shift remaining observers
-                for (size_t j = i; j < numObservers_ - 1; ++j) {
-                    observers_[j] = observers_[j + 1];
-                }
-                numObservers_--;
-                return true;
-            }
-        }
-        return false;
+        return observers_.remove(observer);
     }
 
     // Called from ISR or polling loop when button state changes
     void notifyPressed(uint8_t buttonId) {
-        for (size_t i = 0; i < numObservers_; ++i) {
-            observers_[i]->onButtonPressed(buttonId);
+        for (IButtonObserver* observer : observers_) {
+            observer->onButtonPressed(buttonId);
         }
     }
 
     void notifyReleased(uint8_t buttonId) {
-        for (size_t i = 0; i < numObservers_; ++i) {
-            observers_[i]->onButtonReleased(buttonId);
+        for (IButtonObserver* observer : observers_) {
+            observer->onButtonReleased(buttonId);
         }
     }
 
-    size_t getObserverCount() const { return numObservers_; }
+    size_t getObserverCount() const { return observers_.size(); }
 
 private:
-    std::array<IButtonObserver*, MAX_OBSERVERS> observers_;
-    size_t numObservers_;
+    fixed_containers::StaticVector<IButtonObserver*, MAX_OBSERVERS> observers_;
 };
 
 /**
  * @brief Temperature sensor subject
+ *
+ * Coalescing (both off by default, every update notifies):
+ *   - Deadband: skip readings within +/- deadband of the last notified value
+ *   - Minimum interval: at most one notification per minIntervalMs
+ * Overtemperature readings always notify, safety is never rate-limited.
+ *
+ * Mailbox: storeLatest() only overwrites a single slot (cheap, ISR side),
+ * publishLatest() delivers the newest value through the same filter.
+ * Intermediate readings are simply lost, which is what a display wants.
+ *
+ * The minimum interval needs the time (free-running ms, e.g. millis()),
+ * so only updateTemperature(celsius, nowMs) and publishLatest() apply it.
+ * updateTemperature(celsius) has no time: it applies the deadband only
+ * and does not count as a notification for the interval.
  */
 template<size_t MAX_OBSERVERS = 4>
 class TemperatureSubject {
 public:
     TemperatureSubject(float threshold = 50.0f)
-        : numObservers_(0), threshold_(threshold), lastTemp_(0.0f) {}
+        : threshold_(threshold), lastTemp_(0.0f),
+          deadband_(0.0f), minIntervalMs_(0), lastNotifiedTemp_(0.0f),
+          lastNotifyMs_(0), hasNotified_(false), hasTimedNotify_(false), notifyCount_(0),
+          suppressedCount_(0), mailboxTemp_(0.0f), mailboxFull_(false) {}
 
-    bool attach(ITemperatureObserver* observer) {
-        if (numObservers_ >= MAX_OBSERVERS) return false;
-        observers_[numObservers_++] = observer;
-        return true;
-    }
+    bool attach(ITemperatureObserver* observer) { return observers_.pushBack(observer); }
+
+    void setDeadband(float celsius) { deadband_ = celsius < 0.0f ? -celsius : celsius; }
+    void setMinIntervalMs(uint32_t intervalMs) { minIntervalMs_ = intervalMs; }
 
-    // Called when new temperature reading is available
+    // Called when new temperature reading is available (no minimum interval)
     void updateTemperature(float celsius) {
         lastTemp_ = celsius;
+        const bool overtemperature = celsius > threshold_;
+
+        if (!overtemperature && !exceedsDeadband(celsius)) {
+            suppressedCount_++;
+            return;
+        }
+        notify(celsius, overtemperature);
+    }
+
+    // As above with the minimum interval, nowMs in free-running ms
+    void updateTemperature(float celsius, uint32_t nowMs) {
+        lastTemp_ = celsius;
+        const bool overtemperature = celsius > threshold_;
+
+        if (!overtemperature && !isSignificant(celsius, nowMs)) {
+            suppressedCount_++;
+            return;
+        }
+        lastNotifyMs_ = nowMs;
+        hasTimedNotify_ = true;
+        notify(celsius, overtemperature);
+    }
+
+    // Latest-value-only mailbox (producer side, may be called from ISR)
+    void storeLatest(float celsius) {
+        mailboxTemp_ = celsius;
+        mailboxFull_.store(true, std::memory_order_release);
+    }
+
+    // Consumer side: deliver the newest stored value, if any
+    bool publishLatest(uint32_t nowMs) {
+        if (!mailboxFull_.exchange(false, std::memory_order_acquire)) {
+            return false;
+        }
+        updateTemperature(mailboxTemp_, nowMs);
+        return true;
+    }
+
+    float getLastTemperature() const { return lastTemp_; }
+    uint32_t getNotificationCount() const { return notifyCount_; }
+    uint32_t getSuppressedCount() const { return suppressedCount_; }
+
+private:
+    void notify(float celsius, bool overtemperature) {
+        lastNotifiedTemp_ = celsius;
+        hasNotified_ = true;
+        notifyCount_++;
 
         // Notify all observers of change
-        for (size_t i = 0; i < numObservers_; ++i) {
-            observers_[i]->onTemperatureChanged(celsius);
+        for (ITemperatureObserver* observer : observers_) {
+            observer->onTemperatureChanged(celsius);
         }
 
         // Check for overtemperature
-        if (celsius > threshold_) {
-            for (size_t i = 0; i < numObservers_; ++i) {
-                observers_[i]->onOvertemperature(celsius);
+        if (overtemperature) {
+            for (ITemperatureObserver* observer : observers_) {
+                observer->onOvertemperature(celsius);
             }
         }
     }
 
+    bool isSignificant(float celsius, uint32_t nowMs) const {
+        if (hasTimedNotify_ && nowMs - lastNotifyMs_ < minIntervalMs_) return false;  // Wrap-safe
+        return exceedsDeadband(celsius);
+    }
+
+    bool exceedsDeadband(float celsius) const {
+        if (!hasNotified_ || deadband_ == 0.0f) return true;
+        const float delta = celsius - lastNotifiedTemp_;
+        return delta > deadband_ || delta < -deadband_;
+    }
+
+    fixed_containers::StaticVector<ITemperatureObserver*, MAX_OBSERVERS> observers_;
+    float threshold_;
+    float lastTemp_;
+
+    float deadband_;
+    uint32_t minIntervalMs_;
+    float lastNotifiedTemp_;
+    uint32_t lastNotifyMs_;
+    bool hasNotified_;
+    bool hasTimedNotify_;  // lastNotifyMs_ is valid
+    uint32_t notifyCount_;
+    uint32_t suppressedCount_;
+
+    volatile float mailboxTemp_;
+    std::atomic<bool> mailboxFull_;
+};
+
+// ============================================================================
+// Static Subject (observer set fixed at compile time)
+// ============================================================================
+
+/**
+ * @brief Subject whose observers are template parameters
+ *
+ * The subject owns its observers in a std::tuple. The concrete types are
+ * known, so every notification expands (fold expression) into a direct
+ * call the compiler can inline. No pointer table, no observer count, no
+ * vtable lookups: zero RAM per observer beyond the observer's own state.
+ *
+ * Observers keep the IButtonObserver/ITemperatureObserver contract, only
+ * the notifications a subject actually uses need to exist.
+ *
+ * Usage:
+ *   StaticSubject<LedController, EventLogger> buttons;
+ *   buttons.notifyPressed(1);
+ *   buttons.get<LedController>().isLedOn();
+ *
+ * Trade-off: no attach()/detach() at runtime.
+ */
+template<typename... Observers>
+class StaticSubject {
+public:
+    static constexpr size_t OBSERVER_COUNT = sizeof...(Observers);
+
+    StaticSubject() = default;
+    explicit StaticSubject(const Observers&... observers) : observers_(observers...) {}
+
+    void notifyPressed(uint8_t buttonId) {
+        std::apply([buttonId](auto&... obs) { (obs.onButtonPressed(buttonId), ...); }, observers_);
+    }
+
+    void notifyReleased(uint8_t buttonId) {
+        std::apply([buttonId](auto&... obs) { (obs.onButtonReleased(buttonId), ...); }, observers_);
+    }
+
+    void notifyTemperatureChanged(float celsius) {
+        std::apply([celsius](auto&... obs) { (obs.onTemperatureChanged(celsius), ...); }, observers_);
+    }
+
+    void notifyOvertemperature(float celsius) {
+        std::apply([celsius](auto&... obs) { (obs.onOvertemperature(celsius), ...); }, observers_);
+    }
+
+    template<size_t INDEX>
+    auto& get() { return std::get<INDEX>(observers_); }
+
+    template<typename Observer>
+    Observer& get() { return std::get<Observer>(observers_); }
+
+    static constexpr size_t getObserverCount() { return OBSERVER_COUNT; }
+
+private:
+    std::tuple<Observers...> observers_;
+};
+
+/**
+ * @brief Static counterpart of TemperatureSubject (same threshold logic)
+ */
+template<typename... Observers>
+class StaticTemperatureSubject : public StaticSubject<Observers...> {
+public:
+    explicit StaticTemperatureSubject(float threshold = 50.0f)
+        : threshold_(threshold), lastTemp_(0.0f) {}
+
+    void updateTemperature(float celsius) {
+        lastTemp_ = celsius;
+        this->notifyTemperatureChanged(celsius);
+        if (celsius > threshold_) {
+            this->notifyOvertemperature(celsius);
+        }
+    }
+
     float getLastTemperature() const { return lastTemp_; }
 
 private:
-    std::array<ITemperatureObserver*, MAX_OBSERVERS> observers_;
-    size_t numObservers_;
     float threshold_;
     float lastTemp_;
 };
 
+// ============================================================================
+// Deferred Notification (ISR -> main loop)
+// ============================================================================
+
+/**
+ * @brief Fixed-capacity lock-free single-producer/single-consumer ring
+ *
+ * One ISR (producer) posts, the main loop (consumer) pops. Each index is
+ * written by one side only, so no locks and no disabled interrupts are
+ * needed (lockfree_queue::SpscQueue). CAPACITY must be a power of two
+ * (index wrap is a mask).
+ *
+ * When the ring is full post() drops the event and counts it, an ISR
+ * must never wait for the main loop.
+ */
+template<typename Event, size_t CAPACITY = 16>
+class EventQueue {
+public:
+    // Producer side (ISR)
+    bool post(const Event& event) { return queue_.push(event); }
+
+    // Consumer side (main loop)
+    bool pop(Event& event) { return queue_.pop(event); }
+
+    size_t size() const { return queue_.size(); }
+    bool isEmpty() const { return queue_.isEmpty(); }
+    uint32_t getDroppedCount() const { return queue_.getDroppedCount(); }
+
+private:
+    lockfree_queue::SpscQueue<Event, CAPACITY> queue_;
+};
+
+/**
+ * @brief Button event as stored in the deferred queue
+ */
+struct ButtonEvent {
+    uint8_t buttonId;
+    bool pressed;
+};
+
+/**
+ * @brief ButtonSubject whose ISR side only queues events
+ *
+ * The pin-change ISR calls postPressed()/postReleased(), which take a
+ * few instructions no matter how many observers are attached. The main
+ * loop (or a CyclicExecutive task) calls dispatchPending() to notify.
+ */
+template<size_t MAX_OBSERVERS = 4, size_t QUEUE_SIZE = 16>
+class DeferredButtonSubject {
+public:
+    bool attach(IButtonObserver* observer) { return subject_.attach(observer); }
+    bool detach(IButtonObserver* observer) { return subject_.detach(observer); }
+    size_t getObserverCount() const { return subject_.getObserverCount(); }
+
+    // ISR side
+    bool postPressed(uint8_t buttonId) { return queue_.post({buttonId, true}); }
+    bool postReleased(uint8_t buttonId) { return queue_.post({buttonId, false}); }
+
+    /**
+     * @brief Main loop side: notify observers of queued events, oldest first
+     * @param maxEvents Upper bound per call, to bound main loop time
+     * @return Number of events dispatched
+     */
+    size_t dispatchPending(size_t maxEvents = QUEUE_SIZE) {
+        size_t dispatched = 0;
+        ButtonEvent event;
+        while (dispatched < maxEvents && queue_.pop(event)) {
+            if (event.pressed) {
+                subject_.notifyPressed(event.buttonId);
+            } else {
+                subject_.notifyReleased(event.buttonId);
+            }
+            dispatched++;
+        }
+        return dispatched;
+    }
+
+    size_t getPendingCount() const { return queue_.size(); }
+    uint32_t getDroppedCount() const { return queue_.getDroppedCount(); }
+
+private:
+    ButtonSubject<MAX_OBSERVERS> subject_;
+    EventQueue<ButtonEvent, QUEUE_SIZE> queue_;
+};
+
+/**
+ * @brief TemperatureSubject fed from an ADC-complete ISR
+ */
+template<size_t MAX_OBSERVERS = 4, size_t QUEUE_SIZE = 8>
+class DeferredTemperatureSubject {
+public:
+    explicit DeferredTemperatureSubject(float threshold = 50.0f) : subject_(threshold) {}
+
+    bool attach(ITemperatureObserver* observer) { return subject_.attach(observer); }
+
+    // ISR side
+    bool postTemperature(float celsius) { return queue_.post(celsius); }
+
+    // Main loop side, nowMs as for TemperatureSubject::updateTemperature()
+    size_t dispatchPending(uint32_t nowMs, size_t maxEvents = QUEUE_SIZE) {
+        size_t dispatched = 0;
+        float celsius;
+        while (dispatched < maxEvents && queue_.pop(celsius)) {
+            subject_.updateTemperature(celsius, nowMs);
+            dispatched++;
+        }
+        return dispatched;
+    }
+
+    float getLastTemperature() const { return subject_.getLastTemperature(); }
+    size_t getPendingCount() const { return queue_.size(); }
+    uint32_t getDroppedCount() const { return queue_.getDroppedCount(); }
+
+private:
+    TemperatureSubject<MAX_OBSERVERS> subject_;
+    EventQueue<float, QUEUE_SIZE> queue_;
+};
+
+// ============================================================================
+// Batched Notification (high-rate sample streams)
+// ============================================================================
+
+/**
+ * @brief Observer of a sample stream, called once per batch
+ *
+ * samples and timestamps are count entries each, contiguous, and valid
+ * only during the call: copy what must outlive it.
+ */
+template<typename Sample>
+class ISampleObserver {
+public:
+    virtual ~ISampleObserver() = default;
+    virtual void onSamples(const Sample* samples, const uint32_t* timestamps, size_t count) = 0;
+};
+
+/**
+ * @brief Subject that notifies every observer per batch, not per sample
+ *
+ * One virtual call per sample (TemperatureSubject style) costs more than
+ * the work for an ECG stream: 500 Hz x 3 leads is 1500 calls a second
+ * per observer, each carrying one value. Here every observer chooses its
+ * batch size at attach(); it is called once that many samples arrived,
+ * with the samples and their timestamps as arrays, and can process them
+ * in a tight loop. A filter may take 1 (lowest latency), a recorder 32.
+ *
+ * The last CAPACITY samples sit in a mirrored ring: each one is written
+ * at slot and slot + CAPACITY, so any run of up to CAPACITY samples is
+ * contiguous without copying. Observers share the ring, each remembers
+ * the first sample it has not been given yet. A batch is delivered as
+ * soon as it is complete, before the ring could overwrite it.
+ *
+ * For a multi-lead stream, make Sample a struct with one value per lead.
+ * publish() runs in the main loop; from an ISR, queue the samples
+ * (EventQueue) and publishBatch() them.
+ */
+template<typename Sample, size_t CAPACITY = 32, size_t MAX_OBSERVERS = 4>
+class BatchSubject {
+    static_assert(CAPACITY > 0 && (CAPACITY & (CAPACITY - 1)) == 0, "CAPACITY must be a power of two");
+
+public:
+    BatchSubject() : samples_{}, timestamps_{}, published_(0), batches_(0) {}
+
+    /**
+     * @param batchSize Samples per callback, 1 .. CAPACITY
+     * @return false when full or batchSize is out of range
+     *
+     * The observer receives the samples published from now on.
+     */
+    bool attach(ISampleObserver<Sample>* observer, size_t batchSize) {
+        if (batchSize == 0 || batchSize > CAPACITY) return false;
+        return observers_.pushBack({observer, batchSize, published_});
+    }
+
+    /** Drops the observer's incomplete batch; the others keep their order */
+    bool detach(ISampleObserver<Sample>* observer) {
+        for (size_t i = 0; i < observers_.size(); i++) {
+            if (observers_[i].observer == observer) return observers_.removeAt(i);
+        }
+        return false;
+    }
+
+    void publish(const Sample& sample, uint32_t timestamp) {
+        const size_t slot = published_ & (CAPACITY - 1);
+        samples_[slot] = sample;
+        samples_[slot + CAPACITY] = sample;
+        timestamps_[slot] = timestamp;
+        timestamps_[slot + CAPACITY] = timestamp;
+        published_++;
+
+        for (Entry& entry : observers_) {
+            if (published_ - entry.next >= entry.batchSize) {
+                deliver(entry, entry.batchSize);
+            }
+        }
+    }
+
+    void publishBatch(const Sample* samples, const uint32_t* timestamps, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            publish(samples[i], timestamps[i]);
+        }
+    }
+
+    /**
+     * @brief Deliver every incomplete batch now, e.g. before sleeping or
+     *        stopping a recording
+     * @return Number of callbacks made
+     */
+    size_t flush() {
+        size_t callbacks = 0;
+        for (Entry& entry : observers_) {
+            const size_t pending = published_ - entry.next;
+            if (pending > 0) {
+                deliver(entry, pending);
+                callbacks++;
+            }
+        }
+        return callbacks;
+    }
+
+    /** Samples published but not yet delivered to observer */
+    size_t getPendingCount(const ISampleObserver<Sample>* observer) const {
+        for (const Entry& entry : observers_) {
+            if (entry.observer == observer) return published_ - entry.next;
+        }
+        return 0;
+    }
+
+    size_t getObserverCount() const { return observers_.size(); }
+    uint32_t getPublishedCount() const { return published_; }
+    uint32_t getBatchCount() const { return batches_; }
+
+private:
+    struct Entry {
+        ISampleObserver<Sample>* observer;
+        size_t batchSize;
+        uint32_t next;  // Sequence number of the first undelivered sample
+    };
+
+    void deliver(Entry& entry, size_t count) {
+        const size_t start = entry.next & (CAPACITY - 1);
+        entry.next += static_cast<uint32_t>(count);
+        batches_++;
+        entry.observer->onSamples(&samples_[start], &timestamps_[start], count);
+    }
+
+    std::array<Sample, 2 * CAPACITY> samples_;
+    std::array<uint32_t, 2 * CAPACITY> timestamps_;
+    fixed_containers::StaticVector<Entry, MAX_OBSERVERS> observers_;
+    uint32_t published_;  // Wraps; differences stay correct
+    uint32_t batches_;
+};
+
 // ============================================================================
 // Concrete Observers
 // ============================================================================
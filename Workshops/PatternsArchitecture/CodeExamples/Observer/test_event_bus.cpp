@@ -0,0 +1,235 @@
+#include "CppUTest/TestHarness.h"
+#include "EventBus.hpp"
+
+using namespace observer;
+
+namespace {
+
+/**
+ * Handles two topics through the runtime interface
+ */
+class Display : public ISubscriber<TemperatureReading>, public ISubscriber<ButtonPressed> {
+public:
+    void onEvent(const TemperatureReading& event) override {
+        celsius = event.celsius;
+        readings++;
+    }
+
+    void onEvent(const ButtonPressed& event) override { lastButton = event.buttonId; }
+
+    float celsius = 0.0f;
+    int readings = 0;
+    uint8_t lastButton = 0;
+};
+
+/**
+ * Records the order of delivery across subscribers
+ */
+class OrderRecorder : public ISubscriber<TemperatureReading> {
+public:
+    OrderRecorder(char name, char* log, size_t& length) : name_(name), log_(log), length_(length) {}
+
+    void onEvent(const TemperatureReading& /*event*/) override { log_[length_++] = name_; }
+
+private:
+    char name_;
+    char* log_;
+    size_t& length_;
+};
+
+// Static subscribers: plain classes, no interface
+struct ButtonCounter {
+    void onEvent(const ButtonPressed& /*event*/) { presses++; }
+    void onEvent(const ButtonReleased& /*event*/) { releases++; }
+    int presses = 0;
+    int releases = 0;
+};
+
+struct TemperatureLog {
+    void onEvent(const TemperatureReading& event) {
+        if (count < 8) readings[count] = event.celsius;
+        count++;
+    }
+    float readings[8] = {};
+    int count = 0;
+};
+
+struct Unrelated {
+    int value = 0;
+};
+
+using Bus = EventBus<3, ButtonPressed, ButtonReleased, TemperatureReading>;
+using StaticBus = StaticEventBus<ButtonCounter, TemperatureLog, Unrelated>;
+
+} // namespace
+
+// ============================================================================
+// StaticEventBus Tests
+// ============================================================================
+
+TEST_GROUP(StaticEventBus) {
+    StaticBus bus;
+};
+
+TEST(StaticEventBus, RoutingIsCompileTime) {
+    static_assert(StaticBus::getSubscriberCount<ButtonPressed>() == 1, "one button subscriber");
+    static_assert(StaticBus::getSubscriberCount<TemperatureReading>() == 1, "one temperature subscriber");
+    static_assert(!Handles<Unrelated, ButtonPressed>::value, "no onEvent, no subscription");
+    LONGS_EQUAL(3, StaticBus::SUBSCRIBER_COUNT);
+}
+
+TEST(StaticEventBus, DeliversOnlyToSubscribersOfTheTopic) {
+    bus.publish(ButtonPressed{1});
+    bus.publish(ButtonReleased{1});
+    bus.publish(TemperatureReading{21.5f});
+
+    LONGS_EQUAL(1, bus.get<ButtonCounter>().presses);
+    LONGS_EQUAL(1, bus.get<ButtonCounter>().releases);
+    LONGS_EQUAL(1, bus.get<TemperatureLog>().count);
+    DOUBLES_EQUAL(21.5f, bus.get<1>().readings[0], 0.01);
+}
+
+TEST(StaticEventBus, TopicWithoutSubscribersIsAllowed) {
+    struct Unheard {};
+    static_assert(StaticBus::getSubscriberCount<Unheard>() == 0, "nobody listens");
+
+    bus.publish(Unheard{});
+
+    LONGS_EQUAL(0, bus.get<ButtonCounter>().presses);
+}
+
+TEST(StaticEventBus, BatchKeepsOrder) {
+    const TemperatureReading readings[] = {{20.0f}, {21.0f}, {22.0f}};
+
+    bus.publishBatch(readings, 3);
+
+    LONGS_EQUAL(3, bus.get<TemperatureLog>().count);
+    DOUBLES_EQUAL(20.0f, bus.get<TemperatureLog>().readings[0], 0.01);
+    DOUBLES_EQUAL(22.0f, bus.get<TemperatureLog>().readings[2], 0.01);
+    LONGS_EQUAL(0, bus.get<ButtonCounter>().presses);
+}
+
+// ============================================================================
+// EventBus Tests
+// ============================================================================
+
+TEST_GROUP(EventBus) {
+    Bus* bus;
+    Display* display;
+
+    void setup() {
+        bus = new Bus();
+        display = new Display();
+    }
+
+    void teardown() {
+        delete display;
+        delete bus;
+    }
+};
+
+TEST(EventBus, TopicsAreTheTemplateParameters) {
+    static_assert(Bus::carries<ButtonPressed>(), "button topic");
+    static_assert(!Bus::carries<float>(), "not a topic");
+    LONGS_EQUAL(3, Bus::TOPIC_COUNT);
+}
+
+TEST(EventBus, SubscribesPerTopic) {
+    CHECK_TRUE(bus->subscribe<TemperatureReading>(display));
+
+    LONGS_EQUAL(1, bus->getSubscriberCount<TemperatureReading>());
+    LONGS_EQUAL(0, bus->getSubscriberCount<ButtonPressed>());
+}
+
+TEST(EventBus, DeliversOnlyTheSubscribedTopics) {
+    bus->subscribe<TemperatureReading>(display);
+
+    bus->publish(TemperatureReading{30.0f});
+    bus->publish(ButtonPressed{4});
+
+    DOUBLES_EQUAL(30.0f, display->celsius, 0.01);
+    LONGS_EQUAL(0, display->lastButton);  // Not subscribed to buttons
+}
+
+TEST(EventBus, OneSubscriberSeveralTopics) {
+    bus->subscribe<TemperatureReading>(display);
+    bus->subscribe<ButtonPressed>(display);
+
+    bus->publish(ButtonPressed{4});
+
+    LONGS_EQUAL(4, display->lastButton);
+}
+
+TEST(EventBus, UnsubscribedIsNotNotified) {
+    bus->subscribe<TemperatureReading>(display);
+    CHECK_TRUE(bus->unsubscribe<TemperatureReading>(display));
+
+    bus->publish(TemperatureReading{30.0f});
+
+    LONGS_EQUAL(0, display->readings);
+    CHECK_FALSE(bus->unsubscribe<TemperatureReading>(display));
+}
+
+TEST(EventBus, RejectsWhenTopicIsFull) {
+    Display d1, d2, d3;
+    CHECK_TRUE(bus->subscribe<TemperatureReading>(&d1));
+    CHECK_TRUE(bus->subscribe<TemperatureReading>(&d2));
+    CHECK_TRUE(bus->subscribe<TemperatureReading>(display));
+    CHECK_FALSE(bus->subscribe<TemperatureReading>(&d3));  // No room!
+
+    CHECK_TRUE(bus->subscribe<ButtonPressed>(&d3));  // Other topic, own table
+}
+
+TEST(EventBus, NotifiesInSubscribeOrder) {
+    char log[8] = {};
+    size_t length = 0;
+    OrderRecorder a('a', log, length), b('b', log, length), c('c', log, length);
+    bus->subscribe<TemperatureReading>(&a);
+    bus->subscribe<TemperatureReading>(&b);
+    bus->subscribe<TemperatureReading>(&c);
+    bus->unsubscribe<TemperatureReading>(&a);
+
+    bus->publish(TemperatureReading{20.0f});
+
+    STRCMP_EQUAL("bc", log);
+}
+
+TEST(EventBus, BatchDeliversSubscriberBySubscriber) {
+    char log[8] = {};
+    size_t length = 0;
+    OrderRecorder a('a', log, length), b('b', log, length);
+    bus->subscribe<TemperatureReading>(&a);
+    bus->subscribe<TemperatureReading>(&b);
+    const TemperatureReading readings[] = {{20.0f}, {21.0f}};
+
+    bus->publishBatch(readings, 2);
+
+    STRCMP_EQUAL("aabb", log);
+}
+
+TEST(EventBus, DispatchesQueuedEventsInBatches) {
+    EventQueue<TemperatureReading, 16> queue;
+    bus->subscribe<TemperatureReading>(display);
+    for (int i = 0; i < 10; i++) {
+        queue.post(TemperatureReading{20.0f + i});
+    }
+
+    LONGS_EQUAL(10, bus->dispatchPending<4>(queue));
+
+    LONGS_EQUAL(10, display->readings);
+    DOUBLES_EQUAL(29.0f, display->celsius, 0.01);  // Oldest first, newest last
+    CHECK_TRUE(queue.isEmpty());
+}
+
+TEST(EventBus, DispatchCanBeBounded) {
+    EventQueue<TemperatureReading, 16> queue;
+    bus->subscribe<TemperatureReading>(display);
+    for (int i = 0; i < 10; i++) {
+        queue.post(TemperatureReading{20.0f + i});
+    }
+
+    LONGS_EQUAL(5, bus->dispatchPending<4>(queue, 5));
+
+    LONGS_EQUAL(5, display->readings);
+    LONGS_EQUAL(5, queue.size());
+}
@@ -164,6 +164,393 @@ TEST(TemperatureSubject, MultipleObserversAllNotified) {
     DOUBLES_EQUAL(30.0f, display2.getDisplayValue(), 0.01);
 }
 
+TEST(TemperatureSubject, DeadbandSuppressesSmallChanges) {
+    sensor->attach(display);
+    sensor->setDeadband(0.5f);
+
+    sensor->updateTemperature(20.0f, 0);
+    sensor->updateTemperature(20.3f, 10);  // Within deadband
+    sensor->updateTemperature(19.8f, 20);
+
+    DOUBLES_EQUAL(20.0f, display->getDisplayValue(), 0.01);
+    DOUBLES_EQUAL(19.8f, sensor->getLastTemperature(), 0.01);
+    LONGS_EQUAL(1, sensor->getNotificationCount());
+    LONGS_EQUAL(2, sensor->getSuppressedCount());
+
+    sensor->updateTemperature(20.6f, 30);
+    DOUBLES_EQUAL(20.6f, display->getDisplayValue(), 0.01);
+}
+
+TEST(TemperatureSubject, MinIntervalRateLimits) {
+    sensor->attach(display);
+    sensor->setMinIntervalMs(100);
+
+    sensor->updateTemperature(20.0f, 0);
+    sensor->updateTemperature(25.0f, 50);   // Too soon
+    DOUBLES_EQUAL(20.0f, display->getDisplayValue(), 0.01);
+
+    sensor->updateTemperature(26.0f, 100);
+    DOUBLES_EQUAL(26.0f, display->getDisplayValue(), 0.01);
+    LONGS_EQUAL(2, sensor->getNotificationCount());
+}
+
+TEST(TemperatureSubject, MinIntervalFollowsTheCallersClock) {
+    sensor->attach(display);
+    sensor->setMinIntervalMs(100);
+
+    sensor->updateTemperature(20.0f, 5000);
+    sensor->updateTemperature(21.0f, 5099);  // Too soon
+    sensor->updateTemperature(22.0f, 5100);
+
+    DOUBLES_EQUAL(22.0f, display->getDisplayValue(), 0.01);
+    LONGS_EQUAL(2, sensor->getNotificationCount());
+    LONGS_EQUAL(1, sensor->getSuppressedCount());
+}
+
+TEST(TemperatureSubject, UntimedUpdateIgnoresMinInterval) {
+    sensor->attach(display);
+    sensor->setDeadband(0.5f);
+    sensor->setMinIntervalMs(100);
+
+    sensor->updateTemperature(20.0f);
+    sensor->updateTemperature(20.3f);  // Within deadband
+    sensor->updateTemperature(21.0f);
+
+    DOUBLES_EQUAL(21.0f, display->getDisplayValue(), 0.01);
+    LONGS_EQUAL(2, sensor->getNotificationCount());
+    LONGS_EQUAL(1, sensor->getSuppressedCount());
+}
+
+TEST(TemperatureSubject, OvertemperatureBypassesCoalescing) {
+    sensor->attach(safety);
+    sensor->setDeadband(10.0f);
+    sensor->setMinIntervalMs(1000);
+
+    sensor->updateTemperature(45.0f, 0);
+    sensor->updateTemperature(51.0f, 10);
+
+    CHECK_TRUE(safety->isShutdownTriggered());
+}
+
+TEST(TemperatureSubject, MailboxKeepsLatestValueOnly) {
+    sensor->attach(display);
+
+    CHECK_FALSE(sensor->publishLatest(0));
+
+    sensor->storeLatest(21.0f);
+    sensor->storeLatest(22.0f);
+    sensor->storeLatest(23.0f);
+
+    CHECK_TRUE(sensor->publishLatest(10));
+    DOUBLES_EQUAL(23.0f, display->getDisplayValue(), 0.01);
+    LONGS_EQUAL(1, sensor->getNotificationCount());
+    CHECK_FALSE(sensor->publishLatest(20));
+}
+
+// ============================================================================
+// Static Subject Tests
+// ============================================================================
+
+TEST_GROUP(StaticSubject) {
+    StaticSubject<LedController, EventLogger> subject;
+};
+
+TEST(StaticSubject, CountIsCompileTime) {
+    static_assert(StaticSubject<LedController, EventLogger>::getObserverCount() == 2,
+                  "observer count is a constant");
+    LONGS_EQUAL(2, subject.getObserverCount());
+}
+
+TEST(StaticSubject, NotifiesAllObservers) {
+    subject.notifyPressed(3);
+
+    CHECK_TRUE(subject.get<LedController>().isLedOn());
+    LONGS_EQUAL(1, subject.get<EventLogger>().getLogCount());
+    LONGS_EQUAL(3, subject.get<1>().getLogEntry(0).buttonId);
+}
+
+TEST(StaticSubject, NotifiesRelease) {
+    subject.notifyPressed(1);
+    subject.notifyReleased(1);
+
+    CHECK_TRUE(subject.get<0>().isLedOn());  // Toggles on press only
+    CHECK_FALSE(subject.get<EventLogger>().getLogEntry(1).pressed);
+}
+
+TEST(StaticSubject, TemperatureUsesThreshold) {
+    StaticTemperatureSubject<TemperatureDisplay, SafetyController> sensor(50.0f);
+
+    sensor.updateTemperature(45.0f);
+    CHECK_FALSE(sensor.get<TemperatureDisplay>().isAlarmActive());
+    CHECK_FALSE(sensor.get<SafetyController>().isShutdownTriggered());
+
+    sensor.updateTemperature(60.0f);
+    CHECK_TRUE(sensor.get<TemperatureDisplay>().isAlarmActive());
+    CHECK_TRUE(sensor.get<SafetyController>().isShutdownTriggered());
+    DOUBLES_EQUAL(60.0f, sensor.getLastTemperature(), 0.01);
+}
+
+// ============================================================================
+// Deferred Notification Tests
+// ============================================================================
+
+TEST_GROUP(EventQueue) {
+    EventQueue<int, 4> queue;
+};
+
+TEST(EventQueue, StartsEmpty) {
+    int value;
+    CHECK_TRUE(queue.isEmpty());
+    CHECK_FALSE(queue.pop(value));
+}
+
+TEST(EventQueue, PreservesOrder) {
+    queue.post(1);
+    queue.post(2);
+    queue.post(3);
+
+    int value;
+    CHECK_TRUE(queue.pop(value));
+    LONGS_EQUAL(1, value);
+    CHECK_TRUE(queue.pop(value));
+    LONGS_EQUAL(2, value);
+    LONGS_EQUAL(1, queue.size());
+}
+
+TEST(EventQueue, DropsWhenFull) {
+    for (int i = 0; i < 4; i++) {
+        CHECK_TRUE(queue.post(i));
+    }
+
+    CHECK_FALSE(queue.post(99));  // ISR never blocks
+    LONGS_EQUAL(1, queue.getDroppedCount());
+    LONGS_EQUAL(4, queue.size());
+}
+
+TEST(EventQueue, WrapsAround) {
+    int value;
+    for (int i = 0; i < 10; i++) {
+        CHECK_TRUE(queue.post(i));
+        CHECK_TRUE(queue.pop(value));
+        LONGS_EQUAL(i, value);
+    }
+    CHECK_TRUE(queue.isEmpty());
+}
+
+TEST_GROUP(DeferredButtonSubject) {
+    DeferredButtonSubject<4, 8> subject;
+    LedController led;
+    EventLogger logger;
+
+    void setup() {
+        subject.attach(&led);
+        subject.attach(&logger);
+    }
+};
+
+TEST(DeferredButtonSubject, PostDoesNotNotifyObservers) {
+    subject.postPressed(1);  // From "ISR"
+
+    CHECK_FALSE(led.isLedOn());
+    LONGS_EQUAL(0, logger.getLogCount());
+    LONGS_EQUAL(1, subject.getPendingCount());
+}
+
+TEST(DeferredButtonSubject, DispatchNotifiesInOrder) {
+    subject.postPressed(1);
+    subject.postReleased(1);
+    subject.postPressed(2);
+
+    LONGS_EQUAL(3, subject.dispatchPending());
+
+    LONGS_EQUAL(3, logger.getLogCount());
+    CHECK_TRUE(logger.getLogEntry(0).pressed);
+    CHECK_FALSE(logger.getLogEntry(1).pressed);
+    LONGS_EQUAL(2, logger.getLogEntry(2).buttonId);
+    LONGS_EQUAL(2, led.getPressCount());
+    LONGS_EQUAL(0, subject.getPendingCount());
+}
+
+TEST(DeferredButtonSubject, DispatchCanBeBounded) {
+    subject.postPressed(1);
+    subject.postPressed(2);
+    subject.postPressed(3);
+
+    LONGS_EQUAL(2, subject.dispatchPending(2));
+    LONGS_EQUAL(1, subject.getPendingCount());
+}
+
+TEST(DeferredButtonSubject, CountsDroppedEvents) {
+    for (int i = 0; i < 10; i++) {
+        subject.postPressed(static_cast<uint8_t>(i));
+    }
+
+    LONGS_EQUAL(2, subject.getDroppedCount());
+    LONGS_EQUAL(8, subject.dispatchPending());
+}
+
+TEST(DeferredButtonSubject, DeferredTemperatureTriggersAlarmOnDispatch) {
+    DeferredTemperatureSubject<2> sensor(50.0f);
+    TemperatureDisplay display;
+    sensor.attach(&display);
+
+    sensor.postTemperature(20.0f);
+    sensor.postTemperature(55.0f);
+    CHECK_FALSE(display.isAlarmActive());
+
+    LONGS_EQUAL(2, sensor.dispatchPending(0));
+    CHECK_TRUE(display.isAlarmActive());
+    DOUBLES_EQUAL(55.0f, sensor.getLastTemperature(), 0.01);
+}
+
+// ============================================================================
+// Batched Notification Tests
+// ============================================================================
+
+namespace {
+
+/**
+ * Three-lead ECG sample, as one stream entry
+ */
+struct EcgSample {
+    int16_t lead[3];
+};
+
+/**
+ * Keeps the batches it was given
+ */
+class BatchRecorder : public ISampleObserver<EcgSample> {
+public:
+    void onSamples(const EcgSample* samples, const uint32_t* timestamps, size_t count) override {
+        for (size_t i = 0; i < count && length < 64; i++) {
+            lead1[length] = samples[i].lead[1];
+            times[length] = timestamps[i];
+            length++;
+        }
+        lastBatch = count;
+        calls++;
+    }
+
+    int16_t lead1[64] = {};
+    uint32_t times[64] = {};
+    size_t length = 0;
+    size_t lastBatch = 0;
+    int calls = 0;
+};
+
+} // namespace
+
+TEST_GROUP(BatchSubject) {
+    BatchSubject<EcgSample, 8, 3> subject;
+    BatchRecorder filter;
+    BatchRecorder recorder;
+
+    void publishSamples(int count, int first = 0) {
+        for (int i = first; i < first + count; i++) {
+            const int16_t value = static_cast<int16_t>(i);
+            subject.publish(EcgSample{{static_cast<int16_t>(-value), value, 0}}, 2U * i);  // 500 Hz
+        }
+    }
+};
+
+TEST(BatchSubject, CallsOncePerBatch) {
+    subject.attach(&recorder, 4);
+
+    publishSamples(3);
+    LONGS_EQUAL(0, recorder.calls);
+
+    publishSamples(1, 3);
+    LONGS_EQUAL(1, recorder.calls);
+    LONGS_EQUAL(4, recorder.lastBatch);
+}
+
+TEST(BatchSubject, BatchSizeIsPerObserver) {
+    subject.attach(&filter, 1);
+    subject.attach(&recorder, 8);
+
+    publishSamples(16);
+
+    LONGS_EQUAL(16, filter.calls);
+    LONGS_EQUAL(2, recorder.calls);
+    LONGS_EQUAL(16, recorder.length);
+    LONGS_EQUAL(18, subject.getBatchCount());
+}
+
+TEST(BatchSubject, SamplesAndTimestampsStayInOrderAcrossTheWrap) {
+    subject.attach(&recorder, 3);  // Does not divide the ring: batches straddle its end
+
+    publishSamples(21);
+
+    LONGS_EQUAL(21, recorder.length);
+    for (size_t i = 0; i < recorder.length; i++) {
+        LONGS_EQUAL(i, recorder.lead1[i]);
+        LONGS_EQUAL(2 * i, recorder.times[i]);
+    }
+}
+
+TEST(BatchSubject, RejectsBatchLargerThanTheRing) {
+    CHECK_FALSE(subject.attach(&recorder, 9));
+    CHECK_FALSE(subject.attach(&recorder, 0));
+    CHECK_TRUE(subject.attach(&recorder, 8));
+}
+
+TEST(BatchSubject, RejectsWhenFull) {
+    BatchRecorder third, fourth;
+    CHECK_TRUE(subject.attach(&filter, 1));
+    CHECK_TRUE(subject.attach(&recorder, 2));
+    CHECK_TRUE(subject.attach(&third, 4));
+    CHECK_FALSE(subject.attach(&fourth, 4));  // No room!
+}
+
+TEST(BatchSubject, LateObserverStartsAtTheNextSample) {
+    publishSamples(5);
+    subject.attach(&recorder, 2);
+
+    publishSamples(2, 5);
+
+    LONGS_EQUAL(2, recorder.length);
+    LONGS_EQUAL(5, recorder.lead1[0]);
+}
+
+TEST(BatchSubject, FlushDeliversIncompleteBatches) {
+    subject.attach(&filter, 2);
+    subject.attach(&recorder, 8);
+    publishSamples(5);
+    LONGS_EQUAL(5, subject.getPendingCount(&recorder));
+
+    LONGS_EQUAL(2, subject.flush());  // filter holds 1, recorder 5
+
+    LONGS_EQUAL(5, recorder.lastBatch);
+    LONGS_EQUAL(5, filter.length);
+    LONGS_EQUAL(0, subject.getPendingCount(&recorder));
+    LONGS_EQUAL(0, subject.flush());
+}
+
+TEST(BatchSubject, DetachedObserverNotNotified) {
+    subject.attach(&filter, 1);
+    subject.attach(&recorder, 1);
+    CHECK_TRUE(subject.detach(&filter));
+
+    publishSamples(2);
+
+    LONGS_EQUAL(0, filter.calls);
+    LONGS_EQUAL(2, recorder.calls);
+    LONGS_EQUAL(1, subject.getObserverCount());
+}
+
+TEST(BatchSubject, PublishBatchFeedsFromAnArray) {
+    subject.attach(&recorder, 4);
+    const EcgSample samples[] = {{{0, 10, 0}}, {{0, 11, 0}}, {{0, 12, 0}}, {{0, 13, 0}}};
+    const uint32_t timestamps[] = {100, 102, 104, 106};
+
+    subject.publishBatch(samples, timestamps, 4);
+
+    LONGS_EQUAL(1, recorder.calls);
+    LONGS_EQUAL(13, recorder.lead1[3]);
+    LONGS_EQUAL(106, recorder.times[3]);
+    LONGS_EQUAL(4, subject.getPublishedCount());
+}
+
 // ============================================================================
 // Workshop Discussion
 // ============================================================================
@@ -200,4 +587,5 @@ TEST(TemperatureSubject, MultipleObserversAllNotified) {
  * - Publish-Subscribe (more decoupled, with message broker)
  * - Mediator (centralized communication)
  * - Event Queue (deferred processing)
+ * - Batching (BatchSubject): one call per N samples for high-rate streams
  */
@@ -0,0 +1,234 @@
+#ifndef PERF_BUDGET_HPP
+#define PERF_BUDGET_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/**
+ * =============================================================================
+ * PERFORMANCE BUDGETS IN UNIT TESTS
+ * =============================================================================
+ *
+ * Problem:
+ *   The test suites check what the code computes, not what it costs. A
+ *   change that makes an idle scheduler pass walk all tasks, or a filter
+ *   update loop over its window, passes every test and is only found on
+ *   the target, if at all.
+ *
+ * Solution:
+ *   Measure the operation in the test and assert a budget, so a
+ *   performance regression fails like a functional one:
+ *
+ *     CHECK_INSTRUCTION_BUDGET(40, [&]() { scheduler.run(); });
+ *       Instructions per call. Counted by the CPU (Linux perf_event_open,
+ *       user space of this thread only), so the number is the same on
+ *       every run and does not depend on the load of the machine.
+ *
+ *     CHECK_CONSTANT_COST([&]() { small.addReading(x); }, [&]() { large.addReading(x); });
+ *       Complexity: the cost per call may not grow with the size of the
+ *       data (e.g. a filter window of 4 and one of 1024). Works on any
+ *       host; with no instruction counter it compares the fastest of
+ *       several timed batches instead.
+ *
+ *   Instruction counts depend on the compiler and its options. Budgets
+ *   are upper bounds with room for that (and for a few instructions of
+ *   the measuring loop), not exact numbers; they catch the factor 10,
+ *   not the last 5 %.
+ *
+ *   Without a counter (not Linux, a container or VM without PMU access,
+ *   perf_event_paranoid > 2) CHECK_INSTRUCTION_BUDGET passes and prints
+ *   one note. Set PERF_BUDGET_REQUIRED=1 where budgets must be checked
+ *   (a CI runner with counters): a missing counter then fails the test.
+ *
+ * =============================================================================
+ */
+
+namespace perf_budget {
+
+// ============================================================================
+// Counters
+// ============================================================================
+
+/**
+ * @brief Retired user-space instructions of the calling thread
+ */
+class InstructionCounter {
+public:
+    InstructionCounter() : fd_(-1) {
+#if defined(__linux__)
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd_ = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+    }
+
+    ~InstructionCounter() {
+#if defined(__linux__)
+        if (fd_ >= 0) close(fd_);
+#endif
+    }
+
+    InstructionCounter(const InstructionCounter&) = delete;
+    InstructionCounter& operator=(const InstructionCounter&) = delete;
+
+    bool isAvailable() const { return fd_ >= 0; }
+
+    void start() {
+#if defined(__linux__)
+        ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+    }
+
+    uint64_t stop() {
+        uint64_t count = 0;
+#if defined(__linux__)
+        ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(fd_, &count, sizeof(count)) != static_cast<ssize_t>(sizeof(count))) count = 0;
+#endif
+        return count;
+    }
+
+private:
+    int fd_;
+};
+
+// User code that must be measured needs a side effect the optimizer keeps
+template<typename T>
+inline void keep(const T& value) {
+#if defined(__GNUC__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const T* sink;
+    sink = &value;
+#endif
+}
+
+// ============================================================================
+// Measurement
+// ============================================================================
+
+struct Cost {
+    double perCall;       // Instructions, or nanoseconds if !instructions
+    bool instructions;    // Counted by the CPU
+};
+
+/**
+ * @brief Cost of one call of op: the cheapest of several batches
+ *
+ * The first batch warms the caches and branch predictors and is not
+ * counted. The minimum of the rest drops the batches that were
+ * interrupted.
+ */
+template<typename Op>
+Cost measure(Op&& op, size_t calls = 1000, size_t batches = 8) {
+    InstructionCounter counter;
+    double best = 0.0;
+
+    for (size_t batch = 0; batch <= batches; batch++) {
+        double cost;
+        if (counter.isAvailable()) {
+            counter.start();
+            for (size_t i = 0; i < calls; i++) op();
+            cost = static_cast<double>(counter.stop());
+        } else {
+            const auto start = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < calls; i++) op();
+            cost = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        }
+        if (batch == 1 || (batch > 1 && cost < best)) best = cost;
+    }
+    return Cost{best / static_cast<double>(calls), counter.isAvailable()};
+}
+
+/**
+ * @brief Cost per call on large data divided by the cost on small data
+ *
+ * Both operations are measured the same way (instructions or time), so
+ * the ratio is meaningful with either. About 1 for O(1).
+ */
+template<typename SmallOp, typename LargeOp>
+double costRatio(SmallOp&& small, LargeOp&& large, size_t calls = 1000) {
+    const Cost smallCost = measure(small, calls);
+    const Cost largeCost = measure(large, calls);
+    return smallCost.perCall > 0.0 ? largeCost.perCall / smallCost.perCall : 0.0;
+}
+
+// Set PERF_BUDGET_REQUIRED=1 to fail instead of skip without a counter
+inline bool counterRequired() {
+    const char* required = std::getenv("PERF_BUDGET_REQUIRED");
+    return required != nullptr && std::strcmp(required, "0") != 0;
+}
+
+inline void noteSkipped() {
+    static bool noted = false;
+    if (!noted) {
+        std::fprintf(stderr, "\nperf_budget: no instruction counter, instruction budgets not checked\n");
+        noted = true;
+    }
+}
+
+inline std::string describe(double measured, double budget, const char* what) {
+    char text[96];
+    std::snprintf(text, sizeof(text), "%.1f %s, budget %.1f", measured, what, budget);
+    return text;
+}
+
+}  // namespace perf_budget
+
+// ============================================================================
+// CppUTest Assertions
+// ============================================================================
+
+/**
+ * Fails if one call of the operation takes more than budget instructions.
+ * The operation is a callable, e.g. [&]() { filter.addReading(21.5F); }
+ */
+#define CHECK_INSTRUCTION_BUDGET(budget, ...)                                               \
+    do {                                                                                    \
+        const perf_budget::Cost cost_ = perf_budget::measure(__VA_ARGS__);                  \
+        if (cost_.instructions) {                                                           \
+            CHECK_TEXT(cost_.perCall <= (budget),                                           \
+                       perf_budget::describe(cost_.perCall, (budget),                       \
+                                             "instructions per call").c_str());             \
+        } else if (perf_budget::counterRequired()) {                                        \
+            FAIL("PERF_BUDGET_REQUIRED is set, but there is no instruction counter");       \
+        } else {                                                                            \
+            perf_budget::noteSkipped();                                                     \
+        }                                                                                   \
+    } while (0)
+
+/**
+ * Fails if a call on large data costs more than maxRatio times a call on
+ * small data. CHECK_CONSTANT_COST allows 2: O(1) with room for cache
+ * effects and timing noise.
+ */
+#define CHECK_CONSTANT_COST_RATIO(small, large, maxRatio)                                   \
+    do {                                                                                    \
+        const double ratio_ = perf_budget::costRatio(small, large);                         \
+        CHECK_TEXT(ratio_ <= (maxRatio),                                                    \
+                   perf_budget::describe(ratio_, (maxRatio),                                \
+                                         "times the cost on small data").c_str());          \
+    } while (0)
+
+#define CHECK_CONSTANT_COST(small, large) CHECK_CONSTANT_COST_RATIO(small, large, 2.0)
+
+#endif  // PERF_BUDGET_HPP
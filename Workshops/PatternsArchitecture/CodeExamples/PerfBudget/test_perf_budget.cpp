@@ -0,0 +1,67 @@
+#include "CppUTest/TestHarness.h"
+#include "PerfBudget.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace perf_budget;
+
+namespace {
+
+// Stands in for code under test: the cost of sum() grows with the data
+struct Series {
+    std::vector<uint32_t> values;
+    uint64_t total = 0;
+
+    explicit Series(size_t size) : values(size, 3U) {}
+
+    void add() { total += values[total % values.size()]; }
+
+    uint64_t sum() const {
+        uint64_t result = 0;
+        for (uint32_t value : values) result += value;
+        return result;
+    }
+};
+
+}  // namespace
+
+// ============================================================================
+// Measurement Tests
+// ============================================================================
+
+TEST_GROUP(PerfBudget) {
+    Series small{16};
+    Series large{4096};
+};
+
+TEST(PerfBudget, MeasureRunsEveryBatchPlusAWarmUp) {
+    size_t calls = 0;
+
+    const Cost cost = measure([&calls]() { calls++; }, 100, 4);
+
+    LONGS_EQUAL(500, calls);
+    CHECK(cost.perCall >= 0.0);
+}
+
+TEST(PerfBudget, ConstantCostIsAccepted) {
+    CHECK_CONSTANT_COST([this]() { small.add(); }, [this]() { large.add(); });
+}
+
+TEST(PerfBudget, LinearCostIsDetected) {
+    const double ratio = costRatio([this]() { keep(small.sum()); }, [this]() { keep(large.sum()); }, 100);
+
+    CHECK(ratio > 10.0);   // 256 times the data
+}
+
+TEST(PerfBudget, CheapOperationMeetsItsBudget) {
+    // Passes with a counter, and is skipped (with a note) without one
+    CHECK_INSTRUCTION_BUDGET(200, [this]() { small.add(); });
+}
+
+TEST(PerfBudget, DescribesTheMeasurement) {
+    const std::string text = describe(41.5, 40, "instructions per call");
+
+    STRCMP_EQUAL("41.5 instructions per call, budget 40.0", text.c_str());
+}
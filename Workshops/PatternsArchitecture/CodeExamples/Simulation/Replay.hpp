@@ -0,0 +1,524 @@
+#ifndef REPLAY_HPP
+#define REPLAY_HPP
+
+#include "Simulation.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * =============================================================================
+ * RECORD AND REPLAY (field traces into the firmware simulation)
+ * =============================================================================
+ *
+ * Problem:
+ *   A bug seen on a ward happens with that patient's signal, that timing
+ *   and that order of bus traffic. Synthetic models (AdcModel, ...) do
+ *   not reproduce it, and waiting for it on the bench can take days.
+ *
+ * Solution:
+ *   The gateway records what the firmware saw: raw ADC values, I2C
+ *   responses and bytes on the serial line, each with its time. A
+ *   ReplaySource schedules these records on the simulator, so the
+ *   firmware under test reads them through the usual mocks at the same
+ *   virtual times: analogRead() returns the recorded value of the pin,
+ *   ReplayWire answers requestFrom() with the recorded response,
+ *   SerialCapture delivers the recorded input and collects the output.
+ *
+ *   By default the replay runs as fast as the host can (the virtual clock
+ *   jumps from record to record): an hour of trace takes seconds, so a
+ *   regression or a change in run time shows up in a unit test. With
+ *   Pace::RealTime the replay waits for the wall clock (optionally sped
+ *   up), for a bench setup or a human watching the output.
+ *
+ * Trace format (text, one record per line, '#' starts a comment):
+ *
+ *   time_us,adc,pin,value          e.g.  2000,adc,14,2051
+ *   time_us,i2c,address,hex bytes        10000,i2c,0x2A,07FF0800
+ *   time_us,serial,0,hex bytes           5000,serial,0,52450D0A
+ *
+ * Times are relative; the first record is replayed at the start time.
+ *
+ * =============================================================================
+ */
+
+namespace simulation {
+
+// ============================================================================
+// Recording
+// ============================================================================
+
+struct ReplayRecord {
+    enum class Kind : uint8_t { Adc, I2c, Serial };
+
+    TimeUs timeUs;
+    Kind kind;
+    uint16_t source;             // Pin, I2C address or serial port
+    uint16_t value;              // Adc
+    std::vector<uint8_t> bytes;  // I2c response, Serial input
+};
+
+/**
+ * @brief An ordered trace of records, read from and written to the text format
+ */
+class Recording {
+public:
+    void addAdc(TimeUs timeUs, uint16_t pin, uint16_t value) {
+        add(ReplayRecord{timeUs, ReplayRecord::Kind::Adc, pin, value, {}});
+    }
+
+    void addI2c(TimeUs timeUs, uint8_t address, std::vector<uint8_t> response) {
+        add(ReplayRecord{timeUs, ReplayRecord::Kind::I2c, address, 0, std::move(response)});
+    }
+
+    void addSerial(TimeUs timeUs, const std::string& text, uint16_t port = 0) {
+        add(ReplayRecord{timeUs, ReplayRecord::Kind::Serial, port, 0, std::vector<uint8_t>(text.begin(), text.end())});
+    }
+
+    /**
+     * @brief Append a record; records must come in time order
+     * @return false if it is older than the last one (it is not added)
+     */
+    bool add(ReplayRecord record) {
+        if (!records_.empty() && record.timeUs < records_.back().timeUs) return false;
+        records_.push_back(std::move(record));
+        return true;
+    }
+
+    /**
+     * @brief Read a trace
+     * @param error Receives "line n: reason" for the first bad line
+     * @return false on a bad line; the records before it are kept
+     */
+    bool read(std::istream& in, std::string* error = nullptr) {
+        std::string line;
+        for (size_t number = 1; std::getline(in, line); ++number) {
+            const size_t comment = line.find('#');
+            if (comment != std::string::npos) line.erase(comment);
+            if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+
+            const char* problem = parse(line);
+            if (problem != nullptr) {
+                if (error != nullptr) *error = "line " + std::to_string(number) + ": " + problem;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void write(std::ostream& out) const {
+        static const char* const KINDS[] = {"adc", "i2c", "serial"};
+        for (const ReplayRecord& record : records_) {
+            out << record.timeUs << ',' << KINDS[static_cast<int>(record.kind)] << ',' << record.source << ',';
+            if (record.kind == ReplayRecord::Kind::Adc) {
+                out << record.value;
+            } else {
+                char hex[3];
+                for (uint8_t byte : record.bytes) {
+                    std::snprintf(hex, sizeof(hex), "%02X", byte);
+                    out << hex;
+                }
+            }
+            out << '\n';
+        }
+    }
+
+    const std::vector<ReplayRecord>& getRecords() const { return records_; }
+    size_t size() const { return records_.size(); }
+    bool empty() const { return records_.empty(); }
+
+    // From the first to the last record
+    TimeUs getDurationUs() const { return empty() ? 0 : records_.back().timeUs - records_.front().timeUs; }
+
+private:
+    // nullptr if the line was added, the reason otherwise
+    const char* parse(const std::string& line) {
+        std::vector<std::string> fields;
+        std::stringstream stream(line);
+        for (std::string field; std::getline(stream, field, ',');) {
+            const size_t first = field.find_first_not_of(" \t\r");
+            const size_t last = field.find_last_not_of(" \t\r");
+            fields.push_back(first == std::string::npos ? "" : field.substr(first, last - first + 1));
+        }
+        if (fields.size() != 4) return "expected time,kind,source,data";
+
+        char* end = nullptr;
+        const TimeUs time = std::strtoull(fields[0].c_str(), &end, 10);
+        if (fields[0].empty() || *end != '\0') return "bad time";
+        const unsigned long source = std::strtoul(fields[2].c_str(), &end, 0);
+        if (fields[2].empty() || *end != '\0' || source > 0xFFFF) return "bad source";
+
+        ReplayRecord record{time, ReplayRecord::Kind::Adc, static_cast<uint16_t>(source), 0, {}};
+        if (fields[1] == "adc") {
+            const unsigned long value = std::strtoul(fields[3].c_str(), &end, 0);
+            if (fields[3].empty() || *end != '\0' || value > 0xFFFF) return "bad ADC value";
+            record.value = static_cast<uint16_t>(value);
+        } else if (fields[1] == "i2c" || fields[1] == "serial") {
+            record.kind = fields[1] == "i2c" ? ReplayRecord::Kind::I2c : ReplayRecord::Kind::Serial;
+            if (record.kind == ReplayRecord::Kind::I2c && source > 0x7F) return "bad I2C address";
+            if (fields[3].size() % 2 != 0) return "odd number of hex digits";
+            for (size_t i = 0; i < fields[3].size(); i += 2) {
+                const std::string pair = fields[3].substr(i, 2);
+                const unsigned long byte = std::strtoul(pair.c_str(), &end, 16);
+                if (*end != '\0') return "bad hex byte";
+                record.bytes.push_back(static_cast<uint8_t>(byte));
+            }
+        } else {
+            return "unknown kind";
+        }
+        return add(std::move(record)) ? nullptr : "time goes backwards";
+    }
+
+    std::vector<ReplayRecord> records_;
+};
+
+// ============================================================================
+// ReplaySource
+// ============================================================================
+
+/**
+ * @brief Plays a recording into the simulator and holds what it last set
+ *
+ * Only the next record is ever in the event queue, so a trace of
+ * millions of records costs no more memory than the recording itself.
+ * A pin keeps its recorded value until the next record for it, as a
+ * sample-and-hold ADC would; the latest I2C response of an address
+ * stays valid likewise.
+ */
+class ReplaySource {
+public:
+    enum class Pace {
+        Unlimited,   // As fast as the host can
+        RealTime     // Wait for the wall clock, 'speed' times faster
+    };
+
+    using Observer = std::function<void(const ReplayRecord&)>;
+
+    ReplaySource(Simulator& simulator, const Recording& recording,
+                 Pace pace = Pace::Unlimited, double speed = 1.0)
+        : simulator_(simulator)
+        , recording_(recording)
+        , pace_(pace)
+        , speed_(speed > 0.0 ? speed : 1.0)
+        , next_(0)
+        , startUs_(0)
+        , event_(Simulator::NO_EVENT)
+        , maxLagUs_(0)
+    {}
+
+    ~ReplaySource() { stop(); }
+
+    ReplaySource(const ReplaySource&) = delete;
+    ReplaySource& operator=(const ReplaySource&) = delete;
+
+    /**
+     * @brief Replay from the start of the recording, its first record at startUs
+     */
+    void start(TimeUs startUs) {
+        stop();
+        next_ = 0;
+        startUs_ = startUs;
+        wallStart_ = std::chrono::steady_clock::now();
+        adc_.clear();
+        i2c_.clear();
+        for (auto& input : serial_) input.second.clear();   // SerialCapture holds on to these
+        scheduleNext();
+    }
+
+    void start() { start(simulator_.now()); }
+
+    void stop() {
+        simulator_.cancel(event_);
+        event_ = Simulator::NO_EVENT;
+    }
+
+    // Runs for every record as it is applied (e.g. to count or log them)
+    void onRecord(Observer observer) { observer_ = std::move(observer); }
+
+    // What the firmware sees now
+    uint16_t analogRead(uint16_t pin) const {
+        const auto found = adc_.find(pin);
+        return found == adc_.end() ? 0 : found->second;
+    }
+
+    // nullptr while nothing was recorded for the address (it would NACK)
+    const std::vector<uint8_t>* getResponse(uint8_t address) const {
+        const auto found = i2c_.find(address);
+        return found == i2c_.end() ? nullptr : &found->second;
+    }
+
+    // Serial input that has arrived and is not read yet
+    std::deque<uint8_t>& getSerialInput(uint16_t port = 0) { return serial_[port]; }
+
+    bool isFinished() const { return next_ >= recording_.size(); }
+    size_t getApplied() const { return next_; }
+
+    // Virtual time of the last record
+    TimeUs getEndUs() const { return startUs_ + recording_.getDurationUs(); }
+
+    // RealTime: the longest the host fell behind the wall clock schedule
+    TimeUs getMaxLagUs() const { return maxLagUs_; }
+
+private:
+    void scheduleNext() {
+        if (isFinished()) {
+            event_ = Simulator::NO_EVENT;
+            return;
+        }
+        const TimeUs firstUs = recording_.getRecords().front().timeUs;
+        const TimeUs at = startUs_ + (recording_.getRecords()[next_].timeUs - firstUs);
+        event_ = simulator_.at(at, [this]() { apply(); });
+    }
+
+    void apply() {
+        const ReplayRecord& record = recording_.getRecords()[next_];
+        if (pace_ == Pace::RealTime) waitForWallClock();
+
+        switch (record.kind) {
+            case ReplayRecord::Kind::Adc:
+                adc_[record.source] = record.value;
+                break;
+            case ReplayRecord::Kind::I2c:
+                i2c_[static_cast<uint8_t>(record.source)] = record.bytes;
+                break;
+            case ReplayRecord::Kind::Serial: {
+                std::deque<uint8_t>& input = serial_[record.source];
+                input.insert(input.end(), record.bytes.begin(), record.bytes.end());
+                break;
+            }
+        }
+        next_++;
+        if (observer_) observer_(record);
+        scheduleNext();
+    }
+
+    void waitForWallClock() {
+        const double virtualUs = static_cast<double>(simulator_.now() - startUs_) / speed_;
+        const auto due = wallStart_ + std::chrono::microseconds(static_cast<int64_t>(virtualUs));
+        const auto now = std::chrono::steady_clock::now();
+        if (now < due) {
+            std::this_thread::sleep_until(due);
+        } else {
+            const TimeUs lag = static_cast<TimeUs>(std::chrono::duration_cast<std::chrono::microseconds>(now - due).count());
+            if (lag > maxLagUs_) maxLagUs_ = lag;
+        }
+    }
+
+    Simulator& simulator_;
+    const Recording& recording_;
+    Pace pace_;
+    double speed_;
+    size_t next_;                // Next record to apply
+    TimeUs startUs_;
+    Simulator::EventId event_;
+    std::chrono::steady_clock::time_point wallStart_;
+    TimeUs maxLagUs_;
+    Observer observer_;
+    std::unordered_map<uint16_t, uint16_t> adc_;
+    std::unordered_map<uint8_t, std::vector<uint8_t>> i2c_;
+    std::unordered_map<uint16_t, std::deque<uint8_t>> serial_;
+};
+
+// ============================================================================
+// Mocks for firmware code (Wire, Serial, analogRead)
+// ============================================================================
+
+/**
+ * @brief TwoWire master look-alike answering from the replay
+ *
+ * requestFrom() returns the latest recorded response of the address
+ * (up to the requested length), or 0 (NACK) if none was recorded yet.
+ * Writes are collected, so a test can check what the firmware sent.
+ */
+class ReplayWire {
+public:
+    explicit ReplayWire(const ReplaySource& source) : source_(source), address_(0), position_(0), requests_(0) {}
+
+    void begin() {}
+    void setClock(uint32_t) {}
+
+    void beginTransmission(uint8_t address) {
+        address_ = address;
+        pending_.clear();
+    }
+
+    size_t write(uint8_t byte) {
+        pending_.push_back(byte);
+        return 1;
+    }
+
+    size_t write(const uint8_t* data, size_t length) {
+        pending_.insert(pending_.end(), data, data + length);
+        return length;
+    }
+
+    // 0 = ACK, 2 = address NACK (nothing recorded for it)
+    uint8_t endTransmission(bool = true) {
+        written_.push_back(Write{address_, pending_});
+        pending_.clear();
+        return source_.getResponse(address_) != nullptr ? 0 : 2;
+    }
+
+    uint8_t requestFrom(uint8_t address, size_t quantity, bool = true) {
+        requests_++;
+        received_.clear();
+        position_ = 0;
+        const std::vector<uint8_t>* response = source_.getResponse(address);
+        if (response == nullptr) return 0;
+        const size_t count = std::min(quantity, response->size());
+        received_.assign(response->begin(), response->begin() + count);
+        return static_cast<uint8_t>(count);
+    }
+
+    int available() const { return static_cast<int>(received_.size() - position_); }
+    int read() { return position_ < received_.size() ? received_[position_++] : -1; }
+
+    struct Write {
+        uint8_t address;
+        std::vector<uint8_t> bytes;
+    };
+
+    const std::vector<Write>& getWrites() const { return written_; }
+    uint32_t getRequests() const { return requests_; }
+
+private:
+    const ReplaySource& source_;
+    uint8_t address_;
+    std::vector<uint8_t> pending_;
+    std::vector<Write> written_;
+    std::vector<uint8_t> received_;
+    size_t position_;
+    uint32_t requests_;
+};
+
+/**
+ * @brief Serial look-alike: recorded input in, firmware output collected
+ */
+class SerialCapture {
+public:
+    explicit SerialCapture(ReplaySource& source, uint16_t port = 0) : input_(source.getSerialInput(port)) {}
+
+    void begin(unsigned long) {}
+    explicit operator bool() const { return true; }
+
+    int available() const { return static_cast<int>(input_.size()); }
+
+    int read() {
+        if (input_.empty()) return -1;
+        const uint8_t byte = input_.front();
+        input_.pop_front();
+        return byte;
+    }
+
+    int peek() const { return input_.empty() ? -1 : input_.front(); }
+
+    size_t write(uint8_t byte) {
+        output_.push_back(static_cast<char>(byte));
+        return 1;
+    }
+
+    size_t write(const uint8_t* data, size_t length) {
+        output_.append(reinterpret_cast<const char*>(data), length);
+        return length;
+    }
+
+    size_t print(const char* text) { return append(text); }
+    size_t print(const std::string& text) { return append(text); }
+    size_t print(char c) { return write(static_cast<uint8_t>(c)); }
+    size_t print(long value, int base = 10) { return append(format(value, base)); }
+    size_t print(int value, int base = 10) { return print(static_cast<long>(value), base); }
+    size_t print(unsigned long value, int base = 10) { return append(formatUnsigned(value, base)); }
+    size_t print(unsigned int value, int base = 10) { return print(static_cast<unsigned long>(value), base); }
+
+    size_t print(double value, int digits = 2) {
+        char text[64];
+        std::snprintf(text, sizeof(text), "%.*f", digits, value);
+        return append(text);
+    }
+
+    template <typename T>
+    size_t println(const T& value) { return print(value) + println(); }
+    template <typename T>
+    size_t println(const T& value, int option) { return print(value, option) + println(); }
+    size_t println() { return append("\r\n"); }
+
+    const std::string& getOutput() const { return output_; }
+
+    /**
+     * @brief Complete output lines since the last call, without "\r\n"
+     */
+    std::vector<std::string> takeLines() {
+        std::vector<std::string> lines;
+        size_t start = 0;
+        for (size_t end; (end = output_.find('\n', start)) != std::string::npos; start = end + 1) {
+            std::string line = output_.substr(start, end - start);
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            lines.push_back(line);
+        }
+        output_.erase(0, start);
+        return lines;
+    }
+
+private:
+    size_t append(const std::string& text) {
+        output_ += text;
+        return text.size();
+    }
+
+    static std::string formatUnsigned(unsigned long value, int base) {
+        if (base < 2 || base > 16) base = 10;
+        std::string digits;
+        do {
+            digits.insert(digits.begin(), "0123456789ABCDEF"[value % static_cast<unsigned long>(base)]);
+            value /= static_cast<unsigned long>(base);
+        } while (value != 0);
+        return digits;
+    }
+
+    static std::string format(long value, int base) {
+        if (base != 10 || value >= 0) return formatUnsigned(static_cast<unsigned long>(value), base);
+        return "-" + formatUnsigned(0UL - static_cast<unsigned long>(value), base);
+    }
+
+    std::deque<uint8_t>& input_;
+    std::string output_;
+};
+
+/**
+ * @brief Makes a replay the source of arduino::analogRead() while in scope
+ */
+class ReplayScope {
+public:
+    explicit ReplayScope(ReplaySource& source) : previous_(current()) { current() = &source; }
+    ~ReplayScope() { current() = previous_; }
+
+    ReplayScope(const ReplayScope&) = delete;
+    ReplayScope& operator=(const ReplayScope&) = delete;
+
+    static ReplaySource*& current() {
+        static ReplaySource* source = nullptr;
+        return source;
+    }
+
+private:
+    ReplaySource* previous_;
+};
+
+namespace arduino {
+
+inline int analogRead(uint16_t pin) { return ReplayScope::current()->analogRead(pin); }
+
+}  // namespace arduino
+
+}  // namespace simulation
+
+#endif  // REPLAY_HPP
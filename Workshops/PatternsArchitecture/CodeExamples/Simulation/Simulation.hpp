@@ -0,0 +1,539 @@
+#ifndef SIMULATION_HPP
+#define SIMULATION_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <queue>
+#include <random>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * =============================================================================
+ * DISCRETE-EVENT SIMULATION (virtual time for firmware on the host)
+ * =============================================================================
+ *
+ * Problem:
+ *   Mocks have no notion of time. A test of "the heater holds 55 C for a
+ *   day" or "100 ms task never runs late over an hour" would have to
+ *   wait for the real clock, so such scenarios are never tested.
+ *
+ * Solution:
+ *   A virtual clock that jumps from event to event. Everything that
+ *   happens "later" (timer ticks, bounce edges, I2C completions) is an
+ *   event in a queue sorted on time. The simulator takes the earliest
+ *   event, sets the clock to its time and runs it; nothing waits for
+ *   real time, so a simulated hour takes milliseconds when little
+ *   happens and about a second for 3.6 million 1ms ticks.
+ *
+ *   Peripheral models read the virtual clock: an ADC with noise, an I2C
+ *   bus with transfer time, a bouncing contact, a thermal plant. The
+ *   code under test keeps its interfaces (IRawButton, ITemperatureSensor,
+ *   ...); a thin adapter connects them to a model.
+ *
+ * Determinism:
+ *   Events at the same time run in the order they were scheduled, and
+ *   every model has its own seeded generator, so a run is repeatable:
+ *   a failing scenario fails the same way every time.
+ *
+ * =============================================================================
+ */
+
+namespace simulation {
+
+using TimeUs = uint64_t;  // Virtual time since the start, microseconds
+
+constexpr TimeUs MS = 1000U;
+constexpr TimeUs SECOND = 1000U * MS;
+constexpr TimeUs MINUTE = 60U * SECOND;
+constexpr TimeUs HOUR = 60U * MINUTE;
+
+// ============================================================================
+// Simulator (event queue + virtual clock)
+// ============================================================================
+
+/**
+ * @brief Event queue with a virtual clock
+ *
+ * at() / after() schedule a one-shot action, every() a periodic one.
+ * runUntil() / runFor() run all events up to a time and leave the
+ * clock there. Actions may schedule and cancel events themselves.
+ */
+class Simulator {
+public:
+    using Action = std::function<void()>;
+    using EventId = uint64_t;
+
+    static constexpr EventId NO_EVENT = 0;
+
+    Simulator() : now_(0), nextId_(1), sequence_(0), eventsRun_(0), running_(NO_EVENT), cancelRunning_(false) {}
+
+    TimeUs now() const { return now_; }
+
+    // Arduino-style views on the virtual clock (wrap like the real ones)
+    uint32_t millis() const { return static_cast<uint32_t>(now_ / MS); }
+    uint32_t micros() const { return static_cast<uint32_t>(now_); }
+
+    /**
+     * @brief Run an action at an absolute time (not before now)
+     */
+    EventId at(TimeUs time, Action action) {
+        return schedule(time < now_ ? now_ : time, 0, std::move(action));
+    }
+
+    EventId after(TimeUs delay, Action action) {
+        return schedule(now_ + delay, 0, std::move(action));
+    }
+
+    /**
+     * @brief Run an action every period, the first time after firstDelay
+     * @param period Must be > 0
+     */
+    EventId every(TimeUs period, Action action, TimeUs firstDelay = 0) {
+        if (period == 0) return NO_EVENT;
+        return schedule(now_ + (firstDelay == 0 ? period : firstDelay), period, std::move(action));
+    }
+
+    /**
+     * @brief Remove a pending event (a periodic one stops repeating)
+     * @return false if it already ran or was cancelled
+     */
+    bool cancel(EventId id) {
+        if (id != NO_EVENT && id == running_) {
+            cancelRunning_ = true;  // Erased when its action returns
+            return true;
+        }
+        return actions_.erase(id) > 0;
+    }
+
+    /**
+     * @brief Run the earliest pending event
+     * @return false when the queue is empty
+     */
+    bool step() {
+        while (!queue_.empty()) {
+            const Entry entry = queue_.top();
+            queue_.pop();
+            auto found = actions_.find(entry.id);
+            if (found == actions_.end()) continue;  // Cancelled
+
+            now_ = entry.time;
+            eventsRun_++;
+            if (found->second.period == 0) {
+                Action action = std::move(found->second.action);
+                actions_.erase(found);
+                action();
+            } else {
+                queue_.push(Entry{entry.time + found->second.period, sequence_++, entry.id});
+                running_ = entry.id;
+                found->second.action();  // Node stays valid: a self-cancel is deferred
+                running_ = NO_EVENT;
+                if (cancelRunning_) {
+                    cancelRunning_ = false;
+                    actions_.erase(entry.id);
+                }
+            }
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Run every event up to and including time, then set the clock to it
+     * @return Events run
+     */
+    size_t runUntil(TimeUs time) {
+        size_t count = 0;
+        while (!queue_.empty() && nextTime() <= time) {
+            if (step()) count++;
+        }
+        if (time > now_) now_ = time;
+        return count;
+    }
+
+    size_t runFor(TimeUs duration) { return runUntil(now_ + duration); }
+
+    size_t getPendingCount() const { return actions_.size(); }
+    uint64_t getEventsRun() const { return eventsRun_; }
+
+private:
+    struct Entry {
+        TimeUs time;
+        uint64_t sequence;  // Ties run in scheduling order
+        EventId id;
+
+        bool operator>(const Entry& other) const {
+            return time != other.time ? time > other.time : sequence > other.sequence;
+        }
+    };
+
+    struct Pending {
+        Action action;
+        TimeUs period;
+    };
+
+    EventId schedule(TimeUs time, TimeUs period, Action action) {
+        const EventId id = nextId_++;
+        actions_.emplace(id, Pending{std::move(action), period});
+        queue_.push(Entry{time, sequence_++, id});
+        return id;
+    }
+
+    // Earliest event that is still pending (drops cancelled ones)
+    TimeUs nextTime() {
+        while (!queue_.empty() && actions_.count(queue_.top().id) == 0) {
+            queue_.pop();
+        }
+        return queue_.empty() ? now_ : queue_.top().time;
+    }
+
+    TimeUs now_;
+    EventId nextId_;
+    uint64_t sequence_;
+    uint64_t eventsRun_;
+    EventId running_;      // Periodic event whose action is running
+    bool cancelRunning_;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue_;
+    std::unordered_map<EventId, Pending> actions_;
+};
+
+// ============================================================================
+// Clock shims for code written against millis() / micros() and the patterns
+// ============================================================================
+
+/**
+ * @brief Makes a simulator the clock of the shims below while in scope
+ */
+class ClockScope {
+public:
+    explicit ClockScope(Simulator& simulator) : previous_(current()) { current() = &simulator; }
+    ~ClockScope() { current() = previous_; }
+
+    ClockScope(const ClockScope&) = delete;
+    ClockScope& operator=(const ClockScope&) = delete;
+
+    static Simulator*& current() {
+        static Simulator* simulator = nullptr;
+        return simulator;
+    }
+
+private:
+    Simulator* previous_;
+};
+
+namespace arduino {
+
+// 'using namespace simulation::arduino;' lets Arduino code call these
+inline uint32_t millis() { return ClockScope::current()->millis(); }
+inline uint32_t micros() { return ClockScope::current()->micros(); }
+
+}  // namespace arduino
+
+/**
+ * @brief CycleCounter for CyclicExecutive: task times in virtual microseconds
+ *
+ * Only advances while a task itself moves the clock (e.g. a model that
+ * costs time), so it measures simulated, not host, execution time.
+ */
+struct SimCycleCounter {
+    static constexpr bool ENABLED = true;
+    static uint32_t now() { return ClockScope::current()->micros(); }
+};
+
+/**
+ * @brief Tickless PowerPolicy for CyclicExecutive / TimeSlotScheduler
+ *
+ * sleepFor() runs the simulator for the requested time, so the other
+ * models (button edges, I2C completions) keep running while the
+ * scheduler "sleeps". Hours of a mostly idle schedule cost only the
+ * task releases.
+ */
+struct SimTicklessPolicy {
+    static constexpr bool TICKLESS = true;
+    static constexpr uint32_t MAX_SLEEP_MS = 60000;
+    static uint32_t sleepFor(uint32_t ms) {
+        ClockScope::current()->runFor(ms * MS);
+        return ms;
+    }
+};
+
+// ============================================================================
+// Peripheral Models
+// ============================================================================
+
+/**
+ * @brief ADC: signal in volts, Gaussian noise, quantization and clamping
+ */
+class AdcModel {
+public:
+    using Signal = std::function<double(TimeUs)>;
+
+    AdcModel(const Simulator& simulator, Signal signal, uint8_t bits = 12,
+             double vref = 3.3, double noiseRmsV = 0.0, uint32_t seed = 1)
+        : simulator_(simulator)
+        , signal_(std::move(signal))
+        , maxCount_((1U << bits) - 1U)
+        , countsPerVolt_((1U << bits) / vref)
+        , noise_(0.0, noiseRmsV > 0.0 ? noiseRmsV : 1.0)
+        , noisy_(noiseRmsV > 0.0)
+        , random_(seed)
+    {}
+
+    /**
+     * @brief Convert the signal at the current virtual time
+     */
+    uint16_t read() {
+        double volts = signal_(simulator_.now());
+        if (noisy_) volts += noise_(random_);
+        const double counts = std::floor(volts * countsPerVolt_ + 0.5);
+        if (counts <= 0.0) return 0;
+        if (counts >= maxCount_) return static_cast<uint16_t>(maxCount_);
+        return static_cast<uint16_t>(counts);
+    }
+
+    uint16_t getMaxCount() const { return static_cast<uint16_t>(maxCount_); }
+
+private:
+    const Simulator& simulator_;
+    Signal signal_;
+    uint32_t maxCount_;
+    double countsPerVolt_;
+    std::normal_distribution<double> noise_;
+    bool noisy_;
+    std::mt19937 random_;
+};
+
+/**
+ * @brief I2C bus: transfers take bus time and complete later, one at a time
+ *
+ * A transfer of n data bytes costs start + address + n bytes (9 clocks
+ * each, with ACK) + stop, plus a random clock-stretching delay per
+ * transfer. Transfers requested while the bus is busy wait in order.
+ */
+class I2cBusModel {
+public:
+    using Done = std::function<void()>;
+
+    I2cBusModel(Simulator& simulator, uint32_t clockHz = 100000,
+                TimeUs maxStretchUs = 0, uint32_t seed = 1)
+        : simulator_(simulator)
+        , clockHz_(clockHz)
+        , stretch_(0, maxStretchUs)
+        , random_(seed)
+        , busy_(false)
+        , transfers_(0)
+        , busyUs_(0)
+    {}
+
+    // Bus time of a transfer without clock stretching
+    TimeUs transferTimeUs(size_t bytes) const {
+        const uint64_t clocks = 1U + 9U * (bytes + 1U) + 1U;  // start, address, data, stop
+        return (clocks * SECOND + clockHz_ - 1U) / clockHz_;
+    }
+
+    /**
+     * @brief Queue a transfer of 'bytes' data bytes; done runs when it is on the wire
+     */
+    void transfer(size_t bytes, Done done) {
+        waiting_.push_back(Request{bytes, std::move(done)});
+        if (!busy_) startNext();
+    }
+
+    bool isBusy() const { return busy_; }
+    size_t getWaiting() const { return waiting_.size(); }
+    uint32_t getTransfers() const { return transfers_; }
+    TimeUs getBusyUs() const { return busyUs_; }
+
+private:
+    struct Request {
+        size_t bytes;
+        Done done;
+    };
+
+    void startNext() {
+        if (waiting_.empty()) {
+            busy_ = false;
+            return;
+        }
+        busy_ = true;
+        Request request = std::move(waiting_.front());
+        waiting_.pop_front();
+
+        const TimeUs duration = transferTimeUs(request.bytes) + stretch_(random_);
+        busyUs_ += duration;
+        simulator_.after(duration, [this, done = std::move(request.done)]() {
+            transfers_++;
+            if (done) done();
+            startNext();
+        });
+    }
+
+    Simulator& simulator_;
+    uint32_t clockHz_;
+    std::uniform_int_distribution<TimeUs> stretch_;
+    std::mt19937 random_;
+    std::deque<Request> waiting_;
+    bool busy_;
+    uint32_t transfers_;
+    TimeUs busyUs_;
+};
+
+/**
+ * @brief Mechanical contact that bounces after every press and release
+ *
+ * press() / release() change the level a few times at random moments
+ * within the bounce time before it settles. An optional edge callback
+ * (the pin-change interrupt) runs on every change of the level.
+ */
+class BouncingContact {
+public:
+    using Edge = std::function<void()>;
+
+    BouncingContact(Simulator& simulator, TimeUs bounceUs = 5 * MS,
+                    uint8_t maxBounces = 6, uint32_t seed = 1)
+        : simulator_(simulator)
+        , bounceUs_(bounceUs)
+        , maxBounces_(maxBounces)
+        , random_(seed)
+        , level_(false)
+        , target_(false)
+        , edges_(0)
+        , pending_(0)
+    {}
+
+    void onEdge(Edge edge) { edge_ = std::move(edge); }
+
+    void press() { actuate(true); }
+    void release() { actuate(false); }
+
+    bool isClosed() const { return level_; }  // true = pressed
+    bool isSettled() const { return level_ == target_ && pending_ == 0; }
+    uint32_t getEdges() const { return edges_; }
+
+private:
+    void actuate(bool closed) {
+        target_ = closed;
+        // An even number of extra changes, so the level ends at the target
+        const uint8_t bounces = maxBounces_ > 1
+            ? static_cast<uint8_t>(std::uniform_int_distribution<int>(0, maxBounces_ / 2)(random_) * 2)
+            : 0;
+        std::vector<TimeUs> times(bounces + 1U, 0);
+        std::uniform_int_distribution<TimeUs> when(0, bounceUs_);
+        for (size_t i = 1; i < times.size(); ++i) times[i] = when(random_);
+        std::sort(times.begin() + 1, times.end());
+
+        bool level = level_;
+        for (TimeUs t : times) {
+            level = !level;
+            pending_++;
+            simulator_.after(t, [this, level]() { set(level); });
+        }
+    }
+
+    void set(bool level) {
+        pending_--;
+        if (level == level_) return;
+        level_ = level;
+        edges_++;
+        if (edge_) edge_();
+    }
+
+    Simulator& simulator_;
+    TimeUs bounceUs_;
+    uint8_t maxBounces_;
+    std::mt19937 random_;
+    bool level_;
+    bool target_;
+    uint32_t edges_;
+    uint32_t pending_;  // Scheduled level changes
+    Edge edge_;
+};
+
+/**
+ * @brief First-order thermal plant: a heated mass losing heat to ambient
+ *
+ *   C dT/dt = P_heater - (T - T_ambient) / R
+ *
+ * With the heater input constant between changes the solution is exact,
+ * T approaches T_ambient + P R with time constant R C, so the model is
+ * only evaluated when someone looks at it or switches the heater, no
+ * matter how long the interval.
+ */
+class ThermalPlant {
+public:
+    struct Params {
+        double ambientC = 20.0;
+        double heaterW = 50.0;
+        double resistanceKPerW = 1.0;   // K per W to ambient
+        double capacityJPerK = 600.0;   // time constant R C = 10 minutes
+        double initialC = 20.0;
+    };
+
+    ThermalPlant(const Simulator& simulator, const Params& params)
+        : simulator_(simulator)
+        , params_(params)
+        , temperatureC_(params.initialC)
+        , updatedUs_(simulator.now())
+        , power_(0.0)
+        , energyJ_(0.0)
+    {}
+
+    double getTemperatureC() {
+        advance();
+        return temperatureC_;
+    }
+
+    /**
+     * @brief Heater power as a fraction 0..1 (an on/off heater uses 0 or 1)
+     */
+    void setPower(double fraction) {
+        advance();
+        power_ = fraction < 0.0 ? 0.0 : (fraction > 1.0 ? 1.0 : fraction);
+    }
+
+    void setHeater(bool on) { setPower(on ? 1.0 : 0.0); }
+    bool isHeating() const { return power_ > 0.0; }
+
+    void setAmbientC(double ambientC) {
+        advance();
+        params_.ambientC = ambientC;
+    }
+
+    // Steady-state temperature for the current input
+    double getTargetC() const { return params_.ambientC + power_ * params_.heaterW * params_.resistanceKPerW; }
+
+    double getTimeConstantS() const { return params_.resistanceKPerW * params_.capacityJPerK; }
+
+    // Heater energy since construction
+    double getEnergyJ() {
+        advance();
+        return energyJ_;
+    }
+
+private:
+    void advance() {
+        const TimeUs now = simulator_.now();
+        if (now == updatedUs_) return;
+        const double dt = static_cast<double>(now - updatedUs_) / SECOND;
+        const double target = getTargetC();
+        temperatureC_ = target + (temperatureC_ - target) * std::exp(-dt / getTimeConstantS());
+        energyJ_ += power_ * params_.heaterW * dt;
+        updatedUs_ = now;
+    }
+
+    const Simulator& simulator_;
+    Params params_;
+    double temperatureC_;
+    TimeUs updatedUs_;
+    double power_;
+    double energyJ_;
+};
+
+}  // namespace simulation
+
+#endif  // SIMULATION_HPP
@@ -0,0 +1,300 @@
+#include "CppUTest/TestHarness.h"
+#include "Replay.hpp"
+
+#include <chrono>
+#include <sstream>
+#include <string>
+
+using namespace simulation;
+
+// ============================================================================
+// Recording Tests
+// ============================================================================
+
+TEST_GROUP(Recording) {
+    Recording recording;
+};
+
+TEST(Recording, ReadsAllKinds) {
+    std::istringstream in(
+        "# ward 3, bed 12\n"
+        "0,adc,14,2051\n"
+        "\n"
+        "2000, adc, 14, 0x7FF   # hex value\n"
+        "5000,serial,0,52450D0A\n"
+        "10000,i2c,0x2A,07FF0800\n");
+    std::string error;
+
+    CHECK(recording.read(in, &error));
+    LONGS_EQUAL(4, recording.size());
+    LONGS_EQUAL(2051, recording.getRecords()[0].value);
+    LONGS_EQUAL(0x7FF, recording.getRecords()[1].value);
+    CHECK(recording.getRecords()[2].kind == ReplayRecord::Kind::Serial);
+    LONGS_EQUAL(4, recording.getRecords()[2].bytes.size());
+    LONGS_EQUAL(0x2A, recording.getRecords()[3].source);
+    LONGS_EQUAL(0x08, recording.getRecords()[3].bytes[2]);
+    LONGS_EQUAL(10000, recording.getDurationUs());
+}
+
+TEST(Recording, WriteThenReadGivesTheSameRecords) {
+    recording.addAdc(0, 14, 1234);
+    recording.addI2c(100, 0x48, {0x01, 0xFF});
+    recording.addSerial(250, "OK\r\n");
+    std::stringstream text;
+    recording.write(text);
+
+    Recording copy;
+    CHECK(copy.read(text));
+    LONGS_EQUAL(3, copy.size());
+    LONGS_EQUAL(1234, copy.getRecords()[0].value);
+    LONGS_EQUAL(0xFF, copy.getRecords()[1].bytes[1]);
+    STRCMP_EQUAL("OK\r\n", std::string(copy.getRecords()[2].bytes.begin(), copy.getRecords()[2].bytes.end()).c_str());
+}
+
+TEST(Recording, ReportsTheFirstBadLine) {
+    std::istringstream in(
+        "0,adc,14,100\n"
+        "10,adc,14\n"
+        "20,adc,14,300\n");
+    std::string error;
+
+    CHECK_FALSE(recording.read(in, &error));
+    STRCMP_EQUAL("line 2: expected time,kind,source,data", error.c_str());
+    LONGS_EQUAL(1, recording.size());
+}
+
+TEST(Recording, RejectsTimeGoingBackwards) {
+    std::istringstream in("100,adc,14,1\n50,adc,14,2\n");
+    std::string error;
+
+    CHECK_FALSE(recording.read(in, &error));
+    STRCMP_EQUAL("line 2: time goes backwards", error.c_str());
+}
+
+TEST(Recording, RejectsBadData) {
+    std::string error;
+    std::istringstream kind("0,spi,1,00\n");
+    std::istringstream hex("0,i2c,0x2A,0G\n");
+    std::istringstream odd("0,serial,0,ABC\n");
+    std::istringstream address("0,i2c,0x80,00\n");
+
+    CHECK_FALSE(recording.read(kind, &error));
+    STRCMP_EQUAL("line 1: unknown kind", error.c_str());
+    CHECK_FALSE(recording.read(hex, &error));
+    STRCMP_EQUAL("line 1: bad hex byte", error.c_str());
+    CHECK_FALSE(recording.read(odd, &error));
+    STRCMP_EQUAL("line 1: odd number of hex digits", error.c_str());
+    CHECK_FALSE(recording.read(address, &error));
+    STRCMP_EQUAL("line 1: bad I2C address", error.c_str());
+}
+
+// ============================================================================
+// ReplaySource Tests
+// ============================================================================
+
+TEST_GROUP(ReplaySource) {
+    Simulator sim;
+    Recording recording;
+};
+
+TEST(ReplaySource, AppliesRecordsAtTheirVirtualTimes) {
+    recording.addAdc(1000, 14, 100);
+    recording.addAdc(3000, 14, 300);
+    recording.addAdc(3000, 15, 42);
+    ReplaySource replay(sim, recording);
+
+    sim.runUntil(500);
+    replay.start();
+    LONGS_EQUAL(0, replay.analogRead(14));
+
+    sim.runUntil(500);
+    LONGS_EQUAL(100, replay.analogRead(14));
+    sim.runUntil(2499);
+    LONGS_EQUAL(100, replay.analogRead(14));   // Held until the next record
+    sim.runUntil(2500);
+    LONGS_EQUAL(300, replay.analogRead(14));
+    LONGS_EQUAL(42, replay.analogRead(15));
+    CHECK(replay.isFinished());
+    LONGS_EQUAL(2500, replay.getEndUs());
+}
+
+TEST(ReplaySource, FirmwareReadsThroughArduinoAnalogRead) {
+    recording.addAdc(0, 14, 512);
+    ReplaySource replay(sim, recording);
+    ReplayScope scope(replay);
+    ClockScope clock(sim);
+    replay.start();
+
+    int seen = -1;
+    sim.after(10, [&seen]() { seen = arduino::analogRead(14); });
+    sim.runFor(20);
+
+    LONGS_EQUAL(512, seen);
+}
+
+TEST(ReplaySource, AnHourAt500HzReplaysFast) {
+    const TimeUs period = 2 * MS;
+    const size_t samples = HOUR / period;
+    for (size_t i = 0; i < samples; i++) {
+        recording.addAdc(i * period, 14, static_cast<uint16_t>(i % 4096));
+    }
+    ReplaySource replay(sim, recording);
+    ReplayScope scope(replay);
+    replay.start();
+
+    // Firmware sampling at 250 Hz sees every second recorded value
+    size_t mismatches = 0;
+    size_t reads = 0;
+    sim.every(4 * MS, [&]() {
+        const size_t expected = static_cast<size_t>(sim.now() / period) % 4096;
+        if (arduino::analogRead(14) != static_cast<int>(expected)) mismatches++;
+        reads++;
+    }, 1);
+
+    const auto start = std::chrono::steady_clock::now();
+    sim.runUntil(HOUR);
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    CHECK(replay.isFinished());
+    LONGS_EQUAL(samples, replay.getApplied());
+    LONGS_EQUAL(0, mismatches);
+    CHECK(reads > 800000);
+    CHECK(seconds < 10.0);   // Typically well under a second
+}
+
+TEST(ReplaySource, ObserverSeesEveryRecord) {
+    recording.addAdc(0, 14, 1);
+    recording.addI2c(10, 0x2A, {1});
+    recording.addSerial(20, "x");
+    ReplaySource replay(sim, recording);
+    std::string kinds;
+    replay.onRecord([&kinds](const ReplayRecord& record) {
+        kinds += "aic"[static_cast<int>(record.kind)];
+    });
+
+    replay.start();
+    sim.runFor(100);
+
+    STRCMP_EQUAL("aic", kinds.c_str());
+}
+
+TEST(ReplaySource, StopLeavesTheRestUnapplied) {
+    recording.addAdc(0, 14, 1);
+    recording.addAdc(100, 14, 2);
+    ReplaySource replay(sim, recording);
+
+    replay.start();
+    sim.runFor(50);
+    replay.stop();
+    sim.runFor(100);
+
+    LONGS_EQUAL(1, replay.getApplied());
+    LONGS_EQUAL(1, replay.analogRead(14));
+    CHECK_FALSE(replay.isFinished());
+}
+
+TEST(ReplaySource, RealTimeFollowsTheWallClock) {
+    for (TimeUs t = 0; t <= 50 * MS; t += MS) {
+        recording.addAdc(t, 14, 1);
+    }
+    ReplaySource replay(sim, recording, ReplaySource::Pace::RealTime);
+    replay.start();
+
+    const auto start = std::chrono::steady_clock::now();
+    sim.runUntil(50 * MS);
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    CHECK(replay.isFinished());
+    CHECK(ms >= 49.0);
+}
+
+TEST(ReplaySource, RealTimeCanBeSpedUp) {
+    for (TimeUs t = 0; t <= 500 * MS; t += 10 * MS) {
+        recording.addAdc(t, 14, 1);
+    }
+    ReplaySource replay(sim, recording, ReplaySource::Pace::RealTime, 10.0);
+    replay.start();
+
+    const auto start = std::chrono::steady_clock::now();
+    sim.runUntil(500 * MS);
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    CHECK(ms >= 49.0);
+    CHECK(ms < 400.0);
+}
+
+// ============================================================================
+// ReplayWire / SerialCapture Tests
+// ============================================================================
+
+TEST_GROUP(ReplayMocks) {
+    Simulator sim;
+    Recording recording;
+};
+
+TEST(ReplayMocks, WireServesTheLatestResponse) {
+    recording.addAdc(0, 14, 0);     // The trace starts before the first response
+    recording.addI2c(100, 0x68, {0x07, 0xFF, 0x80});
+    recording.addI2c(200, 0x68, {0x08, 0x00, 0x80});
+    ReplaySource replay(sim, recording);
+    ReplayWire wire(replay);
+    replay.start(0);
+
+    wire.beginTransmission(0x68);
+    wire.write(static_cast<uint8_t>(0x98));
+    LONGS_EQUAL(2, wire.endTransmission());    // Nothing recorded yet: NACK
+    LONGS_EQUAL(0, wire.requestFrom(0x68, 3));
+
+    sim.runUntil(150);
+    wire.beginTransmission(0x68);
+    wire.write(static_cast<uint8_t>(0x98));
+    LONGS_EQUAL(0, wire.endTransmission());
+    LONGS_EQUAL(3, wire.requestFrom(0x68, 3));
+    LONGS_EQUAL(0x07, wire.read());
+    LONGS_EQUAL(0xFF, wire.read());
+
+    sim.runUntil(250);
+    LONGS_EQUAL(2, wire.requestFrom(0x68, 2));
+    LONGS_EQUAL(0x08, wire.read());
+    LONGS_EQUAL(0x00, wire.read());
+    LONGS_EQUAL(-1, wire.read());
+
+    LONGS_EQUAL(2, wire.getWrites().size());
+    LONGS_EQUAL(0x98, wire.getWrites()[1].bytes[0]);
+    LONGS_EQUAL(0, wire.requestFrom(0x48, 2));   // Other address
+}
+
+TEST(ReplayMocks, SerialInputArrivesAtItsTime) {
+    recording.addAdc(0, 14, 0);
+    recording.addSerial(1000, "RE");
+    recording.addSerial(2000, "\r\n");
+    ReplaySource replay(sim, recording);
+    SerialCapture serial(replay);
+    replay.start(0);
+
+    LONGS_EQUAL(0, serial.available());
+    sim.runUntil(1000);
+    LONGS_EQUAL(2, serial.available());
+    LONGS_EQUAL('R', serial.read());
+    sim.runUntil(2000);
+    LONGS_EQUAL(3, serial.available());
+    LONGS_EQUAL('E', serial.peek());
+}
+
+TEST(ReplayMocks, SerialCollectsOutputLines) {
+    ReplaySource replay(sim, recording);
+    SerialCapture serial(replay);
+
+    serial.print("HR ");
+    serial.println(72);
+    serial.print(-5);
+    serial.print(' ');
+    serial.println(36.6, 1);
+    serial.print("partial");
+
+    const std::vector<std::string> lines = serial.takeLines();
+    LONGS_EQUAL(2, lines.size());
+    STRCMP_EQUAL("HR 72", lines[0].c_str());
+    STRCMP_EQUAL("-5 36.6", lines[1].c_str());
+    STRCMP_EQUAL("partial", serial.getOutput().c_str());
+}
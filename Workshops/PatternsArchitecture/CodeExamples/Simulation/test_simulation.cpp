@@ -0,0 +1,395 @@
+#include "CppUTest/TestHarness.h"
+#include "Simulation.hpp"
+#include "../CyclicExecutive/CyclicExecutive.hpp"
+#include "../Debouncing/Debouncing.hpp"
+
+#include <cmath>
+#include <string>
+
+using namespace simulation;
+
+// ============================================================================
+// Simulator Tests
+// ============================================================================
+
+TEST_GROUP(Simulator) {
+    Simulator sim;
+    std::string log;
+
+    Simulator::Action note(const char* text) {
+        return [this, text]() { log += text; };
+    }
+};
+
+TEST(Simulator, RunsEventsInTimeOrder) {
+    sim.at(30, note("c"));
+    sim.at(10, note("a"));
+    sim.at(20, note("b"));
+
+    LONGS_EQUAL(3, sim.runUntil(100));
+    STRCMP_EQUAL("abc", log.c_str());
+}
+
+TEST(Simulator, SameTimeEventsRunInSchedulingOrder) {
+    sim.at(10, note("1"));
+    sim.at(10, note("2"));
+    sim.at(10, note("3"));
+
+    sim.runFor(10);
+    STRCMP_EQUAL("123", log.c_str());
+}
+
+TEST(Simulator, RunUntilStopsAtTheTargetTime) {
+    sim.at(10, note("a"));
+    sim.at(50, note("b"));
+
+    sim.runUntil(20);
+    STRCMP_EQUAL("a", log.c_str());
+    UNSIGNED_LONGS_EQUAL(20, sim.now());
+    LONGS_EQUAL(1, sim.getPendingCount());
+}
+
+TEST(Simulator, ClockJumpsToTheEvent) {
+    TimeUs seen = 0;
+    sim.after(HOUR, [&]() { seen = sim.now(); });
+
+    CHECK_TRUE(sim.step());
+    UNSIGNED_LONGS_EQUAL(HOUR, seen);
+    CHECK_FALSE(sim.step());
+}
+
+TEST(Simulator, PeriodicEventRepeatsUntilCancelled) {
+    int runs = 0;
+    const Simulator::EventId id = sim.every(10 * MS, [&]() { runs++; });
+
+    sim.runFor(100 * MS);
+    LONGS_EQUAL(10, runs);
+
+    CHECK_TRUE(sim.cancel(id));
+    sim.runFor(100 * MS);
+    LONGS_EQUAL(10, runs);
+    CHECK_FALSE(sim.cancel(id));
+}
+
+TEST(Simulator, PeriodicEventCanCancelItself) {
+    int runs = 0;
+    Simulator::EventId id = Simulator::NO_EVENT;
+    id = sim.every(MS, [&]() {
+        if (++runs == 3) sim.cancel(id);
+    });
+
+    sim.runFor(SECOND);
+    LONGS_EQUAL(3, runs);
+    LONGS_EQUAL(0, sim.getPendingCount());
+}
+
+TEST(Simulator, CancelledEventDoesNotRun) {
+    const Simulator::EventId id = sim.at(10, note("x"));
+    sim.at(20, note("y"));
+
+    CHECK_TRUE(sim.cancel(id));
+    sim.runUntil(100);
+    STRCMP_EQUAL("y", log.c_str());
+}
+
+TEST(Simulator, ActionsCanScheduleEvents) {
+    sim.at(10, [&]() {
+        log += "a";
+        sim.after(5, note("b"));
+        sim.at(0, note("c"));  // In the past: runs now, after this one
+    });
+
+    sim.runUntil(100);
+    STRCMP_EQUAL("acb", log.c_str());
+}
+
+TEST(Simulator, ArduinoShimsFollowTheClock) {
+    ClockScope scope(sim);
+    sim.runFor(90 * MINUTE);
+
+    UNSIGNED_LONGS_EQUAL(5400000UL, arduino::millis());
+    // micros() wraps after 2^32 us (71.6 minutes), like on the target
+    UNSIGNED_LONGS_EQUAL(static_cast<uint32_t>(90 * MINUTE), arduino::micros());
+}
+
+// ============================================================================
+// Peripheral Model Tests
+// ============================================================================
+
+TEST_GROUP(Models) {
+    Simulator sim;
+};
+
+TEST(Models, AdcQuantizesAndClamps) {
+    double volts = 1.65;
+    AdcModel adc(sim, [&](TimeUs) { return volts; }, 12, 3.3);
+
+    LONGS_EQUAL(2048, adc.read());
+    volts = 5.0;
+    LONGS_EQUAL(4095, adc.read());
+    volts = -0.2;
+    LONGS_EQUAL(0, adc.read());
+}
+
+TEST(Models, AdcSignalFollowsVirtualTime) {
+    AdcModel adc(sim, [](TimeUs t) { return t >= SECOND ? 3.3 : 0.0; }, 10);
+
+    LONGS_EQUAL(0, adc.read());
+    sim.runFor(SECOND);
+    LONGS_EQUAL(1023, adc.read());
+}
+
+TEST(Models, AdcNoiseHasTheConfiguredSpread) {
+    const double voltsPerCount = 3.3 / 4096;
+    AdcModel adc(sim, [](TimeUs) { return 1.0; }, 12, 3.3, 10 * voltsPerCount, 7);
+
+    double sum = 0.0;
+    double squares = 0.0;
+    const int samples = 20000;
+    for (int i = 0; i < samples; ++i) {
+        const double counts = adc.read();
+        sum += counts;
+        squares += counts * counts;
+    }
+    const double mean = sum / samples;
+    const double rms = std::sqrt(squares / samples - mean * mean);
+
+    DOUBLES_EQUAL(1.0 / voltsPerCount, mean, 0.5);
+    DOUBLES_EQUAL(10.0, rms, 0.5);
+}
+
+TEST(Models, AdcIsRepeatableForTheSameSeed) {
+    AdcModel a(sim, [](TimeUs) { return 1.0; }, 12, 3.3, 0.01, 42);
+    AdcModel b(sim, [](TimeUs) { return 1.0; }, 12, 3.3, 0.01, 42);
+
+    for (int i = 0; i < 100; ++i) {
+        LONGS_EQUAL(a.read(), b.read());
+    }
+}
+
+TEST(Models, I2cTransferTakesBusTime) {
+    I2cBusModel bus(sim, 100000);
+    TimeUs doneAt = 0;
+
+    // Start + address + 2 bytes + stop = 29 clocks at 10 us
+    UNSIGNED_LONGS_EQUAL(290, bus.transferTimeUs(2));
+    bus.transfer(2, [&]() { doneAt = sim.now(); });
+    CHECK_TRUE(bus.isBusy());
+
+    sim.runFor(SECOND);
+    UNSIGNED_LONGS_EQUAL(290, doneAt);
+    CHECK_FALSE(bus.isBusy());
+}
+
+TEST(Models, I2cTransfersWaitForTheBus) {
+    I2cBusModel bus(sim, 400000, 20, 3);
+    std::string order;
+
+    bus.transfer(6, [&]() { order += "a"; });
+    bus.transfer(1, [&]() { order += "b"; });
+    LONGS_EQUAL(1, bus.getWaiting());
+
+    sim.runFor(SECOND);
+    STRCMP_EQUAL("ab", order.c_str());
+    LONGS_EQUAL(2, bus.getTransfers());
+    CHECK_TRUE(bus.getBusyUs() >= bus.transferTimeUs(6) + bus.transferTimeUs(1));
+    CHECK_TRUE(bus.getBusyUs() <= bus.transferTimeUs(6) + bus.transferTimeUs(1) + 40);
+}
+
+TEST(Models, ContactBouncesThenSettles) {
+    BouncingContact contact(sim, 5 * MS, 8, 11);
+    int edges = 0;
+    contact.onEdge([&]() { edges++; });
+
+    contact.press();
+    sim.runFor(5 * MS);
+    CHECK_TRUE(contact.isClosed());
+    CHECK_TRUE(contact.isSettled());
+    CHECK_TRUE(edges % 2 == 1);  // Odd: ends closed
+
+    contact.release();
+    sim.runFor(5 * MS);
+    CHECK_FALSE(contact.isClosed());
+    LONGS_EQUAL(static_cast<long>(contact.getEdges()), edges);
+}
+
+TEST(Models, ThermalPlantFollowsTheTimeConstant) {
+    ThermalPlant::Params params;  // 20 C ambient, 50 W, 1 K/W, tau 600 s
+    ThermalPlant plant(sim, params);
+    plant.setHeater(true);
+
+    sim.runFor(600 * SECOND);
+    DOUBLES_EQUAL(20.0 + 50.0 * (1.0 - std::exp(-1.0)), plant.getTemperatureC(), 1e-9);
+
+    sim.runFor(4 * 600 * SECOND);
+    DOUBLES_EQUAL(70.0, plant.getTemperatureC(), 0.4);
+    DOUBLES_EQUAL(50.0 * 3000.0, plant.getEnergyJ(), 1e-6);
+}
+
+TEST(Models, ThermalPlantDoesNotDependOnTheStepSize) {
+    ThermalPlant::Params params;
+    ThermalPlant coarse(sim, params);
+    ThermalPlant fine(sim, params);
+    coarse.setPower(0.6);
+    fine.setPower(0.6);
+
+    for (int s = 0; s < 3600; ++s) {
+        sim.runFor(SECOND);
+        fine.getTemperatureC();
+    }
+    DOUBLES_EQUAL(fine.getTemperatureC(), coarse.getTemperatureC(), 1e-9);
+}
+
+// ============================================================================
+// Long-Horizon Scenarios
+// ============================================================================
+
+namespace {
+
+using namespace cyclic_executive;
+using namespace debouncing;
+
+// IRawButton on a simulated contact
+class SimButton : public IRawButton {
+public:
+    explicit SimButton(const BouncingContact& contact) : contact_(contact) {}
+    bool readRaw() const override { return contact_.isClosed(); }
+
+private:
+    const BouncingContact& contact_;
+};
+
+// IOneShotTimer on the simulator; expiry calls the debouncer's onTimer()
+class SimOneShotTimer : public IOneShotTimer {
+public:
+    explicit SimOneShotTimer(Simulator& sim) : sim_(sim), event_(Simulator::NO_EVENT), target_(nullptr) {}
+
+    void attach(InterruptDebouncer& debouncer) { target_ = &debouncer; }
+
+    void start(uint16_t ms) override {
+        cancel();
+        event_ = sim_.after(ms * MS, [this]() {
+            event_ = Simulator::NO_EVENT;
+            target_->onTimer();
+        });
+    }
+    void cancel() override {
+        if (event_ != Simulator::NO_EVENT) sim_.cancel(event_);
+        event_ = Simulator::NO_EVENT;
+    }
+
+private:
+    Simulator& sim_;
+    Simulator::EventId event_;
+    InterruptDebouncer* target_;
+};
+
+// Presses the contact every period for half the period, 'count' times
+void schedulePresses(Simulator& sim, BouncingContact& contact, int count, TimeUs period) {
+    for (int i = 0; i < count; ++i) {
+        sim.at(i * period + MS, [&contact]() { contact.press(); });
+        sim.at(i * period + period / 2 + MS, [&contact]() { contact.release(); });
+    }
+}
+
+}  // namespace
+
+TEST_GROUP(LongHorizon) {
+    Simulator sim;
+};
+
+TEST(LongHorizon, ExecutiveRunsAnHourOfOneMillisecondTicks) {
+    CyclicExecutive<4> executive;
+    CounterTask fast("fast");
+    CounterTask medium("medium");
+    CounterTask slow("slow");
+    executive.addTask(&fast, 10);
+    executive.addTask(&medium, 100);
+    executive.addTask(&slow, 1000);
+
+    sim.every(MS, [&]() {
+        executive.tick();
+        executive.run();
+    });
+    sim.runFor(HOUR);
+
+    LONGS_EQUAL(360000, fast.getCount());
+    LONGS_EQUAL(36000, medium.getCount());
+    LONGS_EQUAL(3600, slow.getCount());
+    UNSIGNED_LONGS_EQUAL(3600000UL, executive.getCurrentTimeMs());
+}
+
+TEST(LongHorizon, TicklessExecutiveRunsADayOnlyWakingForTasks) {
+    ClockScope scope(sim);
+    CyclicExecutive<4, NoCycleCounter, SimTicklessPolicy> executive;
+    CounterTask heartbeat("heartbeat");
+    CounterTask report("report");
+    executive.addTask(&heartbeat, 1000);
+    executive.addTask(&report, 60000);
+
+    uint32_t wakeups = 0;
+    while (sim.now() < 24 * HOUR) {
+        executive.run();
+        executive.sleepUntilNextDeadline();
+        wakeups++;
+    }
+    executive.run();  // The tasks due at exactly 24 h
+
+    LONGS_EQUAL(86400, heartbeat.getCount());  // t = 1 s ... 86400 s
+    LONGS_EQUAL(1440, report.getCount());
+    UNSIGNED_LONGS_EQUAL(86400, wakeups);  // One per second, not one per ms
+    UNSIGNED_LONGS_EQUAL(sim.millis(), executive.getCurrentTimeMs());
+}
+
+TEST(LongHorizon, PollingDebouncersSeeEveryPressOfABouncingButton) {
+    BouncingContact contact(sim, 5 * MS, 10, 5);
+    SimButton button(contact);
+    DelayDebouncer delay(button, 20);
+    IntegratorDebouncer integrator(button, 10);
+
+    int delayChanges = 0;
+    int integratorChanges = 0;
+    sim.every(MS, [&]() {
+        delay.update();
+        integrator.update();
+        if (delay.stateChanged()) delayChanges++;
+        if (integrator.stateChanged()) integratorChanges++;
+    });
+
+    const int presses = 1000;
+    schedulePresses(sim, contact, presses, 200 * MS);
+    sim.runFor(presses * 200 * MS);
+
+    CHECK_TRUE(contact.getEdges() > 2U * presses);  // It really bounced
+    LONGS_EQUAL(2 * presses, delayChanges);
+    LONGS_EQUAL(2 * presses, integratorChanges);
+}
+
+TEST(LongHorizon, InterruptDebouncerOnlySamplesWhileTheButtonMoves) {
+    BouncingContact contact(sim, 5 * MS, 10, 9);
+    SimButton button(contact);
+    SimOneShotTimer timer(sim);
+    InterruptDebouncer debouncer(button, timer, 10, 1);
+    timer.attach(debouncer);
+
+    contact.onEdge([&]() { debouncer.onEdge(); });
+
+    // stateChanged() only covers the last sample: watch isPressed() instead
+    int changes = 0;
+    bool last = false;
+    sim.every(MS, [&]() {
+        if (debouncer.isPressed() != last) {
+            last = debouncer.isPressed();
+            changes++;
+        }
+    }, MS / 2);
+
+    const int presses = 500;
+    schedulePresses(sim, contact, presses, 400 * MS);
+    sim.runFor(presses * 400 * MS);
+
+    LONGS_EQUAL(2 * presses, changes);
+    CHECK_TRUE(debouncer.isIdle());
+    // About 10-15 samples per press or release instead of 400 per cycle
+    CHECK_TRUE(debouncer.getSampleCount() < 20U * 2U * presses);
+}
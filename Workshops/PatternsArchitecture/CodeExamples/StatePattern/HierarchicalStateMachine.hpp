@@ -0,0 +1,298 @@
+#ifndef HIERARCHICAL_STATE_MACHINE_HPP
+#define HIERARCHICAL_STATE_MACHINE_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include "StatePattern.hpp"
+
+/**
+ * =============================================================================
+ * HIERARCHICAL STATE MACHINE (UML STATECHART) WITH EVENT QUEUE
+ * =============================================================================
+ *
+ * Problem with IHeaterState/HeaterContext:
+ *   - Every state implements a handler for every event (mostly "ignore")
+ *   - Common behaviour (e.g. TURN_OFF from any "on" state) is duplicated
+ *   - An event raised inside a transition is handled re-entrantly,
+ *     in the middle of another state's exit/entry actions
+ *
+ * Solution:
+ *   - States are const descriptors: parent, entry, exit, handler
+ *   - An event a state does not handle bubbles up to its parent
+ *   - Transitions exit up to the common ancestor and enter down to the
+ *     target, running every exit/entry action exactly once
+ *   - Events are queued and processed run-to-completion: one event is
+ *     fully handled before the next one starts
+ *
+ * State descriptors are aggregates of function pointers, so they are
+ * constant-initialized and end up in flash. No heap, no virtual calls.
+ *
+ * Samek: "Practical UML Statecharts in C/C++" (QEP-style dispatcher)
+ *
+ * =============================================================================
+ */
+
+namespace state_pattern {
+
+enum class HsmResult : uint8_t {
+    HANDLED,     // Event consumed, no transition
+    UNHANDLED,   // Let the parent state try
+    TRANSITION   // Event consumed, transition to 'target'
+};
+
+/**
+ * @brief Const state descriptor
+ *
+ * handler may be nullptr (state handles nothing itself). A handler that
+ * returns TRANSITION must set target.
+ */
+template<typename Context, typename Event>
+struct HsmState {
+    using Handler = HsmResult (*)(Context&, const Event&, const HsmState*& target);
+    using Action = void (*)(Context&);
+
+    const HsmState* parent;
+    Action onEntry;
+    Action onExit;
+    Handler handler;
+};
+
+/**
+ * @brief Run-to-completion dispatcher with a fixed-size event queue
+ *
+ * dispatch() queues the event and, unless a dispatch is already running
+ * further up the call stack, drains the queue. Events posted from entry,
+ * exit or handler code are therefore processed after the current one.
+ *
+ * @tparam QUEUE_SIZE Pending events (dropped and counted when full)
+ * @tparam MAX_DEPTH  Maximum nesting depth of the state hierarchy
+ */
+template<typename Context, typename Event, size_t QUEUE_SIZE = 8, size_t MAX_DEPTH = 8>
+class HierarchicalStateMachine {
+public:
+    using State = HsmState<Context, Event>;
+
+    HierarchicalStateMachine(Context& context, const State& initial)
+        : context_(context), initial_(&initial), current_(nullptr),
+          head_(0), count_(0), dropped_(0), busy_(false) {}
+
+    /**
+     * @brief Enter the initial state (runs entry actions root -> initial)
+     */
+    void start() {
+        busy_ = true;
+        enterFrom(nullptr, initial_);
+        current_ = initial_;
+        busy_ = false;
+        processQueue();
+    }
+
+    /**
+     * @brief Queue an event without processing it (e.g. from an ISR)
+     * @return false if the queue is full
+     */
+    bool post(const Event& event) {
+        if (count_ >= QUEUE_SIZE) {
+            dropped_++;
+            return false;
+        }
+        queue_[(head_ + count_) % QUEUE_SIZE] = event;
+        count_++;
+        return true;
+    }
+
+    /**
+     * @brief Queue an event and process everything pending
+     */
+    bool dispatch(const Event& event) {
+        const bool queued = post(event);
+        processQueue();
+        return queued;
+    }
+
+    /**
+     * @brief Process pending events (main loop side of post())
+     * @return Number of events processed
+     */
+    size_t processQueue() {
+        if (busy_ || current_ == nullptr) {
+            return 0;  // Run-to-completion: the outer call drains the queue
+        }
+        busy_ = true;
+        size_t processed = 0;
+        while (count_ > 0) {
+            const Event event = queue_[head_];
+            head_ = (head_ + 1) % QUEUE_SIZE;
+            count_--;
+            handle(event);
+            processed++;
+        }
+        busy_ = false;
+        return processed;
+    }
+
+    /**
+     * @brief True if 'state' is the current state or one of its ancestors
+     */
+    bool isIn(const State& state) const {
+        return contains(&state, current_);
+    }
+
+    const State* getCurrentState() const { return current_; }
+    size_t getPendingCount() const { return count_; }
+    uint32_t getDroppedCount() const { return dropped_; }
+
+private:
+    void handle(const Event& event) {
+        for (const State* s = current_; s != nullptr; s = s->parent) {
+            if (s->handler == nullptr) {
+                continue;
+            }
+            const State* target = nullptr;
+            const HsmResult result = s->handler(context_, event, target);
+            if (result == HsmResult::UNHANDLED) {
+                continue;
+            }
+            if (result == HsmResult::TRANSITION && target != nullptr) {
+                transitionTo(target);
+            }
+            return;
+        }
+        // Bubbled past the root: event ignored
+    }
+
+    void transitionTo(const State* target) {
+        // Exit up to the least common ancestor. A transition to the current
+        // state or one of its ancestors is external: that state exits too.
+        const State* s = current_;
+        while (s != nullptr && !(contains(s, target) && s != target)) {
+            if (s->onExit != nullptr) {
+                s->onExit(context_);
+            }
+            s = s->parent;
+        }
+        enterFrom(s, target);
+        current_ = target;
+    }
+
+    // Run entry actions from just below 'ancestor' down to 'target'
+    void enterFrom(const State* ancestor, const State* target) {
+        std::array<const State*, MAX_DEPTH> path{};
+        size_t depth = 0;
+        for (const State* s = target; s != ancestor && s != nullptr && depth < MAX_DEPTH; s = s->parent) {
+            path[depth++] = s;
+        }
+        while (depth > 0) {
+            const State* s = path[--depth];
+            if (s->onEntry != nullptr) {
+                s->onEntry(context_);
+            }
+        }
+    }
+
+    static bool contains(const State* ancestor, const State* state) {
+        for (const State* s = state; s != nullptr; s = s->parent) {
+            if (s == ancestor) return true;
+        }
+        return false;
+    }
+
+    Context& context_;
+    const State* initial_;
+    const State* current_;
+
+    std::array<Event, QUEUE_SIZE> queue_;
+    size_t head_;
+    size_t count_;
+    uint32_t dropped_;
+    bool busy_;
+};
+
+// ============================================================================
+// Example: Heater as a statechart
+// ============================================================================
+
+/**
+ * @brief Heater controller with an ON superstate
+ *
+ *   +-----+  TURN_ON   +------------------------------------+
+ *   | OFF | ---------> | ON                                 |
+ *   +-----+ <--------- |  +---------+ TEMP_OK  +---------+  |
+ *          TURN_OFF    |  | HEATING | -------> | TARGET  |  |
+ *                      |  +---------+ <------- +---------+  |
+ *                      |              TEMP_LOW              |
+ *                      +------------------------------------+
+ *
+ * TURN_OFF is handled once, by ON; HEATING and TARGET_REACHED only
+ * handle the temperature events. Entry/exit of HEATING switch the
+ * heater element, so every path out of HEATING turns it off.
+ */
+class HeaterStatechart {
+public:
+    using State = HsmState<HeaterStatechart, HeaterEvent>;
+
+    HeaterStatechart() : machine_(*this, OFF), heaterOn_(false) {
+        machine_.start();
+    }
+
+    void handleEvent(HeaterEvent event) { machine_.dispatch(event); }
+
+    HeaterState getState() const {
+        if (machine_.getCurrentState() == &HEATING) return HeaterState::HEATING;
+        if (machine_.getCurrentState() == &TARGET_REACHED) return HeaterState::TARGET_REACHED;
+        return HeaterState::OFF;
+    }
+
+    bool isOn() const { return machine_.isIn(ON); }
+    bool isHeaterOn() const { return heaterOn_; }
+
+private:
+    static HsmResult offHandler(HeaterStatechart&, const HeaterEvent& e, const State*& target) {
+        if (e == HeaterEvent::TURN_ON) {
+            target = &HEATING;
+            return HsmResult::TRANSITION;
+        }
+        return HsmResult::UNHANDLED;
+    }
+
+    static HsmResult onHandler(HeaterStatechart&, const HeaterEvent& e, const State*& target) {
+        if (e == HeaterEvent::TURN_OFF) {
+            target = &OFF;
+            return HsmResult::TRANSITION;
+        }
+        return HsmResult::HANDLED;  // Absorb TURN_ON and stray events while on
+    }
+
+    static HsmResult heatingHandler(HeaterStatechart&, const HeaterEvent& e, const State*& target) {
+        if (e == HeaterEvent::TEMP_OK) {
+            target = &TARGET_REACHED;
+            return HsmResult::TRANSITION;
+        }
+        return HsmResult::UNHANDLED;
+    }
+
+    static HsmResult targetHandler(HeaterStatechart&, const HeaterEvent& e, const State*& target) {
+        if (e == HeaterEvent::TEMP_LOW) {
+            target = &HEATING;
+            return HsmResult::TRANSITION;
+        }
+        return HsmResult::UNHANDLED;
+    }
+
+    static void heaterOn(HeaterStatechart& h) { h.heaterOn_ = true; }
+    static void heaterOff(HeaterStatechart& h) { h.heaterOn_ = false; }
+
+    // State descriptors (constexpr, placed in flash)
+    static constexpr State OFF{nullptr, nullptr, nullptr, &offHandler};
+    static constexpr State ON{nullptr, nullptr, nullptr, &onHandler};
+    static constexpr State HEATING{&ON, &heaterOn, &heaterOff, &heatingHandler};
+    static constexpr State TARGET_REACHED{&ON, nullptr, nullptr, &targetHandler};
+
+    HierarchicalStateMachine<HeaterStatechart, HeaterEvent, 4> machine_;
+    bool heaterOn_;
+};
+
+}  // namespace state_pattern
+
+#endif  // HIERARCHICAL_STATE_MACHINE_HPP
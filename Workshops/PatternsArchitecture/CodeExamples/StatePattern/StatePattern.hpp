@@ -2,7 +2,9 @@
 #define STATE_PATTERN_HPP
 
 #include <cstdint>
-#include <functional>
+#include <cstddef>
+
+#include "../FixedContainers/FixedContainers.hpp"
 
 /**
  * =============================================================================
@@ -15,6 +17,8 @@
  * 2. STATE TABLE (table-driven, compact, good for simple FSMs)
  * 3. STATE PATTERN (OO approach, extensible, testable)
  *
+ * plus an event coalescer that can sit in front of any of them.
+ *
  * Example: A simple heater controller
  *   States: OFF, HEATING, TARGET_REACHED
  *   Events: TURN_ON, TURN_OFF, TEMP_LOW, TEMP_OK
@@ -126,6 +130,75 @@ private:
 // APPROACH 2: State Table (table-driven)
 // ============================================================================
 
+/**
+ * @brief Dense [state][event] transition matrix, built at compile time
+ *
+ * The transition list is written the readable way (one row per
+ * transition) and build() expands it into a full NUM_STATES x NUM_EVENTS
+ * matrix in a constexpr context. Dispatch is one index operation, the
+ * table is const data (flash on Cortex-M/AVR) and actions are plain
+ * function pointers - no std::function, no heap, no linear scan.
+ *
+ * States and events must be enums numbered 0..N-1.
+ */
+template<typename Context, typename State, typename Event,
+         size_t NUM_STATES, size_t NUM_EVENTS>
+class TransitionMatrix {
+public:
+    using Action = void (*)(Context&);
+
+    struct Transition {
+        State currentState;
+        Event event;
+        State nextState;
+        Action action;
+    };
+
+    template<size_t N>
+    static constexpr TransitionMatrix build(const Transition (&transitions)[N]) {
+        TransitionMatrix matrix{};
+        for (size_t i = 0; i < N; ++i) {
+            Cell& cell = matrix.cells_[index(transitions[i].currentState)][index(transitions[i].event)];
+            cell.valid = true;
+            cell.nextState = transitions[i].nextState;
+            cell.action = transitions[i].action;
+        }
+        return matrix;
+    }
+
+    /**
+     * @brief Run the transition for (state, event), if any
+     * @return false if the event is ignored in this state
+     */
+    bool dispatch(Context& context, State& state, Event event) const {
+        const Cell& cell = cells_[index(state)][index(event)];
+        if (!cell.valid) {
+            return false;
+        }
+        if (cell.action != nullptr) {
+            cell.action(context);
+        }
+        state = cell.nextState;
+        return true;
+    }
+
+    constexpr bool handles(State state, Event event) const {
+        return cells_[index(state)][index(event)].valid;
+    }
+
+private:
+    struct Cell {
+        bool valid;
+        State nextState;
+        Action action;
+    };
+
+    template<typename E>
+    static constexpr size_t index(E value) { return static_cast<size_t>(value); }
+
+    Cell cells_[NUM_STATES][NUM_EVENTS];
+};
+
 /**
  * @brief Heater controller using state table
  *
@@ -133,9 +206,10 @@ private:
  * - Compact representation
  * - Easy to visualize as a table
  * - Good for code generation from UML
+ * - O(1) dispatch, table lives in flash
  *
  * Disadvantages:
- * - Actions are harder to express (need function pointers or lambdas)
+ * - Actions are harder to express (need function pointers)
  * - Less flexible for complex entry/exit actions
  */
 class HeaterStateTable {
@@ -143,47 +217,44 @@ public:
     HeaterStateTable() : state_(HeaterState::OFF), heaterOn_(false) {}
 
     void handleEvent(HeaterEvent event) {
-        // Find transition in table
-        for (const auto& transition : transitions_) {
-            if (transition.currentState == state_ && transition.event == event) {
-                // Execute action
-                if (transition.action) {
-                    transition.action(*this);
-                }
-                // Transition to new state
-                state_ = transition.nextState;
-                return;
-            }
-        }
         // No transition found - event ignored in this state
+        table_.dispatch(*this, state_, event);
     }
 
     HeaterState getState() const { return state_; }
     bool isHeaterOn() const { return heaterOn_; }
 
+    /** @brief false if the event is ignored in that state (same for all three machines) */
+    static constexpr bool handles(HeaterState state, HeaterEvent event) {
+        return table_.handles(state, event);
+    }
+
     // Actions (called by table)
     void turnHeaterOn() { heaterOn_ = true; }
     void turnHeaterOff() { heaterOn_ = false; }
 
 private:
-    struct Transition {
-        HeaterState currentState;
-        HeaterEvent event;
-        HeaterState nextState;
-        std::function<void(HeaterStateTable&)> action;
-    };
+    static constexpr size_t NUM_STATES = 3;
+    static constexpr size_t NUM_EVENTS = 4;
+
+    using Table = TransitionMatrix<HeaterStateTable, HeaterState, HeaterEvent,
+                                   NUM_STATES, NUM_EVENTS>;
+
+    static void heaterOn(HeaterStateTable& h) { h.turnHeaterOn(); }
+    static void heaterOff(HeaterStateTable& h) { h.turnHeaterOff(); }
 
     // The state table - defines all valid transitions
-    static constexpr size_t NUM_TRANSITIONS = 5;
-    const Transition transitions_[NUM_TRANSITIONS] = {
-        // Current State         Event                Next State              Action
-        { HeaterState::OFF,      HeaterEvent::TURN_ON, HeaterState::HEATING,        [](HeaterStateTable& h){ h.turnHeaterOn(); } },
-        { HeaterState::HEATING,  HeaterEvent::TURN_OFF, HeaterState::OFF,           [](HeaterStateTable& h){ h.turnHeaterOff(); } },
-        { HeaterState::HEATING,  HeaterEvent::TEMP_OK, HeaterState::TARGET_REACHED, [](HeaterStateTable& h){ h.turnHeaterOff(); } },
-        { HeaterState::TARGET_REACHED, HeaterEvent::TURN_OFF, HeaterState::OFF,     nullptr },
-        { HeaterState::TARGET_REACHED, HeaterEvent::TEMP_LOW, HeaterState::HEATING, [](HeaterStateTable& h){ h.turnHeaterOn(); } },
+    static constexpr Table::Transition transitions_[] = {
+        // Current State               Event                  Next State                   Action
+        { HeaterState::OFF,            HeaterEvent::TURN_ON,  HeaterState::HEATING,        &heaterOn  },
+        { HeaterState::HEATING,        HeaterEvent::TURN_OFF, HeaterState::OFF,            &heaterOff },
+        { HeaterState::HEATING,        HeaterEvent::TEMP_OK,  HeaterState::TARGET_REACHED, &heaterOff },
+        { HeaterState::TARGET_REACHED, HeaterEvent::TURN_OFF, HeaterState::OFF,            nullptr    },
+        { HeaterState::TARGET_REACHED, HeaterEvent::TEMP_LOW, HeaterState::HEATING,        &heaterOn  },
     };
 
+    static constexpr Table table_ = Table::build(transitions_);
+
     HeaterState state_;
     bool heaterOn_;
 };
@@ -356,6 +427,161 @@ inline void TargetReachedState::handleTempLow(HeaterContext& context) {
     context.transitionTo(&HeatingState::getInstance());
 }
 
+// ============================================================================
+// Event Coalescing (in front of any of the three)
+// ============================================================================
+
+/**
+ * @brief Thins out the heater events before they reach the state machine
+ *
+ * A noisy sensor near the setpoint produces long alternating streams of
+ * TEMP_LOW / TEMP_OK. Fed directly, every one of them runs onExit /
+ * onEnter and switches the heater. The coalescer takes the events with
+ * post() and hands them on once per dispatch cycle (dispatch()):
+ *
+ * - A repeat of the last queued event is collapsed in post(), and an
+ *   event the current state ignores (HeaterStateTable::handles()) never
+ *   reaches the machine
+ * - A temperature event that would leave a state before its minimum
+ *   dwell time is held; a newer temperature event replaces it. A LOW/OK
+ *   burst shorter than the dwell time switches nothing at all
+ * - With the mailbox, only the last temperature event of a cycle is
+ *   kept (last-event-wins); without it they are delivered in order
+ *
+ * TURN_ON / TURN_OFF are commands: queued in order and never held, so
+ * switching off is never delayed by a dwell time.
+ *
+ * Works with HeaterSwitchCase, HeaterStateTable and HeaterContext.
+ */
+template<typename Machine = HeaterContext, size_t QUEUE_SIZE = 8>
+class HeaterEventCoalescer {
+public:
+    explicit HeaterEventCoalescer(Machine& machine)
+        : machine_(machine), dwellMs_{}, mailbox_(HeaterEvent::TEMP_OK), held_(HeaterEvent::TEMP_OK),
+          state_(machine.getState()), enteredMs_(0), delivered_(0), coalesced_(0), dropped_(0),
+          useMailbox_(false), mailboxFull_(false), holding_(false) {}
+
+    /** @brief Temperature events may leave state only after it was active this long */
+    void setMinDwellMs(HeaterState state, uint32_t dwellMs) {
+        dwellMs_[static_cast<size_t>(state)] = dwellMs;
+    }
+
+    /** @brief true: keep only the last temperature event per dispatch cycle */
+    void setMailbox(bool lastEventWins) { useMailbox_ = lastEventWins; }
+
+    /**
+     * @brief Take an event; nothing reaches the machine before dispatch()
+     * @return false if the queue was full and the event was dropped
+     */
+    bool post(HeaterEvent event) {
+        if (useMailbox_ && isTemperature(event)) {
+            if (mailboxFull_) coalesced_++;
+            mailbox_ = event;
+            mailboxFull_ = true;
+            return true;
+        }
+        if (!queue_.isEmpty() && queue_.back() == event) {
+            coalesced_++;
+            return true;
+        }
+        if (!queue_.push(event)) {
+            dropped_++;
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief One dispatch cycle: the queued events in order, then the
+     *        mailbox, then a held event whose state has dwelled long enough
+     * @return Events delivered to the machine
+     */
+    size_t dispatch(uint32_t nowMs) {
+        size_t delivered = 0;
+        if (machine_.getState() != state_) {  // Changed outside the coalescer
+            state_ = machine_.getState();
+            enteredMs_ = nowMs;
+        }
+
+        HeaterEvent event;
+        while (queue_.pop(event)) {
+            if (isTemperature(event)) {
+                hold(event);
+                delivered += releaseHeld(nowMs);
+            } else {
+                delivered += deliver(event, nowMs);
+            }
+        }
+        if (mailboxFull_) {
+            mailboxFull_ = false;
+            hold(mailbox_);
+        }
+        delivered += releaseHeld(nowMs);
+        return delivered;
+    }
+
+    /** @brief A temperature event waits for its state's dwell time */
+    bool hasHeldEvent() const { return holding_; }
+
+    uint32_t getDeliveredCount() const { return delivered_; }
+    uint32_t getCoalescedCount() const { return coalesced_; }  // Collapsed, replaced or ignored
+    uint32_t getDroppedCount() const { return dropped_; }      // Queue full
+
+private:
+    static constexpr size_t NUM_STATES = 3;
+
+    static constexpr bool isTemperature(HeaterEvent event) {
+        return event == HeaterEvent::TEMP_LOW || event == HeaterEvent::TEMP_OK;
+    }
+
+    void hold(HeaterEvent event) {
+        if (holding_) coalesced_++;
+        held_ = event;
+        holding_ = true;
+    }
+
+    size_t releaseHeld(uint32_t nowMs) {
+        if (!holding_) return 0;
+        if (!HeaterStateTable::handles(state_, held_)) {
+            holding_ = false;
+            coalesced_++;
+            return 0;
+        }
+        if (nowMs - enteredMs_ < dwellMs_[static_cast<size_t>(state_)]) return 0;
+        holding_ = false;
+        return deliver(held_, nowMs);
+    }
+
+    size_t deliver(HeaterEvent event, uint32_t nowMs) {
+        if (!HeaterStateTable::handles(state_, event)) {
+            coalesced_++;
+            return 0;
+        }
+        machine_.handleEvent(event);
+        delivered_++;
+        const HeaterState state = machine_.getState();
+        if (state != state_) {
+            state_ = state;
+            enteredMs_ = nowMs;
+        }
+        return 1;
+    }
+
+    Machine& machine_;
+    fixed_containers::RingBuffer<HeaterEvent, QUEUE_SIZE> queue_;
+    uint32_t dwellMs_[NUM_STATES];
+    HeaterEvent mailbox_;
+    HeaterEvent held_;
+    HeaterState state_;
+    uint32_t enteredMs_;
+    uint32_t delivered_;
+    uint32_t coalesced_;
+    uint32_t dropped_;
+    bool useMailbox_;
+    bool mailboxFull_;
+    bool holding_;
+};
+
 }  // namespace state_pattern
 
 #endif  // STATE_PATTERN_HPP
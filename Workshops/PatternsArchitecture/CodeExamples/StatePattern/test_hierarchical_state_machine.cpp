@@ -0,0 +1,174 @@
+#include "CppUTest/TestHarness.h"
+#include "HierarchicalStateMachine.hpp"
+
+#include <cstring>
+
+using namespace state_pattern;
+
+// ============================================================================
+// Tests for the Heater Statechart
+// ============================================================================
+
+TEST_GROUP(HeaterStatechart) {
+    HeaterStatechart heater;
+};
+
+TEST(HeaterStatechart, StartsInOffState) {
+    CHECK_EQUAL(HeaterState::OFF, heater.getState());
+    CHECK_FALSE(heater.isOn());
+    CHECK_FALSE(heater.isHeaterOn());
+}
+
+TEST(HeaterStatechart, TurnOnEntersHeatingInsideOn) {
+    heater.handleEvent(HeaterEvent::TURN_ON);
+    CHECK_EQUAL(HeaterState::HEATING, heater.getState());
+    CHECK_TRUE(heater.isOn());
+    CHECK_TRUE(heater.isHeaterOn());
+}
+
+TEST(HeaterStatechart, TurnOffFromSubstateIsHandledByParent) {
+    heater.handleEvent(HeaterEvent::TURN_ON);
+    heater.handleEvent(HeaterEvent::TEMP_OK);
+    heater.handleEvent(HeaterEvent::TURN_OFF);
+    CHECK_EQUAL(HeaterState::OFF, heater.getState());
+    CHECK_FALSE(heater.isHeaterOn());
+}
+
+TEST(HeaterStatechart, HeatingExitSwitchesElementOff) {
+    heater.handleEvent(HeaterEvent::TURN_ON);
+    heater.handleEvent(HeaterEvent::TURN_OFF);
+    CHECK_FALSE(heater.isHeaterOn());
+}
+
+TEST(HeaterStatechart, MatchesStateTable) {
+    HeaterStateTable table;
+    const HeaterEvent events[] = {
+        HeaterEvent::TEMP_OK, HeaterEvent::TURN_ON, HeaterEvent::TEMP_LOW,
+        HeaterEvent::TEMP_OK, HeaterEvent::TURN_ON, HeaterEvent::TEMP_LOW,
+        HeaterEvent::TURN_OFF, HeaterEvent::TURN_OFF
+    };
+
+    for (HeaterEvent e : events) {
+        heater.handleEvent(e);
+        table.handleEvent(e);
+        CHECK_EQUAL(table.getState(), heater.getState());
+        CHECK_EQUAL(table.isHeaterOn(), heater.isHeaterOn());
+    }
+}
+
+// ============================================================================
+// Tests for the Engine (entry/exit order, run-to-completion)
+// ============================================================================
+
+namespace {
+
+enum class Sig { GO, BACK, SELF, ECHO };
+
+struct Recorder;
+using TestMachine = HierarchicalStateMachine<Recorder, Sig, 2>;
+using TestState = TestMachine::State;
+
+struct Recorder {
+    char log[64] = {};
+    TestMachine* machine = nullptr;
+
+    void add(const char* s) { std::strncat(log, s, sizeof(log) - std::strlen(log) - 1); }
+};
+
+// Hierarchy:  A { A1 }   B { B1 }
+extern const TestState A, A1, B, B1;
+
+HsmResult aHandler(Recorder& r, const Sig& sig, const TestState*& target) {
+    if (sig == Sig::GO) { target = &B1; return HsmResult::TRANSITION; }
+    if (sig == Sig::ECHO) {
+        r.add("e");
+        r.machine->dispatch(Sig::GO);  // Raised mid-handling: queued
+        r.add("E");
+        return HsmResult::HANDLED;
+    }
+    return HsmResult::UNHANDLED;
+}
+
+HsmResult a1Handler(Recorder&, const Sig& sig, const TestState*& target) {
+    if (sig == Sig::SELF) { target = &A1; return HsmResult::TRANSITION; }
+    return HsmResult::UNHANDLED;
+}
+
+HsmResult bHandler(Recorder&, const Sig& sig, const TestState*& target) {
+    if (sig == Sig::BACK) { target = &A1; return HsmResult::TRANSITION; }
+    return HsmResult::UNHANDLED;
+}
+
+const TestState A{nullptr, [](Recorder& r) { r.add("+A"); }, [](Recorder& r) { r.add("-A"); }, &aHandler};
+const TestState A1{&A, [](Recorder& r) { r.add("+A1"); }, [](Recorder& r) { r.add("-A1"); }, &a1Handler};
+const TestState B{nullptr, [](Recorder& r) { r.add("+B"); }, [](Recorder& r) { r.add("-B"); }, &bHandler};
+const TestState B1{&B, [](Recorder& r) { r.add("+B1"); }, [](Recorder& r) { r.add("-B1"); }, nullptr};
+
+}  // namespace
+
+TEST_GROUP(HierarchicalStateMachine) {
+    Recorder recorder;
+    TestMachine* machine;
+
+    void setup() {
+        machine = new TestMachine(recorder, A1);
+        recorder.machine = machine;
+        machine->start();
+    }
+
+    void teardown() {
+        delete machine;
+    }
+
+    void clearLog() { recorder.log[0] = '\0'; }
+};
+
+TEST(HierarchicalStateMachine, StartEntersOutermostFirst) {
+    STRCMP_EQUAL("+A+A1", recorder.log);
+    CHECK_TRUE(machine->isIn(A));
+    CHECK_TRUE(machine->isIn(A1));
+    CHECK_FALSE(machine->isIn(B));
+}
+
+TEST(HierarchicalStateMachine, TransitionExitsAndEntersViaCommonAncestor) {
+    clearLog();
+    machine->dispatch(Sig::GO);  // Handled by parent A
+    STRCMP_EQUAL("-A1-A+B+B1", recorder.log);
+    POINTERS_EQUAL(&B1, machine->getCurrentState());
+}
+
+TEST(HierarchicalStateMachine, SelfTransitionExitsAndReenters) {
+    clearLog();
+    machine->dispatch(Sig::SELF);
+    STRCMP_EQUAL("-A1+A1", recorder.log);
+}
+
+TEST(HierarchicalStateMachine, UnhandledEventIsIgnored) {
+    clearLog();
+    machine->dispatch(Sig::BACK);  // Only B handles BACK
+    STRCMP_EQUAL("", recorder.log);
+    POINTERS_EQUAL(&A1, machine->getCurrentState());
+}
+
+TEST(HierarchicalStateMachine, EventRaisedDuringHandlingRunsToCompletion) {
+    clearLog();
+    machine->dispatch(Sig::ECHO);
+    // GO is processed only after the ECHO handler has returned
+    STRCMP_EQUAL("eE-A1-A+B+B1", recorder.log);
+}
+
+TEST(HierarchicalStateMachine, PostQueuesUntilProcessed) {
+    machine->post(Sig::GO);
+    LONGS_EQUAL(1, machine->getPendingCount());
+    POINTERS_EQUAL(&A1, machine->getCurrentState());
+
+    LONGS_EQUAL(1, machine->processQueue());
+    POINTERS_EQUAL(&B1, machine->getCurrentState());
+}
+
+TEST(HierarchicalStateMachine, FullQueueDropsEvents) {
+    CHECK_TRUE(machine->post(Sig::GO));
+    CHECK_TRUE(machine->post(Sig::BACK));
+    CHECK_FALSE(machine->post(Sig::GO));
+    LONGS_EQUAL(1, machine->getDroppedCount());
+}
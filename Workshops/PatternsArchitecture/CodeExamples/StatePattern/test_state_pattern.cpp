@@ -69,6 +69,67 @@ TEST(HeaterStateTable, FullCycleWorks) {
     CHECK_EQUAL(HeaterState::OFF, heater->getState());
 }
 
+TEST(HeaterStateTable, IgnoresUnlistedEvents) {
+    heater->handleEvent(HeaterEvent::TEMP_OK);  // Not in table for OFF
+    CHECK_EQUAL(HeaterState::OFF, heater->getState());
+    CHECK_FALSE(heater->isHeaterOn());
+}
+
+// ============================================================================
+// Tests for TransitionMatrix Engine
+// ============================================================================
+
+namespace {
+
+enum class DoorState { CLOSED, OPEN, LOCKED };
+enum class DoorEvent { PUSH, PULL, KEY };
+
+struct Door {
+    int actions = 0;
+};
+
+void countAction(Door& d) { d.actions++; }
+
+using DoorTable = TransitionMatrix<Door, DoorState, DoorEvent, 3, 3>;
+
+constexpr DoorTable::Transition doorTransitions[] = {
+    { DoorState::CLOSED, DoorEvent::PULL, DoorState::OPEN,   &countAction },
+    { DoorState::OPEN,   DoorEvent::PUSH, DoorState::CLOSED, nullptr },
+    { DoorState::CLOSED, DoorEvent::KEY,  DoorState::LOCKED, &countAction },
+    { DoorState::LOCKED, DoorEvent::KEY,  DoorState::CLOSED, &countAction },
+};
+
+constexpr DoorTable doorTable = DoorTable::build(doorTransitions);
+
+static_assert(doorTable.handles(DoorState::CLOSED, DoorEvent::PULL), "built at compile time");
+static_assert(!doorTable.handles(DoorState::LOCKED, DoorEvent::PULL), "unlisted cells are empty");
+
+}  // namespace
+
+TEST_GROUP(TransitionMatrix) {
+    Door door;
+    DoorState state = DoorState::CLOSED;
+};
+
+TEST(TransitionMatrix, DispatchRunsActionAndTransitions) {
+    CHECK_TRUE(doorTable.dispatch(door, state, DoorEvent::PULL));
+    CHECK_TRUE(DoorState::OPEN == state);
+    LONGS_EQUAL(1, door.actions);
+}
+
+TEST(TransitionMatrix, NullActionOnlyTransitions) {
+    doorTable.dispatch(door, state, DoorEvent::PULL);
+    CHECK_TRUE(doorTable.dispatch(door, state, DoorEvent::PUSH));
+    CHECK_TRUE(DoorState::CLOSED == state);
+    LONGS_EQUAL(1, door.actions);
+}
+
+TEST(TransitionMatrix, UnhandledEventLeavesState) {
+    doorTable.dispatch(door, state, DoorEvent::KEY);
+    CHECK_FALSE(doorTable.dispatch(door, state, DoorEvent::PULL));
+    CHECK_TRUE(DoorState::LOCKED == state);
+}
+
 // ============================================================================
 // Tests for State Pattern Implementation
 // ============================================================================
@@ -156,6 +217,195 @@ TEST(AllImplementationsMatch, SameResultsForFullCycle) {
     CHECK_EQUAL(HeaterState::OFF, statePattern->getState());
 }
 
+// ============================================================================
+// Event Coalescing Tests
+// ============================================================================
+
+namespace {
+
+// HeaterContext that counts what reaches it
+struct CountingHeater {
+    HeaterContext heater;
+    int events = 0;
+    int switches = 0;
+
+    void handleEvent(HeaterEvent event) {
+        const bool wasOn = heater.isHeaterOn();
+        heater.handleEvent(event);
+        events++;
+        if (heater.isHeaterOn() != wasOn) switches++;
+    }
+    HeaterState getState() const { return heater.getState(); }
+};
+
+}  // namespace
+
+TEST_GROUP(HeaterEventCoalescer) {
+    CountingHeater machine;
+    HeaterEventCoalescer<CountingHeater>* coalescer;
+
+    void setup() override {
+        coalescer = new HeaterEventCoalescer<CountingHeater>(machine);
+        coalescer->post(HeaterEvent::TURN_ON);
+        coalescer->dispatch(0);
+    }
+
+    void teardown() override {
+        delete coalescer;
+    }
+};
+
+TEST(HeaterEventCoalescer, NothingDeliveredBeforeDispatch) {
+    coalescer->post(HeaterEvent::TEMP_OK);
+
+    CHECK_EQUAL(HeaterState::HEATING, machine.getState());
+    CHECK_EQUAL(1u, coalescer->dispatch(10));
+    CHECK_EQUAL(HeaterState::TARGET_REACHED, machine.getState());
+}
+
+TEST(HeaterEventCoalescer, WithoutDwellEventsDeliveredInOrder) {
+    coalescer->post(HeaterEvent::TEMP_OK);
+    coalescer->post(HeaterEvent::TEMP_LOW);
+    coalescer->post(HeaterEvent::TEMP_OK);
+
+    CHECK_EQUAL(3u, coalescer->dispatch(10));
+    CHECK_EQUAL(HeaterState::TARGET_REACHED, machine.getState());
+    CHECK_EQUAL(4, machine.switches);
+}
+
+TEST(HeaterEventCoalescer, RepeatsCollapsed) {
+    coalescer->post(HeaterEvent::TEMP_OK);
+    coalescer->post(HeaterEvent::TEMP_OK);
+    coalescer->post(HeaterEvent::TEMP_OK);
+
+    CHECK_EQUAL(1u, coalescer->dispatch(10));
+    CHECK_EQUAL(2u, coalescer->getCoalescedCount());
+}
+
+TEST(HeaterEventCoalescer, IgnoredEventsNeverReachMachine) {
+    coalescer->post(HeaterEvent::TEMP_LOW);  // Already heating
+    coalescer->dispatch(10);
+    coalescer->post(HeaterEvent::TURN_ON);   // Already on
+    coalescer->dispatch(20);
+
+    CHECK_EQUAL(1, machine.events);          // Only the TURN_ON of setup
+    CHECK_EQUAL(2u, coalescer->getCoalescedCount());
+}
+
+TEST(HeaterEventCoalescer, StormWithinDwellSwitchesNothing) {
+    coalescer->setMinDwellMs(HeaterState::HEATING, 1000);
+
+    for (uint32_t t = 10; t < 1000; t += 10) {
+        coalescer->post((t / 10) % 2 ? HeaterEvent::TEMP_OK : HeaterEvent::TEMP_LOW);
+        coalescer->dispatch(t);
+    }
+
+    CHECK_EQUAL(HeaterState::HEATING, machine.getState());
+    CHECK_EQUAL(1, machine.switches);
+    CHECK_EQUAL(1u, coalescer->getDeliveredCount());
+}
+
+TEST(HeaterEventCoalescer, HeldEventDeliveredAfterDwell) {
+    coalescer->setMinDwellMs(HeaterState::HEATING, 1000);
+
+    coalescer->post(HeaterEvent::TEMP_OK);
+    CHECK_EQUAL(0u, coalescer->dispatch(100));
+    CHECK_TRUE(coalescer->hasHeldEvent());
+
+    CHECK_EQUAL(0u, coalescer->dispatch(999));
+    CHECK_EQUAL(1u, coalescer->dispatch(1000));
+    CHECK_EQUAL(HeaterState::TARGET_REACHED, machine.getState());
+    CHECK_FALSE(coalescer->hasHeldEvent());
+}
+
+TEST(HeaterEventCoalescer, NewerEventCancelsHeld) {
+    coalescer->setMinDwellMs(HeaterState::HEATING, 1000);
+
+    coalescer->post(HeaterEvent::TEMP_OK);
+    coalescer->dispatch(100);
+    coalescer->post(HeaterEvent::TEMP_LOW);  // Back below: nothing to do
+    coalescer->dispatch(200);
+
+    CHECK_FALSE(coalescer->hasHeldEvent());
+    coalescer->dispatch(2000);
+    CHECK_EQUAL(HeaterState::HEATING, machine.getState());
+    CHECK_EQUAL(1, machine.events);
+}
+
+TEST(HeaterEventCoalescer, DwellCountsFromStateEntry) {
+    coalescer->setMinDwellMs(HeaterState::TARGET_REACHED, 500);
+
+    coalescer->post(HeaterEvent::TEMP_OK);
+    coalescer->dispatch(100);                // Entered at 100
+    coalescer->post(HeaterEvent::TEMP_LOW);
+    coalescer->dispatch(599);
+    CHECK_EQUAL(HeaterState::TARGET_REACHED, machine.getState());
+
+    coalescer->dispatch(600);
+    CHECK_EQUAL(HeaterState::HEATING, machine.getState());
+}
+
+TEST(HeaterEventCoalescer, CommandsBypassDwell) {
+    coalescer->setMinDwellMs(HeaterState::HEATING, 1000);
+
+    coalescer->post(HeaterEvent::TEMP_OK);
+    coalescer->dispatch(100);
+    coalescer->post(HeaterEvent::TURN_OFF);
+    CHECK_EQUAL(1u, coalescer->dispatch(200));
+
+    CHECK_EQUAL(HeaterState::OFF, machine.getState());
+    CHECK_FALSE(machine.heater.isHeaterOn());
+    CHECK_FALSE(coalescer->hasHeldEvent());  // TEMP_OK means nothing when off
+}
+
+TEST(HeaterEventCoalescer, MailboxKeepsLastTemperatureEvent) {
+    coalescer->setMailbox(true);
+
+    coalescer->post(HeaterEvent::TEMP_OK);
+    coalescer->post(HeaterEvent::TEMP_LOW);
+    coalescer->post(HeaterEvent::TEMP_OK);
+
+    CHECK_EQUAL(1u, coalescer->dispatch(10));
+    CHECK_EQUAL(HeaterState::TARGET_REACHED, machine.getState());
+    CHECK_EQUAL(2u, coalescer->getCoalescedCount());
+}
+
+TEST(HeaterEventCoalescer, MailboxAfterCommands) {
+    coalescer->setMailbox(true);
+
+    coalescer->post(HeaterEvent::TEMP_OK);
+    coalescer->post(HeaterEvent::TURN_OFF);
+    coalescer->post(HeaterEvent::TURN_ON);
+
+    CHECK_EQUAL(3u, coalescer->dispatch(10));
+    CHECK_EQUAL(HeaterState::TARGET_REACHED, machine.getState());
+}
+
+TEST(HeaterEventCoalescer, FullQueueDrops) {
+    CountingHeater other;
+    HeaterEventCoalescer<CountingHeater, 2> small(other);
+
+    CHECK_TRUE(small.post(HeaterEvent::TURN_ON));
+    CHECK_TRUE(small.post(HeaterEvent::TURN_OFF));
+    CHECK_FALSE(small.post(HeaterEvent::TURN_ON));
+    CHECK_EQUAL(1u, small.getDroppedCount());
+}
+
+TEST(HeaterEventCoalescer, WorksWithStateTable) {
+    HeaterStateTable table;
+    HeaterEventCoalescer<HeaterStateTable> tableCoalescer(table);
+    tableCoalescer.setMinDwellMs(HeaterState::HEATING, 1000);
+
+    tableCoalescer.post(HeaterEvent::TURN_ON);
+    tableCoalescer.dispatch(0);
+    tableCoalescer.post(HeaterEvent::TEMP_OK);
+    tableCoalescer.dispatch(500);
+    CHECK_EQUAL(HeaterState::HEATING, table.getState());
+
+    tableCoalescer.dispatch(1000);
+    CHECK_EQUAL(HeaterState::TARGET_REACHED, table.getState());
+}
+
 // ============================================================================
 // Workshop Discussion
 // ============================================================================
@@ -0,0 +1,411 @@
+#ifndef STRESS_SWEEP_HPP
+#define STRESS_SWEEP_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * =============================================================================
+ * PARALLEL STRESS SWEEP (property-based tuning runs on all cores)
+ * =============================================================================
+ *
+ * Problem:
+ *   One simulated scenario (Simulation.hpp) proves little: the worst case
+ *   of a controller or debouncer hides in an unlucky noise sequence or
+ *   bounce pattern. Sweeping every configuration against thousands of
+ *   random scenarios is millions of runs, hours on one core.
+ *
+ * Solution:
+ *   Every run is independent: its own Simulator, models and code under
+ *   test, seeded from (configuration, scenario number) only. The runs go
+ *   to a thread pool with work stealing: each worker has its own deque,
+ *   takes jobs from the back (cache-warm, no contention) and, when idle,
+ *   steals from the front of another worker's deque. Long and short runs
+ *   then balance out without a central queue everyone fights over.
+ *
+ *   Every job folds its runs into a local Summary; the summaries are
+ *   merged in job order after the pool is done, so the report (worst
+ *   overshoot, most switching cycles, longest latency, and the seed that
+ *   caused each) is the same for 1 thread or 64. A worst case can be
+ *   replayed alone with run(config, seed).
+ *
+ * Usage:
+ *   struct Config { float hysteresis; };
+ *   std::vector<Config> grid = ...;
+ *
+ *   Sweep<Config> sweep(grid, 10000);
+ *   SweepResult result = sweep.run(pool, [](const Config& c, uint64_t seed) {
+ *       RunMetrics m;
+ *       ... build a Simulator, run the scenario, fill m ...
+ *       return m;
+ *   });
+ *
+ * =============================================================================
+ */
+
+namespace stress_sweep {
+
+// ============================================================================
+// Work-stealing thread pool
+// ============================================================================
+
+/**
+ * @brief Fixed set of workers, one job deque per worker
+ *
+ * submit() from outside the pool spreads jobs round robin; submit() from
+ * inside a job pushes onto the own deque (depth first, like fork-join).
+ * A job that throws does not stop the others; wait() rethrows the first
+ * exception.
+ */
+class WorkStealingPool {
+public:
+    using Job = std::function<void()>;
+
+    explicit WorkStealingPool(size_t threads = defaultThreadCount())
+        : queues_(threads == 0 ? 1 : threads)
+    {
+        workers_.reserve(queues_.size());
+        for (size_t i = 0; i < queues_.size(); ++i) {
+            workers_.emplace_back([this, i]() { workerLoop(i); });
+        }
+    }
+
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    static size_t defaultThreadCount() {
+        const unsigned cores = std::thread::hardware_concurrency();
+        return cores == 0 ? 1 : cores;
+    }
+
+    void submit(Job job) {
+        unfinished_.fetch_add(1, std::memory_order_relaxed);
+        const Worker& self = currentWorker();
+        const size_t target = self.pool == this
+            ? self.index
+            : nextQueue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+        {
+            std::lock_guard<std::mutex> lock(queues_[target].mutex);
+            queues_[target].jobs.push_back(std::move(job));
+        }
+        {
+            // Under the sleep mutex: a worker between its check and its wait
+            // cannot miss this job
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+            queued_++;
+        }
+        wake_.notify_one();
+    }
+
+    /**
+     * @brief Block until every submitted job (and the jobs they submitted) ran
+     * @note Not from inside a job: the calling worker would wait for itself
+     * @throws The first exception thrown by a job since the last wait()
+     */
+    void wait() {
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        done_.wait(lock, [this]() { return unfinished_.load() == 0; });
+        if (error_) {
+            std::exception_ptr error = error_;
+            error_ = nullptr;
+            std::rethrow_exception(error);
+        }
+    }
+
+    /**
+     * @brief Run fn(i) for every i in [0, count), 'grain' indices per job
+     */
+    template<typename Fn>
+    void parallelFor(size_t count, size_t grain, Fn fn) {
+        grain = grain == 0 ? 1 : grain;
+        for (size_t begin = 0; begin < count; begin += grain) {
+            const size_t end = std::min(count, begin + grain);
+            submit([fn, begin, end]() {
+                for (size_t i = begin; i < end; ++i) fn(i);
+            });
+        }
+        wait();
+    }
+
+    size_t getThreadCount() const { return workers_.size(); }
+    uint64_t getSteals() const { return steals_.load(); }
+    uint64_t getJobsRun() const { return jobsRun_.load(); }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    // The pool and worker index running on this thread (none outside a pool)
+    struct Worker {
+        const WorkStealingPool* pool;
+        size_t index;
+    };
+
+    static Worker& currentWorker() {
+        static thread_local Worker worker{nullptr, 0};
+        return worker;
+    }
+
+    bool popOwn(size_t self, Job& job) {
+        std::lock_guard<std::mutex> lock(queues_[self].mutex);
+        if (queues_[self].jobs.empty()) return false;
+        job = std::move(queues_[self].jobs.back());
+        queues_[self].jobs.pop_back();
+        return true;
+    }
+
+    bool steal(size_t self, Job& job) {
+        for (size_t k = 1; k < queues_.size(); ++k) {
+            Queue& victim = queues_[(self + k) % queues_.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.jobs.empty()) {
+                job = std::move(victim.jobs.front());
+                victim.jobs.pop_front();
+                steals_.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void workerLoop(size_t self) {
+        currentWorker() = Worker{this, self};
+        for (;;) {
+            Job job;
+            if (popOwn(self, job) || steal(self, job)) {
+                {
+                    std::lock_guard<std::mutex> lock(sleepMutex_);
+                    queued_--;
+                }
+                try {
+                    job();
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(sleepMutex_);
+                    if (!error_) error_ = std::current_exception();
+                }
+                jobsRun_.fetch_add(1, std::memory_order_relaxed);
+                if (unfinished_.fetch_sub(1) == 1) {
+                    std::lock_guard<std::mutex> lock(sleepMutex_);
+                    done_.notify_all();
+                }
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(sleepMutex_);
+            wake_.wait(lock, [this]() { return stopping_ || queued_ > 0; });
+            if (stopping_ && queued_ == 0) return;
+        }
+    }
+
+    std::vector<Queue> queues_;
+    std::vector<std::thread> workers_;
+    std::atomic<size_t> nextQueue_{0};
+    std::atomic<size_t> unfinished_{0};
+    std::atomic<uint64_t> steals_{0};
+    std::atomic<uint64_t> jobsRun_{0};
+
+    std::mutex sleepMutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    size_t queued_ = 0;
+    bool stopping_ = false;
+    std::exception_ptr error_;
+};
+
+// ============================================================================
+// Sweep metrics
+// ============================================================================
+
+/// What one scenario run reports; the scenario decides the units
+struct RunMetrics {
+    double overshoot = 0.0;    ///< e.g. degrees above the band, extra state changes
+    uint32_t cycles = 0;       ///< e.g. heater switches, debounced changes
+    double latencyUs = 0.0;    ///< e.g. time to reach the band, press to report
+    bool failed = false;       ///< Property violated (missed press, fault, ...)
+};
+
+/// One run that set a record: enough to replay it alone
+struct WorstCase {
+    size_t config = SIZE_MAX;  ///< Index in the configuration grid
+    uint64_t seed = 0;
+    double value = 0.0;
+
+    bool isSet() const { return config != SIZE_MAX; }
+
+    // Larger value wins; ties go to the lower (config, seed), so the
+    // result does not depend on the order runs finish in
+    void offer(size_t cfg, uint64_t s, double v) {
+        if (!isSet() || v > value || (v == value && std::make_pair(cfg, s) < std::make_pair(config, seed))) {
+            config = cfg;
+            seed = s;
+            value = v;
+        }
+    }
+
+    void merge(const WorstCase& other) {
+        if (other.isSet()) offer(other.config, other.seed, other.value);
+    }
+};
+
+/// Aggregate over the runs of one configuration (or of the whole sweep)
+struct Summary {
+    uint64_t runs = 0;
+    uint64_t failures = 0;
+    double overshootSum = 0.0;
+    double cyclesSum = 0.0;
+    double latencySumUs = 0.0;
+    WorstCase worstOvershoot;
+    WorstCase mostCycles;
+    WorstCase worstLatency;
+    WorstCase firstFailure;    ///< value is 0: the lowest (config, seed) that failed
+
+    void add(size_t config, uint64_t seed, const RunMetrics& m) {
+        runs++;
+        overshootSum += m.overshoot;
+        cyclesSum += m.cycles;
+        latencySumUs += m.latencyUs;
+        worstOvershoot.offer(config, seed, m.overshoot);
+        mostCycles.offer(config, seed, m.cycles);
+        worstLatency.offer(config, seed, m.latencyUs);
+        if (m.failed) {
+            failures++;
+            firstFailure.offer(config, seed, 0.0);
+        }
+    }
+
+    void merge(const Summary& other) {
+        runs += other.runs;
+        failures += other.failures;
+        overshootSum += other.overshootSum;
+        cyclesSum += other.cyclesSum;
+        latencySumUs += other.latencySumUs;
+        worstOvershoot.merge(other.worstOvershoot);
+        mostCycles.merge(other.mostCycles);
+        worstLatency.merge(other.worstLatency);
+        firstFailure.merge(other.firstFailure);
+    }
+
+    double meanOvershoot() const { return runs ? overshootSum / runs : 0.0; }
+    double meanCycles() const { return runs ? cyclesSum / runs : 0.0; }
+    double meanLatencyUs() const { return runs ? latencySumUs / runs : 0.0; }
+};
+
+struct SweepResult {
+    std::vector<Summary> perConfig;
+    Summary total;
+    double seconds = 0.0;      ///< Wall clock time of the sweep
+    uint64_t steals = 0;       ///< Jobs taken from another worker
+
+    double runsPerSecond() const { return seconds > 0.0 ? total.runs / seconds : 0.0; }
+};
+
+/// Scenario seed from configuration and scenario number (splitmix64):
+/// neighbouring runs get unrelated random streams
+inline uint64_t scenarioSeed(size_t config, uint64_t scenario) {
+    uint64_t z = (static_cast<uint64_t>(config) << 40) ^ scenario;
+    z += 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// ============================================================================
+// Sweep driver
+// ============================================================================
+
+/**
+ * @brief Runs every configuration against 'scenarios' seeded scenarios
+ * @tparam Config Parameter set of the code under test (copyable)
+ */
+template<typename Config>
+class Sweep {
+public:
+    /**
+     * @param grid Configurations to test
+     * @param scenarios Runs per configuration
+     * @param runsPerJob Runs per pool job: large enough to hide the queue
+     *        overhead, small enough for stealing to balance the load
+     */
+    Sweep(std::vector<Config> grid, uint64_t scenarios, uint64_t runsPerJob = 64)
+        : grid_(std::move(grid))
+        , scenarios_(scenarios)
+        , runsPerJob_(runsPerJob == 0 ? 1 : runsPerJob)
+    {}
+
+    /// @param scenario RunMetrics(const Config&, uint64_t seed); must only
+    ///        touch its own state, it runs on many threads at once
+    template<typename Scenario>
+    SweepResult run(WorkStealingPool& pool, Scenario scenario) const {
+        struct Job {
+            size_t config;
+            uint64_t first;
+            uint64_t last;
+            Summary summary;
+        };
+
+        std::vector<Job> jobs;
+        for (size_t c = 0; c < grid_.size(); ++c) {
+            for (uint64_t first = 0; first < scenarios_; first += runsPerJob_) {
+                jobs.push_back(Job{c, first, std::min(scenarios_, first + runsPerJob_), Summary{}});
+            }
+        }
+
+        const uint64_t stealsBefore = pool.getSteals();
+        const auto start = std::chrono::steady_clock::now();
+
+        pool.parallelFor(jobs.size(), 1, [this, &jobs, &scenario](size_t j) {
+            Job& job = jobs[j];
+            for (uint64_t n = job.first; n < job.last; ++n) {
+                const uint64_t seed = scenarioSeed(job.config, n);
+                job.summary.add(job.config, seed, scenario(grid_[job.config], seed));
+            }
+        });
+
+        SweepResult result;
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        result.steals = pool.getSteals() - stealsBefore;
+        result.perConfig.resize(grid_.size());
+        for (const Job& job : jobs) {
+            result.perConfig[job.config].merge(job.summary);
+            result.total.merge(job.summary);
+        }
+        return result;
+    }
+
+    const std::vector<Config>& getGrid() const { return grid_; }
+    uint64_t getScenarios() const { return scenarios_; }
+
+private:
+    std::vector<Config> grid_;
+    uint64_t scenarios_;
+    uint64_t runsPerJob_;
+};
+
+}  // namespace stress_sweep
+
+#endif  // STRESS_SWEEP_HPP
@@ -0,0 +1,286 @@
+/**
+ * sweep_controllers - parallel tuning sweep for TemperatureController and
+ * the polling debouncers
+ *
+ * Every configuration of the grids below runs against --scenarios random
+ * scenarios (plant spread, sensor noise, bounce patterns) on all cores.
+ * The report lists per configuration the mean and worst overshoot,
+ * switching cycles and latency, and the seed of every worst case.
+ *
+ *   sweep_controllers                       # all cores, 2000 scenarios
+ *   sweep_controllers --threads 1           # serial baseline
+ *   sweep_controllers --scenarios 100000 --hours 4
+ */
+
+#include "StressSweep.hpp"
+#include "Simulation.hpp"
+#include "Debouncing.hpp"
+#include "temperature_controller.hpp"
+#include "sim_temperature_zone.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace stress_sweep;
+using namespace simulation;
+
+namespace {
+
+// ============================================================================
+// Thermostat: on/off TemperatureController on a spread of plants
+// ============================================================================
+
+struct ThermostatConfig {
+    float setpoint;
+    float hysteresis;
+    float noiseRmsC;
+};
+
+std::string label(const ThermostatConfig& c) {
+    char text[64];
+    std::snprintf(text, sizeof(text), "setpoint %4.1f  hyst %4.2f  noise %4.2f",
+                  c.setpoint, c.hysteresis, c.noiseRmsC);
+    return text;
+}
+
+// overshoot: K above the band, cycles: heater switches,
+// latency: until the plant first enters the band, failed: never did
+RunMetrics runThermostat(const ThermostatConfig& c, uint64_t seed, TimeUs horizon) {
+    std::mt19937_64 random(seed);
+    std::uniform_real_distribution<double> ambient(10.0, 25.0);
+    std::uniform_real_distribution<double> spread(0.8, 1.2);
+
+    Simulator sim;
+    ThermalPlant::Params params;
+    params.ambientC = ambient(random);
+    params.initialC = params.ambientC;
+    params.heaterW *= spread(random);
+    params.capacityJPerK *= spread(random);
+    ThermalPlant plant(sim, params);
+
+    temperature::test::SimTemperatureSensor sensor(plant, c.noiseRmsC, static_cast<uint32_t>(random()));
+    temperature::test::SimHeater heater(plant);
+    temperature::ControllerConfig config;
+    config.setpoint = c.setpoint;
+    config.hysteresis = c.hysteresis;
+    temperature::TemperatureController controller(sensor, heater, config);
+
+    RunMetrics metrics;
+    bool inBand = false;
+    const double bandLow = c.setpoint - c.hysteresis;
+    const double bandHigh = c.setpoint + c.hysteresis;
+    sim.every(SECOND, [&]() {
+        controller.update();
+        const double t = plant.getTemperatureC();
+        if (!inBand && t >= bandLow) {
+            inBand = true;
+            metrics.latencyUs = static_cast<double>(sim.now());
+        }
+        if (t - bandHigh > metrics.overshoot) metrics.overshoot = t - bandHigh;
+    });
+    sim.runFor(horizon);
+
+    metrics.cycles = heater.getSwitchCount();
+    if (!inBand) {
+        metrics.failed = true;
+        metrics.latencyUs = static_cast<double>(horizon);
+    }
+    return metrics;
+}
+
+std::vector<ThermostatConfig> thermostatGrid() {
+    std::vector<ThermostatConfig> grid;
+    for (float setpoint : {30.0F, 45.0F, 60.0F}) {
+        for (float hysteresis : {0.1F, 0.25F, 0.5F, 1.0F}) {
+            for (float noise : {0.0F, 0.1F, 0.3F}) {
+                grid.push_back(ThermostatConfig{setpoint, hysteresis, noise});
+            }
+        }
+    }
+    return grid;
+}
+
+// ============================================================================
+// Debouncers: DelayDebouncer and IntegratorDebouncer on bouncing contacts
+// ============================================================================
+
+struct DebounceConfig {
+    bool integrator;    ///< IntegratorDebouncer, else DelayDebouncer
+    uint8_t threshold;  ///< debounceMs or maxCount, both at a 1 ms poll
+    uint8_t bounceMs;   ///< Bounce window of the contact
+};
+
+std::string label(const DebounceConfig& c) {
+    char text[64];
+    std::snprintf(text, sizeof(text), "%-10s %2u ms  bounce %2u ms",
+                  c.integrator ? "integrator" : "delay", c.threshold, c.bounceMs);
+    return text;
+}
+
+class ContactButton : public debouncing::IRawButton {
+public:
+    explicit ContactButton(const BouncingContact& contact) : contact_(contact) {}
+    bool readRaw() const override { return contact_.isClosed(); }
+
+private:
+    const BouncingContact& contact_;
+};
+
+// overshoot: missed plus extra changes, cycles: debounced changes,
+// latency: longest press or release to report, failed: changes != 2 * presses
+RunMetrics runDebouncer(const DebounceConfig& c, uint64_t seed) {
+    constexpr int PRESSES = 20;
+    std::mt19937_64 random(seed);
+    std::uniform_int_distribution<int> holdMs(30, 300);
+    std::uniform_int_distribution<int> bounces(2, 20);
+
+    Simulator sim;
+    BouncingContact contact(sim, c.bounceMs * MS, bounces(random), static_cast<uint32_t>(random()));
+    ContactButton button(contact);
+    debouncing::DelayDebouncer delay(button, c.threshold);
+    debouncing::IntegratorDebouncer integrator(button, c.threshold);
+
+    RunMetrics metrics;
+    TimeUs commandAt = 0;
+    TimeUs at = MS;
+    for (int i = 0; i < PRESSES; ++i) {
+        sim.at(at, [&]() { commandAt = sim.now(); contact.press(); });
+        at += holdMs(random) * MS;
+        sim.at(at, [&]() { commandAt = sim.now(); contact.release(); });
+        at += holdMs(random) * MS;
+    }
+
+    sim.every(MS, [&]() {
+        bool changed;
+        if (c.integrator) {
+            integrator.update();
+            changed = integrator.stateChanged();
+        } else {
+            delay.update();
+            changed = delay.stateChanged();
+        }
+        if (changed) {
+            metrics.cycles++;
+            const double latency = static_cast<double>(sim.now() - commandAt);
+            if (latency > metrics.latencyUs) metrics.latencyUs = latency;
+        }
+    });
+    sim.runUntil(at + 100 * MS);
+
+    const int expected = 2 * PRESSES;
+    const int changes = static_cast<int>(metrics.cycles);
+    metrics.overshoot = changes > expected ? changes - expected : expected - changes;
+    metrics.failed = changes != expected;
+    return metrics;
+}
+
+std::vector<DebounceConfig> debounceGrid() {
+    std::vector<DebounceConfig> grid;
+    for (bool integrator : {false, true}) {
+        for (uint8_t threshold : {2, 5, 10, 20}) {
+            for (uint8_t bounceMs : {1, 5, 10, 20}) {
+                grid.push_back(DebounceConfig{integrator, threshold, bounceMs});
+            }
+        }
+    }
+    return grid;
+}
+
+// ============================================================================
+// Report
+// ============================================================================
+
+template<typename Config>
+void report(const char* title, const Sweep<Config>& sweep, const SweepResult& result,
+            const char* overshootUnit, const char* latencyUnit, double usPerLatencyUnit) {
+    std::printf("\n== %s: %zu configurations x %llu scenarios ==\n", title,
+                sweep.getGrid().size(), static_cast<unsigned long long>(sweep.getScenarios()));
+    const std::string latency = std::string("lat ") + latencyUnit;
+    const std::string worstLatency = std::string("worst ") + latencyUnit;
+    std::printf("%-40s %10s %10s %10s %10s %10s %10s %8s\n", "configuration",
+                "overshoot", "worst", "cycles", "most", latency.c_str(), worstLatency.c_str(), "failed");
+
+    for (size_t i = 0; i < result.perConfig.size(); ++i) {
+        const Summary& s = result.perConfig[i];
+        std::printf("%-40s %10.3f %10.3f %10.1f %10.0f %10.1f %10.1f %8llu\n",
+                    label(sweep.getGrid()[i]).c_str(),
+                    s.meanOvershoot(), s.worstOvershoot.value,
+                    s.meanCycles(), s.mostCycles.value,
+                    s.meanLatencyUs() / usPerLatencyUnit, s.worstLatency.value / usPerLatencyUnit,
+                    static_cast<unsigned long long>(s.failures));
+    }
+
+    const auto worst = [&](const char* what, const WorstCase& w, double scale, const char* unit) {
+        if (!w.isSet()) return;
+        std::printf("  %-15s %10.3f %-3s %s  seed 0x%016llx\n", what, w.value * scale, unit,
+                    label(sweep.getGrid()[w.config]).c_str(), static_cast<unsigned long long>(w.seed));
+    };
+    std::printf("worst cases:\n");
+    worst("overshoot", result.total.worstOvershoot, 1.0, overshootUnit);
+    worst("cycles", result.total.mostCycles, 1.0, "");
+    worst("latency", result.total.worstLatency, 1.0 / usPerLatencyUnit, latencyUnit);
+    if (result.total.failures > 0) {
+        worst("first failure", result.total.firstFailure, 0.0, "");
+    }
+    std::printf("%llu runs in %.2f s (%.0f runs/s, %llu jobs stolen)\n",
+                static_cast<unsigned long long>(result.total.runs), result.seconds,
+                result.runsPerSecond(), static_cast<unsigned long long>(result.steals));
+}
+
+void usage(const char* program) {
+    std::fprintf(stderr, "usage: %s [--threads N] [--scenarios N] [--hours H] [--only thermostat|debounce]\n",
+                 program);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    size_t threads = WorkStealingPool::defaultThreadCount();
+    uint64_t scenarios = 2000;
+    double hours = 2.0;
+    std::string only;
+
+    for (int i = 1; i < argc; ++i) {
+        const bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--threads") == 0 && hasValue) {
+            threads = std::strtoul(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--scenarios") == 0 && hasValue) {
+            scenarios = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--hours") == 0 && hasValue) {
+            hours = std::strtod(argv[++i], nullptr);
+        } else if (std::strcmp(argv[i], "--only") == 0 && hasValue) {
+            only = argv[++i];
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    WorkStealingPool pool(threads);
+    std::printf("%zu worker threads\n", pool.getThreadCount());
+    bool failed = false;
+
+    if (only.empty() || only == "thermostat") {
+        const TimeUs horizon = static_cast<TimeUs>(hours * HOUR);
+        Sweep<ThermostatConfig> sweep(thermostatGrid(), scenarios, 16);
+        const SweepResult result = sweep.run(pool, [horizon](const ThermostatConfig& c, uint64_t seed) {
+            return runThermostat(c, seed, horizon);
+        });
+        report("TemperatureController on/off", sweep, result, "K", "s", SECOND);
+        failed |= result.total.failures > 0;
+    }
+
+    if (only.empty() || only == "debounce") {
+        Sweep<DebounceConfig> sweep(debounceGrid(), scenarios);
+        const SweepResult result = sweep.run(pool, runDebouncer);
+        report("Polling debouncers", sweep, result, "chg", "ms", MS);
+        failed |= result.total.failures > 0;
+    }
+
+    // Failures are findings, not errors of the tool: exit 1 so scripts notice
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,235 @@
+#include "CppUTest/TestHarness.h"
+#include "StressSweep.hpp"
+#include "../Simulation/Simulation.hpp"
+#include "../Debouncing/Debouncing.hpp"
+
+#include <atomic>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+using namespace stress_sweep;
+
+// ============================================================================
+// WorkStealingPool Tests
+// ============================================================================
+
+TEST_GROUP(WorkStealingPool) {
+};
+
+TEST(WorkStealingPool, RunsEverySubmittedJob) {
+    WorkStealingPool pool(4);
+    std::atomic<int> sum{0};
+
+    for (int i = 1; i <= 1000; ++i) {
+        pool.submit([&sum, i]() { sum += i; });
+    }
+    pool.wait();
+
+    LONGS_EQUAL(500500, sum.load());
+    UNSIGNED_LONGS_EQUAL(1000, pool.getJobsRun());
+}
+
+TEST(WorkStealingPool, ParallelForVisitsEachIndexOnce) {
+    WorkStealingPool pool(3);
+    std::vector<std::atomic<int>> visits(10007);
+
+    pool.parallelFor(visits.size(), 64, [&visits](size_t i) { visits[i]++; });
+
+    for (const auto& v : visits) {
+        LONGS_EQUAL(1, v.load());
+    }
+}
+
+TEST(WorkStealingPool, JobsSubmittedFromJobsAreWaitedFor) {
+    WorkStealingPool pool(4);
+    std::atomic<int> leaves{0};
+
+    // A binary tree of jobs, all children pushed onto the own deque
+    std::function<void(int)> split = [&](int depth) {
+        if (depth == 0) {
+            leaves++;
+            return;
+        }
+        pool.submit([&split, depth]() { split(depth - 1); });
+        pool.submit([&split, depth]() { split(depth - 1); });
+    };
+    pool.submit([&split]() { split(10); });
+    pool.wait();
+
+    LONGS_EQUAL(1024, leaves.load());
+}
+
+TEST(WorkStealingPool, IdleWorkersStealFromABusyOne) {
+    WorkStealingPool pool(4);
+    std::atomic<int> done{0};
+
+    // All work lands on one deque: the others can only get it by stealing
+    pool.submit([&]() {
+        for (int i = 0; i < 64; ++i) {
+            pool.submit([&done]() {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                done++;
+            });
+        }
+    });
+    pool.wait();
+
+    LONGS_EQUAL(64, done.load());
+    CHECK_TRUE(pool.getSteals() > 0U);
+}
+
+TEST(WorkStealingPool, WaitRethrowsTheFirstJobException) {
+    WorkStealingPool pool(2);
+    std::atomic<int> ran{0};
+
+    pool.submit([]() { throw std::runtime_error("scenario crashed"); });
+    for (int i = 0; i < 10; ++i) {
+        pool.submit([&ran]() { ran++; });
+    }
+
+    bool caught = false;
+    try {
+        pool.wait();
+    } catch (const std::runtime_error& e) {
+        caught = true;
+        STRCMP_EQUAL("scenario crashed", e.what());
+    }
+    CHECK_TRUE(caught);
+    LONGS_EQUAL(10, ran.load());
+
+    pool.wait();  // The error was reported once
+}
+
+// ============================================================================
+// Sweep Tests
+// ============================================================================
+
+namespace {
+
+struct Gain {
+    int value;
+};
+
+// Deterministic synthetic scenario: the worst numbers come from known configs
+RunMetrics synthetic(const Gain& g, uint64_t seed) {
+    RunMetrics m;
+    m.overshoot = g.value * static_cast<double>(seed % 100) / 100.0;
+    m.cycles = static_cast<uint32_t>(seed % 7) + static_cast<uint32_t>(g.value);
+    m.latencyUs = 1000.0 / g.value;
+    m.failed = g.value == 3 && seed % 10 == 0;
+    return m;
+}
+
+}  // namespace
+
+TEST_GROUP(Sweep) {
+    std::vector<Gain> grid{{1}, {2}, {3}, {4}};
+};
+
+TEST(Sweep, RunsEveryConfigurationAgainstEveryScenario) {
+    WorkStealingPool pool(4);
+    Sweep<Gain> sweep(grid, 1000, 32);
+
+    const SweepResult result = sweep.run(pool, synthetic);
+
+    UNSIGNED_LONGS_EQUAL(4000, result.total.runs);
+    LONGS_EQUAL(4, static_cast<long>(result.perConfig.size()));
+    for (const Summary& s : result.perConfig) {
+        UNSIGNED_LONGS_EQUAL(1000, s.runs);
+    }
+    LONGS_EQUAL(0, static_cast<long>(result.perConfig[0].failures));
+    CHECK_TRUE(result.perConfig[2].failures > 50U);
+}
+
+TEST(Sweep, FindsTheWorstCasesAndTheirSeeds) {
+    WorkStealingPool pool(4);
+    Sweep<Gain> sweep(grid, 500);
+
+    const SweepResult result = sweep.run(pool, synthetic);
+
+    LONGS_EQUAL(3, static_cast<long>(result.total.worstOvershoot.config));
+    LONGS_EQUAL(0, static_cast<long>(result.total.worstLatency.config));
+    DOUBLES_EQUAL(1000.0, result.total.worstLatency.value, 1e-9);
+    LONGS_EQUAL(2, static_cast<long>(result.total.firstFailure.config));
+
+    // The reported seed reproduces the worst run on its own
+    const WorstCase& w = result.total.worstOvershoot;
+    DOUBLES_EQUAL(w.value, synthetic(grid[w.config], w.seed).overshoot, 1e-12);
+}
+
+TEST(Sweep, ResultDoesNotDependOnTheThreadCount) {
+    WorkStealingPool serial(1);
+    WorkStealingPool parallel(4);
+    Sweep<Gain> sweep(grid, 777, 10);
+
+    const SweepResult a = sweep.run(serial, synthetic);
+    const SweepResult b = sweep.run(parallel, synthetic);
+
+    UNSIGNED_LONGS_EQUAL(a.total.runs, b.total.runs);
+    UNSIGNED_LONGS_EQUAL(a.total.failures, b.total.failures);
+    DOUBLES_EQUAL(a.total.overshootSum, b.total.overshootSum, 1e-9);
+    UNSIGNED_LONGS_EQUAL(a.total.worstOvershoot.seed, b.total.worstOvershoot.seed);
+    UNSIGNED_LONGS_EQUAL(a.total.mostCycles.seed, b.total.mostCycles.seed);
+    UNSIGNED_LONGS_EQUAL(a.total.firstFailure.seed, b.total.firstFailure.seed);
+}
+
+TEST(Sweep, ScenarioSeedsAreDistinct) {
+    std::set<uint64_t> seeds;
+    for (size_t config = 0; config < 16; ++config) {
+        for (uint64_t n = 0; n < 1000; ++n) {
+            seeds.insert(scenarioSeed(config, n));
+        }
+    }
+    LONGS_EQUAL(16000, static_cast<long>(seeds.size()));
+}
+
+// ============================================================================
+// Sweep on simulated scenarios
+// ============================================================================
+
+namespace {
+
+class ContactButton : public debouncing::IRawButton {
+public:
+    explicit ContactButton(const simulation::BouncingContact& contact) : contact_(contact) {}
+    bool readRaw() const override { return contact_.isClosed(); }
+
+private:
+    const simulation::BouncingContact& contact_;
+};
+
+// One press and release of a contact that bounces for 'bounce' ms
+RunMetrics pressOnce(const uint16_t& debounceMs, uint64_t seed, uint16_t bounceMs) {
+    using namespace simulation;
+    Simulator sim;
+    BouncingContact contact(sim, bounceMs * MS, 12, static_cast<uint32_t>(seed));
+    ContactButton button(contact);
+    debouncing::DelayDebouncer debouncer(button, debounceMs);
+
+    RunMetrics m;
+    sim.at(MS, [&]() { contact.press(); });
+    sim.at(200 * MS, [&]() { contact.release(); });
+    sim.every(MS, [&]() {
+        debouncer.update();
+        if (debouncer.stateChanged()) m.cycles++;
+    });
+    sim.runFor(400 * MS);
+    m.failed = m.cycles != 2;
+    return m;
+}
+
+}  // namespace
+
+TEST(Sweep, DebounceTimeShorterThanTheBounceIsCaught) {
+    WorkStealingPool pool(4);
+    Sweep<uint16_t> sweep({2, 20}, 200);
+
+    const SweepResult result = sweep.run(pool, [](const uint16_t& ms, uint64_t seed) {
+        return pressOnce(ms, seed, 10);
+    });
+
+    CHECK_TRUE(result.perConfig[0].failures > 0U);   // 2 ms inside a 10 ms bounce
+    LONGS_EQUAL(0, static_cast<long>(result.perConfig[1].failures));
+    UNSIGNED_LONGS_EQUAL(2, result.perConfig[1].mostCycles.value);
+}
@@ -0,0 +1,90 @@
+/*
+ * HeaterBenchmark - the three heater state machines on real silicon
+ *
+ * Measures handleEvent() of HeaterSwitchCase, HeaterStateTable and
+ * HeaterContext (virtual calls through flash-resident vtables), plus the
+ * Q4.12 conversions (soft-float on Cortex-M0 and AVR), in core cycles.
+ *
+ * Build with TargetBenchmark/, StatePattern/ and FixedPointQ412Test/ on
+ * the include path (see ../README.md), then on the host:
+ *
+ *   python3 target_bench.py --port /dev/ttyACM0 --trigger
+ */
+
+#include <Arduino.h>
+#include "TargetBenchmark.hpp"
+#include "StatePattern.hpp"
+#include "FixedPointQ412.hpp"
+
+using namespace target_benchmark;
+using namespace state_pattern;
+using fixedpoint::FixedPointQ412;
+
+// Visits every state and includes ignored events (same as the host benchmark)
+static const HeaterEvent EVENTS[] = {
+    HeaterEvent::TEMP_LOW,
+    HeaterEvent::TURN_ON,
+    HeaterEvent::TURN_ON,
+    HeaterEvent::TEMP_OK,
+    HeaterEvent::TEMP_LOW,
+    HeaterEvent::TURN_OFF,
+    HeaterEvent::TURN_OFF,
+    HeaterEvent::TEMP_OK,
+};
+static const uint8_t NUM_EVENTS = sizeof(EVENTS) / sizeof(EVENTS[0]);
+
+template<typename Heater>
+struct HeaterCase {
+    Heater heater;
+    uint8_t next;
+};
+
+template<typename Heater>
+static void handleNextEvent(void* context) {
+    HeaterCase<Heater>* c = static_cast<HeaterCase<Heater>*>(context);
+    c->heater.handleEvent(EVENTS[c->next]);
+    c->next = static_cast<uint8_t>(c->next + 1 == NUM_EVENTS ? 0 : c->next + 1);
+}
+
+static HeaterCase<HeaterSwitchCase> switchCase = {};
+static HeaterCase<HeaterStateTable> stateTable = {};
+static HeaterCase<HeaterContext> statePattern = {};
+
+// volatile: the compiler cannot fold the conversions away
+static volatile float voltage = 3.3F;
+static volatile uint16_t fixedValue = 0x3555U;
+
+static void toFixed(void*) {
+    fixedValue = FixedPointQ412::toFixed(voltage);
+}
+
+static void toFixedSaturated(void*) {
+    fixedValue = FixedPointQ412::toFixedSaturated(voltage);
+}
+
+static void toFloat(void*) {
+    voltage = FixedPointQ412::toFloat(fixedValue);
+}
+
+static BenchmarkRunner<> bench(256);
+
+void setup() {
+    Serial.begin(115200);
+    while (!Serial) {}
+
+    bench.addCase("HeaterSwitchCase", &handleNextEvent<HeaterSwitchCase>, &switchCase);
+    bench.addCase("HeaterStateTable", &handleNextEvent<HeaterStateTable>, &stateTable);
+    bench.addCase("HeaterContext", &handleNextEvent<HeaterContext>, &statePattern);
+    bench.addCase("Q412::toFixed", &toFixed);
+    bench.addCase("Q412::toFixedSaturated", &toFixedSaturated);
+    bench.addCase("Q412::toFloat", &toFloat);
+
+    bench.run(Serial);
+}
+
+void loop() {
+    // 'r' from the host runs the cases again
+    if (Serial.available() > 0 && Serial.read() == 'r') {
+        bench.run(Serial);
+    }
+}
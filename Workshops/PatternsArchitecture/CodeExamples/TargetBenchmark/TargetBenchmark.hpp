@@ -0,0 +1,512 @@
+#ifndef TARGET_BENCHMARK_HPP
+#define TARGET_BENCHMARK_HPP
+
+#include <stdint.h>
+#include <stddef.h>
+
+#if defined(__ARM_ARCH_6M__) || defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || \
+    defined(__ARM_ARCH_8M_BASE__) || defined(__ARM_ARCH_8M_MAIN__)
+#define TARGET_BENCHMARK_CORTEX_M 1
+#elif !defined(__AVR__)
+#include <chrono>
+#endif
+
+/**
+ * =============================================================================
+ * ON-TARGET CYCLE BENCHMARKS
+ * =============================================================================
+ *
+ * Problem:
+ *   Host benchmarks hide what matters on a small MCU: soft-float, vtable
+ *   loads from flash, std::function, 8-bit arithmetic. A Cortex-M0 or an
+ *   AVR needs its own numbers.
+ *
+ * Solution:
+ *   Register benchmark cases (plain function + context pointer), run each
+ *   case many times on the target and count core cycles per call:
+ *
+ *     Cortex-M3/M4/M7/M33  DWT->CYCCNT      32-bit, core clock
+ *     Cortex-M0/M0+/M23    SysTick->VAL     24-bit, core clock
+ *     AVR                  Timer1 (TCNT1)   16-bit, F_CPU
+ *     Host                 steady_clock     nanoseconds
+ *
+ *   Every call is measured on its own with interrupts disabled. The cost
+ *   of the measurement itself (reading the counter, the indirect call) is
+ *   measured with an empty case and subtracted. The results are streamed
+ *   as small binary frames; target_bench.py on the host decodes them.
+ *
+ * Include the device header first (Arduino.h does), the counters use
+ * the CMSIS / avr-libc register definitions.
+ *
+ * =============================================================================
+ */
+
+namespace target_benchmark {
+
+// ============================================================================
+// Cycle Counters
+// ============================================================================
+
+/**
+ * Every counter provides:
+ *   enable()                 take the counter over (call once before run())
+ *   restore()                give it back to the application
+ *   start()                  stamp before the measured call
+ *   stop(stamp, ticks)       ticks since the stamp, false on overflow
+ *   clockHz()                ticks per second
+ *   KIND                     CounterKind, sent to the host
+ */
+// Not DWT/SysTick: CMSIS defines those as macros
+enum class CounterKind : uint8_t {
+    ARM_DWT = 0,
+    ARM_SYSTICK = 1,
+    AVR_TIMER1 = 2,
+    HOST_CLOCK = 3
+};
+
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || defined(__ARM_ARCH_8M_MAIN__)
+
+/**
+ * @brief Cortex-M3/M4/M7/M33 DWT cycle counter
+ *
+ * Wraps after 2^32 cycles (about 89 s at 48 MHz), so it never overflows
+ * within one call.
+ */
+struct DwtCounter {
+    static constexpr CounterKind KIND = CounterKind::ARM_DWT;
+
+    static void enable() {
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CYCCNT = 0;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+    static void restore() {}
+
+    static uint32_t start() { return DWT->CYCCNT; }
+    static bool stop(uint32_t stamp, uint32_t& ticks) {
+        ticks = DWT->CYCCNT - stamp;
+        return true;
+    }
+
+    static uint32_t clockHz() { return SystemCoreClock; }
+};
+
+using DefaultCounter = DwtCounter;
+
+#elif defined(TARGET_BENCHMARK_CORTEX_M)
+
+/**
+ * @brief Cortex-M0/M0+/M23 SysTick counter (no DWT cycle counter)
+ *
+ * enable() sets the full 24-bit reload and stops the SysTick interrupt,
+ * so millis() does not advance while benchmarks run. A call may take at
+ * most 2^24 cycles (0.35 s at 48 MHz).
+ */
+struct SysTickCounter {
+    static constexpr CounterKind KIND = CounterKind::ARM_SYSTICK;
+    static constexpr uint32_t MASK = 0x00FFFFFFUL;
+
+    static void enable() {
+        savedCtrl() = SysTick->CTRL;
+        savedLoad() = SysTick->LOAD;
+        SysTick->CTRL = 0;
+        SysTick->LOAD = MASK;
+        SysTick->VAL = 0;
+        SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk;
+    }
+    static void restore() {
+        SysTick->CTRL = 0;
+        SysTick->LOAD = savedLoad();
+        SysTick->VAL = 0;
+        SysTick->CTRL = savedCtrl();
+    }
+
+    static uint32_t start() {
+        (void)SysTick->CTRL;  // Reading CTRL clears COUNTFLAG
+        return SysTick->VAL;
+    }
+    static bool stop(uint32_t stamp, uint32_t& ticks) {
+        const uint32_t now = SysTick->VAL;
+        const bool wrapped = (SysTick->CTRL & SysTick_CTRL_COUNTFLAG_Msk) != 0;
+        ticks = (stamp - now) & MASK;  // Counts down
+        return !wrapped || now > stamp;  // One wrap is fine, more is not
+    }
+
+    static uint32_t clockHz() { return SystemCoreClock; }
+
+private:
+    static uint32_t& savedCtrl() { static uint32_t value = 0; return value; }
+    static uint32_t& savedLoad() { static uint32_t value = 0; return value; }
+};
+
+using DefaultCounter = SysTickCounter;
+
+#elif defined(__AVR__)
+
+/**
+ * @brief AVR Timer1 counter, prescaler 1
+ *
+ * enable() takes Timer1 over (Servo, tone() and PWM on pins 9/10 stop
+ * working until restore()). A call may take at most 65535 cycles
+ * (4 ms at 16 MHz).
+ */
+struct Timer1Counter {
+    static constexpr CounterKind KIND = CounterKind::AVR_TIMER1;
+
+    static void enable() {
+        savedTccr1a() = TCCR1A;
+        savedTccr1b() = TCCR1B;
+        savedTimsk1() = TIMSK1;
+        TIMSK1 = 0;
+        TCCR1A = 0;
+        TCCR1B = _BV(CS10);
+    }
+    static void restore() {
+        TCCR1B = savedTccr1b();
+        TCCR1A = savedTccr1a();
+        TIMSK1 = savedTimsk1();
+    }
+
+    static uint32_t start() {
+        TIFR1 = _BV(TOV1);  // Writing 1 clears the overflow flag
+        return TCNT1;
+    }
+    static bool stop(uint32_t stamp, uint32_t& ticks) {
+        const uint16_t now = TCNT1;
+        const bool wrapped = (TIFR1 & _BV(TOV1)) != 0;
+        ticks = static_cast<uint16_t>(now - stamp);
+        return !wrapped || now < stamp;  // One wrap is fine, more is not
+    }
+
+    static uint32_t clockHz() { return F_CPU; }
+
+private:
+    static uint8_t& savedTccr1a() { static uint8_t value = 0; return value; }
+    static uint8_t& savedTccr1b() { static uint8_t value = 0; return value; }
+    static uint8_t& savedTimsk1() { static uint8_t value = 0; return value; }
+};
+
+using DefaultCounter = Timer1Counter;
+
+#else
+
+/**
+ * @brief Host counter (nanoseconds), to try the harness off-target
+ */
+struct SteadyClockCounter {
+    static constexpr CounterKind KIND = CounterKind::HOST_CLOCK;
+
+    static void enable() {}
+    static void restore() {}
+
+    static uint32_t start() { return now(); }
+    static bool stop(uint32_t stamp, uint32_t& ticks) {
+        ticks = now() - stamp;
+        return true;
+    }
+
+    static uint32_t clockHz() { return 1000000000UL; }
+
+private:
+    static uint32_t now() {
+        return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+};
+
+using DefaultCounter = SteadyClockCounter;
+
+#endif
+
+// ============================================================================
+// Interrupt Lock
+// ============================================================================
+
+/**
+ * @brief Disables interrupts for its lifetime, restores the previous state
+ */
+class InterruptLock {
+public:
+#if defined(TARGET_BENCHMARK_CORTEX_M)
+    InterruptLock() : primask_(__get_PRIMASK()) { __disable_irq(); }
+    ~InterruptLock() { __set_PRIMASK(primask_); }
+#elif defined(__AVR__)
+    InterruptLock() : sreg_(SREG) { cli(); }
+    ~InterruptLock() { SREG = sreg_; }
+#else
+    InterruptLock() {}
+#endif
+
+    InterruptLock(const InterruptLock&) = delete;
+    InterruptLock& operator=(const InterruptLock&) = delete;
+
+private:
+#if defined(TARGET_BENCHMARK_CORTEX_M)
+    uint32_t primask_;
+#elif defined(__AVR__)
+    uint8_t sreg_;
+#endif
+};
+
+// Keeps the compiler from moving memory accesses across a counter read
+inline void compilerBarrier() {
+#if defined(__GNUC__)
+    __asm__ __volatile__("" ::: "memory");
+#endif
+}
+
+// ============================================================================
+// Results and Wire Format
+// ============================================================================
+
+/**
+ * @brief Cycle statistics of one case, overhead already subtracted
+ */
+struct CaseResult {
+    const char* name;
+    uint32_t minTicks;
+    uint32_t maxTicks;
+    uint32_t meanTicks;
+    uint16_t samples;    // Valid measurements
+    uint16_t overflows;  // Measurements dropped because the counter overflowed
+};
+
+/**
+ * Frames, all integers little-endian:
+ *
+ *   0xA5 | type | length | payload[length] | CRC-8 (poly 0x07) over type..payload
+ *
+ *   'H' header   version u8, counter kind u8, clock Hz u32, overhead ticks u32, cases u8
+ *   'C' case     index u8, samples u16, overflows u16, min u32, max u32, mean u32,
+ *                name (the rest of the payload, at most NAME_MAX bytes)
+ *   'E' end      cases u8
+ */
+namespace wire {
+
+static constexpr uint8_t SYNC = 0xA5;
+static constexpr uint8_t VERSION = 1;
+static constexpr uint8_t HEADER = 'H';
+static constexpr uint8_t CASE = 'C';
+static constexpr uint8_t END = 'E';
+static constexpr size_t NAME_MAX = 32;
+static constexpr size_t PAYLOAD_MAX = 19 + NAME_MAX;
+
+inline uint8_t crc8(uint8_t crc, uint8_t byte) {
+    crc ^= byte;
+    for (uint8_t bit = 0; bit < 8; ++bit) {
+        crc = static_cast<uint8_t>((crc & 0x80U) ? (crc << 1) ^ 0x07U : crc << 1);
+    }
+    return crc;
+}
+
+/**
+ * @brief Builds one frame in a fixed buffer
+ */
+class Frame {
+public:
+    explicit Frame(uint8_t type) : length_(3) {
+        bytes_[0] = SYNC;
+        bytes_[1] = type;
+    }
+
+    void put8(uint8_t value) {
+        if (length_ < 3 + PAYLOAD_MAX) bytes_[length_++] = value;
+    }
+    void put16(uint16_t value) {
+        put8(static_cast<uint8_t>(value));
+        put8(static_cast<uint8_t>(value >> 8));
+    }
+    void put32(uint32_t value) {
+        put16(static_cast<uint16_t>(value));
+        put16(static_cast<uint16_t>(value >> 16));
+    }
+
+    // Sink needs write(const uint8_t*, size_t), e.g. Arduino Serial
+    template<typename Sink>
+    void send(Sink& sink) {
+        bytes_[2] = static_cast<uint8_t>(length_ - 3);
+        uint8_t crc = 0;
+        for (size_t i = 1; i < length_; ++i) crc = crc8(crc, bytes_[i]);
+        bytes_[length_] = crc;
+        sink.write(bytes_, length_ + 1);
+    }
+
+private:
+    uint8_t bytes_[3 + PAYLOAD_MAX + 1];
+    size_t length_;
+};
+
+}  // namespace wire
+
+// ============================================================================
+// Runner
+// ============================================================================
+
+/**
+ * @brief Registers cases, measures them and streams the results
+ *
+ * A case is a plain function pointer with a context pointer: the harness
+ * itself uses no virtual calls, no std::function and no heap, so it adds
+ * the same few cycles to every case, which calibrate() removes.
+ *
+ * Usage:
+ *   static HeaterContext heater;
+ *   static void context(void* h) { static_cast<HeaterContext*>(h)->handleEvent(...); }
+ *
+ *   BenchmarkRunner<> bench;
+ *   bench.addCase("HeaterContext", &context, &heater);
+ *   bench.run(Serial);
+ */
+template<typename Counter = DefaultCounter, size_t MAX_CASES = 16>
+class BenchmarkRunner {
+public:
+    using CaseFunction = void (*)(void* context);
+
+    static constexpr uint16_t DEFAULT_SAMPLES = 256;
+
+    explicit BenchmarkRunner(uint16_t samples = DEFAULT_SAMPLES)
+        : numCases_(0), samples_(samples == 0 ? 1 : samples), overheadTicks_(0) {}
+
+    /**
+     * @brief Register a case
+     * @param name Shown by the host script (truncated to wire::NAME_MAX)
+     * @param setup Optional, called before every measured call, not measured
+     * @return false when the table is full
+     */
+    bool addCase(const char* name, CaseFunction function, void* context = nullptr,
+                 CaseFunction setup = nullptr) {
+        if (numCases_ >= MAX_CASES || function == nullptr) return false;
+        cases_[numCases_].name = name;
+        cases_[numCases_].function = function;
+        cases_[numCases_].context = context;
+        cases_[numCases_].setup = setup;
+        results_[numCases_] = CaseResult{name, 0, 0, 0, 0, 0};
+        numCases_++;
+        return true;
+    }
+
+    /**
+     * @brief Measure the harness overhead: the fastest empty call
+     */
+    uint32_t calibrate() {
+        overheadTicks_ = 0;
+        const CaseResult empty = measure(Entry{"", &emptyCase, nullptr, nullptr});
+        overheadTicks_ = empty.samples > 0 ? empty.minTicks : 0;
+        return overheadTicks_;
+    }
+
+    /**
+     * @brief Calibrate and measure all cases; results stay available
+     */
+    void measureAll() {
+        Counter::enable();
+        calibrate();
+        for (size_t i = 0; i < numCases_; ++i) {
+            results_[i] = measure(cases_[i]);
+        }
+        Counter::restore();
+    }
+
+    /**
+     * @brief Stream the stored results (header, one frame per case, end)
+     */
+    template<typename Sink>
+    void report(Sink& sink) const {
+        wire::Frame header(wire::HEADER);
+        header.put8(wire::VERSION);
+        header.put8(static_cast<uint8_t>(Counter::KIND));
+        header.put32(Counter::clockHz());
+        header.put32(overheadTicks_);
+        header.put8(static_cast<uint8_t>(numCases_));
+        header.send(sink);
+
+        for (size_t i = 0; i < numCases_; ++i) {
+            const CaseResult& result = results_[i];
+            wire::Frame frame(wire::CASE);
+            frame.put8(static_cast<uint8_t>(i));
+            frame.put16(result.samples);
+            frame.put16(result.overflows);
+            frame.put32(result.minTicks);
+            frame.put32(result.maxTicks);
+            frame.put32(result.meanTicks);
+            for (size_t c = 0; c < wire::NAME_MAX && result.name[c] != '\0'; ++c) {
+                frame.put8(static_cast<uint8_t>(result.name[c]));
+            }
+            frame.send(sink);
+        }
+
+        wire::Frame end(wire::END);
+        end.put8(static_cast<uint8_t>(numCases_));
+        end.send(sink);
+    }
+
+    template<typename Sink>
+    void run(Sink& sink) {
+        measureAll();
+        report(sink);
+    }
+
+    size_t getCaseCount() const { return numCases_; }
+    uint16_t getSamples() const { return samples_; }
+    uint32_t getOverheadTicks() const { return overheadTicks_; }
+    const CaseResult& getResult(size_t index) const { return results_[index]; }
+
+private:
+    struct Entry {
+        const char* name;
+        CaseFunction function;
+        void* context;
+        CaseFunction setup;
+    };
+
+    static void emptyCase(void*) {}
+
+    CaseResult measure(const Entry& entry) const {
+        CaseResult result{entry.name, UINT32_MAX, 0, 0, 0, 0};
+        uint64_t sum = 0;
+
+        for (uint16_t s = 0; s < samples_; ++s) {
+            if (entry.setup != nullptr) entry.setup(entry.context);
+
+            uint32_t ticks = 0;
+            bool valid = false;
+            {
+                InterruptLock lock;
+                compilerBarrier();
+                const uint32_t stamp = Counter::start();
+                compilerBarrier();
+                entry.function(entry.context);
+                compilerBarrier();
+                valid = Counter::stop(stamp, ticks);
+                compilerBarrier();
+            }
+
+            if (!valid) {
+                result.overflows++;
+                continue;
+            }
+            ticks = ticks > overheadTicks_ ? ticks - overheadTicks_ : 0;
+            if (ticks < result.minTicks) result.minTicks = ticks;
+            if (ticks > result.maxTicks) result.maxTicks = ticks;
+            sum += ticks;
+            result.samples++;
+        }
+
+        if (result.samples == 0) {
+            result.minTicks = 0;
+        } else {
+            result.meanTicks = static_cast<uint32_t>((sum + result.samples / 2) / result.samples);
+        }
+        return result;
+    }
+
+    Entry cases_[MAX_CASES];
+    CaseResult results_[MAX_CASES];
+    size_t numCases_;
+    uint16_t samples_;
+    uint32_t overheadTicks_;
+};
+
+}  // namespace target_benchmark
+
+#endif // TARGET_BENCHMARK_HPP
@@ -0,0 +1,144 @@
+#!/usr/bin/env python3
+"""
+target_bench.py - decoder for TargetBenchmark result frames
+
+The target streams one header frame, one frame per case and an end
+frame (see the wire format in TargetBenchmark.hpp). This tool prints
+them as a table and can store them as JSON or compare them with an
+earlier JSON run.
+
+    # Read a serial port (needs pyserial), 'r' asks the target to run again
+    target_bench.py --port /dev/ttyACM0 --trigger --json m0.json
+
+    # Decode a captured file and compare with a baseline
+    target_bench.py capture.bin --baseline m0.json
+
+Cases that got more than --threshold percent slower (mean cycles) are
+marked, and the exit code is 1 when there is at least one.
+"""
+
+import argparse
+import json
+import struct
+import sys
+
+SYNC = 0xA5
+HEADER = ord('H')
+CASE = ord('C')
+END = ord('E')
+
+COUNTERS = {0: 'DWT', 1: 'SysTick', 2: 'Timer1', 3: 'host'}
+
+
+def crc8(data):
+    """Same as wire::crc8() in TargetBenchmark.hpp: poly 0x07, init 0"""
+    crc = 0
+    for b in data:
+        crc ^= b
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x07) & 0xFF if crc & 0x80 else (crc << 1) & 0xFF
+    return crc
+
+
+def frames(read):
+    """Yield (type, payload) for every frame with a valid checksum"""
+    while True:
+        b = read(1)
+        if not b:
+            return
+        if b[0] != SYNC:
+            continue
+        head = read(2)
+        if len(head) < 2:
+            return
+        rest = read(head[1] + 1)
+        if len(rest) < head[1] + 1:
+            return
+        if crc8(head + rest[:-1]) != rest[-1]:
+            print('checksum error, frame dropped', file=sys.stderr)
+            continue
+        yield head[0], rest[:-1]
+
+
+def collect(read):
+    """Decode one run: header, cases, end. Returns a dict or None"""
+    run = None
+    for kind, payload in frames(read):
+        if kind == HEADER:
+            version, counter, clock, overhead, count = struct.unpack('<BBIIB', payload[:11])
+            run = {'version': version, 'counter': COUNTERS.get(counter, str(counter)),
+                   'clockHz': clock, 'overheadTicks': overhead, 'cases': []}
+        elif kind == CASE and run is not None:
+            index, samples, overflows, lo, hi, mean = struct.unpack('<BHHIII', payload[:17])
+            run['cases'].append({'index': index, 'name': payload[17:].decode('ascii', 'replace'),
+                                 'samples': samples, 'overflows': overflows,
+                                 'min': lo, 'max': hi, 'mean': mean})
+        elif kind == END and run is not None:
+            return run
+    return run
+
+
+def print_run(run, baseline, threshold):
+    print('%s counter, %.1f MHz, overhead %d ticks subtracted' %
+          (run['counter'], run['clockHz'] / 1e6, run['overheadTicks']))
+    old = {c['name']: c for c in baseline['cases']} if baseline else {}
+    regressions = 0
+    print('%-28s %8s %8s %8s %9s %s' % ('case', 'min', 'mean', 'max', 'mean us', 'vs baseline'))
+    for c in run['cases']:
+        us = c['mean'] * 1e6 / run['clockHz'] if run['clockHz'] else 0.0
+        delta = ''
+        if c['name'] in old and old[c['name']]['mean'] > 0:
+            change = 100.0 * (c['mean'] - old[c['name']]['mean']) / old[c['name']]['mean']
+            delta = '%+.1f%%' % change
+            if change > threshold:
+                delta += '  SLOWER'
+                regressions += 1
+        if c['overflows']:
+            delta += '  (%d overflowed)' % c['overflows']
+        print('%-28s %8d %8d %8d %9.3f %s' % (c['name'], c['min'], c['mean'], c['max'], us, delta))
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Decode TargetBenchmark results')
+    parser.add_argument('capture', nargs='?', help='captured binary file (instead of --port)')
+    parser.add_argument('--port', help='serial port of the target')
+    parser.add_argument('--baud', type=int, default=115200)
+    parser.add_argument('--trigger', action='store_true', help="send 'r' to start a run")
+    parser.add_argument('--timeout', type=float, default=10.0, help='serial timeout in seconds')
+    parser.add_argument('--json', help='write the results to this file')
+    parser.add_argument('--baseline', help='earlier --json output to compare with')
+    parser.add_argument('--threshold', type=float, default=5.0, help='regression limit in percent')
+    args = parser.parse_args()
+
+    if args.port:
+        import serial
+        with serial.Serial(args.port, args.baud, timeout=args.timeout) as port:
+            if args.trigger:
+                port.reset_input_buffer()
+                port.write(b'r')
+            run = collect(port.read)
+    elif args.capture:
+        with open(args.capture, 'rb') as f:
+            run = collect(f.read)
+    else:
+        parser.error('give a capture file or --port')
+
+    if run is None:
+        print('no results received', file=sys.stderr)
+        return 2
+
+    baseline = None
+    if args.baseline:
+        with open(args.baseline) as f:
+            baseline = json.load(f)
+    regressions = print_run(run, baseline, args.threshold)
+
+    if args.json:
+        with open(args.json, 'w') as f:
+            json.dump(run, f, indent=2)
+    return 1 if regressions else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,226 @@
+#include "CppUTest/TestHarness.h"
+#include "TargetBenchmark.hpp"
+
+#include <vector>
+
+using namespace target_benchmark;
+
+// ============================================================================
+// Test doubles
+// ============================================================================
+
+// Counter driven by the cases: every measurement costs OVERHEAD ticks
+struct MockCounter {
+    static constexpr CounterKind KIND = CounterKind::HOST_CLOCK;
+    static constexpr uint32_t OVERHEAD = 7;
+
+    static uint32_t now;
+    static bool overflowNext;
+    static int enabled;
+
+    static void enable() { enabled++; }
+    static void restore() { enabled--; }
+
+    static uint32_t start() { return now; }
+    static bool stop(uint32_t stamp, uint32_t& ticks) {
+        now += OVERHEAD;
+        ticks = now - stamp;
+        const bool overflow = overflowNext;
+        overflowNext = false;
+        return !overflow;
+    }
+
+    static uint32_t clockHz() { return 48000000UL; }
+};
+
+uint32_t MockCounter::now = 0;
+bool MockCounter::overflowNext = false;
+int MockCounter::enabled = 0;
+
+struct ByteSink {
+    std::vector<uint8_t> bytes;
+    void write(const uint8_t* data, size_t length) { bytes.insert(bytes.end(), data, data + length); }
+};
+
+// Costs 'cost' ticks, one more on every second call
+struct VaryingWork {
+    uint32_t cost;
+    int calls;
+};
+
+static void varyingWork(void* context) {
+    VaryingWork* work = static_cast<VaryingWork*>(context);
+    MockCounter::now += work->cost + static_cast<uint32_t>(work->calls++ & 1);
+}
+
+static void fixedWork(void*) {
+    MockCounter::now += 100;
+}
+
+static int setupCalls = 0;
+static void countSetup(void*) {
+    setupCalls++;
+    MockCounter::now += 1000;  // Not measured
+}
+
+static void overflowingWork(void*) {
+    MockCounter::overflowNext = true;
+}
+
+static uint32_t read32(const std::vector<uint8_t>& bytes, size_t at) {
+    return static_cast<uint32_t>(bytes[at]) | (static_cast<uint32_t>(bytes[at + 1]) << 8) |
+           (static_cast<uint32_t>(bytes[at + 2]) << 16) | (static_cast<uint32_t>(bytes[at + 3]) << 24);
+}
+
+// ============================================================================
+// BenchmarkRunner Tests
+// ============================================================================
+
+TEST_GROUP(BenchmarkRunner) {
+    void setup() {
+        MockCounter::now = 0;
+        MockCounter::overflowNext = false;
+        MockCounter::enabled = 0;
+        setupCalls = 0;
+    }
+};
+
+TEST(BenchmarkRunner, CalibrationMeasuresHarnessOverhead) {
+    BenchmarkRunner<MockCounter> bench(16);
+    LONGS_EQUAL(MockCounter::OVERHEAD, bench.calibrate());
+}
+
+TEST(BenchmarkRunner, SubtractsOverheadFromEveryCall) {
+    BenchmarkRunner<MockCounter> bench(16);
+    bench.addCase("fixed", &fixedWork);
+    bench.measureAll();
+
+    const CaseResult& result = bench.getResult(0);
+    LONGS_EQUAL(16, result.samples);
+    LONGS_EQUAL(100, result.minTicks);
+    LONGS_EQUAL(100, result.maxTicks);
+    LONGS_EQUAL(100, result.meanTicks);
+}
+
+TEST(BenchmarkRunner, ReportsMinMaxAndMean) {
+    VaryingWork work{20, 0};
+    BenchmarkRunner<MockCounter> bench(10);
+    bench.addCase("varying", &varyingWork, &work);
+    bench.measureAll();
+
+    const CaseResult& result = bench.getResult(0);
+    LONGS_EQUAL(20, result.minTicks);
+    LONGS_EQUAL(21, result.maxTicks);
+    LONGS_EQUAL(21, result.meanTicks);  // 20.5 rounded
+    LONGS_EQUAL(10, work.calls);
+}
+
+TEST(BenchmarkRunner, SetupRunsOutsideTheMeasurement) {
+    BenchmarkRunner<MockCounter> bench(8);
+    bench.addCase("fixed", &fixedWork, nullptr, &countSetup);
+    bench.measureAll();
+
+    LONGS_EQUAL(8, setupCalls);
+    LONGS_EQUAL(100, bench.getResult(0).maxTicks);
+}
+
+TEST(BenchmarkRunner, DropsOverflowedMeasurements) {
+    BenchmarkRunner<MockCounter> bench(5);
+    bench.addCase("overflow", &overflowingWork);
+    bench.measureAll();
+
+    const CaseResult& result = bench.getResult(0);
+    LONGS_EQUAL(0, result.samples);
+    LONGS_EQUAL(5, result.overflows);
+    LONGS_EQUAL(0, result.minTicks);
+}
+
+TEST(BenchmarkRunner, EnablesAndRestoresTheCounter) {
+    BenchmarkRunner<MockCounter> bench;
+    bench.addCase("fixed", &fixedWork);
+    bench.measureAll();
+    LONGS_EQUAL(0, MockCounter::enabled);
+}
+
+TEST(BenchmarkRunner, RejectsCasesWhenFull) {
+    BenchmarkRunner<MockCounter, 2> bench;
+    CHECK_TRUE(bench.addCase("a", &fixedWork));
+    CHECK_TRUE(bench.addCase("b", &fixedWork));
+    CHECK_FALSE(bench.addCase("c", &fixedWork));
+    CHECK_FALSE(BenchmarkRunner<MockCounter>().addCase("null", nullptr));
+    LONGS_EQUAL(2, bench.getCaseCount());
+}
+
+// ============================================================================
+// Wire Format Tests
+// ============================================================================
+
+TEST_GROUP(WireFormat) {
+    void setup() {
+        MockCounter::now = 0;
+        MockCounter::overflowNext = false;
+    }
+};
+
+TEST(WireFormat, StreamsHeaderCasesAndEnd) {
+    BenchmarkRunner<MockCounter> bench(4);
+    bench.addCase("fixed", &fixedWork);
+    ByteSink sink;
+    bench.run(sink);
+
+    const std::vector<uint8_t>& b = sink.bytes;
+    // Header: sync, type, length 11, payload, crc
+    LONGS_EQUAL(wire::SYNC, b[0]);
+    LONGS_EQUAL(wire::HEADER, b[1]);
+    LONGS_EQUAL(11, b[2]);
+    LONGS_EQUAL(wire::VERSION, b[3]);
+    LONGS_EQUAL(static_cast<uint8_t>(CounterKind::HOST_CLOCK), b[4]);
+    LONGS_EQUAL(48000000UL, read32(b, 5));
+    LONGS_EQUAL(MockCounter::OVERHEAD, read32(b, 9));
+    LONGS_EQUAL(1, b[13]);
+
+    // Case: 17 bytes of numbers plus the name
+    const size_t c = 15;
+    LONGS_EQUAL(wire::SYNC, b[c]);
+    LONGS_EQUAL(wire::CASE, b[c + 1]);
+    LONGS_EQUAL(17 + 5, b[c + 2]);
+    LONGS_EQUAL(0, b[c + 3]);
+    LONGS_EQUAL(4, b[c + 4]);
+    LONGS_EQUAL(100, read32(b, c + 8));
+    LONGS_EQUAL(100, read32(b, c + 16));
+    MEMCMP_EQUAL("fixed", &b[c + 20], 5);
+
+    // End
+    const size_t e = c + 3 + 22 + 1;
+    LONGS_EQUAL(wire::SYNC, b[e]);
+    LONGS_EQUAL(wire::END, b[e + 1]);
+    LONGS_EQUAL(e + 5, b.size());
+}
+
+TEST(WireFormat, ChecksumCoversTypeLengthAndPayload) {
+    BenchmarkRunner<MockCounter> bench(1);
+    ByteSink sink;
+    bench.report(sink);
+
+    const std::vector<uint8_t>& b = sink.bytes;
+    uint8_t crc = 0;
+    for (size_t i = 1; i < 3u + b[2]; ++i) crc = wire::crc8(crc, b[i]);
+    LONGS_EQUAL(crc, b[3u + b[2]]);
+}
+
+TEST(WireFormat, Crc8MatchesReferenceValue) {
+    // CRC-8 (poly 0x07, init 0) of "123456789" is 0xF4
+    const char* check = "123456789";
+    uint8_t crc = 0;
+    for (const char* p = check; *p != '\0'; ++p) crc = wire::crc8(crc, static_cast<uint8_t>(*p));
+    LONGS_EQUAL(0xF4, crc);
+}
+
+TEST(WireFormat, TruncatesLongNames) {
+    BenchmarkRunner<MockCounter> bench(1);
+    bench.addCase("a_case_name_that_is_longer_than_thirty_two_bytes", &fixedWork);
+    ByteSink sink;
+    bench.report(sink);
+
+    LONGS_EQUAL(17 + wire::NAME_MAX, sink.bytes[15 + 2]);
+}
@@ -1,13 +1,55 @@
 #include "temperature_conversion.hpp"
 
+#include <array>
+
+#if defined(__AVR__)
+#error "The 8 KB conversion table needs const data in flash (ARM Cortex-M or host), see temperature_conversion.hpp"
+#endif
+
 namespace temperature {
 
+namespace {
+
+constexpr size_t ADC_TABLE_SIZE = SensorConfig::ADC_MAX_VALUE + 1U;
+
+// Rounded to nearest in integer math: the table is exact
+constexpr std::array<int16_t, ADC_TABLE_SIZE> makeCentiTable() {
+    std::array<int16_t, ADC_TABLE_SIZE> table{};
+    constexpr int32_t ADC_MAX = SensorConfig::ADC_MAX_VALUE;
+
+    for (int32_t adc = 0; adc <= ADC_MAX; ++adc) {
+        const int32_t scaled = (2 * adc * SensorConfig::TEMP_RANGE_CENTI + ADC_MAX) / (2 * ADC_MAX);
+        table[static_cast<size_t>(adc)] = static_cast<int16_t>(scaled + SensorConfig::TEMP_MIN_CENTI);
+    }
+    return table;
+}
+
+constexpr std::array<int16_t, ADC_TABLE_SIZE> CENTI_TABLE = makeCentiTable();
+
+static_assert(CENTI_TABLE[0] == SensorConfig::TEMP_MIN_CENTI, "Table must start at TEMP_MIN");
+static_assert(CENTI_TABLE[SensorConfig::ADC_MAX_VALUE]
+                  == SensorConfig::TEMP_MIN_CENTI + SensorConfig::TEMP_RANGE_CENTI,
+              "Table must end at TEMP_MAX");
+
+}  // namespace
+
+int16_t adcToCentiCelsius(uint16_t adcValue) {
+    if (adcValue > SensorConfig::ADC_MAX_VALUE) {
+        adcValue = SensorConfig::ADC_MAX_VALUE;
+    }
+    return CENTI_TABLE[adcValue];
+}
+
+void adcToCentiCelsius(const uint16_t* adcValues, int16_t* centiCelsius, size_t count) {
+    for (size_t i = 0U; i < count; ++i) {
+        centiCelsius[i] = adcToCentiCelsius(adcValues[i]);
+    }
+}
+
 float adcToCelsius(uint16_t adcValue) {
-    const float normalizedValue = static_cast<float>(adcValue) 
-                                / static_cast<float>(SensorConfig::ADC_MAX_VALUE);
-    
-    return (normalizedValue * SensorConfig::TEMP_RANGE_CELSIUS) 
-           + SensorConfig::TEMP_MIN_CELSIUS;
+    constexpr float CENTI_PER_DEGREE = 100.0F;
+
+    return static_cast<float>(adcToCentiCelsius(adcValue)) / CENTI_PER_DEGREE;
 }
 
 bool isInValidRange(float celsius) {
@@ -0,0 +1,230 @@
+#ifndef DECIMATOR_HPP
+#define DECIMATOR_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+namespace temperature {
+
+/// @brief Integer decimator for oversampled ADC readings
+/// @details Two stages, both integer only:
+///          - a CIC (cascaded integrator-comb) filter of STAGES stages that
+///            decimates by the CIC ratio, in wrap-around 32-bit arithmetic:
+///            one add per stage per input sample, no multiplications
+///          - a decimate-by-2 half-band FIR (11 taps, of which 4 are zero)
+///            that removes what the CIC lets alias into the band between a
+///            quarter and half of the output rate, and is flat where the
+///            CIC droops, because the CIC runs at twice the output rate
+///          Total ratio = 2 x CIC ratio, e.g. 16 = CIC 8 + half-band 2.
+///          The output is in input units with OUTPUT_FRACTION_BITS extra
+///          fraction bits: the averaging gains resolution below one count.
+///
+///          Range: the CIC grows STAGES x log2(CIC ratio) bits, so
+///          |input| x (CIC ratio)^STAGES must stay below 2^31 (a 12-bit ADC
+///          at ratio 16, three stages: 21 bits).
+template<uint8_t STAGES = 3U, uint8_t MAX_CIC_RATIO = 8U, uint8_t OUTPUT_FRACTION_BITS = 4U>
+class Decimator {
+public:
+    static_assert(STAGES > 0U, "The CIC needs at least one stage");
+    static_assert(MAX_CIC_RATIO > 0U, "CIC ratio must be at least 1");
+    static_assert(OUTPUT_FRACTION_BITS < 16U, "Output fraction bits out of range");
+
+    static constexpr uint8_t FRACTION_BITS = OUTPUT_FRACTION_BITS;
+    static constexpr uint8_t HALF_BAND_TAPS = 11U;
+
+    /// @brief Outputs until the start-up transient has left both filters
+    static constexpr uint16_t SETTLE_OUTPUTS = (STAGES + HALF_BAND_TAPS) / 2U;
+
+    /// @param ratio Total decimation ratio, see setRatio()
+    explicit Decimator(uint16_t ratio = 2U * MAX_CIC_RATIO);
+
+    /// @brief Set the total decimation ratio and reset
+    /// @param ratio Even, 2 .. 2 x MAX_CIC_RATIO
+    /// @return false (ratio unchanged) for any other value
+    bool setRatio(uint16_t ratio);
+
+    /// @brief Get the total decimation ratio
+    uint16_t getRatio() const;
+
+    /// @brief Add one input sample
+    /// @param input ADC reading (or any integer sample)
+    /// @param output Receives the decimated value when one is ready
+    /// @return true every getRatio() inputs
+    bool addSample(int32_t input, int32_t& output);
+
+    /// @brief Decimate a block of input samples, oldest first
+    /// @details Same result as calling addSample() for each input
+    /// @param input Input samples
+    /// @param count Number of inputs
+    /// @param output Room for count / getRatio() + 1 outputs
+    /// @return Number of outputs written
+    size_t process(const int32_t* input, size_t count, int32_t* output);
+
+    /// @brief Check that the first outputs with start-up transient are past
+    bool isSettled() const;
+
+    /// @brief Clear all filter state
+    void reset();
+
+    /// @brief Convert an output back to input units
+    static float toInputUnits(int32_t output);
+
+private:
+    bool combAndFilter(uint32_t integrated, int32_t& output);
+
+    std::array<uint32_t, STAGES> m_integrators;  // Wrap around by design
+    std::array<uint32_t, STAGES> m_combDelays;
+    std::array<int32_t, HALF_BAND_TAPS> m_halfBand;  // CIC outputs, newest at m_halfBandIndex
+    uint8_t m_cicRatio;
+    uint8_t m_phase;            // Inputs since the last CIC output
+    uint8_t m_halfBandIndex;
+    bool m_halfBandOdd;         // Every second CIC output makes an output
+    uint16_t m_outputs;         // Saturates at SETTLE_OUTPUTS
+    int64_t m_cicGain;          // m_cicRatio ^ STAGES
+};
+
+// ============================================================================
+// Template Implementation
+// ============================================================================
+
+template<uint8_t STAGES, uint8_t MAX_CIC_RATIO, uint8_t OUTPUT_FRACTION_BITS>
+Decimator<STAGES, MAX_CIC_RATIO, OUTPUT_FRACTION_BITS>::Decimator(uint16_t ratio)
+    : m_integrators{}
+    , m_combDelays{}
+    , m_halfBand{}
+    , m_cicRatio{MAX_CIC_RATIO}
+    , m_phase{0U}
+    , m_halfBandIndex{0U}
+    , m_halfBandOdd{false}
+    , m_outputs{0U}
+    , m_cicGain{1}
+{
+    if (!setRatio(ratio)) {
+        setRatio(2U * MAX_CIC_RATIO);
+    }
+}
+
+template<uint8_t STAGES, uint8_t MAX_CIC_RATIO, uint8_t OUTPUT_FRACTION_BITS>
+bool Decimator<STAGES, MAX_CIC_RATIO, OUTPUT_FRACTION_BITS>::setRatio(uint16_t ratio) {
+    if (ratio < 2U || (ratio % 2U) != 0U || ratio / 2U > MAX_CIC_RATIO) {
+        return false;
+    }
+
+    m_cicRatio = static_cast<uint8_t>(ratio / 2U);
+    m_cicGain = 1;
+    for (uint8_t i = 0U; i < STAGES; ++i) {
+        m_cicGain *= m_cicRatio;
+    }
+    reset();
+    return true;
+}
+
+template<uint8_t STAGES, uint8_t MAX_CIC_RATIO, uint8_t OUTPUT_FRACTION_BITS>
+uint16_t Decimator<STAGES, MAX_CIC_RATIO, OUTPUT_FRACTION_BITS>::getRatio() const {
+    return static_cast<uint16_t>(2U * m_cicRatio);
+}
+
+template<uint8_t STAGES, uint8_t MAX_CIC_RATIO, uint8_t OUTPUT_FRACTION_BITS>
+bool Decimator<STAGES, MAX_CIC_RATIO, OUTPUT_FRACTION_BITS>::addSample(int32_t input, int32_t& output) {
+    uint32_t sum = static_cast<uint32_t>(input);
+    for (uint8_t i = 0U; i < STAGES; ++i) {
+        m_integrators[i] += sum;
+        sum = m_integrators[i];
+    }
+
+    if (++m_phase < m_cicRatio) {
+        return false;
+    }
+    m_phase = 0U;
+    return combAndFilter(m_integrators[STAGES - 1U], output);
+}
+
+template<uint8_t STAGES, uint8_t MAX_CIC_RATIO, uint8_t OUTPUT_FRACTION_BITS>
+size_t Decimator<STAGES, MAX_CIC_RATIO, OUTPUT_FRACTION_BITS>::process(
+    const int32_t* input, size_t count, int32_t* output) {
+    size_t written = 0U;
+
+    // Integrators at the input rate, in a local copy for the whole block
+    std::array<uint32_t, STAGES> integrators = m_integrators;
+    for (size_t n = 0U; n < count; ++n) {
+        uint32_t sum = static_cast<uint32_t>(input[n]);
+        for (uint8_t i = 0U; i < STAGES; ++i) {
+            integrators[i] += sum;
+            sum = integrators[i];
+        }
+
+        if (++m_phase == m_cicRatio) {
+            m_phase = 0U;
+            if (combAndFilter(sum, output[written])) {
+                ++written;
+            }
+        }
+    }
+    m_integrators = integrators;
+    return written;
+}
+
+template<uint8_t STAGES, uint8_t MAX_CIC_RATIO, uint8_t OUTPUT_FRACTION_BITS>
+bool Decimator<STAGES, MAX_CIC_RATIO, OUTPUT_FRACTION_BITS>::isSettled() const {
+    return m_outputs >= SETTLE_OUTPUTS;
+}
+
+template<uint8_t STAGES, uint8_t MAX_CIC_RATIO, uint8_t OUTPUT_FRACTION_BITS>
+void Decimator<STAGES, MAX_CIC_RATIO, OUTPUT_FRACTION_BITS>::reset() {
+    m_integrators.fill(0U);
+    m_combDelays.fill(0U);
+    m_halfBand.fill(0);
+    m_phase = 0U;
+    m_halfBandIndex = 0U;
+    m_halfBandOdd = false;
+    m_outputs = 0U;
+}
+
+template<uint8_t STAGES, uint8_t MAX_CIC_RATIO, uint8_t OUTPUT_FRACTION_BITS>
+float Decimator<STAGES, MAX_CIC_RATIO, OUTPUT_FRACTION_BITS>::toInputUnits(int32_t output) {
+    return static_cast<float>(output) / static_cast<float>(1UL << OUTPUT_FRACTION_BITS);
+}
+
+// Combs at the CIC output rate, then the half-band at half that rate
+template<uint8_t STAGES, uint8_t MAX_CIC_RATIO, uint8_t OUTPUT_FRACTION_BITS>
+bool Decimator<STAGES, MAX_CIC_RATIO, OUTPUT_FRACTION_BITS>::combAndFilter(uint32_t integrated, int32_t& output) {
+    uint32_t value = integrated;
+    for (uint8_t i = 0U; i < STAGES; ++i) {
+        const uint32_t delayed = m_combDelays[i];
+        m_combDelays[i] = value;
+        value -= delayed;
+    }
+
+    // Exact as long as the true result fits: wrap-around cancels in the combs.
+    // Remove the CIC gain, keep the fraction bits
+    const int64_t scaled = static_cast<int64_t>(static_cast<int32_t>(value)) << OUTPUT_FRACTION_BITS;
+    const int64_t half = m_cicGain / 2;
+    m_halfBandIndex = static_cast<uint8_t>((m_halfBandIndex + 1U) % HALF_BAND_TAPS);
+    m_halfBand[m_halfBandIndex] = static_cast<int32_t>(
+        (scaled >= 0 ? scaled + half : scaled - half) / m_cicGain);
+
+    m_halfBandOdd = !m_halfBandOdd;
+    if (m_halfBandOdd) {
+        return false;
+    }
+
+    // h = [3 0 -25 0 150 256 150 0 -25 0 3] / 512: symmetric, even taps zero
+    const auto tap = [this](uint8_t age) -> int64_t {
+        return m_halfBand[(m_halfBandIndex + HALF_BAND_TAPS - age) % HALF_BAND_TAPS];
+    };
+    const int64_t sum = 3 * (tap(0U) + tap(10U))
+                      - 25 * (tap(2U) + tap(8U))
+                      + 150 * (tap(4U) + tap(6U))
+                      + 256 * tap(5U);
+    output = static_cast<int32_t>((sum >= 0 ? sum + 256 : sum - 256) / 512);
+
+    if (m_outputs < SETTLE_OUTPUTS) {
+        ++m_outputs;
+    }
+    return true;
+}
+
+}  // namespace temperature
+
+#endif  // DECIMATOR_HPP
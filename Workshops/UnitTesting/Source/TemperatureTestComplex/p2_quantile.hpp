@@ -0,0 +1,184 @@
+#ifndef P2_QUANTILE_HPP
+#define P2_QUANTILE_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+namespace temperature {
+
+/// @brief Streaming percentile estimate with the P-square algorithm
+/// @details For windows too long to store (a percentile over hours of
+///          readings), Jain and Chlamtac's P-square algorithm tracks a
+///          quantile in five markers: the minimum, the quantile, the
+///          maximum and two half-way markers. Each sample moves the marker
+///          positions by one and adjusts the heights with a parabolic
+///          (or, where that overshoots, linear) interpolation. O(1) per
+///          sample and 5 floats of state, whatever the number of samples.
+///
+///          The estimate covers every sample since the last reset(). For
+///          a window that slides, reset() at the window period, or use
+///          SlidingMedian when the window fits in memory.
+class P2Quantile {
+public:
+    static constexpr uint8_t MARKERS = 5U;
+
+    /// @param quantile Between 0 and 1, e.g. 0.5 for the median, 0.95
+    explicit P2Quantile(float quantile = 0.5F);
+
+    /// @brief Add a sample
+    void addSample(float sample);
+
+    /// @brief Estimated quantile of all samples so far
+    /// @details Exact (nearest rank) for the first MARKERS samples
+    /// @return 0 without samples
+    float getEstimate() const;
+
+    /// @brief Smallest and largest sample so far
+    float getMinimum() const;
+    float getMaximum() const;
+
+    float getQuantile() const;
+    uint32_t getSampleCount() const;
+
+    /// @brief Forget all samples
+    void reset();
+
+private:
+    float parabolic(uint8_t i, int32_t direction) const;
+    float linear(uint8_t i, int32_t direction) const;
+
+    float m_quantile;
+    std::array<float, MARKERS> m_heights;
+    std::array<int32_t, MARKERS> m_positions;
+    std::array<float, MARKERS> m_desired;
+    std::array<float, MARKERS> m_increments;
+    uint32_t m_count;
+};
+
+// ============================================================================
+// Implementation
+// ============================================================================
+
+inline P2Quantile::P2Quantile(float quantile)
+    : m_quantile{quantile < 0.0F ? 0.0F : (quantile > 1.0F ? 1.0F : quantile)}
+    , m_heights{}
+    , m_positions{}
+    , m_desired{}
+    , m_increments{0.0F, m_quantile / 2.0F, m_quantile, (1.0F + m_quantile) / 2.0F, 1.0F}
+    , m_count{0U}
+{
+    reset();
+}
+
+inline void P2Quantile::addSample(float sample) {
+    if (m_count < MARKERS) {
+        // Insertion sort of the first samples: they become the markers
+        uint8_t i = static_cast<uint8_t>(m_count);
+        while (i > 0U && sample < m_heights[i - 1U]) {
+            m_heights[i] = m_heights[i - 1U];
+            --i;
+        }
+        m_heights[i] = sample;
+        ++m_count;
+        return;
+    }
+
+    // Cell of the sample; a new extreme moves the outer marker
+    uint8_t cell = 0U;
+    if (sample < m_heights[0]) {
+        m_heights[0] = sample;
+    } else if (sample >= m_heights[MARKERS - 1U]) {
+        m_heights[MARKERS - 1U] = sample;
+        cell = MARKERS - 2U;
+    } else {
+        while (cell < MARKERS - 2U && sample >= m_heights[cell + 1U]) {
+            ++cell;
+        }
+    }
+
+    for (uint8_t i = static_cast<uint8_t>(cell + 1U); i < MARKERS; ++i) {
+        ++m_positions[i];
+    }
+    for (uint8_t i = 0U; i < MARKERS; ++i) {
+        m_desired[i] += m_increments[i];
+    }
+
+    // Move the middle markers that are a position or more off
+    for (uint8_t i = 1U; i < MARKERS - 1U; ++i) {
+        const float offset = m_desired[i] - static_cast<float>(m_positions[i]);
+        const bool up = offset >= 1.0F && m_positions[i + 1U] - m_positions[i] > 1;
+        const bool down = offset <= -1.0F && m_positions[i - 1U] - m_positions[i] < -1;
+        if (!up && !down) {
+            continue;
+        }
+        const int32_t direction = up ? 1 : -1;
+        const float height = parabolic(i, direction);
+        if (m_heights[i - 1U] < height && height < m_heights[i + 1U]) {
+            m_heights[i] = height;
+        } else {
+            m_heights[i] = linear(i, direction);
+        }
+        m_positions[i] += direction;
+    }
+    ++m_count;
+}
+
+inline float P2Quantile::getEstimate() const {
+    if (m_count == 0U) {
+        return 0.0F;
+    }
+    if (m_count < MARKERS) {
+        const float rank = m_quantile * static_cast<float>(m_count - 1U);
+        return m_heights[static_cast<uint8_t>(rank + 0.5F)];
+    }
+    return m_heights[2];
+}
+
+inline float P2Quantile::getMinimum() const {
+    return m_count == 0U ? 0.0F : m_heights[0];
+}
+
+inline float P2Quantile::getMaximum() const {
+    if (m_count == 0U) {
+        return 0.0F;
+    }
+    return m_count < MARKERS ? m_heights[m_count - 1U] : m_heights[MARKERS - 1U];
+}
+
+inline float P2Quantile::getQuantile() const {
+    return m_quantile;
+}
+
+inline uint32_t P2Quantile::getSampleCount() const {
+    return m_count;
+}
+
+inline void P2Quantile::reset() {
+    m_heights.fill(0.0F);
+    for (uint8_t i = 0U; i < MARKERS; ++i) {
+        m_positions[i] = i;
+    }
+    m_desired = {0.0F, 2.0F * m_quantile, 4.0F * m_quantile, 2.0F + 2.0F * m_quantile, 4.0F};
+    m_count = 0U;
+}
+
+// Piecewise-parabolic prediction of marker i moved by direction (+1 or -1)
+inline float P2Quantile::parabolic(uint8_t i, int32_t direction) const {
+    const float d = static_cast<float>(direction);
+    const float below = static_cast<float>(m_positions[i] - m_positions[i - 1U]);
+    const float above = static_cast<float>(m_positions[i + 1U] - m_positions[i]);
+    return m_heights[i] + d / (below + above)
+           * ((below + d) * (m_heights[i + 1U] - m_heights[i]) / above
+              + (above - d) * (m_heights[i] - m_heights[i - 1U]) / below);
+}
+
+inline float P2Quantile::linear(uint8_t i, int32_t direction) const {
+    const uint8_t neighbour = static_cast<uint8_t>(direction > 0 ? i + 1U : i - 1U);
+    return m_heights[i] + static_cast<float>(direction) * (m_heights[neighbour] - m_heights[i])
+           / static_cast<float>(m_positions[neighbour] - m_positions[i]);
+}
+
+}  // namespace temperature
+
+#endif  // P2_QUANTILE_HPP
@@ -0,0 +1,221 @@
+#ifndef SLIDING_MEDIAN_HPP
+#define SLIDING_MEDIAN_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+namespace temperature {
+
+/// @brief Median of the last WINDOW_SIZE samples, O(log N) per sample
+/// @details A spike moves a mean (TemperatureFilter) by spike / N; it does
+///          not move a median at all until half the window is spikes.
+///
+///          The samples sit in a ring buffer. Two heaps index it: a max-heap
+///          holds the lower half of the window, a min-heap the upper half,
+///          so the median is at the top of one or both. A new sample
+///          overwrites the oldest one in place, in whichever heap that was.
+///          It is sifted there, and swapped across if it belongs in the
+///          other half. Each step is O(log N), and no memory is allocated:
+///          three arrays of WINDOW_SIZE.
+template<typename T = int32_t, uint16_t WINDOW_SIZE = 15U>
+class SlidingMedian {
+public:
+    static_assert(WINDOW_SIZE > 0U, "Window must hold at least one sample");
+
+    SlidingMedian();
+
+    /// @brief Add a sample; once the window is full, the oldest one leaves
+    void addSample(T sample);
+
+    /// @brief Median of the samples in the window
+    /// @details For an even count, the mean of the two middle samples
+    ///          (rounded towards the lower one for integers)
+    /// @return T{} while the window is empty
+    T getMedian() const;
+
+    /// @brief The middle samples: for an even count the largest of the
+    ///        lower half and the smallest of the upper half, for an odd
+    ///        count both the median
+    T getLowerMedian() const;
+    T getUpperMedian() const;
+
+    /// @brief Check if the window is fully populated
+    bool isReady() const;
+
+    /// @brief Get number of samples currently in the window
+    uint16_t getSampleCount() const;
+
+    /// @brief Empty the window
+    void reset();
+
+private:
+    // Where a slot of the ring buffer is: heap and index in it
+    struct Location {
+        bool upper;
+        uint16_t index;
+    };
+
+    bool before(bool upper, uint16_t a, uint16_t b) const;
+    void place(bool upper, uint16_t index, uint16_t slot);
+    void siftUp(bool upper, uint16_t index);
+    void siftDown(bool upper, uint16_t index);
+    void balanceTops();
+
+    std::array<T, WINDOW_SIZE> m_values;         // Ring buffer
+    std::array<uint16_t, WINDOW_SIZE> m_heaps;   // Lower heap from 0 up, upper heap from the end down
+    std::array<Location, WINDOW_SIZE> m_where;   // Per slot
+    uint16_t m_lowerSize;
+    uint16_t m_upperSize;
+    uint16_t m_next;                             // Slot of the oldest sample once full
+};
+
+// ============================================================================
+// Template Implementation
+// ============================================================================
+
+template<typename T, uint16_t WINDOW_SIZE>
+SlidingMedian<T, WINDOW_SIZE>::SlidingMedian()
+    : m_values{}
+    , m_heaps{}
+    , m_where{}
+    , m_lowerSize{0U}
+    , m_upperSize{0U}
+    , m_next{0U}
+{
+}
+
+template<typename T, uint16_t WINDOW_SIZE>
+void SlidingMedian<T, WINDOW_SIZE>::addSample(T sample) {
+    const uint16_t slot = m_next;
+    m_next = static_cast<uint16_t>((m_next + 1U) % WINDOW_SIZE);
+    m_values[slot] = sample;
+
+    if (isReady()) {
+        // Overwrite the oldest sample where it is, then restore the heap
+        const Location where = m_where[slot];
+        siftUp(where.upper, where.index);
+        siftDown(where.upper, m_where[slot].index);
+    } else if (m_lowerSize <= m_upperSize) {
+        place(false, m_lowerSize, slot);
+        ++m_lowerSize;
+        siftUp(false, static_cast<uint16_t>(m_lowerSize - 1U));
+    } else {
+        place(true, m_upperSize, slot);
+        ++m_upperSize;
+        siftUp(true, static_cast<uint16_t>(m_upperSize - 1U));
+    }
+    balanceTops();
+}
+
+template<typename T, uint16_t WINDOW_SIZE>
+T SlidingMedian<T, WINDOW_SIZE>::getMedian() const {
+    if (m_lowerSize == 0U) {
+        return T{};
+    }
+    const T lower = getLowerMedian();
+    return lower + (getUpperMedian() - lower) / 2;
+}
+
+template<typename T, uint16_t WINDOW_SIZE>
+T SlidingMedian<T, WINDOW_SIZE>::getLowerMedian() const {
+    return m_lowerSize == 0U ? T{} : m_values[m_heaps[0]];
+}
+
+template<typename T, uint16_t WINDOW_SIZE>
+T SlidingMedian<T, WINDOW_SIZE>::getUpperMedian() const {
+    if (m_lowerSize > m_upperSize) {
+        return getLowerMedian();
+    }
+    return m_values[m_heaps[WINDOW_SIZE - 1U]];
+}
+
+template<typename T, uint16_t WINDOW_SIZE>
+bool SlidingMedian<T, WINDOW_SIZE>::isReady() const {
+    return m_lowerSize + m_upperSize == WINDOW_SIZE;
+}
+
+template<typename T, uint16_t WINDOW_SIZE>
+uint16_t SlidingMedian<T, WINDOW_SIZE>::getSampleCount() const {
+    return static_cast<uint16_t>(m_lowerSize + m_upperSize);
+}
+
+template<typename T, uint16_t WINDOW_SIZE>
+void SlidingMedian<T, WINDOW_SIZE>::reset() {
+    m_lowerSize = 0U;
+    m_upperSize = 0U;
+    m_next = 0U;
+}
+
+// True if a belongs above b in its heap: larger in the lower (max) heap,
+// smaller in the upper (min) heap
+template<typename T, uint16_t WINDOW_SIZE>
+bool SlidingMedian<T, WINDOW_SIZE>::before(bool upper, uint16_t a, uint16_t b) const {
+    const uint16_t slotA = m_heaps[upper ? WINDOW_SIZE - 1U - a : a];
+    const uint16_t slotB = m_heaps[upper ? WINDOW_SIZE - 1U - b : b];
+    return upper ? m_values[slotA] < m_values[slotB] : m_values[slotB] < m_values[slotA];
+}
+
+template<typename T, uint16_t WINDOW_SIZE>
+void SlidingMedian<T, WINDOW_SIZE>::place(bool upper, uint16_t index, uint16_t slot) {
+    m_heaps[upper ? WINDOW_SIZE - 1U - index : index] = slot;
+    m_where[slot] = Location{upper, index};
+}
+
+template<typename T, uint16_t WINDOW_SIZE>
+void SlidingMedian<T, WINDOW_SIZE>::siftUp(bool upper, uint16_t index) {
+    while (index > 0U) {
+        const uint16_t parent = static_cast<uint16_t>((index - 1U) / 2U);
+        if (!before(upper, index, parent)) {
+            return;
+        }
+        const uint16_t slot = m_heaps[upper ? WINDOW_SIZE - 1U - index : index];
+        place(upper, index, m_heaps[upper ? WINDOW_SIZE - 1U - parent : parent]);
+        place(upper, parent, slot);
+        index = parent;
+    }
+}
+
+template<typename T, uint16_t WINDOW_SIZE>
+void SlidingMedian<T, WINDOW_SIZE>::siftDown(bool upper, uint16_t index) {
+    const uint16_t size = upper ? m_upperSize : m_lowerSize;
+    for (;;) {
+        const uint32_t left = 2U * index + 1U;
+        if (left >= size) {
+            return;
+        }
+        uint16_t child = static_cast<uint16_t>(left);
+        if (left + 1U < size && before(upper, static_cast<uint16_t>(left + 1U), child)) {
+            child = static_cast<uint16_t>(left + 1U);
+        }
+        if (!before(upper, child, index)) {
+            return;
+        }
+        const uint16_t slot = m_heaps[upper ? WINDOW_SIZE - 1U - index : index];
+        place(upper, index, m_heaps[upper ? WINDOW_SIZE - 1U - child : child]);
+        place(upper, child, slot);
+        index = child;
+    }
+}
+
+// Every sample in the lower half must be <= every one in the upper half;
+// one sample changed, so at most the two tops are out of order
+template<typename T, uint16_t WINDOW_SIZE>
+void SlidingMedian<T, WINDOW_SIZE>::balanceTops() {
+    if (m_upperSize == 0U) {
+        return;
+    }
+    const uint16_t lowerTop = m_heaps[0];
+    const uint16_t upperTop = m_heaps[WINDOW_SIZE - 1U];
+    if (!(m_values[upperTop] < m_values[lowerTop])) {
+        return;
+    }
+    place(false, 0U, upperTop);
+    place(true, 0U, lowerTop);
+    siftDown(false, 0U);
+    siftDown(true, 0U);
+}
+
+}  // namespace temperature
+
+#endif  // SLIDING_MEDIAN_HPP
@@ -2,21 +2,38 @@
 #define TEMPERATURE_FILTER_HPP
 
 #include <cstdint>
+#include <cstddef>
 #include <array>
 
 namespace temperature {
 
 /// @brief Moving average filter for temperature readings
-/// @details Smooths noisy ADC readings over a configurable window
-template<uint8_t WINDOW_SIZE = 4U>
+/// @details Smooths noisy ADC readings over a configurable window.
+///          Readings are stored in fixed point (1/1024 degC) and a running
+///          integer sum is updated in addReading(), so getFiltered() is O(1)
+///          and the sum never drifts, however long the filter runs.
+template<uint16_t WINDOW_SIZE = 4U>
 class TemperatureFilter {
 public:
+    static_assert(WINDOW_SIZE > 0U, "Window must hold at least one sample");
+
+    /// @brief Fraction bits of the stored readings (resolution 1/1024 degC)
+    static constexpr uint8_t FRACTION_BITS = 10U;
+
     TemperatureFilter();
 
     /// @brief Add a new reading to the filter
     /// @param reading Temperature reading in Celsius
     void addReading(float reading);
 
+    /// @brief Add a block of readings, oldest first
+    /// @details Same result as calling addReading() for each reading (the
+    ///          integer sum is exact), but only the last WINDOW_SIZE
+    ///          readings are converted and stored
+    /// @param readings Temperature readings in Celsius
+    /// @param count Number of readings
+    void addReadings(const float* readings, size_t count);
+
     /// @brief Get the filtered (averaged) temperature
     /// @return Average of readings in the window
     float getFiltered() const;
@@ -30,66 +47,119 @@ public:
 
     /// @brief Get number of samples currently in filter
     /// @return Sample count (0 to WINDOW_SIZE)
-    uint8_t getSampleCount() const;
+    uint16_t getSampleCount() const;
 
 private:
-    std::array<float, WINDOW_SIZE> m_readings;
-    uint8_t m_index;
-    uint8_t m_count;
+    static constexpr float SCALE = static_cast<float>(1UL << FRACTION_BITS);
+
+    static int32_t toFixed(float reading);
+
+    std::array<int32_t, WINDOW_SIZE> m_readings;
+    int64_t m_sum;
+    uint16_t m_index;
+    uint16_t m_count;
 };
 
 // ============================================================================
 // Template Implementation
 // ============================================================================
 
-template<uint8_t WINDOW_SIZE>
+template<uint16_t WINDOW_SIZE>
 TemperatureFilter<WINDOW_SIZE>::TemperatureFilter()
     : m_readings{}
+    , m_sum{0}
     , m_index{0U}
     , m_count{0U}
 {
 }
 
-template<uint8_t WINDOW_SIZE>
+template<uint16_t WINDOW_SIZE>
 void TemperatureFilter<WINDOW_SIZE>::addReading(float reading) {
-    m_readings[m_index] = reading;
-    m_index = static_cast<uint8_t>((m_index + 1U) % WINDOW_SIZE);
-    
+    const int32_t sample = toFixed(reading);
+
     if (m_count < WINDOW_SIZE) {
         ++m_count;
+    } else {
+        m_sum -= m_readings[m_index];  // Evict the oldest sample
+    }
+
+    m_readings[m_index] = sample;
+    m_sum += sample;
+    m_index = static_cast<uint16_t>((m_index + 1U) % WINDOW_SIZE);
+}
+
+template<uint16_t WINDOW_SIZE>
+void TemperatureFilter<WINDOW_SIZE>::addReadings(const float* readings, size_t count) {
+    if (count >= WINDOW_SIZE) {
+        // The block replaces the whole window: refill from index 0
+        const float* window = readings + (count - WINDOW_SIZE);
+        int64_t sum = 0;
+        for (uint16_t i = 0U; i < WINDOW_SIZE; ++i) {
+            m_readings[i] = toFixed(window[i]);
+            sum += m_readings[i];
+        }
+        m_sum = sum;
+        m_index = 0U;
+        m_count = WINDOW_SIZE;
+        return;
+    }
+
+    for (size_t i = 0U; i < count; ++i) {
+        addReading(readings[i]);
     }
 }
 
-template<uint8_t WINDOW_SIZE>
+template<uint16_t WINDOW_SIZE>
 float TemperatureFilter<WINDOW_SIZE>::getFiltered() const {
     if (m_count == 0U) {
         return 0.0F;
     }
-    
-    float sum = 0.0F;
-    for (uint8_t i = 0U; i < m_count; ++i) {
-        sum += m_readings[i];
-    }
-    
-    return sum / static_cast<float>(m_count);
+
+    // Integer division first: a float of the raw sum would lose bits on
+    // long windows
+    const int64_t quotient = m_sum / m_count;
+    const int64_t remainder = m_sum % m_count;
+
+    return (static_cast<float>(quotient)
+            + static_cast<float>(remainder) / static_cast<float>(m_count)) / SCALE;
 }
 
-template<uint8_t WINDOW_SIZE>
+template<uint16_t WINDOW_SIZE>
 bool TemperatureFilter<WINDOW_SIZE>::isReady() const {
     return m_count == WINDOW_SIZE;
 }
 
-template<uint8_t WINDOW_SIZE>
+template<uint16_t WINDOW_SIZE>
 void TemperatureFilter<WINDOW_SIZE>::reset() {
+    m_sum = 0;
     m_index = 0U;
     m_count = 0U;
 }
 
-template<uint8_t WINDOW_SIZE>
-uint8_t TemperatureFilter<WINDOW_SIZE>::getSampleCount() const {
+template<uint16_t WINDOW_SIZE>
+uint16_t TemperatureFilter<WINDOW_SIZE>::getSampleCount() const {
     return m_count;
 }
 
+template<uint16_t WINDOW_SIZE>
+int32_t TemperatureFilter<WINDOW_SIZE>::toFixed(float reading) {
+    // Clamp to the int32_t range (about +/-2 million degC); NaN becomes 0
+    constexpr float LIMIT = 2147483520.0F;  // Largest float below 2^31
+    const float scaled = reading * SCALE;
+
+    if (!(scaled == scaled)) {
+        return 0;
+    }
+    if (scaled >= LIMIT) {
+        return INT32_MAX;
+    }
+    if (scaled <= -LIMIT) {
+        return -INT32_MAX;
+    }
+
+    return static_cast<int32_t>(scaled < 0.0F ? scaled - 0.5F : scaled + 0.5F);
+}
+
 }  // namespace temperature
 
-#endif  // TEMPERATURE_FILTER_HPP
\ No newline at end of file
+#endif  // TEMPERATURE_FILTER_HPP
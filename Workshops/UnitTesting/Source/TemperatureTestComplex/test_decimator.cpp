@@ -0,0 +1,173 @@
+#include "CppUTest/TestHarness.h"
+#include "decimator.hpp"
+
+#include <cmath>
+
+using namespace temperature;
+
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+
+// Largest |output| of a settled decimator fed with a sine of 'cyclesPerOutput'
+template<typename D>
+int32_t settledPeak(D& decimator, double cyclesPerOutput, int32_t amplitude, int32_t offset) {
+    const double step = 2.0 * PI * cyclesPerOutput / decimator.getRatio();
+    int32_t peak = 0;
+    for (int n = 0; n < 64 * decimator.getRatio(); ++n) {
+        const int32_t input = offset + static_cast<int32_t>(std::lround(amplitude * std::sin(step * n)));
+        int32_t output = 0;
+        if (decimator.addSample(input, output) && decimator.isSettled()) {
+            const int32_t deviation = std::abs(output - (offset << D::FRACTION_BITS));
+            peak = deviation > peak ? deviation : peak;
+        }
+    }
+    return peak;
+}
+
+}  // namespace
+
+// ============================================================================
+// Configuration
+// ============================================================================
+
+TEST_GROUP(DecimatorConfig) {
+};
+
+TEST(DecimatorConfig, DefaultRatioIsTheLargest) {
+    Decimator<3U, 8U> decimator;
+    LONGS_EQUAL(16U, decimator.getRatio());
+}
+
+TEST(DecimatorConfig, AcceptsEvenRatiosInRange) {
+    Decimator<3U, 8U> decimator;
+    CHECK_TRUE(decimator.setRatio(4U));
+    LONGS_EQUAL(4U, decimator.getRatio());
+    CHECK_TRUE(decimator.setRatio(2U));
+}
+
+TEST(DecimatorConfig, RejectsOddZeroAndTooLargeRatios) {
+    Decimator<3U, 8U> decimator(8U);
+    CHECK_FALSE(decimator.setRatio(0U));
+    CHECK_FALSE(decimator.setRatio(5U));
+    CHECK_FALSE(decimator.setRatio(18U));
+    LONGS_EQUAL(8U, decimator.getRatio());
+}
+
+// ============================================================================
+// Decimation
+// ============================================================================
+
+TEST_GROUP(Decimator) {
+    Decimator<3U, 8U>* decimator;
+
+    void setup() override {
+        decimator = new Decimator<3U, 8U>(16U);
+    }
+
+    void teardown() override {
+        delete decimator;
+    }
+};
+
+TEST(Decimator, OneOutputPerRatioInputs) {
+    int32_t input[160];
+    int32_t output[11];
+    for (int32_t& sample : input) {
+        sample = 100;
+    }
+
+    LONGS_EQUAL(10U, decimator->process(input, 160U, output));
+    LONGS_EQUAL(0U, decimator->process(input, 15U, output));
+    LONGS_EQUAL(1U, decimator->process(input, 1U, output));
+}
+
+TEST(Decimator, ConstantInputSettlesExactly) {
+    int32_t output = 0;
+    int outputs = 0;
+    for (int n = 0; n < 16 * 20; ++n) {
+        if (decimator->addSample(2048, output)) {
+            ++outputs;
+            if (outputs <= 1) {
+                CHECK_FALSE(decimator->isSettled());
+            }
+        }
+    }
+    CHECK_TRUE(decimator->isSettled());
+    LONGS_EQUAL(2048 << 4, output);
+    DOUBLES_EQUAL(2048.0, decimator->toInputUnits(output), 0.001);
+}
+
+TEST(Decimator, GainsResolutionBelowOneCount) {
+    // Half the readings one count higher: 100.5 counts
+    int32_t output = 0;
+    for (int n = 0; n < 16 * 20; ++n) {
+        decimator->addSample(100 + (n & 1), output);
+    }
+    LONGS_EQUAL(1608, output);
+}
+
+TEST(Decimator, BlockMatchesSingleSamples) {
+    Decimator<3U, 8U> single(16U);
+    int32_t input[333];
+    for (int n = 0; n < 333; ++n) {
+        input[n] = 1000 + ((n * 37) % 101) - 50;
+    }
+
+    int32_t block[24];
+    int32_t singles[24];
+    size_t written = decimator->process(input, 100U, block);
+    written += decimator->process(input + 100, 233U, block + written);
+
+    size_t count = 0U;
+    for (int32_t sample : input) {
+        if (single.addSample(sample, singles[count])) {
+            ++count;
+        }
+    }
+
+    LONGS_EQUAL(count, written);
+    for (size_t i = 0U; i < count; ++i) {
+        LONGS_EQUAL(singles[i], block[i]);
+    }
+}
+
+TEST(Decimator, PassesSlowSignals) {
+    // A tenth of the output rate: CIC droop and half-band ripple stay small
+    const int32_t peak = settledPeak(*decimator, 0.1, 400, 2048);
+    CHECK(peak > (400 << 4) * 9 / 10);
+    CHECK(peak < (400 << 4) * 11 / 10);
+}
+
+TEST(Decimator, RejectsWhatWouldAlias) {
+    // 0.75 x the output rate would fold back to 0.25 x after decimation
+    const int32_t peak = settledPeak(*decimator, 0.75, 400, 2048);
+    CHECK(peak < (400 << 4) / 20);
+}
+
+TEST(Decimator, IntegratorWrapAroundIsHarmless) {
+    // Full-scale 12-bit input: the integrators wrap many times
+    int32_t output = 0;
+    for (int32_t n = 0; n < 200000; ++n) {
+        decimator->addSample(4095, output);
+    }
+    LONGS_EQUAL(4095 << 4, output);
+
+    for (int n = 0; n < 16 * 20; ++n) {
+        decimator->addSample(-4095, output);
+    }
+    LONGS_EQUAL(-(4095 << 4), output);
+}
+
+TEST(Decimator, ResetStartsOver) {
+    int32_t output = 0;
+    for (int n = 0; n < 16 * 20; ++n) {
+        decimator->addSample(500, output);
+    }
+    decimator->reset();
+    CHECK_FALSE(decimator->isSettled());
+    for (int n = 0; n < 16 * 20; ++n) {
+        decimator->addSample(200, output);
+    }
+    LONGS_EQUAL(200 << 4, output);
+}
@@ -0,0 +1,232 @@
+#include "CppUTest/TestHarness.h"
+#include "sliding_median.hpp"
+#include "p2_quantile.hpp"
+#include "PerfBudget.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace temperature;
+
+namespace {
+
+// Reproducible pseudo-random sequence (LCG), -1000 .. 1000
+int32_t nextValue(uint32_t& state) {
+    state = state * 1664525U + 1013904223U;
+    return static_cast<int32_t>((state >> 8) % 2001U) - 1000;
+}
+
+// Median of the last 'window' values by sorting a copy
+int32_t referenceMedian(const std::vector<int32_t>& values, size_t window) {
+    const size_t count = std::min(window, values.size());
+    std::vector<int32_t> last(values.end() - static_cast<std::ptrdiff_t>(count), values.end());
+    std::sort(last.begin(), last.end());
+    const int32_t lower = last[(count - 1U) / 2U];
+    const int32_t upper = last[count / 2U];
+    return lower + (upper - lower) / 2;
+}
+
+template<uint16_t WINDOW>
+void checkAgainstReference(uint32_t seed, int samples) {
+    SlidingMedian<int32_t, WINDOW> median;
+    std::vector<int32_t> values;
+    for (int n = 0; n < samples; ++n) {
+        values.push_back(nextValue(seed));
+        median.addSample(values.back());
+        LONGS_EQUAL(referenceMedian(values, WINDOW), median.getMedian());
+    }
+}
+
+}  // namespace
+
+// ============================================================================
+// Sliding Median
+// ============================================================================
+
+TEST_GROUP(SlidingMedian) {
+};
+
+TEST(SlidingMedian, EmptyWindowGivesZero) {
+    SlidingMedian<int32_t, 5U> median;
+    LONGS_EQUAL(0, median.getMedian());
+    LONGS_EQUAL(0U, median.getSampleCount());
+    CHECK_FALSE(median.isReady());
+}
+
+TEST(SlidingMedian, MedianWhileFilling) {
+    SlidingMedian<int32_t, 5U> median;
+    median.addSample(30);
+    LONGS_EQUAL(30, median.getMedian());
+    median.addSample(10);
+    LONGS_EQUAL(20, median.getMedian());  // Mean of the middle two
+    LONGS_EQUAL(10, median.getLowerMedian());
+    LONGS_EQUAL(30, median.getUpperMedian());
+    median.addSample(20);
+    LONGS_EQUAL(20, median.getMedian());
+    LONGS_EQUAL(3U, median.getSampleCount());
+}
+
+TEST(SlidingMedian, OldestSampleLeavesTheWindow) {
+    SlidingMedian<int32_t, 3U> median;
+    median.addSample(1);
+    median.addSample(2);
+    median.addSample(3);
+    CHECK_TRUE(median.isReady());
+    median.addSample(100);  // Window 2, 3, 100
+    LONGS_EQUAL(3, median.getMedian());
+    median.addSample(100);  // Window 3, 100, 100
+    LONGS_EQUAL(100, median.getMedian());
+}
+
+TEST(SlidingMedian, IgnoresSpikesBelowHalfTheWindow) {
+    // A mean of 7 would move by 1000 / 7 per spike
+    SlidingMedian<int32_t, 7U> median;
+    for (int n = 0; n < 7; ++n) {
+        median.addSample(2150);
+    }
+    median.addSample(3150);
+    median.addSample(-850);
+    median.addSample(3150);
+    LONGS_EQUAL(2150, median.getMedian());
+}
+
+TEST(SlidingMedian, MatchesSortedWindowOddSize) {
+    checkAgainstReference<15U>(1U, 500);
+}
+
+TEST(SlidingMedian, MatchesSortedWindowEvenSize) {
+    checkAgainstReference<8U>(2U, 500);
+}
+
+TEST(SlidingMedian, MatchesSortedWindowWithDuplicates) {
+    SlidingMedian<int32_t, 9U> median;
+    std::vector<int32_t> values;
+    uint32_t seed = 3U;
+    for (int n = 0; n < 300; ++n) {
+        values.push_back(nextValue(seed) / 300);  // Only 7 distinct values
+        median.addSample(values.back());
+        LONGS_EQUAL(referenceMedian(values, 9U), median.getMedian());
+    }
+}
+
+TEST(SlidingMedian, WindowOfOne) {
+    SlidingMedian<int32_t, 1U> median;
+    median.addSample(5);
+    median.addSample(-7);
+    LONGS_EQUAL(-7, median.getMedian());
+}
+
+TEST(SlidingMedian, FloatSamples) {
+    SlidingMedian<float, 4U> median;
+    median.addSample(21.0F);
+    median.addSample(22.0F);
+    median.addSample(85.0F);
+    median.addSample(21.5F);
+    DOUBLES_EQUAL(21.75, median.getMedian(), 0.0001);
+}
+
+TEST(SlidingMedian, ResetEmptiesTheWindow) {
+    SlidingMedian<int32_t, 3U> median;
+    median.addSample(10);
+    median.addSample(20);
+    median.addSample(30);
+    median.reset();
+    LONGS_EQUAL(0U, median.getSampleCount());
+    median.addSample(7);
+    LONGS_EQUAL(7, median.getMedian());
+}
+
+// ============================================================================
+// P-square Quantile
+// ============================================================================
+
+TEST_GROUP(P2Quantile) {
+};
+
+TEST(P2Quantile, ExactForTheFirstSamples) {
+    P2Quantile median(0.5F);
+    DOUBLES_EQUAL(0.0, median.getEstimate(), 0.0);
+    median.addSample(3.0F);
+    median.addSample(1.0F);
+    median.addSample(2.0F);
+    DOUBLES_EQUAL(2.0, median.getEstimate(), 0.0);
+    DOUBLES_EQUAL(1.0, median.getMinimum(), 0.0);
+    DOUBLES_EQUAL(3.0, median.getMaximum(), 0.0);
+}
+
+TEST(P2Quantile, ClampsTheQuantile) {
+    DOUBLES_EQUAL(1.0, P2Quantile(1.5F).getQuantile(), 0.0);
+    DOUBLES_EQUAL(0.0, P2Quantile(-0.5F).getQuantile(), 0.0);
+}
+
+TEST(P2Quantile, ConstantInput) {
+    P2Quantile p95(0.95F);
+    for (int n = 0; n < 1000; ++n) {
+        p95.addSample(36.6F);
+    }
+    DOUBLES_EQUAL(36.6, p95.getEstimate(), 0.0001);
+}
+
+TEST(P2Quantile, TracksPercentilesOfAUniformStream) {
+    const float quantiles[] = {0.1F, 0.5F, 0.9F, 0.99F};
+    for (float quantile : quantiles) {
+        P2Quantile estimator(quantile);
+        uint32_t seed = 4U;
+        for (int n = 0; n < 20000; ++n) {
+            estimator.addSample(static_cast<float>(nextValue(seed)));
+        }
+        // Uniform over -1000 .. 1000
+        DOUBLES_EQUAL(-1000.0 + 2000.0 * quantile, estimator.getEstimate(), 20.0);
+        DOUBLES_EQUAL(-1000.0, estimator.getMinimum(), 0.0);
+        DOUBLES_EQUAL(1000.0, estimator.getMaximum(), 0.0);
+        LONGS_EQUAL(20000U, estimator.getSampleCount());
+    }
+}
+
+TEST(P2Quantile, MedianOfASortedRamp) {
+    // Worst case for the markers: every sample is a new maximum
+    P2Quantile median(0.5F);
+    for (int n = 0; n <= 10000; ++n) {
+        median.addSample(static_cast<float>(n));
+    }
+    DOUBLES_EQUAL(5000.0, median.getEstimate(), 50.0);
+}
+
+TEST(P2Quantile, ResetForgetsAllSamples) {
+    P2Quantile median(0.5F);
+    for (int n = 0; n < 100; ++n) {
+        median.addSample(static_cast<float>(n));
+    }
+    median.reset();
+    LONGS_EQUAL(0U, median.getSampleCount());
+    median.addSample(-4.0F);
+    DOUBLES_EQUAL(-4.0, median.getEstimate(), 0.0);
+}
+
+// ============================================================================
+// Performance Budget
+// ============================================================================
+
+TEST_GROUP(SlidingMedianBudget) {
+    SlidingMedian<int32_t, 1023U> median;
+    P2Quantile p95{0.95F};
+    uint32_t seed = 5U;
+
+    void setup() override {
+        for (uint16_t i = 0U; i < 1023U; ++i) {
+            median.addSample(nextValue(seed));
+        }
+    }
+};
+
+TEST(SlidingMedianBudget, AddSampleIsLogarithmic) {
+    // At most four sifts of 9 levels (a heap of 512); scanning the window
+    // of 1023 would cost several times this budget
+    CHECK_INSTRUCTION_BUDGET(4000, [this]() { median.addSample(nextValue(seed)); });
+}
+
+TEST(SlidingMedianBudget, P2AddSampleStaysSmall) {
+    // Five markers, whatever the number of samples
+    CHECK_INSTRUCTION_BUDGET(1000, [this]() { p95.addSample(static_cast<float>(nextValue(seed))); });
+}
@@ -1,5 +1,6 @@
 #include "CppUTest/TestHarness.h"
 #include "temperature_filter.hpp"
+#include "PerfBudget.hpp"
 
 using namespace temperature;
 
@@ -177,4 +178,132 @@ TEST(TemperatureFilterReset, CanAddReadingsAfterReset) {
     
     DOUBLES_EQUAL(NEW_READING, filter->getFiltered(), 0.01);
     LONGS_EQUAL(1U, filter->getSampleCount());
-}
\ No newline at end of file
+}
+// ============================================================================
+// Running Sum
+// ============================================================================
+
+TEST_GROUP(TemperatureFilterRunningSum) {
+};
+
+TEST(TemperatureFilterRunningSum, AverageTracksWrappedWindow) {
+    TemperatureFilter<3U> filter;
+
+    for (int i = 1; i <= 7; ++i) {
+        filter.addReading(static_cast<float>(i));
+    }
+
+    // Window holds [7, 5, 6] after wrapping twice
+    DOUBLES_EQUAL(6.0, filter.getFiltered(), 0.01);
+}
+
+TEST(TemperatureFilterRunningSum, NoDriftAfterManyReadings) {
+    TemperatureFilter<4U> filter;
+
+    for (uint32_t i = 0U; i < 100000U; ++i) {
+        filter.addReading((i % 2U == 0U) ? 20.1F : 19.9F);
+    }
+    filter.addReading(21.3F);
+    filter.addReading(21.3F);
+    filter.addReading(21.3F);
+    filter.addReading(21.3F);
+
+    DOUBLES_EQUAL(21.3, filter.getFiltered(), 0.001);
+}
+
+TEST(TemperatureFilterRunningSum, WindowLargerThan255) {
+    TemperatureFilter<1000U> filter;
+
+    for (uint16_t i = 0U; i < 999U; ++i) {
+        filter.addReading(10.0F);
+    }
+    CHECK_FALSE(filter.isReady());
+
+    filter.addReading(1010.0F);
+
+    CHECK_TRUE(filter.isReady());
+    LONGS_EQUAL(1000U, filter.getSampleCount());
+    DOUBLES_EQUAL(11.0, filter.getFiltered(), 0.01);
+}
+
+TEST(TemperatureFilterRunningSum, ResetClearsSum) {
+    TemperatureFilter<4U> filter;
+    filter.addReading(80.0F);
+    filter.reset();
+
+    filter.addReading(20.0F);
+
+    DOUBLES_EQUAL(20.0, filter.getFiltered(), 0.01);
+}
+
+// ============================================================================
+// Block Readings
+// ============================================================================
+
+TEST_GROUP(TemperatureFilterBlock) {
+};
+
+TEST(TemperatureFilterBlock, ShortBlockMatchesSingleReadings) {
+    const float readings[] = {20.0F, 21.5F, 19.25F};
+    TemperatureFilter<4U> block;
+    TemperatureFilter<4U> single;
+
+    block.addReading(30.0F);
+    single.addReading(30.0F);
+    block.addReadings(readings, 3U);
+    for (float reading : readings) {
+        single.addReading(reading);
+    }
+
+    LONGS_EQUAL(single.getSampleCount(), block.getSampleCount());
+    CHECK_EQUAL(single.getFiltered(), block.getFiltered());
+}
+
+TEST(TemperatureFilterBlock, LongBlockMatchesSingleReadings) {
+    float readings[37];
+    for (int i = 0; i < 37; ++i) {
+        readings[i] = 18.0F + 0.37F * static_cast<float>(i % 11);
+    }
+    TemperatureFilter<8U> block;
+    TemperatureFilter<8U> single;
+
+    block.addReadings(readings, 37U);
+    for (float reading : readings) {
+        single.addReading(reading);
+    }
+    CHECK_EQUAL(single.getFiltered(), block.getFiltered());
+
+    // Eviction order continues correctly after the block
+    block.addReading(40.0F);
+    single.addReading(40.0F);
+    CHECK_EQUAL(single.getFiltered(), block.getFiltered());
+}
+
+// ============================================================================
+// Performance Budget
+// ============================================================================
+
+TEST_GROUP(TemperatureFilterBudget) {
+    TemperatureFilter<4U> small;
+    TemperatureFilter<1024U> large;
+};
+
+TEST(TemperatureFilterBudget, AddReadingStaysSmall) {
+    // About 15 instructions with -O2 and 145 without optimisation
+    CHECK_INSTRUCTION_BUDGET(250, [this]() { small.addReading(21.5F); });
+    CHECK_INSTRUCTION_BUDGET(250, [this]() { large.addReading(21.5F); });
+}
+
+TEST(TemperatureFilterBudget, AddReadingIsConstantTime) {
+    CHECK_CONSTANT_COST([this]() { small.addReading(21.5F); }, [this]() { large.addReading(21.5F); });
+}
+
+TEST(TemperatureFilterBudget, GetFilteredIsConstantTime) {
+    for (uint16_t i = 0U; i < 1024U; ++i) {
+        small.addReading(20.0F);
+        large.addReading(20.0F);
+    }
+
+    CHECK_CONSTANT_COST([this]() { perf_budget::keep(small.getFiltered()); },
+                        [this]() { perf_budget::keep(large.getFiltered()); });
+}
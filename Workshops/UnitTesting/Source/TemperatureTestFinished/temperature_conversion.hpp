@@ -2,6 +2,7 @@
 #define TEMPERATURE_CONVERSION_HPP
 
 #include <cstdint>
+#include <cstddef>
 
 namespace temperature {  // <-- This line
 
@@ -10,8 +11,26 @@ struct SensorConfig {
     static constexpr float TEMP_MIN_CELSIUS = -40.0F;
     static constexpr float TEMP_MAX_CELSIUS = 85.0F;
     static constexpr float TEMP_RANGE_CELSIUS = TEMP_MAX_CELSIUS - TEMP_MIN_CELSIUS;
+
+    // Same range in centi-degrees, for the integer-only path
+    static constexpr int16_t TEMP_MIN_CENTI = -4000;
+    static constexpr int16_t TEMP_RANGE_CENTI = 12500;
 };
 
+/// @brief Convert ADC counts to centi-degrees Celsius (2150 = 21.50 C)
+/// @details Table lookup, no floating point. The table is generated at
+///          compile time as a constexpr std::array (C++14 or later). On
+///          ARM Cortex-M and on the host it stays in flash/.rodata (8 KB);
+///          AVR has neither <array> nor const data in flash without
+///          PROGMEM, so this path is not meant for AVR. Values above
+///          ADC_MAX_VALUE are clamped.
+int16_t adcToCentiCelsius(uint16_t adcValue);
+
+/// @brief Convert a block of ADC counts, e.g. a DMA buffer
+void adcToCentiCelsius(const uint16_t* adcValues, int16_t* centiCelsius, size_t count);
+
+/// @brief Convert ADC counts to degrees Celsius (wraps adcToCentiCelsius,
+///        so values above ADC_MAX_VALUE are clamped to TEMP_MAX_CELSIUS)
 float adcToCelsius(uint16_t adcValue);
 bool isInValidRange(float celsius);
 float celsiusToFahrenheit(float celsius);
@@ -40,6 +40,50 @@ TEST(AdcToCelsius, RoomTemperatureAdcValue) {
     DOUBLES_EQUAL(EXPECTED_ROOM_TEMP, adcToCelsius(ADC_ROOM_TEMP), 0.5);
 }
 
+TEST(AdcToCelsius, ClampsAboveAdcMax) {
+    DOUBLES_EQUAL(SensorConfig::TEMP_MAX_CELSIUS, adcToCelsius(0xFFFFU), 0.01);
+}
+
+// ============================================================================
+// ADC to Centi-Celsius (integer path)
+// ============================================================================
+
+TEST_GROUP(AdcToCentiCelsius) {
+};
+
+TEST(AdcToCentiCelsius, EndpointsAreExact) {
+    LONGS_EQUAL(-4000, adcToCentiCelsius(0U));
+    LONGS_EQUAL(8500, adcToCentiCelsius(SensorConfig::ADC_MAX_VALUE));
+}
+
+TEST(AdcToCentiCelsius, RoundsToNearestCentiDegree) {
+    // 1966 / 4095 * 125 - 40 = 20.0122 C
+    LONGS_EQUAL(2001, adcToCentiCelsius(1966U));
+}
+
+TEST(AdcToCentiCelsius, ClampsAboveAdcMax) {
+    LONGS_EQUAL(8500, adcToCentiCelsius(0xFFFFU));
+}
+
+TEST(AdcToCentiCelsius, BatchMatchesSingleConversion) {
+    const uint16_t adc[] = {0U, 1U, 1000U, 2047U, 4094U, 4095U};
+    int16_t centi[6] = {};
+
+    adcToCentiCelsius(adc, centi, 6U);
+
+    for (size_t i = 0U; i < 6U; ++i) {
+        LONGS_EQUAL(adcToCentiCelsius(adc[i]), centi[i]);
+    }
+}
+
+TEST(AdcToCentiCelsius, MatchesFloatFormulaEverywhere) {
+    for (uint16_t adc = 0U; adc <= SensorConfig::ADC_MAX_VALUE; ++adc) {
+        const double exact = (static_cast<double>(adc) / SensorConfig::ADC_MAX_VALUE)
+                           * SensorConfig::TEMP_RANGE_CELSIUS + SensorConfig::TEMP_MIN_CELSIUS;
+        DOUBLES_EQUAL(exact, adcToCelsius(adc), 0.005);
+    }
+}
+
 // ============================================================================
 // Temperature Range Validation
 // ============================================================================
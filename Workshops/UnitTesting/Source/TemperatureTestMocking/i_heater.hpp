@@ -20,6 +20,22 @@ public:
     virtual bool isOn() const = 0;
 };
 
+/// @brief Heater with a power level instead of only on/off
+/// @details The output is switched by hardware (e.g. a timer window, see
+///          TimeProportioningHeater): the controller sets a duty cycle once
+///          per update instead of toggling the heater itself. turnOn() and
+///          turnOff() mean full and zero power.
+class IProportionalHeater : public IHeater {
+public:
+    /// @brief Set heater power
+    /// @param duty Fraction of the time the heater is on, 0.0 to 1.0
+    virtual void setDutyCycle(float duty) = 0;
+
+    /// @brief Get heater power
+    /// @return Duty cycle as applied by the output, 0.0 to 1.0
+    virtual float getDutyCycle() const = 0;
+};
+
 }  // namespace temperature
 
 #endif  // I_HEATER_HPP
\ No newline at end of file
@@ -0,0 +1,36 @@
+#ifndef I_PWM_TIMER_HPP
+#define I_PWM_TIMER_HPP
+
+#include <cstdint>
+
+namespace temperature {
+
+/// @brief Interface for a hardware timer in slow PWM mode
+/// @details The timer counts through a fixed window (e.g. 1 s for a relay,
+///          100 ms for an SSR) and drives the heater pin itself: high from
+///          the start of the window until the compare value, low for the
+///          rest. On an STM32 or SAMD21 that is a timer channel in PWM mode
+///          with a preloaded compare register, so a new value takes effect
+///          at the next window and never cuts a pulse short. The CPU only
+///          writes the compare value.
+class IPwmTimer {
+public:
+    virtual ~IPwmTimer() = default;
+
+    /// @brief Get the window length
+    /// @return Timer ticks per window, > 0
+    virtual uint32_t getPeriodTicks() const = 0;
+
+    /// @brief Set the on time, applied from the next window
+    /// @param onTicks Ticks high per window, 0 (always low) to
+    ///        getPeriodTicks() (always high)
+    virtual void setCompare(uint32_t onTicks) = 0;
+
+    /// @brief Check the pin the timer drives
+    /// @return true if the output is high now
+    virtual bool isOutputHigh() const = 0;
+};
+
+}  // namespace temperature
+
+#endif  // I_PWM_TIMER_HPP
@@ -0,0 +1,36 @@
+#ifndef I_ZONE_IO_HPP
+#define I_ZONE_IO_HPP
+
+#include <cstddef>
+
+namespace temperature {
+
+/// @brief Interface for a bank of temperature sensors read in one go
+/// @details One virtual call per control sweep instead of one per zone,
+///          e.g. a multiplexed ADC scan or a DMA buffer
+class ISensorBank {
+public:
+    virtual ~ISensorBank() = default;
+
+    /// @brief Read all sensors
+    /// @param temperatures Output, degrees Celsius per zone
+    /// @param healthy Output, sensor health per zone
+    /// @param count Number of zones
+    virtual void readAll(float* temperatures, bool* healthy, size_t count) = 0;
+};
+
+/// @brief Interface for a bank of heaters written in one go
+/// @details E.g. a shift register or one GPIO port write
+class IHeaterBank {
+public:
+    virtual ~IHeaterBank() = default;
+
+    /// @brief Set all heater outputs
+    /// @param on Requested state per zone
+    /// @param count Number of zones
+    virtual void writeAll(const bool* on, size_t count) = 0;
+};
+
+}  // namespace temperature
+
+#endif  // I_ZONE_IO_HPP
@@ -0,0 +1,77 @@
+#ifndef MOCK_PWM_TIMER_HPP
+#define MOCK_PWM_TIMER_HPP
+
+#include "i_pwm_timer.hpp"
+#include <cstdint>
+
+namespace temperature {
+namespace test {
+
+/// @brief Manual mock for testing
+/// @details Counts like the hardware: advance() moves the counter, a new
+///          compare value is taken over at the start of a window.
+class MockPwmTimer : public IPwmTimer {
+public:
+    explicit MockPwmTimer(uint32_t periodTicks = 1000U)
+        : m_periodTicks{periodTicks}
+        , m_counter{0U}
+        , m_compare{0U}
+        , m_pending{0U}
+        , m_writeCount{0U}
+    {
+    }
+
+    uint32_t getPeriodTicks() const override {
+        return m_periodTicks;
+    }
+
+    void setCompare(uint32_t onTicks) override {
+        m_pending = onTicks;
+        ++m_writeCount;
+    }
+
+    bool isOutputHigh() const override {
+        return m_counter < m_compare;
+    }
+
+    // Test control methods
+    void advance(uint32_t ticks) {
+        for (uint32_t i = 0U; i < ticks; ++i) {
+            if (++m_counter == m_periodTicks) {
+                m_counter = 0U;
+                m_compare = m_pending;
+            }
+        }
+    }
+
+    /// @brief Ticks high over the next windows, counter advanced
+    uint32_t countHighTicks(uint32_t ticks) {
+        uint32_t high = 0U;
+        for (uint32_t i = 0U; i < ticks; ++i) {
+            high += isOutputHigh() ? 1U : 0U;
+            advance(1U);
+        }
+        return high;
+    }
+
+    // Test inspection methods
+    uint32_t getPendingCompare() const {
+        return m_pending;
+    }
+
+    uint32_t getWriteCount() const {
+        return m_writeCount;
+    }
+
+private:
+    uint32_t m_periodTicks;
+    uint32_t m_counter;
+    uint32_t m_compare;
+    uint32_t m_pending;
+    uint32_t m_writeCount;
+};
+
+}  // namespace test
+}  // namespace temperature
+
+#endif  // MOCK_PWM_TIMER_HPP
@@ -0,0 +1,84 @@
+#ifndef MOCK_ZONE_IO_HPP
+#define MOCK_ZONE_IO_HPP
+
+#include "i_zone_io.hpp"
+#include <array>
+#include <cstdint>
+
+namespace temperature {
+namespace test {
+
+/// @brief Manual mock for testing
+template<size_t N>
+class MockSensorBank : public ISensorBank {
+public:
+    MockSensorBank()
+        : m_temperatures{}
+        , m_readCount{0U}
+    {
+        m_temperatures.fill(20.0F);
+        m_healthy.fill(true);
+    }
+
+    void readAll(float* temperatures, bool* healthy, size_t count) override {
+        ++m_readCount;
+        for (size_t i = 0U; i < count && i < N; ++i) {
+            temperatures[i] = m_temperatures[i];
+            healthy[i] = m_healthy[i];
+        }
+    }
+
+    // Test control methods
+    void setTemperature(size_t zone, float temperature) {
+        m_temperatures[zone] = temperature;
+    }
+
+    void setHealthy(size_t zone, bool healthy) {
+        m_healthy[zone] = healthy;
+    }
+
+    uint32_t getReadCount() const {
+        return m_readCount;
+    }
+
+private:
+    std::array<float, N> m_temperatures;
+    std::array<bool, N> m_healthy;
+    uint32_t m_readCount;
+};
+
+/// @brief Manual mock for testing
+template<size_t N>
+class MockHeaterBank : public IHeaterBank {
+public:
+    MockHeaterBank()
+        : m_on{}
+        , m_writeCount{0U}
+    {
+    }
+
+    void writeAll(const bool* on, size_t count) override {
+        ++m_writeCount;
+        for (size_t i = 0U; i < count && i < N; ++i) {
+            m_on[i] = on[i];
+        }
+    }
+
+    // Test inspection methods
+    bool isOn(size_t zone) const {
+        return m_on[zone];
+    }
+
+    uint32_t getWriteCount() const {
+        return m_writeCount;
+    }
+
+private:
+    std::array<bool, N> m_on;
+    uint32_t m_writeCount;
+};
+
+}  // namespace test
+}  // namespace temperature
+
+#endif  // MOCK_ZONE_IO_HPP
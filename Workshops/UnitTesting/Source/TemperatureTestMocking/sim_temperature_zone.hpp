@@ -0,0 +1,107 @@
+#ifndef SIM_TEMPERATURE_ZONE_HPP
+#define SIM_TEMPERATURE_ZONE_HPP
+
+#include "i_temperature_sensor.hpp"
+#include "i_heater.hpp"
+#include "Simulation.hpp"
+#include <cstdint>
+#include <random>
+
+namespace temperature {
+namespace test {
+
+/// @brief Sensor that reads a simulated thermal plant
+/// @details Unlike MockTemperatureSensor the reading follows virtual time:
+///          the temperature the plant has reached at the simulator's now(),
+///          plus optional Gaussian noise (fixed seed, so runs repeat).
+class SimTemperatureSensor : public ITemperatureSensor {
+public:
+    /// @brief Construct sensor on a plant (caller owns lifetime)
+    /// @param plant Simulated plant
+    /// @param noiseRmsC Noise added to each reading in Celsius (0 = none)
+    /// @param seed Noise generator seed
+    explicit SimTemperatureSensor(simulation::ThermalPlant& plant,
+                                  float noiseRmsC = 0.0F,
+                                  uint32_t seed = 1U)
+        : m_plant{plant}
+        , m_noiseRmsC{noiseRmsC}
+        , m_random{seed}
+        , m_isHealthy{true}
+    {
+    }
+
+    float read() override {
+        float reading = static_cast<float>(m_plant.getTemperatureC());
+        if (m_noiseRmsC > 0.0F) {
+            reading += m_noiseRmsC * m_noise(m_random);
+        }
+        return reading;
+    }
+
+    bool isHealthy() const override {
+        return m_isHealthy;
+    }
+
+    // Test configuration methods
+    void setHealthy(bool healthy) {
+        m_isHealthy = healthy;
+    }
+
+private:
+    simulation::ThermalPlant& m_plant;
+    float m_noiseRmsC;
+    std::mt19937 m_random;
+    std::normal_distribution<float> m_noise{0.0F, 1.0F};
+    bool m_isHealthy;
+};
+
+/// @brief Heater that drives a simulated thermal plant
+/// @details Counts real on/off transitions (repeated turnOn() calls while
+///          on are not a switch), the figure that wears out a relay.
+class SimHeater : public IHeater {
+public:
+    /// @brief Construct heater on a plant (caller owns lifetime)
+    /// @param plant Simulated plant
+    explicit SimHeater(simulation::ThermalPlant& plant)
+        : m_plant{plant}
+        , m_isOn{false}
+        , m_switchCount{0U}
+    {
+        m_plant.setHeater(false);
+    }
+
+    void turnOn() override {
+        set(true);
+    }
+
+    void turnOff() override {
+        set(false);
+    }
+
+    bool isOn() const override {
+        return m_isOn;
+    }
+
+    // Test inspection methods
+    uint32_t getSwitchCount() const {
+        return m_switchCount;
+    }
+
+private:
+    void set(bool on) {
+        if (on != m_isOn) {
+            m_isOn = on;
+            ++m_switchCount;
+            m_plant.setHeater(on);
+        }
+    }
+
+    simulation::ThermalPlant& m_plant;
+    bool m_isOn;
+    uint32_t m_switchCount;
+};
+
+}  // namespace test
+}  // namespace temperature
+
+#endif  // SIM_TEMPERATURE_ZONE_HPP
@@ -0,0 +1,95 @@
+#ifndef STATIC_INTERFACE_HPP
+#define STATIC_INTERFACE_HPP
+
+#include <type_traits>
+#include <utility>
+
+#if defined(__cpp_concepts) && __cpp_concepts >= 201907L
+#include <concepts>
+#define TEMPERATURE_HAS_CONCEPTS 1
+#endif
+
+namespace temperature {
+
+/// @brief Compile-time versions of ITemperatureSensor and IHeater
+/// @details A component written against a type parameter instead of an
+///          interface reference can be instantiated two ways from the same
+///          source:
+///          - with the interface types: virtual calls, mocks injected at
+///            run time (unit tests)
+///          - with the concrete types: direct calls the compiler can
+///            inline, no vtable needed (production)
+///          The traits below state what such a type must provide, so a
+///          wrong type fails with one readable static_assert instead of
+///          an error deep inside the template. The interfaces themselves
+///          satisfy them, and so does every class implementing them.
+///          With C++20 the same requirements are also named concepts.
+
+namespace detail {
+
+template<typename T, typename = void>
+struct IsTemperatureSensor : std::false_type {};
+
+template<typename T>
+struct IsTemperatureSensor<T, std::void_t<
+    decltype(static_cast<float>(std::declval<T&>().read())),
+    decltype(static_cast<bool>(std::declval<const T&>().isHealthy()))>> : std::true_type {};
+
+template<typename T, typename = void>
+struct IsHeater : std::false_type {};
+
+template<typename T>
+struct IsHeater<T, std::void_t<
+    decltype(std::declval<T&>().turnOn()),
+    decltype(std::declval<T&>().turnOff()),
+    decltype(static_cast<bool>(std::declval<const T&>().isOn()))>> : std::true_type {};
+
+template<typename T, typename = void>
+struct IsProportionalHeater : std::false_type {};
+
+template<typename T>
+struct IsProportionalHeater<T, std::void_t<
+    decltype(std::declval<T&>().setDutyCycle(0.0F)),
+    decltype(static_cast<float>(std::declval<const T&>().getDutyCycle()))>> : IsHeater<T> {};
+
+}  // namespace detail
+
+/// @brief true if T has float read() and bool isHealthy() const
+template<typename T>
+constexpr bool IsTemperatureSensorV = detail::IsTemperatureSensor<T>::value;
+
+/// @brief true if T has turnOn(), turnOff() and bool isOn() const
+template<typename T>
+constexpr bool IsHeaterV = detail::IsHeater<T>::value;
+
+/// @brief true if T is a heater with setDutyCycle(float) and
+///        float getDutyCycle() const (the output does the time proportioning)
+template<typename T>
+constexpr bool IsProportionalHeaterV = detail::IsProportionalHeater<T>::value;
+
+#if defined(TEMPERATURE_HAS_CONCEPTS)
+
+template<typename T>
+concept TemperatureSensor = requires(T& sensor, const T& constSensor) {
+    { sensor.read() } -> std::convertible_to<float>;
+    { constSensor.isHealthy() } -> std::convertible_to<bool>;
+};
+
+template<typename T>
+concept Heater = requires(T& heater, const T& constHeater) {
+    heater.turnOn();
+    heater.turnOff();
+    { constHeater.isOn() } -> std::convertible_to<bool>;
+};
+
+template<typename T>
+concept ProportionalHeater = Heater<T> && requires(T& heater, const T& constHeater) {
+    heater.setDutyCycle(0.0F);
+    { constHeater.getDutyCycle() } -> std::convertible_to<float>;
+};
+
+#endif
+
+}  // namespace temperature
+
+#endif  // STATIC_INTERFACE_HPP
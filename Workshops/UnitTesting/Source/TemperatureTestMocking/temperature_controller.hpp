@@ -3,31 +3,81 @@
 
 #include "i_temperature_sensor.hpp"
 #include "i_heater.hpp"
+#include "static_interface.hpp"
+#include <cstddef>
+#include <cstdint>
 
 namespace temperature {
 
+/// @brief Control law used by TemperatureController
+enum class ControlMode : uint8_t {
+    OnOff,      ///< Bang-bang with hysteresis
+    Pid         ///< PID with time-proportioned heater output
+};
+
 /// @brief Controller configuration
 struct ControllerConfig {
     float setpoint = 20.0F;       ///< Target temperature in Celsius
     float hysteresis = 1.0F;      ///< Dead band to prevent oscillation
+
+    ControlMode mode = ControlMode::OnOff;
+    float kp = 0.5F;              ///< PID: duty per degree of error
+    float ki = 0.0F;              ///< PID: duty per degree-second of error
+    float kd = 0.0F;              ///< PID: duty per degree/second of change
+    float samplePeriodS = 0.001F; ///< PID: time between update() calls
+    uint8_t derivativeFilterShift = 3U;  ///< PID: measurement EMA, alpha = 1/2^shift
+    uint16_t pwmPeriodTicks = 1000U;     ///< PID: updates per heater on/off window (on/off heaters only)
 };
 
-/// @brief Simple on/off temperature controller
-/// @details Uses hysteresis to prevent rapid switching
-class TemperatureController {
+/// @brief On/off or PID temperature controller
+/// @tparam Sensor Sensor type: ITemperatureSensor (virtual, any implementation)
+///         or a concrete class (direct calls, e.g. a final production driver)
+/// @tparam Heater Heater type: IHeater or a concrete class
+/// @details Use TemperatureController for the virtual version; it is
+///          compiled once in temperature_controller.cpp. Production code
+///          may instantiate BasicTemperatureController<AdcSensor, GpioHeater>
+///          from the same source and lose every virtual call.
+///          On/off mode uses hysteresis to prevent rapid switching.
+///          PID mode runs in Q16.16 fixed point (the float sensor reading is
+///          converted once per update, the rest is integer math) with
+///          integral anti-windup and the derivative taken on the filtered
+///          measurement, so setpoint changes give no derivative kick. The
+///          integral accumulates ki * dt * error in Q32.32: at a 1 kHz
+///          update rate a Q16.16 step would truncate to 0. The
+///          duty cycle drives the on/off IHeater by time proportioning:
+///          on for duty * pwmPeriodTicks updates out of every pwmPeriodTicks.
+///          A heater that takes a duty cycle itself (IsProportionalHeaterV,
+///          e.g. TimeProportioningHeater on a hardware timer) gets it once
+///          per update instead, and update() only has to run at the
+///          control rate.
+template<typename Sensor = ITemperatureSensor, typename Heater = IHeater>
+class BasicTemperatureController {
 public:
+    static_assert(IsTemperatureSensorV<Sensor>, "Sensor needs float read() and bool isHealthy() const");
+    static_assert(IsHeaterV<Heater>, "Heater needs turnOn(), turnOff() and bool isOn() const");
+
     /// @brief Construct controller with injected dependencies
     /// @param sensor Temperature sensor (caller owns lifetime)
     /// @param heater Heater output (caller owns lifetime)
     /// @param config Controller configuration
-    TemperatureController(ITemperatureSensor& sensor, 
-                          IHeater& heater,
-                          const ControllerConfig& config = ControllerConfig{});
+    BasicTemperatureController(Sensor& sensor,
+                               Heater& heater,
+                               const ControllerConfig& config = ControllerConfig{});
 
     /// @brief Run one control cycle
     /// @details Reads sensor, decides heater state
     void update();
 
+    /// @brief Run the control law over a block of readings
+    /// @details For backfilling from a sample buffer (e.g. DMA ADC): the
+    ///          readings are taken from 'readings' instead of the sensor, and
+    ///          the heater is switched at most once. The final heater state is
+    ///          the same as calling update() once per reading.
+    /// @param readings Temperatures in Celsius, oldest first
+    /// @param count Number of readings (0 leaves everything unchanged)
+    /// @return Heater state after the block
+    bool updateBatch(const float* readings, size_t count);
+
     /// @brief Get current setpoint
     /// @return Target temperature in Celsius
     float getSetpoint() const;
@@ -44,14 +94,302 @@ public:
     /// @return Last read temperature in Celsius
     float getLastReading() const;
 
+    /// @brief Get PID output
+    /// @return Duty cycle 0.0 to 1.0 (always 0.0 in on/off mode)
+    float getDutyCycle() const;
+
 private:
-    ITemperatureSensor& m_sensor;
-    IHeater& m_heater;
+    using Q16 = int32_t;  ///< Q16.16 fixed point, 1.0 == 65536
+    using Q32 = int64_t;  ///< Q32.32 fixed point, 1.0 == 2^32
+
+    static constexpr Q16 Q16_ONE = 65536;
+    static constexpr Q32 Q32_ONE = static_cast<Q32>(1) << 32;
+
+    static Q16 toQ16(float value);
+    static Q32 toQ32(float value);
+    static Q16 mulQ16(Q16 a, Q16 b);
+    static Q32 mulQ32(Q32 a, Q16 b);
+
+    void controlOnOff(float reading);
+    void controlPid(float reading);
+    void applyTimeProportioned();
+    void resetPid();
+
+    Sensor& m_sensor;
+    Heater& m_heater;
     ControllerConfig m_config;
     float m_lastReading;
     bool m_inFault;
+
+    // PID state, gains pre-scaled by the sample period
+    Q16 m_setpointQ16;
+    Q16 m_kp;
+    Q32 m_kiDt;
+    Q16 m_kdOverDt;
+    Q32 m_integral;
+    Q16 m_filtered;
+    Q16 m_duty;
+    uint16_t m_pwmTick;
+    bool m_pidPrimed;
 };
 
+/// @brief Controller on the interfaces: mocks, simulations and drivers
+///        can be swapped at run time
+using TemperatureController = BasicTemperatureController<ITemperatureSensor, IHeater>;
+
+/// @brief Controller on the interfaces for heaters with a duty-cycle
+///        input: PID output goes to IProportionalHeater::setDutyCycle()
+using ProportionalTemperatureController = BasicTemperatureController<ITemperatureSensor, IProportionalHeater>;
+
+// ============================================================================
+// Template Implementation
+// ============================================================================
+
+namespace detail {
+
+constexpr float Q16_SCALE = 65536.0F;
+constexpr float Q16_LIMIT = 2147483520.0F;  // Largest float below 2^31
+constexpr float Q32_SCALE = 4294967296.0F;
+constexpr float Q32_LIMIT = 32767.0F;        // |ki * dt| per update, keeps mulQ32() in 64 bits
+
+}  // namespace detail
+
+template<typename Sensor, typename Heater>
+BasicTemperatureController<Sensor, Heater>::BasicTemperatureController(Sensor& sensor,
+                                                                  Heater& heater,
+                                                                  const ControllerConfig& config)
+    : m_sensor{sensor}
+    , m_heater{heater}
+    , m_config{config}
+    , m_lastReading{0.0F}
+    , m_inFault{false}
+    , m_setpointQ16{toQ16(config.setpoint)}
+    , m_kp{toQ16(config.kp)}
+    , m_kiDt{toQ32(config.ki * config.samplePeriodS)}
+    , m_kdOverDt{toQ16(config.samplePeriodS > 0.0F ? config.kd / config.samplePeriodS : 0.0F)}
+    , m_integral{0}
+    , m_filtered{0}
+    , m_duty{0}
+    , m_pwmTick{0U}
+    , m_pidPrimed{false}
+{
+    if (m_config.pwmPeriodTicks == 0U) {
+        m_config.pwmPeriodTicks = 1U;
+    }
+}
+
+template<typename Sensor, typename Heater>
+void BasicTemperatureController<Sensor, Heater>::update() {
+    if (!m_sensor.isHealthy()) {
+        m_inFault = true;
+        resetPid();
+        m_heater.turnOff();
+        return;
+    }
+
+    m_inFault = false;
+    m_lastReading = m_sensor.read();
+
+    if (m_config.mode == ControlMode::Pid) {
+        controlPid(m_lastReading);
+    } else {
+        controlOnOff(m_lastReading);
+    }
+}
+
+template<typename Sensor, typename Heater>
+bool BasicTemperatureController<Sensor, Heater>::updateBatch(const float* readings, size_t count) {
+    if (!m_sensor.isHealthy()) {
+        m_inFault = true;
+        resetPid();
+        m_heater.turnOff();
+        return false;
+    }
+
+    m_inFault = false;
+    if (count == 0U) {
+        return m_heater.isOn();
+    }
+    m_lastReading = readings[count - 1U];
+
+    if (m_config.mode == ControlMode::Pid) {
+        // PID state and PWM phase advance every sample: no shortcut
+        for (size_t i = 0U; i < count; ++i) {
+            controlPid(readings[i]);
+        }
+        return m_heater.isOn();
+    }
+
+    // Readings inside the hysteresis band keep the previous state, so only
+    // the newest reading outside the band decides: search backwards
+    for (size_t i = count; i > 0U; --i) {
+        const float error = m_config.setpoint - readings[i - 1U];
+
+        if (error > m_config.hysteresis) {
+            m_heater.turnOn();
+            break;
+        }
+        if (error < -m_config.hysteresis) {
+            m_heater.turnOff();
+            break;
+        }
+    }
+
+    return m_heater.isOn();
+}
+
+template<typename Sensor, typename Heater>
+float BasicTemperatureController<Sensor, Heater>::getSetpoint() const {
+    return m_config.setpoint;
+}
+
+template<typename Sensor, typename Heater>
+void BasicTemperatureController<Sensor, Heater>::setSetpoint(float setpoint) {
+    m_config.setpoint = setpoint;
+    m_setpointQ16 = toQ16(setpoint);
+}
+
+template<typename Sensor, typename Heater>
+bool BasicTemperatureController<Sensor, Heater>::isInFault() const {
+    return m_inFault;
+}
+
+template<typename Sensor, typename Heater>
+float BasicTemperatureController<Sensor, Heater>::getLastReading() const {
+    return m_lastReading;
+}
+
+template<typename Sensor, typename Heater>
+float BasicTemperatureController<Sensor, Heater>::getDutyCycle() const {
+    return static_cast<float>(m_duty) / detail::Q16_SCALE;
+}
+
+template<typename Sensor, typename Heater>
+typename BasicTemperatureController<Sensor, Heater>::Q16 BasicTemperatureController<Sensor, Heater>::toQ16(float value) {
+    const float scaled = value * detail::Q16_SCALE;
+
+    if (scaled >= detail::Q16_LIMIT) {
+        return INT32_MAX;
+    }
+    if (scaled <= -detail::Q16_LIMIT) {
+        return -INT32_MAX;
+    }
+    return static_cast<Q16>(scaled < 0.0F ? scaled - 0.5F : scaled + 0.5F);
+}
+
+template<typename Sensor, typename Heater>
+typename BasicTemperatureController<Sensor, Heater>::Q32 BasicTemperatureController<Sensor, Heater>::toQ32(float value) {
+    if (value >= detail::Q32_LIMIT) {
+        value = detail::Q32_LIMIT;
+    } else if (value <= -detail::Q32_LIMIT) {
+        value = -detail::Q32_LIMIT;
+    }
+    const float scaled = value * detail::Q32_SCALE;
+    return static_cast<Q32>(scaled < 0.0F ? scaled - 0.5F : scaled + 0.5F);
+}
+
+template<typename Sensor, typename Heater>
+typename BasicTemperatureController<Sensor, Heater>::Q16 BasicTemperatureController<Sensor, Heater>::mulQ16(Q16 a, Q16 b) {
+    const int64_t product = static_cast<int64_t>(a) * b;
+    const int64_t shifted = product >> 16;
+
+    if (shifted > INT32_MAX) {
+        return INT32_MAX;
+    }
+    if (shifted < -INT32_MAX) {
+        return -INT32_MAX;
+    }
+    return static_cast<Q16>(shifted);
+}
+
+template<typename Sensor, typename Heater>
+typename BasicTemperatureController<Sensor, Heater>::Q32 BasicTemperatureController<Sensor, Heater>::mulQ32(Q32 a, Q16 b) {
+    // Q32.32 * Q16.16 >> 16 in two halves: |a| < 2^47 and |b| < 2^31 keep both in 64 bits
+    const int64_t high = (a >> 16) * b;
+    const int64_t low = ((a & 0xFFFF) * b) >> 16;
+    return high + low;
+}
+
+template<typename Sensor, typename Heater>
+void BasicTemperatureController<Sensor, Heater>::controlOnOff(float reading) {
+    const float error = m_config.setpoint - reading;
+
+    if (error > m_config.hysteresis) {
+        m_heater.turnOn();
+    } else if (error < -m_config.hysteresis) {
+        m_heater.turnOff();
+    }
+    // Within hysteresis band: maintain current state
+}
+
+template<typename Sensor, typename Heater>
+void BasicTemperatureController<Sensor, Heater>::controlPid(float reading) {
+    const Q16 measurement = toQ16(reading);
+    const Q16 error = m_setpointQ16 - measurement;
+
+    // Derivative on the filtered measurement, not on the error
+    if (!m_pidPrimed) {
+        m_filtered = measurement;
+        m_pidPrimed = true;
+    }
+    const Q16 previous = m_filtered;
+    m_filtered += (measurement - m_filtered) >> m_config.derivativeFilterShift;
+
+    const int64_t proportional = mulQ16(m_kp, error);
+    const int64_t derivative = -static_cast<int64_t>(mulQ16(m_kdOverDt, m_filtered - previous));
+
+    // Anti-windup: only integrate while that does not push the output
+    // further into saturation, and keep the integral inside the output range
+    const int64_t integralQ16 = m_integral >> 16;
+    const int64_t unclamped = proportional + integralQ16 + derivative;
+    const bool saturatedHigh = (unclamped >= Q16_ONE) && (error > 0);
+    const bool saturatedLow = (unclamped <= 0) && (error < 0);
+    if (!saturatedHigh && !saturatedLow) {
+        const Q32 integral = m_integral + mulQ32(m_kiDt, error);
+        m_integral = (integral > Q32_ONE) ? Q32_ONE : ((integral < 0) ? 0 : integral);
+    }
+
+    int64_t output = proportional + (m_integral >> 16) + derivative;
+    output = (output > Q16_ONE) ? Q16_ONE : ((output < 0) ? 0 : output);
+    m_duty = static_cast<Q16>(output);
+
+    if constexpr (IsProportionalHeaterV<Heater>) {
+        // The output shapes the window itself
+        m_heater.setDutyCycle(static_cast<float>(m_duty) / detail::Q16_SCALE);
+    } else {
+        applyTimeProportioned();
+    }
+}
+
+template<typename Sensor, typename Heater>
+void BasicTemperatureController<Sensor, Heater>::applyTimeProportioned() {
+    // Time-proportioned output: on for the first part of every window
+    const uint32_t onTicks =
+        static_cast<uint32_t>((static_cast<int64_t>(m_duty) * m_config.pwmPeriodTicks + (Q16_ONE / 2)) >> 16);
+    const bool wantOn = m_pwmTick < onTicks;
+    m_pwmTick = static_cast<uint16_t>((m_pwmTick + 1U) % m_config.pwmPeriodTicks);
+
+    if (wantOn != m_heater.isOn()) {
+        if (wantOn) {
+            m_heater.turnOn();
+        } else {
+            m_heater.turnOff();
+        }
+    }
+}
+
+template<typename Sensor, typename Heater>
+void BasicTemperatureController<Sensor, Heater>::resetPid() {
+    m_integral = 0;
+    m_duty = 0;
+    m_pwmTick = 0U;
+    m_pidPrimed = false;
+}
+
+// Instantiated once in temperature_controller.cpp
+extern template class BasicTemperatureController<ITemperatureSensor, IHeater>;
+extern template class BasicTemperatureController<ITemperatureSensor, IProportionalHeater>;
+
 }  // namespace temperature
 
 #endif  // TEMPERATURE_CONTROLLER_HPP
\ No newline at end of file
@@ -0,0 +1,172 @@
+#include "CppUTest/TestHarness.h"
+#include "temperature_controller.hpp"
+#include "mock_temperature_sensor.hpp"
+#include "mock_heater.hpp"
+
+#include <type_traits>
+
+using namespace temperature;
+using namespace temperature::test;
+
+// ============================================================================
+// Production-style types without virtual functions
+// ============================================================================
+
+namespace {
+
+/// @brief Sensor with the ITemperatureSensor members but no base class
+class PlainTemperatureSensor {
+public:
+    float read() { return m_temperature; }
+    bool isHealthy() const { return m_healthy; }
+
+    void setTemperature(float temperature) { m_temperature = temperature; }
+    void setHealthy(bool healthy) { m_healthy = healthy; }
+
+private:
+    float m_temperature = 20.0F;
+    bool m_healthy = true;
+};
+
+/// @brief Heater with the IHeater members but no base class
+class PlainHeater {
+public:
+    void turnOn() { m_isOn = true; }
+    void turnOff() { m_isOn = false; }
+    bool isOn() const { return m_isOn; }
+
+private:
+    bool m_isOn = false;
+};
+
+/// @brief Final implementation: usable through IHeater and directly
+class FinalHeater final : public IHeater {
+public:
+    void turnOn() override { m_isOn = true; }
+    void turnOff() override { m_isOn = false; }
+    bool isOn() const override { return m_isOn; }
+
+private:
+    bool m_isOn = false;
+};
+
+struct NotASensor {
+    int read() const;  // Missing isHealthy()
+};
+
+// Same temperature profile for both controllers: rise, overshoot, fall
+float profile(int step) {
+    const int phase = step % 200;
+    return (phase < 100) ? 15.0F + 0.1F * static_cast<float>(phase)
+                         : 25.0F - 0.1F * static_cast<float>(phase - 100);
+}
+
+}  // namespace
+
+static_assert(!std::is_polymorphic<PlainHeater>::value, "PlainHeater must not have a vtable");
+
+#if defined(TEMPERATURE_HAS_CONCEPTS)
+static_assert(TemperatureSensor<PlainTemperatureSensor>, "concept matches the trait");
+static_assert(Heater<FinalHeater>, "concept matches the trait");
+static_assert(!TemperatureSensor<NotASensor>, "concept rejects incomplete types");
+#endif
+
+// ============================================================================
+// Static Interface Traits
+// ============================================================================
+
+TEST_GROUP(StaticInterface) {
+};
+
+TEST(StaticInterface, InterfacesAndImplementationsQualify) {
+    CHECK_TRUE(IsTemperatureSensorV<ITemperatureSensor>);
+    CHECK_TRUE(IsTemperatureSensorV<MockTemperatureSensor>);
+    CHECK_TRUE(IsTemperatureSensorV<PlainTemperatureSensor>);
+    CHECK_TRUE(IsHeaterV<IHeater>);
+    CHECK_TRUE(IsHeaterV<MockHeater>);
+    CHECK_TRUE(IsHeaterV<PlainHeater>);
+    CHECK_TRUE(IsHeaterV<FinalHeater>);
+}
+
+TEST(StaticInterface, IncompleteTypesAreRejected) {
+    CHECK_FALSE(IsTemperatureSensorV<NotASensor>);
+    CHECK_FALSE(IsTemperatureSensorV<int>);
+    CHECK_FALSE(IsHeaterV<MockTemperatureSensor>);
+}
+
+// ============================================================================
+// Static vs Virtual Dispatch
+// ============================================================================
+
+TEST_GROUP(StaticDispatch) {
+    MockTemperatureSensor virtualSensor;
+    MockHeater virtualHeater;
+    PlainTemperatureSensor plainSensor;
+    PlainHeater plainHeater;
+
+    // Runs both controllers over the same readings, heater states must match
+    void runSideBySide(const ControllerConfig& config, int steps) {
+        TemperatureController dynamicController(virtualSensor, virtualHeater, config);
+        BasicTemperatureController<PlainTemperatureSensor, PlainHeater> staticController(
+            plainSensor, plainHeater, config);
+
+        for (int i = 0; i < steps; ++i) {
+            virtualSensor.setTemperature(profile(i));
+            plainSensor.setTemperature(profile(i));
+            dynamicController.update();
+            staticController.update();
+
+            CHECK_EQUAL(virtualHeater.isOn(), plainHeater.isOn());
+            DOUBLES_EQUAL(dynamicController.getDutyCycle(), staticController.getDutyCycle(), 0.0);
+        }
+    }
+};
+
+TEST(StaticDispatch, OnOffMatchesVirtualController) {
+    ControllerConfig config;
+    config.setpoint = 20.0F;
+    config.hysteresis = 1.0F;
+
+    runSideBySide(config, 1000);
+    CHECK_TRUE(virtualHeater.getTurnOnCount() > 0U);
+}
+
+TEST(StaticDispatch, PidMatchesVirtualController) {
+    ControllerConfig config;
+    config.setpoint = 20.0F;
+    config.mode = ControlMode::Pid;
+    config.kp = 0.3F;
+    config.ki = 0.05F;
+    config.kd = 0.01F;
+    config.samplePeriodS = 0.1F;
+    config.pwmPeriodTicks = 10U;
+
+    runSideBySide(config, 1000);
+    CHECK_TRUE(virtualHeater.getTurnOnCount() > 0U);
+}
+
+TEST(StaticDispatch, FaultTurnsPlainHeaterOff) {
+    BasicTemperatureController<PlainTemperatureSensor, PlainHeater> controller(plainSensor, plainHeater);
+    plainSensor.setTemperature(10.0F);
+    controller.update();
+    CHECK_TRUE(plainHeater.isOn());
+
+    plainSensor.setHealthy(false);
+    controller.update();
+    CHECK_TRUE(controller.isInFault());
+    CHECK_FALSE(plainHeater.isOn());
+}
+
+TEST(StaticDispatch, FinalImplementationServesBothForms) {
+    FinalHeater heater;
+    TemperatureController throughInterface(virtualSensor, heater);
+    BasicTemperatureController<MockTemperatureSensor, FinalHeater> direct(virtualSensor, heater);
+
+    virtualSensor.setTemperature(10.0F);
+    throughInterface.update();
+    CHECK_TRUE(heater.isOn());
+
+    virtualSensor.setTemperature(30.0F);
+    direct.update();
+    CHECK_FALSE(heater.isOn());
+}
@@ -291,4 +291,229 @@ TEST(TemperatureControllerHysteresis, PreventsRapidSwitching) {
     // Heater only turned on once, never turned off
     LONGS_EQUAL(1U, heater->getTurnOnCount());
     LONGS_EQUAL(0U, heater->getTurnOffCount());
-}
\ No newline at end of file
+}
+// ============================================================================
+// Batch Update
+// ============================================================================
+
+TEST_GROUP(TemperatureControllerBatch) {
+    MockTemperatureSensor* sensor;
+    MockHeater* heater;
+    TemperatureController* controller;
+
+    void setup() override {
+        sensor = new MockTemperatureSensor();
+        heater = new MockHeater();
+
+        ControllerConfig config;
+        config.setpoint = 20.0F;
+        config.hysteresis = 2.0F;
+
+        controller = new TemperatureController(*sensor, *heater, config);
+    }
+
+    void teardown() override {
+        delete controller;
+        delete heater;
+        delete sensor;
+    }
+};
+
+TEST(TemperatureControllerBatch, LastOutOfBandReadingDecides) {
+    const float readings[] = {17.0F, 23.0F, 16.0F, 19.0F, 21.0F};
+
+    CHECK_TRUE(controller->updateBatch(readings, 5U));
+
+    CHECK_TRUE(heater->isOn());
+    DOUBLES_EQUAL(21.0, controller->getLastReading(), 0.01);
+}
+
+TEST(TemperatureControllerBatch, SwitchesHeaterAtMostOnce) {
+    const float readings[] = {15.0F, 15.0F, 15.0F, 15.0F};
+    heater->resetCounts();
+
+    controller->updateBatch(readings, 4U);
+
+    LONGS_EQUAL(1U, heater->getTurnOnCount());
+    LONGS_EQUAL(0U, heater->getTurnOffCount());
+}
+
+TEST(TemperatureControllerBatch, InBandBlockKeepsState) {
+    const float readings[] = {19.0F, 21.0F, 20.5F};
+    heater->turnOn();
+    heater->resetCounts();
+
+    CHECK_TRUE(controller->updateBatch(readings, 3U));
+    LONGS_EQUAL(0U, heater->getTurnOnCount() + heater->getTurnOffCount());
+}
+
+TEST(TemperatureControllerBatch, MatchesScalarPath) {
+    const float readings[] = {18.5F, 17.9F, 19.0F, 22.1F, 21.0F, 22.0F, 17.5F, 18.0F};
+    MockTemperatureSensor scalarSensor;
+    MockHeater scalarHeater;
+    ControllerConfig config;
+    config.hysteresis = 2.0F;
+    TemperatureController scalar(scalarSensor, scalarHeater, config);
+
+    for (size_t n = 1U; n <= 8U; ++n) {
+        scalarSensor.setTemperature(readings[n - 1U]);
+        scalar.update();
+
+        heater->turnOff();
+        CHECK_EQUAL(scalarHeater.isOn(), controller->updateBatch(readings, n));
+    }
+}
+
+TEST(TemperatureControllerBatch, UnhealthySensorTurnsHeaterOff) {
+    const float readings[] = {10.0F};
+    heater->turnOn();
+    sensor->setHealthy(false);
+
+    CHECK_FALSE(controller->updateBatch(readings, 1U));
+    CHECK_TRUE(controller->isInFault());
+}
+
+// ============================================================================
+// PID Mode
+// ============================================================================
+
+TEST_GROUP(TemperatureControllerPid) {
+    MockTemperatureSensor* sensor;
+    MockHeater* heater;
+    TemperatureController* controller;
+
+    void setup() override {
+        sensor = new MockTemperatureSensor();
+        heater = new MockHeater();
+        controller = nullptr;
+    }
+
+    void teardown() override {
+        delete controller;
+        delete heater;
+        delete sensor;
+    }
+
+    void create(float kp, float ki, float kd) {
+        ControllerConfig config;
+        config.setpoint = 20.0F;
+        config.mode = ControlMode::Pid;
+        config.kp = kp;
+        config.ki = ki;
+        config.kd = kd;
+        config.samplePeriodS = 0.1F;
+        config.pwmPeriodTicks = 10U;
+        controller = new TemperatureController(*sensor, *heater, config);
+    }
+
+    uint32_t onTicksInWindow() {
+        uint32_t on = 0U;
+        for (int i = 0; i < 10; ++i) {
+            controller->update();
+            on += heater->isOn() ? 1U : 0U;
+        }
+        return on;
+    }
+};
+
+TEST(TemperatureControllerPid, FarBelowSetpointGivesFullDuty) {
+    create(0.5F, 0.0F, 0.0F);
+    sensor->setTemperature(10.0F);
+
+    LONGS_EQUAL(10U, onTicksInWindow());
+    DOUBLES_EQUAL(1.0, controller->getDutyCycle(), 0.001);
+}
+
+TEST(TemperatureControllerPid, ProportionalDutyIsTimeProportioned) {
+    create(0.5F, 0.0F, 0.0F);
+    sensor->setTemperature(19.0F);  // 1 degree low: duty 0.5
+
+    LONGS_EQUAL(5U, onTicksInWindow());
+    DOUBLES_EQUAL(0.5, controller->getDutyCycle(), 0.001);
+}
+
+TEST(TemperatureControllerPid, AboveSetpointKeepsHeaterOff) {
+    create(0.5F, 0.0F, 0.0F);
+    sensor->setTemperature(21.0F);
+
+    LONGS_EQUAL(0U, onTicksInWindow());
+    LONGS_EQUAL(0U, heater->getTurnOnCount());
+}
+
+TEST(TemperatureControllerPid, IntegralRemovesSteadyStateError) {
+    create(0.1F, 0.5F, 0.0F);
+    sensor->setTemperature(19.5F);  // P alone gives duty 0.05
+
+    for (int i = 0; i < 100; ++i) {
+        controller->update();
+    }
+
+    CHECK(controller->getDutyCycle() > 0.5F);
+}
+
+TEST(TemperatureControllerPid, AntiWindupReleasesImmediately) {
+    create(0.5F, 1.0F, 0.0F);
+    sensor->setTemperature(0.0F);
+    for (int i = 0; i < 1000; ++i) {
+        controller->update();  // Saturated for 100 s
+    }
+
+    // Integral is held at the output range, not at 100 s of error
+    sensor->setTemperature(23.0F);
+    controller->update();
+    controller->update();
+
+    DOUBLES_EQUAL(0.0, controller->getDutyCycle(), 0.001);
+}
+
+TEST(TemperatureControllerPid, SetpointStepGivesNoDerivativeKick) {
+    create(0.0F, 0.0F, 10.0F);
+    sensor->setTemperature(20.0F);
+    controller->update();
+
+    controller->setSetpoint(30.0F);
+    controller->update();
+
+    DOUBLES_EQUAL(0.0, controller->getDutyCycle(), 0.001);
+}
+
+TEST(TemperatureControllerPid, DerivativeOpposesFallingTemperature) {
+    create(0.0F, 0.0F, 1.0F);
+    sensor->setTemperature(20.0F);
+    controller->update();
+
+    sensor->setTemperature(18.0F);  // Falling fast
+    controller->update();
+
+    CHECK(controller->getDutyCycle() > 0.0F);
+}
+
+TEST(TemperatureControllerPid, FaultResetsOutput) {
+    create(0.5F, 0.0F, 0.0F);
+    sensor->setTemperature(10.0F);
+    controller->update();
+    CHECK_TRUE(heater->isOn());
+
+    sensor->setHealthy(false);
+    controller->update();
+
+    CHECK_FALSE(heater->isOn());
+    DOUBLES_EQUAL(0.0, controller->getDutyCycle(), 0.001);
+}
+
+TEST(TemperatureControllerPid, IntegralAccumulatesAtOneKilohertz) {
+    ControllerConfig config;
+    config.setpoint = 20.0F;
+    config.mode = ControlMode::Pid;
+    config.kp = 0.0F;
+    config.ki = 0.05F;
+    config.samplePeriodS = 0.001F;  // ki * dt * error is 5e-6 per update
+    controller = new TemperatureController(*sensor, *heater, config);
+    sensor->setTemperature(19.9F);
+
+    for (int i = 0; i < 60000; ++i) {
+        controller->update();  // 60 s of 0.1 degree error
+    }
+
+    DOUBLES_EQUAL(0.30, controller->getDutyCycle(), 0.01);
+}
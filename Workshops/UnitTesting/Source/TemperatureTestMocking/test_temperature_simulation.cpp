@@ -0,0 +1,122 @@
+#include "CppUTest/TestHarness.h"
+#include "temperature_controller.hpp"
+#include "sim_temperature_zone.hpp"
+
+using namespace temperature;
+using namespace temperature::test;
+using simulation::HOUR;
+using simulation::MS;
+using simulation::SECOND;
+using simulation::TimeUs;
+
+// ============================================================================
+// Closed Loop on a Simulated Plant
+// ============================================================================
+// The plant: 20 C ambient, 50 W heater, 1 K/W to ambient, 600 J/K, so a
+// 600 s time constant and 70 C at full power. A simulated day takes well
+// under a second, because the virtual clock jumps from update to update.
+
+TEST_GROUP(TemperatureSimulation) {
+    simulation::Simulator sim;
+    simulation::ThermalPlant* plant;
+    SimTemperatureSensor* sensor;
+    SimHeater* heater;
+    TemperatureController* controller;
+
+    // Band seen after the warm-up
+    float minC;
+    float maxC;
+
+    void setup() override {
+        plant = new simulation::ThermalPlant(sim, simulation::ThermalPlant::Params{});
+        sensor = new SimTemperatureSensor(*plant);
+        heater = new SimHeater(*plant);
+        controller = nullptr;
+        minC = 1000.0F;
+        maxC = -1000.0F;
+    }
+
+    void teardown() override {
+        delete controller;
+        delete heater;
+        delete sensor;
+        delete plant;
+    }
+
+    void start(const ControllerConfig& config, TimeUs period, TimeUs warmUp) {
+        controller = new TemperatureController(*sensor, *heater, config);
+        sim.every(period, [this, warmUp]() {
+            controller->update();
+            if (sim.now() >= warmUp) {
+                const float reading = controller->getLastReading();
+                minC = reading < minC ? reading : minC;
+                maxC = reading > maxC ? reading : maxC;
+            }
+        });
+    }
+};
+
+TEST(TemperatureSimulation, OnOffHoldsTheBandForADay) {
+    ControllerConfig config;
+    config.setpoint = 40.0F;
+    config.hysteresis = 1.0F;
+    start(config, SECOND, HOUR);
+
+    sim.runFor(24 * HOUR);
+
+    // Overshoot beyond the band is one update of drift (< 0.05 K/s here)
+    CHECK_TRUE(minC > 38.9F);
+    CHECK_TRUE(maxC < 41.1F);
+    // About 100 s per cycle near 40 C: under 2000 switches a day
+    CHECK_TRUE(heater->getSwitchCount() > 1000U);
+    CHECK_TRUE(heater->getSwitchCount() < 2000U);
+    LONGS_EQUAL(86400, sim.getEventsRun());
+}
+
+TEST(TemperatureSimulation, OnOffWithNoisySensorStillHoldsTheBand) {
+    delete sensor;
+    sensor = new SimTemperatureSensor(*plant, 0.1F, 7U);
+    ControllerConfig config;
+    config.setpoint = 40.0F;
+    config.hysteresis = 1.0F;
+    start(config, SECOND, HOUR);
+
+    sim.runFor(24 * HOUR);
+
+    // The readings include the noise, the plant itself stays closer
+    CHECK_TRUE(minC > 38.3F);
+    CHECK_TRUE(maxC < 41.7F);
+}
+
+TEST(TemperatureSimulation, PidSettlesAndRidesOutAnAmbientDrop) {
+    ControllerConfig config;
+    config.setpoint = 40.0F;
+    config.mode = ControlMode::Pid;
+    config.kp = 0.2F;
+    config.ki = 0.001F;
+    config.samplePeriodS = 0.1F;
+    config.pwmPeriodTicks = 100U;  // 10 s heater window
+    start(config, 100 * MS, 23 * HOUR);
+
+    // Window open at night: 10 C ambient needs 60 % duty instead of 40 %
+    sim.at(12 * HOUR, [this]() { plant->setAmbientC(10.0); });
+    sim.runFor(24 * HOUR);
+
+    DOUBLES_EQUAL(40.0, minC, 0.5);
+    DOUBLES_EQUAL(40.0, maxC, 0.5);
+    DOUBLES_EQUAL(0.6, controller->getDutyCycle(), 0.1);
+}
+
+TEST(TemperatureSimulation, SensorFaultLetsThePlantCoolDown) {
+    ControllerConfig config;
+    config.setpoint = 40.0F;
+    start(config, SECOND, 0U);
+
+    sim.at(2 * HOUR, [this]() { sensor->setHealthy(false); });
+    sim.runFor(4 * HOUR);
+
+    CHECK_TRUE(controller->isInFault());
+    CHECK_FALSE(heater->isOn());
+    // Two hours is 12 time constants: back at ambient
+    DOUBLES_EQUAL(20.0, plant->getTemperatureC(), 0.1);
+}
@@ -0,0 +1,177 @@
+#include "CppUTest/TestHarness.h"
+#include "temperature_controller.hpp"
+#include "time_proportioning_heater.hpp"
+#include "mock_temperature_sensor.hpp"
+#include "mock_heater.hpp"
+#include "mock_pwm_timer.hpp"
+
+using namespace temperature;
+using namespace temperature::test;
+
+static_assert(IsProportionalHeaterV<IProportionalHeater>, "interface qualifies");
+static_assert(IsProportionalHeaterV<TimeProportioningHeater>, "driver qualifies");
+static_assert(!IsProportionalHeaterV<IHeater>, "on/off heater does not");
+static_assert(!IsProportionalHeaterV<MockHeater>, "on/off mock does not");
+
+#if defined(TEMPERATURE_HAS_CONCEPTS)
+static_assert(ProportionalHeater<TimeProportioningHeater>, "concept matches the trait");
+static_assert(!ProportionalHeater<MockHeater>, "concept rejects on/off heaters");
+#endif
+
+// ============================================================================
+// TimeProportioningHeater
+// ============================================================================
+
+TEST_GROUP(TimeProportioningHeater) {
+    MockPwmTimer* timer;
+    TimeProportioningHeater* heater;
+
+    void setup() override {
+        timer = new MockPwmTimer(100U);
+        heater = new TimeProportioningHeater(*timer);
+    }
+
+    void teardown() override {
+        delete heater;
+        delete timer;
+    }
+};
+
+TEST(TimeProportioningHeater, StartsOff) {
+    LONGS_EQUAL(0U, timer->getPendingCompare());
+    LONGS_EQUAL(0U, timer->countHighTicks(300U));
+    CHECK_FALSE(heater->isOn());
+}
+
+TEST(TimeProportioningHeater, DutyCycleBecomesCompareValue) {
+    heater->setDutyCycle(0.25F);
+
+    LONGS_EQUAL(25U, heater->getOnTicks());
+    LONGS_EQUAL(25U, timer->getPendingCompare());
+    DOUBLES_EQUAL(0.25, heater->getDutyCycle(), 0.001);
+}
+
+TEST(TimeProportioningHeater, TimerShapesTheWindow) {
+    heater->setDutyCycle(0.3F);
+    timer->advance(100U);  // Taken over at the next window
+
+    LONGS_EQUAL(30U, timer->countHighTicks(100U));
+    LONGS_EQUAL(90U, timer->countHighTicks(300U));
+}
+
+TEST(TimeProportioningHeater, IsOnFollowsTheOutput) {
+    heater->setDutyCycle(0.5F);
+    timer->advance(100U);
+
+    CHECK_TRUE(heater->isOn());
+    timer->advance(50U);
+    CHECK_FALSE(heater->isOn());
+}
+
+TEST(TimeProportioningHeater, DutyCycleIsClamped) {
+    heater->setDutyCycle(1.5F);
+    LONGS_EQUAL(100U, heater->getOnTicks());
+
+    heater->setDutyCycle(-0.5F);
+    LONGS_EQUAL(0U, heater->getOnTicks());
+}
+
+TEST(TimeProportioningHeater, TurnOnAndOffAreFullAndZeroPower) {
+    heater->turnOn();
+    LONGS_EQUAL(100U, heater->getOnTicks());
+
+    heater->turnOff();
+    LONGS_EQUAL(0U, heater->getOnTicks());
+}
+
+TEST(TimeProportioningHeater, UnchangedDutyIsNotWrittenAgain) {
+    const uint32_t writes = timer->getWriteCount();
+
+    heater->setDutyCycle(0.4F);
+    heater->setDutyCycle(0.4F);
+    heater->setDutyCycle(0.401F);  // Same tick count
+
+    LONGS_EQUAL(writes + 1U, timer->getWriteCount());
+}
+
+// ============================================================================
+// PID Controller on a Proportional Heater
+// ============================================================================
+
+TEST_GROUP(ProportionalTemperatureController) {
+    MockTemperatureSensor* sensor;
+    MockPwmTimer* timer;
+    TimeProportioningHeater* heater;
+    ProportionalTemperatureController* controller;
+
+    void setup() override {
+        sensor = new MockTemperatureSensor();
+        timer = new MockPwmTimer(1000U);
+        heater = new TimeProportioningHeater(*timer);
+
+        ControllerConfig config;
+        config.setpoint = 20.0F;
+        config.mode = ControlMode::Pid;
+        config.kp = 0.5F;
+        config.samplePeriodS = 1.0F;
+        controller = new ProportionalTemperatureController(*sensor, *heater, config);
+    }
+
+    void teardown() override {
+        delete controller;
+        delete heater;
+        delete timer;
+        delete sensor;
+    }
+};
+
+TEST(ProportionalTemperatureController, OneUpdateSetsTheWholeWindow) {
+    sensor->setTemperature(19.0F);  // 1 degree low: duty 0.5
+    controller->update();
+
+    LONGS_EQUAL(500U, timer->getPendingCompare());
+    timer->advance(1000U);
+    LONGS_EQUAL(500U, timer->countHighTicks(1000U));
+}
+
+TEST(ProportionalTemperatureController, HeaterDutyFollowsController) {
+    sensor->setTemperature(19.5F);
+    controller->update();
+
+    DOUBLES_EQUAL(controller->getDutyCycle(), heater->getDutyCycle(), 0.001);
+    DOUBLES_EQUAL(0.25, heater->getDutyCycle(), 0.001);
+}
+
+TEST(ProportionalTemperatureController, AboveSetpointGivesZeroPower) {
+    sensor->setTemperature(21.0F);
+    controller->update();
+
+    LONGS_EQUAL(0U, heater->getOnTicks());
+}
+
+TEST(ProportionalTemperatureController, FaultTurnsHeaterOff) {
+    sensor->setTemperature(10.0F);
+    controller->update();
+    LONGS_EQUAL(1000U, heater->getOnTicks());
+
+    sensor->setHealthy(false);
+    controller->update();
+
+    LONGS_EQUAL(0U, heater->getOnTicks());
+    DOUBLES_EQUAL(0.0, controller->getDutyCycle(), 0.001);
+}
+
+TEST(ProportionalTemperatureController, OnOffModeSwitchesFullPower) {
+    ControllerConfig config;
+    config.setpoint = 20.0F;
+    config.hysteresis = 1.0F;
+    ProportionalTemperatureController onOff(*sensor, *heater, config);
+
+    sensor->setTemperature(18.0F);
+    onOff.update();
+    LONGS_EQUAL(1000U, heater->getOnTicks());
+
+    sensor->setTemperature(22.0F);
+    onOff.update();
+    LONGS_EQUAL(0U, heater->getOnTicks());
+}
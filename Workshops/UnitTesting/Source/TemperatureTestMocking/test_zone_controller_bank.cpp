@@ -0,0 +1,90 @@
+#include "CppUTest/TestHarness.h"
+#include "zone_controller_bank.hpp"
+#include "mock_zone_io.hpp"
+
+using namespace temperature;
+using namespace temperature::test;
+
+// ============================================================================
+// Zone Controller Bank
+// ============================================================================
+
+TEST_GROUP(ZoneControllerBank) {
+    static constexpr size_t ZONES = 16U;
+
+    MockSensorBank<ZONES>* sensors;
+    MockHeaterBank<ZONES>* heaters;
+    ZoneControllerBank<ZONES>* bank;
+
+    void setup() override {
+        sensors = new MockSensorBank<ZONES>();
+        heaters = new MockHeaterBank<ZONES>();
+        bank = new ZoneControllerBank<ZONES>(*sensors, *heaters, 20.0F, 1.0F);
+    }
+
+    void teardown() override {
+        delete bank;
+        delete heaters;
+        delete sensors;
+    }
+};
+
+TEST(ZoneControllerBank, OneReadAndOneWritePerUpdate) {
+    bank->update();
+
+    LONGS_EQUAL(1U, sensors->getReadCount());
+    LONGS_EQUAL(1U, heaters->getWriteCount());
+}
+
+TEST(ZoneControllerBank, ZonesAreControlledIndependently) {
+    sensors->setTemperature(0U, 15.0F);
+    sensors->setTemperature(5U, 25.0F);
+
+    bank->update();
+
+    CHECK_TRUE(heaters->isOn(0U));
+    CHECK_FALSE(heaters->isOn(5U));
+    CHECK_FALSE(heaters->isOn(1U));
+    DOUBLES_EQUAL(15.0, bank->getLastReading(0U), 0.01);
+}
+
+TEST(ZoneControllerBank, HysteresisKeepsStatePerZone) {
+    sensors->setTemperature(3U, 15.0F);
+    bank->update();
+
+    sensors->setTemperature(3U, 20.5F);  // Inside the band
+    bank->update();
+
+    CHECK_TRUE(bank->isHeaterOn(3U));
+}
+
+TEST(ZoneControllerBank, SetpointPerZone) {
+    bank->setSetpoint(7U, 30.0F);
+    sensors->setTemperature(7U, 25.0F);
+
+    bank->update();
+
+    DOUBLES_EQUAL(30.0, bank->getSetpoint(7U), 0.01);
+    CHECK_TRUE(heaters->isOn(7U));
+}
+
+TEST(ZoneControllerBank, UnhealthyZoneTurnsOnlyItsHeaterOff) {
+    sensors->setTemperature(2U, 10.0F);
+    sensors->setTemperature(4U, 10.0F);
+    bank->update();
+
+    sensors->setHealthy(2U, false);
+    bank->update();
+
+    CHECK_TRUE(bank->isInFault(2U));
+    CHECK_FALSE(heaters->isOn(2U));
+    CHECK_TRUE(heaters->isOn(4U));
+    LONGS_EQUAL(1U, bank->getFaultCount());
+}
+
+TEST(ZoneControllerBank, OutOfRangeZoneIsIgnored) {
+    bank->setSetpoint(ZONES, 99.0F);
+
+    DOUBLES_EQUAL(0.0, bank->getSetpoint(ZONES), 0.01);
+    CHECK_FALSE(bank->isHeaterOn(ZONES));
+}
@@ -0,0 +1,76 @@
+#ifndef TIME_PROPORTIONING_HEATER_HPP
+#define TIME_PROPORTIONING_HEATER_HPP
+
+#include "i_heater.hpp"
+#include "i_pwm_timer.hpp"
+#include <cstdint>
+
+namespace temperature {
+
+/// @brief Heater driven by a hardware timer window (slow PWM)
+/// @details The duty cycle becomes the timer's compare value; the timer
+///          switches the heater on and off without the CPU. With it
+///          BasicTemperatureController in PID mode hands over its duty once
+///          per update(), so update() runs at the control rate instead of
+///          pwmPeriodTicks times per window.
+class TimeProportioningHeater final : public IProportionalHeater {
+public:
+    /// @brief Construct heater on a timer (caller owns lifetime)
+    /// @param timer Timer that drives the heater pin
+    explicit TimeProportioningHeater(IPwmTimer& timer)
+        : m_timer{timer}
+        , m_onTicks{0U}
+    {
+        m_timer.setCompare(0U);
+    }
+
+    void turnOn() override {
+        apply(m_timer.getPeriodTicks());
+    }
+
+    void turnOff() override {
+        apply(0U);
+    }
+
+    /// @return true while the timer output is high
+    bool isOn() const override {
+        return m_timer.isOutputHigh();
+    }
+
+    void setDutyCycle(float duty) override {
+        const uint32_t period = m_timer.getPeriodTicks();
+
+        if (!(duty > 0.0F)) {  // Also NaN
+            apply(0U);
+        } else if (duty >= 1.0F) {
+            apply(period);
+        } else {
+            apply(static_cast<uint32_t>(duty * static_cast<float>(period) + 0.5F));
+        }
+    }
+
+    float getDutyCycle() const override {
+        return static_cast<float>(m_onTicks) / static_cast<float>(m_timer.getPeriodTicks());
+    }
+
+    /// @brief Get the on time as applied
+    /// @return Ticks high per window
+    uint32_t getOnTicks() const {
+        return m_onTicks;
+    }
+
+private:
+    void apply(uint32_t onTicks) {
+        if (onTicks != m_onTicks) {
+            m_onTicks = onTicks;
+            m_timer.setCompare(onTicks);
+        }
+    }
+
+    IPwmTimer& m_timer;
+    uint32_t m_onTicks;
+};
+
+}  // namespace temperature
+
+#endif  // TIME_PROPORTIONING_HEATER_HPP
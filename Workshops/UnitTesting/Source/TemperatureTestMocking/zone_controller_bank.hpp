@@ -0,0 +1,160 @@
+#ifndef ZONE_CONTROLLER_BANK_HPP
+#define ZONE_CONTROLLER_BANK_HPP
+
+#include "i_zone_io.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace temperature {
+
+/// @brief On/off hysteresis control for N zones in one sweep
+/// @details Same control law as TemperatureController in on/off mode, but
+///          zone state is kept as structure-of-arrays and the I/O is
+///          batched: update() makes one readAll() and one writeAll() call
+///          and the control loop in between is a plain pass over arrays.
+template<size_t N>
+class ZoneControllerBank {
+public:
+    static_assert(N > 0U, "Bank needs at least one zone");
+
+    /// @brief Construct bank with injected I/O
+    /// @param sensors Sensor bank (caller owns lifetime)
+    /// @param heaters Heater bank (caller owns lifetime)
+    /// @param setpoint Initial setpoint for every zone in Celsius
+    /// @param hysteresis Dead band shared by all zones
+    ZoneControllerBank(ISensorBank& sensors,
+                       IHeaterBank& heaters,
+                       float setpoint = 20.0F,
+                       float hysteresis = 1.0F);
+
+    /// @brief Run one control cycle for all zones
+    void update();
+
+    /// @brief Get number of zones
+    /// @return N
+    static constexpr size_t getZoneCount() { return N; }
+
+    /// @brief Get setpoint of a zone
+    /// @return Target temperature in Celsius
+    float getSetpoint(size_t zone) const;
+
+    /// @brief Change setpoint of a zone
+    /// @param zone Zone index (ignored if out of range)
+    /// @param setpoint New target temperature in Celsius
+    void setSetpoint(size_t zone, float setpoint);
+
+    /// @brief Check if a zone is in fault state
+    /// @return true if the zone's sensor is unhealthy
+    bool isInFault(size_t zone) const;
+
+    /// @brief Get number of zones in fault
+    /// @return Zones with an unhealthy sensor after the last update
+    size_t getFaultCount() const;
+
+    /// @brief Get last temperature reading of a zone
+    /// @return Last healthy reading in Celsius
+    float getLastReading(size_t zone) const;
+
+    /// @brief Get heater output of a zone
+    /// @return true if the zone's heater is on
+    bool isHeaterOn(size_t zone) const;
+
+private:
+    ISensorBank& m_sensors;
+    IHeaterBank& m_heaters;
+    float m_hysteresis;
+
+    // Structure-of-arrays zone state
+    std::array<float, N> m_setpoints;
+    std::array<float, N> m_lastReadings;
+    std::array<float, N> m_scratch;
+    std::array<bool, N> m_healthy;
+    std::array<bool, N> m_outputs;
+};
+
+// ============================================================================
+// Template Implementation
+// ============================================================================
+
+template<size_t N>
+ZoneControllerBank<N>::ZoneControllerBank(ISensorBank& sensors,
+                                          IHeaterBank& heaters,
+                                          float setpoint,
+                                          float hysteresis)
+    : m_sensors{sensors}
+    , m_heaters{heaters}
+    , m_hysteresis{hysteresis}
+    , m_setpoints{}
+    , m_lastReadings{}
+    , m_scratch{}
+    , m_healthy{}
+    , m_outputs{}
+{
+    m_setpoints.fill(setpoint);
+    m_healthy.fill(true);
+}
+
+template<size_t N>
+void ZoneControllerBank<N>::update() {
+    m_sensors.readAll(m_scratch.data(), m_healthy.data(), N);
+
+    for (size_t i = 0U; i < N; ++i) {
+        if (!m_healthy[i]) {
+            m_outputs[i] = false;  // Fault: heater off, keep last reading
+            continue;
+        }
+
+        m_lastReadings[i] = m_scratch[i];
+        const float error = m_setpoints[i] - m_scratch[i];
+
+        if (error > m_hysteresis) {
+            m_outputs[i] = true;
+        } else if (error < -m_hysteresis) {
+            m_outputs[i] = false;
+        }
+        // Within hysteresis band: maintain current state
+    }
+
+    m_heaters.writeAll(m_outputs.data(), N);
+}
+
+template<size_t N>
+float ZoneControllerBank<N>::getSetpoint(size_t zone) const {
+    return (zone < N) ? m_setpoints[zone] : 0.0F;
+}
+
+template<size_t N>
+void ZoneControllerBank<N>::setSetpoint(size_t zone, float setpoint) {
+    if (zone < N) {
+        m_setpoints[zone] = setpoint;
+    }
+}
+
+template<size_t N>
+bool ZoneControllerBank<N>::isInFault(size_t zone) const {
+    return (zone < N) && !m_healthy[zone];
+}
+
+template<size_t N>
+size_t ZoneControllerBank<N>::getFaultCount() const {
+    size_t faults = 0U;
+    for (bool healthy : m_healthy) {
+        faults += healthy ? 0U : 1U;
+    }
+    return faults;
+}
+
+template<size_t N>
+float ZoneControllerBank<N>::getLastReading(size_t zone) const {
+    return (zone < N) ? m_lastReadings[zone] : 0.0F;
+}
+
+template<size_t N>
+bool ZoneControllerBank<N>::isHeaterOn(size_t zone) const {
+    return (zone < N) && m_outputs[zone];
+}
+
+}  // namespace temperature
+
+#endif  // ZONE_CONTROLLER_BANK_HPP